@@ -19,6 +19,10 @@ CUDA_TOOLKIT_ROOT_ENV_KEY = "IREE_CUDA_TOOLKIT_ROOT"
 # TODO: Simplify this on the CMake/docker side and update here to match.
 CUDA_DEPS_DIR_FOR_CI_ENV_KEY = "IREE_CUDA_DEPS_DIR"
 
+# The Perfetto SDK amalgamation is not vendored; this matches the CMake
+# IREE_PERFETTO_SDK_DIR option and points at the root of a release checkout.
+PERFETTO_SDK_DIR_ENV_KEY = "IREE_PERFETTO_SDK_DIR"
+
 def cuda_auto_configure_impl(repository_ctx):
     env = repository_ctx.os.environ
     cuda_toolkit_root = None
@@ -73,6 +77,36 @@ def configure_iree_cuda_deps(iree_repo_alias = None):
         iree_repo_alias = iree_repo_alias,
     )
 
+def perfetto_sdk_configure_impl(repository_ctx):
+    perfetto_sdk_dir = repository_ctx.os.environ.get(PERFETTO_SDK_DIR_ENV_KEY)
+    iree_repo_alias = repository_ctx.attr.iree_repo_alias
+    if perfetto_sdk_dir:
+        repository_ctx.symlink(perfetto_sdk_dir + "/sdk", "sdk")
+    repository_ctx.template(
+        "BUILD",
+        Label("%s//:build_tools/third_party/perfetto/BUILD.template" % iree_repo_alias),
+        {
+            "%ENABLED%": "True" if perfetto_sdk_dir else "False",
+        },
+    )
+
+perfetto_sdk_configure = repository_rule(
+    environ = [
+        PERFETTO_SDK_DIR_ENV_KEY,
+    ],
+    implementation = perfetto_sdk_configure_impl,
+    attrs = {
+        "iree_repo_alias": attr.string(default = "@iree_core"),
+    },
+)
+
+def configure_iree_perfetto_deps(iree_repo_alias = None):
+    maybe(
+        perfetto_sdk_configure,
+        name = "perfetto_sdk",
+        iree_repo_alias = iree_repo_alias,
+    )
+
 def configure_iree_submodule_deps(iree_repo_alias = "@", iree_path = "./"):
     """Configure all of IREE's simple repository dependencies that come from submodules.
 
@@ -86,6 +86,8 @@ class TargetConverter:
                 "@nccl//:headers": [
                     "nccl::headers",
                 ],
+                # Perfetto.
+                "@perfetto_sdk//:sdk": ["perfetto_sdk::sdk"],
                 # Tracy.
                 "@tracy_client//:runtime": ["tracy_client::runtime"],
                 # Vulkan
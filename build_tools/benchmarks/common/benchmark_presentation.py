@@ -565,6 +565,23 @@ def _sort_benchmarks_and_get_table(
     )
 
 
+def get_regressed_benchmarks(
+    benchmarks: Dict[str, AggregateBenchmarkLatency]
+) -> Dict[str, AggregateBenchmarkLatency]:
+    """Returns the benchmarks whose latency regressed beyond their threshold.
+
+    Args:
+      benchmarks: A dictionary of benchmark names to its aggregate info.
+    """
+    regressed, _, _, _ = _categorize_on_single_metric(
+        benchmarks,
+        lambda results: (results.mean_time, results.base_mean_time),
+        BENCHMARK_THRESHOLDS,
+        "ns",
+    )
+    return regressed
+
+
 def categorize_benchmarks_into_tables(
     benchmarks: Dict[str, AggregateBenchmarkLatency], size_cut: Optional[int] = None
 ) -> str:
@@ -129,6 +129,9 @@ BENCHMARK_THRESHOLDS = [
     BenchmarkThreshold(
         re.compile(r"^MobileNet.*GPU"), 1 * 10**6, ThresholdUnit.VALUE_NS
     ),
+    # Ukernel microbenchmarks run a single kernel in a tight loop and are far
+    # less noisy than full models.
+    BenchmarkThreshold(re.compile(r"^ukernel "), 5, ThresholdUnit.PERCENTAGE),
     # Default threshold for all ARM64/X86_64 benchmarks: 10%.
     BenchmarkThreshold(re.compile(r".*CPU-ARM.*"), 10, ThresholdUnit.PERCENTAGE),
     BenchmarkThreshold(re.compile(r".*x86_64.*"), 10, ThresholdUnit.PERCENTAGE),
@@ -9,6 +9,9 @@
 Example usage:
   python3 diff_local_benchmarks.py --base=/path/to/base_benchmarks.json
                                    --target=/path/to/target_benchmarks.json
+
+With --fail-on-regression the script exits with a non-zero status if any
+benchmark regressed beyond its threshold in common/benchmark_thresholds.py.
 """
 
 import pathlib
@@ -19,11 +22,26 @@ sys.path.insert(0, str(pathlib.Path(__file__).parent.with_name("python")))
 
 import argparse
 
-from typing import Optional
+from typing import Dict, Optional
 
 from common.benchmark_presentation import *
 
 
+def get_compared_benchmarks(
+    base_benchmark_file: Optional[pathlib.Path],
+    target_benchmark_file: Optional[pathlib.Path],
+) -> Dict[str, AggregateBenchmarkLatency]:
+    """Gets the target benchmarks updated with their corresponding base numbers."""
+    if not base_benchmark_file or not target_benchmark_file:
+        return {}
+    base_benchmarks = aggregate_all_benchmarks([base_benchmark_file])
+    target_benchmarks = aggregate_all_benchmarks([target_benchmark_file])
+    for bench in base_benchmarks:
+        if bench in target_benchmarks:
+            target_benchmarks[bench].base_mean_time = base_benchmarks[bench].mean_time
+    return target_benchmarks
+
+
 def get_benchmark_result_markdown(
     base_benchmark_file: Optional[pathlib.Path],
     target_benchmark_file: Optional[pathlib.Path],
@@ -32,13 +50,11 @@ def get_benchmark_result_markdown(
     verbose: bool = False,
 ) -> str:
     """Gets the full markdown summary of all benchmarks in files."""
-    base_benchmarks = {}
-    target_benchmarks = {}
+    target_benchmarks = get_compared_benchmarks(
+        base_benchmark_file, target_benchmark_file
+    )
     base_compilation_metrics = {}
     target_compilation_metrics = {}
-    if base_benchmark_file and target_benchmark_file:
-        base_benchmarks = aggregate_all_benchmarks([base_benchmark_file])
-        target_benchmarks = aggregate_all_benchmarks([target_benchmark_file])
     if base_compile_stats_file and target_compile_stats_file:
         base_compilation_metrics = collect_all_compilation_metrics(
             [base_compile_stats_file]
@@ -47,11 +63,6 @@ def get_benchmark_result_markdown(
             [target_compile_stats_file]
         )
 
-    # Update the target benchmarks with their corresponding base numbers.
-    for bench in base_benchmarks:
-        if bench in target_benchmarks:
-            target_benchmarks[bench].base_mean_time = base_benchmarks[bench].mean_time
-
     for target_name, base_metrics in base_compilation_metrics.items():
         updated_metrics = base_metrics
         for mapper in COMPILATION_METRICS_TO_TABLE_MAPPERS:
@@ -95,6 +106,11 @@ def parse_arguments():
         type=check_file_path,
         help="Target compilation statistics",
     )
+    parser.add_argument(
+        "--fail-on-regression",
+        action="store_true",
+        help="Exit with a non-zero status if any benchmark regressed",
+    )
     parser.add_argument(
         "--verbose",
         action="store_true",
@@ -126,3 +142,11 @@ if __name__ == "__main__":
             verbose=args.verbose,
         )
     )
+
+    if args.fail_on_regression:
+        regressed = get_regressed_benchmarks(
+            get_compared_benchmarks(args.base, args.target)
+        )
+        if regressed:
+            names = "\n".join(sorted(str(bench) for bench in regressed.values()))
+            sys.exit(f"{len(regressed)} benchmark(s) regressed:\n{names}")
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Generates a per-dispatch roofline report.
+
+Combines the static per-dispatch FLOP and byte estimates emitted by the
+compiler with measured dispatch durations to report the achieved GFLOP/s and
+GB/s of each dispatch against the peak of the device.
+
+Example usage:
+  $ iree-compile \\
+      --iree-hal-target-backends=cuda \\
+      --iree-scheduling-dump-statistics-format=json \\
+      --iree-scheduling-dump-statistics-file=statistics.json \\
+      model.mlir -o model.vmfb
+  $ iree-benchmark-module \\
+      --device=cuda \\
+      --module=model.vmfb \\
+      --function=main \\
+      --device_profiling_mode=dispatch \\
+      --device_profiling_file=dispatches.json
+  $ generate_roofline_report.py \\
+      --statistics=statistics.json \\
+      --dispatch_trace=dispatches.json \\
+      --peak_gflops=19500 \\
+      --peak_gbps=1555
+"""
+
+import argparse
+import csv
+import json
+import pathlib
+import sys
+from dataclasses import dataclass
+from typing import Dict, List, Optional, TextIO
+
+
+@dataclass(frozen=True)
+class DispatchCost(object):
+    """Compiler estimate of the work done by a single dispatch."""
+
+    flops: int
+    bytes: int
+    complete: bool
+
+
+@dataclass(frozen=True)
+class RooflineRow(object):
+    """Roofline metrics of a single dispatch export."""
+
+    name: str
+    count: int
+    mean_time_us: float
+    flops: int
+    bytes: int
+    complete: bool
+    intensity: float
+    achieved_gflops: float
+    achieved_gbps: float
+    attainable_gflops: float
+    efficiency: float
+    bound: str
+
+
+def load_dispatch_costs(statistics: dict) -> Dict[str, DispatchCost]:
+    """Loads per-export costs keyed by export name.
+
+    Expects the output of `--iree-scheduling-dump-statistics-format=json`.
+    """
+    costs = {}
+    for export in statistics.get("executable-exports", []):
+        costs[export["export"]] = DispatchCost(
+            flops=int(export["flops"]),
+            bytes=int(export["bytes"]),
+            complete=bool(export["complete"]),
+        )
+    return costs
+
+
+def load_dispatch_durations(trace: dict) -> Dict[str, List[float]]:
+    """Loads dispatch durations in microseconds from a Chrome trace JSON file
+    as produced by `--device_profiling_mode=dispatch`."""
+    events = trace["traceEvents"] if isinstance(trace, dict) else trace
+    durations = {}
+    for event in events:
+        if event.get("ph") != "X":
+            continue
+        durations.setdefault(event["name"], []).append(float(event["dur"]))
+    return durations
+
+
+def build_roofline_rows(
+    costs: Dict[str, DispatchCost],
+    durations: Dict[str, List[float]],
+    peak_gflops: float,
+    peak_gbps: float,
+) -> List[RooflineRow]:
+    """Joins costs and durations by export name.
+
+    Dispatches without a cost estimate are skipped. Rows are sorted by total
+    time spent in the dispatch, largest first.
+    """
+    ridge_intensity = peak_gflops / peak_gbps
+    rows = []
+    for name, samples in durations.items():
+        cost = costs.get(name)
+        if cost is None or not samples:
+            continue
+        mean_time_us = sum(samples) / len(samples)
+        seconds = mean_time_us * 1e-6
+        achieved_gflops = cost.flops / seconds * 1e-9 if seconds else 0.0
+        achieved_gbps = cost.bytes / seconds * 1e-9 if seconds else 0.0
+        intensity = cost.flops / cost.bytes if cost.bytes else 0.0
+        if cost.bytes:
+            attainable_gflops = min(peak_gflops, intensity * peak_gbps)
+        else:
+            attainable_gflops = peak_gflops
+        if cost.flops:
+            efficiency = achieved_gflops / attainable_gflops
+        else:
+            # Pure data movement; measure against bandwidth instead.
+            efficiency = achieved_gbps / peak_gbps
+        rows.append(
+            RooflineRow(
+                name=name,
+                count=len(samples),
+                mean_time_us=mean_time_us,
+                flops=cost.flops,
+                bytes=cost.bytes,
+                complete=cost.complete,
+                intensity=intensity,
+                achieved_gflops=achieved_gflops,
+                achieved_gbps=achieved_gbps,
+                attainable_gflops=attainable_gflops,
+                efficiency=efficiency,
+                bound="compute" if intensity >= ridge_intensity else "memory",
+            )
+        )
+    rows.sort(key=lambda row: row.mean_time_us * row.count, reverse=True)
+    return rows
+
+
+def write_markdown(rows: List[RooflineRow], output: TextIO):
+    output.write(
+        "| Dispatch | Count | Mean (us) | FLOP/B | GFLOP/s | GB/s "
+        "| Attainable GFLOP/s | Efficiency | Bound |\n"
+    )
+    output.write("|---|---|---|---|---|---|---|---|---|\n")
+    for row in rows:
+        # Incomplete estimates are lower bounds.
+        prefix = "" if row.complete else ">="
+        output.write(
+            f"| {row.name} | {row.count} | {row.mean_time_us:.2f} "
+            f"| {prefix}{row.intensity:.2f} "
+            f"| {prefix}{row.achieved_gflops:.2f} "
+            f"| {prefix}{row.achieved_gbps:.2f} "
+            f"| {row.attainable_gflops:.2f} "
+            f"| {prefix}{row.efficiency * 100:.1f}% | {row.bound} |\n"
+        )
+
+
+def write_csv(rows: List[RooflineRow], output: TextIO):
+    writer = csv.writer(output)
+    writer.writerow(
+        [
+            "name",
+            "count",
+            "mean_time_us",
+            "flops",
+            "bytes",
+            "complete",
+            "intensity",
+            "achieved_gflops",
+            "achieved_gbps",
+            "attainable_gflops",
+            "efficiency",
+            "bound",
+        ]
+    )
+    for row in rows:
+        writer.writerow(
+            [
+                row.name,
+                row.count,
+                f"{row.mean_time_us:.3f}",
+                row.flops,
+                row.bytes,
+                int(row.complete),
+                f"{row.intensity:.3f}",
+                f"{row.achieved_gflops:.3f}",
+                f"{row.achieved_gbps:.3f}",
+                f"{row.attainable_gflops:.3f}",
+                f"{row.efficiency:.4f}",
+                row.bound,
+            ]
+        )
+
+
+def _parse_arguments():
+    parser = argparse.ArgumentParser(
+        description="Generates a per-dispatch roofline report."
+    )
+    parser.add_argument(
+        "--statistics",
+        type=pathlib.Path,
+        required=True,
+        help="JSON output of --iree-scheduling-dump-statistics-format=json.",
+    )
+    parser.add_argument(
+        "--dispatch_trace",
+        type=pathlib.Path,
+        required=True,
+        help="Chrome trace JSON output of --device_profiling_mode=dispatch.",
+    )
+    parser.add_argument(
+        "--peak_gflops",
+        type=float,
+        required=True,
+        help="Peak compute throughput of the device in GFLOP/s.",
+    )
+    parser.add_argument(
+        "--peak_gbps",
+        type=float,
+        required=True,
+        help="Peak memory bandwidth of the device in GB/s.",
+    )
+    parser.add_argument(
+        "--format",
+        choices=["markdown", "csv"],
+        default="markdown",
+        help="Output format.",
+    )
+    parser.add_argument(
+        "--output",
+        type=pathlib.Path,
+        default=None,
+        help="Path to write the report to (default stdout).",
+    )
+    return parser.parse_args()
+
+
+def main(args: argparse.Namespace):
+    costs = load_dispatch_costs(json.loads(args.statistics.read_text()))
+    durations = load_dispatch_durations(
+        json.loads(args.dispatch_trace.read_text())
+    )
+    rows = build_roofline_rows(costs, durations, args.peak_gflops, args.peak_gbps)
+
+    output: TextIO = sys.stdout
+    if args.output is not None:
+        output = args.output.open("w")
+    if args.format == "csv":
+        write_csv(rows, output)
+    else:
+        write_markdown(rows, output)
+    if args.output is not None:
+        output.close()
+
+
+if __name__ == "__main__":
+    main(_parse_arguments())
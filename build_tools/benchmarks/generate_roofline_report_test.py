@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from io import StringIO
+import unittest
+
+from generate_roofline_report import (
+    DispatchCost,
+    build_roofline_rows,
+    load_dispatch_costs,
+    load_dispatch_durations,
+    write_markdown,
+)
+
+
+class GenerateRooflineReportTest(unittest.TestCase):
+    def test_load_dispatch_costs(self):
+        statistics = {
+            "stream-aggregate": {},
+            "executable-exports": [
+                {
+                    "executable": "ex",
+                    "export": "matmul",
+                    "flops": 65536,
+                    "bytes": 12288,
+                    "complete": True,
+                }
+            ],
+        }
+
+        costs = load_dispatch_costs(statistics)
+
+        self.assertEqual(
+            costs, {"matmul": DispatchCost(flops=65536, bytes=12288, complete=True)}
+        )
+
+    def test_load_dispatch_durations_skips_metadata(self):
+        trace = {
+            "traceEvents": [
+                {"ph": "M", "name": "thread_name", "args": {"name": "stream"}},
+                {"ph": "X", "name": "matmul", "ts": 0, "dur": 2.0},
+                {"ph": "X", "name": "matmul", "ts": 5, "dur": 4.0},
+            ]
+        }
+
+        durations = load_dispatch_durations(trace)
+
+        self.assertEqual(durations, {"matmul": [2.0, 4.0]})
+
+    def test_build_roofline_rows(self):
+        costs = {
+            # 1 GFLOP over 10 MB: compute bound on a 100 GFLOP/s 10 GB/s device.
+            "matmul": DispatchCost(
+                flops=1_000_000_000, bytes=10_000_000, complete=True
+            ),
+            # 1 MFLOP over 100 MB: memory bound.
+            "add": DispatchCost(flops=1_000_000, bytes=100_000_000, complete=False),
+        }
+        durations = {
+            "matmul": [20_000.0, 20_000.0],
+            "add": [20_000.0],
+            "unknown": [1.0],
+        }
+
+        rows = build_roofline_rows(costs, durations, peak_gflops=100, peak_gbps=10)
+
+        self.assertEqual([row.name for row in rows], ["matmul", "add"])
+        matmul, add = rows
+        self.assertAlmostEqual(matmul.achieved_gflops, 50.0)
+        self.assertAlmostEqual(matmul.attainable_gflops, 100.0)
+        self.assertAlmostEqual(matmul.efficiency, 0.5)
+        self.assertEqual(matmul.bound, "compute")
+        self.assertAlmostEqual(add.achieved_gbps, 5.0)
+        self.assertAlmostEqual(add.attainable_gflops, 0.1)
+        self.assertEqual(add.bound, "memory")
+
+    def test_write_markdown_marks_incomplete_estimates(self):
+        costs = {"add": DispatchCost(flops=10, bytes=100, complete=False)}
+        rows = build_roofline_rows(
+            costs, {"add": [1.0]}, peak_gflops=100, peak_gbps=10
+        )
+        output = StringIO()
+
+        write_markdown(rows, output)
+
+        self.assertIn("| add | 1 | 1.00 | >=0.10 |", output.getvalue())
+
+
+if __name__ == "__main__":
+    unittest.main()
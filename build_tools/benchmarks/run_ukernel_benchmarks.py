@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Runs the ukernel benchmark suite and writes benchmark results JSON.
+
+Runs the mmt4d, pack, and unpack ukernel benchmarks built from
+runtime/src/iree/builtins/ukernel/tools over a set of representative problem
+shapes. Every data type and ISA variant (AVX2, AVX-512 base/VNNI/BF16, AMX,
+NEON dotprod/i8mm, ...) that the benchmarks register and the host supports is
+measured; each is reported as its own series so that regressions can be
+attributed to a single ISA variant. The output can be compared with
+diff_local_benchmarks.py, which can also gate on regressions:
+
+  $ run_ukernel_benchmarks.py \\
+      --tools_dir=build/runtime/src/iree/builtins/ukernel/tools \\
+      --output=base.json
+  ... apply the change and rebuild ...
+  $ run_ukernel_benchmarks.py \\
+      --tools_dir=build/runtime/src/iree/builtins/ukernel/tools \\
+      --output=target.json
+  $ diff_local_benchmarks.py --base=base.json --target=target.json \\
+      --fail-on-regression
+"""
+
+import pathlib
+import sys
+
+# Add build_tools python dir to the search path.
+sys.path.insert(0, str(pathlib.Path(__file__).parent.with_name("python")))
+
+import argparse
+import json
+from dataclasses import dataclass
+from typing import Any, Dict, List, Sequence
+
+from common.benchmark_definition import (
+    IREE_DRIVERS_INFOS,
+    BenchmarkInfo,
+    BenchmarkLatency,
+    BenchmarkMemory,
+    BenchmarkMetrics,
+    BenchmarkResults,
+    BenchmarkRun,
+    DeviceInfo,
+    execute_cmd_and_get_stdout,
+)
+from common.linux_device_utils import get_linux_device_info
+
+# Prefix of all ukernel benchmark series names. Used to select the regression
+# thresholds in common/benchmark_thresholds.py.
+SERIES_NAME_PREFIX = "ukernel"
+
+# The CPU feature suffixes appended to benchmark names by
+# iree_uk_benchmark_register. Longer names first so that prefixes of other
+# features (fp16/fp16fml) don't match early. Benchmarks without a suffix run
+# the architecture-generic code.
+ISA_SUFFIXES = [
+    "avx512_base",
+    "avx512_vnni",
+    "avx512_bf16",
+    "avx2_fma",
+    "amx_bf16",
+    "amx_int8",
+    "fp16fml",
+    "fp16",
+    "bf16",
+    "dotprod",
+    "i8mm",
+    "sve",
+]
+GENERIC_ISA = "generic"
+
+TIME_UNIT_TO_NS = {"ns": 1, "us": 10**3, "ms": 10**6, "s": 10**9}
+
+
+@dataclass(frozen=True)
+class UkernelBenchmarkConfig(object):
+    """A benchmark binary run with a fixed set of flags.
+
+    - tool: the benchmark binary name.
+    - shape: label of the problem shape the flags select.
+    - flags: flags passed to the binary.
+    """
+
+    tool: str
+    shape: str
+    flags: Sequence[str]
+
+
+# mmt4d sizes are in tiles so the absolute shape scales with the tile size of
+# each ISA variant. M=1 exercises the narrow-M0 kernels used for matrix-vector
+# products.
+UKERNEL_BENCHMARK_CONFIGS = [
+    # Single row of tiles accumulating over a deep K; isolates the inner loop.
+    UkernelBenchmarkConfig(
+        "mmt4d_benchmark", "tile", ["--m_size=1", "--n_size=1", "--k_size=256"]
+    ),
+    # LLM token generation: matrix-vector products with wide N and deep K.
+    UkernelBenchmarkConfig(
+        "mmt4d_benchmark",
+        "llm_decode",
+        ["--m_size=1", "--n_size=128", "--k_size=256", "--accumulate=true"],
+    ),
+    # LLM prompt processing: large matmuls.
+    UkernelBenchmarkConfig(
+        "mmt4d_benchmark",
+        "llm_prefill",
+        ["--m_size=32", "--n_size=64", "--k_size=256", "--accumulate=true"],
+    ),
+    # CNN im2col convolutions: many output pixels, few channels, shallow K.
+    UkernelBenchmarkConfig(
+        "mmt4d_benchmark", "cnn", ["--m_size=256", "--n_size=4", "--k_size=36"]
+    ),
+    # pack/unpack register cache-resident and DRAM-sized working sets.
+    UkernelBenchmarkConfig("pack_benchmark", "default", []),
+    UkernelBenchmarkConfig("unpack_benchmark", "default", []),
+]
+
+
+def get_isa(benchmark_name: str) -> str:
+    """Returns the ISA variant a benchmark was registered for."""
+    for suffix in ISA_SUFFIXES:
+        if benchmark_name.endswith(f"_{suffix}"):
+            return suffix
+    return GENERIC_ISA
+
+
+def parse_ukernel_benchmark_json(
+    benchmark_json: Dict[str, Any],
+    config: UkernelBenchmarkConfig,
+    device_info: DeviceInfo,
+) -> List[BenchmarkRun]:
+    """Converts the JSON output of a ukernel benchmark binary run with
+    repetitions into benchmark runs, one per registered benchmark."""
+    aggregates: Dict[str, Dict[str, Dict[str, Any]]] = {}
+    for case in benchmark_json["benchmarks"]:
+        if case.get("run_type") != "aggregate":
+            continue
+        # Benchmarks are registered with real time: "<name>/real_time".
+        run_name = case["run_name"].split("/")[0]
+        aggregates.setdefault(run_name, {})[case["aggregate_name"]] = case
+
+    runs = []
+    for run_name, cases in aggregates.items():
+        real_time_object: Dict[str, Any] = dict(unit="ns")
+        cpu_time_object: Dict[str, Any] = dict(unit="ns")
+        for metric in ["mean", "median", "stddev"]:
+            case = cases[metric]
+            scale = TIME_UNIT_TO_NS[case["time_unit"]]
+            real_time_object[metric] = int(round(case["real_time"] * scale))
+            cpu_time_object[metric] = int(round(case["cpu_time"] * scale))
+
+        isa = get_isa(run_name)
+        name = (
+            f"{SERIES_NAME_PREFIX} {run_name} [{config.shape}] ({isa}) "
+            f"@ {device_info.cpu_abi}"
+        )
+        info = BenchmarkInfo(
+            name=name,
+            model_name=run_name,
+            model_tags=[config.shape],
+            model_source="ukernel",
+            bench_mode=[isa],
+            driver_info=IREE_DRIVERS_INFOS["iree-llvm-cpu-sync"],
+            device_info=device_info,
+            run_config_id=f"{config.tool}/{config.shape}/{run_name}",
+        )
+        no_memory = BenchmarkMemory(peak=0, allocated=0, freed=0, live=0, unit="bytes")
+        metrics = BenchmarkMetrics(
+            real_time=BenchmarkLatency.from_json_object(real_time_object),
+            cpu_time=BenchmarkLatency.from_json_object(cpu_time_object),
+            host_memory=no_memory,
+            device_memory=no_memory,
+            raw_data=cases,
+        )
+        runs.append(BenchmarkRun(info=info, metrics=metrics))
+    return runs
+
+
+def run_ukernel_benchmarks(
+    tools_dir: pathlib.Path,
+    configs: Sequence[UkernelBenchmarkConfig],
+    device_info: DeviceInfo,
+    repetitions: int,
+    benchmark_filter: str,
+    verbose: bool = False,
+) -> BenchmarkResults:
+    results = BenchmarkResults()
+    for config in configs:
+        tool_path = tools_dir / config.tool
+        if not tool_path.exists():
+            raise FileNotFoundError(f"Ukernel benchmark not found: {tool_path}")
+        cmd = [
+            str(tool_path),
+            *config.flags,
+            "--benchmark_format=json",
+            f"--benchmark_repetitions={repetitions}",
+            "--benchmark_report_aggregates_only=true",
+        ]
+        if benchmark_filter:
+            cmd.append(f"--benchmark_filter={benchmark_filter}")
+        stdout = execute_cmd_and_get_stdout(cmd, verbose=verbose)
+        results.benchmarks.extend(
+            parse_ukernel_benchmark_json(json.loads(stdout), config, device_info)
+        )
+    return results
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(
+        description="Runs the ukernel benchmark suite.",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog=__doc__,
+    )
+    parser.add_argument(
+        "--tools_dir",
+        type=pathlib.Path,
+        required=True,
+        help="Directory containing the built ukernel benchmark binaries.",
+    )
+    parser.add_argument(
+        "--output",
+        type=pathlib.Path,
+        required=True,
+        help="Path to write the benchmark results JSON to.",
+    )
+    parser.add_argument(
+        "--shapes",
+        nargs="*",
+        default=None,
+        help="Only run the given shapes (default all).",
+    )
+    parser.add_argument(
+        "--benchmark_filter",
+        default="",
+        help="Regex selecting the benchmarks to run within each binary.",
+    )
+    parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=5,
+        help="Number of repetitions to aggregate for each benchmark.",
+    )
+    parser.add_argument(
+        "--device_model", default="Unknown", help="Device model name."
+    )
+    parser.add_argument(
+        "--cpu_uarch", default=None, help="CPU microarchitecture, e.g. CascadeLake."
+    )
+    parser.add_argument(
+        "--commit", default="<unknown>", help="Commit the results are for."
+    )
+    parser.add_argument(
+        "--verbose",
+        action="store_true",
+        help="Print internal information during execution.",
+    )
+    return parser.parse_args()
+
+
+def main(args: argparse.Namespace):
+    configs = [
+        config
+        for config in UKERNEL_BENCHMARK_CONFIGS
+        if not args.shapes or config.shape in args.shapes
+    ]
+    device_info = get_linux_device_info(
+        device_model=args.device_model, cpu_uarch=args.cpu_uarch, verbose=args.verbose
+    )
+    results = run_ukernel_benchmarks(
+        tools_dir=args.tools_dir,
+        configs=configs,
+        device_info=device_info,
+        repetitions=args.repetitions,
+        benchmark_filter=args.benchmark_filter,
+        verbose=args.verbose,
+    )
+    results.set_commit(args.commit)
+    args.output.write_text(results.to_json_str())
+
+
+if __name__ == "__main__":
+    main(parse_arguments())
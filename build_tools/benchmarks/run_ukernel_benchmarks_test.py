@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+import unittest
+
+from common import benchmark_definition
+from common.benchmark_presentation import (
+    AggregateBenchmarkLatency,
+    get_regressed_benchmarks,
+)
+from run_ukernel_benchmarks import (
+    UkernelBenchmarkConfig,
+    get_isa,
+    parse_ukernel_benchmark_json,
+)
+
+DEVICE_INFO = benchmark_definition.DeviceInfo(
+    platform_type=benchmark_definition.PlatformType.LINUX,
+    model="Unknown",
+    cpu_abi="x86_64",
+    cpu_uarch="CascadeLake",
+    cpu_features=[],
+    gpu_name="Unknown",
+)
+CONFIG = UkernelBenchmarkConfig(
+    "mmt4d_benchmark", "llm_decode", ["--m_size=1", "--n_size=128"]
+)
+
+
+def _make_aggregate(run_name: str, aggregate_name: str, time: float):
+    return {
+        "name": f"{run_name}/real_time_{aggregate_name}",
+        "run_name": f"{run_name}/real_time",
+        "run_type": "aggregate",
+        "repetitions": 3,
+        "aggregate_name": aggregate_name,
+        "real_time": time,
+        "cpu_time": time * 2,
+        "time_unit": "us",
+    }
+
+
+class RunUkernelBenchmarksTest(unittest.TestCase):
+    def test_get_isa(self):
+        self.assertEqual(
+            get_isa("mmt4d_f32f32f32_tile_16x16x1_avx512_base"), "avx512_base"
+        )
+        self.assertEqual(
+            get_isa("mmt4d_s8s8s32_tile_16x16x2_avx512_vnni"), "avx512_vnni"
+        )
+        self.assertEqual(get_isa("mmt4d_f16f16f32_tile_8x8x1_fp16fml"), "fp16fml")
+        self.assertEqual(get_isa("mmt4d_s8s8s32_tile_8x8x8_i8mm"), "i8mm")
+        self.assertEqual(get_isa("mmt4d_f32f32f32_tile_8x8x1"), "generic")
+        self.assertEqual(get_isa("memcpy_wss_10000"), "generic")
+
+    def test_parse_ukernel_benchmark_json(self):
+        run_name = "mmt4d_s8s8s32_tile_16x16x2_avx512_vnni"
+        benchmark_json = {
+            "context": {},
+            "benchmarks": [
+                # Non-aggregate iterations are ignored.
+                {
+                    "name": f"{run_name}/real_time",
+                    "run_name": f"{run_name}/real_time",
+                    "run_type": "iteration",
+                    "real_time": 100.0,
+                    "cpu_time": 100.0,
+                    "time_unit": "us",
+                },
+                _make_aggregate(run_name, "mean", 1.5),
+                _make_aggregate(run_name, "median", 1.25),
+                _make_aggregate(run_name, "stddev", 0.5),
+                _make_aggregate(run_name, "cv", 0.1),
+            ],
+        }
+
+        runs = parse_ukernel_benchmark_json(benchmark_json, CONFIG, DEVICE_INFO)
+
+        self.assertEqual(len(runs), 1)
+        info = runs[0].info
+        self.assertEqual(
+            info.name, f"ukernel {run_name} [llm_decode] (avx512_vnni) @ x86_64"
+        )
+        self.assertEqual(info.model_name, run_name)
+        self.assertEqual(info.model_tags, ["llm_decode"])
+        self.assertEqual(info.bench_mode, ["avx512_vnni"])
+        self.assertEqual(info.run_config_id, f"mmt4d_benchmark/llm_decode/{run_name}")
+        self.assertEqual(
+            runs[0].metrics.real_time,
+            benchmark_definition.BenchmarkLatency(
+                mean=1500, median=1250, stddev=500, unit="ns"
+            ),
+        )
+        self.assertEqual(runs[0].metrics.cpu_time.mean, 3000)
+
+        # Results round-trip through the JSON format read by
+        # diff_local_benchmarks.py.
+        results = benchmark_definition.BenchmarkResults()
+        results.benchmarks.extend(runs)
+        decoded = benchmark_definition.BenchmarkResults.from_json_str(
+            results.to_json_str()
+        )
+        self.assertEqual(decoded.benchmarks[0].info, info)
+
+    def test_get_regressed_benchmarks(self):
+        def make_latency(isa: str, mean_time: int, base_mean_time: int):
+            run_name = f"mmt4d_f32f32f32_tile_16x16x1_{isa}"
+            runs = parse_ukernel_benchmark_json(
+                {
+                    "benchmarks": [
+                        _make_aggregate(run_name, "mean", mean_time / 1000),
+                        _make_aggregate(run_name, "median", mean_time / 1000),
+                        _make_aggregate(run_name, "stddev", 0),
+                    ]
+                },
+                CONFIG,
+                DEVICE_INFO,
+            )
+            return AggregateBenchmarkLatency(
+                name=runs[0].info.name,
+                benchmark_info=runs[0].info,
+                mean_time=mean_time,
+                median_time=mean_time,
+                stddev_time=0,
+                base_mean_time=base_mean_time,
+            )
+
+        # Ukernels use a 5% threshold rather than the 10% x86_64 default.
+        benchmarks = {
+            "avx2_fma": make_latency("avx2_fma", 1000, 1000),
+            "avx512_base": make_latency("avx512_base", 1070, 1000),
+        }
+
+        regressed = get_regressed_benchmarks(benchmarks)
+
+        self.assertEqual(list(regressed.keys()), ["avx512_base"])
+
+
+if __name__ == "__main__":
+    unittest.main()
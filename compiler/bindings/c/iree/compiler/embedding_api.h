@@ -136,6 +136,17 @@ IREE_EMBED_EXPORTED void ireeCompilerEnumeratePlugins(
 // options. If the CL environment was initialized, session options will be
 // bootstrapped from global flags.
 //
+// Sessions are intended to be long-lived: pass pipelines constructed by
+// invocations are cached on the session (keyed by the pipeline, compile phases,
+// and invocation options) and reused by later invocations until the session
+// flags are changed. All sessions share a single compiler thread pool.
+//
+// Invocations of the same session may run concurrently from multiple threads
+// so long as the session flags are not modified at the same time. Note that
+// diagnostics are scoped to the session: diagnostic handlers enabled on one
+// invocation may observe diagnostics from other invocations running
+// concurrently in the same session.
+//
 // Session creation cannot fail in a non-fatal way.
 //===----------------------------------------------------------------------===//
 
@@ -39,6 +39,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <limits>
+#include <mutex>
 
 #include "iree/compiler/API/Internal/Diagnostics.h"
 #include "iree/compiler/API/MLIRInterop.h"
@@ -53,6 +54,7 @@
 #include "iree/compiler/Tools/version.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "iree/compiler/embedding_api.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ManagedStatic.h"
@@ -61,6 +63,7 @@
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/CAPI/IR.h"
@@ -176,7 +179,10 @@ struct Error {
 
 struct GlobalInit {
   GlobalInit();
-  ~GlobalInit() { llvm::llvm_shutdown(); }
+  ~GlobalInit() {
+    threadPool.reset();
+    llvm::llvm_shutdown();
+  }
   void registerCommandLineOptions();
 
   // Reference count of balanced calls to ireeCompilerGlobalInitialize
@@ -186,6 +192,13 @@ struct GlobalInit {
   mlir::DialectRegistry registry;
   PluginManager pluginManager;
 
+  // Returns the thread pool shared by all session contexts or nullptr if
+  // multithreading has been disabled (i.e. via --mlir-disable-threading).
+  // Sharing the pool avoids each session spinning up its own set of threads.
+  llvm::ThreadPool *getThreadPool();
+  std::once_flag threadPoolOnce;
+  std::unique_ptr<llvm::ThreadPool> threadPool;
+
   // Command line handling.
   bool usesCommandLine = false;
   // Populated and retained if we have to copy and handle our own permuted
@@ -230,6 +243,20 @@ GlobalInit::GlobalInit() {
   pluginManager.registerGlobalDialects(registry);
 }
 
+llvm::ThreadPool *GlobalInit::getThreadPool() {
+  std::call_once(threadPoolOnce, [&]() {
+    // The MLIRContext command line options are private; probe a context
+    // constructed with the default threading mode to see if they disabled it.
+    if (usesCommandLine &&
+        !MLIRContext(MLIRContext::Threading::ENABLED)
+             .isMultithreadingEnabled()) {
+      return;
+    }
+    threadPool = std::make_unique<llvm::ThreadPool>();
+  });
+  return threadPool.get();
+}
+
 void GlobalInit::registerCommandLineOptions() {
   // Register MLIRContext command-line options like
   // -mlir-print-op-on-diagnostic.
@@ -255,6 +282,18 @@ void GlobalInit::registerCommandLineOptions() {
   pluginManager.initializeCLI();
 }
 
+// A pass manager with a fully constructed pipeline retained by a session for
+// reuse across invocations.
+struct CachedPassManager {
+  std::unique_ptr<PassManager> passManager;
+  // Crash reproducer stream factory of the invocation running the pass
+  // manager. The pass manager's reproducer generator forwards to it as the
+  // generator can only be configured once.
+  std::shared_ptr<PassManager::ReproducerStreamFactory> crashReproducerFactory;
+  // Session options generation the pipeline was constructed with.
+  int64_t optionsGeneration = 0;
+};
+
 struct Session {
   Session(GlobalInit &globalInit);
 
@@ -268,6 +307,8 @@ struct Session {
       errorMessage.append(message.data(), message.size());
     };
 
+    // Pipelines constructed with the previous options must not be reused.
+    clearPassManagerCache();
     if (failed(binder.parseArguments(argc, argv, callback))) {
       return new Error(std::move(errorMessage));
     }
@@ -284,6 +325,7 @@ struct Session {
   }
 
   LogicalResult activatePluginsOnce() {
+    std::lock_guard<std::mutex> guard(pluginActivationMutex);
     if (!pluginsActivated) {
       pluginsActivated = true;
       if (failed(pluginSession.initializePlugins())) {
@@ -304,6 +346,48 @@ struct Session {
     return pluginActivationStatus;
   }
 
+  // Takes a pass manager previously constructed for |key| out of the cache or
+  // returns nullptr if none is available. The caller has exclusive use of the
+  // pass manager until it is returned with releasePassManager.
+  std::unique_ptr<CachedPassManager> acquirePassManager(StringRef key) {
+    std::lock_guard<std::mutex> guard(passManagerCacheMutex);
+    auto it = passManagerCache.find(key);
+    if (it == passManagerCache.end() || it->second.empty())
+      return nullptr;
+    return it->second.pop_back_val();
+  }
+
+  // Returns a pass manager to the cache for reuse by subsequent invocations
+  // with the same |key|. Pass managers constructed with since-changed options
+  // or in excess of what concurrent invocations have needed are dropped.
+  void releasePassManager(StringRef key,
+                          std::unique_ptr<CachedPassManager> passManager) {
+    std::lock_guard<std::mutex> guard(passManagerCacheMutex);
+    if (passManager->optionsGeneration != optionsGeneration)
+      return;
+    if (!passManagerCache.contains(key) &&
+        passManagerCache.size() >= kMaxCachedPipelines) {
+      // Arbitrary textual pipelines may produce unbounded keys; start over
+      // instead of tracking usage.
+      passManagerCache.clear();
+    }
+    auto &passManagers = passManagerCache[key];
+    if (passManagers.size() < kMaxCachedPassManagersPerPipeline) {
+      passManagers.push_back(std::move(passManager));
+    }
+  }
+
+  void clearPassManagerCache() {
+    std::lock_guard<std::mutex> guard(passManagerCacheMutex);
+    ++optionsGeneration;
+    passManagerCache.clear();
+  }
+
+  int64_t getOptionsGeneration() {
+    std::lock_guard<std::mutex> guard(passManagerCacheMutex);
+    return optionsGeneration;
+  }
+
   GlobalInit &globalInit;
   // When created, the Session owns the context, but there are situations
   // where ownership can be released, in which case the ownedContext will be
@@ -324,6 +408,7 @@ struct Session {
   // We lazily activate plugins on the first invocation. This allows plugin
   // activation to be configured at the session level via the API, if
   // desired.
+  std::mutex pluginActivationMutex;
   bool pluginsActivated = false;
   LogicalResult pluginActivationStatus{failure()};
 
@@ -338,12 +423,27 @@ struct Session {
 #ifdef IREE_HAVE_C_OUTPUT_FORMAT
   IREE::VM::CTargetOptions cTargetOptions;
 #endif
+
+  // Pass managers with constructed pipelines keyed by the pipeline and
+  // invocation configuration. Multiple instances are retained per key so that
+  // concurrent invocations each have their own. Declared last so the pass
+  // managers are destroyed before the registries and context they reference.
+  static constexpr size_t kMaxCachedPipelines = 16;
+  static constexpr size_t kMaxCachedPassManagersPerPipeline = 4;
+  std::mutex passManagerCacheMutex;
+  int64_t optionsGeneration = 0;
+  llvm::StringMap<SmallVector<std::unique_ptr<CachedPassManager>>>
+      passManagerCache;
 };
 
 Session::Session(GlobalInit &globalInit)
-    : globalInit(globalInit), ownedContext(std::make_unique<MLIRContext>()),
+    : globalInit(globalInit), ownedContext(std::make_unique<MLIRContext>(
+                                  MLIRContext::Threading::DISABLED)),
       context(*ownedContext), binder(OptionsBinder::local()),
       pluginSession(globalInit.pluginManager, binder, pluginManagerOptions) {
+  if (auto *threadPool = globalInit.getThreadPool()) {
+    context.setThreadPool(*threadPool);
+  }
   context.allowUnregisteredDialects();
   context.appendDialectRegistry(globalInit.registry);
 
@@ -613,11 +713,13 @@ void Output::keep() {
 
 // Invocation corresponds to iree_compiler_invocation_t
 struct Invocation {
-  using PassManagerInitializer = std::function<void(PassManager &pm)>;
   Invocation(Session &session);
   ~Invocation();
   bool initializeInvocation();
-  std::unique_ptr<PassManager> createPassManager();
+  std::unique_ptr<CachedPassManager> createPassManager();
+  bool runCachedPipeline(
+      StringRef pipelineKey,
+      function_ref<LogicalResult(PassManager &)> buildPipeline);
   bool parseSource(Source &source);
   Operation *exportModule();
   bool importModule(Operation *inputModule, bool steal);
@@ -632,9 +734,12 @@ struct Invocation {
   Error *outputHALExecutable(Output &output);
 
   Session &session;
-  llvm::SmallVector<PassManagerInitializer> passManagerInitializers;
   IREEVMPipelineHooks pipelineHooks;
 
+  // Crash reproducer configuration (if enabled).
+  PassManager::ReproducerStreamFactory crashReproducerFactory;
+  bool genLocalCrashReproducer = false;
+
   // Diagnostic handlers are instantiated upon parsing the source (when we
   // have the SrcMgr) and held for the duration of the invocation. Each will
   // de-register upon destruction if set.
@@ -678,8 +783,11 @@ Invocation::~Invocation() {
   }
 }
 
-std::unique_ptr<PassManager> Invocation::createPassManager() {
-  auto passManager = std::make_unique<PassManager>(&session.context);
+std::unique_ptr<CachedPassManager> Invocation::createPassManager() {
+  auto cached = std::make_unique<CachedPassManager>();
+  cached->optionsGeneration = session.getOptionsGeneration();
+  cached->passManager = std::make_unique<PassManager>(&session.context);
+  auto &passManager = cached->passManager;
   if (session.globalInit.usesCommandLine) {
     if (failed(mlir::applyPassManagerCLOptions(*passManager))) {
       emitError(UnknownLoc::get(&session.context))
@@ -689,10 +797,50 @@ std::unique_ptr<PassManager> Invocation::createPassManager() {
   }
   passManager->addInstrumentation(std::make_unique<PassTracing>());
   passManager->enableVerifier(enableVerifier);
-  for (auto &init : passManagerInitializers) {
-    init(*passManager);
+  if (crashReproducerFactory) {
+    cached->crashReproducerFactory =
+        std::make_shared<PassManager::ReproducerStreamFactory>();
+    passManager->enableCrashReproducerGeneration(
+        [factory = cached->crashReproducerFactory](std::string &errorMessage)
+            -> std::unique_ptr<PassManager::ReproducerStream> {
+          return (*factory)(errorMessage);
+        },
+        genLocalCrashReproducer);
   }
-  return passManager;
+  return cached;
+}
+
+bool Invocation::runCachedPipeline(
+    StringRef pipelineKey,
+    function_ref<LogicalResult(PassManager &)> buildPipeline) {
+  // Everything that influences the constructed pass manager must be part of
+  // the key. Session options are handled by dropping the cache when they
+  // change.
+  std::string key = pipelineKey.str();
+  if (enableVerifier)
+    key += ";verify";
+  if (crashReproducerFactory)
+    key += genLocalCrashReproducer ? ";local-reproducer" : ";reproducer";
+
+  auto cached = session.acquirePassManager(key);
+  if (!cached) {
+    cached = createPassManager();
+    if (failed(buildPipeline(*cached->passManager)))
+      return false;
+  }
+  if (cached->crashReproducerFactory) {
+    *cached->crashReproducerFactory = crashReproducerFactory;
+  }
+  if (failed(cached->passManager->run(parsedModule))) {
+    // Don't reuse pass managers that may have been left in an unexpected
+    // state (i.e. after crash recovery).
+    return false;
+  }
+  if (cached->crashReproducerFactory) {
+    *cached->crashReproducerFactory = nullptr;
+  }
+  session.releasePassManager(key, std::move(cached));
+  return true;
 }
 
 bool Invocation::initializeInvocation() {
@@ -839,7 +987,7 @@ bool Invocation::getCompilationPhase(IREEVMPipelinePhase &compileFrom,
 }
 
 bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
-  auto passManager = createPassManager();
+  bool result = false;
   switch (pipeline) {
   case IREE_COMPILER_PIPELINE_STD: {
     IREEVMPipelinePhase compileFrom;
@@ -860,12 +1008,17 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
       }
     }
 
-    buildIREEVMTransformPassPipeline(
-        session.targetRegistry, session.bindingOptions, session.inputOptions,
-        session.preprocessingOptions, session.highLevelOptimizationOptions,
-        session.schedulingOptions, session.halTargetOptions,
-        session.vmTargetOptions, pipelineHooks, *passManager, compileFrom,
-        compileTo);
+    result = runCachedPipeline(
+        "std:" + compileFromPhaseName + ":" + compileToPhaseName,
+        [&](PassManager &passManager) {
+          buildIREEVMTransformPassPipeline(
+              session.targetRegistry, session.bindingOptions,
+              session.inputOptions, session.preprocessingOptions,
+              session.highLevelOptimizationOptions, session.schedulingOptions,
+              session.halTargetOptions, session.vmTargetOptions,
+              pipelineHooks, passManager, compileFrom, compileTo);
+          return success();
+        });
     break;
   }
   case IREE_COMPILER_PIPELINE_HAL_EXECUTABLE: {
@@ -882,8 +1035,11 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
              "op";
       return false;
     }
-    IREE::HAL::buildHALTransformPassPipeline(
-        *passManager, session.targetRegistry, session.halTargetOptions);
+    result = runCachedPipeline("hal-executable", [&](PassManager &passManager) {
+      IREE::HAL::buildHALTransformPassPipeline(
+          passManager, session.targetRegistry, session.halTargetOptions);
+      return success();
+    });
     break;
   }
   case IREE_COMPILER_PIPELINE_PRECOMPILE: {
@@ -893,11 +1049,17 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
       return false;
     }
 
-    buildIREEPrecompileTransformPassPipeline(
-        session.targetRegistry, session.bindingOptions, session.inputOptions,
-        session.preprocessingOptions, session.highLevelOptimizationOptions,
-        session.schedulingOptions, session.halTargetOptions, pipelineHooks,
-        *passManager, compileFrom, compileTo);
+    result = runCachedPipeline(
+        "precompile:" + compileFromPhaseName + ":" + compileToPhaseName,
+        [&](PassManager &passManager) {
+          buildIREEPrecompileTransformPassPipeline(
+              session.targetRegistry, session.bindingOptions,
+              session.inputOptions, session.preprocessingOptions,
+              session.highLevelOptimizationOptions, session.schedulingOptions,
+              session.halTargetOptions, pipelineHooks, passManager,
+              compileFrom, compileTo);
+          return success();
+        });
     break;
   }
   default:
@@ -905,7 +1067,7 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
     return false;
   }
 
-  if (failed(passManager->run(parsedModule))) {
+  if (!result) {
     return false;
   }
   // Done with the pipeline, mark the start of a new 'frame'.
@@ -914,14 +1076,11 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
 }
 
 bool Invocation::runTextualPassPipeline(const char *textPassPipeline) {
-  auto passManager = createPassManager();
-  if (failed(mlir::parsePassPipeline(textPassPipeline, *passManager,
-                                     llvm::errs())))
-    return false;
-  if (failed(passManager->run(parsedModule))) {
-    return false;
-  }
-  return true;
+  return runCachedPipeline(
+      std::string("text:") + textPassPipeline, [&](PassManager &passManager) {
+        return mlir::parsePassPipeline(textPassPipeline, passManager,
+                                       llvm::errs());
+      });
 }
 
 Error *Invocation::outputIR(Output &output) {
@@ -1290,27 +1449,24 @@ void ireeCompilerInvocationSetCrashHandler(
     iree_compiler_output_t *output;
   };
 
-  unwrap(inv)->passManagerInitializers.push_back(
-      [=](mlir::PassManager &passManager) {
-        passManager.enableCrashReproducerGeneration(
-            [=](std::string &errorMessage)
-                -> std::unique_ptr<mlir::PassManager::ReproducerStream> {
-              iree_compiler_output_t *output = nullptr;
-              auto error = onCrashCallback(&output, userData);
-              if (error) {
-                errorMessage = ireeCompilerErrorGetMessage(error);
-                return nullptr;
-              }
-
-              if (!output) {
-                errorMessage = "callback did not set output";
-                return nullptr;
-              }
-
-              return std::make_unique<StreamImpl>(output);
-            },
-            /*genLocalReproducer=*/genLocalReproducer);
-      });
+  unwrap(inv)->genLocalCrashReproducer = genLocalReproducer;
+  unwrap(inv)->crashReproducerFactory =
+      [=](std::string &errorMessage)
+      -> std::unique_ptr<mlir::PassManager::ReproducerStream> {
+    iree_compiler_output_t *output = nullptr;
+    auto error = onCrashCallback(&output, userData);
+    if (error) {
+      errorMessage = ireeCompilerErrorGetMessage(error);
+      return nullptr;
+    }
+
+    if (!output) {
+      errorMessage = "callback did not set output";
+      return nullptr;
+    }
+
+    return std::make_unique<StreamImpl>(output);
+  };
 }
 
 bool ireeCompilerInvocationParseSource(iree_compiler_invocation_t *inv,
@@ -38,14 +38,13 @@ static void shutdownCompiler(struct compiler_state_t *state) {
   ireeCompilerGlobalShutdown();
 }
 
-int main(int argc, char **argv) {
-  struct compiler_state_t state;
-  initializeCompiler(&state);
-
+// Compiles a simple module in a new invocation of the session and returns
+// 0 on success.
+static int compileSimpleMul(struct compiler_state_t *state) {
   // Important: The compiler expects a top-level 'module' and in order to
   // parse that, it must be explicitly wrapped as such.
   MlirOperation module = mlirOperationCreateParse(
-      state.context,
+      state->context,
       mlirStringRefCreateFromCString(
           "module {"
           "func.func @simple_mul(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) "
@@ -57,47 +56,32 @@ int main(int argc, char **argv) {
           "}\n"),
       mlirStringRefCreateFromCString("source.mlir"));
   if (mlirOperationIsNull(module)) {
-    // TODO: Shutdown.
-    return false;
-  }
-
-  // Set flags.
-  iree_compiler_error_t *err;
-  const char *flags[] = {
-      "--iree-hal-target-backends=vmvx",
-  };
-  err = ireeCompilerSessionSetFlags(state.session, 1, flags);
-  if (err) {
-    fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
-    mlirOperationDestroy(module);
-    shutdownCompiler(&state);
     return 1;
   }
 
   // Import module.
-  iree_compiler_invocation_t *inv = ireeCompilerInvocationCreate(state.session);
+  iree_compiler_invocation_t *inv =
+      ireeCompilerInvocationCreate(state->session);
   if (!ireeCompilerInvocationImportStealModule(inv, module)) {
     // ireeCompilerInvocationCreate takes ownership of the module regardless
     // of success or error, so we let it destroy it.
     ireeCompilerInvocationDestroy(inv);
-    shutdownCompiler(&state);
     return 1;
   }
 
   // Compile.
   if (!ireeCompilerInvocationPipeline(inv, IREE_COMPILER_PIPELINE_STD)) {
     ireeCompilerInvocationDestroy(inv);
-    shutdownCompiler(&state);
     return 1;
   }
 
   // Output.
+  iree_compiler_error_t *err;
   iree_compiler_output_t *output;
   err = ireeCompilerOutputOpenMembuffer(&output);
   if (err) {
     fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
     ireeCompilerInvocationDestroy(inv);
-    shutdownCompiler(&state);
     return 1;
   }
   err = ireeCompilerInvocationOutputVMBytecode(inv, output);
@@ -105,7 +89,6 @@ int main(int argc, char **argv) {
     fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
     ireeCompilerOutputDestroy(output);
     ireeCompilerInvocationDestroy(inv);
-    shutdownCompiler(&state);
     return 1;
   }
 
@@ -117,13 +100,40 @@ int main(int argc, char **argv) {
     fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
     ireeCompilerOutputDestroy(output);
     ireeCompilerInvocationDestroy(inv);
-    shutdownCompiler(&state);
     return 1;
   }
 
   printf("Success! Generated vmfb size: %d\n", (int)bytecodeSize);
   ireeCompilerOutputDestroy(output);
   ireeCompilerInvocationDestroy(inv);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  struct compiler_state_t state;
+  initializeCompiler(&state);
+
+  // Set flags.
+  iree_compiler_error_t *err;
+  const char *flags[] = {
+      "--iree-hal-target-backends=vmvx",
+  };
+  err = ireeCompilerSessionSetFlags(state.session, 1, flags);
+  if (err) {
+    fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
+    shutdownCompiler(&state);
+    return 1;
+  }
+
+  // Compile twice: the second invocation reuses the pass pipeline cached on
+  // the session by the first.
+  for (int i = 0; i < 2; ++i) {
+    if (compileSimpleMul(&state) != 0) {
+      shutdownCompiler(&state);
+      return 1;
+    }
+  }
+
   shutdownCompiler(&state);
   return 0;
 }
@@ -27,6 +27,10 @@ enum class InvocationModel {
   Sync,
   // Exposes one wait fence for all inputs and one signal fence for all outputs.
   CoarseFences,
+  // Exposes one wait fence for each tensor input and one signal fence for all
+  // outputs. This allows execution depending only on some inputs to begin
+  // while others are still being produced.
+  FineFences,
 };
 
 struct InvocationOptions : public PassPipelineOptions<InvocationOptions> {
@@ -40,7 +44,10 @@ struct InvocationOptions : public PassPipelineOptions<InvocationOptions> {
                      "Fully synchronous behavior with no fences."),
           clEnumValN(IREE::ABI::InvocationModel::CoarseFences, "coarse-fences",
                      "Exposes one wait fence for all inputs and one signal "
-                     "fence for all outputs.")),
+                     "fence for all outputs."),
+          clEnumValN(IREE::ABI::InvocationModel::FineFences, "fine-fences",
+                     "Exposes one wait fence for each tensor input and one "
+                     "signal fence for all outputs.")),
   };
 };
 
@@ -32,6 +32,8 @@ getInvocationModel(Operation *op, IREE::ABI::InvocationModel defaultModel) {
     return defaultModel;
   if (modelAttr == "coarse-fences") {
     return IREE::ABI::InvocationModel::CoarseFences;
+  } else if (modelAttr == "fine-fences") {
+    return IREE::ABI::InvocationModel::FineFences;
   } else {
     return IREE::ABI::InvocationModel::Sync;
   }
@@ -245,6 +247,12 @@ static LogicalResult wrapImportFunc(IREE::ABI::InvocationModel invocationModel,
                                     mlir::ModuleOp moduleOp,
                                     func::FuncOp importOp,
                                     SymbolTable &symbolTable) {
+  // Imports receive their tensor arguments from a single barrier today so
+  // there's nothing to gain from splitting the wait fence.
+  if (invocationModel == IREE::ABI::InvocationModel::FineFences) {
+    invocationModel = IREE::ABI::InvocationModel::CoarseFences;
+  }
+
   // Replace all existing calls to the import to instead call the wrapper.
   auto publicName = importOp.getName().str();
   auto privateName = "_" + publicName;
@@ -315,6 +323,10 @@ static void populateReflectionAttrs(IREE::ABI::InvocationModel invocationModel,
     attrs.emplace_back(StringAttr::get(context, "iree.abi.model"),
                        StringAttr::get(context, "coarse-fences"));
     break;
+  case IREE::ABI::InvocationModel::FineFences:
+    attrs.emplace_back(StringAttr::get(context, "iree.abi.model"),
+                       StringAttr::get(context, "fine-fences"));
+    break;
   }
 
   if (!attrs.empty()) {
@@ -379,6 +391,16 @@ createExportWrapperFunc(IREE::ABI::InvocationModel invocationModel,
     argAttrDict.push_back(nullptr);  // wait
     argAttrDict.push_back(nullptr);  // signal
     break;
+  case IREE::ABI::InvocationModel::FineFences:
+    for (auto oldType : oldExportType.getInputs()) {
+      if (llvm::isa<TensorType>(oldType)) {
+        inputTypes.push_back(fenceType); // wait
+        argAttrDict.push_back(nullptr);  // wait
+      }
+    }
+    inputTypes.push_back(fenceType); // signal
+    argAttrDict.push_back(nullptr);  // signal
+    break;
   }
   SmallVector<Type> resultTypes;
   for (auto oldType : oldExportType.getResults()) {
@@ -424,20 +446,36 @@ createExportWrapperFunc(IREE::ABI::InvocationModel invocationModel,
   }
 
   // Build a map of each I/O argument to the fence that covers them.
-  // TODO(benvanik): actually support a map; for now we just handle the 1:M
-  // coarse mode where all inputs are covered by a single wait fence and all
+  // In the coarse mode all inputs are covered by a single wait fence and in the
+  // fine mode each tensor input has its own wait fence. In both cases all
   // outputs are covered by a single signal fence.
-  Value waitFence;
+  SmallVector<Value> waitFences(oldExportType.getNumInputs());
   Value signalFence;
   switch (invocationModel) {
   default:
   case IREE::ABI::InvocationModel::Sync:
     break;
-  case IREE::ABI::InvocationModel::CoarseFences:
-    waitFence = entryBlock->getArgument(entryBlock->getNumArguments() - 2);
+  case IREE::ABI::InvocationModel::CoarseFences: {
+    auto waitFence = entryBlock->getArgument(entryBlock->getNumArguments() - 2);
+    for (auto [argIndex, oldType] :
+         llvm::enumerate(oldExportType.getInputs())) {
+      if (llvm::isa<TensorType>(oldType))
+        waitFences[argIndex] = waitFence;
+    }
     signalFence = entryBlock->getArgument(entryBlock->getNumArguments() - 1);
     break;
   }
+  case IREE::ABI::InvocationModel::FineFences: {
+    unsigned fenceIndex = oldExportType.getNumInputs();
+    for (auto [argIndex, oldType] :
+         llvm::enumerate(oldExportType.getInputs())) {
+      if (llvm::isa<TensorType>(oldType))
+        waitFences[argIndex] = entryBlock->getArgument(fenceIndex++);
+    }
+    signalFence = entryBlock->getArgument(entryBlock->getNumArguments() - 1);
+    break;
+  }
+  }
 
   // Marshal arguments.
   SmallVector<Value> arguments;
@@ -449,7 +487,7 @@ createExportWrapperFunc(IREE::ABI::InvocationModel invocationModel,
           exportOp.getArgAttrOfType<TypeAttr>(argIndex, "iree.abi.encoding");
       auto importOp = entryBuilder.create<IREE::HAL::TensorImportOp>(
           arg.getLoc(), oldType, arg,
-          encoding ? encoding : TypeAttr::get(oldType), waitFence,
+          encoding ? encoding : TypeAttr::get(oldType), waitFences[argIndex],
           inferArgumentName(argIndex, argAttrDict, entryBuilder));
       arguments.push_back(importOp.getTarget());
     } else {
@@ -621,7 +659,10 @@ private:
                      "Fully synchronous behavior with no fences."),
           clEnumValN(IREE::ABI::InvocationModel::CoarseFences, "coarse-fences",
                      "Exposes one wait fence for all inputs and one signal "
-                     "fence for all outputs.")),
+                     "fence for all outputs."),
+          clEnumValN(IREE::ABI::InvocationModel::FineFences, "fine-fences",
+                     "Exposes one wait fence for each tensor input and one "
+                     "signal fence for all outputs.")),
   };
 };
 
@@ -0,0 +1,63 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-abi-wrap-entry-points{invocation-model=fine-fences})' --split-input-file %s | FileCheck %s
+
+// Tests that each tensor input gets its own wait fence that the import of the
+// tensor waits on while all outputs are covered by a single signal fence.
+
+// CHECK-LABEL: func.func @asyncEntry(
+//  CHECK-SAME:   %[[ARG0:.+]]: !hal.buffer_view, %[[ARG1:.+]]: i32, %[[ARG2:.+]]: !hal.buffer_view, %[[WAIT0:.+]]: !hal.fence, %[[WAIT2:.+]]: !hal.fence, %[[SIGNAL:.+]]: !hal.fence
+//  CHECK-SAME: -> (
+//  CHECK-SAME:   !hal.buffer_view
+//  CHECK-SAME: ) attributes {
+//  CHECK-SAME:   iree.abi.stub
+//  CHECK-SAME:   iree.reflection = {iree.abi.model = "fine-fences"}
+//  CHECK-SAME: } {
+//  CHECK-NEXT:   %[[ARG0_TENSOR:.+]] = hal.tensor.import wait(%[[WAIT0]]) => %[[ARG0]] "input 0" : !hal.buffer_view -> tensor<4xf32>
+//  CHECK-NEXT:   %[[ARG2_TENSOR:.+]] = hal.tensor.import wait(%[[WAIT2]]) => %[[ARG2]] "input 2" : !hal.buffer_view -> tensor<4xf32>
+//  CHECK-NEXT:   %[[RESULT_TENSOR:.+]] = call @_asyncEntry(%[[ARG0_TENSOR]], %[[ARG1]], %[[ARG2_TENSOR]])
+//  CHECK-NEXT:   %[[READY_TENSOR:.+]] = hal.tensor.barrier join(%[[RESULT_TENSOR]] : tensor<4xf32>) => %[[SIGNAL]] : !hal.fence
+//  CHECK-NEXT:   %[[RET0_VIEW:.+]] = hal.tensor.export %[[READY_TENSOR]] "output 0" : tensor<4xf32> -> !hal.buffer_view
+//  CHECK-NEXT:   return %[[RET0_VIEW]] : !hal.buffer_view
+//  CHECK-NEXT: }
+
+// CHECK-LABEL: func.func private @_asyncEntry(
+func.func @asyncEntry(%arg0: tensor<4xf32>, %arg1: i32, %arg2: tensor<4xf32>) -> tensor<4xf32> {
+  %0 = arith.addf %arg0, %arg2 : tensor<4xf32>
+  return %0 : tensor<4xf32>
+}
+
+// -----
+
+// Tests that functions without tensor inputs only get the signal fence.
+
+// CHECK-LABEL: func.func @primitiveArgOnly
+//  CHECK-SAME: (%[[ARG0:.+]]: i32, %[[SIGNAL:.+]]: !hal.fence)
+//  CHECK-NEXT:   call @_primitiveArgOnly(%[[ARG0]])
+//  CHECK-NEXT:   hal.fence.signal<%[[SIGNAL]] : !hal.fence>
+//  CHECK-NEXT:   return
+
+// CHECK-LABEL: func.func private @_primitiveArgOnly(
+func.func @primitiveArgOnly(%arg0: i32) {
+  %0 = arith.addi %arg0, %arg0 : i32
+  util.optimization_barrier %0 : i32
+  return
+}
+
+// -----
+
+// Tests that imports fall back to a single wait fence covering all of the
+// tensors passed to them.
+
+// CHECK-LABEL: func.func private @import(!hal.buffer_view, !hal.buffer_view, !hal.fence, !hal.fence) -> !hal.buffer_view
+func.func private @import(tensor<?x2xi32>, tensor<?x4xi32>) -> tensor<2x?xi32> attributes {nosideeffects}
+
+// CHECK: func.func private @_import(%[[ARG0_TENSOR:.+]]: tensor<?x2xi32>, %[[ARG1_TENSOR:.+]]: tensor<?x4xi32>) -> tensor<2x?xi32> {
+//      CHECK:   %[[WAIT:.+]] = hal.fence.create
+//      CHECK:   hal.tensor.barrier join(%[[ARG0_TENSOR]], %[[ARG1_TENSOR]] : tensor<?x2xi32>, tensor<?x4xi32>) => %[[WAIT]] : !hal.fence
+//      CHECK:   call @import({{.+}}, %[[WAIT]], %{{.+}})
+
+// CHECK: func.func private @caller
+func.func private @caller(%arg0: tensor<?x2xi32>, %arg1: tensor<?x4xi32>) -> tensor<2x?xi32> {
+  // CHECK: call @_import
+  %0 = call @import(%arg0, %arg1) : (tensor<?x2xi32>, tensor<?x4xi32>) -> tensor<2x?xi32>
+  return %0 : tensor<2x?xi32>
+}
@@ -6,7 +6,9 @@
 
 #include "iree/compiler/Codegen/Common/PassDetail.h"
 #include "iree/compiler/Codegen/Common/Passes.h"
+#include "llvm/ADT/STLExtras.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -24,6 +26,56 @@ static void addContractFMF(Operation *op) {
           [&](auto llvmOp) { llvmOp.setFastmathFlags(contract); });
 }
 
+/// Returns true if |type| is a floating-point scalar or vector.
+static bool isFloatLike(Type type) {
+  if (auto vectorType = dyn_cast<VectorType>(type)) {
+    type = vectorType.getElementType();
+  }
+  return isa<FloatType>(type);
+}
+
+/// Returns true if the ops in |funcOp| may produce results that depend on the
+/// floating-point environment (such as whether denormals are flushed to zero).
+/// Ops that only move values around produce the same bits in any environment.
+/// Direct calls are skipped as callees are tagged on their own and target
+/// backends combine the tags across the call graph. Indirect calls and inline
+/// assembly are conservatively treated as dependent.
+static bool dependsOnFPUState(LLVM::LLVMFuncOp funcOp) {
+  auto walkResult = funcOp.walk([](Operation *op) {
+    if (auto callOp = dyn_cast<LLVM::CallOp>(op)) {
+      return callOp.getCallee() ? WalkResult::advance()
+                                : WalkResult::interrupt();
+    }
+    if (isa<LLVM::InlineAsmOp>(op)) {
+      return WalkResult::interrupt();
+    }
+    if (isa<LLVM::ConstantOp, LLVM::LoadOp, LLVM::StoreOp, LLVM::BitcastOp,
+            LLVM::SelectOp, LLVM::GEPOp, LLVM::ExtractElementOp,
+            LLVM::InsertElementOp, LLVM::ExtractValueOp, LLVM::InsertValueOp,
+            LLVM::ShuffleVectorOp, LLVM::MaskedLoadOp, LLVM::MaskedStoreOp>(
+            op)) {
+      return WalkResult::advance();
+    }
+    if (llvm::any_of(op->getOperandTypes(), isFloatLike) ||
+        llvm::any_of(op->getResultTypes(), isFloatLike)) {
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  return walkResult.wasInterrupted();
+}
+
+/// Appends |name| to the passthrough attributes of |funcOp|.
+static void addPassthroughAttr(LLVM::LLVMFuncOp funcOp, StringRef name) {
+  Builder builder(funcOp.getContext());
+  SmallVector<Attribute> passthroughAttrs;
+  if (auto existingAttrs = funcOp.getPassthroughAttr()) {
+    llvm::append_range(passthroughAttrs, existingAttrs);
+  }
+  passthroughAttrs.push_back(builder.getStringAttr(name));
+  funcOp.setPassthroughAttr(builder.getArrayAttr(passthroughAttrs));
+}
+
 namespace {
 
 /// Add the corresponding fast-math flags to operations given a floating-point
@@ -33,15 +85,30 @@ struct AddFastMathFlagsPass
     : public AddFastMathFlagsBase<AddFastMathFlagsPass> {
 public:
   using AddFastMathFlagsBase::AddFastMathFlagsBase;
+  AddFastMathFlagsPass(bool preserveDenormals) {
+    this->preserveDenormals = preserveDenormals;
+  }
 
   void runOnOperation() override {
-    getOperation()->walk([](Operation *op) { addContractFMF(op); });
+    auto funcOp = getOperation();
+    funcOp->walk([](Operation *op) { addContractFMF(op); });
+
+    // Declare the floating-point environment the function requires so that
+    // hosts only switch the FPU state of their threads when needed.
+    if (funcOp.isExternal())
+      return;
+    if (!dependsOnFPUState(funcOp)) {
+      addPassthroughAttr(funcOp, kFPUAgnosticAttrName);
+    }
+    if (preserveDenormals) {
+      addPassthroughAttr(funcOp, kFPUPreserveDenormalsAttrName);
+    }
   }
 };
 
 } // namespace
 
 std::unique_ptr<OperationPass<LLVM::LLVMFuncOp>>
-mlir::iree_compiler::createAddFastMathFlagsPass() {
-  return std::make_unique<AddFastMathFlagsPass>();
+mlir::iree_compiler::createAddFastMathFlagsPass(bool preserveDenormals) {
+  return std::make_unique<AddFastMathFlagsPass>(preserveDenormals);
 }
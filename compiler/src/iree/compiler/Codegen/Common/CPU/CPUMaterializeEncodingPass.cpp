@@ -100,6 +100,12 @@ chooseMatmulTileParamsX86_64(EncodingUser user, TypeRange elementTypes,
   Type out = elementTypes[2];
 
   if (out.isF32() || out.isF16() || out.isBF16()) {
+    if (lhs.isBF16() && rhs.isBF16() && out.isF32()) {
+      if (hasFeature(target, "+amx-bf16")) {
+        // Aim to use TDPBF16PS: a single 16x32 by 32x16 tile product.
+        return MatmulTileParams{16, 32, 16};
+      }
+    }
     if (lhs.isBF16() && rhs.isBF16() && (out.isBF16() || out.isF32())) {
       if (hasFeature(target, "+avx512bf16")) {
         return MatmulTileParams{16, 2, 16};
@@ -126,6 +132,10 @@ chooseMatmulTileParamsX86_64(EncodingUser user, TypeRange elementTypes,
 
   if (lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
       out.isSignlessInteger(32)) {
+    if (hasFeature(target, "+amx-int8")) {
+      // Aim to use TDPBSSD: a single 16x64 by 64x16 tile product.
+      return MatmulTileParams{16, 64, 16};
+    }
     if (hasFeature(target, "+avx512vnni")) {
       // Aim to use VPDPWSSD. This is the same tile size as with VPMADDWD
       // as the only difference is that VPDPWSSD accumulates. VPDPBUSD would
@@ -147,6 +157,23 @@ chooseMatmulTileParamsX86_64(EncodingUser user, TypeRange elementTypes,
   return failure();
 }
 
+static FailureOr<MatmulTileParams>
+chooseMatmulTileParamsWasm32(EncodingUser user, TypeRange elementTypes,
+                             ExecutableTargetAttr target) {
+  if (user != EncodingUser::MATMUL && user != EncodingUser::BATCH_MATMUL) {
+    return failure();
+  }
+
+  assert(elementTypes.size() == 3);
+  if (llvm::all_of(elementTypes, [](Type t) { return t.isF32(); }) &&
+      hasFeature(target, "+simd128")) {
+    // Two 4-lane accumulators per row. M0 is kept at 4 so that the tile fits
+    // in the 16 vector registers of x86 hosts the engine maps SIMD128 onto.
+    return MatmulTileParams{4, 1, 8};
+  }
+  return chooseMatmulTileParamsGeneric(target);
+}
+
 static FailureOr<MatmulTileParams>
 chooseMatmulTileParams(EncodingUser user, TypeRange elementTypes,
                        ExecutableTargetAttr target) {
@@ -156,6 +183,9 @@ chooseMatmulTileParams(EncodingUser user, TypeRange elementTypes,
   if (isX86_64(target)) {
     return chooseMatmulTileParamsX86_64(user, elementTypes, target);
   }
+  if (isWasm32(target)) {
+    return chooseMatmulTileParamsWasm32(user, elementTypes, target);
+  }
   return chooseMatmulTileParamsGeneric(target);
 }
 
@@ -0,0 +1,190 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- CPUSplitMmt4dReductionPass.cpp -------------------------------------===//
+//
+// Splits the K1 (outer reduction) dimension of linalg.mmt4d ops whose parallel
+// dimensions are too small to keep all threads busy, e.g. in the decode phase
+// of LLMs where M1 == 1. The mmt4d is rewritten into a linalg.batch_mmt4d over
+// the splits, producing partial accumulators, followed by a linalg.reduce
+// summing the partial accumulators into the original accumulator. The batch
+// dimension of the batch_mmt4d is a parallel dimension, so the splits get
+// distributed across workgroups.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Codegen/Common/CPU/PassDetail.h"
+#include "iree/compiler/Codegen/Common/CPU/Passes.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/IndexingUtils.h"
+#include "mlir/IR/PatternMatch.h"
+
+#define DEBUG_TYPE "iree-cpu-split-mmt4d-reduction"
+
+namespace mlir {
+namespace iree_compiler {
+
+static llvm::cl::opt<bool> clEnableSplitMmt4dReduction(
+    "iree-cpu-enable-split-mmt4d-reduction",
+    llvm::cl::desc("split the reduction dimension of linalg.mmt4d ops with "
+                   "small parallel dimensions across threads"),
+    llvm::cl::init(true));
+
+static llvm::cl::opt<int> clSplitMmt4dReductionNumThreads(
+    "iree-cpu-split-mmt4d-reduction-number-of-threads",
+    llvm::cl::desc("number of threads that are expected to be used at runtime "
+                   "when deciding to split the reduction of linalg.mmt4d ops"),
+    llvm::cl::init(8));
+
+namespace {
+
+// Minimum number of M1/N1 tiles that a workgroup processes. This mirrors the
+// minimum distribution tile sizes used for linalg.mmt4d in KernelDispatch.cpp.
+constexpr int64_t kMinOuterTilesPerWorkgroup = 4;
+
+// Minimum number of scalar reduction steps (K1 * K0) per split, so that the
+// partial accumulators are amortized over enough work.
+constexpr int64_t kMinReductionSizePerSplit = 256;
+
+/// Returns the number of splits for the K1 dimension of `mmt4dOp`, or 1 if the
+/// reduction should not be split.
+static int64_t getMmt4dReductionSplitFactor(linalg::Mmt4DOp mmt4dOp) {
+  auto lhsType = cast<RankedTensorType>(mmt4dOp.getInputs()[0].getType());
+  auto rhsType = cast<RankedTensorType>(mmt4dOp.getInputs()[1].getType());
+  if (!lhsType.hasStaticShape() || !rhsType.hasStaticShape()) {
+    return 1;
+  }
+  int64_t M1 = lhsType.getDimSize(0);
+  int64_t K1 = lhsType.getDimSize(1);
+  int64_t K0 = lhsType.getDimSize(3);
+  int64_t N1 = rhsType.getDimSize(0);
+  int64_t numParallelWorkgroups =
+      llvm::divideCeil(M1, kMinOuterTilesPerWorkgroup) *
+      llvm::divideCeil(N1, kMinOuterTilesPerWorkgroup);
+  int64_t numThreads = clSplitMmt4dReductionNumThreads;
+  if (numParallelWorkgroups >= numThreads) {
+    return 1;
+  }
+  int64_t splitFactor = 1;
+  for (int64_t candidate = 2;
+       candidate * numParallelWorkgroups <= numThreads &&
+       K1 % candidate == 0 &&
+       (K1 / candidate) * K0 >= kMinReductionSizePerSplit;
+       candidate *= 2) {
+    splitFactor = candidate;
+  }
+  return splitFactor;
+}
+
+/// Expands the K1 dimension (dim 1) of an mmt4d operand of shape
+/// [X1, K1, X0, K0] into [splitFactor, X1, K1 / splitFactor, X0, K0].
+static Value splitMmt4dOperand(RewriterBase &rewriter, Location loc,
+                               Value operand, int64_t splitFactor) {
+  auto type = cast<RankedTensorType>(operand.getType());
+  ArrayRef<int64_t> shape = type.getShape();
+  SmallVector<int64_t> expandedShape = {shape[0], splitFactor,
+                                        shape[1] / splitFactor, shape[2],
+                                        shape[3]};
+  SmallVector<ReassociationIndices> reassociation = {{0}, {1, 2}, {3}, {4}};
+  Value expanded = rewriter.create<tensor::ExpandShapeOp>(
+      loc, RankedTensorType::get(expandedShape, type.getElementType()),
+      operand, reassociation);
+  SmallVector<int64_t> perm = {1, 0, 2, 3, 4};
+  SmallVector<int64_t> transposedShape =
+      applyPermutation(ArrayRef<int64_t>(expandedShape), perm);
+  Value init = rewriter.create<tensor::EmptyOp>(loc, transposedShape,
+                                                type.getElementType());
+  return rewriter.create<linalg::TransposeOp>(loc, expanded, init, perm)
+      ->getResult(0);
+}
+
+static void splitMmt4dReduction(RewriterBase &rewriter,
+                                linalg::Mmt4DOp mmt4dOp, int64_t splitFactor) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(mmt4dOp);
+  Location loc = mmt4dOp.getLoc();
+  Value lhs = splitMmt4dOperand(rewriter, loc, mmt4dOp.getInputs()[0],
+                                splitFactor);
+  Value rhs = splitMmt4dOperand(rewriter, loc, mmt4dOp.getInputs()[1],
+                                splitFactor);
+
+  Value acc = mmt4dOp.getOutputs()[0];
+  auto accType = cast<RankedTensorType>(acc.getType());
+  Type accElemType = accType.getElementType();
+  SmallVector<int64_t> partialShape = {splitFactor};
+  llvm::append_range(partialShape, accType.getShape());
+  Value partialInit =
+      rewriter.create<tensor::EmptyOp>(loc, partialShape, accElemType);
+  Value zero = rewriter.create<arith::ConstantOp>(
+      loc, accElemType, rewriter.getZeroAttr(accElemType));
+  partialInit = rewriter.create<linalg::FillOp>(loc, zero, partialInit)
+                    ->getResult(0);
+  Value partial = rewriter
+                      .create<linalg::BatchMmt4DOp>(
+                          loc, partialInit.getType(), ValueRange{lhs, rhs},
+                          ValueRange{partialInit})
+                      ->getResult(0);
+
+  auto reduceOp = rewriter.create<linalg::ReduceOp>(
+      loc, ValueRange{partial}, ValueRange{acc}, ArrayRef<int64_t>{0},
+      [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+        Value sum;
+        if (isa<FloatType>(accElemType)) {
+          sum = b.create<arith::AddFOp>(nestedLoc, args[0], args[1]);
+        } else {
+          sum = b.create<arith::AddIOp>(nestedLoc, args[0], args[1]);
+        }
+        b.create<linalg::YieldOp>(nestedLoc, sum);
+      });
+  rewriter.replaceOp(mmt4dOp, reduceOp->getResults());
+}
+
+struct CPUSplitMmt4dReductionPass
+    : public CPUSplitMmt4dReductionBase<CPUSplitMmt4dReductionPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void CPUSplitMmt4dReductionPass::runOnOperation() {
+  if (!clEnableSplitMmt4dReduction) {
+    return;
+  }
+  SmallVector<std::pair<linalg::Mmt4DOp, int64_t>> candidates;
+  getOperation()->walk([&](linalg::Mmt4DOp op) {
+    if (!op.hasTensorSemantics()) {
+      return;
+    }
+    int64_t splitFactor = getMmt4dReductionSplitFactor(op);
+    LLVM_DEBUG(llvm::dbgs() << "split factor " << splitFactor << " for " << op
+                            << "\n");
+    if (splitFactor > 1) {
+      candidates.emplace_back(op, splitFactor);
+    }
+  });
+
+  IRRewriter rewriter(&getContext());
+  for (auto [mmt4dOp, splitFactor] : candidates) {
+    splitMmt4dReduction(rewriter, mmt4dOp, splitFactor);
+  }
+}
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createCPUSplitMmt4dReductionPass() {
+  return std::make_unique<CPUSplitMmt4dReductionPass>();
+}
+
+} // namespace iree_compiler
+} // namespace mlir
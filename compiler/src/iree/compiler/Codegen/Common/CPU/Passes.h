@@ -45,6 +45,13 @@ std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createCPUMaterializeUpperBoundTileSizePass(
     ArrayRef<IREE::HAL::ExecutableTargetAttr> targetAttrs = {});
 
+/// Splits the K1 dimension of linalg.mmt4d ops whose M1 and N1 dimensions are
+/// too small to give work to all threads into a linalg.batch_mmt4d computing
+/// partial accumulators, followed by a linalg.reduce of the partial
+/// accumulators.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createCPUSplitMmt4dReductionPass();
+
 void registerCodegenCommonCPUPasses();
 
 } // namespace iree_compiler
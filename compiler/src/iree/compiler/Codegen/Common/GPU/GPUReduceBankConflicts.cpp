@@ -8,8 +8,11 @@
 #include "iree/compiler/Codegen/Common/GPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/NVGPU/Transforms/Transforms.h"
+
 namespace mlir {
 namespace iree_compiler {
 
@@ -45,14 +48,26 @@ static void padAlloc(MLIRContext *context, memref::AllocOp allocOp,
   rewriter.eraseOp(allocOp);
 }
 
+/// Tries to XOR-swizzle the layout of `allocOp` so that 128-bit accesses along
+/// rows and columns hit different banks. Unlike padding this doesn't use any
+/// extra shared memory. Returns failure without changing the IR when the
+/// swizzling is not legal or not profitable, e.g., if some accesses are not
+/// plain loads/stores or go through subviews, or if several rows already fit
+/// in a single 128B shared memory line.
+static LogicalResult swizzleAlloc(func::FuncOp funcOp,
+                                  memref::AllocOp allocOp) {
+  if (allocOp.getType().getRank() < 2)
+    return failure();
+  return nvgpu::optimizeSharedMemoryReadsAndWrites(funcOp,
+                                                   allocOp.getMemref());
+}
+
 namespace {
 
 /// Pass to reduce the number of bank conflicts when accessing shared memory in
-/// a 2D manner. This is a simple version just padding allocation.
-/// This doesn't fully remove bank conflicts and increase the shared memory
-/// usage. In order to get better memory access patterns we should do shared
-/// memory swizzling which requires more complex transformations. This pass can
-/// be removed once the better solution is implemented.
+/// a 2D manner. Allocations are swizzled when all their accesses allow it, and
+/// padded otherwise. Padding doesn't fully remove bank conflicts and increases
+/// the shared memory usage, which can limit occupancy.
 struct GPUReduceBankConflictsPass
     : public GPUReduceBankConflictsBase<GPUReduceBankConflictsPass> {
 private:
@@ -62,6 +77,10 @@ public:
   GPUReduceBankConflictsPass(int64_t paddingSizeBits)
       : paddingSizeBits(paddingSizeBits) {}
 
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect>();
+  }
+
   void runOnOperation() override {
     auto funcOp = getOperation();
     MLIRContext *context = &getContext();
@@ -73,8 +92,11 @@ public:
         sharedMemAllocs.push_back(allocOp);
       }
     });
-    for (memref::AllocOp alloc : sharedMemAllocs)
+    for (memref::AllocOp alloc : sharedMemAllocs) {
+      if (succeeded(swizzleAlloc(funcOp, alloc)))
+        continue;
       padAlloc(context, alloc, paddingSizeBits);
+    }
   }
 };
 } // namespace
@@ -52,9 +52,6 @@ pipelineSharedMemoryCopy(RewriterBase &rewriter, scf::ForOp forOp,
 LogicalResult tileReductionToSerialLoops(func::FuncOp funcOp,
                                          bool fuseInputProducer = false);
 
-LogicalResult swizzleWorkgroupsInFunc(func::FuncOp funcOp,
-                                      unsigned swizzleLogTile);
-
 //===----------------------------------------------------------------------===//
 // Passes
 //===----------------------------------------------------------------------===//
@@ -119,10 +116,6 @@ createConvertVectorReductionToGPUPass(
 std::unique_ptr<OperationPass<func::FuncOp>>
 createWorkgroupSpecializationPass();
 
-/// Converts vector ops to gpu dialect.
-std::unique_ptr<OperationPass<func::FuncOp>>
-createWorkGroupSwizzle(unsigned swizzleLogTile = 0);
-
 /// Register Common GPU passes.
 void registerCodegenCommonGPUPasses();
 
@@ -31,13 +31,16 @@
 #include "iree/compiler/Codegen/Common/GPU/PassDetail.h"
 #include "iree/compiler/Codegen/Common/GPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
 #define DEBUG_TYPE "iree-codegen-workgroup-specialization"
 
@@ -58,6 +61,67 @@ getConstantLowerBound(affine::AffineMinOp affineMinOp) {
   return std::nullopt;
 }
 
+// Returns the ops computing `value` if it only depends on values that are
+// uniform across the dispatch (workgroup ids and push constants), in which
+// case the ops can be hoisted to the top of the function.
+static std::optional<SetVector<Operation *>> getUniformSlice(Value value) {
+  Operation *definingOp = value.getDefiningOp();
+  if (!definingOp)
+    return std::nullopt;
+  BackwardSliceOptions options;
+  options.inclusive = true;
+  SetVector<Operation *> slice;
+  getBackwardSlice(definingOp, &slice, options);
+  for (Operation *op : slice) {
+    if (op->getNumRegions() != 0 || !isPure(op))
+      return std::nullopt;
+    if (llvm::any_of(op->getOperands(), [](Value operand) {
+          return llvm::isa<BlockArgument>(operand);
+        })) {
+      return std::nullopt;
+    }
+  }
+  return slice;
+}
+
+// Returns true if `minOp` always evaluates to `tileSize`. This is the case
+// when the non-constant results are known to be multiples of the tile size,
+// e.g. `-wgid * 64 + %dim` with `%dim` loaded from a push constant aligned to
+// a multiple of 64 as in dispatches specialized for shape buckets. The
+// distribution only launches workgroups for which those results are positive,
+// so they are then at least `tileSize`.
+static bool isAlwaysFullTile(affine::AffineMinOp minOp, int64_t tileSize) {
+  AffineMap map = minOp.getMap();
+  MLIRContext *context = minOp.getContext();
+  SmallVector<AffineExpr> dimReplacements, symReplacements;
+  for (auto [index, operand] : llvm::enumerate(minOp->getOperands())) {
+    bool isDim = index < map.getNumDims();
+    AffineExpr expr =
+        isDim ? getAffineDimExpr(index, context)
+              : getAffineSymbolExpr(index - map.getNumDims(), context);
+    if (!operand.getDefiningOp<IREE::HAL::InterfaceWorkgroupIDOp>()) {
+      if (std::optional<uint64_t> alignment =
+              IREE::HAL::lookupOffsetOrAlignment(operand)) {
+        expr = expr * static_cast<int64_t>(*alignment);
+      }
+    }
+    (isDim ? dimReplacements : symReplacements).push_back(expr);
+  }
+  for (AffineExpr result : map.getResults()) {
+    if (auto cst = result.dyn_cast<AffineConstantExpr>()) {
+      if (cst.getValue() != tileSize)
+        return false;
+      continue;
+    }
+    AffineExpr alignedResult = simplifyAffineExpr(
+        result.replaceDimsAndSymbols(dimReplacements, symReplacements),
+        map.getNumDims(), map.getNumSymbols());
+    if (!alignedResult.isMultipleOf(tileSize))
+      return false;
+  }
+  return true;
+}
+
 // Specialize the distributed function with the main tile sizes.
 //
 // Transformed output
@@ -69,26 +133,34 @@ getConstantLowerBound(affine::AffineMinOp affineMinOp) {
 //
 // Steps:
 // 1. Walk the code and collect affine.min that only depend on workgroup.id
-// and have one constant result.
-// 2. Move those at the top of the function
-// 3. Create a condition that ANDs all the affineMin == constant
-// 4. Splice the rest of the block and clone into a specialized if/else
+// and push constants and have one constant result.
+// 2. Replace the ones that are known to always be equal to the tile size, e.g.
+// because the dynamic dimensions are aligned to the tile size in a dispatch
+// specialized for a shape bucket.
+// 3. Move the others at the top of the function
+// 4. Create a condition that ANDs all the affineMin == constant
+// 5. Splice the rest of the block and clone into a specialized if/else
 static void specializeFunction(func::FuncOp funcOp) {
   SmallVector<affine::AffineMinOp> minSizeOps;
-  SmallVector<Operation *> ids;
-  funcOp.walk([&minSizeOps, &ids](Operation *op) {
-    if (auto affineMin = dyn_cast<affine::AffineMinOp>(op)) {
-      for (Value operand : affineMin->getOperands()) {
-        if (!operand.getDefiningOp<IREE::HAL::InterfaceWorkgroupIDOp>()) {
-          return WalkResult::advance();
-        }
-        ids.push_back(operand.getDefiningOp());
-      }
-      if (!getConstantLowerBound(affineMin)) {
-        return WalkResult::advance();
-      }
-      minSizeOps.push_back(affineMin);
+  SetVector<Operation *> uniformOps;
+  funcOp.walk([&minSizeOps, &uniformOps](affine::AffineMinOp affineMin) {
+    std::optional<int64_t> lowerBound = getConstantLowerBound(affineMin);
+    if (!lowerBound) {
+      return WalkResult::advance();
     }
+    std::optional<SetVector<Operation *>> slice =
+        getUniformSlice(affineMin.getResult());
+    if (!slice) {
+      return WalkResult::advance();
+    }
+    if (isAlwaysFullTile(affineMin, *lowerBound)) {
+      OpBuilder builder(affineMin);
+      affineMin.replaceAllUsesWith(builder.create<arith::ConstantIndexOp>(
+          affineMin.getLoc(), *lowerBound));
+      return WalkResult::advance();
+    }
+    uniformOps.insert(slice->begin(), slice->end());
+    minSizeOps.push_back(affineMin);
     return WalkResult::advance();
   });
   if (minSizeOps.empty()) {
@@ -101,14 +173,16 @@ static void specializeFunction(func::FuncOp funcOp) {
   OpBuilder builder(funcOp->getContext());
   OpBuilder::InsertionGuard guard(builder);
   // Move ops at the top of the function. This is always correct as those only
-  // depends on workgroup ids.
-  for (affine::AffineMinOp affineMin : llvm::reverse(minSizeOps)) {
-    affineMin->moveBefore(&block->front());
-  }
-  for (Operation *id : llvm::reverse(ids)) {
-    id->moveBefore(&block->front());
+  // depends on workgroup ids and push constants. Keep their relative order,
+  // which is a valid topological order.
+  SmallVector<Operation *> hoistedOps = uniformOps.takeVector();
+  llvm::sort(hoistedOps, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+  for (Operation *op : llvm::reverse(hoistedOps)) {
+    op->moveBefore(&block->front());
   }
-  builder.setInsertionPointAfter(minSizeOps.back());
+  builder.setInsertionPointAfter(hoistedOps.back());
   // create a condition for scf.if
   Value cond;
   SmallVector<Value> constantOps; // ConstantIndexOps for tile sizes
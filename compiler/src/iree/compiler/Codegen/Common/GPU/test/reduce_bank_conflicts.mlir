@@ -42,3 +42,18 @@ func.func @pad_alloc_rank_zero() {
   vector.transfer_write %cst, %0[] : vector<f32>, memref<f32, #gpu.address_space<workgroup>>
   return
 }
+
+// -----
+
+// CHECK-LABEL: func.func @swizzle_alloc
+func.func @swizzle_alloc(%i: index, %j: index, %v: vector<8xf16>) -> vector<8xf16> {
+// CHECK: %[[A:.*]] = memref.alloc() : memref<32x64xf16, #gpu.address_space<workgroup>>
+  %0 = memref.alloc() : memref<32x64xf16, #gpu.address_space<workgroup>>
+// CHECK: %[[STORE_COL:.*]] = arith.xori
+// CHECK: vector.store %{{.*}}, %[[A]][%{{.*}}, %[[STORE_COL]]] : memref<32x64xf16, #gpu.address_space<workgroup>>, vector<8xf16>
+  vector.store %v, %0[%i, %j] : memref<32x64xf16, #gpu.address_space<workgroup>>, vector<8xf16>
+// CHECK: %[[LOAD_COL:.*]] = arith.xori
+// CHECK: vector.load %[[A]][%{{.*}}, %[[LOAD_COL]]] : memref<32x64xf16, #gpu.address_space<workgroup>>, vector<8xf16>
+  %1 = vector.load %0[%j, %i] : memref<32x64xf16, #gpu.address_space<workgroup>>, vector<8xf16>
+  return %1 : vector<8xf16>
+}
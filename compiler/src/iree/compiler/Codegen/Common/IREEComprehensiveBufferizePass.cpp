@@ -31,6 +31,7 @@
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -42,6 +43,13 @@ using mlir::bufferization::BufferizationOptions;
 using mlir::bufferization::OneShotAnalysisState;
 using mlir::bufferization::OneShotBufferizationOptions;
 
+static llvm::cl::opt<bool> clReportBufferizationCopies(
+    "iree-codegen-report-bufferization-copies",
+    llvm::cl::desc("Emits a remark with the byte count for every copy "
+                   "inserted by bufferization because a tensor couldn't be "
+                   "bufferized in place"),
+    llvm::cl::init(false));
+
 namespace mlir {
 namespace iree_compiler {
 
@@ -146,9 +154,49 @@ static IREEOneShotBufferizationOptions getBufferizationOptions() {
   return options;
 }
 
+/// Moves the producers of `tensor.insert_slice` sources right before the
+/// insert_slice when their inits are `tensor.empty` ops. Chains of
+/// insert_slices (such as decomposed concats) usually compute all the sources
+/// before the first insertion, in which case the destination doesn't dominate
+/// the `tensor.empty` and it can't be replaced by a slice of the destination;
+/// the source is then computed into a temporary buffer and copied.
+static void sinkInsertSliceSourceProducers(RewriterBase &rewriter,
+                                           Operation *op) {
+  op->walk([&](tensor::InsertSliceOp insertSliceOp) {
+    Value source = insertSliceOp.getSource();
+    auto producer = source.getDefiningOp<DestinationStyleOpInterface>();
+    if (!producer || !source.hasOneUse() ||
+        producer->getBlock() != insertSliceOp->getBlock() ||
+        !isMemoryEffectFree(producer)) {
+      return;
+    }
+    Operation *destOp = insertSliceOp.getDest().getDefiningOp();
+    if (!destOp || destOp->getBlock() != producer->getBlock() ||
+        destOp->isBeforeInBlock(producer)) {
+      return;
+    }
+    SmallVector<tensor::EmptyOp> emptyOps;
+    for (OpOperand &init : producer.getDpsInitsMutable()) {
+      auto emptyOp = init.get().getDefiningOp<tensor::EmptyOp>();
+      if (!emptyOp || !emptyOp->hasOneUse())
+        return;
+      emptyOps.push_back(emptyOp);
+    }
+    // All operands of the ops dominate their original position and so also
+    // the new one later in the same block.
+    rewriter.moveOpBefore(producer, insertSliceOp);
+    for (auto emptyOp : emptyOps) {
+      if (emptyOp->getBlock() == producer->getBlock())
+        rewriter.moveOpBefore(emptyOp, producer);
+    }
+  });
+}
+
 LogicalResult
 eliminateEmptyTensors(RewriterBase &rewriter, Operation *op,
                       const OneShotBufferizationOptions &options) {
+  sinkInsertSliceSourceProducers(rewriter, op);
+
   // Analyze IR.
   OneShotAnalysisState state(op, options);
   if (failed(analyzeOp(op, state)))
@@ -177,6 +225,8 @@ void EliminateEmptyTensorsPass::runOnOperation() {
   }
 
   IRRewriter rewriter(moduleOp->getContext());
+  sinkInsertSliceSourceProducers(rewriter, moduleOp);
+
   auto bufferizationOptions = getBufferizationOptions();
   OneShotAnalysisState state(moduleOp, bufferizationOptions);
   // Analyze IR.
@@ -209,6 +259,46 @@ void IREEComprehensiveBufferizePass::runOnOperation() {
   options.allocationFn = allocationFn;
   options.memCpyFn = memCpyFn;
 
+  // Copies into buffers allocated by bufferization are the ones introduced
+  // for tensors that couldn't be bufferized in place. Other copies (such as
+  // into a subview for a tensor.insert_slice) move data that would be written
+  // anyway.
+  DenseSet<Value> allocations;
+  bool emitCopyRemarks = reportCopies || clReportBufferizationCopies;
+  if (allocationFn && memCpyFn) {
+    options.allocationFn = [&](OpBuilder &builder, Location loc,
+                               MemRefType type, ValueRange dynamicSizes,
+                               unsigned alignment) -> FailureOr<Value> {
+      FailureOr<Value> allocation =
+          (*allocationFn)(builder, loc, type, dynamicSizes, alignment);
+      if (succeeded(allocation))
+        allocations.insert(allocation.value());
+      return allocation;
+    };
+    options.memCpyFn = [&](OpBuilder &builder, Location loc, Value from,
+                           Value to) -> LogicalResult {
+      if (allocations.contains(to)) {
+        auto type = llvm::cast<MemRefType>(to.getType());
+        ++numCopies;
+        if (type.hasStaticShape() && type.getElementType().isIntOrFloat()) {
+          int64_t byteCount =
+              type.getNumElements() *
+              llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+          numCopiedBytes += byteCount;
+          if (emitCopyRemarks) {
+            emitRemark(loc) << "bufferization copies " << byteCount
+                            << " bytes into a new " << type;
+          }
+        } else if (emitCopyRemarks) {
+          emitRemark(loc) << "bufferization copies into a new dynamically "
+                             "sized "
+                          << type;
+        }
+      }
+      return (*memCpyFn)(builder, loc, from, to);
+    };
+  }
+
   if (failed(runIREEOneShotBufferize(moduleOp, options))) {
     return signalPassFailure();
   }
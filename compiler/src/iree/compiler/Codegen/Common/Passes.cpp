@@ -11,13 +11,16 @@
 namespace mlir {
 namespace iree_compiler {
 
-void addCommonTargetExecutablePreprocessingPasses(OpPassManager &passManager) {
+void addCommonTargetExecutablePreprocessingPasses(
+    OpPassManager &passManager,
+    std::function<bool(Operation *)> decomposeSoftmaxFilter) {
   OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
   nestedModulePM.addNestedPass<func::FuncOp>(createTypePropagationPass());
   nestedModulePM.addPass(createBubbleUpOrdinalOpsPass());
   nestedModulePM.addPass(createBufferizeCopyOnlyDispatchesPass());
   nestedModulePM.addNestedPass<func::FuncOp>(
-      IREE::LinalgExt::createDecomposeSoftmaxPass());
+      IREE::LinalgExt::createDecomposeSoftmaxPass(
+          std::move(decomposeSoftmaxFilter)));
   passManager.addPass(createMaterializeUserConfigsPass());
 }
 
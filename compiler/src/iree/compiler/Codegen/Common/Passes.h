@@ -12,6 +12,7 @@
 #ifndef IREE_COMPILER_CODEGEN_COMMON_PASSES_H_
 #define IREE_COMPILER_CODEGEN_COMMON_PASSES_H_
 
+#include <functional>
 #include <limits>
 
 #include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
@@ -28,8 +29,12 @@ void registerTransformDialectTranslationDependentDialects(
     DialectRegistry &registry);
 
 /// Passes that are done on all backends before target-specific code-generation
-/// kicks in.
-void addCommonTargetExecutablePreprocessingPasses(OpPassManager &passManager);
+/// kicks in. If `decomposeSoftmaxFilter` is set, only the linalg.softmax ops
+/// for which it returns true are decomposed; the backend is then responsible
+/// for the others.
+void addCommonTargetExecutablePreprocessingPasses(
+    OpPassManager &passManager,
+    std::function<bool(Operation *)> decomposeSoftmaxFilter = nullptr);
 
 /// Post-bufferization passes run to cleanup the IR
 /// (ResolveShapedTypeResultDims, Canonicalization/CSE and
@@ -43,7 +48,22 @@ void addIREEComprehensiveBufferizePasses(
         std::nullopt,
     std::optional<BufferizationOptions::MemCpyFn> memCpyFn = std::nullopt);
 
-std::unique_ptr<OperationPass<LLVM::LLVMFuncOp>> createAddFastMathFlagsPass();
+/// LLVM function attributes placed by the AddFastMathFlags pass declaring the
+/// floating-point environment a function requires. Functions without either
+/// attribute expect denormals to be flushed to zero. Target backends use them
+/// to declare the corresponding IREE_HAL_EXECUTABLE_DISPATCH_FLAG_* bits:
+///   kFPUAgnosticAttrName: ops in the function (excluding direct calls) do
+///     not depend on the environment.
+///   kFPUPreserveDenormalsAttrName: requires IEEE denormal handling.
+static constexpr StringLiteral kFPUAgnosticAttrName = "iree-hal-fpu-agnostic";
+static constexpr StringLiteral kFPUPreserveDenormalsAttrName =
+    "iree-hal-fpu-preserve-denormals";
+
+/// Adds fast-math flags to LLVM ops and tags the function with the
+/// floating-point environment it requires. If |preserveDenormals| is set then
+/// functions require IEEE denormal handling instead of flush-to-zero.
+std::unique_ptr<OperationPass<LLVM::LLVMFuncOp>>
+createAddFastMathFlagsPass(bool preserveDenormals = false);
 
 /// Pass to bubble up ordinal operations to allow workgroup count computation
 /// based on slices to correlate back to workload computation.
@@ -258,6 +278,15 @@ std::unique_ptr<OperationPass<func::FuncOp>> createTypePropagationPass();
 /// control flows.
 std::unique_ptr<OperationPass<func::FuncOp>> createVectorizePadPass();
 
+/// Swizzles the workgroup IDs in groups of 2^`swizzleLogTile` rows so that
+/// workgroups processed close in time touch neighboring data.
+LogicalResult swizzleWorkgroupsInFunc(func::FuncOp funcOp,
+                                      unsigned swizzleLogTile);
+
+/// Pass to swizzle the workgroup IDs for better cache reuse.
+std::unique_ptr<OperationPass<func::FuncOp>>
+createWorkGroupSwizzle(unsigned swizzleLogTile = 0);
+
 /// Populates patterns with patterns to concretize tensor.pad op's result
 /// shape. `numWorkgroups`, if not empty, will be used as bounds for simplifying
 /// workgroup ID ops.
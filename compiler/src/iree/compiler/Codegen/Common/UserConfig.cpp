@@ -6,9 +6,20 @@
 
 #include "iree/compiler/Codegen/Common/UserConfig.h"
 
+#include "iree/compiler/Codegen/Dialect/IREECodegenDialect.h"
+#include "llvm/Support/CommandLine.h"
+
 namespace mlir {
 namespace iree_compiler {
 
+static llvm::cl::opt<std::string> clCodegenProfileInput(
+    "iree-codegen-profile-input",
+    llvm::cl::desc(
+        "Path to a JSON profile with the measured time of each dispatch under "
+        "one or more configurations. Dispatches use the fastest measured "
+        "configuration in place of the default heuristics."),
+    llvm::cl::init(""));
+
 /// Propagate the configuration annotated in the incoming IR.
 LogicalResult
 setUserConfig(func::FuncOp entryPointFn, Operation *computeOp,
@@ -34,5 +45,23 @@ setUserConfig(func::FuncOp entryPointFn, Operation *computeOp,
   return success();
 }
 
+FailureOr<bool> setProfileGuidedConfig(func::FuncOp entryPointFn,
+                                       Operation *rootOp) {
+  if (clCodegenProfileInput.empty())
+    return false;
+  auto *dialect = entryPointFn->getContext()
+                      ->getOrLoadDialect<IREE::Codegen::IREECodegenDialect>();
+  auto profile = dialect->getOrLoadDispatchProfile(clCodegenProfileInput);
+  if (failed(profile))
+    return failure();
+  auto compilationInfo = profile->getAs<IREE::Codegen::CompilationInfoAttr>(
+      entryPointFn.getName());
+  if (!compilationInfo)
+    return false;
+  if (failed(setUserConfig(entryPointFn, rootOp, compilationInfo)))
+    return failure();
+  return true;
+}
+
 } // namespace iree_compiler
 } // namespace mlir
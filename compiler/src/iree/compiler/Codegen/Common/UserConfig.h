@@ -13,5 +13,12 @@ namespace iree_compiler {
 LogicalResult setUserConfig(func::FuncOp entryPointFn, Operation *computeOp,
                             IREE::Codegen::CompilationInfoAttr compilationInfo);
 
+/// Sets the compilation configuration measured to be the fastest for
+/// |entryPointFn| in the profile passed with `--iree-codegen-profile-input`.
+/// Returns true if a configuration was set on |rootOp| and false if there is no
+/// profile or it has no better configuration than the default.
+FailureOr<bool> setProfileGuidedConfig(func::FuncOp entryPointFn,
+                                       Operation *rootOp);
+
 } // namespace iree_compiler
 } // namespace mlir
@@ -1,4 +1,5 @@
 // RUN: iree-opt -iree-codegen-add-fast-math-flags --split-input-file %s | FileCheck %s
+// RUN: iree-opt --pass-pipeline="builtin.module(llvm.func(iree-codegen-add-fast-math-flags{preserve-denormals=true}))" --split-input-file %s | FileCheck %s --check-prefix=PRESERVE
 
 // LABEL: llvm.func @fmfs
 llvm.func @fmfs() -> f32 {
@@ -11,3 +12,38 @@ llvm.func @fmfs() -> f32 {
 
 // CHECK: llvm.fmul %{{.*}}, %{{.*}}  {fastmathFlags = #llvm.fastmath<contract>} : f32
 // CHECK: llvm.fadd %{{.*}}, %{{.*}}  {fastmathFlags = #llvm.fastmath<contract>} : f32
+
+// -----
+
+// Functions performing floating-point arithmetic require the default
+// environment unless denormals are to be preserved.
+
+// CHECK-LABEL: llvm.func @fpu_dependent
+//   CHECK-NOT:   passthrough
+// PRESERVE-LABEL: llvm.func @fpu_dependent
+//  PRESERVE-SAME:   passthrough = ["iree-hal-fpu-preserve-denormals"]
+llvm.func @fpu_dependent(%arg0: !llvm.ptr) {
+  %0 = llvm.load %arg0 : !llvm.ptr -> f32
+  %1 = llvm.fadd %0, %0 : f32
+  llvm.store %1, %arg0 : f32, !llvm.ptr
+  llvm.return
+}
+
+// -----
+
+// Functions only moving floating-point values around do not depend on the
+// environment. Existing passthrough attributes are retained.
+
+// CHECK-LABEL: llvm.func @fpu_agnostic
+//  CHECK-SAME:   passthrough = ["alwaysinline", "iree-hal-fpu-agnostic"]
+// PRESERVE-LABEL: llvm.func @fpu_agnostic
+//  PRESERVE-SAME:   passthrough = ["alwaysinline", "iree-hal-fpu-agnostic", "iree-hal-fpu-preserve-denormals"]
+llvm.func @fpu_agnostic(%arg0: !llvm.ptr, %arg1: !llvm.ptr, %arg2: i1) attributes {passthrough = ["alwaysinline"]} {
+  %0 = llvm.load %arg0 : !llvm.ptr -> vector<4xf32>
+  %1 = llvm.load %arg1 : !llvm.ptr -> vector<4xf32>
+  %2 = llvm.select %arg2, %0, %1 : i1, vector<4xf32>
+  llvm.store %2, %arg0 : vector<4xf32>, !llvm.ptr
+  llvm.call @callee(%arg0) : (!llvm.ptr) -> ()
+  llvm.return
+}
+llvm.func @callee(!llvm.ptr)
@@ -0,0 +1,32 @@
+// RUN: iree-opt --split-input-file --verify-diagnostics --pass-pipeline="builtin.module(iree-codegen-iree-comprehensive-bufferize{report-copies})" %s -o /dev/null
+
+func.func @report_copy_of_readonly_input() {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<4x8xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<4x8xf32>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [4, 8], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4x8xf32>> -> tensor<4x8xf32>
+  // The input binding is read-only so accumulating into it needs a copy.
+  // expected-remark @+1 {{bufferization copies 128 bytes into a new}}
+  %3 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} outs(%2 : tensor<4x8xf32>) {
+  ^bb0(%out: f32):
+    %4 = arith.addf %out, %out : f32
+    linalg.yield %4 : f32
+  } -> tensor<4x8xf32>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [4, 8], strides = [1, 1] : tensor<4x8xf32> -> !flow.dispatch.tensor<writeonly:tensor<4x8xf32>>
+  return
+}
+
+// -----
+
+func.func @no_report_for_in_place_update() {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readwrite:tensor<4x8xf32>>
+  %1 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [4, 8], strides = [1, 1] : !flow.dispatch.tensor<readwrite:tensor<4x8xf32>> -> tensor<4x8xf32>
+  %2 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} outs(%1 : tensor<4x8xf32>) {
+  ^bb0(%out: f32):
+    %3 = arith.addf %out, %out : f32
+    linalg.yield %3 : f32
+  } -> tensor<4x8xf32>
+  flow.dispatch.tensor.store %2, %0, offsets = [0, 0], sizes = [4, 8], strides = [1, 1] : tensor<4x8xf32> -> !flow.dispatch.tensor<readwrite:tensor<4x8xf32>>
+  return
+}
@@ -27,3 +27,41 @@ func.func @eliminate_empty_tensors_with_store_op() {
 // CHECK:   %[[LOAD:.+]] = flow.dispatch.tensor.load %[[SPAN]], offsets = [%[[ARG0]], 0]
 // CHECK:   %[[RES:.+]] = scf.for %{{.+}} = %[[C0]] to %[[C32]] step %[[C8]] iter_args(%{{.+}} = %[[LOAD]])
 // CHECK:   flow.dispatch.tensor.store %[[RES]], %[[SPAN]]
+
+// -----
+
+func.func @eliminate_empty_tensors_in_insert_slice_chain() {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<4x8xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<8x8xf32>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [4, 8], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4x8xf32>> -> tensor<4x8xf32>
+  %3 = tensor.empty() : tensor<4x8xf32>
+  %4 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%2 : tensor<4x8xf32>) outs(%3 : tensor<4x8xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %10 = math.exp %in : f32
+    linalg.yield %10 : f32
+  } -> tensor<4x8xf32>
+  %5 = tensor.empty() : tensor<4x8xf32>
+  %6 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%2 : tensor<4x8xf32>) outs(%5 : tensor<4x8xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %10 = arith.negf %in : f32
+    linalg.yield %10 : f32
+  } -> tensor<4x8xf32>
+  %7 = tensor.empty() : tensor<8x8xf32>
+  %8 = tensor.insert_slice %4 into %7[0, 0] [4, 8] [1, 1] : tensor<4x8xf32> into tensor<8x8xf32>
+  %9 = tensor.insert_slice %6 into %8[4, 0] [4, 8] [1, 1] : tensor<4x8xf32> into tensor<8x8xf32>
+  flow.dispatch.tensor.store %9, %1, offsets = [0, 0], sizes = [8, 8], strides = [1, 1] : tensor<8x8xf32> -> !flow.dispatch.tensor<writeonly:tensor<8x8xf32>>
+  return
+}
+
+// The sources of the insert_slices are computed directly into the output.
+// CHECK-LABEL: @eliminate_empty_tensors_in_insert_slice_chain
+//       CHECK:   %[[OUT:.+]] = hal.interface.binding.subspan set(0) binding(1)
+//       CHECK:   %[[LOAD:.+]] = flow.dispatch.tensor.load %[[OUT]]
+//       CHECK:   %[[SLICE0:.+]] = tensor.extract_slice %[[LOAD]][0, 0] [4, 8] [1, 1]
+//       CHECK:   %[[EXP:.+]] = linalg.generic {{.+}} outs(%[[SLICE0]] :
+//       CHECK:   %[[INSERT0:.+]] = tensor.insert_slice %[[EXP]] into %[[LOAD]][0, 0] [4, 8] [1, 1]
+//       CHECK:   %[[SLICE1:.+]] = tensor.extract_slice %[[INSERT0]][4, 0] [4, 8] [1, 1]
+//       CHECK:   %[[NEG:.+]] = linalg.generic {{.+}} outs(%[[SLICE1]] :
+//       CHECK:   %[[INSERT1:.+]] = tensor.insert_slice %[[NEG]] into %[[INSERT0]][4, 0] [4, 8] [1, 1]
+//       CHECK:   flow.dispatch.tensor.store %[[INSERT1]], %[[OUT]]
@@ -129,3 +129,88 @@ func.func @unaligned_partial_loop() {
 // CHECK:         linalg.matmul
 // CHECK-SAME:                  ins(%{{.+}}, %{{.+}} : tensor<2x768xf32>, tensor<768x?xf32>) outs(%{{.+}} : tensor<2x?xf32>)
 
+
+// -----
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64, 64, 0], [16, 4, 0], [0, 0, 64]]>
+#map = affine_map<()[s0] -> (s0 * 64)>
+#map1 = affine_map<()[s0, s1] -> (s0 * -64 + s1, 64)>
+func.func @dynamic_matmul() {
+  %cst = arith.constant 0.000000e+00 : f32
+  %c0 = arith.constant 0 : index
+  %m_i32 = hal.interface.constant.load[0] : i32
+  %n_i32 = hal.interface.constant.load[1] : i32
+  %m = arith.index_castui %m_i32 : i32 to index
+  %n = arith.index_castui %n_i32 : i32 to index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<?x456xf32>>{%m}
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<456x?xf32>>{%n}
+  %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>{%m, %n}
+  %workgroup_id_x = hal.interface.workgroup.id[0] : index
+  %workgroup_id_y = hal.interface.workgroup.id[1] : index
+  %3 = affine.apply #map()[%workgroup_id_y]
+  %4 = affine.min #map1()[%workgroup_id_y, %m]
+  %5 = affine.apply #map()[%workgroup_id_x]
+  %6 = affine.min #map1()[%workgroup_id_x, %n]
+  %7 = flow.dispatch.tensor.load %0, offsets = [%3, 0], sizes = [%4, 456], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<?x456xf32>>{%m} -> tensor<?x456xf32>
+  %8 = flow.dispatch.tensor.load %1, offsets = [0, %5], sizes = [456, %6], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<456x?xf32>>{%n} -> tensor<456x?xf32>
+  %9 = tensor.empty(%4, %6) : tensor<?x?xf32>
+  %10 = linalg.fill ins(%cst : f32) outs(%9 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  %11 = linalg.matmul {lowering_config = #config} ins(%7, %8 : tensor<?x456xf32>, tensor<456x?xf32>) outs(%10 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  flow.dispatch.tensor.store %11, %2, offsets = [%3, %5], sizes = [%4, %6], strides = [1, 1] : tensor<?x?xf32> -> !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>{%m, %n}
+  return
+}
+
+// The dynamic sizes come from push constants, which are uniform across the
+// dispatch, so the tile sizes can still be checked upfront.
+
+// CHECK: func.func @dynamic_matmul()
+// CHECK:       %[[C64:.+]] = arith.constant 64 : index
+// CHECK:       %[[CMP0:.+]] = arith.cmpi eq, %{{.+}}, %[[C64]] : index
+// CHECK:       %[[CMP1:.+]] = arith.cmpi eq, %{{.+}}, %[[C64]] : index
+// CHECK:       %[[COND:.+]] = arith.andi %[[CMP0]], %[[CMP1]] : i1
+// CHECK:       scf.if %[[COND]] {
+// CHECK:         linalg.matmul
+// CHECK-SAME:                  ins(%{{.+}}, %{{.+}} : tensor<64x456xf32>, tensor<456x64xf32>) outs(%{{.+}} : tensor<64x64xf32>) -> tensor<64x64xf32>
+// CHECK:       } else {
+// CHECK:         linalg.matmul
+// CHECK-SAME:                  ins(%{{.+}}, %{{.+}} : tensor<?x456xf32>, tensor<456x?xf32>) outs(%{{.+}} : tensor<?x?xf32>) -> tensor<?x?xf32>
+
+// -----
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64, 64, 0], [16, 4, 0], [0, 0, 64]]>
+#map = affine_map<()[s0] -> (s0 * 64)>
+#map1 = affine_map<()[s0, s1] -> (s0 * -64 + s1, 64)>
+func.func @aligned_dynamic_matmul() {
+  %cst = arith.constant 0.000000e+00 : f32
+  %c0 = arith.constant 0 : index
+  %m_i32 = hal.interface.constant.load[0] alignment(128) : i32
+  %n_i32 = hal.interface.constant.load[1] alignment(64) : i32
+  %m = arith.index_castui %m_i32 : i32 to index
+  %n = arith.index_castui %n_i32 : i32 to index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<?x456xf32>>{%m}
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<456x?xf32>>{%n}
+  %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>{%m, %n}
+  %workgroup_id_x = hal.interface.workgroup.id[0] : index
+  %workgroup_id_y = hal.interface.workgroup.id[1] : index
+  %3 = affine.apply #map()[%workgroup_id_y]
+  %4 = affine.min #map1()[%workgroup_id_y, %m]
+  %5 = affine.apply #map()[%workgroup_id_x]
+  %6 = affine.min #map1()[%workgroup_id_x, %n]
+  %7 = flow.dispatch.tensor.load %0, offsets = [%3, 0], sizes = [%4, 456], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<?x456xf32>>{%m} -> tensor<?x456xf32>
+  %8 = flow.dispatch.tensor.load %1, offsets = [0, %5], sizes = [456, %6], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<456x?xf32>>{%n} -> tensor<456x?xf32>
+  %9 = tensor.empty(%4, %6) : tensor<?x?xf32>
+  %10 = linalg.fill ins(%cst : f32) outs(%9 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  %11 = linalg.matmul {lowering_config = #config} ins(%7, %8 : tensor<?x456xf32>, tensor<456x?xf32>) outs(%10 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  flow.dispatch.tensor.store %11, %2, offsets = [%3, %5], sizes = [%4, %6], strides = [1, 1] : tensor<?x?xf32> -> !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>{%m, %n}
+  return
+}
+
+// The dynamic sizes are multiples of the tile sizes (as in dispatches
+// specialized for shape buckets) so all tiles are full and no fallback is
+// needed.
+
+// CHECK: func.func @aligned_dynamic_matmul()
+// CHECK-NOT:   scf.if
+// CHECK:       linalg.matmul
+// CHECK-SAME:                ins(%{{.+}}, %{{.+}} : tensor<64x456xf32>, tensor<456x64xf32>) outs(%{{.+}} : tensor<64x64xf32>) -> tensor<64x64xf32>
+// CHECK-NOT:   linalg.matmul
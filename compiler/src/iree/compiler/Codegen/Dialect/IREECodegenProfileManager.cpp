@@ -0,0 +1,117 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
+#include "iree/compiler/Codegen/Dialect/IREECodegenDialect.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "mlir/AsmParser/AsmParser.h"
+#include "mlir/IR/Diagnostics.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Codegen {
+
+// Parses a dispatch profile of the form:
+//  {
+//    "dispatches": {
+//      "main_dispatch_0_matmul_128x384x256_f32": [
+//        {"time_us": 51.2},
+//        {"time_us": 38.9,
+//         "compilation_info": "#iree_codegen.compilation_info<...>"}
+//      ]
+//    }
+//  }
+// Each dispatch function lists the time measured for each configuration that
+// was tried. Samples without a `compilation_info` were measured with the
+// default configuration selected by the compiler.
+static FailureOr<DictionaryAttr> parseDispatchProfile(MLIRContext *context,
+                                                      StringRef profilePath) {
+  auto loc = FileLineColLoc::get(context, profilePath, 0, 0);
+  auto fileOr = llvm::MemoryBuffer::getFile(profilePath);
+  if (!fileOr) {
+    return mlir::emitError(loc) << "failed to open dispatch profile: "
+                                << fileOr.getError().message();
+  }
+  auto json = llvm::json::parse((*fileOr)->getBuffer());
+  if (!json) {
+    return mlir::emitError(loc) << "failed to parse dispatch profile: "
+                                << llvm::toString(json.takeError());
+  }
+  auto *rootObject = json->getAsObject();
+  auto *dispatches = rootObject ? rootObject->getObject("dispatches") : nullptr;
+  if (!dispatches) {
+    return mlir::emitError(loc)
+           << "dispatch profile must contain a `dispatches` object";
+  }
+
+  SmallVector<NamedAttribute> bestConfigs;
+  for (auto &dispatch : *dispatches) {
+    StringRef name = dispatch.first;
+    auto *samples = dispatch.second.getAsArray();
+    if (!samples) {
+      return mlir::emitError(loc)
+             << "expected a list of samples for dispatch `" << name << "`";
+    }
+    std::optional<double> bestTime;
+    CompilationInfoAttr bestConfig;
+    for (auto &sampleValue : *samples) {
+      auto *sample = sampleValue.getAsObject();
+      std::optional<double> time =
+          sample ? sample->getNumber("time_us") : std::nullopt;
+      if (!time) {
+        return mlir::emitError(loc)
+               << "sample of dispatch `" << name << "` is missing `time_us`";
+      }
+      CompilationInfoAttr config;
+      if (auto configStr = sample->getString("compilation_info")) {
+        config = llvm::dyn_cast_if_present<CompilationInfoAttr>(
+            mlir::parseAttribute(*configStr, context));
+        if (!config) {
+          return mlir::emitError(loc)
+                 << "invalid compilation_info for dispatch `" << name << "`";
+        }
+      }
+      if (!bestTime || *time < *bestTime) {
+        bestTime = time;
+        bestConfig = config;
+      }
+    }
+    // No override is needed when the default configuration is the fastest.
+    if (bestConfig) {
+      bestConfigs.emplace_back(StringAttr::get(context, name), bestConfig);
+    }
+  }
+  return DictionaryAttr::get(context, bestConfigs);
+}
+
+FailureOr<DictionaryAttr>
+IREECodegenDialect::getOrLoadDispatchProfile(std::string profilePath) {
+  // Acquire a lock on the map that will release once out of scope.
+  std::lock_guard<std::mutex> guard(profileMutex);
+
+  auto loadedProfile = dispatchProfiles.find(profilePath);
+  if (loadedProfile != dispatchProfiles.end()) {
+    // Check whether the profile already failed to load.
+    if (!loadedProfile->second) {
+      return failure();
+    }
+    return loadedProfile->second;
+  }
+
+  // We update the storage for the profile regardless of whether parsing
+  // succeeds so that other threads don't have to retry.
+  auto profile = parseDispatchProfile(getContext(), profilePath);
+  dispatchProfiles[profilePath] =
+      succeeded(profile) ? *profile : DictionaryAttr();
+  return profile;
+}
+
+} // namespace Codegen
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -202,6 +202,32 @@ struct AllParallelAsPartitionableLoops
   }
 };
 
+/// External model implementation for specifying partitionable loops of
+/// linalg.softmax: all the loops except the one along the softmax dimension.
+struct SoftmaxOpPartitionableLoops
+    : public PartitionableLoopsInterface::ExternalModel<
+          SoftmaxOpPartitionableLoops, linalg::SoftmaxOp> {
+  llvm::SmallVector<unsigned>
+  getPartitionableLoops(Operation *op,
+                        std::optional<unsigned> maxNumPartitionedLoops) const {
+    auto softmaxOp = cast<linalg::SoftmaxOp>(op);
+    SmallVector<unsigned> partitionableLoops;
+    for (unsigned i = 0, e = softmaxOp.getInputOperandRank(); i < e; ++i) {
+      if (i != softmaxOp.getDimension())
+        partitionableLoops.push_back(i);
+    }
+    if (!maxNumPartitionedLoops.has_value() ||
+        partitionableLoops.size() <= maxNumPartitionedLoops.value()) {
+      return partitionableLoops;
+    }
+    partitionableLoops.erase(
+        partitionableLoops.begin(),
+        std::next(partitionableLoops.begin(),
+                  partitionableLoops.size() - maxNumPartitionedLoops.value()));
+    return partitionableLoops;
+  }
+};
+
 /// Registers the `LinalgOpPartitionableLoops` model for all Linalg ops. This
 /// needs to be done on a op-by-op basis since registration is on an op-by-op
 /// basis.
@@ -237,6 +263,8 @@ void registerPartitionableLoopsInterfaceModels(DialectRegistry &registry) {
     registerInterfaceForLinalgOps<
 #include "mlir/Dialect/Linalg/IR/LinalgStructuredOps.cpp.inc"
         >(ctx);
+    // linalg.softmax is not a structured op, so it is not in the list above.
+    linalg::SoftmaxOp::attachInterface<SoftmaxOpPartitionableLoops>(*ctx);
   });
 
   registry.insert<IREE::LinalgExt::IREELinalgExtDialect>();
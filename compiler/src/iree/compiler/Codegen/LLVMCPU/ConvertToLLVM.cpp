@@ -915,8 +915,9 @@ public:
 
 class ConvertToLLVMPass : public ConvertToLLVMBase<ConvertToLLVMPass> {
 public:
-  ConvertToLLVMPass(bool reassociateFpReductions) {
+  ConvertToLLVMPass(bool reassociateFpReductions, bool workgroupRanges) {
     targetReassociateFpReductions.setValue(reassociateFpReductions);
+    targetWorkgroupRanges.setValue(workgroupRanges);
   }
   ConvertToLLVMPass(const ConvertToLLVMPass &pass) {}
   void getDependentDialects(DialectRegistry &registry) const override {
@@ -937,6 +938,11 @@ private:
       *this, "target-reassociate-fp-reductions",
       llvm::cl::desc("Code generation target reassociate FP reductions."),
       llvm::cl::init("false")};
+  Option<bool> targetWorkgroupRanges{
+      *this, "target-workgroup-ranges",
+      llvm::cl::desc("Builds entry points that execute a range of workgroups "
+                     "per call."),
+      llvm::cl::init(false)};
 };
 
 } // namespace
@@ -1051,6 +1057,19 @@ void ConvertToLLVMPass::runOnOperation() {
       typeConverter, patterns, targetReassociateFpReductions.getValue());
   populateReconcileUnrealizedCastsPatterns(patterns);
 
+  // Entry points are identified prior to conversion as they are otherwise
+  // indistinguishable from other public LLVM functions.
+  SmallVector<std::string> entryPointNames;
+  if (targetWorkgroupRanges) {
+    for (auto funcOp : module.getOps<func::FuncOp>()) {
+      FunctionType fnType = funcOp.getFunctionType();
+      if (funcOp.isPublic() && !funcOp.isExternal() &&
+          fnType.getNumInputs() == 0 && fnType.getNumResults() == 0) {
+        entryPointNames.push_back(funcOp.getName().str());
+      }
+    }
+  }
+
   HALDispatchABI abi(&typeConverter);
   // clang-format off
   patterns.insert<
@@ -1089,6 +1108,13 @@ void ConvertToLLVMPass::runOnOperation() {
       return signalPassFailure();
   }
 
+  // Wrap entry points in loops over workgroup ranges.
+  for (auto &entryPointName : entryPointNames) {
+    if (auto funcOp = module.lookupSymbol<LLVM::LLVMFuncOp>(entryPointName)) {
+      HALDispatchABI::buildWorkgroupRangeEntryPoint(funcOp, &typeConverter);
+    }
+  }
+
   // Post conversion patterns.
   {
     RewritePatternSet postPatterns(&getContext());
@@ -1105,8 +1131,9 @@ void ConvertToLLVMPass::runOnOperation() {
 }
 
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertToLLVMPass(bool reassociateFpReductions) {
-  return std::make_unique<ConvertToLLVMPass>(reassociateFpReductions);
+createConvertToLLVMPass(bool reassociateFpReductions, bool workgroupRanges) {
+  return std::make_unique<ConvertToLLVMPass>(reassociateFpReductions,
+                                             workgroupRanges);
 }
 
 } // namespace iree_compiler
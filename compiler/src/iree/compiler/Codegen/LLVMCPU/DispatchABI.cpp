@@ -298,7 +298,8 @@ LLVM::DIDerivedTypeAttr ExecutableLibraryDI::getWorkgroupStateV0T() {
               getMemberOf("workgroup_id_x", getUint32T(), &offsetInBits),
               getMemberOf("workgroup_id_y", getUint32T(), &offsetInBits),
               getMemberOf("workgroup_id_z", getUint16T(), &offsetInBits),
-              getMemberOf("reserved", getUint16T(), &offsetInBits),
+              getMemberOf("workgroup_range_count", getUint16T(),
+                          &offsetInBits),
               getMemberOf("processor_id", getUint32T(), &offsetInBits),
               getMemberOf("local_memory", getVoidPtr(), &offsetInBits),
               getMemberOf("local_memory_size", getUint32T(), &offsetInBits),
@@ -451,7 +452,7 @@ HALDispatchABI::getWorkgroupStateType(MLIRContext *context,
   fieldTypes.push_back(uint32Type);
   fieldTypes.push_back(uint16Type);
 
-  // uint16_t reserved;
+  // uint16_t workgroup_range_count;
   fieldTypes.push_back(uint16Type);
 
   // uint32_t processor_id;
@@ -529,6 +530,165 @@ HALDispatchABI::buildScopeAttr(mlir::ModuleOp moduleOp, StringRef funcName,
       subroutineTypeAttr);
 }
 
+LLVM::LLVMFuncOp HALDispatchABI::buildWorkgroupRangeEntryPoint(
+    LLVM::LLVMFuncOp funcOp, const LLVMTypeConverter *typeConverter) {
+  auto *context = funcOp.getContext();
+  OpBuilder builder(context);
+  auto i32Type = builder.getI32Type();
+  auto i16Type = builder.getI16Type();
+  auto ptrType = LLVM::LLVMPointerType::get(context);
+  auto dispatchStateType = getDispatchStateType(context, typeConverter);
+  auto workgroupStateType = getWorkgroupStateType(context, typeConverter);
+
+  // Move the original function out of the way and have it inlined into the
+  // loop below. The debug scope of the function is kept as-is as the body
+  // references it.
+  std::string exportName = funcOp.getName().str();
+  funcOp.setSymName(exportName + "_workgroup");
+  funcOp.setLinkageAttr(
+      LLVM::LinkageAttr::get(context, LLVM::Linkage::Internal));
+  SmallVector<Attribute> passthroughAttrs;
+  if (auto existingAttrs = funcOp.getPassthroughAttr()) {
+    llvm::append_range(passthroughAttrs, existingAttrs);
+  }
+  passthroughAttrs.push_back(builder.getStringAttr("alwaysinline"));
+  funcOp.setPassthroughAttr(builder.getArrayAttr(passthroughAttrs));
+
+  // The wrapper gets its own debug scope so that the inlined body has a valid
+  // call site location.
+  Location loc = funcOp.getLoc();
+  if (auto scopeLocAttr =
+          loc->findInstanceOf<mlir::FusedLocWith<LLVM::DISubprogramAttr>>()) {
+    loc = FusedLoc::get(context, scopeLocAttr.getLocations());
+  }
+  auto scopeAttr = buildScopeAttr(funcOp->getParentOfType<mlir::ModuleOp>(),
+                                  exportName, typeConverter);
+  auto funcType = funcOp.getFunctionType();
+  builder.setInsertionPointAfter(funcOp);
+  auto rangeFuncOp = builder.create<LLVM::LLVMFuncOp>(
+      FusedLoc::get(context, {loc}, scopeAttr), exportName, funcType,
+      LLVM::Linkage::External, /*dsoLocal=*/false, /*cconv=*/LLVM::CConv::C);
+  for (unsigned i = 0; i <= 2; ++i) {
+    rangeFuncOp.setArgAttr(i, LLVM::LLVMDialect::getNoAliasAttrName(),
+                           builder.getUnitAttr());
+    rangeFuncOp.setArgAttr(i, LLVM::LLVMDialect::getAlignAttrName(),
+                           builder.getI64IntegerAttr(16));
+  }
+  rangeFuncOp.setPassthroughAttr(
+      builder.getArrayAttr({builder.getStringAttr(kWorkgroupRangeAttrName)}));
+
+  // Entry: sample the workgroup count and range and make a mutable copy of the
+  // workgroup state to pass to each workgroup.
+  Block *entryBlock = builder.createBlock(
+      &rangeFuncOp.getBody(), rangeFuncOp.getBody().end(),
+      funcType.getParams(),
+      SmallVector<Location>(funcType.getNumParams(), loc));
+  Value environmentPtr = entryBlock->getArgument(0);
+  Value dispatchStatePtr = entryBlock->getArgument(1);
+  Value workgroupStatePtr = entryBlock->getArgument(2);
+  builder.setInsertionPointToStart(entryBlock);
+  Value dispatchState =
+      builder.create<LLVM::LoadOp>(loc, dispatchStateType, dispatchStatePtr);
+  Value workgroupCountX = builder.create<LLVM::ExtractValueOp>(
+      loc, dispatchState,
+      SmallVector<int64_t, 1>{int64_t(DispatchStateField::workgroup_count_x)});
+  Value workgroupCountY = builder.create<LLVM::ExtractValueOp>(
+      loc, dispatchState,
+      SmallVector<int64_t, 1>{int64_t(DispatchStateField::workgroup_count_y)});
+  Value workgroupState =
+      builder.create<LLVM::LoadOp>(loc, workgroupStateType, workgroupStatePtr);
+  auto extractWorkgroupField = [&](WorkgroupStateField field) -> Value {
+    return builder.create<LLVM::ExtractValueOp>(
+        loc, workgroupState, SmallVector<int64_t, 1>{int64_t(field)});
+  };
+  Value baseX = extractWorkgroupField(WorkgroupStateField::workgroup_id_x);
+  Value baseY = extractWorkgroupField(WorkgroupStateField::workgroup_id_y);
+  Value baseZ = extractWorkgroupField(WorkgroupStateField::workgroup_id_z);
+  Value rangeCount = builder.create<LLVM::ZExtOp>(
+      loc, i32Type,
+      extractWorkgroupField(WorkgroupStateField::workgroup_range_count));
+  Value zeroI32 = builder.create<LLVM::ConstantOp>(loc, i32Type, 0);
+  Value oneI32 = builder.create<LLVM::ConstantOp>(loc, i32Type, 1);
+  Value oneI16 = builder.create<LLVM::ConstantOp>(loc, i16Type, 1);
+  // A range count of 0 is treated as 1 for hosts that zero the field.
+  rangeCount = builder.create<LLVM::SelectOp>(
+      loc,
+      builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, rangeCount,
+                                   zeroI32),
+      oneI32, rangeCount);
+  Value statePtr = builder.create<LLVM::AllocaOp>(
+      loc, ptrType, workgroupStateType, oneI32, /*alignment=*/16);
+  workgroupState = builder.create<LLVM::InsertValueOp>(
+      loc, workgroupState, oneI16,
+      SmallVector<int64_t, 1>{
+          int64_t(WorkgroupStateField::workgroup_range_count)});
+
+  // Loop: execute one workgroup per iteration advancing x, then y, then z.
+  Block *loopBlock = builder.createBlock(
+      &rangeFuncOp.getBody(), rangeFuncOp.getBody().end(),
+      {i32Type, i32Type, i32Type, i16Type}, {loc, loc, loc, loc});
+  Block *continueBlock =
+      builder.createBlock(&rangeFuncOp.getBody(), rangeFuncOp.getBody().end());
+  Block *exitBlock = builder.createBlock(&rangeFuncOp.getBody(),
+                                         rangeFuncOp.getBody().end(),
+                                         {i32Type}, {loc});
+  builder.setInsertionPointToEnd(entryBlock);
+  builder.create<LLVM::BrOp>(loc, ValueRange{zeroI32, baseX, baseY, baseZ},
+                             loopBlock);
+
+  builder.setInsertionPointToStart(loopBlock);
+  Value index = loopBlock->getArgument(0);
+  Value x = loopBlock->getArgument(1);
+  Value y = loopBlock->getArgument(2);
+  Value z = loopBlock->getArgument(3);
+  Value iterationState = workgroupState;
+  iterationState = builder.create<LLVM::InsertValueOp>(
+      loc, iterationState, x,
+      SmallVector<int64_t, 1>{int64_t(WorkgroupStateField::workgroup_id_x)});
+  iterationState = builder.create<LLVM::InsertValueOp>(
+      loc, iterationState, y,
+      SmallVector<int64_t, 1>{int64_t(WorkgroupStateField::workgroup_id_y)});
+  iterationState = builder.create<LLVM::InsertValueOp>(
+      loc, iterationState, z,
+      SmallVector<int64_t, 1>{int64_t(WorkgroupStateField::workgroup_id_z)});
+  builder.create<LLVM::StoreOp>(loc, iterationState, statePtr);
+  Value result =
+      builder
+          .create<LLVM::CallOp>(
+              loc, funcOp,
+              ValueRange{environmentPtr, dispatchStatePtr, statePtr})
+          .getResult();
+  // Failures abort the remainder of the range.
+  Value failed = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne,
+                                              result, zeroI32);
+  builder.create<LLVM::CondBrOp>(loc, failed, exitBlock, ValueRange{result},
+                                 continueBlock, ValueRange{});
+
+  builder.setInsertionPointToStart(continueBlock);
+  Value nextIndex = builder.create<LLVM::AddOp>(loc, index, oneI32);
+  Value nextX = builder.create<LLVM::AddOp>(loc, x, oneI32);
+  Value wrapX = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq,
+                                             nextX, workgroupCountX);
+  nextX = builder.create<LLVM::SelectOp>(loc, wrapX, zeroI32, nextX);
+  Value nextY = builder.create<LLVM::SelectOp>(
+      loc, wrapX, builder.create<LLVM::AddOp>(loc, y, oneI32), y);
+  Value wrapY = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq,
+                                             nextY, workgroupCountY);
+  nextY = builder.create<LLVM::SelectOp>(loc, wrapY, zeroI32, nextY);
+  Value nextZ = builder.create<LLVM::SelectOp>(
+      loc, wrapY, builder.create<LLVM::AddOp>(loc, z, oneI16), z);
+  Value more = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult,
+                                            nextIndex, rangeCount);
+  builder.create<LLVM::CondBrOp>(loc, more, loopBlock,
+                                 ValueRange{nextIndex, nextX, nextY, nextZ},
+                                 exitBlock, ValueRange{zeroI32});
+
+  builder.setInsertionPointToStart(exitBlock);
+  builder.create<LLVM::ReturnOp>(loc, exitBlock->getArgument(0));
+
+  return rangeFuncOp;
+}
+
 // Returns the most local DISubprogramAttr starting from |forOp|.
 static LLVM::DISubprogramAttr getLocalScopeAttr(Operation *forOp) {
   auto funcOp = forOp->getParentOfType<LLVM::LLVMFuncOp>();
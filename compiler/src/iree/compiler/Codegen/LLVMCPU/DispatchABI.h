@@ -181,7 +181,7 @@ public:
     /*uint32_t*/ workgroup_id_x = 0,
     /*uint32_t*/ workgroup_id_y,
     /*uint16_t*/ workgroup_id_z,
-    /*uint16_t*/ reserved,
+    /*uint16_t*/ workgroup_range_count,
     /*uint32_t*/ processor_id,
     /*intptr_t*/ local_memory,
     /*uint32_t*/ local_memory_size,
@@ -210,6 +210,21 @@ public:
   buildScopeAttr(mlir::ModuleOp moduleOp, StringRef funcName,
                  const LLVMTypeConverter *typeConverter);
 
+  // LLVM function attribute placed on entry points built with
+  // buildWorkgroupRangeEntryPoint. Target backends use it to declare
+  // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE on the export.
+  static constexpr StringLiteral kWorkgroupRangeAttrName =
+      "iree-hal-workgroup-range";
+
+  // Wraps the entry point |funcOp| in a function taking over its name that
+  // executes the workgroup_range_count workgroups starting at the workgroup ID
+  // in the workgroup state. The original function is renamed, made internal,
+  // and marked for inlining into the loop so that the per-call overhead of the
+  // ABI is paid once per range instead of once per workgroup.
+  static LLVM::LLVMFuncOp
+  buildWorkgroupRangeEntryPoint(LLVM::LLVMFuncOp funcOp,
+                                const LLVMTypeConverter *typeConverter);
+
   explicit HALDispatchABI(LLVMTypeConverter *typeConverter)
       : context(&typeConverter->getContext()), typeConverter(typeConverter),
         processorType(getProcessorType(context, typeConverter)),
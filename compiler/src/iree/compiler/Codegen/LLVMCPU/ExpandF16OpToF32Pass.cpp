@@ -6,7 +6,10 @@
 
 #include "iree/compiler/Codegen/LLVMCPU/PassDetail.h"
 #include "iree/compiler/Codegen/LLVMCPU/Passes.h"
+#include "iree/compiler/Codegen/LLVMCPU/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Vector/Transforms/LoweringPatterns.h"
 #include "mlir/Dialect/Vector/Transforms/VectorRewritePatterns.h"
 #include "mlir/Pass/Pass.h"
@@ -32,6 +35,12 @@ public:
     if (getElementTypeOrSelf(resultType).getIntOrFloatBitWidth() != 16) {
       return failure();
     }
+    // Targets with native f16 arithmetic lower the op directly and keep the
+    // values in f16 vector registers.
+    if (getElementTypeOrSelf(resultType).isF16() &&
+        hasFullFp16Feature(IREE::HAL::ExecutableTargetAttr::lookup(op))) {
+      return failure();
+    }
 
     Location loc = op.getLoc();
 
@@ -49,16 +58,154 @@ public:
   }
 };
 
+/// Returns |source| converted elementwise to |elementType| with an
+/// arith.extf or arith.truncf.
+static Value convertFloatTensor(OpBuilder &builder, Location loc, Value source,
+                                Type elementType) {
+  auto sourceType = llvm::cast<RankedTensorType>(source.getType());
+  int64_t rank = sourceType.getRank();
+  SmallVector<OpFoldResult> sizes =
+      tensor::getMixedSizes(builder, loc, source);
+  Value empty = builder.create<tensor::EmptyOp>(loc, sizes, elementType);
+  AffineMap identityMap = builder.getMultiDimIdentityMap(rank);
+  SmallVector<utils::IteratorType> iteratorTypes(rank,
+                                                 utils::IteratorType::parallel);
+  auto genericOp = builder.create<linalg::GenericOp>(
+      loc, empty.getType(), source, empty,
+      ArrayRef<AffineMap>{identityMap, identityMap}, iteratorTypes,
+      [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+        Value result;
+        if (elementType.getIntOrFloatBitWidth() >
+            args[0].getType().getIntOrFloatBitWidth()) {
+          result = b.create<arith::ExtFOp>(nestedLoc, elementType, args[0]);
+        } else {
+          result = b.create<arith::TruncFOp>(nestedLoc, elementType, args[0]);
+        }
+        b.create<linalg::YieldOp>(nestedLoc, result);
+      });
+  return genericOp.getResult(0);
+}
+
+/// Rewrites a reduction with an f16 accumulator to accumulate in f32 and round
+/// the result to f16 once after the reduction instead of at every step.
+/// Floating-point arithmetic on the accumulator is performed in f32 and all
+/// other operations in the body are left in f16.
+struct WidenF16ReductionAccumulatorPattern
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp genericOp,
+                                PatternRewriter &rewriter) const override {
+    if (!genericOp.hasTensorSemantics() || genericOp.getNumDpsInits() != 1 ||
+        genericOp.getNumReductionLoops() == 0) {
+      return failure();
+    }
+    OpOperand *initOperand = genericOp.getDpsInitOperand(0);
+    auto initType =
+        llvm::dyn_cast<RankedTensorType>(initOperand->get().getType());
+    if (!initType || !initType.getElementType().isF16()) {
+      return failure();
+    }
+    Block *body = genericOp.getBody();
+    if (genericOp.getMatchingBlockArgument(initOperand).use_empty() ||
+        llvm::any_of(body->getOperations(), [](Operation &op) {
+          return op.getNumRegions() != 0;
+        })) {
+      return failure();
+    }
+
+    Location loc = genericOp.getLoc();
+    Type f16Type = rewriter.getF16Type();
+    Type f32Type = rewriter.getF32Type();
+    Value wideInit =
+        convertFloatTensor(rewriter, loc, initOperand->get(), f32Type);
+    auto wideOp = rewriter.create<linalg::GenericOp>(
+        loc, wideInit.getType(), genericOp.getDpsInputs(), wideInit,
+        genericOp.getIndexingMapsArray(), genericOp.getIteratorTypesArray());
+
+    SmallVector<Type> argTypes;
+    SmallVector<Location> argLocs;
+    for (BlockArgument arg : body->getArguments()) {
+      argTypes.push_back(arg.getType());
+      argLocs.push_back(arg.getLoc());
+    }
+    argTypes.back() = f32Type;
+    Block *wideBody = rewriter.createBlock(&wideOp.getRegion(), {}, argTypes,
+                                           argLocs);
+    IRMapping mapping;
+    mapping.map(body->getArguments(), wideBody->getArguments());
+    // Values of the new body standing in for f16 values of the original.
+    DenseSet<Value> widenedValues;
+    widenedValues.insert(wideBody->getArguments().back());
+    auto getWide = [&](Value value) -> Value {
+      Value mapped = mapping.lookupOrDefault(value);
+      if (widenedValues.contains(mapped) || !mapped.getType().isF16())
+        return mapped;
+      return rewriter.create<arith::ExtFOp>(loc, f32Type, mapped);
+    };
+    for (Operation &op : body->without_terminator()) {
+      bool usesAccumulator = llvm::any_of(op.getOperands(), [&](Value value) {
+        return widenedValues.contains(mapping.lookupOrDefault(value));
+      });
+      if (usesAccumulator && op.getNumResults() == 1 &&
+          op.getResult(0).getType() == f16Type &&
+          isa<arith::AddFOp, arith::SubFOp, arith::MulFOp, arith::DivFOp,
+              arith::MaximumFOp, arith::MinimumFOp, arith::SelectOp>(op)) {
+        SmallVector<Value> operands;
+        for (Value operand : op.getOperands())
+          operands.push_back(getWide(operand));
+        OperationState state(op.getLoc(), op.getName(), operands, {f32Type},
+                             op.getAttrs());
+        Value result = rewriter.create(state)->getResult(0);
+        mapping.map(op.getResult(0), result);
+        widenedValues.insert(result);
+        continue;
+      }
+      // Any other use of the accumulator sees it rounded to f16.
+      SmallVector<std::pair<Value, Value>> widenedOperands;
+      for (Value operand : op.getOperands()) {
+        Value mapped = mapping.lookupOrDefault(operand);
+        if (!widenedValues.contains(mapped))
+          continue;
+        widenedOperands.emplace_back(operand, mapped);
+        mapping.map(operand,
+                    rewriter.create<arith::TruncFOp>(loc, f16Type, mapped));
+      }
+      rewriter.clone(op, mapping);
+      for (auto [operand, mapped] : widenedOperands)
+        mapping.map(operand, mapped);
+    }
+    auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+    rewriter.create<linalg::YieldOp>(yieldOp.getLoc(),
+                                     getWide(yieldOp.getOperand(0)));
+
+    rewriter.setInsertionPointAfter(wideOp);
+    rewriter.replaceOp(genericOp, convertFloatTensor(rewriter, loc,
+                                                     wideOp.getResult(0),
+                                                     f16Type));
+    return success();
+  }
+};
+
 struct ExpandF16OpToF32Pass
     : public ExpandArithF16ToF32Base<ExpandF16OpToF32Pass> {
+  ExpandF16OpToF32Pass() = default;
+  ExpandF16OpToF32Pass(const ExpandF16OpToF32Pass &pass) {}
+  explicit ExpandF16OpToF32Pass(bool accumulateReductionsInF32) {
+    this->accumulateReductionsInF32 = accumulateReductionsInF32;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
-    registry.insert<linalg::LinalgDialect>();
+    registry.insert<linalg::LinalgDialect, tensor::TensorDialect>();
   }
 
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(&getContext());
     patterns.insert<ExpandF16OpToF32Pattern<arith::MaximumFOp>>(context);
+    if (accumulateReductionsInF32) {
+      patterns.insert<WidenF16ReductionAccumulatorPattern>(context);
+    }
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -67,8 +214,9 @@ struct ExpandF16OpToF32Pass
 };
 } // namespace
 
-std::unique_ptr<Pass> createExpandF16OpToF32Pass() {
-  return std::make_unique<ExpandF16OpToF32Pass>();
+std::unique_ptr<Pass>
+createExpandF16OpToF32Pass(bool accumulateReductionsInF32) {
+  return std::make_unique<ExpandF16OpToF32Pass>(accumulateReductionsInF32);
 }
 
 } // namespace iree_compiler
@@ -10,6 +10,7 @@
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "iree/compiler/Codegen/Common/TileSizeSelection.h"
+#include "iree/compiler/Codegen/Common/UserConfig.h"
 #include "iree/compiler/Codegen/LLVMCPU/TargetMLTransformInfo.h"
 #include "iree/compiler/Codegen/LLVMCPU/Utils.h"
 #include "iree/compiler/Codegen/TransformStrategies/CPU/Common.h"
@@ -999,6 +1000,38 @@ static void getDefaultMatmulVectorSizes(
   return;
 }
 
+/// Shrinks the M and N vector tile sizes of a matmul, given as (M, N, K), until
+/// the unrolled kernel is predicted to fit in the register file described by
+/// `targetMLTransInfo`. The model assumes the lowering keeps an M x N/vector
+/// accumulator tile live, loads one row of the RHS tile and broadcasts one LHS
+/// element per reduction step. The dimension using more registers is halved
+/// first so the tile stays as square as possible.
+static void
+limitMatmulVectorSizesByRegisterPressure(SmallVectorImpl<int64_t> &sizes,
+                                         int64_t vectorSize,
+                                         const TargetMLTransformInfo &info) {
+  if (info.numVectorRegisters == 0 || sizes.size() != 3 || vectorSize <= 0)
+    return;
+  int64_t &tileM = sizes[0];
+  int64_t &tileN = sizes[1];
+  auto getNumRegisters = [&]() {
+    int64_t numNVectors = llvm::divideCeil(tileN, vectorSize);
+    return tileM * numNVectors + numNVectors + 1;
+  };
+  while (getNumRegisters() > info.numVectorRegisters) {
+    int64_t numNVectors = llvm::divideCeil(tileN, vectorSize);
+    if (tileM > numNVectors && tileM > 1) {
+      tileM /= 2;
+    } else if (tileN > vectorSize) {
+      tileN /= 2;
+    } else if (tileM > 1) {
+      tileM /= 2;
+    } else {
+      break;
+    }
+  }
+}
+
 /// Main utility to compute the vectorization/unrolling tile sizes.
 static SizesAndScalableFlags getMatmulVectorSizes(func::FuncOp entryPointFn,
                                                   linalg::LinalgOp op,
@@ -1025,6 +1058,15 @@ static SizesAndScalableFlags getMatmulVectorSizes(func::FuncOp entryPointFn,
     getDefaultMatmulVectorSizes(op, matmulTileSizes, matmulScalableFlags,
                                 vectorSize);
   }
+
+  // Reduce the unrolling if the kernel is predicted to spill. Scalable sizes
+  // are left alone as their register footprint is unknown at compile time.
+  if (llvm::none_of(matmulScalableFlags, [](bool flag) { return flag; })) {
+    auto targetMLTransInfo =
+        TargetMLTransformInfo::getTargetMLTransformInfo(targetAttr);
+    limitMatmulVectorSizesByRegisterPressure(matmulTileSizes, vectorSize,
+                                             targetMLTransInfo);
+  }
   // Pad the scalable flags with false to match the tile sizes.
   matmulScalableFlags.resize(matmulTileSizes.size());
 
@@ -1242,11 +1284,28 @@ static LogicalResult setRootConfig(func::FuncOp entryPointFn,
     minTileSizes[0] = 1;
     minTileSizes[1] = 4;
     minTileSizes[2] = 4;
-    maxTileSizes[0] = 1;
+    // With microkernels, a workgroup can cover several batches (e.g. attention
+    // heads) with a single batch_mmt4d call, amortizing the per-call overhead.
+    auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+    maxTileSizes[0] = hasMicrokernels(targetAttr) ? 32 : 1;
     maxTileSizes[1] = 48;
     maxTileSizes[2] = 32;
     SmallVector<int64_t> distTileSizes = getDefaultDistributedLevelTileSizes(
         batchMmt4dOp, minTileSizes, maxTileSizes);
+
+    // When the M1 and N1 dims are too small to give work to all threads, e.g.
+    // for the partial accumulators of an mmt4d whose reduction was split by
+    // CPUSplitMmt4dReduction, distribute the batch dim one batch at a time.
+    SmallVector<int64_t> loopRanges = batchMmt4dOp.getStaticLoopRanges();
+    int64_t numWorkgroups = 1;
+    for (auto [range, tileSize] : llvm::zip(loopRanges, distTileSizes)) {
+      if (ShapedType::isDynamic(range) || tileSize == 0)
+        continue;
+      numWorkgroups *= llvm::divideCeil(range, tileSize);
+    }
+    if (numWorkgroups < clNumberOfRuntimeThreads) {
+      distTileSizes[0] = std::min<int64_t>(distTileSizes[0], 1);
+    }
     return distTileSizes;
   };
 
@@ -1389,6 +1448,54 @@ setUnPackOpRootConfig(func::FuncOp entryPointFn, tensor::UnPackOp op,
                                                pipeline);
 }
 
+/// Sets the lowering configuration for a linalg.softmax root op. Softmax ops
+/// only reach here when they are meant to be lowered to the softmax
+/// microkernel, which works on 2-D tiles: all the outer dimensions but the
+/// last one are tiled to 1 so that the tile can be collapsed to 2-D.
+static LogicalResult setRootConfig(func::FuncOp entryPointFn,
+                                   linalg::SoftmaxOp op) {
+  assert(!getLoweringConfig(op) && "expected lowering_config is not set");
+  SmallVector<int64_t> distTileSizes =
+      getDefaultDistributionTileSizes(cast<TilingInterface>(op.getOperation()));
+  int64_t rank = op.getInputOperandRank();
+  for (int64_t i = 0; i < rank - 2; ++i) {
+    if (distTileSizes[i] != 0)
+      distTileSizes[i] = 1;
+  }
+  TileSizesListType tileSizesList = {distTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, op, tileSizesList,
+      DispatchLoweringPassPipeline::CPUDefault);
+}
+
+/// Sets the lowering configuration for a linalg_ext.attention root op. The
+/// tile-and-decompose lowering of attention processes one batch and a tile of
+/// the query sequence per workgroup, iterating over the key sequence with the
+/// same tile size, and needs the whole head dimension. So the batch is tiled
+/// to 1, the head dimension is not tiled, and the sequence tile size must
+/// divide both the query and the key sequence lengths.
+static LogicalResult setRootConfig(func::FuncOp entryPointFn,
+                                   IREE::LinalgExt::AttentionOp attnOp) {
+  assert(!getLoweringConfig(attnOp) && "expected lowering_config is not set");
+  ShapedType queryType = attnOp.getQueryType();
+  ShapedType keyType = attnOp.getKeyType();
+  if (!queryType.hasStaticShape() || !keyType.hasStaticShape()) {
+    return attnOp.emitOpError("expected static shapes");
+  }
+  int64_t seqLengths =
+      std::gcd(queryType.getDimSize(1), keyType.getDimSize(1));
+  int64_t seqTileSize = std::max<int64_t>(
+      std::min<int64_t>(seqLengths, defaultDistTileSize), 1);
+  while (seqTileSize > 1 && seqLengths % seqTileSize != 0) {
+    --seqTileSize;
+  }
+  SmallVector<int64_t> distTileSizes = {1, seqTileSize, 0};
+  TileSizesListType tileSizes = {distTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, attnOp, tileSizes,
+      DispatchLoweringPassPipeline::CPUDefault);
+}
+
 /// Sets the lowering configuration for dispatch region for linalg_ext.fft
 /// root op.
 static LogicalResult
@@ -1641,6 +1748,12 @@ setTransposeLikeOpRootConfig(func::FuncOp entryPointFn,
 /// Sets elementwise dispatches to use peeling approach. It scales the number of
 /// workload per workgroup to a larger number, which prevents runtime overheads
 /// from tiny dispatches.
+/// Returns true if the body of `genericOp` reads from a tensor through
+/// `tensor.extract`, e.g., the row lookup of an embedding table.
+static bool hasTensorExtractInBody(linalg::GenericOp genericOp) {
+  return !genericOp.getBody()->getOps<tensor::ExtractOp>().empty();
+}
+
 static LogicalResult setElementwiseGenericOpRootConfig(
     func::FuncOp entryPointFn, linalg::GenericOp genericOp,
     const LinalgOpInfo &linalgOpInfo,
@@ -1703,6 +1816,19 @@ static LogicalResult setElementwiseGenericOpRootConfig(
                       vecPreProcStrategy == VectorPreProcStrategy::Masking);
   }
 
+  // Gather-like ops index a tensor with values loaded at runtime. Unrolling
+  // the outer dimensions turns every `tensor.extract` into an n-D
+  // `vector.gather`, while a unit outer tile lets the vectorizer recognize the
+  // contiguous accesses along the innermost dimension (e.g., the rows of an
+  // embedding table) and emit plain vector loads. Non-contiguous accesses still
+  // become 1-D gathers, which lower to masked gathers on AVX2/AVX-512/SVE.
+  if (hasTensorExtractInBody(genericOp)) {
+    for (int64_t &tileSize :
+         MutableArrayRef<int64_t>(vecTileSizes).drop_back()) {
+      tileSize = std::min<int64_t>(tileSize, 1);
+    }
+  }
+
   // Setting reduction tile sizes is a workaround to kick in peeling transform.
   // The tiling won't happen because the sizes are zeros.
   SmallVector<int64_t> zeros(numLoops, 0);
@@ -2041,8 +2167,9 @@ setRootConfigImpl(func::FuncOp entryPointFn, Operation *op,
           return setRootConfig(entryPointFn, op, LinalgOpInfo(op),
                                targetMLTransInfo);
         })
-        .Case<IREE::LinalgExt::FftOp, tensor::PackOp, tensor::PadOp,
-              linalg::Mmt4DOp, linalg::BatchMmt4DOp>(
+        .Case<IREE::LinalgExt::FftOp, IREE::LinalgExt::AttentionOp,
+              tensor::PackOp, tensor::PadOp, linalg::Mmt4DOp,
+              linalg::BatchMmt4DOp>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<linalg::Conv2DNhwcHwcfOp, linalg::Conv2DNchwFchwOp,
               linalg::PoolingNhwcSumOp, linalg::PoolingNhwcMaxOp,
@@ -2054,6 +2181,8 @@ setRootConfigImpl(func::FuncOp entryPointFn, Operation *op,
             })
         .Case<tensor::UnPackOp>(
             [&](auto op) { return setUnPackOpRootConfig(entryPointFn, op); })
+        .Case<linalg::SoftmaxOp>(
+            [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<linalg::ContractionOpInterface>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<linalg::LinalgOp>(
@@ -2512,6 +2641,15 @@ setTranslationInfoAndRootConfig(func::FuncOp entryPointFn,
     return lowerUsingDefaultPipeline(entryPointFn);
   }
 
+  // Use the configuration measured to be the fastest if a profile is provided.
+  // Like user configurations these are used as-is.
+  FailureOr<bool> profiledConfig =
+      setProfileGuidedConfig(entryPointFn, rootOperation);
+  if (failed(profiledConfig))
+    return failure();
+  if (*profiledConfig)
+    return success();
+
   auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
   if (isVMVXBackend(targetAttr)) {
     if (failed(setVMVXRootConfigImpl(entryPointFn, rootOperation))) {
@@ -207,7 +207,8 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
       case IREE::Codegen::DispatchLoweringPassPipeline::None:
         return;
       case IREE::Codegen::DispatchLoweringPassPipeline::CPUDefault:
-        addCPUDefaultPassPipeline(executableLoweringPipeline);
+        addCPUDefaultPassPipeline(executableLoweringPipeline,
+                                  enableMicrokernels);
         break;
       case IREE::Codegen::DispatchLoweringPassPipeline::
           CPUBufferOpsTileAndVectorize: {
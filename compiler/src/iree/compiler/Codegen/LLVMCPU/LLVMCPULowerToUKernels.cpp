@@ -14,6 +14,7 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinAttributes.h"
@@ -21,6 +22,8 @@
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/TypeRange.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/ValueBoundsOpInterface.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -102,45 +105,183 @@ getFnNameAndDefAttrs(const char *ukernelName, RewriterBase &rewriter,
   return result;
 }
 
-/// Matches an (linalg.fill -> )? linalg.mmt4d operation sequence and converts
-/// it into a iree_codegen.ukernel.mmt4d operation, that is later lowered
-/// into a call to the microkernel.
-static FailureOr<IREE::Codegen::UKernelOpInterface>
-matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
-                   bool skipIntermediateRoundings) {
-  Value lhs = op.getDpsInputOperand(0)->get();
-  Value rhs = op.getDpsInputOperand(1)->get();
-  Value out = op.getDpsInitOperand(0)->get();
-  auto lhsType = llvm::cast<ShapedType>(lhs.getType());
-  auto rhsType = llvm::cast<ShapedType>(rhs.getType());
-  auto outType = llvm::cast<ShapedType>(out.getType());
-  Type lhsElemType = lhsType.getElementType();
-  Type rhsElemType = rhsType.getElementType();
-  Type outElemType = outType.getElementType();
-  uint32_t flags = 0;
+/// Returns the IREE_UK_FLAG_MMT4D_TYPE_* value for the element types of the
+/// operands of `op`, a linalg.mmt4d or linalg.batch_mmt4d, or 0 if there is no
+/// mmt4d ukernel for them.
+static uint32_t getMmt4dTypeFlag(linalg::LinalgOp op) {
+  Type lhsElemType = getElementTypeOrSelf(op.getDpsInputOperand(0)->get());
+  Type rhsElemType = getElementTypeOrSelf(op.getDpsInputOperand(1)->get());
+  Type outElemType = getElementTypeOrSelf(op.getDpsInitOperand(0)->get());
   if (lhsElemType.isSignlessInteger(8) && rhsElemType.isSignlessInteger(8) &&
       outElemType.isSignlessInteger(32)) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_I8I8I32;
+    return IREE_UK_FLAG_MMT4D_TYPE_I8I8I32;
   } else if (lhsElemType.isF32() && rhsElemType.isF32() &&
              outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F32F32F32;
+    return IREE_UK_FLAG_MMT4D_TYPE_F32F32F32;
   } else if (lhsElemType.isF16() && rhsElemType.isF16() &&
              outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F16F16F32;
+    return IREE_UK_FLAG_MMT4D_TYPE_F16F16F32;
   } else if (lhsElemType.isF16() && rhsElemType.isF16() &&
              outElemType.isF16()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_F16F16F16;
+    return IREE_UK_FLAG_MMT4D_TYPE_F16F16F16;
   } else if (lhsElemType.isBF16() && rhsElemType.isBF16() &&
              outElemType.isF32()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32;
+    return IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32;
   } else if (lhsElemType.isBF16() && rhsElemType.isBF16() &&
              outElemType.isBF16()) {
-    flags = IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16;
-  } else {
+    return IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16;
+  } else if (lhsElemType.isF32() && rhsElemType.isSignlessInteger(8) &&
+             outElemType.isF32()) {
+    // Weight-only quantized matmul: the i8 RHS is sign-extended to f32 and any
+    // dequantization scales are applied by consumers of the result.
+    return IREE_UK_FLAG_MMT4D_TYPE_F32I8F32;
+  }
+  return 0;
+}
+
+/// Describes an elementwise consumer of a linalg.mmt4d that can be lowered
+/// together with it to the `mmt4d_epilogue` microkernel.
+struct Mmt4dEpilogue {
+  linalg::Mmt4DOp mmt4dOp;
+  Value bias;
+  uint32_t flags = 0;
+  float clampMin = 0.0f;
+  float clampMax = 0.0f;
+};
+
+/// Matches a linalg.generic computing `activation(mmt4d + bias)` elementwise,
+/// where `mmt4d` is the result of a linalg.mmt4d with f32 or i32 accumulators
+/// and no other use, `bias` is broadcast along the M and M0 dimensions, and
+/// the activation is either absent, a relu, or a clamp to constant bounds.
+static FailureOr<Mmt4dEpilogue> matchMmt4dEpilogue(linalg::GenericOp op) {
+  if (op.getNumDpsInputs() != 2 || op.getNumDpsInits() != 1 ||
+      op.getNumLoops() != 4 || op.getNumParallelLoops() != 4) {
+    return failure();
+  }
+  MLIRContext *context = op.getContext();
+  AffineMap biasMap = AffineMap::get(
+      4, 0, {getAffineDimExpr(1, context), getAffineDimExpr(3, context)},
+      context);
+  Mmt4dEpilogue epilogue;
+  int accIndex = -1;
+  for (int i = 0; i < 2; ++i) {
+    OpOperand *input = op.getDpsInputOperand(i);
+    auto mmt4dOp = input->get().getDefiningOp<linalg::Mmt4DOp>();
+    if (mmt4dOp && op.getMatchingIndexingMap(input).isIdentity()) {
+      epilogue.mmt4dOp = mmt4dOp;
+      accIndex = i;
+      break;
+    }
+  }
+  if (accIndex < 0 || !epilogue.mmt4dOp->hasOneUse()) {
+    return failure();
+  }
+  OpOperand *biasOperand = op.getDpsInputOperand(1 - accIndex);
+  if (op.getMatchingIndexingMap(biasOperand) != biasMap ||
+      !op.getMatchingIndexingMap(op.getDpsInitOperand(0)).isIdentity()) {
+    return failure();
+  }
+  epilogue.bias = biasOperand->get();
+  Type accType = getElementTypeOrSelf(epilogue.mmt4dOp->getResult(0));
+  if (!accType.isF32() && !accType.isSignlessInteger(32)) {
+    return failure();
+  }
+  if (getElementTypeOrSelf(epilogue.bias) != accType ||
+      getElementTypeOrSelf(op->getResult(0)) != accType) {
+    return failure();
+  }
+
+  // Walk the body backwards from the yielded value.
+  Block &body = op.getRegion().front();
+  Value value = body.getTerminator()->getOperand(0);
+  int numMatchedOps = 0;
+  auto matchConstant = [](Value v, float &result) {
+    FloatAttr floatAttr;
+    IntegerAttr intAttr;
+    if (matchPattern(v, m_Constant(&floatAttr))) {
+      result = floatAttr.getValueAsDouble();
+      return true;
+    }
+    if (matchPattern(v, m_Constant(&intAttr))) {
+      result = intAttr.getInt();
+      return true;
+    }
+    return false;
+  };
+  auto matchMax = [&](Value v, Value &input, float &bound) {
+    Operation *maxOp = v.getDefiningOp();
+    if (!isa_and_nonnull<arith::MaximumFOp, arith::MaxSIOp>(maxOp) ||
+        !matchConstant(maxOp->getOperand(1), bound)) {
+      return false;
+    }
+    input = maxOp->getOperand(0);
+    return true;
+  };
+  Operation *minOp = value.getDefiningOp();
+  Value clampInput;
+  float reluBound = 0.0f;
+  if (isa_and_nonnull<arith::MinimumFOp, arith::MinSIOp>(minOp) &&
+      matchConstant(minOp->getOperand(1), epilogue.clampMax) &&
+      matchMax(minOp->getOperand(0), clampInput, epilogue.clampMin)) {
+    epilogue.flags |= IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP;
+    value = clampInput;
+    numMatchedOps += 2;
+  } else if (matchMax(value, clampInput, reluBound) && reluBound == 0.0f) {
+    epilogue.flags |= IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU;
+    value = clampInput;
+    numMatchedOps += 1;
+  }
+  Operation *addOp = value.getDefiningOp();
+  if (!isa_and_nonnull<arith::AddFOp, arith::AddIOp>(addOp)) {
+    return failure();
+  }
+  Value accArg = body.getArgument(accIndex);
+  Value biasArg = body.getArgument(1 - accIndex);
+  if (!((addOp->getOperand(0) == accArg && addOp->getOperand(1) == biasArg) ||
+        (addOp->getOperand(0) == biasArg && addOp->getOperand(1) == accArg))) {
+    return failure();
+  }
+  epilogue.flags |= IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+  numMatchedOps += 1;
+  // Nothing else is allowed in the body, besides constants.
+  int numOps = llvm::count_if(body.without_terminator(), [](Operation &o) {
+    return !isa<arith::ConstantOp>(o);
+  });
+  if (numOps != numMatchedOps) {
+    return failure();
+  }
+  return epilogue;
+}
+
+/// Matches an (linalg.fill -> )? linalg.mmt4d operation sequence and converts
+/// it into a iree_codegen.ukernel.mmt4d operation, that is later lowered
+/// into a call to the microkernel.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
+                   bool skipIntermediateRoundings) {
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  uint32_t flags = getMmt4dTypeFlag(op);
+  if (!flags) {
     return rewriter.notifyMatchFailure(
         op, "unsupported combination of element types");
   }
 
+  // Leave this op to the linalg.generic pattern below if it can be lowered
+  // together with its consumer to the mmt4d_epilogue microkernel.
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  if (!isVMVXBackend(targetAttr) && isInitializedToZero(out)) {
+    for (Operation *user : op->getUsers()) {
+      auto genericOp = dyn_cast<linalg::GenericOp>(user);
+      if (genericOp && succeeded(matchMmt4dEpilogue(genericOp))) {
+        return rewriter.notifyMatchFailure(
+            op, "left to be lowered with its epilogue");
+      }
+    }
+  }
+
   // Check if the accumulator is zero-filled.
   if (isInitializedToZero(out)) {
     // Not setting flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE, so the mmt4d op won't
@@ -173,7 +314,6 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
   Value k0 = getDimAsI32(rewriter, loc, rhs, 3);
   Value flagsVal = rewriter.create<arith::ConstantOp>(
       loc, rewriter.getI32IntegerAttr(flags));
-  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
   auto fn = getFnNameAndDefAttrs("mmt4d", rewriter, targetAttr);
   auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
       loc, outType, fn.name, ValueRange{lhs, rhs}, out,
@@ -184,6 +324,125 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches an (linalg.fill -> )? linalg.batch_mmt4d operation sequence and
+/// converts it into a call to the batch_mmt4d microkernel, which loops over the
+/// batch dimension internally instead of needing one mmt4d call per batch.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::BatchMmt4DOp op,
+                   bool skipIntermediateRoundings) {
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  uint32_t flags = getMmt4dTypeFlag(op);
+  if (!flags) {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+
+  if (isInitializedToZero(out)) {
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  }
+
+  if (skipIntermediateRoundings) {
+    flags |= IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  }
+
+  Location loc = op.getLoc();
+  Value batch = rewriter.create<tensor::DimOp>(loc, lhs, 0);
+  Value m = rewriter.create<tensor::DimOp>(loc, lhs, 1);
+  Value n = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+  Value k = rewriter.create<tensor::DimOp>(loc, rhs, 2);
+  auto getDimAsI32 = [&](Value value, int dim) -> Value {
+    return rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getI32Type(),
+        rewriter.create<tensor::DimOp>(loc, value, dim));
+  };
+  Value m0 = getDimAsI32(lhs, 3);
+  Value n0 = getDimAsI32(rhs, 3);
+  Value k0 = getDimAsI32(rhs, 4);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("batch_mmt4d", rewriter, targetAttr);
+  // The batch and row strides of each operand are passed.
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, ValueRange{lhs, rhs}, out,
+      ValueRange{batch, m, n, k, m0, n0, k0, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(2));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches a (linalg.fill -> )? linalg.mmt4d -> linalg.generic operation
+/// sequence, where the linalg.generic is a bias-add and activation epilogue,
+/// and converts it into a call to the mmt4d_epilogue microkernel which applies
+/// the epilogue to each accumulator tile before writing it out.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op,
+                   bool skipIntermediateRoundings) {
+  FailureOr<Mmt4dEpilogue> epilogue = matchMmt4dEpilogue(op);
+  if (failed(epilogue)) {
+    return rewriter.notifyMatchFailure(op, "not a fusable mmt4d epilogue");
+  }
+  linalg::Mmt4DOp mmt4dOp = epilogue->mmt4dOp;
+  // The microkernel doesn't accumulate into an existing accumulator.
+  if (!isInitializedToZero(mmt4dOp.getDpsInitOperand(0)->get())) {
+    return rewriter.notifyMatchFailure(op, "mmt4d accumulator is not zero");
+  }
+  uint32_t flags = getMmt4dTypeFlag(mmt4dOp);
+  if (!flags) {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+  flags |= epilogue->flags;
+  if (skipIntermediateRoundings) {
+    flags |= IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  }
+
+  Value lhs = mmt4dOp.getDpsInputOperand(0)->get();
+  Value rhs = mmt4dOp.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  Location loc = op.getLoc();
+  Value m = rewriter.create<tensor::DimOp>(loc, lhs, 0);
+  Value n = rewriter.create<tensor::DimOp>(loc, rhs, 0);
+  Value k = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+  auto getDimAsI32 = [&](Value value, int dim) -> Value {
+    return rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getI32Type(),
+        rewriter.create<tensor::DimOp>(loc, value, dim));
+  };
+  Value m0 = getDimAsI32(lhs, 2);
+  Value n0 = getDimAsI32(rhs, 2);
+  Value k0 = getDimAsI32(rhs, 3);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  // Requantization is not matched yet, so scale and zero_point are unused.
+  Value scale = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getF32FloatAttr(1.0f));
+  Value zeroPoint =
+      rewriter.create<arith::ConstantOp>(loc, rewriter.getI32IntegerAttr(0));
+  Value clampMin = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getF32FloatAttr(epilogue->clampMin));
+  Value clampMax = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getF32FloatAttr(epilogue->clampMax));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("mmt4d_epilogue", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, out.getType(), fn.name, ValueRange{lhs, rhs, epilogue->bias}, out,
+      ValueRange{m, n, k, m0, n0, k0, flagsVal, scale, zeroPoint, clampMin,
+                 clampMax},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, tensor::PackOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -301,6 +560,92 @@ matchDAGForUKernel(RewriterBase &rewriter, tensor::PackOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Upper bound on the size in bytes of the packed LHS tile passed to each
+/// mmt4d microkernel call when the LHS is packed in the same dispatch. The
+/// packed tile lives in a stack allocation and this keeps it well within
+/// --iree-llvmcpu-stack-allocation-limit and the L1 cache.
+static constexpr int64_t kMaxFusedLhsPackTileBytes = 16 * 1024;
+
+/// Returns the K1 tile size bounding the packed LHS tile of |mmt4dOp| to
+/// kMaxFusedLhsPackTileBytes or 0 if the whole reduction dimension fits.
+static int64_t getFusedLhsPackK1TileSize(linalg::Mmt4DOp mmt4dOp) {
+  Value lhs = mmt4dOp.getDpsInputOperand(0)->get();
+  auto lhsType = llvm::cast<RankedTensorType>(lhs.getType());
+  // The LHS is M1xK1xM0xK0; size the tile from a single K1 slice.
+  int64_t sliceBytes = llvm::divideCeil(lhsType.getElementTypeBitWidth(), 8);
+  for (int64_t dim : {0, 2, 3}) {
+    int64_t size = lhsType.getDimSize(dim);
+    if (ShapedType::isDynamic(size)) {
+      FailureOr<int64_t> maybeSize =
+          ValueBoundsConstraintSet::computeConstantBound(
+              presburger::BoundType::UB, lhs, dim,
+              /*stopCondition=*/nullptr, /*closedUB=*/true);
+      if (failed(maybeSize))
+        return 0;
+      size = maybeSize.value();
+    }
+    sliceBytes *= size;
+  }
+  int64_t k1TileSize =
+      std::max<int64_t>(1, kMaxFusedLhsPackTileBytes / sliceBytes);
+  int64_t k1 = lhsType.getDimSize(1);
+  if (!ShapedType::isDynamic(k1) && k1 <= k1TileSize)
+    return 0;
+  return k1TileSize;
+}
+
+/// Lowers a tensor.pack producing the LHS of |mmt4dOp| in the same dispatch
+/// (see --iree-flow-enable-fuse-encoding-into-linalg-consumer-ops) to the pack
+/// microkernel. When needed the reduction dimension of the mmt4d is tiled
+/// first, fusing the pack and its elementwise producers into the loop, so that
+/// the LHS is packed tile by tile into a small thread-local buffer right
+/// before each mmt4d microkernel call instead of being written out by a
+/// separate dispatch and read back.
+static LogicalResult lowerFusedLhsPack(RewriterBase &rewriter,
+                                       linalg::Mmt4DOp mmt4dOp) {
+  if (!mmt4dOp.getDpsInputOperand(0)->get().getDefiningOp<tensor::PackOp>())
+    return success();
+
+  if (int64_t k1TileSize = getFusedLhsPackK1TileSize(mmt4dOp)) {
+    // Each iteration accumulates into the iter_arg so the mmt4d microkernels
+    // in the loop read the accumulator (and don't match the epilogue one).
+    SmallVector<OpFoldResult> tileSizes(mmt4dOp.getNumLoops(),
+                                        rewriter.getIndexAttr(0));
+    tileSizes[2] = rewriter.getIndexAttr(k1TileSize);
+    rewriter.setInsertionPoint(mmt4dOp);
+    FailureOr<scf::SCFTileAndFuseResult> tileAndFuseResult =
+        scf::tileConsumerAndFuseProducerGreedilyUsingSCFForOp(
+            rewriter, cast<TilingInterface>(mmt4dOp.getOperation()),
+            scf::SCFTileAndFuseOptions().setTilingOptions(
+                scf::SCFTilingOptions().setTileSizes(tileSizes)));
+    if (failed(tileAndFuseResult)) {
+      return mmt4dOp.emitOpError("failed to tile and fuse the LHS pack");
+    }
+    linalg::Mmt4DOp tiledMmt4dOp;
+    for (Operation *op : tileAndFuseResult->tiledAndFusedOps) {
+      if (auto tiledOp = dyn_cast<linalg::Mmt4DOp>(op))
+        tiledMmt4dOp = tiledOp;
+    }
+    rewriter.replaceOp(mmt4dOp, tileAndFuseResult->replacements.lookup(
+                                    mmt4dOp->getResult(0)));
+    if (!tiledMmt4dOp)
+      return success();
+    mmt4dOp = tiledMmt4dOp;
+  }
+
+  auto packOp =
+      mmt4dOp.getDpsInputOperand(0)->get().getDefiningOp<tensor::PackOp>();
+  if (!packOp || !packOp->hasOneUse())
+    return success();
+  rewriter.setInsertionPoint(packOp);
+  FailureOr<IREE::Codegen::UKernelOpInterface> ukernelOp =
+      matchDAGForUKernel(rewriter, packOp, /*skipIntermediateRoundings=*/false);
+  // Packs without a microkernel are left to codegen.
+  if (succeeded(ukernelOp))
+    rewriter.replaceOp(packOp, ukernelOp.value()->getResults());
+  return success();
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, tensor::UnPackOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -467,8 +812,86 @@ matchDAGForUKernel(RewriterBase &rewriter, IREE::Codegen::QueryTileSizesOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Returns true if `op` is a f32 softmax along the innermost dimension, i.e.
+/// the case implemented by the softmax microkernel.
+static bool isInnermostF32Softmax(linalg::SoftmaxOp op) {
+  int64_t rank = op.getInputOperandRank();
+  int64_t dim = op.getDimension();
+  return dim == rank - 1 &&
+         op.getInputOperandType().getElementType().isF32() &&
+         op.getOutputOperandType().getElementType().isF32();
+}
+
+/// Matches a 2-D linalg.softmax along the innermost dimension and converts it
+/// into a call to the softmax microkernel. Higher-rank softmax ops are first
+/// collapsed to 2-D by CollapseSoftmaxOuterUnitDimsPattern.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::SoftmaxOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  if (op.getInputOperandRank() != 2) {
+    return rewriter.notifyMatchFailure(op, "only the 2D case is implemented");
+  }
+  if (!isInnermostF32Softmax(op)) {
+    return rewriter.notifyMatchFailure(
+        op, "only f32 softmax along the innermost dimension is supported");
+  }
+  Value in = op.getInput();
+  Value out = op.getOutput();
+  Location loc = op.getLoc();
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("softmax", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, out.getType(), fn.name, ValueRange{in}, out,
+      ValueRange{size0, size1, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 namespace {
 
+/// Collapses the outer dimensions of a softmax along the innermost dimension
+/// into a single one when all but the last of them have static size 1, which
+/// is what distribution produces for softmax ops meant for the microkernel.
+struct CollapseSoftmaxOuterUnitDimsPattern
+    : OpRewritePattern<linalg::SoftmaxOp> {
+  using OpRewritePattern<linalg::SoftmaxOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::SoftmaxOp op,
+                                PatternRewriter &rewriter) const override {
+    int64_t rank = op.getInputOperandRank();
+    if (rank <= 2 || !isInnermostF32Softmax(op)) {
+      return failure();
+    }
+    ArrayRef<int64_t> shape = op.getInputOperandType().getShape();
+    if (llvm::any_of(shape.take_front(rank - 2),
+                     [](int64_t size) { return size != 1; })) {
+      return rewriter.notifyMatchFailure(op, "outer dims are not unit dims");
+    }
+    SmallVector<ReassociationIndices> reassociation(2);
+    for (int64_t i = 0; i < rank - 1; ++i) {
+      reassociation[0].push_back(i);
+    }
+    reassociation[1].push_back(rank - 1);
+    Location loc = op.getLoc();
+    Value in = rewriter.create<tensor::CollapseShapeOp>(loc, op.getInput(),
+                                                        reassociation);
+    Value out = rewriter.create<tensor::CollapseShapeOp>(loc, op.getOutput(),
+                                                         reassociation);
+    auto collapsedOp = rewriter.create<linalg::SoftmaxOp>(
+        loc, out.getType(), in, out, /*dimension=*/1);
+    rewriter.replaceOpWithNewOp<tensor::ExpandShapeOp>(
+        op, op.getOutputOperandType(), collapsedOp.getResult()[0],
+        reassociation);
+    return success();
+  }
+};
+
 using TargetPredicate = std::function<bool(IREE::HAL::ExecutableTargetAttr)>;
 
 template <typename OpType>
@@ -502,6 +925,24 @@ struct LowerToUKernelPattern : OpRewritePattern<OpType> {
 
 void LLVMCPULowerToUKernelsPass::runOnOperation() {
   MLIRContext *context = &getContext();
+
+  // Packs are otherwise left to codegen on LLVMCPU (see below) but those
+  // packing the LHS of an mmt4d in the same dispatch only feed the mmt4d
+  // microkernel and gain nothing from fusions at that point. VMVX lowers all
+  // packs to microkernels with the patterns below.
+  {
+    SmallVector<linalg::Mmt4DOp> mmt4dOps;
+    getOperation()->walk([&](linalg::Mmt4DOp op) {
+      if (!isVMVXBackend(IREE::HAL::ExecutableTargetAttr::lookup(op)))
+        mmt4dOps.push_back(op);
+    });
+    IRRewriter rewriter(context);
+    for (auto mmt4dOp : mmt4dOps) {
+      if (failed(lowerFusedLhsPack(rewriter, mmt4dOp)))
+        return signalPassFailure();
+    }
+  }
+
   RewritePatternSet patterns(context);
   // Enabling a lowering of an op to a microkernel is a trade-off between the
   // potential performance advantage of a microkernel over pure code generation
@@ -518,6 +959,15 @@ void LLVMCPULowerToUKernelsPass::runOnOperation() {
   auto allTargets = [](auto target) { return true; };
   patterns.insert<LowerToUKernelPattern<linalg::Mmt4DOp>>(
       context, allTargets, skipIntermediateRoundings);
+  // The batch_mmt4d, mmt4d_epilogue and softmax microkernels have no VMVX
+  // import. Softmax ops only reach here undecomposed when they are meant to be
+  // lowered to the microkernel, see the LLVMCPU pass pipeline.
+  auto nonVMVXTargets = [](auto target) { return !isVMVXBackend(target); };
+  patterns.insert<LowerToUKernelPattern<linalg::BatchMmt4DOp>,
+                  LowerToUKernelPattern<linalg::GenericOp>,
+                  LowerToUKernelPattern<linalg::SoftmaxOp>>(
+      context, nonVMVXTargets, skipIntermediateRoundings);
+  patterns.insert<CollapseSoftmaxOuterUnitDimsPattern>(context);
   // These patterns could in principle be used on LLVMCPU, not just VMVX, but
   // we choose not to, for two reasons:
   // 1. Codegen for these ops is thought to be good enough, that we do not
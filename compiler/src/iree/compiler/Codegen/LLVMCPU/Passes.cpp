@@ -70,6 +70,27 @@ static llvm::cl::opt<bool> clEnableReassociateFpReductions(
     llvm::cl::desc("Enables reassociation for FP reductions"),
     llvm::cl::init(true));
 
+static llvm::cl::opt<bool> clEnableWorkgroupRanges(
+    "iree-llvmcpu-enable-workgroup-ranges",
+    llvm::cl::desc("Builds entry points that execute a range of workgroups per "
+                   "call so the runtime can amortize the dispatch overhead"),
+    llvm::cl::init(true));
+
+static llvm::cl::opt<bool> clPreserveDenormals(
+    "iree-llvmcpu-preserve-denormals",
+    llvm::cl::desc("Requires IEEE denormal handling in dispatches that depend "
+                   "on the floating-point environment instead of flushing "
+                   "denormals to zero"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<unsigned> clWorkgroupSwizzleLogTile(
+    "iree-llvmcpu-workgroup-swizzle-log-tile",
+    llvm::cl::desc("Swizzles workgroups in groups of 2^N rows so that "
+                   "workgroups run concurrently by neighboring workers reuse "
+                   "the same input tiles from shared caches; 0 disables "
+                   "swizzling"),
+    llvm::cl::init(0));
+
 static llvm::cl::opt<bool> clSkipIntermediateRoundings(
     "iree-llvmcpu-skip-intermediate-roundings",
     llvm::cl::desc(
@@ -80,6 +101,12 @@ static llvm::cl::opt<bool> clSkipIntermediateRoundings(
         "is slow."),
     llvm::cl::init(true));
 
+static llvm::cl::opt<bool> clF16ReductionsAccumulateInF32(
+    "iree-llvmcpu-f16-reductions-accumulate-in-f32",
+    llvm::cl::desc("Accumulates reductions of f16 values in f32 and rounds "
+                   "the result to f16 once instead of at every step"),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clInstrumentMemoryAccesses{
     "iree-llvmcpu-instrument-memory-accesses",
     llvm::cl::desc("Instruments memory accesses in dispatches when dispatch "
@@ -131,6 +158,10 @@ static void addTileAndDistributePasses(OpPassManager &pm) {
       createFoldAffineMinInDistributedLoopsPass());
   nestedModulePM.addPass(createCanonicalizerPass());
   nestedModulePM.addPass(createCSEPass());
+  // Workers reserve workgroups in linear order so swizzling groups tiles
+  // sharing input slices together in time.
+  nestedModulePM.addNestedPass<func::FuncOp>(
+      createWorkGroupSwizzle(clWorkgroupSwizzleLogTile));
   nestedModulePM.addNestedPass<func::FuncOp>(
       createFuseTensorPadWithConsumerPass());
   nestedModulePM.addNestedPass<func::FuncOp>(
@@ -653,9 +684,18 @@ void addCPUDataTilingPipeline(OpPassManager &passManager,
   }
 }
 
-void addCPUDefaultPassPipeline(OpPassManager &passManager) {
+void addCPUDefaultPassPipeline(OpPassManager &passManager,
+                               bool enableMicrokernels) {
   addTileAndDistributePasses(passManager);
   OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
+  if (enableMicrokernels) {
+    nestedModulePM.addPass(
+        createLLVMCPULowerToUKernelsPass(clSkipIntermediateRoundings));
+    // Softmax ops that were kept intact for the microkernel but could not be
+    // lowered to it are decomposed here.
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        IREE::LinalgExt::createDecomposeSoftmaxPass());
+  }
   addBufferizePasses(nestedModulePM);
 }
 
@@ -739,7 +779,8 @@ static void addLowerToLLVMPasses(OpPassManager &passManager) {
     passManager.addNestedPass<func::FuncOp>(
         createInstrumentMemoryAccessesPass());
   }
-  passManager.addPass(createConvertToLLVMPass(clEnableReassociateFpReductions));
+  passManager.addPass(createConvertToLLVMPass(clEnableReassociateFpReductions,
+                                              clEnableWorkgroupRanges));
   passManager.addPass(createReconcileUnrealizedCastsPass());
 
   // We rely on MLIR symbol visibility being correct after this point and need
@@ -748,19 +789,53 @@ static void addLowerToLLVMPasses(OpPassManager &passManager) {
 
   passManager.addPass(createCanonicalizerPass());
   passManager.addPass(createCSEPass());
-  passManager.addNestedPass<LLVM::LLVMFuncOp>(createAddFastMathFlagsPass());
+  passManager.addNestedPass<LLVM::LLVMFuncOp>(
+      createAddFastMathFlagsPass(clPreserveDenormals));
+}
+
+/// Returns false for the linalg.softmax ops that should be kept intact so that
+/// they can be lowered to the softmax microkernel: f32 softmax along the
+/// innermost dimension, alone in its dispatch, on a target with microkernels.
+static bool shouldDecomposeSoftmax(Operation *op) {
+  auto softmaxOp = cast<linalg::SoftmaxOp>(op);
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  if (!targetAttr || isVMVXBackend(targetAttr) ||
+      !hasMicrokernels(targetAttr)) {
+    return true;
+  }
+  int64_t rank = softmaxOp.getInputOperandRank();
+  int64_t dim = softmaxOp.getDimension();
+  if (rank < 2 || dim != rank - 1 ||
+      !softmaxOp.getInputOperandType().getElementType().isF32() ||
+      !softmaxOp.getOutputOperandType().getElementType().isF32()) {
+    return true;
+  }
+  // The softmax op has to be the root of its dispatch for the CPUDefault
+  // pipeline to be selected and the microkernel to apply.
+  auto funcOp = op->getParentOfType<func::FuncOp>();
+  bool hasOtherComputeOps = false;
+  funcOp.walk([&](TilingInterface tilingOp) {
+    if (tilingOp.getOperation() != op) {
+      hasOtherComputeOps = true;
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  return hasOtherComputeOps;
 }
 
 void buildLLVMCPUCodegenStrategyInitializationPassPipeline(
     OpPassManager &passManager) {
   {
-    addCommonTargetExecutablePreprocessingPasses(passManager);
+    addCommonTargetExecutablePreprocessingPasses(passManager,
+                                                 shouldDecomposeSoftmax);
     OpPassManager &modulePassManager = passManager.nest<ModuleOp>();
     modulePassManager.addNestedPass<func::FuncOp>(
         createRematerializeParallelOpsPass());
     // TODO(#13888): This(createExpandF16OpToF32Pass()) pass is being added way
     // to late and should insted be be done during lowering to LLVM.
-    modulePassManager.addPass(createExpandF16OpToF32Pass());
+    modulePassManager.addPass(
+        createExpandF16OpToF32Pass(clF16ReductionsAccumulateInF32));
 
     modulePassManager.addNestedPass<func::FuncOp>(
         createCPUMaterializeEncodingPass());
@@ -20,9 +20,11 @@ namespace iree_compiler {
 
 class TilingConfig;
 
-/// Performs the final conversion to LLVM dialect.
+/// Performs the final conversion to LLVM dialect. When |workgroupRanges| is set
+/// entry points are built to execute a range of workgroups per call.
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertToLLVMPass(bool reassociateFpReordering = false);
+createConvertToLLVMPass(bool reassociateFpReordering = false,
+                        bool workgroupRanges = false);
 
 /// Checks CPU backend specific IR constraints (like no stack allocations)
 std::unique_ptr<OperationPass<ModuleOp>>
@@ -46,8 +48,11 @@ createLLVMCPULowerExecutableTargetPass();
 /// Pass to handel F16 bit operations, but converting f16 operands to F32.
 /// Currently this pass is handeling fmaxf conversion from f16 to f32,
 /// and then returing a f16 output back after preforming the operation.
-/// Can handel more operations if required in future.
-std::unique_ptr<Pass> createExpandF16OpToF32Pass();
+/// Can handel more operations if required in future. Targets with native f16
+/// arithmetic keep the operations in f16. With |accumulateReductionsInF32|
+/// reductions with f16 accumulators are widened to accumulate in f32.
+std::unique_ptr<Pass>
+createExpandF16OpToF32Pass(bool accumulateReductionsInF32 = false);
 
 /// Pass to lower a sequence of operations to a iree_codegen.ukernel.*
 /// operation.
@@ -133,8 +138,10 @@ void addCPUDataTilingPipeline(OpPassManager &passManager,
 
 /// Populates the passes to lower to scalars operations for linalg based
 /// code-generation. This pipeline does not vectorize, but instead just
-/// converts to memrefs
-void addCPUDefaultPassPipeline(OpPassManager &passManager);
+/// converts to memrefs. If `enableMicrokernels` is set, the ops that have a
+/// microkernel (e.g. linalg.softmax) are lowered to it after distribution.
+void addCPUDefaultPassPipeline(OpPassManager &passManager,
+                               bool enableMicrokernels = false);
 
 void addConvTileAndDecomposeExpertPassPipeline(OpPassManager &passManager,
                                                TilingConfig &tilingConfig,
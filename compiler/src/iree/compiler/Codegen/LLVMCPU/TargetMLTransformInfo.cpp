@@ -20,6 +20,18 @@ struct RISCVTargetMLTransformInfo : TargetMLTransformInfo {
   }
 };
 
+struct X86TargetMLTransformInfo : TargetMLTransformInfo {
+  X86TargetMLTransformInfo(IREE::HAL::ExecutableTargetAttr targetAttr) {
+    // AVX-512 doubles the register file to 32 zmm registers; AVX/AVX2 only
+    // have 16 ymm registers.
+    if (hasAVX512fFeature(targetAttr)) {
+      numVectorRegisters = 32;
+    } else if (hasAVX2Feature(targetAttr)) {
+      numVectorRegisters = 16;
+    }
+  }
+};
+
 } // namespace
 
 namespace mlir {
@@ -30,6 +42,9 @@ const TargetMLTransformInfo TargetMLTransformInfo::getTargetMLTransformInfo(
   if (isRISCV(targetAttr)) {
     return RISCVTargetMLTransformInfo();
   }
+  if (isX86(targetAttr)) {
+    return X86TargetMLTransformInfo(targetAttr);
+  }
 
   return TargetMLTransformInfo();
 };
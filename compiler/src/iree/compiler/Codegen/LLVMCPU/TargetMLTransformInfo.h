@@ -20,6 +20,9 @@ struct TargetMLTransformInfo {
   unsigned defaultMaxUnrollFactor = 8;
   unsigned defaultMaxTransposeUnrollFactor =
       std::numeric_limits<unsigned>::max();
+  // Number of architectural vector registers available to hold the
+  // accumulators and operands of vectorized kernels. Zero if unknown.
+  unsigned numVectorRegisters = 0;
 
   static const TargetMLTransformInfo
   getTargetMLTransformInfo(IREE::HAL::ExecutableTargetAttr targetAttr);
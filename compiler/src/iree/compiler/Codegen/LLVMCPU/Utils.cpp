@@ -55,6 +55,11 @@ bool hasSMEFeature(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return hasFeature(targetAttr, "+sme");
 }
 
+bool hasFullFp16Feature(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  return isAArch64(targetAttr) && (hasFeature(targetAttr, "+fullfp16") ||
+                                   hasFeature(targetAttr, "+fp16fml"));
+}
+
 FailureOr<Operation *> getRootOperation(ArrayRef<Operation *> computeOps) {
   Operation *rootOperation = nullptr;
   for (auto op : llvm::reverse(computeOps)) {
@@ -45,6 +45,10 @@ bool hasAnySVEFeature(IREE::HAL::ExecutableTargetAttr targetAttr);
 /// Returns true if the 'targetAttr' contains '+sme' in its cpu features.
 bool hasSMEFeature(IREE::HAL::ExecutableTargetAttr targetAttr);
 
+/// Returns true if the 'targetAttr' describes an AArch64 CPU with native FP16
+/// arithmetic ('+fullfp16', also implied by '+fp16fml').
+bool hasFullFp16Feature(IREE::HAL::ExecutableTargetAttr targetAttr);
+
 /// Find the root operation for the dispatch region. The priority is:
 ///   1. A Linalg operation that has reduction loops.
 ///   2. Any other Linalg op or LinalgExt op.
@@ -1,4 +1,5 @@
-// RUN: iree-opt --iree-llvmcpu-expand-f16-op-to-f32 %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-llvmcpu-expand-f16-op-to-f32 %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-llvmcpu-expand-f16-op-to-f32=accumulate-reductions-in-f32 %s | FileCheck %s --check-prefix=ACC
 
 func.func @test_expand_f16_maxf(%arg0: tensor<4xf16>, %arg1: tensor<4xf16>) -> tensor<4xf16>{
     %1 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], 
@@ -20,4 +21,54 @@ func.func @test_expand_f16_maxf(%arg0: tensor<4xf16>, %arg1: tensor<4xf16>) -> t
 // CHECK: linalg.yield %[[TRUNC:.*]] : f16
 // CHECK: return %[[GEN:.*]] : tensor<4xf16>
 
+// -----
 
+func.func @test_native_f16_maxf(%arg0: tensor<4xf16>, %arg1: tensor<4xf16>) -> tensor<4xf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "embedded-elf-arm_64", {cpu_features = "+fullfp16", target_triple = "aarch64-none-elf"}>
+} {
+    %1 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+                        iterator_types = ["parallel"]} ins(%arg0: tensor<4xf16>) outs(%arg1: tensor<4xf16>) {
+        ^bb0(%in: f16, %out: f16):
+        %2 = arith.maximumf %in, %out : f16
+        linalg.yield %2: f16
+    } -> tensor<4xf16>
+    return %1 : tensor<4xf16>
+}
+
+// CHECK-LABEL: func.func @test_native_f16_maxf
+// CHECK-NOT: arith.extf
+// CHECK: arith.maximumf %in, %out : f16
+
+// -----
+
+func.func @test_f16_sum(%arg0: tensor<4x256xf16>, %arg1: tensor<4xf16>) -> tensor<4xf16> {
+    %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+                        iterator_types = ["parallel", "reduction"]} ins(%arg0: tensor<4x256xf16>) outs(%arg1: tensor<4xf16>) {
+        ^bb0(%in: f16, %out: f16):
+        %2 = arith.mulf %in, %in : f16
+        %3 = arith.addf %2, %out : f16
+        linalg.yield %3: f16
+    } -> tensor<4xf16>
+    return %1 : tensor<4xf16>
+}
+
+// CHECK-LABEL: func.func @test_f16_sum
+// CHECK-NOT: f32
+
+// ACC-LABEL: func.func @test_f16_sum
+//  ACC-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<4x256xf16>
+//  ACC-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<4xf16>
+//       ACC:   %[[INIT:.+]] = linalg.generic
+//  ACC-SAME:       ins(%[[ARG1]] : tensor<4xf16>)
+//       ACC:     arith.extf %{{.+}} : f16 to f32
+//       ACC:   %[[SUM:.+]] = linalg.generic
+//  ACC-SAME:       ins(%[[ARG0]] : tensor<4x256xf16>) outs(%[[INIT]] : tensor<4xf32>)
+//       ACC:   ^bb0(%[[IN:.+]]: f16, %[[OUT:.+]]: f32):
+//       ACC:     %[[MUL:.+]] = arith.mulf %[[IN]], %[[IN]] : f16
+//       ACC:     %[[MULEXT:.+]] = arith.extf %[[MUL]] : f16 to f32
+//       ACC:     %[[ADD:.+]] = arith.addf %[[MULEXT]], %[[OUT]] : f32
+//       ACC:     linalg.yield %[[ADD]] : f32
+//       ACC:   %[[RESULT:.+]] = linalg.generic
+//  ACC-SAME:       ins(%[[SUM]] : tensor<4xf32>)
+//       ACC:     arith.truncf %{{.+}} : f32 to f16
+//       ACC:   return %[[RESULT]]
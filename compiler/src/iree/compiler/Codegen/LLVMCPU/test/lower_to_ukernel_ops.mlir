@@ -246,6 +246,218 @@ func.func @mmt4d_bf16bf16bf16(%arg0 : tensor<?x?x?x?xbf16>, %arg1 : tensor<?x?x?
 
 // -----
 
+func.func @mmt4d_f32i8f32(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xi8>,
+    %arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf32>, tensor<?x?x?x?xi8>)
+      outs(%arg2 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?xf32>
+}
+//      CHECK: func @mmt4d_f32i8f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi8>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1287 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @mmt4d_epilogue_f32_bias_relu(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xf32>,
+    %arg2 : tensor<?x?xf32>, %arg3 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
+  %cst = arith.constant 0.0 : f32
+  %fill = linalg.fill ins(%cst : f32) outs(%arg3 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf32>, tensor<?x?x?x?xf32>)
+      outs(%fill : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d1, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%0, %arg2 : tensor<?x?x?x?xf32>, tensor<?x?xf32>)
+      outs(%arg3 : tensor<?x?x?x?xf32>) {
+  ^bb0(%in: f32, %bias: f32, %out: f32):
+    %2 = arith.addf %in, %bias : f32
+    %3 = arith.maximumf %2, %cst : f32
+    linalg.yield %3 : f32
+  } -> tensor<?x?x?x?xf32>
+  return %1 : tensor<?x?x?x?xf32>
+}
+//      CHECK: func @mmt4d_epilogue_f32_bias_relu(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x?x?xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 70657 : i32
+//  CHECK-DAG:   %[[SCALE:.+]] = arith.constant 1.000000e+00 : f32
+//  CHECK-DAG:   %[[ZERO_POINT:.+]] = arith.constant 0 : i32
+//  CHECK-DAG:   %[[CLAMP:.+]] = arith.constant 0.000000e+00 : f32
+//  CHECK-NOT:   linalg.mmt4d
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d_epilogue"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[ARG3]] :
+// CHECK-SAME:       %[[FLAGS]], %[[SCALE]], %[[ZERO_POINT]], %[[CLAMP]], %[[CLAMP]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+//      NOSKIPROUND: func @mmt4d_epilogue_f32_bias_relu(
+//  NOSKIPROUND-DAG:   %[[FLAGS:.+]] = arith.constant 69633 : i32
+//      NOSKIPROUND:   iree_codegen.ukernel.generic "iree_uk_mmt4d_epilogue"
+// NOSKIPROUND-SAME:       %[[FLAGS]],
+
+// -----
+
+func.func @mmt4d_epilogue_i32_bias_clamp(%arg0 : tensor<?x?x?x?xi8>, %arg1 : tensor<?x?x?x?xi8>,
+    %arg2 : tensor<?x?xi32>, %arg3 : tensor<?x?x?x?xi32>) -> tensor<?x?x?x?xi32> {
+  %c0 = arith.constant 0 : i32
+  %cmin = arith.constant -128 : i32
+  %cmax = arith.constant 127 : i32
+  %fill = linalg.fill ins(%c0 : i32) outs(%arg3 : tensor<?x?x?x?xi32>) -> tensor<?x?x?x?xi32>
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xi8>, tensor<?x?x?x?xi8>)
+      outs(%fill : tensor<?x?x?x?xi32>) -> tensor<?x?x?x?xi32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d1, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%arg2, %0 : tensor<?x?xi32>, tensor<?x?x?x?xi32>)
+      outs(%arg3 : tensor<?x?x?x?xi32>) {
+  ^bb0(%bias: i32, %in: i32, %out: i32):
+    %2 = arith.addi %bias, %in : i32
+    %3 = arith.maxsi %2, %cmin : i32
+    %4 = arith.minsi %3, %cmax : i32
+    linalg.yield %4 : i32
+  } -> tensor<?x?x?x?xi32>
+  return %1 : tensor<?x?x?x?xi32>
+}
+//      CHECK: func @mmt4d_epilogue_i32_bias_clamp(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi8>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi8>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?xi32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x?x?xi32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 136194 : i32
+//  CHECK-DAG:   %[[CLAMP_MIN:.+]] = arith.constant -1.280000e+02 : f32
+//  CHECK-DAG:   %[[CLAMP_MAX:.+]] = arith.constant 1.270000e+02 : f32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d_epilogue"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[ARG3]] :
+// CHECK-SAME:       %[[FLAGS]], %{{.+}}, %{{.+}}, %[[CLAMP_MIN]], %[[CLAMP_MAX]] :
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+// Check that the epilogue is not fused when the mmt4d accumulates into a
+// non-zero accumulator.
+func.func @mmt4d_epilogue_accumulate(%arg0 : tensor<?x?x?x?xf32>, %arg1 : tensor<?x?x?x?xf32>,
+    %arg2 : tensor<?x?xf32>, %arg3 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32> {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?xf32>, tensor<?x?x?x?xf32>)
+      outs(%arg3 : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d1, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      ins(%0, %arg2 : tensor<?x?x?x?xf32>, tensor<?x?xf32>)
+      outs(%arg3 : tensor<?x?x?x?xf32>) {
+  ^bb0(%in: f32, %bias: f32, %out: f32):
+    %2 = arith.addf %in, %bias : f32
+    linalg.yield %2 : f32
+  } -> tensor<?x?x?x?xf32>
+  return %1 : tensor<?x?x?x?xf32>
+}
+//      CHECK: func @mmt4d_epilogue_accumulate(
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+//      CHECK:   linalg.generic
+// CHECK-SAME:       ins(%[[MICRO_KERNEL]],
+
+// -----
+
+func.func @batch_mmt4d_f32f32f32(%arg0 : tensor<?x?x?x?x?xf32>, %arg1 : tensor<?x?x?x?x?xf32>,
+    %arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32> {
+  %0 = linalg.batch_mmt4d ins(%arg0, %arg1 : tensor<?x?x?x?x?xf32>, tensor<?x?x?x?x?xf32>)
+      outs(%arg2 : tensor<?x?x?x?x?xf32>) -> tensor<?x?x?x?x?xf32>
+  return %0 : tensor<?x?x?x?x?xf32>
+}
+//      CHECK: func @batch_mmt4d_f32f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x?x?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1
+//  CHECK-DAG:   %[[C2:.+]] = arith.constant 2
+//  CHECK-DAG:   %[[C3:.+]] = arith.constant 3
+//  CHECK-DAG:   %[[C4:.+]] = arith.constant 4
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1281 : i32
+//  CHECK-DAG:   %[[BATCH:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[M:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-DAG:   %[[N:.+]] = tensor.dim %[[ARG1]], %[[C1]]
+//  CHECK-DAG:   %[[K:.+]] = tensor.dim %[[ARG1]], %[[C2]]
+//  CHECK-DAG:   %[[M0_index:.+]] = tensor.dim %[[ARG0]], %[[C3]]
+//  CHECK-DAG:   %[[M0:.+]] = arith.index_cast %[[M0_index]] : index to i32
+//  CHECK-DAG:   %[[N0_index:.+]] = tensor.dim %[[ARG1]], %[[C3]]
+//  CHECK-DAG:   %[[N0:.+]] = arith.index_cast %[[N0_index]] : index to i32
+//  CHECK-DAG:   %[[K0_index:.+]] = tensor.dim %[[ARG1]], %[[C4]]
+//  CHECK-DAG:   %[[K0:.+]] = arith.index_cast %[[K0_index]] : index to i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_batch_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       (%[[BATCH]], %[[M]], %[[N]], %[[K]], %[[M0]], %[[N0]], %[[K0]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(2)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @softmax_f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg.softmax dimension(1) ins(%arg0 : tensor<?x?xf32>)
+      outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+//      CHECK: func @softmax_f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       (%[[SIZE0]], %[[SIZE1]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @softmax_f32_outer_unit_dims(%arg0 : tensor<1x?x?xf32>, %arg1 : tensor<1x?x?xf32>) -> tensor<1x?x?xf32> {
+  %0 = linalg.softmax dimension(2) ins(%arg0 : tensor<1x?x?xf32>)
+      outs(%arg1 : tensor<1x?x?xf32>) -> tensor<1x?x?xf32>
+  return %0 : tensor<1x?x?xf32>
+}
+//      CHECK: func @softmax_f32_outer_unit_dims(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<1x?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<1x?x?xf32>
+//  CHECK-DAG:   %[[IN:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1], [2]]
+//  CHECK-DAG:   %[[OUT:.+]] = tensor.collapse_shape %[[ARG1]] {{\[}}[0, 1], [2]]
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[IN]] :
+// CHECK-SAME:       outs(%[[OUT]] :
+//      CHECK:   %[[RESULT:.+]] = tensor.expand_shape %[[MICRO_KERNEL]] {{\[}}[0, 1], [2]]
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+// Only the innermost dimension is supported.
+//      CHECK: func @softmax_f32_outer_dim(
+//      CHECK:   linalg.softmax
+func.func @softmax_f32_outer_dim(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg.softmax dimension(0) ins(%arg0 : tensor<?x?xf32>)
+      outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+
+// -----
+
 // Check that tensor.pack is not lowered to a microkernel by default - it should
 // only be on VMVX.
 //      CHECK: func @pack_i8i8_default(
@@ -503,3 +715,31 @@ func.func @query_tile_sizes_2d() -> (index, index)  attributes {
   %result:2 = iree_codegen.query_tile_sizes tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>> -> index, index
   return %result#0, %result#1 : index, index
 }
+
+// -----
+
+func.func @mmt4d_fused_lhs_pack(%arg0 : tensor<64x512xf32>,
+    %arg1 : tensor<8x512x8x1xf32>, %arg2 : tensor<8x8x8x8xf32>)
+    -> tensor<8x8x8x8xf32> {
+  %empty = tensor.empty() : tensor<8x512x8x1xf32>
+  %pack = tensor.pack %arg0 inner_dims_pos = [0, 1] inner_tiles = [8, 1]
+      into %empty : tensor<64x512xf32> -> tensor<8x512x8x1xf32>
+  %0 = linalg.mmt4d ins(%pack, %arg1 : tensor<8x512x8x1xf32>, tensor<8x512x8x1xf32>)
+      outs(%arg2 : tensor<8x8x8x8xf32>) -> tensor<8x8x8x8xf32>
+  return %0 : tensor<8x8x8x8xf32>
+}
+// The packed LHS would be 128KB so the pack is fused into a loop over K1
+// producing 8x64x8x1xf32 (16KB) tiles.
+//      CHECK: func @mmt4d_fused_lhs_pack(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<64x512xf32>
+//  CHECK-DAG:   %[[C64:.+]] = arith.constant 64 : index
+//  CHECK-DAG:   %[[C512:.+]] = arith.constant 512 : index
+//      CHECK:   scf.for %{{.+}} = %{{.+}} to %[[C512]] step %[[C64]]
+//      CHECK:     %[[SRC:.+]] = tensor.extract_slice %[[ARG0]]
+// CHECK-SAME:         [64, 64] [1, 1]
+//      CHECK:     %[[PACK:.+]] = iree_codegen.ukernel.generic "iree_uk_pack"
+// CHECK-SAME:         ins(%[[SRC]] :
+// CHECK-SAME:         outs(%{{.+}} : tensor<8x64x8x1xf32>)
+//      CHECK:     iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:         ins(%[[PACK]], %{{.+}} :
+//      CHECK:     scf.yield
@@ -0,0 +1,53 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-cpu-split-mmt4d-reduction))" --split-input-file %s | FileCheck %s
+
+func.func @mmt4d_gemv_f32(%lhs: tensor<1x4096x1x1xf32>, %rhs: tensor<4x4096x16x1xf32>, %acc: tensor<1x4x1x16xf32>) -> tensor<1x4x1x16xf32> {
+  %0 = linalg.mmt4d ins(%lhs, %rhs : tensor<1x4096x1x1xf32>, tensor<4x4096x16x1xf32>) outs(%acc : tensor<1x4x1x16xf32>) -> tensor<1x4x1x16xf32>
+  return %0 : tensor<1x4x1x16xf32>
+}
+// CHECK-LABEL: func @mmt4d_gemv_f32(
+// CHECK-SAME:    %[[LHS:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[RHS:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[ACC:[a-zA-Z0-9]+]]
+//  CHECK-DAG:    %[[ZERO:.+]] = arith.constant 0.000000e+00 : f32
+//      CHECK:    %[[LHS_EXPAND:.+]] = tensor.expand_shape %[[LHS]] {{\[}}[0], [1, 2], [3], [4]] : tensor<1x4096x1x1xf32> into tensor<1x8x512x1x1xf32>
+//      CHECK:    %[[LHS_SPLIT:.+]] = linalg.transpose ins(%[[LHS_EXPAND]] : tensor<1x8x512x1x1xf32>) outs(%{{.+}} : tensor<8x1x512x1x1xf32>) permutation = [1, 0, 2, 3, 4]
+//      CHECK:    %[[RHS_EXPAND:.+]] = tensor.expand_shape %[[RHS]] {{\[}}[0], [1, 2], [3], [4]] : tensor<4x4096x16x1xf32> into tensor<4x8x512x16x1xf32>
+//      CHECK:    %[[RHS_SPLIT:.+]] = linalg.transpose ins(%[[RHS_EXPAND]] : tensor<4x8x512x16x1xf32>) outs(%{{.+}} : tensor<8x4x512x16x1xf32>) permutation = [1, 0, 2, 3, 4]
+//      CHECK:    %[[FILL:.+]] = linalg.fill ins(%[[ZERO]] : f32) outs(%{{.+}} : tensor<8x1x4x1x16xf32>)
+//      CHECK:    %[[PARTIAL:.+]] = linalg.batch_mmt4d ins(%[[LHS_SPLIT]], %[[RHS_SPLIT]] : tensor<8x1x512x1x1xf32>, tensor<8x4x512x16x1xf32>) outs(%[[FILL]] : tensor<8x1x4x1x16xf32>)
+//      CHECK:    %[[RESULT:.+]] = linalg.reduce ins(%[[PARTIAL]] : tensor<8x1x4x1x16xf32>) outs(%[[ACC]] : tensor<1x4x1x16xf32>) dimensions = [0]
+//      CHECK:      arith.addf
+//      CHECK:    return %[[RESULT]]
+
+// -----
+
+func.func @mmt4d_gemv_i8i8i32(%lhs: tensor<1x512x1x2xi8>, %rhs: tensor<16x512x16x2xi8>, %acc: tensor<1x16x1x16xi32>) -> tensor<1x16x1x16xi32> {
+  %0 = linalg.mmt4d ins(%lhs, %rhs : tensor<1x512x1x2xi8>, tensor<16x512x16x2xi8>) outs(%acc : tensor<1x16x1x16xi32>) -> tensor<1x16x1x16xi32>
+  return %0 : tensor<1x16x1x16xi32>
+}
+// CHECK-LABEL: func @mmt4d_gemv_i8i8i32(
+//      CHECK:    linalg.batch_mmt4d
+// CHECK-SAME:      ins(%{{.+}}, %{{.+}} : tensor<2x1x256x1x2xi8>, tensor<2x16x256x16x2xi8>)
+// CHECK-SAME:      outs(%{{.+}} : tensor<2x1x16x1x16xi32>)
+//      CHECK:    linalg.reduce
+//      CHECK:      arith.addi
+
+// -----
+
+func.func @mmt4d_large_parallel_dims(%lhs: tensor<16x4096x8x1xf32>, %rhs: tensor<16x4096x16x1xf32>, %acc: tensor<16x16x8x16xf32>) -> tensor<16x16x8x16xf32> {
+  %0 = linalg.mmt4d ins(%lhs, %rhs : tensor<16x4096x8x1xf32>, tensor<16x4096x16x1xf32>) outs(%acc : tensor<16x16x8x16xf32>) -> tensor<16x16x8x16xf32>
+  return %0 : tensor<16x16x8x16xf32>
+}
+// CHECK-LABEL: func @mmt4d_large_parallel_dims(
+//  CHECK-NOT:    linalg.batch_mmt4d
+//      CHECK:    linalg.mmt4d
+
+// -----
+
+func.func @mmt4d_small_reduction(%lhs: tensor<1x64x1x1xf32>, %rhs: tensor<4x64x16x1xf32>, %acc: tensor<1x4x1x16xf32>) -> tensor<1x4x1x16xf32> {
+  %0 = linalg.mmt4d ins(%lhs, %rhs : tensor<1x64x1x1xf32>, tensor<4x64x16x1xf32>) outs(%acc : tensor<1x4x1x16xf32>) -> tensor<1x4x1x16xf32>
+  return %0 : tensor<1x4x1x16xf32>
+}
+// CHECK-LABEL: func @mmt4d_small_reduction(
+//  CHECK-NOT:    linalg.batch_mmt4d
+//      CHECK:    linalg.mmt4d
@@ -90,7 +90,44 @@ hal.executable private @batch_mmt4d {
   }
 }
 
-//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 10, 20, 0, 0, 0, 0], [1, 1, 1, 0, 8, 4, 0], [0, 0, 0, 1, 0, 0, 1]{{\]}}>
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[32, 10, 20, 0, 0, 0, 0], [1, 1, 1, 0, 8, 4, 0], [0, 0, 0, 1, 0, 0, 1]{{\]}}>
 //      CHECK: func.func @batch_mmt4d()
 //      CHECK:   linalg.batch_mmt4d
 // CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu = "cascadelake", cpu_features = "", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 32 : index, target_triple = "x86_64-unknown-unknown-eabi-elf", ukernels = true}>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer, ReadOnly>,
+    #hal.descriptor_set.binding<1, storage_buffer, ReadOnly>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable private @batch_mmt4d_split_reduction {
+  hal.executable.variant public @embedded_elf_x86_64 target(#executable_target_embedded_elf_x86_64_) {
+    hal.executable.export public @batch_mmt4d_split_reduction ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      func.func @batch_mmt4d_split_reduction() {
+        %cst = arith.constant 0.000000e+00 : f32
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<8x1x512x1x1xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<8x4x512x16x1xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<8x1x4x1x16xf32>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0, 0, 0], sizes = [8, 1, 512, 1, 1], strides = [1, 1, 1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<8x1x512x1x1xf32>> -> tensor<8x1x512x1x1xf32>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0, 0, 0], sizes = [8, 4, 512, 16, 1], strides = [1, 1, 1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<8x4x512x16x1xf32>> -> tensor<8x4x512x16x1xf32>
+        %5 = tensor.empty() : tensor<8x1x4x1x16xf32>
+        %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<8x1x4x1x16xf32>) -> tensor<8x1x4x1x16xf32>
+        %7 = linalg.batch_mmt4d ins(%3, %4 : tensor<8x1x512x1x1xf32>, tensor<8x4x512x16x1xf32>) outs(%6 : tensor<8x1x4x1x16xf32>) -> tensor<8x1x4x1x16xf32>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0, 0, 0, 0], sizes = [8, 1, 4, 1, 16], strides = [1, 1, 1, 1, 1] : tensor<8x1x4x1x16xf32> -> !flow.dispatch.tensor<writeonly:tensor<8x1x4x1x16xf32>>
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 1, 4, 0, 0, 0, 0], [1, 1, 1, 0, 1, 16, 0], [0, 0, 0, 1, 0, 0, 1]{{\]}}>
+//      CHECK: func.func @batch_mmt4d_split_reduction()
+//      CHECK:   linalg.batch_mmt4d
+// CHECK-SAME:     lowering_config = #[[CONFIG]]
@@ -0,0 +1,37 @@
+// RUN: iree-opt --iree-convert-to-llvm="target-workgroup-ranges=true" --split-input-file %s | FileCheck %s
+
+// CHECK-LABEL: llvm.func internal @entry_workgroup
+// CHECK-SAME: passthrough = ["alwaysinline"]
+//      CHECK:   llvm.load %arg2 : !llvm.ptr -> !llvm.struct<"iree_hal_executable_workgroup_state_v0_t"
+
+//      CHECK: llvm.func @entry(%[[ENV:[a-z0-9]+]]: !llvm.ptr {{.+}}, %[[DISPATCH:[a-z0-9]+]]: !llvm.ptr {{.+}}, %[[WORKGROUP:[a-z0-9]+]]: !llvm.ptr {{.+}}) -> i32
+// CHECK-SAME: passthrough = ["iree-hal-workgroup-range"]
+//      CHECK:   %[[DISPATCH_STATE:.+]] = llvm.load %[[DISPATCH]] : !llvm.ptr -> !llvm.struct<"iree_hal_executable_dispatch_state_v0_t"
+//  CHECK-DAG:   %[[COUNT_X:.+]] = llvm.extractvalue %[[DISPATCH_STATE]][4]
+//  CHECK-DAG:   %[[COUNT_Y:.+]] = llvm.extractvalue %[[DISPATCH_STATE]][5]
+//      CHECK:   %[[WORKGROUP_STATE:.+]] = llvm.load %[[WORKGROUP]] : !llvm.ptr -> !llvm.struct<"iree_hal_executable_workgroup_state_v0_t"
+//  CHECK-DAG:   %[[BASE_X:.+]] = llvm.extractvalue %[[WORKGROUP_STATE]][0]
+//  CHECK-DAG:   %[[BASE_Y:.+]] = llvm.extractvalue %[[WORKGROUP_STATE]][1]
+//  CHECK-DAG:   %[[BASE_Z:.+]] = llvm.extractvalue %[[WORKGROUP_STATE]][2]
+//  CHECK-DAG:   %[[RANGE16:.+]] = llvm.extractvalue %[[WORKGROUP_STATE]][3]
+//      CHECK:   %[[STATE_PTR:.+]] = llvm.alloca
+//      CHECK:   llvm.br ^bb1(%{{.+}}, %[[BASE_X]], %[[BASE_Y]], %[[BASE_Z]] : i32, i32, i32, i16)
+//      CHECK: ^bb1(%[[INDEX:.+]]: i32, %[[X:.+]]: i32, %[[Y:.+]]: i32, %[[Z:.+]]: i16):
+//      CHECK:   llvm.store %{{.+}}, %[[STATE_PTR]]
+//      CHECK:   %[[RESULT:.+]] = llvm.call @entry_workgroup(%[[ENV]], %[[DISPATCH]], %[[STATE_PTR]])
+//      CHECK:   llvm.cond_br %{{.+}}, ^bb3(%[[RESULT]] : i32), ^bb2
+//      CHECK: ^bb2:
+//      CHECK:   llvm.icmp "eq" %{{.+}}, %[[COUNT_X]]
+//      CHECK:   llvm.icmp "eq" %{{.+}}, %[[COUNT_Y]]
+//      CHECK:   llvm.cond_br %{{.+}}, ^bb1({{.+}}), ^bb3({{.+}} : i32)
+//      CHECK: ^bb3(%[[RETURN:.+]]: i32):
+//      CHECK:   llvm.return %[[RETURN]] : i32
+func.func @entry() {
+  %workgroup_id_x = hal.interface.workgroup.id[0] : index
+  %val = arith.index_cast %workgroup_id_x : index to i64
+  llvm.call @sink(%val) : (i64) -> ()
+  return
+}
+llvm.func @sink(%arg0: i64) {
+  llvm.return
+}
@@ -0,0 +1,287 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- ConvertGPUMMAToMFMA.cpp - Subgroup MMA ops to AMD matrix cores -----===//
+//
+// Lowers the `gpu.subgroup_mma_*` ops produced by the tensor core pipeline to
+// `amdgpu.mfma`. Unlike the NVVM WMMA intrinsics, MFMA instructions don't come
+// with fragment load/store intrinsics so each lane loads and stores its part
+// of the fragments following the register layout of
+// `v_mfma_f32_16x16x16f16` on a wave of 64 lanes:
+//   A (16x16, MxK): lane l holds A[l % 16][4 * (l / 16) + i], i in [0, 4)
+//   B (16x16, KxN): lane l holds B[4 * (l / 16) + i][l % 16]
+//   C (16x16, MxN): lane l holds C[4 * (l / 16) + i][l % 16]
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Codegen/LLVMGPU/ConvertToLLVM.h"
+#include "mlir/Dialect/AMDGPU/IR/AMDGPUDialect.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/Transforms/Patterns.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Transforms/DialectConversion.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+/// Number of lanes of the wave executing an MFMA instruction.
+constexpr int64_t kMFMAWaveSize = 64;
+/// Size of the square fragments of the supported MFMA instruction.
+constexpr int64_t kMFMAFragmentDim = 16;
+/// Number of elements of a fragment held by each lane.
+constexpr int64_t kMFMAElementsPerLane = 4;
+
+/// Returns true if `type` is a fragment of `v_mfma_f32_16x16x16f16`.
+static bool isSupportedMMAMatrixType(gpu::MMAMatrixType type) {
+  if (type.getShape() !=
+      ArrayRef<int64_t>{kMFMAFragmentDim, kMFMAFragmentDim}) {
+    return false;
+  }
+  if (type.getOperand() == "COp")
+    return type.getElementType().isF32();
+  return type.getElementType().isF16();
+}
+
+static VectorType getLaneFragmentType(gpu::MMAMatrixType type) {
+  return VectorType::get({kMFMAElementsPerLane}, type.getElementType());
+}
+
+/// Returns the (row, column) positions in the fragment of the elements held by
+/// the current lane. The last two `indices` are offset by them to get the
+/// memref indices of the elements, swapped if the fragment is `transposed` in
+/// memory.
+static SmallVector<SmallVector<Value>>
+getLaneElementIndices(OpBuilder &b, Location loc, StringRef operand,
+                      ValueRange indices, bool transposed) {
+  Value threadId = b.create<gpu::ThreadIdOp>(loc, gpu::Dimension::x);
+  Value laneId = b.create<arith::RemUIOp>(
+      loc, threadId, b.create<arith::ConstantIndexOp>(loc, kMFMAWaveSize));
+  Value fragmentDim = b.create<arith::ConstantIndexOp>(loc, kMFMAFragmentDim);
+  // The lane selects the position along the non-reduced dimension and the
+  // group of 4 consecutive elements along the other one.
+  Value laneMinor = b.create<arith::RemUIOp>(loc, laneId, fragmentDim);
+  Value laneMajor = b.create<arith::MulIOp>(
+      loc, b.create<arith::DivUIOp>(loc, laneId, fragmentDim),
+      b.create<arith::ConstantIndexOp>(loc, kMFMAElementsPerLane));
+
+  SmallVector<SmallVector<Value>> elementIndices;
+  for (int64_t i = 0; i < kMFMAElementsPerLane; ++i) {
+    Value major = b.create<arith::AddIOp>(
+        loc, laneMajor, b.create<arith::ConstantIndexOp>(loc, i));
+    Value row = operand == "AOp" ? laneMinor : major;
+    Value col = operand == "AOp" ? major : laneMinor;
+    if (transposed)
+      std::swap(row, col);
+    SmallVector<Value> elementIndex = llvm::to_vector(indices);
+    Value &rowIndex = elementIndex[elementIndex.size() - 2];
+    Value &colIndex = elementIndex.back();
+    rowIndex = b.create<arith::AddIOp>(loc, rowIndex, row);
+    colIndex = b.create<arith::AddIOp>(loc, colIndex, col);
+    elementIndices.push_back(std::move(elementIndex));
+  }
+  return elementIndices;
+}
+
+struct MMALoadMatrixOpConversion
+    : public OpConversionPattern<gpu::SubgroupMmaLoadMatrixOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupMmaLoadMatrixOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto type = llvm::cast<gpu::MMAMatrixType>(op.getRes().getType());
+    if (!isSupportedMMAMatrixType(type))
+      return rewriter.notifyMatchFailure(op, "unsupported fragment type");
+    Location loc = op.getLoc();
+    bool transposed = op->hasAttr("transpose");
+    SmallVector<SmallVector<Value>> elementIndices = getLaneElementIndices(
+        rewriter, loc, type.getOperand(), adaptor.getIndices(), transposed);
+    VectorType fragmentType = getLaneFragmentType(type);
+
+    // The elements of a lane are contiguous in memory when they are along
+    // the innermost dimension, which is the case for A unless it is
+    // transposed and the other way around for B.
+    bool isContiguous = (type.getOperand() == "AOp") != transposed;
+    if (isContiguous) {
+      rewriter.replaceOpWithNewOp<vector::LoadOp>(
+          op, fragmentType, adaptor.getSrcMemref(), elementIndices.front());
+      return success();
+    }
+
+    Value fragment = rewriter.create<arith::ConstantOp>(
+        loc, fragmentType, rewriter.getZeroAttr(fragmentType));
+    for (auto [i, indices] : llvm::enumerate(elementIndices)) {
+      Value element =
+          rewriter.create<memref::LoadOp>(loc, adaptor.getSrcMemref(), indices);
+      fragment = rewriter.create<vector::InsertOp>(
+          loc, element, fragment, ArrayRef<int64_t>{static_cast<int64_t>(i)});
+    }
+    rewriter.replaceOp(op, fragment);
+    return success();
+  }
+};
+
+struct MMAStoreMatrixOpConversion
+    : public OpConversionPattern<gpu::SubgroupMmaStoreMatrixOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupMmaStoreMatrixOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto type = llvm::cast<gpu::MMAMatrixType>(op.getSrc().getType());
+    if (!isSupportedMMAMatrixType(type))
+      return rewriter.notifyMatchFailure(op, "unsupported fragment type");
+    Location loc = op.getLoc();
+    SmallVector<SmallVector<Value>> elementIndices =
+        getLaneElementIndices(rewriter, loc, type.getOperand(),
+                              adaptor.getIndices(), op->hasAttr("transpose"));
+    for (auto [i, indices] : llvm::enumerate(elementIndices)) {
+      Value element = rewriter.create<vector::ExtractOp>(
+          loc, adaptor.getSrc(), ArrayRef<int64_t>{static_cast<int64_t>(i)});
+      rewriter.create<memref::StoreOp>(loc, element, adaptor.getDstMemref(),
+                                       indices);
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+struct MMAComputeOpConversion
+    : public OpConversionPattern<gpu::SubgroupMmaComputeOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupMmaComputeOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // Transposed operands are handled when loading the fragments.
+    if (op->hasAttr("a_transpose") || op->hasAttr("b_transpose"))
+      return rewriter.notifyMatchFailure(op, "unsupported transpose");
+    for (Value operand : op->getOperands()) {
+      if (!isSupportedMMAMatrixType(
+              llvm::cast<gpu::MMAMatrixType>(operand.getType()))) {
+        return rewriter.notifyMatchFailure(op, "unsupported fragment type");
+      }
+    }
+    rewriter.replaceOpWithNewOp<amdgpu::MFMAOp>(
+        op, adaptor.getOpC().getType(), /*m=*/kMFMAFragmentDim,
+        /*n=*/kMFMAFragmentDim, /*k=*/kMFMAFragmentDim, /*blocks=*/1,
+        adaptor.getOpA(), adaptor.getOpB(), adaptor.getOpC());
+    return success();
+  }
+};
+
+struct MMAConstantMatrixOpConversion
+    : public OpConversionPattern<gpu::SubgroupMmaConstantMatrixOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupMmaConstantMatrixOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto type = llvm::cast<gpu::MMAMatrixType>(op.getRes().getType());
+    if (!isSupportedMMAMatrixType(type))
+      return rewriter.notifyMatchFailure(op, "unsupported fragment type");
+    rewriter.replaceOpWithNewOp<vector::SplatOp>(op, getLaneFragmentType(type),
+                                                 adaptor.getValue());
+    return success();
+  }
+};
+
+/// Elementwise ops apply to all the fragments in the same way, regardless of
+/// the layout, as long as all the operands share it.
+struct MMAElementwiseOpConversion
+    : public OpConversionPattern<gpu::SubgroupMmaElementwiseOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupMmaElementwiseOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type resultType = getTypeConverter()->convertType(op.getType());
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "unsupported fragment type");
+    ValueRange args = adaptor.getArgs();
+    Location loc = op.getLoc();
+    Value result;
+    switch (op.getOpType()) {
+    case gpu::MMAElementwiseOp::ADDF:
+      result = rewriter.create<arith::AddFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::MULF:
+      result = rewriter.create<arith::MulFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::SUBF:
+      result = rewriter.create<arith::SubFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::DIVF:
+      result = rewriter.create<arith::DivFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::MAXF:
+      result = rewriter.create<arith::MaximumFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::MINF:
+      result = rewriter.create<arith::MinimumFOp>(loc, args[0], args[1]);
+      break;
+    case gpu::MMAElementwiseOp::NEGATEF:
+      result = rewriter.create<arith::NegFOp>(loc, args[0]);
+      break;
+    case gpu::MMAElementwiseOp::EXTF:
+      result = rewriter.create<arith::ExtFOp>(loc, resultType, args[0]);
+      break;
+    default:
+      return rewriter.notifyMatchFailure(op, "unsupported elementwise op");
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+} // namespace
+
+LogicalResult convertGPUMMAToMFMA(ModuleOp moduleOp) {
+  bool hasMMAOps = false;
+  moduleOp.walk([&](Operation *op) {
+    if (isa<gpu::SubgroupMmaComputeOp, gpu::SubgroupMmaLoadMatrixOp>(op)) {
+      hasMMAOps = true;
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  if (!hasMMAOps)
+    return success();
+
+  MLIRContext *context = moduleOp.getContext();
+  TypeConverter typeConverter;
+  typeConverter.addConversion([](Type type) { return type; });
+  typeConverter.addConversion(
+      [](gpu::MMAMatrixType type) -> std::optional<Type> {
+        if (!isSupportedMMAMatrixType(type))
+          return std::nullopt;
+        return getLaneFragmentType(type);
+      });
+
+  ConversionTarget target(*context);
+  target.markUnknownOpDynamicallyLegal([](Operation *) { return true; });
+  target.addIllegalOp<gpu::SubgroupMmaComputeOp,
+                      gpu::SubgroupMmaConstantMatrixOp,
+                      gpu::SubgroupMmaElementwiseOp,
+                      gpu::SubgroupMmaLoadMatrixOp,
+                      gpu::SubgroupMmaStoreMatrixOp>();
+
+  RewritePatternSet patterns(context);
+  patterns.add<MMAComputeOpConversion, MMAConstantMatrixOpConversion,
+               MMAElementwiseOpConversion, MMALoadMatrixOpConversion,
+               MMAStoreMatrixOpConversion>(typeConverter, context);
+  // Fragments are carried across the iterations of the K loop.
+  scf::populateSCFStructuralTypeConversionsAndLegality(typeConverter, patterns,
+                                                       target);
+  return applyPartialConversion(moduleOp, target, std::move(patterns));
+}
+
+} // namespace iree_compiler
+} // namespace mlir
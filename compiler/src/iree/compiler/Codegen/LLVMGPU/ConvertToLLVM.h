@@ -29,6 +29,10 @@ void populateConvertSharedMemoryAllocOps(RewritePatternSet &patterns);
 
 void ConvertToDynamicSharedMemory(ModuleOp moduleOp);
 
+/// Converts the gpu.subgroup_mma ops to amdgpu.mfma ops and loads/stores of
+/// the fragments held by each lane.
+LogicalResult convertGPUMMAToMFMA(ModuleOp moduleOp);
+
 using MemorySpaceMapping =
     std::function<unsigned(gpu::AddressSpace gpuAddressSpace)>;
 void populateGpuMemorySpaceAttributeConversions(
@@ -11,6 +11,7 @@
 #include "iree/compiler/Codegen/LLVMGPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "mlir/Conversion/AMDGPUToROCDL/AMDGPUToROCDL.h"
 #include "mlir/Conversion/ArithToLLVM/ArithToLLVM.h"
 #include "mlir/Conversion/ComplexToLLVM/ComplexToLLVM.h"
 #include "mlir/Conversion/ControlFlowToLLVM/ControlFlowToLLVM.h"
@@ -22,6 +23,8 @@
 #include "mlir/Conversion/MathToLLVM/MathToLLVM.h"
 #include "mlir/Conversion/MemRefToLLVM/MemRefToLLVM.h"
 #include "mlir/Conversion/VectorToLLVM/ConvertVectorToLLVM.h"
+#include "mlir/Dialect/AMDGPU/IR/AMDGPUDialect.h"
+#include "mlir/Dialect/AMDGPU/Utils/Chipset.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
 #include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
@@ -34,6 +37,16 @@
 namespace mlir {
 namespace iree_compiler {
 
+/// Returns the chipset of the target the module is compiled for, if known.
+static FailureOr<amdgpu::Chipset> getChipset(ModuleOp moduleOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(moduleOp);
+  std::optional<StringAttr> targetArch =
+      getConfigStringAttr(targetAttr, "target_arch");
+  if (!targetArch)
+    return failure();
+  return amdgpu::Chipset::parse(targetArch->getValue());
+}
+
 namespace {
 
 /// A pass that replaces all occurrences of GPU device operations with their
@@ -43,7 +56,8 @@ namespace {
 /// code.
 struct ConvertToROCDLPass : public ConvertToROCDLBase<ConvertToROCDLPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
-    registry.insert<LLVM::LLVMDialect, ROCDL::ROCDLDialect>();
+    registry.insert<amdgpu::AMDGPUDialect, LLVM::LLVMDialect,
+                    ROCDL::ROCDLDialect, vector::VectorDialect>();
   }
   void runOnOperation() override {
     ModuleOp m = getOperation();
@@ -65,6 +79,12 @@ struct ConvertToROCDLPass : public ConvertToROCDLBase<ConvertToROCDLPass> {
           llvm_unreachable("unknown address space enum value");
           return 0;
         });
+    // Lower the subgroup MMA ops of the tensor core pipeline to matrix core
+    // ops first, their fragment loads and stores go through the vector
+    // lowerings below.
+    if (failed(convertGPUMMAToMFMA(m))) {
+      return signalPassFailure();
+    }
     // Apply in-dialect lowering first. In-dialect lowering will replace ops
     // which need to be lowered further, which is not supported by a single
     // conversion pass.
@@ -124,6 +144,13 @@ struct ConvertToROCDLPass : public ConvertToROCDLBase<ConvertToROCDLPass> {
       populateGpuToROCDLConversionPatterns(converter, llvmPatterns,
                                            gpu::amd::Runtime::Unknown);
       LLVMConversionTarget target(getContext());
+      // The AMDGPU ops are lowered to intrinsics of the target chipset.
+      FailureOr<amdgpu::Chipset> chipset = getChipset(m);
+      if (succeeded(chipset)) {
+        populateAMDGPUToROCDLConversionPatterns(converter, llvmPatterns,
+                                                *chipset);
+        target.addIllegalDialect<amdgpu::AMDGPUDialect>();
+      }
       populateFuncToLLVMFuncOpConversionPattern(converter, llvmPatterns);
       configureGpuToROCDLConversionLegality(target);
       if (failed(applyPartialConversion(m, target, std::move(llvmPatterns))))
@@ -9,6 +9,7 @@
 #include <numeric>
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
+#include "iree/compiler/Codegen/Common/UserConfig.h"
 #include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/Interfaces/UKernelOpInterface.h"
 #include "iree/compiler/Codegen/TransformStrategies/GPU/Strategies.h"
@@ -21,6 +22,7 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/IR/Types.h"
 #include "mlir/IR/Value.h"
 
@@ -61,6 +63,10 @@ struct TargetInfo {
   bool hasTF32TensorCore = false;
   bool hasWarpShuffle = false;
   bool hasMmaSync = false;
+  // sm_90 allows up to 227KB of shared memory per workgroup.
+  bool hasLargeSharedMemory = false;
+  // AMD CDNA matrix cores, which execute on full 64-wide waves.
+  bool hasMFMA = false;
 };
 
 struct TileWorkgroupSizePair {
@@ -72,6 +78,8 @@ struct TileWorkgroupSizePair {
 
 // Simt codegen does not do software pipelining.
 constexpr unsigned softwarePipelineDepthSimt = 0;
+// MFMA instructions are executed by a full wave of 64 lanes.
+constexpr unsigned mfmaWaveSize = 64;
 } // namespace
 
 /// Return the best combination of tile size and wg size. It will then used to
@@ -95,7 +103,8 @@ static void getMatmulConfig(SmallVectorImpl<TileWorkgroupSizePair> &tileSizes) {
 /// operations.
 static void
 getTensorCoreConfig(SmallVectorImpl<TileWorkgroupSizePair> &tileSizes,
-                    Type elementType, int64_t M, int64_t N, int64_t K) {
+                    Type elementType, int64_t M, int64_t N, int64_t K,
+                    const TargetInfo &targetInfo) {
   // Based on early analysis we found that 128x256x32_3 gives acceptable
   // performance across many of the large matrix sizes for f16 and fp32. This
   // needs to be refined into a better startegy based on empircal data but this
@@ -103,12 +112,46 @@ getTensorCoreConfig(SmallVectorImpl<TileWorkgroupSizePair> &tileSizes,
   // magnitude for large square like cases.
   int64_t parallelDim = M * N;
   static constexpr int64_t kLargDimThreashold = 1536;
+  // MFMA configurations use 64-wide waves, i.e. {128, 2, 1} is a 2x2 grid of
+  // waves. There are no async copies on AMD GPUs so nothing is gained from
+  // multi-buffering the shared memory.
+  if (targetInfo.hasMFMA) {
+    if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
+      tileSizes.push_back(
+          TileWorkgroupSizePair({{128, 128, 32}, {128, 2, 1}, 1}));
+    }
+    tileSizes.push_back(TileWorkgroupSizePair({{64, 64, 32}, {128, 2, 1}, 1}));
+    tileSizes.push_back(TileWorkgroupSizePair({{32, 32, 32}, {64, 2, 1}, 1}));
+    tileSizes.push_back(TileWorkgroupSizePair({{16, 16, 16}, {64, 1, 1}, 1}));
+    return;
+  }
+  // With the larger shared memory of sm_90 we can double the K tile of the
+  // large configuration and keep 4 stages in flight (4 x 48KB). This halves
+  // the number of barriers per K step and gives the async copies more time to
+  // hide the memory latency.
+  if (targetInfo.hasLargeSharedMemory &&
+      parallelDim >= kLargDimThreashold * kLargDimThreashold) {
+    int64_t tileK = elementType.isInteger(8) ? 128
+                    : elementType.isF16()    ? 64
+                                             : 32;
+    tileSizes.push_back(
+        TileWorkgroupSizePair({{128, 256, tileK}, {128, 2, 1}, 4}));
+  }
   if (elementType.isF16()) {
     if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
       tileSizes.push_back(
           TileWorkgroupSizePair({{128, 256, 32}, {128, 2, 1}, 3}));
     }
     tileSizes.push_back(TileWorkgroupSizePair({{32, 32, 32}, {64, 2, 1}, 4}));
+  } else if (elementType.isInteger(8)) {
+    // The i8 mma.sync instruction has a K of 32, so tile K by 64 to keep the
+    // same number of bytes per stage as f16.
+    if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
+      tileSizes.push_back(
+          TileWorkgroupSizePair({{128, 256, 64}, {128, 2, 1}, 3}));
+    }
+    tileSizes.push_back(TileWorkgroupSizePair({{32, 32, 64}, {64, 2, 1}, 4}));
+    tileSizes.push_back(TileWorkgroupSizePair({{32, 32, 32}, {64, 2, 1}, 4}));
   } else {
     if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
       tileSizes.push_back(
@@ -178,6 +221,9 @@ static TargetInfo getCudaTargetInfo(func::FuncOp entryPoint) {
     info.hasTF32TensorCore = true;
     info.hasMmaSync = true;
   }
+  if (smVersion >= 90) {
+    info.hasLargeSharedMemory = true;
+  }
   return info;
 }
 
@@ -194,7 +240,12 @@ static TargetInfo getRocmTargetInfo(func::FuncOp entryPoint) {
   }
   // Assumes all gfx has warp shuffle.
   info.hasWarpShuffle = true;
-  // TODO: Check and enable for WMMA once pipeline is available.
+  // CDNA targets have matrix cores. RDNA WMMA is not supported yet.
+  static constexpr StringLiteral kMFMATargets[] = {
+      "gfx908", "gfx90a", "gfx940", "gfx941", "gfx942"};
+  if (llvm::is_contained(kMFMATargets, targetName)) {
+    info.hasMFMA = true;
+  }
   return info;
 }
 
@@ -213,20 +264,51 @@ static bool supportsTensorCore(func::FuncOp entryPoint, linalg::LinalgOp op,
                                const TargetInfo &targetInfo) {
   // Limit tensor core pipeline to matmul as not all combinations of transpose
   // are supported upstream.
-  if (!targetInfo.hasTF32TensorCore)
+  if (!targetInfo.hasTF32TensorCore && !targetInfo.hasMFMA)
     return false;
+  // Only the f16 MFMA instructions accumulating into f32 are lowered.
+  if (targetInfo.hasMFMA) {
+    Type lhsElementType =
+        getElementTypeOrSelf(op.getDpsInputOperand(0)->get().getType());
+    Type accElementType =
+        getElementTypeOrSelf(op.getDpsInitOperand(0)->get().getType());
+    if (!lhsElementType.isF16() || !accElementType.isF32())
+      return false;
+  }
+  // Integer matmuls only map to the 8-bit mma.sync instructions, which
+  // accumulate into 32-bit integers.
+  Type lhsElementType =
+      getElementTypeOrSelf(op.getDpsInputOperand(0)->get().getType());
+  bool isIntegerMatmul = isa<IntegerType>(lhsElementType);
+  if (isIntegerMatmul) {
+    Type accElementType =
+        getElementTypeOrSelf(op.getDpsInitOperand(0)->get().getType());
+    if (!targetInfo.hasMmaSync || !lhsElementType.isInteger(8) ||
+        !accElementType.isInteger(32)) {
+      return false;
+    }
+  }
   if (!(isa<linalg::MatmulOp>(op) || isa<linalg::BatchMatmulOp>(op))) {
     assert(linalg::isaContractionOpInterface(op));
     // If this is not a named op matmul check some properties to make sure that
     // we can map it to tensorcore ops. We should have only mulAdd in the region
-    // and the output map should have no permutation and the last dimension
-    // should be a reduce.
+    // (after extending the inputs to the accumulator type) and the output map
+    // should have no permutation and the last dimension should be a reduce.
     Region &body = op->getRegion(0);
     Region::OpIterator it = body.op_begin();
-    if (it == body.op_end() || !isa<arith::MulFOp>(*(it++)))
-      return false;
-    if (it == body.op_end() || !isa<arith::AddFOp>(*(it++)))
-      return false;
+    while (it != body.op_end() && isa<arith::ExtSIOp, arith::ExtFOp>(*it))
+      ++it;
+    if (isIntegerMatmul) {
+      if (it == body.op_end() || !isa<arith::MulIOp>(*(it++)))
+        return false;
+      if (it == body.op_end() || !isa<arith::AddIOp>(*(it++)))
+        return false;
+    } else {
+      if (it == body.op_end() || !isa<arith::MulFOp>(*(it++)))
+        return false;
+      if (it == body.op_end() || !isa<arith::AddFOp>(*(it++)))
+        return false;
+    }
     if (it == body.op_end() || !isa<linalg::YieldOp>(*(it++)))
       return false;
     AffineMap outputMap = op.getMatchingIndexingMap(op.getDpsInitOperand(0));
@@ -243,13 +325,21 @@ static bool supportsTensorCore(func::FuncOp entryPoint, linalg::LinalgOp op,
 
 /// Decides which tensorcore operations to use.
 static IREE::Codegen::DispatchLoweringPassPipeline
-getTensorCorePipeline(Type elementType) {
+getTensorCorePipeline(Type elementType, const TargetInfo &targetInfo) {
+  // MFMA ops are only generated from the subgroup MMA ops of the WMMA
+  // pipeline.
+  if (targetInfo.hasMFMA) {
+    return IREE::Codegen::DispatchLoweringPassPipeline::
+        LLVMGPUMatmulTensorCore;
+  }
   // Currently mma.sync is on by default for fp16 only.
   IREE::Codegen::DispatchLoweringPassPipeline codegenPipeline =
       IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUMatmulTensorCore;
 
-  // For F16 and F32 use mmasync by default.
-  if (elementType.isF16() || elementType.isF32()) {
+  // For F16, F32 and I8 use mmasync by default. I8 is only supported through
+  // mmasync.
+  if (elementType.isF16() || elementType.isF32() ||
+      elementType.isInteger(8)) {
     codegenPipeline = IREE::Codegen::DispatchLoweringPassPipeline::
         LLVMGPUMatmulTensorCoreMmaSync;
   }
@@ -301,10 +391,11 @@ static LogicalResult setContractConfig(func::FuncOp entryPoint,
   }
 
   auto setMatmulConfig =
-      [&entryPoint, &op](int64_t tileX, int64_t tileY, int64_t tileK,
-                         llvm::ArrayRef<int64_t> workgroupSize,
-                         unsigned softwarePipelineDepth,
-                         IREE::Codegen::DispatchLoweringPassPipeline pipeline) {
+      [&entryPoint, &op,
+       &targetInfo](int64_t tileX, int64_t tileY, int64_t tileK,
+                    llvm::ArrayRef<int64_t> workgroupSize,
+                    unsigned softwarePipelineDepth,
+                    IREE::Codegen::DispatchLoweringPassPipeline pipeline) {
         TileSizesListType tileSizes;
         unsigned numParallelLoops = op.getNumParallelLoops();
         SmallVector<int64_t> workgroupTileSizes(numParallelLoops - 2, 1);
@@ -325,9 +416,17 @@ static LogicalResult setContractConfig(func::FuncOp entryPoint,
 
         tileSizes.emplace_back(
             std::move(workgroupTileSizes)); // Workgroup level.
+        // The tensor core configurations for MFMA are expressed in 64-wide
+        // waves.
+        std::optional<int64_t> subgroupSize;
+        if (targetInfo.hasMFMA &&
+            pipeline == IREE::Codegen::DispatchLoweringPassPipeline::
+                            LLVMGPUMatmulTensorCore) {
+          subgroupSize = mfmaWaveSize;
+        }
         return setOpConfigAndEntryPointFnTranslation(
-            entryPoint, op, tileSizes, pipeline, workgroupSize,
-            /*subgroupSize=*/std::nullopt, softwarePipelineDepth,
+            entryPoint, op, tileSizes, pipeline, workgroupSize, subgroupSize,
+            softwarePipelineDepth,
             /*softwarePipelineStoreStage=*/1);
       };
   // Infer the MxN size of the matmul based on operands and indexing maps.
@@ -377,7 +476,8 @@ static LogicalResult setContractConfig(func::FuncOp entryPoint,
                              op.getDpsInputOperand(0)->get().getType())
                              .getElementType();
 
-      getTensorCoreConfig(TCtileSizeConfig, elementType, sizeM, sizeN, sizeK);
+      getTensorCoreConfig(TCtileSizeConfig, elementType, sizeM, sizeN, sizeK,
+                          targetInfo);
       // Pick the best configuration where the original shape is aligned on the
       // tile size.
       for (TileWorkgroupSizePair &config : TCtileSizeConfig) {
@@ -385,7 +485,7 @@ static LogicalResult setContractConfig(func::FuncOp entryPoint,
             sizeN % config.tileSize[1] == 0 &&
             sizeM % config.tileSize[0] == 0) {
           IREE::Codegen::DispatchLoweringPassPipeline codegenPipeline =
-              getTensorCorePipeline(elementType);
+              getTensorCorePipeline(elementType, targetInfo);
           return setMatmulConfig(
               config.tileSize[0], config.tileSize[1], config.tileSize[2],
               config.workgroupSize,
@@ -471,6 +571,32 @@ static LogicalResult setFftConfig(func::FuncOp entryPoint,
       workgroupSize);
 }
 
+/// Sets the configuration of a linalg_ext.attention op lowered without a
+/// transform dialect strategy. Each workgroup computes the attention of one
+/// batch and a tile of the query sequence with the tiled online softmax
+/// algorithm, so the batch is tiled to 1, the head dimension is not tiled and
+/// the sequence tile size must divide both sequence lengths. The tile is
+/// processed by a single thread; parallelism comes from the number of tiles.
+static LogicalResult setAttentionConfig(func::FuncOp entryPoint,
+                                        IREE::LinalgExt::AttentionOp op) {
+  ShapedType queryType = op.getQueryType();
+  ShapedType keyType = op.getKeyType();
+  if (!queryType.hasStaticShape() || !keyType.hasStaticShape()) {
+    return op.emitOpError("expected static shapes");
+  }
+  const int64_t maxSeqTileSize = 16;
+  int64_t seqLengths = std::gcd(queryType.getDimSize(1), keyType.getDimSize(1));
+  int64_t seqTileSize =
+      std::max<int64_t>(std::min<int64_t>(seqLengths, maxSeqTileSize), 1);
+  while (seqTileSize > 1 && seqLengths % seqTileSize != 0) {
+    --seqTileSize;
+  }
+  TileSizesListType tileSizes = {{1, seqTileSize, 0}};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes,
+      IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUDefault, {1, 1, 1});
+}
+
 static LogicalResult setSortConfig(func::FuncOp entryPoint, Operation *op) {
   TileSizesListType tileSizes;
   auto interfaceOp = cast<PartitionableLoopsInterface>(*op);
@@ -1163,6 +1289,9 @@ static LogicalResult setRootConfig(func::FuncOp entryPointFn,
   if (auto fftOp = dyn_cast<IREE::LinalgExt::FftOp>(computeOp)) {
     return setFftConfig(entryPointFn, fftOp);
   }
+  if (auto attnOp = dyn_cast<IREE::LinalgExt::AttentionOp>(computeOp)) {
+    return setAttentionConfig(entryPointFn, attnOp);
+  }
   if (auto sortOp = dyn_cast<IREE::LinalgExt::SortOp>(computeOp)) {
     return setSortConfig(entryPointFn, sortOp);
   }
@@ -1249,6 +1378,17 @@ LogicalResult initGPULaunchConfig(ModuleOp moduleOp) {
       continue;
     }
 
+    // Use the configuration measured to be the fastest if a profile is
+    // provided.
+    FailureOr<bool> profiledConfig =
+        setProfileGuidedConfig(funcOp, rootOperation);
+    if (failed(profiledConfig))
+      return failure();
+    if (*profiledConfig) {
+      propagateLoweringConfig(rootOperation, computeOps);
+      continue;
+    }
+
     if (failed(setRootConfig(funcOp, rootOperation)))
       continue;
 
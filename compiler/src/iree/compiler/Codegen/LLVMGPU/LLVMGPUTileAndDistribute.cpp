@@ -140,19 +140,20 @@ calculateDistributedTileSize(ArrayRef<int64_t> numElements, OpBuilder &builder,
 /// Patterns for warp level tiling.
 static void
 populateTilingToWarpPatterns(RewritePatternSet &patterns,
-                             SmallVectorImpl<int64_t> &workgroupSize) {
+                             SmallVectorImpl<int64_t> &workgroupSize,
+                             int64_t warpSize) {
   std::array<int64_t, 3> warpPerWorkgroup = {
-      workgroupSize[0] / kWarpSize, workgroupSize[1], workgroupSize[2]};
+      workgroupSize[0] / warpSize, workgroupSize[1], workgroupSize[2]};
 
   linalg::TileSizeComputationFunction getInnerTileSizeFn =
       [warpPerWorkgroup](OpBuilder &builder, Operation *operation) {
         return calculateDistributedTileSize(warpPerWorkgroup, builder,
                                             operation);
       };
-  auto getWarpProcInfoFn = [warpPerWorkgroup](
+  auto getWarpProcInfoFn = [warpPerWorkgroup, warpSize](
                                OpBuilder &builder, Location loc,
                                ArrayRef<Range> parallelLoopRanges) {
-    return getSubgroupIdsAndCounts(builder, loc, /*warpSize=*/32u,
+    return getSubgroupIdsAndCounts(builder, loc, warpSize,
                                    parallelLoopRanges.size(), warpPerWorkgroup);
   };
   linalg::LinalgLoopDistributionOptions warpDistributionOptions;
@@ -252,14 +253,18 @@ public:
       funcOp.dump();
     });
 
+    FailureOr<IREE::HAL::ExecutableExportOp> exportOp = getEntryPoint(funcOp);
     auto workgroupSize = llvm::map_to_vector(
-        getEntryPoint(funcOp)->getWorkgroupSize().value(),
+        exportOp->getWorkgroupSize().value(),
         [&](Attribute attr) { return llvm::cast<IntegerAttr>(attr).getInt(); });
+    // Targets running wave64 (e.g. AMD CDNA matrix cores) set the subgroup
+    // size on the entry point.
+    int64_t warpSize = getSubgroupSize(*exportOp).value_or(kWarpSize);
 
     int64_t flatWorkgroupSize =
         workgroupSize[0] * workgroupSize[1] * workgroupSize[2];
     // Only promote to workgroup size if there are multiple warps.
-    if (flatWorkgroupSize > kWarpSize) {
+    if (flatWorkgroupSize > warpSize) {
       RewritePatternSet promotionPatterns(&getContext());
 
       populateContractPromotionPatterns(promotionPatterns, {0, 1});
@@ -289,7 +294,8 @@ public:
     if (distributeToWarp) {
       // Apply last level of tiling and distribute to warps.
       RewritePatternSet warpLevelTilingPatterns(context);
-      populateTilingToWarpPatterns(warpLevelTilingPatterns, workgroupSize);
+      populateTilingToWarpPatterns(warpLevelTilingPatterns, workgroupSize,
+                                   warpSize);
       if (failed(applyPatternsAndFoldGreedily(
               funcOp, std::move(warpLevelTilingPatterns)))) {
         return signalPassFailure();
@@ -9,6 +9,7 @@
 #include "iree/compiler/Codegen/LLVMGPU/Passes.h"
 #include "iree/compiler/Codegen/LLVMGPU/Utils/LLVMGPUUtils.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "mlir/Conversion/VectorToGPU/VectorToGPU.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -84,7 +85,11 @@ struct LLVMGPUVectorToGPUPass
         return signalPassFailure();
       }
     }
-    createAsyncGroups(rewriter, funcOp, targetMmaSync);
+    // Async copies lower to nvgpu ops that only exist on NVIDIA GPUs, AMD
+    // matrix cores load their operands through regular shared memory copies.
+    if (!isROCMBackend(IREE::HAL::ExecutableTargetAttr::lookup(funcOp))) {
+      createAsyncGroups(rewriter, funcOp, targetMmaSync);
+    }
 
     if (targetMmaSync) {
       // Fold subview on memory copy to enable the application of shared memory
@@ -13,6 +13,7 @@
 #include "iree/compiler/Codegen/LLVMGPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/MarkerUtils.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Util/Transforms/Passes.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Conversion/ComplexToStandard/ComplexToStandard.h"
@@ -499,6 +500,26 @@ static void addLowerAndOptimzeAddressComputation(OpPassManager &pm) {
   pm.addPass(createLowerAffinePass());
 }
 
+/// Returns the maximum shared memory per workgroup (in bytes) that kernels
+/// can opt into on the target of `func`.
+static unsigned getGPUSharedMemoryLimit(func::FuncOp func) {
+  // TODO: query this from the target.
+  static constexpr unsigned kDefaultSharedMemoryLimit = 163 * 1024;
+  FailureOr<IREE::HAL::ExecutableVariantOp> variantOp =
+      getExecutableVariantOp(func);
+  if (failed(variantOp))
+    return kDefaultSharedMemoryLimit;
+  auto config = variantOp->getTarget().getConfiguration();
+  auto targetArch = config ? config.getAs<StringAttr>("target_arch") : nullptr;
+  APInt version;
+  if (targetArch && targetArch.getValue().starts_with("sm_") &&
+      !targetArch.getValue().substr(3).getAsInteger(10, version) &&
+      version.getZExtValue() >= 90) {
+    return 227 * 1024;
+  }
+  return kDefaultSharedMemoryLimit;
+}
+
 static void addLowerToLLVMGPUPasses(OpPassManager &pm, bool useROCM) {
   pm.addPass(createConvertHALDescriptorTypeToGPUAddressSpacePass());
 
@@ -535,11 +556,9 @@ static void addLowerToLLVMGPUPasses(OpPassManager &pm, bool useROCM) {
   // THIS NEEDS TO RUN BEFORE SCF ->CF OFF
 
   // Run checks on shared memory usage.
-  // TODO: query this from the target.
-  auto getSharedMemoryLimit = [](func::FuncOp) { return 163 * 1024; };
   auto getIndexBitwidth = [](func::FuncOp) { return 64; };
-  pm.addPass(
-      createGPUCheckResourceUsagePass(getSharedMemoryLimit, getIndexBitwidth));
+  pm.addPass(createGPUCheckResourceUsagePass(getGPUSharedMemoryLimit,
+                                             getIndexBitwidth));
 
   // SCF -> STD
   pm.addNestedPass<func::FuncOp>(createConvertSCFToCFPass());
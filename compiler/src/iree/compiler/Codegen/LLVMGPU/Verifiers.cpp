@@ -4,9 +4,11 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/LLVMGPU/PassDetail.h"
 #include "iree/compiler/Codegen/LLVMGPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "mlir/Dialect/Linalg/Passes.h"
 
 namespace mlir {
@@ -57,9 +59,18 @@ static LogicalResult getInstructionShape(
       instructionShape = {16, 8, 16};
     } else if (inputElementType.isF32()) {
       instructionShape = {16, 8, 8};
+    } else if (inputElementType.isInteger(8)) {
+      // 8-bit integer mma.sync only accumulates into 32-bit integers.
+      Type accElementType = getElementTypeOrSelf(
+          cast<linalg::LinalgOp>(op).getDpsInits()[0].getType());
+      if (!accElementType.isInteger(32)) {
+        return op->emitError(
+            "Expected i32 accumulator for i8 Tensor Core (MMA.SYNC) pipeline");
+      }
+      instructionShape = {16, 8, 32};
     } else {
       return op->emitError(
-          "Expected f16, bf16 or f32 for Tensor Core (MMA.SYNC) pipeline");
+          "Expected f16, bf16, f32 or i8 for Tensor Core (MMA.SYNC) pipeline");
     }
     break;
   default:
@@ -174,18 +185,27 @@ verifyGPUMatmulPipeline(Operation *op,
   // Additional verification Tensor Core pipelines.
   //
 
-  // Verify that x-dim has multiple of kWarpSize threads or has integer units of
+  // The warp size defaults to kWarpSize unless the configuration picked a
+  // different subgroup size for the entry point, e.g. wave64 on AMD GPUs.
+  int64_t warpSize = kWarpSize;
+  if (auto funcOp = op->getParentOfType<func::FuncOp>()) {
+    FailureOr<IREE::HAL::ExecutableExportOp> exportOp = getEntryPoint(funcOp);
+    if (succeeded(exportOp))
+      warpSize = getSubgroupSize(*exportOp).value_or(kWarpSize);
+  }
+
+  // Verify that x-dim has multiple of warpSize threads or has integer units of
   // warps in x-dim.
-  if (workgroupSize[kDimX] % kWarpSize != 0) {
+  if (workgroupSize[kDimX] % warpSize != 0) {
     return op->emitError("Number of threads in x-dim ")
            << workgroupSize[kDimX] << " is not a multiple of warp size ("
-           << kWarpSize
+           << warpSize
            << ") or integer units of warps in x-dim with compilation pipeline "
            << pipelineName;
   }
 
   // Number of warps in x, y, and z dim.
-  SmallVector<int64_t> numWarps{workgroupSize[kDimX] / kWarpSize,
+  SmallVector<int64_t> numWarps{workgroupSize[kDimX] / warpSize,
                                 workgroupSize[kDimY], workgroupSize[kDimZ]};
 
   // Matrix-multiply problem shape in number of elements in M, N, and K dim.
@@ -73,3 +73,41 @@ hal.executable @abs_ex_dispatch_0 {
 }
 // CHECK-LABEL: llvm.func @reduction_maximum
 // CHECK:  llvm.intr.vector.reduce.fmax({{.*}})  : (vector<2xf32>) -> f32
+
+// -----
+// Test that subgroup MMA ops are converted to MFMA intrinsics on CDNA targets.
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable @mfma_ex {
+  hal.executable.variant @rocm target(<"rocm", "rocm-hsaco-fb", {target_arch = "gfx90a"}>) {
+    hal.executable.export @mfma_matmul layout(#pipeline_layout)
+    builtin.module {
+      func.func @mfma_matmul() {
+        %c0 = arith.constant 0 : index
+        %cst = arith.constant 0.000000e+00 : f32
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) flags(ReadOnly) : memref<16x16xf16>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) flags(ReadOnly) : memref<16x16xf16>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : memref<16x16xf32>
+        %3 = gpu.subgroup_mma_load_matrix %0[%c0, %c0] {leadDimension = 16 : index} : memref<16x16xf16> -> !gpu.mma_matrix<16x16xf16, "AOp">
+        %4 = gpu.subgroup_mma_load_matrix %1[%c0, %c0] {leadDimension = 16 : index} : memref<16x16xf16> -> !gpu.mma_matrix<16x16xf16, "BOp">
+        %5 = gpu.subgroup_mma_constant_matrix %cst : !gpu.mma_matrix<16x16xf32, "COp">
+        %6 = gpu.subgroup_mma_compute %3, %4, %5 : !gpu.mma_matrix<16x16xf16, "AOp">, !gpu.mma_matrix<16x16xf16, "BOp"> -> !gpu.mma_matrix<16x16xf32, "COp">
+        gpu.subgroup_mma_store_matrix %6, %2[%c0, %c0] {leadDimension = 16 : index} : !gpu.mma_matrix<16x16xf32, "COp">, memref<16x16xf32>
+        return
+      }
+    }
+  }
+}
+// The A fragment of a lane is contiguous in memory while B and C are strided.
+// CHECK-LABEL: llvm.func @mfma_matmul
+//       CHECK:   rocdl.workitem.id.x
+//       CHECK:   llvm.load {{.*}} -> vector<4xf16>
+//   CHECK-COUNT-4:   llvm.load {{.*}} -> f16
+//       CHECK:   rocdl.mfma.f32.16x16x16f16 {{.*}} -> vector<4xf32>
+//   CHECK-COUNT-4:   llvm.store
+//   CHECK-NOT:   gpu.subgroup_mma
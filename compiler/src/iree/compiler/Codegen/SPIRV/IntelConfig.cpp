@@ -0,0 +1,97 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- IntelConfig.h - Intel CodeGen Configurations -----------------------===//
+//
+// This file contains CodeGen configurations for Intel GPUs.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
+#include "iree/compiler/Codegen/SPIRV/KernelConfig.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BuiltinOps.h"
+
+#define DEBUG_TYPE "iree-spirv-intel-config"
+
+namespace mlir {
+namespace iree_compiler {
+namespace detail {
+
+constexpr unsigned IntelNumSubgroupsPerWorkgroup = 4;
+// The number of tiles along M and N dimensions per workgroup. Intel XMX native
+// cooperative matrix sizes are small (8x8), so use more tiles per subgroup.
+constexpr unsigned IntelNumMNTilesPerSubgroup = 16;
+
+static LogicalResult setIntelMatmulConfig(linalg::LinalgOp op,
+                                          const spirv::TargetEnv &targetEnv) {
+  if (succeeded(setCooperativeMatrixConfig(targetEnv, op,
+                                           IntelNumSubgroupsPerWorkgroup,
+                                           IntelNumMNTilesPerSubgroup)))
+    return success();
+
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  const int subgroupSize = limits.getSubgroupSize();
+  const std::array<int64_t, 2> workgroupXY = {subgroupSize, 4};
+  std::array<int64_t, 3> threadMNK;
+  auto inputType =
+      llvm::cast<ShapedType>(op.getDpsInputOperand(0)->get().getType());
+  if (inputType.getElementType().getIntOrFloatBitWidth() == 16) {
+    threadMNK = {8, 8, 16};
+  } else {
+    threadMNK = {4, 4, 16};
+  }
+  return setMatmulOpConfig(limits, op, workgroupXY, threadMNK,
+                           /*enablePromotion=*/true);
+}
+
+// Xe-HPG architecture (Arc A-series):
+// https://www.intel.com/content/www/us/en/developer/articles/technical/introduction-to-the-xe-hpg-architecture.html
+//
+// Xe-core is the block for workgroups in Xe-HPG; it has 16 vector engines
+// (SIMD8) and 16 matrix engines (XMX), shared local memory, and L1 cache.
+//
+// * 64KB shared local memory per Xe-core
+// * Max 32KB shared local memory per workgroup exposed by Vulkan drivers
+// * Cooperative matrix requires a subgroup size of 8
+
+//===----------------------------------------------------------------------===//
+// Entry Point
+//===----------------------------------------------------------------------===//
+
+LogicalResult setIntelCodeGenConfig(const spirv::TargetEnv &targetEnv,
+                                    Operation *rootOp) {
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  int subgroupSize = limits.getSubgroupSize();
+
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
+    if (isMatmulOrBatchMatmul(linalgOp))
+      return setIntelMatmulConfig(linalgOp, targetEnv);
+  }
+
+  if (auto convOp = dyn_cast<linalg::ConvolutionOpInterface>(rootOp)) {
+    // Use the result type in case of larger bitwidth for accumulators.
+    auto type = cast<ShapedType>(convOp->getResult(0).getType());
+    const int bitwidth = type.getElementTypeBitWidth();
+    if (bitwidth > 32)
+      return failure();
+    const int multipler = 32 / bitwidth;
+    bool hasPaddedInput = convOp.image().getDefiningOp<tensor::PadOp>();
+    const int bestTilingFactor = (hasPaddedInput ? 16 : 32) * multipler;
+    return setConvOpConfig(cast<linalg::LinalgOp>(rootOp), subgroupSize,
+                           bestTilingFactor);
+  }
+
+  return failure();
+}
+
+} // namespace detail
+} // namespace iree_compiler
+} // namespace mlir
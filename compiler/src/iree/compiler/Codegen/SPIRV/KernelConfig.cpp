@@ -1027,8 +1027,10 @@ LogicalResult setCooperativeMatrixConfig(
 
   std::optional<int64_t> subgroupSize = limits.getSubgroupSize();
   // AMD RDNA architectures supports both wave32 and wave64 modes. Prefer to use
-  // wave32 mode for better performance.
-  if (targetEnv.getVendorID() == spirv::Vendor::AMD) {
+  // wave32 mode for better performance. Intel Xe-HPG requires SIMD8 subgroups
+  // for cooperative matrix.
+  if (targetEnv.getVendorID() == spirv::Vendor::AMD ||
+      targetEnv.getVendorID() == spirv::Vendor::Intel) {
     if (std::optional<int> minSize = limits.getMinSubgroupSize())
       subgroupSize = *minSize;
   }
@@ -1226,7 +1228,8 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   if (!foundSingleReductionOutput)
     return failure();
 
-  const int subgroupSize = targetEnv.getResourceLimits().getSubgroupSize();
+  spirv::ResourceLimitsAttr limits = targetEnv.getResourceLimits();
+  const int subgroupSize = limits.getSubgroupSize();
   int64_t reductionSize = 1;
   for (int64_t dim : reductionDims)
     reductionSize *= bounds[dim];
@@ -1291,8 +1294,15 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   // First, do warp reductions along multiple subgroups.
   // Second, reduce results from multiple subgroups using single warp reduce.
   // The final warp reduce requires subgroup count <= subgroup size to work.
-  if ((groupSize / subgroupSize) > subgroupSize)
-    return failure();
+  // For very long rows (e.g., 64K elements with subgroup size 16 on Mali) cap
+  // the workgroup at subgroup size squared and let each thread loop over more
+  // elements instead of falling back to the default configuration.
+  if ((groupSize / subgroupSize) > subgroupSize) {
+    groupSize = GreatestCommonDivisor(
+                    APInt(64, uint64_t(groupSize)),
+                    APInt(64, uint64_t(subgroupSize * subgroupSize)))
+                    .getZExtValue();
+  }
 
   std::array<int64_t, 3> workgroupSize = {groupSize, 1, 1};
   // Tile all the parallel dimension to 1.
@@ -1319,12 +1329,25 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
     remaingGroupSize /= size.getSExtValue();
   }
 
+  // The shuffles of the subgroup reduction are generated for `subgroupSize`
+  // lanes. Require it when the target can run with different subgroup sizes
+  // (e.g. wave32 and wave64 on AMD RDNA) so that the driver doesn't pick
+  // another one.
+  std::optional<int64_t> requiredSubgroupSize;
+  std::optional<int> minSubgroupSize = limits.getMinSubgroupSize();
+  std::optional<int> maxSubgroupSize = limits.getMaxSubgroupSize();
+  if (minSubgroupSize && maxSubgroupSize &&
+      *minSubgroupSize != *maxSubgroupSize) {
+    requiredSubgroupSize = subgroupSize;
+  }
+
   TileSizesListType tileSizes;
   tileSizes.emplace_back(std::move(workgroupTileSizes)); // Workgroup level
   tileSizes.emplace_back(std::move(reductionTileSizes)); // reduction level
   if (failed(setOpConfigAndEntryPointFnTranslation(
           op->getParentOfType<func::FuncOp>(), op, tileSizes,
-          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize))) {
+          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize,
+          requiredSubgroupSize))) {
     return failure();
   }
 
@@ -1675,6 +1698,10 @@ static LogicalResult setSPIRVOpConfig(const spirv::TargetEnv &targetEnv,
     if (succeeded(detail::setAppleCodeGenConfig(targetEnv, rootOp)))
       return success();
     break;
+  case spirv::Vendor::Intel:
+    if (succeeded(detail::setIntelCodeGenConfig(targetEnv, rootOp)))
+      return success();
+    break;
   case spirv::Vendor::ARM:
     if (succeeded(detail::setMaliCodeGenConfig(targetEnv, rootOp)))
       return success();
@@ -581,9 +581,12 @@ void addSPIRVSubgroupReducePassPipeline(OpPassManager &pm) {
   nestedModulePM.addNestedPass<func::FuncOp>(createForOpCanonicalizationPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
 
+  // Use the subgroup size required by the configuration, if any, so that the
+  // shuffles match the subgroup size requested at pipeline creation.
   auto getWarpSize = [](func::FuncOp func) {
-    auto moduleOp = func->getParentOfType<ModuleOp>();
-    spirv::TargetEnvAttr target = getSPIRVTargetEnvAttr(moduleOp);
+    if (std::optional<int> subgroupSize = getSPIRVSubgroupSize(func))
+      return *subgroupSize;
+    spirv::TargetEnvAttr target = getSPIRVTargetEnvAttr(func);
     return target.getResourceLimits().getSubgroupSize();
   };
 
@@ -0,0 +1,60 @@
+// RUN: iree-opt --split-input-file \
+// RUN:   --pass-pipeline='builtin.module(hal.executable(hal.executable.variant(iree-spirv-select-lowering-strategy-pass)))' \
+// RUN:   %s | FileCheck %s
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable public @matmul_256x1024x128_f16_f32 {
+  hal.executable.variant @vulkan target(<"vulkan-spirv", "vulkan-spirv-fb", {
+    spirv.target_env = #spirv.target_env<
+      #spirv.vce<v1.6,
+      [Shader, Float16, StorageBuffer16BitAccess, StorageUniform16, CooperativeMatrixKHR],
+      [SPV_KHR_variable_pointers, SPV_KHR_cooperative_matrix]>, Intel:DiscreteGPU,
+      #spirv.resource_limits<
+        cooperative_matrix_properties_khr = [
+          #spirv.coop_matrix_props_khr<
+            a_type = f16, b_type = f16, c_type = f32, k_size = 16,
+            m_size = 8, n_size = 8, result_type = f32, acc_sat = false, scope = <Subgroup>>
+        ],
+        max_compute_shared_memory_size = 32768,
+        max_compute_workgroup_invocations = 1024,
+        max_compute_workgroup_size = [1024, 1024, 64],
+        subgroup_size = 32, min_subgroup_size = 8, max_subgroup_size = 32>
+       >}>) {
+    hal.executable.export public @matmul_256x1024x128_f16_f32 layout(#pipeline_layout)
+    builtin.module {
+      func.func @matmul_256x1024x128_f16_f32() {
+        %c0 = arith.constant 0 : index
+        %cst = arith.constant 0.000000e+00 : f32
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<256x128xf16>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<128x1024xf16>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<256x1024xf32>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [256, 128], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:tensor<256x128xf16>> -> tensor<256x128xf16>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [128, 1024], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:tensor<128x1024xf16>> -> tensor<128x1024xf16>
+        %5 = tensor.empty() : tensor<256x1024xf32>
+        %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<256x1024xf32>) -> tensor<256x1024xf32>
+        %7 = linalg.matmul ins(%3, %4 : tensor<256x128xf16>, tensor<128x1024xf16>) outs(%6 : tensor<256x1024xf32>) -> tensor<256x1024xf32>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [256, 1024], strides = [1, 1]
+            : tensor<256x1024xf32> -> !flow.dispatch.tensor<writeonly:tensor<256x1024xf32>>
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[$CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[64, 64], [32, 32], [0, 0, 32], [8, 8, 16]{{\]}}>
+//  CHECK-DAG: #[[$TRANSLATION:.+]] = #iree_codegen.translation_info<SPIRVCooperativeMatrixVectorize pipeline_depth = 1 store_stage = 0>
+//CHECK-LABEL: hal.executable.export public @matmul_256x1024x128_f16_f32
+// CHECK-SAME:   subgroup_size = 8 : index
+// CHECK-SAME:   translation_info = #[[$TRANSLATION]]
+// CHECK-SAME:   workgroup_size = [16 : index, 2 : index, 1 : index]
+//      CHECK: func.func @matmul_256x1024x128_f16_f32()
+//      CHECK:   linalg.matmul
+// CHECK-SAME:     lowering_config = #[[$CONFIG]]
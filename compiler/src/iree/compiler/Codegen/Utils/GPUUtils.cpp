@@ -792,6 +792,57 @@ std::optional<SmallVector<int64_t>> getMmaNativeVectorSize(Operation *op) {
       }
     }
 
+    // Loading I8 values from Shared Memory to Registers.
+    if (resultElementType.isInteger(8)) {
+      // Set mmaShapeK for I8 datatype mma.sync.s32.s8.s8.s32.m16n8k32.
+      mmaShapeK = 32;
+
+      // For matrixA.
+      if (*operandId == 0) {
+        SmallVector<int64_t> readShape;
+        readShape.append({mmaShapeM, mmaShapeK});
+        LLVM_DEBUG({
+          llvm::interleaveComma(readShape,
+                                DBGS() << "shape for vector.xfer_read: ");
+          llvm::dbgs() << "\n";
+        });
+        return readShape;
+      }
+      // For matrixB.
+      if (*operandId == 1) {
+        // ldmatrix can only transpose 16-bit elements, so matrixB is loaded
+        // in the shape of the extract strided slices feeding the mma.sync.
+        VectorType sliceType;
+        for (Operation *users : op->getUsers()) {
+          auto extract = dyn_cast<vector::ExtractStridedSliceOp>(users);
+          if (!extract)
+            return std::nullopt;
+          auto vecType = llvm::cast<VectorType>(extract.getResult().getType());
+          if (sliceType && sliceType != vecType)
+            return std::nullopt;
+          sliceType = vecType;
+        }
+        LLVM_DEBUG({
+          llvm::interleaveComma(sliceType.getShape(),
+                                DBGS() << "shape for vector.xfer_read: ");
+          llvm::dbgs() << "\n";
+        });
+        return llvm::to_vector(sliceType.getShape());
+      }
+    }
+
+    // Loading I32 accumulator values from Shared Memory to Registers.
+    if (resultElementType.isInteger(32) && *operandId == 2) {
+      SmallVector<int64_t> readShape;
+      readShape.append({mmaShapeM, mmaShapeN});
+      LLVM_DEBUG({
+        llvm::interleaveComma(readShape,
+                              DBGS() << "shape for vector.xfer_read: ");
+        llvm::dbgs() << "\n";
+      });
+      return readShape;
+    }
+
     // Loading F32 values from Shared Memory to Registers.
     if (resultElementType.isF32()) {
       // Set mmaShapeK for F32 datatype mma.sync.f32.tf32.m16n8k8.
@@ -638,6 +638,42 @@ struct LinalgBinaryGenericConversion
               }
               return std::nullopt;
             })
+            .Case([&](arith::MaximumFOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "max");
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::MaxSIOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "maxs");
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::MaxUIOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "maxu");
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::MinimumFOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "min");
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::MinSIOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "mins");
+              }
+              return std::nullopt;
+            })
+            .Case([&](arith::MinUIOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "minu");
+              }
+              return std::nullopt;
+            })
             .Case([&](arith::MulFOp op) -> std::optional<BinaryEmitter> {
               if (resultType.getIntOrFloatBitWidth() == 32) {
                 return configureGenericBinary(op, "mul");
@@ -668,6 +704,12 @@ struct LinalgBinaryGenericConversion
               }
               return std::nullopt;
             })
+            .Case([&](arith::ShRUIOp op) -> std::optional<BinaryEmitter> {
+              if (resultType.getIntOrFloatBitWidth() == 32) {
+                return configureGenericBinary(op, "shru");
+              }
+              return std::nullopt;
+            })
             .Case([&](arith::XOrIOp op) -> std::optional<BinaryEmitter> {
               if (resultType.getIntOrFloatBitWidth() == 32) {
                 return configureGenericBinary(op, "xor");
@@ -892,6 +934,8 @@ struct LinalgFillConversion : public OpRewritePattern<linalg::FillOp> {
     // Switch based on specialization.
     if (info.getRank() == 2 && info.outAnal.areInnerDimsContiguousRowMajor()) {
       return handle2DTile(info, rewriter);
+    } else if (info.getRank() <= 1 && hasUnitStride(info.outAnal.getType())) {
+      return handle1DTile(info, rewriter);
     }
 
     return rewriter.notifyMatchFailure(op, "unhandled fill variant");
@@ -915,6 +959,37 @@ struct LinalgFillConversion : public OpRewritePattern<linalg::FillOp> {
         info.op, info.scalar, outBuffer, outDesc.offset, stride, m, n);
     return success();
   }
+
+  // Returns true if |type| is a rank 0 or contiguous rank 1 memref.
+  static bool hasUnitStride(MemRefType type) {
+    if (type.getRank() == 0 || type.getLayout().isIdentity())
+      return true;
+    SmallVector<int64_t> strides;
+    int64_t offset;
+    if (failed(mlir::getStridesAndOffset(type, strides, offset)))
+      return false;
+    return strides[0] == 1;
+  }
+
+  // Fills a rank 0 or contiguous rank 1 buffer as a single row.
+  LogicalResult handle1DTile(OpInfo &info, PatternRewriter &rewriter) const {
+    Type scalarType = info.scalar.getType();
+    if (!scalarType.isIntOrFloat() ||
+        scalarType.getIntOrFloatBitWidth() != 32) {
+      return rewriter.notifyMatchFailure(info.op,
+                                         "handling only 32-bit scalar types");
+    }
+    auto loc = info.op.getLoc();
+    StridedBufferDescriptor &outDesc = info.outAnal.getDesc(rewriter);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value n = info.getRank() == 1 ? outDesc.sizes[0] : one;
+    Value outBuffer = outDesc.castToLinear(loc, rewriter);
+
+    rewriter.replaceOpWithNewOp<IREE::VMVX::Fill2DOp>(
+        info.op, info.scalar, outBuffer, outDesc.offset, /*stride=*/n,
+        /*m=*/one, n);
+    return success();
+  }
 };
 
 } // namespace
@@ -53,6 +53,15 @@ func.func @fill2d(%arg0 : memref<384x128xf32>, %arg1 : f32) {
   func.return
 }
 
+// CHECK-LABEL: @fill1d
+//   CHECK-DAG: %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG: %[[BB0:.*]], %[[OFFSET0:.*]], %[[SIZE0:.*]], %[[STRIDE0:.*]] = vmvx.get_buffer_descriptor %arg0
+//       CHECK: vmvx.fill2d scalar(%arg1 : i32) out(%[[BB0]] offset %[[OFFSET0]] row_stride %[[SIZE0]] : !util.buffer) sizes(%[[C1]], %[[SIZE0]])
+func.func @fill1d(%arg0 : memref<384xi32>, %arg1 : i32) {
+  linalg.fill ins(%arg1 : i32) outs(%arg0 : memref<384xi32>)
+  func.return
+}
+
 // CHECK-LABEL: @addf2d_rank_broadcast
 //   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
 //   CHECK-DAG: %[[BB0:.*]], %[[OFFSET0:.*]], %[[SIZES0:.*]]:2, %[[STRIDES0:.*]]:2 = vmvx.get_buffer_descriptor %arg0
@@ -194,6 +203,71 @@ func.func @shrsi(%arg0 : memref<64x64xi32>, %arg1 : memref<64xi32>) {
   func.return
 }
 
+// Now test all binary primitives just to make sure they convert.
+// CHECK-LABEL: @shrui
+// CHECK: vmvx.binary op("shru" : i32)
+func.func @shrui(%arg0 : memref<64x64xi32>, %arg1 : memref<64xi32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xi32>) outs(%arg0 : memref<64x64xi32>) {
+  ^bb0(%arg2: i32, %arg3: i32):
+    %12 = arith.shrui %arg2, %arg3 : i32
+    linalg.yield %12 : i32
+  }
+  func.return
+}
+
+// Now test all binary primitives just to make sure they convert.
+// CHECK-LABEL: @maximumf
+// CHECK: vmvx.binary op("max" : f32)
+func.func @maximumf(%arg0 : memref<64x64xf32>, %arg1 : memref<64xf32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xf32>) outs(%arg0 : memref<64x64xf32>) {
+  ^bb0(%arg2: f32, %arg3: f32):
+    %12 = arith.maximumf %arg2, %arg3 : f32
+    linalg.yield %12 : f32
+  }
+  func.return
+}
+
+// Now test all binary primitives just to make sure they convert.
+// CHECK-LABEL: @minimumf
+// CHECK: vmvx.binary op("min" : f32)
+func.func @minimumf(%arg0 : memref<64x64xf32>, %arg1 : memref<64xf32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xf32>) outs(%arg0 : memref<64x64xf32>) {
+  ^bb0(%arg2: f32, %arg3: f32):
+    %12 = arith.minimumf %arg2, %arg3 : f32
+    linalg.yield %12 : f32
+  }
+  func.return
+}
+
+// Now test all binary primitives just to make sure they convert.
+// CHECK-LABEL: @maxsi
+// CHECK: vmvx.binary op("maxs" : i32)
+func.func @maxsi(%arg0 : memref<64x64xi32>, %arg1 : memref<64xi32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xi32>) outs(%arg0 : memref<64x64xi32>) {
+  ^bb0(%arg2: i32, %arg3: i32):
+    %12 = arith.maxsi %arg2, %arg3 : i32
+    linalg.yield %12 : i32
+  }
+  func.return
+}
+
+// Now test all binary primitives just to make sure they convert.
+// CHECK-LABEL: @minui
+// CHECK: vmvx.binary op("minu" : i32)
+func.func @minui(%arg0 : memref<64x64xi32>, %arg1 : memref<64xi32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]}
+    ins(%arg1 : memref<64xi32>) outs(%arg0 : memref<64x64xi32>) {
+  ^bb0(%arg2: i32, %arg3: i32):
+    %12 = arith.minui %arg2, %arg3 : i32
+    linalg.yield %12 : i32
+  }
+  func.return
+}
+
 // Now test all binary primitives just to make sure they convert.
 // CHECK-LABEL: @xori
 // CHECK: vmvx.binary op("xor" : i32)
@@ -10,9 +10,14 @@
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Builders.h"
@@ -20,6 +25,7 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/Parser/Parser.h"
 
 #include <cstdlib>
 
@@ -43,6 +49,14 @@ static llvm::cl::opt<bool> clEnableDebug(
         "don't want to run a debug compiler)."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<std::string> clJitCacheDir(
+    "iree-consteval-jit-cache-dir",
+    llvm::cl::desc(
+        "Directory used to cache evaluated initializer results across "
+        "compilations. Results are keyed by the initializer IR, the JIT "
+        "target backend and the contents of all inputs."),
+    llvm::cl::init(""));
+
 namespace {
 
 static bool isDebugEnabled() {
@@ -160,6 +174,165 @@ struct JitFunctionDesc {
   std::string name;
   llvm::SmallVector<ArgumentBinding> argumentBindings;
   llvm::SmallVector<ResultBinding> resultBindings;
+  // Key of the function results in the result cache, if cacheable.
+  std::string cacheKey;
+};
+
+// Feeds everything written to the stream into a hasher so that large values
+// can be hashed without materializing them.
+class HashingOStream : public llvm::raw_ostream {
+public:
+  explicit HashingOStream(llvm::SHA256 &hasher) : hasher(hasher) {
+    SetUnbuffered();
+  }
+
+private:
+  void write_impl(const char *ptr, size_t size) override {
+    hasher.update(StringRef(ptr, size));
+    pos += size;
+  }
+  uint64_t current_pos() const override { return pos; }
+
+  llvm::SHA256 &hasher;
+  uint64_t pos = 0;
+};
+
+// On-disk cache of JIT function results keyed by everything that contributes
+// to them: the function IR, the JIT target and the argument values. Arguments
+// produced by other JIT functions are keyed by the producer key so that keys
+// can be computed prior to evaluating anything.
+class ResultCache {
+public:
+  ResultCache(StringRef cachePath, StringRef targetBackend)
+      : cachePath(cachePath), targetBackend(targetBackend) {}
+
+  // Assigns cache keys to all |jitFunctions| that are cacheable.
+  void assignKeys(ModuleOp targetModuleOp,
+                  llvm::SmallVector<JitFunctionDesc> &jitFunctions) {
+    SymbolTable symbolTable(targetModuleOp);
+    for (auto &jitFunction : jitFunctions) {
+      llvm::SHA256 hasher;
+      hasher.update("iree-consteval-jit-cache-v0");
+      hasher.update(targetBackend);
+      std::string funcStr;
+      llvm::raw_string_ostream funcStream(funcStr);
+      symbolTable.lookup(jitFunction.name)
+          ->print(funcStream, OpPrintingFlags().useLocalScope());
+      hasher.update(funcStream.str());
+      if (!hashArguments(jitFunction, hasher))
+        continue;
+      jitFunction.cacheKey = llvm::toHex(hasher.final(), /*LowerCase=*/true);
+      for (auto [i, resultBinding] :
+           llvm::enumerate(jitFunction.resultBindings)) {
+        producerKeys[resultBinding.getGlobalOp()] =
+            jitFunction.cacheKey + ":" + std::to_string(i);
+      }
+    }
+  }
+
+  // Loads the cached results of |jitFunction|, if present.
+  FailureOr<ArrayAttr> lookup(MLIRContext *context,
+                              const JitFunctionDesc &jitFunction) {
+    if (jitFunction.cacheKey.empty())
+      return failure();
+    auto path = getEntryPath(jitFunction.cacheKey);
+    if (!llvm::sys::fs::exists(path))
+      return failure();
+    auto moduleOp = parseSourceFile<ModuleOp>(path, context);
+    if (!moduleOp)
+      return failure();
+    auto resultsAttr =
+        (*moduleOp)->getAttrOfType<ArrayAttr>("iree.consteval.results");
+    if (!resultsAttr ||
+        resultsAttr.size() != jitFunction.resultBindings.size()) {
+      return failure();
+    }
+    return resultsAttr;
+  }
+
+  // Stores the evaluated results of |jitFunction|.
+  void store(MLIRContext *context, const JitFunctionDesc &jitFunction,
+             ArrayRef<Attribute> results) {
+    if (jitFunction.cacheKey.empty())
+      return;
+    if (auto ec = llvm::sys::fs::create_directories(cachePath)) {
+      emitWarning(jitFunction.loc)
+          << "unable to create consteval cache directory " << cachePath
+          << ": " << ec.message();
+      return;
+    }
+    OwningOpRef<ModuleOp> moduleOp = ModuleOp::create(UnknownLoc::get(context));
+    (*moduleOp)->setAttr("iree.consteval.results",
+                         ArrayAttr::get(context, results));
+    // writeToOutput renames a temporary file into place so concurrent
+    // compilations never observe partial entries.
+    auto path = getEntryPath(jitFunction.cacheKey);
+    auto error = llvm::writeToOutput(path, [&](raw_ostream &os) -> llvm::Error {
+      if (failed(writeBytecodeToFile(*moduleOp, os))) {
+        return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                       "failed to write bytecode");
+      }
+      return llvm::Error::success();
+    });
+    if (error) {
+      emitWarning(jitFunction.loc)
+          << "unable to write consteval cache entry " << path << ": "
+          << llvm::toString(std::move(error));
+    }
+  }
+
+private:
+  std::string getEntryPath(StringRef key) {
+    SmallString<256> path(cachePath);
+    llvm::sys::path::append(path, key + ".mlirbc");
+    return std::string(path.str());
+  }
+
+  // Returns false if any argument cannot be hashed.
+  bool hashArguments(JitFunctionDesc &jitFunction, llvm::SHA256 &hasher) {
+    for (auto &arg : jitFunction.argumentBindings) {
+      switch (arg.getType()) {
+      case ArgumentBinding::Type::ElementsAttr:
+        if (!hashAttr(arg.getElementsAttr(), hasher))
+          return false;
+        break;
+      case ArgumentBinding::Type::GlobalOp: {
+        auto globalOp = arg.getGlobalOp();
+        auto it = producerKeys.find(globalOp);
+        if (it != producerKeys.end()) {
+          hasher.update(it->second);
+        } else if (auto initialValue = globalOp.getInitialValueAttr()) {
+          if (!hashAttr(initialValue, hasher))
+            return false;
+        } else {
+          return false;
+        }
+      } break;
+      }
+    }
+    return true;
+  }
+
+  static bool hashAttr(Attribute attr, llvm::SHA256 &hasher) {
+    HashingOStream os(hasher);
+    if (!llvm::isa<ElementsAttr>(attr)) {
+      // Scalars are small enough to hash in their printed form.
+      attr.print(os);
+      return true;
+    }
+    auto serializableAttr =
+        llvm::dyn_cast<IREE::Util::SerializableAttrInterface>(attr);
+    if (!serializableAttr)
+      return false;
+    llvm::cast<ElementsAttr>(attr).getType().print(os);
+    return succeeded(serializableAttr.serializeToStream(
+        UnknownLoc::get(attr.getContext()), llvm::endianness::little, os));
+  }
+
+  std::string cachePath;
+  std::string targetBackend;
+  // Global -> key of the JIT function result stored into it.
+  llvm::DenseMap<Operation *, std::string> producerKeys;
 };
 
 class ProgramBuilder {
@@ -395,7 +568,8 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
   LogicalResult
   processFunctions(CompiledBinary &binary,
                    llvm::SmallVector<JitFunctionDesc> &jitFunctions,
-                   ModuleOp module, llvm::TimerGroup &tg) {
+                   ModuleOp module, ResultCache *resultCache,
+                   llvm::TimerGroup &tg) {
     // Process each function through the runtime.
     for (JitFunctionDesc &jitFunction : jitFunctions) {
       std::optional<llvm::Timer> invokeTimer;
@@ -438,6 +612,7 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       }
 
       // Process results.
+      SmallVector<Attribute> resultAttrs;
       for (auto it : llvm::enumerate(jitFunction.resultBindings)) {
         ResultBinding &resultBinding = it.value();
         switch (resultBinding.getType()) {
@@ -448,10 +623,14 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
                   resultBinding.getGlobalOp().getType(), attr)))
             return failure();
           resultBinding.getGlobalOp().setInitialValueAttr(attr);
+          resultAttrs.push_back(attr);
           break;
         }
         }
       }
+      if (resultCache) {
+        resultCache->store(module.getContext(), jitFunction, resultAttrs);
+      }
 
       if (debugEnabled) {
         invokeTimer->stopTimer();
@@ -515,8 +694,40 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
         dbgs() << "::: Rejected consteval initializer:\n" << initOp << "\n";
       }
     }
+
+    // Apply cached results. Functions that hit are dropped from the program
+    // so that if everything hits we skip compilation entirely. Cached results
+    // are applied in program order ahead of evaluation so that they are
+    // available as inputs to any function that missed.
+    std::optional<ResultCache> resultCache;
+    if (!clJitCacheDir.empty()) {
+      resultCache.emplace(clJitCacheDir, requestedTargetBackend);
+      auto &jitFunctions = programBuilder.getJitFunctions();
+      resultCache->assignKeys(programBuilder.getTargetModule(), jitFunctions);
+      SymbolTable targetSymbolTable(programBuilder.getTargetModule());
+      llvm::erase_if(jitFunctions, [&](JitFunctionDesc &jitFunction) {
+        auto resultsAttr = resultCache->lookup(&getContext(), jitFunction);
+        if (failed(resultsAttr))
+          return false;
+        for (auto [resultBinding, resultAttr] :
+             llvm::zip_equal(jitFunction.resultBindings, *resultsAttr)) {
+          resultBinding.getGlobalOp().setInitialValueAttr(
+              llvm::cast<TypedAttr>(resultAttr));
+        }
+        if (debugEnabled) {
+          dbgs() << "::: Using cached results for " << jitFunction.name
+                 << "\n";
+        }
+        targetSymbolTable.erase(targetSymbolTable.lookup(jitFunction.name));
+        return true;
+      });
+    }
+
     if (programBuilder.getJitFunctions().empty()) {
       programBuilder.getTargetModule()->erase();
+      for (auto deadOp : deadInitOps) {
+        deadOp.erase();
+      }
       return;
     }
 
@@ -544,8 +755,9 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     programBuilder.getTargetModule()->erase();
 
     // Process the functions.
-    if (failed(processFunctions(binary, programBuilder.getJitFunctions(),
-                                outerModule, tg))) {
+    if (failed(processFunctions(
+            binary, programBuilder.getJitFunctions(), outerModule,
+            resultCache ? &*resultCache : nullptr, tg))) {
       signalPassFailure();
       return;
     }
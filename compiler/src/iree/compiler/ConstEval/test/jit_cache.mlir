@@ -0,0 +1,55 @@
+// RUN: rm -rf %t
+// RUN: iree-opt --iree-consteval-jit-target-backend=vmvx --iree-consteval-jit-cache-dir=%t --iree-consteval-jit-globals %s | FileCheck %s
+// RUN: iree-opt --iree-consteval-jit-target-backend=vmvx --iree-consteval-jit-cache-dir=%t --iree-consteval-jit-debug --iree-consteval-jit-globals %s 2>&1 | FileCheck %s --check-prefix=CACHED
+
+// Tests that evaluated initializer results are cached and that a subsequent
+// compilation of the same program uses them without compiling the JIT program.
+
+// CHECK-LABEL: @cached
+// CHECK: util.global private @hoisted = dense<4.000000e+04> : tensor<5x6xf32>
+// CHECK: util.global private @dependent = dense<8.000000e+04> : tensor<5x6xf32>
+// CHECK-NOT: util.initializer
+
+// CACHED: Using cached results for jit_eval
+// CACHED: Using cached results for jit_eval
+// CACHED-NOT: COMPILING JIT
+// CACHED: util.global private @hoisted = dense<4.000000e+04> : tensor<5x6xf32>
+// CACHED: util.global private @dependent = dense<8.000000e+04> : tensor<5x6xf32>
+#map0 = affine_map<(d0, d1) -> ()>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module @cached {
+  util.global private @hoisted : tensor<5x6xf32>
+  util.global private @dependent : tensor<5x6xf32>
+  func.func @main() -> (tensor<5x6xf32>, tensor<5x6xf32>) {
+    %hoisted = util.global.load @hoisted : tensor<5x6xf32>
+    %dependent = util.global.load @dependent : tensor<5x6xf32>
+    return %hoisted, %dependent : tensor<5x6xf32>, tensor<5x6xf32>
+  }
+  util.initializer attributes {iree.compiler.consteval} {
+    %cst = arith.constant dense<2.0e+02> : tensor<f32>
+    %0 = tensor.empty() : tensor<5x6xf32>
+    %1 = linalg.generic {indexing_maps = [#map0, #map1], iterator_types = ["parallel", "parallel"]} ins(%cst : tensor<f32>) outs(%0 : tensor<5x6xf32>) {
+    ^bb0(%arg0: f32, %arg1: f32):
+      linalg.yield %arg0 : f32
+    } -> tensor<5x6xf32>
+    %2 = tensor.empty() : tensor<5x6xf32>
+    %3 = linalg.generic {indexing_maps = [#map1, #map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%1, %1 : tensor<5x6xf32>, tensor<5x6xf32>) outs(%2 : tensor<5x6xf32>) {
+    ^bb0(%arg0: f32, %arg1: f32, %arg2: f32):
+      %4 = arith.mulf %arg0, %arg1 : f32
+      linalg.yield %4 : f32
+    } -> tensor<5x6xf32>
+    util.global.store %3, @hoisted : tensor<5x6xf32>
+    util.initializer.return
+  }
+  util.initializer attributes {iree.compiler.consteval} {
+    %hoisted = util.global.load @hoisted : tensor<5x6xf32>
+    %0 = tensor.empty() : tensor<5x6xf32>
+    %1 = linalg.generic {indexing_maps = [#map1, #map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%hoisted, %hoisted : tensor<5x6xf32>, tensor<5x6xf32>) outs(%0 : tensor<5x6xf32>) {
+    ^bb0(%arg0: f32, %arg1: f32, %arg2: f32):
+      %2 = arith.addf %arg0, %arg1 : f32
+      linalg.yield %2 : f32
+    } -> tensor<5x6xf32>
+    util.global.store %1, @dependent : tensor<5x6xf32>
+    util.initializer.return
+  }
+}
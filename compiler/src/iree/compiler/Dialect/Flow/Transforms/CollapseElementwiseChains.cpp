@@ -0,0 +1,217 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--- CollapseElementwiseChains.cpp - Rank-1 elementwise chains --------===//
+//
+// Collapses chains of elementwise operations over logically identical data to
+// rank-1 before dispatch formation. `CollapseDimensions` only collapses
+// dispatches with a single root op after they are formed, which leaves
+// reshapes between the ops of a chain that block fusion and force
+// non-contiguous accesses. Collapsing every op of a chain at the function level
+// makes the `tensor.expand_shape`/`tensor.collapse_shape` pairs between them
+// cancel out so that the whole chain ends up in a single rank-1 dispatch.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/MemRef/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Transforms/Transforms.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Interfaces/TilingInterface.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#define DEBUG_TYPE "iree-flow-collapse-elementwise-chains"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+struct CollapseElementwiseChainsPass
+    : public CollapseElementwiseChainsBase<CollapseElementwiseChainsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<affine::AffineDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override;
+};
+
+} // namespace
+
+/// Returns true if `op` is an elementwise `linalg.generic` whose iteration
+/// space is or can be collapsed to a single dimension: all loops are parallel,
+/// all shapes are static and every operand is accessed with an identity map (or
+/// is a broadcasted scalar).
+static bool isCollapsibleElementwiseOp(Operation *op) {
+  auto genericOp = dyn_cast_or_null<linalg::GenericOp>(op);
+  if (!genericOp || !isNonNullAndOutsideDispatch(op))
+    return false;
+  if (genericOp.getNumLoops() == 0 ||
+      genericOp.getNumParallelLoops() != genericOp.getNumLoops()) {
+    return false;
+  }
+  // Like in `CollapseDimensions`, dynamic shapes cannot be expanded back and
+  // index semantics would need to be delinearized.
+  if (genericOp.hasDynamicShape() || genericOp.hasIndexSemantics())
+    return false;
+  return llvm::all_of(genericOp.getIndexingMapsArray(), [](AffineMap map) {
+    return map.isIdentity() || map.getNumResults() == 0;
+  });
+}
+
+static bool isReshapeOp(Operation *op) {
+  return isa<tensor::CollapseShapeOp, tensor::ExpandShapeOp>(op);
+}
+
+/// Returns true if `op` is a compute op that must not see its operands or
+/// results reshaped, e.g. because it would no longer fuse with them.
+static bool isBlockingComputeOp(Operation *op) {
+  return isa<linalg::LinalgOp, TilingInterface>(op) &&
+         !isCollapsibleElementwiseOp(op);
+}
+
+/// Appends to `neighbors` the elementwise ops producing the operands of or
+/// consuming the results of `op`, looking through reshapes. Returns false if
+/// `op` is connected to any other compute op.
+static bool getChainNeighbors(Operation *op,
+                              SmallVectorImpl<Operation *> &neighbors) {
+  for (Value operand : op->getOperands()) {
+    Operation *producer = operand.getDefiningOp();
+    while (producer && isReshapeOp(producer)) {
+      producer = producer->getOperand(0).getDefiningOp();
+    }
+    if (!producer)
+      continue;
+    if (isBlockingComputeOp(producer))
+      return false;
+    if (isCollapsibleElementwiseOp(producer))
+      neighbors.push_back(producer);
+  }
+
+  SmallVector<Operation *> worklist(op->getUsers());
+  while (!worklist.empty()) {
+    Operation *user = worklist.pop_back_val();
+    if (isReshapeOp(user)) {
+      worklist.append(user->getUsers().begin(), user->getUsers().end());
+      continue;
+    }
+    if (isBlockingComputeOp(user))
+      return false;
+    if (isCollapsibleElementwiseOp(user))
+      neighbors.push_back(user);
+  }
+  return true;
+}
+
+/// Finds the chains of elementwise ops connected directly or through reshapes.
+/// A chain is only collapsed as a whole: collapsing some of its ops would leave
+/// reshapes between ops of the chain, and collapsing ops connected to other
+/// compute ops would prevent their fusion. Single elementwise ops are left to
+/// `CollapseDimensions` once they are in their own dispatch.
+static SmallVector<linalg::GenericOp>
+getCollapsibleChainOps(mlir::FunctionOpInterface funcOp) {
+  SmallVector<linalg::GenericOp> chainOps;
+  llvm::SmallPtrSet<Operation *, 16> visited;
+  funcOp.walk([&](linalg::GenericOp root) {
+    if (visited.count(root) || !isCollapsibleElementwiseOp(root))
+      return;
+    SetVector<Operation *> chain;
+    chain.insert(root);
+    visited.insert(root);
+    bool isBlocked = false;
+    for (unsigned i = 0; i < chain.size(); ++i) {
+      SmallVector<Operation *> neighbors;
+      if (!getChainNeighbors(chain[i], neighbors))
+        isBlocked = true;
+      for (Operation *neighbor : neighbors) {
+        if (chain.insert(neighbor))
+          visited.insert(neighbor);
+      }
+    }
+    if (isBlocked || chain.size() < 2)
+      return;
+    for (Operation *op : chain) {
+      chainOps.push_back(cast<linalg::GenericOp>(op));
+    }
+  });
+  return chainOps;
+}
+
+void CollapseElementwiseChainsPass::runOnOperation() {
+  mlir::FunctionOpInterface funcOp = getOperation();
+  MLIRContext *context = &getContext();
+
+  // Decide on all the ops to collapse before modifying any of them, collapsing
+  // an op introduces reshapes around it that its neighbors look through.
+  SmallVector<linalg::GenericOp> chainOps = getCollapsibleChainOps(funcOp);
+  if (chainOps.empty())
+    return;
+
+  IRRewriter rewriter(context);
+  for (linalg::GenericOp genericOp : chainOps) {
+    if (genericOp.getNumLoops() == 1)
+      continue;
+    ReassociationIndices allLoops =
+        llvm::to_vector(llvm::seq<int64_t>(0, genericOp.getNumLoops()));
+    rewriter.setInsertionPoint(genericOp);
+    FailureOr<SmallVector<Value>> maybeReplacements =
+        mlir::linalg::collapseOpIterationDims(genericOp, {allLoops}, rewriter);
+    if (failed(maybeReplacements))
+      continue;
+    rewriter.replaceOp(genericOp, maybeReplacements.value());
+  }
+
+  LLVM_DEBUG({
+    llvm::dbgs() << "\n--- After collapsing elementwise ops ---\n";
+    funcOp->print(llvm::dbgs(), OpPrintingFlags().useLocalScope());
+    llvm::dbgs() << "\n\n";
+  });
+
+  // Cancel out the reshapes between the collapsed ops and fuse the rank-1
+  // producers with their single consumers.
+  RewritePatternSet patterns(context);
+  linalg::ControlFusionFn fuseElementwiseOpsControlFn =
+      [](OpOperand *fusedOperand) {
+        Operation *producer = fusedOperand->get().getDefiningOp();
+        Operation *consumer = fusedOperand->getOwner();
+        return isNonNullAndOutsideDispatch({producer, consumer}) &&
+               producer->hasOneUse();
+      };
+  linalg::populateElementwiseOpsFusionPatterns(patterns,
+                                               fuseElementwiseOpsControlFn);
+  tensor::CollapseShapeOp::getCanonicalizationPatterns(patterns, context);
+  tensor::ExpandShapeOp::getCanonicalizationPatterns(patterns, context);
+  tensor::populateFoldTensorEmptyPatterns(patterns);
+  linalg::GenericOp::getCanonicalizationPatterns(patterns, context);
+  memref::populateResolveRankedShapedTypeResultDimsPatterns(patterns);
+  if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+    funcOp->emitError("failed to fold reshapes between collapsed ops");
+    return signalPassFailure();
+  }
+}
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createCollapseElementwiseChainsPass() {
+  return std::make_unique<CollapseElementwiseChainsPass>();
+}
+
+} // namespace Flow
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
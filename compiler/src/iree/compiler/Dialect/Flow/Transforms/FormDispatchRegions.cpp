@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/Flow/IR/FlowDialect.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/Flow/Transforms/ConvertRegionToWorkgroups.h"
+#include "iree/compiler/Dialect/Flow/Transforms/FusionCostModel.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
@@ -168,6 +169,18 @@ static bool isInFusionGroup(Operation *op, unsigned targetGroup) {
   return false;
 }
 /// Removes the fusion groups attribute.
+/// Returns the ops of the fusion group of which `root` is the root, starting
+/// with `root`.
+static SmallVector<Operation *> getFusionGroupOps(Operation *root) {
+  SmallVector<Operation *> ops = {root};
+  int64_t rootNumber = getRootNumber(root);
+  for (Operation &op : *root->getBlock()) {
+    if (&op != root && isInFusionGroup(&op, rootNumber))
+      ops.push_back(&op);
+  }
+  return ops;
+}
+
 static void removeFusionGroupsAttribute(Operation *op) {
   op->removeAttr(kFusionGroupsAttr);
 }
@@ -256,6 +269,26 @@ static bool isPadUsedInSetEncoding(tensor::PadOp padOp) {
   });
 }
 
+/// Returns true if |operand| is the LHS of a contraction produced by a
+/// `set_encoding` op. Fusing it into the contraction dispatch lets backends
+/// pack the LHS tile by tile right before it is consumed instead of writing
+/// the packed tensor to memory and reading it back in a separate dispatch.
+/// The RHS is excluded as it is usually a constant that gets hoisted.
+static bool isFusableLhsSetEncoding(OpOperand &operand) {
+  auto setEncodingOp =
+      operand.get().getDefiningOp<IREE::LinalgExt::SetEncodingOp>();
+  auto linalgOp = dyn_cast<linalg::LinalgOp>(operand.getOwner());
+  if (!setEncodingOp || !linalgOp || !linalgOp.isDpsInput(&operand) ||
+      !linalg::isaContractionOpInterface(linalgOp)) {
+    return false;
+  }
+  auto encoding = setEncodingOp.getResultType()
+                      .getEncoding()
+                      .dyn_cast_or_null<IREE::LinalgExt::EncodingAttr>();
+  return encoding &&
+         encoding.getRole().getValue() == IREE::LinalgExt::EncodingRole::LHS;
+}
+
 //===----------------------------------------------------------------------===//
 // Heuristics for fusing dispatchble ops with root ops using tile + fuse.
 //===----------------------------------------------------------------------===//
@@ -567,11 +600,13 @@ isFusableWithConsumer(OpOperand &fusedOperand,
 }
 
 /// Fuses roots with its consumers. If a root is fused with its consumer, it is
-/// no more tagged as a root to aid with the dispatch region formation.
+/// no more tagged as a root to aid with the dispatch region formation. If
+/// `costModel` is set, only fusions it deems profitable are done.
 static void fuseRootsWithConsumers(MLIRContext *context,
                                    ArrayRef<Operation *> roots,
                                    DominanceInfo const &dominanceInfo,
-                                   FormDispatchRegionsOptions const &options) {
+                                   FormDispatchRegionsOptions const &options,
+                                   FusionCostModel *costModel) {
   // Fuse with consumers where possible.
   for (Operation *root : roots) {
     SmallVector<Operation *> workList;
@@ -605,6 +640,10 @@ static void fuseRootsWithConsumers(MLIRContext *context,
 
       if (isFusableWithConsumer(*(fusableUse.value()), rootOuterParallelLoops,
                                 options)) {
+        if (costModel &&
+            !costModel->shouldFuse(consumerOp, getFusionGroupOps(currRoot))) {
+          continue;
+        }
         updateRootTo(consumerOp);
         workList.push_back(consumerOp);
       }
@@ -621,8 +660,10 @@ isFusableWithProducer(OpOperand &operand,
   Operation *consumer = operand.getOwner();
 
   if (auto padOp = dyn_cast<tensor::PadOp>(consumer)) {
+    // Roots form their own dispatches and are not pulled into those of other
+    // roots (such as a contraction whose LHS set_encoding was fused).
     if (options.fusePadWithProducers || isPadUsedInSetEncoding(padOp)) {
-      return isa<linalg::LinalgOp>(producer);
+      return isa<linalg::LinalgOp>(producer) && !isRootOp(producer);
     }
     return false;
   }
@@ -632,6 +673,11 @@ isFusableWithProducer(OpOperand &operand,
     return true;
   }
 
+  if (options.fuseEncodingWithConsumers &&
+      isa<IREE::LinalgExt::SetEncodingOp>(producer)) {
+    return isFusableLhsSetEncoding(operand);
+  }
+
   if (isPackLikeOp(consumer)) {
     if (auto linalgProducerOp = dyn_cast<linalg::LinalgOp>(producer)) {
       if (auto packOp = dyn_cast<tensor::PackOp>(consumer)) {
@@ -661,13 +707,16 @@ isFusableWithProducer(OpOperand &operand,
 }
 
 /// Starting from the `root` op, traverse the operand use-def chain
-/// in reverse to fuse with producers.
+/// in reverse to fuse with producers. If `costModel` is set, only fusions it
+/// deems profitable are done.
 static void fuseRootsWithProducers(MLIRContext *context, Operation *root,
                                    unsigned groupNum,
                                    DominanceInfo const &dominanceInfo,
-                                   FormDispatchRegionsOptions const &options) {
+                                   FormDispatchRegionsOptions const &options,
+                                   FusionCostModel *costModel) {
   SmallVector<Operation *> worklist;
   worklist.push_back(root);
+  SmallVector<Operation *> group = {root};
   llvm::SmallBitVector rootOuterParallelLoops = getOuterParallelLoops(root);
   while (!worklist.empty()) {
     Operation *candidate = worklist.pop_back_val();
@@ -689,7 +738,12 @@ static void fuseRootsWithProducers(MLIRContext *context, Operation *root,
         continue;
       }
 
+      if (costModel && !costModel->shouldFuse(producer, group)) {
+        continue;
+      }
+
       appendToFusionGroup(producer, groupNum);
+      group.push_back(producer);
       worklist.push_back(producer);
     }
   }
@@ -706,7 +760,7 @@ static void fuseRootsWithProducers(MLIRContext *context, Operation *root,
 static unsigned
 decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
                        FormDispatchRegionsOptions const &options,
-                       unsigned numRootOps = 0) {
+                       FusionCostModel *costModel, unsigned numRootOps = 0) {
   MLIRContext *context = region.getContext();
   OpBuilder builder(context);
   for (Block &block : region) {
@@ -720,7 +774,7 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
       if (isa<scf::SCFDialect>(op.getDialect())) {
         for (auto &region : op.getRegions()) {
           numRootOps = decideFusableLinalgOps(region, dominanceInfo, options,
-                                              numRootOps);
+                                              costModel, numRootOps);
         }
         continue;
       }
@@ -731,11 +785,12 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
       unsigned newGroup = numRootOps++;
       setRootAttribute(context, &op, newGroup);
 
-      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options);
+      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options,
+                             costModel);
       roots.push_back(&op);
     }
     roots = llvm::to_vector(llvm::reverse(roots));
-    fuseRootsWithConsumers(context, roots, dominanceInfo, options);
+    fuseRootsWithConsumers(context, roots, dominanceInfo, options, costModel);
   }
 
   // Once all root linalg ops have been tagged, put all remaining generic ops
@@ -758,11 +813,12 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
       unsigned newGroup = numRootOps++;
       setRootAttribute(context, &op, newGroup);
 
-      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options);
+      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options,
+                             costModel);
       roots.push_back(&op);
     }
     roots = llvm::to_vector(llvm::reverse(roots));
-    fuseRootsWithConsumers(context, roots, dominanceInfo, options);
+    fuseRootsWithConsumers(context, roots, dominanceInfo, options, costModel);
   }
 
   return numRootOps;
@@ -777,11 +833,12 @@ static LogicalResult
 createFusionGroups(TensorDimTrackingRewriter &rewriter,
                    FunctionOpInterface funcOp,
                    DominanceInfo const &dominanceInfo,
-                   FormDispatchRegionsOptions const &options) {
+                   FormDispatchRegionsOptions const &options,
+                   FusionCostModel *costModel) {
   // Step 1: Decide fusion groups (heuristic). This marks rootOps with an
   // attribute
-  unsigned numRoots =
-      decideFusableLinalgOps(funcOp.getFunctionBody(), dominanceInfo, options);
+  unsigned numRoots = decideFusableLinalgOps(
+      funcOp.getFunctionBody(), dominanceInfo, options, costModel);
   SmallVector<Operation *> roots(numRoots, nullptr);
   DenseMap<unsigned, SmallVector<Operation *>> producers;
 
@@ -890,11 +947,16 @@ struct FormDispatchRegionsPass
     generateWorkloadRegion = options.generateWorkloadRegion;
     fusePadWithConsumers = options.fusePadWithConsumers;
     fusePadWithProducers = options.fusePadWithProducers;
+    fuseEncodingWithConsumers = options.fuseEncodingWithConsumers;
+    fusionCostModel = options.fusionCostModel;
+    dumpFusionGraph = options.dumpFusionGraph;
   }
   FormDispatchRegionsPass(const FormDispatchRegionsPass &other)
       : FormDispatchRegionsPass(FormDispatchRegionsOptions{
             other.fuseMultiUse, other.generateWorkloadRegion,
-            other.fusePadWithConsumers, other.fusePadWithProducers}) {}
+            other.fusePadWithConsumers, other.fusePadWithProducers,
+            other.fuseEncodingWithConsumers, other.fusionCostModel,
+            other.dumpFusionGraph}) {}
 
   void runOnOperation() override;
 };
@@ -905,13 +967,28 @@ void FormDispatchRegionsPass::runOnOperation() {
   mlir::FunctionOpInterface funcOp = getOperation();
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
-  FormDispatchRegionsOptions options{fuseMultiUse, generateWorkloadRegion,
-                                     fusePadWithConsumers,
-                                     fusePadWithProducers};
-  if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
+  FormDispatchRegionsOptions options{
+      fuseMultiUse,         generateWorkloadRegion,    fusePadWithConsumers,
+      fusePadWithProducers, fuseEncodingWithConsumers, fusionCostModel,
+      dumpFusionGraph};
+  std::unique_ptr<FusionCostModel> costModel;
+  if (!options.fusionCostModel.empty()) {
+    costModel = createFusionCostModel(options.fusionCostModel,
+                                      funcOp->getParentOfType<ModuleOp>());
+    if (!costModel) {
+      funcOp->emitOpError("unknown fusion cost model '")
+          << options.fusionCostModel << "'";
+      return signalPassFailure();
+    }
+  }
+  if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options,
+                                costModel.get()))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
   }
+  if (costModel && options.dumpFusionGraph) {
+    costModel->printDecisionsAsDot(llvm::errs());
+  }
 }
 
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
@@ -0,0 +1,274 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Flow/Transforms/FusionCostModel.h"
+
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BuiltinTypes.h"
+
+#define DEBUG_TYPE "iree-flow-fusion-cost-model"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+//===----------------------------------------------------------------------===//
+// Cost estimation
+//===----------------------------------------------------------------------===//
+
+/// Returns the size in bytes of `type` if it is a ranked tensor, treating
+/// dynamic dims as 1.
+static int64_t getTensorSizeInBytes(Type type, bool &hasDynamicShapes) {
+  auto tensorType = dyn_cast<RankedTensorType>(type);
+  if (!tensorType || !tensorType.getElementType().isIntOrFloat())
+    return 0;
+  int64_t numElements = 1;
+  for (int64_t dim : tensorType.getShape()) {
+    if (ShapedType::isDynamic(dim)) {
+      hasDynamicShapes = true;
+      continue;
+    }
+    numElements *= dim;
+  }
+  int64_t bitWidth = tensorType.getElementType().getIntOrFloatBitWidth();
+  return llvm::divideCeil(numElements * bitWidth, 8);
+}
+
+/// Returns the number of scalar arithmetic operations performed by `op`.
+static int64_t getNumArithmeticOps(Operation *op, bool &hasDynamicShapes) {
+  auto linalgOp = dyn_cast<linalg::LinalgOp>(op);
+  if (!linalgOp)
+    return 0;
+  int64_t numIterations = 1;
+  for (int64_t range : linalgOp.getStaticLoopRanges()) {
+    if (ShapedType::isDynamic(range)) {
+      hasDynamicShapes = true;
+      continue;
+    }
+    numIterations *= range;
+  }
+  int64_t numPayloadOps = 0;
+  if (Block *body = linalgOp.getBlock()) {
+    numPayloadOps = llvm::range_size(body->without_terminator());
+  }
+  return numIterations * std::max<int64_t>(numPayloadOps, 1);
+}
+
+DispatchCost estimateDispatchCost(ArrayRef<Operation *> ops) {
+  DispatchCost cost;
+  llvm::SmallPtrSet<Operation *, 8> inGroup(ops.begin(), ops.end());
+  llvm::SetVector<Value> externalTensors;
+  for (Operation *op : ops) {
+    cost.ops += getNumArithmeticOps(op, cost.hasDynamicShapes);
+    for (Value operand : op->getOperands()) {
+      if (!isa<RankedTensorType>(operand.getType()))
+        continue;
+      Operation *definingOp = operand.getDefiningOp();
+      if (definingOp && inGroup.contains(definingOp))
+        continue;
+      // `tensor.empty` and splat constants do not move any data.
+      if (definingOp && (isa<tensor::EmptyOp>(definingOp) ||
+                         definingOp->hasTrait<OpTrait::ConstantLike>())) {
+        continue;
+      }
+      externalTensors.insert(operand);
+    }
+    for (Value result : op->getResults()) {
+      if (!isa<RankedTensorType>(result.getType()))
+        continue;
+      bool usedOutside =
+          result.use_empty() || llvm::any_of(result.getUsers(), [&](auto *u) {
+            return !inGroup.contains(u);
+          });
+      if (usedOutside)
+        externalTensors.insert(result);
+    }
+  }
+  for (Value tensor : externalTensors) {
+    cost.bytes += getTensorSizeInBytes(tensor.getType(), cost.hasDynamicShapes);
+  }
+  cost.numLiveTensors = externalTensors.size();
+  return cost;
+}
+
+//===----------------------------------------------------------------------===//
+// FusionCostModel
+//===----------------------------------------------------------------------===//
+
+bool FusionCostModel::shouldFuse(Operation *candidate,
+                                 ArrayRef<Operation *> group) {
+  DispatchCost groupCost = estimateDispatchCost(group);
+  DispatchCost candidateCost = estimateDispatchCost(candidate);
+  SmallVector<Operation *> fusedGroup(group.begin(), group.end());
+  fusedGroup.push_back(candidate);
+  DispatchCost fusedCost = estimateDispatchCost(fusedGroup);
+
+  DispatchCost separateCost;
+  separateCost.bytes = groupCost.bytes + candidateCost.bytes;
+  separateCost.ops = groupCost.ops + candidateCost.ops;
+  separateCost.numLiveTensors =
+      std::max(groupCost.numLiveTensors, candidateCost.numLiveTensors);
+  separateCost.hasDynamicShapes =
+      groupCost.hasDynamicShapes || candidateCost.hasDynamicShapes;
+  double separateCycles =
+      estimateCycles(groupCost) + estimateCycles(candidateCost);
+  double fusedCycles = estimateCycles(fusedCost);
+
+  bool fuse =
+      isProfitable(separateCost, separateCycles, fusedCost, fusedCycles);
+  LLVM_DEBUG({
+    llvm::dbgs() << getName() << ": " << (fuse ? "fuse " : "do not fuse ")
+                 << candidate->getName() << " into dispatch rooted at "
+                 << group.front()->getName() << " (" << separateCycles
+                 << " vs. " << fusedCycles << " cycles)\n";
+  });
+  decisions.push_back(Decision{candidate, group.front(), separateCost,
+                               fusedCost, separateCycles, fusedCycles, fuse});
+  return fuse;
+}
+
+void FusionCostModel::printDecisionsAsDot(raw_ostream &os) const {
+  DenseMap<Operation *, int64_t> nodeIds;
+  auto getNodeId = [&](Operation *op) {
+    auto [it, inserted] = nodeIds.try_emplace(op, nodeIds.size());
+    if (inserted) {
+      DispatchCost cost = estimateDispatchCost(op);
+      os << "  v" << it->second << " [shape=box, label=\"" << op->getName()
+         << "\\nbytes: " << cost.bytes << "\\nops: " << cost.ops << "\"];\n";
+    }
+    return it->second;
+  };
+  os << "digraph \"" << getName() << "\" {\n";
+  for (const Decision &decision : decisions) {
+    int64_t from = getNodeId(decision.candidate);
+    int64_t to = getNodeId(decision.root);
+    os << "  v" << from << " -> v" << to << " [color="
+       << (decision.fuse ? "green" : "red") << ", label=\""
+       << llvm::format("%.0f", decision.separateCycles) << " -> "
+       << llvm::format("%.0f", decision.fusedCycles)
+       << " cycles\\nbytes: " << decision.separateCost.bytes << " -> "
+       << decision.fusedCost.bytes
+       << "\\nlive tensors: " << decision.fusedCost.numLiveTensors << "\"];\n";
+  }
+  os << "}\n";
+}
+
+//===----------------------------------------------------------------------===//
+// Roofline cost model
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Coarse description of the memory hierarchy and compute throughput of a
+/// class of targets.
+struct RooflineParams {
+  /// Sustained memory bandwidth.
+  double bytesPerCycle;
+  /// Sustained arithmetic throughput.
+  double opsPerCycle;
+  /// Fixed cost of a dispatch (launch, synchronization).
+  double dispatchOverheadCycles;
+  /// Maximum number of tensors a dispatch can stream concurrently before
+  /// spilling registers or thrashing the closest cache.
+  int64_t maxLiveTensors;
+};
+
+static const RooflineParams kCPURooflineParams = {
+    /*bytesPerCycle=*/16.0, /*opsPerCycle=*/32.0,
+    /*dispatchOverheadCycles=*/2000.0, /*maxLiveTensors=*/16};
+
+static const RooflineParams kGPURooflineParams = {
+    /*bytesPerCycle=*/256.0, /*opsPerCycle=*/4096.0,
+    /*dispatchOverheadCycles=*/5000.0, /*maxLiveTensors=*/32};
+
+static bool isGPUBackend(StringRef backend) {
+  return backend == "cuda" || backend == "rocm" || backend.ends_with("spirv");
+}
+
+/// Estimates the time of a dispatch as the max of its memory time and compute
+/// time, plus a fixed overhead. Fusion is profitable if it does not increase
+/// the estimated time and the fused dispatch does not stream more tensors
+/// than the target can keep close.
+class RooflineFusionCostModel : public FusionCostModel {
+public:
+  explicit RooflineFusionCostModel(RooflineParams params) : params(params) {}
+
+  StringRef getName() const override { return "roofline"; }
+
+protected:
+  double estimateCycles(const DispatchCost &cost) const override {
+    double memoryCycles = cost.bytes / params.bytesPerCycle;
+    double computeCycles = cost.ops / params.opsPerCycle;
+    return std::max(memoryCycles, computeCycles) +
+           params.dispatchOverheadCycles;
+  }
+
+  bool isProfitable(const DispatchCost &separateCost, double separateCycles,
+                    const DispatchCost &fusedCost,
+                    double fusedCycles) const override {
+    // Without static shapes the estimates are meaningless; keep the default
+    // heuristics.
+    if (separateCost.hasDynamicShapes || fusedCost.hasDynamicShapes)
+      return true;
+    if (fusedCost.numLiveTensors > params.maxLiveTensors)
+      return false;
+    return fusedCycles <= separateCycles;
+  }
+
+private:
+  RooflineParams params;
+};
+
+} // namespace
+
+static std::unique_ptr<FusionCostModel>
+createRooflineFusionCostModel(ModuleOp moduleOp) {
+  SmallVector<IREE::HAL::ExecutableTargetAttr> targets =
+      IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(moduleOp);
+  // Use the GPU parameters only if all targets are GPUs, the CPU parameters
+  // are the more conservative ones.
+  bool allGPU = !targets.empty() && llvm::all_of(targets, [](auto target) {
+    return isGPUBackend(target.getBackend().getValue());
+  });
+  return std::make_unique<RooflineFusionCostModel>(
+      allGPU ? kGPURooflineParams : kCPURooflineParams);
+}
+
+//===----------------------------------------------------------------------===//
+// Registry
+//===----------------------------------------------------------------------===//
+
+static llvm::StringMap<FusionCostModelFactory> &getFusionCostModelRegistry() {
+  static llvm::StringMap<FusionCostModelFactory> registry = {
+      {"roofline", createRooflineFusionCostModel},
+  };
+  return registry;
+}
+
+void registerFusionCostModel(StringRef name, FusionCostModelFactory factory) {
+  getFusionCostModelRegistry()[name] = std::move(factory);
+}
+
+std::unique_ptr<FusionCostModel> createFusionCostModel(StringRef name,
+                                                       ModuleOp moduleOp) {
+  auto &registry = getFusionCostModelRegistry();
+  auto it = registry.find(name);
+  if (it == registry.end())
+    return nullptr;
+  return it->second(moduleOp);
+}
+
+} // namespace Flow
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -0,0 +1,103 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_FUSIONCOSTMODEL_H_
+#define IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_FUSIONCOSTMODEL_H_
+
+#include <functional>
+#include <memory>
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Operation.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+/// Estimated cost of executing a group of ops as a single dispatch.
+struct DispatchCost {
+  /// Bytes read from and written to memory by the dispatch.
+  int64_t bytes = 0;
+  /// Scalar arithmetic operations performed by the dispatch.
+  int64_t ops = 0;
+  /// Number of distinct tensors read or written by the dispatch. Each of them
+  /// is streamed through the memory hierarchy concurrently, so this is a proxy
+  /// for register and cache pressure.
+  int64_t numLiveTensors = 0;
+  /// Set if some shape was dynamic, in which case `bytes` and `ops` are only
+  /// lower bounds.
+  bool hasDynamicShapes = false;
+};
+
+/// Estimates the cost of a dispatch formed by `ops`. Values produced by an op
+/// of the group and only used within the group are assumed to stay on chip.
+DispatchCost estimateDispatchCost(ArrayRef<Operation *> ops);
+
+/// Decides whether fusing an op into a dispatch is profitable. This is only
+/// consulted for fusions that FormDispatchRegions already deems legal.
+class FusionCostModel {
+public:
+  virtual ~FusionCostModel() = default;
+
+  virtual StringRef getName() const = 0;
+
+  /// Returns true if `candidate` should be moved into the dispatch formed by
+  /// `group`. `group[0]` is the current root of the dispatch.
+  bool shouldFuse(Operation *candidate, ArrayRef<Operation *> group);
+
+  /// Prints all the decisions taken so far as a graphviz graph: ops are
+  /// nodes, and each decision is an edge from the candidate to the root of the
+  /// dispatch, labeled with the estimated costs.
+  void printDecisionsAsDot(raw_ostream &os) const;
+
+protected:
+  struct Decision {
+    Operation *candidate;
+    Operation *root;
+    DispatchCost separateCost;
+    DispatchCost fusedCost;
+    double separateCycles;
+    double fusedCycles;
+    bool fuse;
+  };
+
+  /// Returns the estimated execution time of a dispatch with the given cost.
+  virtual double estimateCycles(const DispatchCost &cost) const = 0;
+
+  /// Returns true if fusing is profitable given the estimated costs of the
+  /// dispatch formed by `group` + the dispatch formed by `candidate` alone, vs.
+  /// the estimated cost of the fused dispatch.
+  virtual bool isProfitable(const DispatchCost &separateCost,
+                            double separateCycles,
+                            const DispatchCost &fusedCost,
+                            double fusedCycles) const = 0;
+
+private:
+  SmallVector<Decision> decisions;
+};
+
+using FusionCostModelFactory =
+    std::function<std::unique_ptr<FusionCostModel>(ModuleOp moduleOp)>;
+
+/// Registers a cost model that can then be selected by name with the
+/// `fusion-cost-model` option of FormDispatchRegions.
+void registerFusionCostModel(StringRef name, FusionCostModelFactory factory);
+
+/// Creates the cost model registered under `name` for the targets of
+/// `moduleOp`. Returns nullptr if there is no such cost model.
+std::unique_ptr<FusionCostModel> createFusionCostModel(StringRef name,
+                                                       ModuleOp moduleOp);
+
+} // namespace Flow
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
+
+#endif // IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_FUSIONCOSTMODEL_H_
@@ -70,6 +70,14 @@ static llvm::cl::opt<bool> clEnableFusePaddingIntoLinalgProducerOps(
     llvm::cl::desc("Enable fusing tensor.pad ops into Linalg consumer ops."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableFuseEncodingIntoLinalgConsumerOps(
+    "iree-flow-enable-fuse-encoding-into-linalg-consumer-ops",
+    llvm::cl::desc("Enable fusing the set_encoding ops of contraction LHS "
+                   "operands into the contraction dispatch so that they are "
+                   "packed tile by tile. Requires backend support (LLVMCPU "
+                   "with microkernels)."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool>
     clEnableFuseMultiUse("iree-flow-fuse-multi-use",
                          llvm::cl::desc("Fuse multi-use ops."),
@@ -94,12 +102,31 @@ static llvm::cl::opt<std::string> clDumpDispatchGraphOutputFile(
     llvm::cl::desc("Output file name for a dispatch graph dump."),
     llvm::cl::init("dispatch.dot"));
 
+static llvm::cl::opt<std::string> clDispatchFusionCostModel(
+    "iree-flow-dispatch-fusion-cost-model",
+    llvm::cl::desc("Cost model deciding whether fusions during dispatch region "
+                   "formation are profitable (e.g. `roofline`). By default, "
+                   "ops are fused whenever legal."),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<bool> clDumpDispatchFusionGraph(
+    "iree-flow-dump-dispatch-fusion-graph",
+    llvm::cl::desc("Dump a dot graph of the fusion cost model decisions to "
+                   "stderr."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<std::string> clDispatchTransformFileName(
     "iree-flow-dispatch-use-transform-dialect",
     llvm::cl::desc("MLIR file containing a top-level module that specifies "
                    "the transformations to apply to form dispatch regions."),
     llvm::cl::init(""));
 
+static llvm::cl::opt<bool> clCollapseElementwiseChains(
+    "iree-flow-collapse-elementwise-chains",
+    llvm::cl::desc("Collapse chains of elementwise ops connected through "
+                   "reshapes to rank-1 before dispatch region formation."),
+    llvm::cl::init(true));
+
 static llvm::cl::opt<bool> clZeroFillEmptyTensors(
     "iree-flow-zero-fill-empty-tensors",
     llvm::cl::desc(
@@ -149,6 +176,10 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       // transpose.
       .addPredicatedPass(clNormalizeInputIndexingMap,
                          createInterchangeTransposeGenericOpsPass)
+      // Collapse elementwise chains to rank-1 so that the reshapes between
+      // them cancel out and they form a single contiguous dispatch.
+      .addPredicatedPass(clCollapseElementwiseChains,
+                         createCollapseElementwiseChainsPass)
       ////////////////////////////////////////////////////////////////////////
       // Dispatch region formation.
       .addPredicatedPass(!clDispatchTransformFileName.empty(),
@@ -167,7 +198,9 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
         return createFormDispatchRegionsPass(FormDispatchRegionsOptions{
             clEnableFuseMultiUse, clDispatchGenerateWorkloadRegion,
             clEnableFusePaddingIntoLinalgConsumerOps,
-            clEnableFusePaddingIntoLinalgProducerOps});
+            clEnableFusePaddingIntoLinalgProducerOps,
+            clEnableFuseEncodingIntoLinalgConsumerOps,
+            clDispatchFusionCostModel, clDumpDispatchFusionGraph});
       })
       // Collapse dimensions of linalg Ops.
       .addPass(createCollapseDimensionsPass)
@@ -137,6 +137,9 @@ struct FormDispatchRegionsOptions {
   bool generateWorkloadRegion = true;
   bool fusePadWithConsumers = false;
   bool fusePadWithProducers = false;
+  bool fuseEncodingWithConsumers = false;
+  std::string fusionCostModel = "";
+  bool dumpFusionGraph = false;
 };
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createFormDispatchRegionsPass(FormDispatchRegionsOptions options = {});
@@ -149,6 +152,11 @@ createFormScalarDispatchesPass();
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createCollapseDimensionsPass();
 
+// Pass to collapse chains of elementwise ops connected through reshapes to
+// rank-1 ahead of dispatch region formation.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createCollapseElementwiseChainsPass();
+
 // Pass to clone into dispatch regions producers of values used in the dispatch
 // regions but defined in the above. This prepares the dispatch regions for
 // converting to dispatch workgroups with explicit captures.
@@ -11,6 +11,7 @@
 #include "iree-dialects/Transforms/TransformMatchers.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/Support/CommandLine.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -26,6 +27,13 @@ namespace iree_compiler {
 namespace IREE {
 namespace Flow {
 
+static llvm::cl::opt<bool> clRaiseAttention(
+    "iree-flow-raise-attention",
+    llvm::cl::desc("Raise matmul(softmax(matmul(Q, transpose(K))), V) to "
+                   "iree_linalg_ext.attention. Only the LLVMCPU and LLVMGPU "
+                   "backends lower the attention op."),
+    llvm::cl::init(false));
+
 namespace {
 
 //===----------------------------------------------------------------------===//
@@ -596,6 +604,137 @@ static Value rewriteCatNegateAndSlice(RewriterBase &rewriter,
                                                   result, reassoc);
 }
 
+//===----------------------------------------------------------------------===//
+// Attention raising
+//===----------------------------------------------------------------------===//
+
+/// Returns true if `value` is produced by a linalg.fill of zero.
+static bool isZeroFilled(Value value) {
+  auto fillOp = value.getDefiningOp<linalg::FillOp>();
+  return fillOp && matchPattern(fillOp.getDpsInputs()[0], m_AnyZeroFloat());
+}
+
+/// Matches a linalg.generic scaling its single input by a scalar defined
+/// outside of it, i.e. a multiplication or division by a constant. Returns the
+/// scaling op in the body on success.
+static Operation *matchScalarScale(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() != 1 || genericOp.getNumDpsInits() != 1 ||
+      genericOp.getNumParallelLoops() != genericOp.getNumLoops() ||
+      !llvm::all_of(genericOp.getIndexingMapsArray(),
+                    [](AffineMap map) { return map.isIdentity(); })) {
+    return nullptr;
+  }
+  Block *body = genericOp.getBlock();
+  if (!llvm::hasNItems(body->without_terminator(), 1)) {
+    return nullptr;
+  }
+  Operation *scaleOp = &body->front();
+  if (!isa<arith::MulFOp, arith::DivFOp>(scaleOp) ||
+      body->getTerminator()->getOperand(0) != scaleOp->getResult(0) ||
+      scaleOp->getOperand(0) != body->getArgument(0)) {
+    return nullptr;
+  }
+  Value scale = scaleOp->getOperand(1);
+  if (!matchPattern(scale, m_Constant())) {
+    return nullptr;
+  }
+  return scaleOp;
+}
+
+/// Matches the attention pattern
+///
+///   %qk = linalg.batch_matmul_transpose_b ins(%Q, %K) outs(zero fill)
+///   %scaled = (optional) linalg.generic { mulf/divf by a constant }
+///   %p = linalg.softmax dimension(2) ins(%qk or %scaled)
+///   %result = linalg.batch_matmul ins(%p, %V) outs(zero fill)
+///
+/// and rewrites it as an iree_linalg_ext.attention op, which gets lowered with
+/// a tiled online softmax and never materializes the full score matrix. The
+/// scaling is applied to the query instead. Only static shapes are raised, as
+/// the lowering of the attention op requires them.
+static LogicalResult raiseAttention(RewriterBase &rewriter,
+                                    linalg::BatchMatmulOp pvOp) {
+  auto softmaxOp = pvOp.getDpsInputs()[0].getDefiningOp<linalg::SoftmaxOp>();
+  if (!softmaxOp || softmaxOp.getDimension() != 2 ||
+      !softmaxOp->hasOneUse() || !isZeroFilled(pvOp.getDpsInits()[0])) {
+    return failure();
+  }
+  Value scores = softmaxOp.getInput();
+  linalg::GenericOp scaleGenericOp = scores.getDefiningOp<linalg::GenericOp>();
+  Operation *scaleOp = nullptr;
+  if (scaleGenericOp) {
+    scaleOp = matchScalarScale(scaleGenericOp);
+    if (!scaleOp || !scaleGenericOp->hasOneUse()) {
+      return failure();
+    }
+    scores = scaleGenericOp.getDpsInputs()[0];
+  }
+  auto qkOp = scores.getDefiningOp<linalg::BatchMatmulTransposeBOp>();
+  if (!qkOp || !qkOp->hasOneUse() || !isZeroFilled(qkOp.getDpsInits()[0])) {
+    return failure();
+  }
+
+  Value query = qkOp.getDpsInputs()[0];
+  Value key = qkOp.getDpsInputs()[1];
+  Value value = pvOp.getDpsInputs()[1];
+  auto queryType = cast<RankedTensorType>(query.getType());
+  auto keyType = cast<RankedTensorType>(key.getType());
+  auto valueType = cast<RankedTensorType>(value.getType());
+  auto resultType = cast<RankedTensorType>(pvOp->getResult(0).getType());
+  Type elementType = queryType.getElementType();
+  if (!isa<FloatType>(elementType) ||
+      llvm::any_of(
+          ArrayRef<Type>{keyType.getElementType(), valueType.getElementType(),
+                         resultType.getElementType(),
+                         cast<ShapedType>(softmaxOp.getInput().getType())
+                             .getElementType()},
+          [&](Type type) { return type != elementType; })) {
+    return failure();
+  }
+  // The attention op expects the key and value to have the same shape, and
+  // the output to have the same shape as the query.
+  if (!queryType.hasStaticShape() || !keyType.hasStaticShape() ||
+      keyType != valueType || resultType != queryType) {
+    return failure();
+  }
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(pvOp);
+  Location loc = pvOp.getLoc();
+  if (scaleOp) {
+    Value scale = scaleOp->getOperand(1);
+    Value init =
+        rewriter.create<tensor::EmptyOp>(loc, queryType.getShape(), elementType);
+    AffineMap identity = rewriter.getMultiDimIdentityMap(queryType.getRank());
+    SmallVector<utils::IteratorType> iteratorTypes(
+        queryType.getRank(), utils::IteratorType::parallel);
+    query = rewriter
+                .create<linalg::GenericOp>(
+                    loc, queryType, query, init,
+                    ArrayRef<AffineMap>{identity, identity}, iteratorTypes,
+                    [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                      Operation *scaled = b.create(
+                          nestedLoc, scaleOp->getName().getIdentifier(),
+                          ValueRange{args[0], scale}, elementType,
+                          scaleOp->getAttrs());
+                      b.create<linalg::YieldOp>(nestedLoc,
+                                                scaled->getResult(0));
+                    })
+                .getResult(0);
+  }
+  Value output =
+      rewriter.create<tensor::EmptyOp>(loc, resultType.getShape(), elementType);
+  rewriter.replaceOpWithNewOp<IREE::LinalgExt::AttentionOp>(
+      pvOp, TypeRange{resultType}, ValueRange{query, key, value},
+      ValueRange{output});
+  rewriter.eraseOp(softmaxOp);
+  if (scaleGenericOp) {
+    rewriter.eraseOp(scaleGenericOp);
+  }
+  rewriter.eraseOp(qkOp);
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Pass Implementation
 //===----------------------------------------------------------------------===//
@@ -717,6 +856,17 @@ struct RaiseSpecialOpsPass : public RaiseSpecialOpsBase<RaiseSpecialOpsPass> {
           rewriteCatNegateAndSlice(rewriter, sliceOp, catNegateAndSlice.second);
       rewriter.replaceOp(sliceOp, res);
     }
+
+    // Attention is raised last, as it is made of the softmax and transposed
+    // batch matmuls raised above.
+    if (clRaiseAttention) {
+      SmallVector<linalg::BatchMatmulOp> attentionRoots;
+      getOperation()->walk(
+          [&](linalg::BatchMatmulOp op) { attentionRoots.push_back(op); });
+      for (linalg::BatchMatmulOp op : attentionRoots) {
+        (void)raiseAttention(rewriter, op);
+      }
+    }
   }
 };
 
@@ -29,11 +29,43 @@ static llvm::cl::opt<int64_t>
     splitReductionRatio("iree-flow-split-matmul-reduction",
                         llvm::cl::desc("split ratio"), llvm::cl::init(1));
 
+static llvm::cl::opt<int64_t> splitReductionTargetTiles(
+    "iree-flow-split-matmul-reduction-target-tiles",
+    llvm::cl::desc(
+        "Splits the reduction of skinny matmuls that have fewer output tiles "
+        "than this so that the split matmul has about this many tiles. "
+        "Ignored when --iree-flow-split-matmul-reduction is set."),
+    llvm::cl::init(0));
+
 static llvm::cl::list<int64_t> topkSplitReductionRatio(
     "iree-flow-topk-split-reduction",
     llvm::cl::desc("comma separated list of split ratios"),
     llvm::cl::CommaSeparated);
 
+/// Returns the split ratio for `matmulOp` so that the split matmul has about
+/// `targetTiles` output tiles, or 0 if the matmul already has enough
+/// parallelism or its reduction is too small to split.
+static int64_t getSkinnyMatmulSplitRatio(linalg::MatmulOp matmulOp,
+                                         int64_t targetTiles) {
+  // Approximate workgroup tile size used to count the parallel work.
+  static constexpr int64_t kTileSize = 64;
+  // Minimum size of each split reduction so that every partial matmul still
+  // streams enough data to be worth a workgroup.
+  static constexpr int64_t kMinSplitReductionSize = 256;
+  SmallVector<int64_t> bounds = matmulOp.getStaticLoopRanges();
+  if (ShapedType::isDynamicShape(bounds))
+    return 0;
+  int64_t numTiles = llvm::divideCeil(bounds[0], kTileSize) *
+                     llvm::divideCeil(bounds[1], kTileSize);
+  int64_t sizeK = bounds[2];
+  int64_t ratio = 1;
+  while (numTiles * ratio * 2 <= targetTiles && sizeK % (ratio * 2) == 0 &&
+         sizeK / (ratio * 2) >= kMinSplitReductionSize) {
+    ratio *= 2;
+  }
+  return ratio > 1 ? ratio : 0;
+}
+
 namespace {
 /// Pattern to wrap splitReduction transformation. This also propagates
 /// attributes to allow compilation info attribute to not be lost.
@@ -84,6 +116,7 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
 
   void runOnOperation() override {
     if (splitReductionRatio.getValue() <= 1 &&
+        splitReductionTargetTiles.getValue() <= 0 &&
         topkSplitReductionRatio.empty()) {
       return;
     }
@@ -94,8 +127,14 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
         [&](linalg::LinalgOp op) -> linalg::SplitReductionOptions {
           // For matmul make the new parallel dimension first so that it looks
           // like a batch_matmul and can follow the same codegen.
-          if (isa<linalg::MatmulOp>(op))
-            return {int64_t(splitReductionRatio), 0, /*innerParallel=*/false};
+          if (auto matmulOp = dyn_cast<linalg::MatmulOp>(op.getOperation())) {
+            int64_t ratio = splitReductionRatio;
+            if (ratio <= 1 && splitReductionTargetTiles > 0) {
+              ratio = getSkinnyMatmulSplitRatio(matmulOp,
+                                                splitReductionTargetTiles);
+            }
+            return {ratio, 0, /*innerParallel=*/false};
+          }
           // Currently disable spliting reduction for non-matmul op. This will
           // get enabled after once tests are ready.
           return {int64_t(0), 0, /*innerParallel=*/false};
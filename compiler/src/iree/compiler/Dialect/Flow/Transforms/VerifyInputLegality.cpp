@@ -9,6 +9,7 @@
 #include "iree/compiler/Utils/ConversionUtils.h"
 #include "mlir/Dialect/Tosa/IR/TosaOps.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
@@ -18,17 +19,54 @@ namespace IREE {
 namespace Flow {
 
 namespace {
+
+// Returns true if |type| is a tensor carrying a sparse_tensor encoding.
+// Checked by dialect namespace to avoid depending on the SparseTensor dialect.
+static bool isSparseTensorType(Type type) {
+  auto tensorType = llvm::dyn_cast<RankedTensorType>(type);
+  if (!tensorType || !tensorType.getEncoding())
+    return false;
+  return tensorType.getEncoding().getDialect().getNamespace() ==
+         "sparse_tensor";
+}
+
+// Returns true if |op| uses or defines a sparse tensor, including through the
+// arguments of its regions and - for functions - its signature.
+static bool hasSparseTensorTypes(Operation *op) {
+  if (llvm::any_of(op->getOperandTypes(), isSparseTensorType) ||
+      llvm::any_of(op->getResultTypes(), isSparseTensorType)) {
+    return true;
+  }
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      if (llvm::any_of(block.getArgumentTypes(), isSparseTensorType)) {
+        return true;
+      }
+    }
+  }
+  // External functions have no entry block to carry their arguments.
+  if (auto funcOp = dyn_cast<FunctionOpInterface>(op)) {
+    return llvm::any_of(funcOp.getArgumentTypes(), isSparseTensorType) ||
+           llvm::any_of(funcOp.getResultTypes(), isSparseTensorType);
+  }
+  return false;
+}
+
 class VerifyInputLegalityPass
     : public VerifyInputLegalityBase<VerifyInputLegalityPass> {
   void runOnOperation() override {
     ConversionTarget target(getContext());
-    target.markUnknownOpDynamicallyLegal([](Operation *) { return true; });
+    // Sparse tensors have no storage representation in flow/stream/HAL yet and
+    // must be densified before reaching IREE.
+    target.markUnknownOpDynamicallyLegal(
+        [](Operation *op) { return !hasSparseTensorTypes(op); });
     target.addLegalOp<tosa::ApplyScaleOp>();
     // We're already depending on the Tosa Dialect
     target.addIllegalDialect<tosa::TosaDialect>();
     // Avoid StableHLO dependency
     target.addIllegalDialect("chlo");
     target.addIllegalDialect("stablehlo");
+    target.addIllegalDialect("sparse_tensor");
     target.addIllegalOp<UnrealizedConversionCastOp>();
 
     if (failed(iree_compiler::verifyAllOperationsAreLegal(getOperation(),
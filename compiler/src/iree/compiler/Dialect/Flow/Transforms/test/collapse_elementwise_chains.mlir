@@ -0,0 +1,104 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-flow-collapse-elementwise-chains, cse))" %s | FileCheck %s
+
+#map = affine_map<(d0, d1, d2) -> (d0, d1, d2)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+func.func @chain_through_reshape(%arg0: tensor<4x8x16xf32>) -> (tensor<4x8x16xf32>, tensor<32x16xf32>) {
+  %0 = tensor.empty() : tensor<4x8x16xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel", "parallel"]}
+      ins(%arg0 : tensor<4x8x16xf32>) outs(%0 : tensor<4x8x16xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %5 = math.exp %in : f32
+    linalg.yield %5 : f32
+  } -> tensor<4x8x16xf32>
+  %2 = tensor.collapse_shape %1 [[0, 1], [2]] : tensor<4x8x16xf32> into tensor<32x16xf32>
+  %3 = tensor.empty() : tensor<32x16xf32>
+  %4 = linalg.generic {indexing_maps = [#map1, #map1], iterator_types = ["parallel", "parallel"]}
+      ins(%2 : tensor<32x16xf32>) outs(%3 : tensor<32x16xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %5 = arith.negf %in : f32
+    linalg.yield %5 : f32
+  } -> tensor<32x16xf32>
+  return %1, %4 : tensor<4x8x16xf32>, tensor<32x16xf32>
+}
+// The reshapes between the collapsed ops cancel out, only the ones at the
+// boundary of the chain remain.
+//       CHECK: #[[$MAP:.+]] = affine_map<(d0) -> (d0)>
+// CHECK-LABEL: func.func @chain_through_reshape
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<4x8x16xf32>
+//       CHECK:   %[[IN:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1, 2]] : tensor<4x8x16xf32> into tensor<512xf32>
+//       CHECK:   %[[EXP:.+]] = linalg.generic
+//  CHECK-SAME:       indexing_maps = [#[[$MAP]], #[[$MAP]]], iterator_types = ["parallel"]
+//  CHECK-SAME:       ins(%[[IN]] : tensor<512xf32>)
+//       CHECK:     math.exp
+//       CHECK:   %[[NEG:.+]] = linalg.generic
+//  CHECK-SAME:       iterator_types = ["parallel"]
+//  CHECK-SAME:       ins(%[[EXP]] : tensor<512xf32>)
+//       CHECK:     arith.negf
+//   CHECK-DAG:   %[[RES0:.+]] = tensor.expand_shape %[[EXP]] {{\[}}[0, 1, 2]] : tensor<512xf32> into tensor<4x8x16xf32>
+//   CHECK-DAG:   %[[RES1:.+]] = tensor.expand_shape %[[NEG]] {{\[}}[0, 1]] : tensor<512xf32> into tensor<32x16xf32>
+//       CHECK:   return %[[RES0]], %[[RES1]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> ()>
+func.func @single_use_chain_fused(%arg0: tensor<16x32xf32>, %arg1: tensor<16x32xf32>, %arg2: tensor<f32>) -> tensor<16x32xf32> {
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %arg2 : tensor<16x32xf32>, tensor<f32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %3 = arith.mulf %in, %in_0 : f32
+    linalg.yield %3 : f32
+  } -> tensor<16x32xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%1, %arg1 : tensor<16x32xf32>, tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %3 = arith.addf %in, %in_0 : f32
+    linalg.yield %3 : f32
+  } -> tensor<16x32xf32>
+  return %2 : tensor<16x32xf32>
+}
+// CHECK-LABEL: func.func @single_use_chain_fused
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<16x32xf32>
+//  CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<f32>
+//   CHECK-DAG:   %[[IN0:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1]] : tensor<16x32xf32> into tensor<512xf32>
+//   CHECK-DAG:   %[[IN1:.+]] = tensor.collapse_shape %[[ARG1]] {{\[}}[0, 1]] : tensor<16x32xf32> into tensor<512xf32>
+//       CHECK:   %[[FUSED:.+]] = linalg.generic
+//  CHECK-SAME:       iterator_types = ["parallel"]
+//   CHECK-NOT:   linalg.generic
+//       CHECK:   %[[RES:.+]] = tensor.expand_shape %[[FUSED]] {{\[}}[0, 1]] : tensor<512xf32> into tensor<16x32xf32>
+//       CHECK:   return %[[RES]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @chain_with_matmul_producer(%arg0: tensor<16x8xf32>, %arg1: tensor<8x32xf32>, %arg2: tensor<16x32xf32>) -> (tensor<16x32xf32>, tensor<16x32xf32>) {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tensor.empty() : tensor<16x32xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<16x32xf32>) -> tensor<16x32xf32>
+  %2 = linalg.matmul ins(%arg0, %arg1 : tensor<16x8xf32>, tensor<8x32xf32>) outs(%1 : tensor<16x32xf32>) -> tensor<16x32xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%2, %arg2 : tensor<16x32xf32>, tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %5 = arith.addf %in, %in_0 : f32
+    linalg.yield %5 : f32
+  } -> tensor<16x32xf32>
+  %4 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%3 : tensor<16x32xf32>) outs(%0 : tensor<16x32xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %5 = math.exp %in : f32
+    linalg.yield %5 : f32
+  } -> tensor<16x32xf32>
+  return %3, %4 : tensor<16x32xf32>, tensor<16x32xf32>
+}
+// Chains touching other compute ops are left alone so that they still fuse
+// with them during dispatch region formation.
+// CHECK-LABEL: func.func @chain_with_matmul_producer
+//   CHECK-NOT:   tensor.collapse_shape
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       iterator_types = ["parallel", "parallel"]
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       iterator_types = ["parallel", "parallel"]
+//   CHECK-NOT:   tensor.expand_shape
@@ -0,0 +1,65 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-flow-form-dispatch-regions{fuse-encoding-with-consumers}))" --split-input-file %s | FileCheck %s
+
+#lhs_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = LHS, element_types = [f32, f32, f32]>
+#rhs_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = RHS, element_types = [f32, f32, f32]>
+#result_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>
+func.func @fuse_lhs_encoding_with_matmul(%arg0 : tensor<?x?xf32>,
+    %arg1 : tensor<?x?xf32, #rhs_encoding>,
+    %arg2 : tensor<?x?xf32, #result_encoding>) -> tensor<?x?xf32, #result_encoding> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %d0 = tensor.dim %arg0, %c0 : tensor<?x?xf32>
+  %d1 = tensor.dim %arg0, %c1 : tensor<?x?xf32>
+  %0 = tensor.empty(%d0, %d1) : tensor<?x?xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%0 : tensor<?x?xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %2 = arith.negf %b0 : f32
+      linalg.yield %2 : f32
+    } -> tensor<?x?xf32>
+  %3 = iree_linalg_ext.set_encoding %1
+      : tensor<?x?xf32> -> tensor<?x?xf32, #lhs_encoding>
+  %4 = linalg.matmul
+      ins(%3, %arg1 : tensor<?x?xf32, #lhs_encoding>, tensor<?x?xf32, #rhs_encoding>)
+      outs(%arg2 : tensor<?x?xf32, #result_encoding>) -> tensor<?x?xf32, #result_encoding>
+  return %4 : tensor<?x?xf32, #result_encoding>
+}
+// CHECK-LABEL: func @fuse_lhs_encoding_with_matmul(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32, #{{.+}}>
+//  CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?xf32, #{{.+}}>
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[GENERIC:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[ARG0]] :
+//       CHECK:     %[[LHS:.+]] = iree_linalg_ext.set_encoding %[[GENERIC]]
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:         ins(%[[LHS]], %[[ARG1]] :
+//       CHECK:     flow.return %[[MATMUL]]
+//       CHECK:   return %[[RETURN]]
+
+// -----
+
+#lhs_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = LHS, element_types = [f32, f32, f32]>
+#rhs_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = RHS, element_types = [f32, f32, f32]>
+#result_encoding = #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>
+func.func @no_fuse_rhs_encoding_with_matmul(
+    %arg0 : tensor<?x?xf32, #lhs_encoding>, %arg1 : tensor<?x?xf32>,
+    %arg2 : tensor<?x?xf32, #result_encoding>) -> tensor<?x?xf32, #result_encoding> {
+  %0 = iree_linalg_ext.set_encoding %arg1
+      : tensor<?x?xf32> -> tensor<?x?xf32, #rhs_encoding>
+  %1 = linalg.matmul
+      ins(%arg0, %0 : tensor<?x?xf32, #lhs_encoding>, tensor<?x?xf32, #rhs_encoding>)
+      outs(%arg2 : tensor<?x?xf32, #result_encoding>) -> tensor<?x?xf32, #result_encoding>
+  return %1 : tensor<?x?xf32, #result_encoding>
+}
+// CHECK-LABEL: func @no_fuse_rhs_encoding_with_matmul(
+//       CHECK:   %[[RHS:.+]] = flow.dispatch.region
+//       CHECK:     iree_linalg_ext.set_encoding
+//       CHECK:     flow.return
+//       CHECK:   flow.dispatch.region
+//   CHECK-NOT:     iree_linalg_ext.set_encoding
+//       CHECK:     linalg.matmul
+//  CHECK-SAME:         ins(%{{.+}}, %[[RHS]] :
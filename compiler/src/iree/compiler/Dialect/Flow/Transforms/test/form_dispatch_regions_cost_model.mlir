@@ -0,0 +1,86 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-flow-form-dispatch-regions{fusion-cost-model=roofline}))" --split-input-file %s | FileCheck %s
+
+func.func @matmul_bias_add(%lhs: tensor<16x16xf32>, %rhs: tensor<16x16xf32>, %bias: tensor<16xf32>) -> tensor<16x16xf32> {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<16x16xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %matmul = linalg.matmul ins(%lhs, %rhs : tensor<16x16xf32>, tensor<16x16xf32>)
+      outs(%fill : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%matmul, %bias : tensor<16x16xf32>, tensor<16xf32>)
+      outs(%empty : tensor<16x16xf32>) {
+    ^bb0(%b0: f32, %b1: f32, %b2: f32):
+      %1 = arith.addf %b0, %b1 : f32
+      linalg.yield %1 : f32
+  } -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
+// CHECK-LABEL: func @matmul_bias_add(
+//       CHECK:   %[[DISPATCH:.+]] = flow.dispatch.region
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//       CHECK:     %[[GENERIC:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[MATMUL]],
+//       CHECK:     flow.return %[[GENERIC]]
+//       CHECK:   return %[[DISPATCH]]
+
+// -----
+
+// Fusing the consumer would stream more tensors than the target can keep
+// close, so it goes to its own dispatch.
+func.func @matmul_wide_consumer(%lhs: tensor<16x16xf32>, %rhs: tensor<16x16xf32>, %e0: tensor<16x16xf32>, %e1: tensor<16x16xf32>, %e2: tensor<16x16xf32>, %e3: tensor<16x16xf32>, %e4: tensor<16x16xf32>, %e5: tensor<16x16xf32>, %e6: tensor<16x16xf32>, %e7: tensor<16x16xf32>, %e8: tensor<16x16xf32>, %e9: tensor<16x16xf32>, %e10: tensor<16x16xf32>, %e11: tensor<16x16xf32>, %e12: tensor<16x16xf32>) -> tensor<16x16xf32> {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<16x16xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %matmul = linalg.matmul ins(%lhs, %rhs : tensor<16x16xf32>, tensor<16x16xf32>)
+      outs(%fill : tensor<16x16xf32>) -> tensor<16x16xf32>
+  %0 = linalg.generic {
+      indexing_maps = [
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%matmul, %e0, %e1, %e2, %e3, %e4, %e5, %e6, %e7, %e8, %e9, %e10, %e11, %e12 : tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>, tensor<16x16xf32>)
+      outs(%empty : tensor<16x16xf32>) {
+    ^bb0(%b0: f32, %b1: f32, %b2: f32, %b3: f32, %b4: f32, %b5: f32, %b6: f32, %b7: f32, %b8: f32, %b9: f32, %b10: f32, %b11: f32, %b12: f32, %b13: f32, %b14: f32):
+      %s1 = arith.addf %b0, %b1 : f32
+      %s2 = arith.addf %s1, %b2 : f32
+      %s3 = arith.addf %s2, %b3 : f32
+      %s4 = arith.addf %s3, %b4 : f32
+      %s5 = arith.addf %s4, %b5 : f32
+      %s6 = arith.addf %s5, %b6 : f32
+      %s7 = arith.addf %s6, %b7 : f32
+      %s8 = arith.addf %s7, %b8 : f32
+      %s9 = arith.addf %s8, %b9 : f32
+      %s10 = arith.addf %s9, %b10 : f32
+      %s11 = arith.addf %s10, %b11 : f32
+      %s12 = arith.addf %s11, %b12 : f32
+      %s13 = arith.addf %s12, %b13 : f32
+      linalg.yield %s13 : f32
+  } -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
+// CHECK-LABEL: func @matmul_wide_consumer(
+//       CHECK:   %[[DISPATCH0:.+]] = flow.dispatch.region
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//       CHECK:     flow.return %[[MATMUL]]
+//       CHECK:   %[[DISPATCH1:.+]] = flow.dispatch.region
+//       CHECK:     %[[GENERIC:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[DISPATCH0]],
+//       CHECK:     flow.return %[[GENERIC]]
+//       CHECK:   return %[[DISPATCH1]]
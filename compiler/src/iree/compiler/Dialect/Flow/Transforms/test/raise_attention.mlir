@@ -0,0 +1,85 @@
+// RUN: iree-opt --iree-flow-raise-special-ops --iree-flow-raise-attention -canonicalize --split-input-file %s | FileCheck %s
+
+func.func @attention(%query : tensor<12x384x64xf32>, %key : tensor<12x384x64xf32>, %value : tensor<12x384x64xf32>) -> tensor<12x384x64xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tensor.empty() : tensor<12x384x384xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %2 = linalg.batch_matmul_transpose_b ins(%query, %key : tensor<12x384x64xf32>, tensor<12x384x64xf32>)
+      outs(%1 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %3 = linalg.softmax dimension(2) ins(%2 : tensor<12x384x384xf32>) outs(%0 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %4 = tensor.empty() : tensor<12x384x64xf32>
+  %5 = linalg.fill ins(%cst : f32) outs(%4 : tensor<12x384x64xf32>) -> tensor<12x384x64xf32>
+  %6 = linalg.batch_matmul ins(%3, %value : tensor<12x384x384xf32>, tensor<12x384x64xf32>)
+      outs(%5 : tensor<12x384x64xf32>) -> tensor<12x384x64xf32>
+  return %6 : tensor<12x384x64xf32>
+}
+// CHECK-LABEL: func.func @attention
+//  CHECK-SAME:     %[[QUERY:[a-zA-Z0-9]+]]: tensor<12x384x64xf32>
+//  CHECK-SAME:     %[[KEY:[a-zA-Z0-9]+]]: tensor<12x384x64xf32>
+//  CHECK-SAME:     %[[VALUE:[a-zA-Z0-9]+]]: tensor<12x384x64xf32>
+//   CHECK-NOT:   linalg.softmax
+//       CHECK:   %[[EMPTY:.+]] = tensor.empty() : tensor<12x384x64xf32>
+//       CHECK:   %[[ATTN:.+]] = iree_linalg_ext.attention
+//  CHECK-SAME:       ins(%[[QUERY]], %[[KEY]], %[[VALUE]] :
+//  CHECK-SAME:       outs(%[[EMPTY]] :
+//   CHECK-NOT:   linalg.batch_matmul
+//       CHECK:   return %[[ATTN]]
+
+// -----
+
+// The scaling of the scores is applied to the query instead.
+func.func @scaled_attention(%query : tensor<12x384x64xf16>, %key : tensor<12x384x64xf16>, %value : tensor<12x384x64xf16>) -> tensor<12x384x64xf16> {
+  %cst = arith.constant 0.000000e+00 : f16
+  %scale = arith.constant 1.250000e-01 : f16
+  %0 = tensor.empty() : tensor<12x384x384xf16>
+  %1 = linalg.fill ins(%cst : f16) outs(%0 : tensor<12x384x384xf16>) -> tensor<12x384x384xf16>
+  %2 = linalg.batch_matmul_transpose_b ins(%query, %key : tensor<12x384x64xf16>, tensor<12x384x64xf16>)
+      outs(%1 : tensor<12x384x384xf16>) -> tensor<12x384x384xf16>
+  %3 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d1, d2)>, affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+      iterator_types = ["parallel", "parallel", "parallel"]}
+      ins(%2 : tensor<12x384x384xf16>) outs(%0 : tensor<12x384x384xf16>) {
+  ^bb0(%in: f16, %out: f16):
+    %7 = arith.mulf %in, %scale : f16
+    linalg.yield %7 : f16
+  } -> tensor<12x384x384xf16>
+  %4 = linalg.softmax dimension(2) ins(%3 : tensor<12x384x384xf16>) outs(%0 : tensor<12x384x384xf16>) -> tensor<12x384x384xf16>
+  %5 = tensor.empty() : tensor<12x384x64xf16>
+  %6 = linalg.fill ins(%cst : f16) outs(%5 : tensor<12x384x64xf16>) -> tensor<12x384x64xf16>
+  %7 = linalg.batch_matmul ins(%4, %value : tensor<12x384x384xf16>, tensor<12x384x64xf16>)
+      outs(%6 : tensor<12x384x64xf16>) -> tensor<12x384x64xf16>
+  return %7 : tensor<12x384x64xf16>
+}
+// CHECK-LABEL: func.func @scaled_attention
+//  CHECK-SAME:     %[[QUERY:[a-zA-Z0-9]+]]: tensor<12x384x64xf16>
+//  CHECK-SAME:     %[[KEY:[a-zA-Z0-9]+]]: tensor<12x384x64xf16>
+//  CHECK-SAME:     %[[VALUE:[a-zA-Z0-9]+]]: tensor<12x384x64xf16>
+//       CHECK:   %[[SCALE:.+]] = arith.constant 1.250000e-01 : f16
+//       CHECK:   %[[SCALED_QUERY:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[QUERY]] : tensor<12x384x64xf16>)
+//       CHECK:     arith.mulf %{{.+}}, %[[SCALE]] : f16
+//       CHECK:   %[[ATTN:.+]] = iree_linalg_ext.attention
+//  CHECK-SAME:       ins(%[[SCALED_QUERY]], %[[KEY]], %[[VALUE]] :
+//       CHECK:   return %[[ATTN]]
+
+// -----
+
+// The scores are used by something else than the softmax, so they have to be
+// materialized anyway.
+func.func @scores_multiple_uses(%query : tensor<12x384x64xf32>, %key : tensor<12x384x64xf32>, %value : tensor<12x384x64xf32>) -> (tensor<12x384x64xf32>, tensor<12x384x384xf32>) {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tensor.empty() : tensor<12x384x384xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %2 = linalg.batch_matmul_transpose_b ins(%query, %key : tensor<12x384x64xf32>, tensor<12x384x64xf32>)
+      outs(%1 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %3 = linalg.softmax dimension(2) ins(%2 : tensor<12x384x384xf32>) outs(%0 : tensor<12x384x384xf32>) -> tensor<12x384x384xf32>
+  %4 = tensor.empty() : tensor<12x384x64xf32>
+  %5 = linalg.fill ins(%cst : f32) outs(%4 : tensor<12x384x64xf32>) -> tensor<12x384x64xf32>
+  %6 = linalg.batch_matmul ins(%3, %value : tensor<12x384x384xf32>, tensor<12x384x64xf32>)
+      outs(%5 : tensor<12x384x64xf32>) -> tensor<12x384x64xf32>
+  return %6, %2 : tensor<12x384x64xf32>, tensor<12x384x384xf32>
+}
+// CHECK-LABEL: func.func @scores_multiple_uses
+//   CHECK-NOT:   iree_linalg_ext.attention
+//       CHECK:   linalg.softmax
+//       CHECK:   linalg.batch_matmul
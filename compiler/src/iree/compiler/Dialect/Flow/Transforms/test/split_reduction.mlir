@@ -0,0 +1,46 @@
+// RUN: iree-opt --split-input-file --iree-flow-split-matmul-reduction-target-tiles=16 --pass-pipeline='builtin.module(func.func(iree-flow-split-reduction-ops))' %s | FileCheck %s
+
+func.func @skinny_matmul(%lhs: tensor<16x16384xf32>, %rhs: tensor<16384x32xf32>,
+                         %acc: tensor<16x32xf32>) -> tensor<16x32xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<16x16384xf32>, tensor<16384x32xf32>)
+      outs(%acc : tensor<16x32xf32>) -> tensor<16x32xf32>
+  return %0 : tensor<16x32xf32>
+}
+// CHECK-LABEL: func.func @skinny_matmul
+//  CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<16x16384xf32>
+//  CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<16384x32xf32>
+//   CHECK-DAG:   %[[EXPANDED_LHS:.+]] = tensor.expand_shape %[[LHS]]
+//  CHECK-SAME:       tensor<16x16384xf32> into tensor<16x16x1024xf32>
+//   CHECK-DAG:   %[[EXPANDED_RHS:.+]] = tensor.expand_shape %[[RHS]]
+//  CHECK-SAME:       tensor<16384x32xf32> into tensor<16x1024x32xf32>
+//       CHECK:   %[[PARTIAL:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[EXPANDED_LHS]], %[[EXPANDED_RHS]]
+//  CHECK-SAME:       -> tensor<16x16x32xf32>
+//       CHECK:   %[[RESULT:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[PARTIAL]] : tensor<16x16x32xf32>)
+//  CHECK-SAME:       -> tensor<16x32xf32>
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @large_matmul(%lhs: tensor<512x16384xf32>, %rhs: tensor<16384x512xf32>,
+                        %acc: tensor<512x512xf32>) -> tensor<512x512xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<512x16384xf32>, tensor<16384x512xf32>)
+      outs(%acc : tensor<512x512xf32>) -> tensor<512x512xf32>
+  return %0 : tensor<512x512xf32>
+}
+// CHECK-LABEL: func.func @large_matmul
+//       CHECK:   %[[RESULT:.+]] = linalg.matmul
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @small_reduction_matmul(%lhs: tensor<16x256xf32>, %rhs: tensor<256x32xf32>,
+                                  %acc: tensor<16x32xf32>) -> tensor<16x32xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<16x256xf32>, tensor<256x32xf32>)
+      outs(%acc : tensor<16x32xf32>) -> tensor<16x32xf32>
+  return %0 : tensor<16x32xf32>
+}
+// CHECK-LABEL: func.func @small_reduction_matmul
+//       CHECK:   %[[RESULT:.+]] = linalg.matmul
+//       CHECK:   return %[[RESULT]]
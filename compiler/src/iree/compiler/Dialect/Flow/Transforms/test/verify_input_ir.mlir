@@ -47,3 +47,37 @@ func.func @check_linalg_ok(%conv : tensor<1x112x112x16xf32>, %bias : tensor<16xf
       } -> tensor<1x112x112x16xf32>
   return %result : tensor<1x112x112x16xf32>
 }
+
+// -----
+
+#CSR = #sparse_tensor.encoding<{ map = (d0, d1) -> (d0 : dense, d1 : compressed) }>
+
+// expected-error@+1 {{illegal operations still remain}}
+func.func @check_no_sparse_tensor_ops(%arg0: tensor<8x8xf32>) -> tensor<8x8xf32> {
+  // expected-error@+1 {{illegal op still exists}}
+  %0 = sparse_tensor.convert %arg0 : tensor<8x8xf32> to tensor<8x8xf32, #CSR>
+  // expected-error@+1 {{illegal op still exists}}
+  %1 = sparse_tensor.convert %0 : tensor<8x8xf32, #CSR> to tensor<8x8xf32>
+  return %1 : tensor<8x8xf32>
+}
+
+// -----
+
+#CSR = #sparse_tensor.encoding<{ map = (d0, d1) -> (d0 : dense, d1 : compressed) }>
+
+// expected-error@+2 {{illegal operations still remain}}
+// expected-error@+1 {{illegal op still exists}}
+func.func private @check_no_sparse_signature(tensor<8x8xf32, #CSR>) -> tensor<8x8xf32>
+
+// -----
+
+#CSR = #sparse_tensor.encoding<{ map = (d0, d1) -> (d0 : dense, d1 : compressed) }>
+
+// Block arguments are checked even when the function signature is dense.
+// expected-error@+2 {{illegal operations still remain}}
+// expected-error@+1 {{illegal op still exists}}
+func.func @check_no_sparse_block_arguments(%arg0: tensor<8x8xf32>) -> tensor<8x8xf32> {
+  return %arg0 : tensor<8x8xf32>
+^bb1(%0: tensor<8x8xf32, #CSR>):
+  return %arg0 : tensor<8x8xf32>
+}
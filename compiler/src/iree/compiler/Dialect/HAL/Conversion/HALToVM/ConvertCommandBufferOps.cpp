@@ -304,6 +304,43 @@ private:
   mutable IREE::VM::ImportOp importOp;
 };
 
+class CommandBufferExecuteCommandsOpConversion
+    : public OpConversionPattern<IREE::HAL::CommandBufferExecuteCommandsOp> {
+public:
+  CommandBufferExecuteCommandsOpConversion(MLIRContext *context,
+                                           SymbolTable &importSymbols,
+                                           TypeConverter &typeConverter,
+                                           StringRef importName)
+      : OpConversionPattern(context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+  }
+
+  LogicalResult
+  matchAndRewrite(IREE::HAL::CommandBufferExecuteCommandsOp op,
+                  OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto importType = importOp.getFunctionType();
+    SmallVector<Value, 2> callOperands = {
+        adaptor.getCommandBuffer(),
+        adaptor.getCommands(),
+    };
+    SmallVector<int16_t, 3> segmentSizes = {
+        /*command_buffer=*/-1,
+        /*commands=*/-1,
+        /*bindings=*/0,
+    };
+    auto callOp = rewriter.replaceOpWithNewOp<IREE::VM::CallVariadicOp>(
+        op, SymbolRefAttr::get(importOp), importType.getResults(), segmentSizes,
+        importType.getInputs(), callOperands);
+    copyImportAttrs(importOp, callOp);
+    return success();
+  }
+
+private:
+  mutable IREE::VM::ImportOp importOp;
+};
+
 } // namespace
 
 void populateHALCommandBufferToVMPatterns(MLIRContext *context,
@@ -345,6 +382,9 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
       .insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchIndirectOp>>(
           context, importSymbols, typeConverter,
           "hal.command_buffer.dispatch.indirect");
+  patterns.insert<CommandBufferExecuteCommandsOpConversion>(
+      context, importSymbols, typeConverter,
+      "hal.command_buffer.execute.commands");
 }
 
 } // namespace iree_compiler
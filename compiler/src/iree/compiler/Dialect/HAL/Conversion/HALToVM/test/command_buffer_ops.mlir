@@ -249,3 +249,16 @@ func.func @command_buffer_dispatch_indirect(
       workgroups(%arg2 : !hal.buffer)[%c100]
   return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_execute_commands
+func.func @command_buffer_execute_commands(
+  %arg0: !hal.command_buffer,
+  %arg1: !hal.command_buffer
+) {
+  // CHECK: vm.call.variadic @hal.command_buffer.execute.commands(%arg0, %arg1, []) : (!vm.ref<!hal.command_buffer>, !vm.ref<!hal.command_buffer>, tuple<!vm.ref<!hal.buffer>, i64, i64> ...)
+  hal.command_buffer.execute.commands<%arg0 : !hal.command_buffer>
+      commands(%arg1 : !hal.command_buffer)
+  return
+}
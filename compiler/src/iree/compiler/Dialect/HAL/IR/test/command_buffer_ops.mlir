@@ -247,3 +247,18 @@ func.func @command_buffer_dispatch_indirect(
       workgroups(%buffer : !hal.buffer)[%offset]
   return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_execute_commands
+//  CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer,
+//  CHECK-SAME:  %[[COMMANDS:.+]]: !hal.command_buffer)
+func.func @command_buffer_execute_commands(
+    %cmd: !hal.command_buffer,
+    %commands: !hal.command_buffer) {
+  //      CHECK: hal.command_buffer.execute.commands<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   commands(%[[COMMANDS]] : !hal.command_buffer)
+  hal.command_buffer.execute.commands<%cmd : !hal.command_buffer>
+      commands(%commands : !hal.command_buffer)
+  return
+}
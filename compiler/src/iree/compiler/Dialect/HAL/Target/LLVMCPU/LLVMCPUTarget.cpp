@@ -7,10 +7,14 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMCPUTarget.h"
 
 #include <cstdlib>
+#include <cstring>
+#include <optional>
 #include <unordered_set>
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
+#include "iree/compiler/Codegen/Common/Passes.h"
 #include "iree/compiler/Codegen/Dialect/IREECodegenDialect.h"
+#include "iree/compiler/Codegen/LLVMCPU/DispatchABI.h"
 #include "iree/compiler/Codegen/LLVMCPU/Passes.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/Builtins/Device.h"
@@ -23,14 +27,17 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVMLinkerUtils.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Utils/ModuleUtils.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/GlobalValue.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/PDL/IR/PDL.h"
@@ -69,6 +76,32 @@ namespace HAL {
 static constexpr char kQueryFunctionName[] =
     "iree_hal_executable_library_query";
 
+// Returns true if |func| and all functions it transitively calls were tagged
+// with kFPUAgnosticAttrName during codegen. Functions that were not tagged
+// (such as declarations or linked bitcode) are assumed to depend on the
+// floating-point environment.
+static bool isFPUAgnostic(llvm::Function *func) {
+  SmallVector<llvm::Function *> worklist = {func};
+  llvm::SmallPtrSet<llvm::Function *, 8> visited = {func};
+  while (!worklist.empty()) {
+    auto *function = worklist.pop_back_val();
+    if (!function->hasFnAttribute(kFPUAgnosticAttrName))
+      return false;
+    for (auto &inst : llvm::instructions(function)) {
+      auto *callInst = dyn_cast<llvm::CallBase>(&inst);
+      if (!callInst)
+        continue;
+      // Intrinsics were vetted along with the rest of the function body.
+      auto *callee = callInst->getCalledFunction();
+      if (!callee)
+        return false;
+      if (!callee->isIntrinsic() && visited.insert(callee).second)
+        worklist.push_back(callee);
+    }
+  }
+  return true;
+}
+
 static void dumpBitcodeToPath(StringRef path, StringRef baseName,
                               StringRef suffix, StringRef extension,
                               llvm::Module &module) {
@@ -139,6 +172,93 @@ static LogicalResult appendDebugDatabase(std::vector<int8_t> &baseFile,
   return success();
 }
 
+// Returns the FatELF feature level the runtime uses to select ELFs generated
+// for |cpu| or nullopt if the CPU is not a known level.
+// Matches IREE_FATELF_FEATURE_LEVEL_* in runtime/src/iree/hal/local/elf/.
+static std::optional<uint8_t> getFatELFFeatureLevel(const llvm::Triple &triple,
+                                                    StringRef cpu) {
+  if (triple.getArch() != llvm::Triple::x86_64)
+    return std::nullopt;
+  return llvm::StringSwitch<std::optional<uint8_t>>(cpu)
+      .Cases("", "generic", "x86-64", 0)
+      .Case("x86-64-v2", 1)
+      .Case("x86-64-v3", 2)
+      .Case("x86-64-v4", 3)
+      .Case("znver4", 4)
+      .Default(std::nullopt);
+}
+
+// An embedded ELF generated for the CPU with the given FatELF feature level.
+struct FeatureLevelELF {
+  uint8_t featureLevel;
+  std::vector<int8_t> data;
+};
+
+// Packs |elfs| into a FatELF file the runtime selects from at load time.
+// See runtime/src/iree/hal/local/elf/fatelf.h for the format.
+static FailureOr<std::vector<int8_t>>
+buildFatELF(ArrayRef<FeatureLevelELF> elfs) {
+  // NOTE: like the debug database footer this assumes a little-endian host.
+  static constexpr uint64_t kPageSize = 4096;
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t recordCount;
+    uint8_t reserved;
+  };
+  struct Record {
+    uint16_t machine;
+    uint8_t osabi;
+    uint8_t osabiVersion;
+    uint8_t wordSize;
+    uint8_t byteOrder;
+    uint8_t featureLevel;
+    uint8_t reserved;
+    uint64_t offset;
+    uint64_t size;
+  };
+  static_assert(sizeof(Header) == 8 && sizeof(Record) == 24,
+                "must match the runtime FatELF structures");
+  if (elfs.size() > UINT8_MAX)
+    return failure();
+
+  Header header = {/*magic=*/0x1F0E70FA, /*version=*/1,
+                   static_cast<uint8_t>(elfs.size()), /*reserved=*/0};
+  uint64_t offset = IREE::Util::align(
+      sizeof(Header) + elfs.size() * sizeof(Record), kPageSize);
+  SmallVector<Record> records;
+  for (auto &elf : elfs) {
+    // Only the e_ident and e_machine fields common to both ELF classes are
+    // needed here.
+    static const uint8_t kELFMagic[4] = {0x7F, 'E', 'L', 'F'};
+    const auto *data = reinterpret_cast<const uint8_t *>(elf.data.data());
+    if (elf.data.size() < 20 ||
+        std::memcmp(data, kELFMagic, sizeof(kELFMagic)) != 0) {
+      return failure();
+    }
+    Record record = {0};
+    std::memcpy(&record.machine, data + 18, sizeof(record.machine));
+    record.osabi = data[7];          // EI_OSABI
+    record.osabiVersion = data[8];   // EI_ABIVERSION
+    record.wordSize = data[4];       // EI_CLASS
+    record.byteOrder = data[5] == 1; // EI_DATA: ELFDATA2LSB
+    record.featureLevel = elf.featureLevel;
+    record.offset = offset;
+    record.size = elf.data.size();
+    records.push_back(record);
+    offset = IREE::Util::align(offset + elf.data.size(), kPageSize);
+  }
+
+  std::vector<int8_t> file(offset, 0);
+  std::memcpy(file.data(), &header, sizeof(header));
+  std::memcpy(file.data() + sizeof(header), records.data(),
+              records.size() * sizeof(Record));
+  for (auto [elf, record] : llvm::zip_equal(elfs, records)) {
+    std::memcpy(file.data() + record.offset, elf.data.data(), elf.data.size());
+  }
+  return file;
+}
+
 /// Helper method to check if the variant op has a `ukernel` attribute
 /// in its `hal.executable.target`. If so, load the ukernel library
 /// for that target and link.
@@ -370,6 +490,21 @@ public:
                                     .value_or(APInt(64, 0))
                                     .getSExtValue();
 
+      // Entry points built to execute workgroup ranges are tagged during
+      // conversion; the tag is only needed to declare the export flag.
+      bool workgroupRange =
+          llvmFunc->hasFnAttribute(HALDispatchABI::kWorkgroupRangeAttrName);
+      llvmFunc->removeFnAttr(HALDispatchABI::kWorkgroupRangeAttrName);
+
+      // Codegen tags functions with the floating-point environment they
+      // require so that the runtime only switches the FPU state when needed.
+      // Entry points may call other functions (such as the workgroup body of
+      // range entry points) and are only agnostic if all callees are.
+      bool fpuAgnostic = isFPUAgnostic(llvmFunc);
+      bool preserveDenormals =
+          !fpuAgnostic &&
+          llvmFunc->hasFnAttribute(kFPUPreserveDenormalsAttrName);
+
       std::string sourceFile = "";
       int sourceLine = 0;
       if (options.debugLevel >= 1) {
@@ -380,7 +515,16 @@ public:
       }
       libraryBuilder.addExport(
           exportOp.getName(), sourceFile, sourceLine, /*tag=*/"",
-          LibraryBuilder::DispatchAttrs{localMemorySize}, llvmFunc);
+          LibraryBuilder::DispatchAttrs{localMemorySize, workgroupRange,
+                                        preserveDenormals, fpuAgnostic},
+          llvmFunc);
+    }
+
+    // The floating-point environment tags are only needed to declare the
+    // export flags above.
+    for (auto &function : llvmModule->getFunctionList()) {
+      function.removeFnAttr(kFPUAgnosticAttrName);
+      function.removeFnAttr(kFPUPreserveDenormalsAttrName);
     }
 
     auto queryFunctionName = std::string(kQueryFunctionName);
@@ -624,6 +768,38 @@ public:
                         variantOp.getName(), ".linked.bc", *llvmModule);
     }
 
+    // Clone the module for each additional CPU variant prior to optimization
+    // so that each is optimized and code generated for its own CPU. The base
+    // target must be one of the levels so the runtime knows when it can be
+    // selected.
+    SmallVector<std::pair<LLVMTarget, std::unique_ptr<llvm::Module>>>
+        cpuVariants;
+    uint8_t baseFeatureLevel = 0;
+    if (!defaultOptions_.targetCpuVariants.empty()) {
+      if (!target.getLinkEmbedded() || target.linkStatic) {
+        return variantOp.emitError()
+               << "CPU variants are only supported with embedded linking";
+      }
+      auto featureLevel = getFatELFFeatureLevel(targetTriple, target.getCpu());
+      if (!featureLevel) {
+        return variantOp.emitError()
+               << "target CPU '" << target.getCpu()
+               << "' is not a microarchitecture level supported as the base "
+                  "of CPU variants on '"
+               << targetTriple.str() << "'";
+      }
+      baseFeatureLevel = *featureLevel;
+      for (auto &cpu : defaultOptions_.targetCpuVariants) {
+        if (!getFatELFFeatureLevel(targetTriple, cpu)) {
+          return variantOp.emitError()
+                 << "unsupported CPU variant '" << cpu << "' for '"
+                 << targetTriple.str() << "'";
+        }
+        cpuVariants.emplace_back(target.getVariantForCpu(cpu),
+                                 llvm::CloneModule(*llvmModule));
+      }
+    }
+
     // LLVM opt passes that perform code generation optimizations/transformation
     // similar to what a frontend would do.
     if (failed(
@@ -649,16 +825,45 @@ public:
                         variantOp.getName(), ".optimized.bc", *llvmModule);
     }
 
+    // Static libraries emitted as bitcode are code generated by the hosting
+    // application's link-time optimization instead of here.
+    if (target.linkStatic && target.staticLibraryBitcode) {
+      SmallVector<IREE::HAL::ExecutableObjectAttr> linkerObjectAttrs;
+      IREE::HAL::ExecutableObjectAttr::filterObjects(
+          variantOp.getObjectsAttr(), {".o", ".obj", ".a", ".lib"},
+          linkerObjectAttrs);
+      if (!linkerObjectAttrs.empty()) {
+        return variantOp.emitError()
+               << "static library bitcode cannot include custom object files";
+      }
+      SmallVector<Artifact> bitcodeFiles;
+      bitcodeFiles.push_back(Artifact::createTemporary(libraryName, "bc"));
+      auto &os = bitcodeFiles.back().outputFile->os();
+      llvm::WriteBitcodeToFile(*llvmModule, os);
+      os.flush();
+      os.close();
+      return serializeStaticLibraryExecutable(options, target, variantOp,
+                                              executableBuilder, libraryName,
+                                              queryFunctionName, bitcodeFiles);
+    }
+
     SmallVector<Artifact> objectFiles;
 
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
-    {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
+    // Emit the base object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking order.
+    // When linking executables together all dispatches end up in one module
+    // so code generation is optionally split to scale across cores. Static
+    // library generation only supports one object file per library.
+    unsigned partitionCount =
+        target.linkStatic ? 1 : defaultOptions_.codegenPartitionCount;
+    SmallVector<std::string> objectDatas;
+    if (partitionCount > 1) {
+      if (failed(runEmitObjFilePassesInParallel(target, llvmModule.get(),
+                                                partitionCount, objectDatas))) {
+        return variantOp.emitError()
+               << "failed to compile LLVM-IR module to object files";
+      }
+    } else {
       std::string objectData;
       if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
                                       llvm::CodeGenFileType::ObjectFile,
@@ -666,7 +871,12 @@ public:
         return variantOp.emitError()
                << "failed to compile LLVM-IR module to an object file";
       }
-      auto objectFile = Artifact::createTemporary(libraryName, "o");
+      objectDatas.push_back(std::move(objectData));
+    }
+    for (auto [index, objectData] : llvm::enumerate(objectDatas)) {
+      auto objectFile = Artifact::createTemporary(
+          index == 0 ? libraryName : libraryName + "_" + std::to_string(index),
+          "o");
       auto &os = objectFile.outputFile->os();
       os << objectData;
       os.flush();
@@ -715,6 +925,22 @@ public:
       }
     }
 
+    // Generate an ELF for each CPU variant. Custom objects are linked into
+    // each as they are into the base ELF.
+    SmallVector<FeatureLevelELF> variantELFs;
+    ArrayRef<Artifact> customObjectFiles =
+        ArrayRef<Artifact>(objectFiles).drop_front(objectDatas.size());
+    for (auto &[variantTarget, variantModule] : cpuVariants) {
+      auto elfData = serializeCpuVariant(
+          variantOp, variantTarget, libraryName, queryFunctionName,
+          *variantModule, customObjectFiles, linkerTool.get());
+      if (failed(elfData))
+        return failure();
+      variantELFs.push_back(FeatureLevelELF{
+          *getFatELFFeatureLevel(targetTriple, variantTarget.getCpu()),
+          std::move(*elfData)});
+    }
+
     if (target.linkStatic) {
       return serializeStaticLibraryExecutable(options, target, variantOp,
                                               executableBuilder, libraryName,
@@ -722,8 +948,76 @@ public:
     } else {
       return serializeDynamicLibraryExecutable(
           options, target, variantOp, executableBuilder, libraryName,
-          targetTriple, objectFiles, linkerTool.get());
+          targetTriple, objectFiles, linkerTool.get(), baseFeatureLevel,
+          variantELFs);
+    }
+  }
+
+  // Optimizes and code generates |llvmModule| for |variantTarget| and links it
+  // into an embedded ELF along with |customObjectFiles|.
+  FailureOr<std::vector<int8_t>>
+  serializeCpuVariant(IREE::HAL::ExecutableVariantOp variantOp,
+                      const LLVMTarget &variantTarget,
+                      const std::string &libraryName,
+                      const std::string &queryFunctionName,
+                      llvm::Module &llvmModule,
+                      ArrayRef<Artifact> customObjectFiles,
+                      LinkerTool *linkerTool) {
+    auto targetMachine = createTargetMachine(variantTarget);
+    if (!targetMachine) {
+      variantOp.emitError()
+          << "failed to create target machine for CPU variant '"
+          << variantTarget.getCpu() << "'";
+      return failure();
+    }
+    if (failed(runLLVMIRPasses(variantTarget, targetMachine.get(),
+                               &llvmModule))) {
+      variantOp.emitError()
+          << "failed to run LLVM-IR opt passes for CPU variant '"
+          << variantTarget.getCpu() << "'";
+      return failure();
     }
+    SetVector<llvm::Function *> preservedFuncs;
+    preservedFuncs.insert(llvmModule.getFunction(queryFunctionName));
+    fixupVisibility(llvmModule, preservedFuncs);
+
+    std::string objectData;
+    if (failed(runEmitObjFilePasses(targetMachine.get(), &llvmModule,
+                                    llvm::CodeGenFileType::ObjectFile,
+                                    &objectData))) {
+      variantOp.emitError()
+          << "failed to compile LLVM-IR module to an object file for CPU "
+             "variant '"
+          << variantTarget.getCpu() << "'";
+      return failure();
+    }
+    SmallVector<Artifact> objectFiles;
+    objectFiles.push_back(Artifact::createTemporary(
+        libraryName + "_" + variantTarget.getCpu(), "o"));
+    auto &os = objectFiles.back().outputFile->os();
+    os << objectData;
+    os.flush();
+    os.close();
+    for (auto &customObjectFile : customObjectFiles) {
+      objectFiles.push_back(Artifact::fromFile(customObjectFile.path));
+    }
+
+    auto linkArtifactsOr = linkerTool->linkDynamicLibrary(
+        libraryName + "_" + variantTarget.getCpu(), objectFiles);
+    if (!linkArtifactsOr.has_value()) {
+      variantOp.emitError()
+          << "failed to link executable for CPU variant '"
+          << variantTarget.getCpu() << "'";
+      return failure();
+    }
+    auto elfFile = linkArtifactsOr->libraryFile.read();
+    if (!elfFile.has_value()) {
+      variantOp.emitError()
+          << "failed to read back dylib temp file at "
+          << linkArtifactsOr->libraryFile.path;
+      return failure();
+    }
+    return std::move(elfFile).value();
   }
 
   LogicalResult serializeStaticLibraryExecutable(
@@ -759,7 +1053,8 @@ public:
       const SerializationOptions &options, const LLVMTarget &target,
       IREE::HAL::ExecutableVariantOp variantOp, OpBuilder &executableBuilder,
       const std::string &libraryName, const llvm::Triple &targetTriple,
-      const SmallVector<Artifact> &objectFiles, LinkerTool *linkerTool) {
+      const SmallVector<Artifact> &objectFiles, LinkerTool *linkerTool,
+      uint8_t baseFeatureLevel, MutableArrayRef<FeatureLevelELF> variantELFs) {
     // Link the generated object files into a dylib.
     auto linkArtifactsOr =
         linkerTool->linkDynamicLibrary(libraryName, objectFiles);
@@ -787,9 +1082,25 @@ public:
                << "failed to read back dylib temp file at "
                << linkArtifacts.libraryFile.path;
       }
+      // Pack the ELFs for all CPU variants into a FatELF that the runtime
+      // selects from when loading.
+      StringRef extension = ".so";
+      if (!variantELFs.empty()) {
+        SmallVector<FeatureLevelELF> elfs;
+        elfs.push_back(FeatureLevelELF{baseFeatureLevel, std::move(*elfFile)});
+        for (auto &variantELF : variantELFs)
+          elfs.push_back(std::move(variantELF));
+        auto fatELF = buildFatELF(elfs);
+        if (failed(fatELF)) {
+          return variantOp.emitError()
+                 << "failed to pack CPU variant ELFs into a FatELF";
+        }
+        elfFile = std::move(*fatELF);
+        extension = ".sos";
+      }
       if (!options.dumpBinariesPath.empty()) {
         dumpDataToPath<int8_t>(options.dumpBinariesPath, options.dumpBaseName,
-                               variantOp.getName(), ".so", *elfFile);
+                               variantOp.getName(), extension, *elfFile);
       }
       auto bufferAttr = DenseIntElementsAttr::get(
           VectorType::get({static_cast<int64_t>(elfFile->size())},
@@ -7,6 +7,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMIRPasses.h"
 
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -137,6 +138,32 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
   return success();
 }
 
+LogicalResult
+runEmitObjFilePassesInParallel(const LLVMTarget &target, llvm::Module *module,
+                               unsigned partitionCount,
+                               SmallVectorImpl<std::string> &objData) {
+  // Target machines are not thread-safe so each partition gets its own.
+  // Verify the target up front as splitCodeGen has no way to report failure.
+  if (!createTargetMachine(target))
+    return failure();
+  SmallVector<SmallVector<char, 0>> buffers(partitionCount);
+  SmallVector<std::unique_ptr<llvm::raw_svector_ostream>> streams;
+  SmallVector<llvm::raw_pwrite_stream *> streamPtrs;
+  for (auto &buffer : buffers) {
+    streams.push_back(std::make_unique<llvm::raw_svector_ostream>(buffer));
+    streamPtrs.push_back(streams.back().get());
+  }
+  llvm::splitCodeGen(
+      *module, streamPtrs, /*BCOSs=*/{},
+      [&]() { return createTargetMachine(target); },
+      llvm::CodeGenFileType::ObjectFile);
+  streams.clear();
+  for (auto &buffer : buffers) {
+    objData.push_back(std::string(buffer.begin(), buffer.end()));
+  }
+  return success();
+}
+
 } // namespace HAL
 } // namespace IREE
 } // namespace iree_compiler
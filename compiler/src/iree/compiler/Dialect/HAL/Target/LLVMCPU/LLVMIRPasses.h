@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMTargetOptions.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Target/TargetMachine.h"
 #include "mlir/Support/LogicalResult.h"
@@ -34,6 +35,15 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
                                    llvm::CodeGenFileType fileType,
                                    std::string *objData);
 
+// Emits compiled module objs for |target| with the module split into
+// |partitionCount| partitions that are code generated in parallel, one object
+// per partition. Local symbols referenced across partitions are promoted to
+// hidden symbols in |module|.
+LogicalResult
+runEmitObjFilePassesInParallel(const LLVMTarget &target, llvm::Module *module,
+                               unsigned partitionCount,
+                               SmallVectorImpl<std::string> &objData);
+
 } // namespace HAL
 } // namespace IREE
 } // namespace iree_compiler
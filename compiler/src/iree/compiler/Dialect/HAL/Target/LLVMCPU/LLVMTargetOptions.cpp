@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVMCPU/LLVMTargetOptions.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "llvm/ADT/APFloat.h"
@@ -136,6 +137,7 @@ void LLVMTarget::print(llvm::raw_ostream &os) const {
      << "  debugSymbols=" << debugSymbols << "\n"
      << "  sanitizer=" << static_cast<int>(sanitizerKind) << "\n"
      << "  staticLibraryOutput=" << staticLibraryOutput << "\n"
+     << "  staticLibraryBitcode=" << staticLibraryBitcode << "\n"
      << "  linkStatic=" << linkStatic << "\n"
      << "  pipelineTuningOptions={\n"
      << "    LoopInterleaving=" << pipelineTuningOptions.LoopInterleaving
@@ -190,6 +192,9 @@ void LLVMTarget::storeToConfigAttrs(MLIRContext *context,
   if (!staticLibraryOutput.empty()) {
     addString("static_library_output", staticLibraryOutput);
   }
+  if (staticLibraryBitcode != DEFAULT_STATIC_LIBRARY_BITCODE) {
+    addBool("static_library_bitcode", staticLibraryBitcode);
+  }
   if (pipelineTuningOptions.LoopInterleaving != DEFAULT_LOOP_INTERLEAVING)
     addBool("loop_interleaving", DEFAULT_LOOP_INTERLEAVING);
   if (pipelineTuningOptions.LoopVectorization != DEFAULT_LOOP_VECTORIZATION)
@@ -298,6 +303,8 @@ LLVMTarget::loadFromConfigAttr(Location loc, DictionaryAttr config,
     }
   }
   target.staticLibraryOutput = getString("static_library_output", "", false);
+  target.staticLibraryBitcode = getBoolValue("static_library_bitcode",
+                                             DEFAULT_STATIC_LIBRARY_BITCODE);
   target.pipelineTuningOptions.LoopInterleaving = getBoolValue(
       "loop_interleaving", target.pipelineTuningOptions.LoopInterleaving);
   target.pipelineTuningOptions.LoopVectorization = getBoolValue(
@@ -329,6 +336,19 @@ LLVMTarget::loadFromConfigAttr(Location loc, DictionaryAttr config,
   return target;
 }
 
+LLVMTarget LLVMTarget::getVariantForCpu(std::string_view cpu) const {
+  LLVMTarget variant = *this;
+  variant.cpu = cpu;
+  variant.cpuFeatures.clear();
+  variant.addTargetCPUFeaturesForCPU();
+  if (llvm::Triple(variant.triple).isAArch64()) {
+    llvm::SubtargetFeatures targetCpuFeatures(variant.cpuFeatures);
+    targetCpuFeatures.AddFeature("reserve-x18", true);
+    variant.cpuFeatures = targetCpuFeatures.getString();
+  }
+  return variant;
+}
+
 void LLVMTarget::addTargetCPUFeaturesForCPU() {
   if (!llvm::Triple(triple).isX86()) {
     // Currently only implemented on x86.
@@ -370,6 +390,24 @@ void LLVMTargetOptions::initializeTargetInvariantFlags() {
       llvm::cl::desc("Keep LLVM linker target artifacts (.so/.dll/etc)"),
       llvm::cl::init(keepLinkerArtifacts));
   keepLinkerArtifacts = clKeepLinkerArtifacts;
+
+  static llvm::cl::opt<unsigned> clCodegenPartitionCount(
+      "iree-llvmcpu-codegen-partitions",
+      llvm::cl::desc("Splits each linked LLVM module into this many partitions "
+                     "that are code generated in parallel and linked "
+                     "together."),
+      llvm::cl::init(codegenPartitionCount));
+  codegenPartitionCount = std::max(1u, clCodegenPartitionCount.getValue());
+
+  static llvm::cl::list<std::string> clTargetCpuVariants(
+      "iree-llvmcpu-target-cpu-variants",
+      llvm::cl::desc("Additional CPU microarchitecture levels to generate "
+                     "embedded ELFs for (x86-64-v2, x86-64-v3, x86-64-v4, "
+                     "znver4). The ELFs are packed into a FatELF and the "
+                     "runtime selects the best one supported by the host."),
+      llvm::cl::CommaSeparated);
+  targetCpuVariants.assign(clTargetCpuVariants.begin(),
+                           clTargetCpuVariants.end());
 }
 
 LLVMTargetOptions LLVMTargetOptions::getHostOptions() {
@@ -483,6 +521,15 @@ LLVMTargetOptions LLVMTargetOptions::getFromFlags() {
       llvm::cl::init(target.staticLibraryOutput));
   target.staticLibraryOutput = clStaticLibraryOutputPath;
 
+  static llvm::cl::opt<bool> clStaticLibraryBitcode(
+      "iree-llvmcpu-static-library-bitcode",
+      llvm::cl::desc(
+          "Emits static libraries as LLVM bitcode ('.bc') instead of an object "
+          "file so that the hosting application can link-time optimize the "
+          "dispatches together with the runtime."),
+      llvm::cl::init(target.staticLibraryBitcode));
+  target.staticLibraryBitcode = clStaticLibraryBitcode;
+
   static llvm::cl::opt<bool> clListTargets(
       "iree-llvmcpu-list-targets",
       llvm::cl::desc("Lists all registered targets that the LLVM backend can "
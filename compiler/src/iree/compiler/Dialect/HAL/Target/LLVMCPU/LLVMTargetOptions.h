@@ -36,6 +36,7 @@ struct LLVMTarget {
   static constexpr bool DEFAULT_DEBUG_SYMBOLS = true;
   static constexpr SanitizerKind DEFAULT_SANITIZER_KIND = SanitizerKind::kNone;
   static constexpr bool DEFAULT_LINK_STATIC = false;
+  static constexpr bool DEFAULT_STATIC_LIBRARY_BITCODE = false;
   static constexpr bool DEFAULT_LOOP_INTERLEAVING = false;
   static constexpr bool DEFAULT_LOOP_VECTORIZATION = false;
   static constexpr bool DEFAULT_LOOP_UNROLLING = true;
@@ -51,6 +52,10 @@ struct LLVMTarget {
   static const LLVMTarget &getForHost();
   void print(llvm::raw_ostream &os) const;
 
+  // Returns a copy of this target generating code for |cpu| instead.
+  // The CPU features are those implied by |cpu|.
+  LLVMTarget getVariantForCpu(std::string_view cpu) const;
+
   // Stores the target to the given DictionaryAttr in a way that can be
   // later loaded from loadFromConfigAttr().
   void storeToConfigAttrs(MLIRContext *context,
@@ -91,6 +96,12 @@ struct LLVMTarget {
   // This option is incompatible with the linkEmbedded option.
   std::string staticLibraryOutput;
 
+  // Emit static libraries as LLVM bitcode ("{staticLibraryOutput}.bc") in place
+  // of the object file. Code generation is then deferred to the hosting
+  // application's link-time optimization, where the dispatches can be
+  // optimized together with the runtime.
+  bool staticLibraryBitcode = DEFAULT_STATIC_LIBRARY_BITCODE;
+
   // Link any required runtime libraries into the produced binaries statically.
   // This increases resulting binary size but enables the binaries to be used on
   // any machine without requiring matching system libraries to be installed.
@@ -127,6 +138,19 @@ struct LLVMTargetOptions {
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
 
+  // Number of partitions each linked LLVM module is split into for code
+  // generation. Partitions are code generated in parallel into separate object
+  // files that are then linked together. The partitioning is deterministic for
+  // a given count so binaries are reproducible. Static library output always
+  // uses a single partition.
+  unsigned codegenPartitionCount = 1;
+
+  // Additional CPUs (microarchitecture levels such as x86-64-v3) to generate
+  // code for. When set, embedded ELFs are emitted as FatELFs containing one
+  // ELF per CPU and the runtime selects the best one supported by the host.
+  // All variants are compiled from the IR produced for the base target.
+  SmallVector<std::string> targetCpuVariants;
+
   // Returns LLVMTargetOptions that are suitable for running on the host.
   // This does not configure the options from global flags unless if they
   // are target invariant.
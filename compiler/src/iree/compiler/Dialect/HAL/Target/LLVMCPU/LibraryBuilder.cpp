@@ -398,7 +398,7 @@ LibraryBuilder::buildLibraryV0ExportTable(std::string libraryName) {
       llvm::find_if(exports, [](const Dispatch &dispatch) {
         return !dispatch.attrs.isDefault();
       }) != exports.end();
-  if (!hasNonDefaultAttrs) {
+  if (hasNonDefaultAttrs) {
     SmallVector<llvm::Constant *> exportAttrValues;
     for (auto dispatch : exports) {
       exportAttrValues.push_back(llvm::ConstantStruct::get(
@@ -409,8 +409,8 @@ LibraryBuilder::buildLibraryV0ExportTable(std::string libraryName) {
                   i16Type, RoundUpToAlignment(dispatch.attrs.localMemorySize,
                                               kWorkgroupLocalMemoryPageSize) /
                                kWorkgroupLocalMemoryPageSize),
-              // reserved=
-              llvm::ConstantInt::get(i16Type, 0),
+              // flags=
+              llvm::ConstantInt::get(i16Type, dispatch.attrs.getFlags()),
           }));
     }
     auto *exportAttrsType =
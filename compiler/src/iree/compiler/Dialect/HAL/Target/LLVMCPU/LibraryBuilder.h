@@ -75,6 +75,20 @@ public:
     UNDEFINED = 4u,
   };
 
+  // iree_hal_executable_dispatch_flags_v0_t
+  enum class DispatchFlags : uint16_t {
+    // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE
+    NONE = 0u,
+    // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE
+    WORKGROUP_RANGE = 1u << 0,
+    // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PRESERVE_DENORMALS
+    PRESERVE_DENORMALS = 1u << 1,
+    // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_FPU_AGNOSTIC
+    FPU_AGNOSTIC = 1u << 2,
+    // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH
+    WHOLE_DISPATCH = 1u << 3,
+  };
+
   // IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
   static const int64_t kWorkgroupLocalMemoryPageSize = 4096;
 
@@ -83,8 +97,32 @@ public:
     // Required workgroup local memory size, in bytes.
     int64_t localMemorySize = 0;
 
+    // True if the export executes workgroup_range_count workgroups per call.
+    bool workgroupRange = false;
+
+    // True if the export requires IEEE denormal handling.
+    bool preserveDenormals = false;
+
+    // True if the export does not depend on the floating-point environment.
+    bool fpuAgnostic = false;
+
     // True if all values are default and the attributes may be omitted.
-    constexpr bool isDefault() const { return localMemorySize == 0; }
+    constexpr bool isDefault() const {
+      return localMemorySize == 0 && !workgroupRange && !preserveDenormals &&
+             !fpuAgnostic;
+    }
+
+    // Returns the DispatchFlags bits for the attributes.
+    constexpr uint16_t getFlags() const {
+      uint16_t flags = static_cast<uint16_t>(DispatchFlags::NONE);
+      if (workgroupRange)
+        flags |= static_cast<uint16_t>(DispatchFlags::WORKGROUP_RANGE);
+      if (preserveDenormals)
+        flags |= static_cast<uint16_t>(DispatchFlags::PRESERVE_DENORMALS);
+      if (fpuAgnostic)
+        flags |= static_cast<uint16_t>(DispatchFlags::FPU_AGNOSTIC);
+      return flags;
+    }
   };
 
   LibraryBuilder(llvm::Module *module, Mode mode,
@@ -91,8 +91,10 @@ bool outputStaticLibrary(const std::string &library_name,
                          const std::string &query_function_name,
                          const std::string &library_output_path,
                          const std::string &temp_object_path) {
+  // The library is either an object file or bitcode; keep its extension.
   llvm::SmallString<32> object_file_path(library_output_path);
-  llvm::sys::path::replace_extension(object_file_path, ".o");
+  llvm::sys::path::replace_extension(
+      object_file_path, llvm::sys::path::extension(temp_object_path));
   llvm::SmallString<32> header_file_path(library_output_path);
   llvm::sys::path::replace_extension(header_file_path, ".h");
 
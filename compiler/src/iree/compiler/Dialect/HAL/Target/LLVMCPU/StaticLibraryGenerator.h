@@ -16,7 +16,8 @@ namespace IREE {
 namespace HAL {
 
 // Produces a static executable library and generated '.h'.
-// The temporary object file is copied to the library_output_path. The '.h' file
+// The temporary object (or bitcode) file is copied to the library_output_path
+// using the extension of the temporary file. The '.h' file
 // with the query_function_name is placed beside it (using the same base
 // filename of the library). Returns true if successful.
 bool outputStaticLibrary(const std::string &library_name,
@@ -82,6 +82,14 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-dir", executableCachePath,
+      llvm::cl::desc(
+          "Directory used to cache translated and serialized executables "
+          "across compilations. The cache is not invalidated by compiler "
+          "changes and should be scoped to a compiler build."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 void dumpDataToPath(StringRef path, StringRef baseName, StringRef suffix,
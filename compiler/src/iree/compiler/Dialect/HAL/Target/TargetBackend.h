@@ -55,6 +55,11 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // A directory used to cache translated and serialized executables across
+  // compilations. Executables identical to ones previously compiled with the
+  // same cache skip translation and serialization.
+  std::string executableCachePath;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
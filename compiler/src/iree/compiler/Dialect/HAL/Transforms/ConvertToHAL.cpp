@@ -21,6 +21,8 @@
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Dialect/Util/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
@@ -38,6 +40,30 @@ namespace IREE {
 namespace HAL {
 namespace {
 
+// Records the IDs of the devices the module was compiled for, in order of
+// preference, as module reflection metadata. Hosting applications can use this
+// to pick an available device when loading the module; executables then only
+// load the variants matching the selected device (see
+// MaterializeResourceCaches).
+static void recordDeviceTargets(mlir::ModuleOp moduleOp) {
+  auto targetAttrs = IREE::HAL::DeviceTargetAttr::lookup(moduleOp);
+  if (targetAttrs.empty())
+    return;
+  SmallVector<StringRef> deviceIDs;
+  for (auto targetAttr : targetAttrs) {
+    auto deviceID = targetAttr.getDeviceID().getValue();
+    if (!llvm::is_contained(deviceIDs, deviceID))
+      deviceIDs.push_back(deviceID);
+  }
+  auto *context = moduleOp.getContext();
+  NamedAttrList reflectionAttrs(
+      moduleOp->getAttrOfType<DictionaryAttr>("iree.reflection"));
+  reflectionAttrs.set("hal.device.targets",
+                      StringAttr::get(context, llvm::join(deviceIDs, ",")));
+  moduleOp->setAttr("iree.reflection",
+                    reflectionAttrs.getDictionary(context));
+}
+
 // A pass converting the IREE flow dialect into the IREE HAL dialect.
 class ConvertToHALPass
     : public PassWrapper<ConvertToHALPass, OperationPass<ModuleOp>> {
@@ -100,6 +126,8 @@ public:
                                       std::move(patterns)))) {
       return signalPassFailure();
     }
+
+    recordDeviceTargets(getOperation());
   }
 };
 
@@ -0,0 +1,98 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/Transforms/ExecutableCache.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/Parser/Parser.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Bump when the entry format or key derivation changes.
+static const char kCacheFormatVersion[] = "iree-hal-executable-cache-v0";
+
+std::string getExecutableCacheKey(Operation *op, ArrayRef<StringRef> salts) {
+  llvm::SHA256 hasher;
+  hasher.update(kCacheFormatVersion);
+  for (auto salt : salts) {
+    // Length-prefix each salt so that adjacent salts can't alias.
+    hasher.update(std::to_string(salt.size()));
+    hasher.update(":");
+    hasher.update(salt);
+  }
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  op->print(os, OpPrintingFlags().useLocalScope());
+  hasher.update(os.str());
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+static std::string getEntryPath(StringRef cachePath, StringRef key) {
+  SmallString<256> path(cachePath);
+  llvm::sys::path::append(path, key + ".mlirbc");
+  return std::string(path.str());
+}
+
+OwningOpRef<mlir::ModuleOp> loadExecutableCacheEntry(StringRef cachePath,
+                                                     StringRef key,
+                                                     MLIRContext *context) {
+  auto path = getEntryPath(cachePath, key);
+  if (!llvm::sys::fs::exists(path))
+    return {};
+  // Entries hold ops outside of their usual parent (binaries outside of an
+  // executable, etc) and were verified when they were produced.
+  ParserConfig config(context, /*verifyAfterParse=*/false);
+  return parseSourceFile<mlir::ModuleOp>(path, config);
+}
+
+void storeExecutableCacheEntry(StringRef cachePath, StringRef key,
+                               ArrayRef<Operation *> ops) {
+  if (ops.empty())
+    return;
+  auto loc = ops.front()->getLoc();
+  if (auto ec = llvm::sys::fs::create_directories(cachePath)) {
+    mlir::emitWarning(loc) << "unable to create executable cache directory "
+                           << cachePath << ": " << ec.message();
+    return;
+  }
+
+  OwningOpRef<mlir::ModuleOp> moduleOp =
+      mlir::ModuleOp::create(UnknownLoc::get(loc.getContext()));
+  auto moduleBuilder = OpBuilder::atBlockEnd(moduleOp->getBody());
+  for (auto *op : ops)
+    moduleBuilder.clone(*op);
+
+  // writeToOutput goes through a temporary file that is renamed into place
+  // so readers never observe partially written entries.
+  auto path = getEntryPath(cachePath, key);
+  auto error = llvm::writeToOutput(path, [&](raw_ostream &os) -> llvm::Error {
+    if (failed(writeBytecodeToFile(*moduleOp, os))) {
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "failed to write bytecode");
+    }
+    return llvm::Error::success();
+  });
+  if (error) {
+    mlir::emitWarning(loc) << "unable to write executable cache entry " << path
+                           << ": " << llvm::toString(std::move(error));
+  }
+}
+
+} // namespace HAL
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -0,0 +1,57 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_HAL_TRANSFORMS_EXECUTABLECACHE_H_
+#define IREE_COMPILER_DIALECT_HAL_TRANSFORMS_EXECUTABLECACHE_H_
+
+#include <string>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Content-addressed on-disk cache of executable translation and serialization
+// results shared across compiler invocations.
+//
+// Entries are keyed by the printed IR of the op being processed and a set of
+// salts capturing everything else that influences the result (stage, target
+// backend, pass pipeline, debug level, etc). Locations are not part of the key
+// so that executables shared between otherwise unrelated programs hit: debug
+// information in cached results reflects the compilation that populated the
+// entry. Flags that change backend behavior without being reflected in the
+// IR or the salts and changes to the compiler itself do not invalidate
+// entries; the cache directory should be scoped to a compiler build and flag
+// set.
+
+// Returns a stable hex key for |op| combined with |salts|.
+std::string getExecutableCacheKey(Operation *op, ArrayRef<StringRef> salts);
+
+// Loads the ops stored under |key| in |cachePath|.
+// The ops are returned in a module in the order they were stored and must be
+// cloned into their final location. Returns nullptr if there is no entry.
+OwningOpRef<mlir::ModuleOp> loadExecutableCacheEntry(StringRef cachePath,
+                                                     StringRef key,
+                                                     MLIRContext *context);
+
+// Stores clones of |ops| under |key| in |cachePath|.
+// Entries are written atomically so concurrent compilations sharing a cache
+// directory are safe. Failures are reported as warnings on the first op and
+// otherwise ignored as the cache is only an optimization.
+void storeExecutableCacheEntry(StringRef cachePath, StringRef key,
+                               ArrayRef<Operation *> ops);
+
+} // namespace HAL
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
+
+#endif // IREE_COMPILER_DIALECT_HAL_TRANSFORMS_EXECUTABLECACHE_H_
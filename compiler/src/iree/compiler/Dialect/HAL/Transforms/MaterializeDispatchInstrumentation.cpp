@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Stream/Analysis/DispatchCost.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
@@ -188,8 +189,9 @@ public:
         if (!funcOp)
           continue;
 
-        // Capture the source before we mess with it.
+        // Capture the source and cost before we mess with it.
         auto originalSource = getOpStr(funcOp);
+        auto cost = IREE::Stream::estimateDispatchCost(funcOp);
 
         // Mark as instrumented.
         instrumentedExports[SymbolRefAttr::get(
@@ -237,6 +239,12 @@ public:
                                                         targetRef);
         iree_instruments_DispatchFunctionDef_source_add(metadataBuilder,
                                                         sourceRef);
+        if (cost.isComplete) {
+          iree_instruments_DispatchFunctionDef_flops_add(metadataBuilder,
+                                                         cost.flops);
+          iree_instruments_DispatchFunctionDef_bytes_add(metadataBuilder,
+                                                         cost.bytes);
+        }
         dispatchFunctionRefs.push_back(
             iree_instruments_DispatchFunctionDef_end(metadataBuilder));
       }
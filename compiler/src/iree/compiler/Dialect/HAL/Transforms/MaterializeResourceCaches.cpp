@@ -18,6 +18,7 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir {
@@ -112,6 +113,11 @@ public:
     for (auto lookupOp : executableLookupOps) {
       replaceExecutableLookupOp(lookupOp);
     }
+
+    // Run the initializers that don't need executables, such as the ones
+    // issuing asynchronous constant uploads, before creating the executables
+    // so that the uploads overlap with executable loading.
+    sinkExecutableInitializers(moduleOp);
   }
 
 private:
@@ -215,6 +221,7 @@ private:
     executableCache_.try_emplace(executableOp.getSymName(), globalOp);
 
     auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
+    executableInitializerOps_.push_back(initializerOp);
     OpBuilder blockBuilder =
         OpBuilder::atBlockEnd(initializerOp.addEntryBlock());
     auto deviceValue = blockBuilder.createOrFold<ExSharedDeviceOp>(loc);
@@ -362,6 +369,55 @@ private:
     lookupOp.erase();
   }
 
+  // Returns true if |initializerOp| may use any executable. Calls are
+  // conservatively assumed to.
+  bool mayUseExecutables(IREE::Util::InitializerOp initializerOp) {
+    auto result = initializerOp.walk([&](Operation *op) {
+      if (isa<CallOpInterface>(op))
+        return WalkResult::interrupt();
+      if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOp>(op)) {
+        if (isa<ExecutableType>(loadOp.getResult().getType()))
+          return WalkResult::interrupt();
+      }
+      return WalkResult::advance();
+    });
+    return result.wasInterrupted();
+  }
+
+  // Moves the executable initializers right before the first other initializer
+  // that may use an executable, or after the last initializer if none do.
+  // Executable creation is synchronous and would otherwise delay the work
+  // issued by all later initializers.
+  void sinkExecutableInitializers(ModuleOp moduleOp) {
+    if (executableInitializerOps_.empty())
+      return;
+    DenseSet<Operation *> executableInitializerOps(
+        executableInitializerOps_.begin(), executableInitializerOps_.end());
+    Operation *lastInitializerOp = nullptr;
+    Operation *firstUserOp = nullptr;
+    for (auto initializerOp : moduleOp.getOps<IREE::Util::InitializerOp>()) {
+      if (executableInitializerOps.contains(initializerOp))
+        continue;
+      if (mayUseExecutables(initializerOp)) {
+        firstUserOp = initializerOp;
+        break;
+      }
+      lastInitializerOp = initializerOp;
+    }
+    for (auto initializerOp : executableInitializerOps_) {
+      if (!lastInitializerOp ||
+          lastInitializerOp->isBeforeInBlock(initializerOp)) {
+        continue; // Nothing to overlap with.
+      }
+      if (firstUserOp) {
+        initializerOp->moveBefore(firstUserOp);
+      } else {
+        initializerOp->moveAfter(lastInitializerOp);
+        lastInitializerOp = initializerOp;
+      }
+    }
+  }
+
   TargetOptions targetOptions_;
 
   OpBuilder moduleBuilder{static_cast<MLIRContext *>(nullptr)};
@@ -370,6 +426,7 @@ private:
       descriptorSetLayoutCache_;
   DenseMap<Attribute, IREE::Util::GlobalOp> pipelineLayoutCache_;
   DenseMap<StringRef, IREE::Util::GlobalOp> executableCache_;
+  SmallVector<IREE::Util::InitializerOp> executableInitializerOps_;
 
   int nextUniqueConstantBlockId = 0;
   int nextUniquePipelineLayoutId = 0;
@@ -0,0 +1,429 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <memory>
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+namespace {
+
+// Size of the x/y/z workgroup counts read by an indirect dispatch.
+static constexpr int64_t kWorkgroupCountsSize = 3 * sizeof(uint32_t);
+
+// Tracks which values can be recomputed at initialization time.
+// Static values are constants, loads of immutable globals, and pure ops
+// (without regions) whose operands are all static.
+class StaticValueAnalysis {
+public:
+  explicit StaticValueAnalysis(SymbolTable &symbolTable)
+      : symbolTable(symbolTable) {}
+
+  bool isStatic(Value value) {
+    auto it = cache.find(value);
+    if (it != cache.end())
+      return it->second;
+    bool result = computeIsStatic(value);
+    cache[value] = result;
+    return result;
+  }
+
+private:
+  bool computeIsStatic(Value value) {
+    auto *op = value.getDefiningOp();
+    if (!op)
+      return false; // block arguments vary per invocation
+    if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOp>(op)) {
+      // Immutable globals are stored by initializers that run before the ones
+      // we create at the end of the module.
+      auto globalOp =
+          symbolTable.lookup<IREE::Util::GlobalOp>(loadOp.getGlobal());
+      return globalOp && !globalOp.getIsMutable();
+    }
+    if (op->getNumRegions() != 0 || !isMemoryEffectFree(op))
+      return false;
+    return llvm::all_of(op->getOperands(),
+                        [&](Value operand) { return isStatic(operand); });
+  }
+
+  SymbolTable &symbolTable;
+  DenseMap<Value, bool> cache;
+};
+
+// A command buffer that is created, recorded, and finalized within a single
+// block from static values and then only submitted.
+struct MemoizableCommandBuffer {
+  IREE::HAL::CommandBufferCreateOp createOp;
+  // All ops recording into the command buffer in program order.
+  SmallVector<Operation *> recordOps;
+  IREE::HAL::CommandBufferFinalizeOp finalizeOp;
+  // Dispatches whose workgroup counts vary per invocation. These are recorded
+  // as indirect dispatches and the counts are written before each submission.
+  SmallVector<IREE::HAL::CommandBufferDispatchOp> indirectDispatchOps;
+  // The only submission of the command buffer if it has indirect dispatches.
+  IREE::HAL::DeviceQueueExecuteOp executeOp;
+};
+
+static std::optional<MemoizableCommandBuffer>
+analyzeCommandBuffer(IREE::HAL::CommandBufferCreateOp createOp,
+                     StaticValueAnalysis &analysis) {
+  MemoizableCommandBuffer result;
+  result.createOp = createOp;
+  auto *block = createOp->getBlock();
+  Value commandBuffer = createOp.getResult();
+  SmallVector<Operation *> users;
+  for (auto *user : commandBuffer.getUsers()) {
+    if (user->getBlock() != block)
+      return std::nullopt;
+    users.push_back(user);
+  }
+  llvm::sort(users, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+  SmallVector<Operation *> submitOps;
+  for (auto *user : users) {
+    if (result.finalizeOp) {
+      // After finalization the command buffer may only be submitted or
+      // executed as a nested command buffer.
+      auto executeOp =
+          dyn_cast<IREE::HAL::CommandBufferExecuteCommandsOp>(user);
+      if (!isa<IREE::HAL::DeviceQueueExecuteOp>(user) &&
+          !(executeOp && executeOp.getCommandBuffer() != commandBuffer))
+        return std::nullopt;
+      submitOps.push_back(user);
+      continue;
+    }
+    if (auto finalizeOp = dyn_cast<IREE::HAL::CommandBufferFinalizeOp>(user)) {
+      result.finalizeOp = finalizeOp;
+      continue;
+    }
+    // Recording ops produce no values; anything else (such as querying the
+    // device or passing the command buffer along) may observe the recording.
+    if (user->getNumResults() != 0 ||
+        !user->getName().getStringRef().starts_with("hal.command_buffer."))
+      return std::nullopt;
+    result.recordOps.push_back(user);
+  }
+  if (!result.finalizeOp)
+    return std::nullopt;
+
+  auto isStaticOperand = [&](Value operand) {
+    return operand == commandBuffer || analysis.isStatic(operand);
+  };
+  if (!llvm::all_of(createOp->getOperands(), isStaticOperand))
+    return std::nullopt;
+  for (auto *recordOp : result.recordOps) {
+    if (auto dispatchOp =
+            dyn_cast<IREE::HAL::CommandBufferDispatchOp>(recordOp)) {
+      if (!isStaticOperand(dispatchOp.getExecutable()))
+        return std::nullopt;
+      Value workgroupCounts[] = {
+          dispatchOp.getWorkgroupX(),
+          dispatchOp.getWorkgroupY(),
+          dispatchOp.getWorkgroupZ(),
+      };
+      if (!llvm::all_of(workgroupCounts, isStaticOperand))
+        result.indirectDispatchOps.push_back(dispatchOp);
+      continue;
+    }
+    if (!llvm::all_of(recordOp->getOperands(), isStaticOperand))
+      return std::nullopt;
+  }
+
+  // The workgroup counts of indirect dispatches are overwritten by the next
+  // invocation once the submission reading them has completed. That's only
+  // known when the command buffer is directly submitted exactly once.
+  if (!result.indirectDispatchOps.empty()) {
+    if (submitOps.size() != 1)
+      return std::nullopt;
+    result.executeOp =
+        dyn_cast<IREE::HAL::DeviceQueueExecuteOp>(submitOps.front());
+    if (!result.executeOp)
+      return std::nullopt;
+  }
+  return result;
+}
+
+// Clones the ops producing static |value| into |builder| and returns the
+// value in the new location.
+static Value cloneStaticValue(Value value, OpBuilder &builder,
+                              IRMapping &mapping) {
+  if (auto mappedValue = mapping.lookupOrNull(value))
+    return mappedValue;
+  auto *op = value.getDefiningOp();
+  for (auto operand : op->getOperands())
+    cloneStaticValue(operand, builder, mapping);
+  builder.clone(*op, mapping);
+  return mapping.lookup(value);
+}
+
+static void memoizeCommandBuffer(MemoizableCommandBuffer &memoizable,
+                                 SymbolTable &symbolTable,
+                                 OpBuilder &moduleBuilder) {
+  auto createOp = memoizable.createOp;
+  auto loc = createOp.getLoc();
+  auto commandBufferType = createOp.getResult().getType();
+  auto bufferType = IREE::HAL::BufferType::get(moduleBuilder.getContext());
+  auto fenceType = IREE::HAL::FenceType::get(moduleBuilder.getContext());
+  bool hasIndirectDispatches = !memoizable.indirectDispatchOps.empty();
+
+  auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+      loc, "_command_buffer", /*isMutable=*/false, commandBufferType);
+  globalOp.setPrivate();
+  symbolTable.insert(globalOp);
+
+  // Indirect dispatches read their workgroup counts from a buffer that is
+  // written before each submission. The fence of the last submission guards
+  // against overwriting the counts while they are still in use.
+  IREE::Util::GlobalOp workgroupsGlobalOp;
+  IREE::Util::GlobalOp fenceGlobalOp;
+  if (hasIndirectDispatches) {
+    workgroupsGlobalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+        loc, "_command_buffer_workgroups", /*isMutable=*/false, bufferType);
+    workgroupsGlobalOp.setPrivate();
+    symbolTable.insert(workgroupsGlobalOp);
+    fenceGlobalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+        loc, "_command_buffer_fence", /*isMutable=*/true, fenceType);
+    fenceGlobalOp.setPrivate();
+    symbolTable.insert(fenceGlobalOp);
+  }
+
+  // Record the command buffer once during initialization. It is submitted
+  // multiple times and so cannot be one-shot or executed inline.
+  auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
+  auto initializerBuilder =
+      OpBuilder::atBlockBegin(initializerOp.addEntryBlock());
+  IRMapping mapping;
+  DenseMap<Operation *, int64_t> indirectDispatchOrdinals;
+  for (auto [ordinal, dispatchOp] :
+       llvm::enumerate(memoizable.indirectDispatchOps)) {
+    indirectDispatchOrdinals[dispatchOp] = ordinal;
+  }
+  auto cloneOperands = [&](Operation *op) {
+    if (indirectDispatchOrdinals.count(op)) {
+      auto dispatchOp = cast<IREE::HAL::CommandBufferDispatchOp>(op);
+      cloneStaticValue(dispatchOp.getExecutable(), initializerBuilder,
+                       mapping);
+      return;
+    }
+    for (auto operand : op->getOperands()) {
+      if (operand != createOp.getResult())
+        cloneStaticValue(operand, initializerBuilder, mapping);
+    }
+  };
+  cloneOperands(createOp);
+  for (auto *recordOp : memoizable.recordOps)
+    cloneOperands(recordOp);
+  Value workgroupsBuffer;
+  if (hasIndirectDispatches) {
+    auto allocator = initializerBuilder
+                         .create<IREE::HAL::DeviceAllocatorOp>(
+                             loc, mapping.lookup(createOp.getDevice()))
+                         .getResult();
+    auto queueAffinity =
+        initializerBuilder.create<arith::ConstantIntOp>(loc, -1, 64);
+    auto memoryTypes = IREE::HAL::MemoryTypeBitfield::HostVisible |
+                       IREE::HAL::MemoryTypeBitfield::DeviceVisible;
+    auto bufferUsage = IREE::HAL::BufferUsageBitfield::DispatchIndirectParams |
+                       IREE::HAL::BufferUsageBitfield::Mapping;
+    auto bufferSize = initializerBuilder.create<arith::ConstantIndexOp>(
+        loc, memoizable.indirectDispatchOps.size() * kWorkgroupCountsSize);
+    workgroupsBuffer =
+        initializerBuilder
+            .create<IREE::HAL::AllocatorAllocateOp>(
+                loc, bufferType, allocator, queueAffinity, memoryTypes,
+                bufferUsage, bufferSize)
+            .getResult();
+    initializerBuilder.create<IREE::Util::GlobalStoreOp>(
+        loc, workgroupsBuffer, workgroupsGlobalOp.getName());
+  }
+  auto modes = createOp.getModes() &
+               ~(IREE::HAL::CommandBufferModeBitfield::OneShot |
+                 IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution);
+  auto newCreateOp =
+      initializerBuilder.create<IREE::HAL::CommandBufferCreateOp>(
+          loc, commandBufferType, mapping.lookup(createOp.getDevice()),
+          modes, createOp.getCommandCategories(),
+          createOp.getBindingCapacity()
+              ? mapping.lookup(createOp.getBindingCapacity())
+              : Value{});
+  mapping.map(createOp.getResult(), newCreateOp.getResult());
+  for (auto *recordOp : memoizable.recordOps) {
+    auto it = indirectDispatchOrdinals.find(recordOp);
+    if (it == indirectDispatchOrdinals.end()) {
+      initializerBuilder.clone(*recordOp, mapping);
+      continue;
+    }
+    auto dispatchOp = cast<IREE::HAL::CommandBufferDispatchOp>(recordOp);
+    auto workgroupsOffset = initializerBuilder.create<arith::ConstantIndexOp>(
+        dispatchOp.getLoc(), it->second * kWorkgroupCountsSize);
+    initializerBuilder.create<IREE::HAL::CommandBufferDispatchIndirectOp>(
+        dispatchOp.getLoc(), newCreateOp.getResult(),
+        mapping.lookup(dispatchOp.getExecutable()),
+        dispatchOp.getEntryPointAttr(), workgroupsBuffer, workgroupsOffset);
+  }
+  initializerBuilder.create<IREE::HAL::CommandBufferFinalizeOp>(
+      memoizable.finalizeOp.getLoc(), newCreateOp.getResult());
+  initializerBuilder.create<IREE::Util::GlobalStoreOp>(
+      loc, newCreateOp.getResult(), globalOp.getName());
+  initializerBuilder.create<IREE::Util::InitializerReturnOp>(loc);
+
+  // Replace the recording with the memoized command buffer. Submissions
+  // remain where they were.
+  OpBuilder replaceBuilder(createOp);
+  auto loadOp = replaceBuilder.create<IREE::Util::GlobalLoadOp>(
+      loc, commandBufferType, globalOp.getName());
+  if (hasIndirectDispatches) {
+    // Wait for the previous submission before overwriting the workgroup
+    // counts it reads. The fence is null until the first submission.
+    auto fenceLoadOp = replaceBuilder.create<IREE::Util::GlobalLoadOp>(
+        loc, fenceType, fenceGlobalOp.getName());
+    Value timeoutMillis =
+        replaceBuilder.create<arith::ConstantIntOp>(loc, -1, 32);
+    auto awaitOp = replaceBuilder.create<IREE::HAL::FenceAwaitOp>(
+        loc, replaceBuilder.getI32Type(), timeoutMillis,
+        fenceLoadOp.getResult());
+    replaceBuilder.create<IREE::Util::StatusCheckOkOp>(
+        loc, awaitOp.getStatus(), "failed to wait on previous submission");
+    auto workgroupsLoadOp = replaceBuilder.create<IREE::Util::GlobalLoadOp>(
+        loc, bufferType, workgroupsGlobalOp.getName());
+
+    // Write the workgroup counts where each dispatch was recorded; they are
+    // only available from there on.
+    for (auto [ordinal, dispatchOp] :
+         llvm::enumerate(memoizable.indirectDispatchOps)) {
+      OpBuilder dispatchBuilder(dispatchOp);
+      Value workgroupCounts[] = {
+          dispatchOp.getWorkgroupX(),
+          dispatchOp.getWorkgroupY(),
+          dispatchOp.getWorkgroupZ(),
+      };
+      for (auto [i, workgroupCount] : llvm::enumerate(workgroupCounts)) {
+        auto offset = dispatchBuilder.create<arith::ConstantIndexOp>(
+            dispatchOp.getLoc(),
+            ordinal * kWorkgroupCountsSize + i * sizeof(uint32_t));
+        auto value = dispatchBuilder.create<arith::IndexCastOp>(
+            dispatchOp.getLoc(), dispatchBuilder.getI32Type(),
+            workgroupCount);
+        dispatchBuilder.create<IREE::HAL::BufferStoreOp>(
+            dispatchOp.getLoc(), value, workgroupsLoadOp.getResult(), offset);
+      }
+    }
+
+    auto executeOp = memoizable.executeOp;
+    OpBuilder submitBuilder(executeOp->getContext());
+    submitBuilder.setInsertionPointAfter(executeOp);
+    submitBuilder.create<IREE::Util::GlobalStoreOp>(
+        executeOp.getLoc(), executeOp.getSignalFence(),
+        fenceGlobalOp.getName());
+  }
+  SmallVector<Operation *> erasedOps;
+  erasedOps.push_back(memoizable.finalizeOp);
+  llvm::append_range(erasedOps, llvm::reverse(memoizable.recordOps));
+  createOp.getResult().replaceAllUsesWith(loadOp.getResult());
+  erasedOps.push_back(createOp);
+
+  // Erase the recording along with any static values only it used.
+  SetVector<Operation *> deadOpCandidates;
+  while (!erasedOps.empty()) {
+    auto *op = erasedOps.pop_back_val();
+    for (auto operand : op->getOperands()) {
+      if (auto *definingOp = operand.getDefiningOp())
+        deadOpCandidates.insert(definingOp);
+    }
+    deadOpCandidates.remove(op);
+    op->erase();
+    if (erasedOps.empty()) {
+      for (auto *candidateOp : deadOpCandidates) {
+        if (isOpTriviallyDead(candidateOp))
+          erasedOps.push_back(candidateOp);
+      }
+      for (auto *deadOp : erasedOps)
+        deadOpCandidates.remove(deadOp);
+    }
+  }
+}
+
+// NOTE: only command buffers whose every recorded operand is known at
+// initialization time are memoized, with the exception of dispatch workgroup
+// counts which are made indirect. Command buffers referencing transient
+// resources would need their bindings made indirect (binding tables) and
+// provided at submission time.
+class MemoizeCommandBuffersPass
+    : public PassWrapper<MemoizeCommandBuffersPass, OperationPass<ModuleOp>> {
+public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect>();
+    registry.insert<IREE::HAL::HALDialect>();
+    registry.insert<IREE::Util::UtilDialect>();
+  }
+
+  StringRef getArgument() const override {
+    return "iree-hal-memoize-command-buffers";
+  }
+
+  StringRef getDescription() const override {
+    return "Records command buffers with static contents once at "
+           "initialization and reuses them for each submission";
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SymbolTable symbolTable(moduleOp);
+    StaticValueAnalysis analysis(symbolTable);
+
+    // Initializers only run once and gain nothing from memoization.
+    SmallVector<MemoizableCommandBuffer> memoizables;
+    for (auto callableOp : moduleOp.getOps<mlir::CallableOpInterface>()) {
+      if (isa<IREE::Util::InitializerOp>(callableOp))
+        continue;
+      callableOp.walk([&](IREE::HAL::CommandBufferCreateOp createOp) {
+        if (auto memoizable = analyzeCommandBuffer(createOp, analysis)) {
+          memoizables.push_back(std::move(*memoizable));
+        }
+      });
+    }
+    if (memoizables.empty())
+      return;
+
+    // Initializers are appended so that they run after those storing the
+    // immutable globals they reference.
+    auto moduleBuilder = OpBuilder::atBlockEnd(moduleOp.getBody());
+    for (auto &memoizable : memoizables) {
+      memoizeCommandBuffer(memoizable, symbolTable, moduleBuilder);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>> createMemoizeCommandBuffersPass() {
+  return std::make_unique<MemoizeCommandBuffersPass>();
+}
+
+static PassRegistration<MemoizeCommandBuffersPass> pass;
+
+} // namespace HAL
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
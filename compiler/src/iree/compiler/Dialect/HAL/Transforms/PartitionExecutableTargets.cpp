@@ -0,0 +1,142 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Returns true if the device target executes on the host CPU.
+static bool isHostDeviceTarget(IREE::HAL::DeviceTargetAttr targetAttr) {
+  auto deviceID = targetAttr.getDeviceID().getValue();
+  return deviceID == "llvm-cpu" || deviceID == "vmvx" ||
+         deviceID == "vmvx-inline";
+}
+
+// Returns the total number of workload elements of |dispatchOp| or nullopt if
+// any dimension is dynamic or the export takes no workload.
+static std::optional<int64_t>
+getStaticWorkload(IREE::Stream::CmdDispatchOp dispatchOp) {
+  auto workloadValues = dispatchOp.getWorkload();
+  if (workloadValues.empty())
+    return std::nullopt;
+  int64_t workload = 1;
+  for (auto workloadValue : workloadValues) {
+    APInt workloadConstValue;
+    if (!matchPattern(workloadValue, m_ConstantInt(&workloadConstValue))) {
+      return std::nullopt;
+    }
+    workload *= workloadConstValue.getSExtValue();
+  }
+  return workload;
+}
+
+class PartitionExecutableTargetsPass
+    : public PassWrapper<PartitionExecutableTargetsPass,
+                         OperationPass<ModuleOp>> {
+public:
+  PartitionExecutableTargetsPass() = default;
+  PartitionExecutableTargetsPass(const PartitionExecutableTargetsPass &pass) {}
+  explicit PartitionExecutableTargetsPass(int64_t workloadThreshold) {
+    this->workloadThreshold = workloadThreshold;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect>();
+  }
+
+  StringRef getArgument() const override {
+    return "iree-hal-partition-executable-targets";
+  }
+
+  StringRef getDescription() const override {
+    return "Places each executable on either the host or the offload device "
+           "targets of the module based on the size of its dispatches.";
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+
+    // Split the module targets into those running on the host CPU and those
+    // offloading to another device. There's nothing to choose between unless
+    // both kinds are present.
+    SmallVector<Attribute> hostTargetAttrs;
+    SmallVector<Attribute> offloadTargetAttrs;
+    for (auto targetAttr : IREE::HAL::DeviceTargetAttr::lookup(moduleOp)) {
+      if (isHostDeviceTarget(targetAttr)) {
+        hostTargetAttrs.push_back(targetAttr);
+      } else {
+        offloadTargetAttrs.push_back(targetAttr);
+      }
+    }
+    if (hostTargetAttrs.empty() || offloadTargetAttrs.empty())
+      return;
+
+    // Gather the largest workload each executable is dispatched with.
+    // Dynamic workloads may be arbitrarily large and are treated as such.
+    DenseMap<StringAttr, std::optional<int64_t>> executableWorkloads;
+    moduleOp.walk([&](IREE::Stream::CmdDispatchOp dispatchOp) {
+      auto workload = getStaticWorkload(dispatchOp);
+      dispatchOp.forEachEntryPointAttr([&](SymbolRefAttr entryPointAttr) {
+        auto it = executableWorkloads
+                      .try_emplace(entryPointAttr.getRootReference(), 0)
+                      .first;
+        if (!it->second)
+          return;
+        it->second = workload ? std::max(*it->second, *workload) : workload;
+      });
+    });
+
+    // Scope the device targets of each executable to the ones its dispatches
+    // should run on. Executables that are never dispatched are left alone.
+    auto hostTargetsAttr = ArrayAttr::get(&getContext(), hostTargetAttrs);
+    auto offloadTargetsAttr = ArrayAttr::get(&getContext(), offloadTargetAttrs);
+    for (auto executableOp : moduleOp.getOps<IREE::Stream::ExecutableOp>()) {
+      auto it = executableWorkloads.find(executableOp.getSymNameAttr());
+      if (it == executableWorkloads.end())
+        continue;
+      bool isSmall = it->second && *it->second <= workloadThreshold;
+      executableOp->setAttr("hal.device.targets",
+                            isSmall ? hostTargetsAttr : offloadTargetsAttr);
+    }
+  }
+
+private:
+  Option<int64_t> workloadThreshold{
+      *this, "workload-threshold",
+      llvm::cl::desc("Largest total workload of an executable that is placed "
+                     "on the host device targets."),
+      llvm::cl::init(0)};
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createPartitionExecutableTargetsPass(int64_t workloadThreshold) {
+  return std::make_unique<PartitionExecutableTargetsPass>(workloadThreshold);
+}
+
+static PassRegistration<PartitionExecutableTargetsPass> pass([] {
+  return std::make_unique<PartitionExecutableTargetsPass>();
+});
+
+} // namespace HAL
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -55,6 +55,35 @@ static llvm::cl::opt<unsigned> clBenchmarkDispatchRepeatCount{
     llvm::cl::init(1),
 };
 
+static llvm::cl::opt<bool> clMemoizeCommandBuffers{
+    "iree-hal-memoize-command-buffers",
+    llvm::cl::desc(
+        "Records command buffers that only reference constants and immutable "
+        "globals once at initialization and reuses them for each submission "
+        "instead of re-recording them on every invocation. Dispatches with "
+        "dynamic workgroup counts are recorded as indirect dispatches."),
+    llvm::cl::init(false),
+};
+
+static llvm::cl::opt<unsigned> clSplitCommandBufferDispatchCount{
+    "iree-hal-split-command-buffer-dispatch-count",
+    llvm::cl::desc(
+        "Splits command buffers into nested command buffers at the first "
+        "execution barrier after this many dispatches. Segments with static "
+        "contents can then be memoized independently. 0 disables splitting."),
+    llvm::cl::init(0),
+};
+
+static llvm::cl::opt<int64_t> clPartitionWorkloadThreshold{
+    "iree-hal-partition-workload-threshold",
+    llvm::cl::desc(
+        "When targeting both the host CPU and an offload device places "
+        "executables dispatched with at most this many workload elements on "
+        "the host and all others on the offload device. 0 disables "
+        "partitioning and translates every executable for all targets."),
+    llvm::cl::init(0),
+};
+
 static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     "iree-hal-instrument-dispatches",
     llvm::cl::desc("Enables dispatch instrumentation with a power-of-two byte "
@@ -165,6 +194,13 @@ void buildHALConfigurationPassPipeline(
   }
   passManager.addPass(createVerifyTargetEnvironmentPass(targetRegistry));
 
+  // Place small dispatches on the host and large ones on the offload device
+  // when targeting both.
+  if (clPartitionWorkloadThreshold > 0) {
+    passManager.addPass(
+        createPartitionExecutableTargetsPass(clPartitionWorkloadThreshold));
+  }
+
   // Add dispatch instrumentation prior to materializing interfaces so we can
   // more easily mutate the stream dispatch ops and exports.
   if (auto bufferSize = clInstrumentDispatchBufferSize.getValue()) {
@@ -255,7 +291,8 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
 
   if (compileFrom < PipelinePhase::ExecutableTargets) {
     passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-        createTranslateExecutablesPass(targetRegistry));
+        createTranslateExecutablesPass(targetRegistry,
+                                       targetOptions.executableCachePath));
   }
 
   if (compileTo == PipelinePhase::ExecutableTargets)
@@ -331,9 +368,22 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
         createBenchmarkBatchDispatchesPass(clBenchmarkDispatchRepeatCount));
   }
 
+  // Split large command buffers into nested command buffers. This must run
+  // before state elision as nested command buffers don't inherit state.
+  if (clSplitCommandBufferDispatchCount != 0) {
+    FunctionLikeNest(passManager).addPass([]() {
+      return createSplitCommandBuffersPass(clSplitCommandBufferDispatchCount);
+    });
+  }
+
   // Elide redundant command buffer state ops created during conversion.
   FunctionLikeNest(passManager).addPass(createElideRedundantCommandsPass);
 
+  // Record command buffers with static contents once at initialization.
+  if (clMemoizeCommandBuffers) {
+    passManager.addPass(createMemoizeCommandBuffersPass());
+  }
+
   // Fixup workgroup count calculations that may have used the affine dialect.
   // Kind of random here but can happen if the benchmarking code does things.
   passManager.addPass(mlir::createLowerAffinePass());
@@ -357,7 +407,8 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
         createSerializeExecutablesPass(
             targetRegistry, targetOptions.debugLevel,
             targetOptions.executableIntermediatesPath,
-            targetOptions.executableBinariesPath));
+            targetOptions.executableBinariesPath,
+            targetOptions.executableCachePath));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run
     // it if we serialized things.
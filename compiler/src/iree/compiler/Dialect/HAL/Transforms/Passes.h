@@ -85,6 +85,12 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createAssignTargetDevicesPass(const TargetBackendRegistry &targetRegistry,
                               ArrayRef<std::string> targets);
 
+// Scopes the device targets of each executable to either the host CPU targets
+// or the offload targets of the module. Executables whose largest static
+// workload is at most |workloadThreshold| run on the host.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createPartitionExecutableTargetsPass(int64_t workloadThreshold);
+
 // Applies fixups to the program for when using legacy HAL devices that only
 // support synchronous execution. Once all devices support async this will be
 // removed.
@@ -132,13 +138,17 @@ std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createPreprocessExecutablesWithToolPass(std::string command);
 
 // Translates hal.executable.variant ops via a nested translation pipeline.
+// If |cachePath| is provided translated variants are cached there and reused
+// by subsequent compilations translating identical variants.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass(const TargetBackendRegistry &targetRegistry);
+createTranslateExecutablesPass(const TargetBackendRegistry &targetRegistry,
+                               std::string cachePath = "");
 
 // Translates hal.executable.variant ops for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
 createTranslateTargetExecutableVariantsPass(
-    const TargetBackendRegistry &targetRegistry, StringRef target);
+    const TargetBackendRegistry &targetRegistry, StringRef target,
+    std::string cachePath = "");
 
 // Calls into each target backend to have it link multiple hal.executables
 // together (if that makes sense). For example, the LLVM AOT backend may combine
@@ -157,18 +167,21 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createResolveExportOrdinalsPass();
 
 // Converts hal.executable.variants to one or more hal.executable.binary ops.
+// If |cachePath| is provided serialized binaries are cached there and reused
+// by subsequent compilations serializing identical variants.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createSerializeExecutablesPass(const TargetBackendRegistry &targetRegistry,
                                int debugLevel = 2,
                                std::string dumpIntermediatesPath = "",
-                               std::string dumpBinariesPath = "");
+                               std::string dumpBinariesPath = "",
+                               std::string cachePath = "");
 
 // Serializes executables for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createSerializeTargetExecutablesPass(
     const TargetBackendRegistry &targetRegistry, StringRef target,
     int debugLevel = 2, std::string dumpIntermediatesPath = "",
-    std::string dumpBinariesPath = "");
+    std::string dumpBinariesPath = "", std::string cachePath = "");
 
 //===----------------------------------------------------------------------===//
 // Resource initialization, caching, and optimization
@@ -184,9 +197,21 @@ createMaterializeDispatchInstrumentationPass(int64_t bufferSize);
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createMaterializeResourceCachesPass(TargetOptions targetOptions);
 
+// Splits command buffers recording more than |splitDispatchCount| dispatches
+// into nested command buffers at execution barriers.
+std::unique_ptr<OperationPass<void>>
+createSplitCommandBuffersPass(unsigned splitDispatchCount);
+
 // Elides stateful command buffer ops that set redundant state.
 std::unique_ptr<OperationPass<void>> createElideRedundantCommandsPass();
 
+// Records command buffers built entirely from values available at
+// initialization time once in an initializer and reuses them for every
+// submission. Dispatch workgroup counts computed per invocation are written to
+// a buffer read by indirect dispatches.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createMemoizeCommandBuffersPass();
+
 // Repeats dispatches `iree-hal-repeat-dispatch-num` times, which is 1 by
 // default.
 std::unique_ptr<OperationPass<func::FuncOp>>
@@ -211,11 +236,14 @@ inline void registerHALPasses() {
   createMaterializeDispatchInstrumentationPass(0);
   createMaterializeInterfacesPass();
   createMaterializeResourceCachesPass(targetOptions);
+  createMemoizeCommandBuffersPass();
   createMemoizeDeviceQueriesPass();
+  createPartitionExecutableTargetsPass(/*workloadThreshold=*/0);
   createPreprocessExecutablesPass("");
   createResolveExportOrdinalsPass();
   createSerializeExecutablesPass(TargetBackendRegistry::getGlobal());
   createSerializeTargetExecutablesPass(TargetBackendRegistry::getGlobal(), "");
+  createSplitCommandBuffersPass(/*splitDispatchCount=*/0);
   createSubstituteExecutablesPass();
   createTranslateExecutablesPass(TargetBackendRegistry::getGlobal());
   createTranslateTargetExecutableVariantsPass(
@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "iree/compiler/Dialect/HAL/Transforms/ExecutableCache.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/FileSystem.h"
 #include "mlir/IR/Attributes.h"
@@ -35,12 +36,14 @@ public:
   SerializeTargetExecutablesPass(const TargetBackendRegistry &targetRegistry,
                                  StringRef target, int debugLevel,
                                  std::string dumpIntermediatesPath,
-                                 std::string dumpBinariesPath)
+                                 std::string dumpBinariesPath,
+                                 std::string cachePath)
       : targetRegistry(targetRegistry) {
     this->target = target.str();
     this->debugLevel = debugLevel;
     this->dumpIntermediatesPath = dumpIntermediatesPath;
     this->dumpBinariesPath = dumpBinariesPath;
+    this->cachePath = cachePath;
   }
 
   StringRef getArgument() const override {
@@ -93,15 +96,44 @@ public:
       if (variantOp.getTarget().getBackend().getValue() != target)
         continue;
       OpBuilder executableBuilder(variantOp);
+
+      // Reuse the binaries of a prior serialization of the identical variant
+      // if cached.
+      std::string cacheKey;
+      if (!cachePath.empty()) {
+        cacheKey = getExecutableCacheKey(
+            variantOp, {"serialize", target, std::to_string(debugLevel)});
+        if (auto entryOp = loadExecutableCacheEntry(cachePath, cacheKey,
+                                                    variantOp.getContext())) {
+          for (auto &op : entryOp->getOps())
+            executableBuilder.clone(op);
+          variantOp.erase();
+          continue;
+        }
+      }
+
       // Ask the target backend to serialize the executable. Note that it
       // may create one or more hal.executable.binary ops in the case of
       // multi-architecture binaries.
+      Operation *prevOp = variantOp->getPrevNode();
       if (failed(targetBackend->serializeExecutable(
               serializationOptions, variantOp, executableBuilder))) {
         variantOp.emitError()
             << "failed to serialize executable for target backend " << target;
         return signalPassFailure();
       }
+
+      // Binaries are inserted immediately before the variant.
+      if (!cacheKey.empty()) {
+        SmallVector<Operation *> binaryOps;
+        for (auto it = prevOp ? std::next(Block::iterator(prevOp))
+                              : executableOp.getBlock().begin();
+             &*it != variantOp.getOperation(); ++it) {
+          binaryOps.push_back(&*it);
+        }
+        storeExecutableCacheEntry(cachePath, cacheKey, binaryOps);
+      }
+
       variantOp.erase();
     }
   }
@@ -124,6 +156,10 @@ private:
       *this, "dump-binaries-path",
       llvm::cl::desc("Path to write translated and serialized executable "
                      "binaries into for debugging.")};
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Path to a directory used to cache serialized "
+                     "executable binaries across compilations.")};
 
   const TargetBackendRegistry &targetRegistry;
 };
@@ -132,10 +168,10 @@ std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createSerializeTargetExecutablesPass(
     const TargetBackendRegistry &targetRegistry, StringRef target,
     int debugLevel, std::string dumpIntermediatesPath,
-    std::string dumpBinariesPath) {
+    std::string dumpBinariesPath, std::string cachePath) {
   return std::make_unique<SerializeTargetExecutablesPass>(
       targetRegistry, target, debugLevel, dumpIntermediatesPath,
-      dumpBinariesPath);
+      dumpBinariesPath, cachePath);
 }
 
 static PassRegistration<SerializeTargetExecutablesPass> linkTargetPass([] {
@@ -150,10 +186,10 @@ public:
       : targetRegistry(TargetBackendRegistry::getGlobal()) {}
   SerializeExecutablesPass(const TargetBackendRegistry &targetRegistry,
                            int debugLevel, std::string dumpIntermediatesPath,
-                           std::string dumpBinariesPath)
+                           std::string dumpBinariesPath, std::string cachePath)
       : targetRegistry(targetRegistry), debugLevel(debugLevel),
         dumpIntermediatesPath(dumpIntermediatesPath),
-        dumpBinariesPath(dumpBinariesPath) {}
+        dumpBinariesPath(dumpBinariesPath), cachePath(cachePath) {}
 
   StringRef getArgument() const override {
     return "iree-hal-serialize-executables";
@@ -169,7 +205,7 @@ public:
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addPass(createSerializeTargetExecutablesPass(
           targetRegistry, targetName, debugLevel, dumpIntermediatesPath,
-          dumpBinariesPath));
+          dumpBinariesPath, cachePath));
     }
     if (failed(runPipeline(passManager, executableOp))) {
       executableOp.emitError() << "failed to serialize executables";
@@ -182,15 +218,18 @@ private:
   int debugLevel;
   std::string dumpIntermediatesPath;
   std::string dumpBinariesPath;
+  std::string cachePath;
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
 createSerializeExecutablesPass(const TargetBackendRegistry &targetRegistry,
                                int debugLevel,
                                std::string dumpIntermediatesPath,
-                               std::string dumpBinariesPath) {
+                               std::string dumpBinariesPath,
+                               std::string cachePath) {
   return std::make_unique<SerializeExecutablesPass>(
-      targetRegistry, debugLevel, dumpIntermediatesPath, dumpBinariesPath);
+      targetRegistry, debugLevel, dumpIntermediatesPath, dumpBinariesPath,
+      cachePath);
 }
 
 static PassRegistration<SerializeExecutablesPass> linkPass([] {
@@ -0,0 +1,189 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+namespace {
+
+static bool isDispatchOp(Operation *op) {
+  return isa<IREE::HAL::CommandBufferDispatchSymbolOp,
+             IREE::HAL::CommandBufferDispatchOp,
+             IREE::HAL::CommandBufferDispatchIndirectSymbolOp,
+             IREE::HAL::CommandBufferDispatchIndirectOp>(op);
+}
+
+// Returns all ops recording into the command buffer produced by |createOp| in
+// program order if they are all within the same block and precede a finalize.
+static std::optional<SmallVector<Operation *>>
+getRecordingOps(IREE::HAL::CommandBufferCreateOp createOp) {
+  auto *block = createOp->getBlock();
+  Value commandBuffer = createOp.getResult();
+  SmallVector<Operation *> users;
+  for (auto *user : commandBuffer.getUsers()) {
+    if (user->getBlock() != block)
+      return std::nullopt;
+    users.push_back(user);
+  }
+  llvm::sort(users, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+  SmallVector<Operation *> recordOps;
+  for (auto *user : users) {
+    if (isa<IREE::HAL::CommandBufferFinalizeOp>(user))
+      return recordOps;
+    // Anything other than a recording op (such as querying the device or
+    // passing the command buffer along) may observe the command buffer.
+    if (user->getNumResults() != 0 ||
+        !user->getName().getStringRef().starts_with("hal.command_buffer.") ||
+        isa<IREE::HAL::CommandBufferExecuteCommandsOp>(user))
+      return std::nullopt;
+    recordOps.push_back(user);
+  }
+  return std::nullopt;
+}
+
+// Partitions |recordOps| into segments with at least |splitDispatchCount|
+// dispatches (except the last) separated by execution barriers.
+// The separating barriers are returned in neither segment and stay in the
+// parent command buffer.
+static SmallVector<SmallVector<Operation *>>
+partitionRecordingOps(ArrayRef<Operation *> recordOps,
+                      unsigned splitDispatchCount) {
+  SmallVector<SmallVector<Operation *>> segments(1);
+  unsigned dispatchCount = 0;
+  int debugGroupDepth = 0;
+  for (auto *op : recordOps) {
+    // Debug groups can't span command buffers.
+    if (isa<IREE::HAL::CommandBufferExecutionBarrierOp>(op) &&
+        debugGroupDepth == 0 && dispatchCount >= splitDispatchCount) {
+      segments.emplace_back();
+      dispatchCount = 0;
+      continue;
+    }
+    if (isa<IREE::HAL::CommandBufferBeginDebugGroupOp>(op)) {
+      ++debugGroupDepth;
+    } else if (isa<IREE::HAL::CommandBufferEndDebugGroupOp>(op)) {
+      --debugGroupDepth;
+    } else if (isDispatchOp(op)) {
+      ++dispatchCount;
+    }
+    segments.back().push_back(op);
+  }
+  llvm::erase_if(segments, [](auto &segment) { return segment.empty(); });
+  return segments;
+}
+
+// Moves each segment of the command buffer created by |createOp| into its own
+// nested command buffer executed in place of the original commands.
+static void splitCommandBuffer(IREE::HAL::CommandBufferCreateOp createOp,
+                               ArrayRef<SmallVector<Operation *>> segments) {
+  Value commandBuffer = createOp.getResult();
+  auto modes = (createOp.getModes() |
+                IREE::HAL::CommandBufferModeBitfield::Nested) &
+               ~IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution;
+  for (auto &segment : segments) {
+    auto loc = segment.front()->getLoc();
+    OpBuilder builder(segment.front());
+    auto nestedOp = builder.create<IREE::HAL::CommandBufferCreateOp>(
+        loc, commandBuffer.getType(), createOp.getDevice(), modes,
+        createOp.getCommandCategories(), /*binding_capacity=*/Value{});
+    for (auto *op : segment)
+      op->replaceUsesOfWith(commandBuffer, nestedOp.getResult());
+    builder.setInsertionPointAfter(segment.back());
+    builder.create<IREE::HAL::CommandBufferFinalizeOp>(loc,
+                                                       nestedOp.getResult());
+    builder.create<IREE::HAL::CommandBufferExecuteCommandsOp>(
+        loc, commandBuffer, nestedOp.getResult());
+  }
+}
+
+// NOTE: the nested command buffers are still recorded in order by the VM
+// invocation recording the parent. Each segment is independent of the others
+// and of the parent, though, so segments can be memoized individually when
+// their contents are static and the layout is ready for recording segments
+// concurrently once the VM can issue recording work asynchronously.
+class SplitCommandBuffersPass
+    : public PassWrapper<SplitCommandBuffersPass, OperationPass<void>> {
+public:
+  SplitCommandBuffersPass() = default;
+  SplitCommandBuffersPass(const SplitCommandBuffersPass &pass) {}
+  explicit SplitCommandBuffersPass(unsigned splitDispatchCount) {
+    this->splitDispatchCount = splitDispatchCount;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect>();
+  }
+
+  StringRef getArgument() const override {
+    return "iree-hal-split-command-buffers";
+  }
+
+  StringRef getDescription() const override {
+    return "Splits large command buffers into nested command buffers at "
+           "execution barriers";
+  }
+
+  void runOnOperation() override {
+    if (splitDispatchCount == 0)
+      return;
+    SmallVector<IREE::HAL::CommandBufferCreateOp> createOps;
+    getOperation()->walk([&](IREE::HAL::CommandBufferCreateOp createOp) {
+      createOps.push_back(createOp);
+    });
+    for (auto createOp : createOps) {
+      // Nested command buffers don't nest further and binding tables are only
+      // available to the parent command buffer.
+      if (bitEnumContainsAll(createOp.getModes(),
+                             IREE::HAL::CommandBufferModeBitfield::Nested) ||
+          createOp.getBindingCapacity()) {
+        continue;
+      }
+      auto recordOps = getRecordingOps(createOp);
+      if (!recordOps)
+        continue;
+      auto segments = partitionRecordingOps(*recordOps, splitDispatchCount);
+      if (segments.size() < 2)
+        continue;
+      splitCommandBuffer(createOp, segments);
+    }
+  }
+
+private:
+  Option<unsigned> splitDispatchCount{
+      *this, "dispatch-count",
+      llvm::cl::desc("Minimum number of dispatches recorded into each nested "
+                     "command buffer before splitting at the next barrier; "
+                     "0 disables splitting."),
+      llvm::cl::init(0)};
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<void>>
+createSplitCommandBuffersPass(unsigned splitDispatchCount) {
+  return std::make_unique<SplitCommandBuffersPass>(splitDispatchCount);
+}
+
+static PassRegistration<SplitCommandBuffersPass> pass;
+
+} // namespace HAL
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "iree/compiler/Dialect/HAL/Transforms/ExecutableCache.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "llvm/ADT/StringSet.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
@@ -35,9 +36,11 @@ public:
       const TranslateTargetExecutableVariantsPass &pass)
       : targetRegistry(pass.targetRegistry) {}
   TranslateTargetExecutableVariantsPass(
-      const TargetBackendRegistry &targetRegistry, StringRef target)
+      const TargetBackendRegistry &targetRegistry, StringRef target,
+      std::string cachePath)
       : targetRegistry(targetRegistry) {
     this->target = target.str();
+    this->cachePath = cachePath;
   }
 
   StringRef getArgument() const override {
@@ -70,12 +73,40 @@ public:
 
     OpPassManager passManager(variantOp.getOperationName());
     targetBackend->buildTranslationPassPipeline(variantOp, passManager);
+
+    // Reuse a prior translation of the identical source variant if cached.
+    // The translated variant replaces the contents of the source variant
+    // in-place as if the pipeline had run.
+    std::string cacheKey;
+    if (!cachePath.empty()) {
+      std::string pipeline;
+      llvm::raw_string_ostream pipelineStream(pipeline);
+      passManager.printAsTextualPipeline(pipelineStream);
+      cacheKey = getExecutableCacheKey(
+          variantOp, {"translate", target, pipelineStream.str()});
+      if (auto entryOp = loadExecutableCacheEntry(cachePath, cacheKey,
+                                                  variantOp.getContext())) {
+        auto cachedVariantOps =
+            entryOp->getOps<IREE::HAL::ExecutableVariantOp>();
+        if (!cachedVariantOps.empty()) {
+          auto cachedVariantOp = *cachedVariantOps.begin();
+          variantOp->setAttrs(cachedVariantOp->getAttrDictionary());
+          variantOp->getRegion(0).takeBody(cachedVariantOp->getRegion(0));
+          return;
+        }
+      }
+    }
+
     if (failed(runPipeline(passManager, variantOp))) {
       variantOp.emitError() << "failed to run translation of source "
                                "executable to target executable for backend "
                             << variantOp.getTarget();
       return signalPassFailure();
     }
+
+    if (!cacheKey.empty()) {
+      storeExecutableCacheEntry(cachePath, cacheKey, {variantOp});
+    }
   }
 
 private:
@@ -84,15 +115,20 @@ private:
       llvm::cl::desc(
           "Target backend name whose executables will be translated by "
           "this pass.")};
+  Option<std::string> cachePath{
+      *this, "cache-path",
+      llvm::cl::desc("Path to a directory used to cache translated "
+                     "executables across compilations.")};
 
   const TargetBackendRegistry &targetRegistry;
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
 createTranslateTargetExecutableVariantsPass(
-    const TargetBackendRegistry &targetRegistry, StringRef target) {
-  return std::make_unique<TranslateTargetExecutableVariantsPass>(targetRegistry,
-                                                                 target);
+    const TargetBackendRegistry &targetRegistry, StringRef target,
+    std::string cachePath) {
+  return std::make_unique<TranslateTargetExecutableVariantsPass>(
+      targetRegistry, target, cachePath);
 }
 
 static PassRegistration<TranslateTargetExecutableVariantsPass> linkTargetPass(
@@ -106,8 +142,9 @@ public:
       : targetRegistry(TargetBackendRegistry::getGlobal()) {}
   TranslateExecutablesPass(const TranslateExecutablesPass &pass)
       : targetRegistry(pass.targetRegistry) {}
-  TranslateExecutablesPass(const TargetBackendRegistry &targetRegistry)
-      : targetRegistry(targetRegistry) {}
+  TranslateExecutablesPass(const TargetBackendRegistry &targetRegistry,
+                           std::string cachePath)
+      : targetRegistry(targetRegistry), cachePath(cachePath) {}
 
   StringRef getArgument() const override {
     return "iree-hal-translate-executables";
@@ -133,7 +170,7 @@ public:
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
           createTranslateTargetExecutableVariantsPass(targetRegistry,
-                                                      targetName));
+                                                      targetName, cachePath));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
@@ -145,11 +182,14 @@ public:
   }
 
   const TargetBackendRegistry &targetRegistry;
+  std::string cachePath;
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass(const TargetBackendRegistry &targetRegistry) {
-  return std::make_unique<TranslateExecutablesPass>(targetRegistry);
+createTranslateExecutablesPass(const TargetBackendRegistry &targetRegistry,
+                               std::string cachePath) {
+  return std::make_unique<TranslateExecutablesPass>(targetRegistry,
+                                                    cachePath);
 }
 
 static PassRegistration<TranslateExecutablesPass> translatePass([] {
@@ -16,6 +16,7 @@
 ]>
 
 // CHECK: module
+// CHECK-SAME: iree.reflection = {"hal.device.targets" = "llvm-cpu"}
 module attributes {hal.device.targets = [#device_target_cpu]}  {
 
   // CHECK: hal.executable private @ex
@@ -224,6 +224,61 @@ func.func @exeLookup(%device : !hal.device) -> !hal.executable {
 
 // -----
 
+// Tests that executables are created after the initializers that don't use
+// them (such as constant uploads) and before the first one that may.
+
+#pipeline_layout_0 = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>
+  ]>
+]>
+
+module attributes {hal.device.targets = [#hal.device.target<"vmvx">]} {
+
+hal.executable @exe {
+  hal.executable.variant @vmvx target(<"vmvx", "vmvx-bytecode-fb">) {
+    hal.executable.export @entry0 ordinal(0) layout(#pipeline_layout_0) attributes {
+      workgroup_size = [32 : index, 1 : index, 1 : index]
+    }
+  }
+}
+
+// CHECK: util.global private @_executable_exe : !hal.executable
+
+// CHECK: util.global private @constant_upload : !hal.buffer
+util.global private @constant_upload : !hal.buffer
+// CHECK-NEXT: util.initializer {
+util.initializer {
+  %c16 = arith.constant 16 : index
+  %affinity = arith.constant -1 : i64
+  %device = hal.ex.shared_device : !hal.device
+  %allocator = hal.device.allocator<%device : !hal.device> : !hal.allocator
+  %buffer = hal.allocator.allocate<%allocator : !hal.allocator> affinity(%affinity) type("DeviceLocal") usage("Transfer|DispatchStorage") : !hal.buffer{%c16}
+  // CHECK: util.global.store %{{.+}}, @constant_upload
+  util.global.store %buffer, @constant_upload : !hal.buffer
+  util.initializer.return
+}
+
+// CHECK: util.initializer {
+// CHECK:   hal.executable.create
+// CHECK:   util.global.store %{{.+}}, @_executable_exe : !hal.executable
+
+// CHECK: util.global private @executable_user : !hal.executable
+util.global private @executable_user : !hal.executable
+// CHECK-NEXT: util.initializer {
+util.initializer {
+  %device = hal.ex.shared_device : !hal.device
+  // CHECK: util.global.load @_executable_exe : !hal.executable
+  %exe = hal.executable.lookup device(%device : !hal.device)
+                               executable(@exe) : !hal.executable
+  util.global.store %exe, @executable_user : !hal.executable
+  util.initializer.return
+}
+
+}
+
+// -----
+
 // Tests that materialization no-ops when resource caches have already been
 // materialized. Today this is rather simplistic and just bails if the names
 // match with the expectation being that users are mostly just running through
@@ -0,0 +1,212 @@
+// RUN: iree-opt --split-input-file --iree-hal-memoize-command-buffers %s | FileCheck %s
+
+// Tests that a command buffer recorded only from constants and immutable
+// globals is recorded once in an initializer and reused by each submission.
+
+util.global private @buffer : !hal.buffer
+
+// CHECK-LABEL: func.func @static_command_buffer
+func.func @static_command_buffer(%wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c128 = arith.constant 128 : index
+  %c-1_i64 = arith.constant -1 : i64
+  %pattern = arith.constant 1234 : i32
+  // CHECK: %[[DEVICE:.+]] = hal.ex.shared_device
+  %device = hal.ex.shared_device : !hal.device
+  %buffer = util.global.load @buffer : !hal.buffer
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.fill_buffer
+  // CHECK-NOT: hal.command_buffer.finalize
+  // CHECK: %[[CMD:.+]] = util.global.load @_command_buffer : !hal.command_buffer
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer") : !hal.command_buffer
+  hal.command_buffer.fill_buffer<%cmd : !hal.command_buffer>
+      target(%buffer : !hal.buffer)[%c0, %c128]
+      pattern(%pattern : i32)
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  // CHECK: hal.device.queue.execute<%[[DEVICE]] : !hal.device>
+  // CHECK-SAME: commands([%[[CMD]]])
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  return
+}
+
+//      CHECK: util.global private @_command_buffer : !hal.command_buffer
+// CHECK-NEXT: util.initializer {
+//  CHECK-DAG:   %[[INIT_DEVICE:.+]] = hal.ex.shared_device
+//  CHECK-DAG:   %[[INIT_BUFFER:.+]] = util.global.load @buffer
+//      CHECK:   %[[INIT_CMD:.+]] = hal.command_buffer.create device(%[[INIT_DEVICE]] : !hal.device) mode("None") categories(Transfer)
+// CHECK-NEXT:   hal.command_buffer.fill_buffer<%[[INIT_CMD]] : !hal.command_buffer> target(%[[INIT_BUFFER]] : !hal.buffer)
+// CHECK-NEXT:   hal.command_buffer.finalize<%[[INIT_CMD]] : !hal.command_buffer>
+// CHECK-NEXT:   util.global.store %[[INIT_CMD]], @_command_buffer : !hal.command_buffer
+// CHECK-NEXT:   util.initializer.return
+
+// -----
+
+// Tests that command buffers referencing per-invocation values are recorded
+// each time.
+
+// CHECK-LABEL: func.func @dynamic_command_buffer
+func.func @dynamic_command_buffer(%buffer: !hal.buffer, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c128 = arith.constant 128 : index
+  %c-1_i64 = arith.constant -1 : i64
+  %pattern = arith.constant 1234 : i32
+  %device = hal.ex.shared_device : !hal.device
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer") : !hal.command_buffer
+  // CHECK: hal.command_buffer.fill_buffer
+  hal.command_buffer.fill_buffer<%cmd : !hal.command_buffer>
+      target(%buffer : !hal.buffer)[%c0, %c128]
+      pattern(%pattern : i32)
+  // CHECK: hal.command_buffer.finalize
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  return
+}
+
+// CHECK-NOT: util.global private @_command_buffer
+
+// -----
+
+// Tests that nested command buffers with static contents are memoized even
+// when the parent command buffer must be recorded each time.
+
+util.global private @buffer : !hal.buffer
+
+// CHECK-LABEL: func.func @static_nested_command_buffer
+func.func @static_nested_command_buffer(%dynamic_buffer: !hal.buffer, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c128 = arith.constant 128 : index
+  %c-1_i64 = arith.constant -1 : i64
+  %pattern = arith.constant 1234 : i32
+  %device = hal.ex.shared_device : !hal.device
+  %buffer = util.global.load @buffer : !hal.buffer
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer") : !hal.command_buffer
+  // CHECK-NEXT: %[[NESTED:.+]] = util.global.load @_command_buffer : !hal.command_buffer
+  %nested = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|Nested") categories("Transfer") : !hal.command_buffer
+  hal.command_buffer.fill_buffer<%nested : !hal.command_buffer>
+      target(%buffer : !hal.buffer)[%c0, %c128]
+      pattern(%pattern : i32)
+  hal.command_buffer.finalize<%nested : !hal.command_buffer>
+  // CHECK-NEXT: hal.command_buffer.execute.commands<%[[CMD]] : !hal.command_buffer> commands(%[[NESTED]] : !hal.command_buffer)
+  hal.command_buffer.execute.commands<%cmd : !hal.command_buffer>
+      commands(%nested : !hal.command_buffer)
+  // CHECK-NEXT: hal.command_buffer.fill_buffer<%[[CMD]] : !hal.command_buffer>
+  hal.command_buffer.fill_buffer<%cmd : !hal.command_buffer>
+      target(%dynamic_buffer : !hal.buffer)[%c0, %c128]
+      pattern(%pattern : i32)
+  // CHECK-NEXT: hal.command_buffer.finalize<%[[CMD]] : !hal.command_buffer>
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  return
+}
+
+//      CHECK: util.global private @_command_buffer : !hal.command_buffer
+// CHECK-NEXT: util.initializer {
+//      CHECK:   %[[INIT_CMD:.+]] = hal.command_buffer.create device(%{{.+}} : !hal.device) mode(Nested) categories(Transfer)
+// CHECK-NEXT:   hal.command_buffer.fill_buffer<%[[INIT_CMD]] : !hal.command_buffer>
+// CHECK-NEXT:   hal.command_buffer.finalize<%[[INIT_CMD]] : !hal.command_buffer>
+// CHECK-NEXT:   util.global.store %[[INIT_CMD]], @_command_buffer : !hal.command_buffer
+
+// -----
+
+// Tests that dispatches with per-invocation workgroup counts are recorded as
+// indirect dispatches reading the counts from a buffer written before each
+// submission once the previous submission has completed.
+
+util.global private @executable : !hal.executable
+
+// CHECK-LABEL: func.func @indirect_command_buffer
+//  CHECK-SAME: (%[[COUNT:.+]]: index, %[[WAIT:.+]]: !hal.fence, %[[SIGNAL:.+]]: !hal.fence)
+func.func @indirect_command_buffer(%count: index, %wait: !hal.fence, %signal: !hal.fence) {
+  %c1 = arith.constant 1 : index
+  %c-1_i64 = arith.constant -1 : i64
+  // CHECK: %[[DEVICE:.+]] = hal.ex.shared_device
+  %device = hal.ex.shared_device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  // CHECK-NOT: hal.command_buffer.create
+  //     CHECK: %[[CMD:.+]] = util.global.load @_command_buffer : !hal.command_buffer
+  //     CHECK: %[[FENCE:.+]] = util.global.load @_command_buffer_fence : !hal.fence
+  //     CHECK: %[[STATUS:.+]] = hal.fence.await until([%[[FENCE]]]) timeout_millis(%{{.+}}) : i32
+  // CHECK-NEXT: util.status.check_ok %[[STATUS]]
+  // CHECK-NEXT: %[[WORKGROUPS:.+]] = util.global.load @_command_buffer_workgroups : !hal.buffer
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Dispatch") : !hal.command_buffer
+  //      CHECK: %[[X:.+]] = arith.index_cast %[[COUNT]] : index to i32
+  // CHECK-NEXT: hal.buffer.store<%[[WORKGROUPS]] : !hal.buffer>[%{{.+}}] value(%[[X]] : i32)
+  //      CHECK: hal.buffer.store<%[[WORKGROUPS]] : !hal.buffer>
+  //      CHECK: hal.buffer.store<%[[WORKGROUPS]] : !hal.buffer>
+  //  CHECK-NOT: hal.command_buffer.dispatch
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer>
+      target(%executable : !hal.executable)[0]
+      workgroups([%count, %c1, %c1])
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  //      CHECK: hal.device.queue.execute<%[[DEVICE]] : !hal.device>
+  // CHECK-SAME:   signal(%[[SIGNAL]])
+  // CHECK-SAME:   commands([%[[CMD]]])
+  // CHECK-NEXT: util.global.store %[[SIGNAL]], @_command_buffer_fence : !hal.fence
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  return
+}
+
+//      CHECK: util.global private @_command_buffer : !hal.command_buffer
+// CHECK-NEXT: util.global private @_command_buffer_workgroups : !hal.buffer
+// CHECK-NEXT: util.global private mutable @_command_buffer_fence : !hal.fence
+// CHECK-NEXT: util.initializer {
+//  CHECK-DAG:   %[[INIT_DEVICE:.+]] = hal.ex.shared_device
+//  CHECK-DAG:   %[[INIT_EXECUTABLE:.+]] = util.global.load @executable
+//      CHECK:   %[[ALLOCATOR:.+]] = hal.device.allocator<%[[INIT_DEVICE]] : !hal.device>
+//      CHECK:   %[[INIT_WORKGROUPS:.+]] = hal.allocator.allocate<%[[ALLOCATOR]] : !hal.allocator>
+// CHECK-SAME:     type("HostVisible|DeviceVisible")
+// CHECK-SAME:     usage("DispatchIndirectParams|{{.+}}")
+// CHECK-NEXT:   util.global.store %[[INIT_WORKGROUPS]], @_command_buffer_workgroups : !hal.buffer
+//      CHECK:   %[[INIT_CMD:.+]] = hal.command_buffer.create device(%[[INIT_DEVICE]] : !hal.device) mode("None") categories(Dispatch)
+//      CHECK:   hal.command_buffer.dispatch.indirect<%[[INIT_CMD]] : !hal.command_buffer>
+// CHECK-SAME:     target(%[[INIT_EXECUTABLE]] : !hal.executable)[0]
+// CHECK-SAME:     workgroups(%[[INIT_WORKGROUPS]] : !hal.buffer)
+// CHECK-NEXT:   hal.command_buffer.finalize<%[[INIT_CMD]] : !hal.command_buffer>
+// CHECK-NEXT:   util.global.store %[[INIT_CMD]], @_command_buffer : !hal.command_buffer
+
+// -----
+
+// Tests that command buffers with per-invocation workgroup counts are recorded
+// each time when submitted more than once as the counts may still be in use.
+
+util.global private @executable : !hal.executable
+
+// CHECK-LABEL: func.func @indirect_command_buffer_resubmitted
+func.func @indirect_command_buffer_resubmitted(%count: index, %wait: !hal.fence, %signal0: !hal.fence, %signal1: !hal.fence) {
+  %c1 = arith.constant 1 : index
+  %c-1_i64 = arith.constant -1 : i64
+  %device = hal.ex.shared_device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("None") categories("Dispatch") : !hal.command_buffer
+  // CHECK: hal.command_buffer.dispatch<
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer>
+      target(%executable : !hal.executable)[0]
+      workgroups([%count, %c1, %c1])
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%wait) signal(%signal0)
+      commands([%cmd])
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%c-1_i64)
+      wait(%signal0) signal(%signal1)
+      commands([%cmd])
+  return
+}
+
+// CHECK-NOT: util.global private @_command_buffer
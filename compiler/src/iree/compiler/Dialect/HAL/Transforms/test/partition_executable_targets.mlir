@@ -0,0 +1,123 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-hal-partition-executable-targets{workload-threshold=1024})' %s | FileCheck %s
+
+// Tests that small dispatches are placed on the host CPU targets and large or
+// dynamically-sized dispatches on the offload targets.
+
+// CHECK: #device_target_llvm_cpu = #hal.device.target<"llvm-cpu"
+// CHECK: #device_target_vulkan = #hal.device.target<"vulkan"
+module attributes {hal.device.targets = [
+  #hal.device.target<"llvm-cpu", {
+    executable_targets = [#hal.executable.target<"llvm-cpu", "embedded-elf-x86_64">]
+  }>,
+  #hal.device.target<"vulkan", {
+    executable_targets = [#hal.executable.target<"vulkan", "vulkan-spirv-fb">]
+  }>
+]} {
+
+  // CHECK: stream.executable private @ex_small
+  // CHECK-SAME: attributes {hal.device.targets = [#device_target_llvm_cpu]}
+  stream.executable private @ex_small {
+    stream.executable.export public @entry workgroups(%arg0: index, %arg1: index) -> (index, index, index) {
+      stream.return %arg0, %arg1, %arg0 : index, index, index
+    }
+    builtin.module {
+      func.func @entry(%arg0: !stream.binding) {
+        return
+      }
+    }
+  }
+
+  // CHECK: stream.executable private @ex_large
+  // CHECK-SAME: attributes {hal.device.targets = [#device_target_vulkan]}
+  stream.executable private @ex_large {
+    stream.executable.export public @entry workgroups(%arg0: index, %arg1: index) -> (index, index, index) {
+      stream.return %arg0, %arg1, %arg0 : index, index, index
+    }
+    builtin.module {
+      func.func @entry(%arg0: !stream.binding) {
+        return
+      }
+    }
+  }
+
+  // CHECK: stream.executable private @ex_dynamic
+  // CHECK-SAME: attributes {hal.device.targets = [#device_target_vulkan]}
+  stream.executable private @ex_dynamic {
+    stream.executable.export public @entry workgroups(%arg0: index, %arg1: index) -> (index, index, index) {
+      stream.return %arg0, %arg1, %arg0 : index, index, index
+    }
+    builtin.module {
+      func.func @entry(%arg0: !stream.binding) {
+        return
+      }
+    }
+  }
+
+  // CHECK: stream.executable private @ex_unused {
+  stream.executable private @ex_unused {
+    stream.executable.export public @entry workgroups(%arg0: index, %arg1: index) -> (index, index, index) {
+      stream.return %arg0, %arg1, %arg0 : index, index, index
+    }
+    builtin.module {
+      func.func @entry(%arg0: !stream.binding) {
+        return
+      }
+    }
+  }
+
+  func.func @main(%arg0: !stream.resource<transient>, %arg1: index, %arg2: index) {
+    %c0 = arith.constant 0 : index
+    %c4 = arith.constant 4 : index
+    %c64 = arith.constant 64 : index
+    %c128 = arith.constant 128 : index
+    %0 = stream.cmd.execute with(%arg0 as %arg3: !stream.resource<transient>{%arg1}) {
+      stream.cmd.dispatch @ex_small::@entry[%c4, %c64] {
+        rw %arg3[%c0 for %arg1] : !stream.resource<transient>{%arg1}
+      }
+      stream.cmd.dispatch @ex_large::@entry[%c4, %c64] {
+        rw %arg3[%c0 for %arg1] : !stream.resource<transient>{%arg1}
+      }
+      stream.cmd.dispatch @ex_large::@entry[%c128, %c64] {
+        rw %arg3[%c0 for %arg1] : !stream.resource<transient>{%arg1}
+      }
+      stream.cmd.dispatch @ex_dynamic::@entry[%c4, %arg2] {
+        rw %arg3[%c0 for %arg1] : !stream.resource<transient>{%arg1}
+      }
+    } => !stream.timepoint
+    %1 = stream.timepoint.await %0 => %arg0 : !stream.resource<transient>{%arg1}
+    return
+  }
+}
+
+// -----
+
+// Tests that modules only targeting the host are left unchanged.
+
+// CHECK: stream.executable private @ex {
+module attributes {hal.device.targets = [
+  #hal.device.target<"llvm-cpu", {
+    executable_targets = [#hal.executable.target<"llvm-cpu", "embedded-elf-x86_64">]
+  }>
+]} {
+  stream.executable private @ex {
+    stream.executable.export public @entry workgroups(%arg0: index) -> (index, index, index) {
+      stream.return %arg0, %arg0, %arg0 : index, index, index
+    }
+    builtin.module {
+      func.func @entry(%arg0: !stream.binding) {
+        return
+      }
+    }
+  }
+  func.func @main(%arg0: !stream.resource<transient>, %arg1: index) {
+    %c0 = arith.constant 0 : index
+    %c4 = arith.constant 4 : index
+    %0 = stream.cmd.execute with(%arg0 as %arg2: !stream.resource<transient>{%arg1}) {
+      stream.cmd.dispatch @ex::@entry[%c4] {
+        rw %arg2[%c0 for %arg1] : !stream.resource<transient>{%arg1}
+      }
+    } => !stream.timepoint
+    %1 = stream.timepoint.await %0 => %arg0 : !stream.resource<transient>{%arg1}
+    return
+  }
+}
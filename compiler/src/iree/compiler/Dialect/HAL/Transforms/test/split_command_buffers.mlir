@@ -0,0 +1,69 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-hal-split-command-buffers{dispatch-count=2}))" %s | FileCheck %s
+
+// Tests that command buffers are split at the first barrier following the
+// requested number of dispatches and that the barriers remain in the parent.
+
+// CHECK-LABEL: @split_at_barriers
+//  CHECK-SAME: (%[[DEVICE:.+]]: !hal.device, %[[EXECUTABLE:.+]]: !hal.executable)
+func.func @split_at_barriers(%device: !hal.device, %executable: !hal.executable) -> !hal.command_buffer {
+  %c1 = arith.constant 1 : index
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create device(%[[DEVICE]] : !hal.device) mode("OneShot|AllowInlineExecution")
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  // CHECK: %[[NESTED0:.+]] = hal.command_buffer.create device(%[[DEVICE]] : !hal.device) mode("OneShot|Nested")
+  // CHECK-NEXT: hal.command_buffer.dispatch<%[[NESTED0]] : !hal.command_buffer>
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: hal.command_buffer.execution_barrier<%[[NESTED0]] : !hal.command_buffer>
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|CommandRetire") target("CommandIssue|Dispatch") flags("None")
+  // CHECK-NEXT: hal.command_buffer.dispatch<%[[NESTED0]] : !hal.command_buffer>
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[1] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: hal.command_buffer.finalize<%[[NESTED0]] : !hal.command_buffer>
+  // CHECK-NEXT: hal.command_buffer.execute.commands<%[[CMD]] : !hal.command_buffer> commands(%[[NESTED0]] : !hal.command_buffer)
+  // CHECK-NEXT: hal.command_buffer.execution_barrier<%[[CMD]] : !hal.command_buffer>
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|CommandRetire") target("CommandIssue|Dispatch") flags("None")
+  // CHECK-NEXT: %[[NESTED1:.+]] = hal.command_buffer.create device(%[[DEVICE]] : !hal.device) mode("OneShot|Nested")
+  // CHECK-NEXT: hal.command_buffer.dispatch<%[[NESTED1]] : !hal.command_buffer>
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[2] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: hal.command_buffer.finalize<%[[NESTED1]] : !hal.command_buffer>
+  // CHECK-NEXT: hal.command_buffer.execute.commands<%[[CMD]] : !hal.command_buffer> commands(%[[NESTED1]] : !hal.command_buffer)
+  // CHECK-NEXT: hal.command_buffer.finalize<%[[CMD]] : !hal.command_buffer>
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  return %cmd : !hal.command_buffer
+}
+
+// -----
+
+// Tests that command buffers with fewer dispatches are left alone.
+
+// CHECK-LABEL: @small_command_buffer
+func.func @small_command_buffer(%device: !hal.device, %executable: !hal.executable) -> !hal.command_buffer {
+  %c1 = arith.constant 1 : index
+  // CHECK: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.execute.commands
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|CommandRetire") target("CommandIssue|Dispatch") flags("None")
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  return %cmd : !hal.command_buffer
+}
+
+// -----
+
+// Tests that debug groups are not split across command buffers.
+
+// CHECK-LABEL: @debug_group
+func.func @debug_group(%device: !hal.device, %executable: !hal.executable) -> !hal.command_buffer {
+  %c1 = arith.constant 1 : index
+  // CHECK: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.execute.commands
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.begin_debug_group<%cmd : !hal.command_buffer> label("group")
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[1] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|CommandRetire") target("CommandIssue|Dispatch") flags("None")
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[2] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.end_debug_group<%cmd : !hal.command_buffer>
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  return %cmd : !hal.command_buffer
+}
@@ -0,0 +1,100 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/Analysis/DispatchCost.h"
+
+#include "iree/compiler/Dialect/Flow/IR/FlowTypes.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Interfaces/CastInterfaces.h"
+#include "mlir/Interfaces/TilingInterface.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+
+// Returns the number of arithmetic ops performed per iteration of the body of
+// |linalgOp|. Constants and casts are free.
+static uint64_t countBodyFlops(linalg::LinalgOp linalgOp) {
+  uint64_t count = 0;
+  for (auto &op : linalgOp.getBlock()->without_terminator()) {
+    if (!isa<arith::ArithDialect, math::MathDialect>(op.getDialect()))
+      continue;
+    if (isa<arith::ConstantOp>(op) || isa<CastOpInterface>(op))
+      continue;
+    ++count;
+  }
+  return count;
+}
+
+DispatchCost estimateDispatchCost(FunctionOpInterface funcOp) {
+  DispatchCost cost;
+  if (funcOp.isExternal()) {
+    cost.isComplete = false;
+    return cost;
+  }
+
+  // Bytes moved: every binding is assumed to be fully read and/or written.
+  funcOp.walk([&](IREE::Stream::BindingSubspanOp subspanOp) {
+    auto tensorType =
+        llvm::dyn_cast<IREE::Flow::DispatchTensorType>(subspanOp.getType());
+    if (!tensorType) {
+      // Buffer-level bindings (memrefs, etc) are opaque to us.
+      cost.isComplete = false;
+      return;
+    }
+    if (tensorType.getNumDynamicDims() > 0) {
+      cost.isComplete = false;
+      return;
+    }
+    uint64_t byteLength =
+        static_cast<uint64_t>(tensorType.getNumElements()) *
+        llvm::divideCeil(tensorType.getBoundElementTypeBitWidth(), 8);
+    switch (tensorType.getAccess()) {
+    case IREE::Flow::TensorAccess::ReadOnly:
+    case IREE::Flow::TensorAccess::WriteOnly:
+      cost.bytes += byteLength;
+      break;
+    case IREE::Flow::TensorAccess::ReadWrite:
+      cost.bytes += 2 * byteLength;
+      break;
+    }
+  });
+
+  // Arithmetic: body op count times the iteration domain size of each op.
+  funcOp.walk([&](Operation *op) {
+    auto linalgOp = dyn_cast<linalg::LinalgOp>(op);
+    if (!linalgOp) {
+      // Ops from other structured dialects (linalg_ext, etc) aren't modeled.
+      if (isa<TilingInterface>(op))
+        cost.isComplete = false;
+      return;
+    }
+    uint64_t bodyFlops = countBodyFlops(linalgOp);
+    if (!bodyFlops)
+      return;
+    uint64_t iterationCount = 1;
+    for (int64_t range : linalgOp.getStaticLoopRanges()) {
+      if (ShapedType::isDynamic(range)) {
+        cost.isComplete = false;
+        return;
+      }
+      iterationCount *= static_cast<uint64_t>(range);
+    }
+    cost.flops += iterationCount * bodyFlops;
+  });
+
+  return cost;
+}
+
+} // namespace Stream
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -0,0 +1,52 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_STREAM_ANALYSIS_DISPATCH_COST_H_
+#define IREE_COMPILER_DIALECT_STREAM_ANALYSIS_DISPATCH_COST_H_
+
+#include <cstdint>
+
+#include "mlir/Interfaces/FunctionInterfaces.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+
+// Static estimate of the work performed by a single dispatch of an exported
+// function. Used to produce roofline reports by combining the estimates with
+// measured dispatch times.
+struct DispatchCost {
+  // Arithmetic operations performed across all workgroups. Each scalar
+  // arith/math op in a linalg body counts as one operation per iteration so a
+  // multiply-accumulate is two.
+  uint64_t flops = 0;
+  // Bytes read from and written to the dispatch bindings assuming each bound
+  // tensor is accessed exactly once (read-write bindings count twice).
+  uint64_t bytes = 0;
+  // False if any dynamic shape or unrecognized op prevented a full estimate.
+  // The counts above are then lower bounds.
+  bool isComplete = true;
+
+  // Returns flops/bytes or 0 if no bytes are accessed.
+  double getArithmeticIntensity() const {
+    return bytes ? static_cast<double>(flops) / static_cast<double>(bytes)
+                 : 0.0;
+  }
+};
+
+// Estimates the cost of dispatching |funcOp|, the tensor-level implementation
+// of a stream.executable export (operating on !stream.binding arguments).
+// Only statically-shaped bindings and linalg ops with static loop ranges
+// contribute to the estimate.
+DispatchCost estimateDispatchCost(FunctionOpInterface funcOp);
+
+} // namespace Stream
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
+
+#endif // IREE_COMPILER_DIALECT_STREAM_ANALYSIS_DISPATCH_COST_H_
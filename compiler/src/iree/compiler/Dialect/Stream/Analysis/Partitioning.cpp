@@ -170,9 +170,9 @@ void PartitionSet::topologicalSort() {
 }
 
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block) {
+                                    Block *block, bool isolateCollectives) {
   // Only one algorithm today.
-  return partitionStreamableOpsReference(config, block);
+  return partitionStreamableOpsReference(config, block, isolateCollectives);
 }
 
 PartitionSet
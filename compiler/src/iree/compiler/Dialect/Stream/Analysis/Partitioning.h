@@ -106,8 +106,14 @@ struct PartitionSet {
 // partitions (with >1 implying duplication). Partitions may contain
 // non-streamable ops if it is safe to do so (such as std arithmetic). Not all
 // ops in the block will be covered by a partition.
+//
+// If |isolateCollectives| is set each collective op is placed in a partition
+// of its own and the ops producing its operands are kept out of partitions
+// with unrelated work. This allows a collective to execute as soon as its own
+// inputs are ready and concurrently with independent compute that follows it.
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block);
+                                    Block *block,
+                                    bool isolateCollectives = false);
 PartitionSet
 partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
                            Block *block);
@@ -120,7 +126,7 @@ partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
 // Produces the largest possible streams for any given block. Unsatisfactory.
 PartitionSet
 partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
-                                Block *block);
+                                Block *block, bool isolateCollectives = false);
 
 // Similarly poor algorithm to partitionStreamableOpsReference but for use
 // within partitioned streams to produce waves of concurrently executable work.
@@ -38,13 +38,57 @@ static std::unique_ptr<AsmState> getRootAsmState(Block *block) {
   return nullptr;
 }
 
+// Returns a map of each op in |block| to the set of external timepoints it
+// transitively waits on, as ordinals into the unique timepoints imported by
+// awaits in the block. Returns an empty map if fewer than two unique external
+// timepoints are awaited as then there is nothing to distinguish.
+//
+// When inputs are imported with their own fences (such as with the
+// fine-fences ABI model) this lets partitioning keep work depending only on the
+// inputs that are ready early separate from work that must wait on inputs still
+// being transferred.
+static DenseMap<Operation *, llvm::BitVector>
+computeExternalAwaitSets(Block *block) {
+  DenseMap<Operation *, llvm::BitVector> awaitSets;
+
+  llvm::SmallDenseMap<Value, unsigned> externalTimepoints;
+  for (auto awaitOp : block->getOps<IREE::Stream::TimepointAwaitOp>()) {
+    auto timepoint = awaitOp.getAwaitTimepoint();
+    if (!timepoint.getDefiningOp<IREE::Stream::TimepointImportOp>())
+      continue;
+    externalTimepoints.try_emplace(timepoint, externalTimepoints.size());
+  }
+  if (externalTimepoints.size() < 2)
+    return awaitSets;
+
+  for (auto &op : *block) {
+    llvm::BitVector awaitSet(externalTimepoints.size(), /*t=*/false);
+    if (auto awaitOp = dyn_cast<IREE::Stream::TimepointAwaitOp>(op)) {
+      auto it = externalTimepoints.find(awaitOp.getAwaitTimepoint());
+      if (it != externalTimepoints.end())
+        awaitSet.set(it->second);
+    }
+    for (auto operand : op.getOperands()) {
+      auto *definingOp = operand.getDefiningOp();
+      if (!definingOp || definingOp->getBlock() != block)
+        continue;
+      auto it = awaitSets.find(definingOp);
+      if (it != awaitSets.end())
+        awaitSet |= it->second;
+    }
+    if (awaitSet.any())
+      awaitSets[&op] = std::move(awaitSet);
+  }
+  return awaitSets;
+}
+
 // This is terrible. See Stream/Analysis/Partition.h for a description of what
 // a real implementation would do. We want cost modeling for tie breakers when
 // an op could be in multiple partitions, cloning for ops that are not worth
 // spanning partitions (like splats), etc.
 PartitionSet
 partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
-                                Block *block) {
+                                Block *block, bool isolateCollectives) {
   PartitionSet partitionSet;
 
   struct PartitionBuilder {
@@ -55,16 +99,22 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
     SetVector<Operation *> ops;
     // Ops that were cloned and are known not to have their values escape.
     DenseSet<Operation *> clonedOps;
-    void insert(Operation *op) {
+    // External timepoints the ops in the partition wait on, if any.
+    llvm::BitVector awaitSet;
+    void insert(Operation *op, const llvm::BitVector &opAwaitSet) {
       if (auto affinityOp = dyn_cast<IREE::Stream::AffinityOpInterface>(op)) {
         affinity = affinity ? affinity.joinAND(affinityOp.getAffinity())
                             : affinityOp.getAffinity();
       }
+      if (opAwaitSet.any())
+        awaitSet = opAwaitSet;
       ops.insert(op);
     }
   };
   SmallVector<std::unique_ptr<PartitionBuilder>> builders;
   llvm::BitVector usableBuilders;
+  // Partitions holding an isolated collective.
+  llvm::BitVector isolatedBuilders;
 
   struct OpInfo {
     // Which partitions the op is contained within.
@@ -76,6 +126,14 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
 
   auto asmState = getRootAsmState(block);
 
+  // Ops only join partitions waiting on the same external timepoints. Ops that
+  // don't wait on any can join any partition.
+  auto externalAwaitSets = computeExternalAwaitSets(block);
+  auto lookupAwaitSet = [&](Operation *op) -> llvm::BitVector {
+    auto it = externalAwaitSets.find(op);
+    return it != externalAwaitSets.end() ? it->second : llvm::BitVector();
+  };
+
   for (auto &op : llvm::reverse(*block)) {
     // Skip constants; they just add noise (and since they are heavily CSE'd
     // they have lots of users to test).
@@ -145,6 +203,31 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
       opInfo.hazards |= userInfo.membership;
       opInfo.hazards |= userInfo.hazards;
     }
+
+    // Collectives are placed in their own partitions when isolated. Only cheap
+    // ops that prefer being cloned (allocas, splats) may join them. Other ops
+    // producing their operands only join partitions consuming them and never
+    // one the collective depends on: joining an unrelated partition would make
+    // the collective wait on all of its work.
+    bool isolateOp =
+        isolateCollectives && isa<IREE::Stream::AsyncCollectiveOp>(op);
+    bool isCloneable = false;
+    if (auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op))
+      isCloneable = streamableOp.preferCloneToConsumers();
+    bool feedsIsolatedOp = false;
+    llvm::BitVector isolatedHazards;
+    if (isolateCollectives && !isCloneable) {
+      for (auto user : op.getUsers()) {
+        if (!isa<IREE::Stream::AsyncCollectiveOp>(user))
+          continue;
+        auto userInfoIt = opInfos.find(user);
+        if (userInfoIt == opInfos.end())
+          continue;
+        feedsIsolatedOp = true;
+        isolatedHazards |= userInfoIt->second.hazards;
+      }
+    }
+
     llvm::BitVector candidates(builders.size(), /*t=*/true);
     candidates ^= opInfo.hazards;
     candidates |= consumers;
@@ -160,6 +243,31 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
       }
     }
 
+    // Prune candidates that wait on a different set of external timepoints.
+    auto opAwaitSet = lookupAwaitSet(&op);
+    if (opAwaitSet.any()) {
+      for (auto ordinal : candidates.set_bits()) {
+        auto &partitionAwaitSet = builders[ordinal]->awaitSet;
+        if (partitionAwaitSet.any() && partitionAwaitSet != opAwaitSet) {
+          LLVM_DEBUG(llvm::dbgs() << "Candidate partition " << ordinal
+                                  << " awaits different timepoints\n");
+          candidates.reset(ordinal);
+        }
+      }
+    }
+
+    if (isolateOp) {
+      LLVM_DEBUG(llvm::dbgs() << "Isolating collective\n");
+      candidates.reset();
+    } else if (!isCloneable) {
+      candidates.reset(isolatedBuilders);
+      if (feedsIsolatedOp) {
+        LLVM_DEBUG(llvm::dbgs() << "Producer of isolated collective\n");
+        candidates &= consumers;
+        candidates.reset(isolatedHazards);
+      }
+    }
+
     // If this op is not streamable then bail here; we've still setup the hazard
     // map for following iteration.
     auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op);
@@ -184,7 +292,7 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
           LLVM_DEBUG(llvm::dbgs() << "Cloning into consumer partition "
                                   << consumerOrdinal << "\n");
           auto &consumerBuilder = builders[consumerOrdinal];
-          consumerBuilder->insert(&op);
+          consumerBuilder->insert(&op, opAwaitSet);
           consumerBuilder->clonedOps.insert(&op);
           opInfo.membership.set(consumerOrdinal);
           opInfo.hazards.reset(consumerOrdinal);
@@ -194,7 +302,7 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
         LLVM_DEBUG(llvm::dbgs() << "Moving into consumer partition "
                                 << consumerOrdinal << "\n");
         auto &consumerBuilder = builders[consumerOrdinal];
-        consumerBuilder->insert(&op);
+        consumerBuilder->insert(&op, opAwaitSet);
         opInfo.membership.set(consumerOrdinal);
         opInfo.hazards.reset(consumerOrdinal);
       }
@@ -207,7 +315,7 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
     if (firstCandidateOrdinal != -1) {
       LLVM_DEBUG(llvm::dbgs() << "Moving to first candidate partition "
                               << firstCandidateOrdinal << " (continue)\n");
-      builders[firstCandidateOrdinal]->insert(&op);
+      builders[firstCandidateOrdinal]->insert(&op, opAwaitSet);
       opInfo.membership.set(firstCandidateOrdinal);
       opInfo.hazards.reset(firstCandidateOrdinal);
       continue;
@@ -223,11 +331,14 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
     auto builder = std::make_unique<PartitionBuilder>();
     builder->ordinal = builders.size();
     builder->affinity = affinityAttr;
-    builder->insert(&op);
+    builder->insert(&op, opAwaitSet);
     LLVM_DEBUG(llvm::dbgs()
                << "Created partition " << builder->ordinal << "\n");
     builders.push_back(std::move(builder));
     usableBuilders.resize(builders.size(), /*t=*/true);
+    isolatedBuilders.resize(builders.size(), /*t=*/false);
+    if (isolateOp)
+      isolatedBuilders.set(builders.size() - 1);
   }
 
   // Ops cloned into multiple partitions may still escape if there are
@@ -68,6 +68,12 @@ static llvm::cl::opt<bool> clResourceAliasMutableBindings(
     llvm::cl::desc(
         "Fuses bindings that are mutable instead of leaving them split."),
     llvm::cl::init(false));
+static llvm::cl::opt<bool> clResourceAggressiveBindingFusion(
+    "iree-stream-resource-aggressive-binding-fusion",
+    llvm::cl::desc("Specializes dispatches per binding aliasing pattern and "
+                   "rebases correlated offsets to fuse more bindings and "
+                   "push constants."),
+    llvm::cl::init(false));
 
 //===----------------------------------------------------------------------===//
 // #stream.resource_config<...>
@@ -84,6 +90,7 @@ Attribute ResourceConfigAttr::parse(AsmParser &p, Type type) {
   int64_t minBufferRangeAlignment = 0;
   int64_t indexBits = 32;
   bool aliasMutableBindings = false;
+  bool aggressiveBindingFusion = false;
   while (failed(p.parseOptionalRBrace())) {
     StringRef key;
     int64_t value = 0;
@@ -103,6 +110,8 @@ Attribute ResourceConfigAttr::parse(AsmParser &p, Type type) {
       indexBits = value;
     } else if (key == "alias_mutable_bindings") {
       aliasMutableBindings = (bool)value;
+    } else if (key == "aggressive_binding_fusion") {
+      aggressiveBindingFusion = (bool)value;
     }
     (void)p.parseOptionalComma();
   }
@@ -111,7 +120,8 @@ Attribute ResourceConfigAttr::parse(AsmParser &p, Type type) {
 
   return ResourceConfigAttr::get(
       p.getContext(), maxAllocationSize, minBufferOffsetAlignment,
-      maxBufferRange, minBufferRangeAlignment, indexBits, aliasMutableBindings);
+      maxBufferRange, minBufferRangeAlignment, indexBits, aliasMutableBindings,
+      aggressiveBindingFusion);
 }
 
 void ResourceConfigAttr::print(AsmPrinter &p) const {
@@ -123,7 +133,8 @@ void ResourceConfigAttr::print(AsmPrinter &p) const {
   os << "max_buffer_range = " << getMaxBufferRange() << ", ";
   os << "min_buffer_range_alignment = " << getMinBufferRangeAlignment() << ", ";
   os << "index_bits = " << getIndexBits() << ", ";
-  os << "alias_mutable_bindings = " << getAliasMutableBindings();
+  os << "alias_mutable_bindings = " << getAliasMutableBindings() << ", ";
+  os << "aggressive_binding_fusion = " << getAggressiveBindingFusion();
   os << "}>";
 }
 
@@ -145,7 +156,8 @@ ResourceConfigAttr::intersectBufferConstraints(ResourceConfigAttr lhs,
       std::max(lhs.getMinBufferRangeAlignment(),
                rhs.getMinBufferRangeAlignment()),
       std::max(lhs.getIndexBits(), rhs.getIndexBits()),
-      rhs.getAliasMutableBindings() && lhs.getAliasMutableBindings());
+      rhs.getAliasMutableBindings() && lhs.getAliasMutableBindings(),
+      rhs.getAggressiveBindingFusion() && lhs.getAggressiveBindingFusion());
 }
 
 // static
@@ -157,7 +169,7 @@ ResourceConfigAttr::getDefaultHostConstraints(MLIRContext *context) {
   return ResourceConfigAttr::get(
       context, clResourceMaxAllocationSize, clResourceMinOffsetAlignment,
       clResourceMaxRange, clResourceMinOffsetAlignment, clResourceIndexBits,
-      clResourceAliasMutableBindings);
+      clResourceAliasMutableBindings, clResourceAggressiveBindingFusion);
 }
 
 // static
@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "iree/compiler/Dialect/Stream/Analysis/DispatchCost.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamTraits.h"
@@ -96,6 +97,42 @@ struct UsageInfo {
   }
 };
 
+// Returns the number of commands along the longest dependency chain of |op|.
+// Commands in a concurrent region are assumed to overlap entirely and all
+// other regions (including the execution region itself) execute serially.
+static size_t computeCriticalPathLength(Operation *op) {
+  if (auto concurrentOp = dyn_cast<IREE::Stream::CmdConcurrentOp>(op)) {
+    size_t maxLength = 0;
+    for (auto &nestedOp : concurrentOp.getBody().front()) {
+      maxLength = std::max(maxLength, computeCriticalPathLength(&nestedOp));
+    }
+    return maxLength;
+  }
+  if (op->getNumRegions() == 0) {
+    return op->hasTrait<OpTrait::IsTerminator>() ? 0 : 1;
+  }
+  size_t totalLength = 0;
+  for (auto &region : op->getRegions()) {
+    for (auto &block : region) {
+      for (auto &nestedOp : block) {
+        totalLength += computeCriticalPathLength(&nestedOp);
+      }
+    }
+  }
+  return totalLength;
+}
+
+// Returns the number of commands in the execution region |executeOp|.
+static size_t computeCommandCount(IREE::Stream::CmdExecuteOp executeOp) {
+  size_t commandCount = 0;
+  executeOp.getBody().walk([&](Operation *op) {
+    if (op->getNumRegions() == 0 && !op->hasTrait<OpTrait::IsTerminator>()) {
+      ++commandCount;
+    }
+  });
+  return commandCount;
+}
+
 // TODO(benvanik): StaticSize helper or something for the dynamic bit.
 struct Statistics {
   // Globals:
@@ -113,6 +150,13 @@ struct Statistics {
   size_t submissionCount = 0;
   int64_t transientSize = 0;
   bool transientSizeDynamic = false;
+  // Predicted maximum of transient memory live at once in any block assuming
+  // program order of the allocas and deallocas.
+  int64_t peakTransientSize = 0;
+  bool peakTransientSizeDynamic = false;
+  size_t commandCount = 0;
+  // Sum of the critical paths of all submissions, in commands.
+  size_t criticalPathLength = 0;
   // TODO(benvanik): add fill/copy sizes (when possible).
   size_t fillCount = 0;
   size_t copyCount = 0;
@@ -163,7 +207,10 @@ struct Statistics {
         transientSizeDynamic = true;
       }
     }
+    analyzePeakTransientSize(usageInfo);
     for (auto executeOp : usageInfo.executeOps) {
+      commandCount += computeCommandCount(executeOp);
+      criticalPathLength += computeCriticalPathLength(executeOp);
       executeOp.walk([&](Operation *op) {
         TypeSwitch<Operation *>(op)
             .Case<IREE::Stream::CmdFillOp>([&](auto op) { ++fillCount; })
@@ -179,6 +226,38 @@ struct Statistics {
     // Executables:
     executableCount = usageInfo.executableOps.size();
   }
+
+  // Walks each block containing allocas tracking the live transient memory as
+  // allocas and deallocas are encountered.
+  void analyzePeakTransientSize(const UsageInfo &usageInfo) {
+    llvm::MapVector<Block *, DenseMap<Operation *, int64_t>> blockDeltas;
+    for (auto allocaOp : usageInfo.allocaOps) {
+      APInt allocaSize;
+      if (!matchPattern(allocaOp.getStorageSize(),
+                        m_ConstantInt(&allocaSize))) {
+        peakTransientSizeDynamic = true;
+        continue;
+      }
+      auto &deltas = blockDeltas[allocaOp->getBlock()];
+      deltas[allocaOp] += allocaSize.getSExtValue();
+      for (auto *user : allocaOp.getResult().getUsers()) {
+        if (isa<IREE::Stream::ResourceDeallocaOp>(user) &&
+            user->getBlock() == allocaOp->getBlock()) {
+          deltas[user] -= allocaSize.getSExtValue();
+        }
+      }
+    }
+    for (auto &[block, deltas] : blockDeltas) {
+      int64_t liveSize = 0;
+      for (auto &op : *block) {
+        auto it = deltas.find(&op);
+        if (it == deltas.end())
+          continue;
+        liveSize += it->second;
+        peakTransientSize = std::max(peakTransientSize, liveSize);
+      }
+    }
+  }
 };
 
 //===----------------------------------------------------------------------===//
@@ -246,6 +325,13 @@ static void prettyPrintStatistics(const UsageInfo &usageInfo,
       "{0}{1} B ({2:F2} MiB)\n", stats.transientSizeDynamic ? "minimum " : "",
       stats.transientSize, stats.transientSize / (1 * 1024 * 1024.0f));
 
+  os << llvm::formatv(
+      "// Peak Memory: predicted {0}{1} B ({2:F2} MiB) of transients\n",
+      stats.peakTransientSizeDynamic ? "minimum " : "",
+      stats.peakTransientSize, stats.peakTransientSize / (1 * 1024 * 1024.0f));
+  os << llvm::formatv("//   Crit Path: {0} of {1} commands\n",
+                      stats.criticalPathLength, stats.commandCount);
+
   os << llvm::formatv("//   DMA Fills: {0}\n", stats.fillCount);
   os << llvm::formatv("//  DMA Copies: {0}\n", stats.copyCount);
   os << llvm::formatv("// Collectives: {0}\n", stats.collectiveCount);
@@ -303,11 +389,13 @@ static void prettyPrintStreamInfo(const UsageInfo &usageInfo,
   os << "\n";
   os << "//\n";
 
+  os << llvm::formatv("// Commands: {0}, critical path of {1}\n",
+                      computeCommandCount(executeOp),
+                      computeCriticalPathLength(executeOp));
+
   // TODO(benvanik): print stream information (for each stream.cmd.execute):
   // - number of unique resources captured
   // - number of commands of each type
-  // - % concurrently executable
-  os << "// TODO\n";
 }
 
 static void prettyPrintAllStreamInfo(const UsageInfo &usageInfo, bool verbose,
@@ -342,6 +430,11 @@ static void prettyPrintExecutableExportInfo(
   os << "\n";
   os << "//\n";
 
+  auto cost = estimateDispatchCost(funcOp);
+  os << llvm::formatv("// Estimated Cost: {0}{1} FLOP, {0}{2} B, ",
+                      cost.isComplete ? "" : ">=", cost.flops, cost.bytes);
+  os << llvm::formatv("{0:F2} FLOP/B\n", cost.getArithmeticIntensity());
+
   // TODO(benvanik): interface and usage stats:
   // - operand info
   // - binding info
@@ -351,8 +444,6 @@ static void prettyPrintExecutableExportInfo(
 
   // TODO(benvanik): ask codegen team if they want anything like a list of
   // linalg named ops, etc.
-
-  os << "// TODO\n";
 }
 
 static void prettyPrintExecutableInfo(const UsageInfo &usageInfo,
@@ -404,7 +495,7 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
   Statistics stats;
   stats.analyze(usageInfo);
 
-  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables")";
+  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Peak Transient Size","Fills","Copies","Dispatches","Async Calls","Critical Path","Executables")";
   os << "\n";
 
   // Globals:
@@ -416,9 +507,11 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
   os << llvm::formatv("{0},", stats.awaitCount);
 
   // Execution:
-  os << llvm::formatv("{0},{1},{2},{3},{4},{5},", stats.submissionCount,
-                      stats.transientSize, stats.fillCount, stats.copyCount,
-                      stats.dispatchCount, stats.callCount);
+  os << llvm::formatv("{0},{1},{2},{3},{4},{5},{6},{7},",
+                      stats.submissionCount, stats.transientSize,
+                      stats.peakTransientSize, stats.fillCount, stats.copyCount,
+                      stats.dispatchCount, stats.callCount,
+                      stats.criticalPathLength);
 
   // Executables:
   os << llvm::formatv("{0}", stats.executableCount);
@@ -496,6 +589,27 @@ static void dumpExecutionCSVTable(const UsageInfo &usageInfo,
   os << "\n";
 }
 
+static void dumpExecutableCSVTable(const UsageInfo &usageInfo,
+                                   llvm::raw_fd_ostream &os) {
+  os << R"("Symbol","FLOPs","Bytes","Complete")";
+  os << "\n";
+  for (auto it : usageInfo.executableOps) {
+    auto executableOp = it.second;
+    for (auto exportOp :
+         executableOp.getOps<IREE::Stream::ExecutableExportOp>()) {
+      auto funcOp = exportOp.lookupFunctionRef();
+      if (!funcOp)
+        continue;
+      auto cost = estimateDispatchCost(funcOp);
+      os << llvm::formatv(R"("@{0}::@{1}",{2},{3},{4})",
+                          executableOp.getName(), exportOp.getName(),
+                          cost.flops, cost.bytes, cost.isComplete ? 1 : 0);
+      os << "\n";
+    }
+  }
+  os << "\n";
+}
+
 static void dumpCSVTables(const UsageInfo &usageInfo,
                           llvm::raw_fd_ostream &os) {
   os << ";\n";
@@ -511,6 +625,11 @@ static void dumpCSVTables(const UsageInfo &usageInfo,
   for (auto executeOp : usageInfo.executeOps) {
     dumpExecutionCSVTable(usageInfo, executeOp, os);
   }
+
+  os << ";\n";
+  os << "; Executables\n";
+  os << ";\n\n";
+  dumpExecutableCSVTable(usageInfo, os);
 }
 
 //===----------------------------------------------------------------------===//
@@ -539,10 +658,14 @@ static void dumpAggregateJSONStructure(const UsageInfo &usageInfo,
   os << "  \"execution\": {\n";
   os << llvm::formatv(kvPair, "submission-count", stats.submissionCount);
   os << llvm::formatv(kvPair, "transient-memory-size", stats.transientSize);
+  os << llvm::formatv(kvPair, "peak-transient-memory-size",
+                      stats.peakTransientSize);
   os << llvm::formatv(kvPair, "fill-count", stats.fillCount);
   os << llvm::formatv(kvPair, "copy-count", stats.copyCount);
   os << llvm::formatv(kvPair, "dispatch-count", stats.dispatchCount);
-  os << llvm::formatv(kvPairNoComma, "call-count", stats.callCount);
+  os << llvm::formatv(kvPair, "call-count", stats.callCount);
+  os << llvm::formatv(kvPairNoComma, "critical-path-length",
+                      stats.criticalPathLength);
   os << "  },\n";
 
   os << "  \"executable\": {\n";
@@ -550,13 +673,45 @@ static void dumpAggregateJSONStructure(const UsageInfo &usageInfo,
   os << "  }\n";
 }
 
+// Dumps the estimated cost of each executable export keyed by export name.
+// Export names are preserved through to the runtime and can be used to join
+// against measured dispatch timings.
+static void dumpExecutableJSONStructure(const UsageInfo &usageInfo,
+                                        llvm::raw_fd_ostream &os) {
+  bool first = true;
+  for (auto it : usageInfo.executableOps) {
+    auto executableOp = it.second;
+    for (auto exportOp :
+         executableOp.getOps<IREE::Stream::ExecutableExportOp>()) {
+      auto funcOp = exportOp.lookupFunctionRef();
+      if (!funcOp)
+        continue;
+      auto cost = estimateDispatchCost(funcOp);
+      if (!first)
+        os << ",\n";
+      first = false;
+      os << llvm::formatv(
+          R"(  {{"executable": "{0}", "export": "{1}", "flops": {2}, )"
+          R"("bytes": {3}, "complete": {4}})",
+          executableOp.getName(), exportOp.getName(), cost.flops, cost.bytes,
+          cost.isComplete ? "true" : "false");
+    }
+  }
+  if (!first)
+    os << "\n";
+}
+
 static void dumpJSONStructures(const UsageInfo &usageInfo,
                                llvm::raw_fd_ostream &os) {
   os << "{\n";
 
   os << "\"stream-aggregate\": {\n";
   dumpAggregateJSONStructure(usageInfo, os);
-  os << "}\n";
+  os << "},\n";
+
+  os << "\"executable-exports\": [\n";
+  dumpExecutableJSONStructure(usageInfo, os);
+  os << "]\n";
 
   // TODO(antiagainst): dump per-execution data if needed.
 
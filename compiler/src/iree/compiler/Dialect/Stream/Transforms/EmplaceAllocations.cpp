@@ -20,6 +20,7 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -54,6 +55,134 @@ static void replaceUsesAndTransfer(Value oldValue, Value newValue) {
   oldValue.replaceAllUsesWith(transferValue);
 }
 
+// Returns the index of the resource operand |operand| of |dispatchOp| into the
+// resource operand size/offset/end/length lists or std::nullopt if the operand
+// is not a resource operand.
+static std::optional<unsigned>
+getResourceOperandRangeIndex(IREE::Stream::AsyncDispatchOp dispatchOp,
+                             OpOperand &operand) {
+  auto resourceOperands = dispatchOp.getResourceOperands();
+  unsigned beginIndex = resourceOperands.getBeginOperandIndex();
+  if (operand.getOperandNumber() < beginIndex ||
+      operand.getOperandNumber() >= beginIndex + resourceOperands.size()) {
+    return std::nullopt;
+  }
+  unsigned rangeIndex = 0;
+  for (Value resourceOperand : resourceOperands.take_front(
+           operand.getOperandNumber() - beginIndex)) {
+    if (resourceOperand.getType().isa<IREE::Stream::ResourceType>())
+      ++rangeIndex;
+  }
+  return rangeIndex;
+}
+
+// Returns true if nothing that mutates |value| in place (and the values tied
+// to it in turn) writes into the constant range [|offset|, |end|). Only
+// in-place updates and tied dispatch operands with constant ranges are
+// allowed; any other tied use is conservatively treated as overlapping.
+static bool isRangeUnmodified(Value value, int64_t offset, int64_t end) {
+  auto isDisjoint = [&](Value writeOffset, Value writeEnd) {
+    APInt writeOffsetInt;
+    APInt writeEndInt;
+    if (!matchPattern(writeOffset, m_ConstantInt(&writeOffsetInt)) ||
+        !matchPattern(writeEnd, m_ConstantInt(&writeEndInt))) {
+      return false;
+    }
+    return writeEndInt.getSExtValue() <= offset ||
+           writeOffsetInt.getSExtValue() >= end;
+  };
+  while (value) {
+    Value nextValue;
+    for (OpOperand &use : value.getUses()) {
+      Value tiedResult;
+      if (auto updateOp = dyn_cast<IREE::Stream::AsyncUpdateOp>(
+              use.getOwner())) {
+        if (updateOp.getTarget() != value)
+          continue;
+        if (!isDisjoint(updateOp.getTargetOffset(), updateOp.getTargetEnd()))
+          return false;
+        tiedResult = updateOp.getResult();
+      } else if (auto dispatchOp = dyn_cast<IREE::Stream::AsyncDispatchOp>(
+                     use.getOwner())) {
+        auto tiedResults =
+            dispatchOp.getOperandTiedResults(use.getOperandNumber());
+        if (tiedResults.empty())
+          continue;
+        auto rangeIndex = getResourceOperandRangeIndex(dispatchOp, use);
+        if (!rangeIndex || tiedResults.size() != 1 ||
+            !isDisjoint(dispatchOp.getResourceOperandOffsets()[*rangeIndex],
+                        dispatchOp.getResourceOperandEnds()[*rangeIndex])) {
+          return false;
+        }
+        tiedResult = tiedResults.front();
+      } else if (auto tiedOp =
+                     dyn_cast<IREE::Util::TiedOpInterface>(use.getOwner())) {
+        if (tiedOp.isOperandTied(use.getOperandNumber()))
+          return false;
+        continue;
+      } else {
+        continue;
+      }
+      // Copy-on-write has already been materialized so there can only be one
+      // in-place mutation of each value.
+      if (nextValue)
+        return false;
+      nextValue = tiedResult;
+    }
+    value = nextValue;
+  }
+  return true;
+}
+
+// Returns true if the dispatch ops in |readUses| can read the subrange of
+// |updateOp|'s target that their operand is placed into instead of the
+// operand itself. The subrange must have a constant range that no subsequent
+// in-place mutation of the target overwrites.
+static bool canReadFromPlacedRange(ArrayRef<OpOperand *> readUses,
+                                   IREE::Stream::AsyncUpdateOp updateOp,
+                                   Operation *producerOp) {
+  APInt targetOffset;
+  APInt targetEnd;
+  if (!matchPattern(updateOp.getTargetOffset(), m_ConstantInt(&targetOffset)) ||
+      !matchPattern(updateOp.getTargetEnd(), m_ConstantInt(&targetEnd))) {
+    return false;
+  }
+  for (OpOperand *use : readUses) {
+    auto readOp = dyn_cast<IREE::Stream::AsyncDispatchOp>(use->getOwner());
+    if (!readOp || readOp == producerOp ||
+        !getResourceOperandRangeIndex(readOp, *use) ||
+        readOp.isOperandTied(use->getOperandNumber())) {
+      return false;
+    }
+  }
+  return isRangeUnmodified(updateOp.getResult(), targetOffset.getSExtValue(),
+                           targetEnd.getSExtValue());
+}
+
+// Redirects the dispatch ops in |readUses| to read the subrange of |result|
+// starting at |targetOffset| after it has been placed into a larger resource
+// of size |targetSize|.
+static void redirectReadsToPlacedRange(ArrayRef<OpOperand *> readUses,
+                                       Value targetOffset, Value targetSize) {
+  for (OpOperand *use : readUses) {
+    auto readOp = cast<IREE::Stream::AsyncDispatchOp>(use->getOwner());
+    unsigned rangeIndex = getResourceOperandRangeIndex(readOp, *use).value();
+    OpBuilder builder(readOp);
+    auto offsets = readOp.getResourceOperandOffsetsMutable();
+    auto ends = readOp.getResourceOperandEndsMutable();
+    Value offset = builder.createOrFold<arith::AddIOp>(
+        readOp.getLoc(), targetOffset,
+        readOp.getResourceOperandOffsets()[rangeIndex]);
+    Value end = builder.createOrFold<arith::AddIOp>(
+        readOp.getLoc(), targetOffset,
+        readOp.getResourceOperandEnds()[rangeIndex]);
+    offsets.slice(rangeIndex, 1).assign(offset);
+    ends.slice(rangeIndex, 1).assign(end);
+    readOp.getResourceOperandSizesMutable().slice(rangeIndex, 1).assign(
+        targetSize);
+  }
+}
+
 // TODO(#14566): multiple results with sparse ties don't work due to
 // implicit operand/result ordering on the dispatch ops. Flow and stream
 // dispatch ops and the executable entry points need to be reworked to
@@ -62,9 +191,27 @@ static void replaceUsesAndTransfer(Value oldValue, Value newValue) {
 static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
   bool didChange = false;
   for (auto [resultIndex, result] : llvm::enumerate(dispatchOp.getResults())) {
-    // Ignore results with multiple users. We could potentially place these but
-    // that makes tracking much more complicated.
-    if (!result.hasOneUse()) {
+    // Results with multiple users are only placed if they have a single update
+    // user and all others are dispatches that can read the placed subrange
+    // in-place (such as a skip connection also feeding a concat).
+    Operation *userOp = nullptr;
+    SmallVector<OpOperand *> readUses;
+    for (OpOperand &use : result.getUses()) {
+      auto updateOp = dyn_cast<IREE::Stream::AsyncUpdateOp>(use.getOwner());
+      if (!userOp && updateOp && updateOp.getUpdate() == result) {
+        userOp = updateOp;
+      } else {
+        readUses.push_back(&use);
+      }
+    }
+    if (!userOp) {
+      // TODO(#14566): continue if sparse emplacement on multiple results.
+      break;
+    }
+    if (!readUses.empty() &&
+        !canReadFromPlacedRange(readUses,
+                                cast<IREE::Stream::AsyncUpdateOp>(userOp),
+                                dispatchOp)) {
       // TODO(#14566): continue if sparse emplacement on multiple results.
       break;
     }
@@ -84,7 +231,6 @@ static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
     Value targetLength;
     Value targetResult;
     Value targetResultSize;
-    Operation *userOp = *result.user_begin();
     if (auto updateOp = dyn_cast<IREE::Stream::AsyncUpdateOp>(userOp)) {
       if (updateOp.getUpdate() != result) {
         // TODO(#14566): continue if sparse emplacement on multiple results.
@@ -138,7 +284,9 @@ static bool tryEmplaceDispatchOp(IREE::Stream::AsyncDispatchOp dispatchOp) {
     resultSizes[resultIndex] = targetResultSize;
     dispatchOp.getResultSizesMutable().assign(resultSizes);
 
-    // Replace users with the result of the dispatch op.
+    // Redirect other readers to the placed subrange and replace users of the
+    // update with the result of the dispatch op.
+    redirectReadsToPlacedRange(readUses, targetOffset, targetResultSize);
     replaceUsesAndTransfer(targetResult, result);
     userOp->erase();
 
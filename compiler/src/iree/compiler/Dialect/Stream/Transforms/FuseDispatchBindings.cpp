@@ -5,6 +5,8 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -65,20 +67,68 @@ struct Binding {
   // One bit per binding that alias each other.
   llvm::BitVector correlationMap;
 
+  // One entry per correlated binding (in correlationMap order) with the
+  // offset of the range relative to the first correlated binding if it is the
+  // same at all dispatch sites. Such ranges need no offset operand.
+  SmallVector<std::optional<int64_t>> relativeOffsets;
+
   // An access bitfield with a union of all range accesses.
   IREE::Stream::ResourceAccessBitfield derivedAccess =
       IREE::Stream::ResourceAccessBitfield::None;
 };
 
+// Returns for each binding of |dispatchOp| the index of the first binding at
+// the same site that it may alias. Mutable bindings are only aliased when
+// |aliasMutableBindings| is set.
+static SmallVector<unsigned>
+getBindingAliasLeaders(IREE::Stream::CmdDispatchOp dispatchOp,
+                       bool aliasMutableBindings) {
+  SmallVector<unsigned> leaders;
+  DenseMap<Value, unsigned> resourceLeaders;
+  for (auto [idx, resource, resourceAccessAttr] : llvm::enumerate(
+           dispatchOp.getResources(), dispatchOp.getResourceAccesses())) {
+    // If the resource is mutable and we were told not to alias mutable
+    // bindings we always put the resource into its own class.
+    auto resourceAccess =
+        llvm::cast<IREE::Stream::ResourceAccessBitfieldAttr>(
+            resourceAccessAttr);
+    if (!aliasMutableBindings &&
+        bitEnumContainsAll(resourceAccess.getValue(),
+                           IREE::Stream::ResourceAccessBitfield::Write)) {
+      leaders.push_back(idx);
+      resourceLeaders.insert(std::make_pair(resource, idx));
+      continue;
+    }
+
+    // Find or create a class for equivalent aliasable resource bindings.
+    auto it = resourceLeaders.insert(std::make_pair(resource, idx)).first;
+    leaders.push_back(it->second);
+  }
+  return leaders;
+}
+
+// Returns the constant |offset| - |baseOffset| if it can be derived.
+static std::optional<int64_t> getRelativeOffset(Value baseOffset,
+                                                Value offset) {
+  if (offset == baseOffset)
+    return 0;
+  APInt baseValue;
+  APInt value;
+  if (!matchPattern(baseOffset, m_ConstantInt(&baseValue)) ||
+      !matchPattern(offset, m_ConstantInt(&value))) {
+    return std::nullopt;
+  }
+  return value.getSExtValue() - baseValue.getSExtValue();
+}
+
 // Builds a set of fused bindings based on dispatches.
 // Each dispatch may have a unique binding set and we conservatively fuse only
-// those we can prove are the same. We could in the future introduce new entry
-// points if we had minor divergence in order to gain more fusion in the common
-// cases.
+// those we can prove are the same. Sites that diverge can be split onto their
+// own entry points with specializeDivergentDispatches to gain more fusion.
 static SmallVector<Binding>
 findCorrelatedBindings(unsigned bindingCount,
                        ArrayRef<IREE::Stream::CmdDispatchOp> dispatchOps,
-                       bool aliasMutableBindings) {
+                       bool aliasMutableBindings, bool rebaseOffsets) {
   // For each dispatch build equivalence classes indicating which bindings are
   // from the same base resource. Note that not all dispatches will have the
   // same duplicate bindings (though we hope they do!).
@@ -86,32 +136,11 @@ findCorrelatedBindings(unsigned bindingCount,
   ecs.reserve(dispatchOps.size());
   for (auto dispatchOp : dispatchOps) {
     llvm::EquivalenceClasses<unsigned> ec;
-    DenseMap<Value, unsigned> leaders;
-    for (auto [idx, resource, resourceAccessAttr] : llvm::enumerate(
-             dispatchOp.getResources(), dispatchOp.getResourceAccesses())) {
-      // If the resource is mutable and we were told not to alias mutable
-      // bindings we always put the resource into its own class.
-      auto resourceAccess =
-          llvm::cast<IREE::Stream::ResourceAccessBitfieldAttr>(
-              resourceAccessAttr);
-      if (!aliasMutableBindings &&
-          bitEnumContainsAll(resourceAccess.getValue(),
-                             IREE::Stream::ResourceAccessBitfield::Write)) {
-        ec.insert(idx);
-        leaders.insert(std::make_pair(resource, idx));
-        continue;
-      }
-
-      // Find or create a class for equivalent aliasable resource bindings.
-      auto ecIt = leaders.find(resource);
-      if (ecIt == leaders.end()) {
-        // New unique value.
-        ec.insert(idx);
-        leaders.insert(std::make_pair(resource, idx));
-      } else {
-        // Found existing; union with leader.
-        ec.unionSets(ecIt->second, idx);
-      }
+    for (auto [idx, leader] : llvm::enumerate(
+             getBindingAliasLeaders(dispatchOp, aliasMutableBindings))) {
+      ec.insert(idx);
+      if (leader != idx)
+        ec.unionSets(leader, idx);
     }
     ecs.push_back(std::move(ec));
   }
@@ -165,6 +194,26 @@ findCorrelatedBindings(unsigned bindingCount,
         binding.derivedAccess = binding.derivedAccess | range.access;
       }
     }
+
+    // Find ranges at a uniform offset from the first range of the binding.
+    // The first range always gets an offset operand.
+    for (unsigned k = 0; k < binding.correlationMap.count(); ++k) {
+      std::optional<int64_t> relativeOffset;
+      if (rebaseOffsets && k > 0) {
+        for (auto dispatchOp : dispatchOps) {
+          auto &siteRanges = binding.sites[dispatchOp];
+          auto siteOffset = getRelativeOffset(siteRanges.front().offset,
+                                              siteRanges[k].offset);
+          if (!siteOffset ||
+              (relativeOffset && *relativeOffset != *siteOffset)) {
+            relativeOffset = std::nullopt;
+            break;
+          }
+          relativeOffset = siteOffset;
+        }
+      }
+      binding.relativeOffsets.push_back(relativeOffset);
+    }
     bindings.push_back(binding);
   }
   return bindings;
@@ -206,15 +255,29 @@ static void updateExecutableSignature(IREE::Stream::ExecutableOp executableOp,
   unsigned offsetIdx = newBindingArgs.back().getArgNumber() + 1;
   for (auto binding : llvm::enumerate(bindings)) {
     auto newBindingArg = newBindingArgs[binding.index()];
-    for (unsigned oldIdx : binding.value().correlationMap.set_bits()) {
+    BlockArgument baseOffsetArg;
+    for (auto [oldIdx, relativeOffset] :
+         llvm::zip_equal(binding.value().correlationMap.set_bits(),
+                         binding.value().relativeOffsets)) {
       auto oldBindingArg = oldBindingArgs[oldIdx];
-      auto offsetArg = entryBlock.insertArgument(offsetIdx++, offsetType,
-                                                 newBindingArg.getLoc());
+      BlockArgument offsetArg = baseOffsetArg;
+      if (!relativeOffset) {
+        offsetArg = entryBlock.insertArgument(offsetIdx++, offsetType,
+                                              newBindingArg.getLoc());
+      }
+      if (!baseOffsetArg)
+        baseOffsetArg = offsetArg;
       for (auto &use : llvm::make_early_inc_range(oldBindingArg.getUses())) {
         if (auto subspanOp =
                 dyn_cast<IREE::Stream::BindingSubspanOp>(use.getOwner())) {
           OpBuilder builder(subspanOp);
           Value offsetSum = offsetArg;
+          if (relativeOffset && *relativeOffset != 0) {
+            offsetSum = builder.createOrFold<arith::AddIOp>(
+                newBindingArg.getLoc(), offsetSum,
+                builder.create<arith::ConstantIndexOp>(newBindingArg.getLoc(),
+                                                       *relativeOffset));
+          }
           if (!mlir::matchPattern(subspanOp.getByteOffset(), m_Zero())) {
             offsetSum = builder.createOrFold<arith::AddIOp>(
                 newBindingArg.getLoc(), subspanOp.getByteOffset(), offsetSum);
@@ -282,8 +345,11 @@ static void updateDispatchSite(IREE::Stream::CmdDispatchOp dispatchOp,
     // We could be more selective about what we add but doing it like this and
     // relying on dispatch site specialization allows us to reuse that pass to
     // better deduplicate and inline values.
-    for (auto &range : ranges) {
-      newOperands.push_back(range.offset);
+    // Ranges at a uniform offset from the first are rebased in the executable.
+    for (auto [range, relativeOffset] :
+         llvm::zip_equal(ranges, binding.relativeOffsets)) {
+      if (!relativeOffset)
+        newOperands.push_back(range.offset);
     }
 
     // New binding has full resource range. We could use min/max to get a
@@ -325,6 +391,17 @@ fuseDispatchBindings(IREE::Stream::ExecutableOp executableOp,
   auto configAttr = IREE::Stream::ResourceConfigAttr::lookup(exportOp);
   bool aliasMutableBindings = configAttr.getAliasMutableBindings();
 
+  // Subranges into the same resource are commonly at fixed distances from each
+  // other (such as slices of a transient or constant storage buffer):
+  //   operand[0]: @storage0: offset 100
+  //   operand[1]: @storage0: offset 200
+  // ->
+  //   operand[0]: @storage0: offset 100
+  //   (offset[0] + 100 inlined into the executable)
+  // Passing only the base offset reduces the push constants each dispatch must
+  // update.
+  bool rebaseOffsets = configAttr.getAggressiveBindingFusion();
+
   LLVM_DEBUG({
     AsmState asmState(executableOp->getParentOp());
     llvm::dbgs() << "---- fuseDispatchBindings(@" << executableOp.getSymName()
@@ -337,8 +414,8 @@ fuseDispatchBindings(IREE::Stream::ExecutableOp executableOp,
   });
 
   // Analysis to find which bindings we can fuse together based on dispatches.
-  auto bindings =
-      findCorrelatedBindings(bindingCount, dispatchOps, aliasMutableBindings);
+  auto bindings = findCorrelatedBindings(bindingCount, dispatchOps,
+                                        aliasMutableBindings, rebaseOffsets);
 
   // TODO(benvanik): canonicalize bindings and bail early here. Today this
   // rebasing will widen access modes and pass in the offset across the bindings
@@ -377,24 +454,6 @@ fuseDispatchBindings(IREE::Stream::ExecutableOp executableOp,
     }
   });
 
-  // TODO(benvanik): some special handling for finding least-common-denominator
-  // or base values for constants passed in. We can end up with a lot of
-  // subranges into transient or constant resources that are all relatively
-  // correlated:
-  //   operand[0]: @storage0: offset 100
-  //   operand[1]: @storage0: offset 200
-  //   operand[2]: @storage0: offset 300
-  // ->
-  //   operand[0]: @storage0: offset +0
-  //   operand[1]: @storage0: offset +100
-  //   operand[2]: @storage0: offset +200
-  // Identifying these and using those relative offsets would make it cheaper to
-  // inline the values into the executables as they are not dispatch site
-  // specific. We'd do this by going per range and finding uniformly constant
-  // values. See the old MaterializeInterfaces.cpp pass for an earlier
-  // implementation that was special-cased for constant buffers only: here we
-  // can do it for everything.
-
   // Update the executable function to use the new bindings.
   auto funcOp = exportOp.lookupFunctionRef();
   assert(funcOp && "entry func not found");
@@ -408,6 +467,105 @@ fuseDispatchBindings(IREE::Stream::ExecutableOp executableOp,
   bindings.clear(); // invalidated above
 }
 
+//===----------------------------------------------------------------------===//
+// Entry point specialization
+//===----------------------------------------------------------------------===//
+
+// Clones |exportOp| and its function with |suffix|.
+static IREE::Stream::ExecutableExportOp
+cloneExport(IREE::Stream::ExecutableOp executableOp,
+            IREE::Stream::ExecutableExportOp exportOp, StringRef suffix) {
+  auto funcOp = exportOp.lookupFunctionRef();
+  auto innerModuleOp = funcOp->getParentOfType<mlir::ModuleOp>();
+
+  auto clonedFuncOp = funcOp.clone();
+  clonedFuncOp.setName((funcOp.getName() + suffix).str());
+  auto funcName = SymbolTable(innerModuleOp)
+                      .insert(clonedFuncOp, ++Block::iterator(funcOp));
+
+  auto clonedExportOp = exportOp.clone();
+  clonedExportOp.setSymName((exportOp.getSymName() + suffix).str());
+  clonedExportOp.setFunctionRefAttr(FlatSymbolRefAttr::get(funcName));
+  SymbolTable(executableOp)
+      .insert(clonedExportOp, ++Block::iterator(exportOp));
+  return clonedExportOp;
+}
+
+// Splits |dispatchOps| of |exportOp| by the pattern of resources they alias
+// and moves each pattern beyond the first to its own clone of the export.
+// Fusion only considers bindings correlated at all dispatch sites of an export
+// and a single site binding distinct resources would otherwise prevent fusion
+// for all of them. Dispatches that may select between multiple entry points
+// remain on the original export.
+//
+// Returns the new exports with the dispatches targeting them.
+static SmallVector<std::pair<IREE::Stream::ExecutableExportOp,
+                             SmallVector<IREE::Stream::CmdDispatchOp>>>
+specializeDivergentDispatches(
+    IREE::Stream::ExecutableOp executableOp,
+    IREE::Stream::ExecutableExportOp exportOp,
+    SmallVector<IREE::Stream::CmdDispatchOp> &dispatchOps) {
+  if (dispatchOps.size() <= 1)
+    return {};
+  auto configAttr = IREE::Stream::ResourceConfigAttr::lookup(exportOp);
+  bool aliasMutableBindings = configAttr.getAliasMutableBindings();
+
+  // Pattern of the original export; taken from the first dispatch that must
+  // stay on it, if any.
+  SmallVector<unsigned> basePattern;
+  for (auto dispatchOp : dispatchOps) {
+    if (dispatchOp.getEntryPoints().size() > 1) {
+      basePattern = getBindingAliasLeaders(dispatchOp, aliasMutableBindings);
+      break;
+    }
+  }
+  if (basePattern.empty()) {
+    basePattern =
+        getBindingAliasLeaders(dispatchOps.front(), aliasMutableBindings);
+  }
+
+  SmallVector<IREE::Stream::CmdDispatchOp> baseDispatchOps;
+  SmallVector<std::pair<SmallVector<unsigned>,
+                        SmallVector<IREE::Stream::CmdDispatchOp>>>
+      divergentGroups;
+  for (auto dispatchOp : dispatchOps) {
+    auto pattern = getBindingAliasLeaders(dispatchOp, aliasMutableBindings);
+    if (pattern == basePattern || dispatchOp.getEntryPoints().size() > 1) {
+      baseDispatchOps.push_back(dispatchOp);
+      continue;
+    }
+    auto it = llvm::find_if(divergentGroups, [&](auto &group) {
+      return group.first == pattern;
+    });
+    if (it == divergentGroups.end()) {
+      divergentGroups.push_back({pattern, {}});
+      it = std::prev(divergentGroups.end());
+    }
+    it->second.push_back(dispatchOp);
+  }
+  if (divergentGroups.empty())
+    return {};
+
+  SmallVector<std::pair<IREE::Stream::ExecutableExportOp,
+                        SmallVector<IREE::Stream::CmdDispatchOp>>>
+      specializations;
+  for (auto [i, group] : llvm::enumerate(divergentGroups)) {
+    auto clonedExportOp = cloneExport(executableOp, exportOp,
+                                      "_fused_" + std::to_string(i));
+    auto entryPointAttr = SymbolRefAttr::get(
+        executableOp.getSymNameAttr(),
+        {FlatSymbolRefAttr::get(clonedExportOp.getSymNameAttr())});
+    for (auto dispatchOp : group.second) {
+      dispatchOp.setEntryPointsAttr(
+          ArrayAttr::get(dispatchOp.getContext(), {entryPointAttr}));
+    }
+    specializations.push_back(
+        std::make_pair(clonedExportOp, std::move(group.second)));
+  }
+  dispatchOps = std::move(baseDispatchOps);
+  return specializations;
+}
+
 //===----------------------------------------------------------------------===//
 // -iree-stream-fuse-dispatch-bindings
 //===----------------------------------------------------------------------===//
@@ -452,9 +610,20 @@ public:
          getOperation().getBodyRegion().getOps<IREE::Stream::ExecutableOp>()) {
       if (!executableOp.getInnerModule())
         continue;
-      for (auto exportOp :
-           executableOp.getOps<IREE::Stream::ExecutableExportOp>()) {
-        fuseDispatchBindings(executableOp, exportOp, entryDispatchMap[exportOp],
+      auto exportOps = llvm::to_vector(
+          executableOp.getOps<IREE::Stream::ExecutableExportOp>());
+      for (auto exportOp : exportOps) {
+        auto &dispatchOps = entryDispatchMap[exportOp];
+        auto configAttr = IREE::Stream::ResourceConfigAttr::lookup(exportOp);
+        if (configAttr.getAggressiveBindingFusion()) {
+          for (auto &[specializedOp, specializedDispatchOps] :
+               specializeDivergentDispatches(executableOp, exportOp,
+                                             dispatchOps)) {
+            fuseDispatchBindings(executableOp, specializedOp,
+                                 specializedDispatchOps, memoizedZeros);
+          }
+        }
+        fuseDispatchBindings(executableOp, exportOp, dispatchOps,
                              memoizedZeros);
       }
     }
@@ -312,11 +312,16 @@ static TimepointResource buildTryMapConstantResource(
   return TimepointResource{ifTimepoint, ifResource, storageResourceSize};
 }
 
-static Value generateUpload(Value awaitTimepoint,
-                            IREE::Stream::ResourceConstantsOp constantsOp,
-                            IREE::Stream::Lifetime lifetime,
-                            IREE::Stream::ResourceConfigAttr resourceConfig,
-                            IndexSet &indexSet, OpBuilder &builder) {
+// Emits the uploads of all constants of |lifetime| in |constantsOp| and appends
+// the timepoints indicating their completion to |uploadTimepoints|. Uploads of
+// separate storage resources are independent so that they can be scheduled
+// concurrently with each other and any other initialization work.
+static void generateUpload(Value awaitTimepoint,
+                           IREE::Stream::ResourceConstantsOp constantsOp,
+                           IREE::Stream::Lifetime lifetime,
+                           IREE::Stream::ResourceConfigAttr resourceConfig,
+                           IndexSet &indexSet, OpBuilder &builder,
+                           SmallVectorImpl<Value> &uploadTimepoints) {
   // Gather the slices produced by this constant pooling op.
   SmallVector<ConstantSlice> slices;
   slices.reserve(constantsOp.getResults().size());
@@ -339,7 +344,7 @@ static Value generateUpload(Value awaitTimepoint,
   auto storageResources =
       computePackingMap(slices, resourceConfig, constantsOp.getContext());
   if (storageResources.empty())
-    return nullptr;
+    return;
 
   // TODO(benvanik): should be able to have a single buffer constant and
   // subrange it so that we don't need so many files.
@@ -351,7 +356,6 @@ static Value generateUpload(Value awaitTimepoint,
   // Emit rodata storage for the constant values.
   // As our upload paths may vary this ensures that we are only emitting
   // them once regardless of how many strategies we emit IR for.
-  Value currentTimepoint = awaitTimepoint;
   for (auto &storageResource : storageResources) {
     Value storageBuffer = builder.create<IREE::Util::BufferConstantOp>(
         storageResource.loc, /*name=*/nullptr, storageResource.data,
@@ -365,12 +369,12 @@ static Value generateUpload(Value awaitTimepoint,
     TimepointResource uploadedResource;
     if (resourceType.getLifetime() == IREE::Stream::Lifetime::Constant) {
       uploadedResource = buildTryMapConstantResource(
-          constantsOp.getLoc(), currentTimepoint, constantsOp.getAffinityAttr(),
+          constantsOp.getLoc(), awaitTimepoint, constantsOp.getAffinityAttr(),
           resourceType, storageResource, resourceSize, storageBuffer,
           resourceSize, indexSet, builder);
     } else {
       uploadedResource = buildFileRead(
-          constantsOp.getLoc(), currentTimepoint, constantsOp.getAffinityAttr(),
+          constantsOp.getLoc(), awaitTimepoint, constantsOp.getAffinityAttr(),
           resourceType, storageResource, resourceSize, storageBuffer,
           resourceSize, indexSet, builder);
     }
@@ -383,11 +387,8 @@ static Value generateUpload(Value awaitTimepoint,
       span.slice.result.replaceAllUsesWith(subviewOp.getResult());
     }
 
-    currentTimepoint = uploadedResource.timepoint;
+    uploadTimepoints.push_back(uploadedResource.timepoint);
   }
-
-  // Join on storage timepoints for our transitive dependencies to await.
-  return currentTimepoint;
 }
 
 //===----------------------------------------------------------------------===//
@@ -431,20 +432,27 @@ public:
       indexSet.populate(constantsOp.getResultSizes());
 
       // Perform upload/processing for immutable and mutable constants.
-      Value currentTimepoint =
+      Value immediateTimepoint =
           builder.create<IREE::Stream::TimepointImmediateOp>(
               constantsOp.getLoc());
-      if (auto uploadTimepoint = generateUpload(
-              currentTimepoint, constantsOp, IREE::Stream::Lifetime::Constant,
-              resourceConfig, indexSet, builder)) {
-        currentTimepoint = uploadTimepoint;
-      }
-      if (auto uploadTimepoint = generateUpload(
-              currentTimepoint, constantsOp, IREE::Stream::Lifetime::Variable,
-              resourceConfig, indexSet, builder)) {
-        currentTimepoint = uploadTimepoint;
+      SmallVector<Value> uploadTimepoints;
+      generateUpload(immediateTimepoint, constantsOp,
+                     IREE::Stream::Lifetime::Constant, resourceConfig, indexSet,
+                     builder, uploadTimepoints);
+      generateUpload(immediateTimepoint, constantsOp,
+                     IREE::Stream::Lifetime::Variable, resourceConfig, indexSet,
+                     builder, uploadTimepoints);
+
+      // Join on all uploads for our transitive dependencies to await.
+      Value resultTimepoint = immediateTimepoint;
+      if (uploadTimepoints.size() == 1) {
+        resultTimepoint = uploadTimepoints.front();
+      } else if (uploadTimepoints.size() > 1) {
+        resultTimepoint = builder.create<IREE::Stream::TimepointJoinOp>(
+            constantsOp.getLoc(), immediateTimepoint.getType(),
+            uploadTimepoints);
       }
-      constantsOp.getResultTimepoint().replaceAllUsesWith(currentTimepoint);
+      constantsOp.getResultTimepoint().replaceAllUsesWith(resultTimepoint);
 
       constantsOp.erase();
     });
@@ -0,0 +1,316 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-pack-transients"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Transient slot analysis
+//===----------------------------------------------------------------------===//
+
+// A transient allocation scoped to a single block that is a candidate for
+// placement into a shared arena.
+struct TransientSlot {
+  IREE::Stream::ResourceAllocaOp allocaOp;
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+  // Position of the alloca and dealloca ops in the parent block. The slot is
+  // live over the inclusive range [start, end] in program order.
+  int64_t start = 0;
+  int64_t end = 0;
+};
+
+// Returns the dealloca of the transient allocated by |allocaOp| if its entire
+// lifetime is contained within the parent block and ends at the dealloca.
+static IREE::Stream::ResourceDeallocaOp
+findBlockLocalDealloca(IREE::Stream::ResourceAllocaOp allocaOp,
+                       DenseMap<Operation *, int64_t> &opOrdinals) {
+  auto resourceType =
+      llvm::dyn_cast<IREE::Stream::ResourceType>(allocaOp.getResult().getType());
+  if (!resourceType ||
+      resourceType.getLifetime() != IREE::Stream::Lifetime::Transient) {
+    return {};
+  }
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+  for (auto *user : allocaOp.getResult().getUsers()) {
+    if (user->getBlock() != allocaOp->getBlock())
+      return {};
+    if (auto userDeallocaOp = dyn_cast<IREE::Stream::ResourceDeallocaOp>(user)) {
+      if (deallocaOp)
+        return {};
+      deallocaOp = userDeallocaOp;
+    }
+  }
+  if (!deallocaOp)
+    return {};
+
+  // All other uses must happen before the memory is released.
+  int64_t end = opOrdinals[deallocaOp];
+  for (auto *user : allocaOp.getResult().getUsers()) {
+    if (opOrdinals[user] > end)
+      return {};
+  }
+  return deallocaOp;
+}
+
+// Gathers the ops that need to move above |insertionPoint| for |value| to be
+// available there. Returns false if |value| cannot be made available.
+static bool gatherHoistableOps(Value value, Operation *insertionPoint,
+                               DenseMap<Operation *, int64_t> &opOrdinals,
+                               SetVector<Operation *> &hoistedOps) {
+  // Values not defined by ops in the block dominate the whole block as they
+  // are already used within it.
+  auto *definingOp = value.getDefiningOp();
+  if (!definingOp || definingOp->getBlock() != insertionPoint->getBlock()) {
+    return true;
+  }
+  if (opOrdinals[definingOp] < opOrdinals[insertionPoint] ||
+      hoistedOps.contains(definingOp)) {
+    return true;
+  }
+  // Only pure size arithmetic (constants, stream.resource.pack, etc) can move.
+  if (!isPure(definingOp) || definingOp->getNumRegions() != 0)
+    return false;
+  for (auto operand : definingOp->getOperands()) {
+    if (!gatherHoistableOps(operand, insertionPoint, opOrdinals, hoistedOps))
+      return false;
+  }
+  hoistedOps.insert(definingOp);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Arena packing
+//===----------------------------------------------------------------------===//
+
+// Joins |timepoints| into a single timepoint, if more than one is provided.
+static Value joinTimepoints(Location loc, ArrayRef<Value> timepoints,
+                            OpBuilder &builder) {
+  if (timepoints.size() == 1)
+    return timepoints.front();
+  return builder.createOrFold<IREE::Stream::TimepointJoinOp>(
+      loc, builder.getType<IREE::Stream::TimepointType>(), timepoints);
+}
+
+// Returns a timepoint indicating that the memory of |slot| can be reused.
+// The memory is free to reuse once the work the dealloca awaits completes.
+static Value getReleaseTimepoint(TransientSlot &slot, OpBuilder &builder) {
+  if (auto awaitTimepoint = slot.deallocaOp.getAwaitTimepoint())
+    return awaitTimepoint;
+  return builder.create<IREE::Stream::TimepointImmediateOp>(
+      slot.deallocaOp.getLoc());
+}
+
+// Places all |slots| into a single arena allocated ahead of the first slot and
+// released after the last. Slots with disjoint lifetimes share memory and the
+// work using a slot is ordered after the work of all earlier slots it may
+// overlap with.
+static void packSlotsIntoArena(MutableArrayRef<TransientSlot> slots,
+                               IREE::Stream::AffinityAttr affinityAttr) {
+  auto *insertionPoint = slots.front().allocaOp.getOperation();
+  OpBuilder builder(insertionPoint);
+
+  SmallVector<Location> locs;
+  SmallVector<int64_t> lifetimeIntervals;
+  SmallVector<Value> dynamicSliceSizes;
+  for (auto &slot : slots) {
+    locs.push_back(slot.allocaOp.getLoc());
+    lifetimeIntervals.push_back(slot.start);
+    lifetimeIntervals.push_back(slot.end);
+    dynamicSliceSizes.push_back(slot.allocaOp.getStorageSize());
+  }
+
+  // Compute the total arena size and the offset of each slot within it.
+  // LayoutSlices will reuse the ranges of slots with disjoint lifetimes.
+  auto fusedLoc = builder.getFusedLoc(locs);
+  auto indexType = builder.getIndexType();
+  SmallVector<Type> packedOffsetTypes(dynamicSliceSizes.size(), indexType);
+  auto packOp = builder.create<IREE::Stream::ResourcePackOp>(
+      fusedLoc, indexType, packedOffsetTypes,
+      /*offset=*/nullptr, builder.getIndexArrayAttr(lifetimeIntervals),
+      dynamicSliceSizes, affinityAttr);
+
+  // Allocate the arena once for all slots.
+  auto transientType = builder.getType<IREE::Stream::ResourceType>(
+      IREE::Stream::Lifetime::Transient);
+  auto timepointType = builder.getType<IREE::Stream::TimepointType>();
+  auto arenaOp = builder.create<IREE::Stream::ResourceAllocaOp>(
+      fusedLoc, transientType, timepointType, packOp.getTotalLength(),
+      /*await_timepoint=*/Value{}, affinityAttr);
+  auto arena = arenaOp.getResult();
+  auto arenaSize = arenaOp.getStorageSize();
+
+  // Replace each slot alloca with a subview of the arena. The memory is only
+  // available once all prior occupants that may share its range are released.
+  for (size_t i = 0; i < slots.size(); ++i) {
+    auto &slot = slots[i];
+    builder.setInsertionPoint(slot.allocaOp);
+    SmallVector<Value> awaitTimepoints;
+    awaitTimepoints.push_back(arenaOp.getResultTimepoint());
+    if (auto awaitTimepoint = slot.allocaOp.getAwaitTimepoint()) {
+      awaitTimepoints.push_back(awaitTimepoint);
+    }
+    for (auto &priorSlot : slots.take_front(i)) {
+      if (priorSlot.end < slot.start) {
+        awaitTimepoints.push_back(getReleaseTimepoint(priorSlot, builder));
+      }
+    }
+    auto subviewOp = builder.create<IREE::Stream::ResourceSubviewOp>(
+        slot.allocaOp.getLoc(), arena, arenaSize, packOp.getPackedOffsets()[i],
+        slot.allocaOp.getStorageSize());
+    slot.allocaOp.getResult().replaceAllUsesWith(subviewOp.getResult());
+    slot.allocaOp.getResultTimepoint().replaceAllUsesWith(
+        joinTimepoints(slot.allocaOp.getLoc(), awaitTimepoints, builder));
+  }
+
+  // Release the arena in place of the last dealloca and drop the others; their
+  // memory remains reserved in the arena until the end of its lifetime.
+  auto *lastSlot =
+      std::max_element(slots.begin(), slots.end(),
+                       [](auto &lhs, auto &rhs) { return lhs.end < rhs.end; });
+  builder.setInsertionPoint(lastSlot->deallocaOp);
+  SmallVector<Value> releaseTimepoints;
+  for (auto &slot : slots) {
+    releaseTimepoints.push_back(getReleaseTimepoint(slot, builder));
+  }
+  auto arenaDeallocaOp = builder.create<IREE::Stream::ResourceDeallocaOp>(
+      fusedLoc, arena, arenaSize,
+      joinTimepoints(fusedLoc, releaseTimepoints, builder), affinityAttr);
+  for (auto &slot : slots) {
+    if (&slot == lastSlot) {
+      slot.deallocaOp.getResultTimepoint().replaceAllUsesWith(
+          arenaDeallocaOp.getResultTimepoint());
+    } else {
+      builder.setInsertionPoint(slot.deallocaOp);
+      slot.deallocaOp.getResultTimepoint().replaceAllUsesWith(
+          getReleaseTimepoint(slot, builder));
+    }
+  }
+  for (auto &slot : slots) {
+    slot.deallocaOp.erase();
+    slot.allocaOp.erase();
+  }
+}
+
+// Packs all block-local transient allocations in |block| that share an
+// affinity into per-affinity arenas.
+static void packBlockTransients(Block &block) {
+  DenseMap<Operation *, int64_t> opOrdinals;
+  int64_t ordinal = 0;
+  for (auto &op : block) {
+    opOrdinals[&op] = ordinal++;
+  }
+
+  // Bucket candidate slots by affinity in program order.
+  llvm::MapVector<Attribute, SmallVector<TransientSlot>> affinitySlots;
+  for (auto allocaOp : block.getOps<IREE::Stream::ResourceAllocaOp>()) {
+    auto deallocaOp = findBlockLocalDealloca(allocaOp, opOrdinals);
+    if (!deallocaOp)
+      continue;
+    TransientSlot slot;
+    slot.allocaOp = allocaOp;
+    slot.deallocaOp = deallocaOp;
+    slot.start = opOrdinals[allocaOp];
+    slot.end = opOrdinals[deallocaOp];
+    affinitySlots[allocaOp.getAffinityAttr()].push_back(slot);
+  }
+
+  for (auto &[affinityAttr, candidateSlots] : affinitySlots) {
+    if (candidateSlots.size() < 2)
+      continue;
+
+    // The arena is allocated at the first slot and all slot sizes must be
+    // available there.
+    auto *insertionPoint = candidateSlots.front().allocaOp.getOperation();
+    SetVector<Operation *> hoistedOps;
+    SmallVector<TransientSlot> slots;
+    for (auto &slot : candidateSlots) {
+      SetVector<Operation *> slotHoistedOps = hoistedOps;
+      if (!gatherHoistableOps(slot.allocaOp.getStorageSize(), insertionPoint,
+                              opOrdinals, slotHoistedOps)) {
+        LLVM_DEBUG(llvm::dbgs() << "  - size not available at arena: "
+                                << slot.allocaOp << "\n");
+        continue;
+      }
+      hoistedOps = std::move(slotHoistedOps);
+      slots.push_back(slot);
+    }
+    if (slots.size() < 2)
+      continue;
+
+    // Move the size computations above the arena preserving their order.
+    auto sortedOps = hoistedOps.takeVector();
+    llvm::sort(sortedOps, [&](Operation *lhs, Operation *rhs) {
+      return opOrdinals[lhs] < opOrdinals[rhs];
+    });
+    for (auto *op : sortedOps) {
+      op->moveBefore(insertionPoint);
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << "packing " << slots.size()
+                            << " transients into a shared arena\n");
+    packSlotsIntoArena(slots, llvm::dyn_cast_if_present<
+                                  IREE::Stream::AffinityAttr>(affinityAttr));
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-pack-transients
+//===----------------------------------------------------------------------===//
+
+class PackTransientsPass : public PackTransientsBase<PackTransientsPass> {
+public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<mlir::arith::ArithDialect>();
+    registry.insert<IREE::Stream::StreamDialect>();
+    registry.insert<IREE::Util::UtilDialect>();
+  }
+
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (!parentOp || !parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+    SmallVector<Block *> blocks;
+    parentOp.getCallableRegion()->walk(
+        [&](Block *block) { blocks.push_back(block); });
+    for (auto *block : blocks) {
+      packBlockTransients(*block);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackTransientsPass() {
+  return std::make_unique<PackTransientsPass>();
+}
+
+} // namespace Stream
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -157,15 +157,33 @@ void buildStreamAsyncPassPipeline(OpPassManager &passManager,
   // the stream.cmd.* layer.
   passManager.addPass(IREE::Stream::createVerifyAsyncAccessRangesPass());
 
+  // Specialize dynamically shaped dispatches for exact shapes and shape
+  // buckets and select the variant to use on the host. This must happen before
+  // execution regions are formed as the selection is done with structured
+  // control flow around the dispatches.
+  if (!transformOptions.dispatchShapeBuckets.empty() ||
+      !transformOptions.dispatchShapeValues.empty()) {
+    passManager.addPass(IREE::Stream::createSpecializeDispatchShapesPass(
+        llvm::to_vector(transformOptions.dispatchShapeBuckets),
+        llvm::to_vector(transformOptions.dispatchShapeValues)));
+  }
+
   //----------------------------------------------------------------------------
   // Stream formation and scheduling
   //----------------------------------------------------------------------------
 
   FunctionLikeNest(passManager)
       // Combine async work into execution regions.
-      .addPass(IREE::Stream::createScheduleExecutionPass)
+      .addPass([&]() {
+        return IREE::Stream::createScheduleExecutionPass(
+            transformOptions.overlapCollectives,
+            transformOptions.collectiveQueue);
+      })
       // Group concurrently executable work into waves.
-      .addPass(IREE::Stream::createScheduleConcurrencyPass);
+      .addPass([&]() {
+        return IREE::Stream::createScheduleConcurrencyPass(
+            transformOptions.maxTransientMemory);
+      });
 
   // Materialize timepoints across the entire module. This simplifies scheduling
   // of the timeline as we can shake the IR and see what timepoints we still
@@ -197,6 +215,12 @@ void buildStreamCmdPassPipeline(OpPassManager &passManager,
       // streams. Ideally all transient allocs become stream-ordered allocas.
       // createPropagateTransientsPass()
 
+      // Place transients from different execution regions with disjoint
+      // lifetimes into a shared arena. This trades concurrency between the
+      // regions sharing memory for a lower peak transient footprint.
+      .addPredicatedPass(transformOptions.packTransients,
+                         IREE::Stream::createPackTransientsPass)
+
       // Allocate backing storage for fused constant resources.
       // This expands packed constants into explicit forms with partitioned
       // storage buffers and upload logic.
@@ -35,6 +35,57 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
       llvm::cl::init(true),
   };
 
+  ListOption<int64_t> dispatchShapeBuckets{
+      *this,
+      "dispatch-shape-buckets",
+      llvm::cl::desc(
+          "Specializes dynamically shaped dispatches for dynamic dimensions "
+          "that are multiples of each of the given powers of two."),
+  };
+
+  ListOption<int64_t> dispatchShapeValues{
+      *this,
+      "dispatch-shape-values",
+      llvm::cl::desc(
+          "Specializes dynamically shaped dispatches for dynamic dimensions "
+          "equal to each of the given values."),
+  };
+
+  Option<int64_t> maxTransientMemory{
+      *this,
+      "max-transient-memory",
+      llvm::cl::desc(
+          "Limits the bytes of transient memory concurrently executing work "
+          "may allocate by serializing work that exceeds it; 0 for no limit."),
+      llvm::cl::init(0),
+  };
+
+  Option<bool> overlapCollectives{
+      *this,
+      "overlap-collectives",
+      llvm::cl::desc(
+          "Schedules collectives in their own execution regions so that they "
+          "overlap with independent compute instead of serializing with it."),
+      llvm::cl::init(false),
+  };
+  Option<int64_t> collectiveQueue{
+      *this,
+      "collective-queue",
+      llvm::cl::desc("Device queue ordinal overlapped collectives execute on "
+                     "so that they run concurrently with compute; -1 to use "
+                     "the same queues as the surrounding work."),
+      llvm::cl::init(-1),
+  };
+
+  Option<bool> packTransients{
+      *this,
+      "pack-transients",
+      llvm::cl::desc(
+          "Packs transient allocations with disjoint lifetimes across "
+          "execution regions into a single arena per invocation."),
+      llvm::cl::init(false),
+  };
+
   Option<DumpOutputFormat> dumpStatisticsFormat{
       *this,
       "dump-statistics-format",
@@ -114,9 +165,10 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createRefineUsagePass();
 //===----------------------------------------------------------------------===//
 
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleExecutionPass();
+createScheduleExecutionPass(bool overlapCollectives = false,
+                            int64_t collectiveQueue = -1);
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleConcurrencyPass();
+createScheduleConcurrencyPass(int64_t maxTransientMemory = 0);
 
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createPropagateTimepointsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createElideTimepointsPass();
@@ -128,6 +180,7 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createElideTimepointsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createScheduleAllocationPass();
 
 std::unique_ptr<InterfacePass<CallableOpInterface>> createPackConstantsPass();
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackTransientsPass();
 std::unique_ptr<InterfacePass<CallableOpInterface>> createLayoutSlicesPass();
 
 //===----------------------------------------------------------------------===//
@@ -145,6 +198,9 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createFoldUniformOperandsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createFuseDispatchBindingsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createSpecializeDispatchesPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSpecializeDispatchShapesPass(ArrayRef<int64_t> bucketSizes = {},
+                                   ArrayRef<int64_t> values = {});
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createAnnotateDispatchArgumentsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createPackDispatchOperandsPass();
 
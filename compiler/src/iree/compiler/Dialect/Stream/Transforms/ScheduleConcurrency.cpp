@@ -174,9 +174,106 @@ struct WavePartitionBuilder {
   IRMapping mapping;
 };
 
+//===----------------------------------------------------------------------===//
+// Memory-bounded waves
+//===----------------------------------------------------------------------===//
+
+// Returns the number of bytes of new storage |op| requires for its results.
+// Results tied to operands reuse the operand storage and results with dynamic
+// sizes cannot be estimated; both are counted as zero.
+static int64_t estimateResultStorageSize(Operation *op) {
+  auto sizeAwareOp = dyn_cast<IREE::Util::SizeAwareOpInterface>(op);
+  if (!sizeAwareOp)
+    return 0;
+  auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(op);
+  int64_t totalSize = 0;
+  for (auto result : op->getResults()) {
+    if (!llvm::isa<IREE::Stream::ResourceType>(result.getType()))
+      continue;
+    if (tiedOp && tiedOp.getTiedResultOperandIndex(result.getResultNumber()))
+      continue;
+    APInt resultSize;
+    auto resultSizeValue = sizeAwareOp.getResultSize(result.getResultNumber());
+    if (resultSizeValue &&
+        matchPattern(resultSizeValue, m_ConstantInt(&resultSize))) {
+      totalSize += resultSize.getSExtValue();
+    }
+  }
+  return totalSize;
+}
+
+// Builds a wave from |ops|, declaring the values crossing its boundary.
+static Partition buildWave(IREE::Stream::AffinityAttr affinity,
+                           ArrayRef<Operation *> ops) {
+  Partition wave;
+  wave.affinity = affinity;
+  wave.ops.insert(ops.begin(), ops.end());
+  SetVector<Value> producedValues;
+  for (auto *op : ops) {
+    for (auto operand : op->getOperands()) {
+      wave.ins.insert(operand);
+    }
+    for (auto result : op->getResults()) {
+      producedValues.insert(result);
+      for (auto *user : result.getUsers()) {
+        if (!wave.ops.contains(user)) {
+          wave.outs.insert(result);
+          break;
+        }
+      }
+    }
+  }
+  wave.ins.set_subtract(producedValues);
+  return wave;
+}
+
+// Splits waves whose ops together allocate more than |maxTransientMemory|
+// bytes into multiple waves executed one after another. Ops within a wave have
+// no hazards with each other so any split preserves correctness; the split
+// only trades away concurrency to lower the peak amount of live memory.
+static void splitWavesByMemoryBudget(PartitionSet &waveSet,
+                                     int64_t maxTransientMemory) {
+  SmallVector<Partition> newPartitions;
+  for (auto &wave : waveSet.partitions) {
+    auto ops = llvm::to_vector(wave.ops);
+    llvm::sort(ops, [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+
+    SmallVector<SmallVector<Operation *>> opGroups;
+    int64_t groupSize = 0;
+    for (auto *op : ops) {
+      int64_t opSize = estimateResultStorageSize(op);
+      if (opGroups.empty() || groupSize + opSize > maxTransientMemory) {
+        opGroups.emplace_back();
+        groupSize = 0;
+      }
+      opGroups.back().push_back(op);
+      groupSize += opSize;
+    }
+    if (opGroups.size() <= 1) {
+      newPartitions.push_back(std::move(wave));
+      continue;
+    }
+    LLVM_DEBUG(llvm::dbgs() << "splitting wave of " << ops.size()
+                            << " ops into " << opGroups.size()
+                            << " waves to fit within " << maxTransientMemory
+                            << " bytes\n");
+    for (auto &opGroup : opGroups) {
+      newPartitions.push_back(buildWave(wave.affinity, opGroup));
+    }
+  }
+  waveSet.partitions = std::move(newPartitions);
+}
+
 class ScheduleConcurrencyPass
     : public ScheduleConcurrencyBase<ScheduleConcurrencyPass> {
 public:
+  ScheduleConcurrencyPass() = default;
+  ScheduleConcurrencyPass(int64_t maxTransientMemory) {
+    this->maxTransientMemory = maxTransientMemory;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<IREE::Stream::StreamDialect>();
     registry.insert<IREE::Util::UtilDialect>();
@@ -209,6 +306,9 @@ public:
     auto waveSet = partitionRegionConcurrency(configAttr, block);
     if (waveSet.empty())
       return success();
+    if (maxTransientMemory > 0) {
+      splitWavesByMemoryBudget(waveSet, maxTransientMemory);
+    }
     if (failed(waveSet.verify(parentOp.getLoc())))
       return failure();
 
@@ -275,8 +375,8 @@ public:
 } // namespace
 
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleConcurrencyPass() {
-  return std::make_unique<ScheduleConcurrencyPass>();
+createScheduleConcurrencyPass(int64_t maxTransientMemory) {
+  return std::make_unique<ScheduleConcurrencyPass>(maxTransientMemory);
 }
 
 } // namespace Stream
@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -219,11 +221,13 @@ static SmallVector<Block *, 8> sortBlocksInDominanceOrder(Region &region) {
 }
 
 LogicalResult processRegion(Location loc, MLIRContext *context, Region &region,
-                            const PartitioningConfigAttr &configAttr) {
+                            const PartitioningConfigAttr &configAttr,
+                            bool overlapCollectives) {
   for (auto *block : sortBlocksInDominanceOrder(region)) {
     // Compute a set of partitions covering all of the streamable ops in the
     // block.
-    auto partitionSet = partitionStreamableOps(configAttr, block);
+    auto partitionSet =
+        partitionStreamableOps(configAttr, block, overlapCollectives);
     if (partitionSet.empty())
       continue;
     if (failed(partitionSet.verify(loc))) {
@@ -302,7 +306,8 @@ LogicalResult processRegion(Location loc, MLIRContext *context, Region &region,
     for (auto &op : *block) {
       if (isa<scf::SCFDialect>(op.getDialect())) {
         for (auto &subregion : op.getRegions()) {
-          if (failed(processRegion(loc, context, subregion, configAttr)))
+          if (failed(processRegion(loc, context, subregion, configAttr,
+                                   overlapCollectives)))
             return failure();
         }
       }
@@ -315,7 +320,14 @@ LogicalResult processRegion(Location loc, MLIRContext *context, Region &region,
 class ScheduleExecutionPass
     : public ScheduleExecutionBase<ScheduleExecutionPass> {
 public:
+  ScheduleExecutionPass() = default;
+  ScheduleExecutionPass(bool overlapCollectives, int64_t collectiveQueue) {
+    this->overlapCollectives = overlapCollectives;
+    this->collectiveQueue = collectiveQueue;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect>();
     registry.insert<IREE::Stream::StreamDialect>();
     registry.insert<IREE::Util::UtilDialect>();
   }
@@ -331,13 +343,30 @@ public:
     // Lookup the optional config used to control partitioning.
     auto configAttr = IREE::Stream::PartitioningConfigAttr::lookup(parentOp);
 
+    // Move collectives without an explicit affinity onto their own queue so
+    // that once partitioned they execute concurrently with compute.
+    if (overlapCollectives && collectiveQueue >= 0) {
+      if (collectiveQueue >= 64) {
+        parentOp.emitError() << "collective queue " << collectiveQueue
+                             << " out of range of the queue affinity mask";
+        return signalPassFailure();
+      }
+      auto queueAttr =
+          IREE::HAL::AffinityQueueAttr::get(context, 1ll << collectiveQueue);
+      parentOp.walk([&](IREE::Stream::AsyncCollectiveOp collectiveOp) {
+        if (!collectiveOp.getAffinityAttr())
+          collectiveOp.setAffinityAttr(queueAttr);
+      });
+    }
+
     // Partition each block on its own. We could try to partition with the CFG
     // however that's much more complex - it's easier to handle partitioning
     // structured control flow (scf) ops. Note that we do this in dominance
     // order so that we are sure if we replace values that dominate other blocks
     // they see the correct values.
     auto &region = *parentOp.getCallableRegion();
-    if (failed(processRegion(parentOp.getLoc(), context, region, configAttr)))
+    if (failed(processRegion(parentOp.getLoc(), context, region, configAttr,
+                             overlapCollectives)))
       return signalPassFailure();
 
     // Cleanup the dead ops.
@@ -359,8 +388,9 @@ public:
 } // namespace
 
 std::unique_ptr<InterfacePass<CallableOpInterface>>
-createScheduleExecutionPass() {
-  return std::make_unique<ScheduleExecutionPass>();
+createScheduleExecutionPass(bool overlapCollectives, int64_t collectiveQueue) {
+  return std::make_unique<ScheduleExecutionPass>(overlapCollectives,
+                                                 collectiveQueue);
 }
 
 } // namespace Stream
@@ -0,0 +1,384 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <memory>
+#include <utility>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-specialize-dispatch-shapes"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Executable variants
+//===----------------------------------------------------------------------===//
+
+// Returns a bit per argument of |funcOp| indicating whether the argument is
+// used as a dynamic dimension of one of the bindings.
+static llvm::BitVector findDynamicDimArgs(mlir::func::FuncOp funcOp) {
+  llvm::BitVector dimArgs(funcOp.getNumArguments());
+  auto markArg = [&](Value value) {
+    // Dimensions captured as workloads are wrapped in ordinal annotations.
+    if (auto ordinalOp =
+            value.getDefiningOp<IREE::Flow::DispatchWorkloadOrdinalOp>()) {
+      value = ordinalOp.getOperand();
+    }
+    auto arg = llvm::dyn_cast<BlockArgument>(value);
+    if (arg && arg.getOwner() == &funcOp.front()) {
+      dimArgs.set(arg.getArgNumber());
+    }
+  };
+  funcOp.walk([&](IREE::Stream::BindingSubspanOp subspanOp) {
+    for (auto dim : subspanOp.getDynamicDims())
+      markArg(dim);
+  });
+  return dimArgs;
+}
+
+// Clones |exportOp| and its function into a new export with |suffix| that is
+// only ever dispatched with dynamic dimensions matching the variant.
+//
+// The body is not modified: for buckets the dispatch sites pass the dimensions
+// through a util.align so that the argument alignment gets derived and
+// attached to the function arguments by the argument annotation pass like any
+// other alignment. For exact values the dispatch sites pass constants that
+// dispatch specialization later inlines into the function.
+static IREE::Stream::ExecutableExportOp
+cloneExportForVariant(IREE::Stream::ExecutableOp executableOp,
+                      IREE::Stream::ExecutableExportOp exportOp,
+                      StringRef suffix) {
+  auto funcOp = exportOp.lookupFunctionRef();
+  auto innerModuleOp = funcOp->getParentOfType<mlir::ModuleOp>();
+
+  auto clonedFuncOp = funcOp.clone();
+  clonedFuncOp.setName((funcOp.getName() + suffix).str());
+  auto funcName = SymbolTable(innerModuleOp)
+                      .insert(clonedFuncOp, ++Block::iterator(funcOp));
+
+  auto clonedExportOp = exportOp.clone();
+  clonedExportOp.setSymName((exportOp.getSymName() + suffix).str());
+  clonedExportOp.setFunctionRefAttr(FlatSymbolRefAttr::get(funcName));
+  SymbolTable(executableOp)
+      .insert(clonedExportOp, ++Block::iterator(exportOp));
+  return clonedExportOp;
+}
+
+//===----------------------------------------------------------------------===//
+// Dispatch site specialization
+//===----------------------------------------------------------------------===//
+
+struct ExportVariant {
+  // Whether all dynamic dimensions equal |size| or are multiples of it.
+  enum class Kind {
+    Value,
+    Bucket,
+  } kind;
+  int64_t size;
+  // Entry point of the export specialized for the variant.
+  SymbolRefAttr entryPoint;
+};
+
+struct ExportVariants {
+  // Dispatch operand index -> whether the operand is a dynamic dimension.
+  // Indices are into the primitive (non-resource) operands of the dispatch.
+  llvm::BitVector dimOperands;
+  // Variants in the order they are checked: exact values followed by buckets
+  // from the largest to the smallest.
+  SmallVector<ExportVariant> variants;
+};
+
+// Returns the dynamic dimension values passed to |dispatchOp|, excluding
+// those that are constant as there is nothing to specialize for them.
+static SetVector<Value>
+getDynamicDimOperands(IREE::Stream::AsyncDispatchOp dispatchOp,
+                      const llvm::BitVector &dimOperands) {
+  SetVector<Value> dims;
+  unsigned operandIdx = 0;
+  for (auto operand : dispatchOp.getResourceOperands()) {
+    if (llvm::isa<IREE::Stream::ResourceType>(operand.getType()))
+      continue;
+    if (dimOperands.test(operandIdx++) && !matchPattern(operand, m_Constant()))
+      dims.insert(operand);
+  }
+  return dims;
+}
+
+// Builds `(dim0 % bucketSize == 0) && (dim1 % bucketSize == 0) && ...`.
+static Value buildDivisibilityCondition(Location loc, ArrayRef<Value> dims,
+                                        int64_t bucketSize,
+                                        OpBuilder &builder) {
+  Value bucketSizeValue =
+      builder.create<arith::ConstantIndexOp>(loc, bucketSize);
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value cond;
+  for (auto dim : dims) {
+    Value rem = builder.create<arith::RemUIOp>(loc, dim, bucketSizeValue);
+    Value cmp = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                              rem, zero);
+    cond = cond ? builder.create<arith::AndIOp>(loc, cond, cmp) : cmp;
+  }
+  return cond;
+}
+
+// Builds `(dim0 == value) && (dim1 == value) && ...`.
+static Value buildEqualityCondition(Location loc, ArrayRef<Value> dims,
+                                    int64_t value, OpBuilder &builder) {
+  Value constantValue = builder.create<arith::ConstantIndexOp>(loc, value);
+  Value cond;
+  for (auto dim : dims) {
+    Value cmp = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                              dim, constantValue);
+    cond = cond ? builder.create<arith::AndIOp>(loc, cond, cmp) : cmp;
+  }
+  return cond;
+}
+
+// Replaces |dispatchOp| with a chain of host-side checks selecting the export
+// specialized for the exact values of the dynamic dimensions or otherwise the
+// largest bucket they are all a multiple of, falling back to the original
+// fully dynamic export:
+//
+//   %0 = scf.if %all_dims_equal_to_1 {
+//     stream.async.dispatch @ex::@dispatch_eq1(%c1 ...)
+//   } else {
+//     scf.if %all_dims_divisible_by_128 {
+//       stream.async.dispatch @ex::@dispatch_div128(util.align %dim, 128 ...)
+//     } else {
+//       ...
+//         stream.async.dispatch @ex::@dispatch(%dim ...)
+//     }
+//   }
+static void specializeDispatchSite(IREE::Stream::AsyncDispatchOp dispatchOp,
+                                   const ExportVariants &exportVariants) {
+  auto dims = getDynamicDimOperands(dispatchOp, exportVariants.dimOperands);
+  if (dims.empty())
+    return;
+
+  auto loc = dispatchOp.getLoc();
+  auto resultTypes = dispatchOp->getResultTypes();
+  OpBuilder builder(dispatchOp);
+  scf::IfOp rootIfOp;
+  for (auto &variant : exportVariants.variants) {
+    Value cond =
+        variant.kind == ExportVariant::Kind::Value
+            ? buildEqualityCondition(loc, dims.getArrayRef(), variant.size,
+                                     builder)
+            : buildDivisibilityCondition(loc, dims.getArrayRef(), variant.size,
+                                         builder);
+    auto ifOp = builder.create<scf::IfOp>(loc, resultTypes, cond,
+                                          /*withElseRegion=*/true);
+    if (!rootIfOp) {
+      rootIfOp = ifOp;
+    } else {
+      builder.create<scf::YieldOp>(loc, ifOp.getResults());
+    }
+
+    // Dispatch the specialized export with dimensions that are known constant
+    // or aligned. The util.align are no-ops at runtime as the condition
+    // guarantees the dimensions are already multiples of the bucket size.
+    builder.setInsertionPointToStart(ifOp.thenBlock());
+    IRMapping mapping;
+    if (variant.kind == ExportVariant::Kind::Value) {
+      Value constantValue =
+          builder.create<arith::ConstantIndexOp>(loc, variant.size);
+      for (auto dim : dims)
+        mapping.map(dim, constantValue);
+    } else {
+      for (auto dim : dims) {
+        mapping.map(dim, builder.create<IREE::Util::AlignOp>(loc, dim,
+                                                             variant.size));
+      }
+    }
+    auto specializedOp = cast<IREE::Stream::AsyncDispatchOp>(
+        builder.clone(*dispatchOp.getOperation(), mapping));
+    specializedOp.setEntryPointsAttr(
+        builder.getArrayAttr({variant.entryPoint}));
+    builder.create<scf::YieldOp>(loc, specializedOp.getResults());
+
+    builder.setInsertionPointToStart(ifOp.elseBlock());
+  }
+
+  // The original dispatch becomes the fallback in the innermost else.
+  dispatchOp->replaceAllUsesWith(rootIfOp.getResults());
+  dispatchOp->moveBefore(builder.getInsertionBlock(),
+                         builder.getInsertionPoint());
+  builder.setInsertionPointAfter(dispatchOp);
+  builder.create<scf::YieldOp>(loc, dispatchOp.getResults());
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-specialize-dispatch-shapes
+//===----------------------------------------------------------------------===//
+
+class SpecializeDispatchShapesPass
+    : public SpecializeDispatchShapesBase<SpecializeDispatchShapesPass> {
+public:
+  SpecializeDispatchShapesPass() = default;
+  SpecializeDispatchShapesPass(ArrayRef<int64_t> bucketSizes,
+                               ArrayRef<int64_t> values) {
+    this->bucketSizes = bucketSizes;
+    this->values = values;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<mlir::arith::ArithDialect>();
+    registry.insert<mlir::scf::SCFDialect>();
+    registry.insert<IREE::Stream::StreamDialect>();
+    registry.insert<IREE::Util::UtilDialect>();
+  }
+
+  void runOnOperation() override {
+    if (bucketSizes.empty() && values.empty())
+      return;
+    auto moduleOp = getOperation();
+
+    // Largest buckets are checked first so that dispatches get the most
+    // specialized variant they can use.
+    SmallVector<int64_t> sortedBucketSizes(bucketSizes.begin(),
+                                           bucketSizes.end());
+    for (auto bucketSize : sortedBucketSizes) {
+      if (bucketSize <= 1 || !llvm::isPowerOf2_64(bucketSize)) {
+        moduleOp.emitError() << "shape bucket sizes must be powers of two "
+                                "greater than 1; got "
+                             << bucketSize;
+        return signalPassFailure();
+      }
+    }
+    llvm::sort(sortedBucketSizes, std::greater<int64_t>());
+    sortedBucketSizes.erase(std::unique(sortedBucketSizes.begin(),
+                                        sortedBucketSizes.end()),
+                            sortedBucketSizes.end());
+    SmallVector<int64_t> sortedValues(values.begin(), values.end());
+    for (auto value : sortedValues) {
+      if (value < 0) {
+        moduleOp.emitError()
+            << "shape values must be non-negative; got " << value;
+        return signalPassFailure();
+      }
+    }
+    llvm::sort(sortedValues);
+    sortedValues.erase(std::unique(sortedValues.begin(), sortedValues.end()),
+                       sortedValues.end());
+
+    // Gather the dispatch sites of each export before creating any variant.
+    // Only dispatches with a single entry point that are not yet part of an
+    // execution region can be wrapped in host control flow.
+    SymbolTable symbolTable(moduleOp);
+    llvm::MapVector<Operation *, SmallVector<IREE::Stream::AsyncDispatchOp>>
+        exportDispatchMap;
+    for (auto callableOp : moduleOp.getOps<CallableOpInterface>()) {
+      callableOp->walk([&](IREE::Stream::AsyncDispatchOp dispatchOp) {
+        if (dispatchOp->getParentOfType<IREE::Stream::AsyncExecuteOp>())
+          return;
+        auto entryPointRefs = dispatchOp.getEntryPointRefs();
+        if (llvm::range_size(entryPointRefs) != 1)
+          return;
+        auto *exportOp = symbolTable.lookupNearestSymbolFrom(
+            dispatchOp, *entryPointRefs.begin());
+        exportDispatchMap[exportOp].push_back(dispatchOp);
+      });
+    }
+
+    for (auto &[op, dispatchOps] : exportDispatchMap) {
+      auto exportOp = dyn_cast_or_null<IREE::Stream::ExecutableExportOp>(op);
+      if (!exportOp)
+        continue;
+      auto funcOp = exportOp.lookupFunctionRef();
+      if (!funcOp)
+        continue;
+
+      // Map the dynamic dimension arguments back to dispatch operands.
+      auto dimArgs = findDynamicDimArgs(funcOp);
+      if (dimArgs.none())
+        continue;
+      auto operandToArgMap =
+          IREE::Stream::CmdDispatchOp::makeOperandToArgMap(funcOp);
+      ExportVariants exportVariants;
+      exportVariants.dimOperands.resize(operandToArgMap.size());
+      for (auto [operandIdx, argIdx] : llvm::enumerate(operandToArgMap)) {
+        if (dimArgs.test(argIdx))
+          exportVariants.dimOperands.set(operandIdx);
+      }
+
+      if (llvm::none_of(dispatchOps, [&](auto dispatchOp) {
+            return !getDynamicDimOperands(dispatchOp,
+                                          exportVariants.dimOperands)
+                        .empty();
+          })) {
+        continue;
+      }
+
+      auto executableOp =
+          exportOp->getParentOfType<IREE::Stream::ExecutableOp>();
+      // Variants are inserted right after the original export so we create
+      // them in the reverse of the order they are checked to keep them sorted
+      // in the IR.
+      auto addVariant = [&](ExportVariant::Kind kind, int64_t size,
+                            StringRef prefix) {
+        auto variantOp = cloneExportForVariant(
+            executableOp, exportOp, (prefix + std::to_string(size)).str());
+        exportVariants.variants.push_back(
+            {kind, size,
+             SymbolRefAttr::get(executableOp.getSymNameAttr(),
+                                {FlatSymbolRefAttr::get(variantOp)})});
+      };
+      for (auto bucketSize : llvm::reverse(sortedBucketSizes)) {
+        addVariant(ExportVariant::Kind::Bucket, bucketSize, "_div");
+      }
+      for (auto value : llvm::reverse(sortedValues)) {
+        addVariant(ExportVariant::Kind::Value, value, "_eq");
+      }
+      std::reverse(exportVariants.variants.begin(),
+                   exportVariants.variants.end());
+      LLVM_DEBUG(llvm::dbgs()
+                 << "specializing @" << executableOp.getSymName() << "::@"
+                 << exportOp.getSymName() << " for " << sortedValues.size()
+                 << " shape values and " << sortedBucketSizes.size()
+                 << " shape buckets at " << dispatchOps.size()
+                 << " dispatch sites\n");
+
+      for (auto dispatchOp : dispatchOps) {
+        specializeDispatchSite(dispatchOp, exportVariants);
+      }
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSpecializeDispatchShapesPass(ArrayRef<int64_t> bucketSizes,
+                                   ArrayRef<int64_t> values) {
+  return std::make_unique<SpecializeDispatchShapesPass>(bucketSizes, values);
+}
+
+} // namespace Stream
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
@@ -6,19 +6,27 @@
 // CHECK-PRETTY:   Variables: 0, (TBD)
 // CHECK-PRETTY:  D->H Syncs: 2
 // CHECK-PRETTY: Submissions: 2, using cumulative 0 B
+// CHECK-PRETTY: Peak Memory: predicted 0 B
+// CHECK-PRETTY:   Crit Path: 4 of 4 commands
 // CHECK-PRETTY:   DMA Fills: 0
 // CHECK-PRETTY:  DMA Copies: 1
 // CHECK-PRETTY: Collectives: 0
 // CHECK-PRETTY:  Dispatches: 3
 // CHECK-PRETTY: Executables: 2, 33% reuse
+// CHECK-PRETTY: stream.executable.export @func_a_ex_0::@dispatch_0
+// CHECK-PRETTY: Estimated Cost: >=0 FLOP, >=48 B, 0.00 FLOP/B
 
 // CHECK-CSV: ; Aggregate Statistics
-// CHECK-CSV: "Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables"
-// CHECK-CSV: 1,192,0,0,2,2,0,0,1,3,0,2
+// CHECK-CSV: "Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Peak Transient Size","Fills","Copies","Dispatches","Async Calls","Critical Path","Executables"
+// CHECK-CSV: 1,192,0,0,2,2,0,0,0,1,3,0,4,2
 // CHECK-CSV: ; Execution
 // CHECK-CSV: "Depth","Command","Symbol","Length","Invocations","Workload","Operands","Resources"
 // CHECK-CSV: 0,"copy",,16,,,,
 // CHECK-CSV: 0,"dispatch","@func_a_ex_0::@dispatch_0",,4,"4;1;1",0,3
+// CHECK-CSV: ; Executables
+// CHECK-CSV: "Symbol","FLOPs","Bytes","Complete"
+// CHECK-CSV: "@func_a_ex_0::@dispatch_0",0,48,0
+// CHECK-CSV: "@func_a_ex_1::@dispatch_1",0,36,0
 
 util.global private mutable @_constant__timepoint = #stream.timepoint<immediate>
 util.global private @_constant : !stream.resource<constant>
@@ -146,3 +154,33 @@ func.func public @func_a() -> (tensor<4xi32>, tensor<4xi32>) {
   %7 = stream.tensor.export %6 : tensor<4xi32> in !stream.resource<external>{%c16} -> tensor<4xi32>
   return %5, %7 : tensor<4xi32>, tensor<4xi32>
 }
+
+// -----
+
+// Statically-shaped dispatches get complete cost estimates: 2*M*N*K for the
+// matmul and nothing for the fill with each binding accessed once.
+
+// CHECK-PRETTY: stream.executable.export @matmul_ex::@matmul
+// CHECK-PRETTY: Estimated Cost: 65536 FLOP, 12288 B, 5.33 FLOP/B
+
+// CHECK-CSV: "@matmul_ex::@matmul",65536,12288,1
+
+stream.executable private @matmul_ex {
+  stream.executable.export public @matmul
+  builtin.module {
+    func.func @matmul(%arg0: !stream.binding, %arg1: !stream.binding, %arg2: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      %cst = arith.constant 0.000000e+00 : f32
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<32x32xf32>>
+      %1 = stream.binding.subspan %arg1[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<32x32xf32>>
+      %2 = stream.binding.subspan %arg2[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:tensor<32x32xf32>>
+      %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [32, 32], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<32x32xf32>> -> tensor<32x32xf32>
+      %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [32, 32], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<32x32xf32>> -> tensor<32x32xf32>
+      %5 = tensor.empty() : tensor<32x32xf32>
+      %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<32x32xf32>) -> tensor<32x32xf32>
+      %7 = linalg.matmul ins(%3, %4 : tensor<32x32xf32>, tensor<32x32xf32>) outs(%6 : tensor<32x32xf32>) -> tensor<32x32xf32>
+      flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [32, 32], strides = [1, 1] : tensor<32x32xf32> -> !flow.dispatch.tensor<writeonly:tensor<32x32xf32>>
+      return
+    }
+  }
+}
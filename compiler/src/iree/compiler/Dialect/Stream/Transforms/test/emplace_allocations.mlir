@@ -216,3 +216,55 @@ func.func @emplaceDependentDispatchSequence(
   // CHECK-NEXT: return %[[TARGET1]]
   return %target1 : !stream.resource<*>
 }
+
+// -----
+
+// Tests that a dispatch result that is also read by another dispatch (such as
+// a skip connection feeding a concat) gets placed and the reader is redirected
+// to the placed subrange as no later update overwrites it.
+
+// CHECK-LABEL: @emplaceDispatchWithReader
+func.func @emplaceDispatchWithReader(
+    // CHECK-SAME: %[[INPUT:arg[0-9]+]]: !stream.resource<*>, %[[INPUT_SIZE:arg[0-9]+]]: index
+    %input: !stream.resource<*>, %input_size: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c128 = arith.constant 128 : index
+  // CHECK: %[[TARGET:.+]] = stream.async.alloca
+  // CHECK: %[[TARGET0:.+]] = stream.async.dispatch @ex::@dispatch0({{.+}}, %[[TARGET]][%c0 to %c64 for %c64]) : ({{.+}}) -> %[[TARGET]]{%c128}
+  %skip = stream.async.dispatch @ex::@dispatch0(%input[%c0 to %input_size for %input_size]) : (!stream.resource<*>{%input_size}) -> !stream.resource<*>{%c64}
+  // CHECK: %[[TARGET1:.+]] = stream.async.dispatch @ex::@dispatch1(%[[TARGET0]][%{{.+}} to %{{.+}} for %c64], %[[TARGET0]][%c64 to %c128 for %c64]) :
+  // CHECK-SAME: (!stream.resource<*>{%c128}, !stream.resource<*>{%c128}) -> %[[TARGET0]]{%c128}
+  %update = stream.async.dispatch @ex::@dispatch1(%skip[%c0 to %c64 for %c64]) : (!stream.resource<*>{%c64}) -> !stream.resource<*>{%c64}
+  // CHECK-NOT: stream.async.alloca
+  %target = stream.async.alloca : !stream.resource<*>{%c128}
+  // CHECK-NOT: stream.async.update
+  %target0 = stream.async.update %skip, %target[%c0 to %c64] : !stream.resource<*>{%c64} -> %target as !stream.resource<*>{%c128}
+  // CHECK-NOT: stream.async.update
+  %target1 = stream.async.update %update, %target0[%c64 to %c128] : !stream.resource<*>{%c64} -> %target0 as !stream.resource<*>{%c128}
+  // CHECK: return %[[TARGET1]]
+  return %target1 : !stream.resource<*>
+}
+
+// -----
+
+// Tests that a dispatch result read by another dispatch is not placed if a
+// later update overwrites the placed subrange.
+
+// CHECK-LABEL: @dontEmplaceDispatchWithOverwrittenReader
+func.func @dontEmplaceDispatchWithOverwrittenReader(
+    %input: !stream.resource<*>, %input_size: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c128 = arith.constant 128 : index
+  // CHECK: %[[SKIP:.+]] = stream.async.dispatch @ex::@dispatch0
+  // CHECK-SAME: -> !stream.resource<*>{%c64}
+  %skip = stream.async.dispatch @ex::@dispatch0(%input[%c0 to %input_size for %input_size]) : (!stream.resource<*>{%input_size}) -> !stream.resource<*>{%c64}
+  // CHECK: stream.async.update %[[SKIP]]
+  // CHECK: stream.async.dispatch @ex::@dispatch1(%[[SKIP]][%c0 to %c64 for %c64]
+  %update = stream.async.dispatch @ex::@dispatch1(%skip[%c0 to %c64 for %c64]) : (!stream.resource<*>{%c64}) -> !stream.resource<*>{%c128}
+  %target = stream.async.alloca : !stream.resource<*>{%c128}
+  %target0 = stream.async.update %skip, %target[%c0 to %c64] : !stream.resource<*>{%c64} -> %target as !stream.resource<*>{%c128}
+  %target1 = stream.async.update %update, %target0[%c0 to %c128] : !stream.resource<*>{%c128} -> %target0 as !stream.resource<*>{%c128}
+  return %target1 : !stream.resource<*>
+}
@@ -0,0 +1,81 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-stream-fuse-dispatch-bindings)' %s | FileCheck %s
+
+// Tests that dispatch sites aliasing different bindings are split onto their
+// own entry points so that each can fuse the bindings it aliases and that
+// ranges at a uniform distance from each other share one offset operand.
+
+#aggressiveConfig = #stream.resource_config<{
+  alias_mutable_bindings = true,
+  aggressive_binding_fusion = true
+}>
+
+// CHECK-LABEL: @divergentBindingsEx
+stream.executable private @divergentBindingsEx {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK: stream.executable.export public @dispatch_fused_0
+  stream.executable.export public @dispatch attributes {stream.resources = #aggressiveConfig}
+  builtin.module  {
+    func.func @dispatch(%binding_a: !stream.binding, %binding_b: !stream.binding, %operand: index) {
+      %c0 = arith.constant 0 : index
+      %c20 = arith.constant 20 : index
+      %subspan_a = stream.binding.subspan %binding_a[%c0] : !stream.binding -> !flow.dispatch.tensor<readwrite:tensor<20xi8>>{%c20}
+      util.optimization_barrier %subspan_a : !flow.dispatch.tensor<readwrite:tensor<20xi8>>
+      %subspan_b = stream.binding.subspan %binding_b[%c20] : !stream.binding -> !flow.dispatch.tensor<readwrite:tensor<20xi8>>{%c20}
+      util.optimization_barrier %subspan_b : !flow.dispatch.tensor<readwrite:tensor<20xi8>>
+      util.optimization_barrier %operand : index
+      return
+    }
+  }
+}
+
+// The base entry point passes only the offset of the first range.
+// CHECK: func.func @dispatch(%[[BINDING:.+]]: !stream.binding, %[[OFFSET:.+]]: index, %[[OPERAND:.+]]: index)
+// CHECK: %[[SUBSPAN_A:.+]] = stream.binding.subspan %[[BINDING]][%[[OFFSET]]]
+// CHECK-NEXT: util.optimization_barrier %[[SUBSPAN_A]]
+// CHECK: %[[C100:.+]] = arith.constant 100 : index
+// CHECK-NEXT: %[[REBASED_B:.+]] = arith.addi %[[OFFSET]], %[[C100]]
+// CHECK-NEXT: %[[SUM_OFFSET_B:.+]] = arith.addi %c20, %[[REBASED_B]]
+// CHECK-NEXT: %[[SUBSPAN_B:.+]] = stream.binding.subspan %[[BINDING]][%[[SUM_OFFSET_B]]]
+
+// The specialized entry point keeps distinct bindings.
+// CHECK: func.func @dispatch_fused_0(%[[BINDING_A:.+]]: !stream.binding, %[[BINDING_B:.+]]: !stream.binding,
+// CHECK-SAME:                        %[[OFFSET_A:.+]]: index, %[[OFFSET_B:.+]]: index, %{{.+}}: index)
+// CHECK: stream.binding.subspan %[[BINDING_A]][%[[OFFSET_A]]]
+// CHECK: %[[SUM_OFFSET_B:.+]] = arith.addi %c20, %[[OFFSET_B]]
+// CHECK-NEXT: stream.binding.subspan %[[BINDING_B]][%[[SUM_OFFSET_B]]]
+
+// CHECK: func.func @divergentBindings(%[[OPERAND:.+]]: index)
+func.func @divergentBindings(%operand: index) {
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  %c40 = arith.constant 40 : index
+  %c80 = arith.constant 80 : index
+  %c120 = arith.constant 120 : index
+  %c200 = arith.constant 200 : index
+  // CHECK: %[[ALLOC0:.+]] = stream.resource.alloc
+  %alloc0 = stream.resource.alloc uninitialized : !stream.resource<transient>{%c200}
+  // CHECK-NEXT: %[[ALLOC1:.+]] = stream.resource.alloc
+  %alloc1 = stream.resource.alloc uninitialized : !stream.resource<transient>{%c200}
+  // CHECK: stream.cmd.execute
+  %result_timepoint = stream.cmd.execute
+      // CHECK-SAME: with(%[[ALLOC0]] as %[[CAPTURE0:.+]]: !stream.resource<transient>{%c200},
+      // CHECK-SAME:      %[[ALLOC1]] as %[[CAPTURE1:.+]]: !stream.resource<transient>{%c200})
+      with(%alloc0 as %capture0: !stream.resource<transient>{%c200},
+           %alloc1 as %capture1: !stream.resource<transient>{%c200}) {
+    // CHECK: stream.cmd.dispatch @divergentBindingsEx::@dispatch[%c1, %c1, %c1](%c20, %[[OPERAND]] : index, index) {
+    stream.cmd.dispatch @divergentBindingsEx::@dispatch[%c1, %c1, %c1](%operand : index) {
+      // CHECK-NEXT: rw %[[CAPTURE0]][%c0{{.*}} for %c200]
+      // CHECK-NEXT: }
+      ro %capture0[%c20 for %c20] : !stream.resource<transient>{%c200},
+      rw %capture0[%c120 for %c20] : !stream.resource<transient>{%c200}
+    }
+    // CHECK: stream.cmd.dispatch @divergentBindingsEx::@dispatch_fused_0[%c1, %c1, %c1](%c40, %c80, %[[OPERAND]] : index, index, index) {
+    stream.cmd.dispatch @divergentBindingsEx::@dispatch[%c1, %c1, %c1](%operand : index) {
+      // CHECK-NEXT: ro %[[CAPTURE0]][%c0
+      ro %capture0[%c40 for %c20] : !stream.resource<transient>{%c200},
+      // CHECK-NEXT: rw %[[CAPTURE1]][%c0
+      rw %capture1[%c80 for %c20] : !stream.resource<transient>{%c200}
+    }
+  } => !stream.timepoint
+  return
+}
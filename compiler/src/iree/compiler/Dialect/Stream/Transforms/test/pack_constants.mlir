@@ -88,7 +88,8 @@ func.func @resourceVariables() -> (!stream.resource<variable>, !stream.resource<
 
 // Tests that if we exceed the maximum allowed allocation size the constants get
 // partitioned into multiple buckets each within the required bounds. This test
-// produces the same logic as above but doubled.
+// produces the same logic as above but doubled with both uploads issued at once
+// and joined.
 
 #splitResourceConstantsConfig = #stream.resource_config<{
   max_allocation_size = 16,
@@ -126,7 +127,7 @@ func.func @splitResourceConstants() -> (!stream.resource<constant>, !stream.reso
   // CHECK: %[[DID_MAP1:.+]], %[[TRY_MAP1:.+]] = stream.resource.try_map %[[RODATA1]]
   // CHECK: %[[IF1:.+]]:2 = scf.if %[[DID_MAP1]]
   // CHECK: %[[FILE1:.+]] = stream.file.constant %[[RODATA1]]
-  // CHECK: stream.file.read await(%[[IF0]]#0) => %[[FILE1]]
+  // CHECK: stream.file.read await(%[[IMMEDIATE]]) => %[[FILE1]]
   // CHECK: %[[RES1:.+]] = stream.resource.subview %[[IF1]]#1[%c0] : !stream.resource<constant>{%c16} -> !stream.resource<constant>{%c8}
 
   %0:3 = stream.resource.constants :
@@ -134,6 +135,7 @@ func.func @splitResourceConstants() -> (!stream.resource<constant>, !stream.reso
     !stream.resource<constant>{%c8} = dense<[101, 102]> : tensor<2xi32>
     => !stream.timepoint
 
-  // CHECK: return %[[RES0]], %[[RES1]], %[[IF1]]#0
+  // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[IF0]]#0, %[[IF1]]#0) => !stream.timepoint
+  // CHECK: return %[[RES0]], %[[RES1]], %[[JOIN]]
   return %0#0, %0#1, %0#2 : !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint
 }
@@ -0,0 +1,99 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(func.func(iree-stream-pack-transients))' %s | FileCheck %s
+
+// Tests that transients of sequential execution regions are placed into a
+// single arena where their disjoint lifetimes allow them to share memory. The
+// second region must wait for the first to release its range.
+
+// CHECK-LABEL: @sequentialTransients
+// CHECK-SAME: (%[[SIZE0:.+]]: index, %[[SIZE1:.+]]: index, %[[AWAIT_TIMEPOINT:.+]]: !stream.timepoint)
+func.func @sequentialTransients(%size0: index, %size1: index, %await_timepoint: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c254_i32 = arith.constant 254 : i32
+  //      CHECK: %[[SLICES:.+]]:3 = stream.resource.pack slices({
+  // CHECK-NEXT:   [2, 4] = %[[SIZE0]],
+  // CHECK-NEXT:   [6, 8] = %[[SIZE1]]
+  // CHECK-NEXT: })
+  // CHECK-NEXT: %[[ARENA:.+]], %[[ARENA_TIMEPOINT:.+]] = stream.resource.alloca uninitialized : !stream.resource<transient>{%[[SLICES]]#0} => !stream.timepoint
+  // CHECK-NEXT: %[[SUBVIEW0:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#1] : !stream.resource<transient>{%[[SLICES]]#0} -> !stream.resource<transient>{%[[SIZE0]]}
+  // CHECK-NEXT: %[[AWAIT0:.+]] = stream.timepoint.join max(%[[ARENA_TIMEPOINT]], %[[AWAIT_TIMEPOINT]])
+  %alloca0, %alloca0_timepoint = stream.resource.alloca uninitialized await(%await_timepoint) => !stream.resource<transient>{%size0} => !stream.timepoint
+  // CHECK: %[[EXEC0:.+]] = stream.cmd.execute await(%[[AWAIT0]]) => with(%[[SUBVIEW0]] as
+  %exec0 = stream.cmd.execute await(%alloca0_timepoint) => with(%alloca0 as %capture0: !stream.resource<transient>{%size0}) {
+    stream.cmd.fill %c254_i32, %capture0[%c0 for %size0] : i32 -> !stream.resource<transient>{%size0}
+  } => !stream.timepoint
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca0 = stream.resource.dealloca await(%exec0) => %alloca0 : !stream.resource<transient>{%size0} => !stream.timepoint
+  // CHECK: %[[JOIN0:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC0]])
+  %join0 = stream.timepoint.join max(%dealloca0, %exec0) => !stream.timepoint
+  // CHECK-NEXT: %[[SUBVIEW1:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#2] : !stream.resource<transient>{%[[SLICES]]#0} -> !stream.resource<transient>{%[[SIZE1]]}
+  // CHECK-NEXT: %[[AWAIT1:.+]] = stream.timepoint.join max(%[[ARENA_TIMEPOINT]], %[[JOIN0]], %[[EXEC0]])
+  %alloca1, %alloca1_timepoint = stream.resource.alloca uninitialized await(%join0) => !stream.resource<transient>{%size1} => !stream.timepoint
+  // CHECK: %[[EXEC1:.+]] = stream.cmd.execute await(%[[AWAIT1]]) => with(%[[SUBVIEW1]] as
+  %exec1 = stream.cmd.execute await(%alloca1_timepoint) => with(%alloca1 as %capture1: !stream.resource<transient>{%size1}) {
+    stream.cmd.fill %c254_i32, %capture1[%c0 for %size1] : i32 -> !stream.resource<transient>{%size1}
+  } => !stream.timepoint
+  // CHECK: %[[RELEASE:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC1]])
+  // CHECK-NEXT: %[[DEALLOCA:.+]] = stream.resource.dealloca await(%[[RELEASE]]) => %[[ARENA]] : !stream.resource<transient>{%[[SLICES]]#0} => !stream.timepoint
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca1 = stream.resource.dealloca await(%exec1) => %alloca1 : !stream.resource<transient>{%size1} => !stream.timepoint
+  // CHECK: %[[JOIN1:.+]] = stream.timepoint.join max(%[[DEALLOCA]], %[[EXEC1]])
+  %join1 = stream.timepoint.join max(%dealloca1, %exec1) => !stream.timepoint
+  // CHECK: return %[[JOIN1]]
+  return %join1 : !stream.timepoint
+}
+
+// -----
+
+// Tests that transients live at the same time are given overlapping lifetimes
+// in the arena and that no ordering is introduced between their regions.
+
+// CHECK-LABEL: @overlappingTransients
+// CHECK-SAME: (%[[SIZE0:.+]]: index, %[[SIZE1:.+]]: index)
+func.func @overlappingTransients(%size0: index, %size1: index) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c254_i32 = arith.constant 254 : i32
+  //      CHECK: %[[SLICES:.+]]:3 = stream.resource.pack slices({
+  // CHECK-NEXT:   [2, 6] = %[[SIZE0]],
+  // CHECK-NEXT:   [3, 7] = %[[SIZE1]]
+  // CHECK-NEXT: })
+  // CHECK-NEXT: %[[ARENA:.+]], %[[ARENA_TIMEPOINT:.+]] = stream.resource.alloca
+  // CHECK-NEXT: %[[SUBVIEW0:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#1]
+  // CHECK-NEXT: %[[SUBVIEW1:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#2]
+  %alloca0, %alloca0_timepoint = stream.resource.alloca uninitialized : !stream.resource<transient>{%size0} => !stream.timepoint
+  %alloca1, %alloca1_timepoint = stream.resource.alloca uninitialized : !stream.resource<transient>{%size1} => !stream.timepoint
+  // CHECK: %[[EXEC0:.+]] = stream.cmd.execute await(%[[ARENA_TIMEPOINT]]) => with(%[[SUBVIEW0]] as
+  %exec0 = stream.cmd.execute await(%alloca0_timepoint) => with(%alloca0 as %capture0: !stream.resource<transient>{%size0}) {
+    stream.cmd.fill %c254_i32, %capture0[%c0 for %size0] : i32 -> !stream.resource<transient>{%size0}
+  } => !stream.timepoint
+  // CHECK: %[[EXEC1:.+]] = stream.cmd.execute await(%[[ARENA_TIMEPOINT]]) => with(%[[SUBVIEW1]] as
+  %exec1 = stream.cmd.execute await(%alloca1_timepoint) => with(%alloca1 as %capture1: !stream.resource<transient>{%size1}) {
+    stream.cmd.fill %c254_i32, %capture1[%c0 for %size1] : i32 -> !stream.resource<transient>{%size1}
+  } => !stream.timepoint
+  %dealloca0 = stream.resource.dealloca await(%exec0) => %alloca0 : !stream.resource<transient>{%size0} => !stream.timepoint
+  // CHECK: %[[RELEASE:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC1]])
+  // CHECK-NEXT: %[[DEALLOCA:.+]] = stream.resource.dealloca await(%[[RELEASE]]) => %[[ARENA]]
+  %dealloca1 = stream.resource.dealloca await(%exec1) => %alloca1 : !stream.resource<transient>{%size1} => !stream.timepoint
+  // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[DEALLOCA]])
+  %join = stream.timepoint.join max(%dealloca0, %dealloca1) => !stream.timepoint
+  // CHECK: return %[[JOIN]]
+  return %join : !stream.timepoint
+}
+
+// -----
+
+// Tests that a lone transient is left as-is.
+
+// CHECK-LABEL: @singleTransient
+func.func @singleTransient(%size: index) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c254_i32 = arith.constant 254 : i32
+  // CHECK-NOT: stream.resource.pack
+  // CHECK: %[[ALLOCA:.+]], %{{.+}} = stream.resource.alloca uninitialized : !stream.resource<transient>{%arg0}
+  %alloca, %alloca_timepoint = stream.resource.alloca uninitialized : !stream.resource<transient>{%size} => !stream.timepoint
+  %exec = stream.cmd.execute await(%alloca_timepoint) => with(%alloca as %capture: !stream.resource<transient>{%size}) {
+    stream.cmd.fill %c254_i32, %capture[%c0 for %size] : i32 -> !stream.resource<transient>{%size}
+  } => !stream.timepoint
+  // CHECK: stream.resource.dealloca await({{.+}}) => %[[ALLOCA]]
+  %dealloca = stream.resource.dealloca await(%exec) => %alloca : !stream.resource<transient>{%size} => !stream.timepoint
+  return %dealloca : !stream.timepoint
+}
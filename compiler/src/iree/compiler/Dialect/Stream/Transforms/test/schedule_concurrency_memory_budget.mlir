@@ -0,0 +1,46 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-stream-schedule-concurrency{max-transient-memory=1024}))" %s | FileCheck %s
+
+// Tests that a wave allocating more than the memory budget is split into waves
+// executed serially while waves that only operate in-place remain concurrent.
+
+// CHECK-LABEL: @splitWaveOverBudget
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>, %[[ARG1:.+]]: !stream.resource<external>)
+func.func @splitWaveOverBudget(%arg0: !stream.resource<external>, %arg1: !stream.resource<external>) -> !stream.resource<external>
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  %c80 = arith.constant 80 : index
+  %c1280 = arith.constant 1280 : index
+  %c255_i32 = arith.constant 255 : i32
+  // CHECK: stream.async.execute
+  %results, %result_timepoint = stream.async.execute
+      with(%arg1 as %arg2: !stream.resource<external>{%c80},
+           %arg0 as %arg3: !stream.resource<external>{%c20})
+      -> !stream.resource<external>{%c20} {
+
+    // The splats together allocate 1300 bytes and can't share a wave.
+    // CHECK-NOT: stream.async.concurrent
+    // CHECK: %[[SPLAT0:.+]] = stream.async.splat %c255_i32 : i32 -> !stream.resource<transient>{%c1280}
+    // CHECK-NOT: stream.async.concurrent
+    // CHECK: %[[SPLAT1:.+]] = stream.async.splat %c255_i32 : i32 -> !stream.resource<transient>{%c20}
+
+    // The dispatches are tied to their operands and allocate nothing.
+    // CHECK: %[[CON:.+]]:2 = stream.async.concurrent
+    // CHECK-SAME: with(%[[SPLAT0]] as
+    // CHECK: stream.async.dispatch @ex::@dispatch_0
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+    // CHECK-NEXT: stream.yield
+
+    // CHECK: stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%[[CON]]#0[{{.+}}], %[[CON]]#1[{{.+}}])
+
+    %1 = stream.async.splat %c255_i32 : i32 -> !stream.resource<transient>{%c1280}
+    %2 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%1[%c0 to %c1280 for %c1280], %arg2[%c0 to %c80 for %c80]) : (!stream.resource<transient>{%c1280}, !stream.resource<external>{%c80}) -> %1{%c1280}
+    %3 = stream.async.splat %c255_i32 : i32 -> !stream.resource<transient>{%c20}
+    %4 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%arg3[%c0 to %c20 for %c20], %3[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}, !stream.resource<transient>{%c20}) -> %3{%c20}
+    %5 = stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%2[%c0 to %c1280 for %c1280], %4[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c1280}, !stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+    stream.yield %5 : !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %0 = stream.timepoint.await %result_timepoint => %results : !stream.resource<external>{%c20}
+  return %0 : !stream.resource<external>
+}
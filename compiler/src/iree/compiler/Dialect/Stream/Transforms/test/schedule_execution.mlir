@@ -134,6 +134,55 @@ func.func @partitioningWithConcurrentAffinities(%arg0: !stream.resource<external
 
 // -----
 
+// Tests that dispatches consuming inputs imported with their own fences are
+// partitioned into execution regions that each wait on only the fences of the
+// inputs they consume. This allows work on inputs that are ready early to begin
+// while others are still being transferred.
+
+// CHECK-LABEL: @partitioningWithFineFences
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>, %[[FENCE0:.+]]: !hal.fence, %[[ARG1:.+]]: !stream.resource<external>, %[[FENCE1:.+]]: !hal.fence)
+func.func @partitioningWithFineFences(%arg0: !stream.resource<external>, %fence0: !hal.fence, %arg1: !stream.resource<external>, %fence1: !hal.fence) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  // CHECK: %[[TIMEPOINT0:.+]] = stream.timepoint.import %[[FENCE0]]
+  %timepoint0 = stream.timepoint.import %fence0 : (!hal.fence) => !stream.timepoint
+  // CHECK-NEXT: %[[READY0:.+]] = stream.timepoint.await %[[TIMEPOINT0]] => %[[ARG0]]
+  %ready0 = stream.timepoint.await %timepoint0 => %arg0 : !stream.resource<external>{%c20}
+  // CHECK-NEXT: %[[TIMEPOINT1:.+]] = stream.timepoint.import %[[FENCE1]]
+  %timepoint1 = stream.timepoint.import %fence1 : (!hal.fence) => !stream.timepoint
+  // CHECK-NEXT: %[[READY1:.+]] = stream.timepoint.await %[[TIMEPOINT1]] => %[[ARG1]]
+  %ready1 = stream.timepoint.await %timepoint1 => %arg1 : !stream.resource<external>{%c20}
+
+  // CHECK: %[[RESULT0:.+]], %[[EXEC_TIMEPOINT0:.+]] = stream.async.execute
+  // CHECK-SAME: with(%[[READY0]] as %[[READY0_CAPTURE:.+]]: !stream.resource<external>{%c20})
+  // CHECK-NEXT: %[[DISPATCH0:.+]] = stream.async.dispatch @ex::@dispatch_0[%c1](%[[READY0_CAPTURE]][{{.+}}])
+  %dispatch0 = stream.async.dispatch @ex::@dispatch_0[%c1](%ready0[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+  // CHECK-NEXT: stream.yield %[[DISPATCH0]]
+  // CHECK-NEXT: } => !stream.timepoint
+
+  // CHECK: %[[RESULT1:.+]], %[[EXEC_TIMEPOINT1:.+]] = stream.async.execute
+  // CHECK-SAME: with(%[[READY1]] as %[[READY1_CAPTURE:.+]]: !stream.resource<external>{%c20})
+  // CHECK-NEXT: %[[DISPATCH1:.+]] = stream.async.dispatch @ex::@dispatch_1[%c1](%[[READY1_CAPTURE]][{{.+}}])
+  %dispatch1 = stream.async.dispatch @ex::@dispatch_1[%c1](%ready1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+  // CHECK-NEXT: stream.yield %[[DISPATCH1]]
+  // CHECK-NEXT: } => !stream.timepoint
+
+  // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[EXEC_TIMEPOINT0]], %[[EXEC_TIMEPOINT1]])
+  // CHECK: %[[RESULT:.+]], %[[EXEC_TIMEPOINT2:.+]] = stream.async.execute
+  // CHECK-SAME: await(%[[JOIN]])
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2
+  %dispatch2 = stream.async.dispatch @ex::@dispatch_2[%c1](%dispatch0[%c0 to %c20 for %c20], %dispatch1[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}, !stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+  // CHECK-NEXT: stream.yield
+  // CHECK-NEXT: } => !stream.timepoint
+
+  // CHECK-NEXT: %[[READY:.+]] = stream.timepoint.await %[[EXEC_TIMEPOINT2]] => %[[RESULT]]
+  // CHECK-NEXT: return %[[READY]]
+  return %dispatch2 : !stream.resource<external>
+}
+
+// -----
+
 // Tests that ops in multiple blocks are partitioned independently and that
 // timepoints are chained between the partitions. Note that the dispatches
 // happen in-place on the splat and we expect the execution regions to be tied.
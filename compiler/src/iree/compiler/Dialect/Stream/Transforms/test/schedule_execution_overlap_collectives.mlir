@@ -0,0 +1,65 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-stream-schedule-execution{overlap-collectives=true collective-queue=1}))" %s | FileCheck %s
+
+// Tests that chunked compute feeding collectives is pipelined: each collective
+// is placed in its own execution region on the collective queue and waits only
+// on the compute of its own chunk, leaving the compute of the next chunk free
+// to execute concurrently with it.
+
+// CHECK-LABEL: @overlapChunkedCollectives
+// CHECK-SAME: (%[[CHANNEL:.+]]: !stream.channel, %[[ARG0:.+]]: !stream.resource<external>, %[[ARG1:.+]]: !stream.resource<external>)
+func.func @overlapChunkedCollectives(%channel: !stream.channel, %arg0: !stream.resource<external>, %arg1: !stream.resource<external>) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  %c80 = arith.constant 80 : index
+  %c320 = arith.constant 320 : index
+  %c1280 = arith.constant 1280 : index
+
+  // CHECK: %[[CHUNK0:.+]], %[[CHUNK0_TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-SAME: with(%[[ARG0]] as %[[ARG0_CAPTURE:.+]]: !stream.resource<external>{%c80})
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0[%c1](%[[ARG0_CAPTURE]][{{.+}}])
+  // CHECK-NEXT: stream.yield
+  %chunk0 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg0[%c0 to %c80 for %c80]) : (!stream.resource<external>{%c80}) -> !stream.resource<transient>{%c1280}
+
+  // CHECK: %[[REDUCED0:.+]], %[[REDUCED0_TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-SAME: on(#hal.affinity.queue<[1]>)
+  // CHECK-SAME: await(%[[CHUNK0_TIMEPOINT]])
+  // CHECK-SAME: with(%[[CHUNK0]] as %[[CHUNK0_CAPTURE:.+]]: !stream.resource<transient>{%c1280})
+  // CHECK-NEXT: %[[RECV0:.+]] = stream.async.alloca
+  // CHECK-NEXT: stream.async.collective<all_reduce with sum : f32>[%c320] channel(%[[CHANNEL]])
+  // CHECK-SAME: %[[CHUNK0_CAPTURE]][{{.+}}], %[[RECV0]][{{.+}}]
+  // CHECK-NEXT: stream.yield
+  %recv0 = stream.async.alloca : !stream.resource<transient>{%c1280}
+  %reduced0 = stream.async.collective<all_reduce with sum : f32>[%c320] channel(%channel)
+      %chunk0[%c0 to %c1280 for %c1280],
+      %recv0[%c0 to %c1280 for %c1280] :
+      !stream.resource<transient>{%c1280} -> %recv0 as !stream.resource<transient>{%c1280}
+
+  // The compute of the second chunk does not wait on the first collective.
+  // CHECK: %[[CHUNK1:.+]], %[[CHUNK1_TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-NOT: await
+  // CHECK-SAME: with(%[[ARG1]] as %[[ARG1_CAPTURE:.+]]: !stream.resource<external>{%c80})
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0[%c1](%[[ARG1_CAPTURE]][{{.+}}])
+  // CHECK-NEXT: stream.yield
+  %chunk1 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg1[%c0 to %c80 for %c80]) : (!stream.resource<external>{%c80}) -> !stream.resource<transient>{%c1280}
+
+  // CHECK: %[[REDUCED1:.+]], %[[REDUCED1_TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-SAME: on(#hal.affinity.queue<[1]>)
+  // CHECK-SAME: await(%[[CHUNK1_TIMEPOINT]])
+  // CHECK: stream.async.collective<all_reduce with sum : f32>
+  %recv1 = stream.async.alloca : !stream.resource<transient>{%c1280}
+  %reduced1 = stream.async.collective<all_reduce with sum : f32>[%c320] channel(%channel)
+      %chunk1[%c0 to %c1280 for %c1280],
+      %recv1[%c0 to %c1280 for %c1280] :
+      !stream.resource<transient>{%c1280} -> %recv1 as !stream.resource<transient>{%c1280}
+
+  // CHECK: %[[RESULT:.+]], %[[RESULT_TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-SAME: with(%[[REDUCED0]] as %{{.+}}: !stream.resource<transient>{%c1280},
+  // CHECK-SAME:      %[[REDUCED1]] as %{{.+}}: !stream.resource<transient>{%c1280})
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+  %result = stream.async.dispatch @ex::@dispatch_1[%c1](%reduced0[%c0 to %c1280 for %c1280], %reduced1[%c0 to %c1280 for %c1280]) : (!stream.resource<transient>{%c1280}, !stream.resource<transient>{%c1280}) -> !stream.resource<external>{%c20}
+
+  // CHECK: %[[READY:.+]] = stream.timepoint.await %[[RESULT_TIMEPOINT]] => %[[RESULT]]
+  // CHECK-NEXT: return %[[READY]]
+  return %result : !stream.resource<external>
+}
@@ -0,0 +1,108 @@
+// RUN: iree-opt --split-input-file --iree-stream-specialize-dispatch-shapes="bucket-sizes=16,64" %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-stream-specialize-dispatch-shapes="bucket-sizes=16 values=1" %s | FileCheck %s --check-prefix=VALUES
+
+// Tests that an export with dynamic dimensions gets one variant per bucket and
+// that the dispatch site selects between them and the original dynamic export
+// based on the divisibility of the dimensions.
+
+// Exact shape values are checked before any bucket and dispatch constants so
+// that the variant is specialized to static shapes.
+
+// CHECK-LABEL: stream.executable private @ex
+// VALUES-LABEL: stream.executable private @ex
+stream.executable private @ex {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK-NEXT: stream.executable.export public @dispatch_div64
+  // CHECK-NEXT: stream.executable.export public @dispatch_div16
+  // VALUES: stream.executable.export public @dispatch
+  // VALUES-NEXT: stream.executable.export public @dispatch_eq1
+  // VALUES-NEXT: stream.executable.export public @dispatch_div16
+  stream.executable.export public @dispatch
+  builtin.module {
+    // CHECK: func.func @dispatch(
+    // CHECK: func.func @dispatch_div64(
+    // CHECK: func.func @dispatch_div16(
+    func.func @dispatch(%arg0: !stream.binding, %arg1: !stream.binding, %dim: index) {
+      %c0 = arith.constant 0 : index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<?x4xf32>>{%dim}
+      %1 = stream.binding.subspan %arg1[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>{%dim}
+      %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [%dim, 4], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<?x4xf32>>{%dim} -> tensor<?x4xf32>
+      flow.dispatch.tensor.store %2, %1, offsets = [0, 0], sizes = [%dim, 4], strides = [1, 1] : tensor<?x4xf32> -> !flow.dispatch.tensor<writeonly:tensor<?x4xf32>>{%dim}
+      return
+    }
+  }
+}
+// CHECK-LABEL: func.func @dynamic_dispatch
+// CHECK-SAME: (%[[INPUT:.+]]: !stream.resource<*>, %[[SIZE:.+]]: index, %[[DIM:.+]]: index)
+// VALUES-LABEL: func.func @dynamic_dispatch
+// VALUES-SAME: (%[[INPUT:.+]]: !stream.resource<*>, %[[SIZE:.+]]: index, %[[DIM:.+]]: index)
+func.func @dynamic_dispatch(%input: !stream.resource<*>, %size: index, %dim: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  // CHECK-DAG: %[[C64:.+]] = arith.constant 64 : index
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK: %[[REM64:.+]] = arith.remui %[[DIM]], %[[C64]]
+  // CHECK: %[[COND64:.+]] = arith.cmpi eq, %[[REM64]], %[[C0]]
+  // CHECK: %[[RESULT:.+]] = scf.if %[[COND64]] -> (!stream.resource<*>) {
+  // CHECK:   %[[ALIGNED64:.+]] = util.align %[[DIM]], %{{.+}} : index
+  // CHECK:   %[[RESULT64:.+]] = stream.async.dispatch @ex::@dispatch_div64[%[[ALIGNED64]], %c1, %c1](%[[INPUT]][%c0 to %[[SIZE]] for %[[SIZE]]], %[[ALIGNED64]])
+  // CHECK:   scf.yield %[[RESULT64]]
+  // CHECK: } else {
+  // CHECK:   %[[C16:.+]] = arith.constant 16 : index
+  // CHECK:   %[[REM16:.+]] = arith.remui %[[DIM]], %[[C16]]
+  // CHECK:   %[[COND16:.+]] = arith.cmpi eq, %[[REM16]]
+  // CHECK:   %[[NESTED:.+]] = scf.if %[[COND16]] -> (!stream.resource<*>) {
+  // CHECK:     %[[ALIGNED16:.+]] = util.align %[[DIM]], %{{.+}} : index
+  // CHECK:     %[[RESULT16:.+]] = stream.async.dispatch @ex::@dispatch_div16{{.+}}, %[[ALIGNED16]])
+  // CHECK:     scf.yield %[[RESULT16]]
+  // CHECK:   } else {
+  // CHECK:     %[[FALLBACK:.+]] = stream.async.dispatch @ex::@dispatch{{.+}}, %[[DIM]])
+  // CHECK:     scf.yield %[[FALLBACK]]
+  // CHECK:   }
+  // CHECK:   scf.yield %[[NESTED]]
+  // CHECK: }
+  %0 = stream.async.dispatch @ex::@dispatch[%dim, %c1, %c1](%input[%c0 to %size for %size], %dim) : (!stream.resource<*>{%size}, index) -> !stream.resource<*>{%size}
+  // VALUES: %[[C1:.+]] = arith.constant 1 : index
+  // VALUES: %[[COND1:.+]] = arith.cmpi eq, %[[DIM]], %[[C1]]
+  // VALUES: %[[RESULT:.+]] = scf.if %[[COND1]] -> (!stream.resource<*>) {
+  // VALUES:   %[[C1_0:.+]] = arith.constant 1 : index
+  // VALUES:   %[[RESULT1:.+]] = stream.async.dispatch @ex::@dispatch_eq1[%[[C1_0]], %c1, %c1](%[[INPUT]][%c0 to %[[SIZE]] for %[[SIZE]]], %[[C1_0]])
+  // VALUES:   scf.yield %[[RESULT1]]
+  // VALUES: } else {
+  // VALUES:   scf.if
+  // VALUES:     stream.async.dispatch @ex::@dispatch_div16
+  // VALUES:   } else {
+  // VALUES:     stream.async.dispatch @ex::@dispatch{{.+}}, %[[DIM]])
+  // CHECK: return %[[RESULT]]
+  // VALUES: return %[[RESULT]]
+  return %0 : !stream.resource<*>
+}
+
+// -----
+
+// Tests that exports only ever dispatched with static dimensions are left
+// untouched.
+
+// CHECK-LABEL: stream.executable private @static_ex
+stream.executable private @static_ex {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK-NOT: stream.executable.export
+  stream.executable.export public @dispatch
+  builtin.module {
+    func.func @dispatch(%arg0: !stream.binding, %dim: index) {
+      %c0 = arith.constant 0 : index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readwrite:tensor<?xf32>>{%dim}
+      return
+    }
+  }
+}
+// CHECK-LABEL: func.func @static_dispatch
+func.func @static_dispatch(%input: !stream.resource<*>, %size: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  // CHECK-NOT: scf.if
+  // CHECK: stream.async.dispatch @static_ex::@dispatch
+  %0 = stream.async.dispatch @static_ex::@dispatch[%c1, %c1, %c1](%input[%c0 to %size for %size], %c128) : (!stream.resource<*>{%size}, index) -> %input{%size}
+  return %0 : !stream.resource<*>
+}
@@ -13,6 +13,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/GraphWriter.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 
 #define DEBUG_TYPE "iree-constexpr"
 
@@ -370,8 +371,11 @@ void ConstExprHoistingPolicy::makeInvariantDecision(
   }
 
   // Check 4: Does hoisting this value significantly increase the size of the
-  // module?
-  if (doesHoistingIncreaseSizeSignificantly(
+  // module? Packs are exempt: they only change the layout (plus padding
+  // bounded by the inner tile sizes), and leaving them in the program means
+  // re-packing the weights they typically apply to on every context creation.
+  if (!isa<tensor::PackOp>(info->getOperation()) &&
+      doesHoistingIncreaseSizeSignificantly(
           info, constExprMaxSizeIncreaseThreshold)) {
     return decision->disableHoist();
   }
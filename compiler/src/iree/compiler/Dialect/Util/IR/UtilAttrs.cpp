@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "llvm/ADT/BitVector.h"
@@ -751,8 +753,40 @@ struct SerializableDenseResourceElementsAttrModel
       return success();
     }
 
-    return mlir::emitError(loc)
-           << "DenseResourceElementsAttr not yet supported for serialization";
+    // Stream the blob contents directly to avoid materializing another copy
+    // of what may be a very large (and possibly memory-mapped) value.
+    auto *blob = handle.getBlob();
+    if (!blob) {
+      return mlir::emitError(loc)
+             << "dense resource '" << handle.getKey()
+             << "' has no data and cannot be serialized";
+    }
+    ArrayRef<char> data = blob->getData();
+    if (static_cast<int64_t>(data.size()) != getStorageSize(baseAttr)) {
+      return mlir::emitError(loc)
+             << "dense resource '" << handle.getKey() << "' has "
+             << data.size() << " bytes but " << getStorageSize(baseAttr)
+             << " are required for " << attr.getType();
+    }
+    // Complex values are swapped per component.
+    Type elementType = attr.getType().getElementType();
+    if (auto complexType = llvm::dyn_cast<ComplexType>(elementType)) {
+      elementType = complexType.getElementType();
+    }
+    unsigned elementByteWidth = getTypeBitWidth(elementType) / 8;
+    if (elementByteWidth <= 1 || endian == llvm::endianness::native) {
+      os.write(data.data(), data.size());
+      return success();
+    }
+
+    // Slow-path swapping each element from the host endianness.
+    SmallVector<char, 8> element(elementByteWidth);
+    for (size_t i = 0; i < data.size(); i += elementByteWidth) {
+      std::reverse_copy(data.begin() + i, data.begin() + i + elementByteWidth,
+                        element.begin());
+      os.write(element.data(), element.size());
+    }
+    return success();
   }
 };
 
@@ -313,3 +313,26 @@ module @do_not_hoist_significant_size_increase_const_expr {
     return %2 : tensor<129xi8>
   }
 }
+
+// -----
+
+// Packs are hoisted regardless of the size increase from their padding, so
+// that constant weights are packed once at compile time.
+// CHECK-LABEL: @hoist_padded_pack
+// CHECK: util.global private @[[HOISTED:.*]] : tensor<1x32x8x1xf32>
+// CHECK: func.func @main
+// CHECK:   %[[RESULT:.*]] = util.global.load @[[HOISTED]]
+// CHECK:   return %[[RESULT]]
+// CHECK: util.initializer
+// CHECK:   tensor.pack
+module @hoist_padded_pack {
+  func.func @main() -> (tensor<1x32x8x1xf32>) {
+    %cst = arith.constant dense<1.0> : tensor<1x32xf32>
+    %pad = arith.constant 0.0 : f32
+    %0 = tensor.empty() : tensor<1x32x8x1xf32>
+    %1 = tensor.pack %cst padding_value(%pad : f32)
+        inner_dims_pos = [0, 1] inner_tiles = [8, 1]
+        into %0 : tensor<1x32xf32> -> tensor<1x32x8x1xf32>
+    return %1 : tensor<1x32x8x1xf32>
+  }
+}
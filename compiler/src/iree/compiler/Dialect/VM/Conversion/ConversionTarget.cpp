@@ -23,6 +23,12 @@ VMConversionTarget::nestModuleForConversion(mlir::ModuleOp outerModuleOp) {
     innerModuleOp.getBodyRegion().takeBody(outerModuleOp.getBodyRegion());
     outerModuleOp.getBodyRegion().getBlocks().push_back(new Block());
     outerModuleOp.push_back(innerModuleOp);
+    // Module-level reflection metadata belongs to the VM module produced from
+    // the inner module.
+    if (auto reflectionAttr = outerModuleOp->getAttr("iree.reflection")) {
+      innerModuleOp->setAttr("iree.reflection", reflectionAttr);
+      outerModuleOp->removeAttr("iree.reflection");
+    }
   }
 
   outerModuleOp->setAttr("vm.toplevel",
@@ -49,3 +49,12 @@ module @t004_module_version {
 module @my_module attributes {vm.version = 4 : i32} {}
 
 }
+
+// -----
+// CHECK-LABEL: @t005_module_reflection
+module @t005_module_reflection {
+
+// CHECK: vm.module public @my_module attributes {iree.reflection = {"hal.device.targets" = "vulkan,llvm-cpu"}}
+module @my_module attributes {iree.reflection = {"hal.device.targets" = "vulkan,llvm-cpu"}} {}
+
+}
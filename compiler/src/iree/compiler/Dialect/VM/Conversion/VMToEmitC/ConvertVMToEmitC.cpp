@@ -2736,6 +2736,141 @@ class CompareRefNotZeroOpConversion
   }
 };
 
+// Converts vm.select.ref with the same retain/move semantics as the bytecode
+// interpreter: the selected operand is retained or moved into the result and
+// the other operand is released if it was moved.
+class SelectRefOpConversion
+    : public EmitCConversionPattern<IREE::VM::SelectRefOp> {
+  using Adaptor = IREE::VM::SelectRefOp::Adaptor;
+  using EmitCConversionPattern<IREE::VM::SelectRefOp>::EmitCConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(IREE::VM::SelectRefOp selectOp, Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto ctx = selectOp.getContext();
+    auto loc = selectOp.getLoc();
+
+    auto funcOp =
+        selectOp.getOperation()->getParentOfType<mlir::func::FuncOp>();
+
+    IREE::VM::EmitCTypeConverter *typeConverter = const_cast<
+        IREE::VM::EmitCTypeConverter *>(
+        this->template getTypeConverter<const IREE::VM::EmitCTypeConverter>());
+
+    auto vmAnalysis = typeConverter->lookupAnalysis(funcOp);
+    if (failed(vmAnalysis)) {
+      return selectOp.emitError() << "parent func op not found in cache.";
+    }
+
+    bool moveTrue = vmAnalysis.value().get().isMove(selectOp.getTrueValue(),
+                                                    selectOp.getOperation());
+    bool moveFalse = vmAnalysis.value().get().isMove(selectOp.getFalseValue(),
+                                                     selectOp.getOperation());
+
+    std::optional<Value> refTrue =
+        typeConverter->materializeRef(selectOp.getTrueValue());
+    std::optional<Value> refFalse =
+        typeConverter->materializeRef(selectOp.getFalseValue());
+    std::optional<Value> refResult =
+        typeConverter->materializeRef(selectOp.getResult());
+    if (!refTrue.has_value() || !refFalse.has_value() ||
+        !refResult.has_value()) {
+      return selectOp.emitError() << "local ref not found";
+    }
+
+    auto moduleOp = selectOp->getParentOfType<IREE::VM::ModuleOp>();
+    const BlockArgument moduleArg = funcOp.getArgument(CCONV_ARGUMENT_MODULE);
+    auto elementTypePtr =
+        createVmTypeDefPtr(rewriter, loc, *typeConverter, moduleOp, moduleArg,
+                           selectOp.getType());
+    if (!elementTypePtr.has_value()) {
+      return selectOp.emitError() << "generating iree_vm_type_def_t* failed";
+    }
+    auto typedefAsRef =
+        rewriter
+            .create<emitc::CallOp>(
+                /*location=*/loc,
+                /*type=*/emitc::OpaqueType::get(ctx, "iree_vm_ref_type_t"),
+                /*callee=*/StringAttr::get(ctx, "iree_vm_type_def_as_ref"),
+                /*args=*/ArrayAttr{}, /*templateArgs=*/ArrayAttr{},
+                /*operands=*/ArrayRef<Value>{elementTypePtr.value()})
+            .getResult(0);
+
+    returnIfError(
+        /*rewriter=*/rewriter,
+        /*location=*/loc,
+        /*callee=*/StringAttr::get(ctx, "vm_select_ref"),
+        /*args=*/
+        ArrayAttr::get(
+            ctx, {rewriter.getIndexAttr(0), rewriter.getIndexAttr(1),
+                  rewriter.getBoolAttr(moveTrue), rewriter.getIndexAttr(2),
+                  rewriter.getBoolAttr(moveFalse), rewriter.getIndexAttr(3),
+                  rewriter.getIndexAttr(4)}),
+        /*operands=*/
+        ArrayRef<Value>{adaptor.getCondition(), refTrue.value(),
+                        refFalse.value(), typedefAsRef, refResult.value()},
+        /*typeConverter=*/*typeConverter);
+
+    rewriter.replaceOp(selectOp, refResult.value());
+
+    return success();
+  }
+};
+
+// Converts vm.switch.* ops on primitive values into a chain of selects that
+// starts from the default value and tests the cases from last to first.
+template <typename OpTy>
+class SwitchOpConversion : public EmitCConversionPattern<OpTy> {
+  using Adaptor = typename OpTy::Adaptor;
+  using EmitCConversionPattern<OpTy>::EmitCConversionPattern;
+
+public:
+  SwitchOpConversion(const TypeConverter &typeConverter, MLIRContext *context,
+                     StringRef selectFuncName)
+      : EmitCConversionPattern<OpTy>(typeConverter, context),
+        selectFuncName(selectFuncName) {}
+
+private:
+  LogicalResult
+  matchAndRewrite(OpTy switchOp, Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto ctx = switchOp.getContext();
+    auto loc = switchOp.getLoc();
+
+    Type indexType = adaptor.getIndex().getType();
+    ValueRange values = adaptor.getValues();
+    Value result = adaptor.getDefaultValue();
+    for (int64_t i = static_cast<int64_t>(values.size()) - 1; i >= 0; --i) {
+      Value caseIndex = rewriter.create<emitc::ConstantOp>(
+          loc, indexType, rewriter.getIntegerAttr(indexType, i));
+      Value isCase =
+          rewriter
+              .create<emitc::CallOp>(
+                  /*location=*/loc,
+                  /*type=*/indexType,
+                  /*callee=*/StringAttr::get(ctx, "vm_cmp_eq_i32"),
+                  /*args=*/ArrayAttr{},
+                  /*templateArgs=*/ArrayAttr{},
+                  /*operands=*/ArrayRef<Value>{adaptor.getIndex(), caseIndex})
+              .getResult(0);
+      result = rewriter
+                   .create<emitc::CallOp>(
+                       /*location=*/loc,
+                       /*type=*/switchOp.getType(),
+                       /*callee=*/StringAttr::get(ctx, selectFuncName),
+                       /*args=*/ArrayAttr{},
+                       /*templateArgs=*/ArrayAttr{},
+                       /*operands=*/ArrayRef<Value>{isCase, values[i], result})
+                   .getResult(0);
+    }
+    rewriter.replaceOp(switchOp, result);
+
+    return success();
+  }
+
+  StringRef selectFuncName;
+};
+
 template <typename OpTy>
 class ConstOpConversion : public EmitCConversionPattern<OpTy> {
   using Adaptor = typename OpTy::Adaptor;
@@ -3982,6 +4117,10 @@ class ListGetOpConversion : public EmitCConversionPattern<OpTy> {
               return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_I64"),
                                     StringRef("iree_vm_value_get_i64"));
             })
+            .template Case<IREE::VM::ListGetF32Op>([&](auto op) {
+              return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_F32"),
+                                    StringRef("iree_vm_value_get_f32"));
+            })
             .Default([](Operation *) {
               return std::make_pair(std::nullopt, std::nullopt);
             });
@@ -4209,6 +4348,8 @@ class ListSetOpConversion : public EmitCConversionPattern<OpTy> {
                 [&](auto op) { return StringRef("iree_vm_value_make_i32"); })
             .template Case<IREE::VM::ListSetI64Op>(
                 [&](auto op) { return StringRef("iree_vm_value_make_i64"); })
+            .template Case<IREE::VM::ListSetF32Op>(
+                [&](auto op) { return StringRef("iree_vm_value_make_f32"); })
             .Default([](Operation *) { return std::nullopt; });
 
     if (!valueConstructor.has_value()) {
@@ -4328,6 +4469,8 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
 #define ADD_CONTAINER_PATTERN(Op, FuncName, IndexSet, Failable)                \
   patterns.add<ContainerOpConversion<Op>>(typeConverter, context, FuncName,    \
                                           IndexSet, Failable);
+#define ADD_SWITCH_PATTERN(Op, SelectFuncName)                                 \
+  patterns.add<SwitchOpConversion<Op>>(typeConverter, context, SelectFuncName)
 #define ADD_GLOBAL_LOAD_PATTERN(Op, GlobalOp, FuncName)                        \
   patterns.add<GlobalLoadOpConversion<Op, GlobalOp>>(typeConverter, context,   \
                                                      FuncName);
@@ -4367,13 +4510,16 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
     GlobalLoadStoreRefOpConversion<IREE::VM::GlobalLoadRefOp>,
     GlobalLoadStoreRefOpConversion<IREE::VM::GlobalStoreRefOp>,
     ImportResolvedOpConversion,
+    ListGetOpConversion<IREE::VM::ListGetF32Op>,
     ListGetOpConversion<IREE::VM::ListGetI32Op>,
     ListGetOpConversion<IREE::VM::ListGetI64Op>,
     ListGetRefOpConversion,
+    ListSetOpConversion<IREE::VM::ListSetF32Op>,
     ListSetOpConversion<IREE::VM::ListSetI32Op>,
     ListSetOpConversion<IREE::VM::ListSetI64Op>,
     ListSetRefOpConversion,
-    ReturnOpConversion
+    ReturnOpConversion,
+    SelectRefOpConversion
   >(typeConverter, context);
   // clang-format on
 
@@ -4490,6 +4636,11 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   ADD_GENERIC_PATTERN(IREE::VM::XorI32Op, "vm_xor_i32");
   ADD_GENERIC_PATTERN(IREE::VM::XorI64Op, "vm_xor_i64");
 
+  // switch patterns
+  ADD_SWITCH_PATTERN(IREE::VM::SwitchF32Op, "vm_select_f32");
+  ADD_SWITCH_PATTERN(IREE::VM::SwitchI32Op, "vm_select_i32");
+  ADD_SWITCH_PATTERN(IREE::VM::SwitchI64Op, "vm_select_i64");
+
   // containers wrapped in ref types
   ADD_CONTAINER_PATTERN(IREE::VM::BufferCompareOp, "vm_buffer_compare",
                         DenseSet<size_t>({0, 2}), true);
@@ -4559,6 +4710,7 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
 
 #undef ADD_GENERIC_PATTERN
 #undef ADD_CONTAINER_PATTERN
+#undef ADD_SWITCH_PATTERN
 #undef ADD_GLOBAL_LOAD_PATTERN
 #undef ADD_GLOBAL_STORE_PATTERN
 }
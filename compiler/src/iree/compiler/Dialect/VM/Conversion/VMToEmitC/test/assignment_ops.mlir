@@ -8,3 +8,31 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @my_module_select_ref
+vm.module @my_module {
+  vm.func @select_ref(%arg0 : i32, %arg1 : !vm.buffer, %arg2 : !vm.buffer) -> !vm.buffer {
+    // CHECK: %[[TYPE:.+]] = emitc.call "iree_vm_type_def_as_ref"(%{{.+}}) : (!emitc.opaque<"iree_vm_type_def_t">) -> !emitc.opaque<"iree_vm_ref_type_t">
+    // CHECK: %{{.+}} = emitc.call "vm_select_ref"(%arg3, %arg4, %arg5, %[[TYPE]], %{{.+}}) {args = [0 : index, 1 : index, {{(true|false)}}, 2 : index, {{(true|false)}}, 3 : index, 4 : index]} : (i32, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>, !emitc.opaque<"iree_vm_ref_type_t">, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>) -> !emitc.opaque<"iree_status_t">
+    %0 = vm.select.ref %arg0, %arg1, %arg2 : !vm.buffer
+    vm.return %0 : !vm.buffer
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_switch_i32
+vm.module @my_module {
+  vm.func @switch_i32(%arg0 : i32, %arg1 : i32, %arg2 : i32, %arg3 : i32) -> i32 {
+    // CHECK: %[[C1:.+]] = "emitc.constant"() <{value = 1 : i32}> : () -> i32
+    // CHECK-NEXT: %[[EQ1:.+]] = emitc.call "vm_cmp_eq_i32"(%arg3, %[[C1]]) : (i32, i32) -> i32
+    // CHECK-NEXT: %[[SEL1:.+]] = emitc.call "vm_select_i32"(%[[EQ1]], %arg5, %arg6) : (i32, i32, i32) -> i32
+    // CHECK-NEXT: %[[C0:.+]] = "emitc.constant"() <{value = 0 : i32}> : () -> i32
+    // CHECK-NEXT: %[[EQ0:.+]] = emitc.call "vm_cmp_eq_i32"(%arg3, %[[C0]]) : (i32, i32) -> i32
+    // CHECK-NEXT: %{{.+}} = emitc.call "vm_select_i32"(%[[EQ0]], %arg4, %[[SEL1]]) : (i32, i32, i32) -> i32
+    %0 = vm.switch.i32 %arg0[%arg1, %arg2] else %arg3 : i32
+    vm.return %0 : i32
+  }
+}
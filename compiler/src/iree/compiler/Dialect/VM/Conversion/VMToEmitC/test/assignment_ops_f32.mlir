@@ -8,3 +8,16 @@ vm.module @my_module {
     vm.return %0 : f32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @my_module_switch_f32
+vm.module @my_module {
+  vm.func @switch_f32(%arg0 : i32, %arg1 : f32, %arg2 : f32) -> f32 {
+    // CHECK: %[[C0:.+]] = "emitc.constant"() <{value = 0 : i32}> : () -> i32
+    // CHECK-NEXT: %[[EQ0:.+]] = emitc.call "vm_cmp_eq_i32"(%arg3, %[[C0]]) : (i32, i32) -> i32
+    // CHECK-NEXT: %{{.+}} = emitc.call "vm_select_f32"(%[[EQ0]], %arg4, %arg5) : (i32, f32, f32) -> f32
+    %0 = vm.switch.f32 %arg0[%arg1] else %arg2 : f32
+    vm.return %0 : f32
+  }
+}
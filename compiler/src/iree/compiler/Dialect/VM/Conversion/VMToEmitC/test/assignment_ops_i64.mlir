@@ -8,3 +8,16 @@ vm.module @my_module {
     vm.return %0 : i64
   }
 }
+
+// -----
+
+// CHECK-LABEL: @my_module_switch_i64
+vm.module @my_module {
+  vm.func @switch_i64(%arg0 : i32, %arg1 : i64, %arg2 : i64) -> i64 {
+    // CHECK: %[[C0:.+]] = "emitc.constant"() <{value = 0 : i32}> : () -> i32
+    // CHECK-NEXT: %[[EQ0:.+]] = emitc.call "vm_cmp_eq_i32"(%arg3, %[[C0]]) : (i32, i32) -> i32
+    // CHECK-NEXT: %{{.+}} = emitc.call "vm_select_i64"(%[[EQ0]], %arg4, %arg5) : (i32, i64, i64) -> i64
+    %0 = vm.switch.i64 %arg0[%arg1] else %arg2 : i64
+    vm.return %0 : i64
+  }
+}
@@ -1265,6 +1265,31 @@ SuccessorOperands CondBranchOp::getSuccessorOperands(unsigned index) {
                             : SuccessorOperands(getFalseDestOperandsMutable());
 }
 
+template <typename T>
+static SuccessorOperands getCompareBranchSuccessorOperands(T op,
+                                                           unsigned index) {
+  assert(index < op->getNumSuccessors() && "invalid successor index");
+  return index == T::trueIndex
+             ? SuccessorOperands(op.getTrueDestOperandsMutable())
+             : SuccessorOperands(op.getFalseDestOperandsMutable());
+}
+
+SuccessorOperands CmpBranchEQI32Op::getSuccessorOperands(unsigned index) {
+  return getCompareBranchSuccessorOperands(*this, index);
+}
+
+SuccessorOperands CmpBranchNEI32Op::getSuccessorOperands(unsigned index) {
+  return getCompareBranchSuccessorOperands(*this, index);
+}
+
+SuccessorOperands CmpBranchLTI32SOp::getSuccessorOperands(unsigned index) {
+  return getCompareBranchSuccessorOperands(*this, index);
+}
+
+SuccessorOperands CmpBranchLTI32UOp::getSuccessorOperands(unsigned index) {
+  return getCompareBranchSuccessorOperands(*this, index);
+}
+
 static ParseResult parseBranchTableCases(
     OpAsmParser &parser, Block *&defaultDestination,
     SmallVectorImpl<OpAsmParser::UnresolvedOperand> &defaultOperands,
@@ -7,6 +7,9 @@
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
@@ -71,6 +74,10 @@ struct RodataRef {
   uint64_t alignment = kDefaultRodataAlignment;
   // Total size of the serialized data in bytes.
   uint64_t totalSize = 0;
+  // Run-length encoded data and its element size if the rodata is compressed.
+  // Shared with the archive file writer when stored externally.
+  std::shared_ptr<std::vector<uint8_t>> compressedData;
+  unsigned compressedElementSize = 0;
   // Optional reference to the rodata in the file.
   std::optional<ArchiveWriter::File> archiveFile;
 };
@@ -127,6 +134,114 @@ serializeEmbeddedData(Location loc, Attribute valueAttr, uint64_t alignment,
   return flatbuffers_uint8_vec_end(fbb);
 }
 
+// Returns the element size used to run-length encode |valueAttr|.
+// Elements of the natural type width find runs that bytes would miss (such as
+// repeated non-zero floats).
+static unsigned getRunLengthElementSize(Attribute valueAttr,
+                                        uint64_t totalSize) {
+  unsigned elementSize = 1;
+  if (auto elementsAttr = llvm::dyn_cast<ElementsAttr>(valueAttr)) {
+    auto elementType = elementsAttr.getElementType();
+    if (elementType.isIntOrFloat()) {
+      unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+      if (bitWidth == 16 || bitWidth == 32 || bitWidth == 64) {
+        elementSize = bitWidth / 8;
+      }
+    }
+  }
+  return totalSize % elementSize == 0 ? elementSize : 1;
+}
+
+// Run-length encodes |data| as a sequence of chunks of |elementSize| elements
+// as described by RunLengthDataDef in bytecode_module_def.fbs.
+static std::vector<uint8_t> encodeRunLength(ArrayRef<uint8_t> data,
+                                            unsigned elementSize) {
+  static constexpr uint32_t kRunBit = 0x80000000u;
+  static constexpr uint64_t kMaxChunkCount = 0x7FFFFFFFu;
+  std::vector<uint8_t> result;
+  auto appendHeader = [&](uint32_t header) {
+    uint8_t bytes[sizeof(uint32_t)];
+    llvm::support::endian::write32le(bytes, header);
+    result.insert(result.end(), bytes, bytes + sizeof(bytes));
+  };
+  const uint8_t *elements = data.data();
+  uint64_t elementCount = data.size() / elementSize;
+  auto isSameElement = [&](uint64_t lhs, uint64_t rhs) {
+    return std::memcmp(elements + lhs * elementSize,
+                       elements + rhs * elementSize, elementSize) == 0;
+  };
+  uint64_t literalStart = 0;
+  auto flushLiteral = [&](uint64_t end) {
+    while (literalStart < end) {
+      uint64_t count = std::min(end - literalStart, kMaxChunkCount);
+      appendHeader(static_cast<uint32_t>(count));
+      result.insert(result.end(), elements + literalStart * elementSize,
+                    elements + (literalStart + count) * elementSize);
+      literalStart += count;
+    }
+  };
+  uint64_t i = 0;
+  while (i < elementCount) {
+    uint64_t runEnd = i + 1;
+    while (runEnd < elementCount && runEnd - i < kMaxChunkCount &&
+           isSameElement(i, runEnd)) {
+      ++runEnd;
+    }
+    // Only emit a run when it is smaller than appending it to a literal; short
+    // runs would otherwise split literals and grow the output.
+    uint64_t runCount = runEnd - i;
+    if (runCount * elementSize >= elementSize + 2 * sizeof(uint32_t)) {
+      flushLiteral(i);
+      appendHeader(kRunBit | static_cast<uint32_t>(runCount));
+      result.insert(result.end(), elements + i * elementSize,
+                    elements + (i + 1) * elementSize);
+      literalStart = runEnd;
+    }
+    i = runEnd;
+  }
+  flushLiteral(elementCount);
+  return result;
+}
+
+// Compresses |rodataRef| in-place if requested and worthwhile.
+static LogicalResult
+compressRodata(IREE::VM::BytecodeTargetOptions bytecodeOptions,
+               IREE::Util::SerializableAttrInterface rodataValue,
+               RodataRef &rodataRef) {
+  // Rodata with a mime type is consumed in its stored form (executables,
+  // user-visible files in the polyglot zip, etc).
+  if (bytecodeOptions.rodataCompression ==
+          IREE::VM::RodataCompression::kNone ||
+      rodataRef.rodataOp.getMimeType().has_value() ||
+      rodataRef.totalSize < 64 || rodataRef.totalSize > SIZE_MAX) {
+    return success();
+  }
+  // Decompressed data is allocated by the runtime with the default alignment.
+  if (rodataRef.alignment > kDefaultRodataAlignment) {
+    return success();
+  }
+  Location loc = rodataRef.rodataOp.getLoc();
+  std::vector<uint8_t> data(static_cast<size_t>(rodataRef.totalSize));
+  if (failed(rodataValue.serializeToBuffer(
+          loc, llvm::endianness::little,
+          ArrayRef<char>(reinterpret_cast<char *>(data.data()),
+                         data.size())))) {
+    return mlir::emitError(loc) << "constant attribute failed to serialize: "
+                                   "unsupported format or encoding";
+  }
+  unsigned elementSize =
+      getRunLengthElementSize(rodataRef.rodataOp.getValue(), data.size());
+  auto compressedData = encodeRunLength(data, elementSize);
+  // Decompression costs a copy at load time; skip it unless it pays off.
+  if (compressedData.size() > data.size() - data.size() / 8) {
+    return success();
+  }
+  rodataRef.compressedData =
+      std::make_shared<std::vector<uint8_t>>(std::move(compressedData));
+  rodataRef.compressedElementSize = elementSize;
+  return success();
+}
+
 // Canonicalizes the module to its final form prior to emission.
 // This verifies that we only have ops we can serialize and performs any of the
 // required transformations (such as debug op stripping).
@@ -182,6 +297,10 @@ canonicalizeModule(IREE::VM::BytecodeTargetOptions bytecodeOptions,
 
   modulePasses.addPass(IREE::Util::createDropCompilerHintsPass());
 
+  if (bytecodeOptions.fuseSuperinstructions) {
+    modulePasses.addPass(IREE::VM::createFuseSuperinstructionsPass());
+  }
+
   // Mark up the module with ordinals for each top-level op (func, etc).
   // This will make it easier to correlate the MLIR textual output to the
   // binary output.
@@ -229,6 +348,28 @@ makeImportFunctionSignatureDef(IREE::VM::ImportOp importOp,
                                     cconv.value(), /*attrsRef=*/0, fbb);
 }
 
+// Returns the serialized string key/value pairs of the `iree.reflection`
+// dictionary on |op|, if any.
+static iree_vm_AttrDef_vec_ref_t
+makeReflectionAttrDefs(Operation *op, FlatbufferBuilder &fbb) {
+  auto attrs = op->getAttrOfType<DictionaryAttr>("iree.reflection");
+  if (!attrs)
+    return 0;
+  SmallVector<iree_vm_AttrDef_ref_t> attrRefs;
+  for (auto attr : attrs) {
+    auto key = attr.getName().strref();
+    auto value = llvm::dyn_cast<StringAttr>(attr.getValue());
+    if (!value || key.empty())
+      continue;
+    // NOTE: if we actually want to keep these we should dedupe them (as the
+    // keys and likely several of the values are shared across all functions).
+    auto valueRef = fbb.createString(value.getValue());
+    auto keyRef = fbb.createString(key);
+    attrRefs.push_back(iree_vm_AttrDef_create(fbb, keyRef, valueRef));
+  }
+  return iree_vm_AttrDef_vec_create(fbb, attrRefs.data(), attrRefs.size());
+}
+
 // Returns a serialized function signature.
 static iree_vm_FunctionSignatureDef_ref_t
 makeFunctionSignatureDef(IREE::VM::FuncOp funcOp,
@@ -240,23 +381,7 @@ makeFunctionSignatureDef(IREE::VM::FuncOp funcOp,
     return {};
 
   // Reflection attributes.
-  iree_vm_AttrDef_vec_ref_t attrsRef = 0;
-  if (auto attrs = funcOp->getAttrOfType<DictionaryAttr>("iree.reflection")) {
-    SmallVector<iree_vm_AttrDef_ref_t> attrRefs;
-    for (auto attr : attrs) {
-      auto key = attr.getName().strref();
-      auto value = llvm::dyn_cast<StringAttr>(attr.getValue());
-      if (!value || key.empty())
-        continue;
-      // NOTE: if we actually want to keep these we should dedupe them (as the
-      // keys and likely several of the values are shared across all functions).
-      auto valueRef = fbb.createString(value.getValue());
-      auto keyRef = fbb.createString(key);
-      attrRefs.push_back(iree_vm_AttrDef_create(fbb, keyRef, valueRef));
-    }
-    attrsRef =
-        iree_vm_AttrDef_vec_create(fbb, attrRefs.data(), attrRefs.size());
-  }
+  auto attrsRef = makeReflectionAttrDefs(funcOp, fbb);
 
   return createFunctionSignatureDef(funcOp.getFunctionType(), typeTable,
                                     cconv.value(), attrsRef, fbb);
@@ -405,9 +530,18 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   // layout planning by preserving the order in the IR is useful.
   SmallVector<iree_vm_RodataSegmentDef_ref_t, 8> rodataSegmentRefs;
   for (auto &rodataRef : llvm::reverse(rodataRefs)) {
+    iree_vm_CompressionTypeDef_union_ref_t compressionTypeRef =
+        iree_vm_CompressionTypeDef_as_NONE();
+    if (rodataRef.compressedData) {
+      compressionTypeRef = iree_vm_CompressionTypeDef_as_RunLengthDataDef(
+          iree_vm_RunLengthDataDef_create(
+              fbb, static_cast<uint8_t>(rodataRef.compressedElementSize),
+              rodataRef.totalSize));
+    }
     if (rodataRef.archiveFile.has_value()) {
       // Data is already in the file at a calculated offset.
       iree_vm_RodataSegmentDef_start(fbb);
+      iree_vm_RodataSegmentDef_compression_type_add(fbb, compressionTypeRef);
       iree_vm_RodataSegmentDef_external_data_offset_add(
           fbb, rodataRef.archiveFile->relativeOffset +
                    rodataRef.archiveFile->prefixLength);
@@ -416,12 +550,21 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
       rodataSegmentRefs.push_back(iree_vm_RodataSegmentDef_end(fbb));
     } else {
       // Serialize the embedded data first so that we can reference it.
-      flatbuffers_uint8_vec_ref_t embeddedRef = serializeEmbeddedData(
-          rodataRef.rodataOp.getLoc(), rodataRef.rodataOp.getValue(),
-          rodataRef.alignment, rodataRef.totalSize, fbb);
+      // Compressed data is decompressed into its own allocation at runtime and
+      // needs no alignment in the FlatBuffer.
+      flatbuffers_uint8_vec_ref_t embeddedRef =
+          rodataRef.compressedData
+              ? flatbuffers_uint8_vec_create(fbb,
+                                             rodataRef.compressedData->data(),
+                                             rodataRef.compressedData->size())
+              : serializeEmbeddedData(rodataRef.rodataOp.getLoc(),
+                                      rodataRef.rodataOp.getValue(),
+                                      rodataRef.alignment, rodataRef.totalSize,
+                                      fbb);
       if (!embeddedRef)
         return failure();
       iree_vm_RodataSegmentDef_start(fbb);
+      iree_vm_RodataSegmentDef_compression_type_add(fbb, compressionTypeRef);
       iree_vm_RodataSegmentDef_embedded_data_add(fbb, embeddedRef);
       rodataSegmentRefs.push_back(iree_vm_RodataSegmentDef_end(fbb));
     }
@@ -522,6 +665,7 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
 
   auto moduleNameRef = fbb.createString(
       moduleOp.getSymName().empty() ? "module" : moduleOp.getSymName());
+  auto moduleAttrsRef = makeReflectionAttrDefs(moduleOp, fbb);
 
   // TODO(benvanik): let moduleRequirements be a subset of function requirements
   // so that we can multi-version. For now the moduleRequirements will be the OR
@@ -541,7 +685,7 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   iree_vm_BytecodeModuleDef_version_add(fbb,
                                         moduleOp.getVersion().value_or(0u));
   iree_vm_BytecodeModuleDef_requirements_add(fbb, moduleRequirements);
-  // TODO(benvanik): iree_vm_BytecodeModuleDef_attrs_add
+  iree_vm_BytecodeModuleDef_attrs_add(fbb, moduleAttrsRef);
   iree_vm_BytecodeModuleDef_types_add(fbb, typesRef);
   iree_vm_BytecodeModuleDef_dependencies_add(fbb, dependenciesRef);
   iree_vm_BytecodeModuleDef_imported_functions_add(fbb, importFuncsRef);
@@ -658,17 +802,30 @@ translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
     rodataRef.alignment =
         rodataOp.getAlignment().value_or(kDefaultRodataAlignment);
     rodataRef.totalSize = static_cast<uint64_t>(actualSize);
+    if (failed(compressRodata(bytecodeOptions, rodataValue, rodataRef))) {
+      return failure();
+    }
     if (storeExternal) {
       std::string fileName =
           (rodataOp.getName() +
            mimeTypeToFileExtension(rodataOp.getMimeType().value_or("")))
               .str();
-      rodataRef.archiveFile = archiveWriter->declareFile(
-          fileName, rodataRef.alignment, rodataRef.totalSize,
-          [=](llvm::raw_ostream &os) {
-            return rodataValue.serializeToStream(rodataLoc,
-                                                 llvm::endianness::little, os);
-          });
+      if (auto compressedData = rodataRef.compressedData) {
+        rodataRef.archiveFile = archiveWriter->declareFile(
+            fileName, rodataRef.alignment, compressedData->size(),
+            [=](llvm::raw_ostream &os) {
+              os.write(reinterpret_cast<const char *>(compressedData->data()),
+                       compressedData->size());
+              return success();
+            });
+      } else {
+        rodataRef.archiveFile = archiveWriter->declareFile(
+            fileName, rodataRef.alignment, rodataRef.totalSize,
+            [=](llvm::raw_ostream &os) {
+              return rodataValue.serializeToStream(
+                  rodataLoc, llvm::endianness::little, os);
+            });
+      }
     }
     rodataRefs[rodataOp.getOrdinal()->getLimitedValue()] = rodataRef;
   }
@@ -727,6 +884,11 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::cat(vmBytecodeOptionsCategory),
       llvm::cl::desc("Optimizes the VM module with CSE/inlining/etc prior to "
                      "serialization"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-fuse-superinstructions", fuseSuperinstructions,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Fuses common op sequences such as compare-and-branch "
+                     "into single bytecode superinstructions"));
   binder.opt<std::string>(
       "iree-vm-bytecode-source-listing", sourceListing,
       llvm::cl::cat(vmBytecodeOptionsCategory),
@@ -738,6 +900,16 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-vm-bytecode-module-strip-debug-ops", stripDebugOps,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips debug-only ops from the module"));
+  binder.opt<RodataCompression>(
+      "iree-vm-bytecode-module-rodata-compression", rodataCompression,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Compression applied to rodata segments without a mime "
+                     "type; decompressed by the runtime on module load"),
+      llvm::cl::values(
+          clEnumValN(RodataCompression::kNone, "none",
+                     "Rodata is stored uncompressed"),
+          clEnumValN(RodataCompression::kRunLength, "rle",
+                     "Run-length encodes rodata when it shrinks the data")));
   binder.opt<bool>(
       "iree-vm-emit-polyglot-zip", emitPolyglotZip,
       llvm::cl::cat(vmBytecodeOptionsCategory),
@@ -33,6 +33,15 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Defines how rodata segments are compressed in the bytecode module.
+enum class RodataCompression {
+  // Rodata is stored verbatim and referenced in-place at runtime.
+  kNone,
+  // Rodata is run-length encoded by element when it shrinks the data and
+  // decompressed by the runtime when the module is loaded.
+  kRunLength,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -41,6 +50,10 @@ struct BytecodeTargetOptions {
   // Run basic CSE/inlining/etc passes prior to serialization.
   bool optimize = true;
 
+  // Fuse common op sequences into superinstructions that decode and dispatch
+  // as a single bytecode op.
+  bool fuseSuperinstructions = true;
+
   // Dump a VM MLIR file and annotate source locations with it.
   // This allows for the runtime to serve stack traces referencing both the
   // original source locations and the VM IR.
@@ -57,6 +70,10 @@ struct BytecodeTargetOptions {
   // should be disabled in release builds.
   bool emitPolyglotZip = true;
 
+  // Compression applied to rodata without a mime type. Compressed rodata is
+  // smaller on disk but costs memory and time to decompress when loaded.
+  RodataCompression rodataCompression = RodataCompression::kNone;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<BytecodeTargetOptions>;
 };
@@ -151,6 +151,15 @@ vm.module @constants {
   // CHECK-NEXT: ]
   vm.rodata private @elided_f32 dense_resource<__elided__> : tensor<3xf32>
 
+  // Tests that dense resources are serialized from their blob contents.
+  //      CHECK: "embedded_data": [
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   2,
+  // CHECK-NEXT:   0
+  // CHECK-NEXT: ]
+  vm.rodata private @resource_i16 dense_resource<resource_i16> : tensor<2xi16>
+
   // Tests #util.byte_pattern on sub-byte types.
   //      CHECK: "embedded_data": [
   // CHECK-NEXT:   1,
@@ -159,3 +168,11 @@ vm.module @constants {
   // CHECK-NEXT: ]
   vm.rodata private @byte_pattern_i2 #util.byte_pattern<1> : tensor<9xi2>
 }
+
+{-#
+  dialect_resources: {
+    builtin: {
+      resource_i16: "0x0200000001000200"
+    }
+  }
+#-}
@@ -16,3 +16,14 @@ vm.module @simple_module {
     vm.return %arg0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: module_attrs
+// CHECK: "attrs":
+// CHECK:   "key": "hal.device.targets"
+// CHECK:   "value": "vulkan,llvm-cpu"
+vm.module @module_attrs attributes {
+  iree.reflection = {"hal.device.targets" = "vulkan,llvm-cpu"}
+} {
+}
@@ -0,0 +1,48 @@
+// RUN: iree-compile --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-rodata-compression=rle \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-text %s | FileCheck %s
+
+// CHECK: "name": "rodata_compression"
+vm.module @rodata_compression {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+
+  // CHECK: "rodata_segments": [{
+
+  // Tests that splats are encoded as a single run of f32 elements.
+  //      CHECK: "compression_type_type": "RunLengthDataDef",
+  // CHECK-NEXT: "compression_type": {
+  // CHECK-NEXT:   "element_size": 4,
+  // CHECK-NEXT:   "decompressed_length": 256
+  // CHECK-NEXT: },
+  // CHECK-NEXT: "embedded_data": [
+  // CHECK-NEXT:   64,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   128,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   128,
+  // CHECK-NEXT:   63
+  // CHECK-NEXT: ]
+  vm.rodata private @splat_f32 dense<1.0> : tensor<64xf32>
+
+  // Tests that data smaller than the compression threshold is left as-is.
+  //      CHECK: }, {
+  // CHECK-NOT: "compression_type_type"
+  //      CHECK: "embedded_data": [
+  // CHECK-NEXT:   7,
+  // CHECK-NEXT:   7,
+  // CHECK-NEXT:   7,
+  // CHECK-NEXT:   7
+  // CHECK-NEXT: ]
+  vm.rodata private @small_i8 dense<7> : tensor<4xi8>
+
+  // Tests that data with a mime type is never compressed.
+  //      CHECK: }, {
+  // CHECK-NOT: "compression_type_type"
+  //      CHECK: "embedded_data": [
+  vm.rodata private @mime_i8 {mime_type = "text/plain"} dense<0> : tensor<128xi8>
+}
@@ -0,0 +1,20 @@
+// RUN: iree-compile \
+// RUN:   --output-format=vm-c \
+// RUN:   --iree-execution-model=inline-static \
+// RUN:   --iree-hal-target-backends=vmvx-inline %s | FileCheck %s
+
+// Tests that a program compiled with the inline-static execution model lowers
+// entirely to C: executables are inlined into the host program and the only
+// runtime dependencies are the inline HAL and VMVX modules.
+
+func.func @simple_mul(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> tensor<4xf32> {
+  %0 = arith.mulf %arg0, %arg1 : tensor<4xf32>
+  return %0 : tensor<4xf32>
+}
+
+// CHECK: module_imports_[]
+// CHECK-NOT: {"hal.
+// CHECK: {"hal_inline.
+// CHECK-NOT: {"hal.
+// CHECK: module_exports_[]
+// CHECK-NEXT: {{.+}}"simple_mul"
@@ -0,0 +1,130 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+namespace {
+
+// Replaces |condBranchOp| with a compare-and-branch superinstruction of type
+// T using the operands of |cmpOp|.
+template <typename T>
+void replaceWithCompareBranch(Operation *cmpOp, CondBranchOp condBranchOp) {
+  OpBuilder builder(condBranchOp);
+  builder.create<T>(
+      builder.getFusedLoc({cmpOp->getLoc(), condBranchOp.getLoc()}),
+      cmpOp->getOperand(0), cmpOp->getOperand(1),
+      condBranchOp.getTrueDestOperands(), condBranchOp.getFalseDestOperands(),
+      condBranchOp.getTrueDest(), condBranchOp.getFalseDest());
+  condBranchOp.erase();
+  cmpOp->erase();
+}
+
+// Fuses a vm.cmp.* whose only use is the condition of the vm.cond_br
+// terminating its block into a vm.cmp_br.*.
+bool fuseCompareBranch(CondBranchOp condBranchOp) {
+  Operation *cmpOp = condBranchOp.getCondition().getDefiningOp();
+  if (!cmpOp || cmpOp->getBlock() != condBranchOp->getBlock() ||
+      !cmpOp->hasOneUse()) {
+    return false;
+  }
+  // The compare operands are read when the branch executes so other ops
+  // are allowed to sit between the two.
+  return TypeSwitch<Operation *, bool>(cmpOp)
+      .Case([&](CmpEQI32Op op) {
+        replaceWithCompareBranch<CmpBranchEQI32Op>(op, condBranchOp);
+        return true;
+      })
+      .Case([&](CmpNEI32Op op) {
+        replaceWithCompareBranch<CmpBranchNEI32Op>(op, condBranchOp);
+        return true;
+      })
+      .Case([&](CmpLTI32SOp op) {
+        replaceWithCompareBranch<CmpBranchLTI32SOp>(op, condBranchOp);
+        return true;
+      })
+      .Case([&](CmpLTI32UOp op) {
+        replaceWithCompareBranch<CmpBranchLTI32UOp>(op, condBranchOp);
+        return true;
+      })
+      .Default([](Operation *) { return false; });
+}
+
+// Fuses a vm.add.i32 with a vm.const.i32 operand into a vm.add.imm.i32.
+// The constant is erased if this was its last use.
+bool fuseAddImmediate(AddI32Op addOp) {
+  Value operand;
+  ConstI32Op constOp;
+  if ((constOp = addOp.getRhs().getDefiningOp<ConstI32Op>())) {
+    operand = addOp.getLhs();
+  } else if ((constOp = addOp.getLhs().getDefiningOp<ConstI32Op>())) {
+    operand = addOp.getRhs();
+  } else {
+    return false;
+  }
+  OpBuilder builder(addOp);
+  auto addImmOp = builder.create<AddImmI32Op>(
+      addOp.getLoc(), addOp.getType(), operand, constOp.getValue());
+  addOp.replaceAllUsesWith(addImmOp.getResult());
+  addOp.erase();
+  if (constOp.use_empty()) {
+    constOp.erase();
+  }
+  return true;
+}
+
+} // namespace
+
+class FuseSuperinstructionsPass
+    : public PassWrapper<FuseSuperinstructionsPass,
+                         OperationPass<IREE::VM::ModuleOp>> {
+public:
+  StringRef getArgument() const override {
+    return "iree-vm-fuse-superinstructions";
+  }
+
+  StringRef getDescription() const override {
+    return "Fuses common bytecode op sequences into superinstructions.";
+  }
+
+  void runOnOperation() override {
+    for (auto funcOp : getOperation().getOps<FuncOp>()) {
+      for (auto &block : funcOp.getBlocks()) {
+        for (auto addOp :
+             llvm::make_early_inc_range(block.getOps<AddI32Op>())) {
+          fuseAddImmediate(addOp);
+        }
+        if (auto condBranchOp =
+                dyn_cast<CondBranchOp>(block.getTerminator())) {
+          fuseCompareBranch(condBranchOp);
+        }
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createFuseSuperinstructionsPass() {
+  return std::make_unique<FuseSuperinstructionsPass>();
+}
+
+static PassRegistration<FuseSuperinstructionsPass> pass;
+
+} // namespace VM
+} // namespace IREE
+} // namespace iree_compiler
+} // namespace mlir
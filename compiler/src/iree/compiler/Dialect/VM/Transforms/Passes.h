@@ -89,6 +89,12 @@ createDropEmptyModuleInitializersPass();
 // number of live registers at the cost of additional storage requirements.
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>> createSinkDefiningOpsPass();
 
+// Fuses common op sequences such as compare-and-branch into superinstructions
+// that the bytecode interpreter decodes and dispatches as a single op.
+// Only valid when targeting bytecode.
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createFuseSuperinstructionsPass();
+
 //===----------------------------------------------------------------------===//
 // Test passes
 //===----------------------------------------------------------------------===//
@@ -111,6 +117,7 @@ inline void registerVMPasses() {
   createOrdinalAllocationPass();
   createResolveRodataLoadsPass();
   createSinkDefiningOpsPass();
+  createFuseSuperinstructionsPass();
 }
 
 inline void registerVMTestPasses() {
@@ -0,0 +1,66 @@
+// RUN: iree-opt --split-input-file --iree-vm-fuse-superinstructions %s | FileCheck %s
+
+vm.module @module {
+  // CHECK-LABEL: @loop
+  vm.func @loop(%count : i32) -> i32 {
+    // CHECK-NOT: vm.const.i32 1
+    %c1 = vm.const.i32 1
+    %i0 = vm.const.i32.zero
+    vm.br ^loop(%i0 : i32)
+  // CHECK: ^bb1(%[[I:.+]]: i32):
+  ^loop(%i : i32):
+    // CHECK-NEXT: %[[IN:.+]] = vm.add.imm.i32 %[[I]], 1 : i32
+    %in = vm.add.i32 %i, %c1 : i32
+    // CHECK-NEXT: vm.cmp_br.lt.i32.s %[[IN]], %arg0 : i32, ^bb1(%[[IN]] : i32), ^bb2(%[[IN]] : i32)
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.return %ie : i32
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: @shared_constant
+  vm.func @shared_constant(%arg0 : i32) -> (i32, i32) {
+    // CHECK: %[[C4:.+]] = vm.const.i32 4
+    %c4 = vm.const.i32 4
+    // CHECK-NEXT: %[[ADD:.+]] = vm.add.imm.i32 %arg0, 4 : i32
+    %0 = vm.add.i32 %c4, %arg0 : i32
+    // CHECK-NEXT: vm.return %[[ADD]], %[[C4]]
+    vm.return %0, %c4 : i32, i32
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: @multiple_condition_uses
+  vm.func @multiple_condition_uses(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: %[[CMP:.+]] = vm.cmp.eq.i32 %arg0, %arg1 : i32
+    %cmp = vm.cmp.eq.i32 %arg0, %arg1 : i32
+    // CHECK-NEXT: vm.cond_br %[[CMP]]
+    vm.cond_br %cmp, ^bb1(%cmp : i32), ^bb1(%arg0 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: @unsupported_predicate
+  vm.func @unsupported_predicate(%arg0 : i64, %arg1 : i64) -> i32 {
+    // CHECK: %[[CMP:.+]] = vm.cmp.lt.i64.u %arg0, %arg1 : i64
+    %cmp = vm.cmp.lt.i64.u %arg0, %arg1 : i64
+    // CHECK-NEXT: vm.cond_br %[[CMP]]
+    vm.cond_br %cmp, ^bb1, ^bb2
+  ^bb1:
+    %c1 = vm.const.i32 1
+    vm.return %c1 : i32
+  ^bb2:
+    %c0 = vm.const.i32.zero
+    vm.return %c0 : i32
+  }
+}
@@ -193,7 +193,8 @@ void getExtensions(const TargetTriple &triple,
 
   llvm::append_range(extensions, desktop);
   if (getVendor(triple) == spirv::Vendor::NVIDIA ||
-      triple.getArch() == TargetTripleArch::AMD_RDNAv3) {
+      triple.getArch() == TargetTripleArch::AMD_RDNAv3 ||
+      triple.getArch() == TargetTripleArch::Intel_Arc) {
     extensions.push_back(Extension::VK_KHR_cooperative_matrix);
   }
 }
@@ -446,7 +447,7 @@ CapabilitiesAttr getCapabilities(const TargetTriple &triple,
 
     variablePointers = variablePointersStorageBuffer = true;
     break;
-  case TargetTripleArch::Intel_Arc:
+  case TargetTripleArch::Intel_Arc: {
     // Example: https://vulkan.gpuinfo.org/displayreport.php?id=19818
     maxComputeSharedMemorySize = 32768;
     maxComputeWorkGroupInvocations = 1024;
@@ -472,7 +473,31 @@ CapabilitiesAttr getCapabilities(const TargetTriple &triple,
     uniformAndStorageBuffer8BitAccess = true;
 
     variablePointers = variablePointersStorageBuffer = true;
-    break;
+
+    auto i8t = builder.getIntegerType(8);
+    auto i32t = builder.getIntegerType(32);
+    auto f16t = builder.getF16Type();
+    auto f32t = builder.getF32Type();
+    auto scope = ScopeKHRAttr::get(context, ScopeKHR::Subgroup);
+
+    // Note: the driver also advertises unsigned integer variants, which can be
+    // declared when needed.
+    coopmatCases.push_back(CooperativeMatrixPropertiesKHRAttr::get(
+        context,
+        /*mSize=*/8, /*nSize=*/8, /*kSize=*/32, /*aType=*/i8t,
+        /*bType=*/i8t, /*cType=*/i32t, /*resultType=*/i32t, /*accSat=*/false,
+        /*scope=*/scope));
+    coopmatCases.push_back(CooperativeMatrixPropertiesKHRAttr::get(
+        context,
+        /*mSize=*/8, /*nSize=*/8, /*kSize=*/16, /*aType=*/f16t,
+        /*bType=*/f16t, /*cType=*/f16t, /*resultType=*/f16t, /*accSat=*/false,
+        /*scope=*/scope));
+    coopmatCases.push_back(CooperativeMatrixPropertiesKHRAttr::get(
+        context,
+        /*mSize=*/8, /*nSize=*/8, /*kSize=*/16, /*aType=*/f16t,
+        /*bType=*/f16t, /*cType=*/f32t, /*resultType=*/f32t, /*accSat=*/false,
+        /*scope=*/scope));
+  } break;
   case TargetTripleArch::Unknown:
     // Use the largest subgroup size we can find across various vendors.
     subgroupSize = 64;
@@ -0,0 +1,77 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
+#include "iree-dialects/Dialect/LinalgExt/Passes/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace GlobalOptimization {
+
+/// Returns true if all the executable targets of all devices in the module are
+/// handled by the llvm-cpu backend.
+static bool hasOnlyLLVMCPUTargets(ModuleOp moduleOp) {
+  auto targetsAttr = moduleOp->getAttrOfType<ArrayAttr>("hal.device.targets");
+  if (!targetsAttr || targetsAttr.empty())
+    return false;
+  for (auto attr : targetsAttr) {
+    auto deviceTarget = dyn_cast<IREE::HAL::DeviceTargetAttr>(attr);
+    if (!deviceTarget)
+      return false;
+    SmallVector<IREE::HAL::ExecutableTargetAttr> executableTargets =
+        deviceTarget.getExecutableTargets();
+    if (executableTargets.empty())
+      return false;
+    for (auto executableTarget : executableTargets) {
+      if (executableTarget.getBackend() != "llvm-cpu")
+        return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+class ConvertConv2DToWinogradPass
+    : public ConvertConv2DToWinogradBase<ConvertConv2DToWinogradPass> {
+public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect,
+                    IREE::LinalgExt::IREELinalgExtDialect>();
+  }
+
+  void runOnOperation() override {
+    // Not all backends can lower the winograd transform ops (e.g., LLVMGPU),
+    // so only convert when every executable target is a CPU.
+    ModuleOp moduleOp = getOperation();
+    if (!hasOnlyLLVMCPUTargets(moduleOp))
+      return;
+
+    // Filters are required to be constant and their transform is folded at
+    // compile time, so only the input and output transforms remain at runtime.
+    OpPassManager passManager(moduleOp.getOperationName());
+    passManager.addNestedPass<func::FuncOp>(
+        IREE::LinalgExt::createConvertConv2DToWinogradPass());
+    if (failed(runPipeline(passManager, moduleOp))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>> createConvertConv2DToWinogradPass() {
+  return std::make_unique<ConvertConv2DToWinogradPass>();
+}
+
+} // namespace GlobalOptimization
+} // namespace iree_compiler
+} // namespace mlir
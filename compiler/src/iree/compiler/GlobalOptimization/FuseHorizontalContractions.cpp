@@ -0,0 +1,270 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--------------- FuseHorizontalContractions.cpp ----------------------===//
+// Fuses independent contractions that share their LHS and have constant RHS
+// (e.g. the Q/K/V projections of an attention layer) into a single contraction
+// over the concatenated RHS, so that they form a single dispatch with a larger
+// workgroup space instead of several small ones. The concatenation of the RHS
+// is a constant expression and gets hoisted and evaluated at compile time.
+//===---------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/Util/Analysis/Constant/ConstExpr.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Analysis/SliceAnalysis.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#define DEBUG_TYPE "iree-global-opt-fuse-horizontal-contractions"
+
+namespace mlir {
+namespace iree_compiler {
+namespace GlobalOptimization {
+
+namespace {
+
+/// Returns true if `op` is a contraction that this pass can fuse, i.e. a named
+/// op with static shapes whose N dimension is the innermost dimension of both
+/// the RHS and the result, and whose init is a `linalg.fill`.
+static bool isFusableContraction(linalg::LinalgOp op) {
+  if (!isa<linalg::MatmulOp, linalg::VecmatOp, linalg::BatchMatmulOp,
+           linalg::BatchVecmatOp>(op.getOperation())) {
+    return false;
+  }
+  if (!op.hasTensorSemantics() || op.hasDynamicShape())
+    return false;
+  return op.getDpsInitOperand(0)->get().getDefiningOp<linalg::FillOp>() !=
+         nullptr;
+}
+
+/// Key identifying contractions that can be fused together: same op, same
+/// LHS, same RHS shape up to the N dimension, same element types and same
+/// fill value.
+struct ContractionKey {
+  OperationName opName;
+  Value lhs;
+  Value fillValue;
+  SmallVector<int64_t> rhsOuterShape;
+  Type rhsElementType;
+  Type resultElementType;
+
+  bool operator==(const ContractionKey &other) const {
+    return opName == other.opName && lhs == other.lhs &&
+           fillValue == other.fillValue &&
+           rhsOuterShape == other.rhsOuterShape &&
+           rhsElementType == other.rhsElementType &&
+           resultElementType == other.resultElementType;
+  }
+};
+
+static ContractionKey getContractionKey(linalg::LinalgOp op) {
+  auto rhsType = cast<RankedTensorType>(op.getDpsInputs()[1].getType());
+  auto resultType = cast<RankedTensorType>(op->getResult(0).getType());
+  auto fillOp = op.getDpsInitOperand(0)->get().getDefiningOp<linalg::FillOp>();
+  return ContractionKey{op->getName(),
+                        op.getDpsInputs()[0],
+                        fillOp.getDpsInputs()[0],
+                        llvm::to_vector(rhsType.getShape().drop_back()),
+                        rhsType.getElementType(),
+                        resultType.getElementType()};
+}
+
+/// Moves the operations in the same block that `value` depends on, and that
+/// are after `insertionPoint`, before `insertionPoint`. Returns failure (and
+/// moves nothing) if that is not possible without reordering side effects.
+static LogicalResult moveDefiningOpsBefore(Value value,
+                                           Operation *insertionPoint,
+                                           DominanceInfo &dominanceInfo) {
+  if (dominanceInfo.properlyDominates(value, insertionPoint))
+    return success();
+  Operation *definingOp = value.getDefiningOp();
+  if (!definingOp || definingOp->getBlock() != insertionPoint->getBlock())
+    return failure();
+
+  Block *block = insertionPoint->getBlock();
+  BackwardSliceOptions options;
+  options.inclusive = true;
+  options.filter = [&](Operation *op) {
+    return op->getBlock() == block && insertionPoint->isBeforeInBlock(op);
+  };
+  SetVector<Operation *> slice;
+  getBackwardSlice(definingOp, &slice, options);
+  // Loads of immutable globals are memory effect free too.
+  if (!llvm::all_of(slice,
+                    [](Operation *op) { return isMemoryEffectFree(op); })) {
+    return failure();
+  }
+  // The slice is topologically sorted.
+  for (Operation *op : slice) {
+    op->moveBefore(insertionPoint);
+  }
+  return success();
+}
+
+/// Concatenates `values` along their innermost dimension.
+static Value concatenateInnermost(RewriterBase &rewriter, Location loc,
+                                  ArrayRef<Value> values) {
+  auto firstType = cast<RankedTensorType>(values.front().getType());
+  SmallVector<int64_t> shape(firstType.getShape());
+  shape.back() = 0;
+  for (Value value : values) {
+    shape.back() += cast<RankedTensorType>(value.getType()).getShape().back();
+  }
+  Value result = rewriter.create<tensor::EmptyOp>(loc, shape,
+                                                  firstType.getElementType());
+  int64_t rank = shape.size();
+  int64_t offset = 0;
+  for (Value value : values) {
+    auto type = cast<RankedTensorType>(value.getType());
+    SmallVector<OpFoldResult> offsets(rank, rewriter.getIndexAttr(0));
+    offsets.back() = rewriter.getIndexAttr(offset);
+    SmallVector<OpFoldResult> sizes = llvm::to_vector(llvm::map_range(
+        type.getShape(),
+        [&](int64_t size) -> OpFoldResult {
+          return rewriter.getIndexAttr(size);
+        }));
+    SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+    result = rewriter.create<tensor::InsertSliceOp>(loc, value, result, offsets,
+                                                    sizes, strides);
+    offset += type.getShape().back();
+  }
+  return result;
+}
+
+/// Replaces `ops`, which all have the same contraction key, by a single
+/// contraction on the concatenation of their RHS, followed by slices of the
+/// result.
+static LogicalResult fuseContractions(RewriterBase &rewriter,
+                                      ArrayRef<linalg::LinalgOp> ops,
+                                      DominanceInfo &dominanceInfo) {
+  linalg::LinalgOp firstOp = ops.front();
+  for (linalg::LinalgOp op : ops.drop_front()) {
+    if (failed(moveDefiningOpsBefore(op.getDpsInputs()[1], firstOp,
+                                     dominanceInfo))) {
+      return failure();
+    }
+  }
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(firstOp);
+  Location loc = rewriter.getFusedLoc(llvm::to_vector(
+      llvm::map_range(ops, [](linalg::LinalgOp op) { return op.getLoc(); })));
+  SmallVector<Value> rhsValues = llvm::to_vector(llvm::map_range(
+      ops, [](linalg::LinalgOp op) { return op.getDpsInputs()[1]; }));
+  Value rhs = concatenateInnermost(rewriter, loc, rhsValues);
+
+  auto firstResultType =
+      cast<RankedTensorType>(firstOp->getResult(0).getType());
+  SmallVector<int64_t> resultShape(firstResultType.getShape());
+  resultShape.back() = 0;
+  for (linalg::LinalgOp op : ops) {
+    resultShape.back() +=
+        cast<RankedTensorType>(op->getResult(0).getType()).getShape().back();
+  }
+  auto fillOp =
+      firstOp.getDpsInitOperand(0)->get().getDefiningOp<linalg::FillOp>();
+  Value init = rewriter.create<tensor::EmptyOp>(
+      loc, resultShape, firstResultType.getElementType());
+  init = rewriter.create<linalg::FillOp>(loc, fillOp.getDpsInputs()[0], init)
+             ->getResult(0);
+  Operation *fusedOp = mlir::clone(rewriter, firstOp, {init.getType()},
+                                   {firstOp.getDpsInputs()[0], rhs, init});
+
+  int64_t rank = resultShape.size();
+  int64_t offset = 0;
+  for (linalg::LinalgOp op : ops) {
+    auto resultType = cast<RankedTensorType>(op->getResult(0).getType());
+    SmallVector<OpFoldResult> offsets(rank, rewriter.getIndexAttr(0));
+    offsets.back() = rewriter.getIndexAttr(offset);
+    SmallVector<OpFoldResult> sizes = llvm::to_vector(llvm::map_range(
+        resultType.getShape(),
+        [&](int64_t size) -> OpFoldResult {
+          return rewriter.getIndexAttr(size);
+        }));
+    SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+    Value slice = rewriter.create<tensor::ExtractSliceOp>(
+        op.getLoc(), resultType, fusedOp->getResult(0), offsets, sizes,
+        strides);
+    rewriter.replaceOp(op, slice);
+    offset += resultType.getShape().back();
+  }
+  return success();
+}
+
+struct FuseHorizontalContractionsPass
+    : public FuseHorizontalContractionsBase<FuseHorizontalContractionsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect, tensor::TensorDialect>();
+  }
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void FuseHorizontalContractionsPass::runOnOperation() {
+  ModuleOp moduleOp = getOperation();
+  // Group the candidates before modifying anything as rewriting invalidates
+  // the analysis.
+  SmallVector<SmallVector<linalg::LinalgOp>> groups;
+  {
+    ConstExprAnalysis constExprs(moduleOp);
+    auto isConstant = [&](Value value) {
+      const ConstExprAnalysis::ConstValueInfo *info = constExprs.lookup(value);
+      return info &&
+             info->state == ConstExprAnalysis::ConstValueInfo::CONSTANT;
+    };
+    moduleOp.walk([&](Block *block) {
+      SmallVector<std::pair<ContractionKey, SmallVector<linalg::LinalgOp>>>
+          blockGroups;
+      for (Operation &op : *block) {
+        auto linalgOp = dyn_cast<linalg::LinalgOp>(&op);
+        if (!linalgOp || !isFusableContraction(linalgOp))
+          continue;
+        // If the LHS is constant too, the whole contraction gets hoisted.
+        if (isConstant(linalgOp.getDpsInputs()[0]) ||
+            !isConstant(linalgOp.getDpsInputs()[1])) {
+          continue;
+        }
+        ContractionKey key = getContractionKey(linalgOp);
+        auto it = llvm::find_if(blockGroups,
+                                [&](auto &group) { return group.first == key; });
+        if (it == blockGroups.end()) {
+          blockGroups.push_back({key, {linalgOp}});
+        } else {
+          it->second.push_back(linalgOp);
+        }
+      }
+      for (auto &group : blockGroups) {
+        if (group.second.size() > 1)
+          groups.push_back(std::move(group.second));
+      }
+    });
+  }
+
+  IRRewriter rewriter(&getContext());
+  DominanceInfo dominanceInfo(moduleOp);
+  for (ArrayRef<linalg::LinalgOp> group : groups) {
+    LLVM_DEBUG(llvm::dbgs() << "fusing " << group.size() << " contractions\n");
+    if (failed(fuseContractions(rewriter, group, dominanceInfo))) {
+      LLVM_DEBUG(llvm::dbgs() << "failed to move RHS producers\n");
+    }
+  }
+}
+
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createFuseHorizontalContractionsPass() {
+  return std::make_unique<FuseHorizontalContractionsPass>();
+}
+
+} // namespace GlobalOptimization
+} // namespace iree_compiler
+} // namespace mlir
@@ -58,6 +58,9 @@ public:
         createCPUMaterializeUpperBoundTileSizePass(executableTargets));
     passManager.addNestedPass<func::FuncOp>(
         createCPUMaterializeEncodingPass(executableTarget));
+    // Split the reduction of mmt4d ops with small parallel dimensions before
+    // const-eval, so that the relayout of constant RHS operands is hoisted.
+    passManager.addNestedPass<func::FuncOp>(createCPUSplitMmt4dReductionPass());
 
     if (failed(runPipeline(passManager, moduleOp))) {
       return signalPassFailure();
@@ -50,6 +50,9 @@ void buildGlobalOptimizationPassPipeline(
       .addPass(mlir::createLinalgNamedOpConversionPass)
       .addPass(createConvert1X1FilterConv2DToMatmulPass);
   mainPassManager.addPass(createEraseUnusedLinalgOperands());
+  if (transformOptions.options.winogradConv) {
+    mainPassManager.addPass(createConvertConv2DToWinogradPass());
+  }
 
   // Expand tensor shapes into SSA values and optimize the whole program.
   // The more we are able to equate shape dimensions at this level the
@@ -67,7 +70,16 @@ void buildGlobalOptimizationPassPipeline(
       // this pass both before unit dim folding + consteval, as well as after.
       .addPass(IREE::Flow::createRaiseSpecialOps)
       .addPass(IREE::Flow::createFoldUnitExtentDimsPass)
-      .addPass(IREE::Flow::createFuseDequantizationMatmulPass)
+      .addPredicatedPass(transformOptions.options.raiseQDQMatmul,
+                         createRaiseQDQMatmulPass)
+      .addPass(IREE::Flow::createFuseDequantizationMatmulPass);
+  // Fuse independent contractions with constant RHS before encodings are set,
+  // so that the concatenated RHS gets hoisted and packed at compile time.
+  if (transformOptions.options.horizontalContractionFusion &&
+      transformOptions.options.constExprHoisting) {
+    mainPassManager.addPass(createFuseHorizontalContractionsPass());
+  }
+  FunctionLikeNest(mainPassManager)
       // Expand all vectors in vecmat/matvec ops into matrices for tiling.
       .addPredicatedPass(transformOptions.options.dataTiling,
                          createExpandVectorsPass)
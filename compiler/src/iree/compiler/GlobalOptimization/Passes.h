@@ -46,6 +46,11 @@ void buildGlobalOptimizationPassPipeline(
 // linalg.matmul
 std::unique_ptr<Pass> createConvert1X1FilterConv2DToMatmulPass();
 
+// Converts 3x3 convolutions with constant filters into winograd input/output
+// transforms around a batch_matmul if all executable targets are llvm-cpu.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createConvertConv2DToWinogradPass();
+
 // Create a pass to detach elementwise ops from named Linalg ops.
 std::unique_ptr<Pass> createDetachElementwiseFromNamedOpsPass();
 
@@ -58,11 +63,20 @@ createEraseUnusedLinalgOperands();
 // forms.
 std::unique_ptr<Pass> createExpandVectorsPass();
 
+// Fuses contractions that share their LHS and have constant RHS into a single
+// contraction on the concatenated RHS.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createFuseHorizontalContractionsPass();
+
 // Materializes logical encodings to physical encodings if there is a single
 // device target.
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createMaterializeHomogeneousEncodingsPass();
 
+// Raises floating point matmuls on dequantized int8 tensors (QDQ models) to
+// integer matmuls followed by a rescaling epilogue.
+std::unique_ptr<Pass> createRaiseQDQMatmulPass();
+
 // Removes tensors that have 0-extents.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createRemoveZeroExtentTensorsPass();
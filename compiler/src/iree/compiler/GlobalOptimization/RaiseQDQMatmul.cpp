@@ -0,0 +1,303 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--------------- RaiseQDQMatmul.cpp ----------------------------------===//
+// Raises floating point matmuls on dequantized int8 tensors, as produced when
+// importing QDQ (quantize/dequantize) models, to integer matmuls:
+//
+//   %a = dequantize(%a_i8, scale_a, zp_a) : f32
+//   %b = dequantize(%b_i8, scale_b, zp_b) : f32
+//   %c = linalg.matmul ins(%a, %b) : f32
+//
+// becomes an i8 x i8 -> i32 `linalg.matmul` followed by an elementwise
+// epilogue applying the zero point corrections and the combined scale. The
+// epilogue fuses with the quantization of the result in the consumer dispatch
+// so that activations stay in int8 between layers and the matmul maps to the
+// integer microkernels.
+//===---------------------------------------------------------------------===//
+
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#define DEBUG_TYPE "iree-global-opt-raise-qdq-matmul"
+
+namespace mlir {
+namespace iree_compiler {
+namespace GlobalOptimization {
+
+namespace {
+
+/// Per-tensor quantization parameters of a dequantized int8 tensor.
+struct Dequantization {
+  Value input;
+  double scale = 1.0;
+  int64_t zeroPoint = 0;
+};
+
+/// Returns the other operand of `op` if one of its two operands is a constant
+/// float, which is returned in `constant`.
+template <typename OpTy>
+static Value matchConstantFloatOperand(OpTy op, double &constant,
+                                       bool commutative) {
+  APFloat value(0.0);
+  if (matchPattern(op.getRhs(), m_ConstantFloat(&value))) {
+    constant = value.convertToDouble();
+    return op.getLhs();
+  }
+  if (commutative && matchPattern(op.getLhs(), m_ConstantFloat(&value))) {
+    constant = value.convertToDouble();
+    return op.getRhs();
+  }
+  return nullptr;
+}
+
+/// Matches `value` against an elementwise `linalg.generic` dequantizing an i8
+/// tensor with a per-tensor scale and zero point, i.e. with a payload of the
+/// form
+///
+///   %0 = arith.extsi %in : i8 to i32       // optional
+///   %1 = arith.subi %0, %zp : i32          // optional
+///   %2 = arith.sitofp %1 : i32 to f32
+///   %3 = arith.subf %2, %zp : f32          // optional
+///   %4 = arith.mulf %3, %scale : f32
+///   linalg.yield %4 : f32
+static std::optional<Dequantization> matchDequantization(Value value) {
+  auto genericOp = value.getDefiningOp<linalg::GenericOp>();
+  if (!genericOp || genericOp.getNumDpsInputs() != 1 ||
+      genericOp.getNumDpsInits() != 1 ||
+      genericOp.getNumParallelLoops() != genericOp.getNumLoops() ||
+      !llvm::all_of(genericOp.getIndexingMapsArray(),
+                    [](AffineMap map) { return map.isIdentity(); })) {
+    return std::nullopt;
+  }
+  Value input = genericOp.getDpsInputs()[0];
+  if (!getElementTypeOrSelf(input.getType()).isInteger(8))
+    return std::nullopt;
+
+  Block *body = genericOp.getBody();
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  Dequantization dequantization;
+  dequantization.input = input;
+
+  Value current = yieldOp.getOperand(0);
+  auto mulOp = current.getDefiningOp<arith::MulFOp>();
+  if (!mulOp)
+    return std::nullopt;
+  current = matchConstantFloatOperand(mulOp, dequantization.scale,
+                                      /*commutative=*/true);
+  if (!current)
+    return std::nullopt;
+
+  if (auto subOp = current.getDefiningOp<arith::SubFOp>()) {
+    double zeroPoint = 0.0;
+    current = matchConstantFloatOperand(subOp, zeroPoint,
+                                        /*commutative=*/false);
+    if (!current || zeroPoint != std::round(zeroPoint))
+      return std::nullopt;
+    dequantization.zeroPoint += static_cast<int64_t>(zeroPoint);
+  }
+
+  auto convertOp = current.getDefiningOp<arith::SIToFPOp>();
+  if (!convertOp)
+    return std::nullopt;
+  current = convertOp.getIn();
+
+  // An integer zero point is only subtracted exactly after extension.
+  if (auto subOp = current.getDefiningOp<arith::SubIOp>()) {
+    APInt zeroPoint;
+    if (!matchPattern(subOp.getRhs(), m_ConstantInt(&zeroPoint)))
+      return std::nullopt;
+    dequantization.zeroPoint += zeroPoint.getSExtValue();
+    current = subOp.getLhs();
+    if (!current.getDefiningOp<arith::ExtSIOp>())
+      return std::nullopt;
+  }
+  if (auto extOp = current.getDefiningOp<arith::ExtSIOp>()) {
+    current = extOp.getIn();
+  }
+
+  if (current != body->getArgument(0))
+    return std::nullopt;
+  return dequantization;
+}
+
+/// Returns the i32 sums of the i8 `matrix` along `reductionDim`.
+static Value sumMatrix(OpBuilder &builder, Location loc, Value matrix,
+                       int reductionDim) {
+  Type i32Type = builder.getI32Type();
+  OpFoldResult size =
+      tensor::getMixedSizes(builder, loc, matrix)[1 - reductionDim];
+  Value zero =
+      builder.create<arith::ConstantOp>(loc, builder.getZeroAttr(i32Type));
+  Value init = builder.create<tensor::EmptyOp>(
+      loc, ArrayRef<OpFoldResult>{size}, i32Type);
+  init = builder.create<linalg::FillOp>(loc, zero, init).getResult(0);
+
+  MLIRContext *context = builder.getContext();
+  AffineExpr d0, d1;
+  bindDims(context, d0, d1);
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(2, 0, {d0, d1}, context),
+      AffineMap::get(2, 0, reductionDim == 0 ? d1 : d0, context)};
+  SmallVector<utils::IteratorType> iteratorTypes(
+      2, utils::IteratorType::parallel);
+  iteratorTypes[reductionDim] = utils::IteratorType::reduction;
+  return builder
+      .create<linalg::GenericOp>(
+          loc, init.getType(), matrix, init, indexingMaps, iteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            Value element = b.create<arith::ExtSIOp>(loc, i32Type, args[0]);
+            Value sum = b.create<arith::AddIOp>(loc, element, args[1]);
+            b.create<linalg::YieldOp>(loc, sum);
+          })
+      .getResult(0);
+}
+
+/// Rewrites a floating point `linalg.matmul` of two dequantized i8 tensors
+/// into an integer matmul and a rescaling epilogue:
+///
+///   C = sa * sb * (A * B - zb * rowsum(A) - za * colsum(B) + K * za * zb)
+struct RaiseQDQMatmulPattern : public OpRewritePattern<linalg::MatmulOp> {
+  using OpRewritePattern<linalg::MatmulOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::MatmulOp matmulOp,
+                                PatternRewriter &rewriter) const override {
+    if (!matmulOp.hasTensorSemantics())
+      return failure();
+    auto resultType = cast<RankedTensorType>(matmulOp.getResult(0).getType());
+    if (!isa<FloatType>(resultType.getElementType()))
+      return failure();
+
+    // The accumulator must be zero so that the scaling applies to the
+    // products only.
+    auto fillOp = matmulOp.getDpsInits()[0].getDefiningOp<linalg::FillOp>();
+    if (!fillOp || !matchPattern(fillOp.getDpsInputs()[0], m_AnyZeroFloat()))
+      return failure();
+
+    std::optional<Dequantization> lhs =
+        matchDequantization(matmulOp.getDpsInputs()[0]);
+    std::optional<Dequantization> rhs =
+        matchDequantization(matmulOp.getDpsInputs()[1]);
+    if (!lhs || !rhs)
+      return failure();
+    auto lhsType = cast<RankedTensorType>(lhs->input.getType());
+    int64_t kSize = lhsType.getDimSize(1);
+    if (ShapedType::isDynamic(kSize) && lhs->zeroPoint != 0 &&
+        rhs->zeroPoint != 0) {
+      return failure();
+    }
+    LLVM_DEBUG(llvm::dbgs() << "raising QDQ matmul with scales " << lhs->scale
+                            << ", " << rhs->scale << " and zero points "
+                            << lhs->zeroPoint << ", " << rhs->zeroPoint
+                            << "\n");
+
+    Location loc = matmulOp.getLoc();
+    Type i32Type = rewriter.getI32Type();
+    SmallVector<OpFoldResult> resultSizes =
+        tensor::getMixedSizes(rewriter, loc, matmulOp.getResult(0));
+    Value zero =
+        rewriter.create<arith::ConstantOp>(loc, rewriter.getZeroAttr(i32Type));
+    Value accInit = rewriter.create<tensor::EmptyOp>(loc, resultSizes, i32Type);
+    accInit = rewriter.create<linalg::FillOp>(loc, zero, accInit).getResult(0);
+    Value acc = rewriter
+                    .create<linalg::MatmulOp>(
+                        loc, accInit.getType(),
+                        ValueRange{lhs->input, rhs->input}, accInit)
+                    .getResult(0);
+
+    // Collect the inputs of the epilogue.
+    MLIRContext *context = rewriter.getContext();
+    AffineExpr m, n;
+    bindDims(context, m, n);
+    SmallVector<Value> inputs = {acc};
+    SmallVector<AffineMap> indexingMaps = {
+        AffineMap::get(2, 0, {m, n}, context)};
+    int lhsSumsIndex = -1, rhsSumsIndex = -1;
+    if (rhs->zeroPoint != 0) {
+      lhsSumsIndex = inputs.size();
+      inputs.push_back(
+          sumMatrix(rewriter, loc, lhs->input, /*reductionDim=*/1));
+      indexingMaps.push_back(AffineMap::get(2, 0, m, context));
+    }
+    if (lhs->zeroPoint != 0) {
+      rhsSumsIndex = inputs.size();
+      inputs.push_back(
+          sumMatrix(rewriter, loc, rhs->input, /*reductionDim=*/0));
+      indexingMaps.push_back(AffineMap::get(2, 0, n, context));
+    }
+    indexingMaps.push_back(AffineMap::get(2, 0, {m, n}, context));
+
+    Value resultInit = rewriter.create<tensor::EmptyOp>(
+        loc, resultSizes, resultType.getElementType());
+    SmallVector<utils::IteratorType> iteratorTypes(
+        2, utils::IteratorType::parallel);
+    auto epilogueOp = rewriter.create<linalg::GenericOp>(
+        loc, resultType, inputs, resultInit, indexingMaps, iteratorTypes,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          auto constant = [&](int64_t value) -> Value {
+            return b.create<arith::ConstantOp>(
+                loc, b.getIntegerAttr(i32Type, value));
+          };
+          Value result = args[0];
+          if (lhsSumsIndex >= 0) {
+            Value correction = b.create<arith::MulIOp>(
+                loc, args[lhsSumsIndex], constant(rhs->zeroPoint));
+            result = b.create<arith::SubIOp>(loc, result, correction);
+          }
+          if (rhsSumsIndex >= 0) {
+            Value correction = b.create<arith::MulIOp>(
+                loc, args[rhsSumsIndex], constant(lhs->zeroPoint));
+            result = b.create<arith::SubIOp>(loc, result, correction);
+          }
+          if (lhsSumsIndex >= 0 && rhsSumsIndex >= 0) {
+            result = b.create<arith::AddIOp>(
+                loc, result,
+                constant(kSize * lhs->zeroPoint * rhs->zeroPoint));
+          }
+          Type floatType = resultType.getElementType();
+          Value scaled = b.create<arith::SIToFPOp>(loc, floatType, result);
+          Value scale = b.create<arith::ConstantOp>(
+              loc, b.getFloatAttr(floatType, lhs->scale * rhs->scale));
+          scaled = b.create<arith::MulFOp>(loc, scaled, scale);
+          b.create<linalg::YieldOp>(loc, scaled);
+        });
+    rewriter.replaceOp(matmulOp, epilogueOp.getResults());
+    return success();
+  }
+};
+
+struct RaiseQDQMatmulPass : public RaiseQDQMatmulBase<RaiseQDQMatmulPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.insert<RaiseQDQMatmulPattern>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> createRaiseQDQMatmulPass() {
+  return std::make_unique<RaiseQDQMatmulPass>();
+}
+
+} // namespace GlobalOptimization
+} // namespace iree_compiler
+} // namespace mlir
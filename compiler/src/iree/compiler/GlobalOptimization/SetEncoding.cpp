@@ -21,10 +21,12 @@
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinAttributeInterfaces.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeRange.h"
@@ -144,6 +146,53 @@ static Value unsetEncodingAndExtractSlice(OpBuilder &builder, Location loc,
                                                 sizes, strides);
 }
 
+/// Returns the encoded tensor if `value` is an `extract_slice` of the full
+/// unpadded shape out of an `unset_encoding` with a `RESULT` role. Padding of
+/// tensors with `RESULT` role only ever contributes to the padding of the
+/// results computed from them, so elementwise computations on it are allowed
+/// to leave arbitrary values there.
+static Value getEncodedResultSource(Value value) {
+  auto sliceOp = value.getDefiningOp<tensor::ExtractSliceOp>();
+  if (!sliceOp || !sliceOp.getType().hasStaticShape())
+    return nullptr;
+  auto isConstant = [](int64_t value) {
+    return [value](OpFoldResult ofr) { return isConstantIntValue(ofr, value); };
+  };
+  if (!llvm::all_of(sliceOp.getMixedOffsets(), isConstant(0)) ||
+      !llvm::all_of(sliceOp.getMixedStrides(), isConstant(1))) {
+    return nullptr;
+  }
+  auto unsetEncodingOp =
+      sliceOp.getSource().getDefiningOp<IREE::LinalgExt::UnsetEncodingOp>();
+  if (!unsetEncodingOp)
+    return nullptr;
+  RankedTensorType encodedType = unsetEncodingOp.getSourceType();
+  auto encoding = llvm::dyn_cast_if_present<IREE::LinalgExt::EncodingAttr>(
+      encodedType.getEncoding());
+  if (!encoding ||
+      encoding.getRole().getValue() != IREE::LinalgExt::EncodingRole::RESULT) {
+    return nullptr;
+  }
+  RankedTensorType originalType = encodedType;
+  if (auto originalTypeAttr = encoding.getOriginalType()) {
+    originalType = originalTypeAttr.getValue().cast<RankedTensorType>();
+  }
+  if (originalType.getShape() != sliceOp.getType().getShape())
+    return nullptr;
+  return unsetEncodingOp.getSource();
+}
+
+/// Returns `encoding` with its original type set to `originalType`, or
+/// without an original type if `originalType` is null.
+static IREE::LinalgExt::EncodingAttr
+withOriginalType(IREE::LinalgExt::EncodingAttr encoding,
+                 RankedTensorType originalType) {
+  return IREE::LinalgExt::EncodingAttr::get(
+      encoding.getContext(), encoding.getUser(), encoding.getRole(),
+      encoding.getElementTypes(),
+      originalType ? TypeAttr::get(originalType) : TypeAttr{});
+}
+
 namespace {
 
 /// Rewrites the matmul op to work on tensors with encoding. Optionally
@@ -319,6 +368,169 @@ struct FoldFillWithSetEncoding
   }
 };
 
+/// Propagates the encoding of matmul results through elementwise consumers,
+/// i.e. rewrites
+///   %0 = iree_linalg_ext.unset_encoding %mm
+///   %1 = tensor.extract_slice %0[0, 0] [M, N] [1, 1]
+///   %2 = linalg.generic ins(%1, %cst) outs(%empty)
+/// into
+///   %0 = linalg.generic ins(%mm, %encoded_cst) outs(%encoded_empty)
+///   %1 = iree_linalg_ext.unset_encoding %0
+///   %2 = tensor.extract_slice %1[0, 0] [M, N] [1, 1]
+/// so that the elementwise ops run in the packed layout of the matmul that
+/// produces their operands. Operands that are constants are broadcast and
+/// encoded as well; hoisting packs them at compile time.
+struct PropagateResultEncodingThroughElementwise
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp genericOp,
+                                PatternRewriter &rewriter) const override {
+    if (!genericOp.hasTensorSemantics() || genericOp.getNumDpsInits() != 1 ||
+        genericOp.getNumLoops() != genericOp.getNumParallelLoops() ||
+        genericOp.hasIndexSemantics()) {
+      return failure();
+    }
+    OpOperand *initOperand = genericOp.getDpsInitOperand(0);
+    if (genericOp.payloadUsesValueFromOperand(initOperand) ||
+        !genericOp.getMatchingIndexingMap(initOperand).isIdentity()) {
+      return rewriter.notifyMatchFailure(genericOp, "not elementwise");
+    }
+
+    // All tensor inputs that are not constants have to be read in the same
+    // encoded layout. Constant tensors are encoded as well, broadcasting them
+    // if needed.
+    Value encodedSource;
+    for (OpOperand *input : genericOp.getDpsInputOperands()) {
+      if (!isa<RankedTensorType>(input->get().getType()))
+        continue;
+      AffineMap indexingMap = genericOp.getMatchingIndexingMap(input);
+      if (matchPattern(input->get(), m_Constant())) {
+        if (!indexingMap.isProjectedPermutation()) {
+          return rewriter.notifyMatchFailure(genericOp,
+                                             "unsupported constant broadcast");
+        }
+        continue;
+      }
+      Value source = getEncodedResultSource(input->get());
+      if (!source || !indexingMap.isIdentity()) {
+        return rewriter.notifyMatchFailure(genericOp,
+                                           "operand not in an encoded layout");
+      }
+      if (encodedSource && encodedSource.getType() != source.getType()) {
+        return rewriter.notifyMatchFailure(genericOp, "mismatched encodings");
+      }
+      encodedSource = source;
+    }
+    if (!encodedSource) {
+      return rewriter.notifyMatchFailure(genericOp, "no encoded operand");
+    }
+
+    auto encodedType = encodedSource.getType().cast<RankedTensorType>();
+    auto encoding =
+        encodedType.getEncoding().cast<IREE::LinalgExt::EncodingAttr>();
+    auto resultType = genericOp.getResultTypes()[0].cast<RankedTensorType>();
+    Location loc = genericOp.getLoc();
+    int64_t rank = resultType.getRank();
+    AffineMap identityMap = rewriter.getMultiDimIdentityMap(rank);
+
+    SmallVector<Value> newInputs;
+    SmallVector<AffineMap> newIndexingMaps;
+    for (OpOperand *input : genericOp.getDpsInputOperands()) {
+      Value operand = input->get();
+      AffineMap indexingMap = genericOp.getMatchingIndexingMap(input);
+      auto operandType = dyn_cast<RankedTensorType>(operand.getType());
+      if (!operandType) {
+        // Scalars are used as-is.
+        newInputs.push_back(operand);
+        newIndexingMaps.push_back(indexingMap);
+        continue;
+      }
+      newIndexingMaps.push_back(identityMap);
+      if (Value source = getEncodedResultSource(operand)) {
+        newInputs.push_back(source);
+        continue;
+      }
+      if (!indexingMap.isIdentity()) {
+        Value empty = rewriter.create<tensor::EmptyOp>(
+            loc, resultType.getShape(), operandType.getElementType());
+        SmallVector<utils::IteratorType> iteratorTypes(
+            rank, utils::IteratorType::parallel);
+        operand = rewriter
+                      .create<linalg::GenericOp>(
+                          loc, empty.getType(), operand, empty,
+                          ArrayRef<AffineMap>{indexingMap, identityMap},
+                          iteratorTypes,
+                          [](OpBuilder &b, Location loc, ValueRange args) {
+                            b.create<linalg::YieldOp>(loc, args[0]);
+                          })
+                      .getResult(0);
+      }
+      auto encodingForPad = withOriginalType(encoding, /*originalType=*/{});
+      Value padded = pad(rewriter, loc, operand, encodingForPad);
+      auto encodingForSetEncoding = encodingForPad;
+      if (padded.getType() != operand.getType()) {
+        encodingForSetEncoding = withOriginalType(
+            encoding, operand.getType().cast<RankedTensorType>());
+      }
+      newInputs.push_back(
+          setEncoding(rewriter, loc, padded, encodingForSetEncoding));
+    }
+    newIndexingMaps.push_back(identityMap);
+
+    // The result keeps the layout with its own element type.
+    auto resultEncoding = encoding;
+    if (encoding.getOriginalType()) {
+      resultEncoding = withOriginalType(encoding, resultType);
+    }
+    Value newInit = rewriter.create<tensor::EmptyOp>(
+        loc, tensor::getMixedSizes(rewriter, loc, encodedSource),
+        resultType.getElementType(), resultEncoding);
+    auto newGenericOp = rewriter.create<linalg::GenericOp>(
+        loc, newInit.getType(), newInputs, newInit, newIndexingMaps,
+        genericOp.getIteratorTypesArray());
+    rewriter.inlineRegionBefore(genericOp.getRegion(),
+                                newGenericOp.getRegion(),
+                                newGenericOp.getRegion().begin());
+
+    SmallVector<OpFoldResult> sizes =
+        getAsIndexOpFoldResult(getContext(), resultType.getShape());
+    Value result = unsetEncodingAndExtractSlice(
+        rewriter, loc, newGenericOp.getResult(0), sizes);
+    rewriter.replaceOp(genericOp, result);
+    return success();
+  }
+};
+
+/// Folds a `set_encoding` of a tensor that was just decoded from the same
+/// layout, i.e.
+///   %0 = iree_linalg_ext.unset_encoding %encoded
+///   %1 = tensor.extract_slice %0[0, 0] [M, N] [1, 1]
+///   %2 = tensor.pad %1 ...
+///   %3 = iree_linalg_ext.set_encoding %2
+/// into `%encoded`. Only tensors with `RESULT` role are folded since their
+/// padding is never read into the unpadded part of any result.
+struct FoldSetEncodingOfUnsetEncoding
+    : public OpRewritePattern<IREE::LinalgExt::SetEncodingOp> {
+  using OpRewritePattern<IREE::LinalgExt::SetEncodingOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::SetEncodingOp encodingOp,
+                                PatternRewriter &rewriter) const override {
+    Value source = encodingOp.getSource();
+    if (auto padOp = source.getDefiningOp<tensor::PadOp>()) {
+      if (!padOp.hasZeroLowPad())
+        return failure();
+      source = padOp.getSource();
+    }
+    Value encodedSource = getEncodedResultSource(source);
+    if (!encodedSource || encodedSource.getType() != encodingOp.getType()) {
+      return failure();
+    }
+    rewriter.replaceOp(encodingOp, encodedSource);
+    return success();
+  }
+};
+
 struct SetEncodingPass : public SetEncodingBase<SetEncodingPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<IREE::LinalgExt::IREELinalgExtDialect>();
@@ -333,6 +545,8 @@ void SetEncodingPass::runOnOperation() {
   {
     RewritePatternSet patterns(context);
     patterns.insert<SetBatchMatmulEncoding, SetMatmulEncoding>(context);
+    patterns.insert<FoldSetEncodingOfUnsetEncoding,
+                    PropagateResultEncodingThroughElementwise>(context);
     linalg::FillOp::getCanonicalizationPatterns(patterns, context);
     patterns.insert<FoldFillWithSetEncoding>(context);
     memref::populateResolveRankedShapedTypeResultDimsPatterns(patterns);
@@ -0,0 +1,39 @@
+// RUN: iree-opt --split-input-file --iree-global-opt-convert-conv2d-to-winograd %s | FileCheck %s
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu_features = "+avx512f"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  func.func @conv_3x3_llvm_cpu(%arg0: tensor<1x16x16x4xf32>, %arg1: tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32> {
+    %cst = arith.constant dense<0.1> : tensor<3x3x4x16xf32>
+    %0 = linalg.conv_2d_nhwc_hwcf
+      {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+      ins(%arg0, %cst : tensor<1x16x16x4xf32>, tensor<3x3x4x16xf32>)
+      outs(%arg1 : tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32>
+    return %0 : tensor<1x14x14x16xf32>
+  }
+}
+// CHECK-LABEL: func.func @conv_3x3_llvm_cpu
+//       CHECK:   %[[FILTER:.+]] = arith.constant {{.+}} : tensor<64x4x16xf32>
+//       CHECK:   %[[INPUT:.+]] = iree_linalg_ext.winograd.input_transform output_tile_size(6) kernel_size(3)
+//       CHECK:   %[[LHS:.+]] = tensor.collapse_shape %[[INPUT]]
+//       CHECK:   %[[MATMUL:.+]] = linalg.batch_matmul ins(%[[LHS]], %[[FILTER]]
+//       CHECK:   iree_linalg_ext.winograd.output_transform output_tile_size(6) kernel_size(3)
+//   CHECK-NOT:   linalg.conv_2d_nhwc_hwcf
+
+// -----
+
+#executable_target_cuda_nvptx_fb = #hal.executable.target<"cuda", "cuda-nvptx-fb", {target_arch = "sm_80"}>
+#device_target_cuda = #hal.device.target<"cuda", {executable_targets = [#executable_target_cuda_nvptx_fb]}>
+module attributes {hal.device.targets = [#device_target_cuda]} {
+  func.func @conv_3x3_cuda(%arg0: tensor<1x16x16x4xf32>, %arg1: tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32> {
+    %cst = arith.constant dense<0.1> : tensor<3x3x4x16xf32>
+    %0 = linalg.conv_2d_nhwc_hwcf
+      {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+      ins(%arg0, %cst : tensor<1x16x16x4xf32>, tensor<3x3x4x16xf32>)
+      outs(%arg1 : tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32>
+    return %0 : tensor<1x14x14x16xf32>
+  }
+}
+// CHECK-LABEL: func.func @conv_3x3_cuda
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+//   CHECK-NOT:   iree_linalg_ext.winograd
@@ -0,0 +1,84 @@
+// RUN: iree-opt --iree-global-opt-fuse-horizontal-contractions --split-input-file %s | FileCheck %s
+
+util.global private @q_weight = dense<1.0> : tensor<64x32xf32>
+util.global private @k_weight = dense<2.0> : tensor<64x32xf32>
+util.global private @v_weight = dense<3.0> : tensor<64x16xf32>
+func.func @qkv_projections(%input : tensor<8x64xf32>) -> (tensor<8x32xf32>, tensor<8x32xf32>, tensor<8x16xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %q_weight = util.global.load @q_weight : tensor<64x32xf32>
+  %empty0 = tensor.empty() : tensor<8x32xf32>
+  %fill0 = linalg.fill ins(%cst : f32) outs(%empty0 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %q = linalg.matmul ins(%input, %q_weight : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill0 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %k_weight = util.global.load @k_weight : tensor<64x32xf32>
+  %empty1 = tensor.empty() : tensor<8x32xf32>
+  %fill1 = linalg.fill ins(%cst : f32) outs(%empty1 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %k = linalg.matmul ins(%input, %k_weight : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill1 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %v_weight = util.global.load @v_weight : tensor<64x16xf32>
+  %empty2 = tensor.empty() : tensor<8x16xf32>
+  %fill2 = linalg.fill ins(%cst : f32) outs(%empty2 : tensor<8x16xf32>) -> tensor<8x16xf32>
+  %v = linalg.matmul ins(%input, %v_weight : tensor<8x64xf32>, tensor<64x16xf32>)
+      outs(%fill2 : tensor<8x16xf32>) -> tensor<8x16xf32>
+  return %q, %k, %v : tensor<8x32xf32>, tensor<8x32xf32>, tensor<8x16xf32>
+}
+//      CHECK: func.func @qkv_projections
+// CHECK-SAME:     %[[INPUT:[a-zA-Z0-9]+]]: tensor<8x64xf32>
+//  CHECK-DAG:   %[[Q_WEIGHT:.+]] = util.global.load @q_weight
+//  CHECK-DAG:   %[[K_WEIGHT:.+]] = util.global.load @k_weight
+//  CHECK-DAG:   %[[V_WEIGHT:.+]] = util.global.load @v_weight
+//      CHECK:   %[[EMPTY:.+]] = tensor.empty() : tensor<64x80xf32>
+//      CHECK:   %[[INSERT0:.+]] = tensor.insert_slice %[[Q_WEIGHT]] into %[[EMPTY]][0, 0] [64, 32] [1, 1]
+//      CHECK:   %[[INSERT1:.+]] = tensor.insert_slice %[[K_WEIGHT]] into %[[INSERT0]][0, 32] [64, 32] [1, 1]
+//      CHECK:   %[[RHS:.+]] = tensor.insert_slice %[[V_WEIGHT]] into %[[INSERT1]][0, 64] [64, 16] [1, 1]
+//      CHECK:   %[[INIT:.+]] = tensor.empty() : tensor<8x80xf32>
+//      CHECK:   %[[FILL:.+]] = linalg.fill ins(%{{.+}} : f32) outs(%[[INIT]] : tensor<8x80xf32>)
+//      CHECK:   %[[MATMUL:.+]] = linalg.matmul
+// CHECK-SAME:       ins(%[[INPUT]], %[[RHS]] : tensor<8x64xf32>, tensor<64x80xf32>)
+// CHECK-SAME:       outs(%[[FILL]] : tensor<8x80xf32>)
+//  CHECK-DAG:   %[[Q:.+]] = tensor.extract_slice %[[MATMUL]][0, 0] [8, 32] [1, 1]
+//  CHECK-DAG:   %[[K:.+]] = tensor.extract_slice %[[MATMUL]][0, 32] [8, 32] [1, 1]
+//  CHECK-DAG:   %[[V:.+]] = tensor.extract_slice %[[MATMUL]][0, 64] [8, 16] [1, 1]
+//  CHECK-NOT:   linalg.matmul
+//      CHECK:   return %[[Q]], %[[K]], %[[V]]
+
+// -----
+
+// The RHS are not constant, so concatenating them would cost a copy at
+// runtime.
+func.func @non_constant_rhs(%input : tensor<8x64xf32>, %w0 : tensor<64x32xf32>, %w1 : tensor<64x32xf32>) -> (tensor<8x32xf32>, tensor<8x32xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<8x32xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %0 = linalg.matmul ins(%input, %w0 : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %1 = linalg.matmul ins(%input, %w1 : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %0, %1 : tensor<8x32xf32>, tensor<8x32xf32>
+}
+// CHECK-LABEL: func.func @non_constant_rhs
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.matmul
+//   CHECK-NOT:   tensor.extract_slice
+
+// -----
+
+// Contractions with different LHS are not fused.
+util.global private @weight0 = dense<1.0> : tensor<64x32xf32>
+util.global private @weight1 = dense<2.0> : tensor<64x32xf32>
+func.func @different_lhs(%input0 : tensor<8x64xf32>, %input1 : tensor<8x64xf32>) -> (tensor<8x32xf32>, tensor<8x32xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %w0 = util.global.load @weight0 : tensor<64x32xf32>
+  %w1 = util.global.load @weight1 : tensor<64x32xf32>
+  %empty = tensor.empty() : tensor<8x32xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %0 = linalg.matmul ins(%input0, %w0 : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %1 = linalg.matmul ins(%input1, %w1 : tensor<8x64xf32>, tensor<64x32xf32>)
+      outs(%fill : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %0, %1 : tensor<8x32xf32>, tensor<8x32xf32>
+}
+// CHECK-LABEL: func.func @different_lhs
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.matmul
+//   CHECK-NOT:   tensor.extract_slice
@@ -0,0 +1,130 @@
+// RUN: iree-opt --iree-global-opt-raise-qdq-matmul --split-input-file %s | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @qdq_matmul_symmetric(%lhs: tensor<8x64xi8>, %rhs: tensor<64x32xi8>) -> tensor<8x32xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %lhs_scale = arith.constant 5.000000e-01 : f32
+  %rhs_scale = arith.constant 2.500000e-01 : f32
+  %0 = tensor.empty() : tensor<8x64xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%lhs : tensor<8x64xi8>) outs(%0 : tensor<8x64xf32>) {
+  ^bb0(%in: i8, %out: f32):
+    %7 = arith.sitofp %in : i8 to f32
+    %8 = arith.mulf %7, %lhs_scale : f32
+    linalg.yield %8 : f32
+  } -> tensor<8x64xf32>
+  %2 = tensor.empty() : tensor<64x32xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%rhs : tensor<64x32xi8>) outs(%2 : tensor<64x32xf32>) {
+  ^bb0(%in: i8, %out: f32):
+    %7 = arith.sitofp %in : i8 to f32
+    %8 = arith.mulf %rhs_scale, %7 : f32
+    linalg.yield %8 : f32
+  } -> tensor<64x32xf32>
+  %4 = tensor.empty() : tensor<8x32xf32>
+  %5 = linalg.fill ins(%cst : f32) outs(%4 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %6 = linalg.matmul ins(%1, %3 : tensor<8x64xf32>, tensor<64x32xf32>) outs(%5 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %6 : tensor<8x32xf32>
+}
+// CHECK-LABEL: func.func @qdq_matmul_symmetric
+//  CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<8x64xi8>
+//  CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<64x32xi8>
+//   CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : i32
+//       CHECK:   %[[FILL:.+]] = linalg.fill ins(%[[C0]] : i32)
+//       CHECK:   %[[ACC:.+]] = linalg.matmul
+//  CHECK-SAME:       ins(%[[LHS]], %[[RHS]] : tensor<8x64xi8>, tensor<64x32xi8>)
+//  CHECK-SAME:       outs(%[[FILL]] : tensor<8x32xi32>)
+//       CHECK:   %[[RESULT:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[ACC]] : tensor<8x32xi32>)
+//       CHECK:   ^bb0(%[[IN:.+]]: i32, %{{.+}}: f32):
+//       CHECK:     %[[FP:.+]] = arith.sitofp %[[IN]] : i32 to f32
+//       CHECK:     %[[SCALED:.+]] = arith.mulf %[[FP]], %{{.+}} : f32
+//       CHECK:     linalg.yield %[[SCALED]]
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @qdq_matmul_zero_points(%lhs: tensor<8x64xi8>, %rhs: tensor<64x32xi8>) -> tensor<8x32xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %lhs_scale = arith.constant 5.000000e-01 : f32
+  %lhs_zp = arith.constant 3 : i32
+  %rhs_scale = arith.constant 2.500000e-01 : f32
+  %rhs_zp = arith.constant -2.000000e+00 : f32
+  %0 = tensor.empty() : tensor<8x64xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%lhs : tensor<8x64xi8>) outs(%0 : tensor<8x64xf32>) {
+  ^bb0(%in: i8, %out: f32):
+    %7 = arith.extsi %in : i8 to i32
+    %8 = arith.subi %7, %lhs_zp : i32
+    %9 = arith.sitofp %8 : i32 to f32
+    %10 = arith.mulf %9, %lhs_scale : f32
+    linalg.yield %10 : f32
+  } -> tensor<8x64xf32>
+  %2 = tensor.empty() : tensor<64x32xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%rhs : tensor<64x32xi8>) outs(%2 : tensor<64x32xf32>) {
+  ^bb0(%in: i8, %out: f32):
+    %7 = arith.sitofp %in : i8 to f32
+    %8 = arith.subf %7, %rhs_zp : f32
+    %9 = arith.mulf %8, %rhs_scale : f32
+    linalg.yield %9 : f32
+  } -> tensor<64x32xf32>
+  %4 = tensor.empty() : tensor<8x32xf32>
+  %5 = linalg.fill ins(%cst : f32) outs(%4 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %6 = linalg.matmul ins(%1, %3 : tensor<8x64xf32>, tensor<64x32xf32>) outs(%5 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %6 : tensor<8x32xf32>
+}
+// The zero point corrections use -2 and 3 as well as 64 * 3 * -2 = -384.
+//   CHECK-DAG: #[[$MAP:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//   CHECK-DAG: #[[$ROW:.+]] = affine_map<(d0, d1) -> (d0)>
+//   CHECK-DAG: #[[$COL:.+]] = affine_map<(d0, d1) -> (d1)>
+// CHECK-LABEL: func.func @qdq_matmul_zero_points
+//  CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<8x64xi8>
+//  CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<64x32xi8>
+//   CHECK-DAG:   arith.constant -2 : i32
+//   CHECK-DAG:   arith.constant 3 : i32
+//   CHECK-DAG:   arith.constant -384 : i32
+//       CHECK:   %[[ACC:.+]] = linalg.matmul
+//  CHECK-SAME:       ins(%[[LHS]], %[[RHS]] : tensor<8x64xi8>, tensor<64x32xi8>)
+//       CHECK:   %[[LHS_SUMS:.+]] = linalg.generic
+//  CHECK-SAME:       iterator_types = ["parallel", "reduction"]
+//  CHECK-SAME:       ins(%[[LHS]] : tensor<8x64xi8>) outs(%{{.+}} : tensor<8xi32>)
+//       CHECK:   %[[RHS_SUMS:.+]] = linalg.generic
+//  CHECK-SAME:       iterator_types = ["reduction", "parallel"]
+//  CHECK-SAME:       ins(%[[RHS]] : tensor<64x32xi8>) outs(%{{.+}} : tensor<32xi32>)
+//       CHECK:   %[[RESULT:.+]] = linalg.generic
+//  CHECK-SAME:       indexing_maps = [#[[$MAP]], #[[$ROW]], #[[$COL]], #[[$MAP]]]
+//  CHECK-SAME:       ins(%[[ACC]], %[[LHS_SUMS]], %[[RHS_SUMS]] : tensor<8x32xi32>, tensor<8xi32>, tensor<32xi32>)
+//       CHECK:   ^bb0(%[[IN:.+]]: i32, %[[ROW_SUM:.+]]: i32, %[[COL_SUM:.+]]: i32, %{{.+}}: f32):
+//       CHECK:     %[[T0:.+]] = arith.muli %[[ROW_SUM]], %{{.+}}
+//       CHECK:     %[[T1:.+]] = arith.subi %[[IN]], %[[T0]]
+//       CHECK:     %[[T2:.+]] = arith.muli %[[COL_SUM]], %{{.+}}
+//       CHECK:     %[[T3:.+]] = arith.subi %[[T1]], %[[T2]]
+//       CHECK:     %[[T4:.+]] = arith.addi %[[T3]], %{{.+}}
+//       CHECK:     %[[FP:.+]] = arith.sitofp %[[T4]] : i32 to f32
+//       CHECK:     arith.mulf %[[FP]]
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @no_raise_f32_lhs(%lhs: tensor<8x64xf32>, %rhs: tensor<64x32xi8>) -> tensor<8x32xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %rhs_scale = arith.constant 2.500000e-01 : f32
+  %2 = tensor.empty() : tensor<64x32xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%rhs : tensor<64x32xi8>) outs(%2 : tensor<64x32xf32>) {
+  ^bb0(%in: i8, %out: f32):
+    %7 = arith.sitofp %in : i8 to f32
+    %8 = arith.mulf %7, %rhs_scale : f32
+    linalg.yield %8 : f32
+  } -> tensor<64x32xf32>
+  %4 = tensor.empty() : tensor<8x32xf32>
+  %5 = linalg.fill ins(%cst : f32) outs(%4 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  %6 = linalg.matmul ins(%lhs, %3 : tensor<8x64xf32>, tensor<64x32xf32>) outs(%5 : tensor<8x32xf32>) -> tensor<8x32xf32>
+  return %6 : tensor<8x32xf32>
+}
+// CHECK-LABEL: func.func @no_raise_f32_lhs
+//       CHECK:   linalg.matmul
+//  CHECK-SAME:       tensor<8x64xf32>, tensor<64x32xf32>
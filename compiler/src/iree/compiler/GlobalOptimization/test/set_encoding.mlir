@@ -639,3 +639,66 @@ func.func @fold_fill_with_tensor_pad(%arg0 : index, %arg1 : index, %arg2 : index
 //      CHECK:   %[[FILL:.+]] = linalg.fill
 // CHECK-SAME:       outs(%[[EMPTY]] :
 //      CHECK:   return %[[FILL]]
+
+// -----
+
+func.func @matmul_bias_relu(%arg0 : tensor<100x250xf32>, %arg1 : tensor<250x500xf32>,
+    %arg2 : tensor<100x500xf32>) -> tensor<100x500xf32> {
+  %bias = arith.constant dense<1.0> : tensor<500xf32>
+  %cst = arith.constant 0.0 : f32
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<100x250xf32>, tensor<250x500xf32>)
+      outs(%arg2 : tensor<100x500xf32>) -> tensor<100x500xf32>
+  %1 = tensor.empty() : tensor<100x500xf32>
+  %2 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%0, %bias : tensor<100x500xf32>, tensor<500xf32>) outs(%1 : tensor<100x500xf32>) {
+  ^bb0(%b0 : f32, %b1 : f32, %b2 : f32):
+    %3 = arith.addf %b0, %b1 : f32
+    %4 = arith.maximumf %3, %cst : f32
+    linalg.yield %4 : f32
+  } -> tensor<100x500xf32>
+  return %2 : tensor<100x500xf32>
+}
+//  CHECK-DAG: #[[IDENTITY:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//  CHECK-DAG: #[[BROADCAST:.+]] = affine_map<(d0, d1) -> (d1)>
+//      CHECK: func @matmul_bias_relu(
+//  CHECK-DAG:   %[[BIAS:.+]] = arith.constant dense<1.000000e+00> : tensor<500xf32>
+//      CHECK:   %[[MATMUL:.+]] = linalg.matmul
+//      CHECK:   %[[BROADCAST_EMPTY:.+]] = tensor.empty() : tensor<100x500xf32>
+//      CHECK:   %[[BROADCAST_BIAS:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[BROADCAST]], #[[IDENTITY]]]
+// CHECK-SAME:       ins(%[[BIAS]] :
+// CHECK-SAME:       outs(%[[BROADCAST_EMPTY]] :
+//      CHECK:   %[[BIAS_PAD:.+]] = tensor.pad %[[BROADCAST_BIAS]]
+//      CHECK:   %[[ENCODED_BIAS:.+]] = iree_linalg_ext.set_encoding %[[BIAS_PAD]]
+// CHECK-SAME:       tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32], original_type = tensor<100x500xf32>>>
+//      CHECK:   %[[EMPTY:.+]] = tensor.empty({{.+}}) : tensor<?x?xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32], original_type = tensor<100x500xf32>>>
+//      CHECK:   %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[IDENTITY]], #[[IDENTITY]], #[[IDENTITY]]]
+// CHECK-SAME:       ins(%[[MATMUL]], %[[ENCODED_BIAS]] :
+// CHECK-SAME:       outs(%[[EMPTY]] :
+//      CHECK:     arith.addf
+//      CHECK:     arith.maximumf
+//      CHECK:   %[[RESULT_PADDED:.+]] = iree_linalg_ext.unset_encoding %[[GENERIC]]
+//      CHECK:   %[[RESULT:.+]] = tensor.extract_slice %[[RESULT_PADDED]][0, 0] [100, 500] [1, 1]
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @matmul_accumulate_into_matmul(%arg0 : tensor<100x250xf32>, %arg1 : tensor<250x500xf32>,
+    %arg2 : tensor<100x500xf32>, %arg3 : tensor<100x64xf32>, %arg4 : tensor<64x500xf32>) -> tensor<100x500xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<100x250xf32>, tensor<250x500xf32>)
+      outs(%arg2 : tensor<100x500xf32>) -> tensor<100x500xf32>
+  %1 = linalg.matmul ins(%arg3, %arg4 : tensor<100x64xf32>, tensor<64x500xf32>)
+      outs(%0 : tensor<100x500xf32>) -> tensor<100x500xf32>
+  return %1 : tensor<100x500xf32>
+}
+//      CHECK: func @matmul_accumulate_into_matmul(
+//      CHECK:   %[[MATMUL0:.+]] = linalg.matmul
+//  CHECK-NOT:   iree_linalg_ext.unset_encoding
+//      CHECK:   %[[MATMUL1:.+]] = linalg.matmul
+// CHECK-SAME:       outs(%[[MATMUL0]] :
+//      CHECK:   %[[RESULT_PADDED:.+]] = iree_linalg_ext.unset_encoding %[[MATMUL1]]
+//      CHECK:   %[[RESULT:.+]] = tensor.extract_slice %[[RESULT_PADDED]][0, 0] [100, 500] [1, 1]
+//      CHECK:   return %[[RESULT]]
@@ -13,7 +13,9 @@
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Value.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/RegionUtils.h"
 #include "stablehlo/dialect/StablehloOps.h"
 
 namespace mlir::iree_compiler::stablehlo {
@@ -55,6 +57,34 @@ Value extractTensorValue(OpBuilder &b, Value tensor) {
   return b.create<tensor::ExtractOp>(loc, tensor, ValueRange());
 }
 
+// Hoists ops out of the condition and body of |op| that compute the same value
+// on every iteration. Once lowered each op remaining in the loop is work issued
+// from the host per iteration, and loop-invariant setup (broadcasts of
+// constants, transposes of weights, etc) would otherwise be recomputed each
+// step of RNN and decoding loops. Only ops free of memory effects are hoisted
+// as the body may not execute. Hoisting also exposes loops whose bounds are
+// computed within the condition to the scf.for lowering below.
+void hoistLoopInvariantOps(mlir::stablehlo::WhileOp op) {
+  auto isDefinedOutside = [&](Value value) {
+    return !op->isAncestor(value.getParentRegion()->getParentOp());
+  };
+  for (Region &region : op->getRegions()) {
+    for (Operation &nestedOp :
+         llvm::make_early_inc_range(region.front().without_terminator())) {
+      if (!isMemoryEffectFree(&nestedOp) ||
+          !llvm::all_of(nestedOp.getOperands(), isDefinedOutside)) {
+        continue;
+      }
+      SetVector<Value> capturedValues;
+      getUsedValuesDefinedAbove(nestedOp.getRegions(), capturedValues);
+      if (!llvm::all_of(capturedValues, isDefinedOutside)) {
+        continue;
+      }
+      nestedOp.moveBefore(op);
+    }
+  }
+}
+
 struct ScfForBounds {
   Value lb;
   Value ub;
@@ -259,6 +289,10 @@ struct LegalizeControlFlow final
     func::FuncOp f = getOperation();
     MLIRContext *ctx = f.getContext();
 
+    // Inner loops are visited first so that their invariants can continue to
+    // be hoisted out of any enclosing loops.
+    f.walk([](mlir::stablehlo::WhileOp op) { hoistLoopInvariantOps(op); });
+
     RewritePatternSet patterns(ctx);
     populateLegalizeControlFlowPatterns(ctx, &patterns);
 
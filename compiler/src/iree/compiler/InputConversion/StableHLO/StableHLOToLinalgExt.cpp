@@ -21,6 +21,7 @@
 #include "iree/compiler/InputConversion/StableHLO/PassDetail.h"
 #include "iree/compiler/InputConversion/StableHLO/Passes.h"
 #include "iree/compiler/InputConversion/StableHLO/Rewriters.h"
+#include "llvm/ADT/DenseSet.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -200,6 +201,74 @@ struct SortOpConversion final : OpConversionPattern<mlir::stablehlo::SortOp> {
 // ScatterOp
 //===----------------------------------------------------------------------===//
 
+// Maximum number of constant index elements inspected when checking whether
+// scatter indices are unique.
+static constexpr int64_t kMaxUniqueIndicesCheckElements = 1 << 16;
+
+/// Returns true if |value|, viewed in row-major order as consecutive rows of
+/// |rowSize| elements, is known to contain no duplicate rows.
+static bool hasDistinctRows(Value value, int64_t rowSize) {
+  auto valueType = dyn_cast<RankedTensorType>(value.getType());
+  if (!valueType || !valueType.hasStaticShape() ||
+      !isa<IntegerType>(valueType.getElementType()) || rowSize <= 0) {
+    return false;
+  }
+  // A single row cannot have duplicates.
+  if (valueType.getNumElements() <= rowSize) {
+    return true;
+  }
+
+  // Reshapes preserve the row-major order and integer conversions that do not
+  // narrow preserve distinct values.
+  if (auto reshapeOp = value.getDefiningOp<mlir::stablehlo::ReshapeOp>()) {
+    return hasDistinctRows(reshapeOp.getOperand(), rowSize);
+  }
+  if (auto convertOp = value.getDefiningOp<mlir::stablehlo::ConvertOp>()) {
+    auto sourceType = dyn_cast<IntegerType>(
+        getElementTypeOrSelf(convertOp.getOperand().getType()));
+    if (!sourceType || sourceType.getWidth() >
+                           valueType.getElementType().getIntOrFloatBitWidth()) {
+      return false;
+    }
+    return hasDistinctRows(convertOp.getOperand(), rowSize);
+  }
+
+  // Each row of an iota holds a single distinct value if the iota dimension
+  // strides by exactly one row and no outer dimension repeats the sequence.
+  if (auto iotaOp = value.getDefiningOp<mlir::stablehlo::IotaOp>()) {
+    ArrayRef<int64_t> shape = valueType.getShape();
+    int64_t iotaDim = iotaOp.getIotaDimension();
+    int64_t outerSize = 1;
+    for (int64_t dim = 0; dim < iotaDim; ++dim)
+      outerSize *= shape[dim];
+    int64_t innerSize = 1;
+    for (int64_t dim = iotaDim + 1; dim < valueType.getRank(); ++dim)
+      innerSize *= shape[dim];
+    unsigned bitWidth = valueType.getElementType().getIntOrFloatBitWidth();
+    bool wraps = bitWidth < 63 && shape[iotaDim] > (int64_t{1} << bitWidth);
+    return outerSize == 1 && innerSize == rowSize && !wraps;
+  }
+
+  DenseIntElementsAttr constantAttr;
+  if (!matchPattern(value, m_Constant(&constantAttr)) ||
+      constantAttr.getNumElements() > kMaxUniqueIndicesCheckElements ||
+      valueType.getElementType().getIntOrFloatBitWidth() > 64) {
+    return false;
+  }
+  SmallVector<int64_t> values;
+  values.reserve(constantAttr.getNumElements());
+  for (const APInt &element : constantAttr.getValues<APInt>()) {
+    values.push_back(element.getSExtValue());
+  }
+  llvm::DenseSet<ArrayRef<int64_t>> rows;
+  for (int64_t offset = 0; offset < static_cast<int64_t>(values.size());
+       offset += rowSize) {
+    if (!rows.insert(ArrayRef<int64_t>(values).slice(offset, rowSize)).second)
+      return false;
+  }
+  return true;
+}
+
 struct ScatterOpConversion final
     : OpConversionPattern<mlir::stablehlo::ScatterOp> {
   using OpConversionPattern::OpConversionPattern;
@@ -266,9 +335,18 @@ struct ScatterOpConversion final
       scatterDimMap.push_back(dim);
     }
 
+    // Scatters with unique indices have no conflicting updates and can be
+    // executed in parallel across the batch dimension instead of serially.
+    // Frontends often omit the attribute when indices come from an iota or a
+    // constant, so check those directly.
+    auto indicesType = cast<ShapedType>(op.getScatterIndices().getType());
+    bool uniqueIndices =
+        op.getUniqueIndices() ||
+        hasDistinctRows(op.getScatterIndices(), indicesType.getShape().back());
+
     auto scatterOp = rewriter.create<IREE::LinalgExt::ScatterOp>(
         op.getLoc(), originalType, ValueRange{updates, indices},
-        ValueRange{original}, scatterDimMap, op.getUniqueIndices());
+        ValueRange{original}, scatterDimMap, uniqueIndices);
 
     rewriter.inlineRegionBefore(op.getUpdateComputation(),
                                 scatterOp.getRegion(),
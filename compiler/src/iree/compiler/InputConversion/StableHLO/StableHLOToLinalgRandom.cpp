@@ -81,6 +81,16 @@ public:
     return ArithOpBuilder(builder, loc, res);
   }
 
+  ArithOpBuilder operator/(ArithOpBuilder &rhs) {
+    Value res = builder.create<arith::DivUIOp>(loc, value, rhs.value);
+    return ArithOpBuilder(builder, loc, res);
+  }
+
+  ArithOpBuilder operator%(ArithOpBuilder &rhs) {
+    Value res = builder.create<arith::RemUIOp>(loc, value, rhs.value);
+    return ArithOpBuilder(builder, loc, res);
+  }
+
   ArithOpBuilder operator|(ArithOpBuilder &rhs) {
     Value res = builder.create<arith::OrIOp>(loc, value, rhs.value);
     return ArithOpBuilder(builder, loc, res);
@@ -124,15 +134,12 @@ ArithOpBuilder fuseI32s(ArithOpBuilder low, ArithOpBuilder high) {
 // Implements the ThreeFry counter-based PRNG algorithm.
 // Salmon et al. SC 2011. Parallel random numbers: as easy as 1, 2, 3.
 // http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+// |counter| is the i64 counter (state + offset) of the pair being generated.
 std::pair<ArithOpBuilder, ArithOpBuilder>
 runThreeFry2xi32(ArithOpBuilder key0, ArithOpBuilder key1,
-                 ArithOpBuilder initialState) {
-  ArithOpBuilder index = initialState.linalgIndex(0);
-  index = index.indexCast(64);
-  index = index + initialState;
-
+                 ArithOpBuilder counter) {
   // Split into the 2xi32 used for threefry.
-  std::pair<ArithOpBuilder, ArithOpBuilder> input = splitI64(index);
+  std::pair<ArithOpBuilder, ArithOpBuilder> input = splitI64(counter);
   ArithOpBuilder input0 = input.first;
   ArithOpBuilder input1 = input.second;
 
@@ -288,28 +295,62 @@ Value setState64(OpBuilder &b, Location loc, Value store, Value state) {
   return nullptr;
 }
 
-Value reshapeToTarget(OpBuilder &builder, Location loc, ShapedType destTy,
-                      Value src) {
-  auto srcTy = cast<ShapedType>(src.getType());
-  // Expand out to the target shape.
-
-  auto reassociationIndices =
-      getReassociationIndicesForCollapse(destTy.getShape(), srcTy.getShape());
-  if (reassociationIndices.has_value()) {
-    src = builder.create<tensor::ExpandShapeOp>(loc, destTy, src,
-                                                reassociationIndices.value());
-  }
-
-  // It is also possible our target is Rank-0, then we would
-  // need to collapse.
-  reassociationIndices =
-      getReassociationIndicesForCollapse(srcTy.getShape(), destTy.getShape());
-  if (reassociationIndices.has_value()) {
-    src = builder.create<tensor::CollapseShapeOp>(loc, destTy, src,
-                                                  reassociationIndices.value());
-  }
+// Builds an elementwise linalg.generic without inputs producing |resultTy|.
+// |bodyBuilder| computes each element from its row-major linear index within
+// |linearShape|, which may be padded relative to the result shape. Generating
+// directly into the result shape (instead of reshaping, concatenating, and
+// slicing intermediate tensors) keeps the generator a plain elementwise
+// producer that can be fused into and recomputed within its consumers so the
+// random values are never materialized.
+Value buildRandomGeneric(
+    OpBuilder &builder, Location loc, ShapedType resultTy,
+    ArrayRef<int64_t> linearShape,
+    function_ref<Value(OpBuilder &, Location, ArithOpBuilder)> bodyBuilder) {
+  int64_t rank = resultTy.getRank();
+  Value dest = builder.create<tensor::EmptyOp>(loc, resultTy.getShape(),
+                                               resultTy.getElementType());
+  SmallVector<AffineMap> indexingMaps(1, builder.getMultiDimIdentityMap(rank));
+  SmallVector<utils::IteratorType> iterators(rank,
+                                             utils::IteratorType::parallel);
+
+  auto generic = builder.create<linalg::GenericOp>(
+      loc, dest.getType(), /*inputs=*/ValueRange(),
+      /*outputs=*/ValueRange{dest},
+      /*indexingMaps=*/indexingMaps, iterators,
+      [&](OpBuilder &b, Location nestedLoc, ValueRange) {
+        std::optional<ArithOpBuilder> index;
+        int64_t stride = 1;
+        for (int64_t i = rank - 1; i >= 0; --i) {
+          ArithOpBuilder dimIndex =
+              ArithOpBuilder(b, nestedLoc, Value()).linalgIndex(i);
+          dimIndex = dimIndex.indexCast(64);
+          if (stride != 1) {
+            ArithOpBuilder dimStride = dimIndex.constantI(stride, 64);
+            dimIndex = dimIndex * dimStride;
+          }
+          index = index ? *index + dimIndex : dimIndex;
+          stride *= linearShape[i];
+        }
+        if (!index) {
+          index = ArithOpBuilder(b, nestedLoc, Value()).constantI(0, 64);
+        }
+        Value result = bodyBuilder(b, nestedLoc, *index);
+        b.create<linalg::YieldOp>(nestedLoc, result);
+      });
+  return generic.getResult(0);
+}
 
-  return src;
+// Selects |values[lane]| for the i64 |lane| computed within a generic body.
+Value selectLane(OpBuilder &b, Location loc, ArithOpBuilder lane,
+                 ArrayRef<Value> values) {
+  Value result = values.front();
+  for (int64_t i = 1, e = values.size(); i < e; ++i) {
+    Value laneIndex = lane.constantI(i, 64).val();
+    Value isLane = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                           lane.val(), laneIndex);
+    result = b.create<arith::SelectOp>(loc, isLane, values[i], result);
+  }
+  return result;
 }
 
 // Compute the shape for computing three fry.
@@ -339,12 +380,11 @@ std::pair<ShapedType, int64_t> threeFry32Shape(ShapedType resultTy) {
 }
 
 /// This implementation generates a 32-bit tensor of ThreeFry random numbers.
-/// It matches the XLA implementation bit-exact and includes an inefficient
-/// method of concatenating / slicing the pairs of generated numbers.
-///
-/// We should consider dropping the complex slicing and simply generating
-/// 2x the values, then downcast to a 32-bit. It substantially simplifies
-/// the computation and avoids the concat / slice behavior.
+/// It matches the XLA implementation bit-exact. XLA generates pairs of values
+/// over the result shape with one dimension halved and interleaves them by
+/// concatenating, reshaping, and slicing. Instead of materializing the pairs
+/// each element computes the counter and half of the pair it comes from so
+/// that the generator remains a single elementwise op.
 LogicalResult generateLinalgThreeFry32(OpBuilder &builder, Location loc,
                                        ShapedType resultTy, Value &store,
                                        Value &result) {
@@ -374,73 +414,48 @@ LogicalResult generateLinalgThreeFry32(OpBuilder &builder, Location loc,
       builder.create<arith::ConstantOp>(loc, builder.getI64IntegerAttr(count));
   Value newState = builder.create<arith::AddIOp>(loc, initialState, countVal);
 
-  // Generate a 1D tensor with for the random values.
-  Value destLeft = builder.create<tensor::EmptyOp>(
-      loc, ArrayRef<int64_t>({count}), resultETy);
-  Value destRight = builder.create<tensor::EmptyOp>(
-      loc, ArrayRef<int64_t>({count}), resultETy);
-
-  ShapedType destTy = llvm::cast<ShapedType>(destLeft.getType());
-
-  SmallVector<AffineMap> indexingMaps(2, builder.getMultiDimIdentityMap(1));
-  SmallVector<utils::IteratorType> iterators(1, utils::IteratorType::parallel);
-
-  linalg::GenericOp generic = builder.create<linalg::GenericOp>(
-      loc, TypeRange{destTy, destTy},
-      /*inputs=*/ValueRange(),
-      /*outputs=*/ValueRange{destLeft, destRight},
-      /*indexingMaps=*/indexingMaps, iterators,
-      [&](OpBuilder &b, Location nestedLoc, ValueRange) {
-        // Grab three fry results and write to each array.
-        auto split = runThreeFry2xi32(
-            key0, key1, ArithOpBuilder(b, nestedLoc, initialState));
+  // The pairs are concatenated on the dimension following the half dimension
+  // and collapsed back into it (rounded up to an even size) before slicing.
+  // Within each block of 2 * |pairStride| elements of the collapsed shape the
+  // first half holds the first values of the pairs and the second half the
+  // second values.
+  llvm::SmallVector<int64_t> collapseShape(resultTy.getShape());
+  int64_t pairStride = 1;
+  if (resultTy.getRank() != 0) {
+    collapseShape[halfDim] += collapseShape[halfDim] & 1;
+    for (int64_t dim : resultTy.getShape().drop_front(halfDim + 1))
+      pairStride *= dim;
+  }
+
+  result = buildRandomGeneric(
+      builder, loc, resultTy, collapseShape,
+      [&](OpBuilder &b, Location nestedLoc, ArithOpBuilder index) {
+        ArithOpBuilder stride = index.constantI(pairStride, 64);
+        ArithOpBuilder blockStride = index.constantI(2 * pairStride, 64);
+        ArithOpBuilder block = index / blockStride;
+        ArithOpBuilder offset = index % blockStride;
+        ArithOpBuilder half = offset / stride;
+        ArithOpBuilder element = offset % stride;
+        ArithOpBuilder counter = block * stride;
+        counter = counter + element;
+        ArithOpBuilder state(b, nestedLoc, initialState);
+        counter = counter + state;
+
+        // Grab the three fry pair and pick the value for this element.
+        auto split = runThreeFry2xi32(key0, key1, counter);
         auto first = split.first.truncI(resultETy.getIntOrFloatBitWidth());
         auto second = split.second.truncI(resultETy.getIntOrFloatBitWidth());
-        b.create<linalg::YieldOp>(loc, ValueRange{first.val(), second.val()});
+        return selectLane(b, nestedLoc, half, {first.val(), second.val()});
       });
 
-  if (resultTy.getNumElements() == 1) {
-    result = reshapeToTarget(builder, loc, resultTy, generic.getResult(0));
-    store = setState64(builder, loc, store, newState);
-    return success();
-  }
-
-  // Reshape to the target size and concatenate on the dimension following the
-  // half dimension.
-  Value random0 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(0));
-  Value random1 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(1));
-  Value concatenate = builder.create<mlir::stablehlo::ConcatenateOp>(
-      loc, ValueRange{random0, random1},
-      builder.getI64IntegerAttr(halfDim + 1));
-
-  // Collapse the concat dimension back into the parent.
-  llvm::SmallVector<int64_t> collapseShape(resultTy.getShape());
-  collapseShape[halfDim] =
-      collapseShape[halfDim] + (collapseShape[halfDim] & 1);
-  Value reshape = builder.create<mlir::stablehlo::ReshapeOp>(
-      loc, resultTy.clone(collapseShape), concatenate);
-
-  // Slice to only the required results.
-  llvm::SmallVector<int64_t> offset(resultTy.getRank(), 0);
-  llvm::SmallVector<int64_t> stride(resultTy.getRank(), 1);
-  Value slice = builder.create<mlir::stablehlo::SliceOp>(
-      loc, resultTy, reshape, builder.getI64TensorAttr(offset),
-      builder.getI64TensorAttr(resultTy.getShape()),
-      builder.getI64TensorAttr(stride));
-
   // Set the new tensor values.
   store = setState64(builder, loc, store, newState);
-  result = slice;
-
   return success();
 }
 
 LogicalResult generateLinalgThreeFry64(OpBuilder &builder, Location loc,
                                        ShapedType resultTy, Value &store,
                                        Value &result) {
-  Type resultETy = resultTy.getElementType();
   int64_t count = resultTy.getNumElements();
 
   // Extract the stateful values as an i64 and increment the state ahead.
@@ -460,29 +475,17 @@ LogicalResult generateLinalgThreeFry64(OpBuilder &builder, Location loc,
       builder.create<arith::ConstantOp>(loc, builder.getI64IntegerAttr(count));
   Value newState = builder.create<arith::AddIOp>(loc, initialState, countVal);
 
-  // Generate a 1D tensor with for the random values.
-  Value dest = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                               resultETy);
-  ShapedType destTy = llvm::cast<ShapedType>(dest.getType());
-
-  SmallVector<AffineMap> indexingMaps(1, builder.getMultiDimIdentityMap(1));
-  SmallVector<utils::IteratorType> iterators(1, utils::IteratorType::parallel);
-
-  auto random = builder.create<linalg::GenericOp>(
-      loc, destTy, /*inputs=*/ValueRange(),
-      /*outputs=*/ValueRange{dest},
-      /*indexingMaps=*/indexingMaps, iterators,
-      [&](OpBuilder &b, Location nestedLoc, ValueRange) {
+  result = buildRandomGeneric(
+      builder, loc, resultTy, resultTy.getShape(),
+      [&](OpBuilder &b, Location nestedLoc, ArithOpBuilder index) {
         // Generate three fry results, fuse, and return an
         // i64.
-        auto split = runThreeFry2xi32(
-            key0, key1, ArithOpBuilder(b, nestedLoc, initialState));
-        Value result = fuseI32s(split.first, split.second).val();
-        b.create<linalg::YieldOp>(nestedLoc, result);
+        ArithOpBuilder state(b, nestedLoc, initialState);
+        auto split = runThreeFry2xi32(key0, key1, index + state);
+        return fuseI32s(split.first, split.second).val();
       });
 
   store = setState64(builder, loc, store, newState);
-  result = reshapeToTarget(builder, loc, resultTy, random.getResult(0));
   return success();
 }
 
@@ -527,14 +530,11 @@ PhiloxKey raiseKey(PhiloxKey key) {
 // The Philox PRNG has been proposed in:
 // Salmon et al. SC 2011. Parallel random numbers: as easy as 1, 2, 3.
 // http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+// |counter| is the i64 counter (state + offset) of the block being generated.
 std::array<ArithOpBuilder, 4> runPhilox4x32(PhiloxKey key,
-                                            ArithOpBuilder state) {
-  ArithOpBuilder index = state.linalgIndex(0);
-  index = index.indexCast(64);
-  index = index + state;
-
+                                            ArithOpBuilder counter) {
   // Split into the 2xi32 used for threefry.
-  std::pair<ArithOpBuilder, ArithOpBuilder> input = splitI64(index);
+  std::pair<ArithOpBuilder, ArithOpBuilder> input = splitI64(counter);
   ArithOpBuilder input0 = input.first;
   ArithOpBuilder input1 = input.second;
 
@@ -551,7 +551,8 @@ std::array<ArithOpBuilder, 4> runPhilox4x32(PhiloxKey key,
 
 // Generates an array of primitive type U32 with the given shape containing
 // random bits generated by the Philox algorithm. Returns the array and the new
-// state of the random number generator.
+// state of the random number generator. Each counter generates a block of four
+// consecutive elements.
 LogicalResult generateLinalgPhilox32(OpBuilder &builder, Location loc,
                                      ShapedType resultTy, Value &store,
                                      Value &result) {
@@ -567,96 +568,41 @@ LogicalResult generateLinalgPhilox32(OpBuilder &builder, Location loc,
 
   int64_t numElements = resultTy.getNumElements();
   int64_t count = (numElements + 3) / 4;
-  ShapedType intermediateType =
-      RankedTensorType::get({count, 1}, resultTy.getElementType());
-  int64_t concatDim = 1;
 
   // Compute the number of random i64s generated and increment state.
   Value countVal =
       builder.create<arith::ConstantOp>(loc, builder.getI64IntegerAttr(count));
   Value newState = builder.create<arith::AddIOp>(loc, initialState, countVal);
 
-  // set up four outputs
-  Value dest0 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-  Value dest1 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-  Value dest2 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-  Value dest3 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-
-  ShapedType destTy = dest0.getType().cast<ShapedType>();
-
-  SmallVector<AffineMap> indexingMaps(4, builder.getMultiDimIdentityMap(1));
-  SmallVector<utils::IteratorType> iterators(1, utils::IteratorType::parallel);
-
-  linalg::GenericOp generic = builder.create<linalg::GenericOp>(
-      loc, TypeRange{destTy, destTy, destTy, destTy},
-      /*inputs=*/ValueRange(),
-      /*outputs=*/ValueRange{dest0, dest1, dest2, dest3},
-      /*indexingMaps=*/indexingMaps, iterators,
-      [&](OpBuilder &b, Location nestedLoc, ValueRange) {
+  result = buildRandomGeneric(
+      builder, loc, resultTy, resultTy.getShape(),
+      [&](OpBuilder &b, Location nestedLoc, ArithOpBuilder index) {
+        ArithOpBuilder lanes = index.constantI(4, 64);
+        ArithOpBuilder counter = index / lanes;
+        ArithOpBuilder lane = index % lanes;
+        ArithOpBuilder state(b, nestedLoc, initialState);
+        counter = counter + state;
         auto output =
             runPhilox4x32(PhiloxKey{ArithOpBuilder(b, nestedLoc, keys.first),
                                     ArithOpBuilder(b, nestedLoc, keys.second)},
-                          ArithOpBuilder(b, nestedLoc, initialState));
-        auto out0 = output[0].truncI(resultETy.getIntOrFloatBitWidth());
-        auto out1 = output[1].truncI(resultETy.getIntOrFloatBitWidth());
-        auto out2 = output[2].truncI(resultETy.getIntOrFloatBitWidth());
-        auto out3 = output[3].truncI(resultETy.getIntOrFloatBitWidth());
-        b.create<linalg::YieldOp>(
-            loc, ValueRange{out0.val(), out1.val(), out2.val(), out3.val()});
+                          counter);
+        SmallVector<Value> values;
+        for (ArithOpBuilder value : output) {
+          values.push_back(
+              value.truncI(resultETy.getIntOrFloatBitWidth()).val());
+        }
+        return selectLane(b, nestedLoc, lane, values);
       });
 
-  if (resultTy.getNumElements() == 1) {
-    result = reshapeToTarget(builder, loc, resultTy, generic.getResult(0));
-    store = setState64(builder, loc, store, newState);
-    return success();
-  }
-
-  Value r0 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(0));
-  Value r1 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(1));
-  Value r2 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(2));
-  Value r3 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(3));
-
-  Value concatenate = builder.create<mlir::stablehlo::ConcatenateOp>(
-      loc, ValueRange{r0, r1, r2, r3}, builder.getI64IntegerAttr(concatDim));
-
-  // Collapse the concat dimension back into the parent.
-  llvm::SmallVector<int64_t> collapseShape(intermediateType.getShape());
-  collapseShape[0] = collapseShape[0] * 4;
-  Value reshapeIntermediate = builder.create<mlir::stablehlo::ReshapeOp>(
-      loc, resultTy.clone(collapseShape), concatenate);
-
-  // Slice to only the required results.
-  collapseShape[0] = resultTy.getNumElements();
-
-  llvm::SmallVector<int64_t> offset(resultTy.getRank(), 0);
-  llvm::SmallVector<int64_t> stride(resultTy.getRank(), 1);
-  Value slice = builder.create<mlir::stablehlo::SliceOp>(
-      loc, intermediateType.clone(collapseShape), reshapeIntermediate,
-      builder.getI64TensorAttr(offset), builder.getI64TensorAttr(collapseShape),
-      builder.getI64TensorAttr(stride));
-  Value reshapeResult =
-      builder.create<mlir::stablehlo::ReshapeOp>(loc, resultTy, slice);
-
   // Set the new tensor values.
   store = setState64(builder, loc, store, newState);
-  result = reshapeResult;
-
   return success();
 }
 
+// Each counter generates a block of two consecutive elements.
 LogicalResult generateLinalgPhilox64(OpBuilder &builder, Location loc,
                                      ShapedType resultTy, Value &store,
                                      Value &result) {
-  Type resultETy = resultTy.getElementType();
-
   Value initialState = extractState64(builder, loc, store);
   if (!initialState)
     return failure();
@@ -667,79 +613,31 @@ LogicalResult generateLinalgPhilox64(OpBuilder &builder, Location loc,
 
   int64_t numElements = resultTy.getNumElements();
   int64_t count = (numElements + 1) / 2;
-  ShapedType intermediateType =
-      RankedTensorType::get({count, 1}, resultTy.getElementType());
-  int64_t concatDim = 1;
 
   // Compute the number of random i64s generated and increment state.
   Value countVal =
       builder.create<arith::ConstantOp>(loc, builder.getI64IntegerAttr(count));
   Value newState = builder.create<arith::AddIOp>(loc, initialState, countVal);
 
-  // set up four outputs
-  Value dest0 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-  Value dest1 = builder.create<tensor::EmptyOp>(loc, ArrayRef<int64_t>({count}),
-                                                resultETy);
-  ShapedType destTy = dest0.getType().cast<ShapedType>();
-
-  SmallVector<AffineMap> indexingMaps(2, builder.getMultiDimIdentityMap(1));
-  SmallVector<utils::IteratorType> iterators(1, utils::IteratorType::parallel);
-
-  linalg::GenericOp generic = builder.create<linalg::GenericOp>(
-      loc, TypeRange{destTy, destTy},
-      /*inputs=*/ValueRange(),
-      /*outputs=*/ValueRange{dest0, dest1},
-      /*indexingMaps=*/indexingMaps, iterators,
-      [&](OpBuilder &b, Location nestedLoc, ValueRange) {
+  result = buildRandomGeneric(
+      builder, loc, resultTy, resultTy.getShape(),
+      [&](OpBuilder &b, Location nestedLoc, ArithOpBuilder index) {
+        ArithOpBuilder lanes = index.constantI(2, 64);
+        ArithOpBuilder counter = index / lanes;
+        ArithOpBuilder lane = index % lanes;
+        ArithOpBuilder state(b, nestedLoc, initialState);
+        counter = counter + state;
         auto output =
             runPhilox4x32(PhiloxKey{ArithOpBuilder(b, nestedLoc, keys.first),
                                     ArithOpBuilder(b, nestedLoc, keys.second)},
-                          ArithOpBuilder(b, nestedLoc, initialState));
-        auto out0 = output[0];
-        auto out1 = output[1];
-        auto out2 = output[2];
-        auto out3 = output[3];
-        Value result1 = fuseI32s(out0, out1).val();
-        Value result2 = fuseI32s(out2, out3).val();
-        b.create<linalg::YieldOp>(loc, ValueRange{result1, result2});
+                          counter);
+        Value result0 = fuseI32s(output[0], output[1]).val();
+        Value result1 = fuseI32s(output[2], output[3]).val();
+        return selectLane(b, nestedLoc, lane, {result0, result1});
       });
 
-  if (resultTy.getNumElements() == 1) {
-    result = reshapeToTarget(builder, loc, resultTy, generic.getResult(0));
-    store = setState64(builder, loc, store, newState);
-    return success();
-  }
-
-  Value r0 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(0));
-  Value r1 =
-      reshapeToTarget(builder, loc, intermediateType, generic.getResult(1));
-  Value concatenate = builder.create<mlir::stablehlo::ConcatenateOp>(
-      loc, ValueRange{r0, r1}, builder.getI64IntegerAttr(concatDim));
-
-  // Collapse the concat dimension back into the parent.
-  llvm::SmallVector<int64_t> collapseShape(intermediateType.getShape());
-  collapseShape[0] = collapseShape[0] * 2;
-  Value reshapeIntermediate = builder.create<mlir::stablehlo::ReshapeOp>(
-      loc, resultTy.clone(collapseShape), concatenate);
-
-  // Slice to only the required results.
-  collapseShape[0] = resultTy.getNumElements();
-
-  llvm::SmallVector<int64_t> offset(resultTy.getRank(), 0);
-  llvm::SmallVector<int64_t> stride(resultTy.getRank(), 1);
-  Value slice = builder.create<mlir::stablehlo::SliceOp>(
-      loc, intermediateType.clone(collapseShape), reshapeIntermediate,
-      builder.getI64TensorAttr(offset), builder.getI64TensorAttr(collapseShape),
-      builder.getI64TensorAttr(stride));
-  Value reshapeResult =
-      builder.create<mlir::stablehlo::ReshapeOp>(loc, resultTy, slice);
-
   // Set the new tensor values.
   store = setState64(builder, loc, store, newState);
-  result = reshapeResult;
-
   return success();
 }
 
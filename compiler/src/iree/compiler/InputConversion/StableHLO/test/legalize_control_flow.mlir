@@ -32,6 +32,8 @@ func.func @while(%arg0: tensor<1xi64>) -> tensor<1xi64> {
 }
 
 
+// Constants in the condition and body are hoisted and the loop is recognized
+// as a for loop.
 // CHECK-LABEL: func @while_multi_operands(
 // CHECK-SAME:    %[[VAL_0:.*]]: tensor<3xi32>) -> tuple<tensor<i32>, tensor<3xi32>> {
 func.func @while_multi_operands(%arg0: tensor<3xi32>) -> tuple<tensor<i32>, tensor<3xi32>> {
@@ -41,32 +43,30 @@ func.func @while_multi_operands(%arg0: tensor<3xi32>) -> tuple<tensor<i32>, tens
   %0 = stablehlo.constant dense<false> : tensor<i1>
   %1 = stablehlo.constant dense<0> : tensor<i32>
 
-  // CHECK: %[[VAL_3:.*]]:2 = scf.while (%[[VAL_4:.*]] = %[[VAL_2]], %[[VAL_5:.*]] = %[[VAL_0]]) : (tensor<i32>, tensor<3xi32>) -> (tensor<i32>, tensor<3xi32>) {
+  // CHECK-NEXT: %[[VAL_6:.*]] = stablehlo.constant dense<false> : tensor<i1>
+  // CHECK-NEXT: %[[VAL_7:.*]] = stablehlo.constant dense<8> : tensor<i32>
+  // CHECK-NEXT: %[[VAL_12:.*]] = stablehlo.constant dense<false> : tensor<i1>
+  // CHECK-NEXT: %[[VAL_13:.*]] = stablehlo.constant dense<1> : tensor<i32>
+  // CHECK-DAG: %[[LB:.*]] = tensor.extract %[[VAL_2]][] : tensor<i32>
+  // CHECK-DAG: %[[UB:.*]] = tensor.extract %[[VAL_7]][] : tensor<i32>
+  // CHECK-DAG: %[[STEP:.*]] = tensor.extract %[[VAL_13]][] : tensor<i32>
+  // CHECK: %[[VAL_3:.*]]:2 = scf.for %[[I:.*]] = %[[LB]] to %[[UB]] step %[[STEP]]
+  // CHECK-SAME: iter_args(%[[VAL_4:.*]] = %[[VAL_2]], %[[VAL_5:.*]] = %[[VAL_0]])
   %2:2 = "stablehlo.while"(%1, %arg0) ({
   ^bb0(%arg1: tensor<i32> , %arg2: tensor<3xi32> ):
-
-    // CHECK-NEXT: %[[VAL_6:.*]] = stablehlo.constant dense<false> : tensor<i1>
-    // CHECK-NEXT: %[[VAL_7:.*]] = stablehlo.constant dense<8> : tensor<i32>
-    // CHECK: %[[VAL_8:.*]] = stablehlo.compare LT, %[[VAL_4]], %[[VAL_7]] : (tensor<i32>, tensor<i32>) -> tensor<i1>
-    // CHECK: %[[VAL_9:.*]] = tensor.extract %[[VAL_8]][] : tensor<i1>
-    // CHECK: scf.condition(%[[VAL_9]]) %[[VAL_4]], %[[VAL_5]] : tensor<i32>, tensor<3xi32>
     %4 = stablehlo.constant dense<false> : tensor<i1>
     %5 = stablehlo.constant dense<8> : tensor<i32>
     %6 = "stablehlo.compare"(%arg1, %5) {comparison_direction = #stablehlo<comparison_direction LT>} : (tensor<i32>, tensor<i32>) -> tensor<i1>
     "stablehlo.return"(%6) : (tensor<i1>) -> ()
   },  {
-
-  // CHECK: } do {
-  // CHECK: ^bb0(%[[VAL_10:.*]]: tensor<i32>, %[[VAL_11:.*]]: tensor<3xi32>):
   ^bb0(%arg1: tensor<i32>, %arg2: tensor<3xi32>):
 
-    // CHECK-NEXT: %[[VAL_12:.*]] = stablehlo.constant dense<false> : tensor<i1>
-    // CHECK-NEXT: %[[VAL_13:.*]] = stablehlo.constant dense<1> : tensor<i32>
-    // CHECK: %[[VAL_14:.*]] = stablehlo.add %[[VAL_10]], %[[VAL_13]] : tensor<i32>
-    // CHECK: %[[VAL_15:.*]] = stablehlo.convert %[[VAL_10]] : tensor<i32>
-    // CHECK: %[[VAL_16:.*]] = stablehlo.broadcast_in_dim %[[VAL_15]], dims = [] : (tensor<i32>) -> tensor<3xi32>
-    // CHECK: %[[VAL_17:.*]] = stablehlo.add %[[VAL_11]], %[[VAL_16]] : tensor<3xi32>
-    // CHECK: scf.yield %[[VAL_14]], %[[VAL_17]] : tensor<i32>, tensor<3xi32>
+    // CHECK-NEXT: %[[VAL_10:.*]] = tensor.from_elements %[[I]] : tensor<i32>
+    // CHECK-NEXT: %[[VAL_14:.*]] = stablehlo.add %[[VAL_10]], %[[VAL_13]] : tensor<i32>
+    // CHECK-NEXT: %[[VAL_15:.*]] = stablehlo.convert %[[VAL_10]] : tensor<i32>
+    // CHECK-NEXT: %[[VAL_16:.*]] = stablehlo.broadcast_in_dim %[[VAL_15]], dims = [] : (tensor<i32>) -> tensor<3xi32>
+    // CHECK-NEXT: %[[VAL_17:.*]] = stablehlo.add %[[VAL_5]], %[[VAL_16]] : tensor<3xi32>
+    // CHECK-NEXT: scf.yield %[[VAL_14]], %[[VAL_17]] : tensor<i32>, tensor<3xi32>
     %4 = stablehlo.constant dense<false> : tensor<i1>
     %5 = stablehlo.constant dense<1> : tensor<i32>
     %6 = stablehlo.add %arg1, %5 : tensor<i32>
@@ -76,12 +76,54 @@ func.func @while_multi_operands(%arg0: tensor<3xi32>) -> tuple<tensor<i32>, tens
     "stablehlo.return"(%6, %9) : (tensor<i32>, tensor<3xi32>) -> ()
   }) : (tensor<i32>, tensor<3xi32>) -> (tensor<i32>, tensor<3xi32>)
 
-  // CHECK: %[[VAL_18:.*]] = stablehlo.tuple %[[VAL_19:.*]]#0, %[[VAL_19]]#1 {xla_shape = "(s32[], s32[3]{0})"} : tuple<tensor<i32>, tensor<3xi32>>
+  // CHECK: %[[VAL_18:.*]] = stablehlo.tuple %[[VAL_3]]#0, %[[VAL_3]]#1 {xla_shape = "(s32[], s32[3]{0})"} : tuple<tensor<i32>, tensor<3xi32>>
   // CHECK: return %[[VAL_18]] : tuple<tensor<i32>, tensor<3xi32>>
   %3 = "stablehlo.tuple"(%2#0, %2#1) {xla_shape = "(s32[], s32[3]{0})"} : (tensor<i32>, tensor<3xi32>) -> tuple<tensor<i32>, tensor<3xi32>>
   func.return %3 : tuple<tensor<i32>, tensor<3xi32>>
 }
 
+// Loop-invariant computations (including those with regions and those
+// depending on other hoisted values) are hoisted out of the loop body while
+// iteration-dependent computations remain.
+// CHECK-LABEL: func @while_hoist_invariants(
+// CHECK-SAME:    %[[STATE:.*]]: tensor<4xf32>, %[[WEIGHTS:.*]]: tensor<4x4xf32>, %[[BIAS:.*]]: tensor<f32>)
+func.func @while_hoist_invariants(%state: tensor<4xf32>, %weights: tensor<4x4xf32>, %bias: tensor<f32>) -> tensor<4xf32> {
+  // CHECK: %[[SUM:.*]] = stablehlo.reduce
+  // CHECK: %[[TRANSPOSE:.*]] = {{.*}}stablehlo.transpose{{.*}}%[[WEIGHTS]]
+  // CHECK: %[[BROADCAST:.*]] = stablehlo.broadcast_in_dim %[[BIAS]]
+  // CHECK: scf.while (%[[ITER:.*]] = %[[STATE]])
+  // CHECK-NOT: stablehlo.transpose
+  // CHECK-NOT: stablehlo.reduce
+  // CHECK: } do {
+  // CHECK: ^bb0(%[[BODY_ITER:.*]]: tensor<4xf32>):
+  // CHECK-NEXT: %[[DOT:.*]] = {{.*}}stablehlo.dot{{.*}}%[[TRANSPOSE]], %[[BODY_ITER]]
+  // CHECK-NEXT: %[[ADD:.*]] = stablehlo.add %[[DOT]], %[[BROADCAST]]
+  // CHECK-NEXT: scf.yield %[[ADD]]
+  %0 = stablehlo.while(%iter = %state) : tensor<4xf32> cond {
+    %init = stablehlo.constant dense<0.0> : tensor<f32>
+    %sum = stablehlo.reduce(%weights init: %init) across dimensions = [0, 1] : (tensor<4x4xf32>, tensor<f32>) -> tensor<f32>
+      reducer(%lhs: tensor<f32>, %rhs: tensor<f32>) {
+        %add = stablehlo.add %lhs, %rhs : tensor<f32>
+        stablehlo.return %add : tensor<f32>
+      }
+    %first = "stablehlo.slice"(%iter) {
+      start_indices = dense<0> : tensor<1xi64>,
+      limit_indices = dense<1> : tensor<1xi64>,
+      strides = dense<1> : tensor<1xi64>
+    } : (tensor<4xf32>) -> tensor<1xf32>
+    %first_scalar = stablehlo.reshape %first : (tensor<1xf32>) -> tensor<f32>
+    %cmp = stablehlo.compare LT, %first_scalar, %sum : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    stablehlo.return %cmp : tensor<i1>
+  } do {
+    %transpose = "stablehlo.transpose"(%weights) {permutation = dense<[1, 0]> : tensor<2xi64>} : (tensor<4x4xf32>) -> tensor<4x4xf32>
+    %broadcast = "stablehlo.broadcast_in_dim"(%bias) {broadcast_dimensions = dense<> : tensor<0xi64>} : (tensor<f32>) -> tensor<4xf32>
+    %dot = "stablehlo.dot"(%transpose, %iter) : (tensor<4x4xf32>, tensor<4xf32>) -> tensor<4xf32>
+    %add = stablehlo.add %dot, %broadcast : tensor<4xf32>
+    stablehlo.return %add : tensor<4xf32>
+  }
+  func.return %0 : tensor<4xf32>
+}
+
 // CHECK-LABEL: func @conditional(
 // CHECK-SAME:    %[[VAL_0:.*]]: tensor<f32>) -> tensor<f32> {
 func.func @conditional(%arg0: tensor<f32>) -> tensor<f32> {
@@ -309,6 +309,69 @@ func.func @scatter_update_slice_2D(%arg0: tensor<6x3xi32>, %arg1: tensor<2x1xi32
 
 // -----
 
+// Indices produced by an iota are known to be unique.
+// CHECK-LABEL: func.func @scatter_add_iota_indices
+func.func @scatter_add_iota_indices(%arg0: tensor<8xf32>, %arg1: tensor<4xf32>) -> tensor<8xf32> {
+  %indices = "stablehlo.iota"() {iota_dimension = 0 : i64} : () -> tensor<4xi32>
+  %indices_2d = stablehlo.reshape %indices : (tensor<4xi32>) -> tensor<4x1xi32>
+  %0 = "stablehlo.scatter"(%arg0, %indices_2d, %arg1) ( {
+  ^bb0(%arg3: tensor<f32>, %arg4: tensor<f32>):
+    %1 = stablehlo.add %arg3, %arg4 : tensor<f32>
+    "stablehlo.return"(%1) : (tensor<f32>) -> ()
+  }) {
+    indices_are_sorted = false,
+    scatter_dimension_numbers = #stablehlo.scatter<
+      inserted_window_dims = [0],
+      scatter_dims_to_operand_dims = [0],
+      index_vector_dim = 1,
+    >,
+    unique_indices = false
+  } : (tensor<8xf32>, tensor<4x1xi32>, tensor<4xf32>) -> tensor<8xf32>
+  return %0 : tensor<8xf32>
+}
+// CHECK:         iree_linalg_ext.scatter
+// CHECK-SAME:      unique_indices(true)
+
+// -----
+
+// Constant indices are checked for duplicate index tuples.
+// CHECK-LABEL: func.func @scatter_add_constant_indices
+func.func @scatter_add_constant_indices(%arg0: tensor<4x3xi32>, %arg1: tensor<3xi32>) -> (tensor<4x3xi32>, tensor<4x3xi32>) {
+  %unique = stablehlo.constant dense<[[0, 1], [1, 0], [2, 2]]> : tensor<3x2xi32>
+  %duplicate = stablehlo.constant dense<[[0, 1], [1, 0], [0, 1]]> : tensor<3x2xi32>
+  %0 = "stablehlo.scatter"(%arg0, %unique, %arg1) ( {
+  ^bb0(%arg3: tensor<i32>, %arg4: tensor<i32>):
+    %2 = stablehlo.add %arg3, %arg4 : tensor<i32>
+    "stablehlo.return"(%2) : (tensor<i32>) -> ()
+  }) {indices_are_sorted = false,
+      scatter_dimension_numbers = #stablehlo.scatter<
+        inserted_window_dims = [0, 1],
+        scatter_dims_to_operand_dims = [0, 1],
+        index_vector_dim = 1,
+      >,
+      unique_indices = false
+  } : (tensor<4x3xi32>, tensor<3x2xi32>, tensor<3xi32>) -> tensor<4x3xi32>
+  %1 = "stablehlo.scatter"(%arg0, %duplicate, %arg1) ( {
+  ^bb0(%arg3: tensor<i32>, %arg4: tensor<i32>):
+    %2 = stablehlo.add %arg3, %arg4 : tensor<i32>
+    "stablehlo.return"(%2) : (tensor<i32>) -> ()
+  }) {indices_are_sorted = false,
+      scatter_dimension_numbers = #stablehlo.scatter<
+        inserted_window_dims = [0, 1],
+        scatter_dims_to_operand_dims = [0, 1],
+        index_vector_dim = 1,
+      >,
+      unique_indices = false
+  } : (tensor<4x3xi32>, tensor<3x2xi32>, tensor<3xi32>) -> tensor<4x3xi32>
+  return %0, %1 : tensor<4x3xi32>, tensor<4x3xi32>
+}
+// CHECK:         iree_linalg_ext.scatter
+// CHECK-SAME:      unique_indices(true)
+// CHECK:         iree_linalg_ext.scatter
+// CHECK-SAME:      unique_indices(false)
+
+// -----
+
 // CHECK-LABEL: func.func @scatter_add_slice_2D
 func.func @scatter_add_slice_2D(%arg0: tensor<6x3xi32>, %arg1: tensor<2x1xi32>,
     %arg2: tensor<2x3xi32>) -> tensor<6x3xi32> {
@@ -215,37 +215,35 @@ func.func @three_fry_i32(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi32>)
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi32>)
   return %output_state, %output : tensor<2xi64>, tensor<8xi32>
 }
-// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
 // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1_I64:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C2_I64:.+]] = arith.constant 2 : i64
 // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C4]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<4xi32>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<4xi32>
-// CHECK: %[[GENERIC:.+]]:2 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map]
+// Both values of each pair are generated and selected between in a single
+// elementwise op without materializing the pairs.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi32>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]] : tensor<4xi32>, tensor<4xi32>)
-
-// CHECK: %expanded = tensor.expand_shape %[[GENERIC]]#0
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<4x1xi32>
-
-// CHECK: %expanded_1 = tensor.expand_shape %[[GENERIC]]#1
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<4x1xi32>
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<4x2xi32>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<4x2xi32>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4x2xi32> into tensor<8xi32>
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi32>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[HALF:.+]] = arith.remui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK:   %[[IS_SECOND:.+]] = arith.cmpi eq, %[[HALF]], %[[C1_I64]] : i64
+// CHECK:   %[[SELECT:.+]] = arith.select %[[IS_SECOND]], %{{.+}}, %{{.+}} : i32
+// CHECK:   linalg.yield %[[SELECT]] : i32
+// CHECK-NOT: tensor.expand_shape
+// CHECK-NOT: tensor.collapse_shape
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: return %[[INSERTED]], %[[COLLAPSE]]
-
+// CHECK: return %[[INSERTED]], %[[GENERIC]] : tensor<2xi64>, tensor<8xi32>
 
 // -----
 
@@ -255,37 +253,37 @@ func.func @three_fry_odd_i32(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<7x1
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<7x11xi32>)
   return %output_state, %output : tensor<2xi64>, tensor<7x11xi32>
 }
-// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
 // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C2_I64:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C12:.+]] = arith.constant 12 : i64
 // CHECK-DAG: %[[C42:.+]] = arith.constant 42 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C42]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<42xi32>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<42xi32>
-// CHECK: %[[GENERIC:.+]]:2 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map]
-// CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]] : tensor<42xi32>, tensor<42xi32>)
-
-// CHECK: %expanded = tensor.expand_shape %[[GENERIC]]#0
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<7x6x1xi32>
-
-// CHECK: %expanded_1 = tensor.expand_shape %[[GENERIC]]#1
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<7x6x1xi32>
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<7x6x2xi32>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<7x6x2xi32>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %10
-// CHECK-SAME{literal}: [[0], [1, 2]] : tensor<7x6x2xi32> into tensor<7x12xi32>
-
-// CHECK: %[[SLICE:.+]] = tensor.extract_slice %[[COLLAPSE]][0, 0] [7, 11] [1, 1]
+// The linear index is computed within the 7x12 shape the pairs are collapsed
+// into so that the padding element of each row is skipped.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<7x11xi32>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
+// CHECK-SAME: iterator_types = ["parallel", "parallel"]}
+// CHECK-SAME: outs(%[[DEST]] : tensor<7x11xi32>)
+// CHECK-DAG:   %[[IDX0:.+]] = linalg.index 0 : index
+// CHECK-DAG:   %[[IDX1:.+]] = linalg.index 1 : index
+// CHECK-DAG:   %[[IDX0_I64:.+]] = arith.index_cast %[[IDX0]] : index to i64
+// CHECK-DAG:   %[[IDX1_I64:.+]] = arith.index_cast %[[IDX1]] : index to i64
+// CHECK-DAG:   %[[ROW:.+]] = arith.muli %[[IDX0_I64]], %[[C12]] : i64
+// CHECK-DAG:   %[[LINEAR:.+]] = arith.addi %[[IDX1_I64]], %[[ROW]] : i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[LINEAR]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[HALF:.+]] = arith.remui %[[LINEAR]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK:   %[[IS_SECOND:.+]] = arith.cmpi eq, %[[HALF]], %{{.+}} : i64
+// CHECK:   %[[SELECT:.+]] = arith.select %[[IS_SECOND]], %{{.+}}, %{{.+}} : i32
+// CHECK:   linalg.yield %[[SELECT]] : i32
+// CHECK-NOT: tensor.extract_slice
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
-// CHECK: return %[[INSERTED]], %[[SLICE]] : tensor<2xi64>, tensor<7x11xi32>
+// CHECK: return %[[INSERTED]], %[[GENERIC]] : tensor<2xi64>, tensor<7x11xi32>
 
 // -----
 
@@ -295,36 +293,35 @@ func.func @three_fry_i16(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi16>)
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi16>)
   return %output_state, %output : tensor<2xi64>, tensor<8xi16>
 }
-// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
 // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1_I64:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C2_I64:.+]] = arith.constant 2 : i64
 // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C4]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<4xi16>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<4xi16>
-// CHECK: %[[GENERIC:.+]]:2 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map]
+// Both values of each pair are generated and selected between in a single
+// elementwise op without materializing the pairs.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi16>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]] : tensor<4xi16>, tensor<4xi16>)
-
-// CHECK: %expanded = tensor.expand_shape %[[GENERIC]]#0
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi16> into tensor<4x1xi16>
-
-// CHECK: %expanded_1 = tensor.expand_shape %[[GENERIC]]#1
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi16> into tensor<4x1xi16>
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<4x2xi16>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<4x2xi16>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4x2xi16> into tensor<8xi16>
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi16>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[HALF:.+]] = arith.remui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK:   %[[IS_SECOND:.+]] = arith.cmpi eq, %[[HALF]], %[[C1_I64]] : i64
+// CHECK:   %[[SELECT:.+]] = arith.select %[[IS_SECOND]], %{{.+}}, %{{.+}} : i16
+// CHECK:   linalg.yield %[[SELECT]] : i16
+// CHECK-NOT: tensor.expand_shape
+// CHECK-NOT: tensor.collapse_shape
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: return %[[INSERTED]], %[[COLLAPSE]] : tensor<2xi64>, tensor<8xi16>
+// CHECK: return %[[INSERTED]], %[[GENERIC]] : tensor<2xi64>, tensor<8xi16>
 
 // -----
 
@@ -334,36 +331,35 @@ func.func @three_fry_i8(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi8>) {
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi8>)
   return %output_state, %output : tensor<2xi64>, tensor<8xi8>
 }
-// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
 // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1_I64:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C2_I64:.+]] = arith.constant 2 : i64
 // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C4]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<4xi8>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<4xi8>
-// CHECK: %[[GENERIC:.+]]:2 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map]
+// Both values of each pair are generated and selected between in a single
+// elementwise op without materializing the pairs.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi8>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]] : tensor<4xi8>, tensor<4xi8>)
-
-// CHECK: %expanded = tensor.expand_shape %[[GENERIC]]#0
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi8> into tensor<4x1xi8>
-
-// CHECK: %expanded_1 = tensor.expand_shape %[[GENERIC]]#1
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi8> into tensor<4x1xi8>
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<4x2xi8>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<4x2xi8>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4x2xi8> into tensor<8xi8>
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi8>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[HALF:.+]] = arith.remui %[[IDX_I64]], %[[C2_I64]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK:   %[[IS_SECOND:.+]] = arith.cmpi eq, %[[HALF]], %[[C1_I64]] : i64
+// CHECK:   %[[SELECT:.+]] = arith.select %[[IS_SECOND]], %{{.+}}, %{{.+}} : i8
+// CHECK:   linalg.yield %[[SELECT]] : i8
+// CHECK-NOT: tensor.expand_shape
+// CHECK-NOT: tensor.collapse_shape
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: return %[[INSERTED]], %[[COLLAPSE]] : tensor<2xi64>, tensor<8xi8>
+// CHECK: return %[[INSERTED]], %[[GENERIC]] : tensor<2xi64>, tensor<8xi8>
 
 // -----
 
@@ -405,13 +401,14 @@ func.func @philox_i64(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi64>) {
 // CHECK-DAG: %[[VAL_28:.*]] = arith.shrui %[[VAL_26]], %[[VAL_23]] : i64
 // CHECK-DAG: %[[VAL_29:.*]] = arith.trunci %[[VAL_28]] : i64 to i32
 // CHECK-DAG: %[[VAL_30:.*]] = arith.addi %[[VAL_25]], %[[VAL_22]] : i64
-// CHECK-DAG: %[[VAL_31:.*]] = tensor.empty() : tensor<4xi64>
-// CHECK-DAG: %[[VAL_32:.*]] = tensor.empty() : tensor<4xi64>
-// CHECK-DAG: %[[VAL_33:.*]]:2 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} outs(%[[VAL_31]], %[[VAL_32]] : tensor<4xi64>, tensor<4xi64>) {
-// CHECK-DAG: ^bb0(%[[VAL_34:.*]]: i64, %[[VAL_35:.*]]: i64):
+// CHECK-DAG: %[[VAL_31:.*]] = tensor.empty() : tensor<8xi64>
+// CHECK-DAG: %[[VAL_33:.*]] = linalg.generic {indexing_maps = [#map], iterator_types = ["parallel"]} outs(%[[VAL_31]] : tensor<8xi64>) {
+// CHECK-DAG: ^bb0(%[[VAL_34:.*]]: i64):
 // CHECK-DAG:   %[[VAL_36:.*]] = linalg.index 0 : index
 // CHECK-DAG:   %[[VAL_37:.*]] = arith.index_cast %[[VAL_36]] : index to i64
-// CHECK-DAG:   %[[VAL_38:.*]] = arith.addi %[[VAL_37]], %[[VAL_25]] : i64
+// CHECK-DAG:   %[[VAL_35:.*]] = arith.divui %[[VAL_37]], %[[C2:.*]] : i64
+// CHECK-DAG:   %[[LANE:.*]] = arith.remui %[[VAL_37]], %[[C2]] : i64
+// CHECK-DAG:   %[[VAL_38:.*]] = arith.addi %[[VAL_35]], %[[VAL_25]] : i64
 // CHECK-DAG:   %[[VAL_39:.*]] = arith.trunci %[[VAL_38]] : i64 to i32
 // CHECK-DAG:   %[[VAL_40:.*]] = arith.shrui %[[VAL_38]], %[[VAL_23]] : i64
 // CHECK-DAG:   %[[VAL_41:.*]] = arith.trunci %[[VAL_40]] : i64 to i32
@@ -480,15 +477,13 @@ func.func @philox_i64(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi64>) {
 // CHECK-DAG:   %[[VAL_100:.*]] = arith.xori %[[VAL_91]], %[[VAL_76]] : i32
 // CHECK-DAG:   %[[VAL_101:.*]] = arith.xori %[[VAL_100]], %[[VAL_87]] : i32
 
-// CHECK: linalg.yield %[[YIELDED_1:.*]], %[[YIELDED_2:.*]] : i64, i64
-// CHECK-DAG: %[[VAL_206:.*]] = tensor.expand_shape %[[VAL_207:.*]]#0 {{\[\[}}0, 1]] : tensor<4xi64> into tensor<4x1xi64>
-// CHECK-DAG: %[[VAL_208:.*]] = tensor.expand_shape %[[VAL_207]]#1 {{\[\[}}0, 1]] : tensor<4xi64> into tensor<4x1xi64>
-// CHECK-DAG: %[[VAL_209:.*]] = tensor.empty() : tensor<4x2xi64>
-// CHECK-DAG: %[[VAL_213:.*]] = tensor.insert %[[VAL_30]] into %[[VAL_0]]{{\[}}%[[VAL_19]]] : tensor<2xi64>
-
-// CHECK: return %[[VAL_213]], %[[GENERIC:.*]] : tensor<2xi64>, tensor<8xi64>
-
+// CHECK:   %[[IS_LANE1:.*]] = arith.cmpi eq, %[[LANE]], %{{.*}} : i64
+// CHECK:   %[[SELECT:.*]] = arith.select %[[IS_LANE1]], %{{.*}}, %{{.*}} : i64
+// CHECK:   linalg.yield %[[SELECT]] : i64
+// CHECK-NOT: tensor.expand_shape
+// CHECK: %[[VAL_213:.*]] = tensor.insert %[[VAL_30]] into %[[VAL_0]]{{\[}}%[[VAL_19]]] : tensor<2xi64>
 
+// CHECK: return %[[VAL_213]], %[[VAL_33]] : tensor<2xi64>, tensor<8xi64>
 
 // -----
 
@@ -499,31 +494,32 @@ func.func @philox_i32(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi32>) {
   return %output_state, %output : tensor<2xi64>, tensor<8xi32>
 }
 
-// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
- //CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
 // CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C2]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<2xi32>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<2xi32>
-// CHECK: %[[DEST2:.+]] = tensor.empty() : tensor<2xi32>
-// CHECK: %[[DEST3:.+]] = tensor.empty() : tensor<2xi32>
-// CHECK: %[[GENERIC:.+]]:4 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map, #map, #map]
+// Each counter produces four consecutive elements; the element selects its
+// lane of the block within a single elementwise op.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi32>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]], %[[DEST2]], %[[DEST3]] : tensor<2xi32>, tensor<2xi32>, tensor<2xi32>, tensor<2xi32>)
-
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-// CHECK-SAME{literal}: [[0, 1]] : tensor<2x4xi32> into tensor<8xi32>
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi32>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[LANE:.+]] = arith.remui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK-COUNT-3: arith.select
+// CHECK:   linalg.yield %{{.+}} : i32
+// CHECK-NOT: tensor.collapse_shape
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: return %[[INSERTED]], %[[COLLAPSE]]
-
+// CHECK: return %[[INSERTED]], %[[GENERIC]]
 
 // -----
 
@@ -544,49 +540,39 @@ func.func @philox_i32_odd(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<7x11xi
 // CHECK-LABEL: func.func @philox_i32_odd
 // CHECK-SAME:  %[[ARG0:.*]]: tensor<2xi64>
 
- //CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
- //CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C11:.+]] = arith.constant 11 : i64
 // CHECK-DAG: %[[C20:.+]] = arith.constant 20 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C20]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<20xi32>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<20xi32>
-// CHECK: %[[DEST2:.+]] = tensor.empty() : tensor<20xi32>
-// CHECK: %[[DEST3:.+]] = tensor.empty() : tensor<20xi32>
-// CHECK: %[[GENERIC:.+]]:4 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map, #map, #map]
-// CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]], %[[DEST2]], %[[DEST3]] : tensor<20xi32>, tensor<20xi32>, tensor<20xi32>, tensor<20xi32>)
-
-
-// CHECK: %expanded = tensor.expand_shape %[[GENERIC]]#0
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<4x1xi32>
-
-// CHECK: %expanded_1 = tensor.expand_shape %[[GENERIC]]#1
-// CHECK-SAME{literal}: [[0, 1]] : tensor<4xi32> into tensor<4x1xi32>
-
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<20x4xi32>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<20x4xi32>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-
-
-// CHECK: %[[VAL_213:.*]] = tensor.expand_shape %[[COLLAPSE]] {{\[\[}}0, 1]] : tensor<80xi32> into tensor<80x1xi32>
-// CHECK: %[[VAL_214:.*]] = tensor.extract_slice %[[VAL_213]][0, 0] [77, 1] [1, 1] : tensor<80x1xi32> to tensor<77x1xi32>
-// CHECK: %[[VAL_215:.*]] = tensor.collapse_shape %[[VAL_214]] {{\[\[}}0, 1]] : tensor<77x1xi32> into tensor<77xi32>
-// CHECK: %[[VAL_216:.*]] = tensor.expand_shape %[[VAL_215]] {{\[\[}}0, 1]] : tensor<77xi32> into tensor<7x11xi32>
-// CHECK: %[[VAL_217:.*]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]]{{\[}}%[[C1]]] : tensor<2xi64>
-// CHECK: return %[[VAL_217]], %[[VAL_216]] : tensor<2xi64>, tensor<7x11xi32>
-
+// The trailing elements of the last block are never computed rather than
+// being generated and sliced away.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<7x11xi32>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
+// CHECK-SAME: iterator_types = ["parallel", "parallel"]}
+// CHECK-SAME: outs(%[[DEST]] : tensor<7x11xi32>)
+// CHECK-DAG:   %[[IDX0:.+]] = linalg.index 0 : index
+// CHECK-DAG:   %[[IDX1:.+]] = linalg.index 1 : index
+// CHECK-DAG:   %[[IDX0_I64:.+]] = arith.index_cast %[[IDX0]] : index to i64
+// CHECK-DAG:   %[[IDX1_I64:.+]] = arith.index_cast %[[IDX1]] : index to i64
+// CHECK-DAG:   %[[ROW:.+]] = arith.muli %[[IDX0_I64]], %[[C11]] : i64
+// CHECK-DAG:   %[[LINEAR:.+]] = arith.addi %[[IDX1_I64]], %[[ROW]] : i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[LINEAR]], %[[C4]] : i64
+// CHECK-DAG:   %[[LANE:.+]] = arith.remui %[[LINEAR]], %[[C4]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK-COUNT-3: arith.select
+// CHECK:   linalg.yield %{{.+}} : i32
+// CHECK-NOT: tensor.extract_slice
+// CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]]{{\[}}%[[C1]]] : tensor<2xi64>
+// CHECK: return %[[INSERTED]], %[[GENERIC]] : tensor<2xi64>, tensor<7x11xi32>
 
 // -----
 
-
 func.func @philox_i64_odd(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<3x5xi64>) {
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm PHILOX>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<3x5xi64>)
   return %output_state, %output : tensor<2xi64>, tensor<3x5xi64>
@@ -595,37 +581,39 @@ func.func @philox_i64_odd(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<3x5xi6
 // CHECK-LABEL: func.func @philox_i64_odd
 // CHECK-SAME:  %[[ARG0:.*]]: tensor<2xi64>
 
- //CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
- //CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C5:.+]] = arith.constant 5 : i64
 // CHECK-DAG: %[[C8:.+]] = arith.constant 8 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C8]] : i64
 
-// CHECK: %[[DEST2:.+]] = tensor.empty() : tensor<8xi64>
-// CHECK: %[[DEST3:.+]] = tensor.empty() : tensor<8xi64>
-// CHECK: %[[GENERIC:.+]]:2 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map]
-// CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST2]], %[[DEST3]] : tensor<8xi64>, tensor<8xi64>)
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<8x2xi64>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<8x2xi64>)
-
-// CHECK-DAG: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]] {{\[\[}}0, 1]] : tensor<8x2xi64> into tensor<16xi64>
-
-
-// CHECK-DAG: %[[EXPANDED:.*]] = tensor.expand_shape %[[COLLAPSE]] {{\[\[}}0, 1]] : tensor<16xi64> into tensor<16x1xi64>
-// CHECK-DAG: %[[SLICE:.*]] = tensor.extract_slice %[[EXPANDED]][0, 0] [15, 1] [1, 1] : tensor<16x1xi64> to tensor<15x1xi64>
-// CHECK-DAG: %[[EXPAND_2:.*]] = tensor.collapse_shape %[[SLICE]] {{\[\[}}0, 1]] : tensor<15x1xi64> into tensor<15xi64>
-// CHECK-DAG: %[[RESHAPE:.*]] = tensor.expand_shape %[[EXPAND_2]] {{\[\[}}0, 1]] : tensor<15xi64> into tensor<3x5xi64>
-// CHECK-DAG: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
-// CHECK: return %[[INSERTED]], %[[RESHAPE]]
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<3x5xi64>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
+// CHECK-SAME: iterator_types = ["parallel", "parallel"]}
+// CHECK-SAME: outs(%[[DEST]] : tensor<3x5xi64>)
+// CHECK-DAG:   %[[IDX0:.+]] = linalg.index 0 : index
+// CHECK-DAG:   %[[IDX1:.+]] = linalg.index 1 : index
+// CHECK-DAG:   %[[IDX0_I64:.+]] = arith.index_cast %[[IDX0]] : index to i64
+// CHECK-DAG:   %[[IDX1_I64:.+]] = arith.index_cast %[[IDX1]] : index to i64
+// CHECK-DAG:   %[[ROW:.+]] = arith.muli %[[IDX0_I64]], %[[C5]] : i64
+// CHECK-DAG:   %[[LINEAR:.+]] = arith.addi %[[IDX1_I64]], %[[ROW]] : i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[LINEAR]], %[[C2]] : i64
+// CHECK-DAG:   %[[LANE:.+]] = arith.remui %[[LINEAR]], %[[C2]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK:   %[[IS_LANE1:.+]] = arith.cmpi eq, %[[LANE]], %{{.+}} : i64
+// CHECK:   %[[SELECT:.+]] = arith.select %[[IS_LANE1]], %{{.+}}, %{{.+}} : i64
+// CHECK:   linalg.yield %[[SELECT]] : i64
+// CHECK-NOT: tensor.extract_slice
+// CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
+// CHECK: return %[[INSERTED]], %[[GENERIC]]
 
 // -----
 
+
 func.func @philox_i16(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi16>) {
   %output_state, %output = "stablehlo.rng_bit_generator"(%arg0) {rng_algorithm = #stablehlo<rng_algorithm PHILOX>} : (tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi16>)
   return %output_state, %output : tensor<2xi64>, tensor<8xi16>
@@ -634,32 +622,32 @@ func.func @philox_i16(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi16>) {
 // CHECK-LABEL: func.func @philox_i16
 // CHECK-SAME:  %[[ARG0:.*]]: tensor<2xi64>
 
- //CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
- //CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
 // CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C2]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<2xi16>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<2xi16>
-// CHECK: %[[DEST2:.+]] = tensor.empty() : tensor<2xi16>
-// CHECK: %[[DEST3:.+]] = tensor.empty() : tensor<2xi16>
-// CHECK: %[[GENERIC:.+]]:4 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map, #map, #map]
+// Each counter produces four consecutive elements; the element selects its
+// lane of the block within a single elementwise op.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi16>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]], %[[DEST2]], %[[DEST3]] : tensor<2xi16>, tensor<2xi16>, tensor<2xi16>, tensor<2xi16>)
-
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<2x4xi16>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<2x4xi16>)
-
-// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[CONCAT]]
-// CHECK-SAME{literal}: [[0, 1]] : tensor<2x4xi16> into tensor<8xi16>
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi16>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[LANE:.+]] = arith.remui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK-COUNT-3: arith.select
+// CHECK:   linalg.yield %{{.+}} : i16
+// CHECK-NOT: tensor.collapse_shape
 // CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: return %[[INSERTED]], %[[COLLAPSE]]
+// CHECK: return %[[INSERTED]], %[[GENERIC]]
 
 // -----
 
@@ -671,23 +659,29 @@ func.func @philox_i8(%arg0: tensor<2xi64>) -> (tensor<2xi64>, tensor<8xi8>) {
 // CHECK-LABEL: func.func @philox_i8
 // CHECK-SAME:  %[[ARG0:.*]]: tensor<2xi64>
 
- //CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
- //CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
 // CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 
 // Check we update state correctly:
 // CHECK: %[[STATE:.+]] = tensor.extract %[[ARG0]][%[[C1]]] : tensor<2xi64>
 // CHECK: %[[NEWSTATE:.+]] = arith.addi %[[STATE]], %[[C2]] : i64
 
-// CHECK: %[[DEST0:.+]] = tensor.empty() : tensor<2xi8>
-// CHECK: %[[DEST1:.+]] = tensor.empty() : tensor<2xi8>
-// CHECK: %[[DEST2:.+]] = tensor.empty() : tensor<2xi8>
-// CHECK: %[[DEST3:.+]] = tensor.empty() : tensor<2xi8>
-// CHECK: %[[GENERIC:.+]]:4 = linalg.generic
-// CHECK-SAME: indexing_maps = [#map, #map, #map, #map]
+// Each counter produces four consecutive elements; the element selects its
+// lane of the block within a single elementwise op.
+// CHECK: %[[DEST:.+]] = tensor.empty() : tensor<8xi8>
+// CHECK: %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME: indexing_maps = [#map]
 // CHECK-SAME: iterator_types = ["parallel"]}
-// CHECK-SAME: outs(%[[DEST0]], %[[DEST1]], %[[DEST2]], %[[DEST3]] : tensor<2xi8>, tensor<2xi8>, tensor<2xi8>, tensor<2xi8>)
+// CHECK-SAME: outs(%[[DEST]] : tensor<8xi8>)
+// CHECK:   %[[IDX:.+]] = linalg.index 0 : index
+// CHECK:   %[[IDX_I64:.+]] = arith.index_cast %[[IDX]] : index to i64
+// CHECK-DAG:   %[[BLOCK:.+]] = arith.divui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[LANE:.+]] = arith.remui %[[IDX_I64]], %[[C4]] : i64
+// CHECK-DAG:   %[[COUNTER:.+]] = arith.addi %[[BLOCK]], %[[STATE]] : i64
+// CHECK-COUNT-3: arith.select
+// CHECK:   linalg.yield %{{.+}} : i8
+// CHECK-NOT: tensor.collapse_shape
+// CHECK: %[[INSERTED:.+]] = tensor.insert %[[NEWSTATE]] into %[[ARG0]][%[[C1]]] : tensor<2xi64>
 
-// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<2x4xi8>
-// CHECK: %[[CONCAT:.+]] = linalg.generic
-// CHECK-SAME: outs(%[[EMPTY]] : tensor<2x4xi8>)
+// CHECK: return %[[INSERTED]], %[[GENERIC]]
@@ -132,6 +132,13 @@ void GlobalOptimizationOptions::bindOptions(OptionsBinder &binder) {
                    llvm::cl::desc("Enables data tiling path."),
                    llvm::cl::cat(category));
 
+  binder.opt<bool>(
+      "iree-opt-winograd-conv", winogradConv,
+      llvm::cl::desc("Converts 3x3 convolutions with constant filters to "
+                     "winograd F(6x6, 3x3) transforms when all executable "
+                     "targets are CPUs."),
+      llvm::cl::cat(category));
+
   binder.opt<bool>(
       "iree-opt-const-eval", constEval,
       llvm::cl::desc("Enables eager evaluation of constants using the full "
@@ -143,6 +150,17 @@ void GlobalOptimizationOptions::bindOptions(OptionsBinder &binder) {
           "Hoists the results of latent constant expressions into immutable "
           "global initializers for evaluation at program load."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-horizontal-contraction-fusion", horizontalContractionFusion,
+      llvm::cl::desc("Fuses contractions that share their LHS and have "
+                     "constant RHS into a single contraction on the "
+                     "concatenated RHS."),
+      llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-raise-qdq-matmul", raiseQDQMatmul,
+      llvm::cl::desc("Raises matmuls on per-tensor dequantized int8 tensors "
+                     "to int8 matmuls with a rescaling epilogue."),
+      llvm::cl::cat(category));
   binder.opt<bool>(
       "iree-opt-numeric-precision-reduction", numericPrecisionReduction,
       llvm::cl::desc(
@@ -203,6 +221,57 @@ void SchedulingOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Enables binding fusion and dispatch site specialization."),
       llvm::cl::cat(category));
+
+  binder.list<int64_t>(
+      "iree-scheduling-dispatch-shape-buckets", dispatchShapeBuckets,
+      llvm::cl::desc(
+          "Specializes dynamically shaped dispatches for dynamic dimensions "
+          "that are multiples of the given powers of two (e.g. 16,64,128) and "
+          "selects the specialization at runtime, falling back to the fully "
+          "dynamic dispatch."),
+      llvm::cl::CommaSeparated, llvm::cl::cat(category));
+
+  binder.list<int64_t>(
+      "iree-scheduling-dispatch-shape-values", dispatchShapeValues,
+      llvm::cl::desc(
+          "Specializes dynamically shaped dispatches for dynamic dimensions "
+          "equal to the given values (e.g. 1,8) such that the specializations "
+          "are compiled with static shapes and selects the specialization at "
+          "runtime, falling back to the fully dynamic dispatch."),
+      llvm::cl::CommaSeparated, llvm::cl::cat(category));
+
+  binder.opt<int64_t>(
+      "iree-scheduling-max-transient-memory", maxTransientMemory,
+      llvm::cl::desc(
+          "Limits the bytes of transient memory that concurrently executing "
+          "work may allocate. Work exceeding the limit is executed serially, "
+          "trading concurrency for a lower peak. 0 disables the limit."),
+      llvm::cl::cat(category));
+
+  binder.opt<bool>(
+      "iree-scheduling-pack-transients", packTransients,
+      llvm::cl::desc(
+          "Packs transient allocations with disjoint lifetimes across "
+          "execution regions into a single arena allocated once per "
+          "invocation. Reduces peak memory at the cost of ordering the "
+          "execution regions sharing memory."),
+      llvm::cl::cat(category));
+
+  binder.opt<bool>(
+      "iree-scheduling-overlap-collectives", overlapCollectives,
+      llvm::cl::desc(
+          "Schedules each collective in its own execution region and keeps the "
+          "work producing its operands apart from unrelated work. This lets "
+          "collectives on chunked tensor-parallel work overlap with the "
+          "compute of the following chunks."),
+      llvm::cl::cat(category));
+  binder.opt<int64_t>(
+      "iree-scheduling-collective-queue", collectiveQueue,
+      llvm::cl::desc(
+          "Device queue ordinal overlapped collectives are assigned to so "
+          "that they execute concurrently with compute. -1 keeps the "
+          "default queue affinity."),
+      llvm::cl::cat(category));
 }
 
 void PreprocessingOptions::bindOptions(OptionsBinder &binder) {
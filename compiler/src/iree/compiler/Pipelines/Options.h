@@ -82,9 +82,21 @@ struct GlobalOptimizationOptions {
   // Enables data tiling.
   bool dataTiling = false;
 
+  // Converts 3x3 convolutions with constant filters to winograd transforms
+  // when only targeting CPUs.
+  bool winogradConv = false;
+
   // Enables const-expr hoisting into globals.
   bool constExprHoisting = true;
 
+  // Fuses contractions that share their LHS and have constant RHS into a
+  // single contraction. Requires const-expr hoisting.
+  bool horizontalContractionFusion = true;
+
+  // Raises matmuls on dequantized int8 tensors (QDQ models) to integer
+  // matmuls so that activations stay in int8 between layers.
+  bool raiseQDQMatmul = true;
+
   // Enables recursive evaluation of immutable globals using the compiler
   // and runtime.
   bool constEval = true;
@@ -149,6 +161,20 @@ struct SchedulingOptions {
   std::string dumpStatisticsFile = "";
   // Enables fusing bindings with the same underlying storage.
   bool optimizeBindings = true;
+  // Powers of two the dynamic dimensions of dispatches are specialized for.
+  std::vector<int64_t> dispatchShapeBuckets;
+  // Values the dynamic dimensions of dispatches are specialized for exactly.
+  std::vector<int64_t> dispatchShapeValues;
+  // Maximum bytes of transient memory concurrently executing work may
+  // allocate; 0 for no limit.
+  int64_t maxTransientMemory = 0;
+  // Packs transients with disjoint lifetimes into a shared arena.
+  bool packTransients = false;
+  // Schedules collectives in their own execution regions to overlap them with
+  // independent compute.
+  bool overlapCollectives = false;
+  // Device queue ordinal overlapped collectives execute on or -1 for default.
+  int64_t collectiveQueue = -1;
 
   // TODO(benvanik): favor size/speed/etc for partitioning.
   // TODO(benvanik): execution model to optimize for (unified/discrete memory,
@@ -222,6 +222,12 @@ void buildIREEVMTransformPassPipeline(
       (IREE::Stream::DumpOutputFormat)schedulingOptions.dumpStatisticsFormat;
   streamOptions.dumpStatisticsFile = schedulingOptions.dumpStatisticsFile;
   streamOptions.optimizeBindings = schedulingOptions.optimizeBindings;
+  streamOptions.dispatchShapeBuckets = schedulingOptions.dispatchShapeBuckets;
+  streamOptions.dispatchShapeValues = schedulingOptions.dispatchShapeValues;
+  streamOptions.maxTransientMemory = schedulingOptions.maxTransientMemory;
+  streamOptions.packTransients = schedulingOptions.packTransients;
+  streamOptions.overlapCollectives = schedulingOptions.overlapCollectives;
+  streamOptions.collectiveQueue = schedulingOptions.collectiveQueue;
 
   switch (schedulingOptions.executionModel) {
   case SchedulingOptions::ExecutionModel::HostOnly:
@@ -7,10 +7,12 @@
 #include "iree/compiler/Preprocessing/Common/PassDetail.h"
 #include "iree/compiler/Preprocessing/Common/Passes.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
 #include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -19,12 +21,58 @@ namespace iree_compiler {
 namespace IREE {
 
 namespace {
+
+/// Returns the `tensor.extract_slice` defining `value` if it only strips the
+/// padding added to reach the next integer multiple of `paddingSize`: it has
+/// zero offsets and unit strides and every source dimension is either the
+/// sliced size or the sliced size rounded up to `paddingSize`.
+static tensor::ExtractSliceOp getPaddingSlice(Value value, int paddingSize) {
+  auto sliceOp = value.getDefiningOp<tensor::ExtractSliceOp>();
+  if (!sliceOp)
+    return nullptr;
+  RankedTensorType sourceType = sliceOp.getSourceType();
+  RankedTensorType resultType = sliceOp.getResultType();
+  if (!sourceType.hasStaticShape() || !resultType.hasStaticShape() ||
+      sourceType.getRank() != resultType.getRank() ||
+      sourceType == resultType) {
+    return nullptr;
+  }
+  auto isZero = [](OpFoldResult ofr) { return isConstantIntValue(ofr, 0); };
+  auto isOne = [](OpFoldResult ofr) { return isConstantIntValue(ofr, 1); };
+  if (!llvm::all_of(sliceOp.getMixedOffsets(), isZero) ||
+      !llvm::all_of(sliceOp.getMixedStrides(), isOne)) {
+    return nullptr;
+  }
+  for (auto [sourceSize, size] :
+       llvm::zip_equal(sourceType.getShape(), resultType.getShape())) {
+    if (sourceSize != size &&
+        sourceSize != llvm::divideCeil(size, paddingSize) * paddingSize) {
+      return nullptr;
+    }
+  }
+  return sliceOp;
+}
+
+/// Returns the padded source of `value` if it is a padding slice (see
+/// `getPaddingSlice`) of a tensor of `paddedType`. The padded region of the
+/// source holds arbitrary values, so this must only be used for operands whose
+/// padded region only contributes to the padded region of the results.
+static Value getPaddedSource(Value value, RankedTensorType paddedType,
+                             int paddingSize) {
+  tensor::ExtractSliceOp sliceOp = getPaddingSlice(value, paddingSize);
+  if (!sliceOp || sliceOp.getSourceType() != paddedType)
+    return nullptr;
+  return sliceOp.getSource();
+}
+
 /// A pattern to pad statically shaped matmul operands to the next integer
 /// multiple of padSize.
 class PadMatmulOp : public OpInterfaceRewritePattern<linalg::LinalgOp> {
 public:
-  PadMatmulOp(MLIRContext *context, int size, PatternBenefit benefit = 1)
-      : OpInterfaceRewritePattern(context, benefit), paddingSize(size) {}
+  PadMatmulOp(MLIRContext *context, int size, bool propagate,
+              PatternBenefit benefit = 1)
+      : OpInterfaceRewritePattern(context, benefit), paddingSize(size),
+        propagatePadding(propagate) {}
 
   LogicalResult matchAndRewrite(linalg::LinalgOp linalgOp,
                                 PatternRewriter &rewriter) const override {
@@ -98,15 +146,28 @@ public:
       return result;
     };
 
+    // When propagating padding, operands that are slices of already padded
+    // tensors are used directly as long as the reduction dimension is not
+    // padded: padding along M and N only produces padded result elements.
+    auto getPropagatedSource = [&](Value value, RankedTensorType paddedType) {
+      if (!propagatePadding || paddingForK > 0)
+        return Value();
+      return getPaddedSource(value, paddedType, paddingSize);
+    };
+
     Value paddedLhs = lhs;
-    if (paddingForM > 0 || paddingForK > 0) {
+    if (Value source = getPropagatedSource(lhs, lhsPaddedType)) {
+      paddedLhs = source;
+    } else if (paddingForM > 0 || paddingForK > 0) {
       paddedLhs = rewriter.create<tensor::PadOp>(
           loc, lhsPaddedType, lhs, createPadding({0, 0}),
           createPadding({paddingForM, paddingForK}), lhsPaddingValue);
     }
 
     Value paddedRhs = rhs;
-    if (paddingForK > 0 || paddingForN > 0) {
+    if (Value source = getPropagatedSource(rhs, rhsPaddedType)) {
+      paddedRhs = source;
+    } else if (paddingForK > 0 || paddingForN > 0) {
       paddedRhs = rewriter.create<tensor::PadOp>(
           loc, rhsPaddedType, rhs, createPadding({0, 0}),
           createPadding({paddingForK, paddingForN}), rhsPaddingValue);
@@ -121,11 +182,17 @@ public:
     } else {
       auto newResultType = RankedTensorType::get(
           getFullShape({newMSize, newNSize}), resultType.getElementType());
-      Value resultPaddingValue = rewriter.create<arith::ConstantOp>(
-          loc, rewriter.getZeroAttr(resultType.getElementType()));
-      Value paddedResult = rewriter.create<tensor::PadOp>(
-          loc, newResultType, result, createPadding({0, 0}),
-          createPadding({paddingForM, paddingForN}), resultPaddingValue);
+      Value paddedResult;
+      if (propagatePadding) {
+        paddedResult = getPaddedSource(result, newResultType, paddingSize);
+      }
+      if (!paddedResult) {
+        Value resultPaddingValue = rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getZeroAttr(resultType.getElementType()));
+        paddedResult = rewriter.create<tensor::PadOp>(
+            loc, newResultType, result, createPadding({0, 0}),
+            createPadding({paddingForM, paddingForN}), resultPaddingValue);
+      }
       auto paddedMatmulOp =
           mlir::clone(rewriter, linalgOp, {newResultType},
                       ArrayRef<Value>{paddedLhs, paddedRhs, paddedResult});
@@ -151,6 +218,144 @@ public:
     return success();
   }
 
+private:
+  int paddingSize;
+  bool propagatePadding;
+};
+
+/// Returns true if computing the payload of `genericOp` on arbitrary padding
+/// values is safe, i.e. it has no ops with undefined behavior such as integer
+/// division by zero.
+static bool canComputeOnPadding(linalg::GenericOp genericOp) {
+  return !genericOp.getBody()
+              ->walk([](Operation *op) {
+                if (isa<arith::DivSIOp, arith::DivUIOp, arith::CeilDivSIOp,
+                        arith::CeilDivUIOp, arith::FloorDivSIOp,
+                        arith::RemSIOp, arith::RemUIOp>(op)) {
+                  return WalkResult::interrupt();
+                }
+                return WalkResult::advance();
+              })
+              .wasInterrupted();
+}
+
+/// A pattern to propagate padding through elementwise consumers. An elementwise
+/// op reading the slice that strips the padding of a padded producer is
+/// computed on the padded shape instead and the slice is moved to its results:
+///
+///   %0 = tensor.extract_slice %padded[0, 0] [11, 13] [1, 1]
+///   %1 = linalg.generic ins(%0, %other : tensor<11x13xf32>, ...)
+///
+/// becomes
+///
+///   %0 = tensor.pad %other ...
+///   %1 = linalg.generic ins(%padded, %0 : tensor<12x16xf32>, ...)
+///   %2 = tensor.extract_slice %1[0, 0] [11, 13] [1, 1]
+///
+/// so that the padding is only stripped once at the end of the chain.
+class PropagatePaddingThroughElementwiseOp
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  PropagatePaddingThroughElementwiseOp(MLIRContext *context, int size,
+                                       PatternBenefit benefit = 1)
+      : OpRewritePattern(context, benefit), paddingSize(size) {}
+
+  LogicalResult matchAndRewrite(linalg::GenericOp genericOp,
+                                PatternRewriter &rewriter) const override {
+    if (!genericOp.hasTensorSemantics() || genericOp.getNumLoops() == 0 ||
+        genericOp.getNumParallelLoops() != genericOp.getNumLoops() ||
+        genericOp.hasDynamicShape()) {
+      return failure();
+    }
+    if (!llvm::all_of(genericOp.getIndexingMapsArray(), [](AffineMap map) {
+          return map.isIdentity() || map.getNumResults() == 0;
+        })) {
+      return failure();
+    }
+    if (!canComputeOnPadding(genericOp))
+      return failure();
+
+    // Find the padded shape from the first input that is a padding slice.
+    RankedTensorType paddedType;
+    for (Value input : genericOp.getDpsInputs()) {
+      if (tensor::ExtractSliceOp sliceOp =
+              getPaddingSlice(input, paddingSize)) {
+        paddedType = sliceOp.getSourceType();
+        break;
+      }
+    }
+    if (!paddedType)
+      return failure();
+
+    Location loc = genericOp.getLoc();
+    auto padOperand = [&](Value operand) -> FailureOr<Value> {
+      auto operandType = cast<RankedTensorType>(operand.getType());
+      if (operandType.getRank() == 0)
+        return operand;
+      auto operandPaddedType = RankedTensorType::get(
+          paddedType.getShape(), operandType.getElementType());
+      if (Value source =
+              getPaddedSource(operand, operandPaddedType, paddingSize)) {
+        return source;
+      }
+      if (operand.getDefiningOp<tensor::EmptyOp>()) {
+        return rewriter
+            .create<tensor::EmptyOp>(loc, operandPaddedType.getShape(),
+                                     operandType.getElementType())
+            .getResult();
+      }
+      Type elementType = operandType.getElementType();
+      if (!elementType.isIntOrFloat())
+        return failure();
+      SmallVector<OpFoldResult> lowPadding(operandType.getRank(),
+                                           rewriter.getIndexAttr(0));
+      SmallVector<OpFoldResult> highPadding;
+      for (auto [paddedSize, size] : llvm::zip_equal(
+               operandPaddedType.getShape(), operandType.getShape())) {
+        highPadding.push_back(rewriter.getIndexAttr(paddedSize - size));
+      }
+      Value paddingValue = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getZeroAttr(elementType));
+      return rewriter
+          .create<tensor::PadOp>(loc, operandPaddedType, operand, lowPadding,
+                                 highPadding, paddingValue)
+          .getResult();
+    };
+
+    SmallVector<Value> paddedOperands;
+    for (Value operand : genericOp->getOperands()) {
+      FailureOr<Value> paddedOperand = padOperand(operand);
+      if (failed(paddedOperand))
+        return failure();
+      paddedOperands.push_back(paddedOperand.value());
+    }
+    SmallVector<Type> paddedResultTypes;
+    for (Value init : ArrayRef<Value>(paddedOperands)
+                          .drop_front(genericOp.getNumDpsInputs())) {
+      paddedResultTypes.push_back(init.getType());
+    }
+    Operation *paddedOp =
+        mlir::clone(rewriter, genericOp, paddedResultTypes, paddedOperands);
+
+    SmallVector<Value> replacements;
+    for (auto [result, paddedResult] :
+         llvm::zip_equal(genericOp->getResults(), paddedOp->getResults())) {
+      auto resultType = cast<RankedTensorType>(result.getType());
+      SmallVector<OpFoldResult> offsets(resultType.getRank(),
+                                        rewriter.getIndexAttr(0));
+      SmallVector<OpFoldResult> strides(resultType.getRank(),
+                                        rewriter.getIndexAttr(1));
+      SmallVector<OpFoldResult> sizes;
+      for (int64_t size : resultType.getShape()) {
+        sizes.push_back(rewriter.getIndexAttr(size));
+      }
+      replacements.push_back(rewriter.create<tensor::ExtractSliceOp>(
+          loc, paddedResult, offsets, sizes, strides));
+    }
+    rewriter.replaceOp(genericOp, replacements);
+    return success();
+  }
+
 private:
   int paddingSize;
 };
@@ -163,10 +368,28 @@ public:
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
-    patterns.insert<PadMatmulOp>(context, paddingSize);
-    if (failed(applyPatternsAndFoldGreedily(getOperation(),
-                                            std::move(patterns)))) {
-      return signalPassFailure();
+    patterns.insert<PadMatmulOp>(context, paddingSize, propagatePadding);
+    if (!propagatePadding) {
+      if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                              std::move(patterns)))) {
+        return signalPassFailure();
+      }
+      return;
+    }
+
+    // Padding is propagated from producers to consumers, so the ops are
+    // rewritten in program order: each op then sees the padding slices of all
+    // its already rewritten producers.
+    patterns.insert<PropagatePaddingThroughElementwiseOp>(context,
+                                                          paddingSize);
+    FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+    SmallVector<Operation *> linalgOps;
+    getOperation()->walk(
+        [&](linalg::LinalgOp linalgOp) { linalgOps.push_back(linalgOp); });
+    for (Operation *op : linalgOps) {
+      if (failed(applyOpPatternsAndFold(op, frozenPatterns))) {
+        return signalPassFailure();
+      }
     }
   }
 };
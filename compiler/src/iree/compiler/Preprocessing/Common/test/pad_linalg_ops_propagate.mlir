@@ -0,0 +1,76 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(func.func(iree-preprocessing-pad-linalg-ops{propagate=true}))" %s | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @matmul_bias_add(%lhs: tensor<11x17xf32>, %rhs: tensor<17x13xf32>, %init: tensor<11x13xf32>, %bias: tensor<11x13xf32>) -> tensor<11x13xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<11x17xf32>, tensor<17x13xf32>) outs(%init : tensor<11x13xf32>) -> tensor<11x13xf32>
+  %1 = tensor.empty() : tensor<11x13xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0, %bias : tensor<11x13xf32>, tensor<11x13xf32>) outs(%1 : tensor<11x13xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %3 = arith.addf %in, %in_0 : f32
+    linalg.yield %3 : f32
+  } -> tensor<11x13xf32>
+  return %2 : tensor<11x13xf32>
+}
+// The padding is only stripped after the elementwise consumer.
+// CHECK-LABEL: func.func @matmul_bias_add
+//  CHECK-SAME:   %[[BIAS:[a-zA-Z0-9]+]]: tensor<11x13xf32>
+//       CHECK:   %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:       outs(%{{.+}} : tensor<12x16xf32>)
+//       CHECK:   %[[PADDED_BIAS:.+]] = tensor.pad %[[BIAS]] low[0, 0] high[1, 3]
+//       CHECK:   %[[EMPTY:.+]] = tensor.empty() : tensor<12x16xf32>
+//       CHECK:   %[[ADD:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[MATMUL]], %[[PADDED_BIAS]] : tensor<12x16xf32>, tensor<12x16xf32>)
+//  CHECK-SAME:       outs(%[[EMPTY]] : tensor<12x16xf32>)
+//       CHECK:   %[[RESULT:.+]] = tensor.extract_slice %[[ADD]][0, 0] [11, 13] [1, 1] : tensor<12x16xf32> to tensor<11x13xf32>
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @matmul_chain(%lhs: tensor<11x16xf32>, %rhs0: tensor<16x16xf32>, %rhs1: tensor<16x20xf32>, %init0: tensor<11x16xf32>, %init1: tensor<11x20xf32>) -> tensor<11x20xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs0 : tensor<11x16xf32>, tensor<16x16xf32>) outs(%init0 : tensor<11x16xf32>) -> tensor<11x16xf32>
+  %1 = tensor.empty() : tensor<11x16xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0 : tensor<11x16xf32>) outs(%1 : tensor<11x16xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %4 = math.tanh %in : f32
+    linalg.yield %4 : f32
+  } -> tensor<11x16xf32>
+  %3 = linalg.matmul ins(%2, %rhs1 : tensor<11x16xf32>, tensor<16x20xf32>) outs(%init1 : tensor<11x20xf32>) -> tensor<11x20xf32>
+  return %3 : tensor<11x20xf32>
+}
+// Only M is padded so the padded rows flow from the first matmul into the
+// second one without being sliced and padded again in between.
+// CHECK-LABEL: func.func @matmul_chain
+//       CHECK:   %[[MATMUL0:.+]] = linalg.matmul
+//  CHECK-SAME:       -> tensor<12x16xf32>
+//       CHECK:   %[[TANH:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[MATMUL0]] : tensor<12x16xf32>)
+//   CHECK-NOT:   tensor.extract_slice
+//       CHECK:   %[[MATMUL1:.+]] = linalg.matmul
+//  CHECK-SAME:       ins(%[[TANH]], %{{.+}} : tensor<12x16xf32>, tensor<16x20xf32>)
+//  CHECK-SAME:       -> tensor<12x20xf32>
+//       CHECK:   %[[RESULT:.+]] = tensor.extract_slice %[[MATMUL1]][0, 0] [11, 20] [1, 1]
+//       CHECK:   return %[[RESULT]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @no_propagation_through_division(%lhs: tensor<11x16xi32>, %rhs: tensor<16x16xi32>, %init: tensor<11x16xi32>, %divisor: tensor<11x16xi32>) -> tensor<11x16xi32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<11x16xi32>, tensor<16x16xi32>) outs(%init : tensor<11x16xi32>) -> tensor<11x16xi32>
+  %1 = tensor.empty() : tensor<11x16xi32>
+  %2 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%0, %divisor : tensor<11x16xi32>, tensor<11x16xi32>) outs(%1 : tensor<11x16xi32>) {
+  ^bb0(%in: i32, %in_0: i32, %out: i32):
+    %3 = arith.divsi %in, %in_0 : i32
+    linalg.yield %3 : i32
+  } -> tensor<11x16xi32>
+  return %2 : tensor<11x16xi32>
+}
+// Integer division would divide by the zero padding of the divisor.
+// CHECK-LABEL: func.func @no_propagation_through_division
+//       CHECK:   %[[MATMUL:.+]] = linalg.matmul
+//       CHECK:   %[[SLICE:.+]] = tensor.extract_slice %[[MATMUL]]
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       ins(%[[SLICE]], %{{.+}} : tensor<11x16xi32>, tensor<11x16xi32>)
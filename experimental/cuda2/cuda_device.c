@@ -523,6 +523,14 @@ static iree_status_t iree_hal_cuda2_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda2_device_t* device = iree_hal_cuda2_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) ||
+      binding_capacity > 0) {
+    // Indirect command buffers are recorded once and replayed into the graph
+    // of each command buffer executing them with its binding table.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, device->host_allocator, out_command_buffer);
+  }
   return iree_hal_cuda2_graph_command_buffer_create(
       base_device, device->cuda_symbols, device->cu_context, mode,
       command_categories, queue_affinity, binding_capacity, &device->block_pool,
@@ -725,6 +733,14 @@ static iree_status_t iree_hal_cuda2_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_cuda2_device_t* device = iree_hal_cuda2_device_cast(base_device);
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    if (iree_hal_deferred_command_buffer_isa(command_buffers[i])) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "command buffers with binding tables must be "
+                              "executed via iree_hal_command_buffer_execute_"
+                              "commands");
+    }
+  }
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_status_t status = iree_hal_cuda2_pending_queue_actions_enqueue_execution(
@@ -18,6 +18,7 @@
 #include "experimental/cuda2/pipeline_layout.h"
 #include "iree/base/api.h"
 #include "iree/hal/utils/collective_batch.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 // The maximal number of descriptor bindings supported in the CUDA HAL driver.
@@ -85,12 +86,6 @@ iree_status_t iree_hal_cuda2_graph_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_cuda2_graph_command_buffer_t* command_buffer = NULL;
@@ -699,13 +694,20 @@ static iree_status_t iree_hal_cuda2_graph_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
+  // Nested command buffers are recorded as deferred command buffers and
+  // replayed into this graph with the binding table resolved.
   // TODO(#10144): support indirect command buffers by adding subgraph nodes and
   // tracking the binding table for future cuGraphExecKernelNodeSetParams usage.
   // Need to look into how to update the params of the subgraph nodes - is the
   // graph exec the outer one and if so will it allow node handles from the
   // subgraphs?
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 static const iree_hal_command_buffer_vtable_t
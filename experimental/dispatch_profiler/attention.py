@@ -0,0 +1,68 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from library import *
+from tensor_operation import *
+
+
+################################################################################
+class AttentionOperation(TensorOperation):
+    """Data structure to describe a batched (unscaled) attention.
+    `result[B, M, K] = softmax(query[B, M, K] * key[B, N, K]^T) * value[B, N, K]`
+    """
+
+    def __init__(self, attention_shape, query, key, value, result):
+        """attention_shape: [B, M, N, K] with M and N the query and key/value
+        sequence lengths and K the head dimension."""
+        self.B, self.M, self.N, self.K = attention_shape
+        super().__init__(
+            OperationKind.Attention,
+            attention_shape,
+            [
+                ([self.B, self.M, self.K], query),
+                ([self.B, self.N, self.K], key),
+                ([self.B, self.N, self.K], value),
+            ],
+            ([self.B, self.M, self.K], result),
+        )
+
+    def flops(self):
+        # Two batch matmuls; the softmax is not counted.
+        return 4 * self.B * self.M * self.N * self.K
+
+    def emit_body(self, values):
+        return """  %init = tensor.empty() : ${type_result}
+  %result = iree_linalg_ext.attention
+                     ins(%arg0, %arg1, %arg2 : ${type_arg0}, ${type_arg1}, ${type_arg2})
+                     outs(%init : ${type_result}) -> ${type_result}"""
+
+    def reference(self, query, key, value):
+        scores = np.matmul(query, np.transpose(key, (0, 2, 1)))
+        scores = np.exp(scores - np.max(scores, axis=-1, keepdims=True))
+        scores /= np.sum(scores, axis=-1, keepdims=True)
+        return np.matmul(scores, value)
+
+
+class AttentionGenerator(TensorOperationGenerator):
+    """Generates attention operations with pre-defined problem shapes."""
+
+    def __init__(self, args):
+        super().__init__(args)
+        # [B, M, N, K]
+        self.attention_shapes = [
+            [12, 384, 384, 64],
+            [16, 1024, 1024, 64],
+            [32, 1, 1024, 128],
+        ]
+
+    def generate(self):
+        for data_type in [DataType.f16, DataType.f32]:
+            tensor = TensorDescription(data_type, LayoutType.RowMajor)
+            for attention_shape in self.attention_shapes:
+                self._append_operation(
+                    AttentionOperation(attention_shape, tensor, tensor, tensor, tensor)
+                )
+        return self.dispatches_collection_list
@@ -0,0 +1,77 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from library import *
+from tensor_operation import *
+
+
+################################################################################
+class Conv2dOperation(TensorOperation):
+    """Data structure to describe a 2D convolution with unit strides and
+    dilations and no padding.
+    `result[N, OH, OW, F] = input[N, H, W, C] * filter[P, Q, C, F]`
+    """
+
+    def __init__(self, conv_shape, input, filter, result):
+        """conv_shape: [N, H, W, C, P, Q, F] problem dimensions."""
+        self.N, self.H, self.W, self.C, self.P, self.Q, self.F = conv_shape
+        self.OH = self.H - self.P + 1
+        self.OW = self.W - self.Q + 1
+        super().__init__(
+            OperationKind.Conv2d,
+            conv_shape,
+            [
+                ([self.N, self.H, self.W, self.C], input),
+                ([self.P, self.Q, self.C, self.F], filter),
+            ],
+            ([self.N, self.OH, self.OW, self.F], result),
+        )
+
+    def flops(self):
+        return 2 * self.N * self.OH * self.OW * self.F * self.P * self.Q * self.C
+
+    def emit_body(self, values):
+        return """  %c0 = arith.constant 0.0 : ${datatype_result}
+  %init = tensor.empty() : ${type_result}
+  %fill = linalg.fill ins(%c0 : ${datatype_result}) outs(%init : ${type_result}) -> ${type_result}
+  %result = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+                     ins(%arg0, %arg1 : ${type_arg0}, ${type_arg1})
+                     outs(%fill : ${type_result}) -> ${type_result}"""
+
+    def reference(self, input, filter):
+        result = np.zeros((self.N, self.OH, self.OW, self.F), dtype=np.float32)
+        for p in range(self.P):
+            for q in range(self.Q):
+                window = input[:, p : p + self.OH, q : q + self.OW, :]
+                result += np.einsum("nhwc,cf->nhwf", window, filter[p, q])
+        return result
+
+
+class Conv2dGenerator(TensorOperationGenerator):
+    """Generates NHWC/HWCF convolutions with pre-defined problem shapes."""
+
+    def __init__(self, args):
+        super().__init__(args)
+        # [N, H, W, C, P, Q, F]
+        self.conv_shapes = [
+            [1, 58, 58, 64, 3, 3, 64],
+            [1, 30, 30, 128, 3, 3, 128],
+            [1, 16, 16, 256, 3, 3, 256],
+            [1, 56, 56, 64, 1, 1, 256],
+        ]
+
+    def generate(self):
+        for data_type in [DataType.f16, DataType.f32]:
+            for conv_shape in self.conv_shapes:
+                self._append_operation(
+                    Conv2dOperation(
+                        conv_shape,
+                        TensorDescription(data_type, LayoutType.NHWC),
+                        TensorDescription(data_type, LayoutType.HWCF),
+                        TensorDescription(data_type, LayoutType.NHWC),
+                    )
+                )
+        return self.dispatches_collection_list
@@ -0,0 +1,62 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from library import *
+from tensor_operation import *
+
+
+################################################################################
+class ElementwiseOperation(TensorOperation):
+    """Data structure to describe a fused elementwise bias-add and ReLU.
+    `result[M, N] = max(input[M, N] + bias[N], 0)`
+    """
+
+    def __init__(self, elementwise_shape, input, bias, result):
+        """elementwise_shape: [M, N] with N the broadcasted bias dimension."""
+        self.M, self.N = elementwise_shape
+        super().__init__(
+            OperationKind.Elementwise,
+            elementwise_shape,
+            [([self.M, self.N], input), ([self.N], bias)],
+            ([self.M, self.N], result),
+        )
+
+    def flops(self):
+        return 2 * self.M * self.N
+
+    def emit_body(self, values):
+        return """  %c0 = arith.constant 0.0 : ${datatype_result}
+  %init = tensor.empty() : ${type_result}
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %arg1 : ${type_arg0}, ${type_arg1}) outs(%init : ${type_result}) {
+  ^bb0(%in: ${datatype_arg0}, %b: ${datatype_arg1}, %out: ${datatype_result}):
+    %add = arith.addf %in, %b : ${datatype_result}
+    %relu = arith.maximumf %add, %c0 : ${datatype_result}
+    linalg.yield %relu : ${datatype_result}
+  } -> ${type_result}"""
+
+    def reference(self, input, bias):
+        return np.maximum(input + bias, 0)
+
+
+class ElementwiseGenerator(TensorOperationGenerator):
+    """Generates elementwise fusions with pre-defined problem shapes."""
+
+    def __init__(self, args):
+        super().__init__(args)
+        # [M, N]
+        self.elementwise_shapes = [[512, 4096], [3456, 1024], [1, 1048576]]
+
+    def generate(self):
+        for data_type in [DataType.f16, DataType.f32]:
+            tensor = TensorDescription(data_type, LayoutType.RowMajor)
+            for elementwise_shape in self.elementwise_shapes:
+                self._append_operation(
+                    ElementwiseOperation(elementwise_shape, tensor, tensor, tensor)
+                )
+        return self.dispatches_collection_list
@@ -7,6 +7,7 @@
 from library import *
 from matmul import ReferenceMatmulOp
 from batch_matmul import ReferenceBatchMatmulOp
+from tensor_operation import ReferenceTensorOp
 from pathlib import Path
 import subprocess
 
@@ -65,12 +66,16 @@ class IreeToolsLauncher:
             self.operation.name()
         ).with_name(f"{vmfb_filename}_profile.vmfb")
 
-        # reference implementation for the operation_kind.
-        self.reference_impl_map = {
+        # reference implementation for the operation_kind; all other kinds are
+        # `TensorOperation`s carrying their own reference.
+        reference_impl_map = {
             OperationKind.Matmul: ReferenceMatmulOp,
             OperationKind.SplitkMatmul: ReferenceMatmulOp,
             OperationKind.BatchMatmul: ReferenceBatchMatmulOp,
         }
+        self.reference_impl = reference_impl_map.get(
+            operation.operation_kind, ReferenceTensorOp
+        )
 
     def iree_compile(self, compilation_mode):
         """Compiles the input mlir file to vmfb file."""
@@ -140,7 +145,7 @@ class IreeToolsLauncher:
         self.iree_compile(CompilationMode.Verify)
 
         # Verify using random data distribution.
-        reference_run = self.reference_impl_map[self.operation.operation_kind](
+        reference_run = self.reference_impl(
             self.operation,
             self.op_reference_cache_path,
             Distribution.Random,
@@ -210,8 +215,7 @@ class IreeToolsLauncher:
 
         # Operation-specific profiling command-line.
         cmd += [f"--function={self.operation.name()}_{configuration.name()}"]
-        cmd += [f"--input={self.operation.lhs_npy_shape()}"]
-        cmd += [f"--input={self.operation.rhs_npy_shape()}"]
+        cmd += [f"--input={shape}" for shape in self.operation.input_npy_shapes()]
 
         # Print the command if verbose.
         if self.args.verbose:
@@ -57,6 +57,9 @@ class OperationKind(enum.Enum):
     BatchMatmul = auto()
     SplitkMatmul = auto()
     Conv2d = auto()
+    Attention = auto()
+    Reduction = auto()
+    Elementwise = auto()
 
 
 OperationKindNames = {
@@ -64,6 +67,9 @@ OperationKindNames = {
     OperationKind.SplitkMatmul: "matmul_splitk",
     OperationKind.BatchMatmul: "batch_matmul",
     OperationKind.Conv2d: "conv2d",
+    OperationKind.Attention: "attention",
+    OperationKind.Reduction: "reduction",
+    OperationKind.Elementwise: "elementwise",
 }
 
 
@@ -181,6 +187,7 @@ class LayoutType(enum.Enum):
     RowMajor = auto()
     NHWC = auto()
     NCWH = auto()
+    HWCF = auto()
 
 
 # cuBLAS/cuDNN layout type names convention is followed for the layout names.
@@ -190,6 +197,7 @@ ShortLayoutTypeName = {
     LayoutType.RowMajor: "t",
     LayoutType.NHWC: "nhwc",
     LayoutType.NCWH: "ncwh",
+    LayoutType.HWCF: "hwcf",
 }
 
 
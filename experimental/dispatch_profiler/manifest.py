@@ -9,6 +9,10 @@ from library import *
 from matmul import *
 from batch_matmul import *
 from split_k_matmul import *
+from conv2d import *
+from attention import *
+from reduction import *
+from elementwise import *
 from pathlib import Path
 
 
@@ -26,19 +30,25 @@ class EmitSourceMLIR:
             self.operation.name()
         ).with_suffix(".mlir")
 
+        # Operation kinds not listed here are `TensorOperation`s emitted with
+        # their default configuration.
         mlir_configuration_emitter = {
             OperationKind.Matmul: EmitMatmulCompilationInfo,
             OperationKind.SplitkMatmul: EmitMatmulCompilationInfo,
             OperationKind.BatchMatmul: EmitMatmulCompilationInfo,
         }
-        self.configuration_emitter = mlir_configuration_emitter[self.operation_kind]()
+        self.configuration_emitter = mlir_configuration_emitter.get(
+            self.operation_kind, EmitDefaultCompilationInfo
+        )()
 
         mlir_dispatch_emitter = {
             OperationKind.Matmul: EmitLinalgMatmulDispatch,
             OperationKind.SplitkMatmul: EmitLinalgMatmulDispatch,
             OperationKind.BatchMatmul: EmitLinalgBatchMatmulDispatch,
         }
-        self.dispatch_emitter = mlir_dispatch_emitter[self.operation_kind]()
+        self.dispatch_emitter = mlir_dispatch_emitter.get(
+            self.operation_kind, EmitTensorOperationDispatch
+        )()
 
     def __enter__(self):
         self.operation_file = open(self.operation_filepath, "w")
@@ -61,6 +71,22 @@ class EmitSourceMLIR:
         self.operation_file.close()
 
 
+###############################################################################
+# Dispatch generators run by `Manifest.initialize`. A kernel class plugs into
+# the profiler by adding its generator here; `TensorOperation`s need nothing
+# else, while other operations also register their emitters above and their
+# reference implementation in `launchers.py`.
+DISPATCH_GENERATORS = [
+    CudaMatmulGenerator,
+    CudaSplitKMatmulGenerator,
+    CudaBatchMatmulGenerator,
+    Conv2dGenerator,
+    AttentionGenerator,
+    ReductionGenerator,
+    ElementwiseGenerator,
+]
+
+
 ###############################################################################
 class Manifest:
     """Manifest collects, filters, and stores dispatches in a data structure.
@@ -102,14 +128,9 @@ class Manifest:
         if args.operation_kind == "all":
             self.operation_kind_enabled = []
         else:
-            operations_kind_list = [
-                OperationKind.Matmul,
-                OperationKind.SplitkMatmul,
-                OperationKind.BatchMatmul,
-            ]
             self.operation_kind_enabled = [
                 x
-                for x in operations_kind_list
+                for x in OperationKind
                 if OperationKindNames[x] in args.operation_kind.split(",")
             ]
 
@@ -204,9 +225,8 @@ class Manifest:
 
     def initialize(self):
         """Initialize the mainfest object by generating dispatches for supported operations."""
-        self.append(CudaMatmulGenerator(self.args).generate())
-        self.append(CudaSplitKMatmulGenerator(self.args).generate())
-        self.append(CudaBatchMatmulGenerator(self.args).generate())
+        for generator in DISPATCH_GENERATORS:
+            self.append(generator(self.args).generate())
 
         # Serialize the initialized mainfest state.
         self.dump()
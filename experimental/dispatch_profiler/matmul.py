@@ -124,6 +124,10 @@ class MatmulOperation:
         """Returns the shape of the result numpy array as a string in the format "MxNxDataType"."""
         return f"{self.M}x{self.N}x{DataTypeName[self.result.datatype]}"
 
+    def input_npy_shapes(self):
+        """Returns the shapes of the inputs for iree-benchmark-module."""
+        return [self.lhs_npy_shape(), self.rhs_npy_shape()]
+
     def bytes(self):
         """Returns the number of bytes read/written by the matmul operation."""
         bytes = (
@@ -40,8 +40,9 @@ def add_typical_arguments(parser):
         "--op-kind",
         dest="operation_kind",
         default="all",
-        help="Specifies the operation kinds to generate.",
-        choices=["matmul", "conv2d", "all"],
+        help="Comma delimited list of the operation kinds to generate "
+        "(matmul, matmul_splitk, batch_matmul, conv2d, attention, reduction, "
+        "elementwise) or all.",
     )
     parser.add_argument(
         "--dispatches",
@@ -209,6 +210,13 @@ def add_performance_report_arguments(parser):
     performance_report_parser.add_argument(
         "--output", default="", help="Path to output file for csv readable results."
     )
+    performance_report_parser.add_argument(
+        "--perf-db",
+        default="",
+        help="Path to output file for the json performance database recording "
+        "the runtime of every configuration and the best configuration of each "
+        "operation.",
+    )
     performance_report_parser.add_argument(
         "--append",
         action="store_true",
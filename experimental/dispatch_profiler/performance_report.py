@@ -4,10 +4,11 @@
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-import csv, textwrap
+import csv, json, textwrap
 import numpy as np
 from collections import namedtuple
 from pathlib import Path
+from library import *
 
 
 class PerformanceResult:
@@ -126,8 +127,11 @@ class PerformanceReport:
             tag_header = [tag.split(":")[0] for tag in self.tags]
             csv_header = tag_header + csv_header
 
-        # Create the csv dictionary writer.
-        self.csv_writer = csv.DictWriter(self.csv_file, fieldnames=csv_header)
+        # Create the csv dictionary writer. Operation kinds with different
+        # arguments than the first one only report the shared columns.
+        self.csv_writer = csv.DictWriter(
+            self.csv_file, fieldnames=csv_header, extrasaction="ignore"
+        )
 
         # Write the header if the file is being created.
         if self.open_mode == "w":
@@ -156,3 +160,73 @@ class PerformanceReport:
 
             # Write the row.
             self.csv_writer.writerow(csv_dict_row)
+
+    @staticmethod
+    def _get_compilation_info_entry(configuration):
+        """Returns the compiler-facing description of a configuration."""
+        entry = {"name": configuration.name()}
+        entry.update(configuration.get_dict_entry())
+        if configuration.config_type == CompilationConfigType.Default:
+            return entry
+        tile_description = configuration.tile_description
+        entry.update(
+            {
+                "tile_sizes": list(tile_description.threadblock_shape),
+                "pipeline": TranslationInfoTag[configuration.translation_info],
+                "pipeline_depth": tile_description.stages,
+                "workgroup_size": list(tile_description.block_dim),
+            }
+        )
+        return entry
+
+    def write_perf_db(self):
+        """Writes the performance database, if args.perf_db is set.
+
+        The database groups the results by operation and records the fastest
+        verified configuration of each so that tile-size selection heuristics
+        (e.g. in KernelConfig.cpp) can be compared against or seeded from it.
+        """
+        if not self.args.perf_db:
+            return
+
+        operations = {}
+        for result in self.perf_result_vector:
+            name = result.operation.name()
+            if name not in operations:
+                operations[name] = {
+                    "operation": result.operation.get_dict_entry(),
+                    "results": [],
+                    "best": None,
+                }
+            entry = operations[name]
+            result_entry = {
+                "compilation_info": self._get_compilation_info_entry(
+                    result.configuration
+                ),
+                "verification": result.verification_result,
+                "runtime_ms": result.runtime if result.runtime != -1.0 else None,
+                "gflops": result.gflops if result.runtime != -1.0 else None,
+            }
+            entry["results"].append(result_entry)
+            # Only profiled configurations that did not fail verification can be
+            # the best configuration.
+            if result_entry["runtime_ms"] is None or result.verification_result not in [
+                "SUCCESS",
+                "Not verified",
+            ]:
+                continue
+            best = entry["best"]
+            if best is None or result_entry["runtime_ms"] < best["runtime_ms"]:
+                entry["best"] = result_entry
+
+        perf_db = {
+            "device": self.args.device,
+            "tags": dict(tag.split(":") for tag in self.tags),
+            "operations": list(operations.values()),
+        }
+        if self.args.device == "cuda":
+            perf_db["cuda_arch"] = self.args.cuda_arch
+
+        print(f"Writing performance database to {self.args.perf_db}")
+        with open(self.args.perf_db, "w") as fp:
+            json.dump(perf_db, fp, indent=2)
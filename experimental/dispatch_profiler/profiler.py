@@ -96,3 +96,6 @@ if __name__ == "__main__":
 
                 # Append the performance result to the performance report.
                 perf_report.append_perf_result(result)
+
+    # Write the performance database of all the profiled dispatches.
+    perf_report.write_perf_db()
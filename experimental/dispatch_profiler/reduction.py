@@ -0,0 +1,60 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from library import *
+from tensor_operation import *
+
+
+################################################################################
+class ReductionOperation(TensorOperation):
+    """Data structure to describe a sum along the innermost dimension.
+    `result[M] = sum(input[M, N], axis=1)`
+    """
+
+    def __init__(self, reduction_shape, input, result):
+        """reduction_shape: [M, N] with N the reduced dimension."""
+        self.M, self.N = reduction_shape
+        super().__init__(
+            OperationKind.Reduction,
+            reduction_shape,
+            [([self.M, self.N], input)],
+            ([self.M], result),
+        )
+
+    def flops(self):
+        return self.M * self.N
+
+    def emit_body(self, values):
+        return """  %c0 = arith.constant 0.0 : ${datatype_result}
+  %init = tensor.empty() : ${type_result}
+  %fill = linalg.fill ins(%c0 : ${datatype_result}) outs(%init : ${type_result}) -> ${type_result}
+  %result = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%arg0 : ${type_arg0}) outs(%fill : ${type_result}) {
+  ^bb0(%in: ${datatype_arg0}, %out: ${datatype_result}):
+    %sum = arith.addf %in, %out : ${datatype_result}
+    linalg.yield %sum : ${datatype_result}
+  } -> ${type_result}"""
+
+    def reference(self, input):
+        return np.sum(input, axis=1)
+
+
+class ReductionGenerator(TensorOperationGenerator):
+    """Generates innermost-dimension reductions with pre-defined problem shapes."""
+
+    def __init__(self, args):
+        super().__init__(args)
+        # [M, N]
+        self.reduction_shapes = [[512, 4096], [4096, 512], [1, 1048576], [32, 32000]]
+
+    def generate(self):
+        # f16 sums of the reference distributions exceed the f16 precision.
+        tensor = TensorDescription(DataType.f32, LayoutType.RowMajor)
+        for reduction_shape in self.reduction_shapes:
+            self._append_operation(ReductionOperation(reduction_shape, tensor, tensor))
+        return self.dispatches_collection_list
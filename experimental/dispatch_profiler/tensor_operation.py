@@ -0,0 +1,258 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+import functools, operator
+from abc import abstractmethod
+from library import *
+from dispatch import *
+
+
+###############################################################################
+class TensorOperation:
+    """Base class for operations fully described by their input and result tensors.
+
+    Kernel classes that do not need operation-specific launchers (convolutions,
+    attention, reductions, elementwise fusions, ...) derive from this class and
+    only provide the MLIR body, the flop count, and a numpy reference. Emission,
+    verification, and profiling are shared across all of them.
+    """
+
+    def __init__(self, operation_kind, problem_shape, inputs, result):
+        """Initializes a tensor operation.
+        operation_kind: OperationKind of the operation.
+        problem_shape: A list of the problem dimensions used to name the operation.
+        inputs: A list of (shape, TensorDescription) pairs for each input.
+        result: A (shape, TensorDescription) pair for the result.
+        """
+        self.operation_kind = operation_kind
+        self.problem_shape = problem_shape
+        self.inputs = inputs
+        self.result = result
+
+    def __eq__(self, other):
+        """Returns true if the operation is *functionally* the same."""
+        return self.name() == other.name()
+
+    def name(self):
+        """Procedurally generated name for the operation."""
+        tensor_names = [tensor.name() for _, tensor in self.inputs + [self.result]]
+        return (
+            f"{OperationKindNames[self.operation_kind]}_"
+            f"{'x'.join(str(dim) for dim in self.problem_shape)}_"
+            f"{'_'.join(tensor_names)}"
+        )
+
+    @staticmethod
+    def npy_shape(shape, tensor):
+        """Returns the shape as a string in the format "AxBxDataType"."""
+        return "x".join([str(dim) for dim in shape] + [DataTypeName[tensor.datatype]])
+
+    @staticmethod
+    def tensor_type(shape, tensor):
+        """Returns the MLIR tensor type for the shape and tensor description."""
+        return f"tensor<{TensorOperation.npy_shape(shape, tensor)}>"
+
+    def input_npy_shapes(self):
+        """Returns the shapes of the inputs for iree-benchmark-module."""
+        return [self.npy_shape(shape, tensor) for shape, tensor in self.inputs]
+
+    def result_npy_shape(self):
+        return self.npy_shape(*self.result)
+
+    def get_argument_dict(self):
+        """Returns the dictionary of operation arguments."""
+        return {
+            "problem_shape": "x".join(str(dim) for dim in self.problem_shape),
+            "inputs": ",".join(self.input_npy_shapes()),
+            "result": self.result_npy_shape(),
+        }
+
+    def get_dict_entry(self):
+        """Returns the dictionary of the operation summary."""
+        dict_entry = {
+            "op_kind": OperationKindNames[self.operation_kind],
+            "Operation": self.name(),
+            "bytes": self.bytes(),
+            "flops": self.flops(),
+        }
+        dict_entry.update(self.get_argument_dict())
+        return dict_entry
+
+    def bytes(self):
+        """Returns the number of bytes read/written by the operation."""
+        return sum(
+            functools.reduce(operator.mul, shape, 1)
+            * DataTypeSizeInBits[tensor.datatype]
+            // 8
+            for shape, tensor in self.inputs + [self.result]
+        )
+
+    @abstractmethod
+    def flops(self):
+        """Returns the number of operations performed."""
+        pass
+
+    @abstractmethod
+    def emit_body(self, values):
+        """Returns the MLIR ops computing `%result` from `%arg0`...`%argN`.
+        values: Template values with the element and tensor types of the
+          inputs (`datatype_argN`, `type_argN`) and result (`datatype_result`,
+          `type_result`).
+        """
+        pass
+
+    @abstractmethod
+    def reference(self, *inputs):
+        """Returns the numpy result computed from the numpy inputs."""
+        pass
+
+
+###############################################################################
+class DefaultCompilationInfo:
+    """Compilation info using the default configuration chosen by the compiler
+    (e.g. KernelConfig.cpp) for operations without custom tuning configurations.
+    """
+
+    def __init__(self, operation_kind):
+        self.operation_kind = operation_kind
+        self.config_type = CompilationConfigType.Default
+
+    def get_dict_entry(self):
+        return {
+            "Tile config": "Default",
+            "Core class": "Default",
+            "Instruction class": "Default",
+        }
+
+    def name(self):
+        return "tile_config_default"
+
+
+class EmitDefaultCompilationInfo:
+    """Default configurations have no compilation info attribute to emit."""
+
+    def emit(self, compilation_info):
+        return ""
+
+
+###############################################################################
+class EmitTensorOperationDispatch:
+    """Emitters for dispatches of `TensorOperation`s."""
+
+    def __init__(self):
+        self.mlir_dialect = MlirDialect.Linalg
+
+        self.dispatch_template = """
+// Dispatch ${operation_kind}
+func.func @${operation_name}_${compilation_info_name}(${arguments}) -> ${type_result}
+{
+${body}
+  return %result : ${type_result}
+}
+"""
+
+    def emit(self, dispatch):
+        """Emit the operation in the MLIR dialect for a single compilation info"""
+        operation = dispatch.operation
+        values = {
+            "datatype_result": DataTypeName[operation.result[1].datatype],
+            "type_result": TensorOperation.tensor_type(*operation.result),
+        }
+        for index, (shape, tensor) in enumerate(operation.inputs):
+            values[f"datatype_arg{index}"] = DataTypeName[tensor.datatype]
+            values[f"type_arg{index}"] = TensorOperation.tensor_type(shape, tensor)
+        arguments = ", ".join(
+            f"%arg{index}: {values[f'type_arg{index}']}"
+            for index in range(len(operation.inputs))
+        )
+
+        return SubstituteTemplate(
+            self.dispatch_template,
+            {
+                "operation_kind": OperationKindNames[operation.operation_kind],
+                "operation_name": operation.name(),
+                "compilation_info_name": dispatch.configuration.name(),
+                "arguments": arguments,
+                "type_result": values["type_result"],
+                "body": SubstituteTemplate(operation.emit_body(values), values),
+            },
+        )
+
+
+###############################################################################
+class ReferenceTensorOp(ReferenceOpInterface):
+    """Reference implementation for `TensorOperation`s in numpy."""
+
+    def __init__(self, operation, op_reference_cache_path, *input_dists):
+        self.operation = operation
+        self.op_reference_cache_path = op_reference_cache_path
+
+        # Distributions of the inputs; the last one given is used for the rest.
+        self.input_dists = [
+            input_dists[min(index, len(input_dists) - 1)]
+            for index in range(len(operation.inputs))
+        ]
+
+        self.filepath_inputs = [
+            self.op_reference_cache_path.joinpath(
+                f"{TensorOperation.npy_shape(shape, tensor)}_"
+                f"{tensor.name()}_{DistributionName[dist]}_arg{index}.npy"
+            )
+            for index, ((shape, tensor), dist) in enumerate(
+                zip(operation.inputs, self.input_dists)
+            )
+        ]
+        self.filepath_reference_result = self.op_reference_cache_path.joinpath(
+            f"{operation.result_npy_shape()}_{operation.result[1].name()}_"
+            "reference_result.npy"
+        )
+
+    def get_input_filepaths(self):
+        return self.filepath_inputs
+
+    def get_output_filepaths(self):
+        return [self.filepath_reference_result]
+
+    def __call__(self):
+        """Generates input data, runs the numpy reference, and saves npy files."""
+        inputs = []
+        for (shape, tensor), dist, filepath in zip(
+            self.operation.inputs, self.input_dists, self.filepath_inputs
+        ):
+            array = np.array(
+                get_np_array(tensor, shape, dist), dtype=DataTypeNumPyTag[tensor.datatype]
+            )
+            np.save(filepath, array)
+            # The reference is computed in f32 from the values as stored.
+            inputs.append(array.astype(np.float32))
+
+        result = self.operation.reference(*inputs)
+        np.save(
+            self.filepath_reference_result,
+            np.array(result, dtype=DataTypeNumPyTag[self.operation.result[1].datatype]),
+        )
+
+
+###############################################################################
+class TensorOperationGenerator:
+    """Base generator for `TensorOperation` kernel classes. Each problem is
+    emitted with the default compiler configuration."""
+
+    def __init__(self, args):
+        self.args = args
+        self.dispatches_collection_list = []
+
+    def _append_operation(self, operation):
+        self.dispatches_collection_list.append(
+            DispatchCollection(
+                operation, [DefaultCompilationInfo(operation.operation_kind)]
+            )
+        )
+
+    @abstractmethod
+    def generate(self):
+        """Returns a list of dispatch collections."""
+        pass
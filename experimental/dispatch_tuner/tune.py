@@ -0,0 +1,333 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""Tunes the tile sizes of every dispatch in a program.
+
+Each dispatch of the program is extracted into a standalone benchmark module
+with `--iree-hal-dump-executable-benchmarks-to=`. For each dispatch the
+configuration chosen by the compiler heuristics is used as a starting point and
+candidate configurations are derived by scaling its workgroup tile sizes. Every
+candidate is compiled and benchmarked with `iree-benchmark-module` and all
+measurements are written to a dispatch profile that later compiles consume with
+`--iree-codegen-profile-input=`:
+
+  python3 tune.py --iree-bin-dir=<build>/tools --device=local-task \
+      --iree-compile-flag=--iree-hal-target-backends=llvm-cpu \
+      --output=profile.json model.mlir
+  iree-compile --iree-hal-target-backends=llvm-cpu \
+      --iree-codegen-profile-input=profile.json model.mlir -o model.vmfb
+"""
+
+import argparse
+import itertools
+import json
+import re
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Dict, List, Optional
+
+# Passes that select the default configuration for each target backend.
+SELECT_LOWERING_STRATEGY_PASSES = {
+    "llvm-cpu": "iree-llvmcpu-select-lowering-strategy",
+    "cuda": "iree-llvmgpu-select-lowering-strategy",
+    "rocm": "iree-llvmgpu-select-lowering-strategy",
+}
+
+# Factors applied to each workgroup tile size when deriving candidates.
+TILE_SCALE_FACTORS = [0.5, 1, 2]
+
+
+class DispatchConfig:
+    """Configuration of a single dispatch function."""
+
+    def __init__(
+        self,
+        tile_sizes: List[List[int]],
+        translation_info: str,
+        workgroup_size: Optional[List[int]],
+    ):
+        self.tile_sizes = tile_sizes
+        self.translation_info = translation_info
+        self.workgroup_size = workgroup_size
+
+    def compilation_info(self) -> str:
+        levels = ", ".join(
+            "[" + ", ".join(str(size) for size in level) + "]"
+            for level in self.tile_sizes
+        )
+        info = (
+            f"#iree_codegen.compilation_info<"
+            f"lowering_config = <tile_sizes = [{levels}]>, "
+            f"translation_info = {self.translation_info}"
+        )
+        if self.workgroup_size:
+            info += ", workgroup_size = [" + ", ".join(
+                str(size) for size in self.workgroup_size
+            )
+            info += "]"
+        return info + ">"
+
+
+def extract_attr(text: str, prefix: str, start: int = 0) -> Optional[str]:
+    """Returns the attribute starting with |prefix| with balanced brackets."""
+    begin = text.find(prefix, start)
+    if begin == -1:
+        return None
+    depth = 0
+    for i in range(begin + len(prefix) - 1, len(text)):
+        if text[i] == "<":
+            depth += 1
+        elif text[i] == ">":
+            depth -= 1
+            if depth == 0:
+                return text[begin : i + 1]
+    return None
+
+
+def parse_tile_sizes(lowering_config: str) -> Optional[List[List[int]]]:
+    """Parses the tile sizes of a lowering config.
+
+    Returns None if the config uses features we don't know how to scale, such
+    as scalable tile sizes.
+    """
+    m = re.search(r"tile_sizes = \[(.*)\]\s*(,|>)", lowering_config)
+    if m is None:
+        return None
+    levels_str = m.group(1)
+    if not re.fullmatch(r"(\[[0-9, ]*\](, )?)*", levels_str):
+        return None
+    return [
+        [int(size) for size in level.split(",") if size.strip()]
+        for level in re.findall(r"\[([0-9, ]*)\]", levels_str)
+    ]
+
+
+def parse_default_configs(configured_ir: str) -> Dict[str, DispatchConfig]:
+    """Parses the configurations selected by the compiler for each export.
+
+    Expects IR printed with `--mlir-print-local-scope` so that attributes are
+    printed inline.
+    """
+    configs = {}
+    for export in re.finditer(r"hal\.executable\.export public @(\w+)", configured_ir):
+        name = export.group(1)
+        line_end = configured_ir.find("\n", export.end())
+        export_line = configured_ir[export.start() : line_end]
+        translation_info = extract_attr(export_line, "#iree_codegen.translation_info<")
+        if translation_info is None:
+            continue
+        workgroup_size = None
+        m = re.search(r"workgroup_size = \[([^\]]*)\]", export_line)
+        if m:
+            workgroup_size = [int(v) for v in re.findall(r"(\d+) : index", m.group(1))]
+
+        # Find the lowering config of the root op in the function body. Like the
+        # compiler we prefer ops other than linalg.generic/linalg.fill.
+        func = re.search(rf"func\.func @{name}\(", configured_ir)
+        if func is None:
+            continue
+        func_end = configured_ir.find("\n      }", func.end())
+        body = configured_ir[func.end() : func_end]
+        root_config = None
+        for line in body.splitlines():
+            config = extract_attr(line, "#iree_codegen.lowering_config<")
+            if config is None:
+                continue
+            is_generic = re.search(r"= (linalg\.generic|linalg\.fill)", line)
+            if root_config is None or not is_generic:
+                root_config = config
+        if root_config is None:
+            continue
+        tile_sizes = parse_tile_sizes(root_config)
+        if tile_sizes is None:
+            continue
+        configs[name] = DispatchConfig(tile_sizes, translation_info, workgroup_size)
+    return configs
+
+
+def generate_candidates(
+    default: DispatchConfig, max_candidates: int
+) -> List[DispatchConfig]:
+    """Derives candidates by scaling the workgroup tile sizes of |default|."""
+    workgroup_tiles = default.tile_sizes[0]
+    tiled_dims = [i for i, size in enumerate(workgroup_tiles) if size != 0]
+    candidates = []
+    for factors in itertools.product(TILE_SCALE_FACTORS, repeat=len(tiled_dims)):
+        if all(factor == 1 for factor in factors):
+            continue
+        new_tiles = list(workgroup_tiles)
+        for dim, factor in zip(tiled_dims, factors):
+            new_tiles[dim] = int(workgroup_tiles[dim] * factor)
+        if any(new_tiles[dim] < 1 for dim in tiled_dims):
+            continue
+        # Inner tiling levels must not exceed the workgroup tiles.
+        tile_sizes = [new_tiles]
+        for level in default.tile_sizes[1:]:
+            tile_sizes.append(
+                [
+                    min(size, new_tiles[i]) if i < len(new_tiles) and new_tiles[i] else size
+                    for i, size in enumerate(level)
+                ]
+            )
+        candidates.append(
+            DispatchConfig(tile_sizes, default.translation_info, default.workgroup_size)
+        )
+    # Prefer candidates closest to the default configuration.
+    candidates.sort(
+        key=lambda c: sum(a != b for a, b in zip(c.tile_sizes[0], workgroup_tiles))
+    )
+    return candidates[:max_candidates]
+
+
+def run(cmd: List[str], verbose: bool) -> Optional[str]:
+    """Runs |cmd| and returns its stdout or None if it failed."""
+    if verbose:
+        print(f"[Running] {' '.join(cmd)}")
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        if verbose:
+            print(result.stderr)
+        return None
+    return result.stdout
+
+
+def benchmark(args, benchmark_file: Path, profile: Optional[dict], work_dir: Path):
+    """Compiles and benchmarks |benchmark_file| with the |profile| forced.
+
+    Returns the total median time in microseconds of all benchmarks in the
+    module or None if compilation or benchmarking failed.
+    """
+    vmfb_file = work_dir / "candidate.vmfb"
+    cmd = [str(Path(args.iree_bin_dir, "iree-compile")), str(benchmark_file)]
+    cmd += args.iree_compile_flag
+    cmd += ["-o", str(vmfb_file)]
+    if profile is not None:
+        profile_file = work_dir / "candidate_profile.json"
+        profile_file.write_text(json.dumps(profile))
+        cmd += [f"--iree-codegen-profile-input={profile_file}"]
+    if run(cmd, args.verbose) is None:
+        return None
+
+    cmd = [
+        str(Path(args.iree_bin_dir, "iree-benchmark-module")),
+        f"--module={vmfb_file}",
+        f"--device={args.device}",
+        f"--batch_size={args.batch_size}",
+        f"--benchmark_repetitions={args.benchmark_repetitions}",
+        "--benchmark_format=json",
+        "--time_unit=us",
+    ]
+    output = run(cmd, args.verbose)
+    if output is None:
+        return None
+    results = json.loads(output)
+    medians = [
+        case["real_time"]
+        for case in results["benchmarks"]
+        if case.get("aggregate_name") == "median"
+    ]
+    if not medians:
+        medians = [case["real_time"] for case in results["benchmarks"]]
+    return sum(medians)
+
+
+def tune_benchmark_file(args, benchmark_file: Path, work_dir: Path) -> dict:
+    """Returns the measured samples of each dispatch in |benchmark_file|."""
+    select_pass = SELECT_LOWERING_STRATEGY_PASSES[args.target_backend]
+    configured_ir = run(
+        [
+            str(Path(args.iree_bin_dir, "iree-opt")),
+            str(benchmark_file),
+            "--mlir-print-local-scope",
+            "--pass-pipeline=builtin.module(hal.executable(hal.executable.variant("
+            f"iree-codegen-materialize-user-configs, {select_pass})))",
+        ],
+        args.verbose,
+    )
+    if configured_ir is None:
+        print(f"[Skipping] {benchmark_file.name}: failed to select configurations")
+        return {}
+
+    dispatches = {}
+    default_time = benchmark(args, benchmark_file, None, work_dir)
+    if default_time is None:
+        print(f"[Skipping] {benchmark_file.name}: failed to benchmark")
+        return {}
+    for name, default in parse_default_configs(configured_ir).items():
+        samples = [{"time_us": default_time}]
+        for candidate in generate_candidates(default, args.max_candidates):
+            info = candidate.compilation_info()
+            profile = {"dispatches": {name: [{"time_us": 0, "compilation_info": info}]}}
+            time = benchmark(args, benchmark_file, profile, work_dir)
+            if time is None:
+                continue
+            samples.append({"time_us": time, "compilation_info": info})
+        best = min(samples, key=lambda s: s["time_us"])
+        print(
+            f"[Tuned] {name}: default {default_time:.2f} us, "
+            f"best {best['time_us']:.2f} us of {len(samples)} configurations"
+        )
+        dispatches[name] = samples
+    return dispatches
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Tunes the tile sizes of each dispatch in a program and "
+        "writes a profile for use with --iree-codegen-profile-input."
+    )
+    parser.add_argument("input", help="Program to tune.")
+    parser.add_argument("--iree-bin-dir", required=True, help="Directory of IREE tools.")
+    parser.add_argument(
+        "--target-backend",
+        default="llvm-cpu",
+        choices=sorted(SELECT_LOWERING_STRATEGY_PASSES.keys()),
+        help="Target backend the program is compiled for.",
+    )
+    parser.add_argument("--device", default="local-task", help="Device to benchmark on.")
+    parser.add_argument(
+        "--iree-compile-flag",
+        action="append",
+        default=[],
+        help="Flag passed to every iree-compile invocation (repeatable).",
+    )
+    parser.add_argument(
+        "--max-candidates",
+        type=int,
+        default=8,
+        help="Maximum number of candidate configurations per dispatch.",
+    )
+    parser.add_argument("--batch-size", type=int, default=16)
+    parser.add_argument("--benchmark-repetitions", type=int, default=5)
+    parser.add_argument("--output", required=True, help="Profile JSON to write.")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        work_dir = Path(temp_dir)
+        benchmarks_dir = work_dir / "benchmarks"
+        cmd = [str(Path(args.iree_bin_dir, "iree-compile")), args.input]
+        cmd += args.iree_compile_flag
+        cmd += [
+            f"--iree-hal-dump-executable-benchmarks-to={benchmarks_dir}",
+            "-o",
+            str(work_dir / "program.vmfb"),
+        ]
+        if run(cmd, args.verbose) is None:
+            sys.exit("failed to extract dispatch benchmarks from the program")
+
+        dispatches = {}
+        for benchmark_file in sorted(benchmarks_dir.glob("*_benchmark.mlir")):
+            dispatches.update(tune_benchmark_file(args, benchmark_file, work_dir))
+
+    Path(args.output).write_text(json.dumps({"dispatches": dispatches}, indent=2))
+    print(f"[Done] wrote {len(dispatches)} tuned dispatches to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
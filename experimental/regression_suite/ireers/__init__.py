@@ -4,6 +4,10 @@
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+from .benchmarks import (
+    collect_benchmark_results,
+    compare_benchmark_results,
+)
 from .fixtures import (
     fetch_source_fixture,
     iree_compile,
@@ -0,0 +1,320 @@
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Performance tracking for the regression suite.
+
+Benchmark runs are recorded in the JSON format produced by
+`build_tools/benchmarks` (see `common/benchmark_definition.py`) so that the
+same comparison, reporting and dashboard tooling can consume them. Each run
+is appended as a line to `benchmark_runs.jsonl` in the artifact root and the
+lines are collected into a single results file afterwards:
+
+  python -m ireers.benchmarks collect --commit=<sha> -o results.json
+  python -m ireers.benchmarks compare --baseline=baseline.json results.json
+"""
+
+from typing import Any, Dict, List, Optional, Sequence
+import argparse
+import json
+import math
+import platform
+import re
+import sys
+from pathlib import Path
+
+from .artifacts import get_artifact_root_dir, StreamArtifact
+
+BENCHMARK_RUNS_NAME = "benchmark_runs.jsonl"
+
+# Runtime driver to the `build_tools/benchmarks` runner name and the pretty
+# name used in benchmark names.
+DRIVER_RUNNERS = {
+    "local-task": ("iree-llvm-cpu", "IREE-LLVM-CPU"),
+    "local-sync": ("iree-llvm-cpu-sync", "IREE-LLVM-CPU-Sync"),
+    "cuda": ("iree-cuda", "IREE-CUDA"),
+    "vulkan": ("iree-vulkan", "IREE-Vulkan"),
+}
+
+# Maps Python's machine names to the CPU ABIs used by `build_tools/benchmarks`.
+MACHINE_CPU_ABIS = {
+    "x86_64": "x86_64",
+    "amd64": "x86_64",
+    "aarch64": "arm64-v8a",
+    "arm64": "arm64-v8a",
+}
+
+# Flags passed to iree-benchmark-module to produce aggregate statistics.
+BENCHMARK_FLAGS = [
+    "--benchmark_repetitions=10",
+    "--benchmark_format=json",
+    "--time_unit=ns",
+    "--print_statistics=true",
+]
+
+# Default similarity threshold for latency and startup time.
+DEFAULT_THRESHOLD_PERCENTAGE = 5.0
+# Default similarity threshold for memory usage.
+DEFAULT_MEMORY_THRESHOLD_PERCENTAGE = 1.0
+# Welch's t-statistic above which a latency change is considered significant.
+# This roughly corresponds to 95% confidence with 10 repetitions per side.
+SIGNIFICANT_T_STATISTIC = 2.1
+
+
+def get_runner(device: str):
+    """Returns the (runner, pretty name) pair for a runtime device URI."""
+    driver = device.split("://")[0]
+    try:
+        return DRIVER_RUNNERS[driver]
+    except KeyError:
+        raise ValueError(f"No benchmark runner known for device '{device}'")
+
+
+def get_device_info(gpu_name: str = "Unknown") -> Dict[str, Any]:
+    """Returns a `DeviceInfo` JSON object describing the host."""
+    machine = platform.machine().lower()
+    return {
+        "platform_type": "Linux",
+        "model": platform.node() or "Unknown",
+        "cpu_abi": MACHINE_CPU_ABIS.get(machine, machine),
+        "cpu_uarch": "",
+        "cpu_features": [],
+        "gpu_name": gpu_name,
+    }
+
+
+def _get_google_benchmark_latencies(benchmark_json: Dict[str, Any]):
+    """Returns the real and CPU time `BenchmarkLatency` JSON objects."""
+    real_time = {"unit": "ns"}
+    cpu_time = {"unit": "ns"}
+    metrics = ["mean", "median", "stddev"]
+    for case in benchmark_json["benchmarks"]:
+        if any(case["name"].endswith(f"real_time_{m}") for m in metrics):
+            if case["time_unit"] != "ns":
+                raise ValueError("Expected ns as time unit")
+            metric = case["name"].split("_")[-1]
+            real_time[metric] = int(round(case["real_time"]))
+            cpu_time[metric] = int(round(case["cpu_time"]))
+    for latency in (real_time, cpu_time):
+        missing = [m for m in metrics if m not in latency]
+        if missing:
+            raise ValueError(f"Missing benchmark aggregates: {missing}")
+    return real_time, cpu_time
+
+
+def _get_iree_memory_statistics(benchmark_stderr: str, device: str):
+    """Returns the `BenchmarkMemory` JSON object for the given memory type."""
+    pattern = (
+        rf"{device}:"
+        r"\s*(?P<peak>\d+)B peak /"
+        r"\s*(?P<allocated>\d+)B allocated /"
+        r"\s*(?P<freed>\d+)B freed /"
+        r"\s*(?P<live>\d+)B live"
+    )
+    match = re.search(pattern, benchmark_stderr)
+    if match is None:
+        raise ValueError(f"Unable to find memory statistics in '{benchmark_stderr}'")
+    return {
+        "peak": int(match["peak"]),
+        "allocated": int(match["allocated"]),
+        "freed": int(match["freed"]),
+        "live": int(match["live"]),
+        "unit": "bytes",
+    }
+
+
+def parse_benchmark_metrics(
+    benchmark_stdout: str,
+    benchmark_stderr: str,
+    *,
+    startup_time_ns: Optional[int] = None,
+) -> Dict[str, Any]:
+    """Returns the `BenchmarkMetrics` JSON object of an iree-benchmark-module run.
+
+    Throughput (invocations per second) and startup time are not part of the
+    `build_tools/benchmarks` metrics and are carried in `raw_data`.
+    """
+    benchmark_json = json.loads(benchmark_stdout)
+    real_time, cpu_time = _get_google_benchmark_latencies(benchmark_json)
+    raw_data = dict(benchmark_json)
+    if real_time["mean"] > 0:
+        raw_data["throughput_per_second"] = 1e9 / real_time["mean"]
+    if startup_time_ns is not None:
+        raw_data["startup_time_ns"] = startup_time_ns
+    return {
+        "real_time": real_time,
+        "cpu_time": cpu_time,
+        "host_memory": _get_iree_memory_statistics(benchmark_stderr, "HOST_LOCAL"),
+        "device_memory": _get_iree_memory_statistics(
+            benchmark_stderr, "DEVICE_LOCAL"
+        ),
+        "raw_data": raw_data,
+    }
+
+
+def make_benchmark_run(
+    *,
+    model_name: str,
+    function: str,
+    device: str,
+    compiled_variant: str,
+    metrics: Dict[str, Any],
+    bench_mode: Sequence[str] = (),
+) -> Dict[str, Any]:
+    """Returns a `BenchmarkRun` JSON object."""
+    runner, pretty_name = get_runner(device)
+    device_info = get_device_info()
+    mode = f"{','.join(bench_mode)} " if bench_mode else ""
+    name = (
+        f"{model_name}.{function} [{compiled_variant}] "
+        f"{mode}with {pretty_name} @ {device_info['model']}"
+    )
+    return {
+        "info": {
+            "name": name,
+            "model_name": model_name,
+            "model_tags": [function],
+            "model_source": "regression_suite",
+            "bench_mode": list(bench_mode),
+            "compile_tags": [compiled_variant],
+            "runner": runner,
+            "device_info": device_info,
+            "run_config_id": None,
+        },
+        "metrics": metrics,
+    }
+
+
+def record_benchmark_run(run: Dict[str, Any]):
+    """Appends a `BenchmarkRun` JSON object to the recorded runs."""
+    StreamArtifact("", BENCHMARK_RUNS_NAME).write_line(json.dumps(run))
+
+
+def collect_benchmark_results(runs_path: Path, commit: str) -> Dict[str, Any]:
+    """Returns a `BenchmarkResults` JSON object of all recorded runs."""
+    benchmarks = []
+    with open(runs_path, "r") as f:
+        for line in f:
+            if line.strip():
+                benchmarks.append(json.loads(line))
+    return {"commit": commit, "benchmarks": benchmarks}
+
+
+def _welch_t_statistic(base: Dict[str, Any], current: Dict[str, Any], count: int):
+    """Returns Welch's t-statistic for the increase of the current mean."""
+    variance = (base["stddev"] ** 2 + current["stddev"] ** 2) / count
+    delta = current["mean"] - base["mean"]
+    if variance == 0:
+        return math.inf if delta > 0 else 0.0
+    return delta / math.sqrt(variance)
+
+
+def _get_repetitions(run: Dict[str, Any]) -> int:
+    for case in run["metrics"]["raw_data"].get("benchmarks", []):
+        if "repetitions" in case:
+            return max(int(case["repetitions"]), 1)
+    return 1
+
+
+def compare_benchmark_results(
+    baseline: Dict[str, Any],
+    current: Dict[str, Any],
+    *,
+    threshold_percentage: float = DEFAULT_THRESHOLD_PERCENTAGE,
+    memory_threshold_percentage: float = DEFAULT_MEMORY_THRESHOLD_PERCENTAGE,
+) -> List[str]:
+    """Returns descriptions of the regressions of current against baseline.
+
+    Latency regressions must both exceed the threshold and be statistically
+    significant given the recorded standard deviations. Memory and startup
+    time regressions only need to exceed their thresholds.
+    """
+    baseline_runs = {run["info"]["name"]: run for run in baseline["benchmarks"]}
+    regressions = []
+    for run in current["benchmarks"]:
+        name = run["info"]["name"]
+        base_run = baseline_runs.get(name)
+        if base_run is None:
+            continue
+
+        def exceeds(base_value, current_value, percentage):
+            return current_value > base_value * (1.0 + percentage / 100.0)
+
+        base_latency = base_run["metrics"]["real_time"]
+        latency = run["metrics"]["real_time"]
+        repetitions = min(_get_repetitions(base_run), _get_repetitions(run))
+        t_statistic = _welch_t_statistic(base_latency, latency, repetitions)
+        if (
+            exceeds(base_latency["mean"], latency["mean"], threshold_percentage)
+            and t_statistic > SIGNIFICANT_T_STATISTIC
+        ):
+            regressions.append(
+                f"{name}: latency {base_latency['mean']} -> {latency['mean']} ns "
+                f"(t={t_statistic:.1f})"
+            )
+
+        for memory in ("host_memory", "device_memory"):
+            base_peak = base_run["metrics"][memory]["peak"]
+            peak = run["metrics"][memory]["peak"]
+            if exceeds(base_peak, peak, memory_threshold_percentage):
+                regressions.append(f"{name}: {memory} peak {base_peak} -> {peak} bytes")
+
+        base_startup = base_run["metrics"]["raw_data"].get("startup_time_ns")
+        startup = run["metrics"]["raw_data"].get("startup_time_ns")
+        if (
+            base_startup is not None
+            and startup is not None
+            and exceeds(base_startup, startup, threshold_percentage)
+        ):
+            regressions.append(f"{name}: startup {base_startup} -> {startup} ns")
+    return regressions
+
+
+def main(argv: Optional[Sequence[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    collect_parser = subparsers.add_parser(
+        "collect", help="Collect recorded runs into a benchmark results file"
+    )
+    collect_parser.add_argument(
+        "--runs",
+        type=Path,
+        default=None,
+        help=f"Recorded runs (default: <artifacts>/{BENCHMARK_RUNS_NAME})",
+    )
+    collect_parser.add_argument("--commit", default="<unknown>")
+    collect_parser.add_argument("-o", "--output", type=Path, required=True)
+
+    compare_parser = subparsers.add_parser(
+        "compare", help="Compare benchmark results against a baseline"
+    )
+    compare_parser.add_argument("--baseline", type=Path, required=True)
+    compare_parser.add_argument("--threshold", type=float, default=None)
+    compare_parser.add_argument("--memory-threshold", type=float, default=None)
+    compare_parser.add_argument("results", type=Path)
+
+    args = parser.parse_args(argv)
+    if args.command == "collect":
+        runs_path = args.runs or get_artifact_root_dir() / BENCHMARK_RUNS_NAME
+        results = collect_benchmark_results(runs_path, args.commit)
+        args.output.write_text(json.dumps(results, indent=2))
+        print(f"Collected {len(results['benchmarks'])} runs into {args.output}")
+        return 0
+
+    baseline = json.loads(args.baseline.read_text())
+    current = json.loads(args.results.read_text())
+    thresholds = {}
+    if args.threshold is not None:
+        thresholds["threshold_percentage"] = args.threshold
+    if args.memory_threshold is not None:
+        thresholds["memory_threshold_percentage"] = args.memory_threshold
+    regressions = compare_benchmark_results(baseline, current, **thresholds)
+    for regression in regressions:
+        print(f"REGRESSION {regression}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -6,7 +6,7 @@
 
 import pytest
 
-from typing import Dict, Sequence, Union
+from typing import Dict, Optional, Sequence, Union
 from pathlib import Path
 import subprocess
 import time
@@ -16,6 +16,12 @@ from .artifacts import (
     FetchedArtifact,
     ProducedArtifact,
 )
+from .benchmarks import (
+    BENCHMARK_FLAGS,
+    make_benchmark_run,
+    parse_benchmark_metrics,
+    record_benchmark_run,
+)
 
 
 IREE_COMPILE_QOL_FLAGS = [
@@ -77,8 +83,18 @@ def iree_run_module(vmfb: Artifact, *, device, function, args: Sequence[str] = (
 
 
 def iree_benchmark_module(
-    vmfb: Artifact, *, device, function, args: Sequence[str] = ()
+    vmfb: Artifact,
+    *,
+    device,
+    function,
+    args: Sequence[str] = (),
+    model_name: Optional[str] = None,
 ):
+    """Benchmarks a function of a compiled module.
+
+    When `model_name` is given the latency, throughput, peak memory and startup
+    time are recorded for comparison against baselines (see `benchmarks.py`).
+    """
     vmfb.join()
     exec_args = [
         "iree-benchmark-module",
@@ -89,4 +105,48 @@ def iree_benchmark_module(
     exec_args.extend(args)
     print("**************************************************************")
     print("Exec:", " ".join(exec_args))
-    subprocess.check_call(exec_args, cwd=vmfb.group.directory)
+    if model_name is None:
+        subprocess.check_call(exec_args, cwd=vmfb.group.directory)
+        return
+
+    exec_args.extend(BENCHMARK_FLAGS)
+    result = subprocess.run(
+        exec_args,
+        cwd=vmfb.group.directory,
+        check=True,
+        capture_output=True,
+        text=True,
+    )
+    print(result.stderr)
+
+    # Startup is approximated by a single run of the function excluding its
+    # steady-state latency.
+    run_args = [
+        "iree-run-module",
+        f"--device={device}",
+        f"--module={vmfb.path}",
+        f"--function={function}",
+    ]
+    run_args.extend(args)
+    start_time = time.perf_counter_ns()
+    subprocess.run(run_args, cwd=vmfb.group.directory, check=True, capture_output=True)
+    run_time_ns = time.perf_counter_ns() - start_time
+
+    metrics = parse_benchmark_metrics(result.stdout, result.stderr)
+    startup_time_ns = max(run_time_ns - metrics["real_time"]["mean"], 0)
+    metrics["raw_data"]["startup_time_ns"] = startup_time_ns
+    compiled_variant = Path(vmfb.name).stem.split(".")[-1]
+    run = make_benchmark_run(
+        model_name=model_name,
+        function=function,
+        device=device,
+        compiled_variant=compiled_variant,
+        metrics=metrics,
+    )
+    print(
+        f"{run['info']['name']}: {metrics['real_time']['mean']} ns mean latency, "
+        f"{metrics['host_memory']['peak']}B host / "
+        f"{metrics['device_memory']['peak']}B device peak, "
+        f"{startup_time_ns} ns startup"
+    )
+    record_benchmark_run(run)
@@ -133,6 +133,7 @@ def test_step_rdna3_vulkan_stripped(llama2_7b_f16qi4_stripped_rdna3_vulkan_vmfb)
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_rdna3_vulkan_vmfb,
         device="vulkan",
+        model_name="llama2_7b_f16qi4_stripped",
         function="first_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -141,6 +142,7 @@ def test_step_rdna3_vulkan_stripped(llama2_7b_f16qi4_stripped_rdna3_vulkan_vmfb)
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_rdna3_vulkan_vmfb,
         device="vulkan",
+        model_name="llama2_7b_f16qi4_stripped",
         function="second_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -156,6 +158,7 @@ def test_step_host_cpu_stripped(llama2_7b_f16qi4_stripped_host_cpu_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_host_cpu_vmfb,
         device="local-task",
+        model_name="llama2_7b_f16qi4_stripped",
         function="first_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -164,6 +167,7 @@ def test_step_host_cpu_stripped(llama2_7b_f16qi4_stripped_host_cpu_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_host_cpu_vmfb,
         device="local-task",
+        model_name="llama2_7b_f16qi4_stripped",
         function="second_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -179,6 +183,7 @@ def test_step_sm80_cuda_stripped(llama2_7b_f16qi4_stripped_sm80_cuda_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_sm80_cuda_vmfb,
         device="cuda",
+        model_name="llama2_7b_f16qi4_stripped",
         function="first_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -187,6 +192,7 @@ def test_step_sm80_cuda_stripped(llama2_7b_f16qi4_stripped_sm80_cuda_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_stripped_sm80_cuda_vmfb,
         device="cuda",
+        model_name="llama2_7b_f16qi4_stripped",
         function="second_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -202,6 +208,7 @@ def test_step_a100_vulkan_stripped(llama2_7b_f16qi4_a100_vulkan_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_a100_vulkan_vmfb,
         device="vulkan",
+        model_name="llama2_7b_f16qi4_stripped",
         function="first_vicuna_forward",
         args=[
             "--input=1x1xi64",
@@ -210,6 +217,7 @@ def test_step_a100_vulkan_stripped(llama2_7b_f16qi4_a100_vulkan_vmfb):
     iree_benchmark_module(
         llama2_7b_f16qi4_a100_vulkan_vmfb,
         device="vulkan",
+        model_name="llama2_7b_f16qi4_stripped",
         function="second_vicuna_forward",
         args=[
             "--input=1x1xi64",
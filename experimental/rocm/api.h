@@ -16,6 +16,58 @@
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// iree_hal_rocm_device_t
+//===----------------------------------------------------------------------===//
+
+// Defines how command buffers are recorded and executed.
+typedef enum iree_hal_rocm_command_buffer_mode_e {
+  // Command buffers are recorded into HIP graphs.
+  IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH = 0,
+  // Command buffers are directly issued as they are recorded.
+  IREE_HAL_ROCM_COMMAND_BUFFER_MODE_DIRECT = 1,
+} iree_hal_rocm_command_buffer_mode_t;
+
+// Parameters defining a hipMemPool_t.
+typedef struct iree_hal_rocm_memory_pool_params_t {
+  // Minimum number of bytes to keep in the pool when trimming with
+  // iree_hal_device_trim. This much memory is reserved when the device is
+  // created so that initial allocations do not need to grow the pool.
+  uint64_t minimum_capacity;
+  // Soft maximum number of bytes to keep in the pool.
+  // When more than this is allocated the extra will be freed at the next
+  // device synchronization in order to remain under the threshold. Values below
+  // |minimum_capacity| are raised to it. UINT64_MAX retains all memory until
+  // the device is trimmed.
+  uint64_t release_threshold;
+} iree_hal_rocm_memory_pool_params_t;
+
+// Parameters for each hipMemPool_t used for queue-ordered allocations.
+typedef struct iree_hal_rocm_memory_pooling_params_t {
+  // Used exclusively for DEVICE_LOCAL allocations.
+  iree_hal_rocm_memory_pool_params_t device_local;
+  // Used for any host-visible/host-local memory types.
+  iree_hal_rocm_memory_pool_params_t other;
+} iree_hal_rocm_memory_pooling_params_t;
+
+// Parameters configuring an iree_hal_rocm_device_t.
+// Must be initialized with iree_hal_rocm_device_params_initialize prior to use.
+typedef struct iree_hal_rocm_device_params_t {
+  // Specifies how command buffers are recorded and executed.
+  iree_hal_rocm_command_buffer_mode_t command_buffer_mode;
+
+  // Whether to use async allocations even if reported as available by the
+  // device. Defaults to true when the device supports it.
+  bool async_allocations;
+
+  // Parameters for each hipMemPool_t used for queue-ordered allocations.
+  iree_hal_rocm_memory_pooling_params_t memory_pools;
+} iree_hal_rocm_device_params_t;
+
+// Initializes |out_params| to default values.
+IREE_API_EXPORT void iree_hal_rocm_device_params_initialize(
+    iree_hal_rocm_device_params_t *out_params);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_rocm_driver_t
 //===----------------------------------------------------------------------===//
@@ -35,6 +87,7 @@ IREE_API_EXPORT void iree_hal_rocm_driver_options_initialize(
 // |out_driver| must be released by the caller (see |iree_hal_driver_release|).
 IREE_API_EXPORT iree_status_t iree_hal_rocm_driver_create(
     iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t *default_params,
     const iree_hal_rocm_driver_options_t *options,
     iree_allocator_t host_allocator, iree_hal_driver_t **out_driver);
 
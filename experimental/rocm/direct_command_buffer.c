@@ -16,6 +16,7 @@
 #include "experimental/rocm/rocm_buffer.h"
 #include "experimental/rocm/status_util.h"
 #include "iree/base/api.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 
 // Command buffer implementation that directly maps to rocm direct.
 // This records the commands on the calling thread without additional threading
@@ -59,11 +60,6 @@ iree_status_t iree_hal_rocm_direct_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_rocm_direct_command_buffer_t* command_buffer = NULL;
@@ -393,8 +389,15 @@ static iree_status_t iree_hal_rocm_direct_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
+  // Nested command buffers are recorded as deferred command buffers and
+  // replayed onto the stream with the binding table resolved.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 static const iree_hal_command_buffer_vtable_t
@@ -0,0 +1,338 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "experimental/rocm/memory_pools.h"
+
+#include <string.h>
+
+#include "experimental/rocm/dynamic_symbols.h"
+#include "experimental/rocm/rocm_buffer.h"
+#include "experimental/rocm/status_util.h"
+
+// NOTE: these are currently global for all devices; we could make
+// device-specific ones by malloc() and leaking (with LSAN note) unique string
+// values instead.
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+static const char* IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID =
+    "ROCM pool: device-local reserved";
+static const char* IREE_HAL_ROCM_OTHER_POOL_RESERVED_ID =
+    "ROCM pool: other reserved";
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
+static iree_status_t iree_hal_rocm_create_memory_pool(
+    iree_hal_rocm_context_wrapper_t* context,
+    iree_hal_rocm_memory_pool_params_t params, hipStream_t stream,
+    hipMemPool_t* IREE_RESTRICT out_pool) {
+  *out_pool = NULL;
+
+  hipMemPoolProps pool_props;
+  memset(&pool_props, 0, sizeof(pool_props));
+  pool_props.allocType = hipMemAllocationTypePinned;
+  // TODO: allow sharing of certain pool memory types by fd/HANDLE.
+  pool_props.handleTypes = hipMemHandleTypeNone;
+  pool_props.location.type = hipMemLocationTypeDevice;
+  pool_props.location.id = context->rocm_device;
+
+  hipMemPool_t pool = NULL;
+  ROCM_RETURN_IF_ERROR(context->syms, hipMemPoolCreate(&pool, &pool_props),
+                       "hipMemPoolCreate");
+
+  // The pool must retain at least its minimum capacity across synchronizations
+  // or the reservation below would be returned to the driver immediately.
+  uint64_t release_threshold =
+      iree_max(params.release_threshold, params.minimum_capacity);
+  iree_status_t status = ROCM_RESULT_TO_STATUS(
+      context->syms,
+      hipMemPoolSetAttribute(pool, hipMemPoolAttrReleaseThreshold,
+                             &release_threshold),
+      "hipMemPoolSetAttribute");
+
+  // Grow the pool to its minimum capacity by allocating and immediately freeing
+  // a block so that the first allocations do not pay for pool growth.
+  if (iree_status_is_ok(status) && params.minimum_capacity > 0) {
+    void* device_ptr = NULL;
+    status = ROCM_RESULT_TO_STATUS(
+        context->syms,
+        hipMallocFromPoolAsync(&device_ptr, (size_t)params.minimum_capacity,
+                               pool, stream),
+        "hipMallocFromPoolAsync");
+    if (iree_status_is_ok(status)) {
+      status = ROCM_RESULT_TO_STATUS(
+          context->syms, hipFreeAsync(device_ptr, stream), "hipFreeAsync");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    ROCM_IGNORE_ERROR(context->syms, hipMemPoolDestroy(pool));
+  }
+  return status;
+}
+
+iree_status_t iree_hal_rocm_memory_pools_initialize(
+    iree_hal_rocm_context_wrapper_t* context,
+    const iree_hal_rocm_memory_pooling_params_t* pooling_params,
+    hipStream_t stream, iree_hal_rocm_memory_pools_t* IREE_RESTRICT out_pools) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(pooling_params);
+  IREE_ASSERT_ARGUMENT(out_pools);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_pools, 0, sizeof(*out_pools));
+  out_pools->context = context;
+
+  iree_status_t status = iree_hal_rocm_create_memory_pool(
+      context, pooling_params->device_local, stream, &out_pools->device_local);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_rocm_create_memory_pool(context, pooling_params->other,
+                                              stream, &out_pools->other);
+  }
+
+  // Wait for the reservations to complete so they are usable from any stream.
+  if (iree_status_is_ok(status)) {
+    status = ROCM_RESULT_TO_STATUS(context->syms, hipStreamSynchronize(stream),
+                                   "hipStreamSynchronize");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_rocm_memory_pools_deinitialize(
+    iree_hal_rocm_memory_pools_t* pools) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (pools->device_local) {
+    ROCM_IGNORE_ERROR(pools->context->syms,
+                      hipMemPoolDestroy(pools->device_local));
+    pools->device_local = NULL;
+  }
+  if (pools->other) {
+    ROCM_IGNORE_ERROR(pools->context->syms, hipMemPoolDestroy(pools->other));
+    pools->other = NULL;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_hal_rocm_memory_pool_track_alloc(
+    iree_hal_rocm_memory_pools_t* pools, iree_hal_buffer_t* buffer) {
+  bool is_device_local = iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                                           IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
+  (void)is_device_local;
+  iree_device_size_t allocation_size = iree_hal_buffer_allocation_size(buffer);
+  (void)allocation_size;
+  IREE_TRACE_ALLOC_NAMED(
+      is_device_local ? IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID
+                      : IREE_HAL_ROCM_OTHER_POOL_RESERVED_ID,
+      (void*)iree_hal_rocm_buffer_device_pointer(buffer), allocation_size);
+  IREE_STATISTICS({
+    iree_atomic_int64_t* bytes_allocated =
+        is_device_local ? &pools->statistics.device_bytes_allocated
+                        : &pools->statistics.host_bytes_allocated;
+    iree_atomic_fetch_add_int64(bytes_allocated, allocation_size,
+                                iree_memory_order_relaxed);
+  });
+}
+
+static void iree_hal_rocm_memory_pool_track_free(
+    iree_hal_rocm_memory_pools_t* pools, iree_hal_buffer_t* buffer) {
+  bool is_device_local = iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                                           IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
+  (void)is_device_local;
+  IREE_TRACE_FREE_NAMED(is_device_local
+                            ? IREE_HAL_ROCM_DEVICE_LOCAL_POOL_RESERVED_ID
+                            : IREE_HAL_ROCM_OTHER_POOL_RESERVED_ID,
+                        (void*)iree_hal_rocm_buffer_device_pointer(buffer));
+  IREE_STATISTICS({
+    iree_atomic_int64_t* bytes_freed =
+        is_device_local ? &pools->statistics.device_bytes_freed
+                        : &pools->statistics.host_bytes_freed;
+    iree_device_size_t allocation_size =
+        iree_hal_buffer_allocation_size(buffer);
+    iree_atomic_fetch_add_int64(bytes_freed, allocation_size,
+                                iree_memory_order_relaxed);
+  });
+}
+
+#if IREE_STATISTICS_ENABLE
+// Queries the high-water marks of memory used from and reserved by |pool|.
+static void iree_hal_rocm_memory_pool_query_peaks(
+    iree_hal_rocm_context_wrapper_t* context, hipMemPool_t pool,
+    uint64_t* out_used_peak, uint64_t* out_reserved_peak) {
+  ROCM_IGNORE_ERROR(context->syms,
+                    hipMemPoolGetAttribute(pool, hipMemPoolAttrUsedMemHigh,
+                                           out_used_peak));
+  ROCM_IGNORE_ERROR(context->syms,
+                    hipMemPoolGetAttribute(pool, hipMemPoolAttrReservedMemHigh,
+                                           out_reserved_peak));
+}
+#endif  // IREE_STATISTICS_ENABLE
+
+void iree_hal_rocm_memory_pools_merge_statistics(
+    iree_hal_rocm_memory_pools_t* pools,
+    iree_hal_allocator_statistics_t* statistics) {
+  IREE_STATISTICS({
+    statistics->device_bytes_allocated += iree_atomic_load_int64(
+        &pools->statistics.device_bytes_allocated, iree_memory_order_relaxed);
+    statistics->host_bytes_allocated += iree_atomic_load_int64(
+        &pools->statistics.host_bytes_allocated, iree_memory_order_relaxed);
+    statistics->device_bytes_freed += iree_atomic_load_int64(
+        &pools->statistics.device_bytes_freed, iree_memory_order_relaxed);
+    statistics->host_bytes_freed += iree_atomic_load_int64(
+        &pools->statistics.host_bytes_freed, iree_memory_order_relaxed);
+    if (pools->device_local) {
+      uint64_t used_peak = 0;
+      uint64_t reserved_peak = 0;
+      iree_hal_rocm_memory_pool_query_peaks(pools->context, pools->device_local,
+                                            &used_peak, &reserved_peak);
+      statistics->device_bytes_peak += (iree_device_size_t)used_peak;
+      statistics->pool_bytes_used_peak += (iree_device_size_t)used_peak;
+      statistics->pool_bytes_reserved_peak += (iree_device_size_t)reserved_peak;
+    }
+    if (pools->other) {
+      uint64_t used_peak = 0;
+      uint64_t reserved_peak = 0;
+      iree_hal_rocm_memory_pool_query_peaks(pools->context, pools->other,
+                                            &used_peak, &reserved_peak);
+      statistics->host_bytes_peak += (iree_device_size_t)used_peak;
+      statistics->pool_bytes_used_peak += (iree_device_size_t)used_peak;
+      statistics->pool_bytes_reserved_peak += (iree_device_size_t)reserved_peak;
+    }
+  });
+}
+
+iree_status_t iree_hal_rocm_memory_pools_trim(
+    iree_hal_rocm_memory_pools_t* pools,
+    const iree_hal_rocm_memory_pooling_params_t* pooling_params) {
+  ROCM_RETURN_IF_ERROR(
+      pools->context->syms,
+      hipMemPoolTrimTo(pools->device_local,
+                       pooling_params->device_local.minimum_capacity),
+      "hipMemPoolTrimTo");
+  ROCM_RETURN_IF_ERROR(
+      pools->context->syms,
+      hipMemPoolTrimTo(pools->other, pooling_params->other.minimum_capacity),
+      "hipMemPoolTrimTo");
+  return iree_ok_status();
+}
+
+// NOTE: this is only issued if the buffer is destroyed without having had been
+// scheduled for deallocation asynchronously. When a buffer is scheduled we drop
+// the release callback so that this isn't called and we don't double-free.
+static void iree_hal_rocm_async_buffer_release_callback(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_rocm_memory_pools_t* pools =
+      (iree_hal_rocm_memory_pools_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  hipDeviceptr_t device_ptr = iree_hal_rocm_buffer_device_pointer(buffer);
+  ROCM_IGNORE_ERROR(pools->context->syms, hipFree(device_ptr));
+  iree_hal_rocm_memory_pool_track_free(pools, buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_rocm_memory_pools_alloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  iree_hal_buffer_params_canonicalize(&params);
+
+  // TODO: more pools and better selection; this is coarsely deciding between
+  // only device local (variables, constants, transients) and other (staging,
+  // external) but could use more buffer properties (including usage/export
+  // flags) to better isolate the different usage patterns and keep the pools
+  // operating with reasonable limits. We should be using the |pool| arg.
+  hipMemPool_t memory_pool =
+      iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
+          ? pools->device_local
+          : pools->other;
+
+  hipDeviceptr_t device_ptr = NULL;
+  iree_status_t status = ROCM_RESULT_TO_STATUS(
+      pools->context->syms,
+      hipMallocFromPoolAsync(&device_ptr, (size_t)allocation_size, memory_pool,
+                             stream),
+      "hipMallocFromPoolAsync");
+
+  // Wrap the allocated HIP buffer in a HAL buffer.
+  // NOTE: we don't provide a device allocator because we didn't allocate from
+  // one and instead we use a release callback to perform the free if the user
+  // doesn't dealloca the buffer.
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_hal_rocm_async_buffer_release_callback,
+        .user_data = pools,
+    };
+    status = iree_hal_rocm_buffer_wrap(
+        /*allocator=*/NULL, params.type, params.access, params.usage,
+        allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, IREE_HAL_ROCM_BUFFER_TYPE_ASYNC,
+        device_ptr, /*host_ptr=*/NULL, release_callback,
+        pools->context->host_allocator, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    // Update statistics (note that it may not yet be accurate).
+    iree_hal_rocm_memory_pool_track_alloc(pools, buffer);
+    *out_buffer = buffer;
+  } else if (buffer) {
+    iree_hal_buffer_release(buffer);
+  } else if (device_ptr) {
+    ROCM_IGNORE_ERROR(pools->context->syms, hipFreeAsync(device_ptr, stream));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_rocm_memory_pools_dealloca(
+    iree_hal_rocm_memory_pools_t* pools, hipStream_t stream,
+    iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
+
+  // Only process the request if the buffer came from an async pool.
+  // We may get requests for deallocations on ones that didn't if one part of
+  // the application allocated the buffer synchronously and another deallocated
+  // it asynchronously.
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  iree_status_t status = iree_ok_status();
+  if (iree_hal_rocm_buffer_type(allocated_buffer) ==
+      IREE_HAL_ROCM_BUFFER_TYPE_ASYNC) {
+    // Try to schedule the buffer for freeing.
+    hipDeviceptr_t device_ptr =
+        iree_hal_rocm_buffer_device_pointer(allocated_buffer);
+    status = ROCM_RESULT_TO_STATUS(pools->context->syms,
+                                   hipFreeAsync(device_ptr, stream),
+                                   "hipFreeAsync");
+    if (iree_status_is_ok(status)) {
+      // Drop the release callback so that we don't try to double-free the
+      // buffer. Note that we only do this if the HIP free succeeded as
+      // otherwise we still need to synchronously deallocate the buffer when it
+      // is destroyed.
+      iree_hal_rocm_buffer_drop_release_callback(allocated_buffer);
+
+      // Update statistics (note that it may not yet be accurate).
+      iree_hal_rocm_memory_pool_track_free(pools, allocated_buffer);
+    }
+  } else {
+    // Not allocated via alloca, ignore.
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "ignored sync allocation");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -11,6 +11,27 @@
 
 #include "experimental/rocm/api.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+
+// Default to direct command buffers as graphs are created and instantiated
+// for every command buffer and most are only executed once.
+IREE_FLAG(bool, rocm_use_graphs, false,
+          "Use HIP graphs for executing command buffers (instead of issuing\n"
+          "commands directly to the default stream).");
+
+IREE_FLAG(
+    bool, rocm_async_allocations, true,
+    "Enables HIP asynchronous stream-ordered allocations when supported.");
+
+IREE_FLAG(
+    int64_t, rocm_device_local_pool_minimum_capacity, 0,
+    "Bytes reserved in the device-local HIP memory pool at device creation\n"
+    "and retained when the device is trimmed.");
+
+IREE_FLAG(
+    int64_t, rocm_device_local_pool_release_threshold, -1,
+    "Bytes the device-local HIP memory pool retains across synchronizations.\n"
+    "-1 retains all memory until the device is trimmed.");
 
 static iree_status_t iree_hal_rocm_driver_factory_enumerate(
     void *self, iree_host_size_t *out_driver_info_count,
@@ -36,10 +57,25 @@ static iree_status_t iree_hal_rocm_driver_factory_try_create(
                             (int)driver_name.size, driver_name.data);
   }
   IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_rocm_device_params_t default_params;
+  iree_hal_rocm_device_params_initialize(&default_params);
+  default_params.command_buffer_mode =
+      FLAG_rocm_use_graphs ? IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH
+                           : IREE_HAL_ROCM_COMMAND_BUFFER_MODE_DIRECT;
+  default_params.async_allocations = FLAG_rocm_async_allocations;
+  default_params.memory_pools.device_local.minimum_capacity =
+      (uint64_t)iree_max(0, FLAG_rocm_device_local_pool_minimum_capacity);
+  default_params.memory_pools.device_local.release_threshold =
+      FLAG_rocm_device_local_pool_release_threshold < 0
+          ? UINT64_MAX
+          : (uint64_t)FLAG_rocm_device_local_pool_release_threshold;
+
   iree_hal_rocm_driver_options_t driver_options;
   iree_hal_rocm_driver_options_initialize(&driver_options);
-  iree_status_t status = iree_hal_rocm_driver_create(
-      driver_name, &driver_options, host_allocator, out_driver);
+  iree_status_t status =
+      iree_hal_rocm_driver_create(driver_name, &default_params, &driver_options,
+                                  host_allocator, out_driver);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
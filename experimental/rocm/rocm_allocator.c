@@ -17,6 +17,7 @@ typedef struct iree_hal_rocm_allocator_t {
   iree_hal_resource_t resource;
   iree_hal_device_t* base_device;
   iree_hal_rocm_context_wrapper_t* context;
+  iree_hal_rocm_memory_pools_t* pools;
 
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_rocm_allocator_t;
@@ -31,7 +32,7 @@ static iree_hal_rocm_allocator_t* iree_hal_rocm_allocator_cast(
 
 iree_status_t iree_hal_rocm_allocator_create(
     iree_hal_rocm_context_wrapper_t* context,
-    iree_hal_allocator_t** out_allocator) {
+    iree_hal_rocm_memory_pools_t* pools, iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_rocm_allocator_t* allocator = NULL;
@@ -41,6 +42,7 @@ iree_status_t iree_hal_rocm_allocator_create(
     iree_hal_resource_initialize(&iree_hal_rocm_allocator_vtable,
                                  &allocator->resource);
     allocator->context = context;
+    allocator->pools = pools;
     *out_allocator = (iree_hal_allocator_t*)allocator;
   }
 
@@ -79,6 +81,10 @@ static void iree_hal_rocm_allocator_query_statistics(
     iree_hal_rocm_allocator_t* allocator =
         iree_hal_rocm_allocator_cast(base_allocator);
     memcpy(out_statistics, &allocator->statistics, sizeof(*out_statistics));
+    if (allocator->pools) {
+      iree_hal_rocm_memory_pools_merge_statistics(allocator->pools,
+                                                  out_statistics);
+    }
   });
 }
 
@@ -237,7 +243,9 @@ static iree_status_t iree_hal_rocm_allocator_allocate_buffer(
         (iree_hal_allocator_t*)allocator, compat_params.type,
         compat_params.access, compat_params.usage, allocation_size,
         /*byte_offset=*/0,
-        /*byte_length=*/allocation_size, device_ptr, host_ptr, &buffer);
+        /*byte_length=*/allocation_size, IREE_HAL_ROCM_BUFFER_TYPE_DEVICE,
+        device_ptr, host_ptr, iree_hal_buffer_release_callback_null(),
+        allocator->context->host_allocator, &buffer);
   }
 
   if (iree_status_is_ok(status)) {
@@ -14,14 +14,18 @@
 #include "experimental/rocm/direct_command_buffer.h"
 #include "experimental/rocm/dynamic_symbols.h"
 #include "experimental/rocm/event_semaphore.h"
+#include "experimental/rocm/graph_command_buffer.h"
+#include "experimental/rocm/memory_pools.h"
 #include "experimental/rocm/nop_executable_cache.h"
 #include "experimental/rocm/pipeline_layout.h"
 #include "experimental/rocm/rocm_allocator.h"
+#include "experimental/rocm/rocm_buffer.h"
 #include "experimental/rocm/rocm_event.h"
 #include "experimental/rocm/status_util.h"
 #include "experimental/rocm/tracing.h"
 #include "iree/base/internal/arena.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -33,6 +37,9 @@ typedef struct iree_hal_rocm_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
 
+  // Parameters used to control device behavior.
+  iree_hal_rocm_device_params_t params;
+
   // Block pool used for command buffers with a larger block size (as command
   // buffers can contain inlined data uploads).
   iree_arena_block_pool_t block_pool;
@@ -49,12 +56,26 @@ typedef struct iree_hal_rocm_device_t {
   iree_hal_rocm_context_wrapper_t context_wrapper;
   iree_hal_allocator_t* device_allocator;
 
+  // Whether the device supports stream-ordered allocations from memory pools.
+  // When false |memory_pools| is uninitialized.
+  bool supports_memory_pools;
+  // Device memory pools used for queue-ordered allocations.
+  iree_hal_rocm_memory_pools_t memory_pools;
+
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 } iree_hal_rocm_device_t;
 
 static const iree_hal_device_vtable_t iree_hal_rocm_device_vtable;
 
+IREE_API_EXPORT void iree_hal_rocm_device_params_initialize(
+    iree_hal_rocm_device_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->command_buffer_mode = IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->async_allocations = true;
+  out_params->memory_pools.device_local.release_threshold = UINT64_MAX;
+}
+
 static iree_hal_rocm_device_t* iree_hal_rocm_device_cast(
     iree_hal_device_t* base_value) {
   IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_rocm_device_vtable);
@@ -69,6 +90,11 @@ static void iree_hal_rocm_device_destroy(iree_hal_device_t* base_device) {
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
 
+  // Destroy memory pools that hold on to reserved memory.
+  if (device->supports_memory_pools) {
+    iree_hal_rocm_memory_pools_deinitialize(&device->memory_pools);
+  }
+
   // Buffers may have been retaining collective resources.
   iree_hal_channel_provider_release(device->channel_provider);
 
@@ -86,9 +112,9 @@ static void iree_hal_rocm_device_destroy(iree_hal_device_t* base_device) {
 
 static iree_status_t iree_hal_rocm_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
-    hipDevice_t rocm_device, hipStream_t stream, hipCtx_t context,
-    iree_hal_rocm_dynamic_symbols_t* syms, iree_allocator_t host_allocator,
-    iree_hal_device_t** out_device) {
+    const iree_hal_rocm_device_params_t* params, hipDevice_t rocm_device,
+    hipStream_t stream, hipCtx_t context, iree_hal_rocm_dynamic_symbols_t* syms,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_rocm_device_t* device = NULL;
   iree_host_size_t total_size = sizeof(*device) + identifier.size;
   IREE_RETURN_IF_ERROR(
@@ -100,6 +126,7 @@ static iree_status_t iree_hal_rocm_device_create_internal(
   uint8_t* buffer_ptr = (uint8_t*)device + sizeof(*device);
   buffer_ptr += iree_string_view_append_to_buffer(
       identifier, &device->identifier, (char*)buffer_ptr);
+  device->params = *params;
   device->device = rocm_device;
   device->stream = stream;
   device->context_wrapper.rocm_context = context;
@@ -110,9 +137,30 @@ static iree_status_t iree_hal_rocm_device_create_internal(
   iree_status_t status = iree_hal_rocm_tracing_context_allocate(
       &device->context_wrapper, device->identifier, stream, &device->block_pool,
       host_allocator, &device->tracing_context);
+
+  // Memory pool support is conditional.
+  if (iree_status_is_ok(status) && params->async_allocations) {
+    int supports_memory_pools = 0;
+    status = ROCM_RESULT_TO_STATUS(
+        syms, hipDeviceGetAttribute(&supports_memory_pools,
+                                    hipDeviceAttributeMemoryPoolsSupported,
+                                    rocm_device),
+        "hipDeviceGetAttribute");
+    device->supports_memory_pools = supports_memory_pools != 0;
+  }
+
+  // Create memory pools first so that we can share them with the allocator.
+  if (iree_status_is_ok(status) && device->supports_memory_pools) {
+    status = iree_hal_rocm_memory_pools_initialize(
+        &device->context_wrapper, &params->memory_pools, stream,
+        &device->memory_pools);
+  }
+
   if (iree_status_is_ok(status)) {
-    status = iree_hal_rocm_allocator_create(&device->context_wrapper,
-                                            &device->device_allocator);
+    status = iree_hal_rocm_allocator_create(
+        &device->context_wrapper,
+        device->supports_memory_pools ? &device->memory_pools : NULL,
+        &device->device_allocator);
   }
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
@@ -122,12 +170,12 @@ static iree_status_t iree_hal_rocm_device_create_internal(
   return status;
 }
 
-iree_status_t iree_hal_rocm_device_create(iree_hal_driver_t* driver,
-                                          iree_string_view_t identifier,
-                                          iree_hal_rocm_dynamic_symbols_t* syms,
-                                          hipDevice_t device,
-                                          iree_allocator_t host_allocator,
-                                          iree_hal_device_t** out_device) {
+iree_status_t iree_hal_rocm_device_create(
+    iree_hal_driver_t* driver, iree_string_view_t identifier,
+    const iree_hal_rocm_device_params_t* params,
+    iree_hal_rocm_dynamic_symbols_t* syms, hipDevice_t device,
+    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_TRACE_ZONE_BEGIN(z0);
   hipCtx_t context;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -137,9 +185,9 @@ iree_status_t iree_hal_rocm_device_create(iree_hal_driver_t* driver,
       syms, hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
 
   if (iree_status_is_ok(status)) {
-    status = iree_hal_rocm_device_create_internal(driver, identifier, device,
-                                                  stream, context, syms,
-                                                  host_allocator, out_device);
+    status = iree_hal_rocm_device_create_internal(
+        driver, identifier, params, device, stream, context, syms,
+        host_allocator, out_device);
   }
   if (!iree_status_is_ok(status)) {
     if (stream) {
@@ -209,7 +257,12 @@ static iree_status_t iree_hal_rocm_device_query_i64(
 static iree_status_t iree_hal_rocm_device_trim(iree_hal_device_t* base_device) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
-  return iree_hal_allocator_trim(device->device_allocator);
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
+  if (device->supports_memory_pools) {
+    IREE_RETURN_IF_ERROR(iree_hal_rocm_memory_pools_trim(
+        &device->memory_pools, &device->params.memory_pools));
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_rocm_device_create_channel(
@@ -225,6 +278,22 @@ static iree_status_t iree_hal_rocm_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) ||
+      binding_capacity > 0) {
+    // Indirect command buffers are recorded once and replayed into the stream
+    // or graph of each command buffer executing them with its binding table.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
+  }
+  if (device->params.command_buffer_mode ==
+      IREE_HAL_ROCM_COMMAND_BUFFER_MODE_GRAPH) {
+    return iree_hal_rocm_graph_command_buffer_create(
+        base_device, &device->context_wrapper, mode, command_categories,
+        queue_affinity, binding_capacity, &device->block_pool,
+        out_command_buffer);
+  }
   return iree_hal_rocm_direct_command_buffer_create(
       base_device, &device->context_wrapper, device->tracing_context, mode,
       command_categories, queue_affinity, binding_capacity, &device->block_pool,
@@ -305,14 +374,39 @@ static iree_status_t iree_hal_rocm_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO: queue-ordered allocations.
+  iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+
+  // TODO: queue-ordered allocations with device-side waits once semaphores
+  // are implemented. Until then we wait on the host and synchronize before
+  // signaling.
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
                                                     iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(
-      iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
-                                         params, allocation_size, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+
+  // Allocate from the pool; likely to fail in cases of virtual memory
+  // exhaustion but the error may be deferred until a later synchronization.
+  // Host-visible memory is not supported by the pools and is allocated
+  // synchronously through the allocator.
+  iree_status_t status = iree_ok_status();
+  if (device->supports_memory_pools &&
+      !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+    status = iree_hal_rocm_memory_pools_alloca(&device->memory_pools,
+                                               device->stream, pool, params,
+                                               allocation_size, out_buffer);
+    if (iree_status_is_ok(status)) {
+      status = ROCM_RESULT_TO_STATUS(device->context_wrapper.syms,
+                                     hipStreamSynchronize(device->stream),
+                                     "hipStreamSynchronize");
+    }
+  } else {
+    status = iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(base_device), params, allocation_size,
+        out_buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_rocm_device_queue_dealloca(
@@ -320,10 +414,25 @@ static iree_status_t iree_hal_rocm_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO: queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_rocm_device_t* device = iree_hal_rocm_device_cast(base_device);
+
+  // Only buffers allocated from the pools are returned to them; others are
+  // freed when their last reference is released.
+  if (!device->supports_memory_pools ||
+      iree_hal_rocm_buffer_type(iree_hal_buffer_allocated_buffer(buffer)) !=
+          IREE_HAL_ROCM_BUFFER_TYPE_ASYNC) {
+    return iree_hal_device_queue_barrier(
+        base_device, queue_affinity, wait_semaphore_list,
+        signal_semaphore_list);
+  }
+
+  // TODO: queue-ordered deallocations with device-side waits once semaphores
+  // are implemented.
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                                    iree_infinite_timeout()));
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_memory_pools_dealloca(
+      &device->memory_pools, device->stream, buffer));
+  return iree_hal_semaphore_list_signal(signal_semaphore_list);
 }
 
 static iree_status_t iree_hal_rocm_device_queue_read(
@@ -368,6 +477,29 @@ static iree_status_t iree_hal_rocm_device_queue_write(
   return loop_status;
 }
 
+static iree_status_t iree_hal_rocm_device_apply_deferred_command_buffer(
+    iree_hal_rocm_device_t* device, iree_hal_command_buffer_t* command_buffer) {
+  iree_hal_command_buffer_t* direct_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_rocm_direct_command_buffer_create(
+      (iree_hal_device_t*)device, &device->context_wrapper,
+      device->tracing_context,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &device->block_pool, &direct_command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(direct_command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_deferred_command_buffer_apply(
+        command_buffer, direct_command_buffer,
+        iree_hal_buffer_binding_table_empty());
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(direct_command_buffer);
+  }
+  iree_hal_command_buffer_release(direct_command_buffer);
+  return status;
+}
+
 static iree_status_t iree_hal_rocm_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -380,7 +512,33 @@ static iree_status_t iree_hal_rocm_device_queue_execute(
   // synchronizes after every submit.
   // TODO(raikonenfnu): currently run on default/null stream, when cmd buffer
   // stream work with device->stream, we'll change
+  // Graph command buffers are launched on the device stream while direct
+  // command buffers have already been issued to the null stream.
+  bool launched_graphs = false;
+  for (iree_host_size_t i = 0; i < command_buffer_count; i++) {
+    if (iree_hal_deferred_command_buffer_isa(command_buffers[i])) {
+      // Deferred command buffers are replayed onto the null stream through a
+      // transient direct command buffer.
+      IREE_RETURN_IF_ERROR(iree_hal_rocm_device_apply_deferred_command_buffer(
+          device, command_buffers[i]));
+      continue;
+    }
+    hipGraphExec_t exec =
+        iree_hal_rocm_graph_command_buffer_handle(command_buffers[i]);
+    if (!exec) continue;
+    ROCM_RETURN_IF_ERROR(device->context_wrapper.syms,
+                         hipGraphLaunch(exec, device->stream),
+                         "hipGraphLaunch");
+    launched_graphs = true;
+  }
+
   IREE_TRACE_ZONE_BEGIN_NAMED(z0, "hipStreamSynchronize");
+  if (launched_graphs) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, ROCM_RESULT_TO_STATUS(device->context_wrapper.syms,
+                                  hipStreamSynchronize(device->stream),
+                                  "hipStreamSynchronize"));
+  }
   ROCM_RETURN_IF_ERROR(device->context_wrapper.syms, hipStreamSynchronize(0),
                        "hipStreamSynchronize");
   iree_hal_rocm_tracing_context_collect(device->tracing_context);
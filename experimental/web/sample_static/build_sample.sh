@@ -67,6 +67,8 @@ echo "=== Compiling MLIR to static library output (.vmfb, .h, .o) ==="
   --iree-hal-target-backends=llvm-cpu \
   --iree-llvmcpu-target-triple=wasm32-unknown-unknown \
   --iree-llvmcpu-target-cpu-features=+simd128 \
+  --iree-opt-data-tiling \
+  --iree-llvmcpu-enable-microkernels \
   --iree-llvmcpu-link-static \
   --iree-llvmcpu-static-library-output-path="${BINARY_DIR}/${INPUT_NAME}_static.o" \
   --o "${BINARY_DIR}/${INPUT_NAME}.vmfb"
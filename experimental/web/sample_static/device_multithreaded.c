@@ -11,6 +11,9 @@
 #include "iree/task/api.h"
 #include "mnist_static.h"
 
+// Upper bound on the number of task executor workers created.
+#define MAX_WORKER_GROUP_COUNT 8
+
 iree_status_t create_device_with_static_loader(iree_allocator_t host_allocator,
                                                iree_hal_device_t** out_device) {
   iree_hal_task_device_params_t params;
@@ -32,13 +35,18 @@ iree_status_t create_device_with_static_loader(iree_allocator_t host_allocator,
   options.worker_local_memory_size = 0;
   iree_task_topology_t topology;
   iree_task_topology_initialize(&topology);
+  // Use one worker (Web Worker) per logical core reported by the browser
+  // (navigator.hardwareConcurrency), capped to keep memory usage bounded.
+  // Note: threads increase memory usage. If raising the cap, consider
+  // passing in a larger WebAssembly.Memory object or increasing Emscripten's
+  // INITIAL_MEMORY; the sample links with ALLOW_MEMORY_GROWTH.
+  int group_count = emscripten_num_logical_cores();
+  if (group_count < 1) group_count = 1;
+  if (group_count > MAX_WORKER_GROUP_COUNT) {
+    group_count = MAX_WORKER_GROUP_COUNT;
+  }
   iree_task_topology_initialize_from_group_count(
-      /*group_count=*/4, &topology);
-  // Note: threads increase memory usage. If using a high thread count, consider
-  // passing in a larger WebAssembly.Memory object, increasing Emscripten's
-  // INITIAL_MEMORY, or setting Emscripten's ALLOW_MEMORY_GROWTH.
-  // iree_task_topology_initialize_from_group_count(
-  //     /*group_count=*/emscripten_num_logical_cores(), &topology);
+      (iree_host_size_t)group_count, &topology);
   iree_task_executor_t* executor = NULL;
   if (iree_status_is_ok(status)) {
     status = iree_task_executor_create(options, &topology, host_allocator,
@@ -20,6 +20,7 @@ void iree_hal_webgpu_bind_group_cache_initialize(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_cache->device = device;
+  out_cache->use_counter = 0;
   out_cache->entry_count = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY;
 
   IREE_TRACE_ZONE_END(z0);
@@ -64,20 +65,24 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
   // that lookups don't need to perform a full scan. This is cheaper than the
   // cost of creating a new bind group per dispatch (no need to call out to
   // WebGPU, allocate new objects, track those new objects lifetimes, etc) but
-  // not cheap. Ideally we'd be relying on this for 4-5 bind groups per command
-  // buffer at which point it doesn't matter but the compiler still needs to
-  // improve a bit there.
+  // not cheap.
+  const uint64_t use_id = ++cache->use_counter;
 
   // Scan the cache for entries with a matching group layout and binding mask.
   // These should be the same today but in the future we may want to allow for
-  // subsetting as defined by bind group compatibility.
-  iree_host_size_t insertion_slot = cache->entry_count - 1;
+  // subsetting as defined by bind group compatibility. While scanning we track
+  // the slot to use on a miss: the first unused slot, if any, or otherwise the
+  // least recently used entry.
+  iree_hal_webgpu_bind_group_cache_entry_t* victim = NULL;
   for (iree_host_size_t i = 0; i < cache->entry_count; ++i) {
     iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[i];
     if (!entry->handle) {
-      insertion_slot = iree_min(insertion_slot, i);
+      if (!victim || victim->handle) victim = entry;
       continue;
     }
+    if (!victim || (victim->handle && entry->last_use < victim->last_use)) {
+      victim = entry;
+    }
     if (entry->group_layout != group_layout) continue;
     if (entry->binding_mask != binding_mask) continue;
 
@@ -87,15 +92,15 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     // faster than what we'd have to do for that comparison.
     if (memcmp(bindings, entry->bindings, sizeof(entry->bindings)) == 0) {
       // Same exact bindings - cache hit!
-      // TODO(benvanik): a real LRU that rearranges this to the front/back.
+      entry->last_use = use_id;
       IREE_TRACE_ZONE_END(z0);
       return entry->handle;
     }
   }
 
-  // Evict an existing entry to store this new one or use the last unused slot.
-  iree_hal_webgpu_bind_group_cache_entry_t* entry =
-      &cache->entries[insertion_slot];
+  // Evict the least recently used entry to store this new one or use the first
+  // unused slot.
+  iree_hal_webgpu_bind_group_cache_entry_t* entry = victim;
   if (entry->handle) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "evict");
     iree_wgpuBindGroupDrop(entry->handle);
@@ -104,6 +109,7 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
   }
   entry->group_layout = group_layout;
   entry->binding_mask = binding_mask;
+  entry->last_use = use_id;
   memcpy(entry->bindings, bindings, sizeof(entry->bindings));
 
   // NOTE: we could change this to do bit scans over the binding_mask but I
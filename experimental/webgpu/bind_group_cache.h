@@ -16,11 +16,12 @@
 extern "C" {
 #endif  // __cplusplus
 
-// NOTE: this is probably too small, but this is all a hack anyway.
-// TODO(benvanik): build a real cache - today this is assuming the compiler does
-// a much better job than it currently does as reducing the number of push
-// descriptor sets.
-#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 32
+// Maximum number of bind groups retained by the cache. Bind groups are cached
+// for the lifetime of the device so this should be large enough to hold the
+// working set of a full inference; when exceeded the least recently used bind
+// group is evicted.
+// TODO: index the cache by layout so lookups don't need a full scan.
+#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 64
 
 // A subset of WGPUBindGroupEntry containing only what we need.
 // WGPUBindGroupEntry is quite large (has sampler and texture information).
@@ -39,6 +40,9 @@ typedef struct iree_hal_webgpu_bind_group_cache_entry_t {
   WGPUBindGroupLayout group_layout;
   // Cached WebGPU bind group containing the bindings.
   WGPUBindGroup handle;
+  // Value of the cache use counter when the entry was last acquired. The entry
+  // with the lowest value is the one evicted when the cache is full.
+  uint64_t last_use;
   // Each bit indicates a populated binding at the respective ordinal.
   iree_hal_webgpu_binding_mask_t binding_mask;
   // Each source binding to use for cache equality comparison.
@@ -46,11 +50,15 @@ typedef struct iree_hal_webgpu_bind_group_cache_entry_t {
       bindings[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
 } iree_hal_webgpu_bind_group_cache_entry_t;
 
-// Simple cache of WGPUBindGroups.
+// LRU cache of WGPUBindGroups.
 // Bind groups in WebGPU are immutable and we need to create new ones for each
-// unique set of bindings.
+// unique set of bindings. The cache is shared by all command buffers created
+// from a device and persists across submissions such that repeated
+// invocations with the same buffers make no WebGPU calls to create bind groups.
 typedef struct iree_hal_webgpu_bind_group_cache_t {
   WGPUDevice device;
+  // Monotonically increasing counter bumped on each acquisition.
+  uint64_t use_counter;
   iree_host_size_t entry_count;
   iree_hal_webgpu_bind_group_cache_entry_t
       entries[IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY];
@@ -73,7 +81,10 @@ void iree_hal_webgpu_bind_group_cache_trim(
 // Each bit of |binding_mask| indicates a binding that is used by the caller;
 // this allows for matching of cached bind groups to match any with only the
 // used bindings needing to match.
-// Callers may use the returned bind group handle until the cache is trimmed.
+// |bindings| must contain IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT
+// entries with unused ones zeroed.
+// Callers may use the returned bind group handle until the next acquisition
+// (which may evict it) or the cache is trimmed.
 WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     iree_hal_webgpu_bind_group_cache_t* cache, WGPUBindGroupLayout group_layout,
     const iree_hal_webgpu_bind_group_binding_t* bindings,
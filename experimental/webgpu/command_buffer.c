@@ -15,6 +15,171 @@
 #include "experimental/webgpu/pipeline_layout.h"
 #include "iree/base/api.h"
 #include "iree/base/internal/arena.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+
+//===----------------------------------------------------------------------===//
+// Replayable encoding
+//===----------------------------------------------------------------------===//
+// WGPUCommandBuffers can only be submitted once and WebGPU has no compute
+// equivalent of GPURenderBundle to reuse encoded passes. Reusable (not
+// one-shot) command buffers capture the commands encoded into each execute
+// segment so that subsequent submissions can re-encode them directly instead
+// of requiring the HAL command buffer to be recorded again. Bind groups are
+// captured by their cache key instead of their handle such that cache eviction
+// can't invalidate them; reacquiring them is a cache hit in the common case
+// and makes no WebGPU calls.
+
+typedef enum iree_hal_webgpu_replay_op_type_e {
+  IREE_HAL_WEBGPU_REPLAY_OP_BEGIN_COMPUTE_PASS,
+  IREE_HAL_WEBGPU_REPLAY_OP_END_COMPUTE_PASS,
+  IREE_HAL_WEBGPU_REPLAY_OP_PUSH_DEBUG_GROUP,
+  IREE_HAL_WEBGPU_REPLAY_OP_POP_DEBUG_GROUP,
+  IREE_HAL_WEBGPU_REPLAY_OP_CLEAR_BUFFER,
+  IREE_HAL_WEBGPU_REPLAY_OP_COPY_BUFFER,
+  IREE_HAL_WEBGPU_REPLAY_OP_SET_PIPELINE,
+  IREE_HAL_WEBGPU_REPLAY_OP_SET_BIND_GROUP,
+  IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH,
+  IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH_INDIRECT,
+} iree_hal_webgpu_replay_op_type_t;
+
+struct iree_hal_webgpu_replay_op_t;
+typedef struct iree_hal_webgpu_replay_op_t {
+  struct iree_hal_webgpu_replay_op_t* next_op;
+  iree_hal_webgpu_replay_op_type_t type;
+  union {
+    struct {
+      const char* label;
+    } push_debug_group;
+    struct {
+      WGPUBuffer buffer;
+      uint64_t offset;
+      uint64_t length;
+    } clear_buffer;
+    struct {
+      WGPUBuffer source_buffer;
+      uint64_t source_offset;
+      WGPUBuffer target_buffer;
+      uint64_t target_offset;
+      uint64_t length;
+    } copy_buffer;
+    struct {
+      WGPUComputePipeline pipeline;
+    } set_pipeline;
+    struct {
+      uint32_t group_index;
+      // Device-owned bind group used as-is, or NULL if the bind group is
+      // acquired from the bind group cache with the key below.
+      WGPUBindGroup handle;
+      WGPUBindGroupLayout group_layout;
+      iree_hal_webgpu_binding_mask_t binding_mask;
+      const iree_hal_webgpu_bind_group_binding_t* bindings;
+      uint32_t dynamic_offset_count;
+      uint32_t dynamic_offset;
+    } set_bind_group;
+    struct {
+      uint32_t workgroup_x;
+      uint32_t workgroup_y;
+      uint32_t workgroup_z;
+    } dispatch;
+    struct {
+      WGPUBuffer workgroups_buffer;
+      uint64_t workgroups_offset;
+    } dispatch_indirect;
+  };
+} iree_hal_webgpu_replay_op_t;
+
+typedef struct iree_hal_webgpu_replay_op_list_t {
+  iree_hal_webgpu_replay_op_t* head;
+  iree_hal_webgpu_replay_op_t* tail;
+} iree_hal_webgpu_replay_op_list_t;
+
+// Encodes |ops| into a new WebGPU command buffer.
+static WGPUCommandBuffer iree_hal_webgpu_replay_op_list_encode(
+    const iree_hal_webgpu_replay_op_t* ops, WGPUDevice device,
+    iree_hal_webgpu_bind_group_cache_t* bind_group_cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const WGPUCommandEncoderDescriptor encoder_descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(device, &encoder_descriptor);
+  WGPUComputePassEncoder compute_pass = NULL;
+  for (const iree_hal_webgpu_replay_op_t* op = ops; op; op = op->next_op) {
+    switch (op->type) {
+      case IREE_HAL_WEBGPU_REPLAY_OP_BEGIN_COMPUTE_PASS: {
+        const WGPUComputePassDescriptor pass_descriptor = {
+            .nextInChain = NULL,
+            .label = NULL,
+        };
+        compute_pass =
+            wgpuCommandEncoderBeginComputePass(encoder, &pass_descriptor);
+        break;
+      }
+      case IREE_HAL_WEBGPU_REPLAY_OP_END_COMPUTE_PASS:
+        wgpuComputePassEncoderEnd(compute_pass);
+        compute_pass = NULL;
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_PUSH_DEBUG_GROUP:
+        wgpuCommandEncoderPushDebugGroup(encoder, op->push_debug_group.label);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_POP_DEBUG_GROUP:
+        wgpuCommandEncoderPopDebugGroup(encoder);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_CLEAR_BUFFER:
+        wgpuCommandEncoderClearBuffer(encoder, op->clear_buffer.buffer,
+                                      op->clear_buffer.offset,
+                                      op->clear_buffer.length);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_COPY_BUFFER:
+        wgpuCommandEncoderCopyBufferToBuffer(
+            encoder, op->copy_buffer.source_buffer,
+            op->copy_buffer.source_offset, op->copy_buffer.target_buffer,
+            op->copy_buffer.target_offset, op->copy_buffer.length);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_SET_PIPELINE:
+        wgpuComputePassEncoderSetPipeline(compute_pass,
+                                          op->set_pipeline.pipeline);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_SET_BIND_GROUP: {
+        WGPUBindGroup handle = op->set_bind_group.handle;
+        if (!handle) {
+          handle = iree_hal_webgpu_bind_group_cache_acquire(
+              bind_group_cache, op->set_bind_group.group_layout,
+              op->set_bind_group.bindings, op->set_bind_group.binding_mask);
+        }
+        wgpuComputePassEncoderSetBindGroup(
+            compute_pass, op->set_bind_group.group_index, handle,
+            op->set_bind_group.dynamic_offset_count,
+            &op->set_bind_group.dynamic_offset);
+        break;
+      }
+      case IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH:
+        wgpuComputePassEncoderDispatchWorkgroups(
+            compute_pass, op->dispatch.workgroup_x, op->dispatch.workgroup_y,
+            op->dispatch.workgroup_z);
+        break;
+      case IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH_INDIRECT:
+        wgpuComputePassEncoderDispatchWorkgroupsIndirect(
+            compute_pass, op->dispatch_indirect.workgroups_buffer,
+            op->dispatch_indirect.workgroups_offset);
+        break;
+      default:
+        break;
+    }
+  }
+  if (compute_pass) wgpuComputePassEncoderEnd(compute_pass);
+
+  const WGPUCommandBufferDescriptor descriptor = {
+      .nextInChain = NULL,
+      .label = NULL,
+  };
+  WGPUCommandBuffer handle = wgpuCommandEncoderFinish(encoder, &descriptor);
+
+  IREE_TRACE_ZONE_END(z0);
+  return handle;
+}
 
 //===----------------------------------------------------------------------===//
 // Segmented submission management
@@ -39,7 +204,11 @@ typedef struct iree_hal_webgpu_command_segment_t {
   iree_hal_webgpu_command_segment_action_t action;
   union {
     struct {
+      // Encoded command buffer; consumed by the first submission.
       WGPUCommandBuffer command_buffer;
+      // Commands captured for re-encoding on subsequent submissions. Only
+      // populated for reusable command buffers.
+      const iree_hal_webgpu_replay_op_t* replay_ops;
     } execute;
     struct {
       const void* source_buffer;
@@ -61,11 +230,13 @@ static void iree_hal_webgpu_command_segment_list_reset(
   for (iree_hal_webgpu_command_segment_t* segment = list->head; segment;
        segment = segment->next_segment) {
     switch (segment->action) {
-      case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_WRITE_BUFFER:
-        iree_wgpuCommandBufferDrop(segment->execute.command_buffer);
+      case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_EXECUTE:
+        if (segment->execute.command_buffer) {
+          iree_wgpuCommandBufferDrop(segment->execute.command_buffer);
+        }
         break;
       default:
-      case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_EXECUTE:
+      case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_WRITE_BUFFER:
         // Nothing to do.
         break;
     }
@@ -94,9 +265,23 @@ static void iree_hal_webgpu_command_segment_list_push_back(
 }
 
 static void iree_hal_webgpu_command_segment_issue_execute(
-    iree_hal_webgpu_command_segment_t* segment, WGPUQueue queue) {
+    iree_hal_webgpu_command_segment_t* segment, WGPUQueue queue,
+    WGPUDevice device, iree_hal_webgpu_bind_group_cache_t* bind_group_cache) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  wgpuQueueSubmit(queue, 1, &segment->execute.command_buffer);
+
+  // The command buffer encoded during recording is used for the first
+  // submission. Subsequent submissions re-encode the captured commands.
+  WGPUCommandBuffer handle = segment->execute.command_buffer;
+  segment->execute.command_buffer = NULL;
+  if (!handle && segment->execute.replay_ops) {
+    handle = iree_hal_webgpu_replay_op_list_encode(
+        segment->execute.replay_ops, device, bind_group_cache);
+  }
+  if (handle) {
+    wgpuQueueSubmit(queue, 1, &handle);
+    iree_wgpuCommandBufferDrop(handle);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -146,6 +331,9 @@ typedef struct iree_hal_webgpu_command_buffer_t {
     WGPUCommandEncoder encoder;
     // Currently open pass - NULL if no open pass.
     WGPUComputePassEncoder compute_pass;
+    // Commands captured from the open encoder for replay. Only populated for
+    // reusable command buffers.
+    iree_hal_webgpu_replay_op_list_t replay_ops;
 
     // All available push constants updated each time push_constants is called.
     // Reset only with the command buffer and otherwise will maintain its values
@@ -197,12 +385,6 @@ iree_status_t iree_hal_webgpu_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_webgpu_command_buffer_t* command_buffer = NULL;
@@ -249,6 +431,7 @@ static void iree_hal_webgpu_command_buffer_reset(
 
   if (command_buffer->state.compute_pass) {
     wgpuComputePassEncoderEnd(command_buffer->state.compute_pass);
+    command_buffer->state.compute_pass = NULL;
   }
   if (command_buffer->state.encoder) {
     const WGPUCommandBufferDescriptor descriptor = {
@@ -261,6 +444,8 @@ static void iree_hal_webgpu_command_buffer_reset(
   }
 
   command_buffer->state.bind_groups_empty = 0;
+  memset(&command_buffer->state.replay_ops, 0,
+         sizeof(command_buffer->state.replay_ops));
 
   iree_hal_webgpu_staging_buffer_reset(command_buffer->staging_buffer);
   iree_hal_webgpu_command_segment_list_reset(&command_buffer->segments);
@@ -295,7 +480,9 @@ iree_status_t iree_hal_webgpu_command_buffer_issue(
        segment; segment = segment->next_segment) {
     switch (segment->action) {
       case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_EXECUTE:
-        iree_hal_webgpu_command_segment_issue_execute(segment, queue);
+        iree_hal_webgpu_command_segment_issue_execute(
+            segment, queue, command_buffer->device,
+            command_buffer->bind_group_cache);
         break;
       case IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_WRITE_BUFFER:
         iree_hal_webgpu_command_segment_issue_write_buffer(segment, queue);
@@ -309,15 +496,86 @@ iree_status_t iree_hal_webgpu_command_buffer_issue(
   return iree_ok_status();
 }
 
+// Captures a command of |type| for replay and returns it in |out_op| for the
+// caller to populate. Returns NULL in |out_op| if the command buffer is
+// one-shot and commands are not captured.
+static iree_status_t iree_hal_webgpu_command_buffer_capture(
+    iree_hal_webgpu_command_buffer_t* command_buffer,
+    iree_hal_webgpu_replay_op_type_t type,
+    iree_hal_webgpu_replay_op_t** out_op) {
+  *out_op = NULL;
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_ok_status();
+  }
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, sizeof(*op), (void**)&op));
+  memset(op, 0, sizeof(*op));
+  op->type = type;
+  iree_hal_webgpu_replay_op_list_t* list = &command_buffer->state.replay_ops;
+  if (list->tail) {
+    list->tail->next_op = op;
+  } else {
+    list->head = op;
+  }
+  list->tail = op;
+  *out_op = op;
+  return iree_ok_status();
+}
+
+// Ends the open compute pass, if any.
+static iree_status_t iree_hal_webgpu_command_buffer_end_compute_pass(
+    iree_hal_webgpu_command_buffer_t* command_buffer) {
+  if (!command_buffer->state.compute_pass) return iree_ok_status();
+  wgpuComputePassEncoderEnd(command_buffer->state.compute_pass);
+  command_buffer->state.compute_pass = NULL;
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  return iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_END_COMPUTE_PASS, &op);
+}
+
+// Captures a bind group set on the open compute pass. |handle| is captured
+// as-is when the bind group is owned by the device and otherwise NULL with the
+// bind group reacquired from the cache by |group_layout|, |bindings|, and
+// |binding_mask| on replay.
+static iree_status_t iree_hal_webgpu_command_buffer_capture_bind_group(
+    iree_hal_webgpu_command_buffer_t* command_buffer, uint32_t group_index,
+    WGPUBindGroup handle, WGPUBindGroupLayout group_layout,
+    const iree_hal_webgpu_bind_group_binding_t* bindings,
+    iree_hal_webgpu_binding_mask_t binding_mask,
+    uint32_t dynamic_offset_count, uint32_t dynamic_offset) {
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_SET_BIND_GROUP, &op));
+  if (!op) return iree_ok_status();
+  op->set_bind_group.group_index = group_index;
+  op->set_bind_group.handle = handle;
+  op->set_bind_group.dynamic_offset_count = dynamic_offset_count;
+  op->set_bind_group.dynamic_offset = dynamic_offset;
+  if (!handle) {
+    // Snapshot the bindings as the command buffer state changes as recording
+    // continues.
+    iree_hal_webgpu_bind_group_binding_t* bindings_copy = NULL;
+    iree_host_size_t bindings_size =
+        IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT * sizeof(*bindings);
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, bindings_size, (void**)&bindings_copy));
+    memcpy(bindings_copy, bindings, bindings_size);
+    op->set_bind_group.group_layout = group_layout;
+    op->set_bind_group.binding_mask = binding_mask;
+    op->set_bind_group.bindings = bindings_copy;
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_webgpu_command_buffer_flush_encoder(
     iree_hal_webgpu_command_buffer_t* command_buffer) {
   if (!command_buffer->state.encoder) return iree_ok_status();
 
   // End any open compute pass.
-  if (command_buffer->state.compute_pass) {
-    wgpuComputePassEncoderEnd(command_buffer->state.compute_pass);
-    command_buffer->state.compute_pass = NULL;
-  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_command_buffer_end_compute_pass(command_buffer));
 
   // Finalize encoder and produce a command buffer.
   const WGPUCommandBufferDescriptor descriptor = {
@@ -335,11 +593,14 @@ static iree_status_t iree_hal_webgpu_command_buffer_flush_encoder(
     // Attach the command buffer segment.
     segment->action = IREE_HAL_WEBGPU_COMMAND_SEGMENT_ACTION_EXECUTE;
     segment->execute.command_buffer = handle;
+    segment->execute.replay_ops = command_buffer->state.replay_ops.head;
     iree_hal_webgpu_command_segment_list_push_back(&command_buffer->segments,
                                                    segment);
   } else {
     iree_wgpuCommandBufferDrop(handle);
   }
+  memset(&command_buffer->state.replay_ops, 0,
+         sizeof(command_buffer->state.replay_ops));
   return status;
 }
 
@@ -347,10 +608,8 @@ static iree_status_t iree_hal_webgpu_command_buffer_acquire_command_encoder(
     iree_hal_webgpu_command_buffer_t* command_buffer,
     WGPUCommandEncoder* out_command_encoder) {
   // Close active compute pass, if any.
-  if (command_buffer->state.compute_pass) {
-    wgpuComputePassEncoderEnd(command_buffer->state.compute_pass);
-    command_buffer->state.compute_pass = NULL;
-  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_webgpu_command_buffer_end_compute_pass(command_buffer));
 
   // Reuse an open encoder, if any.
   if (command_buffer->state.encoder) {
@@ -392,6 +651,9 @@ static iree_status_t iree_hal_webgpu_command_buffer_acquire_compute_pass(
   command_buffer->state.compute_pass =
       wgpuCommandEncoderBeginComputePass(command_encoder, &descriptor);
   *out_compute_pass = command_buffer->state.compute_pass;
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_BEGIN_COMPUTE_PASS, &op));
 
   // Reset all device-side state for the compute pass - nothing carries over
   // across passes and we will need to rebind things.
@@ -404,21 +666,12 @@ static iree_status_t iree_hal_webgpu_command_buffer_acquire_compute_pass(
   return iree_ok_status();
 }
 
-static iree_status_t iree_hal_webgpu_command_buffer_flush(
-    iree_hal_webgpu_command_buffer_t* command_buffer) {
-  // Flush any active encoder as we are beginning a new segment.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_webgpu_command_buffer_flush_encoder(command_buffer));
-
-  // Flush the staging buffer to get the upload parameters.
-  void* source_buffer = NULL;
-  WGPUBuffer target_buffer = NULL;
-  iree_host_size_t upload_length = 0;
-  iree_hal_webgpu_staging_buffer_flush(command_buffer->staging_buffer,
-                                       &source_buffer, &target_buffer,
-                                       &upload_length);
-
-  // Enqueue new segment.
+// Enqueues a write_buffer segment uploading |upload_length| bytes of staged
+// parameters from |source_buffer| to |target_buffer| at |target_offset|.
+static iree_status_t iree_hal_webgpu_command_buffer_enqueue_upload(
+    iree_hal_webgpu_command_buffer_t* command_buffer, const void* source_buffer,
+    WGPUBuffer target_buffer, uint32_t target_offset,
+    iree_host_size_t upload_length) {
   uint8_t* storage_base = NULL;
   iree_hal_webgpu_command_segment_t* segment = NULL;
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
@@ -438,7 +691,7 @@ static iree_status_t iree_hal_webgpu_command_buffer_flush(
   segment->write_buffer.source_buffer = storage_buffer;
   segment->write_buffer.source_offset = 0;
   segment->write_buffer.target_buffer = target_buffer;
-  segment->write_buffer.target_offset = 0;
+  segment->write_buffer.target_offset = target_offset;
   segment->write_buffer.length = upload_length;
   iree_hal_webgpu_command_segment_list_push_back(&command_buffer->segments,
                                                  segment);
@@ -446,6 +699,31 @@ static iree_status_t iree_hal_webgpu_command_buffer_flush(
   return iree_ok_status();
 }
 
+static iree_status_t iree_hal_webgpu_command_buffer_flush(
+    iree_hal_webgpu_command_buffer_t* command_buffer) {
+  // Flush the staging buffer to get the upload parameters. The staging buffer
+  // advances to its next segment so that the parameters of the commands
+  // recorded after this flush do not alias the ones uploaded here.
+  void* source_buffer = NULL;
+  WGPUBuffer target_buffer = NULL;
+  uint32_t target_offset = 0;
+  iree_host_size_t upload_length = 0;
+  iree_hal_webgpu_staging_buffer_flush(command_buffer->staging_buffer,
+                                       &source_buffer, &target_buffer,
+                                       &target_offset, &upload_length);
+
+  // The upload must be issued ahead of the commands that read the parameters,
+  // so it is enqueued before the encoder is flushed.
+  if (upload_length > 0) {
+    IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_enqueue_upload(
+        command_buffer, source_buffer, target_buffer, target_offset,
+        upload_length));
+  }
+
+  // Flush any active encoder as we are beginning a new segment.
+  return iree_hal_webgpu_command_buffer_flush_encoder(command_buffer);
+}
+
 static iree_status_t iree_hal_webgpu_command_buffer_append_parameters(
     iree_hal_webgpu_command_buffer_t* command_buffer,
     iree_const_byte_span_t source, uint32_t* out_offset) {
@@ -502,6 +780,21 @@ static void iree_hal_webgpu_command_buffer_begin_debug_group(
   char label_str[128] = {0};
   memcpy(label_str, label.data, iree_min(sizeof(label_str) - 1, label.size));
   wgpuCommandEncoderPushDebugGroup(command_encoder, label_str);
+
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  status = iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_PUSH_DEBUG_GROUP, &op);
+  if (iree_status_is_ok(status) && op) {
+    char* label_copy = NULL;
+    status = iree_arena_allocate(&command_buffer->arena, sizeof(label_str),
+                                 (void**)&label_copy);
+    if (iree_status_is_ok(status)) {
+      memcpy(label_copy, label_str, sizeof(label_str));
+      op->push_debug_group.label = label_copy;
+    }
+  }
+  // TODO(benvanik): mark recording as failed.
+  iree_status_ignore(status);
 }
 
 static void iree_hal_webgpu_command_buffer_end_debug_group(
@@ -519,6 +812,11 @@ static void iree_hal_webgpu_command_buffer_end_debug_group(
   }
 
   wgpuCommandEncoderPopDebugGroup(command_encoder);
+
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  // TODO(benvanik): mark recording as failed.
+  iree_status_ignore(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_POP_DEBUG_GROUP, &op));
 }
 
 static iree_status_t iree_hal_webgpu_command_buffer_execution_barrier(
@@ -616,11 +914,19 @@ static iree_status_t iree_hal_webgpu_command_buffer_fill_buffer(
     IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_acquire_command_encoder(
         command_buffer, &command_encoder));
 
-    wgpuCommandEncoderClearBuffer(
-        command_encoder,
-        iree_hal_webgpu_buffer_handle(
-            iree_hal_buffer_allocated_buffer(target_buffer)),
-        target_offset, length);
+    WGPUBuffer target_handle = iree_hal_webgpu_buffer_handle(
+        iree_hal_buffer_allocated_buffer(target_buffer));
+    wgpuCommandEncoderClearBuffer(command_encoder, target_handle,
+                                  target_offset, length);
+
+    iree_hal_webgpu_replay_op_t* op = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+        command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_CLEAR_BUFFER, &op));
+    if (op) {
+      op->clear_buffer.buffer = target_handle;
+      op->clear_buffer.offset = target_offset;
+      op->clear_buffer.length = length;
+    }
     return iree_ok_status();
   }
 
@@ -645,6 +951,10 @@ static iree_status_t iree_hal_webgpu_command_buffer_fill_buffer(
   IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_acquire_compute_pass(
       command_buffer, &compute_pass));
   wgpuComputePassEncoderSetPipeline(compute_pass, builtin->pipeline);
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_SET_PIPELINE, &op));
+  if (op) op->set_pipeline.pipeline = builtin->pipeline;
 
   // Bind the push constant emulation bind group at the staging buffer relative
   // offset for this dispatch.
@@ -652,9 +962,17 @@ static iree_status_t iree_hal_webgpu_command_buffer_fill_buffer(
                                      command_buffer->staging_buffer->bind_group,
                                      1, &params_offset);
   command_buffer->state.bind_groups[0].handle = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture_bind_group(
+      command_buffer, /*group_index=*/0,
+      command_buffer->staging_buffer->bind_group, NULL, NULL, 0,
+      /*dynamic_offset_count=*/1, params_offset));
 
   // Grab a (probably uncached) bind group for the target buffer binding.
-  const iree_hal_webgpu_bind_group_binding_t buffer_binding = {
+  // The cache compares all binding slots so the unused ones must be zeroed.
+  iree_hal_webgpu_bind_group_binding_t
+      buffer_bindings[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  memset(buffer_bindings, 0, sizeof(buffer_bindings));
+  buffer_bindings[0] = (iree_hal_webgpu_bind_group_binding_t){
       .type = WGPUBufferBindingType_Storage,
       .buffer = iree_hal_webgpu_buffer_handle(
           iree_hal_buffer_allocated_buffer(target_buffer)),
@@ -663,14 +981,24 @@ static iree_status_t iree_hal_webgpu_command_buffer_fill_buffer(
   };
   WGPUBindGroup buffer_group = iree_hal_webgpu_bind_group_cache_acquire(
       command_buffer->bind_group_cache, builtin->buffer_group_layout,
-      &buffer_binding, /*binding_mask=*/1);
+      buffer_bindings, /*binding_mask=*/1);
   wgpuComputePassEncoderSetBindGroup(compute_pass, /*groupIndex=*/1,
                                      buffer_group, 0, NULL);
   command_buffer->state.bind_groups[1].handle = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture_bind_group(
+      command_buffer, /*group_index=*/1, NULL, builtin->buffer_group_layout,
+      buffer_bindings, /*binding_mask=*/1, /*dynamic_offset_count=*/0, 0));
 
   // NOTE: this is not the right way to do this - we need to be tiling inside
   // the fill.
   wgpuComputePassEncoderDispatchWorkgroups(compute_pass, length, 1, 1);
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH, &op));
+  if (op) {
+    op->dispatch.workgroup_x = length;
+    op->dispatch.workgroup_y = 1;
+    op->dispatch.workgroup_z = 1;
+  }
 
   return iree_ok_status();
 }
@@ -682,9 +1010,10 @@ static iree_status_t iree_hal_webgpu_command_buffer_update_buffer(
   iree_hal_webgpu_command_buffer_t* command_buffer =
       iree_hal_webgpu_command_buffer_cast(base_command_buffer);
 
-  // Flush any active encoder as we are beginning a new segment.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_webgpu_command_buffer_flush_encoder(command_buffer));
+  // Flush any staged parameters and the active encoder as we are beginning a
+  // new segment; the commands recorded so far must be issued with their
+  // parameters before the update.
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_flush(command_buffer));
 
   // Enqueue new segment.
   uint8_t* storage_base = NULL;
@@ -728,10 +1057,22 @@ static iree_status_t iree_hal_webgpu_command_buffer_copy_buffer(
   IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_acquire_command_encoder(
       command_buffer, &command_encoder));
 
-  wgpuCommandEncoderCopyBufferToBuffer(
-      command_encoder, iree_hal_webgpu_buffer_handle(source_buffer),
-      source_offset, iree_hal_webgpu_buffer_handle(target_buffer),
-      target_offset, length);
+  WGPUBuffer source_handle = iree_hal_webgpu_buffer_handle(source_buffer);
+  WGPUBuffer target_handle = iree_hal_webgpu_buffer_handle(target_buffer);
+  wgpuCommandEncoderCopyBufferToBuffer(command_encoder, source_handle,
+                                       source_offset, target_handle,
+                                       target_offset, length);
+
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_COPY_BUFFER, &op));
+  if (op) {
+    op->copy_buffer.source_buffer = source_handle;
+    op->copy_buffer.source_offset = source_offset;
+    op->copy_buffer.target_buffer = target_handle;
+    op->copy_buffer.target_offset = target_offset;
+    op->copy_buffer.length = length;
+  }
 
   return iree_ok_status();
 }
@@ -820,6 +1161,10 @@ static iree_status_t iree_hal_webgpu_command_buffer_prepare_dispatch(
   IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_acquire_compute_pass(
       command_buffer, &compute_pass));
   wgpuComputePassEncoderSetPipeline(compute_pass, entry_point->pipeline);
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_SET_PIPELINE, &op));
+  if (op) op->set_pipeline.pipeline = entry_point->pipeline;
 
   if (push_constant_count > 0) {
     // Bind the push constant emulation bind group at the staging buffer
@@ -827,6 +1172,10 @@ static iree_status_t iree_hal_webgpu_command_buffer_prepare_dispatch(
     wgpuComputePassEncoderSetBindGroup(
         compute_pass, IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX,
         command_buffer->staging_buffer->bind_group, 1, &params_offset);
+    IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture_bind_group(
+        command_buffer, IREE_HAL_WEBGPU_PARAMS_BIND_GROUP_INDEX,
+        command_buffer->staging_buffer->bind_group, NULL, NULL, 0,
+        /*dynamic_offset_count=*/1, params_offset));
   }
 
   // Set all bindings.
@@ -854,6 +1203,10 @@ static iree_status_t iree_hal_webgpu_command_buffer_prepare_dispatch(
     // a lot of bindings.
     wgpuComputePassEncoderSetBindGroup(compute_pass, (uint32_t)i, handle, 0,
                                        NULL);
+    IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture_bind_group(
+        command_buffer, (uint32_t)i, NULL, binding_info->set_layouts[i],
+        command_buffer->state.bind_groups[i].bindings,
+        binding_info->set_masks[i], /*dynamic_offset_count=*/0, 0));
     command_buffer->state.bind_groups[i].handle = handle;
     command_buffer->state.bind_groups_empty &= ~(1ull << i);
   }
@@ -869,6 +1222,9 @@ static iree_status_t iree_hal_webgpu_command_buffer_prepare_dispatch(
 
       wgpuComputePassEncoderSetBindGroup(compute_pass, (uint32_t)i,
                                          empty_handle, 0, NULL);
+      IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture_bind_group(
+          command_buffer, (uint32_t)i, empty_handle, NULL, NULL, 0,
+          /*dynamic_offset_count=*/0, 0));
       command_buffer->state.bind_groups[i].handle = empty_handle;
       command_buffer->state.bind_groups_empty |= 1ull << i;
     }
@@ -891,6 +1247,15 @@ static iree_status_t iree_hal_webgpu_command_buffer_dispatch(
   wgpuComputePassEncoderDispatchWorkgroups(compute_pass, workgroup_x,
                                            workgroup_y, workgroup_z);
 
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH, &op));
+  if (op) {
+    op->dispatch.workgroup_x = workgroup_x;
+    op->dispatch.workgroup_y = workgroup_y;
+    op->dispatch.workgroup_z = workgroup_z;
+  }
+
   return iree_ok_status();
 }
 
@@ -905,9 +1270,18 @@ static iree_status_t iree_hal_webgpu_command_buffer_dispatch_indirect(
   WGPUComputePassEncoder compute_pass = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_prepare_dispatch(
       command_buffer, executable, entry_point, &compute_pass));
+  WGPUBuffer workgroups_handle =
+      iree_hal_webgpu_buffer_handle(workgroups_buffer);
   wgpuComputePassEncoderDispatchWorkgroupsIndirect(
-      compute_pass, iree_hal_webgpu_buffer_handle(workgroups_buffer),
-      workgroups_offset);
+      compute_pass, workgroups_handle, workgroups_offset);
+
+  iree_hal_webgpu_replay_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_capture(
+      command_buffer, IREE_HAL_WEBGPU_REPLAY_OP_DISPATCH_INDIRECT, &op));
+  if (op) {
+    op->dispatch_indirect.workgroups_buffer = workgroups_handle;
+    op->dispatch_indirect.workgroups_offset = workgroups_offset;
+  }
 
   return iree_ok_status();
 }
@@ -916,12 +1290,18 @@ static iree_status_t iree_hal_webgpu_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers via deferred command buffers
-  // as WebGPU has no concept of reusable dispatch command encoders. One day
-  // hopefully there's an equivalent of GPURenderBundle but given WebGPU's other
+  // WebGPU has no concept of reusable dispatch command encoders so nested
+  // command buffers are recorded as deferred command buffers and replayed into
+  // this command buffer with the binding table resolved. One day hopefully
+  // there's an equivalent of GPURenderBundle but given WebGPU's other
   // limitations it may not be useful.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 const iree_hal_command_buffer_vtable_t iree_hal_webgpu_command_buffer_vtable = {
@@ -36,6 +36,27 @@ iree_status_t iree_hal_webgpu_staging_buffer_initialize(
   out_staging_buffer->capacity = (uint32_t)host_buffer_capacity;
   out_staging_buffer->host_buffer = host_buffer;
 
+  // Split the capacity into aligned segments, using fewer segments if the
+  // buffer is too small to give each at least one aligned reservation.
+  uint32_t segment_count = IREE_HAL_WEBGPU_STAGING_BUFFER_SEGMENT_COUNT;
+  while (segment_count > 1 &&
+         out_staging_buffer->capacity / segment_count <
+             out_staging_buffer->alignment) {
+    --segment_count;
+  }
+  out_staging_buffer->segment_count = segment_count;
+  out_staging_buffer->segment_capacity =
+      (out_staging_buffer->capacity / segment_count) &
+      ~(out_staging_buffer->alignment - 1);
+
+  // The bind group exposes a fixed window at the dynamic offset of each
+  // dispatch; the device buffer is padded so that the window of a reservation
+  // at the very end of the ring remains in bounds.
+  const uint32_t binding_size =
+      iree_min(iree_max(IREE_HAL_WEBGPU_STAGING_BUFFER_BINDING_SIZE,
+                        out_staging_buffer->alignment),
+               limits->maxUniformBufferBindingSize);
+
   const iree_hal_buffer_params_t buffer_params = {
       .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
                IREE_HAL_BUFFER_USAGE_DISPATCH_UNIFORM_READ |
@@ -47,7 +68,8 @@ iree_status_t iree_hal_webgpu_staging_buffer_initialize(
   iree_hal_buffer_t* device_buffer = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_allocator_allocate_buffer(device_allocator, buffer_params,
-                                             out_staging_buffer->capacity,
+                                             out_staging_buffer->capacity +
+                                                 binding_size,
                                              &device_buffer));
   out_staging_buffer->device_buffer = device_buffer;
   iree_hal_buffer_retain(device_buffer);
@@ -83,7 +105,7 @@ iree_status_t iree_hal_webgpu_staging_buffer_initialize(
           .binding = 0,
           .buffer = out_staging_buffer->device_buffer_handle,
           .offset = 0,
-          .size = limits->maxUniformBufferBindingSize,
+          .size = binding_size,
       },
   };
   const WGPUBindGroupDescriptor descriptor = {
@@ -132,21 +154,24 @@ iree_status_t iree_hal_webgpu_staging_buffer_reserve(
     iree_byte_span_t* out_reservation, uint32_t* out_offset) {
   iree_host_size_t aligned_length =
       iree_host_align(length, staging_buffer->alignment);
-  if (aligned_length > staging_buffer->capacity) {
-    // Will never fit in the staging buffer.
+  if (aligned_length > staging_buffer->segment_capacity) {
+    // Will never fit in a staging buffer segment.
     return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
                             "reservation (%" PRIhsz
-                            ") exceeds the maximum capacity of "
+                            ") exceeds the maximum segment capacity of "
                             "the staging buffer (%" PRIu32 ")",
-                            length, staging_buffer->capacity);
+                            length, staging_buffer->segment_capacity);
   } else if (staging_buffer->offset + aligned_length >
-             staging_buffer->capacity) {
+             staging_buffer->segment_capacity) {
     // Flush required - this is not an error but a request to the caller.
     return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
   }
+  const uint32_t segment_base =
+      staging_buffer->segment_index * staging_buffer->segment_capacity;
   *out_reservation = iree_make_byte_span(
-      staging_buffer->host_buffer + staging_buffer->offset, aligned_length);
-  *out_offset = staging_buffer->offset;
+      staging_buffer->host_buffer + segment_base + staging_buffer->offset,
+      aligned_length);
+  *out_offset = segment_base + staging_buffer->offset;
   staging_buffer->offset += aligned_length;
   return iree_ok_status();
 }
@@ -163,11 +188,20 @@ iree_status_t iree_hal_webgpu_staging_buffer_append(
 
 void iree_hal_webgpu_staging_buffer_flush(
     iree_hal_webgpu_staging_buffer_t* staging_buffer, void** out_source_buffer,
-    WGPUBuffer* out_target_buffer, iree_host_size_t* out_length) {
-  *out_source_buffer = staging_buffer->host_buffer;
+    WGPUBuffer* out_target_buffer, uint32_t* out_target_offset,
+    iree_host_size_t* out_length) {
+  const uint32_t segment_base =
+      staging_buffer->segment_index * staging_buffer->segment_capacity;
+  *out_source_buffer = staging_buffer->host_buffer + segment_base;
   *out_target_buffer = staging_buffer->device_buffer_handle;
+  *out_target_offset = segment_base;
   *out_length = staging_buffer->offset;
-  staging_buffer->offset = 0;
+  if (staging_buffer->offset > 0) {
+    // Advance the ring so the next upload does not alias this one.
+    staging_buffer->segment_index =
+        (staging_buffer->segment_index + 1) % staging_buffer->segment_count;
+    staging_buffer->offset = 0;
+  }
 }
 
 void iree_hal_webgpu_staging_buffer_reset(
@@ -26,6 +26,18 @@ extern "C" {
 // dispatch of parameters and get 128KB.
 #define IREE_HAL_WEBGPU_STAGING_BUFFER_DEFAULT_CAPACITY (128 * 1024)
 
+// Number of segments the staging buffer is divided into.
+// Each flush uploads only the segment being written and advances to the next
+// so that consecutive uploads target disjoint device memory. This lets the
+// implementation schedule an upload without waiting on previously submitted
+// work that is still reading the parameters from the prior segment.
+#define IREE_HAL_WEBGPU_STAGING_BUFFER_SEGMENT_COUNT 4
+
+// Size, in bytes, of the uniform binding window exposed through the bind
+// group. Must be large enough to hold the largest set of parameters read by a
+// single dispatch (IREE_HAL_WEBGPU_MAX_PUSH_CONSTANT_COUNT * 4).
+#define IREE_HAL_WEBGPU_STAGING_BUFFER_BINDING_SIZE 256
+
 // A staging uniform buffer used for uploading parameters to the device.
 // This allows for high-frequency writes of parameters at appropriate alignment.
 //
@@ -36,6 +48,12 @@ extern "C" {
 // puts the writes into queue timeline immediately before the commands that use
 // it are submitted, and as there is only in-order execution per WebGPU queue
 // this provides us a completely queue-ordered set of memory.
+//
+// The buffer is managed as a ring of segments: writes fill the current segment
+// and a flush uploads just that segment and moves on to the next. Because
+// uploads are queue-ordered no host synchronization is required when the ring
+// wraps around; the segments only serve to keep successive uploads from
+// aliasing memory that in-flight work may still be reading.
 typedef struct iree_hal_webgpu_staging_buffer_t {
   // Alignment required on offsets into the buffer.
   // Uniform bindings with dynamic offsets must satisfy this alignment and on
@@ -44,6 +62,13 @@ typedef struct iree_hal_webgpu_staging_buffer_t {
   // Maximum number of bytes in the buffer.
   uint32_t capacity;
 
+  // Number of segments in the ring.
+  uint32_t segment_count;
+  // Maximum number of bytes in each segment; a multiple of |alignment|.
+  uint32_t segment_capacity;
+  // Index of the segment currently being written.
+  uint32_t segment_index;
+
   // Host-local buffer pointer.
   uint8_t* host_buffer;
   // Device-local HAL buffer - retains ownership.
@@ -61,7 +86,8 @@ typedef struct iree_hal_webgpu_staging_buffer_t {
   // Empty bind group.
   WGPUBindGroup empty_bind_group;
 
-  // Current write offset in the device buffer.
+  // Current write offset in the device buffer relative to the start of the
+  // current segment.
   uint32_t offset;
 } iree_hal_webgpu_staging_buffer_t;
 
@@ -77,26 +103,29 @@ void iree_hal_webgpu_staging_buffer_deinitialize(
 
 // Reserves |length| bytes from the staging buffer and returns a pointer to it
 // in |out_reservation|.
-// Returns RESOURCE_EXHAUSTED if the staging buffer is full and must be flushed
-// with iree_hal_webgpu_staging_buffer_flush first.
+// Returns RESOURCE_EXHAUSTED if the current segment is full and the staging
+// buffer must be flushed with iree_hal_webgpu_staging_buffer_flush first.
 iree_status_t iree_hal_webgpu_staging_buffer_reserve(
     iree_hal_webgpu_staging_buffer_t* staging_buffer, iree_host_size_t length,
     iree_byte_span_t* out_reservation, uint32_t* out_offset);
 
 // Appends |data| of |length| bytes to the staging buffer.
-// Returns RESOURCE_EXHAUSTED if the staging buffer is full and must be flushed
-// with iree_hal_webgpu_staging_buffer_flush first.
+// Returns RESOURCE_EXHAUSTED if the current segment is full and the staging
+// buffer must be flushed with iree_hal_webgpu_staging_buffer_flush first.
 iree_status_t iree_hal_webgpu_staging_buffer_append(
     iree_hal_webgpu_staging_buffer_t* staging_buffer,
     iree_const_byte_span_t source, uint32_t* out_offset);
 
 // Flushes any pending uploads and returns the source buffer, target buffer,
-// and length to upload. |out_length| may be 0 if there is nothing to flush.
+// target offset, and length to upload. |out_length| may be 0 if there is
+// nothing to flush. When there was data to flush subsequent writes will go to
+// the next segment in the ring.
 void iree_hal_webgpu_staging_buffer_flush(
     iree_hal_webgpu_staging_buffer_t* staging_buffer, void** out_source_buffer,
-    WGPUBuffer* out_target_buffer, iree_host_size_t* out_length);
+    WGPUBuffer* out_target_buffer, uint32_t* out_target_offset,
+    iree_host_size_t* out_length);
 
-// Resets the staging buffer to clear any pending writes.
+// Resets the staging buffer to clear any pending writes to the current segment.
 void iree_hal_webgpu_staging_buffer_reset(
     iree_hal_webgpu_staging_buffer_t* staging_buffer);
 
@@ -21,6 +21,7 @@
 #include "experimental/webgpu/staging_buffer.h"
 #include "iree/base/internal/arena.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -238,6 +239,14 @@ static iree_status_t iree_hal_webgpu_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) ||
+      binding_capacity > 0) {
+    // Indirect command buffers are recorded once and replayed into each
+    // command buffer executing them with its binding table.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->large_block_pool, device->host_allocator, out_command_buffer);
+  }
   return iree_hal_webgpu_command_buffer_create(
       (iree_hal_device_t*)device, device->handle, mode, command_categories,
       queue_affinity, binding_capacity, &device->large_block_pool,
@@ -385,6 +394,36 @@ static iree_status_t iree_hal_webgpu_device_queue_write(
   return loop_status;
 }
 
+// Replays a deferred |command_buffer| into a transient command buffer and
+// issues it to the device queue.
+static iree_status_t iree_hal_webgpu_device_issue_deferred_command_buffer(
+    iree_hal_webgpu_device_t* device,
+    iree_hal_command_buffer_t* command_buffer) {
+  iree_hal_command_buffer_t* replay_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_webgpu_command_buffer_create(
+      (iree_hal_device_t*)device, device->handle,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT, IREE_HAL_COMMAND_CATEGORY_ANY,
+      IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/0,
+      &device->large_block_pool, &device->staging_buffer,
+      &device->bind_group_cache, &device->builtins, device->host_allocator,
+      &replay_command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(replay_command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_deferred_command_buffer_apply(
+        command_buffer, replay_command_buffer,
+        iree_hal_buffer_binding_table_empty());
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(replay_command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_webgpu_command_buffer_issue(replay_command_buffer,
+                                                  device->queue);
+  }
+  iree_hal_command_buffer_release(replay_command_buffer);
+  return status;
+}
+
 static iree_status_t iree_hal_webgpu_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -404,6 +443,11 @@ static iree_status_t iree_hal_webgpu_device_queue_execute(
   // TODO(benvanik): propagate errors to semaphores.
   for (iree_host_size_t i = 0; i < command_buffer_count; i++) {
     iree_hal_command_buffer_t* command_buffer = command_buffers[i];
+    if (iree_hal_deferred_command_buffer_isa(command_buffer)) {
+      IREE_RETURN_IF_ERROR(iree_hal_webgpu_device_issue_deferred_command_buffer(
+          device, command_buffer));
+      continue;
+    }
     IREE_RETURN_IF_ERROR(
         iree_hal_webgpu_command_buffer_issue(command_buffer, device->queue));
   }
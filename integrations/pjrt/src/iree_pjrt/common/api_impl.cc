@@ -6,6 +6,8 @@
 
 #include "iree_pjrt/common/api_impl.h"
 
+#include <algorithm>
+#include <functional>
 #include <optional>
 
 #include "iree/hal/api.h"
@@ -20,6 +22,10 @@ namespace iree::pjrt {
 
 const std::string_view kMlirFormat = "mlir";
 
+// Minimum alignment of host pointers that are imported for device transfers.
+// Unaligned pointers are snapshotted instead.
+constexpr iree_host_size_t kHostImportAlignment = 64;
+
 // Some general conversion functions for managing around some API layering
 // that is in flight. It is expected that most of this goes away over time.
 namespace PJRTApiConverter {
@@ -386,6 +392,12 @@ iree_status_t BufferInstance::Delete() {
   return iree_ok_status();
 }
 
+void BufferInstance::Donate() {
+  IREE_TRACE_SCOPE();
+  is_deleted_ = true;
+  buffer_view_.reset();
+}
+
 iree_status_t BufferInstance::CopyToHost(void* dst, iree_host_size_t dst_size,
                                          EventInstance** out_done_event) {
   // Use a data structure to handle intermediary buffer when necessary. This
@@ -695,6 +707,15 @@ iree_status_t DeviceInstance::OpenDevice() {
   IREE_RETURN_IF_ERROR(
       iree_hal_semaphore_create(device(), 0ull, &transfer_timeline_));
 
+  // Collectives in SPMD-partitioned programs span all addressable devices.
+  iree_hal_channel_provider_t* channel_provider = nullptr;
+  IREE_RETURN_IF_ERROR(
+      client_.CreateChannelProvider(this, &channel_provider));
+  if (channel_provider) {
+    iree_hal_device_replace_channel_provider(device(), channel_provider);
+    iree_hal_channel_provider_release(channel_provider);
+  }
+
   return iree_ok_status();
 }
 
@@ -940,9 +961,10 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   // directly operating on imported host buffers. In many actual
   // host/device situations, such unified memory is a productivity (not a
   // performance) feature and best avoided. As such, we always need to be
-  // able to decide to do a staged transfer and implement that here. Using
-  // an imported buffer on the device is left as an optimization for
-  // implementations on which we believe it will be beneficial.
+  // able to decide to do a staged transfer and implement that here. When the
+  // caller guarantees the data outlives the transfer we only use the
+  // imported buffer as the source of a copy and signal the caller once the
+  // copy has completed.
   bool require_snapshot_now = host_buffer_semantics ==
                               PJRT_HostBufferSemantics_kImmutableOnlyDuringCall;
   bool caller_data_done = false;
@@ -951,12 +973,6 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   IREE_RETURN_IF_ERROR(AcquireHostStagingBuffer(
       iree_make_const_byte_span(data, byte_length), require_snapshot_now,
       &caller_data_done, &host_staging_buffer));
-  if (!caller_data_done) {
-    return iree_make_status(
-        IREE_STATUS_UNIMPLEMENTED,
-        "deferred snapshot of host data not yet implemented");
-  }
-
   // Allocate on stream. We serialize across 3 timepoints:
   //   0. Last transfer complete
   //   1. Allocation
@@ -1016,9 +1032,20 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   instance->AdvanceDoneFence(transfer_timeline_.get(), signal_copy_complete);
   *out_buffer = instance;
 
-  // We snapshotted the caller data when acquiring the host staging buffer,
-  // so we won't be touching it again.
-  *out_done_with_host_buffer_event = new EventInstance(/*fence=*/nullptr);
+  if (caller_data_done) {
+    // We snapshotted the caller data when acquiring the host staging buffer,
+    // so we won't be touching it again.
+    *out_done_with_host_buffer_event = new EventInstance(/*fence=*/nullptr);
+  } else {
+    // The device reads directly out of the caller data so it must be kept
+    // alive until the copy has completed.
+    iree::vm::ref<iree_hal_fence_t> copy_done_fence;
+    IREE_RETURN_IF_ERROR(IreeApi::hal_fence_create_at(
+        transfer_timeline_.get(), signal_copy_complete,
+        client_.host_allocator(), &copy_done_fence));
+    *out_done_with_host_buffer_event =
+        new EventInstance(std::move(copy_done_fence));
+  }
 
   return iree_ok_status();
 }
@@ -1027,22 +1054,54 @@ iree_status_t DeviceInstance::AcquireHostStagingBuffer(
     iree_const_byte_span_t initial_contents, bool snapshot_initial_contents_now,
     bool* initial_contents_snapshotted, iree_hal_buffer_t** out_buffer) {
   IREE_TRACE_SCOPE();
-  // There are multiple ways to do this that have different cost/benefits.
-  // Here we do the simplest thing and snapshot into a new host allocation.
-  // This could be replaced with either some form of staging ring buffer
-  // or importing from a raw pointer (on implementations where the cost of
-  // unified addressing is zero).
+  // If the caller keeps the contents alive until the transfer completes we
+  // try to import the host allocation directly and let the device read out of
+  // it. This avoids both the staging allocation and the host memcpy. Not all
+  // devices support importing (or importing unaligned pointers) and in that
+  // case we fall back to a snapshot.
+  if (!snapshot_initial_contents_now &&
+      iree_host_size_has_alignment((iree_host_size_t)initial_contents.data,
+                                   kHostImportAlignment)) {
+    iree_hal_buffer_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE;
+    iree_hal_external_buffer_t external_buffer;
+    memset(&external_buffer, 0, sizeof(external_buffer));
+    external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+    external_buffer.flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE;
+    external_buffer.size = initial_contents.data_length;
+    external_buffer.handle.host_allocation.ptr =
+        const_cast<uint8_t*>(initial_contents.data);
+    iree_status_t status = iree_hal_allocator_import_buffer(
+        device_allocator(), params, &external_buffer,
+        /*release_callback=*/iree_hal_buffer_release_callback_null(),
+        out_buffer);
+    if (iree_status_is_ok(status)) {
+      // The caller data is read by the device and must remain live until the
+      // transfer has completed.
+      *initial_contents_snapshotted = false;
+      return iree_ok_status();
+    }
+    iree_status_ignore(status);
+  }
+
+  // Snapshot into a new host-local allocation the device can read from
+  // directly. Mapping the staging buffer keeps this a plain memcpy instead of
+  // a blocking device transfer.
   iree_hal_buffer_params_t params;
   memset(&params, 0, sizeof(params));
-  params.type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE;
-  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  params.type =
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  params.usage =
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED;
   IREE_RETURN_IF_ERROR(IreeApi::hal_allocator_allocate_buffer(
       device_allocator(), params, initial_contents.data_length, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_device_transfer_h2d(
-      device(), initial_contents.data, *out_buffer, 0,
-      initial_contents.data_length, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
-      iree_infinite_timeout()));
-  // We did a synchronous snapshot (memcpy).
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_write(*out_buffer, 0,
+                                                 initial_contents.data,
+                                                 initial_contents.data_length));
   *initial_contents_snapshotted = true;
   return iree_ok_status();
 }
@@ -1176,9 +1235,16 @@ void ClientInstance::BindApi(PJRT_Api* api) {
   };
   api->PJRT_Client_DefaultDeviceAssignment =
       +[](PJRT_Client_DefaultDeviceAssignment_Args* args) -> PJRT_Error* {
-    // TODO: Something sensible.
+    // Partitions are assigned to addressable devices in order.
+    // TODO: Something sensible for replicas.
+    auto& devices = ClientInstance::Unwrap(args->client)->addressable_devices();
     for (size_t i = 0; i < args->default_assignment_size; ++i) {
-      args->default_assignment[i] = 0;
+      if (devices.empty()) {
+        args->default_assignment[i] = 0;
+        continue;
+      }
+      args->default_assignment[i] =
+          devices[i % devices.size()]->device_description()->client_id();
     }
     return nullptr;
   };
@@ -1282,6 +1348,73 @@ PJRT_Error* ClientInstance::Compile(PJRT_Program* program,
                                       message.c_str()));
   };
 
+  // Programs are SPMD partitioned across all addressable devices when a
+  // partitioner is available and otherwise replicated on each device.
+  const int num_partitions =
+      platform().partitioner() ? (int)addressable_devices_.size() : 1;
+
+  // Set up the main compilation job first: its flags identify the target and
+  // are needed to look up previously compiled executables.
+  std::unique_ptr<CompilerJob> compiler_job = platform().compiler().StartJob();
+  if (!compiler_job) {
+    std::string message = platform().compiler().GetErrorMessage();
+    return MakeError(
+        iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
+  }
+  if (artifact_tx) {
+    compiler_job->EnableCrashDumps(artifact_tx.get());
+  }
+
+  // Set flags.
+  // TODO: This should be done as part of session setup from a named pool.
+  // TODO: The HAL backends and other flags should come from the assigned
+  // devices.
+  if (!SetDefaultCompilerFlags(compiler_job.get())) {
+    return MakeCompilerError(*compiler_job);
+  }
+  // TODO: Plumb CompileOptions through.
+  // if (!job->SetFlags(options)) return MakeCompilerError(*job);
+  if (artifact_tx) {
+    artifact_tx->WriteArtifact(
+        /*label=*/"flags", /*extension=*/"txt", /*index=*/-1,
+        compiler_job->GetFlags());
+  }
+
+  // Check for a previously compiled executable. The key covers the original
+  // program (prior to partitioning) and everything else that influences the
+  // compiled output.
+  std::string cache_key;
+  if (platform().compile_cache().enabled()) {
+    CompileCache::KeyBuilder key_builder;
+    key_builder.Append(platform().compiler().GetRevision());
+    key_builder.Append(platform().partitioner()
+                           ? platform().partitioner()->GetRevision()
+                           : std::string());
+    key_builder.Append(std::to_string(num_partitions));
+    key_builder.Append(compiler_job->GetFlags());
+    key_builder.Append(format);
+    key_builder.Append(code);
+    cache_key = key_builder.Finish();
+    if (std::unique_ptr<CompilerOutput> output =
+            platform().compile_cache().Lookup(cache_key)) {
+      auto* image = new ExecutableImage(
+          std::move(output), std::string(program->code, program->code_size));
+      image->num_partitions = num_partitions;
+      auto executable = std::make_unique<LoadedExecutableInstance>(
+          *this, image, addressable_devices_);
+      status = executable->LoadAll();
+      if (iree_status_is_ok(status)) {
+        if (artifact_tx) {
+          artifact_tx->Cancel();
+        }
+        *out_executable = executable.release();
+        return nullptr;
+      }
+      // A stale or corrupt entry is treated as a miss and overwritten below.
+      iree_status_ignore(status);
+    }
+  }
+
   std::vector<std::unique_ptr<CompilerOutput>> retained_outputs;
 
   // Partition.
@@ -1299,6 +1432,14 @@ PJRT_Error* ClientInstance::Compile(PJRT_Program* program,
     // Set flags.
     // TODO: Plumb CompileOptions through.
     // if (!job->SetFlags(options)) return MakeCompilerError(*job);
+    // Until then the program is partitioned with one shard per addressable
+    // device.
+    std::string num_partitions_flag(
+        "--openxla-partitioner-gspmd-num-partitions=");
+    num_partitions_flag.append(std::to_string(num_partitions));
+    if (!job->SetFlag(num_partitions_flag.c_str())) {
+      return MakeCompilerError(*job);
+    }
     if (artifact_tx) {
       artifact_tx->WriteArtifact(
           /*label=*/"partitioner_flags", /*extension=*/"txt", /*index=*/-1,
@@ -1331,30 +1472,7 @@ PJRT_Error* ClientInstance::Compile(PJRT_Program* program,
 
   // Main compilation.
   {
-    std::unique_ptr<CompilerJob> job = platform().compiler().StartJob();
-    if (!job) {
-      std::string message = platform().compiler().GetErrorMessage();
-      return MakeError(
-          iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
-    }
-    if (artifact_tx) {
-      job->EnableCrashDumps(artifact_tx.get());
-    }
-
-    // Set flags.
-    // TODO: This should be done as part of session setup from a named pool.
-    // TODO: The HAL backends and other flags should come from the assigned
-    // devices.
-    if (!SetDefaultCompilerFlags(job.get())) {
-      return MakeCompilerError(*job);
-    }
-    // TODO: Plumb CompileOptions through.
-    // if (!job->SetFlags(options)) return MakeCompilerError(*job);
-    if (artifact_tx) {
-      artifact_tx->WriteArtifact(
-          /*label=*/"flags", /*extension=*/"txt", /*index=*/-1,
-          job->GetFlags());
-    }
+    std::unique_ptr<CompilerJob> job = std::move(compiler_job);
 
     // Parse the source.
     if (!job->ParseSourceBuffer(code.data(), code.size())) {
@@ -1372,12 +1490,18 @@ PJRT_Error* ClientInstance::Compile(PJRT_Program* program,
           std::string_view(static_cast<const char*>(output->GetData()),
                            output->GetDataSize()));
     }
+    if (platform().compile_cache().enabled()) {
+      platform().compile_cache().Store(
+          cache_key,
+          std::string_view(static_cast<const char*>(output->GetData()),
+                           output->GetDataSize()));
+    }
 
+    auto* image = new ExecutableImage(
+        std::move(output), std::string(program->code, program->code_size));
+    image->num_partitions = num_partitions;
     auto executable = std::make_unique<LoadedExecutableInstance>(
-        *this,
-        new ExecutableImage(std::move(output),
-                            std::string(program->code, program->code_size)),
-        addressable_devices_);
+        *this, image, addressable_devices_);
     status = executable->LoadAll();
     if (!iree_status_is_ok(status)) {
       return MakeError(status);
@@ -1416,6 +1540,130 @@ std::tuple<uint64_t, uint64_t> ClientInstance::AdvanceTimeline() {
   return std::make_tuple(current, next);
 }
 
+namespace {
+
+// Places a device in the default collective group spanning all addressable
+// devices of a client. Default channel IDs are exchanged in-process through
+// the client.
+struct LocalChannelProvider {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  ClientInstance* client;
+  int32_t rank;
+  int32_t count;
+  // Number of default channel IDs exchanged so far by this device.
+  size_t exchange_count;
+};
+
+void LocalChannelProviderDestroy(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  auto* channel_provider =
+      reinterpret_cast<LocalChannelProvider*>(base_channel_provider);
+  iree_allocator_free(channel_provider->host_allocator, channel_provider);
+}
+
+iree_status_t LocalChannelProviderQueryDefaultRankAndCount(
+    iree_hal_channel_provider_t* base_channel_provider, int32_t* out_rank,
+    int32_t* out_count) {
+  auto* channel_provider =
+      reinterpret_cast<LocalChannelProvider*>(base_channel_provider);
+  *out_rank = channel_provider->rank;
+  *out_count = channel_provider->count;
+  return iree_ok_status();
+}
+
+iree_status_t LocalChannelProviderExchangeDefaultId(
+    iree_hal_channel_provider_t* base_channel_provider, iree_byte_span_t id) {
+  auto* channel_provider =
+      reinterpret_cast<LocalChannelProvider*>(base_channel_provider);
+  return channel_provider->client->ExchangeDefaultChannelId(
+      channel_provider->rank, channel_provider->exchange_count++, id);
+}
+
+const iree_hal_channel_provider_vtable_t kLocalChannelProviderVtable = {
+    /*.destroy=*/LocalChannelProviderDestroy,
+    /*.query_default_rank_and_count=*/
+    LocalChannelProviderQueryDefaultRankAndCount,
+    /*.exchange_default_id=*/LocalChannelProviderExchangeDefaultId,
+};
+
+// Runs |fn| for each of |count| devices and returns the first failure.
+// Collective operations block until all participants have arrived and so
+// when there is more than one device each runs on its own thread.
+iree_status_t ForEachDevice(size_t count,
+                            const std::function<iree_status_t(size_t)>& fn) {
+  if (count == 1) return fn(0);
+  std::vector<iree_status_t> statuses(count, iree_ok_status());
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    threads.emplace_back([&, i]() { statuses[i] = fn(i); });
+  }
+  iree_status_t status = iree_ok_status();
+  for (size_t i = 0; i < count; ++i) {
+    threads[i].join();
+    if (iree_status_is_ok(status)) {
+      status = statuses[i];
+    } else {
+      iree_status_ignore(statuses[i]);
+    }
+  }
+  return status;
+}
+
+}  // namespace
+
+iree_status_t ClientInstance::CreateChannelProvider(
+    DeviceInstance* device,
+    iree_hal_channel_provider_t** out_channel_provider) {
+  *out_channel_provider = nullptr;
+  if (addressable_devices_.size() <= 1) return iree_ok_status();
+  auto it = std::find(addressable_devices_.begin(),
+                      addressable_devices_.end(), device);
+  if (it == addressable_devices_.end()) return iree_ok_status();
+
+  LocalChannelProvider* channel_provider = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator_,
+                                             sizeof(*channel_provider),
+                                             (void**)&channel_provider));
+  iree_hal_resource_initialize(&kLocalChannelProviderVtable,
+                               &channel_provider->resource);
+  channel_provider->host_allocator = host_allocator_;
+  channel_provider->client = this;
+  channel_provider->rank = (int32_t)(it - addressable_devices_.begin());
+  channel_provider->count = (int32_t)addressable_devices_.size();
+  channel_provider->exchange_count = 0;
+  *out_channel_provider =
+      reinterpret_cast<iree_hal_channel_provider_t*>(channel_provider);
+  return iree_ok_status();
+}
+
+iree_status_t ClientInstance::ExchangeDefaultChannelId(int32_t rank,
+                                                       size_t generation,
+                                                       iree_byte_span_t id) {
+  std::unique_lock<std::mutex> guard(channel_id_lock_);
+  if (rank == 0) {
+    if (channel_ids_.size() <= generation) {
+      channel_ids_.resize(generation + 1);
+    }
+    channel_ids_[generation].assign(id.data, id.data + id.data_length);
+    channel_id_cond_.notify_all();
+    return iree_ok_status();
+  }
+  channel_id_cond_.wait(guard, [&]() {
+    return channel_ids_.size() > generation &&
+           !channel_ids_[generation].empty();
+  });
+  const auto& root_id = channel_ids_[generation];
+  if (root_id.size() != id.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "default channel ID size mismatch (%zu vs %zu)",
+                            root_id.size(), (size_t)id.data_length);
+  }
+  memcpy(id.data, root_id.data(), id.data_length);
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // EventInstance
 //===----------------------------------------------------------------------===//
@@ -1593,8 +1841,8 @@ void ExecutableImage::BindApi(PJRT_Api* api) {
   };
   api->PJRT_Executable_NumPartitions =
       +[](PJRT_Executable_NumPartitions_Args* args) -> PJRT_Error* {
-    // This should be updated once iree supports partitioning.
-    args->num_partitions = 1;
+    args->num_partitions =
+        ExecutableImage::Unwrap(args->executable)->num_partitions;
     return nullptr;
   };
   api->PJRT_Executable_NumReplicas =
@@ -1720,50 +1968,56 @@ iree_status_t LoadedExecutableInstance::LoadAll() {
   IREE_TRACE_SCOPE();
   if (!resident_executables_.empty()) return iree_ok_status();
 
-  std::vector<ResidentExecutable> new_list;
-  for (DeviceInstance* device_instance : addressable_devices_) {
-    iree_hal_device_t* hal_device;
-    IREE_RETURN_IF_ERROR(device_instance->GetHalDevice(&hal_device));
-    new_list.push_back({});
-    ResidentExecutable& loaded = new_list.back();
-    loaded.device_instance = device_instance;
-
-    // Only de-reference through the image_ shared_ptr once to get the
-    // binary CompilerOutput (mmap).
-    auto* binary = image_->binary.get();
-    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
-        client_.vm_instance(),
-        iree_make_const_byte_span(binary->GetData(), binary->GetDataSize()),
-        /*archive_allocator=*/iree_allocator_null(), client_.host_allocator(),
-        &loaded.main_module));
-
-    // Lookup main function.
-    const char kNameMain[] = "main";
-    IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
-        loaded.main_module.get(), IREE_VM_FUNCTION_LINKAGE_EXPORT,
-        iree_string_view_t{kNameMain, sizeof(kNameMain) - 1},
-        &loaded.main_function));
-
-    // Record number of args/results.
-    iree_vm_function_signature_t sig =
-        iree_vm_function_signature(&loaded.main_function);
-    IREE_RETURN_IF_ERROR(iree_vm_function_call_count_arguments_and_results(
-        &sig, &loaded.arg_count, &loaded.result_count));
-
-    // Defer to the client to populate the stack of modules.
-    std::vector<iree::vm::ref<iree_vm_module_t>> modules;
-    IREE_RETURN_IF_ERROR(
-        client_.PopulateVMModules(modules, hal_device, loaded.main_module));
-    std::vector<iree_vm_module_t*> module_ptrs;
-    module_ptrs.resize(modules.size());
-    for (size_t i = 0; i < modules.size(); ++i) {
-      module_ptrs[i] = modules[i].get();
-    }
-
-    IREE_CHECK_OK(iree_vm_context_create_with_modules(
-        client_.vm_instance(), IREE_VM_CONTEXT_FLAG_NONE, module_ptrs.size(),
-        module_ptrs.data(), iree_allocator_system(), &loaded.vm_context));
-  }
+  // Devices are loaded concurrently as initializing the default collective
+  // channel of a partitioned program blocks until all devices have joined.
+  std::vector<ResidentExecutable> new_list(addressable_devices_.size());
+  IREE_RETURN_IF_ERROR(ForEachDevice(
+      addressable_devices_.size(), [&](size_t dev_index) -> iree_status_t {
+        DeviceInstance* device_instance = addressable_devices_[dev_index];
+        iree_hal_device_t* hal_device;
+        IREE_RETURN_IF_ERROR(device_instance->GetHalDevice(&hal_device));
+        ResidentExecutable& loaded = new_list[dev_index];
+        loaded.device_instance = device_instance;
+
+        // Only de-reference through the image_ shared_ptr once to get the
+        // binary CompilerOutput (mmap).
+        auto* binary = image_->binary.get();
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
+            client_.vm_instance(),
+            iree_make_const_byte_span(binary->GetData(),
+                                      binary->GetDataSize()),
+            /*archive_allocator=*/iree_allocator_null(),
+            client_.host_allocator(), &loaded.main_module));
+
+        // Lookup main function.
+        const char kNameMain[] = "main";
+        IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
+            loaded.main_module.get(), IREE_VM_FUNCTION_LINKAGE_EXPORT,
+            iree_string_view_t{kNameMain, sizeof(kNameMain) - 1},
+            &loaded.main_function));
+
+        // Record number of args/results.
+        iree_vm_function_signature_t sig =
+            iree_vm_function_signature(&loaded.main_function);
+        IREE_RETURN_IF_ERROR(
+            iree_vm_function_call_count_arguments_and_results(
+                &sig, &loaded.arg_count, &loaded.result_count));
+
+        // Defer to the client to populate the stack of modules.
+        std::vector<iree::vm::ref<iree_vm_module_t>> modules;
+        IREE_RETURN_IF_ERROR(client_.PopulateVMModules(modules, hal_device,
+                                                       loaded.main_module));
+        std::vector<iree_vm_module_t*> module_ptrs;
+        module_ptrs.resize(modules.size());
+        for (size_t i = 0; i < modules.size(); ++i) {
+          module_ptrs[i] = modules[i].get();
+        }
+
+        return iree_vm_context_create_with_modules(
+            client_.vm_instance(), IREE_VM_CONTEXT_FLAG_NONE,
+            module_ptrs.size(), module_ptrs.data(), iree_allocator_system(),
+            &loaded.vm_context);
+      }));
 
   new_list.swap(resident_executables_);
   return iree_ok_status();
@@ -1856,6 +2110,10 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
     // Populate inputs.
     for (size_t i = 0; i < args->num_args; ++i) {
       auto* buffer = BufferInstance::Unwrap(args->argument_lists[dev_index][i]);
+      if (buffer->is_deleted()) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "argument %d was deleted or donated", (int)i);
+      }
       iree_vm_ref_t bv_ref =
           iree_hal_buffer_view_retain_ref(buffer->buffer_view());
       IREE_RETURN_IF_ERROR(
@@ -1878,39 +2136,42 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
 
   // Issue invocations.
   // TODO: Switch to using the async API. I've tried to structure this
-  // so that we can move to that. Obviously important before we have more
-  // than one device.
-  iree_status_t status = iree_ok_status();
-  for (size_t dev_index = 0; dev_index < args->num_devices; ++dev_index) {
-    auto& inv = invs[dev_index];
-    if (IreeApi::LOGGING_ENABLED) {
-      IreeApi::LogInvoke(
-          "vm_invoke[async]",
-          "context=%p, f=%d, wait_fence=%p {%s}, signal_fence=%p {%s}",
-          inv.res_exe->vm_context.get(),
-          (int)inv.res_exe->main_function.ordinal, inv.wait_fence.get(),
-          IreeApi::FenceToString(inv.wait_fence.get()).c_str(),
-          inv.signal_fence.get(),
-          IreeApi::FenceToString(inv.signal_fence.get()).c_str());
-    }
-    auto new_status = IreeApi::HandleStatus(
-        "vm_invoke[async]",
-        iree_vm_invoke(inv.res_exe->vm_context.get(),
-                       inv.res_exe->main_function, IREE_VM_INVOCATION_FLAG_NONE,
-                       /*policy=*/nullptr, inv.inputs.get(), inv.outputs.get(),
-                       allocator));
-    // Any invocation that fails needs a barrier so that signal fence is
-    // incremented otherwise future waits will fail. We do this instead of
-    // incrementing as only a subset of devices may fail.
-    if (!iree_status_is_ok(new_status)) {
-      status = new_status;
-      // We can ignore the error as we are already erroring out earlier.
-      IREE_IGNORE_ERROR(IreeApi::hal_device_queue_barrier(
-          inv.res_exe->device_instance->device(), IREE_HAL_QUEUE_AFFINITY_ANY,
-          iree_hal_fence_semaphore_list(inv.wait_fence.get()),
-          iree_hal_fence_semaphore_list(inv.signal_fence.get())));
-    }
-  }
+  // so that we can move to that. Each device invokes on its own thread as
+  // the shards of a partitioned program may block on collectives until all
+  // devices have issued them.
+  iree_status_t status = ForEachDevice(
+      args->num_devices, [&](size_t dev_index) -> iree_status_t {
+        auto& inv = invs[dev_index];
+        if (IreeApi::LOGGING_ENABLED) {
+          IreeApi::LogInvoke(
+              "vm_invoke[async]",
+              "context=%p, f=%d, wait_fence=%p {%s}, signal_fence=%p {%s}",
+              inv.res_exe->vm_context.get(),
+              (int)inv.res_exe->main_function.ordinal, inv.wait_fence.get(),
+              IreeApi::FenceToString(inv.wait_fence.get()).c_str(),
+              inv.signal_fence.get(),
+              IreeApi::FenceToString(inv.signal_fence.get()).c_str());
+        }
+        auto new_status = IreeApi::HandleStatus(
+            "vm_invoke[async]",
+            iree_vm_invoke(inv.res_exe->vm_context.get(),
+                           inv.res_exe->main_function,
+                           IREE_VM_INVOCATION_FLAG_NONE,
+                           /*policy=*/nullptr, inv.inputs.get(),
+                           inv.outputs.get(), allocator));
+        // Any invocation that fails needs a barrier so that signal fence is
+        // incremented otherwise future waits will fail. We do this instead of
+        // incrementing as only a subset of devices may fail.
+        if (!iree_status_is_ok(new_status)) {
+          // We can ignore the error as we are already erroring out earlier.
+          IREE_IGNORE_ERROR(IreeApi::hal_device_queue_barrier(
+              inv.res_exe->device_instance->device(),
+              IREE_HAL_QUEUE_AFFINITY_ANY,
+              iree_hal_fence_semaphore_list(inv.wait_fence.get()),
+              iree_hal_fence_semaphore_list(inv.signal_fence.get())));
+        }
+        return new_status;
+      });
 
   // Process results.
   // Early exit before committing things to the client if anything failed.
@@ -1923,6 +2184,21 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
               inv.outputs.get(), i, iree_hal_buffer_view_type()));
       // This should not be possible so just hard-assert.
       IREE_ASSERT_ARGUMENT(ret_buffer_view);
+      // Results tied to donated arguments (`tf.aliasing_output`, lowered to
+      // `iree.abi.output`) are computed in place in the storage of the
+      // argument. The result now owns that storage and the argument is
+      // consumed so that the storage is not deallocated out from under it.
+      iree_hal_buffer_t* ret_buffer =
+          iree_hal_buffer_view_buffer(ret_buffer_view.get());
+      for (size_t j = 0; j < args->num_args; ++j) {
+        auto* arg_buffer =
+            BufferInstance::Unwrap(args->argument_lists[dev_index][j]);
+        if (!arg_buffer->is_deleted() &&
+            iree_hal_buffer_view_buffer(arg_buffer->buffer_view()) ==
+                ret_buffer) {
+          arg_buffer->Donate();
+        }
+      }
       auto result_buffer = std::make_unique<BufferInstance>(
           *inv.res_exe->device_instance, std::move(ret_buffer_view));
       IREE_RETURN_IF_ERROR(result_buffer->AdvanceReadyFence(
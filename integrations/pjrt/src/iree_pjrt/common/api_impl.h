@@ -8,6 +8,7 @@
 #define IREE_PJRT_PLUGIN_PJRT_COMMON_API_IMPL_H_
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -85,6 +86,10 @@ class BufferInstance {
   DeviceInstance& device() { return device_; }
   iree_status_t AsyncDeallocate();
   iree_status_t Delete();
+  // Marks the buffer as donated to an execution that produced a result
+  // aliasing its storage. The result takes over ownership of the storage so
+  // the buffer is deleted without deallocating it.
+  void Donate();
   bool is_deleted() { return is_deleted_; }
   bool is_on_cpu() {
     // TODO: Plumb through an indication if running on CPU and then implement
@@ -345,6 +350,10 @@ struct ExecutableImage {
   // Original code fed to the compiler. Stored for debugging.
   const std::string code;
 
+  // Number of SPMD partitions the program was compiled for. Each partition
+  // runs on one addressable device.
+  int num_partitions = 1;
+
   // Meta-data about the executable is lazily set when an Executable is obtained
   // from a LoadedExecutable.
   iree_host_size_t arg_count;
@@ -469,6 +478,19 @@ class ClientInstance {
   // Advances the timeline, returning (current, next) time point values.
   std::tuple<uint64_t, uint64_t> AdvanceTimeline();
 
+  // Creates a channel provider for |device| that places it at its index in
+  // the default collective group spanning all addressable devices. Sets
+  // |out_channel_provider| to nullptr if there is only one device.
+  iree_status_t CreateChannelProvider(
+      DeviceInstance* device,
+      iree_hal_channel_provider_t** out_channel_provider);
+
+  // Exchanges the |generation|-th default collective channel ID between the
+  // addressable devices. The device at |rank| 0 provides the ID in |id| and
+  // all other devices block until it is available.
+  iree_status_t ExchangeDefaultChannelId(int32_t rank, size_t generation,
+                                         iree_byte_span_t id);
+
  protected:
   iree_allocator_t host_allocator_;
   iree_hal_driver_registry_t* driver_registry_ = nullptr;
@@ -501,6 +523,12 @@ class ClientInstance {
   // Waiting on the current value of |execution_timeline_| will drain all
   // scheduled work to date.
   uint64_t execution_timeline_ = 0ull;
+
+  // Default collective channel IDs published by the root device, indexed by
+  // the order in which the channels were created.
+  std::mutex channel_id_lock_;
+  std::condition_variable channel_id_cond_;
+  std::vector<std::vector<uint8_t>> channel_ids_;
 };
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,174 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree_pjrt/common/compile_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <thread>
+
+namespace iree::pjrt {
+
+namespace {
+
+// Alignment of cached executables in memory. Module archives embed data
+// that is accessed in place and expects the archive to be at least this
+// aligned (as it would be when memory mapped).
+constexpr std::size_t kExecutableAlignment = 64;
+
+// A CompilerOutput backed by the contents of a cached file.
+class CachedCompilerOutput : public CompilerOutput {
+ public:
+  explicit CachedCompilerOutput(size_t size)
+      : data_(new(std::align_val_t(kExecutableAlignment)) char[size]),
+        size_(size) {}
+  ~CachedCompilerOutput() override {
+    ::operator delete[](data_, std::align_val_t(kExecutableAlignment));
+  }
+  void* GetData() override { return data_; }
+  size_t GetDataSize() override { return size_; }
+
+ private:
+  char* data_;
+  size_t size_;
+};
+
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// CompileCache
+//===----------------------------------------------------------------------===//
+
+CompileCache::KeyBuilder& CompileCache::KeyBuilder::Append(
+    std::string_view component) {
+  // Length prefix each component so that adjacent components cannot alias.
+  uint64_t size = component.size();
+  for (uint64_t& hash : hashes_) {
+    hash = HashBytes(hash, &size, sizeof(size));
+    hash = HashBytes(hash, component.data(), component.size());
+  }
+  return *this;
+}
+
+std::string CompileCache::KeyBuilder::Finish() const {
+  char buffer[33];
+  std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+                static_cast<unsigned long long>(hashes_[0]),
+                static_cast<unsigned long long>(hashes_[1]));
+  return std::string(buffer);
+}
+
+CompileCache::~CompileCache() = default;
+
+std::unique_ptr<CompilerOutput> CompileCache::Lookup(const std::string& key) {
+  return nullptr;
+}
+
+void CompileCache::Store(const std::string& key, std::string_view contents) {}
+
+std::string CompileCache::DebugString() { return std::string("disabled"); }
+
+//===----------------------------------------------------------------------===//
+// FilesCompileCache
+//===----------------------------------------------------------------------===//
+
+FilesCompileCache::FilesCompileCache(Logger& logger,
+                                     std::filesystem::path directory)
+    : logger_(logger), directory_(std::move(directory)) {
+  enabled_ = true;
+}
+
+FilesCompileCache::~FilesCompileCache() = default;
+
+std::unique_ptr<CompilerOutput> FilesCompileCache::Lookup(
+    const std::string& key) {
+  auto file_path = directory_ / (key + ".vmfb");
+  std::error_code ec;
+  auto file_size = std::filesystem::file_size(file_path, ec);
+  if (ec) return nullptr;
+
+  std::ifstream fin(file_path, std::ios::in | std::ios::binary);
+  if (!fin.good()) return nullptr;
+  auto output = std::make_unique<CachedCompilerOutput>(file_size);
+  fin.read(static_cast<char*>(output->GetData()), file_size);
+  if (!fin.good()) {
+    std::string message("Error reading cached executable: ");
+    message.append(file_path.string());
+    logger_.error(message);
+    return nullptr;
+  }
+
+  std::string message("Loaded cached executable: ");
+  message.append(file_path.string());
+  logger_.debug(message);
+  return output;
+}
+
+void FilesCompileCache::Store(const std::string& key,
+                              std::string_view contents) {
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  if (ec) {
+    std::string message("Error creating compile cache directory: ");
+    message.append(directory_.string());
+    logger_.error(message);
+    return;
+  }
+
+  // Multiple processes may be populating the same cache concurrently. Write
+  // to a unique temporary file and atomically rename it into place so that
+  // readers never observe a partially written executable.
+  auto file_path = directory_ / (key + ".vmfb");
+  std::string temp_name = key;
+  temp_name.append(".");
+  temp_name.append(std::to_string(
+      std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+      std::chrono::steady_clock::now().time_since_epoch().count()));
+  temp_name.append(".tmp");
+  auto temp_path = directory_ / temp_name;
+  {
+    std::ofstream fout(temp_path, std::ios::out | std::ios::trunc |
+                                      std::ios::binary);
+    fout.write(contents.data(), contents.size());
+    fout.close();
+    if (!fout.good()) {
+      std::string message("Error writing cached executable: ");
+      message.append(temp_path.string());
+      logger_.error(message);
+      std::filesystem::remove(temp_path, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(temp_path, file_path, ec);
+  if (ec) {
+    std::string message("Error renaming cached executable: ");
+    message.append(file_path.string());
+    logger_.error(message);
+    std::filesystem::remove(temp_path, ec);
+  }
+}
+
+std::string FilesCompileCache::DebugString() {
+  std::string message("caching executables in ");
+  message.append(directory_.string());
+  return message;
+}
+
+}  // namespace iree::pjrt
@@ -0,0 +1,85 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_PJRT_PLUGIN_PJRT_COMPILE_CACHE_H_
+#define IREE_PJRT_PLUGIN_PJRT_COMPILE_CACHE_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "iree_pjrt/common/compiler.h"
+#include "iree_pjrt/common/debugging.h"
+
+namespace iree::pjrt {
+
+//===----------------------------------------------------------------------===//
+// CompileCache
+// Persists compiled executables across processes so that programs which have
+// been compiled before can be loaded without invoking the compiler.
+//
+// Entries are keyed by everything that influences the compiled output: the
+// program source, the compiler flags (which include the target) and the
+// revisions of the compiler and partitioner. Like the ArtifactDumper, the
+// cache swallows errors, reporting them to the Logger and treating them as
+// misses.
+//
+// The default implementation can be instantiated and is hard-coded to
+// !enabled().
+//===----------------------------------------------------------------------===//
+
+class CompileCache {
+ public:
+  // Accumulates the components of a cache key.
+  class KeyBuilder {
+   public:
+    KeyBuilder& Append(std::string_view component);
+    // Returns the key as a hex string suitable for use as a file name.
+    std::string Finish() const;
+
+   private:
+    uint64_t hashes_[2] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull};
+  };
+
+  virtual ~CompileCache();
+
+  // Not virtual for quick checks in disabled state.
+  bool enabled() { return enabled_; }
+
+  // Looks up the compiled executable for |key|. Returns nullptr on a miss.
+  virtual std::unique_ptr<CompilerOutput> Lookup(const std::string& key);
+
+  // Stores the compiled executable |contents| for |key|.
+  virtual void Store(const std::string& key, std::string_view contents);
+
+  // Returns a string suitable for emitting to the debug log, describing
+  // where executables are cached.
+  virtual std::string DebugString();
+
+ protected:
+  bool enabled_ = false;
+};
+
+// Caches executables as files in a directory on the file system.
+class FilesCompileCache : public CompileCache {
+ public:
+  FilesCompileCache(Logger& logger, std::filesystem::path directory);
+  ~FilesCompileCache() override;
+
+  std::unique_ptr<CompilerOutput> Lookup(const std::string& key) override;
+  void Store(const std::string& key, std::string_view contents) override;
+  std::string DebugString() override;
+
+ private:
+  Logger& logger_;
+  std::filesystem::path directory_;
+};
+
+}  // namespace iree::pjrt
+
+#endif  // IREE_PJRT_PLUGIN_PJRT_COMPILE_CACHE_H_
@@ -0,0 +1,71 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree_pjrt/common/compile_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+
+namespace iree::pjrt {
+namespace {
+
+std::string MakeKey(std::initializer_list<std::string_view> components) {
+  CompileCache::KeyBuilder key_builder;
+  for (auto component : components) key_builder.Append(component);
+  return key_builder.Finish();
+}
+
+TEST(CompileCacheTest, KeyIsStable) {
+  EXPECT_EQ(MakeKey({"rev", "--flag", "program"}),
+            MakeKey({"rev", "--flag", "program"}));
+  EXPECT_EQ(MakeKey({"rev"}).size(), 32);
+}
+
+TEST(CompileCacheTest, KeyDependsOnAllComponents) {
+  std::string key = MakeKey({"rev", "--flag", "program"});
+  EXPECT_NE(key, MakeKey({"rev2", "--flag", "program"}));
+  EXPECT_NE(key, MakeKey({"rev", "--flag2", "program"}));
+  EXPECT_NE(key, MakeKey({"rev", "--flag", "program2"}));
+  // Component boundaries are part of the key.
+  EXPECT_NE(MakeKey({"ab", "c"}), MakeKey({"a", "bc"}));
+}
+
+TEST(CompileCacheTest, DisabledCacheMisses) {
+  CompileCache cache;
+  EXPECT_FALSE(cache.enabled());
+  cache.Store("key", "contents");
+  EXPECT_EQ(cache.Lookup("key"), nullptr);
+}
+
+TEST(CompileCacheTest, FilesRoundTrip) {
+  Logger logger;
+  auto directory = std::filesystem::temp_directory_path() /
+                   ("iree_pjrt_compile_cache_test_" +
+                    std::to_string(reinterpret_cast<uintptr_t>(&logger)));
+  FilesCompileCache cache(logger, directory);
+  EXPECT_TRUE(cache.enabled());
+
+  std::string key = MakeKey({"program"});
+  EXPECT_EQ(cache.Lookup(key), nullptr);
+
+  std::string contents("compiled executable");
+  cache.Store(key, contents);
+  auto output = cache.Lookup(key);
+  ASSERT_NE(output, nullptr);
+  EXPECT_EQ(std::string_view(static_cast<const char*>(output->GetData()),
+                             output->GetDataSize()),
+            contents);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(output->GetData()) % 64, 0);
+  EXPECT_EQ(cache.Lookup(MakeKey({"other program"})), nullptr);
+
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
+}  // namespace iree::pjrt
@@ -144,6 +144,16 @@ iree_status_t DylibPlatform::SubclassInitialize() {
   artifact_dumper_ = std::make_unique<FilesArtifactDumper>(
       logger(), artifact_path_callback, /*retain_all=*/true);
 
+  // Initialize the compile cache.
+  auto compile_cache_dir = config_vars().Lookup("COMPILE_CACHE_DIR");
+  if (compile_cache_dir && !compile_cache_dir->empty()) {
+    compile_cache_ =
+        std::make_unique<FilesCompileCache>(logger(), *compile_cache_dir);
+    std::string message("Compile cache: ");
+    message.append(compile_cache_->DebugString());
+    logger().debug(message);
+  }
+
   return iree_ok_status();
 }
 
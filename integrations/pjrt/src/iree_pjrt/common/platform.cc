@@ -50,6 +50,9 @@ Platform::~Platform() = default;
 
 iree_status_t Platform::Initialize() {
   IREE_RETURN_IF_ERROR(SubclassInitialize());
+  if (!compile_cache_) {
+    compile_cache_ = std::make_unique<CompileCache>();
+  }
 
   if (!logger_ || !compiler_ || !artifact_dumper_) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
@@ -14,6 +14,7 @@
 #include <unordered_map>
 
 #include "iree/base/api.h"
+#include "iree_pjrt/common/compile_cache.h"
 #include "iree_pjrt/common/compiler.h"
 #include "iree_pjrt/common/debugging.h"
 
@@ -59,6 +60,7 @@ class Platform {
   // The partitioner is optional.
   AbstractCompiler* partitioner() { return partitioner_.get(); }
   ArtifactDumper& artifact_dumper() { return *artifact_dumper_; }
+  CompileCache& compile_cache() { return *compile_cache_; }
 
  protected:
   virtual iree_status_t SubclassInitialize() = 0;
@@ -67,6 +69,8 @@ class Platform {
   std::unique_ptr<AbstractCompiler> compiler_;
   std::unique_ptr<AbstractCompiler> partitioner_;
   std::unique_ptr<ArtifactDumper> artifact_dumper_;
+  // Optional. Defaults to a disabled cache if not set by the subclass.
+  std::unique_ptr<CompileCache> compile_cache_;
 };
 
 }  // namespace iree::pjrt
@@ -23,11 +23,9 @@ iree_status_t CUDAClientInstance::CreateDriver(iree_hal_driver_t** out_driver) {
   iree_string_view_t driver_name = iree_make_cstring_view("cuda");
 
   // Device params.
-  // TODO: Plumb through some important params:
-  //   nccl_default_id
-  //   nccl_default_rank
-  //   nccl_default_count
-  // Switch command_buffer_mode to graphs when ready.
+  // NCCL channels default to spanning all addressable devices of the client
+  // (see ClientInstance::CreateChannelProvider).
+  // TODO: Switch command_buffer_mode to graphs when ready.
   iree_hal_cuda_device_params_t default_params;
   iree_hal_cuda_device_params_initialize(&default_params);
   default_params.command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
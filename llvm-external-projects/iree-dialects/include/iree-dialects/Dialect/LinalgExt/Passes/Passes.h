@@ -171,6 +171,12 @@ std::unique_ptr<Pass> createConvertConv2DToWinogradPass();
 // linalg generic ops.
 std::unique_ptr<Pass> createDecomposeSoftmaxPass();
 
+// Same as above, but only decomposes the softmax ops for which `filter`
+// returns true. This lets backends keep some softmax ops intact, e.g. to lower
+// them to a microkernel later.
+std::unique_ptr<Pass>
+createDecomposeSoftmaxPass(std::function<bool(Operation *)> filter);
+
 // Transform dialect version of tile and decompose attention wrapper.
 SmallVector<Operation *>
 tileAndDecomposeAttention(IREE::LinalgExt::AttentionOp attnOp,
@@ -116,12 +116,17 @@ static Value computeSoftmax(Value numerator, Value denominator, Value output,
 /// 4. Divide z and l. This gives the N-dimensional softmax.
 ///    softmax = z / l
 ///
-LogicalResult convertSoftmaxToGenerics(func::FuncOp funcOp) {
+/// Only the ops for which `filter` returns true are decomposed, or all of them
+/// if `filter` is null.
+LogicalResult
+convertSoftmaxToGenerics(func::FuncOp funcOp,
+                         const std::function<bool(Operation *)> &filter) {
   IRRewriter rewriter(funcOp.getContext());
   SmallVector<Operation *> toDelete;
   SmallVector<Operation *> softmaxOpsToDecompose;
   funcOp.walk([&](linalg::SoftmaxOp softmaxOp) {
-    softmaxOpsToDecompose.push_back(softmaxOp);
+    if (!filter || filter(softmaxOp))
+      softmaxOpsToDecompose.push_back(softmaxOp);
   });
 
   OpBuilder::InsertionGuard guard(rewriter);
@@ -176,6 +181,10 @@ LogicalResult convertSoftmaxToGenerics(func::FuncOp funcOp) {
 }
 
 struct DecomposeSoftmaxPass : DecomposeSoftmaxBase<DecomposeSoftmaxPass> {
+  DecomposeSoftmaxPass() = default;
+  DecomposeSoftmaxPass(std::function<bool(Operation *)> filter)
+      : filter(std::move(filter)) {}
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry
         .insert<linalg::LinalgDialect, IREE::LinalgExt::IREELinalgExtDialect>();
@@ -183,9 +192,12 @@ struct DecomposeSoftmaxPass : DecomposeSoftmaxBase<DecomposeSoftmaxPass> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     IRRewriter rewriter(context);
-    if (failed(convertSoftmaxToGenerics(getOperation())))
+    if (failed(convertSoftmaxToGenerics(getOperation(), filter)))
       return signalPassFailure();
   }
+
+private:
+  std::function<bool(Operation *)> filter;
 };
 
 } // namespace
@@ -194,6 +206,11 @@ std::unique_ptr<Pass> createDecomposeSoftmaxPass() {
   return std::make_unique<DecomposeSoftmaxPass>();
 }
 
+std::unique_ptr<Pass>
+createDecomposeSoftmaxPass(std::function<bool(Operation *)> filter) {
+  return std::make_unique<DecomposeSoftmaxPass>(std::move(filter));
+}
+
 } // namespace LinalgExt
 } // namespace IREE
 } // namespace iree_compiler
@@ -315,6 +315,52 @@ lowerOpWithEncoding(RewriterBase &rewriter, linalg::FillOp fillOp,
   return materializedFillOp;
 }
 
+/// Utility method to convert an elementwise `linalg.generic` whose operands
+/// all have the same encoding to an elementwise `linalg.generic` on the
+/// materialized types. Since all operands are packed the same way the
+/// computation is independent of the layout.
+static FailureOr<Operation *>
+lowerOpWithEncoding(RewriterBase &rewriter, linalg::GenericOp genericOp,
+                    ValueRange convertedInputOperands,
+                    ValueRange convertedOutputOperands, MaterializeEncodingFn,
+                    MaterializeEncodingValueFn) {
+  if (!genericOp.hasTensorSemantics() || !linalg::isElementwise(genericOp) ||
+      genericOp.hasIndexSemantics()) {
+    return failure();
+  }
+  auto encodingOf = [](OpOperand &operand) {
+    auto type = operand.get().getType().dyn_cast<RankedTensorType>();
+    return type ? getEncodingAttr(type) : EncodingAttr();
+  };
+  EncodingAttr encoding = encodingOf(genericOp->getOpOperand(0));
+  if (!encoding ||
+      llvm::any_of(genericOp->getOpOperands(), [&](OpOperand &operand) {
+        EncodingAttr operandEncoding = encodingOf(operand);
+        return !operandEncoding ||
+               operandEncoding.getUser() != encoding.getUser() ||
+               operandEncoding.getRole() != encoding.getRole() ||
+               !genericOp.getMatchingIndexingMap(&operand).isIdentity();
+      })) {
+    return failure();
+  }
+
+  auto packedType =
+      convertedOutputOperands.front().getType().cast<RankedTensorType>();
+  SmallVector<AffineMap> indexingMaps(
+      genericOp->getNumOperands(),
+      rewriter.getMultiDimIdentityMap(packedType.getRank()));
+  SmallVector<utils::IteratorType> iteratorTypes(packedType.getRank(),
+                                                 utils::IteratorType::parallel);
+  auto materializedGenericOp = rewriter.create<linalg::GenericOp>(
+      genericOp.getLoc(), convertedOutputOperands.getTypes(),
+      convertedInputOperands, convertedOutputOperands, indexingMaps,
+      iteratorTypes);
+  rewriter.cloneRegionBefore(genericOp.getRegion(),
+                             materializedGenericOp.getRegion(),
+                             materializedGenericOp.getRegion().begin());
+  return materializedGenericOp.getOperation();
+}
+
 /// Utility method to convert `tensor.empty` with encoding to a `tensor.empty`
 /// of the materialized type.
 static FailureOr<Operation *>
@@ -556,6 +602,7 @@ void populateMaterializeEncodingPatterns(
   // Add all patterns for converting from encoded type to the materialized
   // type
   patterns.insert<MaterializeDPSOperation<linalg::FillOp>,
+                  MaterializeDPSOperation<linalg::GenericOp>,
                   MaterializeDPSOperation<linalg::MatmulOp>,
                   MaterializeDPSOperation<linalg::BatchMatmulOp>,
                   MaterializeOperation<tensor::EmptyOp>,
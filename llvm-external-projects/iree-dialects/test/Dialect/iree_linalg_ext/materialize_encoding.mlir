@@ -338,3 +338,53 @@ func.func @pack_batch_matmul_fill_dynamic(%arg0 : tensor<?x?x?xf32>, %arg1 : ten
 // CHECK-SAME:       outs(%[[FILL]] :
 //      CHECK:   %[[UNPACK:.+]] = tensor.unpack %[[BATCH_MMT4D]]
 //      CHECK:   return %[[UNPACK]]
+
+// -----
+
+func.func @pack_gemm_elementwise(%arg0 : tensor<128x256xf32>, %arg1 : tensor<256x512xf32>, %arg2 : tensor<128x512xf32>, %arg3 : tensor<128x512xf32>) -> tensor<128x512xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = iree_linalg_ext.set_encoding %arg0 : tensor<128x256xf32> -> tensor<128x256xf32, #iree_linalg_ext.encoding<user = MATMUL, role = LHS, element_types = [f32, f32, f32]>>
+  %1 = iree_linalg_ext.set_encoding %arg1 : tensor<256x512xf32> -> tensor<256x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RHS, element_types = [f32, f32, f32]>>
+  %2 = iree_linalg_ext.set_encoding %arg2 : tensor<128x512xf32> -> tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>
+  %3 = iree_linalg_ext.set_encoding %arg3 : tensor<128x512xf32> -> tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>
+  %4 = linalg.matmul ins(%0, %1 : tensor<128x256xf32, #iree_linalg_ext.encoding<user = MATMUL, role = LHS, element_types = [f32, f32, f32]>>, tensor<256x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RHS, element_types = [f32, f32, f32]>>)
+      outs(%2 : tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>) -> tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>
+  %5 = tensor.empty() : tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>
+  %6 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%4, %3 : tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>, tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>)
+      outs(%5 : tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>) {
+  ^bb0(%b0 : f32, %b1 : f32, %b2 : f32):
+    %7 = arith.addf %b0, %b1 : f32
+    %8 = arith.maximumf %7, %cst : f32
+    linalg.yield %8 : f32
+  } -> tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>>
+  %9 = iree_linalg_ext.unset_encoding %6 : tensor<128x512xf32, #iree_linalg_ext.encoding<user = MATMUL, role = RESULT, element_types = [f32, f32, f32]>> -> tensor<128x512xf32>
+  return %9 : tensor<128x512xf32>
+}
+//  CHECK-DAG: #[[MAP:.+]] = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+//      CHECK: func @pack_gemm_elementwise(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<128x256xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<256x512xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<128x512xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<128x512xf32>
+//      CHECK:   %[[PACK_LHS:.+]] = tensor.pack %[[ARG0]]
+//      CHECK:   %[[PACK_RHS:.+]] = tensor.pack %[[ARG1]]
+//      CHECK:   %[[PACK_RESULT:.+]] = tensor.pack %[[ARG2]]
+// CHECK-SAME:       into %{{.+}} : tensor<128x512xf32> -> tensor<16x64x8x8xf32>
+//      CHECK:   %[[PACK_ADDEND:.+]] = tensor.pack %[[ARG3]]
+// CHECK-SAME:       into %{{.+}} : tensor<128x512xf32> -> tensor<16x64x8x8xf32>
+//      CHECK:   %[[MMT4D:.+]] = linalg.mmt4d
+// CHECK-SAME:       ins(%[[PACK_LHS]], %[[PACK_RHS]] :
+// CHECK-SAME:       outs(%[[PACK_RESULT]] :
+//      CHECK:   %[[EMPTY:.+]] = tensor.empty() : tensor<16x64x8x8xf32>
+//      CHECK:   %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP]], #[[MAP]], #[[MAP]]]
+// CHECK-SAME:       iterator_types = ["parallel", "parallel", "parallel", "parallel"]
+// CHECK-SAME:       ins(%[[MMT4D]], %[[PACK_ADDEND]] :
+// CHECK-SAME:       outs(%[[EMPTY]] :
+//      CHECK:     arith.addf
+//      CHECK:     arith.maximumf
+//      CHECK:   %[[UNPACK:.+]] = tensor.unpack %[[GENERIC]]
+//      CHECK:   return %[[UNPACK]]
@@ -0,0 +1,377 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "./dlpack_interop.h"
+
+#include <cstring>
+#include <vector>
+
+namespace iree::python::dlpack {
+
+namespace {
+
+//------------------------------------------------------------------------------
+// DLPack ABI
+// ABI-compatible subset of dlpack.h (v0.8). The layout of these structures is
+// frozen by the DLPack specification.
+//------------------------------------------------------------------------------
+
+enum DLDeviceType : int32_t {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLCUDAHost = 3,
+  kDLROCM = 10,
+  kDLROCMHost = 11,
+  kDLCUDAManaged = 13,
+};
+
+enum DLDataTypeCode : uint8_t {
+  kDLInt = 0,
+  kDLUInt = 1,
+  kDLFloat = 2,
+  kDLBfloat = 4,
+  kDLComplex = 5,
+  kDLBool = 6,
+};
+
+struct DLDevice {
+  int32_t device_type;
+  int32_t device_id;
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+// Capsule names defined by the Python DLPack protocol. Consumers rename the
+// capsule once they have taken ownership of the tensor.
+static const char kDLTensorCapsuleName[] = "dltensor";
+static const char kUsedDLTensorCapsuleName[] = "used_dltensor";
+
+//------------------------------------------------------------------------------
+// Type conversion
+//------------------------------------------------------------------------------
+
+DLDataType ConvertHalElementTypeToDLDataType(
+    iree_hal_element_type_t element_type) {
+  DLDataType dtype;
+  dtype.bits = static_cast<uint8_t>(iree_hal_element_bit_count(element_type));
+  dtype.lanes = 1;
+  switch (iree_hal_element_numerical_type(element_type)) {
+    case IREE_HAL_NUMERICAL_TYPE_BOOLEAN:
+      dtype.code = kDLBool;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER:
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER_SIGNED:
+      dtype.code = kDLInt;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED:
+      dtype.code = kDLUInt;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_IEEE:
+      dtype.code = kDLFloat;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_BRAIN:
+      dtype.code = kDLBfloat;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_COMPLEX:
+      dtype.code = kDLComplex;
+      break;
+    default:
+      throw py::value_error("Unsupported HAL element type -> DLPack mapping");
+  }
+  return dtype;
+}
+
+iree_hal_element_type_t ConvertDLDataTypeToHalElementType(DLDataType dtype) {
+  if (dtype.lanes != 1) {
+    throw py::value_error("Vectorized DLPack data types are not supported");
+  }
+  switch (dtype.code) {
+    case kDLBool:
+      return iree_hal_make_element_type(IREE_HAL_NUMERICAL_TYPE_BOOLEAN,
+                                        dtype.bits);
+    case kDLInt:
+      return iree_hal_make_element_type(IREE_HAL_NUMERICAL_TYPE_INTEGER_SIGNED,
+                                        dtype.bits);
+    case kDLUInt:
+      return iree_hal_make_element_type(
+          IREE_HAL_NUMERICAL_TYPE_INTEGER_UNSIGNED, dtype.bits);
+    case kDLFloat:
+      return iree_hal_make_element_type(IREE_HAL_NUMERICAL_TYPE_FLOAT_IEEE,
+                                        dtype.bits);
+    case kDLBfloat:
+      return iree_hal_make_element_type(IREE_HAL_NUMERICAL_TYPE_FLOAT_BRAIN,
+                                        dtype.bits);
+    case kDLComplex:
+      return iree_hal_make_element_type(IREE_HAL_NUMERICAL_TYPE_FLOAT_COMPLEX,
+                                        dtype.bits);
+    default:
+      throw py::value_error("Unsupported DLPack -> HAL element type mapping");
+  }
+}
+
+// Returns the DLPack device that device-local allocations of |device| reside
+// on. Only devices whose allocations can be addressed by other frameworks are
+// supported.
+DLDevice QueryDeviceAllocationDevice(HalDevice& device) {
+  iree_string_view_t device_id = iree_hal_device_id(device.raw_ptr());
+  if (iree_string_view_starts_with(device_id, IREE_SV("cuda"))) {
+    int64_t ordinal = 0;
+    CheckApiStatus(
+        iree_hal_device_query_i64(device.raw_ptr(), IREE_SV("cuda.device"),
+                                  IREE_SV("ordinal"), &ordinal),
+        "Querying CUDA device ordinal");
+    return DLDevice{kDLCUDA, static_cast<int32_t>(ordinal)};
+  }
+  throw py::value_error(
+      "DLPack interop with device-local allocations is only supported on "
+      "CUDA devices");
+}
+
+//------------------------------------------------------------------------------
+// Export
+//------------------------------------------------------------------------------
+
+// Storage of an exported buffer as seen by DLPack consumers.
+struct ExportedStorage {
+  void* data;
+  uint64_t byte_offset;
+  DLDevice device;
+};
+
+ExportedStorage ResolveExportedStorage(HalDevice& device,
+                                       iree_hal_buffer_view_t* buffer_view) {
+  iree_hal_buffer_t* buffer = iree_hal_buffer_view_buffer(buffer_view);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  uint64_t byte_offset = iree_hal_buffer_byte_offset(buffer);
+
+  // Prefer exporting host-accessible storage directly as a CPU tensor.
+  iree_hal_external_buffer_t external_buffer;
+  iree_status_t status = iree_hal_allocator_export_buffer(
+      device.allocator(), allocated_buffer,
+      IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE, &external_buffer);
+  if (iree_status_is_ok(status)) {
+    return ExportedStorage{external_buffer.handle.host_allocation.ptr,
+                           byte_offset, DLDevice{kDLCPU, 0}};
+  }
+  iree_status_ignore(status);
+
+  // Otherwise the storage must be a device allocation addressable by others.
+  DLDevice dl_device = QueryDeviceAllocationDevice(device);
+  CheckApiStatus(iree_hal_allocator_export_buffer(
+                     device.allocator(), allocated_buffer,
+                     IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION,
+                     IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE, &external_buffer),
+                 "Buffer storage cannot be exported as a DLPack tensor");
+  return ExportedStorage{
+      reinterpret_cast<void*>(external_buffer.handle.device_allocation.ptr),
+      byte_offset, dl_device};
+}
+
+// Owns an exported tensor and retains the buffer view backing it.
+struct ExportedTensor {
+  DLManagedTensor managed;
+  iree_hal_buffer_view_t* buffer_view;
+  std::vector<int64_t> shape;
+};
+
+void DeleteExportedTensor(DLManagedTensor* managed) {
+  auto* exported = static_cast<ExportedTensor*>(managed->manager_ctx);
+  iree_hal_buffer_view_release(exported->buffer_view);
+  delete exported;
+}
+
+// Destroys a capsule produced by ExportBufferView. The tensor is only
+// deleted here if no consumer took ownership of it.
+void DestroyExportedCapsule(PyObject* capsule) {
+  if (PyCapsule_IsValid(capsule, kUsedDLTensorCapsuleName)) return;
+  PyObject *type, *value, *traceback;
+  PyErr_Fetch(&type, &value, &traceback);
+  auto* managed = static_cast<DLManagedTensor*>(
+      PyCapsule_GetPointer(capsule, kDLTensorCapsuleName));
+  if (managed) {
+    managed->deleter(managed);
+  } else {
+    PyErr_WriteUnraisable(capsule);
+  }
+  PyErr_Restore(type, value, traceback);
+}
+
+//------------------------------------------------------------------------------
+// Import
+//------------------------------------------------------------------------------
+
+// Returns the producer's tensor once the imported buffer is released. This
+// may happen on any thread, with or without the GIL held.
+void ReleaseImportedTensor(void* user_data, iree_hal_buffer_t* buffer) {
+  auto* managed = static_cast<DLManagedTensor*>(user_data);
+  if (!managed->deleter || !Py_IsInitialized()) return;
+  PyGILState_STATE gil_state = PyGILState_Ensure();
+  managed->deleter(managed);
+  PyGILState_Release(gil_state);
+}
+
+}  // namespace
+
+py::object ExportBufferView(HalDevice& device, HalBufferView& buffer_view) {
+  iree_hal_buffer_view_t* raw_buffer_view = buffer_view.raw_ptr();
+  iree_hal_element_type_t element_type =
+      iree_hal_buffer_view_element_type(raw_buffer_view);
+  if (iree_hal_buffer_view_encoding_type(raw_buffer_view) !=
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR) {
+    throw py::value_error("Only dense row-major buffer views can be exported");
+  }
+  DLDataType dtype = ConvertHalElementTypeToDLDataType(element_type);
+  ExportedStorage storage = ResolveExportedStorage(device, raw_buffer_view);
+
+  auto* exported = new ExportedTensor();
+  iree_host_size_t rank = iree_hal_buffer_view_shape_rank(raw_buffer_view);
+  const iree_hal_dim_t* dims = iree_hal_buffer_view_shape_dims(raw_buffer_view);
+  exported->shape.assign(dims, dims + rank);
+  exported->buffer_view = raw_buffer_view;
+  iree_hal_buffer_view_retain(raw_buffer_view);
+
+  DLTensor& dl_tensor = exported->managed.dl_tensor;
+  dl_tensor.data = storage.data;
+  dl_tensor.device = storage.device;
+  dl_tensor.ndim = static_cast<int32_t>(rank);
+  dl_tensor.dtype = dtype;
+  dl_tensor.shape = exported->shape.data();
+  dl_tensor.strides = nullptr;  // Compact row-major.
+  dl_tensor.byte_offset = storage.byte_offset;
+  exported->managed.manager_ctx = exported;
+  exported->managed.deleter = DeleteExportedTensor;
+
+  PyObject* capsule = PyCapsule_New(&exported->managed, kDLTensorCapsuleName,
+                                    DestroyExportedCapsule);
+  if (!capsule) {
+    DeleteExportedTensor(&exported->managed);
+    throw py::python_error();
+  }
+  return py::steal(capsule);
+}
+
+py::tuple QueryBufferViewDevice(HalDevice& device,
+                                HalBufferView& buffer_view) {
+  ExportedStorage storage =
+      ResolveExportedStorage(device, buffer_view.raw_ptr());
+  return py::make_tuple(storage.device.device_type, storage.device.device_id);
+}
+
+HalBufferView ImportBufferView(HalDevice& device, py::handle tensor) {
+  // Accept either a capsule or a producer implementing the protocol.
+  py::object capsule = py::borrow(tensor);
+  if (py::hasattr(tensor, "__dlpack__")) {
+    capsule = tensor.attr("__dlpack__")();
+  }
+  auto* managed = static_cast<DLManagedTensor*>(
+      PyCapsule_GetPointer(capsule.ptr(), kDLTensorCapsuleName));
+  if (!managed) throw py::python_error();
+  const DLTensor& dl_tensor = managed->dl_tensor;
+
+  iree_hal_element_type_t element_type =
+      ConvertDLDataTypeToHalElementType(dl_tensor.dtype);
+  if (!iree_hal_element_is_byte_aligned(element_type)) {
+    throw py::value_error("Sub-byte DLPack data types are not supported");
+  }
+
+  // Only compact row-major tensors can be aliased as buffer views. Strides of
+  // unit dimensions are irrelevant and may be arbitrary.
+  std::vector<iree_hal_dim_t> dims(dl_tensor.ndim);
+  iree_device_size_t element_count = 1;
+  for (int32_t i = dl_tensor.ndim - 1; i >= 0; --i) {
+    if (dl_tensor.strides && dl_tensor.shape[i] != 1 &&
+        dl_tensor.strides[i] != static_cast<int64_t>(element_count)) {
+      throw py::value_error(
+          "Only compact row-major DLPack tensors can be imported");
+    }
+    dims[i] = static_cast<iree_hal_dim_t>(dl_tensor.shape[i]);
+    element_count *= dims[i];
+  }
+  iree_device_size_t byte_length =
+      element_count * iree_hal_element_dense_byte_count(element_type);
+
+  iree_hal_buffer_params_t params;
+  std::memset(&params, 0, sizeof(params));
+  params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+  iree_hal_external_buffer_t external_buffer;
+  std::memset(&external_buffer, 0, sizeof(external_buffer));
+  external_buffer.flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE;
+  external_buffer.size = byte_length;
+  uint8_t* data =
+      static_cast<uint8_t*>(dl_tensor.data) + dl_tensor.byte_offset;
+  switch (dl_tensor.device.device_type) {
+    case kDLCPU:
+    case kDLCUDAHost:
+    case kDLROCMHost:
+      params.type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+      params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT |
+                     IREE_HAL_BUFFER_USAGE_MAPPING;
+      external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+      external_buffer.handle.host_allocation.ptr = data;
+      break;
+    case kDLCUDA:
+    case kDLCUDAManaged: {
+      DLDevice dl_device = QueryDeviceAllocationDevice(device);
+      if (dl_device.device_id != dl_tensor.device.device_id) {
+        throw py::value_error(
+            "DLPack tensor resides on a different device than the target");
+      }
+      params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+      params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+      external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION;
+      external_buffer.handle.device_allocation.ptr =
+          reinterpret_cast<uint64_t>(data);
+      break;
+    }
+    default:
+      throw py::value_error("Unsupported DLPack device type");
+  }
+
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_hal_buffer_release_callback_t release_callback = {
+      ReleaseImportedTensor, managed};
+  CheckApiStatus(
+      iree_hal_allocator_import_buffer(device.allocator(), params,
+                                       &external_buffer, release_callback,
+                                       &buffer),
+      "Importing DLPack tensor");
+  // The buffer now owns the tensor.
+  PyCapsule_SetName(capsule.ptr(), kUsedDLTensorCapsuleName);
+
+  iree_hal_buffer_view_t* buffer_view = nullptr;
+  iree_status_t status = iree_hal_buffer_view_create(
+      buffer, dims.size(), dims.data(), element_type,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      iree_hal_allocator_host_allocator(device.allocator()), &buffer_view);
+  iree_hal_buffer_release(buffer);
+  CheckApiStatus(status, "Creating buffer view of DLPack tensor");
+  return HalBufferView::StealFromRawPtr(buffer_view);
+}
+
+}  // namespace iree::python::dlpack
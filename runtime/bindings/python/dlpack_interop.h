@@ -0,0 +1,32 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BINDINGS_PYTHON_DLPACK_INTEROP_H_
+#define IREE_BINDINGS_PYTHON_DLPACK_INTEROP_H_
+
+#include "./binding.h"
+#include "./hal.h"
+
+namespace iree::python::dlpack {
+
+// Exports |buffer_view| as a DLPack capsule aliasing its storage. The buffer
+// view is retained until the consumer releases the capsule. Host-visible
+// buffers are exported as CPU tensors and device-local buffers as tensors on
+// the device of |device| if the device allocator supports exporting them.
+py::object ExportBufferView(HalDevice& device, HalBufferView& buffer_view);
+
+// Returns the `(device_type, device_id)` DLPack device tuple that
+// ExportBufferView would produce for |buffer_view|.
+py::tuple QueryBufferViewDevice(HalDevice& device, HalBufferView& buffer_view);
+
+// Imports a DLPack capsule (or an object implementing `__dlpack__`) as a
+// buffer view aliasing its storage. The producer is notified that the
+// storage can be released once the buffer view is destroyed.
+HalBufferView ImportBufferView(HalDevice& device, py::handle tensor);
+
+}  // namespace iree::python::dlpack
+
+#endif  // IREE_BINDINGS_PYTHON_DLPACK_INTEROP_H_
@@ -6,6 +6,7 @@
 
 #include "./hal.h"
 
+#include "./dlpack_interop.h"
 #include "./numpy_interop.h"
 #include "./vm.h"
 #include "iree/base/internal/path.h"
@@ -69,6 +70,27 @@ Args:
   signal_semaphores: Semaphores/Fence to signal.
 )";
 
+static const char kHalDeviceExportDLPack[] =
+    R"(Exports a buffer view as a DLPack capsule aliasing its storage.
+
+Host-visible buffers are exported as CPU tensors. Device-local buffers are
+exported as tensors on this device if its allocator supports exporting them
+(currently CUDA). The buffer view is kept alive until the consumer releases
+the tensor. No synchronization is performed: the contents must be ready
+before the capsule is consumed.
+
+Args:
+  buffer_view: `HalBufferView` to export.
+)";
+
+static const char kHalDeviceImportDLPack[] =
+    R"(Imports a DLPack tensor as a buffer view aliasing its storage.
+
+Args:
+  tensor: A DLPack capsule or an object implementing `__dlpack__`. Only
+    compact row-major CPU tensors and tensors on this device are supported.
+)";
+
 static const char kHalFenceWait[] =
     R"(Waits until the fence is signalled or errored.
 
@@ -939,6 +961,12 @@ void SetupHalBindings(nanobind::module_ m) {
       .def("queue_copy", &HalDevice::QueueCopy, py::arg("source_buffer"),
            py::arg("target_buffer"), py::arg("wait_semaphores"),
            py::arg("signal_semaphores"), kHalDeviceQueueCopy)
+      .def("export_dlpack", &dlpack::ExportBufferView, py::arg("buffer_view"),
+           kHalDeviceExportDLPack)
+      .def("dlpack_device", &dlpack::QueryBufferViewDevice,
+           py::arg("buffer_view"))
+      .def("import_dlpack", &dlpack::ImportBufferView, py::arg("tensor"),
+           kHalDeviceImportDLPack)
       .def("__repr__", [](HalDevice& self) {
         auto id_sv = iree_hal_device_id(self.raw_ptr());
         return std::string(id_sv.data, id_sv.size);
@@ -1173,6 +1201,11 @@ void SetupHalBindings(nanobind::module_ m) {
                 "extending fence");
           },
           py::arg("from_fence"))
+      .def("signal",
+           [](HalFence& self) {
+             CheckApiStatus(iree_hal_fence_signal(self.raw_ptr()),
+                            "signaling fence");
+           })
       .def(
           "wait",
           [](HalFence& self, std::optional<iree_duration_t> timeout,
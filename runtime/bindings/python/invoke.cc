@@ -681,6 +681,42 @@ class ArgumentPacker {
     }
   }
 
+  /// Packs positional arguments into an existing (empty) |arg_list|. This is
+  /// the fast path for repeated invocations: keyword resolution is skipped
+  /// and the list storage is reused.
+  void PackInto(InvokeContext &invoke_context, VmVariantList &arg_list,
+                py::sequence pos_args) {
+    IREE_TRACE_SCOPE_NAMED("ArgumentPacker::PackInto");
+    if (arg_list.size() != 0) {
+      throw std::invalid_argument("argument list must be empty");
+    }
+    if (dynamic_dispatch_) {
+      for (py::handle py_arg : pos_args) {
+        PackCallback packer = statics_.GetGenericPackCallbackFor(py_arg);
+        if (!packer) {
+          std::string message("could not convert python value to VM: ");
+          message.append(py::cast<std::string>(py::repr(py_arg)));
+          throw std::invalid_argument(std::move(message));
+        }
+        packer(invoke_context, arg_list.raw_ptr(), py_arg);
+      }
+      return;
+    }
+
+    size_t pos_args_size = py::len(pos_args);
+    if (pos_args_size != flat_arg_packers_.size()) {
+      std::string message("mismatched call arity: expected ");
+      message.append(std::to_string(flat_arg_packers_.size()));
+      message.append(" got ");
+      message.append(std::to_string(pos_args_size));
+      throw std::invalid_argument(std::move(message));
+    }
+    size_t index = 0;
+    for (py::handle py_arg : pos_args) {
+      flat_arg_packers_[index++](invoke_context, arg_list.raw_ptr(), py_arg);
+    }
+  }
+
  private:
   InvokeStatics &statics_;
 
@@ -706,7 +742,8 @@ void SetupInvokeBindings(nanobind::module_ &m) {
   py::class_<ArgumentPacker>(m, "ArgumentPacker")
       .def(py::init<InvokeStatics &, std::optional<py::list>>(),
            py::arg("statics"), py::arg("arg_descs") = py::none())
-      .def("pack", &ArgumentPacker::Pack);
+      .def("pack", &ArgumentPacker::Pack)
+      .def("pack_into", &ArgumentPacker::PackInto);
 
   m.attr("_invoke_statics") = py::cast(InvokeStatics());
 }
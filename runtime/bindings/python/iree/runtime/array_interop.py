@@ -23,6 +23,7 @@ from ._binding import (
 __all__ = [
     "asdevicearray",
     "DeviceArray",
+    "from_dlpack",
 ]
 
 _DEVICE_HANDLED_FUNCTIONS = {}
@@ -216,6 +217,13 @@ class DeviceArray(numpy.lib.mixins.NDArrayOperatorsMixin):
         _, host_array = self._map_to_host()
         return _restore_reduced_array, (host_array,)
 
+    def __dlpack__(self, stream=None):
+        # No synchronization is performed: the array contents must be ready.
+        return self._device.export_dlpack(self._buffer_view)
+
+    def __dlpack_device__(self):
+        return self._device.dlpack_device(self._buffer_view)
+
 
 def _restore_reduced_array(ary):
     return ary
@@ -283,6 +291,22 @@ def asdevicearray(
     )
 
 
+def from_dlpack(
+    device: HalDevice, tensor, *, implicit_host_transfer: bool = False
+) -> DeviceArray:
+    """Creates a DeviceArray aliasing the storage of a DLPack tensor.
+
+    `tensor` may be a DLPack capsule or any object implementing `__dlpack__`
+    (PyTorch, CuPy and JAX arrays, ndarrays, ...). The tensor must be compact
+    row-major and reside either on the host or on `device`. No copy is made:
+    writes through either array are visible to the other.
+    """
+    buffer_view = device.import_dlpack(tensor)
+    return DeviceArray(
+        device, buffer_view, implicit_host_transfer=implicit_host_transfer
+    )
+
+
 # NOTE: Numpy dtypes are not hashable and exist in a hierarchy that should
 # be queried via isinstance checks. This should be done as a fallback but
 # this is a linear list for quick access to the most common. There may also
@@ -6,6 +6,8 @@
 
 from typing import Dict, Optional
 
+import asyncio
+import concurrent.futures
 import json
 import logging
 
@@ -17,6 +19,7 @@ from ._binding import (
     BufferUsage,
     HalBufferView,
     HalDevice,
+    HalFence,
     InvokeContext,
     MemoryType,
     VmContext,
@@ -35,6 +38,7 @@ from .flags import (
 )
 
 __all__ = [
+    "BoundFunctionInvoker",
     "FunctionInvoker",
 ]
 
@@ -89,6 +93,8 @@ class FunctionInvoker:
         "_arg_packer",
         "_ret_descs",
         "_has_inlined_results",
+        "_is_async",
+        "_executor",
         "_tracer",
     ]
 
@@ -110,6 +116,10 @@ class FunctionInvoker:
         self._arg_descs = None
         self._ret_descs = None
         self._has_inlined_results = False
+        self._is_async = (
+            vm_function.reflection.get("iree.abi.model") == "coarse-fences"
+        )
+        self._executor = None
         self._parse_abi_dict(vm_function)
         self._arg_packer = ArgumentPacker(_invoke_statics, self._arg_descs)
 
@@ -137,30 +147,87 @@ class FunctionInvoker:
             self._invoke(arg_list, ret_list)
             if call_trace:
                 call_trace.add_vm_list(ret_list, "results")
-
-            # Un-inline the results to align with reflection, as needed.
-            reflection_aligned_ret_list = ret_list
-            if self._has_inlined_results:
-                reflection_aligned_ret_list = VmVariantList(1)
-                reflection_aligned_ret_list.push_list(ret_list)
-            returns = _extract_vm_sequence_to_python(
-                inv, reflection_aligned_ret_list, ret_descs
-            )
-            return_arity = len(returns)
-            if return_arity == 1:
-                return returns[0]
-            elif return_arity == 0:
-                return None
-            else:
-                return tuple(returns)
+            return self._extract_returns(inv, ret_list)
         finally:
             if call_trace:
                 call_trace.end_call()
 
+    def invoke_async(self, *args, **kwargs) -> asyncio.Future:
+        """Submits an invocation without blocking the running event loop.
+
+        Arguments are marshaled on the calling thread and the invocation is
+        submitted before returning. The returned future resolves to the same
+        results that calling the function would produce.
+
+        Functions using the `coarse-fences` ABI model only schedule work on
+        the device when invoked, so the invocation runs inline and the future
+        completes once the signal fence is reached. Other functions run to
+        completion on a worker thread with the GIL released; invocations of
+        such a function through this invoker are serialized.
+
+        Must be called from a coroutine or callback on a running event loop.
+        Invocations are not traced.
+        """
+        loop = asyncio.get_running_loop()
+        invoke_context = InvokeContext(self._device)
+        arg_list = self._arg_packer.pack(invoke_context, args, kwargs)
+        inv = Invocation(self._device)
+        ret_descs = self._ret_descs
+        ret_list = VmVariantList(len(ret_descs) if ret_descs is not None else 1)
+        if self._is_async:
+            signal_fence = self._append_fences(arg_list)
+            self._invoke(arg_list, ret_list)
+            ready = loop.run_in_executor(None, signal_fence.wait)
+        else:
+            if self._executor is None:
+                self._executor = concurrent.futures.ThreadPoolExecutor(
+                    max_workers=1, thread_name_prefix="iree-invoke"
+                )
+            ready = loop.run_in_executor(
+                self._executor, self._invoke, arg_list, ret_list
+            )
+        return asyncio.ensure_future(self._complete_async(inv, ready, ret_list))
+
+    async def _complete_async(self, inv: Invocation, ready, ret_list):
+        await ready
+        return self._extract_returns(inv, ret_list)
+
+    def _append_fences(self, arg_list: VmVariantList) -> HalFence:
+        """Appends the (wait, signal) fences of the coarse-fences ABI.
+
+        Arguments are ready when the invocation is made, so the wait fence is
+        empty. Returns the signal fence.
+        """
+        signal_fence = HalFence.create_at(self._device.create_semaphore(0), 1)
+        arg_list.push_ref(HalFence(0))
+        arg_list.push_ref(signal_fence)
+        return signal_fence
+
+    def _extract_returns(self, inv: Invocation, ret_list: VmVariantList):
+        # Un-inline the results to align with reflection, as needed.
+        reflection_aligned_ret_list = ret_list
+        if self._has_inlined_results:
+            reflection_aligned_ret_list = VmVariantList(1)
+            reflection_aligned_ret_list.push_list(ret_list)
+        returns = _extract_vm_sequence_to_python(
+            inv, reflection_aligned_ret_list, self._ret_descs
+        )
+        return_arity = len(returns)
+        if return_arity == 1:
+            return returns[0]
+        elif return_arity == 0:
+            return None
+        else:
+            return tuple(returns)
+
     # Break out invoke so it shows up in profiles.
     def _invoke(self, arg_list, ret_list):
         self._vm_context.invoke(self._vm_function, arg_list, ret_list)
 
+    def bind(self) -> "BoundFunctionInvoker":
+        """Returns an invoker specialized for repeated positional calls."""
+        return BoundFunctionInvoker(self)
+
     def _parse_abi_dict(self, vm_function: VmFunction):
         reflection = vm_function.reflection
         abi_json = reflection.get("iree.abi")
@@ -203,6 +270,58 @@ class FunctionInvoker:
         return repr(self._vm_function)
 
 
+class BoundFunctionInvoker:
+    """Invokes a function repeatedly with minimal per-call overhead.
+
+    Created by `FunctionInvoker.bind()`. The packing plan derived from the
+    reflection metadata, the invocation context and the argument/result lists
+    are created once and reused by every call. Calls accept positional
+    arguments only: arguments that are keyword arguments of the function are
+    passed positionally in declaration order.
+
+    Since state is reused across calls, a bound invoker must not be called
+    concurrently or re-entrantly. Calls are not traced.
+    """
+
+    __slots__ = [
+        "_invoker",
+        "_invoke_context",
+        "_inv",
+        "_arg_list",
+        "_ret_list",
+    ]
+
+    def __init__(self, invoker: FunctionInvoker):
+        self._invoker = invoker
+        self._invoke_context = InvokeContext(invoker._device)
+        self._inv = Invocation(invoker._device)
+        arg_descs = invoker._arg_descs
+        ret_descs = invoker._ret_descs
+        self._arg_list = VmVariantList(len(arg_descs) if arg_descs else 0)
+        self._ret_list = VmVariantList(len(ret_descs) if ret_descs else 1)
+
+    @property
+    def vm_function(self) -> VmFunction:
+        return self._invoker.vm_function
+
+    def __call__(self, *args):
+        invoker = self._invoker
+        arg_list = self._arg_list
+        ret_list = self._ret_list
+        try:
+            invoker._arg_packer.pack_into(self._invoke_context, arg_list, args)
+            invoker._invoke(arg_list, ret_list)
+            return invoker._extract_returns(self._inv, ret_list)
+        finally:
+            # Drop references to arguments and results so that they do not
+            # outlive the call.
+            arg_list.clear()
+            ret_list.clear()
+
+    def __repr__(self):
+        return f"<BoundFunctionInvoker {repr(self._invoker)}>"
+
+
 # VM to Python converters. All take:
 #   inv: Invocation
 #   vm_list: VmVariantList to read from
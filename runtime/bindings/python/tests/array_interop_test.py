@@ -164,6 +164,38 @@ class DeviceHalTest(unittest.TestCase):
         self.assertEqual(repr(ary), "<IREE DeviceArray: shape=[3, 4], dtype=bool>")
         np.testing.assert_array_equal(ary.to_host(), init_ary)
 
+    def testDLPackExport(self):
+        init_ary = np.arange(12, dtype=np.float32).reshape([3, 4])
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        self.assertEqual(ary.__dlpack_device__(), (1, 0))
+        aliased = np.from_dlpack(ary)
+        np.testing.assert_array_equal(aliased, init_ary)
+
+        # Writes through the exported tensor are visible to the device array.
+        aliased[1, 2] = 42.0
+        np.testing.assert_array_equal(ary.to_host()[1, 2], 42.0)
+
+        # The exported tensor keeps the storage live.
+        ary = None
+        gc.collect()
+        self.assertEqual(aliased[1, 2], 42.0)
+
+    def testDLPackImport(self):
+        init_ary = np.arange(12, dtype=np.int32).reshape([3, 4])
+        ary = iree.runtime.from_dlpack(self.device, init_ary)
+        self.assertEqual([3, 4], ary.shape)
+        self.assertEqual(np.int32, ary.dtype)
+        np.testing.assert_array_equal(ary.to_host(), init_ary)
+
+        # The device array aliases the imported tensor.
+        init_ary[0, 1] = 7
+        self.assertEqual(np.from_dlpack(ary)[0, 1], 7)
+
+    def testDLPackImportNonContiguous(self):
+        init_ary = np.arange(12, dtype=np.int32).reshape([3, 4])
+        with self.assertRaisesRegex(ValueError, "row-major"):
+            iree.runtime.from_dlpack(self.device, init_ary.T)
+
 
 if __name__ == "__main__":
     unittest.main()
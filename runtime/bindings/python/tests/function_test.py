@@ -4,6 +4,7 @@
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+import asyncio
 import json
 import numpy as np
 import unittest
@@ -14,7 +15,7 @@ from iree.runtime.function import (
     IMPLICIT_BUFFER_ARG_MEMORY_TYPE,
     IMPLICIT_BUFFER_ARG_USAGE,
 )
-from iree.runtime._binding import VmVariantList
+from iree.runtime._binding import HalFence, VmVariantList
 
 
 class MockVmContext:
@@ -685,6 +686,92 @@ class FunctionTest(unittest.TestCase):
         result = invoker()
         self.assertEqual("[1, 2]", repr(result))
 
+    def testBoundInvoker(self):
+        def invoke(arg_list, ret_list):
+            ret_list.push_int(arg_list.get_variant(0) + arg_list.get_variant(1))
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(
+            reflection={
+                "iree.abi": json.dumps(
+                    {
+                        "a": ["i32", ["named", "b", "i32"]],
+                        "r": ["i32"],
+                    }
+                )
+            }
+        )
+        invoker = FunctionInvoker(vm_context, self.device, vm_function, tracer=None)
+        bound = invoker.bind()
+        self.assertEqual(3, bound(1, 2))
+        self.assertEqual(7, bound(3, 4))
+        # The argument list is reused and emptied after each call.
+        (_, first_arg_list, _), (_, second_arg_list, _) = vm_context.invocations
+        self.assertIs(first_arg_list, second_arg_list)
+        self.assertEqual(0, len(first_arg_list))
+
+    def testBoundInvokerArityMismatch(self):
+        vm_context = MockVmContext(lambda arg_list, ret_list: None)
+        vm_function = MockVmFunction(
+            reflection={
+                "iree.abi": json.dumps({"a": ["i32", "i32"], "r": []}),
+            }
+        )
+        invoker = FunctionInvoker(vm_context, self.device, vm_function, tracer=None)
+        bound = invoker.bind()
+        with self.assertRaisesRegex(ValueError, "mismatched call arity"):
+            bound(1)
+        # The bound invoker remains usable after an error.
+        bound(1, 2)
+
+    def testInvokeAsync(self):
+        def invoke(arg_list, ret_list):
+            ret_list.push_int(arg_list.get_variant(0) + 1)
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(reflection={})
+        invoker = FunctionInvoker(vm_context, self.device, vm_function, tracer=None)
+
+        async def main():
+            return await asyncio.gather(
+                invoker.invoke_async(1), invoker.invoke_async(2)
+            )
+
+        self.assertEqual([2, 3], asyncio.run(main()))
+        self.assertEqual(2, len(vm_context.invocations))
+
+    def testInvokeAsyncCoarseFences(self):
+        pending_fences = []
+
+        def invoke(arg_list, ret_list):
+            # (arg, wait_fence, signal_fence)
+            self.assertEqual(3, len(arg_list))
+            wait_fence = arg_list.get_as_object(1, HalFence)
+            self.assertEqual(0, wait_fence.timepoint_count)
+            pending_fences.append(arg_list.get_as_object(2, HalFence))
+            ret_list.push_int(arg_list.get_variant(0) * 2)
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(
+            reflection={
+                "iree.abi.model": "coarse-fences",
+                "iree.abi": json.dumps({"a": ["i32"], "r": ["i32"]}),
+            }
+        )
+        invoker = FunctionInvoker(vm_context, self.device, vm_function, tracer=None)
+
+        async def main():
+            future = invoker.invoke_async(21)
+            # The invocation is submitted eagerly but does not complete until
+            # its signal fence is reached.
+            self.assertEqual(1, len(pending_fences))
+            await asyncio.sleep(0)
+            self.assertFalse(future.done())
+            pending_fences[0].signal()
+            return await future
+
+        self.assertEqual(42, asyncio.run(main()))
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -866,6 +866,7 @@ void SetupVmBindings(nanobind::module_ m) {
           py::arg("capacity"))
       .def_prop_ro("size", &VmVariantList::size)
       .def("__len__", &VmVariantList::size)
+      .def("clear", &VmVariantList::Clear)
       .def("get_as_ref", &VmVariantList::GetAsRef)
       .def("get_as_object", &VmVariantList::GetAsObject)
       .def("get_as_list", &VmVariantList::GetAsList)
@@ -96,6 +96,9 @@ class VmVariantList : public ApiRefCounted<VmVariantList, iree_vm_list_t> {
 
   iree_host_size_t size() const { return iree_vm_list_size(raw_ptr()); }
 
+  // Releases all elements while retaining the storage for reuse.
+  void Clear() { iree_vm_list_clear(raw_ptr()); }
+
   void AppendNullRef() {
     iree_vm_ref_t null_ref = {0};
     CheckApiStatus(iree_vm_list_push_ref_move(raw_ptr(), &null_ref),
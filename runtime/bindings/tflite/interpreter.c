@@ -541,11 +541,20 @@ static iree_status_t _TfLiteInterpreterAllocateTensors(
         iree_vm_list_push_ref_move(interpreter->input_list, &buffer_ref));
   }
 
+  // Outputs with custom allocations keep them wrapped persistently so that
+  // results can be copied into them after each invocation. All other outputs
+  // are bound to the result buffers of each invocation.
   // TODO(benvanik): preallocate outputs when we support using them.
   // We could stash the buffer views in interpreter->output_list.
-  // For now we just drop them all.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
-    _TfLiteTensorDiscardBuffer(&interpreter->output_tensors[i]);
+    TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    if (tensor->custom_allocation.data) {
+      IREE_RETURN_IF_ERROR(_TfLiteTensorReallocateIfNeeded(
+          tensor, iree_hal_device_allocator(interpreter->device),
+          interpreter->allocator));
+    } else {
+      _TfLiteTensorDiscardBuffer(tensor);
+    }
   }
 
   return iree_ok_status();
@@ -590,7 +599,15 @@ static iree_status_t _TfLiteInterpreterInvoke(TfLiteInterpreter* interpreter) {
     iree_hal_buffer_t* buffer =
         iree_vm_list_get_buffer_assign(interpreter->output_list, i);
     TfLiteTensor* tensor = &interpreter->output_tensors[i];
-    IREE_RETURN_IF_ERROR(_TfLiteTensorBind(tensor, buffer));
+    if (tensor->custom_allocation.data && buffer) {
+      // The output shape may have changed with the invocation.
+      IREE_RETURN_IF_ERROR(_TfLiteTensorReallocateIfNeeded(
+          tensor, iree_hal_device_allocator(interpreter->device),
+          interpreter->allocator));
+      IREE_RETURN_IF_ERROR(_TfLiteTensorCopyFromResult(tensor, buffer));
+    } else {
+      IREE_RETURN_IF_ERROR(_TfLiteTensorBind(tensor, buffer));
+    }
   }
 
   return iree_ok_status();
@@ -615,6 +632,42 @@ TFL_CAPI_EXPORT extern TfLiteStatus TfLiteInterpreterInvoke(
   return _TfLiteStatusFromIREEStatus(status);
 }
 
+static iree_status_t _TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  // Only I/O tensors exist: inputs are followed by outputs.
+  int32_t input_count = interpreter->model->input_count;
+  int32_t output_count = interpreter->model->output_count;
+  if (tensor_index < 0 || tensor_index >= input_count + output_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tensor_index out of range (0 <= %d < %d)",
+                            tensor_index, input_count + output_count);
+  }
+  TfLiteTensor* tensor = tensor_index < input_count
+                             ? &interpreter->input_tensors[tensor_index]
+                             : &interpreter->output_tensors[tensor_index -
+                                                            input_count];
+  IREE_RETURN_IF_ERROR(
+      _TfLiteTensorSetCustomAllocation(tensor, allocation, flags));
+  if (tensor_index < input_count) {
+    // Drop the reference the input list holds to the discarded buffer; the
+    // list is repopulated by TfLiteInterpreterAllocateTensors.
+    IREE_RETURN_IF_ERROR(iree_vm_list_resize(interpreter->input_list, 0));
+  }
+  return iree_ok_status();
+}
+
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = _TfLiteInterpreterSetCustomAllocationForTensor(
+      interpreter, tensor_index, allocation, flags);
+  IREE_TRACE_ZONE_END(z0);
+  return _TfLiteStatusFromIREEStatus(status);
+}
+
 TFL_CAPI_EXPORT extern int32_t TfLiteInterpreterGetOutputTensorCount(
     const TfLiteInterpreter* interpreter) {
   return interpreter->model->output_count;
@@ -132,19 +132,51 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
     IREE_TRACE_ZONE_END(z0);
     return iree_ok_status();
   }
+  _TfLiteTensorDiscardBuffer(tensor);
 
-  // Allocate the underlying buffer for the tensor.
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_allocator_allocate_buffer(
-              buffer_allocator,
-              (iree_hal_buffer_params_t){
-                  .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
-                          IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
-                  .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
-                           IREE_HAL_BUFFER_USAGE_TRANSFER |
-                           IREE_HAL_BUFFER_USAGE_MAPPING,
-              },
-              allocation_size, &tensor->buffer));
+  if (tensor->custom_allocation.data) {
+    // Wrap the user memory so that it is used in-place by the program.
+    if (allocation_size > tensor->custom_allocation.bytes) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "custom allocation of %" PRIhsz
+          " bytes is smaller than the required %" PRIdsz " bytes",
+          (iree_host_size_t)tensor->custom_allocation.bytes, allocation_size);
+    }
+    iree_hal_external_buffer_t external_buffer = {
+        .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+        .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+        .size = allocation_size,
+        .handle.host_allocation.ptr = tensor->custom_allocation.data,
+    };
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_allocator_import_buffer(
+                buffer_allocator,
+                (iree_hal_buffer_params_t){
+                    .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                            IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+                    .access = IREE_HAL_MEMORY_ACCESS_ALL,
+                    .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                             IREE_HAL_BUFFER_USAGE_TRANSFER |
+                             IREE_HAL_BUFFER_USAGE_MAPPING,
+                },
+                &external_buffer, iree_hal_buffer_release_callback_null(),
+                &tensor->buffer));
+  } else {
+    // Allocate the underlying buffer for the tensor.
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_allocator_allocate_buffer(
+                buffer_allocator,
+                (iree_hal_buffer_params_t){
+                    .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                            IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+                    .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                             IREE_HAL_BUFFER_USAGE_TRANSFER |
+                             IREE_HAL_BUFFER_USAGE_MAPPING,
+                },
+                allocation_size, &tensor->buffer));
+  }
 
   // Map the buffer memory immediately. The tflite API doesn't let us know if
   // this is a buffer the user will actually touch or some state buffer that is
@@ -161,6 +193,49 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
   return iree_ok_status();
 }
 
+iree_status_t _TfLiteTensorSetCustomAllocation(
+    TfLiteTensor* tensor, const TfLiteCustomAllocation* allocation,
+    int64_t flags) {
+  // This is the same value as kDefaultTensorAlignment in tflite.
+  const iree_host_size_t required_alignment = 64;
+  if (!allocation || !allocation->data) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "custom allocation must have data");
+  }
+  if (!(flags & kTfLiteCustomAllocationFlagsSkipAlignCheck) &&
+      !iree_host_size_has_alignment((iree_host_size_t)allocation->data,
+                                    required_alignment)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "custom allocation must be aligned to %" PRIhsz
+                            " bytes",
+                            required_alignment);
+  }
+  _TfLiteTensorDiscardBuffer(tensor);
+  tensor->custom_allocation = *allocation;
+  return iree_ok_status();
+}
+
+iree_status_t _TfLiteTensorCopyFromResult(TfLiteTensor* tensor,
+                                          iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_device_size_t byte_length = iree_hal_buffer_byte_length(buffer);
+  if (byte_length != tensor->buffer_mapping.contents.data_length) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "result of %" PRIdsz
+                            " bytes does not match the tensor size of %" PRIhsz
+                            " bytes",
+                            byte_length,
+                            tensor->buffer_mapping.contents.data_length);
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, byte_length);
+  iree_status_t status =
+      iree_hal_buffer_map_read(buffer, 0, tensor->buffer_mapping.contents.data,
+                               (iree_host_size_t)byte_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 iree_status_t _TfLiteTensorBind(TfLiteTensor* tensor,
                                 iree_hal_buffer_t* buffer) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -195,6 +270,7 @@ void _TfLiteTensorDiscardBuffer(TfLiteTensor* tensor) {
   IREE_TRACE_ZONE_BEGIN(z0);
   if (tensor->buffer_mapping.contents.data != NULL) {
     iree_hal_buffer_unmap_range(&tensor->buffer_mapping);
+    memset(&tensor->buffer_mapping, 0, sizeof(tensor->buffer_mapping));
   }
   iree_hal_buffer_release(tensor->buffer);
   tensor->buffer = NULL;
@@ -38,6 +38,10 @@ struct TfLiteTensor {
   iree_hal_buffer_t* buffer;
   // Persistently mapped buffer; invalidated when buffer is resized.
   iree_hal_buffer_mapping_t buffer_mapping;
+
+  // User-provided memory the buffer is imported from instead of allocating,
+  // if |custom_allocation.data| is not NULL. Unowned.
+  TfLiteCustomAllocation custom_allocation;
 };
 
 // Parses a tfl.io.names value and sets the |tensor| name.
@@ -60,6 +64,17 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
     TfLiteTensor* tensor, iree_hal_allocator_t* buffer_allocator,
     iree_allocator_t heap_allocator);
 
+// Sets the user-provided memory backing the tensor. The current buffer is
+// discarded and the memory is imported on the next reallocation.
+iree_status_t _TfLiteTensorSetCustomAllocation(
+    TfLiteTensor* tensor, const TfLiteCustomAllocation* allocation,
+    int64_t flags);
+
+// Copies the contents of |buffer| into the allocated tensor buffer.
+// Used to populate custom allocations of outputs after invocation.
+iree_status_t _TfLiteTensorCopyFromResult(TfLiteTensor* tensor,
+                                          iree_hal_buffer_t* buffer);
+
 // Binds the given |buffer| to the tensor and maps it.
 // The tensor shape will be overwritten with the buffer view shape.
 iree_status_t _TfLiteTensorBind(TfLiteTensor* tensor,
@@ -163,6 +163,15 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_STATISTICS_ENABLE 1
 #endif  // !IREE_STATISTICS_ENABLE
 
+// Conditionally enables always-on runtime metrics (see
+// iree/base/internal/metrics.h). Metrics are cheap relaxed atomic counters
+// intended to remain enabled in production builds; disabling them removes the
+// per-operation updates and the process-wide registry.
+
+#if !defined(IREE_METRICS_ENABLE)
+#define IREE_METRICS_ENABLE 1
+#endif  // !IREE_METRICS_ENABLE
+
 //===----------------------------------------------------------------------===//
 // Tracing
 //===----------------------------------------------------------------------===//
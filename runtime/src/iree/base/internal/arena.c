@@ -4,6 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// NOTE: must be first before _any_ system includes.
+#define _GNU_SOURCE
+
 #include "iree/base/internal/arena.h"
 
 #include <stdint.h>
@@ -11,6 +14,14 @@
 
 #include "iree/base/internal/debugging.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IREE_ARENA_HAVE_MAPPED_SLABS 1
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
 //===----------------------------------------------------------------------===//
 // iree_arena_block_pool_t
 //===----------------------------------------------------------------------===//
@@ -30,12 +41,214 @@ void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Huge page size used when backing slabs with huge pages.
+// This is the common size on x86-64 and arm64 with 4KB base pages.
+#define IREE_ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Page size used when touching slab pages to prefault them.
+// Smaller than or equal to all supported platform page sizes.
+#define IREE_ARENA_MIN_PAGE_SIZE 4096
+
+#if defined(IREE_ARENA_HAVE_MAPPED_SLABS)
+
+// From linux/mempolicy.h; not all libcs expose it and we don't want to depend
+// on libnuma just for a single syscall.
+#define IREE_ARENA_MPOL_BIND 2
+
+// Binds [ptr, ptr + size) to |numa_node|. Best-effort: failures (no NUMA
+// support, restricted cpusets, seccomp, etc) leave the default policy in place.
+static void iree_arena_slab_bind_numa_node(void* ptr, iree_host_size_t size,
+                                           uint32_t numa_node) {
+#if defined(SYS_mbind)
+  unsigned long nodemask[4] = {0};
+  const uint32_t bits_per_word = sizeof(nodemask[0]) * 8;
+  if (numa_node >= IREE_ARRAYSIZE(nodemask) * bits_per_word) return;
+  nodemask[numa_node / bits_per_word] = 1ul << (numa_node % bits_per_word);
+  syscall(SYS_mbind, ptr, (unsigned long)size, IREE_ARENA_MPOL_BIND, nodemask,
+          (unsigned long)(IREE_ARRAYSIZE(nodemask) * bits_per_word), 0);
+#endif  // SYS_mbind
+}
+
+static iree_status_t iree_arena_slab_map(
+    iree_host_size_t minimum_size, iree_arena_block_pool_slab_flags_t flags,
+    uint32_t numa_node, iree_arena_block_pool_slab_t* slab) {
+  const bool use_huge_pages =
+      iree_all_bits_set(flags, IREE_ARENA_BLOCK_POOL_SLAB_FLAG_HUGE_PAGES);
+  const iree_host_size_t size =
+      use_huge_pages
+          ? iree_host_align(minimum_size, IREE_ARENA_HUGE_PAGE_SIZE)
+          : iree_host_align(minimum_size, (iree_host_size_t)getpagesize());
+
+  void* ptr = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  // Try explicit huge pages first; these must have been reserved by the system
+  // administrator (vm.nr_hugepages) and commonly are not.
+  if (use_huge_pages) {
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif  // MAP_HUGETLB
+  if (ptr == MAP_FAILED) {
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+               -1, 0);
+    if (ptr == MAP_FAILED) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to map a %" PRIhsz "b arena slab", size);
+    }
+#if defined(MADV_HUGEPAGE)
+    // Fall back to transparent huge pages. The mapping may not be 2MB aligned
+    // in which case only the aligned interior will be eligible.
+    if (use_huge_pages) madvise(ptr, size, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+  }
+
+  // The binding must happen prior to any page being touched as pages are
+  // placed on first touch.
+  if (iree_all_bits_set(flags,
+                        IREE_ARENA_BLOCK_POOL_SLAB_FLAG_BIND_NUMA_NODE)) {
+    iree_arena_slab_bind_numa_node(ptr, size, numa_node);
+  }
+
+  slab->base = (uint8_t*)ptr;
+  slab->size = size;
+  slab->is_mapped = true;
+  return iree_ok_status();
+}
+
+static void iree_arena_slab_unmap(iree_arena_block_pool_slab_t* slab) {
+  munmap(slab->base, slab->size);
+}
+
+#else
+
+static iree_status_t iree_arena_slab_map(
+    iree_host_size_t minimum_size, iree_arena_block_pool_slab_flags_t flags,
+    uint32_t numa_node, iree_arena_block_pool_slab_t* slab) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "mapped arena slabs are not supported");
+}
+
+static void iree_arena_slab_unmap(iree_arena_block_pool_slab_t* slab) {}
+
+#endif  // IREE_ARENA_HAVE_MAPPED_SLABS
+
+// Returns true if |block| is stored within the reserved slab of |block_pool|.
+static bool iree_arena_block_pool_is_slab_block(
+    const iree_arena_block_pool_t* block_pool, const iree_arena_block_t* block) {
+  const uint8_t* block_ptr = (const uint8_t*)block;
+  return block_ptr >= block_pool->slab.base &&
+         block_ptr <
+             block_pool->slab.base + block_pool->slab.block_storage_size;
+}
+
+iree_status_t iree_arena_block_pool_reserve_slab(
+    iree_arena_block_pool_t* block_pool,
+    const iree_arena_block_pool_slab_params_t* params) {
+  IREE_ASSERT_ARGUMENT(block_pool);
+  IREE_ASSERT_ARGUMENT(params);
+  if (params->block_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, params->block_count);
+
+  if (block_pool->slab.base) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "block pool already has a reserved slab");
+  }
+  if (!iree_host_size_has_alignment(block_pool->total_block_size,
+                                    iree_max_align_t)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "block size %" PRIhsz
+                            " must be a multiple of %d to be used in a slab",
+                            block_pool->total_block_size,
+                            (int)iree_max_align_t);
+  }
+  if (params->block_count >
+      IREE_HOST_SIZE_MAX / block_pool->total_block_size) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "slab of %" PRIhsz " blocks overflows",
+                            params->block_count);
+  }
+  const iree_host_size_t block_storage_size =
+      params->block_count * block_pool->total_block_size;
+
+  // Prefer mapping memory directly from the system as that is the only way to
+  // control the page size and placement. If that fails (or isn't supported) we
+  // fall back to the block allocator so that the reservation still avoids
+  // allocations in steady state.
+  iree_arena_block_pool_slab_t slab;
+  memset(&slab, 0, sizeof(slab));
+  iree_status_t status = iree_arena_slab_map(block_storage_size, params->flags,
+                                             params->numa_node, &slab);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    slab.size = block_storage_size;
+    slab.is_mapped = false;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0,
+        iree_allocator_malloc_uninitialized(
+            block_pool->block_allocator, block_storage_size,
+            (void**)&slab.base));
+  }
+  slab.block_storage_size = block_storage_size;
+
+  // Take the page faults now instead of on first use of each block.
+  if (iree_all_bits_set(params->flags,
+                        IREE_ARENA_BLOCK_POOL_SLAB_FLAG_PREFAULT)) {
+    for (iree_host_size_t offset = 0; offset < slab.size;
+         offset += IREE_ARENA_MIN_PAGE_SIZE) {
+      ((volatile uint8_t*)slab.base)[offset] = 0;
+    }
+  }
+
+  // Chain all blocks together in address order and add them to the pool.
+  iree_arena_block_t* head = NULL;
+  iree_arena_block_t* tail = NULL;
+  for (iree_host_size_t i = 0; i < params->block_count; ++i) {
+    iree_arena_block_t* block = iree_arena_block_trailer(
+        block_pool, slab.base + i * block_pool->total_block_size);
+    block->next = NULL;
+    if (tail) {
+      tail->next = block;
+    } else {
+      head = block;
+    }
+    tail = block;
+  }
+  block_pool->slab = slab;
+  iree_arena_block_pool_release(block_pool, head, tail);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Since all blocks must have been released we can just reuse trim (today) as
-  // it doesn't retain any blocks.
-  iree_arena_block_pool_trim(block_pool);
+  // Since all blocks must have been released we can drop all of them as the
+  // slab (if any) is freed in bulk.
+  iree_arena_block_t* head = NULL;
+  iree_atomic_arena_block_slist_flush(
+      &block_pool->available_slist,
+      IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &head, NULL);
+  while (head) {
+    iree_arena_block_t* next = head->next;
+    if (!iree_arena_block_pool_is_slab_block(block_pool, head)) {
+      iree_allocator_free(block_pool->block_allocator,
+                          iree_arena_block_ptr(block_pool, head));
+    }
+    head = next;
+  }
+  if (block_pool->slab.base) {
+    if (block_pool->slab.is_mapped) {
+      iree_arena_slab_unmap(&block_pool->slab);
+    } else {
+      iree_allocator_free(block_pool->block_allocator, block_pool->slab.base);
+    }
+    memset(&block_pool->slab, 0, sizeof(block_pool->slab));
+  }
   iree_atomic_arena_block_slist_deinitialize(&block_pool->available_slist);
 
   IREE_TRACE_ZONE_END(z0);
@@ -48,10 +261,24 @@ void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool) {
   iree_atomic_arena_block_slist_flush(
       &block_pool->available_slist,
       IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &head, NULL);
+
+  // Free all blocks not from the slab and retain the rest.
+  iree_arena_block_t* retained_head = NULL;
+  iree_arena_block_t* retained_tail = NULL;
   while (head) {
-    void* ptr = (uint8_t*)head - block_pool->usable_block_size;
-    head = head->next;
-    iree_allocator_free(block_pool->block_allocator, ptr);
+    iree_arena_block_t* next = head->next;
+    if (iree_arena_block_pool_is_slab_block(block_pool, head)) {
+      head->next = retained_head;
+      retained_head = head;
+      if (!retained_tail) retained_tail = head;
+    } else {
+      iree_allocator_free(block_pool->block_allocator,
+                          iree_arena_block_ptr(block_pool, head));
+    }
+    head = next;
+  }
+  if (retained_head) {
+    iree_arena_block_pool_release(block_pool, retained_head, retained_tail);
   }
 
   IREE_TRACE_ZONE_END(z0);
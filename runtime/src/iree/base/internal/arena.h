@@ -43,6 +43,48 @@ IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
 #define iree_arena_block_trailer(block_pool, ptr) \
   (iree_arena_block_t*)((const uint8_t*)(ptr) + (block_pool)->usable_block_size)
 
+// Bitfield controlling how a block pool slab is allocated.
+typedef uint32_t iree_arena_block_pool_slab_flags_t;
+enum iree_arena_block_pool_slab_flag_bits_t {
+  IREE_ARENA_BLOCK_POOL_SLAB_FLAG_NONE = 0u,
+  // Backs the slab with huge pages (2MB on most systems) when supported by the
+  // platform in order to reduce TLB pressure. Falls back to transparent huge
+  // page hints and then normal pages if explicit huge pages are unavailable.
+  IREE_ARENA_BLOCK_POOL_SLAB_FLAG_HUGE_PAGES = 1u << 0,
+  // Binds the slab memory to the NUMA node specified by
+  // iree_arena_block_pool_slab_params_t::numa_node when supported by the
+  // platform.
+  IREE_ARENA_BLOCK_POOL_SLAB_FLAG_BIND_NUMA_NODE = 1u << 1,
+  // Touches all pages of the slab when it is reserved so that the page faults
+  // are taken up-front instead of on first use of each block.
+  IREE_ARENA_BLOCK_POOL_SLAB_FLAG_PREFAULT = 1u << 2,
+};
+
+// Parameters for reserving a block pool slab.
+typedef struct iree_arena_block_pool_slab_params_t {
+  // Flags controlling the slab allocation.
+  iree_arena_block_pool_slab_flags_t flags;
+  // Total number of blocks to reserve in the slab.
+  iree_host_size_t block_count;
+  // NUMA node the slab is bound to if
+  // IREE_ARENA_BLOCK_POOL_SLAB_FLAG_BIND_NUMA_NODE is set.
+  uint32_t numa_node;
+} iree_arena_block_pool_slab_params_t;
+
+// A contiguous reservation of blocks owned by a block pool.
+typedef struct iree_arena_block_pool_slab_t {
+  // Base pointer of the slab or NULL if no slab has been reserved.
+  uint8_t* base;
+  // Total size of the slab allocation, in bytes. May be larger than the blocks
+  // it contains due to page rounding.
+  iree_host_size_t size;
+  // Total size of the blocks within the slab, in bytes.
+  iree_host_size_t block_storage_size;
+  // True if the slab was mapped directly from the platform instead of being
+  // allocated from the block allocator.
+  bool is_mapped;
+} iree_arena_block_pool_slab_t;
+
 // A simple atomic fixed-size block pool.
 // Blocks are allocated from the system as required and kept in the pool to
 // satisfy future requests. Blocks are all of a uniform size specified when the
@@ -50,6 +92,10 @@ IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
 // blocks so that the underlying allocator is more likely to bucket them
 // appropriately.
 //
+// Pools may optionally reserve a slab of blocks up-front with
+// iree_arena_block_pool_reserve_slab. Blocks from the slab are used before any
+// new blocks are allocated and are never returned to the system by trimming.
+//
 // Thread-safe; multiple threads may acquire and release blocks from the pool.
 // The underlying allocator must also be thread-safe.
 typedef struct iree_arena_block_pool_t {
@@ -62,6 +108,8 @@ typedef struct iree_arena_block_pool_t {
   iree_allocator_t block_allocator;
   // Linked list of free blocks (LIFO).
   iree_atomic_arena_block_slist_t available_slist;
+  // Optional slab of blocks reserved when the pool was created.
+  iree_arena_block_pool_slab_t slab;
 } iree_arena_block_pool_t;
 
 // Initializes a new block pool in |out_block_pool|.
@@ -77,8 +125,21 @@ void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
 // back to it.
 void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool);
 
+// Reserves a contiguous slab of blocks as specified by |params| and adds them
+// to the pool. Only one slab may be reserved per pool and it must be reserved
+// prior to acquiring any blocks. The slab is released when the pool is
+// deinitialized.
+//
+// Huge page and NUMA binding flags are best-effort and ignored on platforms
+// that do not support them (in which case the slab is allocated from the block
+// allocator).
+iree_status_t iree_arena_block_pool_reserve_slab(
+    iree_arena_block_pool_t* block_pool,
+    const iree_arena_block_pool_slab_params_t* params);
+
 // Trims the pool by freeing unused blocks back to the allocator.
-// Acquired blocks are not freed and remain valid.
+// Acquired blocks are not freed and remain valid. Blocks from the reserved
+// slab, if any, are retained in the pool.
 void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool);
 
 // Acquires a single block from the pool and returns it in |out_block|.
@@ -0,0 +1,131 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static bool IsSlabBlock(const iree_arena_block_pool_t* block_pool,
+                        const void* ptr) {
+  const uint8_t* byte_ptr = (const uint8_t*)ptr;
+  return byte_ptr >= block_pool->slab.base &&
+         byte_ptr < block_pool->slab.base + block_pool->slab.block_storage_size;
+}
+
+TEST(ArenaBlockPoolTest, Lifetime) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(4096, iree_allocator_system(), &block_pool);
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+TEST(ArenaBlockPoolTest, AcquireRelease) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(4096, iree_allocator_system(), &block_pool);
+
+  iree_arena_block_t* block = NULL;
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_arena_block_pool_acquire(&block_pool, &block, &ptr));
+  EXPECT_EQ(ptr, iree_arena_block_ptr(&block_pool, block));
+  memset(ptr, 0xCD, block_pool.usable_block_size);
+  iree_arena_block_pool_release(&block_pool, block, block);
+
+  // Reacquiring should reuse the released block.
+  iree_arena_block_t* reused_block = NULL;
+  IREE_ASSERT_OK(
+      iree_arena_block_pool_acquire(&block_pool, &reused_block, &ptr));
+  EXPECT_EQ(reused_block, block);
+  iree_arena_block_pool_release(&block_pool, reused_block, reused_block);
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+// Tests that slab blocks are used before allocating new blocks and that they
+// survive trimming. Huge pages, NUMA binding, and prefaulting are best-effort
+// and must not cause the reservation to fail.
+TEST(ArenaBlockPoolTest, ReserveSlab) {
+  const iree_arena_block_pool_slab_flags_t flag_sets[] = {
+      IREE_ARENA_BLOCK_POOL_SLAB_FLAG_NONE,
+      IREE_ARENA_BLOCK_POOL_SLAB_FLAG_PREFAULT,
+      IREE_ARENA_BLOCK_POOL_SLAB_FLAG_HUGE_PAGES |
+          IREE_ARENA_BLOCK_POOL_SLAB_FLAG_BIND_NUMA_NODE |
+          IREE_ARENA_BLOCK_POOL_SLAB_FLAG_PREFAULT,
+  };
+  for (iree_arena_block_pool_slab_flags_t flags : flag_sets) {
+    iree_arena_block_pool_t block_pool;
+    iree_arena_block_pool_initialize(4096, iree_allocator_system(),
+                                     &block_pool);
+    iree_arena_block_pool_slab_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.flags = flags;
+    params.block_count = 4;
+    params.numa_node = 0;
+    IREE_ASSERT_OK(iree_arena_block_pool_reserve_slab(&block_pool, &params));
+    EXPECT_GE(block_pool.slab.size, 4 * block_pool.total_block_size);
+
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<iree_arena_block_t*> blocks;
+      for (int i = 0; i < 5; ++i) {
+        iree_arena_block_t* block = NULL;
+        void* ptr = NULL;
+        IREE_ASSERT_OK(
+            iree_arena_block_pool_acquire(&block_pool, &block, &ptr));
+        memset(ptr, 0xCD, block_pool.usable_block_size);
+        // The first 4 blocks come from the slab and the 5th is allocated.
+        EXPECT_EQ(IsSlabBlock(&block_pool, ptr), i < 4);
+        blocks.push_back(block);
+      }
+      for (auto* block : blocks) {
+        iree_arena_block_pool_release(&block_pool, block, block);
+      }
+      iree_arena_block_pool_trim(&block_pool);
+    }
+
+    iree_arena_block_pool_deinitialize(&block_pool);
+  }
+}
+
+TEST(ArenaBlockPoolTest, ReserveSlabTwiceFails) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(4096, iree_allocator_system(), &block_pool);
+  iree_arena_block_pool_slab_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.block_count = 2;
+  IREE_ASSERT_OK(iree_arena_block_pool_reserve_slab(&block_pool, &params));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        iree_arena_block_pool_reserve_slab(&block_pool,
+                                                           &params));
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+TEST(ArenaTest, SlabBackedAllocations) {
+  iree_arena_block_pool_t block_pool;
+  iree_arena_block_pool_initialize(4096, iree_allocator_system(), &block_pool);
+  iree_arena_block_pool_slab_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.block_count = 8;
+  IREE_ASSERT_OK(iree_arena_block_pool_reserve_slab(&block_pool, &params));
+
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(&block_pool, &arena);
+  for (int i = 0; i < 16; ++i) {
+    void* ptr = NULL;
+    IREE_ASSERT_OK(iree_arena_allocate(&arena, 1024, &ptr));
+    EXPECT_TRUE(IsSlabBlock(&block_pool, ptr));
+    memset(ptr, i, 1024);
+  }
+  iree_arena_deinitialize(&arena);
+
+  iree_arena_block_pool_deinitialize(&block_pool);
+}
+
+}  // namespace
@@ -35,6 +35,7 @@
 #define IREE_HWCAP_FP (1 << 0)
 #define IREE_HWCAP_ATOMICS (1 << 8)
 #define IREE_HWCAP_ASIMDHP (1 << 10)
+#define IREE_HWCAP_CPUID (1 << 11)
 #define IREE_HWCAP_ASIMDDP (1 << 20)
 #define IREE_HWCAP_SVE (1 << 22)
 #define IREE_HWCAP_ASIMDFHM (1 << 23)
@@ -96,6 +97,17 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
                  IREE_HWCAP2_SME_F64F64);
   IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_ARM_64_SME_I16I64, hwcap2,
                  IREE_HWCAP2_SME_I16I64);
+
+  // With HWCAP_CPUID the kernel emulates EL0 reads of the ID registers.
+  if (hwcap & IREE_HWCAP_CPUID) {
+    uint64_t midr = 0;
+    __asm__ volatile("mrs %0, MIDR_EL1" : "=r"(midr));
+    uint64_t implementer = (midr >> 24) & 0xFF;
+    uint64_t partnum = (midr >> 4) & 0xFFF;
+    out_fields[7] =
+        (implementer << IREE_CPU_DATA7_ARM_64_IMPLEMENTER_SHIFT) |
+        (partnum << IREE_CPU_DATA7_ARM_64_PARTNUM_SHIFT);
+  }
 }
 
 #elif defined(IREE_PLATFORM_MACOS) || defined(IREE_PLATFORM_IOS)
@@ -177,6 +189,11 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
 #include <intrin.h>
 #endif
 
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
 typedef struct iree_cpuid_regs_t {
   uint32_t eax;
   uint32_t ebx;
@@ -240,6 +257,24 @@ static bool iree_cpuid_is_in_range(uint32_t eax, uint32_t ecx,
   return true;
 }
 
+// Returns true if the OS allows this process to use the AMX TILEDATA state.
+// Linux (5.16+) requires each process to opt in before touching the tile
+// registers: the state is large (8KiB) and is not part of the default signal
+// frame, so the first AMX instruction faults unless permission was requested
+// with arch_prctl(ARCH_REQ_XCOMP_PERM). Other OSes enable it when XCR0 does.
+static bool iree_cpu_request_amx_permission(void) {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+  // Defined locally as older kernel headers lack them.
+  const int IREE_ARCH_REQ_XCOMP_PERM = 0x1023;
+  const unsigned long IREE_XFEATURE_XTILEDATA = 18;
+  // Idempotent: requesting an already-granted permission succeeds.
+  return syscall(SYS_arch_prctl, IREE_ARCH_REQ_XCOMP_PERM,
+                 IREE_XFEATURE_XTILEDATA) == 0;
+#else
+  return true;
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+}
+
 static iree_cpuid_regs_t iree_cpuid_or_zero(uint32_t eax, uint32_t ecx,
                                             iree_cpuid_bounds_t bounds) {
   if (!iree_cpuid_is_in_range(eax, ecx, bounds)) {
@@ -248,8 +283,37 @@ static iree_cpuid_regs_t iree_cpuid_or_zero(uint32_t eax, uint32_t ecx,
   return iree_cpuid_raw(eax, ecx);
 }
 
+// Returns the processor identification value for data field 7.
+static uint64_t iree_cpu_identify_x86_64(iree_cpuid_regs_t leaf0,
+                                                   iree_cpuid_regs_t leaf1) {
+  uint64_t vendor = 0;
+  if (leaf0.ebx == 0x756e6547 && leaf0.edx == 0x49656e69 &&
+      leaf0.ecx == 0x6c65746e) {
+    vendor = IREE_CPU_DATA7_X86_64_VENDOR_INTEL;  // "GenuineIntel"
+  } else if (leaf0.ebx == 0x68747541 && leaf0.edx == 0x69746e65 &&
+             leaf0.ecx == 0x444d4163) {
+    vendor = IREE_CPU_DATA7_X86_64_VENDOR_AMD;  // "AuthenticAMD"
+  }
+  if (!vendor || !leaf1.eax) return 0;
+  // Display family and model, as in the Intel Architectures Software
+  // Developer's Manual, Vol. 2A, Figure 3-6 "Version Information Returned by
+  // CPUID in EAX".
+  uint64_t family = (leaf1.eax >> 8) & 0xF;
+  uint64_t model = (leaf1.eax >> 4) & 0xF;
+  if (family == 0x6 || family == 0xF) {
+    model |= ((leaf1.eax >> 16) & 0xF) << 4;
+  }
+  if (family == 0xF) {
+    family += (leaf1.eax >> 20) & 0xFF;
+  }
+  return (vendor << IREE_CPU_DATA7_X86_64_VENDOR_SHIFT) |
+         (family << IREE_CPU_DATA7_X86_64_FAMILY_SHIFT) |
+         (model << IREE_CPU_DATA7_X86_64_MODEL_SHIFT);
+}
+
 static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
   iree_cpuid_bounds_t bounds = iree_cpuid_query_bounds();
+  iree_cpuid_regs_t leaf0 = iree_cpuid_raw(0, 0);
   iree_cpuid_regs_t leaf1 = iree_cpuid_or_zero(1, 0, bounds);
   iree_cpuid_regs_t leaf7_0 = iree_cpuid_or_zero(7, 0, bounds);
   iree_cpuid_regs_t leaf7_1 = iree_cpuid_or_zero(7, 1, bounds);
@@ -300,14 +364,28 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
                    1 << 23);
   }
 
-  // Features that depend on AMX TILE state being enabled by the OS.
-  if (iree_all_bits_set(leafD.eax, 0x60000)) {
+  // Features that depend on AMX TILE state being enabled by the OS and, where
+  // required, permitted for this process.
+  if (iree_all_bits_set(leafD.eax, 0x60000) &&
+      iree_all_bits_set(leaf7_0.edx, 1 << 24) &&
+      iree_cpu_request_amx_permission()) {
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXTILE, leaf7_0.edx, 1 << 24);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXINT8, leaf7_0.edx, 1 << 25);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXBF16, leaf7_0.edx, 1 << 22);
   }
 
   out_fields[0] = out0;
+  out_fields[7] = iree_cpu_identify_x86_64(leaf0, leaf1);
+}
+
+#elif defined(IREE_ARCH_WASM_32)
+
+static void iree_cpu_initialize_from_platform_wasm_32(uint64_t* out_fields) {
+  // The engine has no way to report its features. A runtime built with SIMD
+  // only ever gets this far on engines that validated its SIMD instructions.
+#if defined(__wasm_simd128__)
+  out_fields[0] |= IREE_CPU_DATA0_WASM_32_SIMD128;
+#endif  // defined(__wasm_simd128__)
 }
 
 #endif  // defined(IREE_ARCH_ARM_64)
@@ -318,6 +396,8 @@ static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
   iree_cpu_initialize_from_platform_arm_64(out_fields);
 #elif defined(IREE_ARCH_X86_64)
   iree_cpu_initialize_from_platform_x86_64(out_fields);
+#elif defined(IREE_ARCH_WASM_32)
+  iree_cpu_initialize_from_platform_wasm_32(out_fields);
 #else
   // No implementation available. CPU data will be all zeros.
 #endif  // defined(IREE_ARCH_ARM_64)
@@ -104,3 +104,16 @@ void iree_fpu_state_pop(iree_fpu_state_t state) {
     iree_fpu_store_state(state.previous_value);
   }
 }
+
+void iree_fpu_state_switch(iree_fpu_state_flags_t flags,
+                           iree_fpu_state_flags_t* inout_flags) {
+  if (flags == *inout_flags) return;
+  uint64_t previous_value = iree_fpu_load_state();
+  uint64_t current_value = iree_fpu_state_set_dtz(
+      previous_value,
+      (flags & IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO) ? true : false);
+  if (previous_value != current_value) {
+    iree_fpu_store_state(current_value);
+  }
+  *inout_flags = flags;
+}
@@ -51,6 +51,14 @@ iree_fpu_state_t iree_fpu_state_push(iree_fpu_state_flags_t flags);
 // May lead to a pipeline flush; avoid if possible.
 void iree_fpu_state_pop(iree_fpu_state_t state);
 
+// Switches the FPU state of the current thread to |flags| if they differ from
+// |*inout_flags|, the flags the thread was last switched to, and updates the
+// tracked flags. Threads that execute runs of work with the same requirements
+// pay no cost as the control register is neither read nor written.
+// May lead to a pipeline flush when the state changes.
+void iree_fpu_state_switch(iree_fpu_state_flags_t flags,
+                           iree_fpu_state_flags_t* inout_flags);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
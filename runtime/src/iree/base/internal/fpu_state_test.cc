@@ -25,4 +25,32 @@ TEST(FPUStateTest, FlushDenormalsToZero) {
   iree_fpu_state_pop(fpu_state);
 }
 
+// Tests that switching updates the tracked flags and applies the state.
+TEST(FPUStateTest, SwitchFlushDenormalsToZero) {
+  iree_fpu_state_t fpu_state = iree_fpu_state_push(IREE_FPU_STATE_DEFAULT);
+  iree_fpu_state_flags_t current_flags = IREE_FPU_STATE_DEFAULT;
+
+  iree_fpu_state_switch(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO,
+                        &current_flags);
+  EXPECT_EQ(
+      (iree_fpu_state_flags_t)IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO,
+      current_flags);
+  float f = 1.0f;
+  volatile float* fp = &f;
+  *fp = *fp * 1e-39f;
+  EXPECT_EQ(0.0f, f);
+
+  // Switching to the current flags is a no-op.
+  iree_fpu_state_switch(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO,
+                        &current_flags);
+  EXPECT_EQ(
+      (iree_fpu_state_flags_t)IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO,
+      current_flags);
+
+  iree_fpu_state_switch(IREE_FPU_STATE_DEFAULT, &current_flags);
+  EXPECT_EQ((iree_fpu_state_flags_t)IREE_FPU_STATE_DEFAULT, current_flags);
+
+  iree_fpu_state_pop(fpu_state);
+}
+
 }  // namespace
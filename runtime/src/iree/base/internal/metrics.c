@@ -0,0 +1,292 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/metrics.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+
+int64_t iree_metric_histogram_bucket_upper_bound(
+    iree_host_size_t bucket_index) {
+  if (bucket_index == 0) return 0;
+  if (bucket_index >= IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1) return INT64_MAX;
+  return (INT64_C(1) << bucket_index) - 1;
+}
+
+#if IREE_METRICS_ENABLE
+
+//===----------------------------------------------------------------------===//
+// Process registry
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_metric_registry_t {
+  iree_slim_mutex_t mutex;
+  // Singly-linked list of registered metrics with metrics of the same name
+  // kept adjacent to one another.
+  iree_metric_t* head IREE_GUARDED_BY(mutex);
+} iree_metric_registry_t;
+
+static iree_metric_registry_t iree_metric_registry_;
+static iree_once_flag iree_metric_registry_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_metric_registry_initialize(void) {
+  iree_slim_mutex_initialize(&iree_metric_registry_.mutex);
+}
+
+static iree_metric_registry_t* iree_metric_registry(void) {
+  iree_call_once(&iree_metric_registry_flag_, iree_metric_registry_initialize);
+  return &iree_metric_registry_;
+}
+
+// Links |metric| into the registry list after the last metric with the same
+// name or at the end of the list if there is none.
+// Requires the registry lock to be held.
+static void iree_metric_registry_link(iree_metric_registry_t* registry,
+                                      iree_metric_t* metric) {
+  iree_metric_t** insert_point = &registry->head;
+  iree_metric_t** last_named = NULL;
+  for (iree_metric_t** it = &registry->head; *it; it = &(*it)->next) {
+    if (strcmp((*it)->name, metric->name) == 0) last_named = &(*it)->next;
+    insert_point = &(*it)->next;
+  }
+  if (last_named) insert_point = last_named;
+  metric->next = *insert_point;
+  *insert_point = metric;
+}
+
+void iree_metric_register(iree_metric_t* metric) {
+  iree_metric_registry_t* registry = iree_metric_registry();
+  iree_slim_mutex_lock(&registry->mutex);
+  if (!iree_atomic_load_int32(&metric->registered,
+                              iree_memory_order_relaxed)) {
+    iree_metric_registry_link(registry, metric);
+    iree_atomic_store_int32(&metric->registered, 1, iree_memory_order_release);
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+}
+
+void iree_metric_initialize(iree_metric_kind_t kind, const char* name,
+                            const char* help, iree_string_view_t labels,
+                            iree_metric_t* out_metric) {
+  memset(out_metric, 0, sizeof(*out_metric));
+  out_metric->kind = kind;
+  out_metric->name = name;
+  out_metric->help = help;
+  iree_string_view_t truncated_labels = iree_string_view_substr(
+      labels, 0, IREE_ARRAYSIZE(out_metric->labels) - 1);
+  memcpy(out_metric->labels, truncated_labels.data, truncated_labels.size);
+  iree_metric_register(out_metric);
+}
+
+void iree_metric_deinitialize(iree_metric_t* metric) {
+  if (!metric) return;
+  iree_metric_registry_t* registry = iree_metric_registry();
+  iree_slim_mutex_lock(&registry->mutex);
+  for (iree_metric_t** it = &registry->head; *it; it = &(*it)->next) {
+    if (*it == metric) {
+      *it = metric->next;
+      break;
+    }
+  }
+  metric->next = NULL;
+  iree_atomic_store_int32(&metric->registered, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_unlock(&registry->mutex);
+}
+
+void iree_metric_record(iree_metric_t* metric, int64_t value) {
+  iree_metric_ensure_registered(metric);
+  iree_host_size_t bucket_index =
+      value <= 0 ? 0 : 64 - iree_math_count_leading_zeros_u64((uint64_t)value);
+  bucket_index = iree_min(bucket_index, IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1);
+  iree_atomic_fetch_add_int64(&metric->buckets[bucket_index], 1,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&metric->value, value,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&metric->peak_or_count, 1,
+                              iree_memory_order_relaxed);
+}
+
+//===----------------------------------------------------------------------===//
+// Registry queries
+//===----------------------------------------------------------------------===//
+
+static void iree_metric_snapshot(iree_metric_t* metric,
+                                 iree_metric_snapshot_t* out_snapshot) {
+  memset(out_snapshot, 0, sizeof(*out_snapshot));
+  out_snapshot->kind = metric->kind;
+  out_snapshot->name = iree_make_cstring_view(metric->name);
+  out_snapshot->help = iree_make_cstring_view(metric->help);
+  out_snapshot->labels = iree_make_cstring_view(metric->labels);
+  out_snapshot->value =
+      iree_atomic_load_int64(&metric->value, iree_memory_order_relaxed);
+  int64_t peak_or_count =
+      iree_atomic_load_int64(&metric->peak_or_count, iree_memory_order_relaxed);
+  switch (metric->kind) {
+    case IREE_METRIC_KIND_GAUGE:
+      out_snapshot->peak = peak_or_count;
+      break;
+    case IREE_METRIC_KIND_HISTOGRAM:
+      out_snapshot->count = peak_or_count;
+      for (iree_host_size_t i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT;
+           ++i) {
+        out_snapshot->buckets[i] = iree_atomic_load_int64(
+            &metric->buckets[i], iree_memory_order_relaxed);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+iree_status_t iree_metrics_enumerate(iree_metric_visit_fn_t visit_fn,
+                                     void* user_data) {
+  IREE_ASSERT_ARGUMENT(visit_fn);
+  iree_metric_registry_t* registry = iree_metric_registry();
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&registry->mutex);
+  for (iree_metric_t* metric = registry->head;
+       metric && iree_status_is_ok(status); metric = metric->next) {
+    iree_metric_snapshot_t snapshot;
+    iree_metric_snapshot(metric, &snapshot);
+    status = visit_fn(user_data, &snapshot);
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+  return status;
+}
+
+static const char* iree_metric_kind_prometheus_type(iree_metric_kind_t kind) {
+  switch (kind) {
+    case IREE_METRIC_KIND_COUNTER:
+      return "counter";
+    case IREE_METRIC_KIND_GAUGE:
+      return "gauge";
+    case IREE_METRIC_KIND_HISTOGRAM:
+      return "histogram";
+    default:
+      return "untyped";
+  }
+}
+
+// Appends `{labels}` or `{labels,extra}` to |builder| with empty braces
+// omitted.
+static iree_status_t iree_metric_format_labels(iree_string_builder_t* builder,
+                                               iree_string_view_t labels,
+                                               const char* extra) {
+  if (iree_string_view_is_empty(labels) && !extra) return iree_ok_status();
+  return iree_string_builder_append_format(
+      builder, "{%.*s%s%s}", (int)labels.size, labels.data,
+      !iree_string_view_is_empty(labels) && extra ? "," : "",
+      extra ? extra : "");
+}
+
+static iree_status_t iree_metric_format_prometheus_sample(
+    iree_string_builder_t* builder, const iree_metric_snapshot_t* snapshot) {
+  const iree_string_view_t name = snapshot->name;
+  if (snapshot->kind != IREE_METRIC_KIND_HISTOGRAM) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_string(builder, name));
+    IREE_RETURN_IF_ERROR(
+        iree_metric_format_labels(builder, snapshot->labels, NULL));
+    return iree_string_builder_append_format(builder, " %" PRId64 "\n",
+                                             snapshot->value);
+  }
+  int64_t cumulative_count = 0;
+  for (iree_host_size_t i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+    cumulative_count += snapshot->buckets[i];
+    char le[32];
+    if (i == IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1) {
+      snprintf(le, sizeof(le), "le=\"+Inf\"");
+    } else {
+      snprintf(le, sizeof(le), "le=\"%" PRId64 "\"",
+               iree_metric_histogram_bucket_upper_bound(i));
+    }
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%.*s_bucket", (int)name.size, name.data));
+    IREE_RETURN_IF_ERROR(
+        iree_metric_format_labels(builder, snapshot->labels, le));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, " %" PRId64 "\n", cumulative_count));
+  }
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "%.*s_sum", (int)name.size, name.data));
+  IREE_RETURN_IF_ERROR(
+      iree_metric_format_labels(builder, snapshot->labels, NULL));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, " %" PRId64 "\n", snapshot->value));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "%.*s_count", (int)name.size, name.data));
+  IREE_RETURN_IF_ERROR(
+      iree_metric_format_labels(builder, snapshot->labels, NULL));
+  return iree_string_builder_append_format(builder, " %" PRId64 "\n",
+                                           cumulative_count);
+}
+
+// Formats the run of metrics starting at |first| that share its name and
+// returns the metric following the run in |out_next|.
+static iree_status_t iree_metric_format_prometheus_family(
+    iree_string_builder_t* builder, iree_metric_t* first,
+    iree_metric_t** out_next) {
+  iree_metric_t* end = first->next;
+  while (end && strcmp(end->name, first->name) == 0) end = end->next;
+  *out_next = end;
+
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "# HELP %s %s\n# TYPE %s %s\n", first->name, first->help,
+      first->name, iree_metric_kind_prometheus_type(first->kind)));
+  for (iree_metric_t* metric = first; metric != end; metric = metric->next) {
+    iree_metric_snapshot_t snapshot;
+    iree_metric_snapshot(metric, &snapshot);
+    IREE_RETURN_IF_ERROR(
+        iree_metric_format_prometheus_sample(builder, &snapshot));
+  }
+  if (first->kind != IREE_METRIC_KIND_GAUGE) return iree_ok_status();
+
+  // High-water marks are exported as their own gauge family.
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "# HELP %s_peak High-water mark of %s.\n# TYPE %s_peak gauge\n",
+      first->name, first->name, first->name));
+  for (iree_metric_t* metric = first; metric != end; metric = metric->next) {
+    iree_metric_snapshot_t snapshot;
+    iree_metric_snapshot(metric, &snapshot);
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%s_peak", first->name));
+    IREE_RETURN_IF_ERROR(
+        iree_metric_format_labels(builder, snapshot.labels, NULL));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, " %" PRId64 "\n", snapshot.peak));
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_metrics_format_prometheus(iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_metric_registry_t* registry = iree_metric_registry();
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&registry->mutex);
+  iree_metric_t* metric = registry->head;
+  while (metric && iree_status_is_ok(status)) {
+    status = iree_metric_format_prometheus_family(builder, metric, &metric);
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+  return status;
+}
+
+#else
+
+iree_status_t iree_metrics_enumerate(iree_metric_visit_fn_t visit_fn,
+                                     void* user_data) {
+  return iree_ok_status();
+}
+
+iree_status_t iree_metrics_format_prometheus(iree_string_builder_t* builder) {
+  return iree_ok_status();
+}
+
+#endif  // IREE_METRICS_ENABLE
@@ -0,0 +1,199 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Lightweight always-on runtime metrics.
+//
+// Unlike tracing (which requires a tracing provider and is compiled out of
+// production builds) metrics are cheap enough to leave enabled everywhere:
+// updates are a handful of relaxed atomic operations on storage owned by the
+// instrumented code and there is no buffering, allocation, or locking on the
+// hot path. Hosting applications poll the process-wide registry to snapshot
+// all live metrics or format them in the Prometheus text exposition format for
+// exporting to fleet monitoring.
+//
+// Metrics are either process-wide statics declared with IREE_METRIC_STATIC
+// and registered lazily on first update or embedded in a resource (such as a
+// device queue) with per-instance labels and explicitly initialized and
+// deinitialized along with the resource:
+//
+//   IREE_METRIC_STATIC(my_metric, IREE_METRIC_KIND_COUNTER,
+//                      "iree_my_things_total", "Things done.");
+//   iree_metric_add(&my_metric, 1);
+//
+// Metrics may be compiled out entirely with -DIREE_METRICS_ENABLE=0 in which
+// case updates are no-ops and the registry is always empty.
+
+#ifndef IREE_BASE_INTERNAL_METRICS_H_
+#define IREE_BASE_INTERNAL_METRICS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_metric_t
+//===----------------------------------------------------------------------===//
+
+// Number of log2 buckets tracked by histogram metrics. Bucket i counts values
+// in [2^(i-1), 2^i) with bucket 0 counting values <= 0 and the last bucket
+// counting all values that would have overflowed.
+#define IREE_METRIC_HISTOGRAM_BUCKET_COUNT 40
+
+// Maximum length of the labels of a metric including the NUL terminator.
+#define IREE_METRIC_MAX_LABELS_LENGTH 96
+
+typedef enum iree_metric_kind_e {
+  // Monotonically increasing total (dispatches issued, workers parked, etc).
+  IREE_METRIC_KIND_COUNTER = 0,
+  // Instantaneous value that may go up or down (bytes in use, queue depth).
+  // The high-water mark of the value is tracked alongside it.
+  IREE_METRIC_KIND_GAUGE = 1,
+  // Distribution of recorded values (durations in nanoseconds, sizes).
+  IREE_METRIC_KIND_HISTOGRAM = 2,
+} iree_metric_kind_t;
+
+// A single metric. Storage is owned by the instrumented code and must remain
+// valid while the metric is registered.
+typedef struct iree_metric_t {
+  // Next metric in the registry list. Guarded by the registry lock.
+  struct iree_metric_t* next;
+  // Nonzero once the metric has been added to the registry.
+  iree_atomic_int32_t registered;
+  iree_metric_kind_t kind;
+  // Metric name following the Prometheus naming conventions. Must have static
+  // storage duration.
+  const char* name;
+  // Human-readable description. Must have static storage duration.
+  const char* help;
+  // Comma-separated Prometheus labels (`device="local-task",queue="0"`) or
+  // empty if the metric is unlabeled.
+  char labels[IREE_METRIC_MAX_LABELS_LENGTH];
+  // Counter total, gauge value, or histogram sum.
+  iree_atomic_int64_t value;
+  // Gauge high-water mark or histogram sample count.
+  iree_atomic_int64_t peak_or_count;
+  // Histogram bucket counts; unused by other kinds.
+  iree_atomic_int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT];
+} iree_metric_t;
+
+#if IREE_METRICS_ENABLE
+
+// Declares a process-wide metric |symbol| registered on its first update.
+#define IREE_METRIC_STATIC(symbol, metric_kind, metric_name, metric_help) \
+  static iree_metric_t symbol = {                                         \
+      .kind = (metric_kind),                                              \
+      .name = (metric_name),                                              \
+      .help = (metric_help),                                              \
+  }
+
+// Initializes an embedded metric and registers it with the process registry.
+// |labels| is copied and truncated to IREE_METRIC_MAX_LABELS_LENGTH - 1.
+void iree_metric_initialize(iree_metric_kind_t kind, const char* name,
+                            const char* help, iree_string_view_t labels,
+                            iree_metric_t* out_metric);
+
+// Unregisters an embedded metric. The storage may be freed after this returns.
+void iree_metric_deinitialize(iree_metric_t* metric);
+
+// Registers |metric| if it has not yet been registered. Slow path of updates
+// to static metrics; callers should use the update functions below.
+void iree_metric_register(iree_metric_t* metric);
+
+static inline void iree_metric_ensure_registered(iree_metric_t* metric) {
+  if (IREE_UNLIKELY(!iree_atomic_load_int32(&metric->registered,
+                                            iree_memory_order_acquire))) {
+    iree_metric_register(metric);
+  }
+}
+
+// Adds |delta| to a counter or gauge. Gauges update their high-water mark.
+static inline void iree_metric_add(iree_metric_t* metric, int64_t delta) {
+  iree_metric_ensure_registered(metric);
+  int64_t value = iree_atomic_fetch_add_int64(&metric->value, delta,
+                                              iree_memory_order_relaxed) +
+                  delta;
+  if (metric->kind != IREE_METRIC_KIND_GAUGE) return;
+  int64_t peak =
+      iree_atomic_load_int64(&metric->peak_or_count, iree_memory_order_relaxed);
+  while (value > peak &&
+         !iree_atomic_compare_exchange_weak_int64(
+             &metric->peak_or_count, &peak, value, iree_memory_order_relaxed,
+             iree_memory_order_relaxed)) {
+  }
+}
+
+// Records |value| into a histogram.
+void iree_metric_record(iree_metric_t* metric, int64_t value);
+
+#else
+
+#define IREE_METRIC_STATIC(symbol, metric_kind, metric_name, metric_help) \
+  static iree_metric_t symbol
+
+static inline void iree_metric_initialize(iree_metric_kind_t kind,
+                                          const char* name, const char* help,
+                                          iree_string_view_t labels,
+                                          iree_metric_t* out_metric) {}
+static inline void iree_metric_deinitialize(iree_metric_t* metric) {}
+static inline void iree_metric_add(iree_metric_t* metric, int64_t delta) {}
+static inline void iree_metric_record(iree_metric_t* metric, int64_t value) {}
+
+#endif  // IREE_METRICS_ENABLE
+
+//===----------------------------------------------------------------------===//
+// Registry queries
+//===----------------------------------------------------------------------===//
+
+// A point-in-time copy of a metric.
+// Fields are sampled with relaxed atomics and may tear across one another when
+// the metric is concurrently updated (the histogram count may not exactly
+// match the sum of its buckets, etc).
+typedef struct iree_metric_snapshot_t {
+  iree_metric_kind_t kind;
+  iree_string_view_t name;
+  iree_string_view_t help;
+  iree_string_view_t labels;
+  // Counter total, gauge value, or histogram sum.
+  int64_t value;
+  // Gauge high-water mark.
+  int64_t peak;
+  // Histogram sample count and per-bucket counts.
+  int64_t count;
+  int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT];
+} iree_metric_snapshot_t;
+
+// Callback issued for each registered metric. The snapshot is only valid for
+// the duration of the call. Returning a failure stops the enumeration and is
+// propagated to the caller.
+typedef iree_status_t (*iree_metric_visit_fn_t)(
+    void* user_data, const iree_metric_snapshot_t* snapshot);
+
+// Snapshots each registered metric and calls |visit_fn| with it. Metrics with
+// the same name are visited consecutively. The registry is locked during the
+// enumeration and |visit_fn| must not initialize or deinitialize metrics.
+iree_status_t iree_metrics_enumerate(iree_metric_visit_fn_t visit_fn,
+                                     void* user_data);
+
+// Appends all registered metrics to |builder| in the Prometheus text
+// exposition format. Gauge high-water marks are exported as `<name>_peak`.
+iree_status_t iree_metrics_format_prometheus(iree_string_builder_t* builder);
+
+// Returns the upper bound (inclusive) of histogram bucket |bucket_index| or
+// INT64_MAX for the last bucket.
+int64_t iree_metric_histogram_bucket_upper_bound(
+    iree_host_size_t bucket_index);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_METRICS_H_
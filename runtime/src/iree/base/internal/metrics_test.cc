@@ -0,0 +1,168 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/metrics.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if IREE_METRICS_ENABLE
+
+namespace {
+
+// Returns snapshots of all registered metrics named |name|.
+std::vector<iree_metric_snapshot_t> QueryMetrics(const char* name) {
+  struct State {
+    iree_string_view_t name;
+    std::vector<iree_metric_snapshot_t> snapshots;
+  } state = {iree_make_cstring_view(name), {}};
+  IREE_CHECK_OK(iree_metrics_enumerate(
+      +[](void* user_data, const iree_metric_snapshot_t* snapshot) {
+        auto* state = reinterpret_cast<State*>(user_data);
+        if (iree_string_view_equal(snapshot->name, state->name)) {
+          state->snapshots.push_back(*snapshot);
+        }
+        return iree_ok_status();
+      },
+      &state));
+  return state.snapshots;
+}
+
+std::string FormatPrometheus() {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  IREE_CHECK_OK(iree_metrics_format_prometheus(&builder));
+  std::string result(iree_string_builder_buffer(&builder),
+                     iree_string_builder_size(&builder));
+  iree_string_builder_deinitialize(&builder);
+  return result;
+}
+
+TEST(MetricsTest, Counter) {
+  iree_metric_t metric;
+  iree_metric_initialize(IREE_METRIC_KIND_COUNTER, "test_counter_total",
+                         "Counter.", iree_string_view_empty(), &metric);
+  iree_metric_add(&metric, 1);
+  iree_metric_add(&metric, 2);
+  auto snapshots = QueryMetrics("test_counter_total");
+  ASSERT_EQ(snapshots.size(), 1);
+  EXPECT_EQ(snapshots[0].kind, IREE_METRIC_KIND_COUNTER);
+  EXPECT_EQ(snapshots[0].value, 3);
+  iree_metric_deinitialize(&metric);
+  EXPECT_TRUE(QueryMetrics("test_counter_total").empty());
+}
+
+TEST(MetricsTest, GaugeTracksPeak) {
+  iree_metric_t metric;
+  iree_metric_initialize(IREE_METRIC_KIND_GAUGE, "test_gauge", "Gauge.",
+                         IREE_SV("queue=\"0\""), &metric);
+  iree_metric_add(&metric, 5);
+  iree_metric_add(&metric, -3);
+  iree_metric_add(&metric, 1);
+  auto snapshots = QueryMetrics("test_gauge");
+  ASSERT_EQ(snapshots.size(), 1);
+  EXPECT_EQ(snapshots[0].value, 3);
+  EXPECT_EQ(snapshots[0].peak, 5);
+  EXPECT_TRUE(
+      iree_string_view_equal(snapshots[0].labels, IREE_SV("queue=\"0\"")));
+  iree_metric_deinitialize(&metric);
+}
+
+TEST(MetricsTest, HistogramBuckets) {
+  iree_metric_t metric;
+  iree_metric_initialize(IREE_METRIC_KIND_HISTOGRAM, "test_histogram",
+                         "Histogram.", iree_string_view_empty(), &metric);
+  iree_metric_record(&metric, 0);
+  iree_metric_record(&metric, 1);
+  iree_metric_record(&metric, 3);
+  iree_metric_record(&metric, INT64_MAX);
+  auto snapshots = QueryMetrics("test_histogram");
+  ASSERT_EQ(snapshots.size(), 1);
+  const auto& snapshot = snapshots[0];
+  EXPECT_EQ(snapshot.count, 4);
+  EXPECT_EQ(snapshot.buckets[0], 1);  // <= 0
+  EXPECT_EQ(snapshot.buckets[1], 1);  // [1, 2)
+  EXPECT_EQ(snapshot.buckets[2], 1);  // [2, 4)
+  EXPECT_EQ(snapshot.buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1], 1);
+  EXPECT_EQ(iree_metric_histogram_bucket_upper_bound(2), 3);
+  iree_metric_deinitialize(&metric);
+}
+
+IREE_METRIC_STATIC(test_static_metric, IREE_METRIC_KIND_COUNTER,
+                   "test_static_total", "Static counter.");
+
+TEST(MetricsTest, StaticRegisteredOnFirstUse) {
+  EXPECT_TRUE(QueryMetrics("test_static_total").empty());
+  iree_metric_add(&test_static_metric, 1);
+  auto snapshots = QueryMetrics("test_static_total");
+  ASSERT_EQ(snapshots.size(), 1);
+  EXPECT_EQ(snapshots[0].value, 1);
+}
+
+TEST(MetricsTest, ConcurrentUpdates) {
+  iree_metric_t metric;
+  iree_metric_initialize(IREE_METRIC_KIND_GAUGE, "test_concurrent", "Gauge.",
+                         iree_string_view_empty(), &metric);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&metric]() {
+      for (int j = 0; j < 1000; ++j) iree_metric_add(&metric, 1);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  auto snapshots = QueryMetrics("test_concurrent");
+  ASSERT_EQ(snapshots.size(), 1);
+  EXPECT_EQ(snapshots[0].value, 4000);
+  EXPECT_EQ(snapshots[0].peak, 4000);
+  iree_metric_deinitialize(&metric);
+}
+
+TEST(MetricsTest, FormatPrometheus) {
+  iree_metric_t gauge_a, gauge_b, histogram;
+  iree_metric_initialize(IREE_METRIC_KIND_GAUGE, "test_format_bytes",
+                         "Bytes.", IREE_SV("device=\"a\""), &gauge_a);
+  iree_metric_initialize(IREE_METRIC_KIND_HISTOGRAM, "test_format_ns",
+                         "Durations.", iree_string_view_empty(), &histogram);
+  iree_metric_initialize(IREE_METRIC_KIND_GAUGE, "test_format_bytes",
+                         "Bytes.", IREE_SV("device=\"b\""), &gauge_b);
+  iree_metric_add(&gauge_a, 10);
+  iree_metric_add(&gauge_b, 20);
+  iree_metric_add(&gauge_b, -5);
+  iree_metric_record(&histogram, 3);
+
+  std::string text = FormatPrometheus();
+  // Metrics of the same name are grouped under a single header.
+  EXPECT_NE(text.find("# HELP test_format_bytes Bytes.\n"
+                      "# TYPE test_format_bytes gauge\n"
+                      "test_format_bytes{device=\"a\"} 10\n"
+                      "test_format_bytes{device=\"b\"} 15\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_format_bytes_peak gauge\n"
+                      "test_format_bytes_peak{device=\"a\"} 10\n"
+                      "test_format_bytes_peak{device=\"b\"} 20\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_format_ns histogram\n"), std::string::npos);
+  EXPECT_NE(text.find("test_format_ns_bucket{le=\"1\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_format_ns_bucket{le=\"3\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_format_ns_bucket{le=\"+Inf\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_format_ns_sum 3\ntest_format_ns_count 1\n"),
+            std::string::npos);
+
+  iree_metric_deinitialize(&gauge_a);
+  iree_metric_deinitialize(&gauge_b);
+  iree_metric_deinitialize(&histogram);
+}
+
+}  // namespace
+
+#endif  // IREE_METRICS_ENABLE
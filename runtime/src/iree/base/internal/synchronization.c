@@ -93,6 +93,23 @@ static inline void iree_processor_yield(void) {
 
 #endif  // IREE_COMPILER_*
 
+// Maximum number of iree_processor_yield iterations a thread spins waiting for
+// a held lock to be released before waiting in the kernel. Locks are expected
+// to guard short critical sections and a futex wait/wake round trip costs
+// several microseconds, so a short spin usually avoids the syscalls entirely.
+#define IREE_SYNCHRONIZATION_MAX_SPIN_COUNT 256
+
+// Returns the number of iterations to spin on a held lock with |waiter_count|
+// threads (including the caller) waiting on it. Only one waiter can acquire
+// the lock when it is released so the budget shrinks as contention grows and
+// threads unlikely to win go straight to the kernel instead of burning cycles
+// and memory bandwidth competing for the cache line.
+static inline int iree_synchronization_spin_count(int32_t waiter_count) {
+  if (waiter_count <= 1) return IREE_SYNCHRONIZATION_MAX_SPIN_COUNT;
+  if (waiter_count >= 8) return 0;
+  return IREE_SYNCHRONIZATION_MAX_SPIN_COUNT / waiter_count;
+}
+
 //==============================================================================
 // Cross-platform futex mappings (where supported)
 //==============================================================================
@@ -518,6 +535,15 @@ void iree_slim_mutex_lock(iree_slim_mutex_t* mutex)
       }
     }
 
+    // Spin briefly waiting for the holder to release the lock before waiting
+    // in the kernel. The low bits of the value are the number of threads
+    // (including this one) that want the lock and the spin budget adapts to it.
+    int spin_count = iree_synchronization_spin_count(value & 0x7FFFFFFF);
+    for (int i = 0; i < spin_count && iree_slim_mutex_is_locked(value); ++i) {
+      iree_processor_yield();
+      value = iree_atomic_load_int32(&mutex->value, iree_memory_order_relaxed);
+    }
+
     // While the lock is unavailable: wait for it to become available.
     while (iree_slim_mutex_is_locked(value)) {
       // NOTE: we don't care about wait failure here as we are going to loop
@@ -587,6 +613,335 @@ void iree_slim_mutex_unlock(iree_slim_mutex_t* mutex)
 
 #endif  //  IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_SLOW_LOCKS
 
+//==============================================================================
+// iree_slim_rwlock_t
+//==============================================================================
+
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock) {}
+
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock) {}
+
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {}
+
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return true;
+}
+
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {}
+
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {}
+
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return true;
+}
+
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {}
+
+#elif (IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_FAST_LOCKS)
+
+// Route both shared and exclusive acquisition through the traced slow mutex.
+// Readers lose their concurrency but all lock usage shows up in traces.
+
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock) {
+  iree_mutex_initialize(&out_lock->impl);
+}
+
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock) {
+  iree_mutex_deinitialize(&lock->impl);
+}
+
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  iree_mutex_lock(&lock->impl);
+}
+
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return iree_mutex_try_lock(&lock->impl);
+}
+
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  iree_mutex_unlock(&lock->impl);
+}
+
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  iree_mutex_lock(&lock->impl);
+}
+
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return iree_mutex_try_lock(&lock->impl);
+}
+
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  iree_mutex_unlock(&lock->impl);
+}
+
+#elif defined(IREE_PLATFORM_WINDOWS) && defined(IREE_MUTEX_USE_WIN32_SRW)
+
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock) {
+  InitializeSRWLock(&out_lock->value);
+}
+
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock) {}
+
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  AcquireSRWLockShared(&lock->value);
+}
+
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return TryAcquireSRWLockShared(&lock->value) == TRUE;
+}
+
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  ReleaseSRWLockShared(&lock->value);
+}
+
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  AcquireSRWLockExclusive(&lock->value);
+}
+
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return TryAcquireSRWLockExclusive(&lock->value) == TRUE;
+}
+
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  ReleaseSRWLockExclusive(&lock->value);
+}
+
+#elif defined(IREE_PLATFORM_HAS_FUTEX)
+
+// The high bit of the atomic value indicates whether a writer holds the lock
+// and the low bits count the readers holding it. The remaining bit indicates
+// that one or more threads are (or are about to be) waiting in the kernel; it
+// is only ever set while the lock is held and is cleared by the last thread
+// releasing the lock, which then wakes all waiters to compete for it again.
+// New readers wait while the waiter bit is set so that waiting writers are not
+// starved by a continuous stream of overlapping readers.
+//
+// Refer to the iree_slim_mutex_t struct comment, "Notes on atomics", for the
+// choice of memory orders: acquisitions are acquire and releases are release.
+
+#define IREE_SLIM_RWLOCK_WRITER ((int32_t)0x80000000u)
+#define IREE_SLIM_RWLOCK_WAITERS ((int32_t)0x40000000u)
+#define IREE_SLIM_RWLOCK_READER_MASK ((int32_t)0x3FFFFFFFu)
+
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock) {
+  memset(out_lock, 0, sizeof(*out_lock));
+}
+
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock) {
+  // Assert unlocked (callers must ensure the lock is no longer in use).
+  SYNC_ASSERT(iree_atomic_load_int32(&lock->value, iree_memory_order_acquire) ==
+              0);
+}
+
+// Helper to perform a compare_exchange operation acquiring |lock|.
+static bool iree_slim_rwlock_try_acquire_compare_exchange(
+    iree_slim_rwlock_t* lock, int32_t* expected,
+    int32_t desired) IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return iree_atomic_compare_exchange_weak_int32(
+      &lock->value, expected, desired, iree_memory_order_acquire,
+      iree_memory_order_relaxed);
+}
+
+// Marks |lock| as having waiters and waits in the kernel until its value
+// changes from |value|. Returns early if the value changed before waiting;
+// callers must reload the value and retry acquisition either way.
+static void iree_slim_rwlock_wait(iree_slim_rwlock_t* lock, int32_t value) {
+  int32_t waiting_value = value | IREE_SLIM_RWLOCK_WAITERS;
+  if (value != waiting_value &&
+      !iree_atomic_compare_exchange_weak_int32(&lock->value, &value,
+                                               waiting_value,
+                                               iree_memory_order_relaxed,
+                                               iree_memory_order_relaxed)) {
+    return;
+  }
+  // NOTE: we don't care about wait failure here as we are going to loop and
+  // check again anyway.
+  iree_futex_wait(&lock->value, (uint32_t)waiting_value,
+                  IREE_TIME_INFINITE_FUTURE);
+}
+
+// Spins on |lock| while |busy_mask| bits are set in |value| unless there are
+// already waiters in the kernel (in which case the holder is likely not going
+// to release the lock soon). Returns the last loaded value.
+static int32_t iree_slim_rwlock_spin(iree_slim_rwlock_t* lock, int32_t value,
+                                     int32_t busy_mask) {
+  if (value & IREE_SLIM_RWLOCK_WAITERS) return value;
+  for (int i = 0;
+       i < IREE_SYNCHRONIZATION_MAX_SPIN_COUNT && (value & busy_mask); ++i) {
+    iree_processor_yield();
+    value = iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  }
+  return value;
+}
+
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  const int32_t busy_mask = IREE_SLIM_RWLOCK_WRITER | IREE_SLIM_RWLOCK_WAITERS;
+  int32_t value =
+      iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  bool did_spin = false;
+  while (true) {
+    if (!(value & busy_mask)) {
+      // Add this thread as a reader; on failure |value| is reloaded.
+      if (iree_slim_rwlock_try_acquire_compare_exchange(lock, &value,
+                                                        value + 1)) {
+        return;
+      }
+      continue;
+    }
+    if (!did_spin) {
+      did_spin = true;
+      value = iree_slim_rwlock_spin(lock, value, busy_mask);
+      continue;
+    }
+    iree_slim_rwlock_wait(lock, value);
+    value = iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  }
+}
+
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  const int32_t busy_mask = IREE_SLIM_RWLOCK_WRITER | IREE_SLIM_RWLOCK_WAITERS;
+  int32_t value =
+      iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  while (!(value & busy_mask)) {
+    if (iree_slim_rwlock_try_acquire_compare_exchange(lock, &value,
+                                                      value + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  // Remove this thread as a reader. The last reader clears the waiter bit and
+  // wakes all waiters.
+  int32_t value =
+      iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  int32_t new_value = 0;
+  do {
+    new_value = value - 1;
+    if ((new_value & IREE_SLIM_RWLOCK_READER_MASK) == 0) new_value = 0;
+  } while (!iree_atomic_compare_exchange_weak_int32(
+      &lock->value, &value, new_value, iree_memory_order_release,
+      iree_memory_order_relaxed));
+  if ((value & IREE_SLIM_RWLOCK_WAITERS) &&
+      !(new_value & IREE_SLIM_RWLOCK_WAITERS)) {
+    iree_futex_wake(&lock->value, IREE_ALL_WAITERS);
+  }
+}
+
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  int32_t value = 0;
+  if (iree_slim_rwlock_try_acquire_compare_exchange(lock, &value,
+                                                    IREE_SLIM_RWLOCK_WRITER)) {
+    return;  // uncontended
+  }
+  bool did_spin = false;
+  while (true) {
+    if (value == 0) {
+      // Unheld; on failure |value| is reloaded.
+      if (iree_slim_rwlock_try_acquire_compare_exchange(
+              lock, &value, IREE_SLIM_RWLOCK_WRITER)) {
+        return;
+      }
+      continue;
+    }
+    if (!did_spin) {
+      did_spin = true;
+      value = iree_slim_rwlock_spin(lock, value, ~0);
+      continue;
+    }
+    iree_slim_rwlock_wait(lock, value);
+    value = iree_atomic_load_int32(&lock->value, iree_memory_order_relaxed);
+  }
+}
+
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  int32_t value = 0;
+  return iree_atomic_compare_exchange_strong_int32(
+      &lock->value, &value, IREE_SLIM_RWLOCK_WRITER, iree_memory_order_acquire,
+      iree_memory_order_relaxed);
+}
+
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  // Readers cannot have joined while the writer held the lock so the only
+  // other state is the waiter bit.
+  int32_t value =
+      iree_atomic_exchange_int32(&lock->value, 0, iree_memory_order_release);
+  if (value & IREE_SLIM_RWLOCK_WAITERS) {
+    iree_futex_wake(&lock->value, IREE_ALL_WAITERS);
+  }
+}
+
+#else
+
+// pthread_rwlock_t fallback for platforms without a futex we can use.
+
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock) {
+  pthread_rwlock_init(&out_lock->value, NULL);
+}
+
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock) {
+  pthread_rwlock_destroy(&lock->value);
+}
+
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  pthread_rwlock_rdlock(&lock->value);
+}
+
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return pthread_rwlock_tryrdlock(&lock->value) == 0;
+}
+
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  pthread_rwlock_unlock(&lock->value);
+}
+
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  pthread_rwlock_wrlock(&lock->value);
+}
+
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  return pthread_rwlock_trywrlock(&lock->value) == 0;
+}
+
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  pthread_rwlock_unlock(&lock->value);
+}
+
+#endif  // IREE_PLATFORM_*
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -670,26 +1025,45 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
                                    iree_wait_token_t wait_token,
                                    iree_duration_t spin_ns,
                                    iree_time_t deadline_ns) {
-  struct timespec abs_ts = {
-      .tv_sec = (time_t)(deadline_ns / 1000000000ull),
-      .tv_nsec = (long)(deadline_ns % 1000000000ull),
-  };
-
   pthread_mutex_lock(&notification->mutex);
 
-  // Spin until notified and the epoch increments from what we captured during
-  // iree_notification_prepare_wait.
-  bool result = true;
-  while (notification->epoch == wait_token) {
-    int ret = pthread_cond_timedwait(&notification->cond, &notification->mutex,
-                                     &abs_ts);
-    if (ret != 0) {
-      // Wait failed (timeout/etc); cancel the wait.
-      // This may happen in spurious wakes but that's fine - the caller is
-      // designed to handle looping again and may want the chance to do some
-      // bookkeeping while it has the thread.
-      result = false;
-      break;
+  // If spinning is enabled poll the epoch without sleeping on the condition
+  // variable. The mutex is only held long enough to read the epoch so that
+  // posters are not blocked while we spin.
+  if (notification->epoch == wait_token && spin_ns != IREE_DURATION_ZERO) {
+    const iree_time_t spin_deadline_ns = iree_time_now() + spin_ns;
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_notification_commit_wait_spin");
+    do {
+      pthread_mutex_unlock(&notification->mutex);
+      // Try to be nice to the processor when using SMT.
+      iree_processor_yield();
+      pthread_mutex_lock(&notification->mutex);
+    } while (notification->epoch == wait_token &&
+             iree_time_now() < spin_deadline_ns);
+    IREE_TRACE_ZONE_END(z0);
+  }
+
+  // Wait until notified and the epoch increments from what we captured during
+  // iree_notification_prepare_wait. An infinite past deadline is a poll and
+  // must not block.
+  bool result = notification->epoch != wait_token;
+  if (!result && deadline_ns != IREE_TIME_INFINITE_PAST) {
+    struct timespec abs_ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ull),
+        .tv_nsec = (long)(deadline_ns % 1000000000ull),
+    };
+    result = true;
+    while (notification->epoch == wait_token) {
+      int ret = pthread_cond_timedwait(&notification->cond,
+                                       &notification->mutex, &abs_ts);
+      if (ret != 0) {
+        // Wait failed (timeout/etc); cancel the wait.
+        // This may happen in spurious wakes but that's fine - the caller is
+        // designed to handle looping again and may want the chance to do some
+        // bookkeeping while it has the thread.
+        result = false;
+        break;
+      }
     }
   }
 
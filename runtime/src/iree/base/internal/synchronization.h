@@ -324,6 +324,77 @@ bool iree_slim_mutex_try_lock(iree_slim_mutex_t* mutex)
 void iree_slim_mutex_unlock(iree_slim_mutex_t* mutex)
     IREE_THREAD_ANNOTATION_ATTRIBUTE(release_capability(mutex));
 
+//==============================================================================
+// iree_slim_rwlock_t
+//==============================================================================
+
+// A lightweight reader/writer lock.
+// Any number of readers may hold the lock in shared mode concurrently while a
+// writer holding it in exclusive mode excludes all others. This is intended for
+// read-mostly structures such as caches and registries where lookups vastly
+// outnumber insertions; for anything else prefer iree_slim_mutex_t as the
+// bookkeeping required for shared ownership makes uncontended exclusive
+// acquisition slightly more expensive.
+//
+// Once a writer is waiting new readers will wait as well so that a steady
+// stream of readers cannot starve writers. Like iree_slim_mutex_t the lock is
+// unfair and not recursive: a thread holding the lock in shared mode must not
+// try to acquire it again (in either mode) as a waiting writer will block it.
+//
+// Windows: Slim Reader/Writer (SRW) Locks
+// Linux/Android/Emscripten: futex
+// All others: pthread_rwlock_t
+typedef struct iree_slim_rwlock_t IREE_THREAD_ANNOTATION_ATTRIBUTE(
+    capability("mutex")) {
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+  int reserved;
+#elif (IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_FAST_LOCKS)
+  iree_mutex_t impl;  // re-route to (exclusive) slow mutex
+#elif defined(IREE_PLATFORM_WINDOWS) && defined(IREE_MUTEX_USE_WIN32_SRW)
+  SRWLOCK value;
+#elif defined(IREE_PLATFORM_HAS_FUTEX)
+  iree_atomic_int32_t value;
+#else
+  pthread_rwlock_t value;  // fallback
+#endif  // IREE_PLATFORM_*
+} iree_slim_rwlock_t;
+
+// Initializes |out_lock| to the well-defined unlocked contents.
+// Must be called prior to using any other iree_slim_rwlock_* method.
+void iree_slim_rwlock_initialize(iree_slim_rwlock_t* out_lock);
+
+// Deinitializes |lock| (after a prior call to iree_slim_rwlock_initialize).
+// The lock must not be held by any thread.
+void iree_slim_rwlock_deinitialize(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(locks_excluded(lock));
+
+// Locks the |lock| in shared mode and returns when held by the caller.
+void iree_slim_rwlock_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(acquire_shared_capability(lock));
+
+// Tries to lock the |lock| in shared mode and returns true if the caller holds
+// the lock.
+bool iree_slim_rwlock_try_lock_shared(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(try_acquire_shared_capability(true,
+                                                                   lock));
+
+// Unlocks the |lock|, which must be held by the caller in shared mode.
+void iree_slim_rwlock_unlock_shared(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(release_shared_capability(lock));
+
+// Locks the |lock| in exclusive mode and returns when held by the caller.
+void iree_slim_rwlock_lock(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(acquire_capability(lock));
+
+// Tries to lock the |lock| in exclusive mode and returns true if the caller
+// holds the lock.
+bool iree_slim_rwlock_try_lock(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(try_acquire_capability(true, lock));
+
+// Unlocks the |lock|, which must be held by the caller in exclusive mode.
+void iree_slim_rwlock_unlock(iree_slim_rwlock_t* lock)
+    IREE_THREAD_ANNOTATION_ATTRIBUTE(release_capability(lock));
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <mutex>
+#include <shared_mutex>
 
 #include "benchmark/benchmark.h"
 #include "iree/base/internal/synchronization.h"
@@ -26,7 +27,7 @@ void SpinDelay(int count, int* data) {
 }
 
 //==============================================================================
-// iree_mutex_t / iree_slim_mutex_t
+// iree_mutex_t / iree_slim_mutex_t / iree_slim_rwlock_t
 //==============================================================================
 
 void BM_Mutex(benchmark::State& state) {
@@ -88,6 +89,28 @@ class RaiiLocker<iree_slim_mutex_t> {
   iree_slim_mutex_t* mu_;
 };
 
+template <>
+class RaiiLocker<iree_slim_rwlock_t> {
+ public:
+  static void Initialize(iree_slim_rwlock_t* out_mu) {
+    iree_slim_rwlock_initialize(out_mu);
+  }
+  static void Deinitialize(iree_slim_rwlock_t* mu) {
+    iree_slim_rwlock_deinitialize(mu);
+  }
+  explicit RaiiLocker(iree_slim_rwlock_t* mu)
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis)
+      : mu_(mu) {
+    iree_slim_rwlock_lock(mu_);
+  }
+  ~RaiiLocker() IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis) {
+    iree_slim_rwlock_unlock(mu_);
+  }
+
+ private:
+  iree_slim_rwlock_t* mu_;
+};
+
 template <>
 class RaiiLocker<std::mutex> {
  public:
@@ -116,6 +139,10 @@ BENCHMARK_TEMPLATE(BM_CreateDelete, iree_slim_mutex_t)
     ->UseRealTime()
     ->Threads(1);
 
+BENCHMARK_TEMPLATE(BM_CreateDelete, iree_slim_rwlock_t)
+    ->UseRealTime()
+    ->Threads(1);
+
 BENCHMARK_TEMPLATE(BM_CreateDelete, std::mutex)->UseRealTime()->Threads(1);
 
 template <typename MutexType>
@@ -153,6 +180,12 @@ BENCHMARK_TEMPLATE(BM_Uncontended, iree_slim_mutex_t)
     ->Arg(50)
     ->Arg(200);
 
+BENCHMARK_TEMPLATE(BM_Uncontended, iree_slim_rwlock_t)
+    ->UseRealTime()
+    ->Threads(1)
+    ->Arg(50)
+    ->Arg(200);
+
 BENCHMARK_TEMPLATE(BM_Uncontended, std::mutex)
     ->UseRealTime()
     ->Threads(1)
@@ -225,6 +258,26 @@ BENCHMARK_TEMPLATE(BM_Contended, iree_slim_mutex_t)
     ->Arg(50)
     ->Arg(200);
 
+BENCHMARK_TEMPLATE(BM_Contended, iree_slim_rwlock_t)
+    ->UseRealTime()
+    // ThreadPerCpu poorly handles non-power-of-two CPU counts.
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(6)
+    ->Threads(8)
+    ->Threads(12)
+    ->Threads(16)
+    ->Threads(24)
+    ->Threads(32)
+    ->Threads(48)
+    ->Threads(64)
+    ->Threads(96)
+    // Some empirically chosen amounts of work in critical section.
+    // 1 is low contention, 200 is high contention and few values in between.
+    ->Arg(50)
+    ->Arg(200);
+
 BENCHMARK_TEMPLATE(BM_Contended, std::mutex)
     ->UseRealTime()
     // ThreadPerCpu poorly handles non-power-of-two CPU counts.
@@ -245,6 +298,121 @@ BENCHMARK_TEMPLATE(BM_Contended, std::mutex)
     ->Arg(50)
     ->Arg(200);
 
+//==============================================================================
+// Read-mostly shared access
+//==============================================================================
+
+// Acquires the lock for reading; exclusive-only locks are acquired exclusively.
+template <typename MutexType>
+class RaiiReadLocker : public RaiiLocker<MutexType> {
+ public:
+  using RaiiLocker<MutexType>::RaiiLocker;
+};
+
+template <>
+class RaiiReadLocker<iree_slim_rwlock_t> {
+ public:
+  explicit RaiiReadLocker(iree_slim_rwlock_t* mu)
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis)
+      : mu_(mu) {
+    iree_slim_rwlock_lock_shared(mu_);
+  }
+  ~RaiiReadLocker()
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis) {
+    iree_slim_rwlock_unlock_shared(mu_);
+  }
+
+ private:
+  iree_slim_rwlock_t* mu_;
+};
+
+template <>
+class RaiiLocker<std::shared_mutex> {
+ public:
+  static void Initialize(std::shared_mutex* out_mu) {}
+  static void Deinitialize(std::shared_mutex* mu) {}
+  explicit RaiiLocker(std::shared_mutex* mu) : mu_(mu) { mu_->lock(); }
+  ~RaiiLocker() { mu_->unlock(); }
+
+ private:
+  std::shared_mutex* mu_;
+};
+
+template <>
+class RaiiReadLocker<std::shared_mutex> {
+ public:
+  explicit RaiiReadLocker(std::shared_mutex* mu) : mu_(mu) {
+    mu_->lock_shared();
+  }
+  ~RaiiReadLocker() { mu_->unlock_shared(); }
+
+ private:
+  std::shared_mutex* mu_;
+};
+
+// Models a lookup cache: most iterations only read the shared state and one
+// in every state.range(0) iterations updates it.
+template <typename MutexType>
+void BM_ReadMostly(benchmark::State& state) {
+  struct Shared {
+    MutexType mu;
+    int data = 0;
+    Shared() { RaiiLocker<MutexType>::Initialize(&mu); }
+  };
+  static auto* shared = new Shared();
+  const int write_interval = static_cast<int>(state.range(0));
+  int local = 0;
+  int iteration = 0;
+  for (auto _ : state) {
+    SpinDelay(10, &local);
+    if (++iteration % write_interval == 0) {
+      RaiiLocker<MutexType> locker(&shared->mu);
+      SpinDelay(50, &shared->data);
+    } else {
+      RaiiReadLocker<MutexType> locker(&shared->mu);
+      for (int i = 0; i < 50 * 10; ++i) {
+        benchmark::DoNotOptimize(shared->data);
+      }
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, iree_slim_mutex_t)
+    ->UseRealTime()
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->Threads(32)
+    // Writes once every N iterations.
+    ->Arg(10)
+    ->Arg(1000);
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, iree_slim_rwlock_t)
+    ->UseRealTime()
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->Threads(32)
+    // Writes once every N iterations.
+    ->Arg(10)
+    ->Arg(1000);
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_mutex)
+    ->UseRealTime()
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->Threads(32)
+    // Writes once every N iterations.
+    ->Arg(10)
+    ->Arg(1000);
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -6,7 +6,9 @@
 
 #include "iree/base/internal/synchronization.h"
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "iree/testing/gtest.h"
 
@@ -63,6 +65,29 @@ class Mutex<iree_slim_mutex_t> {
   }
 };
 
+template <>
+class Mutex<iree_slim_rwlock_t> {
+ public:
+  static void Initialize(iree_slim_rwlock_t* out_mu) {
+    iree_slim_rwlock_initialize(out_mu);
+  }
+  static void Deinitialize(iree_slim_rwlock_t* mu) {
+    iree_slim_rwlock_deinitialize(mu);
+  }
+  static void Lock(iree_slim_rwlock_t* mu)
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis) {
+    iree_slim_rwlock_lock(mu);
+  }
+  static bool TryLock(iree_slim_rwlock_t* mu)
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis) {
+    return iree_slim_rwlock_try_lock(mu);
+  }
+  static void Unlock(iree_slim_rwlock_t* mu)
+      IREE_THREAD_ANNOTATION_ATTRIBUTE(no_thread_safety_analysis) {
+    iree_slim_rwlock_unlock(mu);
+  }
+};
+
 // Tests that a mutex allows exclusive access to a region by touching it from
 // multiple threads.
 template <typename T>
@@ -169,6 +194,88 @@ TEST(SlimMutexTest, ExclusiveAccessTryLock) {
   TestMutexExclusiveAccessTryLock<iree_slim_mutex_t>();
 }
 
+//==============================================================================
+// iree_slim_rwlock_t
+//==============================================================================
+
+TEST(SlimRWLockTest, Lifetime) {
+  iree_slim_rwlock_t lock;
+  iree_slim_rwlock_initialize(&lock);
+  bool did_lock = iree_slim_rwlock_try_lock(&lock);
+  EXPECT_TRUE(did_lock);
+  if (did_lock) iree_slim_rwlock_unlock(&lock);
+  bool did_lock_shared = iree_slim_rwlock_try_lock_shared(&lock);
+  EXPECT_TRUE(did_lock_shared);
+  if (did_lock_shared) iree_slim_rwlock_unlock_shared(&lock);
+  iree_slim_rwlock_lock(&lock);
+  iree_slim_rwlock_unlock(&lock);
+  iree_slim_rwlock_lock_shared(&lock);
+  iree_slim_rwlock_unlock_shared(&lock);
+  iree_slim_rwlock_deinitialize(&lock);
+}
+
+TEST(SlimRWLockTest, ExclusiveAccess) {
+  TestMutexExclusiveAccess<iree_slim_rwlock_t>();
+}
+
+TEST(SlimRWLockTest, ExclusiveAccessTryLock) {
+  TestMutexExclusiveAccessTryLock<iree_slim_rwlock_t>();
+}
+
+// Tests that exclusive acquisition fails while the lock is held shared.
+TEST(SlimRWLockTest, SharedBlocksExclusive) {
+  iree_slim_rwlock_t lock;
+  iree_slim_rwlock_initialize(&lock);
+  iree_slim_rwlock_lock_shared(&lock);
+  bool did_lock = true;
+  std::thread th1([&]() {
+    did_lock = iree_slim_rwlock_try_lock(&lock);
+    if (did_lock) iree_slim_rwlock_unlock(&lock);
+  });
+  th1.join();
+  iree_slim_rwlock_unlock_shared(&lock);
+  EXPECT_FALSE(did_lock);
+  iree_slim_rwlock_deinitialize(&lock);
+}
+
+// Tests that readers never observe a partially-applied writer update while
+// many readers and writers contend for the lock.
+TEST(SlimRWLockTest, ReadersAndWriters) {
+  iree_slim_rwlock_t lock;
+  iree_slim_rwlock_initialize(&lock);
+  int value_a = 0;
+  int value_b = 0;
+  std::atomic<bool> did_mismatch = {false};
+
+  static constexpr int kIterationCount = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kIterationCount; ++j) {
+        iree_slim_rwlock_lock_shared(&lock);
+        if (value_a != value_b) did_mismatch = true;
+        iree_slim_rwlock_unlock_shared(&lock);
+      }
+    });
+  }
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kIterationCount; ++j) {
+        iree_slim_rwlock_lock(&lock);
+        ++value_a;
+        ++value_b;
+        iree_slim_rwlock_unlock(&lock);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_FALSE(did_mismatch);
+  EXPECT_EQ(2 * kIterationCount, value_a);
+  EXPECT_EQ(2 * kIterationCount, value_b);
+  iree_slim_rwlock_deinitialize(&lock);
+}
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -215,4 +322,32 @@ TEST(NotificationTest, Timeout) {
   iree_notification_deinitialize(&notification);
 }
 
+// Tests that an infinite past deadline polls after spinning instead of
+// blocking.
+TEST(NotificationTest, SpinThenPoll) {
+  iree_notification_t notification;
+  iree_notification_initialize(&notification);
+
+  iree_time_t start_ns = iree_time_now();
+
+  iree_wait_token_t wait_token = iree_notification_prepare_wait(&notification);
+  EXPECT_FALSE(iree_notification_commit_wait(
+      &notification, wait_token, /*spin_ns=*/10000000ll,
+      /*deadline_ns=*/IREE_TIME_INFINITE_PAST));
+
+  iree_duration_t delta_ns = iree_time_now() - start_ns;
+  iree_duration_t delta_ms = delta_ns / 1000000;
+  EXPECT_GE(delta_ms, 5);    // slop
+  EXPECT_LT(delta_ms, 500);  // slop
+
+  // Posts that land before the commit are observed without spinning.
+  wait_token = iree_notification_prepare_wait(&notification);
+  iree_notification_post(&notification, IREE_ALL_WAITERS);
+  EXPECT_TRUE(iree_notification_commit_wait(
+      &notification, wait_token, /*spin_ns=*/IREE_DURATION_ZERO,
+      /*deadline_ns=*/IREE_TIME_INFINITE_PAST));
+
+  iree_notification_deinitialize(&notification);
+}
+
 }  // namespace
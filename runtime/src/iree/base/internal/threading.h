@@ -44,6 +44,17 @@ typedef enum iree_thread_priority_class_e {
   // Highest possible priority used for interactive work.
   // Maps to QOS_CLASS_USER_INTERACTIVE.
   IREE_THREAD_PRIORITY_CLASS_HIGHEST = 2,
+  // Real-time priority for latency-critical work that must preempt everything
+  // else on the system. Maps to SCHED_FIFO on Linux/Android when the process
+  // is permitted to use it (CAP_SYS_NICE/RLIMIT_RTPRIO) and otherwise falls
+  // back to IREE_THREAD_PRIORITY_CLASS_HIGHEST. Maps to
+  // THREAD_PRIORITY_TIME_CRITICAL on Windows and QOS_CLASS_USER_INTERACTIVE on
+  // Apple platforms.
+  //
+  // WARNING: real-time threads that spin or run for long periods can starve
+  // the rest of the system (including the threads they depend on). Only use
+  // for short bursts of work with bounded duration.
+  IREE_THREAD_PRIORITY_CLASS_REALTIME = 3,
 } iree_thread_priority_class_t;
 
 // Specifies the processor affinity for a particular thread.
@@ -188,6 +188,7 @@ static qos_class_t iree_thread_qos_class_for_priority_class(
     case IREE_THREAD_PRIORITY_CLASS_HIGH:
       return QOS_CLASS_USER_INITIATED;
     case IREE_THREAD_PRIORITY_CLASS_HIGHEST:
+    case IREE_THREAD_PRIORITY_CLASS_REALTIME:
       return QOS_CLASS_USER_INTERACTIVE;
   }
 }
@@ -36,6 +36,10 @@ struct iree_thread_t {
   char name[16];
   pthread_t handle;
 
+  // Kernel thread ID published by the thread when it starts or 0 if it has
+  // not yet started. Guarded by the qos_override_list mutex.
+  pid_t tid;
+
   iree_thread_entry_t entry;
   void* entry_arg;
 
@@ -98,6 +102,21 @@ static void* iree_thread_start_routine(void* param) {
   iree_thread_set_name(thread->handle, thread->name);
   IREE_TRACE_SET_THREAD_NAME(thread->name);
 
+  // Publish our thread ID so that priority changes can target us and apply the
+  // priority requested at creation (or by overrides made before we started).
+  // Linux schedules threads individually and this has to happen on a thread ID
+  // that only exists once we are running.
+#if !defined(IREE_PLATFORM_EMSCRIPTEN)
+  iree_slim_mutex_lock(&thread->qos_override_list.mutex);
+  thread->tid = (pid_t)syscall(SYS_gettid);
+  if (thread->qos_override_list.current_priority_class !=
+      IREE_THREAD_PRIORITY_CLASS_NORMAL) {
+    iree_thread_set_priority_class(
+        thread, thread->qos_override_list.current_priority_class);
+  }
+  iree_slim_mutex_unlock(&thread->qos_override_list.mutex);
+#endif  // !IREE_PLATFORM_EMSCRIPTEN
+
   // Wait until we resume if we were created suspended.
   while (iree_atomic_load_int32(&thread->suspend_count,
                                 iree_memory_order_acquire) > 0) {
@@ -184,9 +203,8 @@ iree_status_t iree_thread_create(iree_thread_entry_t entry, void* entry_arg,
                             "thread creation failed with %d", rc);
   }
 
-  if (params.priority_class != IREE_THREAD_PRIORITY_CLASS_NORMAL) {
-    iree_thread_set_priority_class(thread, params.priority_class);
-  }
+  // NOTE: the initial priority class is applied by the thread itself once it
+  // has started (see iree_thread_start_routine).
   if (params.initial_affinity.specified) {
     iree_thread_request_affinity(thread, params.initial_affinity);
   }
@@ -224,67 +242,66 @@ uintptr_t iree_thread_id(iree_thread_t* thread) {
   return (uintptr_t)thread->handle;
 }
 
-// Maps an IREE iree_thread_priority_class_t value to a pthreads priority param.
-// The min/max ranges of the priority are implementation dependent so we need to
-// do this at runtime.
-static struct sched_param iree_thread_sched_param_for_priority_class(
-    int policy, iree_thread_priority_class_t priority_class) {
-  struct sched_param param;
-  memset(&param, 0, sizeof(param));
-  int min_priority = sched_get_priority_min(policy);
-  int max_priority = sched_get_priority_max(policy);
-  int normal_priority = (max_priority - min_priority) / 2 + min_priority;
+// Maps an IREE iree_thread_priority_class_t value to a nice value.
+// Android thread priorities are nice values (see
+// android.os.Process.setThreadPriority) and these roughly match the
+// background/foreground/display levels used there; the schedulers on big.LITTLE
+// devices use them (along with the thread load) when placing threads on cores.
+static int iree_thread_nice_value_for_priority_class(
+    iree_thread_priority_class_t priority_class) {
   switch (priority_class) {
     case IREE_THREAD_PRIORITY_CLASS_LOWEST:
-      param.sched_priority = min_priority;
-      break;
+      return 19;
     case IREE_THREAD_PRIORITY_CLASS_LOW:
-      param.sched_priority =
-          (normal_priority - min_priority) / 2 + min_priority;
-      break;
+      return 10;
+    default:
     case IREE_THREAD_PRIORITY_CLASS_NORMAL:
-      param.sched_priority = normal_priority;
-      break;
+      return 0;
     case IREE_THREAD_PRIORITY_CLASS_HIGH:
-      param.sched_priority =
-          (max_priority - normal_priority) / 2 + normal_priority;
-      break;
+      return -4;
     case IREE_THREAD_PRIORITY_CLASS_HIGHEST:
-      param.sched_priority = max_priority;
-      break;
+    case IREE_THREAD_PRIORITY_CLASS_REALTIME:
+      return -8;
   }
-  return param;
 }
 
 // Sets the thread priority to the given |priority_class|, resetting any
-// previous value.
+// previous value. Must be called with the qos_override_list mutex held.
 //
-// NOTE: this probably doesn't work on Android, because Android.
-// They seem to use linux LWPs and setpriority/nice on the tid will actually
-// change the priority. It doesn't seem possible to elevate priority above
-// normal (without root), but it would at least be useful to be able to
-// indicate background threads.
+// Threads with the default SCHED_OTHER policy all have the same (0) static
+// priority and pthread_setschedparam can't change anything for them; instead
+// the per-thread nice value is used to weight them. Real-time priority uses
+// SCHED_FIFO if the process is allowed to use it.
 //
-// See:
-// https://stackoverflow.com/questions/17398075/change-native-thread-priority-on-android-in-c-c
-// https://android.googlesource.com/platform/frameworks/native/+/android-4.2.2_r1/include/utils/ThreadDefs.h
-//
-// TODO(benvanik): try this from filament:
-// https://github.com/google/filament/blob/56682794d398236c4caa5be40d80acdb73a13bc8/libs/utils/src/JobSystem.cpp
+// Raising priority (negative nice values or SCHED_FIFO) requires CAP_SYS_NICE
+// or RLIMIT_NICE/RLIMIT_RTPRIO headroom and otherwise fails. Requests are
+// best-effort and failures are ignored.
 static void iree_thread_set_priority_class(
     iree_thread_t* thread, iree_thread_priority_class_t priority_class) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_EMSCRIPTEN)
-  // TODO(benvanik): Some sort of solution on Android, if possible (see above)
+#if defined(IREE_PLATFORM_EMSCRIPTEN)
   // TODO(benvanik): Some sort of solution on Emscripten, if possible
 #else
-  int policy = 0;
-  struct sched_param param;
-  pthread_getschedparam(thread->handle, &policy, &param);
-  param = iree_thread_sched_param_for_priority_class(policy, priority_class);
-  pthread_setschedparam(thread->handle, policy, &param);
-#endif  // IREE_PLATFORM_ANDROID
+  // The thread applies its priority itself when it starts.
+  pid_t tid = thread->tid;
+  if (tid != 0) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    bool is_realtime = false;
+    if (priority_class == IREE_THREAD_PRIORITY_CLASS_REALTIME) {
+      param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+      is_realtime = sched_setscheduler(tid, SCHED_FIFO, &param) == 0;
+    } else if (sched_getscheduler(tid) == SCHED_FIFO) {
+      // Dropping out of a real-time priority (override ended).
+      sched_setscheduler(tid, SCHED_OTHER, &param);
+    }
+    if (!is_realtime) {
+      setpriority(PRIO_PROCESS, (id_t)tid,
+                  iree_thread_nice_value_for_priority_class(priority_class));
+    }
+  }
+#endif  // IREE_PLATFORM_EMSCRIPTEN
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -247,6 +247,9 @@ static void iree_thread_set_priority_class(
     case IREE_THREAD_PRIORITY_CLASS_HIGHEST:
       priority = THREAD_PRIORITY_HIGHEST;
       break;
+    case IREE_THREAD_PRIORITY_CLASS_REALTIME:
+      priority = THREAD_PRIORITY_TIME_CRITICAL;
+      break;
   }
   SetThreadPriority(thread->handle, priority);
 
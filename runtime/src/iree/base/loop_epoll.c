@@ -0,0 +1,1118 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_epoll.h"
+
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/wait_handle.h"
+
+#if (defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)) && \
+    !IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define IREE_LOOP_EPOLL_AVAILABLE 1
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+#if defined(IREE_LOOP_EPOLL_AVAILABLE)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+//===----------------------------------------------------------------------===//
+// iree_loop_epoll_t utilities
+//===----------------------------------------------------------------------===//
+
+// Default number of readiness events retrieved per epoll_wait.
+#define IREE_LOOP_EPOLL_DEFAULT_MAX_EVENTS 64
+
+// Interval at which wait sources that cannot be exported as file descriptors
+// are queried while pending.
+#define IREE_LOOP_EPOLL_POLL_INTERVAL_NS (1 /*ms*/ * 1000000)
+
+// NOTE: all callbacks should be at offset 0. This allows for easily zipping
+// through the params lists and issuing callbacks.
+static_assert(offsetof(iree_loop_call_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_dispatch_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_until_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_one_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_multi_params_t, callback) == 0,
+              "callback must be at offset 0");
+
+typedef struct iree_loop_epoll_op_t iree_loop_epoll_op_t;
+
+// A wait source registered by a pending wait operation.
+typedef struct iree_loop_epoll_registration_t {
+  // Operation the registration belongs to.
+  iree_loop_epoll_op_t* op;
+  // Wait source being waited on. Points into the operation parameters for
+  // wait-one and into the user-provided list for wait-any/wait-all.
+  iree_wait_source_t* wait_source;
+  // Duplicate of the wait source descriptor registered with the epoll instance
+  // or -1 if the wait source is polled (or no longer registered).
+  int fd;
+  // Set when the epoll instance reported the descriptor as readable.
+  bool is_ready;
+  // Set once the wait source has resolved.
+  bool is_resolved;
+} iree_loop_epoll_registration_t;
+
+// An operation that is either runnable or waiting.
+// Operations are heap nodes recycled through a free list so that their
+// address remains stable while registered with the epoll instance.
+struct iree_loop_epoll_op_t {
+  // Intrusive links in the run queue, incoming list, wait list, or free list.
+  iree_loop_epoll_op_t* next;
+  iree_loop_epoll_op_t* prev;
+
+  iree_loop_epoll_scope_t* scope;
+  iree_loop_command_t command;
+  union {
+    iree_loop_callback_t callback;  // asserted at offset 0 above
+    union {
+      iree_loop_call_params_t call;
+      iree_loop_dispatch_params_t dispatch;
+      iree_loop_wait_until_params_t wait_until;
+      iree_loop_wait_one_params_t wait_one;
+      iree_loop_wait_multi_params_t wait_multi;
+    } params;
+  };
+
+  // Status passed to the callback when the operation runs. Owned.
+  iree_status_t status;
+
+  // Time at which a wait fails with IREE_STATUS_DEADLINE_EXCEEDED (or a
+  // wait-until completes).
+  iree_time_t deadline_ns;
+  // Registrations of wait sources; either |inline_registration| or a heap
+  // allocation for multi-waits.
+  iree_host_size_t registration_count;
+  iree_host_size_t resolved_count;
+  iree_loop_epoll_registration_t* registrations;
+  iree_loop_epoll_registration_t inline_registration;
+};
+
+// A FIFO list of operations.
+typedef struct iree_loop_epoll_op_list_t {
+  iree_loop_epoll_op_t* head;
+  iree_loop_epoll_op_t* tail;
+} iree_loop_epoll_op_list_t;
+
+static bool iree_loop_epoll_op_list_is_empty(
+    const iree_loop_epoll_op_list_t* list) {
+  return list->head == NULL;
+}
+
+static void iree_loop_epoll_op_list_push_back(iree_loop_epoll_op_list_t* list,
+                                              iree_loop_epoll_op_t* op) {
+  op->next = NULL;
+  op->prev = list->tail;
+  if (list->tail) {
+    list->tail->next = op;
+  } else {
+    list->head = op;
+  }
+  list->tail = op;
+}
+
+static void iree_loop_epoll_op_list_erase(iree_loop_epoll_op_list_t* list,
+                                          iree_loop_epoll_op_t* op) {
+  if (op->prev) {
+    op->prev->next = op->next;
+  } else {
+    list->head = op->next;
+  }
+  if (op->next) {
+    op->next->prev = op->prev;
+  } else {
+    list->tail = op->prev;
+  }
+  op->next = NULL;
+  op->prev = NULL;
+}
+
+static iree_loop_epoll_op_t* iree_loop_epoll_op_list_pop_front(
+    iree_loop_epoll_op_list_t* list) {
+  iree_loop_epoll_op_t* op = list->head;
+  if (op) iree_loop_epoll_op_list_erase(list, op);
+  return op;
+}
+
+// Moves all operations in |source| attributed to |scope| to |target|.
+// A NULL |scope| moves all operations.
+static void iree_loop_epoll_op_list_take_scope(
+    iree_loop_epoll_op_list_t* source, iree_loop_epoll_scope_t* scope,
+    iree_loop_epoll_op_list_t* target) {
+  iree_loop_epoll_op_t* op = source->head;
+  while (op) {
+    iree_loop_epoll_op_t* next = op->next;
+    if (!scope || op->scope == scope) {
+      iree_loop_epoll_op_list_erase(source, op);
+      iree_loop_epoll_op_list_push_back(target, op);
+    }
+    op = next;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_epoll_t
+//===----------------------------------------------------------------------===//
+
+struct iree_loop_epoll_t {
+  iree_allocator_t allocator;
+
+  // epoll instance containing |wake_fd|, |timer_fd|, and all registered wait
+  // source descriptors. This is the descriptor exposed to external reactors.
+  int epoll_fd;
+  // eventfd signaled when work is enqueued while the loop may be blocked.
+  int wake_fd;
+  // timerfd armed to the earliest pending wait deadline.
+  int timer_fd;
+  // Deadline |timer_fd| is armed for or IREE_TIME_INFINITE_FUTURE.
+  iree_time_t timer_deadline_ns;
+
+  // Pending waits. Only accessed by the thread polling the loop.
+  iree_loop_epoll_op_list_t wait_list;
+
+  // Guards all fields below; operations may be enqueued from any thread.
+  iree_slim_mutex_t mutex;
+  // Set when the loop is being freed and no new work may be enqueued.
+  bool is_shutting_down;
+  // Set while the polling thread is blocked in epoll_wait.
+  bool is_waiting;
+  // Set while the polling thread is processing the loop.
+  bool is_polling;
+  // Set when |wake_fd| has been signaled and not yet consumed.
+  bool is_wake_pending;
+  // Runnable operations in FIFO order.
+  iree_loop_epoll_op_list_t run_queue;
+  // Wait operations enqueued but not yet registered by the polling thread.
+  iree_loop_epoll_op_list_t incoming_waits;
+  // Recycled operation nodes.
+  iree_loop_epoll_op_t* free_ops;
+
+  // Event storage for epoll_wait.
+  iree_host_size_t max_events;
+  struct epoll_event events[];
+};
+
+// Sentinels used as epoll data for the internal descriptors; registrations
+// always have a non-NULL address.
+#define IREE_LOOP_EPOLL_WAKE_TOKEN NULL
+#define IREE_LOOP_EPOLL_TIMER_TOKEN ((void*)(uintptr_t)1)
+
+static void iree_loop_epoll_abort_scope(iree_loop_epoll_t* loop_epoll,
+                                        iree_loop_epoll_scope_t* scope);
+
+// Signals the wake descriptor if it is not already signaled.
+// Must be called with the mutex held.
+static void iree_loop_epoll_signal_wake_locked(iree_loop_epoll_t* loop_epoll) {
+  if (loop_epoll->is_wake_pending) return;
+  loop_epoll->is_wake_pending = true;
+  uint64_t value = 1;
+  ssize_t result = 0;
+  do {
+    result = write(loop_epoll->wake_fd, &value, sizeof(value));
+  } while (result < 0 && errno == EINTR);
+}
+
+// Consumes a pending wake signal, if any.
+// Must be called with the mutex held.
+static void iree_loop_epoll_consume_wake_locked(iree_loop_epoll_t* loop_epoll) {
+  if (!loop_epoll->is_wake_pending) return;
+  loop_epoll->is_wake_pending = false;
+  uint64_t value = 0;
+  ssize_t result = 0;
+  do {
+    result = read(loop_epoll->wake_fd, &value, sizeof(value));
+  } while (result < 0 && errno == EINTR);
+}
+
+// Arms the timer to fire at |deadline_ns| or disarms it if infinite.
+static void iree_loop_epoll_arm_timer(iree_loop_epoll_t* loop_epoll,
+                                      iree_time_t deadline_ns) {
+  if (deadline_ns == loop_epoll->timer_deadline_ns) return;
+  loop_epoll->timer_deadline_ns = deadline_ns;
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  if (deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+    // A zero value disarms the timer so deadlines in the past are clamped to
+    // the earliest representable time; they fire immediately.
+    if (deadline_ns < 1) deadline_ns = 1;
+    spec.it_value.tv_sec = (time_t)(deadline_ns / 1000000000ll);
+    spec.it_value.tv_nsec = (long)(deadline_ns % 1000000000ll);
+  }
+  // NOTE: iree_time_now uses CLOCK_REALTIME and the timer must match.
+  timerfd_settime(loop_epoll->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+static iree_status_t iree_loop_epoll_acquire_op(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_op_t** out_op) {
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  iree_loop_epoll_op_t* op = loop_epoll->free_ops;
+  if (op) loop_epoll->free_ops = op->next;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+  if (!op) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(loop_epoll->allocator,
+                                               sizeof(*op), (void**)&op));
+  }
+  memset(op, 0, sizeof(*op));
+  *out_op = op;
+  return iree_ok_status();
+}
+
+static void iree_loop_epoll_release_op(iree_loop_epoll_t* loop_epoll,
+                                       iree_loop_epoll_op_t* op) {
+  if (op->registrations && op->registrations != &op->inline_registration) {
+    iree_allocator_free(loop_epoll->allocator, op->registrations);
+  }
+  op->registrations = NULL;
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  op->next = loop_epoll->free_ops;
+  loop_epoll->free_ops = op;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+}
+
+// Enqueues |op| on the run queue with |status| passed to its callback.
+static void iree_loop_epoll_enqueue_run(iree_loop_epoll_t* loop_epoll,
+                                        iree_loop_epoll_op_t* op,
+                                        iree_status_t status) {
+  op->status = status;
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  iree_loop_epoll_op_list_push_back(&loop_epoll->run_queue, op);
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+}
+
+//===----------------------------------------------------------------------===//
+// Wait registration
+//===----------------------------------------------------------------------===//
+
+// Returns a descriptor that becomes readable when |wait_primitive| resolves or
+// -1 if the primitive is not descriptor-based.
+static int iree_loop_epoll_primitive_fd(iree_wait_primitive_t wait_primitive) {
+  switch (wait_primitive.type) {
+#if defined(IREE_HAVE_WAIT_TYPE_EVENTFD)
+    case IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD:
+      return wait_primitive.value.event.fd;
+#endif  // IREE_HAVE_WAIT_TYPE_EVENTFD
+#if defined(IREE_HAVE_WAIT_TYPE_SYNC_FILE)
+    case IREE_WAIT_PRIMITIVE_TYPE_SYNC_FILE:
+      return wait_primitive.value.sync_file.fd;
+#endif  // IREE_HAVE_WAIT_TYPE_SYNC_FILE
+#if defined(IREE_HAVE_WAIT_TYPE_PIPE)
+    case IREE_WAIT_PRIMITIVE_TYPE_PIPE:
+      return wait_primitive.value.pipe.read_fd;
+#endif  // IREE_HAVE_WAIT_TYPE_PIPE
+    default:
+      return -1;
+  }
+}
+
+// Returns the descriptor backing |wait_source| or -1 if it has none.
+static int iree_loop_epoll_wait_source_fd(iree_wait_source_t* wait_source) {
+  if (iree_wait_source_is_delay(*wait_source)) return -1;
+  iree_wait_handle_t* wait_handle = iree_wait_handle_from_source(wait_source);
+  if (wait_handle) {
+    return iree_loop_epoll_primitive_fd(
+        iree_make_wait_primitive(wait_handle->type, wait_handle->value));
+  }
+  iree_wait_primitive_t wait_primitive = iree_wait_primitive_immediate();
+  iree_status_t status =
+      iree_wait_source_export(*wait_source, IREE_WAIT_PRIMITIVE_TYPE_ANY,
+                              iree_immediate_timeout(), &wait_primitive);
+  if (!iree_status_is_ok(status)) {
+    // Not exportable; the source will be polled instead.
+    iree_status_ignore(status);
+    return -1;
+  }
+  return iree_loop_epoll_primitive_fd(wait_primitive);
+}
+
+// Removes |registration| from the epoll instance, if registered.
+static void iree_loop_epoll_registration_deinitialize(
+    iree_loop_epoll_t* loop_epoll,
+    iree_loop_epoll_registration_t* registration) {
+  if (registration->fd < 0) return;
+  epoll_ctl(loop_epoll->epoll_fd, EPOLL_CTL_DEL, registration->fd, NULL);
+  close(registration->fd);
+  registration->fd = -1;
+}
+
+// Marks |registration| as resolved and stops watching its descriptor.
+static void iree_loop_epoll_registration_resolve(
+    iree_loop_epoll_t* loop_epoll,
+    iree_loop_epoll_registration_t* registration) {
+  if (registration->is_resolved) return;
+  registration->is_resolved = true;
+  ++registration->op->resolved_count;
+  iree_loop_epoll_registration_deinitialize(loop_epoll, registration);
+}
+
+// Registers |registration| with the epoll instance unless it has already
+// resolved. Sources without descriptors are left to be polled.
+static iree_status_t iree_loop_epoll_registration_initialize(
+    iree_loop_epoll_t* loop_epoll,
+    iree_loop_epoll_registration_t* registration) {
+  registration->fd = -1;
+  if (iree_wait_source_is_immediate(*registration->wait_source)) {
+    iree_loop_epoll_registration_resolve(loop_epoll, registration);
+    return iree_ok_status();
+  }
+
+  // Avoid the registration entirely if the source has already resolved.
+  iree_status_code_t wait_status_code = IREE_STATUS_OK;
+  IREE_RETURN_IF_ERROR(iree_wait_source_query(*registration->wait_source,
+                                              &wait_status_code));
+  if (wait_status_code == IREE_STATUS_OK) {
+    iree_loop_epoll_registration_resolve(loop_epoll, registration);
+    return iree_ok_status();
+  } else if (wait_status_code != IREE_STATUS_DEFERRED) {
+    return iree_status_from_code(wait_status_code);
+  }
+
+  int source_fd = iree_loop_epoll_wait_source_fd(registration->wait_source);
+  if (source_fd < 0) return iree_ok_status();  // polled
+
+  // The same descriptor may be waited on by multiple operations but may only
+  // be added to an epoll instance once; a duplicate gives each registration
+  // its own entry.
+  int fd = fcntl(source_fd, F_DUPFD_CLOEXEC, 0);
+  if (fd < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to duplicate wait descriptor");
+  }
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.ptr = registration;
+  if (epoll_ctl(loop_epoll->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    int error_number = errno;
+    close(fd);
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "failed to register wait descriptor");
+  }
+  registration->fd = fd;
+  return iree_ok_status();
+}
+
+// Updates the resolution of registrations that are polled or were reported
+// ready. Returns an error if any wait source failed.
+static iree_status_t iree_loop_epoll_op_update_registrations(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_op_t* op) {
+  for (iree_host_size_t i = 0; i < op->registration_count; ++i) {
+    iree_loop_epoll_registration_t* registration = &op->registrations[i];
+    if (registration->is_resolved) continue;
+    if (registration->fd >= 0 && !registration->is_ready) continue;
+    if (registration->is_ready &&
+        iree_wait_handle_from_source(registration->wait_source)) {
+      // Wait handles are resolved once readable.
+      iree_loop_epoll_registration_resolve(loop_epoll, registration);
+      continue;
+    }
+    // Polled sources and exported sources are queried so that failures are
+    // propagated. A readable exported descriptor is treated as resolved.
+    iree_status_code_t wait_status_code = IREE_STATUS_OK;
+    IREE_RETURN_IF_ERROR(iree_wait_source_query(*registration->wait_source,
+                                                &wait_status_code));
+    if (wait_status_code == IREE_STATUS_OK || registration->is_ready) {
+      if (wait_status_code != IREE_STATUS_OK &&
+          wait_status_code != IREE_STATUS_DEFERRED) {
+        return iree_status_from_code(wait_status_code);
+      }
+      iree_loop_epoll_registration_resolve(loop_epoll, registration);
+    } else if (wait_status_code != IREE_STATUS_DEFERRED) {
+      return iree_status_from_code(wait_status_code);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Returns DEFERRED if |op| is unresolved, OK if resolved, and an error
+// otherwise. If resolved (successful or not) the caller must retire the wait.
+static iree_status_t iree_loop_epoll_op_check(iree_loop_epoll_t* loop_epoll,
+                                              iree_loop_epoll_op_t* op,
+                                              iree_time_t now_ns) {
+  IREE_RETURN_IF_ERROR(iree_loop_epoll_op_update_registrations(loop_epoll, op));
+  switch (op->command) {
+    case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      return op->deadline_ns <= now_ns
+                 ? iree_ok_status()
+                 : iree_status_from_code(IREE_STATUS_DEFERRED);
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+      if (op->resolved_count > 0) return iree_ok_status();
+      break;
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+      if (op->resolved_count == op->registration_count) {
+        return iree_ok_status();
+      }
+      break;
+    default:
+      break;
+  }
+  return op->deadline_ns <= now_ns
+             ? iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED)
+             : iree_status_from_code(IREE_STATUS_DEFERRED);
+}
+
+// Returns true if |op| has unresolved wait sources that must be polled.
+static bool iree_loop_epoll_op_is_polled(const iree_loop_epoll_op_t* op) {
+  for (iree_host_size_t i = 0; i < op->registration_count; ++i) {
+    const iree_loop_epoll_registration_t* registration = &op->registrations[i];
+    if (!registration->is_resolved && registration->fd < 0) return true;
+  }
+  return false;
+}
+
+// Unregisters all wait sources of |op| from the epoll instance.
+static void iree_loop_epoll_op_unregister(iree_loop_epoll_t* loop_epoll,
+                                          iree_loop_epoll_op_t* op) {
+  for (iree_host_size_t i = 0; i < op->registration_count; ++i) {
+    iree_loop_epoll_registration_deinitialize(loop_epoll,
+                                              &op->registrations[i]);
+  }
+}
+
+// Retires the pending wait |op| and enqueues its callback with |status|.
+static void iree_loop_epoll_retire_wait(iree_loop_epoll_t* loop_epoll,
+                                        iree_loop_epoll_op_t* op,
+                                        iree_status_t status) {
+  iree_loop_epoll_op_unregister(loop_epoll, op);
+  iree_loop_epoll_op_list_erase(&loop_epoll->wait_list, op);
+  iree_loop_epoll_enqueue_run(loop_epoll, op, status);
+}
+
+// Registers the wait sources of a newly enqueued wait |op| and either adds it
+// to the wait list or, if it resolved immediately, the run queue.
+static void iree_loop_epoll_register_wait(iree_loop_epoll_t* loop_epoll,
+                                          iree_loop_epoll_op_t* op,
+                                          iree_time_t now_ns) {
+  iree_host_size_t source_count = 0;
+  iree_wait_source_t* wait_sources = NULL;
+  switch (op->command) {
+    case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      op->deadline_ns = op->params.wait_until.deadline_ns;
+      break;
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+      op->deadline_ns = op->params.wait_one.deadline_ns;
+      source_count = 1;
+      wait_sources = &op->params.wait_one.wait_source;
+      break;
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+      op->deadline_ns = op->params.wait_multi.deadline_ns;
+      source_count = op->params.wait_multi.count;
+      wait_sources = op->params.wait_multi.wait_sources;
+      break;
+    default:
+      break;
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (source_count <= 1) {
+    op->registrations = &op->inline_registration;
+  } else {
+    status = iree_allocator_malloc(loop_epoll->allocator,
+                                   source_count * sizeof(*op->registrations),
+                                   (void**)&op->registrations);
+  }
+
+  // Register sources in order and stop early if a wait-any is satisfied.
+  for (iree_host_size_t i = 0; i < source_count && iree_status_is_ok(status);
+       ++i) {
+    iree_loop_epoll_registration_t* registration = &op->registrations[i];
+    memset(registration, 0, sizeof(*registration));
+    registration->op = op;
+    registration->wait_source = &wait_sources[i];
+    registration->fd = -1;
+    op->registration_count = i + 1;
+    status = iree_loop_epoll_registration_initialize(loop_epoll, registration);
+    if (op->command == IREE_LOOP_COMMAND_WAIT_ANY && op->resolved_count > 0) {
+      break;
+    }
+  }
+
+  iree_loop_epoll_op_list_push_back(&loop_epoll->wait_list, op);
+  if (iree_status_is_ok(status)) {
+    status = iree_loop_epoll_op_check(loop_epoll, op, now_ns);
+  }
+  if (!iree_status_is_deferred(status)) {
+    iree_loop_epoll_retire_wait(loop_epoll, op, status);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Polling
+//===----------------------------------------------------------------------===//
+
+// Waits for and processes readiness events until |deadline_ns|.
+// Returns without waiting if |deadline_ns| is in the past.
+static iree_status_t iree_loop_epoll_process_events(
+    iree_loop_epoll_t* loop_epoll, iree_time_t deadline_ns) {
+  int timeout_ms = 0;
+  if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+    timeout_ms = -1;
+  } else {
+    iree_time_t now_ns = iree_time_now();
+    if (deadline_ns > now_ns) {
+      // Round up so that we don't spin on sub-millisecond remainders.
+      iree_duration_t timeout_ns = deadline_ns - now_ns;
+      timeout_ms = (int)iree_min((timeout_ns + 999999) / 1000000, INT32_MAX);
+    }
+  }
+
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  if (timeout_ms != 0 &&
+      (!iree_loop_epoll_op_list_is_empty(&loop_epoll->run_queue) ||
+       !iree_loop_epoll_op_list_is_empty(&loop_epoll->incoming_waits))) {
+    // Work arrived; don't block.
+    timeout_ms = 0;
+  }
+  loop_epoll->is_waiting = timeout_ms != 0;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  int event_count = 0;
+  do {
+    event_count = epoll_wait(loop_epoll->epoll_fd, loop_epoll->events,
+                             (int)loop_epoll->max_events, timeout_ms);
+  } while (event_count < 0 && errno == EINTR);
+  int error_number = errno;
+
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  loop_epoll->is_waiting = false;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  if (event_count < 0) {
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "epoll_wait failed");
+  }
+
+  // Only mark readiness here: retiring an operation releases its
+  // registrations and later events in the batch may reference them.
+  for (int i = 0; i < event_count; ++i) {
+    void* token = loop_epoll->events[i].data.ptr;
+    if (token == IREE_LOOP_EPOLL_WAKE_TOKEN) {
+      iree_slim_mutex_lock(&loop_epoll->mutex);
+      iree_loop_epoll_consume_wake_locked(loop_epoll);
+      iree_slim_mutex_unlock(&loop_epoll->mutex);
+    } else if (token == IREE_LOOP_EPOLL_TIMER_TOKEN) {
+      uint64_t expirations = 0;
+      if (read(loop_epoll->timer_fd, &expirations, sizeof(expirations)) > 0) {
+        loop_epoll->timer_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+      }
+    } else {
+      ((iree_loop_epoll_registration_t*)token)->is_ready = true;
+    }
+  }
+  return iree_ok_status();
+}
+
+// Registers incoming waits, retires resolved and expired waits, and arms the
+// timer for the earliest remaining deadline.
+static void iree_loop_epoll_scan_waits(iree_loop_epoll_t* loop_epoll) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  iree_loop_epoll_op_list_t incoming_waits = loop_epoll->incoming_waits;
+  loop_epoll->incoming_waits.head = NULL;
+  loop_epoll->incoming_waits.tail = NULL;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  iree_time_t now_ns = iree_time_now();
+  iree_loop_epoll_op_t* op = NULL;
+  while ((op = iree_loop_epoll_op_list_pop_front(&incoming_waits))) {
+    iree_loop_epoll_register_wait(loop_epoll, op, now_ns);
+  }
+
+  iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  op = loop_epoll->wait_list.head;
+  while (op) {
+    iree_loop_epoll_op_t* next = op->next;
+    iree_status_t status = iree_loop_epoll_op_check(loop_epoll, op, now_ns);
+    if (iree_status_is_deferred(status)) {
+      earliest_deadline_ns = iree_min(earliest_deadline_ns, op->deadline_ns);
+      if (iree_loop_epoll_op_is_polled(op)) {
+        earliest_deadline_ns = iree_min(
+            earliest_deadline_ns, now_ns + IREE_LOOP_EPOLL_POLL_INTERVAL_NS);
+      }
+    } else {
+      iree_loop_epoll_retire_wait(loop_epoll, op, status);
+    }
+    op = next;
+  }
+  iree_loop_epoll_arm_timer(loop_epoll, earliest_deadline_ns);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Emits |status| to the given |scope| and aborts associated operations.
+static void iree_loop_epoll_emit_error(iree_loop_epoll_t* loop_epoll,
+                                       iree_loop_epoll_scope_t* scope,
+                                       iree_status_t status) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(
+      z0, iree_status_code_string(iree_status_code(status)));
+
+  if (scope->error_fn) {
+    scope->error_fn(scope->error_user_data, status);
+  } else {
+    iree_status_ignore(status);
+  }
+
+  iree_loop_epoll_abort_scope(loop_epoll, scope);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_loop_epoll_run_dispatch(
+    iree_loop_t loop, const iree_loop_dispatch_params_t* params) {
+  // We run all workgroups before issuing the completion callback.
+  // If any workgroup fails we exit early and pass the failing status back to
+  // the completion handler exactly once.
+  iree_status_t workgroup_status = iree_ok_status();
+  for (uint32_t z = 0; z < params->workgroup_count_xyz[2]; ++z) {
+    for (uint32_t y = 0; y < params->workgroup_count_xyz[1]; ++y) {
+      for (uint32_t x = 0; x < params->workgroup_count_xyz[0]; ++x) {
+        workgroup_status =
+            params->workgroup_fn(params->callback.user_data, loop, x, y, z);
+        if (!iree_status_is_ok(workgroup_status)) goto workgroup_failed;
+      }
+    }
+  }
+workgroup_failed:
+  return params->callback.fn(params->callback.user_data, loop,
+                             workgroup_status);
+}
+
+// Runs up to |max_count| operations from the run queue.
+static void iree_loop_epoll_run_ops(iree_loop_epoll_t* loop_epoll,
+                                    iree_host_size_t max_count) {
+  for (iree_host_size_t i = 0; i < max_count; ++i) {
+    iree_slim_mutex_lock(&loop_epoll->mutex);
+    iree_loop_epoll_op_t* op =
+        iree_loop_epoll_op_list_pop_front(&loop_epoll->run_queue);
+    if (op) --op->scope->pending_count;
+    iree_slim_mutex_unlock(&loop_epoll->mutex);
+    if (!op) break;
+
+    // Copy out the operation so that the node can be reused by any work the
+    // callback enqueues.
+    iree_loop_epoll_scope_t* scope = op->scope;
+    iree_loop_command_t command = op->command;
+    iree_loop_dispatch_params_t dispatch = op->params.dispatch;
+    iree_loop_callback_t callback = op->callback;
+    iree_status_t op_status = op->status;
+    iree_loop_epoll_release_op(loop_epoll, op);
+
+    iree_loop_t loop = iree_loop_epoll_scope(scope);
+    iree_status_t status = iree_ok_status();
+    if (command == IREE_LOOP_COMMAND_DISPATCH) {
+      IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_loop_epoll_run_dispatch");
+      status = iree_loop_epoll_run_dispatch(loop, &dispatch);
+      IREE_TRACE_ZONE_END(z0);
+    } else {
+      IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_loop_epoll_run_call");
+      status = callback.fn(callback.user_data, loop, op_status);
+      IREE_TRACE_ZONE_END(z0);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_loop_epoll_emit_error(loop_epoll, scope, status);
+    }
+  }
+}
+
+// Performs one iteration of the loop: waits for events until |deadline_ns|
+// (returning immediately if work is runnable), retires waits, and runs all
+// operations that were runnable after retiring.
+static iree_status_t iree_loop_epoll_pump(iree_loop_epoll_t* loop_epoll,
+                                          iree_time_t deadline_ns) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  loop_epoll->is_polling = true;
+  iree_loop_epoll_consume_wake_locked(loop_epoll);
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  // Register new waits first so that a blocking wait includes them.
+  iree_loop_epoll_scan_waits(loop_epoll);
+  iree_status_t status =
+      iree_loop_epoll_process_events(loop_epoll, deadline_ns);
+  if (iree_status_is_ok(status)) {
+    iree_loop_epoll_scan_waits(loop_epoll);
+
+    // Only run what is runnable now; work enqueued by the callbacks is handled
+    // on the next pump so that embedding reactors regain control regularly.
+    iree_slim_mutex_lock(&loop_epoll->mutex);
+    iree_host_size_t run_count = 0;
+    for (iree_loop_epoll_op_t* op = loop_epoll->run_queue.head; op;
+         op = op->next) {
+      ++run_count;
+    }
+    iree_slim_mutex_unlock(&loop_epoll->mutex);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)run_count);
+    iree_loop_epoll_run_ops(loop_epoll, run_count);
+  }
+
+  // Keep the loop descriptor readable while work remains runnable.
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  loop_epoll->is_polling = false;
+  if (!iree_loop_epoll_op_list_is_empty(&loop_epoll->run_queue) ||
+      !iree_loop_epoll_op_list_is_empty(&loop_epoll->incoming_waits)) {
+    iree_loop_epoll_signal_wake_locked(loop_epoll);
+  }
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns true if |scope| (or the entire loop if NULL) has no pending work.
+static bool iree_loop_epoll_is_idle(iree_loop_epoll_t* loop_epoll,
+                                    iree_loop_epoll_scope_t* scope) {
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  bool is_idle =
+      scope ? scope->pending_count == 0
+            : iree_loop_epoll_op_list_is_empty(&loop_epoll->run_queue) &&
+                  iree_loop_epoll_op_list_is_empty(
+                      &loop_epoll->incoming_waits) &&
+                  iree_loop_epoll_op_list_is_empty(&loop_epoll->wait_list);
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+  return is_idle;
+}
+
+// Drains work from the loop until all work in |scope| has completed.
+// A NULL |scope| indicates all work from all scopes should be drained.
+static iree_status_t iree_loop_epoll_drain_scope(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_scope_t* scope,
+    iree_time_t deadline_ns) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  while (!iree_loop_epoll_is_idle(loop_epoll, scope)) {
+    if (iree_time_now() >= deadline_ns) {
+      status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+      break;
+    }
+    status = iree_loop_epoll_pump(loop_epoll, deadline_ns);
+    if (!iree_status_is_ok(status)) break;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Aborts all operations in the loop attributed to |scope|.
+// A NULL |scope| indicates all work from all scopes should be aborted.
+static void iree_loop_epoll_abort_scope(iree_loop_epoll_t* loop_epoll,
+                                        iree_loop_epoll_scope_t* scope) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_loop_epoll_op_list_t aborted_ops = {NULL, NULL};
+  iree_loop_epoll_op_t* op = loop_epoll->wait_list.head;
+  while (op) {
+    iree_loop_epoll_op_t* next = op->next;
+    if (!scope || op->scope == scope) {
+      iree_loop_epoll_op_unregister(loop_epoll, op);
+      iree_loop_epoll_op_list_erase(&loop_epoll->wait_list, op);
+      iree_loop_epoll_op_list_push_back(&aborted_ops, op);
+    }
+    op = next;
+  }
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  iree_loop_epoll_op_list_take_scope(&loop_epoll->incoming_waits, scope,
+                                     &aborted_ops);
+  iree_loop_epoll_op_list_take_scope(&loop_epoll->run_queue, scope,
+                                     &aborted_ops);
+  for (op = aborted_ops.head; op; op = op->next) {
+    --op->scope->pending_count;
+  }
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+
+  // Issue the completion callback of each op to notify it of the abort.
+  // To prevent enqueuing more work while aborting we pass in a NULL loop.
+  // We can't do anything with the errors so we ignore them.
+  while ((op = iree_loop_epoll_op_list_pop_front(&aborted_ops))) {
+    iree_loop_callback_t callback = op->callback;
+    iree_status_ignore(op->status);
+    iree_loop_epoll_release_op(loop_epoll, op);
+    iree_status_ignore(callback.fn(callback.user_data, iree_loop_null(),
+                                   iree_make_status(IREE_STATUS_ABORTED)));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_epoll_scope_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_loop_epoll_scope_initialize(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_error_fn_t error_fn,
+    void* error_user_data, iree_loop_epoll_scope_t* out_scope) {
+  memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->loop_epoll = loop_epoll;
+  out_scope->pending_count = 0;
+  out_scope->error_fn = error_fn;
+  out_scope->error_user_data = error_user_data;
+}
+
+IREE_API_EXPORT void iree_loop_epoll_scope_deinitialize(
+    iree_loop_epoll_scope_t* scope) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (scope->loop_epoll) {
+    iree_loop_epoll_abort_scope(scope->loop_epoll, scope);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_epoll_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_allocate(
+    iree_loop_epoll_options_t options, iree_allocator_t allocator,
+    iree_loop_epoll_t** out_loop_epoll) {
+  IREE_ASSERT_ARGUMENT(out_loop_epoll);
+  *out_loop_epoll = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t max_events = options.max_events_per_wait
+                                    ? options.max_events_per_wait
+                                    : IREE_LOOP_EPOLL_DEFAULT_MAX_EVENTS;
+  if (max_events > INT32_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "max events per wait exceeds maximum");
+  }
+
+  iree_loop_epoll_t* loop_epoll = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              allocator,
+              sizeof(*loop_epoll) + max_events * sizeof(struct epoll_event),
+              (void**)&loop_epoll));
+  loop_epoll->allocator = allocator;
+  loop_epoll->max_events = max_events;
+  loop_epoll->timer_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  iree_slim_mutex_initialize(&loop_epoll->mutex);
+
+  loop_epoll->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  loop_epoll->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  loop_epoll->timer_fd =
+      timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+  iree_status_t status = iree_ok_status();
+  if (loop_epoll->epoll_fd < 0 || loop_epoll->wake_fd < 0 ||
+      loop_epoll->timer_fd < 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to create loop descriptors");
+  }
+
+  if (iree_status_is_ok(status)) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = IREE_LOOP_EPOLL_WAKE_TOKEN;
+    if (epoll_ctl(loop_epoll->epoll_fd, EPOLL_CTL_ADD, loop_epoll->wake_fd,
+                  &event) < 0) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to register loop wake descriptor");
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = IREE_LOOP_EPOLL_TIMER_TOKEN;
+    if (epoll_ctl(loop_epoll->epoll_fd, EPOLL_CTL_ADD, loop_epoll->timer_fd,
+                  &event) < 0) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to register loop timer descriptor");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_loop_epoll = loop_epoll;
+  } else {
+    iree_loop_epoll_free(loop_epoll);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_loop_epoll_free(iree_loop_epoll_t* loop_epoll) {
+  IREE_ASSERT_ARGUMENT(loop_epoll);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t allocator = loop_epoll->allocator;
+
+  // Abort all pending operations.
+  // This will issue callbacks for each operation that was aborted directly
+  // with IREE_STATUS_ABORTED.
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  loop_epoll->is_shutting_down = true;
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+  iree_loop_epoll_abort_scope(loop_epoll, /*scope=*/NULL);
+
+  // After all operations are cleared we can release the data structures.
+  while (loop_epoll->free_ops) {
+    iree_loop_epoll_op_t* op = loop_epoll->free_ops;
+    loop_epoll->free_ops = op->next;
+    iree_allocator_free(allocator, op);
+  }
+  if (loop_epoll->timer_fd >= 0) close(loop_epoll->timer_fd);
+  if (loop_epoll->wake_fd >= 0) close(loop_epoll->wake_fd);
+  if (loop_epoll->epoll_fd >= 0) close(loop_epoll->epoll_fd);
+  iree_slim_mutex_deinitialize(&loop_epoll->mutex);
+  iree_allocator_free(allocator, loop_epoll);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT int iree_loop_epoll_fd(const iree_loop_epoll_t* loop_epoll) {
+  IREE_ASSERT_ARGUMENT(loop_epoll);
+  return loop_epoll->epoll_fd;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_loop_epoll_poll(iree_loop_epoll_t* loop_epoll) {
+  IREE_ASSERT_ARGUMENT(loop_epoll);
+  return iree_loop_epoll_pump(loop_epoll, IREE_TIME_INFINITE_PAST);
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_wait_idle(
+    iree_loop_epoll_t* loop_epoll, iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(loop_epoll);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  iree_status_t status =
+      iree_loop_epoll_drain_scope(loop_epoll, /*scope=*/NULL, deadline_ns);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Enqueues a new operation with a copy of |params| of |params_size| bytes.
+static iree_status_t iree_loop_epoll_enqueue(iree_loop_epoll_scope_t* scope,
+                                             iree_loop_command_t command,
+                                             const void* params,
+                                             iree_host_size_t params_size) {
+  iree_loop_epoll_t* loop_epoll = scope->loop_epoll;
+  iree_loop_epoll_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_loop_epoll_acquire_op(loop_epoll, &op));
+  op->scope = scope;
+  op->command = command;
+  memcpy(&op->params, params, params_size);
+
+  iree_slim_mutex_lock(&loop_epoll->mutex);
+  if (IREE_UNLIKELY(loop_epoll->is_shutting_down)) {
+    iree_slim_mutex_unlock(&loop_epoll->mutex);
+    iree_loop_epoll_release_op(loop_epoll, op);
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "new work cannot be enqueued while the loop is shutting down");
+  }
+  ++scope->pending_count;
+  if (command == IREE_LOOP_COMMAND_CALL ||
+      command == IREE_LOOP_COMMAND_DISPATCH) {
+    iree_loop_epoll_op_list_push_back(&loop_epoll->run_queue, op);
+  } else {
+    iree_loop_epoll_op_list_push_back(&loop_epoll->incoming_waits, op);
+  }
+  // The polling thread picks up new work on its own unless it is blocked (or
+  // not polling at all, in which case an embedding reactor needs to see the
+  // loop descriptor become readable).
+  if (!loop_epoll->is_polling || loop_epoll->is_waiting) {
+    iree_loop_epoll_signal_wake_locked(loop_epoll);
+  }
+  iree_slim_mutex_unlock(&loop_epoll->mutex);
+  return iree_ok_status();
+}
+
+// Control function for the epoll loop.
+// |self| must be an iree_loop_epoll_scope_t.
+IREE_API_EXPORT iree_status_t iree_loop_epoll_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(self);
+  iree_loop_epoll_scope_t* scope = (iree_loop_epoll_scope_t*)self;
+  switch (command) {
+    case IREE_LOOP_COMMAND_CALL:
+      return iree_loop_epoll_enqueue(scope, command, params,
+                                     sizeof(iree_loop_call_params_t));
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_loop_epoll_enqueue(scope, command, params,
+                                     sizeof(iree_loop_dispatch_params_t));
+    case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      return iree_loop_epoll_enqueue(scope, command, params,
+                                     sizeof(iree_loop_wait_until_params_t));
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+      return iree_loop_epoll_enqueue(scope, command, params,
+                                     sizeof(iree_loop_wait_one_params_t));
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+      return iree_loop_epoll_enqueue(scope, command, params,
+                                     sizeof(iree_loop_wait_multi_params_t));
+    case IREE_LOOP_COMMAND_DRAIN:
+      return iree_loop_epoll_drain_scope(
+          scope->loop_epoll, scope,
+          ((const iree_loop_drain_params_t*)params)->deadline_ns);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unimplemented loop command");
+  }
+}
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_allocate(
+    iree_loop_epoll_options_t options, iree_allocator_t allocator,
+    iree_loop_epoll_t** out_loop_epoll) {
+  IREE_ASSERT_ARGUMENT(out_loop_epoll);
+  *out_loop_epoll = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "epoll loops are only available on Linux/Android");
+}
+
+IREE_API_EXPORT void iree_loop_epoll_free(iree_loop_epoll_t* loop_epoll) {}
+
+IREE_API_EXPORT int iree_loop_epoll_fd(const iree_loop_epoll_t* loop_epoll) {
+  return -1;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_loop_epoll_poll(iree_loop_epoll_t* loop_epoll) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_wait_idle(
+    iree_loop_epoll_t* loop_epoll, iree_timeout_t timeout) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+}
+
+IREE_API_EXPORT void iree_loop_epoll_scope_initialize(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_error_fn_t error_fn,
+    void* error_user_data, iree_loop_epoll_scope_t* out_scope) {
+  memset(out_scope, 0, sizeof(*out_scope));
+}
+
+IREE_API_EXPORT void iree_loop_epoll_scope_deinitialize(
+    iree_loop_epoll_scope_t* scope) {}
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+}
+
+#endif  // IREE_LOOP_EPOLL_AVAILABLE
@@ -0,0 +1,131 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_LOOP_EPOLL_H_
+#define IREE_BASE_LOOP_EPOLL_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_loop_epoll_t
+//===----------------------------------------------------------------------===//
+
+// Configuration options for the epoll loop implementation.
+typedef struct iree_loop_epoll_options_t {
+  // Maximum number of readiness events retrieved from the system per wait.
+  // More events may be ready and will be retrieved on subsequent waits.
+  // Defaults to 64 when 0.
+  iree_host_size_t max_events_per_wait;
+} iree_loop_epoll_options_t;
+
+// An event-driven loop backed by a Linux epoll instance.
+//
+// Waits are registered with the kernel as file descriptors and timers are
+// multiplexed through a timerfd so that any number of outstanding waits are
+// serviced by a single epoll_wait without dedicated threads. Wait sources that
+// cannot be exported as file descriptors (such as in-process futexes) are
+// polled at a short interval while pending.
+//
+// The loop can be driven in two ways:
+// - Standalone: iree_loop_epoll_wait_idle (or iree_loop_drain on a scope)
+//   blocks the calling thread and runs work until idle.
+// - Embedded: iree_loop_epoll_fd is registered for readability with an
+//   external reactor (epoll/io_uring/libuv/asio/etc) and iree_loop_epoll_poll
+//   is called whenever it becomes readable. The descriptor is readable
+//   whenever the loop has runnable work, a wait has resolved, or a deadline
+//   has been reached, so no separate timer needs to be managed by the reactor.
+//
+// Thread-safe: operations may be enqueued from any thread, including while
+// another thread is blocked waiting in the loop, and will wake the loop.
+// Only one thread may poll or drain the loop at a time and callbacks are
+// issued on that thread.
+typedef struct iree_loop_epoll_t iree_loop_epoll_t;
+
+// Allocates an epoll loop using |allocator| stored into |out_loop_epoll|.
+// Returns IREE_STATUS_UNAVAILABLE on platforms without epoll.
+IREE_API_EXPORT iree_status_t iree_loop_epoll_allocate(
+    iree_loop_epoll_options_t options, iree_allocator_t allocator,
+    iree_loop_epoll_t** out_loop_epoll);
+
+// Frees an epoll |loop_epoll|, aborting all pending operations.
+IREE_API_EXPORT void iree_loop_epoll_free(iree_loop_epoll_t* loop_epoll);
+
+// Returns a file descriptor that is readable whenever the loop has work to
+// perform. The descriptor is owned by the loop and must not be read from or
+// closed by the caller. Level-triggered registration is required.
+IREE_API_EXPORT int iree_loop_epoll_fd(const iree_loop_epoll_t* loop_epoll);
+
+// Performs all work that is ready without blocking: resolved waits and
+// expired deadlines are retired and runnable operations queued prior to the
+// call are executed. Work queued by the executed operations is left for the
+// next poll so that external reactors are not starved.
+IREE_API_EXPORT iree_status_t
+iree_loop_epoll_poll(iree_loop_epoll_t* loop_epoll);
+
+// Waits until the loop is idle (all operations in all scopes have retired).
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if |timeout| is reached before the
+// loop is idle.
+IREE_API_EXPORT iree_status_t iree_loop_epoll_wait_idle(
+    iree_loop_epoll_t* loop_epoll, iree_timeout_t timeout);
+
+// Handles scope errors returned from loop callback operations.
+// Ownership of |status| is passed to the handler and must be freed.
+// All operations of the same scope will be aborted.
+typedef void(IREE_API_PTR* iree_loop_epoll_error_fn_t)(void* user_data,
+                                                       iree_status_t status);
+
+// A scope of execution within a loop.
+// Each scope has a dedicated error handler that is notified when an error
+// propagates from a loop operation scheduled against the scope. When an error
+// arises all other operations in the same scope will be aborted.
+typedef struct iree_loop_epoll_scope_t {
+  // Target loop for execution.
+  iree_loop_epoll_t* loop_epoll;
+
+  // Total number of pending operations in the scope.
+  // When 0 the scope is considered idle. Guarded by the loop.
+  int32_t pending_count;
+
+  // Optional function used to report errors that occur during execution.
+  iree_loop_epoll_error_fn_t error_fn;
+  void* error_user_data;
+} iree_loop_epoll_scope_t;
+
+// Initializes a loop scope that runs operations against |loop_epoll|.
+IREE_API_EXPORT void iree_loop_epoll_scope_initialize(
+    iree_loop_epoll_t* loop_epoll, iree_loop_epoll_error_fn_t error_fn,
+    void* error_user_data, iree_loop_epoll_scope_t* out_scope);
+
+// Deinitializes a loop |scope| and aborts any pending operations.
+IREE_API_EXPORT void iree_loop_epoll_scope_deinitialize(
+    iree_loop_epoll_scope_t* scope);
+
+IREE_API_EXPORT iree_status_t iree_loop_epoll_ctl(void* self,
+                                                  iree_loop_command_t command,
+                                                  const void* params,
+                                                  void** inout_ptr);
+
+// Returns a loop that schedules operations against |scope|.
+// The scope must remain valid until all operations scheduled against it have
+// completed.
+static inline iree_loop_t iree_loop_epoll_scope(
+    iree_loop_epoll_scope_t* scope) {
+  iree_loop_t loop = {
+      scope,
+      iree_loop_epoll_ctl,
+  };
+  return loop;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_LOOP_EPOLL_H_
@@ -0,0 +1,151 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_epoll.h"
+
+#include <poll.h>
+#include <thread>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// Contains the test definitions applied to all loop implementations:
+#include "iree/base/loop_test.h"
+
+void AllocateLoop(iree_status_t* out_status, iree_allocator_t allocator,
+                  iree_loop_t* out_loop) {
+  iree_loop_epoll_options_t options = {0};
+
+  iree_loop_epoll_t* loop_epoll = NULL;
+  IREE_CHECK_OK(iree_loop_epoll_allocate(options, allocator, &loop_epoll));
+
+  iree_loop_epoll_scope_t* scope = NULL;
+  IREE_CHECK_OK(
+      iree_allocator_malloc(allocator, sizeof(*scope), (void**)&scope));
+  iree_loop_epoll_scope_initialize(
+      loop_epoll,
+      +[](void* user_data, iree_status_t status) {
+        iree_status_t* status_ptr = (iree_status_t*)user_data;
+        if (iree_status_is_ok(*status_ptr)) {
+          *status_ptr = status;
+        } else {
+          iree_status_ignore(status);
+        }
+      },
+      out_status, scope);
+  *out_loop = iree_loop_epoll_scope(scope);
+}
+
+void FreeLoop(iree_allocator_t allocator, iree_loop_t loop) {
+  iree_loop_epoll_scope_t* scope = (iree_loop_epoll_scope_t*)loop.self;
+  iree_loop_epoll_t* loop_epoll = scope->loop_epoll;
+
+  iree_loop_epoll_scope_deinitialize(scope);
+  iree_allocator_free(allocator, scope);
+
+  iree_loop_epoll_free(loop_epoll);
+}
+
+// Returns true if |fd| is readable within |timeout_ms|.
+static bool IsReadable(int fd, int timeout_ms) {
+  struct pollfd pfd = {fd, POLLIN, 0};
+  return poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN);
+}
+
+// Drives the loop as an external reactor would: only polling when the loop
+// descriptor is readable.
+TEST(LoopEpollTest, EmbeddedReactor) {
+  iree_allocator_t allocator = iree_allocator_system();
+  iree_loop_epoll_options_t options = {0};
+  iree_loop_epoll_t* loop_epoll = NULL;
+  IREE_ASSERT_OK(iree_loop_epoll_allocate(options, allocator, &loop_epoll));
+  iree_loop_epoll_scope_t scope;
+  iree_loop_epoll_scope_initialize(loop_epoll, NULL, NULL, &scope);
+  iree_loop_t loop = iree_loop_epoll_scope(&scope);
+  int fd = iree_loop_epoll_fd(loop_epoll);
+
+  // Idle loops are not readable.
+  EXPECT_FALSE(IsReadable(fd, 0));
+
+  struct user_data_t {
+    int call_count = 0;
+    bool did_wait = false;
+  } user_data;
+  IREE_ASSERT_OK(iree_loop_call(
+      loop, IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_EXPECT_OK(status);
+        auto* user_data = reinterpret_cast<user_data_t*>(user_data_ptr);
+        ++user_data->call_count;
+        return iree_loop_wait_until(
+            loop, iree_make_timeout_ms(10),
+            +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+              IREE_EXPECT_OK(status);
+              auto* user_data = reinterpret_cast<user_data_t*>(user_data_ptr);
+              user_data->did_wait = true;
+              return iree_ok_status();
+            },
+            user_data);
+      },
+      &user_data));
+
+  // Enqueued work makes the loop readable.
+  ASSERT_TRUE(IsReadable(fd, 0));
+  IREE_ASSERT_OK(iree_loop_epoll_poll(loop_epoll));
+  EXPECT_EQ(user_data.call_count, 1);
+
+  // The deadline fires through the loop descriptor without a reactor timer.
+  for (int i = 0; i < 100 && !user_data.did_wait; ++i) {
+    if (IsReadable(fd, 1000)) {
+      IREE_ASSERT_OK(iree_loop_epoll_poll(loop_epoll));
+    }
+  }
+  EXPECT_TRUE(user_data.did_wait);
+  EXPECT_EQ(scope.pending_count, 0);
+
+  iree_loop_epoll_scope_deinitialize(&scope);
+  iree_loop_epoll_free(loop_epoll);
+}
+
+// Enqueuing from another thread wakes a loop blocked waiting for work.
+TEST(LoopEpollTest, CrossThreadWake) {
+  iree_allocator_t allocator = iree_allocator_system();
+  iree_loop_epoll_options_t options = {0};
+  iree_loop_epoll_t* loop_epoll = NULL;
+  IREE_ASSERT_OK(iree_loop_epoll_allocate(options, allocator, &loop_epoll));
+  iree_loop_epoll_scope_t scope;
+  iree_loop_epoll_scope_initialize(loop_epoll, NULL, NULL, &scope);
+  iree_loop_t loop = iree_loop_epoll_scope(&scope);
+
+  // A long wait keeps the loop blocked until the other thread enqueues work
+  // that cancels it.
+  bool did_call = false;
+  IREE_ASSERT_OK(iree_loop_wait_until(
+      loop, iree_make_timeout_ms(60 * 1000),
+      +[](void* user_data, iree_loop_t loop, iree_status_t status) {
+        IREE_EXPECT_STATUS_IS(IREE_STATUS_ABORTED, status);
+        iree_status_ignore(status);
+        return iree_ok_status();
+      },
+      NULL));
+  std::thread thread([&]() {
+    IREE_EXPECT_OK(iree_loop_call(
+        loop, IREE_LOOP_PRIORITY_DEFAULT,
+        +[](void* user_data, iree_loop_t loop, iree_status_t status) {
+          *(bool*)user_data = true;
+          return iree_make_status(IREE_STATUS_CANCELLED);
+        },
+        &did_call));
+  });
+  IREE_EXPECT_OK(iree_loop_epoll_wait_idle(loop_epoll,
+                                           iree_make_timeout_ms(30 * 1000)));
+  thread.join();
+  EXPECT_TRUE(did_call);
+
+  iree_loop_epoll_scope_deinitialize(&scope);
+  iree_loop_epoll_free(loop_epoll);
+}
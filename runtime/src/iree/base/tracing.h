@@ -13,8 +13,10 @@
 // set on IREE_TRACING_FEATURES when a more custom set of features is
 // required. Exact feature support may vary on platform and toolchain.
 //
-// The tracing infrastructure is currently designed to target the Tracy
+// The tracing infrastructure is primarily designed to target the Tracy
 // profiler: https://github.com/wolfpld/tracy
+// Alternative providers (console, Perfetto) can be selected with the
+// IREE_TRACING_PROVIDER build option; see iree/base/tracing/.
 // Tracy's profiler UI allowing for streaming captures and analysis can be
 // downloaded from: https://github.com/wolfpld/tracy/releases
 // The manual provided on the releases page contains more information about how
@@ -298,6 +300,18 @@ enum {
 // The string |value| will be copied into the trace buffer.
 #define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length)
 
+// Begins a flow connecting the current zone to the zones in which the
+// matching IREE_TRACE_FLOW_STEP/IREE_TRACE_FLOW_END are recorded. Used to
+// follow asynchronous work (such as queue submissions) across threads.
+// |flow_id| must be unique among all active flows in the process; addresses of
+// objects that live for the duration of the work are a good choice.
+// Only supported by providers that can visualize flows (Perfetto).
+#define IREE_TRACE_FLOW_BEGIN(flow_id)
+// Continues a flow begun with IREE_TRACE_FLOW_BEGIN in the current zone.
+#define IREE_TRACE_FLOW_STEP(flow_id)
+// Ends a flow begun with IREE_TRACE_FLOW_BEGIN in the current zone.
+#define IREE_TRACE_FLOW_END(flow_id)
+
 #endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
 
 //===----------------------------------------------------------------------===//
@@ -225,6 +225,10 @@ void iree_tracing_memory_free(const char* name, size_t name_length, void* ptr);
 #define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length) \
   iree_tracing_message_string_view(value, value_length, " ", color)
 
+#define IREE_TRACE_FLOW_BEGIN(flow_id)
+#define IREE_TRACE_FLOW_STEP(flow_id)
+#define IREE_TRACE_FLOW_END(flow_id)
+
 // Utilities:
 #define IREE_TRACE_IMPL_GET_VARIADIC_HELPER_(_1, _2, _3, NAME, ...) NAME
 #define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
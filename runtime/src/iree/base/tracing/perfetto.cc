@@ -0,0 +1,251 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <fcntl.h>
+#include <perfetto.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_WINDOWS)
+#include <io.h>
+#define IREE_PERFETTO_OPEN(path) \
+  _open(path, _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, 0600)
+#define IREE_PERFETTO_CLOSE(fd) _close(fd)
+#else
+#include <unistd.h>
+#define IREE_PERFETTO_OPEN(path) open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)
+#define IREE_PERFETTO_CLOSE(fd) close(fd)
+#endif  // IREE_PLATFORM_WINDOWS
+
+#if IREE_TRACING_FEATURES
+
+PERFETTO_DEFINE_CATEGORIES(
+    perfetto::Category("iree").SetDescription("IREE runtime zones and frames"),
+    perfetto::Category("iree.counters")
+        .SetDescription("IREE runtime plotted values"),
+    perfetto::Category("iree.flows")
+        .SetDescription("IREE work followed across threads"),
+    perfetto::Category("iree.messages")
+        .SetDescription("IREE runtime log messages"));
+
+PERFETTO_TRACK_EVENT_STATIC_STORAGE();
+
+namespace {
+
+// Global shared Perfetto tracing state.
+// Perfetto itself is process-global so there's no benefit in allowing multiple
+// instances of this to exist.
+struct iree_tracing_perfetto_t {
+  // Set once the SDK has been initialized and track events registered.
+  std::atomic<bool> initialized{false};
+
+  // Runtime toggle checked before any event is emitted.
+  std::atomic<bool> enabled{true};
+
+  // In-process session started when IREE_PERFETTO_TRACE_FILE is set.
+  std::unique_ptr<perfetto::TracingSession> session;
+  int session_fd = -1;
+};
+static iree_tracing_perfetto_t _perfetto;
+
+static bool iree_tracing_perfetto_is_recording() {
+  return _perfetto.enabled.load(std::memory_order_relaxed) &&
+         TRACE_EVENT_CATEGORY_ENABLED("iree");
+}
+
+static void iree_tracing_perfetto_start_file_session(const char* path) {
+  int fd = IREE_PERFETTO_OPEN(path);
+  if (fd < 0) {
+    fprintf(stderr, "iree: unable to open perfetto trace file '%s'\n", path);
+    return;
+  }
+
+  // Only the requested categories are enabled; everything else (including
+  // the categories of other libraries in the process) is disabled.
+  perfetto::protos::gen::TrackEventConfig track_event_config;
+  track_event_config.add_disabled_categories("*");
+  const char* categories = getenv("IREE_PERFETTO_CATEGORIES");
+  std::string category_list =
+      categories && categories[0] ? categories : "iree*";
+  size_t start = 0;
+  while (start <= category_list.size()) {
+    size_t end = category_list.find(',', start);
+    if (end == std::string::npos) end = category_list.size();
+    if (end > start) {
+      track_event_config.add_enabled_categories(
+          category_list.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+
+  perfetto::TraceConfig trace_config;
+  trace_config.add_buffers()->set_size_kb(64 * 1024);
+  auto* data_source_config = trace_config.add_data_sources()->mutable_config();
+  data_source_config->set_name("track_event");
+  data_source_config->set_track_event_config_raw(
+      track_event_config.SerializeAsString());
+
+  _perfetto.session = perfetto::Tracing::NewTrace(perfetto::kInProcessBackend);
+  _perfetto.session->Setup(trace_config, fd);
+  _perfetto.session->StartBlocking();
+  _perfetto.session_fd = fd;
+}
+
+}  // namespace
+
+void iree_tracing_perfetto_initialize(void) {
+  if (_perfetto.initialized.load(std::memory_order_acquire)) return;
+
+  const char* trace_file = getenv("IREE_PERFETTO_TRACE_FILE");
+  bool has_trace_file = trace_file && trace_file[0];
+
+  perfetto::TracingInitArgs args;
+  args.backends = perfetto::kSystemBackend;
+  if (has_trace_file) args.backends |= perfetto::kInProcessBackend;
+  perfetto::Tracing::Initialize(args);
+  perfetto::TrackEvent::Register();
+  _perfetto.initialized.store(true, std::memory_order_release);
+
+  if (has_trace_file) iree_tracing_perfetto_start_file_session(trace_file);
+}
+
+void iree_tracing_perfetto_deinitialize(void) {
+  if (!_perfetto.initialized.load(std::memory_order_acquire)) return;
+  perfetto::TrackEvent::Flush();
+  if (_perfetto.session) {
+    _perfetto.session->StopBlocking();
+    _perfetto.session.reset();
+    IREE_PERFETTO_CLOSE(_perfetto.session_fd);
+    _perfetto.session_fd = -1;
+  }
+}
+
+void iree_tracing_perfetto_set_enabled(bool enabled) {
+  _perfetto.enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void iree_tracing_set_thread_name(const char* name) {
+  if (!_perfetto.initialized.load(std::memory_order_acquire)) return;
+  auto track = perfetto::ThreadTrack::Current();
+  auto descriptor = track.Serialize();
+  descriptor.mutable_thread()->set_thread_name(name);
+  perfetto::TrackEvent::SetTrackDescriptor(track, descriptor);
+}
+
+iree_zone_id_t iree_tracing_zone_begin_impl(
+    const iree_tracing_location_t* src_loc, const char* name,
+    size_t name_length) {
+  if (!iree_tracing_perfetto_is_recording()) return 0;
+  if (name) {
+    TRACE_EVENT_BEGIN("iree", perfetto::DynamicString(name, name_length));
+  } else if (src_loc->name) {
+    TRACE_EVENT_BEGIN("iree", perfetto::StaticString(src_loc->name));
+  } else {
+    TRACE_EVENT_BEGIN("iree", perfetto::StaticString(src_loc->function_name));
+  }
+  return 1;
+}
+
+iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length) {
+  if (!iree_tracing_perfetto_is_recording()) return 0;
+  std::string file(file_name, file_name_length);
+  if (name) {
+    TRACE_EVENT_BEGIN("iree", perfetto::DynamicString(name, name_length),
+                      "file", file, "line", line);
+  } else {
+    TRACE_EVENT_BEGIN(
+        "iree", perfetto::DynamicString(function_name, function_name_length),
+        "file", file, "line", line);
+  }
+  return 1;
+}
+
+void iree_tracing_zone_end(iree_zone_id_t zone_id) {
+  // Zones that began while recording was disabled have no slice to end.
+  if (!zone_id) return;
+  TRACE_EVENT_END("iree");
+}
+
+void iree_tracing_zone_append_value_i64(iree_zone_id_t zone_id,
+                                        int64_t value) {
+  if (!zone_id) return;
+  TRACE_EVENT_INSTANT("iree", "value", "value", value);
+}
+
+void iree_tracing_zone_append_text(iree_zone_id_t zone_id, const char* value,
+                                   size_t value_length) {
+  if (!zone_id) return;
+  TRACE_EVENT_INSTANT("iree", perfetto::DynamicString(value, value_length));
+}
+
+void iree_tracing_plot_value_i64_impl(const char* name_literal,
+                                      int64_t value) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_COUNTER("iree.counters", perfetto::CounterTrack(name_literal), value);
+}
+
+void iree_tracing_plot_value_f64_impl(const char* name_literal, double value) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_COUNTER("iree.counters", perfetto::CounterTrack(name_literal), value);
+}
+
+void iree_tracing_frame_mark_impl(const char* name_literal) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_EVENT_INSTANT("iree",
+                      perfetto::StaticString(name_literal ? name_literal
+                                                          : "frame"),
+                      perfetto::Track::Global(0));
+}
+
+// Named frames are tracked on a global track per name so that they may begin
+// and end on different threads.
+void iree_tracing_frame_mark_begin_impl(const char* name_literal) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_EVENT_BEGIN("iree", perfetto::StaticString(name_literal),
+                    perfetto::Track::Global((uintptr_t)name_literal));
+}
+
+void iree_tracing_frame_mark_end_impl(const char* name_literal) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_EVENT_END("iree", perfetto::Track::Global((uintptr_t)name_literal));
+}
+
+void iree_tracing_message_cstring(const char* value, uint32_t color) {
+  iree_tracing_message_string_view(value, strlen(value), color);
+}
+
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  TRACE_EVENT_INSTANT("iree.messages",
+                      perfetto::DynamicString(value, value_length), "color",
+                      color);
+}
+
+// Flows are attached to instant events on the calling thread which Perfetto
+// nests within whichever zone is open on the thread at the time.
+void iree_tracing_flow_impl(uint64_t flow_id, bool terminating) {
+  if (!_perfetto.enabled.load(std::memory_order_relaxed)) return;
+  if (terminating) {
+    TRACE_EVENT_INSTANT("iree.flows", "flow_end",
+                        perfetto::TerminatingFlow::ProcessScoped(flow_id));
+  } else {
+    TRACE_EVENT_INSTANT("iree.flows", "flow",
+                        perfetto::Flow::ProcessScoped(flow_id));
+  }
+}
+
+#endif  // IREE_TRACING_FEATURES
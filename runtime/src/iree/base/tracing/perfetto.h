@@ -0,0 +1,309 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Perfetto SDK tracing provider: https://perfetto.dev/docs/instrumentation/
+//
+// Zones are emitted as Perfetto track events on the thread tracks of the
+// calling threads, plots as counter tracks, messages as instant events, and
+// flows (IREE_TRACE_FLOW_*) as Perfetto flows so that queue submissions can be
+// followed to the threads executing them. By default events are routed to the
+// system tracing service (traced) so that IREE spans appear in system-wide
+// traces alongside the GPU driver and the hosting application and are only
+// recorded while a system trace including the `iree*` categories is active.
+//
+// Categories:
+//   iree           zones and frame marks
+//   iree.counters  plotted values
+//   iree.flows     cross-thread flows
+//   iree.messages  log messages
+//
+// Environment variables read on IREE_TRACE_APP_ENTER:
+//   IREE_PERFETTO_TRACE_FILE: when set an in-process tracing session is
+//     started and written to the given path on IREE_TRACE_APP_EXIT. Useful on
+//     machines without traced.
+//   IREE_PERFETTO_CATEGORIES: comma-separated list of category patterns
+//     enabled in the in-process session (default `iree*`).
+//
+// Recording can be toggled at runtime with iree_tracing_perfetto_set_enabled.
+// When disabled or when no session has enabled a category the cost of a zone
+// is a few loads and a branch.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/attributes.h"
+#include "iree/base/config.h"
+
+#ifndef IREE_BASE_TRACING_PERFETTO_H_
+#define IREE_BASE_TRACING_PERFETTO_H_
+
+//===----------------------------------------------------------------------===//
+// Perfetto tracing configuration
+//===----------------------------------------------------------------------===//
+
+// Filter to only supported features.
+// Allocation tracking is left to heapprofd and device instrumentation to the
+// GPU driver data sources of the system trace.
+#if !defined(IREE_TRACING_FEATURES)
+#define IREE_TRACING_FEATURES          \
+  ((IREE_TRACING_FEATURES_REQUESTED) & \
+   (IREE_TRACING_FEATURE_INSTRUMENTATION | IREE_TRACING_FEATURE_LOG_MESSAGES))
+#endif  // !IREE_TRACING_FEATURES
+
+//===----------------------------------------------------------------------===//
+// C API used for tracing control
+//===----------------------------------------------------------------------===//
+// These functions are implementation details and should not be called directly.
+// Always use the macros (or C++ RAII types).
+
+// Local zone ID used for the C IREE_TRACE_ZONE_* macros.
+// 0 indicates the zone was not recorded and must not be ended.
+typedef uint32_t iree_zone_id_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#if IREE_TRACING_FEATURES
+
+#define IREE_TRACE_IMPL_CONCAT(x, y) IREE_TRACE_IMPL_CONCAT2(x, y)
+#define IREE_TRACE_IMPL_CONCAT2(x, y) x##y
+
+#define IREE_TRACE_STRLEN(literal) (sizeof(literal) - 1)
+
+typedef struct iree_tracing_location_t {
+  const char* name;
+  size_t name_length;
+  const char* function_name;
+  size_t function_name_length;
+  const char* file_name;
+  size_t file_name_length;
+  uint32_t line;
+  uint32_t color;
+} iree_tracing_location_t;
+
+void iree_tracing_perfetto_initialize(void);
+void iree_tracing_perfetto_deinitialize(void);
+
+// Enables or disables recording of all IREE events at runtime. Enabled by
+// default. Zones open when recording is disabled are still properly ended.
+void iree_tracing_perfetto_set_enabled(bool enabled);
+
+void iree_tracing_set_thread_name(const char* name);
+
+IREE_MUST_USE_RESULT iree_zone_id_t
+iree_tracing_zone_begin_impl(const iree_tracing_location_t* src_loc,
+                             const char* name, size_t name_length);
+IREE_MUST_USE_RESULT iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length);
+void iree_tracing_zone_end(iree_zone_id_t zone_id);
+
+void iree_tracing_zone_append_value_i64(iree_zone_id_t zone_id, int64_t value);
+void iree_tracing_zone_append_text(iree_zone_id_t zone_id, const char* value,
+                                   size_t value_length);
+
+void iree_tracing_plot_value_i64_impl(const char* name_literal, int64_t value);
+void iree_tracing_plot_value_f64_impl(const char* name_literal, double value);
+
+void iree_tracing_frame_mark_impl(const char* name_literal);
+void iree_tracing_frame_mark_begin_impl(const char* name_literal);
+void iree_tracing_frame_mark_end_impl(const char* name_literal);
+
+void iree_tracing_message_cstring(const char* value, uint32_t color);
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color);
+
+void iree_tracing_flow_impl(uint64_t flow_id, bool terminating);
+
+#endif  // IREE_TRACING_FEATURES
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Instrumentation macros (C)
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#define IREE_TRACE(expr) expr
+
+#define IREE_TRACE_APP_ENTER() iree_tracing_perfetto_initialize()
+#define IREE_TRACE_APP_EXIT(exit_code) iree_tracing_perfetto_deinitialize()
+#define IREE_TRACE_SET_APP_INFO(value, value_length)
+#define IREE_TRACE_SET_THREAD_NAME(name) iree_tracing_set_thread_name(name)
+
+#define IREE_TRACE_FIBER_ENTER(fiber)
+#define IREE_TRACE_FIBER_LEAVE()
+
+#define IREE_TRACE_ZONE_BEGIN(zone_id) \
+  IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, NULL)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, name_literal)                     \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(                 \
+      __iree_tracing_source_location, __LINE__) = {                            \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),                     \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),                     \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),                         \
+      (uint32_t)__LINE__, 0};                                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                       \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), NULL, \
+      0)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(zone_id, name, name_length)  \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(           \
+      __iree_tracing_source_location, __LINE__) = {                      \
+      NULL,                                                              \
+      0,                                                                 \
+      __FUNCTION__,                                                      \
+      IREE_TRACE_STRLEN(__FUNCTION__),                                   \
+      __FILE__,                                                          \
+      IREE_TRACE_STRLEN(__FILE__),                                       \
+      (uint32_t)__LINE__,                                                \
+      0};                                                                \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                 \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), \
+      (name), (name_length))
+
+#define IREE_TRACE_ZONE_BEGIN_EXTERNAL(                                       \
+    zone_id, file_name, file_name_length, line, function_name,                \
+    function_name_length, name, name_length)                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_external_impl(             \
+      file_name, file_name_length, line, function_name, function_name_length, \
+      name, name_length)
+
+#define IREE_TRACE_ZONE_END(zone_id) iree_tracing_zone_end(zone_id)
+
+#define IREE_RETURN_AND_END_ZONE_IF_ERROR(zone_id, ...) \
+  IREE_RETURN_AND_EVAL_IF_ERROR(IREE_TRACE_ZONE_END(zone_id), __VA_ARGS__)
+
+// Perfetto assigns slice colors itself.
+#define IREE_TRACE_ZONE_SET_COLOR(zone_id, color_xbgr)
+
+// Perfetto slices cannot have arguments added after they begin so appended
+// values are recorded as instant events nested within the zone.
+#define IREE_TRACE_ZONE_APPEND_VALUE_I64(zone_id, value) \
+  iree_tracing_zone_append_value_i64(zone_id, (int64_t)(value))
+#define IREE_TRACE_ZONE_APPEND_TEXT(...)                                  \
+  IREE_TRACE_IMPL_GET_VARIADIC_((__VA_ARGS__,                             \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW, \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_CSTRING))    \
+  (__VA_ARGS__)
+#define IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(zone_id, value) \
+  IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(zone_id, value, strlen(value))
+#define IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(zone_id, value, value_length) \
+  iree_tracing_zone_append_text(zone_id, value, value_length)
+
+// Counter tracks are configured by the trace processor.
+#define IREE_TRACE_SET_PLOT_TYPE(name_literal, plot_type, step, fill, color) \
+  (void)(name_literal), (void)(plot_type), (void)(step), (void)(fill),       \
+      (void)(color)
+#define IREE_TRACE_PLOT_VALUE_I64(name_literal, value) \
+  iree_tracing_plot_value_i64_impl(name_literal, (int64_t)(value))
+#define IREE_TRACE_PLOT_VALUE_F32(name_literal, value) \
+  iree_tracing_plot_value_f64_impl(name_literal, (double)(value))
+#define IREE_TRACE_PLOT_VALUE_F64(name_literal, value) \
+  iree_tracing_plot_value_f64_impl(name_literal, (double)(value))
+
+#define IREE_TRACE_FRAME_MARK() iree_tracing_frame_mark_impl(NULL)
+#define IREE_TRACE_FRAME_MARK_NAMED(name_literal) \
+  iree_tracing_frame_mark_impl(name_literal)
+#define IREE_TRACE_FRAME_MARK_BEGIN_NAMED(name_literal) \
+  iree_tracing_frame_mark_begin_impl(name_literal)
+#define IREE_TRACE_FRAME_MARK_END_NAMED(name_literal) \
+  iree_tracing_frame_mark_end_impl(name_literal)
+
+#define IREE_TRACE_MESSAGE(level, value_literal) \
+  iree_tracing_message_cstring(value_literal,    \
+                               IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_COLORED(color, value_literal) \
+  iree_tracing_message_cstring(value_literal, color)
+#define IREE_TRACE_MESSAGE_DYNAMIC(level, value, value_length) \
+  iree_tracing_message_string_view(value, value_length,        \
+                                   IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length) \
+  iree_tracing_message_string_view(value, value_length, color)
+
+#define IREE_TRACE_FLOW_BEGIN(flow_id) \
+  iree_tracing_flow_impl((uint64_t)(flow_id), false)
+#define IREE_TRACE_FLOW_STEP(flow_id) \
+  iree_tracing_flow_impl((uint64_t)(flow_id), false)
+#define IREE_TRACE_FLOW_END(flow_id) \
+  iree_tracing_flow_impl((uint64_t)(flow_id), true)
+
+// Utilities:
+#define IREE_TRACE_IMPL_GET_VARIADIC_HELPER_(_1, _2, _3, NAME, ...) NAME
+#define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
+  IREE_TRACE_IMPL_GET_VARIADIC_HELPER_ args
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+//===----------------------------------------------------------------------===//
+// Instrumentation C++ RAII types, wrappers, and macros
+//===----------------------------------------------------------------------===//
+
+#ifdef __cplusplus
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+namespace iree {
+
+class ScopedZone {
+ public:
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone(ScopedZone&&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+  ScopedZone& operator=(ScopedZone&&) = delete;
+
+  IREE_ATTRIBUTE_ALWAYS_INLINE ScopedZone(
+      const iree_tracing_location_t* src_loc) {
+    zone_id_ = iree_tracing_zone_begin_impl(src_loc, NULL, 0);
+  }
+  IREE_ATTRIBUTE_ALWAYS_INLINE ~ScopedZone() { IREE_TRACE_ZONE_END(zone_id_); }
+
+  operator iree_zone_id_t() const noexcept { return zone_id_; }
+
+ private:
+  iree_zone_id_t zone_id_;
+};
+
+}  // namespace iree
+
+#define IREE_TRACE_SCOPE()                                         \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      nullptr,                                                     \
+      0,                                                           \
+      __FUNCTION__,                                                \
+      IREE_TRACE_STRLEN(__FUNCTION__),                             \
+      __FILE__,                                                    \
+      IREE_TRACE_STRLEN(__FILE__),                                 \
+      (uint32_t)__LINE__,                                          \
+      0};                                                          \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_NAMED(name_literal)                       \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),         \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),         \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),             \
+      (uint32_t)__LINE__, 0};                                      \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_ID ___iree_tracing_scoped_zone
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_TRACING_PERFETTO_H_
@@ -276,6 +276,11 @@ void* iree_tracing_obscure_ptr(void* ptr);
 #define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length) \
   ___tracy_emit_messageC(value, value_length, color, 0)
 
+// Tracy has no flow visualization.
+#define IREE_TRACE_FLOW_BEGIN(flow_id)
+#define IREE_TRACE_FLOW_STEP(flow_id)
+#define IREE_TRACE_FLOW_END(flow_id)
+
 // Utilities:
 #define IREE_TRACE_IMPL_GET_VARIADIC_HELPER_(_1, _2, _3, NAME, ...) NAME
 #define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
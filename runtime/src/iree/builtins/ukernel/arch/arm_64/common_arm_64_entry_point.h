@@ -17,6 +17,7 @@
 #define IREE_UK_BUILD_ARM_64_BF16
 #define IREE_UK_BUILD_ARM_64_DOTPROD
 #define IREE_UK_BUILD_ARM_64_I8MM
+#define IREE_UK_BUILD_ARM_64_SVE
 #else
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/arm_64/config_arm_64.h"
@@ -54,4 +55,24 @@ static inline bool iree_uk_cpu_supports_i8mm(const iree_uk_uint64_t* cpu_data) {
 }
 #endif  // IREE_UK_BUILD_ARM_64_I8MM
 
+#if defined(IREE_UK_BUILD_ARM_64_SVE)
+static inline bool iree_uk_cpu_supports_sve(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_ARM_64_SVE);
+}
+
+// Returns the number of 32-bit lanes in a SVE vector on the current CPU.
+// Defined in SVE code: only call this after iree_uk_cpu_supports_sve.
+iree_uk_int32_t iree_uk_arm_64_sve_vector_length_32bit_lanes(void);
+
+// The SVE kernels are only used when SVE vectors are wider than NEON's. On
+// 128-bit SVE implementations the NEON kernels are just as good and use the
+// tile sizes that the compiler expects by default.
+static inline iree_uk_int32_t iree_uk_arm_64_sve_wide_lanes(
+    const iree_uk_uint64_t* cpu_data) {
+  if (!iree_uk_cpu_supports_sve(cpu_data)) return 0;
+  iree_uk_int32_t lanes = iree_uk_arm_64_sve_vector_length_32bit_lanes();
+  return lanes >= 8 ? lanes : 0;
+}
+#endif  // IREE_UK_BUILD_ARM_64_SVE
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_COMMON_ARM_64_ENTRY_POINT_H_
@@ -0,0 +1,57 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/layernorm_arm_64_internal.h"
+
+// Same as iree_uk_layernorm_row_generic_f32f32, vectorized.
+void iree_uk_layernorm_row_f32f32_arm_64(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale, const void* IREE_UK_RESTRICT bias,
+    const iree_uk_layernorm_params_t* params) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  const float* IREE_UK_RESTRICT scale_ptr = scale;
+  const float* IREE_UK_RESTRICT bias_ptr = bias;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  iree_uk_index_t size = params->size1;
+  iree_uk_index_t i;
+  float mean = 0.0f;
+  if (!(params->flags & IREE_UK_FLAG_LAYERNORM_RMS)) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (i = 0; i + 4 <= size; i += 4) {
+      acc = vaddq_f32(acc, vld1q_f32(in_ptr + i));
+    }
+    float sum = vaddvq_f32(acc);
+    for (; i < size; ++i) sum += in_ptr[i];
+    mean = sum / (float)size;
+  }
+  float32x4_t mean_bcast = vdupq_n_f32(mean);
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  for (i = 0; i + 4 <= size; i += 4) {
+    float32x4_t d = vsubq_f32(vld1q_f32(in_ptr + i), mean_bcast);
+    acc = vfmaq_f32(acc, d, d);
+  }
+  float sum_squares = vaddvq_f32(acc);
+  for (; i < size; ++i) {
+    float d = in_ptr[i] - mean;
+    sum_squares += d * d;
+  }
+  float inv_stddev =
+      iree_uk_rsqrt_f32(sum_squares / (float)size + params->epsilon);
+  for (i = 0; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(in_ptr + i);
+    float32x4_t y = vmulq_n_f32(vsubq_f32(x, mean_bcast), inv_stddev);
+    if (scale_ptr) y = vmulq_f32(y, vld1q_f32(scale_ptr + i));
+    if (bias_ptr) y = vaddq_f32(y, vld1q_f32(bias_ptr + i));
+    vst1q_f32(out_ptr + i, y);
+  }
+  for (; i < size; ++i) {
+    float y = (in_ptr[i] - mean) * inv_stddev;
+    if (scale_ptr) y *= scale_ptr[i];
+    if (bias_ptr) y += bias_ptr[i];
+    out_ptr[i] = y;
+  }
+}
@@ -82,6 +82,84 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8(
     iree_uk_mmt4d_tile_f32f32f32_4x8x1_arm_64,
     iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64)
 
+// Weight-only quantized case. Same as the f32f32f32 kernel except that the
+// RHS is loaded as i8 and converted to f32 in registers.
+static inline void iree_uk_mmt4d_tile_f32i8f32_1x8x1_to_8x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  float32x4_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vld1q_f32(out_ptr + 4 * i);
+    }
+  } else {
+    for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vdupq_n_f32(0);
+    }
+  }
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    // Sign-extend the 8 i8 RHS values and convert them to f32.
+    int16x8_t rhs_i16 = vmovl_s8(vld1_s8(rhs_ptr));
+    rhs_ptr += 8;
+    float32x4_t rhs[2];
+    rhs[0] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(rhs_i16)));
+    rhs[1] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(rhs_i16)));
+
+    if (M0 == 1) {
+      float lhs = *lhs_ptr++;
+      acc[0] = vfmaq_n_f32(acc[0], rhs[0], lhs);
+      acc[1] = vfmaq_n_f32(acc[1], rhs[1], lhs);
+    } else if (M0 == 2) {
+      float32x2_t lhs = vld1_f32(lhs_ptr);
+      lhs_ptr += 2;
+      acc[0] = vfmaq_lane_f32(acc[0], rhs[0], lhs, 0);
+      acc[1] = vfmaq_lane_f32(acc[1], rhs[1], lhs, 0);
+      acc[2] = vfmaq_lane_f32(acc[2], rhs[0], lhs, 1);
+      acc[3] = vfmaq_lane_f32(acc[3], rhs[1], lhs, 1);
+    } else {
+      float32x4_t lhs[2];
+      for (int i = 0; i < M0 / 4; ++i) {
+        lhs[i] = vld1q_f32(lhs_ptr + 4 * i);
+      }
+      lhs_ptr += M0;
+      acc[0] = vfmaq_lane_f32(acc[0], rhs[0], vget_low_f32(lhs[0]), 0);
+      acc[1] = vfmaq_lane_f32(acc[1], rhs[1], vget_low_f32(lhs[0]), 0);
+      acc[2] = vfmaq_lane_f32(acc[2], rhs[0], vget_low_f32(lhs[0]), 1);
+      acc[3] = vfmaq_lane_f32(acc[3], rhs[1], vget_low_f32(lhs[0]), 1);
+      acc[4] = vfmaq_lane_f32(acc[4], rhs[0], vget_high_f32(lhs[0]), 0);
+      acc[5] = vfmaq_lane_f32(acc[5], rhs[1], vget_high_f32(lhs[0]), 0);
+      acc[6] = vfmaq_lane_f32(acc[6], rhs[0], vget_high_f32(lhs[0]), 1);
+      acc[7] = vfmaq_lane_f32(acc[7], rhs[1], vget_high_f32(lhs[0]), 1);
+      if (M0 == 8) {
+        acc[8] = vfmaq_lane_f32(acc[8], rhs[0], vget_low_f32(lhs[1]), 0);
+        acc[9] = vfmaq_lane_f32(acc[9], rhs[1], vget_low_f32(lhs[1]), 0);
+        acc[10] = vfmaq_lane_f32(acc[10], rhs[0], vget_low_f32(lhs[1]), 1);
+        acc[11] = vfmaq_lane_f32(acc[11], rhs[1], vget_low_f32(lhs[1]), 1);
+        acc[12] = vfmaq_lane_f32(acc[12], rhs[0], vget_high_f32(lhs[1]), 0);
+        acc[13] = vfmaq_lane_f32(acc[13], rhs[1], vget_high_f32(lhs[1]), 0);
+        acc[14] = vfmaq_lane_f32(acc[14], rhs[0], vget_high_f32(lhs[1]), 1);
+        acc[15] = vfmaq_lane_f32(acc[15], rhs[1], vget_high_f32(lhs[1]), 1);
+      }
+    }
+  }
+  for (int i = 0; i < 2 * M0; ++i) {
+    vst1q_f32(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8(
+    iree_uk_mmt4d_tile_f32i8f32_1x8x1_to_8x8x1_arm_64,
+    iree_uk_mmt4d_tile_f32i8f32_1x8x1_arm_64,
+    iree_uk_mmt4d_tile_f32i8f32_2x8x1_arm_64,
+    iree_uk_mmt4d_tile_f32i8f32_4x8x1_arm_64,
+    iree_uk_mmt4d_tile_f32i8f32_8x8x1_arm_64)
+
 // Shared implementation for f16f16f16 and f16f16f32.
 // In the f16f16f16 case, intermediate roundings are skipped. This function
 // should only be used if IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
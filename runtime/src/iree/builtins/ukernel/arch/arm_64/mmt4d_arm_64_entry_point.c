@@ -23,15 +23,65 @@ iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32_M0x8x1(
   return 0;
 }
 
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32_M0xVLx1(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  if (params->N0 == iree_uk_arm_64_sve_wide_lanes(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_f32f32f32_1xVLx1_arm_64_sve;
+      case 2:
+        return iree_uk_mmt4d_tile_f32f32f32_2xVLx1_arm_64_sve;
+      case 4:
+        return iree_uk_mmt4d_tile_f32f32f32_4xVLx1_arm_64_sve;
+      case 8:
+        return iree_uk_mmt4d_tile_f32f32f32_8xVLx1_arm_64_sve;
+    }
+  }
+#endif
+  return 0;
+}
+
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32(
     const iree_uk_mmt4d_params_t* params) {
+  if (params->K0 == 1) {
+    iree_uk_mmt4d_tile_func_t tile_func =
+        iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32_M0xVLx1(params);
+    if (tile_func) return tile_func;
+  }
   if (params->N0 == 8 && params->K0 == 1) {
     return iree_uk_mmt4d_select_tile_func_arm_64_f32f32f32_M0x8x1(params);
   }
   return 0;
 }
 
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_arm_64_f32i8f32_M0x8x1(
+    const iree_uk_mmt4d_params_t* params) {
+  switch (params->M0) {
+    case 1:
+      return iree_uk_mmt4d_tile_f32i8f32_1x8x1_arm_64;
+    case 2:
+      return iree_uk_mmt4d_tile_f32i8f32_2x8x1_arm_64;
+    case 4:
+      return iree_uk_mmt4d_tile_f32i8f32_4x8x1_arm_64;
+    case 8:
+      return iree_uk_mmt4d_tile_f32i8f32_8x8x1_arm_64;
+  }
+  return 0;
+}
+
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_arm_64_f32i8f32(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_tile_func_arm_64_f32i8f32_M0x8x1(params);
+  }
+  return 0;
+}
+
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_arm_64_f16f16f32_M0x8x1(
     const iree_uk_mmt4d_params_t* params) {
@@ -203,8 +253,33 @@ iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_M0x8x8(
   return 0;
 }
 
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_M0xVLx4(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  if (params->N0 == iree_uk_arm_64_sve_wide_lanes(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_i8i8i32_1xVLx4_arm_64_sve;
+      case 2:
+        return iree_uk_mmt4d_tile_i8i8i32_2xVLx4_arm_64_sve;
+      case 4:
+        return iree_uk_mmt4d_tile_i8i8i32_4xVLx4_arm_64_sve;
+      case 8:
+        return iree_uk_mmt4d_tile_i8i8i32_8xVLx4_arm_64_sve;
+    }
+  }
+#endif
+  return 0;
+}
+
 static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32(
     const iree_uk_mmt4d_params_t* params) {
+  if (params->K0 == 4) {
+    iree_uk_mmt4d_tile_func_t tile_func =
+        iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_M0xVLx4(params);
+    if (tile_func) return tile_func;
+  }
   if (params->N0 == 8 && params->K0 == 1) {
     return iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32_M0x8x1(params);
   }
@@ -232,8 +307,33 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
       return iree_uk_mmt4d_select_tile_func_arm_64_bf16bf16bf16(params);
     case iree_uk_mmt4d_type_i8i8i32:
       return iree_uk_mmt4d_select_tile_func_arm_64_i8i8i32(params);
+    case iree_uk_mmt4d_type_f32i8f32:
+      return iree_uk_mmt4d_select_tile_func_arm_64_f32i8f32(params);
     default:
       IREE_UK_ASSUME_UNREACHABLE;
       return 0;
   }
 }
+
+// Processor identification as in data field 7 of cpu_data, for use in
+// mmt4d_arm_64_tuning_db.inl.
+#define IREE_UK_CPU_ID_ARM_64(IMPLEMENTER, PARTNUM)                    \
+  (((iree_uk_uint64_t)(IMPLEMENTER)                                    \
+    << IREE_CPU_DATA7_ARM_64_IMPLEMENTER_SHIFT) |                      \
+   ((iree_uk_uint64_t)(PARTNUM) << IREE_CPU_DATA7_ARM_64_PARTNUM_SHIFT))
+
+static const iree_uk_mmt4d_tuning_entry_t iree_uk_mmt4d_tuning_db_arm_64[] = {
+#define IREE_UK_MMT4D_TUNING_ENTRY(CPU_ID, TYPE, M0, N0, K0, BUCKET, N_BLOCK, \
+                                   PREFETCH)                                  \
+  {CPU_ID, IREE_UK_FLAG_MMT4D_TYPE_##TYPE, M0, N0, K0,                        \
+   iree_uk_mmt4d_shape_bucket_##BUCKET, {N_BLOCK, PREFETCH}},
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_tuning_db.inl"
+#undef IREE_UK_MMT4D_TUNING_ENTRY
+    {0},
+};
+
+bool iree_uk_mmt4d_lookup_tuning_arch(const iree_uk_mmt4d_params_t* params,
+                                      iree_uk_mmt4d_tuning_t* out_tuning) {
+  return iree_uk_mmt4d_search_tuning_db(iree_uk_mmt4d_tuning_db_arm_64, params,
+                                        out_tuning);
+}
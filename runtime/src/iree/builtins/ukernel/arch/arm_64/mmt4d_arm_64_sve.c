@@ -0,0 +1,148 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_sve.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_internal.h"
+
+// The kernels in this file are vector-length-agnostic: N0 is the number of
+// 32-bit lanes in a SVE vector (VL), so that each row of the accumulator tile
+// is exactly one SVE register. The entry point only selects them when N0
+// matches the VL of the CPU we are running on.
+//
+// SVE types are sizeless and can't be array elements, so unlike the NEON
+// kernels the accumulators are individual variables. M0 is a compile-time
+// constant in each instantiation, so unused accumulators are DCE'd.
+
+iree_uk_int32_t iree_uk_arm_64_sve_vector_length_32bit_lanes(void) {
+  return svcntw();
+}
+
+static inline void iree_uk_mmt4d_tile_f32f32f32_1xVLx1_to_8xVLx1_arm_64_sve(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int32_t vl = svcntw();
+  IREE_UK_ASSERT(params->N0 == vl);
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const svbool_t pg = svptrue_b32();
+  // Only the first min(M0, 4) lanes of each LHS load are used.
+  const svbool_t lhs_pg = svwhilelt_b32_s32(0, M0 < 4 ? M0 : 4);
+  svfloat32_t acc0 = svdup_n_f32(0), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+  svfloat32_t acc4 = acc0, acc5 = acc0, acc6 = acc0, acc7 = acc0;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = svld1_f32(pg, out_ptr + 0 * vl);
+    if (M0 >= 2) acc1 = svld1_f32(pg, out_ptr + 1 * vl);
+    if (M0 >= 4) acc2 = svld1_f32(pg, out_ptr + 2 * vl);
+    if (M0 >= 4) acc3 = svld1_f32(pg, out_ptr + 3 * vl);
+    if (M0 >= 8) acc4 = svld1_f32(pg, out_ptr + 4 * vl);
+    if (M0 >= 8) acc5 = svld1_f32(pg, out_ptr + 5 * vl);
+    if (M0 >= 8) acc6 = svld1_f32(pg, out_ptr + 6 * vl);
+    if (M0 >= 8) acc7 = svld1_f32(pg, out_ptr + 7 * vl);
+  }
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    svfloat32_t rhs = svld1_f32(pg, rhs_ptr);
+    rhs_ptr += vl;
+    // svld1rq replicates the (up to) 4 LHS values into each 128-bit segment,
+    // which is what the indexed FMLA reads from.
+    svfloat32_t lhs0 = svld1rq_f32(lhs_pg, lhs_ptr);
+    acc0 = svmla_lane_f32(acc0, rhs, lhs0, 0);
+    if (M0 >= 2) acc1 = svmla_lane_f32(acc1, rhs, lhs0, 1);
+    if (M0 >= 4) acc2 = svmla_lane_f32(acc2, rhs, lhs0, 2);
+    if (M0 >= 4) acc3 = svmla_lane_f32(acc3, rhs, lhs0, 3);
+    if (M0 >= 8) {
+      svfloat32_t lhs1 = svld1rq_f32(pg, lhs_ptr + 4);
+      acc4 = svmla_lane_f32(acc4, rhs, lhs1, 0);
+      acc5 = svmla_lane_f32(acc5, rhs, lhs1, 1);
+      acc6 = svmla_lane_f32(acc6, rhs, lhs1, 2);
+      acc7 = svmla_lane_f32(acc7, rhs, lhs1, 3);
+    }
+    lhs_ptr += M0;
+  }
+  svst1_f32(pg, out_ptr + 0 * vl, acc0);
+  if (M0 >= 2) svst1_f32(pg, out_ptr + 1 * vl, acc1);
+  if (M0 >= 4) svst1_f32(pg, out_ptr + 2 * vl, acc2);
+  if (M0 >= 4) svst1_f32(pg, out_ptr + 3 * vl, acc3);
+  if (M0 >= 8) svst1_f32(pg, out_ptr + 4 * vl, acc4);
+  if (M0 >= 8) svst1_f32(pg, out_ptr + 5 * vl, acc5);
+  if (M0 >= 8) svst1_f32(pg, out_ptr + 6 * vl, acc6);
+  if (M0 >= 8) svst1_f32(pg, out_ptr + 7 * vl, acc7);
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8(
+    iree_uk_mmt4d_tile_f32f32f32_1xVLx1_to_8xVLx1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_1xVLx1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_2xVLx1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_4xVLx1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_8xVLx1_arm_64_sve)
+
+static inline void iree_uk_mmt4d_tile_i8i8i32_1xVLx4_to_8xVLx4_arm_64_sve(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int32_t vl = svcntw();
+  IREE_UK_ASSERT(params->N0 == vl);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const svbool_t pg32 = svptrue_b32();
+  const svbool_t pg8 = svptrue_b8();
+  // Only the first min(M0, 4) groups of 4 bytes of each LHS load are used.
+  const svbool_t lhs_pg = svwhilelt_b8_s32(0, 4 * (M0 < 4 ? M0 : 4));
+  svint32_t acc0 = svdup_n_s32(0), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+  svint32_t acc4 = acc0, acc5 = acc0, acc6 = acc0, acc7 = acc0;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = svld1_s32(pg32, out_ptr + 0 * vl);
+    if (M0 >= 2) acc1 = svld1_s32(pg32, out_ptr + 1 * vl);
+    if (M0 >= 4) acc2 = svld1_s32(pg32, out_ptr + 2 * vl);
+    if (M0 >= 4) acc3 = svld1_s32(pg32, out_ptr + 3 * vl);
+    if (M0 >= 8) acc4 = svld1_s32(pg32, out_ptr + 4 * vl);
+    if (M0 >= 8) acc5 = svld1_s32(pg32, out_ptr + 5 * vl);
+    if (M0 >= 8) acc6 = svld1_s32(pg32, out_ptr + 6 * vl);
+    if (M0 >= 8) acc7 = svld1_s32(pg32, out_ptr + 7 * vl);
+  }
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    // The RHS tile is VL groups of 4 bytes: exactly one SVE vector.
+    svint8_t rhs = svld1_s8(pg8, rhs_ptr);
+    rhs_ptr += 4 * vl;
+    svint8_t lhs0 = svld1rq_s8(lhs_pg, lhs_ptr);
+    acc0 = svdot_lane_s32(acc0, rhs, lhs0, 0);
+    if (M0 >= 2) acc1 = svdot_lane_s32(acc1, rhs, lhs0, 1);
+    if (M0 >= 4) acc2 = svdot_lane_s32(acc2, rhs, lhs0, 2);
+    if (M0 >= 4) acc3 = svdot_lane_s32(acc3, rhs, lhs0, 3);
+    if (M0 >= 8) {
+      svint8_t lhs1 = svld1rq_s8(pg8, lhs_ptr + 16);
+      acc4 = svdot_lane_s32(acc4, rhs, lhs1, 0);
+      acc5 = svdot_lane_s32(acc5, rhs, lhs1, 1);
+      acc6 = svdot_lane_s32(acc6, rhs, lhs1, 2);
+      acc7 = svdot_lane_s32(acc7, rhs, lhs1, 3);
+    }
+    lhs_ptr += 4 * M0;
+  }
+  svst1_s32(pg32, out_ptr + 0 * vl, acc0);
+  if (M0 >= 2) svst1_s32(pg32, out_ptr + 1 * vl, acc1);
+  if (M0 >= 4) svst1_s32(pg32, out_ptr + 2 * vl, acc2);
+  if (M0 >= 4) svst1_s32(pg32, out_ptr + 3 * vl, acc3);
+  if (M0 >= 8) svst1_s32(pg32, out_ptr + 4 * vl, acc4);
+  if (M0 >= 8) svst1_s32(pg32, out_ptr + 5 * vl, acc5);
+  if (M0 >= 8) svst1_s32(pg32, out_ptr + 6 * vl, acc6);
+  if (M0 >= 8) svst1_s32(pg32, out_ptr + 7 * vl, acc7);
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8(
+    iree_uk_mmt4d_tile_i8i8i32_1xVLx4_to_8xVLx4_arm_64_sve,
+    iree_uk_mmt4d_tile_i8i8i32_1xVLx4_arm_64_sve,
+    iree_uk_mmt4d_tile_i8i8i32_2xVLx4_arm_64_sve,
+    iree_uk_mmt4d_tile_i8i8i32_4xVLx4_arm_64_sve,
+    iree_uk_mmt4d_tile_i8i8i32_8xVLx4_arm_64_sve)
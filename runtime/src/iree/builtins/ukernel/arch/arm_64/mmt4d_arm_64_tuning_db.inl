@@ -0,0 +1,23 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tuning database for the mmt4d loop nest on arm_64. Included by
+// mmt4d_arm_64_entry_point.c with the following macro defined:
+//
+//   IREE_UK_MMT4D_TUNING_ENTRY(CPU_ID, TYPE, M0, N0, K0, BUCKET, N_BLOCK,
+//                              PREFETCH)
+//
+// where CPU_ID is IREE_UK_CPU_ID_ARM_64(IMPLEMENTER, PARTNUM), TYPE
+// is the suffix of a IREE_UK_FLAG_MMT4D_TYPE_* value, BUCKET is the suffix of a
+// iree_uk_mmt4d_shape_bucket_* value, and N_BLOCK and PREFETCH are the fields
+// of iree_uk_mmt4d_tuning_t. For example:
+//
+//   IREE_UK_MMT4D_TUNING_ENTRY(IREE_UK_CPU_ID_ARM_64(0x41, 0xd48),
+//                              F32F32F32, 16, 16, 1, large_rhs, 8, true)
+//
+// Entries are generated by running tools/mmt4d_tuner on the target machine,
+// which only prints entries for tunings that measurably beat the default one.
+// Shapes and processors without entries use iree_uk_mmt4d_default_tuning().
@@ -15,6 +15,21 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
   iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
   int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
   bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  iree_uk_int32_t sve_lanes = iree_uk_arm_64_sve_wide_lanes(params->cpu_data);
+  if (sve_lanes) {
+    if (esize == 4 && params->out_size2 == 8 &&
+        params->out_size3 == sve_lanes && !transpose) {
+      return iree_uk_pack_tile_8xVL_x32_arm_64_sve_direct;
+    } else if (esize == 4 && params->out_size2 == sve_lanes &&
+               params->out_size3 == 1 && transpose) {
+      return iree_uk_pack_tile_VLx1_x32_arm_64_sve_transpose;
+    } else if (esize == 1 && params->out_size2 == sve_lanes &&
+               params->out_size3 == 4 && transpose) {
+      return iree_uk_pack_tile_VLx4_x8_arm_64_sve_transpose;
+    }
+  }
+#endif
   if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
     // Currently only used for accumulators, which are never transposed.
     return transpose ? 0 : iree_uk_pack_tile_8x8_x32_arm_64_direct;
@@ -18,5 +18,8 @@ IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x8_arm_64_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x4_x8_arm_64_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x8_arm_64_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x32_arm_64_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_VLx1_x32_arm_64_sve_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8xVL_x32_arm_64_sve_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_VLx4_x8_arm_64_sve_transpose)
 
 #endif  // foIREE_BUILTINS_UKERNEL_ARCH_ARM_64_PACK_ARM_64_INTERNAL_H_
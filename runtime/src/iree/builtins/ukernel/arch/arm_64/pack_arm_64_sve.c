@@ -0,0 +1,79 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_sve.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/pack_arm_64_internal.h"
+
+// Pack tile functions for the vector-length-agnostic SVE mmt4d kernels, where
+// VL is the number of 32-bit lanes in a SVE vector.
+
+void iree_uk_pack_tile_VLx1_x32_arm_64_sve_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == svcntw());
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const svbool_t pg = svptrue_b32();
+  for (; outer_size1 > 0; --outer_size1) {
+    svst1_s32(pg, out_ptr, svld1_s32(pg, in_ptr));
+    out_ptr += out_stride1;
+    in_ptr += tile_size1;
+  }
+}
+
+void iree_uk_pack_tile_8xVL_x32_arm_64_sve_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == svcntw());
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const svbool_t pg = svptrue_b32();
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 8; ++i) {
+      svst1_s32(pg, out_ptr + i * tile_size1,
+                svld1_s32(pg, in_ptr + i * in_stride0));
+    }
+    out_ptr += out_stride1;
+    in_ptr += tile_size1;
+  }
+}
+
+void iree_uk_pack_tile_VLx4_x8_arm_64_sve_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == svcntw());
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  // Each of the 4 input rows is VL bytes: a quarter of a SVE vector. ST4
+  // interleaves them, which is exactly the 4x VL -> VL x 4 transposition.
+  const svbool_t pg = svwhilelt_b8_s64(0, tile_size1);
+  for (; outer_size1 > 0; --outer_size1) {
+    svint8x4_t rows = svcreate4_s8(svld1_s8(pg, in_ptr + 0 * in_stride0),
+                                   svld1_s8(pg, in_ptr + 1 * in_stride0),
+                                   svld1_s8(pg, in_ptr + 2 * in_stride0),
+                                   svld1_s8(pg, in_ptr + 3 * in_stride0));
+    svst4_s8(pg, out_ptr, rows);
+    out_ptr += out_stride1;
+    in_ptr += tile_size1;
+  }
+}
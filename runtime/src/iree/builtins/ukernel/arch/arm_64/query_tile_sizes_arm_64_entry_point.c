@@ -10,6 +10,12 @@
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_arm_64_f32f32f32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  iree_uk_int32_t sve_lanes = iree_uk_arm_64_sve_wide_lanes(params->cpu_data);
+  if (sve_lanes) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = sve_lanes};
+  }
+#endif
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
@@ -21,6 +27,13 @@ iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
     return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 8, .N = 8};
   }
 #endif
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  // SVE SDOT, which unlike NEON SDOT does not require the dotprod extension.
+  iree_uk_int32_t sve_lanes = iree_uk_arm_64_sve_wide_lanes(params->cpu_data);
+  if (sve_lanes) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 4, .N = sve_lanes};
+  }
+#endif
 #ifdef IREE_UK_BUILD_ARM_64_DOTPROD
   if (iree_uk_cpu_supports_dotprod(params->cpu_data)) {
     return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 4, .N = 8};
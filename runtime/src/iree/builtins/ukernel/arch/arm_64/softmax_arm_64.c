@@ -0,0 +1,72 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+// Vectorized iree_uk_exp_f32, see there for the algorithm. NEON min/max
+// propagate NaN.
+static inline float32x4_t iree_uk_exp_f32_arm_64(float32x4_t x) {
+  // Lanes below -87 (but not NaN lanes) flush to zero.
+  uint32x4_t keep = vmvnq_u32(vcltq_f32(x, vdupq_n_f32(-87.0f)));
+  x = vminq_f32(x, vdupq_n_f32(88.0f));
+  x = vmaxq_f32(x, vdupq_n_f32(-87.0f));
+  int32x4_t n_s32 = vcvtnq_s32_f32(vmulq_n_f32(x, 1.44269504f));
+  float32x4_t n = vcvtq_f32_s32(n_s32);
+  float32x4_t r = vfmsq_f32(x, n, vdupq_n_f32(0.693359375f));
+  r = vfmaq_f32(r, n, vdupq_n_f32(2.12194440e-4f));
+  float32x4_t p = vdupq_n_f32(1.0f / 720.0f);
+  p = vfmaq_f32(vdupq_n_f32(1.0f / 120.0f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(1.0f / 24.0f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(1.0f / 6.0f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(0.5f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(1.0f), p, r);
+  p = vfmaq_f32(vdupq_n_f32(1.0f), p, r);
+  int32x4_t pow2_n = vshlq_n_s32(vaddq_s32(n_s32, vdupq_n_s32(127)), 23);
+  float32x4_t result = vmulq_f32(p, vreinterpretq_f32_s32(pow2_n));
+  return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(result), keep));
+}
+
+// Same as iree_uk_softmax_row_generic_f32f32, with one running max and sum per
+// lane, combined after the vectorized part of the row.
+void iree_uk_softmax_row_f32f32_arm_64(void* IREE_UK_RESTRICT out_row,
+                                       const void* IREE_UK_RESTRICT in_row,
+                                       iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  float32x4_t max_vec = vdupq_n_f32(-3.40282347e+38f);
+  float32x4_t sum_vec = vdupq_n_f32(0.0f);
+  iree_uk_index_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(in_ptr + i);
+    float32x4_t new_max = vmaxq_f32(max_vec, x);
+    sum_vec = vfmaq_f32(iree_uk_exp_f32_arm_64(vsubq_f32(x, new_max)), sum_vec,
+                        iree_uk_exp_f32_arm_64(vsubq_f32(max_vec, new_max)));
+    max_vec = new_max;
+  }
+  float max = vmaxvq_f32(max_vec);
+  float sum = vaddvq_f32(vmulq_f32(
+      sum_vec, iree_uk_exp_f32_arm_64(vsubq_f32(max_vec, vdupq_n_f32(max)))));
+  for (; i < size; ++i) {
+    float x = in_ptr[i];
+    if (x > max) {
+      sum = sum * iree_uk_exp_f32(max - x) + 1.0f;
+      max = x;
+    } else {
+      sum += iree_uk_exp_f32(x - max);
+    }
+  }
+  float inv_sum = 1.0f / sum;
+  float32x4_t max_bcast = vdupq_n_f32(max);
+  for (i = 0; i + 4 <= size; i += 4) {
+    float32x4_t e =
+        iree_uk_exp_f32_arm_64(vsubq_f32(vld1q_f32(in_ptr + i), max_bcast));
+    vst1q_f32(out_ptr + i, vmulq_n_f32(e, inv_sum));
+  }
+  for (; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
@@ -14,6 +14,12 @@ iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_arch(
   bool transpose = params->flags & IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER;
   // Unpack is currently only used in practice with esize==4 and non-transpose.
   if (esize != 4 || transpose) return 0;
+#ifdef IREE_UK_BUILD_ARM_64_SVE
+  iree_uk_int32_t sve_lanes = iree_uk_arm_64_sve_wide_lanes(params->cpu_data);
+  if (sve_lanes && params->in_size2 == 8 && params->in_size3 == sve_lanes) {
+    return iree_uk_unpack_tile_8xVL_x32_arm_64_sve_direct;
+  }
+#endif
   if (params->in_size2 == 8 && params->in_size3 == 8) {
     return iree_uk_unpack_tile_8x8_x32_arm_64_direct;
   }
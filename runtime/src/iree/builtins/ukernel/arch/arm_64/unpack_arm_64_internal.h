@@ -10,5 +10,6 @@
 #include "iree/builtins/ukernel/unpack_internal.h"
 
 IREE_UK_UNPACK_TILE_FUNC_DECL(iree_uk_unpack_tile_8x8_x32_arm_64_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(iree_uk_unpack_tile_8xVL_x32_arm_64_sve_direct)
 
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_UNPACK_ARM_64_INTERNAL_H_
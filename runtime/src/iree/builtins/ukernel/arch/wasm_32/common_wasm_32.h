@@ -0,0 +1,26 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+
+#include <wasm_simd128.h>
+
+#include "iree/builtins/ukernel/common.h"
+
+// Transposes the 4x4 matrix of 32-bit elements held in |v| in place.
+static inline void iree_uk_wasm_transpose_4x4xi32(v128_t v[4]) {
+  v128_t t0 = wasm_i32x4_shuffle(v[0], v[1], 0, 4, 1, 5);
+  v128_t t1 = wasm_i32x4_shuffle(v[0], v[1], 2, 6, 3, 7);
+  v128_t t2 = wasm_i32x4_shuffle(v[2], v[3], 0, 4, 1, 5);
+  v128_t t3 = wasm_i32x4_shuffle(v[2], v[3], 2, 6, 3, 7);
+  v[0] = wasm_i64x2_shuffle(t0, t2, 0, 2);
+  v[1] = wasm_i64x2_shuffle(t0, t2, 1, 3);
+  v[2] = wasm_i64x2_shuffle(t1, t3, 0, 2);
+  v[3] = wasm_i64x2_shuffle(t1, t3, 1, 3);
+}
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
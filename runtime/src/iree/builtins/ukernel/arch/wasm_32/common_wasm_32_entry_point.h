@@ -0,0 +1,28 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_ENTRY_POINT_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_ENTRY_POINT_H_
+
+#include "iree/builtins/ukernel/common.h"
+#include "iree/schemas/cpu_data.h"
+
+#if defined(IREE_DEVICE_STANDALONE)
+// Standalone builds (e.g. bitcode) use our own Clang, supporting everything.
+#define IREE_UK_BUILD_WASM_32_SIMD128
+#else  // IREE_DEVICE_STANDALONE
+// Compiling with the system toolchain. Include the configured header.
+#include "iree/builtins/ukernel/arch/wasm_32/config_wasm_32.h"
+#endif  // IREE_DEVICE_STANDALONE
+
+#if defined(IREE_UK_BUILD_WASM_32_SIMD128)
+static inline bool iree_uk_cpu_supports_simd128(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_WASM_32_SIMD128);
+}
+#endif  // IREE_UK_BUILD_WASM_32_SIMD128
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_ENTRY_POINT_H_
@@ -0,0 +1,45 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32_entry_point.h"
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32_internal.h"
+
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_wasm_32_f32f32f32_M0x8x1(
+    const iree_uk_mmt4d_params_t* params) {
+#if defined(IREE_UK_BUILD_WASM_32_SIMD128)
+  if (iree_uk_cpu_supports_simd128(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_f32f32f32_1x8x1_wasm_32_simd128;
+      case 2:
+        return iree_uk_mmt4d_tile_f32f32f32_2x8x1_wasm_32_simd128;
+      case 4:
+        return iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128;
+    }
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_wasm_32_f32f32f32(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_tile_func_wasm_32_f32f32f32_M0x8x1(params);
+  }
+  return 0;
+}
+
+iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  switch (iree_uk_mmt4d_type(params->flags)) {
+    case iree_uk_mmt4d_type_f32f32f32:
+      return iree_uk_mmt4d_select_tile_func_wasm_32_f32f32f32(params);
+    default:
+      return 0;
+  }
+}
@@ -0,0 +1,57 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32_internal.h"
+
+// M0 is capped at 4: the 8 accumulators plus RHS and broadcast LHS registers
+// fit in the 16 vector registers of x86 hosts that the engine maps v128 onto.
+static inline void iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_4x8x1_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 4 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  v128_t acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_v128_load(out_ptr + 4 * i);
+    }
+  } else {
+    for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_f32x4_const_splat(0.0f);
+    }
+  }
+  IREE_UK_ASSUME(params->K >= 1);
+  for (int k = 0; k < params->K; ++k) {
+    v128_t rhs0 = wasm_v128_load(rhs_ptr + 0);
+    v128_t rhs1 = wasm_v128_load(rhs_ptr + 4);
+    rhs_ptr += 8;
+    for (int i = 0; i < M0; ++i) {
+      v128_t lhs = wasm_f32x4_splat(lhs_ptr[i]);
+      acc[2 * i + 0] =
+          wasm_f32x4_add(acc[2 * i + 0], wasm_f32x4_mul(lhs, rhs0));
+      acc[2 * i + 1] =
+          wasm_f32x4_add(acc[2 * i + 1], wasm_f32x4_mul(lhs, rhs1));
+    }
+    lhs_ptr += M0;
+  }
+  for (int i = 0; i < 2 * M0; ++i) {
+    wasm_v128_store(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_4x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_wasm_32_simd128, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_4x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_2x8x1_wasm_32_simd128, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_4x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128, 4)
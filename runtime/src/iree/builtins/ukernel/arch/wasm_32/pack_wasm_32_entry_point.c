@@ -0,0 +1,26 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32_entry_point.h"
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32_internal.h"
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
+    const iree_uk_pack_params_t* params) {
+#if defined(IREE_UK_BUILD_WASM_32_SIMD128)
+  if (!iree_uk_cpu_supports_simd128(params->cpu_data)) return 0;
+  // Only the element type size matters, not the type itself.
+  iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
+  int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
+  bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+  if (esize == 4 && params->out_size2 == 4 && params->out_size3 == 1) {
+    return transpose ? 0 : iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct;
+  } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose
+                     : iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct;
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32_internal.h"
+
+// Packs |rows| (a multiple of 4) rows of 32-bit elements into tiles of
+// |rows|x1, transposing 4x4 blocks in registers.
+static inline void iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr,
+    iree_uk_index_t outer_size1, iree_uk_index_t out_stride1,
+    iree_uk_index_t in_stride0, int rows) {
+  for (; outer_size1 >= 4; outer_size1 -= 4) {
+    for (int r = 0; r < rows; r += 4) {
+      v128_t v[4];
+      for (int i = 0; i < 4; ++i) {
+        v[i] = wasm_v128_load(in_ptr + (r + i) * in_stride0);
+      }
+      iree_uk_wasm_transpose_4x4xi32(v);
+      for (int i = 0; i < 4; ++i) {
+        wasm_v128_store(out_ptr + i * out_stride1 + r, v[i]);
+      }
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int r = 0; r < rows; ++r) {
+      out_ptr[r] = in_ptr[r * in_stride0];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 4);
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 8);
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  // The transposed 8x1 tile is a single row of 8 contiguous elements.
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    wasm_v128_store(out_ptr + 0, wasm_v128_load(in_ptr + 0));
+    wasm_v128_store(out_ptr + 4, wasm_v128_load(in_ptr + 4));
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
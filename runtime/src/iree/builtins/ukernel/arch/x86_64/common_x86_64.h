@@ -46,6 +46,29 @@ static inline void iree_uk_copy_16x64xi8_strided_to_strided(
   }
 }
 
+// Returns true if `ptr` and `stride` are both multiples of `alignment`, which
+// must be a power of two.
+static inline bool iree_uk_x86_64_is_aligned(const void* ptr,
+                                             iree_uk_index_t stride,
+                                             int alignment) {
+  return !((((iree_uk_uint64_t)ptr) | stride) & (alignment - 1));
+}
+
+// Same as iree_uk_copy_8x32xi8_strided_to_strided, but with non-temporal
+// stores, bypassing the cache. `out_ptr` and `out_stride` must be multiples of
+// 32. Callers must issue a _mm_sfence() before the data is read by another
+// thread.
+static inline void iree_uk_avx2_copy_8x32xi8_strided_to_strided_nontemporal(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 8; ++i) {
+    _mm256_stream_si256(
+        (__m256i*)(out_ptr + i * out_stride),
+        _mm256_loadu_si256((const __m256i*)(in_ptr + i * in_stride)));
+  }
+}
+
 static inline __m256i iree_uk_avx2_load_8x4xi8_strided(
     const iree_uk_int8_t* src, iree_uk_index_t stride) {
   __m256i indices = _mm256_mullo_epi32(
@@ -254,6 +277,21 @@ static inline void iree_uk_avx512_storeu_4x128(void* dst0, void* dst1,
   _mm_storeu_si128((__m128i*)dst3, v128_3);
 }
 
+// Same as iree_uk_copy_16x64xi8_strided_to_strided, but with non-temporal
+// stores, bypassing the cache. `out_ptr` and `out_stride` must be multiples of
+// 64. Callers must issue a _mm_sfence() before the data is read by another
+// thread.
+static inline void iree_uk_avx512_copy_16x64xi8_strided_to_strided_nontemporal(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  for (int i = 0; i < 16; ++i) {
+    _mm512_stream_si512(
+        (__m512i*)(out_ptr + i * out_stride),
+        _mm512_loadu_si512((const __m512i*)(in_ptr + i * in_stride)));
+  }
+}
+
 static inline __m512i iree_uk_avx512_loadu_4x128_from_16x16xi32(
     const iree_uk_int32_t* src, int i0, int j0, int i1, int j1, int i2, int j2,
     int i3, int j3) {
@@ -16,6 +16,7 @@
 #define IREE_UK_BUILD_X86_64_AVX512_BASE
 #define IREE_UK_BUILD_X86_64_AVX512_VNNI
 #define IREE_UK_BUILD_X86_64_AVX512_BF16
+#define IREE_UK_BUILD_X86_64_AMX
 #else  // IREE_DEVICE_STANDALONE
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/x86_64/config_x86_64.h"
@@ -50,4 +51,21 @@ static inline bool iree_uk_cpu_supports_avx512_bf16(
          iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512BF16);
 }
 
+// The AMX kernels also use AVX-512 to shuffle the RHS into the tile layout.
+// The AMX bits are only reported when the OS has enabled the tile data state
+// for this process, see iree_cpu_initialize.
+static inline bool iree_uk_cpu_supports_amx_int8(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_supports_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXINT8);
+}
+
+static inline bool iree_uk_cpu_supports_amx_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_supports_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXBF16);
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_COMMON_X86_64_ENTRY_POINT_H_
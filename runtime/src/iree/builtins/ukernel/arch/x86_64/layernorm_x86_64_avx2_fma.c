@@ -0,0 +1,65 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/layernorm_x86_64_internal.h"
+
+static inline float iree_uk_avx_reduce_add_ps(__m256 x) {
+  __m128 v = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_movehdup_ps(v));
+  return _mm_cvtss_f32(v);
+}
+
+// Same as iree_uk_layernorm_row_generic_f32f32, vectorized.
+void iree_uk_layernorm_row_f32f32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale, const void* IREE_UK_RESTRICT bias,
+    const iree_uk_layernorm_params_t* params) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  const float* IREE_UK_RESTRICT scale_ptr = scale;
+  const float* IREE_UK_RESTRICT bias_ptr = bias;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  iree_uk_index_t size = params->size1;
+  iree_uk_index_t i;
+  float mean = 0.0f;
+  if (!(params->flags & IREE_UK_FLAG_LAYERNORM_RMS)) {
+    __m256 acc = _mm256_setzero_ps();
+    for (i = 0; i + 8 <= size; i += 8) {
+      acc = _mm256_add_ps(acc, _mm256_loadu_ps(in_ptr + i));
+    }
+    float sum = iree_uk_avx_reduce_add_ps(acc);
+    for (; i < size; ++i) sum += in_ptr[i];
+    mean = sum / (float)size;
+  }
+  __m256 mean_bcast = _mm256_set1_ps(mean);
+  __m256 acc = _mm256_setzero_ps();
+  for (i = 0; i + 8 <= size; i += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(in_ptr + i), mean_bcast);
+    acc = _mm256_fmadd_ps(d, d, acc);
+  }
+  float sum_squares = iree_uk_avx_reduce_add_ps(acc);
+  for (; i < size; ++i) {
+    float d = in_ptr[i] - mean;
+    sum_squares += d * d;
+  }
+  float inv_stddev =
+      iree_uk_rsqrt_f32(sum_squares / (float)size + params->epsilon);
+  __m256 inv_stddev_bcast = _mm256_set1_ps(inv_stddev);
+  for (i = 0; i + 8 <= size; i += 8) {
+    __m256 x = _mm256_loadu_ps(in_ptr + i);
+    __m256 y = _mm256_mul_ps(_mm256_sub_ps(x, mean_bcast), inv_stddev_bcast);
+    if (scale_ptr) y = _mm256_mul_ps(y, _mm256_loadu_ps(scale_ptr + i));
+    if (bias_ptr) y = _mm256_add_ps(y, _mm256_loadu_ps(bias_ptr + i));
+    _mm256_storeu_ps(out_ptr + i, y);
+  }
+  for (; i < size; ++i) {
+    float y = (in_ptr[i] - mean) * inv_stddev;
+    if (scale_ptr) y *= scale_ptr[i];
+    if (bias_ptr) y += bias_ptr[i];
+    out_ptr[i] = y;
+  }
+}
@@ -0,0 +1,139 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
+
+// AMX tile registers used by the kernels below.
+#define IREE_UK_AMX_TILE_ACC 0
+#define IREE_UK_AMX_TILE_LHS 1
+#define IREE_UK_AMX_TILE_RHS 2
+
+// Memory layout of the operand of LDTILECFG (palette 1).
+typedef struct iree_uk_amx_tile_config_t {
+  iree_uk_uint8_t palette_id;
+  iree_uk_uint8_t start_row;
+  iree_uk_uint8_t reserved[14];
+  iree_uk_uint16_t colsb[16];
+  iree_uk_uint8_t rows[16];
+} iree_uk_amx_tile_config_t;
+
+// Configures the 3 tiles used by the kernels below. All of them are 16 rows of
+// 64 bytes, which is the maximum tile size, regardless of the element type.
+static inline void iree_uk_amx_configure_16x64_tiles(void) {
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_amx_tile_config_t config = {0};
+  config.palette_id = 1;
+  const int tiles[3] = {IREE_UK_AMX_TILE_ACC, IREE_UK_AMX_TILE_LHS,
+                        IREE_UK_AMX_TILE_RHS};
+  for (int i = 0; i < 3; ++i) {
+    config.colsb[tiles[i]] = 64;
+    config.rows[tiles[i]] = 16;
+  }
+  _tile_loadconfig(&config);
+}
+
+// Transposes a 16x16 matrix of 32-bit elements.
+//
+// The RHS panel is stored as N0 rows of K0 elements. The AMX dot-product
+// instructions want the B tile in "VNNI" layout instead: K0/4 rows (i8) or
+// K0/2 rows (bf16) of N0 groups of 4 or 2 consecutive K-elements. Either way
+// a group is 32 bits, so the conversion is exactly a 16x16 transpose of 32-bit
+// elements.
+static inline void iree_uk_avx512_transpose_16x16xi32(
+    const void* IREE_UK_RESTRICT src, void* IREE_UK_RESTRICT dst) {
+  const iree_uk_int32_t* src_ptr = src;
+  iree_uk_int32_t* dst_ptr = dst;
+  __m512i r[16];
+  __m512i t[16];
+  for (int i = 0; i < 16; ++i) {
+    r[i] = _mm512_loadu_si512((const __m512i*)(src_ptr + 16 * i));
+  }
+  // Interleave 32-bit elements of pairs of rows.
+  for (int i = 0; i < 16; i += 2) {
+    t[i + 0] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+    t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+  }
+  // Interleave 64-bit elements. Now each 128-bit lane L of r[4 * g + j] holds
+  // the 4 elements of column (4 * L + j) from rows 4 * g to 4 * g + 3.
+  for (int i = 0; i < 16; i += 4) {
+    r[i + 0] = _mm512_unpacklo_epi64(t[i + 0], t[i + 2]);
+    r[i + 1] = _mm512_unpackhi_epi64(t[i + 0], t[i + 2]);
+    r[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+    r[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+  }
+  // Gather the 128-bit lanes, in two steps.
+  for (int j = 0; j < 4; ++j) {
+    t[j + 0] = _mm512_shuffle_i32x4(r[j + 0], r[j + 4], 0x88);
+    t[j + 4] = _mm512_shuffle_i32x4(r[j + 0], r[j + 4], 0xdd);
+    t[j + 8] = _mm512_shuffle_i32x4(r[j + 8], r[j + 12], 0x88);
+    t[j + 12] = _mm512_shuffle_i32x4(r[j + 8], r[j + 12], 0xdd);
+  }
+  for (int j = 0; j < 4; ++j) {
+    r[j + 0] = _mm512_shuffle_i32x4(t[j + 0], t[j + 8], 0x88);
+    r[j + 8] = _mm512_shuffle_i32x4(t[j + 0], t[j + 8], 0xdd);
+    r[j + 4] = _mm512_shuffle_i32x4(t[j + 4], t[j + 12], 0x88);
+    r[j + 12] = _mm512_shuffle_i32x4(t[j + 4], t[j + 12], 0xdd);
+  }
+  for (int i = 0; i < 16; ++i) {
+    _mm512_storeu_si512((__m512i*)(dst_ptr + 16 * i), r[i]);
+  }
+}
+
+void iree_uk_mmt4d_tile_i8i8i32_16x16x64_x86_64_amx(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_int8_t rhs_vnni[16 * 64];
+  iree_uk_amx_configure_16x64_tiles();
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    _tile_loadd(IREE_UK_AMX_TILE_ACC, out_ptr, 64);
+  } else {
+    _tile_zero(IREE_UK_AMX_TILE_ACC);
+  }
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    iree_uk_avx512_transpose_16x16xi32(rhs_ptr, rhs_vnni);
+    _tile_loadd(IREE_UK_AMX_TILE_LHS, lhs_ptr, 64);
+    _tile_loadd(IREE_UK_AMX_TILE_RHS, rhs_vnni, 64);
+    _tile_dpbssd(IREE_UK_AMX_TILE_ACC, IREE_UK_AMX_TILE_LHS,
+                 IREE_UK_AMX_TILE_RHS);
+    lhs_ptr += 16 * 64;
+    rhs_ptr += 16 * 64;
+  }
+  _tile_stored(IREE_UK_AMX_TILE_ACC, out_ptr, 64);
+  _tile_release();
+}
+
+void iree_uk_mmt4d_tile_bf16bf16f32_16x16x32_x86_64_amx(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_uint16_t rhs_vnni[16 * 32];
+  iree_uk_amx_configure_16x64_tiles();
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    _tile_loadd(IREE_UK_AMX_TILE_ACC, out_ptr, 64);
+  } else {
+    _tile_zero(IREE_UK_AMX_TILE_ACC);
+  }
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    iree_uk_avx512_transpose_16x16xi32(rhs_ptr, rhs_vnni);
+    _tile_loadd(IREE_UK_AMX_TILE_LHS, lhs_ptr, 64);
+    _tile_loadd(IREE_UK_AMX_TILE_RHS, rhs_vnni, 64);
+    _tile_dpbf16ps(IREE_UK_AMX_TILE_ACC, IREE_UK_AMX_TILE_LHS,
+                   IREE_UK_AMX_TILE_RHS);
+    lhs_ptr += 16 * 32;
+    rhs_ptr += 16 * 32;
+  }
+  _tile_stored(IREE_UK_AMX_TILE_ACC, out_ptr, 64);
+  _tile_release();
+}
@@ -60,6 +60,57 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8_16(
     iree_uk_mmt4d_tile_f32f32f32_8x16x1_x86_64_avx512_base,
     iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base)
 
+// Weight-only quantized case: the i8 RHS is sign-extended and converted to f32
+// in registers so the memory traffic on the RHS is a quarter of the f32 case.
+static inline void
+iree_uk_mmt4d_tile_f32i8f32_1x16x1_to_16x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // The prefetches in this function are carried over from
+  // iree_uk_mmt4d_tile_f32f32f32_16x16x1_x86_64_avx512_base.
+  _mm_prefetch((const char*)lhs_ptr, _MM_HINT_T0);
+  _mm_prefetch((const char*)rhs_ptr, _MM_HINT_T0);
+  __m512 acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_ps(out_ptr + i * 16);
+    }
+  } else {
+    for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_ps();
+    }
+  }
+
+  for (iree_uk_int32_t k = 0; k < params->K; ++k) {
+    __m512 rhs = _mm512_cvtepi32_ps(
+        _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)rhs_ptr)));
+    _mm_prefetch((const char*)(rhs_ptr + 128), _MM_HINT_T0);
+    rhs_ptr += 16;
+    for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(lhs_ptr[i]), rhs, acc[i]);
+    }
+    _mm_prefetch((const char*)(lhs_ptr + 128), _MM_HINT_T0);
+    lhs_ptr += M0;
+  }
+
+  for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_ps(out_ptr + i * 16, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0_1_2_4_8_16(
+    iree_uk_mmt4d_tile_f32i8f32_1x16x1_to_16x16x1_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_f32i8f32_1x16x1_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_f32i8f32_2x16x1_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_f32i8f32_4x16x1_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_f32i8f32_8x16x1_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_f32i8f32_16x16x1_x86_64_avx512_base)
+
 // Shared implementation for f16f16f16 and f16f16f32.
 // In the f16f16f16 case, intermediate roundings are skipped. This function
 // should only be used if IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
@@ -61,6 +61,37 @@ iree_uk_mmt4d_select_tile_func_x86_64_f32f32f32(
   return 0;
 }
 
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_x86_64_f32i8f32_M0x16x1(
+    const iree_uk_mmt4d_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_tile_f32i8f32_1x16x1_x86_64_avx512_base;
+      case 2:
+        return iree_uk_mmt4d_tile_f32i8f32_2x16x1_x86_64_avx512_base;
+      case 4:
+        return iree_uk_mmt4d_tile_f32i8f32_4x16x1_x86_64_avx512_base;
+      case 8:
+        return iree_uk_mmt4d_tile_f32i8f32_8x16x1_x86_64_avx512_base;
+      case 16:
+        return iree_uk_mmt4d_tile_f32i8f32_16x16x1_x86_64_avx512_base;
+    }
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_mmt4d_tile_func_t
+iree_uk_mmt4d_select_tile_func_x86_64_f32i8f32(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->N0 == 16 && params->K0 == 1) {
+    return iree_uk_mmt4d_select_tile_func_x86_64_f32i8f32_M0x16x1(params);
+  }
+  return 0;
+}
+
 static iree_uk_mmt4d_tile_func_t
 iree_uk_mmt4d_select_tile_func_x86_64_f16f16f32_M0x16x1(
     const iree_uk_mmt4d_params_t* params) {
@@ -199,6 +230,12 @@ iree_uk_mmt4d_select_tile_func_x86_64_bf16bf16f32(
   if (params->N0 == 16 && params->K0 == 2) {
     return iree_uk_mmt4d_select_tile_func_x86_64_bf16bf16f32_M0x16x2(params);
   }
+#if defined(IREE_UK_BUILD_X86_64_AMX)
+  if (params->M0 == 16 && params->N0 == 16 && params->K0 == 32 &&
+      iree_uk_cpu_supports_amx_bf16(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_bf16bf16f32_16x16x32_x86_64_amx;
+  }
+#endif
   return 0;
 }
 
@@ -274,6 +311,12 @@ static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32(
   if (params->N0 == 8 && params->K0 == 2) {
     return iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32_M0x8x2(params);
   }
+#if defined(IREE_UK_BUILD_X86_64_AMX)
+  if (params->M0 == 16 && params->N0 == 16 && params->K0 == 64 &&
+      iree_uk_cpu_supports_amx_int8(params->cpu_data)) {
+    return iree_uk_mmt4d_tile_i8i8i32_16x16x64_x86_64_amx;
+  }
+#endif
   return 0;
 }
 
@@ -292,8 +335,34 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
       return iree_uk_mmt4d_select_tile_func_x86_64_bf16bf16bf16(params);
     case iree_uk_mmt4d_type_i8i8i32:
       return iree_uk_mmt4d_select_tile_func_x86_64_i8i8i32(params);
+    case iree_uk_mmt4d_type_f32i8f32:
+      return iree_uk_mmt4d_select_tile_func_x86_64_f32i8f32(params);
     default:
       IREE_UK_ASSUME_UNREACHABLE;
       return 0;
   }
 }
+
+// Processor identification as in data field 7 of cpu_data, for use in
+// mmt4d_x86_64_tuning_db.inl.
+#define IREE_UK_CPU_ID_X86_64(VENDOR, FAMILY, MODEL)                          \
+  ((IREE_CPU_DATA7_X86_64_VENDOR_##VENDOR                                     \
+    << IREE_CPU_DATA7_X86_64_VENDOR_SHIFT) |                                  \
+   ((iree_uk_uint64_t)(FAMILY) << IREE_CPU_DATA7_X86_64_FAMILY_SHIFT) |      \
+   ((iree_uk_uint64_t)(MODEL) << IREE_CPU_DATA7_X86_64_MODEL_SHIFT))
+
+static const iree_uk_mmt4d_tuning_entry_t iree_uk_mmt4d_tuning_db_x86_64[] = {
+#define IREE_UK_MMT4D_TUNING_ENTRY(CPU_ID, TYPE, M0, N0, K0, BUCKET, N_BLOCK, \
+                                   PREFETCH)                                  \
+  {CPU_ID, IREE_UK_FLAG_MMT4D_TYPE_##TYPE, M0, N0, K0,                        \
+   iree_uk_mmt4d_shape_bucket_##BUCKET, {N_BLOCK, PREFETCH}},
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_tuning_db.inl"
+#undef IREE_UK_MMT4D_TUNING_ENTRY
+    {0},
+};
+
+bool iree_uk_mmt4d_lookup_tuning_arch(const iree_uk_mmt4d_params_t* params,
+                                      iree_uk_mmt4d_tuning_t* out_tuning) {
+  return iree_uk_mmt4d_search_tuning_db(iree_uk_mmt4d_tuning_db_x86_64, params,
+                                        out_tuning);
+}
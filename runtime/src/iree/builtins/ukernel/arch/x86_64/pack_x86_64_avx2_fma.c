@@ -26,6 +26,38 @@ void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
   }
 }
 
+void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nt(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  if (!iree_uk_x86_64_is_aligned(out_tile_ptr, 4 * out_stride1, 32)) {
+    iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
+        out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+        elem_size, tile_size0, tile_size1);
+    return;
+  }
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    // Each of the 8 source rows is half a cache line per tile. Prefetch them a
+    // few tiles ahead, as they are only read once.
+    for (int i = 0; i < 8; ++i) {
+      IREE_UK_PREFETCH_RO(in_ptr + i * 4 * in_stride0 + 8 * 32,
+                          IREE_UK_PREFETCH_LOCALITY_NONE);
+    }
+    iree_uk_avx2_copy_8x32xi8_strided_to_strided_nontemporal(
+        out_ptr, in_ptr, 32, 4 * in_stride0);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+  _mm_sfence();
+}
+
 static void iree_uk_pack_tile_8x4_x8_x86_64_avx2_fma_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
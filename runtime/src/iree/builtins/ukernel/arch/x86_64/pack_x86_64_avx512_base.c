@@ -26,6 +26,38 @@ void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
   }
 }
 
+void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nt(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  if (!iree_uk_x86_64_is_aligned(out_tile_ptr, 4 * out_stride1, 64)) {
+    iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
+        out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+        elem_size, tile_size0, tile_size1);
+    return;
+  }
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    // Each of the 16 source rows is one cache line per tile. Prefetch them a
+    // few tiles ahead, as they are only read once.
+    for (int i = 0; i < 16; ++i) {
+      IREE_UK_PREFETCH_RO(in_ptr + i * 4 * in_stride0 + 4 * 64,
+                          IREE_UK_PREFETCH_LOCALITY_NONE);
+    }
+    iree_uk_avx512_copy_16x64xi8_strided_to_strided_nontemporal(
+        out_ptr, in_ptr, 64, 4 * in_stride0);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 64;
+  }
+  _mm_sfence();
+}
+
 static void iree_uk_pack_tile_16x4_x8_x86_64_avx512_base_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -12,7 +12,10 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_8x8_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
   if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
+    if (transpose) return 0;
+    return iree_uk_pack_use_nontemporal(params)
+               ? iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nt
+               : iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
   }
 #endif
   return 0;
@@ -23,8 +26,10 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x16_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
   if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0
-                     : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
+    if (transpose) return 0;
+    return iree_uk_pack_use_nontemporal(params)
+               ? iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nt
+               : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
   }
 #endif
   return 0;
@@ -27,6 +27,12 @@ iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AMX)
+  if (iree_uk_cpu_supports_amx_int8(params->cpu_data)) {
+    // One TDPBSSD per K-tile: 16x64 LHS tile times 64x16 RHS tile.
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 64, .N = 16};
+  }
+#endif
 #if defined(IREE_UK_BUILD_X86_64_AVX512_VNNI)
   if (iree_uk_cpu_supports_avx512_vnni(params->cpu_data)) {
     return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
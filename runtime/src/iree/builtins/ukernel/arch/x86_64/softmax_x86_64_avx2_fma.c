@@ -0,0 +1,90 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+// Vectorized iree_uk_exp_f32, see there for the algorithm. The clamping min/max
+// take the constant as first operand: on NaN they return the second operand,
+// so NaN propagates.
+static inline __m256 iree_uk_exp_f32_avx2_fma(__m256 x) {
+  // Lanes below -87 (but not NaN lanes) flush to zero.
+  __m256 keep = _mm256_cmp_ps(x, _mm256_set1_ps(-87.0f), _CMP_NLT_UQ);
+  x = _mm256_min_ps(_mm256_set1_ps(88.0f), x);
+  x = _mm256_max_ps(_mm256_set1_ps(-87.0f), x);
+  __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+  r = _mm256_fmadd_ps(n, _mm256_set1_ps(2.12194440e-4f), r);
+  __m256 p = _mm256_set1_ps(1.0f / 720.0f);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 120.0f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 24.0f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 6.0f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(0.5f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+  __m256i pow2_n = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  return _mm256_and_ps(_mm256_mul_ps(p, _mm256_castsi256_ps(pow2_n)), keep);
+}
+
+static inline float iree_uk_avx_reduce_max_ps(__m256 x) {
+  __m128 v = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_movehdup_ps(v));
+  return _mm_cvtss_f32(v);
+}
+
+static inline float iree_uk_avx_reduce_add_ps(__m256 x) {
+  __m128 v = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_movehdup_ps(v));
+  return _mm_cvtss_f32(v);
+}
+
+// Same as iree_uk_softmax_row_generic_f32f32, with one running max and sum per
+// lane, combined after the vectorized part of the row.
+void iree_uk_softmax_row_f32f32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  __m256 max_vec = _mm256_set1_ps(-3.40282347e+38f);
+  __m256 sum_vec = _mm256_setzero_ps();
+  iree_uk_index_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256 x = _mm256_loadu_ps(in_ptr + i);
+    __m256 new_max = _mm256_max_ps(max_vec, x);
+    sum_vec = _mm256_fmadd_ps(
+        sum_vec, iree_uk_exp_f32_avx2_fma(_mm256_sub_ps(max_vec, new_max)),
+        iree_uk_exp_f32_avx2_fma(_mm256_sub_ps(x, new_max)));
+    max_vec = new_max;
+  }
+  float max = iree_uk_avx_reduce_max_ps(max_vec);
+  float sum = iree_uk_avx_reduce_add_ps(_mm256_mul_ps(
+      sum_vec,
+      iree_uk_exp_f32_avx2_fma(_mm256_sub_ps(max_vec, _mm256_set1_ps(max)))));
+  for (; i < size; ++i) {
+    float x = in_ptr[i];
+    if (x > max) {
+      sum = sum * iree_uk_exp_f32(max - x) + 1.0f;
+      max = x;
+    } else {
+      sum += iree_uk_exp_f32(x - max);
+    }
+  }
+  float inv_sum = 1.0f / sum;
+  __m256 max_bcast = _mm256_set1_ps(max);
+  __m256 inv_sum_bcast = _mm256_set1_ps(inv_sum);
+  for (i = 0; i + 8 <= size; i += 8) {
+    __m256 e = iree_uk_exp_f32_avx2_fma(
+        _mm256_sub_ps(_mm256_loadu_ps(in_ptr + i), max_bcast));
+    _mm256_storeu_ps(out_ptr + i, _mm256_mul_ps(e, inv_sum_bcast));
+  }
+  for (; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
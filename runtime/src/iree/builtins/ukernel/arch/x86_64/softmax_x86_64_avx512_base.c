@@ -0,0 +1,75 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+// Same as iree_uk_exp_f32_avx2_fma, with 16 lanes.
+static inline __m512 iree_uk_exp_f32_avx512_base(__m512 x) {
+  // Lanes below -87 (but not NaN lanes) flush to zero.
+  __mmask16 keep = _mm512_cmp_ps_mask(x, _mm512_set1_ps(-87.0f), _CMP_NLT_UQ);
+  x = _mm512_min_ps(_mm512_set1_ps(88.0f), x);
+  x = _mm512_max_ps(_mm512_set1_ps(-87.0f), x);
+  __m512 n = _mm512_roundscale_ps(
+      _mm512_mul_ps(x, _mm512_set1_ps(1.44269504f)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+  r = _mm512_fmadd_ps(n, _mm512_set1_ps(2.12194440e-4f), r);
+  __m512 p = _mm512_set1_ps(1.0f / 720.0f);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f / 120.0f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f / 24.0f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f / 6.0f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(0.5f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f));
+  __m512i pow2_n = _mm512_slli_epi32(
+      _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+  return _mm512_maskz_mov_ps(keep,
+                             _mm512_mul_ps(p, _mm512_castsi512_ps(pow2_n)));
+}
+
+// Same as iree_uk_softmax_row_f32f32_x86_64_avx2_fma, with 16 lanes.
+void iree_uk_softmax_row_f32f32_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  __m512 max_vec = _mm512_set1_ps(-3.40282347e+38f);
+  __m512 sum_vec = _mm512_setzero_ps();
+  iree_uk_index_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m512 x = _mm512_loadu_ps(in_ptr + i);
+    __m512 new_max = _mm512_max_ps(max_vec, x);
+    sum_vec = _mm512_fmadd_ps(
+        sum_vec, iree_uk_exp_f32_avx512_base(_mm512_sub_ps(max_vec, new_max)),
+        iree_uk_exp_f32_avx512_base(_mm512_sub_ps(x, new_max)));
+    max_vec = new_max;
+  }
+  float max = _mm512_reduce_max_ps(max_vec);
+  float sum = _mm512_reduce_add_ps(_mm512_mul_ps(
+      sum_vec, iree_uk_exp_f32_avx512_base(
+                   _mm512_sub_ps(max_vec, _mm512_set1_ps(max)))));
+  for (; i < size; ++i) {
+    float x = in_ptr[i];
+    if (x > max) {
+      sum = sum * iree_uk_exp_f32(max - x) + 1.0f;
+      max = x;
+    } else {
+      sum += iree_uk_exp_f32(x - max);
+    }
+  }
+  float inv_sum = 1.0f / sum;
+  __m512 max_bcast = _mm512_set1_ps(max);
+  __m512 inv_sum_bcast = _mm512_set1_ps(inv_sum);
+  for (i = 0; i + 16 <= size; i += 16) {
+    __m512 e = iree_uk_exp_f32_avx512_base(
+        _mm512_sub_ps(_mm512_loadu_ps(in_ptr + i), max_bcast));
+    _mm512_storeu_ps(out_ptr + i, _mm512_mul_ps(e, inv_sum_bcast));
+  }
+  for (; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
@@ -0,0 +1,33 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+static iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_x86_64_f32f32(
+    const iree_uk_softmax_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_supports_avx512_base(params->cpu_data)) {
+    return iree_uk_softmax_row_f32f32_x86_64_avx512_base;
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return iree_uk_softmax_row_f32f32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
+
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  switch (iree_uk_softmax_type(params->flags)) {
+    case iree_uk_softmax_type_f32f32:
+      return iree_uk_softmax_select_row_func_x86_64_f32f32(params);
+    default:
+      return 0;
+  }
+}
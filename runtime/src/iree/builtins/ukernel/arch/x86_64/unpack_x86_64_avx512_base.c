@@ -25,3 +25,35 @@ void iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct(
     in_ptr += 4 * in_stride1;
   }
 }
+
+void iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct_nt(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  if (!iree_uk_x86_64_is_aligned(out_tile_ptr, 4 * out_stride0, 64)) {
+    iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct(
+        out_tile_ptr, in_tile_ptr, outer_size1, out_stride0, in_stride1,
+        elem_size, tile_size0, tile_size1);
+    return;
+  }
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    // Each source tile is 16 contiguous cache lines, only read once. Prefetch
+    // the next one.
+    for (int i = 0; i < 16; ++i) {
+      IREE_UK_PREFETCH_RO(in_ptr + 4 * in_stride1 + i * 64,
+                          IREE_UK_PREFETCH_LOCALITY_NONE);
+    }
+    iree_uk_avx512_copy_16x64xi8_strided_to_strided_nontemporal(
+        out_ptr, in_ptr, 4 * out_stride0, 64);
+    out_ptr += 64;
+    in_ptr += 4 * in_stride1;
+  }
+  _mm_sfence();
+}
@@ -828,6 +828,52 @@ static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float value) {
   return iree_uk_f32_to_generic_fp16(value, 8);
 }
 
+//===----------------------------------------------------------------------===//
+// Elementary float functions. Ukernels can't call into libm.
+//
+// Architecture-specific files vectorize these with the same algorithms and
+// constants, so that results agree across code paths to within rounding.
+//===----------------------------------------------------------------------===//
+
+// Approximation of exp(x) good to a few ulps. Results that would be smaller
+// than the smallest normal float are flushed to zero, so that exp(-inf) == 0.
+// Large inputs are clamped so that the result stays finite. NaN propagates.
+static inline float iree_uk_exp_f32(float x) {
+  if (x != x) return x;
+  if (x < -87.0f) return 0.0f;
+  x = x > 88.0f ? 88.0f : x;
+  // Write x = n * ln(2) + r with |r| <= ln(2) / 2, splitting ln(2) in two
+  // parts (Cody-Waite) so that r is computed accurately.
+  float n_f32 = x * 1.44269504f;
+  iree_uk_int32_t n = (iree_uk_int32_t)(n_f32 + (n_f32 < 0.0f ? -0.5f : 0.5f));
+  float r = x - (float)n * 0.693359375f + (float)n * 2.12194440e-4f;
+  float p = 1.0f / 720.0f;
+  p = p * r + 1.0f / 120.0f;
+  p = p * r + 1.0f / 24.0f;
+  p = p * r + 1.0f / 6.0f;
+  p = p * r + 0.5f;
+  p = p * r + 1.0f;
+  p = p * r + 1.0f;
+  iree_uk_uint32_t pow2_n_bits = (iree_uk_uint32_t)(n + 127) << 23;
+  float pow2_n;
+  iree_uk_memcpy(&pow2_n, &pow2_n_bits, sizeof pow2_n);
+  return p * pow2_n;
+}
+
+// Approximation of 1 / sqrt(x) for normal x > 0, good to about 1 ulp: the
+// classic bit-level initial guess refined by three Newton iterations.
+static inline float iree_uk_rsqrt_f32(float x) {
+  iree_uk_uint32_t bits;
+  iree_uk_memcpy(&bits, &x, sizeof bits);
+  bits = 0x5f3759dfu - (bits >> 1);
+  float y;
+  iree_uk_memcpy(&y, &bits, sizeof y);
+  for (int i = 0; i < 3; ++i) {
+    y = y * (1.5f - 0.5f * x * y * y);
+  }
+  return y;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -49,6 +49,7 @@
 #define IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 0x04
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 0x05
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 0x06
+#define IREE_UK_FLAG_MMT4D_TYPE_F32I8F32 0x07
 
 // bit flags
 #define IREE_UK_FLAG_MMT4D_ACCUMULATE 0x100
@@ -56,6 +57,25 @@
 IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_ACCUMULATE);
 #define IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS 0x400
 
+//===----------------------------------------------------------------------===//
+// mmt4d_epilogue
+//===----------------------------------------------------------------------===//
+
+// The low bits are the same as for mmt4d: a IREE_UK_FLAG_MMT4D_TYPE_* value
+// and optionally IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS. The remaining
+// bits describe the epilogue.
+
+// bit flags
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS 0x1000
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE 0x2000
+
+// activation enum
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK 0xF0000
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_NONE 0x00000
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU 0x10000
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP 0x20000
+#define IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU 0x30000
+
 //===----------------------------------------------------------------------===//
 // pack
 //===----------------------------------------------------------------------===//
@@ -90,6 +110,29 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_ACCUMULATE);
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER 0x200
 
+//===----------------------------------------------------------------------===//
+// softmax
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_SOFTMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_SOFTMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F32F32 0x01
+
+//===----------------------------------------------------------------------===//
+// layernorm
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_LAYERNORM_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_LAYERNORM_TYPE_NONE 0x00
+#define IREE_UK_FLAG_LAYERNORM_TYPE_F32F32 0x01
+
+// bit flags
+#define IREE_UK_FLAG_LAYERNORM_RMS 0x100
+#define IREE_UK_FLAG_LAYERNORM_SCALE 0x200
+#define IREE_UK_FLAG_LAYERNORM_BIAS 0x400
+
 //===----------------------------------------------------------------------===//
 // query_tile_sizes
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,77 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+static void iree_uk_layernorm_validate(
+    const iree_uk_layernorm_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_LAYERNORM_TYPE_MASK | IREE_UK_FLAG_LAYERNORM_RMS |
+      IREE_UK_FLAG_LAYERNORM_SCALE | IREE_UK_FLAG_LAYERNORM_BIAS;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_LAYERNORM_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_LAYERNORM_TYPE_F32F32);
+  IREE_UK_ASSERT(!((params->flags & IREE_UK_FLAG_LAYERNORM_RMS) &&
+                   (params->flags & IREE_UK_FLAG_LAYERNORM_BIAS)));
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  if (params->size0 > 1) {
+    IREE_UK_ASSERT(params->in_stride0 >= params->size1);
+    IREE_UK_ASSERT(params->out_stride0 >= params->size1);
+  }
+  IREE_UK_ASSERT(params->epsilon >= 0.0f);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_layernorm_early(const iree_uk_layernorm_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+static void iree_uk_layernorm_using_row_func(
+    const iree_uk_layernorm_params_t* params,
+    iree_uk_layernorm_row_func_t row_func) {
+  iree_uk_layernorm_type_t layernorm_type =
+      iree_uk_layernorm_type(params->flags);
+  const iree_uk_int16_t in_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_layernorm_in_type(layernorm_type));
+  const iree_uk_int16_t out_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_layernorm_out_type(layernorm_type));
+  // The scale and bias have the input element type.
+  const void* scale = 0;
+  if (params->flags & IREE_UK_FLAG_LAYERNORM_SCALE) {
+    scale = (const char*)params->scale_buffer +
+            (params->scale_offset << in_elem_size_log2);
+  }
+  const void* bias = 0;
+  if (params->flags & IREE_UK_FLAG_LAYERNORM_BIAS) {
+    bias = (const char*)params->bias_buffer +
+           (params->bias_offset << in_elem_size_log2);
+  }
+  const char* in_row = (const char*)params->in_buffer +
+                       (params->in_offset << in_elem_size_log2);
+  char* out_row =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    row_func(out_row, in_row, scale, bias, params);
+    in_row += params->in_stride0 << in_elem_size_log2;
+    out_row += params->out_stride0 << out_elem_size_log2;
+  }
+}
+
+IREE_UK_EXPORT int iree_uk_layernorm(
+    const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_validate(params);
+
+  if (iree_uk_layernorm_early(params)) return 0;
+
+  iree_uk_layernorm_row_func_t row_func =
+      iree_uk_layernorm_select_row_func(params);
+  iree_uk_layernorm_using_row_func(params, row_func);
+  return 0;
+}
@@ -0,0 +1,51 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_LAYERNORM_H_
+#define IREE_BUILTINS_UKERNEL_LAYERNORM_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `layernorm` microkernel: normalization along the rows of a size0 x size1
+// matrix,
+//   out[i, j] = (in[i, j] - mean(in[i, :])) / sqrt(var(in[i, :]) + epsilon)
+//               * scale[j] + bias[j]
+// where var is the biased variance. With IREE_UK_FLAG_LAYERNORM_RMS it is
+// RMSNorm instead,
+//   out[i, j] = in[i, j] / sqrt(mean(in[i, :]^2) + epsilon) * scale[j]
+// `scale` and `bias` are 1D buffers of size1 elements, only read if
+// IREE_UK_FLAG_LAYERNORM_SCALE and IREE_UK_FLAG_LAYERNORM_BIAS are set
+// respectively. RMSNorm does not support a bias.
+
+typedef struct iree_uk_layernorm_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  const void* scale_buffer;
+  iree_uk_index_t scale_offset;
+  const void* bias_buffer;
+  iree_uk_index_t bias_offset;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  float epsilon;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_layernorm_params_t;
+
+IREE_UK_EXPORT int iree_uk_layernorm(const iree_uk_layernorm_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_LAYERNORM_H_
@@ -0,0 +1,61 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+
+#include "iree/builtins/ukernel/layernorm.h"
+
+typedef enum iree_uk_layernorm_type_t {
+  iree_uk_layernorm_type_f32f32 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_layernorm_type_t;
+
+static inline iree_uk_layernorm_type_t iree_uk_layernorm_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_LAYERNORM_TYPE_MASK) {
+    case IREE_UK_FLAG_LAYERNORM_TYPE_F32F32:
+      return iree_uk_layernorm_type_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_in_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_out_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Normalizes one row of params->size1 elements, which is at least 1. `scale`
+// and `bias` point to the first element of the respective buffers, or are NULL
+// if the corresponding flag is not set.
+typedef void (*iree_uk_layernorm_row_func_t)(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale, const void* IREE_UK_RESTRICT bias,
+    const iree_uk_layernorm_params_t* params);
+
+// Row kernel declarations. Prototype matches iree_uk_layernorm_row_func_t.
+#define IREE_UK_LAYERNORM_ROW_FUNC_DECL(NAME)                            \
+  void NAME(void* IREE_UK_RESTRICT out_row,                              \
+            const void* IREE_UK_RESTRICT in_row,                         \
+            const void* IREE_UK_RESTRICT scale,                          \
+            const void* IREE_UK_RESTRICT bias,                           \
+            const iree_uk_layernorm_params_t* params);
+
+// Returns the row function to use for the layernorm op with the given params.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func(
+    const iree_uk_layernorm_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func_arch(
+    const iree_uk_layernorm_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
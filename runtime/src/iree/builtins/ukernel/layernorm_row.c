@@ -0,0 +1,63 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+// The mean and the variance are computed in separate passes, as the one-pass
+// sum-of-squares formula loses too much accuracy in f32 when the mean is large
+// compared to the standard deviation.
+static void iree_uk_layernorm_row_generic_f32f32(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale, const void* IREE_UK_RESTRICT bias,
+    const iree_uk_layernorm_params_t* params) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  const float* IREE_UK_RESTRICT scale_ptr = scale;
+  const float* IREE_UK_RESTRICT bias_ptr = bias;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  iree_uk_index_t size = params->size1;
+  float mean = 0.0f;
+  if (!(params->flags & IREE_UK_FLAG_LAYERNORM_RMS)) {
+    float sum = 0.0f;
+    for (iree_uk_index_t i = 0; i < size; ++i) sum += in_ptr[i];
+    mean = sum / (float)size;
+  }
+  float sum_squares = 0.0f;
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    float d = in_ptr[i] - mean;
+    sum_squares += d * d;
+  }
+  float inv_stddev =
+      iree_uk_rsqrt_f32(sum_squares / (float)size + params->epsilon);
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    float y = (in_ptr[i] - mean) * inv_stddev;
+    if (scale_ptr) y *= scale_ptr[i];
+    if (bias_ptr) y += bias_ptr[i];
+    out_ptr[i] = y;
+  }
+}
+
+static iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func_generic(
+    const iree_uk_layernorm_params_t* params) {
+  switch (iree_uk_layernorm_type(params->flags)) {
+    case iree_uk_layernorm_type_f32f32:
+      return iree_uk_layernorm_row_generic_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+      return 0;
+  }
+}
+
+// Select the 'row function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func(
+    const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_row_func_t arch_row_func =
+      iree_uk_layernorm_select_row_func_arch(params);
+  if (arch_row_func) {
+    return arch_row_func;
+  }
+  return iree_uk_layernorm_select_row_func_generic(params);
+}
@@ -20,7 +20,8 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F32 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 ||
-                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16);
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_F32I8F32);
   // Some implementations may wish to avoid supporting absurdly wide types. For
   // instance, K is the innermost (i.e. hottest) loop bound, so some 32bit
   // targets may benefit from K being int32, not int64. We still let K be of
@@ -46,8 +47,9 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
 // handled by the tile_func passed as argument here. Sharing the outer loops
 // across all cases is a roughly 2x code shrink compared to if we were
 // emitting the whole loop nest for each case.
-static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
-                                          iree_uk_mmt4d_tile_func_t tile_func) {
+static void iree_uk_mmt4d_using_tile_func(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tile_func_t tile_func,
+    const iree_uk_mmt4d_tuning_t* tuning) {
   const iree_uk_int32_t M = params->M;
   const iree_uk_int32_t N = params->N;
   const iree_uk_int16_t M0 = params->M0;
@@ -59,30 +61,41 @@ static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
   const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
   const iree_uk_int16_t rhs_elem_size_log2 = iree_uk_type_size_log2(rhs_type);
   const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
-  char* out_tile_row =
+  char* out_start =
       (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
-  const char* lhs_panel = (const char*)params->lhs_buffer +
-                          (params->lhs_offset << lhs_elem_size_log2);
+  const char* lhs_panel_start = (const char*)params->lhs_buffer +
+                                (params->lhs_offset << lhs_elem_size_log2);
   const char* rhs_panel_start = (const char*)params->rhs_buffer +
                                 (params->rhs_offset << rhs_elem_size_log2);
   iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
   iree_uk_index_t lhs_panel_stride = params->lhs_stride0 << lhs_elem_size_log2;
   iree_uk_index_t rhs_panel_stride = params->rhs_stride0 << rhs_elem_size_log2;
   iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
-  for (iree_uk_int32_t i = 0; i < M; ++i) {
-    char* out_tile = out_tile_row;
-    const char* rhs_panel = rhs_panel_start;
-    // Prefetches needed on ARM Cortex-X2, Issue #13332.
-    IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
-    IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
-    IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
-    for (iree_uk_int32_t j = 0; j < N; ++j) {
-      tile_func(out_tile, lhs_panel, rhs_panel, params);
-      out_tile += out_tile_size;
-      rhs_panel += rhs_panel_stride;
+  // Without blocking, the whole N loop is a single block.
+  const iree_uk_int32_t n_block =
+      (tuning->n_block > 0 && tuning->n_block < N) ? tuning->n_block : N;
+  for (iree_uk_int32_t j_start = 0; j_start < N; j_start += n_block) {
+    const iree_uk_int32_t j_end = iree_uk_index_min(N, j_start + n_block);
+    char* out_tile_row = out_start + j_start * out_tile_size;
+    const char* lhs_panel = lhs_panel_start;
+    const char* rhs_block = rhs_panel_start + j_start * rhs_panel_stride;
+    for (iree_uk_int32_t i = 0; i < M; ++i) {
+      char* out_tile = out_tile_row;
+      const char* rhs_panel = rhs_block;
+      if (tuning->prefetch) {
+        // Prefetches needed on ARM Cortex-X2, Issue #13332.
+        IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+        IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+        IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+      }
+      for (iree_uk_int32_t j = j_start; j < j_end; ++j) {
+        tile_func(out_tile, lhs_panel, rhs_panel, params);
+        out_tile += out_tile_size;
+        rhs_panel += rhs_panel_stride;
+      }
+      out_tile_row += out_stride;
+      lhs_panel += lhs_panel_stride;
     }
-    out_tile_row += out_stride;
-    lhs_panel += lhs_panel_stride;
   }
 }
 
@@ -125,17 +138,362 @@ static bool iree_uk_mmt4d_early(const iree_uk_mmt4d_params_t* params) {
   return false;
 }
 
-IREE_UK_EXPORT int iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params) {
+void iree_uk_mmt4d_with_tuning(const iree_uk_mmt4d_params_t* params,
+                               const iree_uk_mmt4d_tuning_t* tuning) {
   iree_uk_mmt4d_validate(params);
 
   // Maybe handle this mmt4d "early", without needing to select a tile_func.
   // Typical cases include trivial cases (e.g. when params->K == 0) and hardware
   // targets that want to handle the entire loop nest in target-specific code.
-  if (iree_uk_mmt4d_early(params)) return 0;
+  if (iree_uk_mmt4d_early(params)) return;
 
   // Select a target-specific tile_func (inner loop on K, computing one M0xN0
   // tile) and use that with generic outer loops.
   iree_uk_mmt4d_tile_func_t tile_func = iree_uk_mmt4d_select_tile_func(params);
-  iree_uk_mmt4d_using_tile_func(params, tile_func);
+  iree_uk_mmt4d_using_tile_func(params, tile_func, tuning);
+}
+
+IREE_UK_EXPORT int iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tuning_t tuning = iree_uk_mmt4d_lookup_tuning(params);
+  iree_uk_mmt4d_with_tuning(params, &tuning);
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// batch_mmt4d
+//===----------------------------------------------------------------------===//
+
+IREE_UK_EXPORT int iree_uk_batch_mmt4d(
+    const iree_uk_batch_mmt4d_params_t* params) {
+  // The mmt4d params for the current batch. Offsets are advanced by the batch
+  // strides in the loop below.
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = params->lhs_buffer,
+      .lhs_offset = params->lhs_offset,
+      .lhs_stride0 = params->lhs_stride1,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_offset = params->rhs_offset,
+      .rhs_stride0 = params->rhs_stride1,
+      .out_buffer = params->out_buffer,
+      .out_offset = params->out_offset,
+      .out_stride0 = params->out_stride1,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags,
+      .cpu_data = params->cpu_data,
+  };
+  iree_uk_mmt4d_validate(&mmt4d_params);
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->batch, 31));
+
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_int16_t lhs_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_mmt4d_lhs_type(mmt4d_type));
+  const iree_uk_int16_t rhs_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_mmt4d_rhs_type(mmt4d_type));
+  // All batch elements have the same shape, so they share the tuning.
+  iree_uk_mmt4d_tuning_t tuning = iree_uk_mmt4d_lookup_tuning(&mmt4d_params);
+  iree_uk_mmt4d_tile_func_t tile_func = 0;
+  for (iree_uk_int32_t b = 0; b < params->batch; ++b) {
+    if (!iree_uk_mmt4d_early(&mmt4d_params)) {
+      if (!tile_func) tile_func = iree_uk_mmt4d_select_tile_func(&mmt4d_params);
+      // With small batch elements (e.g. attention heads), the first panels of
+      // the next batch element would otherwise be a cold miss every time.
+      if (b + 1 < params->batch) {
+        IREE_UK_PREFETCH_RO((const char*)params->lhs_buffer +
+                                ((mmt4d_params.lhs_offset + params->lhs_stride0)
+                                 << lhs_elem_size_log2),
+                            IREE_UK_PREFETCH_LOCALITY_L2);
+        IREE_UK_PREFETCH_RO((const char*)params->rhs_buffer +
+                                ((mmt4d_params.rhs_offset + params->rhs_stride0)
+                                 << rhs_elem_size_log2),
+                            IREE_UK_PREFETCH_LOCALITY_L2);
+      }
+      iree_uk_mmt4d_using_tile_func(&mmt4d_params, tile_func, &tuning);
+    }
+    mmt4d_params.lhs_offset += params->lhs_stride0;
+    mmt4d_params.rhs_offset += params->rhs_stride0;
+    mmt4d_params.out_offset += params->out_stride0;
+  }
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// mmt4d_epilogue
+//===----------------------------------------------------------------------===//
+
+static void iree_uk_mmt4d_epilogue_validate(
+    const iree_uk_mmt4d_epilogue_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_MMT4D_TYPE_MASK |
+      IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS |
+      IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS |
+      IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE |
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  // The epilogue operates on f32 or i32 accumulators.
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t acc_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  IREE_UK_ASSERT(acc_type == IREE_UK_TYPE_FLOAT_32 ||
+                 acc_type == IREE_UK_TYPE_INT_32);
+  iree_uk_uint32_t activation =
+      params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK;
+  IREE_UK_ASSERT(activation <= IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU);
+  if (activation == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU) {
+    IREE_UK_ASSERT(acc_type == IREE_UK_TYPE_FLOAT_32);
+    IREE_UK_ASSERT(!(params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE));
+  }
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS) {
+    IREE_UK_ASSERT(params->bias_buffer);
+  }
+  // The rest is the same as for mmt4d.
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags & (IREE_UK_FLAG_MMT4D_TYPE_MASK |
+                                IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS),
+  };
+  iree_uk_mmt4d_validate(&mmt4d_params);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))), written
+// as x * sigmoid(2 * sqrt(2 / pi) * (x + 0.044715 * x^3)).
+static inline float iree_uk_mmt4d_epilogue_gelu(float x) {
+  float z = 1.59576912f * (x + 0.044715f * x * x * x);
+  return x / (1.0f + iree_uk_exp_f32(-z));
+}
+
+// Comparisons are written so that NaN propagates, matching arith.maximumf and
+// arith.minimumf.
+static inline float iree_uk_mmt4d_epilogue_activation_f32(
+    float x, const iree_uk_mmt4d_epilogue_params_t* params) {
+  switch (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK) {
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU:
+      return x < 0.0f ? 0.0f : x;
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP:
+      x = x < params->clamp_min ? params->clamp_min : x;
+      return x > params->clamp_max ? params->clamp_max : x;
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU:
+      return iree_uk_mmt4d_epilogue_gelu(x);
+    default:
+      return x;
+  }
+}
+
+// For i32 outputs, the clamp bounds are converted to i32 (rounding toward
+// zero).
+static inline iree_uk_int32_t iree_uk_mmt4d_epilogue_activation_i32(
+    iree_uk_int32_t x, const iree_uk_mmt4d_epilogue_params_t* params) {
+  switch (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK) {
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU:
+      return x < 0 ? 0 : x;
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP: {
+      iree_uk_int32_t lo = (iree_uk_int32_t)params->clamp_min;
+      iree_uk_int32_t hi = (iree_uk_int32_t)params->clamp_max;
+      x = x < lo ? lo : x;
+      return x > hi ? hi : x;
+    }
+    default:
+      return x;
+  }
+}
+
+// Rounds to nearest, ties away from zero, adds the zero point and saturates
+// to i8.
+static inline iree_uk_int8_t iree_uk_mmt4d_epilogue_quantize(
+    float x, iree_uk_int32_t zero_point) {
+  // Clamping first keeps the float->int conversion below well-defined, and
+  // is still wide enough to saturate correctly for any i8 zero point.
+  x = x < -1024.0f ? -1024.0f : x;
+  x = x > 1024.0f ? 1024.0f : x;
+  iree_uk_int32_t t = (iree_uk_int32_t)x;
+  float frac = x - (float)t;
+  t += frac >= 0.5f ? 1 : frac <= -0.5f ? -1 : 0;
+  t += zero_point;
+  t = t < -128 ? -128 : t;
+  t = t > 127 ? 127 : t;
+  return (iree_uk_int8_t)t;
+}
+
+// Epilogue for one M0xN0 tile, f32 accumulator, f32 output. `bias` is NULL or
+// points to the N0 bias values for this tile.
+static void iree_uk_mmt4d_epilogue_tile_f32(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT acc_tile,
+    const void* IREE_UK_RESTRICT bias,
+    const iree_uk_mmt4d_epilogue_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT acc_ptr = acc_tile;
+  const float* IREE_UK_RESTRICT bias_ptr = bias;
+  for (iree_uk_int32_t i0 = 0; i0 < params->M0; ++i0) {
+    for (iree_uk_int32_t j0 = 0; j0 < params->N0; ++j0) {
+      float x = acc_ptr[i0 * params->N0 + j0];
+      if (bias_ptr) x += bias_ptr[j0];
+      out_ptr[i0 * params->N0 + j0] =
+          iree_uk_mmt4d_epilogue_activation_f32(x, params);
+    }
+  }
+}
+
+// Same as above, i32 accumulator, i32 output.
+static void iree_uk_mmt4d_epilogue_tile_i32(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT acc_tile,
+    const void* IREE_UK_RESTRICT bias,
+    const iree_uk_mmt4d_epilogue_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int32_t* IREE_UK_RESTRICT acc_ptr = acc_tile;
+  const iree_uk_int32_t* IREE_UK_RESTRICT bias_ptr = bias;
+  for (iree_uk_int32_t i0 = 0; i0 < params->M0; ++i0) {
+    for (iree_uk_int32_t j0 = 0; j0 < params->N0; ++j0) {
+      iree_uk_int32_t x = acc_ptr[i0 * params->N0 + j0];
+      if (bias_ptr) x += bias_ptr[j0];
+      out_ptr[i0 * params->N0 + j0] =
+          iree_uk_mmt4d_epilogue_activation_i32(x, params);
+    }
+  }
+}
+
+// Same as above, f32 or i32 accumulator, requantized i8 output.
+static void iree_uk_mmt4d_epilogue_tile_requantize(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT acc_tile,
+    const void* IREE_UK_RESTRICT bias,
+    const iree_uk_mmt4d_epilogue_params_t* params) {
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  bool acc_is_i32 = iree_uk_mmt4d_out_type(mmt4d_type) == IREE_UK_TYPE_INT_32;
+  for (iree_uk_int32_t i0 = 0; i0 < params->M0; ++i0) {
+    for (iree_uk_int32_t j0 = 0; j0 < params->N0; ++j0) {
+      iree_uk_int32_t index = i0 * params->N0 + j0;
+      float x;
+      if (acc_is_i32) {
+        iree_uk_int32_t acc = ((const iree_uk_int32_t*)acc_tile)[index];
+        if (bias) acc += ((const iree_uk_int32_t*)bias)[j0];
+        x = (float)acc;
+      } else {
+        x = ((const float*)acc_tile)[index];
+        if (bias) x += ((const float*)bias)[j0];
+      }
+      x = iree_uk_mmt4d_epilogue_activation_f32(x * params->scale, params);
+      out_ptr[index] = iree_uk_mmt4d_epilogue_quantize(x, params->zero_point);
+    }
+  }
+}
+
+typedef void (*iree_uk_mmt4d_epilogue_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT acc_tile,
+    const void* IREE_UK_RESTRICT bias,
+    const iree_uk_mmt4d_epilogue_params_t* params);
+
+// Same loop nest as iree_uk_mmt4d_using_tile_func, except that the tile_func
+// writes to a stack accumulator tile, which the epilogue reads while it is
+// still in L1, writing the final values to the output.
+static void iree_uk_mmt4d_epilogue_using_tile_func(
+    const iree_uk_mmt4d_epilogue_params_t* params,
+    const iree_uk_mmt4d_params_t* mmt4d_params,
+    iree_uk_mmt4d_tile_func_t tile_func,
+    iree_uk_mmt4d_epilogue_tile_func_t epilogue_tile_func) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  const iree_uk_type_t acc_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  const iree_uk_type_t out_type =
+      params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE
+          ? IREE_UK_TYPE_INT_8
+          : acc_type;
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const iree_uk_int16_t rhs_elem_size_log2 = iree_uk_type_size_log2(rhs_type);
+  const iree_uk_int16_t acc_elem_size_log2 = iree_uk_type_size_log2(acc_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  char* out_tile_row =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  const char* lhs_panel = (const char*)params->lhs_buffer +
+                          (params->lhs_offset << lhs_elem_size_log2);
+  const char* rhs_panel_start = (const char*)params->rhs_buffer +
+                                (params->rhs_offset << rhs_elem_size_log2);
+  const char* bias_start = 0;
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS) {
+    bias_start = (const char*)params->bias_buffer +
+                 (params->bias_offset << acc_elem_size_log2);
+  }
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_index_t lhs_panel_stride = params->lhs_stride0 << lhs_elem_size_log2;
+  iree_uk_index_t rhs_panel_stride = params->rhs_stride0 << rhs_elem_size_log2;
+  iree_uk_index_t bias_stride = params->bias_stride0 << acc_elem_size_log2;
+  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+  IREE_UK_ATTRIBUTE_ALIGNED(64)
+  char acc_tile[iree_uk_mmt4d_tile_generic_max_bytes];
+  if (params->K == 0) {
+    // No tile_func to call, the accumulator is just zero.
+    iree_uk_memset(acc_tile, 0, (M0 * N0) << acc_elem_size_log2);
+  }
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = rhs_panel_start;
+    const char* bias = bias_start;
+    IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+    IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    for (iree_uk_int32_t j = 0; j < N; ++j) {
+      if (tile_func) tile_func(acc_tile, lhs_panel, rhs_panel, mmt4d_params);
+      epilogue_tile_func(out_tile, acc_tile, bias, params);
+      out_tile += out_tile_size;
+      rhs_panel += rhs_panel_stride;
+      if (bias) bias += bias_stride;
+    }
+    out_tile_row += out_stride;
+    lhs_panel += lhs_panel_stride;
+  }
+}
+
+IREE_UK_EXPORT int iree_uk_mmt4d_epilogue(
+    const iree_uk_mmt4d_epilogue_params_t* params) {
+  iree_uk_mmt4d_epilogue_validate(params);
+  if (params->M == 0 || params->N == 0) return 0;
+
+  // The parameters that tile functions see. They never get to touch the
+  // actual output, so the output fields are left unset.
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = params->lhs_buffer,
+      .lhs_offset = params->lhs_offset,
+      .lhs_stride0 = params->lhs_stride0,
+      .rhs_buffer = params->rhs_buffer,
+      .rhs_offset = params->rhs_offset,
+      .rhs_stride0 = params->rhs_stride0,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .N0 = params->N0,
+      .K0 = params->K0,
+      .flags = params->flags & (IREE_UK_FLAG_MMT4D_TYPE_MASK |
+                                IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS),
+      .cpu_data = params->cpu_data,
+  };
+  iree_uk_mmt4d_tile_func_t tile_func =
+      params->K ? iree_uk_mmt4d_select_tile_func(&mmt4d_params) : 0;
+
+  iree_uk_mmt4d_epilogue_tile_func_t epilogue_tile_func = 0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  if (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE) {
+    epilogue_tile_func = iree_uk_mmt4d_epilogue_tile_requantize;
+  } else if (iree_uk_mmt4d_out_type(mmt4d_type) == IREE_UK_TYPE_INT_32) {
+    epilogue_tile_func = iree_uk_mmt4d_epilogue_tile_i32;
+  } else {
+    epilogue_tile_func = iree_uk_mmt4d_epilogue_tile_f32;
+  }
+  iree_uk_mmt4d_epilogue_using_tile_func(params, &mmt4d_params, tile_func,
+                                         epilogue_tile_func);
   return 0;
 }
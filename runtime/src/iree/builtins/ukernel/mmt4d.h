@@ -38,6 +38,81 @@ typedef struct iree_uk_mmt4d_params_t {
 
 IREE_UK_EXPORT int iree_uk_mmt4d(const iree_uk_mmt4d_params_t* params);
 
+// `batch_mmt4d` microkernel: `batch` independent mmt4d's, e.g. the heads of a
+// multi-head attention, in a single call. Each operand has a batch stride
+// (stride0) and the same row stride (stride1) as `stride0` in mmt4d. Compared
+// to one mmt4d call per batch, the tile function is selected once and the
+// operands of the next batch are prefetched while the current one is computed.
+typedef struct iree_uk_batch_mmt4d_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  iree_uk_index_t lhs_stride1;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  iree_uk_index_t rhs_stride1;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t out_stride1;
+  iree_uk_index_t batch;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_batch_mmt4d_params_t;
+
+IREE_UK_EXPORT int iree_uk_batch_mmt4d(
+    const iree_uk_batch_mmt4d_params_t* params);
+
+// `mmt4d` microkernel with a fused elementwise epilogue. Each accumulator tile
+// is computed as in `mmt4d` (never accumulating into the existing output), then
+// transformed as follows while it is still hot, before being written to the
+// output:
+// 1. If IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS, add the bias, a N x N0 buffer of the
+//    accumulator type (f32 or i32), broadcast along M and M0.
+// 2. If IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE, convert to f32 and multiply by
+//    `scale`.
+// 3. Apply the activation: relu, clamp to [clamp_min, clamp_max], or gelu
+//    (tanh approximation, only for f32 non-requantized outputs).
+// 4. If IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE, round to nearest (ties away
+//    from zero), add `zero_point`, and saturate to i8. Otherwise, the output
+//    has the accumulator type.
+typedef struct iree_uk_mmt4d_epilogue_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  const void* bias_buffer;
+  iree_uk_index_t bias_offset;
+  iree_uk_index_t bias_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  float scale;
+  iree_uk_int32_t zero_point;
+  float clamp_min;
+  float clamp_max;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_mmt4d_epilogue_params_t;
+
+IREE_UK_EXPORT int iree_uk_mmt4d_epilogue(
+    const iree_uk_mmt4d_epilogue_params_t* params);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -22,6 +22,8 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
   iree_uk_mmt4d_type_bf16bf16bf16 =
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  iree_uk_mmt4d_type_f32i8f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, INT_8, FLOAT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
@@ -38,6 +40,8 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_bf16bf16f32;
     case IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16:
       return iree_uk_mmt4d_type_bf16bf16bf16;
+    case IREE_UK_FLAG_MMT4D_TYPE_F32I8F32:
+      return iree_uk_mmt4d_type_f32i8f32;
     default:
       // This unreachable statement is not just an optimization, it also works
       // around a LLVM/riscv32 miscompile.
@@ -125,4 +129,76 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func(
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
     const iree_uk_mmt4d_params_t* params);
 
+// Tuning parameters of the loop nest around the tile function. Unlike the tile
+// shape, which is fixed by the compiler as it determines the data layout, these
+// only affect the order in which tiles are computed and what is prefetched, so
+// they can be picked at runtime for the microarchitecture that we are running
+// on. See iree_uk_mmt4d_tuning_entry_t.
+typedef struct iree_uk_mmt4d_tuning_t {
+  // If nonzero, the N loop is split into blocks of `n_block` RHS panels, and
+  // each block is multiplied by all LHS panels before moving on to the next
+  // one, so that it stays in cache. Zero means no blocking.
+  iree_uk_int32_t n_block;
+  // Whether to prefetch the panels at the start of each row of tiles.
+  bool prefetch;
+} iree_uk_mmt4d_tuning_t;
+
+// The tuning used when the tuning database has no entry for the current
+// processor and shape.
+static inline iree_uk_mmt4d_tuning_t iree_uk_mmt4d_default_tuning(void) {
+  return (iree_uk_mmt4d_tuning_t){.n_block = 0, .prefetch = true};
+}
+
+// Shape buckets keying the tuning database. The best loop nest mostly depends
+// on whether RHS panels are reused at all, and on whether the whole RHS fits
+// in cache.
+typedef enum iree_uk_mmt4d_shape_bucket_t {
+  // M == 1: each RHS panel is used once, e.g. matrix-times-vector.
+  iree_uk_mmt4d_shape_bucket_narrow = 0,
+  // The RHS is at most iree_uk_mmt4d_small_rhs_max_bytes.
+  iree_uk_mmt4d_shape_bucket_small_rhs = 1,
+  // Anything else.
+  iree_uk_mmt4d_shape_bucket_large_rhs = 2,
+} iree_uk_mmt4d_shape_bucket_t;
+
+enum { iree_uk_mmt4d_small_rhs_max_bytes = 256 * 1024 };
+
+iree_uk_mmt4d_shape_bucket_t iree_uk_mmt4d_shape_bucket(
+    const iree_uk_mmt4d_params_t* params);
+
+// Entry of a tuning database. Each architecture has its own database, e.g.
+// arch/x86_64/mmt4d_x86_64_tuning_db.inl, generated by tools/mmt4d_tuner.
+typedef struct iree_uk_mmt4d_tuning_entry_t {
+  // Processor identification, as in data field 7 of cpu_data. See
+  // iree/schemas/cpu_data.h. Zero terminates the database.
+  iree_uk_uint64_t cpu_id;
+  // A IREE_UK_FLAG_MMT4D_TYPE_* value.
+  iree_uk_uint32_t type;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_mmt4d_shape_bucket_t bucket;
+  iree_uk_mmt4d_tuning_t tuning;
+} iree_uk_mmt4d_tuning_entry_t;
+
+// Searches `db` for an entry matching the given params. On success, writes the
+// tuning to `*out_tuning` and returns true.
+bool iree_uk_mmt4d_search_tuning_db(const iree_uk_mmt4d_tuning_entry_t* db,
+                                    const iree_uk_mmt4d_params_t* params,
+                                    iree_uk_mmt4d_tuning_t* out_tuning);
+
+// Returns the tuning for the given params from the tuning database, based on
+// the processor identification in params->cpu_data[7], or the default tuning.
+iree_uk_mmt4d_tuning_t iree_uk_mmt4d_lookup_tuning(
+    const iree_uk_mmt4d_params_t* params);
+
+// Architecture-specific implementation.
+bool iree_uk_mmt4d_lookup_tuning_arch(const iree_uk_mmt4d_params_t* params,
+                                      iree_uk_mmt4d_tuning_t* out_tuning);
+
+// Same as iree_uk_mmt4d, but with the given tuning instead of the one from the
+// tuning database. Used by the tuner to measure candidate tunings.
+void iree_uk_mmt4d_with_tuning(const iree_uk_mmt4d_params_t* params,
+                               const iree_uk_mmt4d_tuning_t* tuning);
+
 #endif  // IREE_BUILTINS_UKERNEL_MMT4D_INTERNAL_H_
@@ -0,0 +1,44 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+
+iree_uk_mmt4d_shape_bucket_t iree_uk_mmt4d_shape_bucket(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->M == 1) return iree_uk_mmt4d_shape_bucket_narrow;
+  iree_uk_type_t rhs_type =
+      iree_uk_mmt4d_rhs_type(iree_uk_mmt4d_type(params->flags));
+  iree_uk_index_t rhs_bytes =
+      (params->N * params->K * params->N0 * params->K0)
+      << iree_uk_type_size_log2(rhs_type);
+  return rhs_bytes <= iree_uk_mmt4d_small_rhs_max_bytes
+             ? iree_uk_mmt4d_shape_bucket_small_rhs
+             : iree_uk_mmt4d_shape_bucket_large_rhs;
+}
+
+bool iree_uk_mmt4d_search_tuning_db(const iree_uk_mmt4d_tuning_entry_t* db,
+                                    const iree_uk_mmt4d_params_t* params,
+                                    iree_uk_mmt4d_tuning_t* out_tuning) {
+  iree_uk_uint64_t cpu_id = params->cpu_data[7];
+  if (!cpu_id) return false;
+  iree_uk_uint32_t type = params->flags & IREE_UK_FLAG_MMT4D_TYPE_MASK;
+  iree_uk_mmt4d_shape_bucket_t bucket = iree_uk_mmt4d_shape_bucket(params);
+  for (const iree_uk_mmt4d_tuning_entry_t* e = db; e->cpu_id; ++e) {
+    if (e->cpu_id == cpu_id && e->type == type && e->M0 == params->M0 &&
+        e->N0 == params->N0 && e->K0 == params->K0 && e->bucket == bucket) {
+      *out_tuning = e->tuning;
+      return true;
+    }
+  }
+  return false;
+}
+
+iree_uk_mmt4d_tuning_t iree_uk_mmt4d_lookup_tuning(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_tuning_t tuning;
+  if (iree_uk_mmt4d_lookup_tuning_arch(params, &tuning)) return tuning;
+  return iree_uk_mmt4d_default_tuning();
+}
@@ -58,6 +58,24 @@ typedef void (*iree_uk_pack_tile_func_t)(
             iree_uk_index_t in_stride0, iree_uk_index_t elem_size,    \
             iree_uk_index_t tile_size0, iree_uk_index_t tile_size1);
 
+// Outputs of at least this many bytes are assumed not to stay in cache until
+// they are next read, e.g. when packing weights for mmt4d. Tile functions may
+// then use non-temporal stores, bypassing the cache, and prefetch their input
+// for reading once, to avoid evicting data that is more likely to be reused.
+// Such tile functions have a `_nt` suffix.
+enum { iree_uk_pack_nontemporal_min_bytes = 4 * 1024 * 1024 };
+
+// Returns true if the output of the pack op with the given params is large
+// enough to use non-temporal stores. See iree_uk_pack_nontemporal_min_bytes.
+static inline bool iree_uk_pack_use_nontemporal(
+    const iree_uk_pack_params_t* params) {
+  iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
+  iree_uk_type_t out_type = iree_uk_pack_out_type(pack_type);
+  iree_uk_index_t out_bytes = (params->out_size0 * params->out_stride0)
+                              << iree_uk_type_size_log2(out_type);
+  return out_bytes >= iree_uk_pack_nontemporal_min_bytes;
+}
+
 // Returns the tile function to use for the pack op with the given params.
 iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func(
     const iree_uk_pack_params_t* params);
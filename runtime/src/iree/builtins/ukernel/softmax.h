@@ -0,0 +1,42 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `softmax` microkernel: softmax along the rows of a size0 x size1 matrix,
+//   out[i, j] = exp(in[i, j] - max_j(in[i, :])) / sum_j(exp(in[i, :] - max))
+// The max and the sum are computed together in a single pass over each row
+// (online softmax), so each input row is read twice and each output row is
+// written once. The input and output buffers must not overlap.
+// Used on LLVMCPU for linalg.softmax along the innermost dimension.
+
+typedef struct iree_uk_softmax_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_softmax_params_t;
+
+IREE_UK_EXPORT int iree_uk_softmax(const iree_uk_softmax_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_H_
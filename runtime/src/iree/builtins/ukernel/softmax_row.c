@@ -0,0 +1,56 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+// Online softmax: the running sum is relative to the running max, and is
+// rescaled whenever the running max increases. Starting from the lowest finite
+// float rather than the first element or -inf keeps rows with -inf entries
+// (e.g. masked attention scores) from producing (-inf) - (-inf) = NaN.
+static void iree_uk_softmax_row_generic_f32f32(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  float max = -3.40282347e+38f;
+  float sum = 0.0f;
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    float x = in_ptr[i];
+    if (x > max) {
+      sum = sum * iree_uk_exp_f32(max - x) + 1.0f;
+      max = x;
+    } else {
+      sum += iree_uk_exp_f32(x - max);
+    }
+  }
+  float inv_sum = 1.0f / sum;
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
+
+static iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_generic(
+    const iree_uk_softmax_params_t* params) {
+  switch (iree_uk_softmax_type(params->flags)) {
+    case iree_uk_softmax_type_f32f32:
+      return iree_uk_softmax_row_generic_f32f32;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+      return 0;
+  }
+}
+
+// Select the 'row function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func(
+    const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_row_func_t arch_row_func =
+      iree_uk_softmax_select_row_func_arch(params);
+  if (arch_row_func) {
+    return arch_row_func;
+  }
+  return iree_uk_softmax_select_row_func_generic(params);
+}
@@ -137,6 +137,20 @@ static void iree_mmt4d_reference_innerloop_i8i8i32(
   *out_ptr = acc;
 }
 
+static void iree_mmt4d_reference_innerloop_f32i8f32(
+    float* out_ptr, const float* lhs_ptr, const int8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  float acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      float lhs_f32 = lhs_ptr[k * params->M0 * params->K0 + k0];
+      float rhs_f32 = rhs_ptr[k * params->N0 * params->K0 + k0];
+      acc += lhs_f32 * rhs_f32;
+    }
+  }
+  *out_ptr = acc;
+}
+
 static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
   iree_uk_index_t lhs_elem_size =
@@ -196,6 +210,11 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
                   (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
                   (const int8_t*)rhs_ptr, params);
               break;
+            case IREE_UK_FLAG_MMT4D_TYPE_F32I8F32:
+              iree_mmt4d_reference_innerloop_f32i8f32(
+                  (float*)out_ptr, (const float*)lhs_ptr,
+                  (const int8_t*)rhs_ptr, params);
+              break;
             default:
               IREE_UK_ASSERT(false && "unhandled type");
           }
@@ -370,6 +389,381 @@ static void iree_uk_test_mmt4d_default_and_skip_intermediate_roundings(
                      N0, K0, cpu_features);
 }
 
+// Reference exp for checking the gelu epilogue without depending on libm:
+// exp(x) = exp(x / 2^16)^(2^16), with a short Taylor series for the former.
+static double iree_mmt4d_epilogue_reference_exp(double x) {
+  x = x > 80.0 ? 80.0 : x < -80.0 ? -80.0 : x;
+  double y = x / 65536.0;
+  double e = 1.0 + y * (1.0 + y * (0.5 + y / 6.0));
+  for (int i = 0; i < 16; ++i) e *= e;
+  return e;
+}
+
+static float iree_mmt4d_epilogue_reference_activation_f32(
+    float x, const iree_uk_mmt4d_epilogue_params_t* params) {
+  switch (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK) {
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU:
+      return x < 0.f ? 0.f : x;
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP:
+      x = x < params->clamp_min ? params->clamp_min : x;
+      return x > params->clamp_max ? params->clamp_max : x;
+    case IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU: {
+      double z = 0.7978845608028654 * (x + 0.044715 * x * x * x);
+      return x / (1.0 + iree_mmt4d_epilogue_reference_exp(-2.0 * z));
+    }
+    default:
+      return x;
+  }
+}
+
+static int8_t iree_mmt4d_epilogue_reference_quantize(float x,
+                                                     int32_t zero_point) {
+  x = x < -1024.f ? -1024.f : x > 1024.f ? 1024.f : x;
+  // x + 0.5 is exact in double, so truncating it rounds ties away from zero.
+  int32_t t = x < 0.f ? -(int32_t)(0.5 - (double)x) : (int32_t)(x + 0.5);
+  t += zero_point;
+  return t < -128 ? -128 : t > 127 ? 127 : t;
+}
+
+// Checks the output of mmt4d_epilogue against the epilogue applied to the
+// accumulators computed by a separate mmt4d call (itself tested above).
+static bool iree_mmt4d_epilogue_check(
+    const iree_uk_mmt4d_epilogue_params_t* params, const void* acc_buffer,
+    const void* bias_buffer, const void* out_buffer) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  bool acc_is_i32 = iree_uk_mmt4d_out_type(mmt4d_type) == IREE_UK_TYPE_INT_32;
+  bool bias = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+  bool requantize = params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  bool gelu = (params->flags & IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_MASK) ==
+              IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU;
+  for (iree_uk_index_t i = 0; i < params->M; ++i) {
+    for (iree_uk_index_t j = 0; j < params->N; ++j) {
+      for (iree_uk_index_t i0 = 0; i0 < params->M0; ++i0) {
+        for (iree_uk_index_t j0 = 0; j0 < params->N0; ++j0) {
+          iree_uk_index_t index = i * params->out_stride0 +
+                                  j * params->M0 * params->N0 +
+                                  i0 * params->N0 + j0;
+          iree_uk_index_t bias_index = j * params->bias_stride0 + j0;
+          if (acc_is_i32 && !requantize) {
+            int32_t x = ((const int32_t*)acc_buffer)[index];
+            if (bias) x += ((const int32_t*)bias_buffer)[bias_index];
+            float clamped = iree_mmt4d_epilogue_reference_activation_f32(
+                (float)x, params);
+            // Going through float is exact for the small test values.
+            if (((const int32_t*)out_buffer)[index] != (int32_t)clamped) {
+              return false;
+            }
+            continue;
+          }
+          float x;
+          if (acc_is_i32) {
+            int32_t acc = ((const int32_t*)acc_buffer)[index];
+            if (bias) acc += ((const int32_t*)bias_buffer)[bias_index];
+            x = (float)acc;
+          } else {
+            x = ((const float*)acc_buffer)[index];
+            if (bias) x += ((const float*)bias_buffer)[bias_index];
+          }
+          if (requantize) x *= params->scale;
+          x = iree_mmt4d_epilogue_reference_activation_f32(x, params);
+          if (requantize) {
+            if (((const int8_t*)out_buffer)[index] !=
+                iree_mmt4d_epilogue_reference_quantize(x, params->zero_point)) {
+              return false;
+            }
+          } else if (gelu) {
+            float diff = ((const float*)out_buffer)[index] - x;
+            float tolerance = 1e-3f * (1.f + (x < 0.f ? -x : x));
+            if (diff > tolerance || diff < -tolerance) return false;
+          } else if (((const float*)out_buffer)[index] != x) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static void iree_uk_test_mmt4d_epilogue_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_mmt4d_epilogue_params_t* src_params) {
+  iree_uk_mmt4d_epilogue_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride0 =
+      params.K * params.M0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.bias_stride0 = params.N0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t acc_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_type_t out_type =
+      params.flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE ? IREE_UK_TYPE_INT_8
+                                                            : acc_type;
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t bias_buffer_size =
+      iree_uk_2d_buffer_length(acc_type, params.N, params.bias_stride0);
+  iree_uk_index_t acc_buffer_size =
+      iree_uk_2d_buffer_length(acc_type, params.M, params.out_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* bias_buffer = malloc(bias_buffer_size);
+  void* acc_buffer = malloc(acc_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(bias_buffer, bias_buffer_size, acc_type, engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.bias_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.lhs_buffer = (const char*)lhs_buffer -
+                      (params.lhs_offset * iree_uk_type_size(lhs_type));
+  params.rhs_buffer = (const char*)rhs_buffer -
+                      (params.rhs_offset * iree_uk_type_size(rhs_type));
+  params.bias_buffer = (const char*)bias_buffer -
+                       (params.bias_offset * iree_uk_type_size(acc_type));
+  params.out_buffer = (char*)out_buffer -
+                      (params.out_offset * iree_uk_type_size(out_type));
+
+  iree_uk_mmt4d_params_t mmt4d_params = {
+      .lhs_buffer = params.lhs_buffer,
+      .lhs_offset = params.lhs_offset,
+      .lhs_stride0 = params.lhs_stride0,
+      .rhs_buffer = params.rhs_buffer,
+      .rhs_offset = params.rhs_offset,
+      .rhs_stride0 = params.rhs_stride0,
+      .out_buffer = acc_buffer,
+      .out_offset = 0,
+      .out_stride0 = params.out_stride0,
+      .M = params.M,
+      .N = params.N,
+      .K = params.K,
+      .M0 = params.M0,
+      .N0 = params.N0,
+      .K0 = params.K0,
+      .flags = params.flags & IREE_UK_FLAG_MMT4D_TYPE_MASK,
+      .cpu_data = params.cpu_data,
+  };
+  iree_uk_mmt4d(&mmt4d_params);
+  iree_uk_mmt4d_epilogue(&params);
+
+  if (!iree_mmt4d_epilogue_check(&params, acc_buffer, bias_buffer,
+                                 out_buffer)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(bias_buffer);
+  free(acc_buffer);
+  free(out_buffer);
+}
+
+static void iree_uk_test_mmt4d_epilogue_for_tile_params(
+    iree_uk_test_t* test, const void* src_params) {
+  typedef struct shape_mnk_t {
+    int m, n, k;
+  } shape_mnk_t;
+  const shape_mnk_t shapes[] = {
+      // Degenerate case M==0. Vacuous.
+      {0, 5, 7},
+      // Degenerate case K==0. The epilogue is applied to zero accumulators.
+      {5, 7, 0},
+      // Non-degenerate cases.
+      {1, 1, 1},
+      {1, 1, 10},
+      {2, 2, 2},
+      {5, 7, 13},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_mmt4d_epilogue_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.M = shapes[i].m;
+    params.N = shapes[i].n;
+    params.K = shapes[i].k;
+    for (int bias = 0; bias <= 1; ++bias) {
+      params.flags &= ~IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+      if (bias) params.flags |= IREE_UK_FLAG_MMT4D_EPILOGUE_BIAS;
+      iree_uk_test_mmt4d_epilogue_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_mmt4d_epilogue(iree_uk_uint32_t flags, int M0,
+                                        int N0, int K0,
+                                        const char* cpu_features) {
+  const iree_uk_uint32_t activations[] = {
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_NONE,
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_RELU,
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_CLAMP,
+      IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU,
+  };
+  const char* activation_strs[] = {"none", "relu", "clamp", "gelu"};
+  char types_str[32];
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
+  iree_uk_type_triple_str(types_str, sizeof types_str, mmt4d_type);
+  bool requantize = flags & IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE;
+  bool float_out =
+      iree_uk_mmt4d_out_type(mmt4d_type) == IREE_UK_TYPE_FLOAT_32 &&
+      !requantize;
+  for (int i = 0; i < IREE_ARRAYSIZE(activations); ++i) {
+    // gelu is only supported on float outputs.
+    if (activations[i] == IREE_UK_FLAG_MMT4D_EPILOGUE_ACTIVATION_GELU &&
+        !float_out) {
+      continue;
+    }
+    iree_uk_mmt4d_epilogue_params_t params = {.flags = flags | activations[i],
+                                              .M0 = M0,
+                                              .N0 = N0,
+                                              .K0 = K0,
+                                              .scale = 0.125f,
+                                              .zero_point = -3,
+                                              .clamp_min = -20.f,
+                                              .clamp_max = 30.f};
+    char test_label_str[256];
+    snprintf(test_label_str, sizeof test_label_str,
+             "epilogue types:%s tile:%dx%dx%d activation:%s%s", types_str, M0,
+             N0, K0, activation_strs[i], requantize ? " requantize" : "");
+    iree_uk_test(test_label_str, iree_uk_test_mmt4d_epilogue_for_tile_params,
+                 &params, cpu_features);
+  }
+}
+
+static void iree_uk_test_batch_mmt4d_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_batch_mmt4d_params_t* src_params) {
+  iree_uk_batch_mmt4d_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Randomly make row strides and batch strides either tight or not.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride1 =
+      params.K * params.M0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride1 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride1 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  params.lhs_stride0 =
+      params.M * params.lhs_stride1 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.N * params.rhs_stride1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.M * params.out_stride1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.batch, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.batch, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.batch, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size, out_type,
+                              engine);
+  memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = actual_out_buffer;
+  params.lhs_offset = 0;
+  params.rhs_offset = 0;
+  params.out_offset = 0;
+
+  // The reference is one mmt4d per batch element.
+  for (iree_uk_index_t b = 0; b < params.batch; ++b) {
+    iree_uk_mmt4d_params_t reference_params = {
+        .lhs_buffer = lhs_buffer,
+        .lhs_offset = b * params.lhs_stride0,
+        .lhs_stride0 = params.lhs_stride1,
+        .rhs_buffer = rhs_buffer,
+        .rhs_offset = b * params.rhs_stride0,
+        .rhs_stride0 = params.rhs_stride1,
+        .out_buffer = reference_out_buffer,
+        .out_offset = b * params.out_stride0,
+        .out_stride0 = params.out_stride1,
+        .M = params.M,
+        .N = params.N,
+        .K = params.K,
+        .M0 = params.M0,
+        .N0 = params.N0,
+        .K0 = params.K0,
+        .flags = params.flags,
+    };
+    iree_mmt4d_reference(&reference_params);
+  }
+  iree_uk_batch_mmt4d(&params);
+
+  // Exact comparison, as in iree_uk_test_mmt4d_for_shape_params.
+  if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+}
+
+static void iree_uk_test_batch_mmt4d_for_tile_params(iree_uk_test_t* test,
+                                                     const void* src_params) {
+  typedef struct shape_bmnk_t {
+    int batch, m, n, k;
+  } shape_bmnk_t;
+  const shape_bmnk_t shapes[] = {
+      // Degenerate case batch==0. Vacuous.
+      {0, 5, 7, 13},
+      // Degenerate case K==0. Zeroing each batch of the output buffer unless
+      // flags have ACCUMULATE.
+      {3, 5, 7, 0},
+      // Non-degenerate cases.
+      {1, 5, 7, 13},
+      {3, 1, 1, 1},
+      {4, 2, 3, 5},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_batch_mmt4d_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.batch = shapes[i].batch;
+    params.M = shapes[i].m;
+    params.N = shapes[i].n;
+    params.K = shapes[i].k;
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      iree_uk_test_batch_mmt4d_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_batch_mmt4d(iree_uk_uint32_t flags, int M0, int N0,
+                                     int K0, const char* cpu_features) {
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str,
+                          iree_uk_mmt4d_type(flags));
+  iree_uk_batch_mmt4d_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "batch types:%s tile:%dx%dx%d", types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_batch_mmt4d_for_tile_params,
+               &params, cpu_features);
+}
+
 int main(int argc, char** argv) {
   // Generic tests, not matching any particular CPU feature. This is the place
   // to test weird M0, N0, K0 to ensure e.g. that we haven't unwittingly baked
@@ -380,6 +774,7 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 9, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 5, 3, 2, "");
 
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
@@ -393,6 +788,13 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4, "dotprod");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 8, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 8, 8, 1, "");
+  // The SVE kernels are only selected when N0 matches the vector length of
+  // the host, so these cover 256-bit and 512-bit SVE implementations.
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "sve");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 16, 1, "sve");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4, "sve");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 16, 4, "sve");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 4, 1, "");  // SSE
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "avx2_fma");
@@ -407,10 +809,44 @@ int main(int argc, char** argv) {
       IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 16, 16, 1, "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 2,
                      "avx512_bf16");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 32,
+                     "amx_bf16");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 4, 2, "");  // SSE2
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 2, "avx2_fma");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 64, "amx_int8");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32I8F32, 16, 16, 1,
+                     "avx512_base");
+#endif  // defined(IREE_ARCH_ARM_64)
+
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7, "");
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32 |
+                                  IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE,
+                              3, 5, 7, "");
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 9, 6, 3, "");
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32 |
+                                  IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE,
+                              9, 6, 3, "");
+#if defined(IREE_ARCH_ARM_64)
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32 |
+                                  IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE,
+                              8, 8, 4, "dotprod");
+#elif defined(IREE_ARCH_X86_64)
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1,
+                              "avx512_base");
+  iree_uk_test_mmt4d_epilogue(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32 |
+                                  IREE_UK_FLAG_MMT4D_EPILOGUE_REQUANTIZE,
+                              16, 16, 2, "avx512_base");
+#endif  // defined(IREE_ARCH_ARM_64)
+
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7, "");
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 9, 6, 3, "");
+#if defined(IREE_ARCH_ARM_64)
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
+#elif defined(IREE_ARCH_X86_64)
+  iree_uk_test_batch_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
+                           "avx2_fma");
 #endif  // defined(IREE_ARCH_ARM_64)
 
   return iree_uk_test_exit_status();
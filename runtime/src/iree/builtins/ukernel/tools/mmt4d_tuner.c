@@ -0,0 +1,263 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Generates entries of the mmt4d tuning database for the host processor. For
+// each tile function supported by the host and each shape bucket, measures all
+// candidate tunings of the loop nest and prints a IREE_UK_MMT4D_TUNING_ENTRY
+// line for the best one, if it beats the default tuning by at least
+// --min_speedup. The output is meant to be pasted into
+// arch/<arch>/mmt4d_<arch>_tuning_db.inl.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
+
+IREE_FLAG(int32_t, k_size, 256,
+          "K-dimension of the mmt4d ops that are measured.");
+IREE_FLAG(int32_t, measure_time_ms, 20,
+          "Time to spend measuring each candidate tuning, in milliseconds.");
+IREE_FLAG(float, min_speedup, 1.05f,
+          "Minimum speedup over the default tuning for an entry to be printed. "
+          "This avoids filling the database with measurement noise.");
+
+typedef struct iree_uk_mmt4d_tuner_tile_t {
+  iree_uk_uint32_t type;
+  const char* type_name;
+  int M0;
+  int N0;
+  int K0;
+  const char* cpu_features;
+} iree_uk_mmt4d_tuner_tile_t;
+
+#define IREE_UK_MMT4D_TUNER_TILE(TYPE, M0, N0, K0, CPU_FEATURES) \
+  {IREE_UK_FLAG_MMT4D_TYPE_##TYPE, #TYPE, M0, N0, K0, CPU_FEATURES}
+
+// Same tiles as mmt4d_benchmark.
+static const iree_uk_mmt4d_tuner_tile_t iree_uk_mmt4d_tuner_tiles[] = {
+#if defined(IREE_ARCH_ARM_64)
+    IREE_UK_MMT4D_TUNER_TILE(F32F32F32, 8, 8, 1, ""),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F32, 8, 8, 1, "fp16fml"),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F16, 8, 8, 1, "fp16"),
+    IREE_UK_MMT4D_TUNER_TILE(BF16BF16F32, 8, 8, 4, "bf16"),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 8, 8, 1, ""),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 8, 8, 4, "dotprod"),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 8, 8, 8, "i8mm"),
+    IREE_UK_MMT4D_TUNER_TILE(F32I8F32, 8, 8, 1, ""),
+#elif defined(IREE_ARCH_X86_64)
+    IREE_UK_MMT4D_TUNER_TILE(F32F32F32, 8, 8, 1, "avx2_fma"),
+    IREE_UK_MMT4D_TUNER_TILE(F32F32F32, 16, 16, 1, "avx512_base"),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F32, 8, 8, 1, "avx2_fma"),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F32, 16, 16, 1, "avx512_base"),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F16, 8, 8, 1, "avx2_fma"),
+    IREE_UK_MMT4D_TUNER_TILE(F16F16F16, 16, 16, 1, "avx512_base"),
+    IREE_UK_MMT4D_TUNER_TILE(BF16BF16F32, 16, 16, 2, "avx512_bf16"),
+    IREE_UK_MMT4D_TUNER_TILE(BF16BF16F32, 16, 16, 32, "amx_bf16"),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 8, 8, 2, "avx2_fma"),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 16, 16, 2, "avx512_vnni"),
+    IREE_UK_MMT4D_TUNER_TILE(I8I8I32, 16, 16, 64, "amx_int8"),
+    IREE_UK_MMT4D_TUNER_TILE(F32I8F32, 16, 16, 1, "avx512_base"),
+#endif  // defined(IREE_ARCH_ARM_64)
+};
+
+static const iree_uk_int32_t iree_uk_mmt4d_tuner_n_blocks[] = {0, 2,  4,
+                                                               8, 16, 32};
+
+// Prints the CPU_ID argument of IREE_UK_MMT4D_TUNING_ENTRY for the host.
+// Returns false if the host processor is not identified.
+static bool iree_uk_mmt4d_tuner_print_cpu_id(char* buf, int buf_length) {
+  iree_uk_uint64_t cpu_id = iree_cpu_data_field(7);
+  if (!cpu_id) return false;
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_uint64_t vendor = (cpu_id >> IREE_CPU_DATA7_X86_64_VENDOR_SHIFT) &
+                            IREE_CPU_DATA7_X86_64_VENDOR_MASK;
+  snprintf(buf, buf_length, "IREE_UK_CPU_ID_X86_64(%s, %d, 0x%x)",
+           vendor == IREE_CPU_DATA7_X86_64_VENDOR_INTEL ? "INTEL" : "AMD",
+           (int)((cpu_id >> IREE_CPU_DATA7_X86_64_FAMILY_SHIFT) &
+                 IREE_CPU_DATA7_X86_64_FAMILY_MASK),
+           (int)((cpu_id >> IREE_CPU_DATA7_X86_64_MODEL_SHIFT) &
+                 IREE_CPU_DATA7_X86_64_MODEL_MASK));
+  return true;
+#elif defined(IREE_ARCH_ARM_64)
+  snprintf(buf, buf_length, "IREE_UK_CPU_ID_ARM_64(0x%x, 0x%x)",
+           (int)((cpu_id >> IREE_CPU_DATA7_ARM_64_IMPLEMENTER_SHIFT) &
+                 IREE_CPU_DATA7_ARM_64_IMPLEMENTER_MASK),
+           (int)((cpu_id >> IREE_CPU_DATA7_ARM_64_PARTNUM_SHIFT) &
+                 IREE_CPU_DATA7_ARM_64_PARTNUM_MASK));
+  return true;
+#else
+  return false;
+#endif  // defined(IREE_ARCH_X86_64)
+}
+
+// Returns the average time in nanoseconds of one mmt4d call with the given
+// tuning.
+static double iree_uk_mmt4d_tuner_measure(
+    const iree_uk_mmt4d_params_t* params,
+    const iree_uk_mmt4d_tuning_t* tuning) {
+  // Warm up caches.
+  iree_uk_mmt4d_with_tuning(params, tuning);
+  iree_time_t start = iree_time_now();
+  iree_time_t deadline = start + FLAG_measure_time_ms * 1000000ll;
+  iree_time_t end = start;
+  int64_t iterations = 0;
+  do {
+    iree_uk_mmt4d_with_tuning(params, tuning);
+    ++iterations;
+    end = iree_time_now();
+  } while (end < deadline);
+  return (double)(end - start) / iterations;
+}
+
+// Sets params->M and params->N to a representative shape of `bucket`.
+static void iree_uk_mmt4d_tuner_set_shape(iree_uk_mmt4d_shape_bucket_t bucket,
+                                          iree_uk_mmt4d_params_t* params) {
+  iree_uk_type_t rhs_type =
+      iree_uk_mmt4d_rhs_type(iree_uk_mmt4d_type(params->flags));
+  iree_uk_index_t rhs_panel_bytes = (params->K * params->N0 * params->K0)
+                                    << iree_uk_type_size_log2(rhs_type);
+  iree_uk_index_t rhs_bytes = 0;
+  switch (bucket) {
+    case iree_uk_mmt4d_shape_bucket_narrow:
+      params->M = 1;
+      rhs_bytes = 1024 * 1024;
+      break;
+    case iree_uk_mmt4d_shape_bucket_small_rhs:
+      params->M = iree_max(2, 128 / params->M0);
+      rhs_bytes = iree_uk_mmt4d_small_rhs_max_bytes / 2;
+      break;
+    case iree_uk_mmt4d_shape_bucket_large_rhs:
+      params->M = iree_max(2, 128 / params->M0);
+      rhs_bytes = 16 * iree_uk_mmt4d_small_rhs_max_bytes;
+      break;
+  }
+  params->N = iree_max(1, rhs_bytes / rhs_panel_bytes);
+}
+
+static const char* iree_uk_mmt4d_tuner_bucket_name(
+    iree_uk_mmt4d_shape_bucket_t bucket) {
+  switch (bucket) {
+    case iree_uk_mmt4d_shape_bucket_narrow:
+      return "narrow";
+    case iree_uk_mmt4d_shape_bucket_small_rhs:
+      return "small_rhs";
+    case iree_uk_mmt4d_shape_bucket_large_rhs:
+      return "large_rhs";
+  }
+  return "";
+}
+
+static void iree_uk_mmt4d_tuner_tune(
+    const iree_uk_mmt4d_tuner_tile_t* tile, int M0,
+    iree_uk_mmt4d_shape_bucket_t bucket, const iree_uk_uint64_t* cpu_data,
+    const char* cpu_id_str) {
+  iree_uk_mmt4d_params_t params = {
+      .flags = tile->type | IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS,
+      .M0 = M0,
+      .N0 = tile->N0,
+      .K0 = tile->K0,
+      .K = FLAG_k_size,
+      .cpu_data = cpu_data};
+  // Only tune tiles that have an architecture-specific tile function, as the
+  // database is keyed by tile shape and the generic fallback is not worth it.
+  if (!iree_uk_mmt4d_select_tile_func_arch(&params)) return;
+  iree_uk_mmt4d_tuner_set_shape(bucket, &params);
+  IREE_ASSERT_EQ(iree_uk_mmt4d_shape_bucket(&params), bucket);
+  params.lhs_stride0 = params.K * params.M0 * params.K0;
+  params.rhs_stride0 = params.K * params.N0 * params.K0;
+  params.out_stride0 = params.N * params.M0 * params.N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, &engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, &engine);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+
+  iree_uk_mmt4d_tuning_t default_tuning = iree_uk_mmt4d_default_tuning();
+  double default_ns = iree_uk_mmt4d_tuner_measure(&params, &default_tuning);
+  iree_uk_mmt4d_tuning_t best_tuning = default_tuning;
+  double best_ns = default_ns;
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_mmt4d_tuner_n_blocks); ++i) {
+    iree_uk_int32_t n_block = iree_uk_mmt4d_tuner_n_blocks[i];
+    // Blocks of at least N panels are the same as no blocking.
+    if (n_block >= params.N) continue;
+    for (int prefetch = 0; prefetch <= 1; ++prefetch) {
+      iree_uk_mmt4d_tuning_t tuning = {.n_block = n_block,
+                                       .prefetch = prefetch};
+      double ns = iree_uk_mmt4d_tuner_measure(&params, &tuning);
+      if (ns < best_ns) {
+        best_ns = ns;
+        best_tuning = tuning;
+      }
+    }
+  }
+  const char* bucket_name = iree_uk_mmt4d_tuner_bucket_name(bucket);
+  double speedup = default_ns / best_ns;
+  if (speedup >= FLAG_min_speedup) {
+    printf(
+        "IREE_UK_MMT4D_TUNING_ENTRY(%s, %s, %d, %d, %d, %s, %d, %s)  "
+        "// %.2fx\n",
+        cpu_id_str, tile->type_name, M0, tile->N0, tile->K0, bucket_name,
+        best_tuning.n_block, best_tuning.prefetch ? "true" : "false", speedup);
+  } else {
+    fprintf(stderr, "// %s %dx%dx%d %s: keeping the default tuning (%.2fx)\n",
+            tile->type_name, M0, tile->N0, tile->K0, bucket_name, speedup);
+  }
+  fflush(stdout);
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("mmt4d_tuner",
+                       "Generates mmt4d tuning database entries for the host "
+                       "processor.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  iree_uk_initialize_cpu_once();
+
+  char cpu_id_str[64];
+  if (!iree_uk_mmt4d_tuner_print_cpu_id(cpu_id_str, sizeof cpu_id_str)) {
+    fprintf(stderr, "The host processor is not identified, nothing to tune\n");
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_mmt4d_tuner_tiles); ++i) {
+    const iree_uk_mmt4d_tuner_tile_t* tile = &iree_uk_mmt4d_tuner_tiles[i];
+    iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+    iree_uk_make_cpu_data_for_features(tile->cpu_features, cpu_data);
+    if (!iree_uk_cpu_supports(cpu_data)) continue;
+    cpu_data[7] = iree_cpu_data_field(7);
+    // As in mmt4d_benchmark, also tune the narrow power-of-two values of M0.
+    for (int M0 = 1; M0 <= tile->M0; M0 *= 2) {
+      for (int bucket = iree_uk_mmt4d_shape_bucket_narrow;
+           bucket <= iree_uk_mmt4d_shape_bucket_large_rhs; ++bucket) {
+        iree_uk_mmt4d_tuner_tune(tile, M0, bucket, cpu_data, cpu_id_str);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Straightforward 3-pass softmax in double precision.
+static void iree_softmax_reference(const iree_uk_softmax_params_t* params) {
+  const float* in_buffer = (const float*)params->in_buffer + params->in_offset;
+  float* out_buffer = (float*)params->out_buffer + params->out_offset;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    const float* in_row = in_buffer + i * params->in_stride0;
+    float* out_row = out_buffer + i * params->out_stride0;
+    double max = -INFINITY;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      if (in_row[j] > max) max = in_row[j];
+    }
+    double sum = 0;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      sum += exp(in_row[j] - max);
+    }
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      out_row[j] = exp(in_row[j] - max) / sum;
+    }
+  }
+}
+
+static bool iree_uk_softmax_outputs_close(const iree_uk_softmax_params_t* a,
+                                          const iree_uk_softmax_params_t* b) {
+  const float* a_buffer = (const float*)a->out_buffer + a->out_offset;
+  const float* b_buffer = (const float*)b->out_buffer + b->out_offset;
+  for (iree_uk_index_t i = 0; i < a->size0; ++i) {
+    for (iree_uk_index_t j = 0; j < a->size1; ++j) {
+      float x = a_buffer[i * a->out_stride0 + j];
+      float y = b_buffer[i * b->out_stride0 + j];
+      if (!(fabsf(x - y) <= 1e-6f + 1e-5f * fabsf(y))) return false;
+    }
+  }
+  return true;
+}
+
+static void iree_uk_test_softmax_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_softmax_params_t* src_params) {
+  iree_uk_softmax_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.in_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_softmax_type_t softmax_type = iree_uk_softmax_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_softmax_in_type(softmax_type);
+  iree_uk_type_t out_type = iree_uk_softmax_out_type(softmax_type);
+  iree_uk_index_t in_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.size0, params.in_stride0);
+  float* in_buffer = malloc(in_buffer_size);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, in_type, engine);
+  // Scale the small random integers to spread the outputs over many orders of
+  // magnitude, and mask out some entries as attention masks do. The first
+  // entry of each row is never masked, as fully masked rows are undefined.
+  for (iree_uk_index_t i = 0; i < in_buffer_size / sizeof(float); ++i) {
+    in_buffer[i] *= 0.75f;
+    if (i % params.in_stride0 != 0 &&
+        iree_uk_random_engine_get_0_65535(engine) < 4096) {
+      in_buffer[i] = -INFINITY;
+    }
+  }
+  params.in_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.in_buffer = in_buffer - params.in_offset;
+
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.size0, params.out_stride0);
+  iree_uk_softmax_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  float* reference_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size, out_type,
+                              engine);
+  reference_params.out_buffer = reference_out_buffer - params.out_offset;
+
+  iree_uk_softmax_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  float* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(actual_out_buffer, out_buffer_size, out_type,
+                              engine);
+  actual_params.out_buffer = actual_out_buffer - params.out_offset;
+
+  iree_softmax_reference(&reference_params);
+  iree_uk_softmax(&actual_params);
+
+  if (!iree_uk_softmax_outputs_close(&actual_params, &reference_params)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_softmax_for_type_params(iree_uk_test_t* test,
+                                                 const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Vacuous.
+      {0, 1},
+      {1, 0},
+      // Non-degenerate cases. Row sizes cover the vectorized parts of the
+      // row kernels with and without a remainder.
+      {1, 1},
+      {3, 7},
+      {2, 16},
+      {4, 33},
+      {5, 100},
+      {2, 1000},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_softmax_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_softmax_for_shape_params(test, &params);
+  }
+}
+
+static void iree_uk_test_softmax(iree_uk_uint32_t flags,
+                                 const char* cpu_features) {
+  iree_uk_softmax_params_t params = {.flags = flags};
+  char types_str[32];
+  iree_uk_softmax_type_t type = iree_uk_softmax_type(flags);
+  iree_uk_type_pair_str(types_str, sizeof types_str, type);
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s", types_str);
+  iree_uk_test(test_label_str, iree_uk_test_softmax_for_type_params, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "");
+
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "avx2_fma");
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
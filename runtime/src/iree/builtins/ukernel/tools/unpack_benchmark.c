@@ -18,18 +18,30 @@ IREE_FLAG(
     int64_t, working_set_size, 10000,
     "Number of bytes to be traversed by the benchmark workload (input and "
     "output buffers together). Matrix shapes are computed accordingly.");
+IREE_FLAG(
+    int64_t, large_working_set_size, 64 * 1024 * 1024,
+    "Working set size of additional benchmarks whose output is too large to "
+    "stay in cache, exercising the non-temporal store code paths. 0 disables "
+    "them.");
 IREE_FLAG(
     int32_t, padding_size, 0,
     "Padding size (same value used for both dimensions, 0 means no padding)");
 
+// The user data of each benchmark: ukernel params, and the working set size
+// to compute the outer dimensions from.
+typedef struct iree_uk_unpack_benchmark_params_t {
+  iree_uk_unpack_params_t params;
+  int64_t working_set_size;
+} iree_uk_unpack_benchmark_params_t;
+
 static iree_status_t iree_uk_benchmark_unpack(
     const iree_benchmark_def_t* benchmark_def,
     iree_benchmark_state_t* benchmark_state) {
   const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
-  const iree_uk_unpack_params_t* src_params =
+  const iree_uk_unpack_benchmark_params_t* src_params =
       iree_uk_benchmark_params(user_data);
   iree_uk_unpack_params_t params;
-  memcpy(&params, src_params, sizeof params);
+  memcpy(&params, &src_params->params, sizeof params);
   params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
   iree_uk_unpack_type_t unpack_type = iree_uk_unpack_type(params.flags);
   iree_uk_type_t in_type = iree_uk_unpack_in_type(unpack_type);
@@ -44,7 +56,7 @@ static iree_status_t iree_uk_benchmark_unpack(
   iree_uk_index_t in_size2 = params.in_size2;
   iree_uk_index_t in_size3 = params.in_size3;
   int target_matrix_size_in_elems =
-      FLAG_working_set_size / (in_type_size + out_type_size);
+      src_params->working_set_size / (in_type_size + out_type_size);
   int target_product_of_outer_sizes_0_1 =
       target_matrix_size_in_elems / (in_size2 * in_size3);
   while (target_product_of_outer_sizes_0_1 >= 4) {
@@ -105,8 +117,8 @@ static void iree_uk_benchmark_register_unpack(iree_uk_uint32_t flags,
   char type_str[32];
   iree_uk_unpack_type_t unpack_type = iree_uk_unpack_type(flags);
   iree_uk_type_pair_str(type_str, sizeof type_str, unpack_type);
-  iree_uk_unpack_params_t params = {.in_size2 = tile_size0,
-                                    .in_size3 = tile_size1};
+  iree_uk_unpack_benchmark_params_t params = {
+      .params = {.in_size2 = tile_size0, .in_size3 = tile_size1}};
   typedef struct unpack_variant_t {
     const char* label;
     iree_uk_uint32_t flags;
@@ -118,15 +130,21 @@ static void iree_uk_benchmark_register_unpack(iree_uk_uint32_t flags,
       {"trboth", IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER |
                      IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER},
   };
-  for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
-    unpack_variant_t variant = variants[i];
-    char name[128];
-    snprintf(name, sizeof name, "unpack_%s_tile_%dx%d_%s_wss_%" PRIi64,
-             type_str, tile_size0, tile_size1, variant.label,
-             FLAG_working_set_size);
-    params.flags = flags | variant.flags;
-    iree_uk_benchmark_register(name, iree_uk_benchmark_unpack, &params,
-                               sizeof params, cpu_features);
+  const int64_t working_set_sizes[] = {FLAG_working_set_size,
+                                       FLAG_large_working_set_size};
+  for (int w = 0; w < IREE_ARRAYSIZE(working_set_sizes); ++w) {
+    if (!working_set_sizes[w]) continue;
+    for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
+      unpack_variant_t variant = variants[i];
+      char name[128];
+      snprintf(name, sizeof name, "unpack_%s_tile_%dx%d_%s_wss_%" PRIi64,
+               type_str, tile_size0, tile_size1, variant.label,
+               working_set_sizes[w]);
+      params.working_set_size = working_set_sizes[w];
+      params.params.flags = flags | variant.flags;
+      iree_uk_benchmark_register(name, iree_uk_benchmark_unpack, &params,
+                                 sizeof params, cpu_features);
+    }
   }
 }
 
@@ -139,6 +157,9 @@ int main(int argc, char** argv) {
   // The memcpy benchmark provides a useful comparison point, as pack is fairly
   // close to memory-bound.
   iree_uk_benchmark_register_memcpy(FLAG_working_set_size);
+  if (FLAG_large_working_set_size) {
+    iree_uk_benchmark_register_memcpy(FLAG_large_working_set_size);
+  }
 
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_benchmark_register_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8, "");
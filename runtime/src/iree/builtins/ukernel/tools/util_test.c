@@ -54,6 +54,9 @@ static void iree_uk_test_make_cpu_data_for_features(iree_uk_test_t* test,
   iree_uk_test_make_cpu_data_for_features_case(test, "avx512_base", expected);
   expected[0] = avx512_vnni;
   iree_uk_test_make_cpu_data_for_features_case(test, "avx512_vnni", expected);
+  expected[0] = avx512_base | IREE_CPU_DATA0_X86_64_AMXTILE |
+                IREE_CPU_DATA0_X86_64_AMXINT8;
+  iree_uk_test_make_cpu_data_for_features_case(test, "amx_int8", expected);
 
 #elif defined(IREE_ARCH_ARM_64)
   // Individual arm64 features.
@@ -4,9 +4,11 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/builtins/ukernel/layernorm_internal.h"
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/pack_internal.h"
 #include "iree/builtins/ukernel/query_tile_sizes_internal.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
 #include "iree/builtins/ukernel/unpack_internal.h"
 
 #if defined(IREE_UK_HAVE_WEAK)
@@ -16,6 +18,11 @@ iree_uk_mmt4d_select_tile_func_arch(const iree_uk_mmt4d_params_t* params) {
   return 0;
 }
 
+IREE_UK_WEAK bool iree_uk_mmt4d_lookup_tuning_arch(
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_tuning_t* out_tuning) {
+  return false;
+}
+
 IREE_UK_WEAK iree_uk_pack_tile_func_t
 iree_uk_pack_select_tile_func_arch(const iree_uk_pack_params_t* params) {
   return 0;
@@ -26,6 +33,17 @@ iree_uk_unpack_select_tile_func_arch(const iree_uk_unpack_params_t* params) {
   return 0;
 }
 
+IREE_UK_WEAK iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  return 0;
+}
+
+IREE_UK_WEAK iree_uk_layernorm_row_func_t
+iree_uk_layernorm_select_row_func_arch(
+    const iree_uk_layernorm_params_t* params) {
+  return 0;
+}
+
 IREE_UK_WEAK bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include <stdio.h>
 
+#include "iree/base/internal/metrics.h"
 #include "iree/hal/detail.h"
 #include "iree/hal/resource.h"
 
@@ -67,12 +68,65 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
       statistics->device_bytes_freed,
       (statistics->device_bytes_allocated - statistics->device_bytes_freed)));
 
+  const uint64_t cache_request_count =
+      statistics->cache_hit_count + statistics->cache_miss_count;
+  if (cache_request_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "      CACHED: %12" PRIdsz "B peak / %12" PRIu64 " hits / %12" PRIu64
+        " misses / %5.1f%% hit rate\n",
+        statistics->cache_bytes_peak, statistics->cache_hit_count,
+        statistics->cache_miss_count,
+        100.0 * (double)statistics->cache_hit_count /
+            (double)cache_request_count));
+  }
+
+  if (statistics->pool_bytes_reserved_peak > 0) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "      POOLED: %12" PRIdsz "B reserved peak / %12" PRIdsz
+        "B used peak / %5.1f%% utilization\n",
+        statistics->pool_bytes_reserved_peak, statistics->pool_bytes_used_peak,
+        100.0 * (double)statistics->pool_bytes_used_peak /
+            (double)statistics->pool_bytes_reserved_peak));
+  }
+
 #else
   // No-op when disabled.
 #endif  // IREE_STATISTICS_ENABLE
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// Metrics
+//===----------------------------------------------------------------------===//
+
+IREE_METRIC_STATIC(iree_hal_allocator_host_bytes_metric,
+                   IREE_METRIC_KIND_GAUGE, "iree_hal_allocator_host_bytes",
+                   "Bytes of HOST_LOCAL memory allocated by HAL allocators.");
+IREE_METRIC_STATIC(iree_hal_allocator_device_bytes_metric,
+                   IREE_METRIC_KIND_GAUGE, "iree_hal_allocator_device_bytes",
+                   "Bytes of device memory allocated by HAL allocators.");
+
+static iree_metric_t* iree_hal_allocator_bytes_metric(
+    iree_hal_memory_type_t memory_type) {
+  return iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)
+             ? &iree_hal_allocator_host_bytes_metric
+             : &iree_hal_allocator_device_bytes_metric;
+}
+
+IREE_API_EXPORT void iree_hal_allocator_metrics_record_alloc(
+    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+  iree_metric_add(iree_hal_allocator_bytes_metric(memory_type),
+                  (int64_t)allocation_size);
+}
+
+IREE_API_EXPORT void iree_hal_allocator_metrics_record_free(
+    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+  iree_metric_add(iree_hal_allocator_bytes_metric(memory_type),
+                  -(int64_t)allocation_size);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t
 //===----------------------------------------------------------------------===//
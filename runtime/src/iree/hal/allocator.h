@@ -365,6 +365,17 @@ typedef struct iree_hal_allocator_statistics_t {
   iree_device_size_t device_bytes_peak;
   iree_device_size_t device_bytes_allocated;
   iree_device_size_t device_bytes_freed;
+  // High-water mark of bytes outstanding or retained by caching allocators.
+  iree_device_size_t cache_bytes_peak;
+  // Number of allocations served from a caching allocator's cache.
+  uint64_t cache_hit_count;
+  // Number of cacheable allocations that required a new allocation.
+  uint64_t cache_miss_count;
+  // High-water marks of bytes reserved from the system by and in use from
+  // queue-ordered memory pools. Reserved bytes exceeding used bytes indicate
+  // memory retained by the pools for reuse.
+  iree_device_size_t pool_bytes_reserved_peak;
+  iree_device_size_t pool_bytes_used_peak;
   // TODO(benvanik): mapping information (discarded, mapping ranges,
   //                 flushed/invalidated, etc).
 #else
@@ -537,6 +548,76 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Parameters controlling the size-class slab sub-allocator used by heap
+// allocators created with iree_hal_allocator_create_heap_with_slabs.
+//
+// Slabs of |slab_size| are allocated from the data allocator and split into
+// power-of-two blocks between |min_block_size| and |max_block_size| as needed
+// (buddy allocation). Freed blocks are coalesced with their buddies to reform
+// larger blocks and fully free slabs are returned to the data allocator when
+// the allocator is trimmed. Allocations larger than |max_block_size| bypass the
+// sub-allocator.
+typedef struct iree_hal_heap_allocator_slab_params_t {
+  // Smallest block size in bytes. Must be a power of two and at least
+  // IREE_HAL_HEAP_BUFFER_ALIGNMENT. Each block holds both the buffer metadata
+  // and its contents.
+  iree_device_size_t min_block_size;
+  // Largest block size in bytes. Must be a power of two and at least
+  // |min_block_size|.
+  iree_device_size_t max_block_size;
+  // Size in bytes of each slab allocated from the data allocator. Must be a
+  // power of two and at least |max_block_size|.
+  iree_device_size_t slab_size;
+  // Maximum number of freed blocks of each size class that are cached for
+  // reuse without coalescing. Caches have their own locks so that allocations
+  // and frees of different size classes do not contend with each other.
+  iree_host_size_t cache_capacity;
+} iree_hal_heap_allocator_slab_params_t;
+
+// Initializes |out_params| to default values.
+IREE_API_EXPORT void iree_hal_heap_allocator_slab_params_initialize(
+    iree_hal_heap_allocator_slab_params_t* out_params);
+
+// Statistics describing the slab sub-allocator of a heap allocator.
+// Internal fragmentation is |allocated_bytes| - |requested_bytes| and external
+// fragmentation can be estimated by comparing |free_bytes| against
+// |largest_free_block_size|.
+typedef struct iree_hal_heap_allocator_slab_statistics_t {
+  // Total number of live slabs.
+  iree_host_size_t slab_count;
+  // Total bytes of all live slabs.
+  iree_device_size_t reserved_bytes;
+  // Total bytes of blocks handed out to live buffers (including rounding up to
+  // the block size class).
+  iree_device_size_t allocated_bytes;
+  // Total bytes requested by live buffers (including their metadata).
+  iree_device_size_t requested_bytes;
+  // Total bytes of freed blocks held in the size class caches.
+  iree_device_size_t cached_bytes;
+  // Total bytes of free blocks available for splitting and coalescing.
+  iree_device_size_t free_bytes;
+  // Size of the largest free block or 0 if there are none.
+  iree_device_size_t largest_free_block_size;
+} iree_hal_heap_allocator_slab_statistics_t;
+
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// that serves small allocations from a size-class slab sub-allocator
+// configured by |slab_params|. This avoids a system allocation (and zeroing)
+// per buffer in programs with many transient buffers. Slab-allocated buffer
+// contents are undefined upon allocation.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_slabs(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_slab_params_t* slab_params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+// Queries slab sub-allocator statistics from a heap |allocator|.
+// Fails with IREE_STATUS_INVALID_ARGUMENT if |allocator| is not a heap
+// allocator and returns all zeros if it was created without slabs.
+IREE_API_EXPORT iree_status_t iree_hal_heap_allocator_query_slab_statistics(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_slab_statistics_t* out_statistics);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
@@ -597,12 +678,23 @@ IREE_API_EXPORT void iree_hal_allocator_deallocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT allocator,
     iree_hal_buffer_t* IREE_RESTRICT buffer);
 
+// Records a buffer allocation to the process-wide allocator metrics. Called
+// automatically when recording to allocator statistics.
+IREE_API_EXPORT void iree_hal_allocator_metrics_record_alloc(
+    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size);
+
+// Records a buffer deallocation to the process-wide allocator metrics. Called
+// automatically when recording to allocator statistics.
+IREE_API_EXPORT void iree_hal_allocator_metrics_record_free(
+    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size);
+
 #if IREE_STATISTICS_ENABLE
 
 // Records a buffer allocation to |statistics|.
 static inline void iree_hal_allocator_statistics_record_alloc(
     iree_hal_allocator_statistics_t* statistics,
     iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+  iree_hal_allocator_metrics_record_alloc(memory_type, allocation_size);
   if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
     statistics->host_bytes_allocated += allocation_size;
     statistics->host_bytes_peak =
@@ -620,6 +712,7 @@ static inline void iree_hal_allocator_statistics_record_alloc(
 static inline void iree_hal_allocator_statistics_record_free(
     iree_hal_allocator_statistics_t* statistics,
     iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+  iree_hal_allocator_metrics_record_free(memory_type, allocation_size);
   if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
     statistics->host_bytes_freed += allocation_size;
   } else {
@@ -8,6 +8,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/allocator.h"
+#include "iree/hal/allocator_heap_slab_impl.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/buffer_heap_impl.h"
 #include "iree/hal/resource.h"
@@ -17,6 +18,8 @@ typedef struct iree_hal_heap_allocator_t {
   iree_allocator_t host_allocator;
   iree_allocator_t data_allocator;
   iree_string_view_t identifier;
+  // Optional size-class sub-allocator for small buffers; NULL if disabled.
+  iree_hal_heap_slab_pool_t* slab_pool;
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t statistics;)
 } iree_hal_heap_allocator_t;
 
@@ -60,6 +63,46 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_slabs(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_slab_params_t* slab_params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(slab_params);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  *out_allocator = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_heap_slab_pool_t* slab_pool = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*slab_pool), (void**)&slab_pool);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_heap_slab_pool_initialize(slab_params, data_allocator,
+                                                host_allocator, slab_pool);
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(host_allocator, slab_pool);
+      slab_pool = NULL;
+    }
+  }
+
+  iree_hal_allocator_t* base_allocator = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_allocator_create_heap(identifier, data_allocator,
+                                            host_allocator, &base_allocator);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_heap_allocator_cast(base_allocator)->slab_pool = slab_pool;
+    *out_allocator = base_allocator;
+  } else if (slab_pool) {
+    iree_hal_heap_slab_pool_deinitialize(slab_pool);
+    iree_allocator_free(host_allocator, slab_pool);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_hal_heap_allocator_destroy(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_heap_allocator_t* allocator =
@@ -67,6 +110,11 @@ static void iree_hal_heap_allocator_destroy(
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (allocator->slab_pool) {
+    iree_hal_heap_slab_pool_deinitialize(allocator->slab_pool);
+    iree_allocator_free(host_allocator, allocator->slab_pool);
+  }
+
   IREE_STATISTICS(iree_slim_mutex_deinitialize(&allocator->statistics.mutex));
 
   iree_allocator_free(host_allocator, allocator);
@@ -83,6 +131,11 @@ static iree_allocator_t iree_hal_heap_allocator_host_allocator(
 
 static iree_status_t iree_hal_heap_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_heap_allocator_t* allocator =
+      iree_hal_heap_allocator_cast(base_allocator);
+  if (allocator->slab_pool) {
+    iree_hal_heap_slab_pool_trim(allocator->slab_pool);
+  }
   return iree_ok_status();
 }
 
@@ -198,13 +251,33 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   IREE_STATISTICS(statistics = &allocator->statistics);
   iree_hal_buffer_t* buffer = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
-      base_allocator, statistics, &compat_params, allocation_size,
+      base_allocator, statistics, allocator->slab_pool, &compat_params,
+      allocation_size,
       allocator->data_allocator, allocator->host_allocator, &buffer));
 
   *out_buffer = buffer;
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_heap_allocator_query_slab_statistics(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_slab_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  if (!iree_hal_resource_is(allocator, &iree_hal_heap_allocator_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocator is not a heap allocator");
+  }
+  iree_hal_heap_allocator_t* heap_allocator =
+      iree_hal_heap_allocator_cast(allocator);
+  if (heap_allocator->slab_pool) {
+    iree_hal_heap_slab_pool_query_statistics(heap_allocator->slab_pool,
+                                             out_statistics);
+  }
+  return iree_ok_status();
+}
+
 static void iree_hal_heap_allocator_deallocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
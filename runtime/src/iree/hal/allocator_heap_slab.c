@@ -0,0 +1,408 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/math.h"
+#include "iree/hal/allocator_heap_slab_impl.h"
+
+// Marks a block state as the head of a free block.
+#define IREE_HAL_HEAP_SLAB_BLOCK_STATE_FREE 0x80u
+
+struct iree_hal_heap_slab_t {
+  iree_hal_heap_slab_t* next;
+  // Base pointer of the slab storage allocated from the data allocator.
+  uint8_t* base;
+  // One state per minimum-sized block in the slab. Either 0 if the block is
+  // allocated or not the head of a block or IREE_HAL_HEAP_SLAB_BLOCK_STATE_FREE
+  // ORed with the level of the free block starting there.
+  uint8_t block_states[];
+};
+
+IREE_API_EXPORT void iree_hal_heap_allocator_slab_params_initialize(
+    iree_hal_heap_allocator_slab_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->min_block_size = 256;
+  out_params->max_block_size = 256 * 1024;
+  out_params->slab_size = 1024 * 1024;
+  out_params->cache_capacity = 32;
+}
+
+static uint32_t iree_hal_heap_slab_log2(iree_device_size_t value) {
+  return (uint32_t)iree_math_count_trailing_zeros_u64((uint64_t)value);
+}
+
+iree_status_t iree_hal_heap_slab_pool_initialize(
+    const iree_hal_heap_allocator_slab_params_t* params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_heap_slab_pool_t* out_pool) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_pool);
+  memset(out_pool, 0, sizeof(*out_pool));
+
+  if (!iree_device_size_is_power_of_two(params->min_block_size) ||
+      !iree_device_size_is_power_of_two(params->max_block_size) ||
+      !iree_device_size_is_power_of_two(params->slab_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "slab block and slab sizes must be powers of two");
+  }
+  if (params->min_block_size < IREE_HAL_HEAP_BUFFER_ALIGNMENT ||
+      params->min_block_size > params->max_block_size ||
+      params->max_block_size > params->slab_size) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "slab sizes must satisfy %d <= min_block_size (%" PRIdsz
+        ") <= max_block_size (%" PRIdsz ") <= slab_size (%" PRIdsz ")",
+        (int)IREE_HAL_HEAP_BUFFER_ALIGNMENT, params->min_block_size,
+        params->max_block_size, params->slab_size);
+  }
+  const uint32_t min_block_size_log2 =
+      iree_hal_heap_slab_log2(params->min_block_size);
+  const uint32_t slab_level =
+      iree_hal_heap_slab_log2(params->slab_size) - min_block_size_log2;
+  if (slab_level >= IREE_HAL_HEAP_SLAB_MAX_LEVELS) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "slab size %" PRIdsz
+                            " has too many block levels (max %d)",
+                            params->slab_size, IREE_HAL_HEAP_SLAB_MAX_LEVELS);
+  }
+
+  out_pool->params = *params;
+  out_pool->data_allocator = data_allocator;
+  out_pool->host_allocator = host_allocator;
+  out_pool->min_block_size_log2 = min_block_size_log2;
+  out_pool->slab_level = slab_level;
+  out_pool->max_block_level =
+      iree_hal_heap_slab_log2(params->max_block_size) - min_block_size_log2;
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(out_pool->caches); ++i) {
+    iree_slim_mutex_initialize(&out_pool->caches[i].mutex);
+  }
+  iree_slim_mutex_initialize(&out_pool->mutex);
+  return iree_ok_status();
+}
+
+void iree_hal_heap_slab_pool_deinitialize(iree_hal_heap_slab_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // All blocks must have been freed so we can drop the caches and free lists
+  // and just free the slabs.
+  iree_hal_heap_slab_t* slab = pool->slab_list;
+  while (slab) {
+    iree_hal_heap_slab_t* next = slab->next;
+    iree_allocator_free_aligned(pool->data_allocator, slab->base);
+    iree_allocator_free(pool->host_allocator, slab);
+    slab = next;
+  }
+  pool->slab_list = NULL;
+
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(pool->caches); ++i) {
+    iree_slim_mutex_deinitialize(&pool->caches[i].mutex);
+  }
+  iree_slim_mutex_deinitialize(&pool->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_heap_slab_pool_can_allocate(const iree_hal_heap_slab_pool_t* pool,
+                                          iree_device_size_t size) {
+  return size > 0 && size <= pool->params.max_block_size;
+}
+
+static iree_device_size_t iree_hal_heap_slab_pool_block_size(
+    const iree_hal_heap_slab_pool_t* pool, uint32_t level) {
+  return pool->params.min_block_size << level;
+}
+
+static uint32_t iree_hal_heap_slab_pool_level_for_size(
+    const iree_hal_heap_slab_pool_t* pool, iree_device_size_t size) {
+  const uint64_t block_size = iree_max(
+      pool->params.min_block_size, iree_math_round_up_to_pow2_u64(size));
+  return iree_hal_heap_slab_log2(block_size) - pool->min_block_size_log2;
+}
+
+static uint32_t iree_hal_heap_slab_pool_block_index(
+    const iree_hal_heap_slab_pool_t* pool, const iree_hal_heap_slab_t* slab,
+    const uint8_t* ptr) {
+  return (uint32_t)((ptr - slab->base) >> pool->min_block_size_log2);
+}
+
+// Adds the block at |ptr| to the |level| free list.
+// Must be called with the pool lock held.
+static void iree_hal_heap_slab_pool_push_free(iree_hal_heap_slab_pool_t* pool,
+                                              iree_hal_heap_slab_t* slab,
+                                              uint8_t* ptr, uint32_t level) {
+  iree_hal_heap_slab_free_block_t* block =
+      (iree_hal_heap_slab_free_block_t*)ptr;
+  block->slab = slab;
+  block->prev = NULL;
+  block->next = pool->free_lists[level];
+  if (block->next) block->next->prev = block;
+  pool->free_lists[level] = block;
+  slab->block_states[iree_hal_heap_slab_pool_block_index(pool, slab, ptr)] =
+      (uint8_t)(IREE_HAL_HEAP_SLAB_BLOCK_STATE_FREE | level);
+  pool->free_bytes += iree_hal_heap_slab_pool_block_size(pool, level);
+}
+
+// Removes the free |block| from the |level| free list.
+// Must be called with the pool lock held.
+static void iree_hal_heap_slab_pool_take_free(
+    iree_hal_heap_slab_pool_t* pool, iree_hal_heap_slab_free_block_t* block,
+    uint32_t level) {
+  if (block->prev) {
+    block->prev->next = block->next;
+  } else {
+    pool->free_lists[level] = block->next;
+  }
+  if (block->next) block->next->prev = block->prev;
+  iree_hal_heap_slab_t* slab = block->slab;
+  slab->block_states[iree_hal_heap_slab_pool_block_index(
+      pool, slab, (const uint8_t*)block)] = 0;
+  pool->free_bytes -= iree_hal_heap_slab_pool_block_size(pool, level);
+}
+
+// Allocates a new slab and adds it to the top-level free list.
+// Must be called with the pool lock held.
+static iree_status_t iree_hal_heap_slab_pool_grow(
+    iree_hal_heap_slab_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, pool->params.slab_size);
+
+  const iree_host_size_t block_count = (iree_host_size_t)1
+                                       << pool->slab_level;
+  iree_hal_heap_slab_t* slab = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(pool->host_allocator,
+                                sizeof(*slab) + block_count, (void**)&slab));
+  iree_status_t status = iree_allocator_malloc_aligned(
+      pool->data_allocator, (iree_host_size_t)pool->params.slab_size,
+      (iree_host_size_t)pool->params.min_block_size, /*offset=*/0,
+      (void**)&slab->base);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(pool->host_allocator, slab);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  slab->next = pool->slab_list;
+  pool->slab_list = slab;
+  ++pool->slab_count;
+  iree_hal_heap_slab_pool_push_free(pool, slab, slab->base, pool->slab_level);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_heap_slab_pool_allocate(
+    iree_hal_heap_slab_pool_t* pool, iree_device_size_t size,
+    iree_hal_heap_slab_block_t* out_block) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_block);
+  memset(out_block, 0, sizeof(*out_block));
+  if (!iree_hal_heap_slab_pool_can_allocate(pool, size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "allocation of %" PRIdsz
+                            " bytes exceeds the maximum slab block size",
+                            size);
+  }
+  const uint32_t level = iree_hal_heap_slab_pool_level_for_size(pool, size);
+  const iree_device_size_t block_size =
+      iree_hal_heap_slab_pool_block_size(pool, level);
+
+  // Fast path: reuse a recently freed block of the same size class.
+  iree_hal_heap_slab_cache_t* cache = &pool->caches[level];
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_heap_slab_free_block_t* cached_block = cache->head;
+  if (cached_block) {
+    cache->head = cached_block->next;
+    --cache->count;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  if (cached_block) {
+    out_block->slab = cached_block->slab;
+    out_block->ptr = (uint8_t*)cached_block;
+    iree_atomic_fetch_add_int64(&pool->cached_bytes, -(int64_t)block_size,
+                                iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int64(&pool->allocated_bytes, (int64_t)block_size,
+                                iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int64(&pool->requested_bytes, (int64_t)size,
+                                iree_memory_order_relaxed);
+    return iree_ok_status();
+  }
+
+  iree_slim_mutex_lock(&pool->mutex);
+
+  // Find the smallest free block that can hold the allocation, growing the
+  // pool by a slab if there are none.
+  uint32_t free_level = level;
+  while (free_level <= pool->slab_level && !pool->free_lists[free_level]) {
+    ++free_level;
+  }
+  if (free_level > pool->slab_level) {
+    iree_status_t status = iree_hal_heap_slab_pool_grow(pool);
+    if (!iree_status_is_ok(status)) {
+      iree_slim_mutex_unlock(&pool->mutex);
+      return status;
+    }
+    free_level = pool->slab_level;
+  }
+  iree_hal_heap_slab_free_block_t* free_block = pool->free_lists[free_level];
+  iree_hal_heap_slab_t* slab = free_block->slab;
+  iree_hal_heap_slab_pool_take_free(pool, free_block, free_level);
+
+  // Split the block in halves until it is the requested size, returning the
+  // upper halves to the free lists.
+  uint8_t* ptr = (uint8_t*)free_block;
+  while (free_level > level) {
+    --free_level;
+    iree_hal_heap_slab_pool_push_free(
+        pool, slab, ptr + iree_hal_heap_slab_pool_block_size(pool, free_level),
+        free_level);
+  }
+
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  out_block->slab = slab;
+  out_block->ptr = ptr;
+  iree_atomic_fetch_add_int64(&pool->allocated_bytes, (int64_t)block_size,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&pool->requested_bytes, (int64_t)size,
+                              iree_memory_order_relaxed);
+  return iree_ok_status();
+}
+
+// Returns a block to the free lists, coalescing it with its free buddies.
+// Must be called with the pool lock held.
+static void iree_hal_heap_slab_pool_release_block(
+    iree_hal_heap_slab_pool_t* pool, iree_hal_heap_slab_t* slab, uint8_t* ptr,
+    uint32_t level) {
+  uint32_t index = iree_hal_heap_slab_pool_block_index(pool, slab, ptr);
+  while (level < pool->slab_level) {
+    const uint32_t buddy_index = index ^ (1u << level);
+    if (slab->block_states[buddy_index] !=
+        (uint8_t)(IREE_HAL_HEAP_SLAB_BLOCK_STATE_FREE | level)) {
+      break;  // buddy in use or split
+    }
+    iree_hal_heap_slab_pool_take_free(
+        pool,
+        (iree_hal_heap_slab_free_block_t*)(slab->base +
+                                           ((iree_host_size_t)buddy_index
+                                            << pool->min_block_size_log2)),
+        level);
+    index &= ~(1u << level);
+    ++level;
+  }
+  iree_hal_heap_slab_pool_push_free(
+      pool, slab,
+      slab->base + ((iree_host_size_t)index << pool->min_block_size_log2),
+      level);
+}
+
+void iree_hal_heap_slab_pool_free(iree_hal_heap_slab_pool_t* pool,
+                                  iree_device_size_t size,
+                                  iree_hal_heap_slab_block_t block) {
+  const uint32_t level = iree_hal_heap_slab_pool_level_for_size(pool, size);
+  const iree_device_size_t block_size =
+      iree_hal_heap_slab_pool_block_size(pool, level);
+  iree_atomic_fetch_add_int64(&pool->allocated_bytes, -(int64_t)block_size,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&pool->requested_bytes, -(int64_t)size,
+                              iree_memory_order_relaxed);
+
+  // Try to keep the block around for reuse by the next allocation of the same
+  // size class.
+  iree_hal_heap_slab_cache_t* cache = &pool->caches[level];
+  iree_slim_mutex_lock(&cache->mutex);
+  if (cache->count < pool->params.cache_capacity) {
+    iree_hal_heap_slab_free_block_t* cached_block =
+        (iree_hal_heap_slab_free_block_t*)block.ptr;
+    cached_block->slab = block.slab;
+    cached_block->prev = NULL;
+    cached_block->next = cache->head;
+    cache->head = cached_block;
+    ++cache->count;
+    iree_slim_mutex_unlock(&cache->mutex);
+    iree_atomic_fetch_add_int64(&pool->cached_bytes, (int64_t)block_size,
+                                iree_memory_order_relaxed);
+    return;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_heap_slab_pool_release_block(pool, block.slab, block.ptr, level);
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+void iree_hal_heap_slab_pool_trim(iree_hal_heap_slab_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Flush all caches back into the free lists so that blocks can coalesce.
+  for (uint32_t level = 0; level <= pool->max_block_level; ++level) {
+    iree_hal_heap_slab_cache_t* cache = &pool->caches[level];
+    iree_slim_mutex_lock(&cache->mutex);
+    iree_hal_heap_slab_free_block_t* head = cache->head;
+    iree_host_size_t count = cache->count;
+    cache->head = NULL;
+    cache->count = 0;
+    iree_slim_mutex_unlock(&cache->mutex);
+    if (!head) continue;
+    iree_atomic_fetch_add_int64(
+        &pool->cached_bytes,
+        -(int64_t)(count * iree_hal_heap_slab_pool_block_size(pool, level)),
+        iree_memory_order_relaxed);
+    iree_slim_mutex_lock(&pool->mutex);
+    while (head) {
+      iree_hal_heap_slab_free_block_t* next = head->next;
+      iree_hal_heap_slab_pool_release_block(pool, head->slab, (uint8_t*)head,
+                                            level);
+      head = next;
+    }
+    iree_slim_mutex_unlock(&pool->mutex);
+  }
+
+  // Release all slabs that have fully coalesced.
+  iree_slim_mutex_lock(&pool->mutex);
+  while (pool->free_lists[pool->slab_level]) {
+    iree_hal_heap_slab_free_block_t* free_block =
+        pool->free_lists[pool->slab_level];
+    iree_hal_heap_slab_t* slab = free_block->slab;
+    iree_hal_heap_slab_pool_take_free(pool, free_block, pool->slab_level);
+    iree_hal_heap_slab_t** slab_ptr = &pool->slab_list;
+    while (*slab_ptr != slab) slab_ptr = &(*slab_ptr)->next;
+    *slab_ptr = slab->next;
+    --pool->slab_count;
+    iree_allocator_free_aligned(pool->data_allocator, slab->base);
+    iree_allocator_free(pool->host_allocator, slab);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_heap_slab_pool_query_statistics(
+    iree_hal_heap_slab_pool_t* pool,
+    iree_hal_heap_allocator_slab_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  iree_slim_mutex_lock(&pool->mutex);
+  out_statistics->slab_count = pool->slab_count;
+  out_statistics->reserved_bytes =
+      (iree_device_size_t)pool->slab_count * pool->params.slab_size;
+  out_statistics->free_bytes = pool->free_bytes;
+  for (int32_t level = (int32_t)pool->slab_level; level >= 0; --level) {
+    if (pool->free_lists[level]) {
+      out_statistics->largest_free_block_size =
+          iree_hal_heap_slab_pool_block_size(pool, (uint32_t)level);
+      break;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  out_statistics->allocated_bytes = (iree_device_size_t)iree_atomic_load_int64(
+      &pool->allocated_bytes, iree_memory_order_relaxed);
+  out_statistics->requested_bytes = (iree_device_size_t)iree_atomic_load_int64(
+      &pool->requested_bytes, iree_memory_order_relaxed);
+  out_statistics->cached_bytes = (iree_device_size_t)iree_atomic_load_int64(
+      &pool->cached_bytes, iree_memory_order_relaxed);
+}
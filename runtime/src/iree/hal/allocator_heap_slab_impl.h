@@ -0,0 +1,132 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_ALLOCATOR_HEAP_SLAB_IMPL_H_
+#define IREE_HAL_ALLOCATOR_HEAP_SLAB_IMPL_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/allocator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_slab_pool_t
+//===----------------------------------------------------------------------===//
+
+// Maximum number of block levels (powers of two between the minimum block size
+// and the slab size) supported by a pool.
+#define IREE_HAL_HEAP_SLAB_MAX_LEVELS 24
+
+typedef struct iree_hal_heap_slab_t iree_hal_heap_slab_t;
+
+// A free block stored in-place at the head of the free block memory.
+typedef struct iree_hal_heap_slab_free_block_t {
+  struct iree_hal_heap_slab_free_block_t* next;
+  struct iree_hal_heap_slab_free_block_t* prev;
+  // Slab the block is from; only valid while cached.
+  iree_hal_heap_slab_t* slab;
+} iree_hal_heap_slab_free_block_t;
+
+// Cache of freed blocks of a single size class.
+// Blocks in the cache are considered allocated by the slab and are handed out
+// again without splitting or coalescing.
+typedef struct iree_hal_heap_slab_cache_t {
+  iree_slim_mutex_t mutex;
+  iree_hal_heap_slab_free_block_t* head IREE_GUARDED_BY(mutex);
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+} iree_hal_heap_slab_cache_t;
+
+// A block allocated from the pool.
+typedef struct iree_hal_heap_slab_block_t {
+  // Slab the block is allocated from.
+  iree_hal_heap_slab_t* slab;
+  // Base pointer of the block aligned to at least the minimum block size.
+  uint8_t* ptr;
+} iree_hal_heap_slab_block_t;
+
+// A power-of-two size-class (buddy) sub-allocator.
+// Slabs are allocated from |data_allocator| and recursively split in half to
+// serve smaller requests. Freed blocks are first placed in the per-level cache
+// and once that is full they are coalesced with their buddies.
+//
+// Thread-safe.
+typedef struct iree_hal_heap_slab_pool_t {
+  iree_hal_heap_allocator_slab_params_t params;
+  iree_allocator_t data_allocator;
+  iree_allocator_t host_allocator;
+
+  // log2 of params.min_block_size.
+  uint32_t min_block_size_log2;
+  // Level of an entire slab.
+  uint32_t slab_level;
+  // Level of the largest allocatable block (params.max_block_size).
+  uint32_t max_block_level;
+
+  // Per-level caches of freed blocks up to max_block_level.
+  iree_hal_heap_slab_cache_t caches[IREE_HAL_HEAP_SLAB_MAX_LEVELS];
+
+  // Guards the slab list and free lists.
+  iree_slim_mutex_t mutex;
+  // All live slabs.
+  iree_hal_heap_slab_t* slab_list IREE_GUARDED_BY(mutex);
+  // Doubly-linked free lists for each level.
+  iree_hal_heap_slab_free_block_t* free_lists[IREE_HAL_HEAP_SLAB_MAX_LEVELS]
+      IREE_GUARDED_BY(mutex);
+  iree_host_size_t slab_count IREE_GUARDED_BY(mutex);
+  iree_device_size_t free_bytes IREE_GUARDED_BY(mutex);
+
+  // Statistics updated outside of the pool lock.
+  iree_atomic_int64_t allocated_bytes;
+  iree_atomic_int64_t requested_bytes;
+  iree_atomic_int64_t cached_bytes;
+} iree_hal_heap_slab_pool_t;
+
+// Initializes |out_pool| with the given |params|.
+// Slabs are allocated from |data_allocator| and slab metadata from
+// |host_allocator|.
+iree_status_t iree_hal_heap_slab_pool_initialize(
+    const iree_hal_heap_allocator_slab_params_t* params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_heap_slab_pool_t* out_pool);
+
+// Deinitializes |pool| and frees all slabs.
+// All blocks must have been freed back to the pool.
+void iree_hal_heap_slab_pool_deinitialize(iree_hal_heap_slab_pool_t* pool);
+
+// Returns true if the pool can serve allocations of |size| bytes.
+bool iree_hal_heap_slab_pool_can_allocate(const iree_hal_heap_slab_pool_t* pool,
+                                          iree_device_size_t size);
+
+// Allocates a block of at least |size| bytes from the pool.
+// Contents of the block are undefined.
+iree_status_t iree_hal_heap_slab_pool_allocate(
+    iree_hal_heap_slab_pool_t* pool, iree_device_size_t size,
+    iree_hal_heap_slab_block_t* out_block);
+
+// Frees a |block| of |size| requested bytes back to the pool.
+// |size| must match the size the block was allocated with as the size class of
+// the block is derived from it.
+void iree_hal_heap_slab_pool_free(iree_hal_heap_slab_pool_t* pool,
+                                  iree_device_size_t size,
+                                  iree_hal_heap_slab_block_t block);
+
+// Flushes all caches and returns fully free slabs to the data allocator.
+void iree_hal_heap_slab_pool_trim(iree_hal_heap_slab_pool_t* pool);
+
+// Queries the current pool statistics.
+void iree_hal_heap_slab_pool_query_statistics(
+    iree_hal_heap_slab_pool_t* pool,
+    iree_hal_heap_allocator_slab_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_ALLOCATOR_HEAP_SLAB_IMPL_H_
@@ -0,0 +1,149 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class HeapAllocatorSlabTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_hal_heap_allocator_slab_params_initialize(&slab_params_);
+    slab_params_.min_block_size = 256;
+    slab_params_.max_block_size = 16 * 1024;
+    slab_params_.slab_size = 64 * 1024;
+    slab_params_.cache_capacity = 4;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap_with_slabs(
+        iree_make_cstring_view("heap"), &slab_params_,
+        iree_allocator_system(), iree_allocator_system(), &allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(allocator_); }
+
+  iree_hal_buffer_t* Allocate(iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+    params.usage = IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(
+        iree_hal_allocator_allocate_buffer(allocator_, params, size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_heap_allocator_slab_statistics_t QueryStatistics() {
+    iree_hal_heap_allocator_slab_statistics_t statistics;
+    IREE_CHECK_OK(
+        iree_hal_heap_allocator_query_slab_statistics(allocator_, &statistics));
+    return statistics;
+  }
+
+  iree_hal_heap_allocator_slab_params_t slab_params_;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(HeapAllocatorSlabTest, AllocateAndRoundTrip) {
+  iree_hal_buffer_t* buffer = Allocate(100);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer), 100);
+
+  std::vector<uint8_t> source(100);
+  for (size_t i = 0; i < source.size(); ++i) source[i] = (uint8_t)i;
+  IREE_ASSERT_OK(iree_hal_buffer_map_write(buffer, 0, source.data(),
+                                           source.size()));
+  std::vector<uint8_t> target(100);
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_read(buffer, 0, target.data(), target.size()));
+  EXPECT_EQ(source, target);
+
+  iree_hal_heap_allocator_slab_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.slab_count, 1);
+  EXPECT_EQ(statistics.reserved_bytes, slab_params_.slab_size);
+  EXPECT_EQ(statistics.allocated_bytes, slab_params_.min_block_size);
+  EXPECT_GT(statistics.requested_bytes, 100);
+
+  iree_hal_buffer_release(buffer);
+  statistics = QueryStatistics();
+  EXPECT_EQ(statistics.allocated_bytes, 0);
+  EXPECT_EQ(statistics.requested_bytes, 0);
+  EXPECT_EQ(statistics.cached_bytes, slab_params_.min_block_size);
+}
+
+TEST_F(HeapAllocatorSlabTest, CachedBlocksAreReused) {
+  iree_hal_buffer_t* buffer0 = Allocate(1000);
+  void* ptr0 = buffer0;
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_t* buffer1 = Allocate(1000);
+  EXPECT_EQ(ptr0, (void*)buffer1);
+  EXPECT_EQ(QueryStatistics().cached_bytes, 0);
+  iree_hal_buffer_release(buffer1);
+}
+
+TEST_F(HeapAllocatorSlabTest, TrimCoalescesAndReleasesSlabs) {
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (int i = 0; i < 64; ++i) {
+    buffers.push_back(Allocate(64 + i * 16));
+  }
+  iree_hal_heap_allocator_slab_statistics_t statistics = QueryStatistics();
+  EXPECT_GE(statistics.slab_count, 1);
+  EXPECT_GE(statistics.allocated_bytes, statistics.requested_bytes);
+  for (auto* buffer : buffers) iree_hal_buffer_release(buffer);
+
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+  statistics = QueryStatistics();
+  EXPECT_EQ(statistics.slab_count, 0);
+  EXPECT_EQ(statistics.reserved_bytes, 0);
+  EXPECT_EQ(statistics.cached_bytes, 0);
+  EXPECT_EQ(statistics.free_bytes, 0);
+}
+
+TEST_F(HeapAllocatorSlabTest, LargeAllocationsBypassSlabs) {
+  iree_hal_buffer_t* buffer = Allocate(slab_params_.max_block_size * 2);
+  iree_hal_heap_allocator_slab_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.slab_count, 0);
+  EXPECT_EQ(statistics.allocated_bytes, 0);
+  iree_hal_buffer_release(buffer);
+}
+
+TEST(HeapAllocatorTest, QuerySlabStatisticsWithoutSlabs) {
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("heap"), iree_allocator_system(),
+      iree_allocator_system(), &allocator));
+  iree_hal_heap_allocator_slab_statistics_t statistics;
+  IREE_ASSERT_OK(
+      iree_hal_heap_allocator_query_slab_statistics(allocator, &statistics));
+  EXPECT_EQ(statistics.slab_count, 0);
+  EXPECT_EQ(statistics.reserved_bytes, 0);
+  iree_hal_allocator_release(allocator);
+}
+
+TEST(HeapAllocatorTest, InvalidSlabParams) {
+  iree_hal_heap_allocator_slab_params_t slab_params;
+  iree_hal_heap_allocator_slab_params_initialize(&slab_params);
+  slab_params.min_block_size = 100;
+  iree_hal_allocator_t* allocator = NULL;
+  EXPECT_THAT(Status(iree_hal_allocator_create_heap_with_slabs(
+                  iree_make_cstring_view("heap"), &slab_params,
+                  iree_allocator_system(), iree_allocator_system(),
+                  &allocator)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(allocator, nullptr);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
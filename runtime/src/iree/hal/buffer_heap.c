@@ -28,6 +28,9 @@ typedef enum iree_hal_heap_buffer_storage_mode_e {
   // A user-provided buffer release callback is notified that the buffer is no
   // longer referencing the data.
   IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL = 2u,
+  // Allocated as a [metadata, data] block suballocated from a slab pool.
+  // The block must be freed back to the pool.
+  IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED = 3u,
 } iree_hal_heap_buffer_storage_mode_t;
 
 typedef struct iree_hal_heap_buffer_t {
@@ -40,6 +43,12 @@ typedef struct iree_hal_heap_buffer_t {
     iree_allocator_t data_allocator;
     // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL.
     iree_hal_buffer_release_callback_t release_callback;
+    // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED.
+    // The block pointer is the buffer itself.
+    struct {
+      iree_hal_heap_slab_pool_t* pool;
+      iree_hal_heap_slab_t* slab;
+    } pooled;
   };
 
   // Optional statistics shared with the allocator.
@@ -110,9 +119,48 @@ static iree_status_t iree_hal_heap_buffer_allocate_slab(
   return iree_ok_status();
 }
 
+// Returns the size of the metadata header prefixing pooled buffer storage.
+static iree_host_size_t iree_hal_heap_buffer_pooled_header_size(void) {
+  return iree_host_align(sizeof(iree_hal_heap_buffer_t),
+                         IREE_HAL_HEAP_BUFFER_ALIGNMENT);
+}
+
+// Allocates a buffer with the metadata as a prefix to the storage in a block
+// suballocated from |slab_pool|. Returns false in |out_allocated| without
+// allocating if the pool cannot serve the request.
+static iree_status_t iree_hal_heap_buffer_allocate_pooled(
+    iree_hal_heap_slab_pool_t* slab_pool, iree_device_size_t allocation_size,
+    bool* out_allocated, iree_hal_heap_buffer_t** out_buffer,
+    iree_byte_span_t* out_data) {
+  *out_allocated = false;
+  const iree_host_size_t header_size =
+      iree_hal_heap_buffer_pooled_header_size();
+  const iree_device_size_t total_size = header_size + allocation_size;
+  if (!iree_hal_heap_slab_pool_can_allocate(slab_pool, total_size)) {
+    return iree_ok_status();
+  }
+
+  iree_hal_heap_slab_block_t block;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_heap_slab_pool_allocate(slab_pool, total_size, &block));
+  iree_hal_heap_buffer_t* buffer = (iree_hal_heap_buffer_t*)block.ptr;
+  memset(buffer, 0, sizeof(*buffer));
+  buffer->pooled.pool = slab_pool;
+  buffer->pooled.slab = block.slab;
+  *out_buffer = buffer;
+
+  uint8_t* data_ptr = block.ptr + header_size;
+  IREE_ASSERT_TRUE(iree_host_size_has_alignment(
+      (iree_host_size_t)data_ptr, IREE_HAL_HEAP_BUFFER_ALIGNMENT));
+  *out_data = iree_make_byte_span(data_ptr, allocation_size);
+  *out_allocated = true;
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_allocator_t* allocator,
     iree_hal_heap_allocator_statistics_t* statistics,
+    iree_hal_heap_slab_pool_t* slab_pool,
     const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
     iree_allocator_t data_allocator, iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer) {
@@ -129,12 +177,20 @@ iree_status_t iree_hal_heap_buffer_create(
 
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_byte_span_t data = iree_make_byte_span(NULL, 0);
-  iree_status_t status =
-      same_allocator
-          ? iree_hal_heap_buffer_allocate_slab(allocation_size, host_allocator,
-                                               &buffer, &data)
-          : iree_hal_heap_buffer_allocate_split(allocation_size, data_allocator,
-                                                host_allocator, &buffer, &data);
+  bool pooled = false;
+  iree_status_t status = iree_ok_status();
+  if (slab_pool) {
+    status = iree_hal_heap_buffer_allocate_pooled(slab_pool, allocation_size,
+                                                  &pooled, &buffer, &data);
+  }
+  if (iree_status_is_ok(status) && !pooled) {
+    status = same_allocator
+                 ? iree_hal_heap_buffer_allocate_slab(
+                       allocation_size, host_allocator, &buffer, &data)
+                 : iree_hal_heap_buffer_allocate_split(
+                       allocation_size, data_allocator, host_allocator, &buffer,
+                       &data);
+  }
 
   if (iree_status_is_ok(status)) {
     iree_hal_buffer_initialize(host_allocator, allocator, &buffer->base,
@@ -143,7 +199,9 @@ iree_status_t iree_hal_heap_buffer_create(
                                &iree_hal_heap_buffer_vtable, &buffer->base);
     buffer->data = data;
 
-    if (same_allocator) {
+    if (pooled) {
+      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED;
+    } else if (same_allocator) {
       buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB;
       buffer->data_allocator = iree_allocator_null();
     } else {
@@ -236,6 +294,17 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
       iree_allocator_free(host_allocator, buffer);
       break;
     }
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED: {
+      iree_hal_heap_slab_block_t block = {
+          .slab = buffer->pooled.slab,
+          .ptr = (uint8_t*)buffer,
+      };
+      iree_hal_heap_slab_pool_free(buffer->pooled.pool,
+                                   iree_hal_heap_buffer_pooled_header_size() +
+                                       base_buffer->allocation_size,
+                                   block);
+      break;
+    }
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL: {
       if (buffer->release_callback.fn) {
         buffer->release_callback.fn(buffer->release_callback.user_data,
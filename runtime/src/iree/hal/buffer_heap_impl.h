@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/hal/allocator_heap_slab_impl.h"
 #include "iree/hal/buffer.h"
 
 #ifdef __cplusplus
@@ -29,10 +30,13 @@ typedef struct iree_hal_heap_allocator_statistics_t {
 // Allocates a new heap buffer from the specified |data_allocator|.
 // |host_allocator| is used for the iree_hal_buffer_t metadata. If both
 // |data_allocator| and |host_allocator| are the same the buffer will be created
-// as a flat slab. |out_buffer| must be released by the caller.
+// as a flat slab. If a |slab_pool| is provided and it can serve the allocation
+// the buffer metadata and storage are suballocated from a single pool block
+// instead. |out_buffer| must be released by the caller.
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_allocator_t* allocator,
     iree_hal_heap_allocator_statistics_t* statistics,
+    iree_hal_heap_slab_pool_t* slab_pool,
     const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
     iree_allocator_t data_allocator, iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer);
@@ -9,6 +9,7 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/hal/command_buffer_validation.h"
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
@@ -541,6 +542,11 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_push_descriptor_set(
   return status;
 }
 
+IREE_METRIC_STATIC(iree_hal_command_buffer_dispatches_metric,
+                   IREE_METRIC_KIND_COUNTER,
+                   "iree_hal_command_buffer_dispatches_total",
+                   "Dispatches recorded into HAL command buffers.");
+
 IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch(
     iree_hal_command_buffer_t* command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -581,6 +587,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch(
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, dispatch)(
       command_buffer, executable, entry_point, workgroup_x, workgroup_y,
       workgroup_z);
+  iree_metric_add(&iree_hal_command_buffer_dispatches_metric, 1);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -603,6 +610,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_indirect(
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, dispatch_indirect)(
       command_buffer, executable, entry_point, workgroups_buffer,
       workgroups_offset);
+  iree_metric_add(&iree_hal_command_buffer_dispatches_metric, 1);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -494,6 +494,61 @@ TEST_P(command_buffer_test, UpdateBufferWholeBuffer) {
   iree_hal_buffer_release(device_buffer);
 }
 
+// Tests that reusable command buffers produce the same results each time they
+// are submitted.
+TEST_P(command_buffer_test, UpdateBufferReusable) {
+  iree_device_size_t target_buffer_size = 16;
+  std::vector<uint8_t> source_buffer{0x01, 0x02, 0x03, 0x04,  //
+                                     0x05, 0x06, 0x07, 0x08,  //
+                                     0xA1, 0xA2, 0xA3, 0xA4,  //
+                                     0xA5, 0xA6, 0xA7, 0xA8};
+
+  iree_hal_buffer_t* device_buffer = NULL;
+  CreateZeroedDeviceBuffer(target_buffer_size, &device_buffer);
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_CHECK_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_ANY,
+      IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, source_buffer.data(), /*source_offset=*/0, device_buffer,
+      /*target_offset=*/0, /*length=*/target_buffer_size / 2));
+  IREE_CHECK_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer,
+      /*source_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      /*target_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, /*memory_barrier_count=*/0,
+      /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  IREE_CHECK_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, source_buffer.data(),
+      /*source_offset=*/target_buffer_size / 2, device_buffer,
+      /*target_offset=*/target_buffer_size / 2,
+      /*length=*/target_buffer_size / 2));
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+
+  std::vector<uint8_t> zero_data(target_buffer_size, 0);
+  for (int i = 0; i < 3; ++i) {
+    IREE_CHECK_OK(iree_hal_device_transfer_h2d(
+        device_, zero_data.data(), device_buffer, /*target_offset=*/0,
+        zero_data.size(), IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    IREE_CHECK_OK(SubmitCommandBufferAndWait(command_buffer));
+
+    std::vector<uint8_t> actual_data(target_buffer_size);
+    IREE_CHECK_OK(iree_hal_device_transfer_d2h(
+        device_, device_buffer, /*source_offset=*/0, actual_data.data(),
+        actual_data.size(), IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    EXPECT_THAT(actual_data, ContainerEq(source_buffer));
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(device_buffer);
+}
+
 TEST_P(command_buffer_test, UpdateBufferWithOffsets) {
   iree_device_size_t target_buffer_size = 16;
   std::vector<uint8_t> source_buffer{0x01, 0x02, 0x03, 0x04,  //
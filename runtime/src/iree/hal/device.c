@@ -379,8 +379,11 @@ IREE_API_EXPORT iree_status_t iree_hal_device_wait_semaphores(
   IREE_ASSERT_ARGUMENT(device);
   if (semaphore_list.count == 0) return iree_ok_status();
   IREE_TRACE_ZONE_BEGIN(z0);
+  const bool is_blocking = !iree_timeout_is_immediate(timeout);
+  const iree_time_t start_time_ns = is_blocking ? iree_time_now() : 0;
   iree_status_t status = _VTABLE_DISPATCH(device, wait_semaphores)(
       device, wait_mode, semaphore_list, timeout);
+  if (is_blocking) iree_hal_semaphore_record_wait_duration(start_time_ns);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
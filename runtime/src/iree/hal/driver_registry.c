@@ -31,7 +31,9 @@
 
 struct iree_hal_driver_registry_t {
   iree_allocator_t host_allocator;
-  iree_slim_mutex_t mutex;
+  // Held exclusively when (un)registering factories and shared while
+  // enumerating or creating drivers so that concurrent queries don't serialize.
+  iree_slim_rwlock_t lock;
 
   // Factories in registration order. As factories are unregistered the list is
   // shifted to be kept dense.
@@ -45,7 +47,7 @@ static iree_once_flag iree_hal_driver_registry_default_flag_ =
 static void iree_hal_driver_registry_default_initialize(void) {
   memset(&iree_hal_driver_registry_default_, 0,
          sizeof(iree_hal_driver_registry_default_));
-  iree_slim_mutex_initialize(&iree_hal_driver_registry_default_.mutex);
+  iree_slim_rwlock_initialize(&iree_hal_driver_registry_default_.lock);
 }
 
 IREE_API_EXPORT iree_hal_driver_registry_t* iree_hal_driver_registry_default(
@@ -67,7 +69,7 @@ iree_hal_driver_registry_allocate(iree_allocator_t host_allocator,
       z0, iree_allocator_malloc(host_allocator, sizeof(*registry),
                                 (void**)&registry));
   registry->host_allocator = host_allocator;
-  iree_slim_mutex_initialize(&registry->mutex);
+  iree_slim_rwlock_initialize(&registry->lock);
 
   *out_registry = registry;
   IREE_TRACE_ZONE_END(z0);
@@ -80,7 +82,7 @@ IREE_API_EXPORT void iree_hal_driver_registry_free(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_allocator_t host_allocator = registry->host_allocator;
 
-  iree_slim_mutex_deinitialize(&registry->mutex);
+  iree_slim_rwlock_deinitialize(&registry->lock);
   iree_allocator_free(host_allocator, registry);
 
   IREE_TRACE_ZONE_END(z0);
@@ -90,7 +92,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_register_factory(
     iree_hal_driver_registry_t* registry,
     const iree_hal_driver_factory_t* factory) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_slim_mutex_lock(&registry->mutex);
+  iree_slim_rwlock_lock(&registry->lock);
 
   // Fail if already present; not because having it in there would harm anything
   // but because we can't then balance with unregisters if we were to skip it
@@ -121,7 +123,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_register_factory(
     registry->factories[registry->factory_count++] = factory;
   }
 
-  iree_slim_mutex_unlock(&registry->mutex);
+  iree_slim_rwlock_unlock(&registry->lock);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -130,7 +132,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_unregister_factory(
     iree_hal_driver_registry_t* registry,
     const iree_hal_driver_factory_t* factory) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_slim_mutex_lock(&registry->mutex);
+  iree_slim_rwlock_lock(&registry->lock);
 
   iree_status_t status = iree_ok_status();
   iree_host_size_t index = -1;
@@ -148,11 +150,12 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_unregister_factory(
   if (iree_status_is_ok(status)) {
     // Compact list. Note that registration order is preserved.
     memmove((void*)&registry->factories[index], &registry->factories[index + 1],
-            registry->factory_count - index - 1);
+            (registry->factory_count - index - 1) *
+                sizeof(registry->factories[0]));
     registry->factories[--registry->factory_count] = NULL;
   }
 
-  iree_slim_mutex_unlock(&registry->mutex);
+  iree_slim_rwlock_unlock(&registry->lock);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -199,7 +202,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_enumerate(
   *out_driver_infos = NULL;
 
   iree_status_t status = iree_ok_status();
-  iree_slim_mutex_lock(&registry->mutex);
+  iree_slim_rwlock_lock_shared(&registry->lock);
 
   // Enumerate each factory and figure out how much memory we need to fully
   // store all data we need to clone.
@@ -252,7 +255,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_enumerate(
     *out_driver_info_count = total_driver_info_count;
   }
 
-  iree_slim_mutex_unlock(&registry->mutex);
+  iree_slim_rwlock_unlock_shared(&registry->lock);
 
   // Cleanup memory if we failed.
   if (!iree_status_is_ok(status) && *out_driver_infos) {
@@ -275,7 +278,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_try_create(
   // allocations and avoid spurious failures by outside mutation of the
   // registry.
   iree_status_t status = iree_ok_status();
-  iree_slim_mutex_lock(&registry->mutex);
+  iree_slim_rwlock_lock_shared(&registry->lock);
 
   // Enumerate each factory and scan for the requested driver.
   // NOTE: we scan in reverse so that we prefer the first hit in the most
@@ -319,7 +322,7 @@ IREE_API_EXPORT iree_status_t iree_hal_driver_registry_try_create(
                          (int)driver_name.size, driver_name.data);
   }
 
-  iree_slim_mutex_unlock(&registry->mutex);
+  iree_slim_rwlock_unlock_shared(&registry->lock);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -53,7 +53,8 @@ typedef struct iree_hal_driver_factory_t {
   // devices then it must do so by first unregistering itself and re-registering
   // only after the changes have been made.
   //
-  // Called with the driver registry lock held; may be called from any thread.
+  // Called with the driver registry lock held for reading; may be called from
+  // any thread and concurrently from multiple threads.
   iree_status_t(IREE_API_PTR* enumerate)(
       void* self, iree_host_size_t* out_driver_info_count,
       const iree_hal_driver_info_t** out_driver_infos);
@@ -66,7 +67,8 @@ typedef struct iree_hal_driver_factory_t {
   // Delay-loaded drivers may still fail here if - for example - required system
   // resources are unavailable or permission is denied.
   //
-  // Called with the driver registry lock held; may be called from any thread.
+  // Called with the driver registry lock held for reading; may be called from
+  // any thread and concurrently from multiple threads.
   iree_status_t(IREE_API_PTR* try_create)(void* self,
                                           iree_string_view_t driver_name,
                                           iree_allocator_t host_allocator,
@@ -36,11 +36,14 @@ typedef struct {
 // Parameters defining a CUmemoryPool.
 typedef struct iree_hal_cuda_memory_pool_params_t {
   // Minimum number of bytes to keep in the pool when trimming with
-  // iree_hal_device_trim.
+  // iree_hal_device_trim. This much memory is reserved when the device is
+  // created so that initial allocations do not need to grow the pool.
   uint64_t minimum_capacity;
   // Soft maximum number of bytes to keep in the pool.
   // When more than this is allocated the extra will be freed at the next
-  // device synchronization in order to remain under the threshold.
+  // device synchronization in order to remain under the threshold. Values below
+  // |minimum_capacity| are raised to it. UINT64_MAX retains all memory until
+  // the device is trimmed.
   uint64_t release_threshold;
   // TODO: per-device access permissions array.
 } iree_hal_cuda_memory_pool_params_t;
@@ -51,6 +54,10 @@ typedef struct iree_hal_cuda_memory_pooling_params_t {
   iree_hal_cuda_memory_pool_params_t device_local;
   // Used for any host-visible/host-local memory types.
   iree_hal_cuda_memory_pool_params_t other;
+  // Creates a separate set of pools for each queue so that allocations with
+  // different queue affinities do not share or fragment each other's memory.
+  // Each set is configured with the parameters above.
+  bool per_queue;
 } iree_hal_cuda_memory_pooling_params_t;
 
 // Parameters configuring an iree_hal_cuda_device_t.
@@ -61,6 +68,13 @@ typedef struct iree_hal_cuda_device_params_t {
   // concurrently unless prohibited by semaphores.
   iree_host_size_t queue_count;
 
+  // Maximum number of CUDA streams each queue uses to execute commands recorded
+  // between barriers concurrently. Commands are distributed across the streams
+  // and joined with events at every barrier. 1 serializes all commands on the
+  // queue stream. Ignored when stream tracing is enabled as trace zones must
+  // be recorded in order on a single stream.
+  iree_host_size_t concurrent_stream_count;
+
   // Total size of each block in the device shared block pool.
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
@@ -69,6 +83,17 @@ typedef struct iree_hal_cuda_device_params_t {
   // Specifies how command buffers are recorded and executed.
   iree_hal_cuda_command_buffer_mode_t command_buffer_mode;
 
+  // Maximum number of idle instantiated CUDA graphs retained for reuse by
+  // graph command buffers. Command buffers with the same structure as a cached
+  // graph update it with cuGraphExecUpdate instead of instantiating a new one.
+  // 0 disables caching.
+  iree_host_size_t graph_exec_cache_capacity;
+
+  // Number of host and device events retained by the device for chaining
+  // queue submissions and waiting on semaphores. More events are created on
+  // demand when exhausted.
+  iree_host_size_t event_pool_capacity;
+
   // Allow executing command buffers against CUDA streams as they are recorded.
   // Only command buffers produced by the compiler that have the
   // IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION bit set will use this.
@@ -90,6 +115,34 @@ typedef struct iree_hal_cuda_device_params_t {
 
   // Parameters for each CUmemoryPool used for queue-ordered allocations.
   iree_hal_cuda_memory_pooling_params_t memory_pools;
+
+  // Maximum size in bytes of buckets used to fuse small all-reduce operations
+  // recorded between barriers in stream command buffers. Runs of all-reduces
+  // on the same channel with the same element type and reduction are copied
+  // into a contiguous bucket allocated from the queue memory pool and reduced
+  // with a single collective. Requires memory pool support on the device.
+  // 0 (the default) issues each all-reduce individually.
+  iree_device_size_t collective_bucket_size;
+
+  // Maximum number of idle host memory registrations retained for reuse.
+  // Importing host allocations registers them with cuMemHostRegister so that
+  // the device can access them in place. Registration pins the pages and is
+  // expensive so imports that fall within a registered range share it. When
+  // non-zero registrations are kept after their last imported buffer is
+  // released so that repeatedly importing the same host memory does not
+  // re-register it; least recently used registrations are evicted beyond the
+  // capacity and all idle registrations are dropped on trim.
+  //
+  // WARNING: retained registrations outlive the imported buffers and the host
+  // memory must remain allocated until the device is trimmed or destroyed.
+  // 0 (the default) unregisters memory as soon as it is no longer imported.
+  iree_host_size_t host_registration_cache_capacity;
+
+  // Optional directory used to persist cubins produced by JIT compiling PTX.
+  // Entries are keyed by the PTX hash, device compute capability, and driver
+  // version. The directory must exist and be writable. Empty disables
+  // persistent caching. The string is copied by the driver and device.
+  iree_string_view_t executable_cache_path;
 } iree_hal_cuda_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -121,6 +174,41 @@ IREE_API_EXPORT iree_status_t iree_hal_cuda_driver_create(
 
 // TODO(thomasraoux): Support importing a CUcontext from app.
 
+//===----------------------------------------------------------------------===//
+// Growable buffers
+//===----------------------------------------------------------------------===//
+
+// Allocates a device-local buffer that reserves |reserved_size| bytes of
+// contiguous device address space but only backs the first |committed_size|
+// bytes with physical memory. The buffer reports |reserved_size| as its
+// allocation size and its device address never changes: growing with
+// iree_hal_cuda_buffer_commit maps more physical memory after the committed
+// range instead of reallocating and copying. This suits storage such as KV
+// caches and dynamically sized outputs whose final size is only bounded.
+//
+// Only the committed range may be accessed; accesses beyond it fault.
+// |allocator| must be the allocator of a CUDA device and the device must
+// support CU_DEVICE_ATTRIBUTE_VIRTUAL_MEMORY_MANAGEMENT_SUPPORTED.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_allocator_allocate_growable_buffer(
+    iree_hal_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t reserved_size, iree_device_size_t committed_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Commits physical memory so that at least the first |minimum_committed_size|
+// bytes of the growable |buffer| (or a subspan of one) are accessible. Commits
+// are rounded up to the device allocation granularity and are a no-op if the
+// range is already committed. Existing contents and in-flight work using the
+// committed range are unaffected.
+//
+// Not thread-safe with respect to other commits of the same buffer.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_buffer_commit(
+    iree_hal_buffer_t* buffer, iree_device_size_t minimum_committed_size);
+
+// Returns the number of bytes from the start of |buffer| that are accessible.
+// Buffers that are not growable are always fully committed.
+IREE_API_EXPORT iree_device_size_t
+iree_hal_cuda_buffer_committed_size(const iree_hal_buffer_t* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
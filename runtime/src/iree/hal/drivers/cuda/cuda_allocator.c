@@ -7,8 +7,11 @@
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/api.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/status_util.h"
@@ -17,6 +20,23 @@
 static const char* IREE_HAL_CUDA_ALLOCATOR_ID = "CUDA unpooled";
 #endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
 
+// A range of host memory registered with cuMemHostRegister.
+// Imports of host allocations falling within the range share the registration
+// as CUDA does not allow registering overlapping ranges.
+typedef struct iree_hal_cuda_host_registration_t {
+  struct iree_hal_cuda_host_registration_t* next;
+  // Base host pointer and size in bytes of the registered range.
+  void* host_ptr;
+  iree_device_size_t size;
+  // Device pointer aliasing |host_ptr|.
+  CUdeviceptr device_ptr;
+  // Flags the range was registered with.
+  uint32_t register_flags;
+  // Number of live imported buffers using the registration. Idle
+  // registrations have a count of 0 and are only retained by the cache.
+  iree_host_size_t ref_count;
+} iree_hal_cuda_host_registration_t;
+
 typedef struct iree_hal_cuda_allocator_t {
   iree_hal_resource_t resource;
   iree_hal_cuda_context_wrapper_t* context;
@@ -25,6 +45,19 @@ typedef struct iree_hal_cuda_allocator_t {
   iree_hal_cuda_memory_pools_t* pools;
   bool supports_concurrent_managed_access;
   bool supports_read_only_host_register;
+  bool supports_virtual_memory_management;
+
+  // Maximum number of idle host registrations retained.
+  iree_host_size_t host_registration_cache_capacity;
+  // Guards the host registration list as buffers may be imported and released
+  // from any thread.
+  iree_slim_mutex_t host_registration_mutex;
+  // Host registrations ordered from most to least recently used.
+  iree_hal_cuda_host_registration_t* host_registrations
+      IREE_GUARDED_BY(host_registration_mutex);
+  // Number of registrations in |host_registrations| with a ref_count of 0.
+  iree_host_size_t idle_host_registration_count
+      IREE_GUARDED_BY(host_registration_mutex);
 
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_cuda_allocator_t;
@@ -39,7 +72,9 @@ static iree_hal_cuda_allocator_t* iree_hal_cuda_allocator_cast(
 
 iree_status_t iree_hal_cuda_allocator_create(
     iree_hal_cuda_context_wrapper_t* context, CUdevice device, CUstream stream,
-    iree_hal_cuda_memory_pools_t* pools, iree_hal_allocator_t** out_allocator) {
+    iree_hal_cuda_memory_pools_t* pools,
+    iree_host_size_t host_registration_cache_capacity,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(pools);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -79,6 +114,18 @@ iree_status_t iree_hal_cuda_allocator_create(
                                       ? "has READ_ONLY_HOST_REGISTER_SUPPORTED"
                                       : "no READ_ONLY_HOST_REGISTER_SUPPORTED");
 
+  // Growable buffers reserve device address ranges and commit physical memory
+  // behind them on demand.
+  int supports_virtual_memory_management = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, CU_RESULT_TO_STATUS(
+              context->syms,
+              cuDeviceGetAttribute(
+                  &supports_virtual_memory_management,
+                  CU_DEVICE_ATTRIBUTE_VIRTUAL_MEMORY_MANAGEMENT_SUPPORTED,
+                  device),
+              "cuDeviceGetAttribute"));
+
   iree_hal_cuda_allocator_t* allocator = NULL;
   iree_status_t status = iree_allocator_malloc(
       context->host_allocator, sizeof(*allocator), (void**)&allocator);
@@ -93,6 +140,13 @@ iree_status_t iree_hal_cuda_allocator_create(
         supports_concurrent_managed_access != 0;
     allocator->supports_read_only_host_register =
         supports_read_only_host_register != 0;
+    allocator->supports_virtual_memory_management =
+        supports_virtual_memory_management != 0;
+    allocator->host_registration_cache_capacity =
+        host_registration_cache_capacity;
+    iree_slim_mutex_initialize(&allocator->host_registration_mutex);
+    allocator->host_registrations = NULL;
+    allocator->idle_host_registration_count = 0;
     *out_allocator = (iree_hal_allocator_t*)allocator;
   }
 
@@ -100,6 +154,171 @@ iree_status_t iree_hal_cuda_allocator_create(
   return status;
 }
 
+//===----------------------------------------------------------------------===//
+// Host memory registration
+//===----------------------------------------------------------------------===//
+
+// Unregisters and frees |registration|, which must already be unlinked.
+static void iree_hal_cuda_host_registration_free(
+    iree_hal_cuda_allocator_t* allocator,
+    iree_hal_cuda_host_registration_t* registration) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  CUDA_IGNORE_ERROR(allocator->context->syms,
+                    cuMemHostUnregister(registration->host_ptr));
+  iree_allocator_free(allocator->context->host_allocator, registration);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Evicts idle registrations, least recently used first, until no more than
+// |max_idle_count| remain. If |overlap_ptr| is non-NULL only idle
+// registrations overlapping [overlap_ptr, overlap_ptr + overlap_size) are
+// evicted, regardless of |max_idle_count|.
+// Must be called with the host_registration_mutex held.
+static void iree_hal_cuda_allocator_evict_host_registrations(
+    iree_hal_cuda_allocator_t* allocator, iree_host_size_t max_idle_count,
+    const void* overlap_ptr, iree_device_size_t overlap_size) {
+  // The list is ordered most recently used first so walk it keeping the most
+  // recent |max_idle_count| idle entries.
+  iree_host_size_t idle_count = 0;
+  iree_hal_cuda_host_registration_t** link = &allocator->host_registrations;
+  while (*link) {
+    iree_hal_cuda_host_registration_t* registration = *link;
+    bool evict = false;
+    if (registration->ref_count == 0) {
+      if (overlap_ptr) {
+        const uint8_t* base = (const uint8_t*)registration->host_ptr;
+        evict = (const uint8_t*)overlap_ptr < base + registration->size &&
+                base < (const uint8_t*)overlap_ptr + overlap_size;
+      } else {
+        evict = ++idle_count > max_idle_count;
+      }
+    }
+    if (evict) {
+      *link = registration->next;
+      --allocator->idle_host_registration_count;
+      iree_hal_cuda_host_registration_free(allocator, registration);
+    } else {
+      link = &registration->next;
+    }
+  }
+}
+
+// Returns a device pointer aliasing |host_ptr| of |size| bytes, registering the
+// memory if it is not already covered by a compatible registration.
+static iree_status_t iree_hal_cuda_allocator_acquire_host_registration(
+    iree_hal_cuda_allocator_t* allocator, void* host_ptr,
+    iree_device_size_t size, uint32_t register_flags,
+    CUdeviceptr* out_device_ptr) {
+  *out_device_ptr = 0;
+  iree_slim_mutex_lock(&allocator->host_registration_mutex);
+
+  // Reuse a registration that covers the requested range. A read-only
+  // registration cannot back a writable import.
+  iree_hal_cuda_host_registration_t** link = &allocator->host_registrations;
+  for (; *link; link = &(*link)->next) {
+    iree_hal_cuda_host_registration_t* registration = *link;
+    const uint8_t* base = (const uint8_t*)registration->host_ptr;
+    if ((const uint8_t*)host_ptr < base ||
+        (const uint8_t*)host_ptr + size > base + registration->size) {
+      continue;
+    }
+    if ((registration->register_flags & CU_MEMHOSTREGISTER_READ_ONLY) &&
+        !(register_flags & CU_MEMHOSTREGISTER_READ_ONLY)) {
+      continue;
+    }
+    if (registration->ref_count++ == 0) {
+      --allocator->idle_host_registration_count;
+    }
+    // Move to the front of the list as the most recently used.
+    *link = registration->next;
+    registration->next = allocator->host_registrations;
+    allocator->host_registrations = registration;
+    *out_device_ptr = registration->device_ptr +
+                      (CUdeviceptr)((const uint8_t*)host_ptr - base);
+    iree_slim_mutex_unlock(&allocator->host_registration_mutex);
+    return iree_ok_status();
+  }
+
+  // CUDA rejects registrations overlapping existing ones; idle registrations
+  // in the way are dropped so that the new range can be registered. Live ones
+  // cause the registration below to fail as before.
+  iree_hal_cuda_allocator_evict_host_registrations(allocator, 0, host_ptr,
+                                                   size);
+
+  iree_hal_cuda_host_registration_t* registration = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(allocator->context->host_allocator,
+                            sizeof(*registration), (void**)&registration);
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "cuMemHostRegister");
+    status = CU_RESULT_TO_STATUS(
+        allocator->context->syms,
+        cuMemHostRegister(host_ptr, size, register_flags), "cuMemHostRegister");
+    IREE_TRACE_ZONE_END(z0);
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(
+          allocator->context->syms,
+          cuMemHostGetDevicePointer(&registration->device_ptr, host_ptr, 0),
+          "cuMemHostGetDevicePointer");
+      if (!iree_status_is_ok(status)) {
+        CUDA_IGNORE_ERROR(allocator->context->syms,
+                          cuMemHostUnregister(host_ptr));
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      registration->host_ptr = host_ptr;
+      registration->size = size;
+      registration->register_flags = register_flags;
+      registration->ref_count = 1;
+      registration->next = allocator->host_registrations;
+      allocator->host_registrations = registration;
+      *out_device_ptr = registration->device_ptr;
+    } else {
+      iree_allocator_free(allocator->context->host_allocator, registration);
+    }
+  }
+
+  iree_slim_mutex_unlock(&allocator->host_registration_mutex);
+  return status;
+}
+
+// Releases the registration backing an import of |host_ptr| acquired with
+// iree_hal_cuda_allocator_acquire_host_registration.
+static void iree_hal_cuda_allocator_release_host_registration(
+    iree_hal_cuda_allocator_t* allocator, void* host_ptr) {
+  iree_slim_mutex_lock(&allocator->host_registration_mutex);
+
+  // Live registrations never overlap so at most one contains |host_ptr|.
+  for (iree_hal_cuda_host_registration_t** link =
+           &allocator->host_registrations;
+       *link; link = &(*link)->next) {
+    iree_hal_cuda_host_registration_t* registration = *link;
+    const uint8_t* base = (const uint8_t*)registration->host_ptr;
+    if (registration->ref_count == 0 || (const uint8_t*)host_ptr < base ||
+        (const uint8_t*)host_ptr >= base + registration->size) {
+      continue;
+    }
+    if (--registration->ref_count == 0) {
+      if (allocator->host_registration_cache_capacity > 0) {
+        // Retain for reuse and evict the least recently used beyond capacity.
+        ++allocator->idle_host_registration_count;
+        iree_hal_cuda_allocator_evict_host_registrations(
+            allocator, allocator->host_registration_cache_capacity, NULL, 0);
+      } else {
+        *link = registration->next;
+        iree_hal_cuda_host_registration_free(allocator, registration);
+      }
+    }
+    break;
+  }
+
+  iree_slim_mutex_unlock(&allocator->host_registration_mutex);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_allocator_t
+//===----------------------------------------------------------------------===//
+
 static void iree_hal_cuda_allocator_destroy(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_cuda_allocator_t* allocator =
@@ -107,6 +326,15 @@ static void iree_hal_cuda_allocator_destroy(
   iree_allocator_t host_allocator = allocator->context->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // All imported buffers must have been released; only idle registrations
+  // retained by the cache remain.
+  iree_slim_mutex_lock(&allocator->host_registration_mutex);
+  iree_hal_cuda_allocator_evict_host_registrations(allocator, 0, NULL, 0);
+  IREE_ASSERT(!allocator->host_registrations,
+              "imported host buffers still live at allocator destruction");
+  iree_slim_mutex_unlock(&allocator->host_registration_mutex);
+  iree_slim_mutex_deinitialize(&allocator->host_registration_mutex);
+
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -121,6 +349,11 @@ static iree_allocator_t iree_hal_cuda_allocator_host_allocator(
 
 static iree_status_t iree_hal_cuda_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_cuda_allocator_t* allocator =
+      iree_hal_cuda_allocator_cast(base_allocator);
+  iree_slim_mutex_lock(&allocator->host_registration_mutex);
+  iree_hal_cuda_allocator_evict_host_registrations(allocator, 0, NULL, 0);
+  iree_slim_mutex_unlock(&allocator->host_registration_mutex);
   return iree_ok_status();
 }
 
@@ -274,9 +507,10 @@ iree_hal_cuda_allocator_query_buffer_compatibility(
   return compatibility;
 }
 
-static void iree_hal_cuda_buffer_free(iree_hal_cuda_context_wrapper_t* context,
+static void iree_hal_cuda_buffer_free(iree_hal_cuda_allocator_t* allocator,
                                       iree_hal_cuda_buffer_type_t buffer_type,
                                       CUdeviceptr device_ptr, void* host_ptr) {
+  iree_hal_cuda_context_wrapper_t* context = allocator->context;
   IREE_TRACE_ZONE_BEGIN(z0);
   switch (buffer_type) {
     case IREE_HAL_CUDA_BUFFER_TYPE_DEVICE: {
@@ -290,8 +524,8 @@ static void iree_hal_cuda_buffer_free(iree_hal_cuda_context_wrapper_t* context,
       break;
     }
     case IREE_HAL_CUDA_BUFFER_TYPE_HOST_REGISTERED: {
-      IREE_TRACE_ZONE_APPEND_TEXT(z0, "cuMemHostUnregister");
-      CUDA_IGNORE_ERROR(context->syms, cuMemHostUnregister(host_ptr));
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "(host registration release)");
+      iree_hal_cuda_allocator_release_host_registration(allocator, host_ptr);
       break;
     }
     case IREE_HAL_CUDA_BUFFER_TYPE_ASYNC: {
@@ -302,6 +536,10 @@ static void iree_hal_cuda_buffer_free(iree_hal_cuda_context_wrapper_t* context,
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; external)");
       break;
     }
+    case IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; release callback)");
+      break;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
 }
@@ -411,7 +649,7 @@ static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
     *out_buffer = buffer;
   } else {
     if (!buffer && (device_ptr || host_ptr)) {
-      iree_hal_cuda_buffer_free(allocator->context, buffer_type, device_ptr,
+      iree_hal_cuda_buffer_free(allocator, buffer_type, device_ptr,
                                 host_ptr);
     } else {
       iree_hal_buffer_release(buffer);
@@ -443,7 +681,7 @@ static void iree_hal_cuda_allocator_deallocate_buffer(
   // to silently ignore them: whatever the user tries to do next will fail in
   // the same way and if we were deallocating this buffer as part of a tear-down
   // on failure we don't want to end up dying during cleanup.
-  iree_hal_cuda_buffer_free(allocator->context, buffer_type,
+  iree_hal_cuda_buffer_free(allocator, buffer_type,
                             iree_hal_cuda_buffer_device_pointer(base_buffer),
                             iree_hal_cuda_buffer_host_pointer(base_buffer));
 
@@ -524,16 +762,12 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
           allocator->supports_read_only_host_register) {
         register_flags |= CU_MEMHOSTREGISTER_READ_ONLY;
       }
-      status = CU_RESULT_TO_STATUS(
-          allocator->context->syms,
-          cuMemHostRegister(host_ptr, external_buffer->size, register_flags),
-          "cuMemHostRegister");
-      if (iree_status_is_ok(status)) {
-        status = CU_RESULT_TO_STATUS(
-            allocator->context->syms,
-            cuMemHostGetDevicePointer(&device_ptr, host_ptr, 0),
-            "cuMemHostGetDevicePointer");
-      }
+      // The device accesses the host memory in place through the
+      // registration; no staging copy is made.
+      status = iree_hal_cuda_allocator_acquire_host_registration(
+          allocator, host_ptr, external_buffer->size, register_flags,
+          &device_ptr);
+      if (!iree_status_is_ok(status)) host_ptr = NULL;
       break;
     }
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION: {
@@ -565,7 +799,7 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
     *out_buffer = buffer;
   } else {
     if (!buffer && (device_ptr || host_ptr)) {
-      iree_hal_cuda_buffer_free(allocator->context, buffer_type, device_ptr,
+      iree_hal_cuda_buffer_free(allocator, buffer_type, device_ptr,
                                 host_ptr);
     } else {
       iree_hal_buffer_release(buffer);
@@ -585,7 +819,11 @@ static iree_status_t iree_hal_cuda_allocator_export_buffer(
   switch (requested_type) {
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION:
       switch (buffer_type) {
+        case IREE_HAL_CUDA_BUFFER_TYPE_DEVICE:
+        case IREE_HAL_CUDA_BUFFER_TYPE_ASYNC:
         case IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL:
+          // The exported pointer is unowned and the caller must keep the
+          // buffer live for as long as it is in use.
           out_external_buffer->flags = requested_flags;
           out_external_buffer->type = requested_type;
           out_external_buffer->handle.device_allocation.ptr =
@@ -605,6 +843,283 @@ static iree_status_t iree_hal_cuda_allocator_export_buffer(
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Growable buffers
+//===----------------------------------------------------------------------===//
+
+// A physical allocation mapped into a growable buffer reservation.
+typedef struct iree_hal_cuda_virtual_chunk_t {
+  CUmemGenericAllocationHandle handle;
+  size_t size;
+} iree_hal_cuda_virtual_chunk_t;
+
+// Device address range reservation backing an
+// IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL buffer. Physical chunks are mapped
+// contiguously from the base of the reservation as the buffer grows.
+typedef struct iree_hal_cuda_virtual_allocation_t {
+  iree_hal_cuda_context_wrapper_t* context;
+  // Properties used to create physical chunks and map them for access.
+  CUmemAllocationProp allocation_prop;
+  // Base of the reserved device address range.
+  CUdeviceptr base_ptr;
+  // Total reserved size in bytes; a multiple of |granularity|.
+  size_t reserved_size;
+  // Minimum size and alignment of physical chunks.
+  size_t granularity;
+  // Bytes from |base_ptr| backed by physical memory.
+  size_t committed_size;
+  iree_host_size_t chunk_count;
+  iree_host_size_t chunk_capacity;
+  iree_hal_cuda_virtual_chunk_t* chunks;
+} iree_hal_cuda_virtual_allocation_t;
+
+static void iree_hal_cuda_virtual_allocation_free(
+    iree_hal_cuda_virtual_allocation_t* allocation) {
+  iree_hal_cuda_context_wrapper_t* context = allocation->context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, allocation->committed_size);
+
+  // Same caveats as iree_hal_cuda_allocator_deallocate_buffer: errors during
+  // teardown are ignored.
+  if (allocation->committed_size) {
+    CUDA_IGNORE_ERROR(context->syms, cuMemUnmap(allocation->base_ptr,
+                                                allocation->committed_size));
+  }
+  for (iree_host_size_t i = 0; i < allocation->chunk_count; ++i) {
+    CUDA_IGNORE_ERROR(context->syms,
+                      cuMemRelease(allocation->chunks[i].handle));
+  }
+  if (allocation->base_ptr) {
+    CUDA_IGNORE_ERROR(context->syms,
+                      cuMemAddressFree(allocation->base_ptr,
+                                       allocation->reserved_size));
+  }
+  iree_allocator_free(context->host_allocator, allocation->chunks);
+  iree_allocator_free(context->host_allocator, allocation);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_hal_cuda_virtual_allocation_release(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_virtual_allocation_free(
+      (iree_hal_cuda_virtual_allocation_t*)user_data);
+}
+
+// Maps a new physical chunk so that at least |minimum_committed_size| bytes of
+// the reservation are accessible.
+static iree_status_t iree_hal_cuda_virtual_allocation_commit(
+    iree_hal_cuda_virtual_allocation_t* allocation,
+    iree_device_size_t minimum_committed_size) {
+  if (minimum_committed_size <= allocation->committed_size) {
+    return iree_ok_status();
+  } else if (minimum_committed_size > allocation->reserved_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "commit of %" PRIdsz
+                            " bytes exceeds the %" PRIhsz
+                            " byte growable buffer reservation",
+                            minimum_committed_size, allocation->reserved_size);
+  }
+  iree_hal_cuda_context_wrapper_t* context = allocation->context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Chunks must be multiples of the granularity; the reservation is as well so
+  // aligning up never exceeds it.
+  const size_t new_committed_size = (size_t)iree_device_align(
+      minimum_committed_size, allocation->granularity);
+  const size_t chunk_size = new_committed_size - allocation->committed_size;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, chunk_size);
+
+  if (allocation->chunk_count == allocation->chunk_capacity) {
+    iree_host_size_t new_capacity = iree_max(8, allocation->chunk_capacity * 2);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_realloc(context->host_allocator,
+                                   new_capacity * sizeof(allocation->chunks[0]),
+                                   (void**)&allocation->chunks));
+    allocation->chunk_capacity = new_capacity;
+  }
+
+  CUmemGenericAllocationHandle handle = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, CU_RESULT_TO_STATUS(context->syms,
+                              cuMemCreate(&handle, chunk_size,
+                                          &allocation->allocation_prop, 0),
+                              "cuMemCreate"));
+
+  // Map the chunk immediately after the committed range. Existing mappings are
+  // untouched so in-flight work using the buffer is unaffected.
+  const CUdeviceptr chunk_ptr =
+      allocation->base_ptr + allocation->committed_size;
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      context->syms, cuMemMap(chunk_ptr, chunk_size, 0, handle, 0), "cuMemMap");
+  if (iree_status_is_ok(status)) {
+    CUmemAccessDesc access_desc;
+    memset(&access_desc, 0, sizeof(access_desc));
+    access_desc.location = allocation->allocation_prop.location;
+    access_desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    status = CU_RESULT_TO_STATUS(
+        context->syms, cuMemSetAccess(chunk_ptr, chunk_size, &access_desc, 1),
+        "cuMemSetAccess");
+    if (!iree_status_is_ok(status)) {
+      CUDA_IGNORE_ERROR(context->syms, cuMemUnmap(chunk_ptr, chunk_size));
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    allocation->chunks[allocation->chunk_count].handle = handle;
+    allocation->chunks[allocation->chunk_count].size = chunk_size;
+    ++allocation->chunk_count;
+    allocation->committed_size = new_committed_size;
+  } else {
+    CUDA_IGNORE_ERROR(context->syms, cuMemRelease(handle));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_allocator_allocate_growable_buffer(
+    iree_hal_allocator_t* base_allocator,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t reserved_size, iree_device_size_t committed_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (!iree_hal_resource_is(base_allocator, &iree_hal_cuda_allocator_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocator is not a CUDA allocator");
+  }
+  iree_hal_cuda_allocator_t* allocator =
+      iree_hal_cuda_allocator_cast(base_allocator);
+  iree_hal_cuda_context_wrapper_t* context = allocator->context;
+  if (!allocator->supports_virtual_memory_management) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "device does not support virtual memory management; growable buffers "
+        "are unavailable");
+  } else if (committed_size > reserved_size) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "committed size %" PRIdsz
+                            " exceeds reserved size %" PRIdsz,
+                            committed_size, reserved_size);
+  }
+
+  // Growable buffers are device-local only: host visibility would require
+  // managed or host memory that cannot be mapped into a reservation.
+  iree_hal_buffer_params_t compat_params = *params;
+  iree_device_size_t allocation_size = reserved_size;
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_cuda_allocator_query_buffer_compatibility(
+          base_allocator, &compat_params, &allocation_size);
+  if (!iree_all_bits_set(compatibility,
+                         IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE) ||
+      !iree_all_bits_set(compat_params.type,
+                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) ||
+      iree_any_bit_set(compat_params.type,
+                       IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "growable buffers must be device-local and not host-visible");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, allocation_size);
+
+  iree_hal_cuda_virtual_allocation_t* allocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(context->host_allocator, sizeof(*allocation),
+                                (void**)&allocation));
+  memset(allocation, 0, sizeof(*allocation));
+  allocation->context = context;
+  allocation->allocation_prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+  allocation->allocation_prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+  allocation->allocation_prop.location.id = allocator->device;
+
+  // Reserve the full range up front so that the device address of the buffer
+  // never changes as it grows.
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      context->syms,
+      cuMemGetAllocationGranularity(&allocation->granularity,
+                                    &allocation->allocation_prop,
+                                    CU_MEM_ALLOC_GRANULARITY_RECOMMENDED),
+      "cuMemGetAllocationGranularity");
+  if (iree_status_is_ok(status)) {
+    allocation->reserved_size =
+        (size_t)iree_device_align(allocation_size, allocation->granularity);
+    status = CU_RESULT_TO_STATUS(
+        context->syms,
+        cuMemAddressReserve(&allocation->base_ptr, allocation->reserved_size,
+                            /*alignment=*/0, /*addr=*/0, /*flags=*/0),
+        "cuMemAddressReserve");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_virtual_allocation_commit(allocation,
+                                                     committed_size);
+  }
+
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_hal_cuda_virtual_allocation_release,
+      .user_data = allocation,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_buffer_wrap(
+        base_allocator, compat_params.type, compat_params.access,
+        compat_params.usage, allocation_size,
+        /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL,
+        allocation->base_ptr, /*host_ptr=*/NULL, release_callback,
+        context->host_allocator, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_cuda_virtual_allocation_free(allocation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_buffer_commit(
+    iree_hal_buffer_t* buffer, iree_device_size_t minimum_committed_size) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (!iree_hal_cuda_buffer_isa(allocated_buffer) ||
+      iree_hal_cuda_buffer_type(allocated_buffer) !=
+          IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "buffer is not a CUDA growable buffer");
+  }
+  // Subspans commit relative to their own offset within the reservation.
+  iree_device_size_t byte_offset = iree_hal_buffer_byte_offset(buffer);
+  return iree_hal_cuda_virtual_allocation_commit(
+      (iree_hal_cuda_virtual_allocation_t*)
+          iree_hal_cuda_buffer_release_user_data(allocated_buffer),
+      byte_offset + minimum_committed_size);
+}
+
+IREE_API_EXPORT iree_device_size_t
+iree_hal_cuda_buffer_committed_size(const iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (!iree_hal_cuda_buffer_isa(allocated_buffer)) return 0;
+  if (iree_hal_cuda_buffer_type(allocated_buffer) !=
+      IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL) {
+    return iree_hal_buffer_byte_length(buffer);
+  }
+  const iree_hal_cuda_virtual_allocation_t* allocation =
+      (const iree_hal_cuda_virtual_allocation_t*)
+          iree_hal_cuda_buffer_release_user_data(allocated_buffer);
+  iree_device_size_t byte_offset = iree_hal_buffer_byte_offset(buffer);
+  if (allocation->committed_size <= byte_offset) return 0;
+  return iree_min(allocation->committed_size - byte_offset,
+                  iree_hal_buffer_byte_length(buffer));
+}
+
 static const iree_hal_allocator_vtable_t iree_hal_cuda_allocator_vtable = {
     .destroy = iree_hal_cuda_allocator_destroy,
     .host_allocator = iree_hal_cuda_allocator_host_allocator,
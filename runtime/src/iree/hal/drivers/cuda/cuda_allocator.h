@@ -22,9 +22,14 @@ extern "C" {
 // |pools| provides memory pools that may be shared across multiple allocators
 // and the pointer must remain valid for the lifetime of the allocator. Pools
 // may not be supported on all devices and can be NULL.
+// |host_registration_cache_capacity| idle host memory registrations are
+// retained for reuse by subsequent imports of the same host memory; see
+// iree_hal_cuda_device_params_t::host_registration_cache_capacity.
 iree_status_t iree_hal_cuda_allocator_create(
     iree_hal_cuda_context_wrapper_t* context, CUdevice device, CUstream stream,
-    iree_hal_cuda_memory_pools_t* pools, iree_hal_allocator_t** out_allocator);
+    iree_hal_cuda_memory_pools_t* pools,
+    iree_host_size_t host_registration_cache_capacity,
+    iree_hal_allocator_t** out_allocator);
 
 #ifdef __cplusplus
 }  // extern "C"
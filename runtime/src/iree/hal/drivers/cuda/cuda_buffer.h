@@ -27,6 +27,10 @@ typedef enum iree_hal_cuda_buffer_type_e {
   // Externally registered buffer whose providence is unknown.
   // Must be freed by the user.
   IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL,
+  // cuMemAddressReserve + cuMemCreate/cuMemMap + cuMemUnmap/cuMemAddressFree
+  // Growable buffer backed by physical memory committed on demand. The
+  // reservation is owned by the buffer release callback.
+  IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL,
 } iree_hal_cuda_buffer_type_t;
 
 // Wraps a CUDA allocation in an iree_hal_buffer_t.
@@ -39,6 +43,9 @@ iree_status_t iree_hal_cuda_buffer_wrap(
     void* host_ptr, iree_hal_buffer_release_callback_t release_callback,
     iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer);
 
+// Returns true if |buffer| is a CUDA buffer.
+bool iree_hal_cuda_buffer_isa(const iree_hal_buffer_t* buffer);
+
 // Returns the underlying CUDA buffer type.
 iree_hal_cuda_buffer_type_t iree_hal_cuda_buffer_type(
     const iree_hal_buffer_t* buffer);
@@ -52,6 +59,10 @@ CUdeviceptr iree_hal_cuda_buffer_device_pointer(
 // Returns the CUDA host pointer for the given |buffer|, if available.
 void* iree_hal_cuda_buffer_host_pointer(const iree_hal_buffer_t* buffer);
 
+// Returns the user data of the release callback of |buffer|.
+// IREE_HAL_CUDA_BUFFER_TYPE_VIRTUAL buffers use it to track their reservation.
+void* iree_hal_cuda_buffer_release_user_data(const iree_hal_buffer_t* buffer);
+
 // Drops the release callback so that when the buffer is destroyed no callback
 // will be made. This is not thread safe but all callers are expected to be
 // holding an allocation and the earliest the buffer could be destroyed is after
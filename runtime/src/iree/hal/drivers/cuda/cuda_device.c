@@ -11,23 +11,29 @@
 #include <string.h>
 
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/event_pool.h"
 #include "iree/base/internal/math.h"
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_event.h"
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/event_semaphore.h"
 #include "iree/hal/drivers/cuda/graph_command_buffer.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
 #include "iree/hal/drivers/cuda/memory_pools.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/nop_executable_cache.h"
+#include "iree/hal/drivers/cuda/pending_queue_actions.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 #include "iree/hal/drivers/cuda/stream_command_buffer.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -35,6 +41,21 @@
 // iree_hal_cuda_device_t
 //===----------------------------------------------------------------------===//
 
+// Maximum number of queues as limited by the queue affinity bitmask.
+#define IREE_HAL_CUDA_MAX_QUEUE_COUNT 64
+
+// A device queue executing work against a set of CUDA streams.
+typedef struct iree_hal_cuda_queue_t {
+  // Streams work on the queue executes against. streams[0] is the queue stream
+  // that all submissions are ordered against and the remaining streams are
+  // used to execute commands between barriers concurrently.
+  iree_host_size_t stream_count;
+  CUstream streams[IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT];
+
+  // Cache of the direct stream command buffer initialized when in stream mode.
+  iree_hal_command_buffer_t* stream_command_buffer;
+} iree_hal_cuda_queue_t;
+
 typedef struct iree_hal_cuda_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
@@ -52,21 +73,39 @@ typedef struct iree_hal_cuda_device_t {
 
   CUdevice device;
 
-  // TODO: support multiple streams.
+  // Stream of queue 0 used for device-level operations such as tracing and
+  // synchronous allocations.
   CUstream stream;
   iree_hal_cuda_context_wrapper_t context_wrapper;
   iree_hal_cuda_tracing_context_t* tracing_context;
 
+  // Measures dispatch execution times while dispatch profiling is active.
+  iree_hal_cuda_dispatch_profiler_t* dispatch_profiler;
+
   bool supports_memory_pools;
   iree_hal_cuda_memory_pools_t memory_pools;
   iree_hal_allocator_t* device_allocator;
 
+  // Pinned host staging buffers reused by synchronous transfers to and from
+  // host memory.
+  iree_hal_transfer_staging_pool_t staging_pool;
+
+  // Instantiated graphs reused by graph command buffers.
+  iree_hal_cuda_graph_exec_cache_t graph_exec_cache;
+
+  // Host events used by semaphore waits and CUDA events used to chain queue
+  // submissions on the device.
+  iree_event_pool_t* host_event_pool;
+  iree_hal_cuda_event_pool_t* device_event_pool;
+
+  // Scheduler deferring queue operations until their waits resolve.
+  iree_hal_cuda_pending_queue_actions_t* pending_queue_actions;
+
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
-  // Cache of the direct stream command buffer initialized when in stream mode.
-  // TODO: have one cached per stream once there are multiple streams.
-  iree_hal_command_buffer_t* stream_command_buffer;
+  // Queues selected by queue affinity with params.queue_count entries.
+  iree_hal_cuda_queue_t* queues;
 } iree_hal_cuda_device_t;
 
 static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable;
@@ -82,15 +121,49 @@ static iree_hal_cuda_device_t* iree_hal_cuda_device_cast_unsafe(
   return (iree_hal_cuda_device_t*)base_value;
 }
 
+// Returns the queue selected by |queue_affinity|. The lowest set bit selects
+// the queue and affinities beyond the queue count wrap around.
+static iree_hal_cuda_queue_t* iree_hal_cuda_device_select_queue(
+    iree_hal_cuda_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  iree_host_size_t queue_index =
+      queue_affinity ? iree_math_count_trailing_zeros_u64(queue_affinity) : 0;
+  return &device->queues[queue_index % device->params.queue_count];
+}
+
+// Returns the collective bucketing configuration used by stream command
+// buffers issuing on |queue|. Buckets are allocated stream-ordered from the
+// device-local pool of the queue and bucketing is disabled without pools.
+static iree_hal_cuda_nccl_bucketing_t iree_hal_cuda_device_collective_bucketing(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_queue_t* queue) {
+  iree_hal_cuda_nccl_bucketing_t bucketing;
+  memset(&bucketing, 0, sizeof(bucketing));
+  if (device->supports_memory_pools) {
+    iree_host_size_t queue_index = (iree_host_size_t)(queue - device->queues);
+    bucketing.pool =
+        device->memory_pools
+            .queues[queue_index % device->memory_pools.queue_count]
+            .device_local;
+    bucketing.bucket_size = device->params.collective_bucket_size;
+  }
+  return bucketing;
+}
+
 IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
     iree_hal_cuda_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 1;
+  out_params->concurrent_stream_count = 4;
   out_params->command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->graph_exec_cache_capacity = 16;
+  out_params->event_pool_capacity = 32;
   out_params->allow_inline_execution = false;
   out_params->stream_tracing = false;
   out_params->async_allocations = true;
+  out_params->collective_bucket_size = 0;
+  // Retain device-local memory across synchronizations so that bursts of
+  // allocations after idle periods do not need to regrow the pool.
+  out_params->memory_pools.device_local.release_threshold = UINT64_MAX;
 }
 
 static iree_status_t iree_hal_cuda_device_check_params(
@@ -99,9 +172,43 @@ static iree_status_t iree_hal_cuda_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "arena block size too small (< 4096 bytes)");
   }
-  if (params->queue_count == 0) {
+  if (params->queue_count == 0 ||
+      params->queue_count > IREE_HAL_CUDA_MAX_QUEUE_COUNT) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "at least one queue is required");
+                            "queue count %" PRIhsz
+                            " out of range (expected 1 to %d)",
+                            params->queue_count, IREE_HAL_CUDA_MAX_QUEUE_COUNT);
+  }
+  if (params->concurrent_stream_count == 0 ||
+      params->concurrent_stream_count >
+          IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "concurrent stream count %" PRIhsz
+                            " out of range (expected 1 to %d)",
+                            params->concurrent_stream_count,
+                            IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT);
+  }
+  return iree_ok_status();
+}
+
+// Creates the stream command buffers of each queue that deferred command
+// buffers are replayed onto if they have not already been created.
+static iree_status_t iree_hal_cuda_device_create_queue_command_buffers(
+    iree_hal_cuda_device_t* device) {
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    iree_hal_cuda_queue_t* queue = &device->queues[i];
+    if (queue->stream_command_buffer) continue;
+    iree_hal_cuda_nccl_bucketing_t bucketing =
+        iree_hal_cuda_device_collective_bucketing(device, queue);
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_create(
+        (iree_hal_device_t*)device, &device->context_wrapper,
+        i == 0 ? device->tracing_context : NULL, device->dispatch_profiler,
+        &bucketing,
+        IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+            IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+        IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/0,
+        queue->stream_count, queue->streams, &device->block_pool,
+        &queue->stream_command_buffer));
   }
   return iree_ok_status();
 }
@@ -112,17 +219,26 @@ static iree_status_t iree_hal_cuda_device_create_internal(
     CUstream stream, CUcontext context, iree_hal_cuda_dynamic_symbols_t* syms,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_cuda_device_t* device = NULL;
-  iree_host_size_t total_size = iree_sizeof_struct(*device) + identifier.size;
+  iree_host_size_t total_size =
+      iree_sizeof_struct(*device) +
+      params->queue_count * sizeof(device->queues[0]) + identifier.size +
+      params->executable_cache_path.size;
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(host_allocator, total_size, (void**)&device));
   memset(device, 0, total_size);
   iree_hal_resource_initialize(&iree_hal_cuda_device_vtable, &device->resource);
   device->driver = driver;
   iree_hal_driver_retain(device->driver);
-  iree_string_view_append_to_buffer(
-      identifier, &device->identifier,
-      (char*)device + iree_sizeof_struct(*device));
+  uint8_t* queue_ptr = (uint8_t*)device + iree_sizeof_struct(*device);
+  device->queues = (iree_hal_cuda_queue_t*)queue_ptr;
+  char* buffer_ptr =
+      (char*)queue_ptr + params->queue_count * sizeof(device->queues[0]);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      identifier, &device->identifier, buffer_ptr);
   device->params = *params;
+  iree_string_view_append_to_buffer(params->executable_cache_path,
+                                    &device->params.executable_cache_path,
+                                    buffer_ptr);
   device->device = cu_device;
   device->stream = stream;
   device->context_wrapper.cu_device = cu_device;
@@ -130,11 +246,32 @@ static iree_status_t iree_hal_cuda_device_create_internal(
   device->context_wrapper.host_allocator = host_allocator;
   iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                    &device->block_pool);
+  iree_hal_transfer_staging_pool_initialize(&device->staging_pool);
   device->context_wrapper.syms = syms;
 
-  // Enable tracing for the (currently only) stream - no-op if disabled.
+  // Create the streams for each queue. The stream provided by the caller is
+  // used as the stream of queue 0.
   iree_status_t status = iree_ok_status();
-  if (device->params.stream_tracing) {
+  for (iree_host_size_t i = 0;
+       i < params->queue_count && iree_status_is_ok(status); ++i) {
+    iree_hal_cuda_queue_t* queue = &device->queues[i];
+    for (iree_host_size_t j = 0; j < params->concurrent_stream_count; ++j) {
+      if (i == 0 && j == 0) {
+        queue->streams[queue->stream_count++] = stream;
+        continue;
+      }
+      status = CU_RESULT_TO_STATUS(
+          syms,
+          cuStreamCreate(&queue->streams[queue->stream_count],
+                         CU_STREAM_NON_BLOCKING),
+          "cuStreamCreate");
+      if (!iree_status_is_ok(status)) break;
+      ++queue->stream_count;
+    }
+  }
+
+  // Enable tracing for the stream of queue 0 - no-op if disabled.
+  if (iree_status_is_ok(status) && device->params.stream_tracing) {
     status = iree_hal_cuda_tracing_context_allocate(
         &device->context_wrapper, device->identifier, stream,
         &device->block_pool, host_allocator, &device->tracing_context);
@@ -155,25 +292,47 @@ static iree_status_t iree_hal_cuda_device_create_internal(
   // Create memory pools first so that we can share them with the allocator.
   if (iree_status_is_ok(status) && device->supports_memory_pools) {
     status = iree_hal_cuda_memory_pools_initialize(
-        &device->context_wrapper, &params->memory_pools, &device->memory_pools);
+        &device->context_wrapper, &params->memory_pools, params->queue_count,
+        stream, &device->memory_pools);
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_allocator_create(
         &device->context_wrapper, cu_device, stream,
         device->supports_memory_pools ? &device->memory_pools : NULL,
-        &device->device_allocator);
+        params->host_registration_cache_capacity, &device->device_allocator);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_graph_exec_cache_initialize(
+        &device->context_wrapper, params->graph_exec_cache_capacity,
+        &device->graph_exec_cache);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_event_pool_allocate(params->event_pool_capacity,
+                                      host_allocator, &device->host_event_pool);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_event_pool_allocate(&device->context_wrapper,
+                                               params->event_pool_capacity,
+                                               &device->device_event_pool);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_pending_queue_actions_create(
+        &device->context_wrapper, device->device_event_pool,
+        device->tracing_context, &device->block_pool,
+        &device->pending_queue_actions);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_dispatch_profiler_allocate(
+        &device->context_wrapper, &device->dispatch_profiler);
   }
 
   if (iree_status_is_ok(status) &&
       params->command_buffer_mode == IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM) {
-    status = iree_hal_cuda_stream_command_buffer_create(
-        (iree_hal_device_t*)device, &device->context_wrapper,
-        device->tracing_context,
-        IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
-            IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
-        IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/0, device->stream,
-        &device->block_pool, &device->stream_command_buffer);
+    status = iree_hal_cuda_device_create_queue_command_buffers(device);
   }
 
   if (iree_status_is_ok(status)) {
@@ -236,9 +395,30 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_command_buffer_release(device->stream_command_buffer);
+  // Wait for all issued work so that the scheduler can retire it. Streams may
+  // be NULL if creation failed part way.
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    iree_hal_cuda_queue_t* queue = &device->queues[i];
+    for (iree_host_size_t j = 0; j < queue->stream_count; ++j) {
+      CUDA_IGNORE_ERROR(device->context_wrapper.syms,
+                        cuStreamSynchronize(queue->streams[j]));
+    }
+  }
+  iree_hal_cuda_pending_queue_actions_destroy(device->pending_queue_actions);
+  if (device->device_event_pool) {
+    iree_hal_cuda_event_pool_release(device->device_event_pool);
+  }
+  if (device->host_event_pool) iree_event_pool_free(device->host_event_pool);
+
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    iree_hal_command_buffer_release(device->queues[i].stream_command_buffer);
+  }
+
+  // There should be no more graph command buffers live that use the cache.
+  iree_hal_cuda_graph_exec_cache_deinitialize(&device->graph_exec_cache);
 
   // There should be no more buffers live that use the allocator.
+  iree_hal_transfer_staging_pool_deinitialize(&device->staging_pool);
   iree_hal_allocator_release(device->device_allocator);
 
   // Buffers may have been retaining collective resources.
@@ -247,10 +427,15 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   // Destroy memory pools that hold on to reserved memory.
   iree_hal_cuda_memory_pools_deinitialize(&device->memory_pools);
 
-  // TODO: support multiple streams.
+  iree_hal_cuda_dispatch_profiler_free(device->dispatch_profiler);
   iree_hal_cuda_tracing_context_free(device->tracing_context);
-  CUDA_IGNORE_ERROR(device->context_wrapper.syms,
-                    cuStreamDestroy(device->stream));
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    iree_hal_cuda_queue_t* queue = &device->queues[i];
+    for (iree_host_size_t j = 0; j < queue->stream_count; ++j) {
+      CUDA_IGNORE_ERROR(device->context_wrapper.syms,
+                        cuStreamDestroy(queue->streams[j]));
+    }
+  }
 
   iree_arena_block_pool_deinitialize(&device->block_pool);
 
@@ -286,6 +471,8 @@ static iree_hal_allocator_t* iree_hal_cuda_device_allocator(
 static void iree_hal_cuda_replace_device_allocator(
     iree_hal_device_t* base_device, iree_hal_allocator_t* new_allocator) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  // Staging buffers must come from the current allocator.
+  iree_hal_transfer_staging_pool_trim(&device->staging_pool);
   iree_hal_allocator_retain(new_allocator);
   iree_hal_allocator_release(device->device_allocator);
   device->device_allocator = new_allocator;
@@ -302,6 +489,7 @@ static void iree_hal_cuda_replace_channel_provider(
 static iree_status_t iree_hal_cuda_device_trim(iree_hal_device_t* base_device) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
+  iree_hal_transfer_staging_pool_trim(&device->staging_pool);
   IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
   if (device->supports_memory_pools) {
     IREE_RETURN_IF_ERROR(iree_hal_cuda_memory_pools_trim(
@@ -334,7 +522,11 @@ static iree_status_t iree_hal_cuda_device_query_i64(
   }
 
   if (iree_string_view_equal(category, IREE_SV("cuda.device"))) {
-    if (iree_string_view_equal(key, IREE_SV("compute_capability_major"))) {
+    if (iree_string_view_equal(key, IREE_SV("ordinal"))) {
+      *out_value = (int64_t)device->device;
+      return iree_ok_status();
+    } else if (iree_string_view_equal(key,
+                                      IREE_SV("compute_capability_major"))) {
       return iree_hal_cuda_device_query_attribute(
           device, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, out_value);
     } else if (iree_string_view_equal(key,
@@ -439,6 +631,15 @@ static iree_status_t iree_hal_cuda_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) ||
+      binding_capacity > 0) {
+    // Indirect command buffers are recorded once and replayed into the stream
+    // or graph of each command buffer executing them with its binding table.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
+  }
   if (device->params.allow_inline_execution &&
       iree_all_bits_set(mode,
                         IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION)) {
@@ -446,17 +647,32 @@ static iree_status_t iree_hal_cuda_device_create_command_buffer(
     // recorded, implying that the command buffer cannot be reused and doesn't
     // need to be persisted. This lets us lower the execution delay as we can
     // directly route commands to a CUDA stream and let it eagerly flush.
+    // Only the streams of queue 0 are traced.
+    iree_hal_cuda_queue_t* queue =
+        iree_hal_cuda_device_select_queue(device, queue_affinity);
+    iree_hal_cuda_nccl_bucketing_t bucketing =
+        iree_hal_cuda_device_collective_bucketing(device, queue);
     return iree_hal_cuda_stream_command_buffer_create(
-        base_device, &device->context_wrapper, device->tracing_context, mode,
-        command_categories, binding_capacity, device->stream,
+        base_device, &device->context_wrapper,
+        queue == &device->queues[0] ? device->tracing_context : NULL,
+        device->dispatch_profiler, &bucketing, mode, command_categories,
+        binding_capacity, queue->stream_count, queue->streams,
         &device->block_pool, out_command_buffer);
   }
-  switch (device->params.command_buffer_mode) {
+  // Graphs are launched as a whole and their dispatches cannot be timed
+  // individually so while profiling dispatches all command buffers are
+  // deferred and replayed onto the queue stream command buffers.
+  iree_hal_cuda_command_buffer_mode_t command_buffer_mode =
+      device->params.command_buffer_mode;
+  if (iree_hal_cuda_dispatch_profiler_is_active(device->dispatch_profiler)) {
+    command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
+  }
+  switch (command_buffer_mode) {
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH:
       return iree_hal_cuda_graph_command_buffer_create(
-          base_device, &device->context_wrapper, mode, command_categories,
-          queue_affinity, binding_capacity, &device->block_pool,
-          out_command_buffer);
+          base_device, &device->context_wrapper, &device->graph_exec_cache,
+          mode, command_categories, queue_affinity, binding_capacity,
+          &device->block_pool, out_command_buffer);
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM:
       return iree_hal_deferred_command_buffer_create(
           base_device, mode, command_categories, binding_capacity,
@@ -491,22 +707,29 @@ static iree_status_t iree_hal_cuda_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   return iree_hal_cuda_nop_executable_cache_create(
-      &device->context_wrapper, identifier, out_executable_cache);
+      &device->context_wrapper, identifier,
+      device->params.executable_cache_path, out_executable_cache);
 }
 
 static iree_status_t iree_hal_cuda_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_cuda_device_create_pipeline_layout(
@@ -524,21 +747,53 @@ static iree_status_t iree_hal_cuda_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
-  return iree_hal_cuda_semaphore_create(&device->context_wrapper, initial_value,
+  return iree_hal_cuda_semaphore_create(&device->context_wrapper,
+                                        device->host_event_pool, initial_value,
                                         out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
 iree_hal_cuda_device_query_semaphore_compatibility(
     iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
-  // TODO: implement CUDA semaphores.
-  return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
+  // CUDA semaphores can be waited on by the device with the events recorded by
+  // the submissions signaling them. Other semaphores (such as those of
+  // local_task CPU queues) are waited on with host timepoints that wake the
+  // queue worker to issue deferred submissions so the device can still be
+  // pipelined against them without blocking the submitter.
+  if (iree_hal_cuda_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
+  }
+  return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY |
+         IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_WAIT;
+}
+
+// Makes the stream of |queue| wait on |wait_semaphore_list| on the device when
+// possible and otherwise blocks the caller until the waits are reached.
+static iree_status_t iree_hal_cuda_device_queue_wait(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  bool waited_on_device = false;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_pending_queue_actions_try_wait_on_stream(
+      device->pending_queue_actions, queue->streams[0], wait_semaphore_list,
+      &waited_on_device));
+  if (waited_on_device) return iree_ok_status();
+  return iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                      iree_infinite_timeout());
+}
+
+// Signals |signal_semaphore_list| once all work prior on the stream of |queue|
+// has completed.
+static iree_status_t iree_hal_cuda_device_queue_signal(
+    iree_hal_cuda_device_t* device, iree_hal_cuda_queue_t* queue,
+    const iree_hal_semaphore_list_t signal_semaphore_list) {
+  if (!signal_semaphore_list.count) return iree_ok_status();
+  return iree_hal_cuda_pending_queue_actions_enqueue_execution(
+      device->pending_queue_actions, queue->streams[0],
+      queue->stream_command_buffer, iree_hal_semaphore_list_empty(),
+      signal_semaphore_list, /*command_buffer_count=*/0,
+      /*command_buffers=*/NULL);
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in CUDA to ensure ordering and avoid
-//       the barrier here.
 static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -547,12 +802,13 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
 
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The CUDA HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
+  // The allocation must be returned synchronously so waits that have not yet
+  // been issued to any stream block the caller.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_queue_wait(device, queue, wait_semaphore_list));
 
   // Allocate from the pool; likely to fail in cases of virtual memory
   // exhaustion but the error may be deferred until a later synchronization.
@@ -561,9 +817,9 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools &&
       !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
-    status = iree_hal_cuda_memory_pools_alloca(&device->memory_pools,
-                                               device->stream, pool, params,
-                                               allocation_size, out_buffer);
+    status = iree_hal_cuda_memory_pools_alloca(
+        &device->memory_pools, (iree_host_size_t)(queue - device->queues),
+        queue->streams[0], pool, params, allocation_size, out_buffer);
   } else {
     status = iree_hal_allocator_allocate_buffer(
         iree_hal_device_allocator(base_device), params, allocation_size,
@@ -572,47 +828,133 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
 
   // Only signal if not returning a synchronous error - synchronous failure
   // indicates that the stream is unchanged (it's not really since we waited
-  // above, but we at least won't deadlock like this).
+  // above, but we at least won't deadlock like this). Signals are recorded on
+  // the stream so work on other queues waiting on them orders after the
+  // allocation.
   if (iree_status_is_ok(status)) {
-    IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
+    status = iree_hal_cuda_device_queue_signal(device, queue,
+                                               signal_semaphore_list);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_buffer_release(*out_buffer);
+      *out_buffer = NULL;
+    }
   }
   return status;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in CUDA to ensure ordering and avoid
-//       the barrier here.
 static iree_status_t iree_hal_cuda_device_queue_dealloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
 
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The CUDA HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_queue_wait(device, queue, wait_semaphore_list));
 
   // Schedule the buffer deallocation if we got it from a pool and otherwise
   // drop it on the floor and let it be freed when the buffer is released.
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools) {
     status = iree_hal_cuda_memory_pools_dealloca(&device->memory_pools,
-                                                 device->stream, buffer);
+                                                 queue->streams[0], buffer);
   }
 
   // Only signal if not returning a synchronous error - synchronous failure
   // indicates that the stream is unchanged (it's not really since we waited
   // above, but we at least won't deadlock like this).
   if (iree_status_is_ok(status)) {
-    IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
+    status = iree_hal_cuda_device_queue_signal(device, queue,
+                                               signal_semaphore_list);
+  }
+  return status;
+}
+
+// Returns true if the read from |source_file| into |target_buffer| can be
+// performed with GPUDirect Storage.
+static bool iree_hal_cuda_device_can_read_with_cufile(
+    iree_hal_cuda_device_t* device, iree_hal_file_t* source_file,
+    iree_hal_buffer_t* target_buffer) {
+  if (!device->context_wrapper.syms->cufile_library) return false;
+  if (iree_hal_fd_file_descriptor(source_file) < 0) return false;
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(target_buffer);
+  return iree_hal_cuda_buffer_isa(allocated_buffer) &&
+         iree_hal_cuda_buffer_type(allocated_buffer) ==
+             IREE_HAL_CUDA_BUFFER_TYPE_DEVICE;
+}
+
+// Reads |length| bytes from |source_file| directly into device memory with
+// cuFile. This is performed synchronously as cuFileRead blocks the caller
+// until the DMA has completed.
+static iree_status_t iree_hal_cuda_device_read_with_cufile(
+    iree_hal_cuda_device_t* device, iree_hal_file_t* source_file,
+    uint64_t source_offset, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
+  iree_hal_cuda_dynamic_symbols_t* syms = device->context_wrapper.syms;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  // TODO: cache handle registration per file and register target
+  // buffers with cuFileBufRegister for repeated transfers.
+  CUfileDescr_t descr;
+  memset(&descr, 0, sizeof(descr));
+  descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+  descr.handle.fd = iree_hal_fd_file_descriptor(source_file);
+  CUfileHandle_t handle = NULL;
+  CUfileError_t result = syms->cuFileHandleRegister(&handle, &descr);
+  if (result.err != CU_FILE_SUCCESS) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "cuFileHandleRegister failed (%d)", result.err);
   }
+
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(target_buffer);
+  void* device_ptr =
+      (void*)iree_hal_cuda_buffer_device_pointer(allocated_buffer);
+  iree_device_size_t device_offset =
+      iree_hal_buffer_byte_offset(target_buffer) + target_offset;
+  iree_status_t status = iree_ok_status();
+  iree_device_size_t bytes_read = 0;
+  while (bytes_read < length) {
+    int64_t read_length = syms->cuFileRead(
+        handle, device_ptr, (size_t)(length - bytes_read),
+        (int64_t)(source_offset + bytes_read),
+        (int64_t)(device_offset + bytes_read));
+    if (read_length < 0) {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "cuFileRead failed (%" PRId64 ")", read_length);
+      break;
+    } else if (read_length == 0) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "file read at offset %" PRIu64 " reached end of file with %" PRIu64
+          " bytes remaining",
+          source_offset + bytes_read, (uint64_t)(length - bytes_read));
+      break;
+    }
+    bytes_read += (iree_device_size_t)read_length;
+  }
+
+  syms->cuFileHandleDeregister(handle);
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_status_t iree_hal_cuda_device_transfer_range(
+    iree_hal_device_t* base_device, iree_hal_transfer_buffer_t source,
+    iree_device_size_t source_offset, iree_hal_transfer_buffer_t target,
+    iree_device_size_t target_offset, iree_device_size_t data_length,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  return iree_hal_device_submit_transfer_range_and_wait_with_staging_pool(
+      base_device, &device->staging_pool, source, source_offset, target,
+      target_offset, data_length, flags, timeout);
+}
+
 static iree_status_t iree_hal_cuda_device_queue_read(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -620,6 +962,46 @@ static iree_status_t iree_hal_cuda_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+
+  // DMA directly from storage into device memory when GPUDirect Storage is
+  // available and otherwise fall back to staging through host memory.
+  if (iree_hal_cuda_device_can_read_with_cufile(device, source_file,
+                                                target_buffer)) {
+    if (!iree_all_bits_set(iree_hal_file_allowed_access(source_file),
+                           IREE_HAL_MEMORY_ACCESS_READ)) {
+      return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                              "file is not readable");
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_range(
+        target_buffer, target_offset, length));
+
+    // NOTE: block on the semaphores here; we could avoid this by properly
+    // sequencing device work with semaphores. The CUDA HAL is not currently
+    // asynchronous.
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                                      iree_infinite_timeout()));
+
+    // Reads are performed after all prior work that may be using the target
+    // buffer has completed on the stream. Work on other queues has already
+    // completed as each submission is synchronous.
+    iree_hal_cuda_queue_t* queue =
+        iree_hal_cuda_device_select_queue(device, queue_affinity);
+    iree_status_t status = CU_RESULT_TO_STATUS(
+        device->context_wrapper.syms, cuStreamSynchronize(queue->streams[0]));
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_device_read_with_cufile(
+          device, source_file, source_offset, target_buffer, target_offset,
+          length);
+    }
+    if (iree_status_is_ok(status)) {
+      return iree_hal_semaphore_list_signal(signal_semaphore_list);
+    }
+    iree_hal_semaphore_list_fail(signal_semaphore_list,
+                                 iree_status_clone(status));
+    return status;
+  }
+
   // TODO: expose streaming chunk count/size options.
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
@@ -662,39 +1044,18 @@ static iree_status_t iree_hal_cuda_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_hal_cuda_queue_t* queue =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
 
-  // TODO(benvanik): trace around the entire submission.
-
-  for (iree_host_size_t i = 0; i < command_buffer_count; i++) {
-    iree_hal_command_buffer_t* command_buffer = command_buffers[i];
-    if (iree_hal_cuda_stream_command_buffer_isa(command_buffer)) {
-      // Nothing to do for an inline command buffer; all the work has already
-      // been submitted. When we support semaphores we'll still need to signal
-      // their completion but do not have to worry about any waits: if there
-      // were waits we wouldn't have been able to execute inline!
-    } else if (iree_hal_cuda_graph_command_buffer_isa(command_buffer)) {
-      CUgraphExec exec =
-          iree_hal_cuda_graph_command_buffer_handle(command_buffers[i]);
-      CUDA_RETURN_IF_ERROR(device->context_wrapper.syms,
-                           cuGraphLaunch(exec, device->stream),
-                           "cuGraphLaunch");
-    } else {
-      IREE_RETURN_IF_ERROR(iree_hal_deferred_command_buffer_apply(
-          command_buffers[i], device->stream_command_buffer,
-          iree_hal_buffer_binding_table_empty()));
-    }
-  }
-
-  // TODO(thomasraoux): implement semaphores - for now this conservatively
-  // synchronizes after every submit.
-  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "cuStreamSynchronize");
-  CUDA_RETURN_IF_ERROR(device->context_wrapper.syms,
-                       cuStreamSynchronize(device->stream),
-                       "cuStreamSynchronize");
-  iree_hal_cuda_tracing_context_collect(device->tracing_context);
+  // Submissions are deferred until their waits can be resolved on the device
+  // so neither waiting nor completion blocks the caller.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_hal_cuda_pending_queue_actions_enqueue_execution(
+      device->pending_queue_actions, queue->streams[0],
+      queue->stream_command_buffer, wait_semaphore_list, signal_semaphore_list,
+      command_buffer_count, command_buffers);
   IREE_TRACE_ZONE_END(z0);
-
-  return iree_ok_status();
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_device_queue_flush(
@@ -706,28 +1067,41 @@ static iree_status_t iree_hal_cuda_device_queue_flush(
 static iree_status_t iree_hal_cuda_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "semaphore not implemented");
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  return iree_hal_cuda_semaphore_multi_wait(wait_mode, semaphore_list, timeout,
+                                            device->host_event_pool,
+                                            &device->block_pool);
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to CUPTI here or use the much simpler cuProfilerStart API.
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  // Only per-dispatch timing is implemented. Other modes could hook in to
+  // CUPTI here or use the much simpler cuProfilerStart API.
+  if (!iree_all_bits_set(options->mode,
+                         IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_ok_status();
+  }
+  // Deferred command buffers recorded while profiling are replayed onto the
+  // queue stream command buffers so they must exist even in graph mode.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_create_queue_command_buffers(device));
+  return iree_hal_cuda_dispatch_profiler_begin(
+      device->dispatch_profiler, device->stream,
+      iree_make_cstring_view(options->file_path ? options->file_path : ""));
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  return iree_hal_cuda_dispatch_profiler_flush(device->dispatch_profiler);
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  return iree_hal_cuda_dispatch_profiler_end(device->dispatch_profiler);
 }
 
 static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable = {
@@ -750,7 +1124,7 @@ static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable = {
     .create_semaphore = iree_hal_cuda_device_create_semaphore,
     .query_semaphore_compatibility =
         iree_hal_cuda_device_query_semaphore_compatibility,
-    .transfer_range = iree_hal_device_submit_transfer_range_and_wait,
+    .transfer_range = iree_hal_cuda_device_transfer_range,
     .queue_alloca = iree_hal_cuda_device_queue_alloca,
     .queue_dealloca = iree_hal_cuda_device_queue_dealloca,
     .queue_read = iree_hal_cuda_device_queue_read,
@@ -53,17 +53,21 @@ static iree_status_t iree_hal_cuda_driver_create_internal(
     const iree_hal_cuda_driver_options_t* options,
     iree_allocator_t host_allocator, iree_hal_driver_t** out_driver) {
   iree_hal_cuda_driver_t* driver = NULL;
-  iree_host_size_t total_size = iree_sizeof_struct(*driver) + identifier.size;
+  iree_host_size_t total_size = iree_sizeof_struct(*driver) + identifier.size +
+                                default_params->executable_cache_path.size;
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(host_allocator, total_size, (void**)&driver));
 
   iree_hal_resource_initialize(&iree_hal_cuda_driver_vtable, &driver->resource);
   driver->host_allocator = host_allocator;
-  iree_string_view_append_to_buffer(
-      identifier, &driver->identifier,
-      (char*)driver + iree_sizeof_struct(*driver));
+  char* buffer_ptr = (char*)driver + iree_sizeof_struct(*driver);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      identifier, &driver->identifier, buffer_ptr);
   memcpy(&driver->default_params, default_params,
          sizeof(driver->default_params));
+  iree_string_view_append_to_buffer(
+      default_params->executable_cache_path,
+      &driver->default_params.executable_cache_path, buffer_ptr);
   driver->default_device_index = options->default_device_index;
 
   iree_status_t status =
@@ -80,6 +84,16 @@ static iree_status_t iree_hal_cuda_driver_create_internal(
     }
   }
 
+  if (iree_status_is_ok(status)) {
+    // Try to load cuFile for GPUDirect Storage. When unavailable file reads
+    // fall back to staging through host memory.
+    status = iree_hal_cuda_cufile_dynamic_symbols_initialize(host_allocator,
+                                                             &driver->syms);
+    if (iree_status_is_unavailable(status)) {
+      status = iree_status_ignore(status);
+    }
+  }
+
   if (iree_status_is_ok(status)) {
     *out_driver = (iree_hal_driver_t*)driver;
   } else {
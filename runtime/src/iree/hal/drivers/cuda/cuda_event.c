@@ -9,11 +9,12 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/status_util.h"
 
-// Dummy events for now, don't do anything.
 typedef struct iree_hal_cuda_event_t {
   iree_hal_resource_t resource;
   iree_hal_cuda_context_wrapper_t* context_wrapper;
+  CUevent handle;
 } iree_hal_cuda_event_t;
 
 static const iree_hal_event_vtable_t iree_hal_cuda_event_vtable;
@@ -24,6 +25,12 @@ static iree_hal_cuda_event_t* iree_hal_cuda_event_cast(
   return (iree_hal_cuda_event_t*)base_value;
 }
 
+static const iree_hal_cuda_event_t* iree_hal_cuda_event_const_cast(
+    const iree_hal_event_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_cuda_event_vtable);
+  return (const iree_hal_cuda_event_t*)base_value;
+}
+
 iree_status_t iree_hal_cuda_event_create(
     iree_hal_cuda_context_wrapper_t* context_wrapper,
     iree_hal_event_t** out_event) {
@@ -38,7 +45,17 @@ iree_status_t iree_hal_cuda_event_create(
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(&iree_hal_cuda_event_vtable, &event->resource);
     event->context_wrapper = context_wrapper;
+    event->handle = NULL;
+    status = CU_RESULT_TO_STATUS(
+        context_wrapper->syms,
+        cuEventCreate(&event->handle, CU_EVENT_DISABLE_TIMING),
+        "cuEventCreate");
+  }
+
+  if (iree_status_is_ok(status)) {
     *out_event = (iree_hal_event_t*)event;
+  } else if (event) {
+    iree_hal_event_release((iree_hal_event_t*)event);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -50,11 +67,22 @@ static void iree_hal_cuda_event_destroy(iree_hal_event_t* base_event) {
   iree_allocator_t host_allocator = event->context_wrapper->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // CUDA defers releasing the event until any pending record completes.
+  if (event->handle) {
+    CUDA_IGNORE_ERROR(event->context_wrapper->syms,
+                      cuEventDestroy(event->handle));
+  }
   iree_allocator_free(host_allocator, event);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+CUevent iree_hal_cuda_event_handle(const iree_hal_event_t* base_event) {
+  const iree_hal_cuda_event_t* event =
+      iree_hal_cuda_event_const_cast(base_event);
+  return event->handle;
+}
+
 static const iree_hal_event_vtable_t iree_hal_cuda_event_vtable = {
     .destroy = iree_hal_cuda_event_destroy,
 };
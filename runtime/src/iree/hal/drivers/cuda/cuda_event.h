@@ -16,14 +16,16 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a dummy event object. Object will be represented by CUDA Graph edges
-// so nothing is created at creation time. When an event is signaled in the
-// command buffer we will add the appropriate edges to enforce the right
-// synchronization.
+// Creates an event object backed by a CUevent. Stream command buffers record
+// and wait on the CUevent directly. Graph command buffers do not use it yet and
+// treat events as full barriers.
 iree_status_t iree_hal_cuda_event_create(
     iree_hal_cuda_context_wrapper_t* context_wrapper,
     iree_hal_event_t** out_event);
 
+// Returns the CUDA event handle backing |event|.
+CUevent iree_hal_cuda_event_handle(const iree_hal_event_t* event);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -10,4 +10,6 @@
 #include "cuda.h"                   // IWYU pragma: export
 #include "third_party/nccl/nccl.h"  // IWYU pragma: export
 
+#include "iree/hal/drivers/cuda/cufile_headers.h"  // IWYU pragma: export
+
 #endif  // IREE_HAL_DRIVERS_CUDA_CUDA_HEADERS_H_
@@ -0,0 +1,47 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cuda.h"  // IWYU pragma: export
+
+// Subset of the cuFile (GPUDirect Storage) API from cufile.h. The library is
+// loaded dynamically and the header is not distributed with the CUDA driver
+// headers so only the ABI-stable declarations we use are mirrored here.
+// cuFile is only available on 64-bit Linux where ssize_t and off_t are both
+// int64_t.
+
+typedef enum CUfileOpError {
+  CU_FILE_SUCCESS = 0,
+} CUfileOpError;
+
+typedef struct CUfileError {
+  CUfileOpError err;
+  CUresult cu_err;
+} CUfileError_t;
+
+typedef enum CUfileFileHandleType {
+  CU_FILE_HANDLE_TYPE_OPAQUE_FD = 1,
+  CU_FILE_HANDLE_TYPE_OPAQUE_WIN32 = 2,
+  CU_FILE_HANDLE_TYPE_USERSPACE_FS = 3,
+} CUfileFileHandleType;
+
+typedef struct CUfileDescr_t {
+  CUfileFileHandleType type;
+  union {
+    int fd;
+    void* handle;
+  } handle;
+  const void* fs_ops;
+} CUfileDescr_t;
+
+typedef void* CUfileHandle_t;
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
@@ -0,0 +1,476 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+// A dispatch whose events have been recorded but not yet resolved.
+typedef struct iree_hal_cuda_dispatch_query_t {
+  CUevent start_event;
+  CUevent end_event;
+  CUstream stream;
+  iree_host_size_t name_index;
+} iree_hal_cuda_dispatch_query_t;
+
+// A resolved dispatch timing in microseconds relative to the base event.
+typedef struct iree_hal_cuda_dispatch_timing_t {
+  iree_host_size_t name_index;
+  iree_host_size_t stream_index;
+  double start_us;
+  double duration_us;
+} iree_hal_cuda_dispatch_timing_t;
+
+struct iree_hal_cuda_dispatch_profiler_t {
+  iree_hal_cuda_context_wrapper_t* context;
+  iree_allocator_t host_allocator;
+
+  // Nonzero while capturing. Read without the lock by command buffers to
+  // avoid any overhead when profiling is not active.
+  iree_atomic_int32_t active;
+
+  iree_slim_mutex_t mutex;
+
+  // Path the trace is written to when the profile ends.
+  char* file_path;
+
+  // Event all timings are relative to. CUDA (without CUPTI) only supports
+  // measuring the elapsed time between two events.
+  CUevent base_event;
+
+  // Unique dispatch names referenced by index from queries and timings.
+  iree_host_size_t name_count;
+  iree_host_size_t name_capacity;
+  iree_string_view_t* names;
+
+  // Unique streams dispatches were recorded on; used as trace thread IDs.
+  iree_host_size_t stream_count;
+  iree_host_size_t stream_capacity;
+  CUstream* streams;
+
+  // Recorded dispatches pending resolution.
+  iree_host_size_t query_count;
+  iree_host_size_t query_capacity;
+  iree_hal_cuda_dispatch_query_t* queries;
+
+  // Resolved dispatch timings pending being written to the trace.
+  iree_host_size_t timing_count;
+  iree_host_size_t timing_capacity;
+  iree_hal_cuda_dispatch_timing_t* timings;
+
+  // Events returned from resolved queries available for reuse.
+  iree_host_size_t free_event_count;
+  iree_host_size_t free_event_capacity;
+  CUevent* free_events;
+};
+
+// Ensures |*inout_ptr| has room for at least |minimum_capacity| elements.
+static iree_status_t iree_hal_cuda_dispatch_profiler_reserve(
+    iree_allocator_t host_allocator, iree_host_size_t element_size,
+    iree_host_size_t minimum_capacity, iree_host_size_t* inout_capacity,
+    void** inout_ptr) {
+  if (minimum_capacity <= *inout_capacity) return iree_ok_status();
+  iree_host_size_t new_capacity = iree_max(16, *inout_capacity * 2);
+  new_capacity = iree_max(new_capacity, minimum_capacity);
+  IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+      host_allocator, new_capacity * element_size, inout_ptr));
+  *inout_capacity = new_capacity;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_allocate(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_dispatch_profiler_t** out_profiler) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_profiler);
+  *out_profiler = NULL;
+  iree_hal_cuda_dispatch_profiler_t* profiler = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      context->host_allocator, sizeof(*profiler), (void**)&profiler));
+  memset(profiler, 0, sizeof(*profiler));
+  profiler->context = context;
+  profiler->host_allocator = context->host_allocator;
+  iree_atomic_store_int32(&profiler->active, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&profiler->mutex);
+  *out_profiler = profiler;
+  return iree_ok_status();
+}
+
+// Returns all pending query events to the free list and drops timings.
+static void iree_hal_cuda_dispatch_profiler_reset(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  iree_hal_cuda_dynamic_symbols_t* syms = profiler->context->syms;
+  for (iree_host_size_t i = 0; i < profiler->query_count; ++i) {
+    CUDA_IGNORE_ERROR(syms, cuEventDestroy(profiler->queries[i].start_event));
+    CUDA_IGNORE_ERROR(syms, cuEventDestroy(profiler->queries[i].end_event));
+  }
+  profiler->query_count = 0;
+  profiler->timing_count = 0;
+  profiler->stream_count = 0;
+  for (iree_host_size_t i = 0; i < profiler->name_count; ++i) {
+    iree_allocator_free(profiler->host_allocator,
+                        (void*)profiler->names[i].data);
+  }
+  profiler->name_count = 0;
+  if (profiler->base_event) {
+    CUDA_IGNORE_ERROR(syms, cuEventDestroy(profiler->base_event));
+    profiler->base_event = NULL;
+  }
+  iree_allocator_free(profiler->host_allocator, profiler->file_path);
+  profiler->file_path = NULL;
+}
+
+void iree_hal_cuda_dispatch_profiler_free(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  if (!profiler) return;
+  iree_allocator_t host_allocator = profiler->host_allocator;
+  iree_hal_cuda_dispatch_profiler_reset(profiler);
+  for (iree_host_size_t i = 0; i < profiler->free_event_count; ++i) {
+    CUDA_IGNORE_ERROR(profiler->context->syms,
+                      cuEventDestroy(profiler->free_events[i]));
+  }
+  iree_allocator_free(host_allocator, profiler->names);
+  iree_allocator_free(host_allocator, profiler->streams);
+  iree_allocator_free(host_allocator, profiler->queries);
+  iree_allocator_free(host_allocator, profiler->timings);
+  iree_allocator_free(host_allocator, profiler->free_events);
+  iree_slim_mutex_deinitialize(&profiler->mutex);
+  iree_allocator_free(host_allocator, profiler);
+}
+
+bool iree_hal_cuda_dispatch_profiler_is_active(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  return profiler && iree_atomic_load_int32(&profiler->active,
+                                            iree_memory_order_acquire) != 0;
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_begin(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_string_view_t file_path) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (iree_hal_cuda_dispatch_profiler_is_active(profiler)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "dispatch profiling already active");
+  }
+  if (iree_string_view_is_empty(file_path)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "dispatch profiling requires an output file path (such as with "
+        "--device_profiling_file=)");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_cuda_dynamic_symbols_t* syms = profiler->context->syms;
+
+  iree_status_t status = iree_allocator_malloc(
+      profiler->host_allocator, file_path.size + 1,
+      (void**)&profiler->file_path);
+  if (iree_status_is_ok(status)) {
+    memcpy(profiler->file_path, file_path.data, file_path.size);
+    profiler->file_path[file_path.size] = 0;
+    status = CU_RESULT_TO_STATUS(
+        syms, cuEventCreate(&profiler->base_event, CU_EVENT_DEFAULT));
+  }
+
+  // Record the base event and wait for it so that it has a valid timestamp
+  // before any dispatch is measured against it.
+  if (iree_status_is_ok(status)) {
+    status = CU_RESULT_TO_STATUS(syms,
+                                 cuEventRecord(profiler->base_event, stream));
+  }
+  if (iree_status_is_ok(status)) {
+    status =
+        CU_RESULT_TO_STATUS(syms, cuEventSynchronize(profiler->base_event));
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_atomic_store_int32(&profiler->active, 1, iree_memory_order_release);
+  } else {
+    iree_hal_cuda_dispatch_profiler_reset(profiler);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Acquires an event from the free list or creates a new one.
+// Requires the profiler lock to be held.
+static iree_status_t iree_hal_cuda_dispatch_profiler_acquire_event(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUevent* out_event) {
+  if (profiler->free_event_count > 0) {
+    *out_event = profiler->free_events[--profiler->free_event_count];
+    return iree_ok_status();
+  }
+  return CU_RESULT_TO_STATUS(profiler->context->syms,
+                             cuEventCreate(out_event, CU_EVENT_DEFAULT));
+}
+
+// Returns |event| to the free list for reuse.
+// Requires the profiler lock to be held.
+static void iree_hal_cuda_dispatch_profiler_release_event(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUevent event) {
+  iree_status_t status = iree_hal_cuda_dispatch_profiler_reserve(
+      profiler->host_allocator, sizeof(*profiler->free_events),
+      profiler->free_event_count + 1, &profiler->free_event_capacity,
+      (void**)&profiler->free_events);
+  if (iree_status_is_ok(status)) {
+    profiler->free_events[profiler->free_event_count++] = event;
+  } else {
+    iree_status_ignore(status);
+    CUDA_IGNORE_ERROR(profiler->context->syms, cuEventDestroy(event));
+  }
+}
+
+// Returns the index of |name| in the name table, inserting a copy if needed.
+// Requires the profiler lock to be held.
+static iree_status_t iree_hal_cuda_dispatch_profiler_intern_name(
+    iree_hal_cuda_dispatch_profiler_t* profiler, iree_string_view_t name,
+    iree_host_size_t* out_name_index) {
+  for (iree_host_size_t i = 0; i < profiler->name_count; ++i) {
+    if (iree_string_view_equal(profiler->names[i], name)) {
+      *out_name_index = i;
+      return iree_ok_status();
+    }
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_dispatch_profiler_reserve(
+      profiler->host_allocator, sizeof(*profiler->names),
+      profiler->name_count + 1, &profiler->name_capacity,
+      (void**)&profiler->names));
+  char* name_copy = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      profiler->host_allocator, iree_max(1, name.size), (void**)&name_copy));
+  memcpy(name_copy, name.data, name.size);
+  *out_name_index = profiler->name_count;
+  profiler->names[profiler->name_count++] =
+      iree_make_string_view(name_copy, name.size);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_record_begin(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    CUevent* out_start_event) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(out_start_event);
+  *out_start_event = NULL;
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status =
+      iree_hal_cuda_dispatch_profiler_acquire_event(profiler, out_start_event);
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_RETURN_IF_ERROR(status);
+  status = CU_RESULT_TO_STATUS(profiler->context->syms,
+                               cuEventRecord(*out_start_event, stream));
+  if (!iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&profiler->mutex);
+    iree_hal_cuda_dispatch_profiler_release_event(profiler, *out_start_event);
+    iree_slim_mutex_unlock(&profiler->mutex);
+    *out_start_event = NULL;
+  }
+  return status;
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_record_end(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_string_view_t name, CUevent start_event) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(start_event);
+  iree_slim_mutex_lock(&profiler->mutex);
+  CUevent end_event = NULL;
+  iree_host_size_t name_index = 0;
+  iree_status_t status =
+      iree_hal_cuda_dispatch_profiler_acquire_event(profiler, &end_event);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_dispatch_profiler_intern_name(profiler, name,
+                                                         &name_index);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_dispatch_profiler_reserve(
+        profiler->host_allocator, sizeof(*profiler->queries),
+        profiler->query_count + 1, &profiler->query_capacity,
+        (void**)&profiler->queries);
+  }
+  if (iree_status_is_ok(status)) {
+    status = CU_RESULT_TO_STATUS(profiler->context->syms,
+                                 cuEventRecord(end_event, stream));
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_cuda_dispatch_query_t* query =
+        &profiler->queries[profiler->query_count++];
+    query->start_event = start_event;
+    query->end_event = end_event;
+    query->stream = stream;
+    query->name_index = name_index;
+  } else {
+    iree_hal_cuda_dispatch_profiler_release_event(profiler, start_event);
+    if (end_event) {
+      iree_hal_cuda_dispatch_profiler_release_event(profiler, end_event);
+    }
+  }
+  iree_slim_mutex_unlock(&profiler->mutex);
+  return status;
+}
+
+// Returns the index of |stream| in the stream table, inserting it if needed.
+// Requires the profiler lock to be held.
+static iree_status_t iree_hal_cuda_dispatch_profiler_stream_index(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_host_size_t* out_stream_index) {
+  for (iree_host_size_t i = 0; i < profiler->stream_count; ++i) {
+    if (profiler->streams[i] == stream) {
+      *out_stream_index = i;
+      return iree_ok_status();
+    }
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_dispatch_profiler_reserve(
+      profiler->host_allocator, sizeof(*profiler->streams),
+      profiler->stream_count + 1, &profiler->stream_capacity,
+      (void**)&profiler->streams));
+  *out_stream_index = profiler->stream_count;
+  profiler->streams[profiler->stream_count++] = stream;
+  return iree_ok_status();
+}
+
+// Resolves all pending queries into timings.
+// Requires the profiler lock to be held.
+static iree_status_t iree_hal_cuda_dispatch_profiler_resolve(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  iree_hal_cuda_dynamic_symbols_t* syms = profiler->context->syms;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_dispatch_profiler_reserve(
+      profiler->host_allocator, sizeof(*profiler->timings),
+      profiler->timing_count + profiler->query_count,
+      &profiler->timing_capacity, (void**)&profiler->timings));
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t resolved_count = 0;
+  for (; resolved_count < profiler->query_count && iree_status_is_ok(status);
+       ++resolved_count) {
+    iree_hal_cuda_dispatch_query_t* query = &profiler->queries[resolved_count];
+    iree_hal_cuda_dispatch_timing_t* timing =
+        &profiler->timings[profiler->timing_count];
+    float start_ms = 0.0f;
+    float duration_ms = 0.0f;
+    status = CU_RESULT_TO_STATUS(syms, cuEventSynchronize(query->end_event));
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(
+          syms, cuEventElapsedTime(&start_ms, profiler->base_event,
+                                   query->start_event));
+    }
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(
+          syms, cuEventElapsedTime(&duration_ms, query->start_event,
+                                   query->end_event));
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_dispatch_profiler_stream_index(
+          profiler, query->stream, &timing->stream_index);
+    }
+    if (iree_status_is_ok(status)) {
+      timing->name_index = query->name_index;
+      timing->start_us = start_ms * 1000.0;
+      timing->duration_us = duration_ms * 1000.0;
+      ++profiler->timing_count;
+    }
+    iree_hal_cuda_dispatch_profiler_release_event(profiler,
+                                                  query->start_event);
+    iree_hal_cuda_dispatch_profiler_release_event(profiler, query->end_event);
+  }
+
+  // Drop resolved queries; on failure any remaining are kept for a retry.
+  memmove(profiler->queries, profiler->queries + resolved_count,
+          (profiler->query_count - resolved_count) *
+              sizeof(*profiler->queries));
+  profiler->query_count -= resolved_count;
+  return status;
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_flush(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  if (!iree_hal_cuda_dispatch_profiler_is_active(profiler)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status = iree_hal_cuda_dispatch_profiler_resolve(profiler);
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Writes |value| to |file| as a JSON string literal.
+static void iree_hal_cuda_dispatch_profiler_write_json_string(
+    FILE* file, iree_string_view_t value) {
+  fputc('"', file);
+  for (iree_host_size_t i = 0; i < value.size; ++i) {
+    char c = value.data[i];
+    if (c == '"' || c == '\\') {
+      fputc('\\', file);
+      fputc(c, file);
+    } else if ((unsigned char)c < 0x20) {
+      fprintf(file, "\\u%04x", (unsigned int)c);
+    } else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+// Writes all resolved timings to the trace file.
+// Requires the profiler lock to be held.
+static iree_status_t iree_hal_cuda_dispatch_profiler_write(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  FILE* file = fopen(profiler->file_path, "wb");
+  if (!file) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "failed to open dispatch profile '%s' for writing",
+                            profiler->file_path);
+  }
+  fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  for (iree_host_size_t i = 0; i < profiler->stream_count; ++i) {
+    fprintf(file,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%" PRIhsz
+            ",\"args\":{\"name\":\"CUDA stream %" PRIhsz "\"}},\n",
+            i, i);
+  }
+  for (iree_host_size_t i = 0; i < profiler->timing_count; ++i) {
+    const iree_hal_cuda_dispatch_timing_t* timing = &profiler->timings[i];
+    fprintf(file, "{\"name\":");
+    iree_hal_cuda_dispatch_profiler_write_json_string(
+        file, profiler->names[timing->name_index]);
+    fprintf(file,
+            ",\"cat\":\"dispatch\",\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIhsz
+            ",\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            timing->stream_index, timing->start_us, timing->duration_us,
+            i + 1 < profiler->timing_count ? "," : "");
+  }
+  fprintf(file, "]}\n");
+  bool write_failed = ferror(file) != 0;
+  if (fclose(file) != 0) write_failed = true;
+  if (write_failed) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "failed to write dispatch profile '%s'",
+                            profiler->file_path);
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_end(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  if (!iree_hal_cuda_dispatch_profiler_is_active(profiler)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_atomic_store_int32(&profiler->active, 0, iree_memory_order_release);
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status = iree_hal_cuda_dispatch_profiler_resolve(profiler);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_dispatch_profiler_write(profiler);
+  }
+  iree_hal_cuda_dispatch_profiler_reset(profiler);
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,77 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
+#define IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Measures the device execution time of individual dispatches with CUDA
+// events and writes them to a Chrome trace JSON file (viewable in
+// chrome://tracing and Perfetto) without requiring a Tracy capture.
+//
+// Used for IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS. Each dispatch
+// launched on a stream while the profiler is active is bracketed by a pair of
+// events and attributed to the name of its executable export. Events are
+// resolved into timings on flush (or end) which synchronizes with the streams
+// and the trace is written when the profile ends.
+//
+// Thread-safe; dispatches may be recorded concurrently from multiple streams.
+typedef struct iree_hal_cuda_dispatch_profiler_t
+    iree_hal_cuda_dispatch_profiler_t;
+
+// Allocates an inactive dispatch profiler. No CUDA resources are acquired
+// until the profiler is started.
+iree_status_t iree_hal_cuda_dispatch_profiler_allocate(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_dispatch_profiler_t** out_profiler);
+
+// Frees |profiler| and any unresolved timings without writing them.
+void iree_hal_cuda_dispatch_profiler_free(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Returns true if |profiler| is non-NULL and capturing dispatch timings.
+bool iree_hal_cuda_dispatch_profiler_is_active(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Starts capturing dispatch timings relative to a base event recorded on
+// |stream|. The trace is written to |file_path| when the profile ends.
+iree_status_t iree_hal_cuda_dispatch_profiler_begin(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_string_view_t file_path);
+
+// Records the start of a dispatch on |stream| and returns the event marking
+// it. The event must be passed to iree_hal_cuda_dispatch_profiler_record_end
+// after the dispatch has been launched on the same stream.
+iree_status_t iree_hal_cuda_dispatch_profiler_record_begin(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    CUevent* out_start_event);
+
+// Records the end of the dispatch of |name| started with |start_event| on
+// |stream|. |name| is copied.
+iree_status_t iree_hal_cuda_dispatch_profiler_record_end(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_string_view_t name, CUevent start_event);
+
+// Waits for all recorded dispatches to complete and resolves their timings.
+iree_status_t iree_hal_cuda_dispatch_profiler_flush(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Flushes all pending timings, writes the trace file, and stops capturing.
+iree_status_t iree_hal_cuda_dispatch_profiler_end(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
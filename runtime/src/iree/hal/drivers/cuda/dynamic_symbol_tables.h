@@ -20,6 +20,7 @@ CU_PFN_DECL(cuDeviceGetCount, int*)
 CU_PFN_DECL(cuDeviceGetName, char*, int, CUdevice)
 CU_PFN_DECL(cuDeviceGetAttribute, int*, CUdevice_attribute, CUdevice)
 CU_PFN_DECL(cuDeviceGetUuid, CUuuid*, CUdevice)
+CU_PFN_DECL(cuDriverGetVersion, int*)
 CU_PFN_DECL(cuEventCreate, CUevent*, unsigned int)
 CU_PFN_DECL(cuEventDestroy, CUevent)
 CU_PFN_DECL(cuEventElapsedTime, float*, CUevent, CUevent)
@@ -27,6 +28,8 @@ CU_PFN_DECL(cuEventQuery, CUevent)
 CU_PFN_DECL(cuEventRecord, CUevent, CUstream)
 CU_PFN_DECL(cuEventSynchronize, CUevent)
 CU_PFN_DECL(cuGetProcAddress, const char*, void**, int, cuuint64_t)
+CU_PFN_DECL(cuGraphAddEmptyNode, CUgraphNode*, CUgraph, const CUgraphNode*,
+            size_t)
 CU_PFN_DECL(cuGraphAddMemcpyNode, CUgraphNode*, CUgraph, const CUgraphNode*,
             size_t, const CUDA_MEMCPY3D*, CUcontext)
 CU_PFN_DECL(cuGraphAddMemsetNode, CUgraphNode*, CUgraph, const CUgraphNode*,
@@ -36,11 +39,19 @@ CU_PFN_DECL(cuGraphAddKernelNode, CUgraphNode*, CUgraph, const CUgraphNode*,
 CU_PFN_DECL(cuGraphCreate, CUgraph*, unsigned int)
 CU_PFN_DECL(cuGraphDestroy, CUgraph)
 CU_PFN_DECL(cuGraphExecDestroy, CUgraphExec)
+CU_PFN_DECL(cuGraphExecUpdate, CUgraphExec, CUgraph, CUgraphNode*,
+            CUgraphExecUpdateResult*)
 CU_PFN_DECL(cuGraphGetNodes, CUgraph, CUgraphNode*, size_t*)
 CU_PFN_DECL(cuGraphInstantiate, CUgraphExec*, CUgraph, CUgraphNode*, char*,
             size_t)
 CU_PFN_DECL(cuGraphLaunch, CUgraphExec, CUstream)
 CU_PFN_DECL(cuInit, unsigned int)
+CU_PFN_DECL(cuLaunchHostFunc, CUstream, CUhostFn, void*)
+CU_PFN_DECL(cuLinkAddData, CUlinkState, CUjitInputType, void*, size_t,
+            const char*, unsigned int, CUjit_option*, void**)
+CU_PFN_DECL(cuLinkComplete, CUlinkState, void**, size_t*)
+CU_PFN_DECL(cuLinkCreate, unsigned int, CUjit_option*, void**, CUlinkState*)
+CU_PFN_DECL(cuLinkDestroy, CUlinkState)
 CU_PFN_DECL(cuMemAllocManaged, CUdeviceptr*, size_t, unsigned int)
 CU_PFN_DECL(cuMemPrefetchAsync, CUdeviceptr, size_t, CUdevice, CUstream)
 CU_PFN_DECL(cuMemAlloc, CUdeviceptr*, size_t)
@@ -59,7 +70,20 @@ CU_PFN_DECL(cuMemPoolTrimTo, CUmemoryPool, size_t)
 CU_PFN_DECL(cuMemAllocFromPoolAsync, CUdeviceptr*, size_t, CUmemoryPool,
             CUstream)
 CU_PFN_DECL(cuMemFreeAsync, CUdeviceptr dptr, CUstream hStream)
+CU_PFN_DECL(cuMemAddressReserve, CUdeviceptr*, size_t, size_t, CUdeviceptr,
+            unsigned long long)
+CU_PFN_DECL(cuMemAddressFree, CUdeviceptr, size_t)
+CU_PFN_DECL(cuMemCreate, CUmemGenericAllocationHandle*, size_t,
+            const CUmemAllocationProp*, unsigned long long)
+CU_PFN_DECL(cuMemRelease, CUmemGenericAllocationHandle)
+CU_PFN_DECL(cuMemMap, CUdeviceptr, size_t, size_t, CUmemGenericAllocationHandle,
+            unsigned long long)
+CU_PFN_DECL(cuMemUnmap, CUdeviceptr, size_t)
+CU_PFN_DECL(cuMemSetAccess, CUdeviceptr, size_t, const CUmemAccessDesc*, size_t)
+CU_PFN_DECL(cuMemGetAllocationGranularity, size_t*, const CUmemAllocationProp*,
+            CUmemAllocationGranularity_flags)
 CU_PFN_DECL(cuModuleGetFunction, CUfunction*, CUmodule, const char*)
+CU_PFN_DECL(cuModuleLoadData, CUmodule*, const void*)
 CU_PFN_DECL(cuModuleLoadDataEx, CUmodule*, const void*, unsigned int,
             CUjit_option*, void**)
 CU_PFN_DECL(cuModuleUnload, CUmodule)
@@ -119,3 +143,12 @@ NCCL_PFN_DECL(ncclRecv, void*, size_t, ncclDataType_t, int, ncclComm_t,
               cudaStream_t)
 NCCL_PFN_DECL(ncclGroupStart)
 NCCL_PFN_DECL(ncclGroupEnd)
+
+// cuFile (GPUDirect Storage)
+
+CUFILE_PFN_DECL(cuFileDriverOpen)
+CUFILE_PFN_DECL(cuFileDriverClose)
+CUFILE_PFN_DECL(cuFileHandleRegister, CUfileHandle_t*, CUfileDescr_t*)
+CUFILE_PFN_DECL_VOID_RETURN(cuFileHandleDeregister, CUfileHandle_t)
+CUFILE_PFN_DECL_SSIZE_RETURN(cuFileRead, CUfileHandle_t, void*, size_t, int64_t,
+                             int64_t)
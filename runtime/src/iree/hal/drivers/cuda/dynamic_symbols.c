@@ -27,6 +27,12 @@ static const char* kNCCLLoaderSearchNames[] = {
 #endif  // IREE_PLATFORM_WINDOWS
 };
 
+// cuFile is only distributed for Linux.
+static const char* kCUFileLoaderSearchNames[] = {
+    "libcufile.so",
+    "libcufile.so.0",
+};
+
 // CUDA API version for cuGetProcAddress.
 // 1000 * major + 10 * minor
 #define IREE_CUDA_DRIVER_API_VERSION 11030
@@ -52,10 +58,16 @@ static iree_status_t iree_hal_cuda_dynamic_symbols_resolve_all(
   }
 #define NCCL_PFN_DECL(ncclSymbolName, ...)
 #define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...)
+#define CUFILE_PFN_DECL(cufileSymbolName, ...)
+#define CUFILE_PFN_DECL_VOID_RETURN(cufileSymbolName, ...)
+#define CUFILE_PFN_DECL_SSIZE_RETURN(cufileSymbolName, ...)
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
 #undef CU_PFN_DECL
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUFILE_PFN_DECL
+#undef CUFILE_PFN_DECL_VOID_RETURN
+#undef CUFILE_PFN_DECL_SSIZE_RETURN
   return iree_ok_status();
 }
 
@@ -75,10 +87,42 @@ static iree_status_t iree_hal_cuda_nccl_dynamic_symbols_resolve_all(
     IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(        \
         syms->nccl_library, kName, (void**)&syms->ncclSymbolName)); \
   }
+#define CUFILE_PFN_DECL(cufileSymbolName, ...)
+#define CUFILE_PFN_DECL_VOID_RETURN(cufileSymbolName, ...)
+#define CUFILE_PFN_DECL_SSIZE_RETURN(cufileSymbolName, ...)
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
 #undef CU_PFN_DECL
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUFILE_PFN_DECL
+#undef CUFILE_PFN_DECL_VOID_RETURN
+#undef CUFILE_PFN_DECL_SSIZE_RETURN
+  return iree_ok_status();
+}
+
+// Load cuFile entry points.
+static iree_status_t iree_hal_cuda_cufile_dynamic_symbols_resolve_all(
+    iree_hal_cuda_dynamic_symbols_t* syms) {
+#define CU_PFN_DECL(cudaSymbolName, ...)
+#define NCCL_PFN_DECL(ncclSymbolName, ...)
+#define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...)
+#define CUFILE_PFN_DECL(cufileSymbolName, ...)                          \
+  {                                                                     \
+    static const char* kName = #cufileSymbolName;                       \
+    IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(            \
+        syms->cufile_library, kName, (void**)&syms->cufileSymbolName)); \
+  }
+#define CUFILE_PFN_DECL_VOID_RETURN(cufileSymbolName, ...) \
+  CUFILE_PFN_DECL(cufileSymbolName)
+#define CUFILE_PFN_DECL_SSIZE_RETURN(cufileSymbolName, ...) \
+  CUFILE_PFN_DECL(cufileSymbolName)
+#include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: keep
+#undef CU_PFN_DECL
+#undef NCCL_PFN_DECL
+#undef NCCL_PFN_DECL_STR_RETURN
+#undef CUFILE_PFN_DECL
+#undef CUFILE_PFN_DECL_VOID_RETURN
+#undef CUFILE_PFN_DECL_SSIZE_RETURN
   return iree_ok_status();
 }
 
@@ -200,12 +244,65 @@ iree_status_t iree_hal_cuda_nccl_dynamic_symbols_initialize(
   return status;
 }
 
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator,
+    iree_hal_cuda_dynamic_symbols_t* out_syms) {
+  IREE_ASSERT_ARGUMENT(out_syms);
+  if (!out_syms->cuda_library) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "CUDA dynamic symbols must be loaded prior to loading cuFile");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT(!out_syms->cufile_library);
+
+  // Attempt to load the cuFile shared library.
+  iree_status_t status = iree_dynamic_library_load_from_files(
+      IREE_ARRAYSIZE(kCUFileLoaderSearchNames), kCUFileLoaderSearchNames,
+      IREE_DYNAMIC_LIBRARY_FLAG_NONE, host_allocator,
+      &out_syms->cufile_library);
+  if (iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    status = iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "cuFile runtime library not available; ensure GPUDirect Storage is "
+        "installed and libcufile.so is on your LD_LIBRARY_PATH");
+  }
+
+  // Resolve all symbols; this will fail if any required symbols are missing.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_cufile_dynamic_symbols_resolve_all(out_syms);
+  }
+
+  // Open the driver once for the lifetime of the symbols. This fails if the
+  // nvidia-fs kernel module is missing and compatibility mode is disabled.
+  if (iree_status_is_ok(status)) {
+    CUfileError_t result = out_syms->cuFileDriverOpen();
+    if (result.err != CU_FILE_SUCCESS) {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "cuFileDriverOpen failed (%d)", result.err);
+    }
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_dynamic_library_release(out_syms->cufile_library);
+    out_syms->cufile_library = NULL;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 void iree_hal_cuda_dynamic_symbols_deinitialize(
     iree_hal_cuda_dynamic_symbols_t* syms) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (syms->cufile_library) {
+    syms->cuFileDriverClose();
+  }
   iree_dynamic_library_release(syms->cuda_library);
   iree_dynamic_library_release(syms->nccl_library);
+  iree_dynamic_library_release(syms->cufile_library);
   memset(syms, 0, sizeof(*syms));
 
   IREE_TRACE_ZONE_END(z0);
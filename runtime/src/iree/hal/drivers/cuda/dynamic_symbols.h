@@ -15,13 +15,14 @@
 extern "C" {
 #endif  // __cplusplus
 
-// DynamicSymbols allow loading dynamically a subset of CUDA driver and NCCL
-// API. It loads all the function declared in `dynamic_symbol_tables.h` and fail
-// if any of the symbol is not available. The functions signatures are matching
-// the declarations in `cuda.h` and `nccl.h"`.
+// DynamicSymbols allow loading dynamically a subset of CUDA driver, NCCL, and
+// cuFile API. It loads all the function declared in `dynamic_symbol_tables.h`
+// and fail if any of the symbol is not available. The functions signatures are
+// matching the declarations in `cuda.h`, `nccl.h"`, and `cufile.h`.
 typedef struct iree_hal_cuda_dynamic_symbols_t {
   iree_dynamic_library_t* cuda_library;
   iree_dynamic_library_t* nccl_library;
+  iree_dynamic_library_t* cufile_library;
 
 #define CU_PFN_DECL(cudaSymbolName, ...) \
   CUresult (*cudaSymbolName)(__VA_ARGS__);
@@ -29,10 +30,19 @@ typedef struct iree_hal_cuda_dynamic_symbols_t {
   ncclResult_t (*ncclSymbolName)(__VA_ARGS__);
 #define NCCL_PFN_DECL_STR_RETURN(ncclSymbolName, ...) \
   const char* (*ncclSymbolName)(__VA_ARGS__);
+#define CUFILE_PFN_DECL(cufileSymbolName, ...) \
+  CUfileError_t (*cufileSymbolName)(__VA_ARGS__);
+#define CUFILE_PFN_DECL_VOID_RETURN(cufileSymbolName, ...) \
+  void (*cufileSymbolName)(__VA_ARGS__);
+#define CUFILE_PFN_DECL_SSIZE_RETURN(cufileSymbolName, ...) \
+  int64_t (*cufileSymbolName)(__VA_ARGS__);
 #include "iree/hal/drivers/cuda/dynamic_symbol_tables.h"  // IWYU pragma: export
 #undef CU_PFN_DECL
 #undef NCCL_PFN_DECL
 #undef NCCL_PFN_DECL_STR_RETURN
+#undef CUFILE_PFN_DECL
+#undef CUFILE_PFN_DECL_VOID_RETURN
+#undef CUFILE_PFN_DECL_SSIZE_RETURN
 } iree_hal_cuda_dynamic_symbols_t;
 
 // Initializes |out_syms| in-place with dynamically loaded CUDA symbols.
@@ -47,6 +57,14 @@ iree_status_t iree_hal_cuda_dynamic_symbols_initialize(
 iree_status_t iree_hal_cuda_nccl_dynamic_symbols_initialize(
     iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* out_syms);
 
+// Initializes |out_syms| in-place with dynamically loaded cuFile symbols and
+// opens the cuFile driver. Returns IREE_STATUS_UNAVAILABLE if GPUDirect Storage
+// is not installed or cannot be initialized on the host.
+// iree_hal_cuda_dynamic_symbols_deinitialize must be used to release the
+// library resources.
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator, iree_hal_cuda_dynamic_symbols_t* out_syms);
+
 // Deinitializes |syms| by unloading the backing library. All function pointers
 // will be invalidated. They _may_ still work if there are other reasons the
 // library remains loaded so be careful.
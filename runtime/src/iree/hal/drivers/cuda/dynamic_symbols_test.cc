@@ -76,6 +76,31 @@ TEST(NCCLDynamicSymbolsTest, CreateFromSystemLoader) {
   iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
 }
 
+TEST(CUFileDynamicSymbolsTest, CreateFromSystemLoader) {
+  iree_hal_cuda_dynamic_symbols_t symbols;
+  iree_status_t status = iree_hal_cuda_dynamic_symbols_initialize(
+      iree_allocator_system(), &symbols);
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_ignore(status);
+    std::cerr << "CUDA symbols cannot be loaded, skipping test.";
+    GTEST_SKIP();
+  }
+
+  status = iree_hal_cuda_cufile_dynamic_symbols_initialize(
+      iree_allocator_system(), &symbols);
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_ignore(status);
+    iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
+    std::cerr << "cuFile symbols cannot be loaded, skipping test.";
+    GTEST_SKIP();
+  }
+
+  EXPECT_NE(symbols.cuFileRead, nullptr);
+  iree_hal_cuda_dynamic_symbols_deinitialize(&symbols);
+}
+
 }  // namespace
 }  // namespace cuda
 }  // namespace hal
@@ -0,0 +1,232 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/event_pool.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_pooled_event_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_cuda_pooled_event_t {
+  // A reference count used to manage resource lifetime. 0 while the event is
+  // available in the pool and >= 1 while acquired by users.
+  iree_atomic_ref_count_t ref_count;
+
+  // The event pool that owns this event. The pool is retained while the event
+  // is acquired so that the event can always be returned to it.
+  iree_hal_cuda_event_pool_t* pool;
+
+  // The underlying CUevent object.
+  CUevent cu_event;
+};
+
+CUevent iree_hal_cuda_pooled_event_handle(
+    const iree_hal_cuda_pooled_event_t* event) {
+  return event->cu_event;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_event_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_cuda_event_pool_t {
+  // A reference count used to manage resource lifetime.
+  iree_atomic_ref_count_t ref_count;
+
+  // Copied from the context as events may outlive the device when retained by
+  // semaphores.
+  iree_allocator_t host_allocator;
+  iree_hal_cuda_dynamic_symbols_t* syms;
+
+  // Guards event related fields in the pool. Events are acquired at most a few
+  // times per submission so contention is expected to be low.
+  iree_slim_mutex_t event_mutex;
+
+  // Maximum number of event objects that will be maintained in the pool.
+  // More events may be allocated at any time, but they will be disposed
+  // directly when they are no longer needed.
+  iree_host_size_t available_capacity IREE_GUARDED_BY(event_mutex);
+  // Total number of currently available event objects.
+  iree_host_size_t available_count IREE_GUARDED_BY(event_mutex);
+  // The list of available_count event objects.
+  iree_hal_cuda_pooled_event_t* available_list[] IREE_GUARDED_BY(event_mutex);
+};
+// + Additional inline allocation for holding events up to the capacity.
+
+static void iree_hal_cuda_pooled_event_destroy(
+    iree_hal_cuda_pooled_event_t* event) {
+  iree_hal_cuda_event_pool_t* pool = event->pool;
+  CUDA_IGNORE_ERROR(pool->syms, cuEventDestroy(event->cu_event));
+  iree_allocator_free(pool->host_allocator, event);
+}
+
+static iree_status_t iree_hal_cuda_pooled_event_create(
+    iree_hal_cuda_event_pool_t* pool,
+    iree_hal_cuda_pooled_event_t** out_event) {
+  *out_event = NULL;
+  iree_hal_cuda_pooled_event_t* event = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      pool->host_allocator, sizeof(*event), (void**)&event));
+  iree_atomic_ref_count_init_value(&event->ref_count, 0);
+  event->pool = pool;
+  event->cu_event = NULL;
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      pool->syms, cuEventCreate(&event->cu_event, CU_EVENT_DISABLE_TIMING),
+      "cuEventCreate");
+  if (iree_status_is_ok(status)) {
+    *out_event = event;
+  } else {
+    iree_allocator_free(pool->host_allocator, event);
+  }
+  return status;
+}
+
+static void iree_hal_cuda_event_pool_free(
+    iree_hal_cuda_event_pool_t* event_pool) {
+  iree_allocator_t host_allocator = event_pool->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_host_size_t i = 0; i < event_pool->available_count; ++i) {
+    iree_hal_cuda_pooled_event_destroy(event_pool->available_list[i]);
+  }
+  IREE_ASSERT_REF_COUNT_ZERO(&event_pool->ref_count);
+
+  iree_slim_mutex_deinitialize(&event_pool->event_mutex);
+  iree_allocator_free(host_allocator, event_pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_event_pool_allocate(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_host_size_t available_capacity,
+    iree_hal_cuda_event_pool_t** out_event_pool) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_event_pool);
+  *out_event_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_event_pool_t* event_pool = NULL;
+  iree_host_size_t total_size =
+      sizeof(*event_pool) +
+      available_capacity * sizeof(*event_pool->available_list);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(context->host_allocator, total_size,
+                                (void**)&event_pool));
+  iree_atomic_ref_count_init(&event_pool->ref_count);  // -> 1
+  event_pool->host_allocator = context->host_allocator;
+  event_pool->syms = context->syms;
+  iree_slim_mutex_initialize(&event_pool->event_mutex);
+  event_pool->available_capacity = available_capacity;
+  event_pool->available_count = 0;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < available_capacity; ++i) {
+    status = iree_hal_cuda_pooled_event_create(
+        event_pool, &event_pool->available_list[event_pool->available_count]);
+    if (!iree_status_is_ok(status)) break;
+    ++event_pool->available_count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_event_pool = event_pool;
+  } else {
+    iree_hal_cuda_event_pool_release(event_pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_event_pool_retain(iree_hal_cuda_event_pool_t* event_pool) {
+  iree_atomic_ref_count_inc(&event_pool->ref_count);
+}
+
+void iree_hal_cuda_event_pool_release(iree_hal_cuda_event_pool_t* event_pool) {
+  if (iree_atomic_ref_count_dec(&event_pool->ref_count) == 1) {
+    iree_hal_cuda_event_pool_free(event_pool);
+  }
+}
+
+iree_status_t iree_hal_cuda_event_pool_acquire(
+    iree_hal_cuda_event_pool_t* event_pool, iree_host_size_t event_count,
+    iree_hal_cuda_pooled_event_t** out_events) {
+  IREE_ASSERT_ARGUMENT(event_pool);
+  if (!event_count) return iree_ok_status();
+  IREE_ASSERT_ARGUMENT(out_events);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Try first to grab from the pool.
+  iree_slim_mutex_lock(&event_pool->event_mutex);
+  iree_host_size_t from_pool_count =
+      iree_min(event_pool->available_count, event_count);
+  if (from_pool_count > 0) {
+    iree_host_size_t pool_base_index =
+        event_pool->available_count - from_pool_count;
+    memcpy(out_events, &event_pool->available_list[pool_base_index],
+           from_pool_count * sizeof(*event_pool->available_list));
+    event_pool->available_count -= from_pool_count;
+  }
+  iree_slim_mutex_unlock(&event_pool->event_mutex);
+
+  // Allocate the rest of the events.
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t acquired_count = from_pool_count;
+  if (acquired_count < event_count) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "event-pool-unpooled-acquire");
+    for (; acquired_count < event_count; ++acquired_count) {
+      status = iree_hal_cuda_pooled_event_create(event_pool,
+                                                 &out_events[acquired_count]);
+      if (!iree_status_is_ok(status)) break;
+    }
+    IREE_TRACE_ZONE_END(z1);
+  }
+
+  // Each acquired event retains the pool until it is returned to it; on
+  // failure this returns the events acquired so far.
+  for (iree_host_size_t i = 0; i < acquired_count; ++i) {
+    iree_atomic_ref_count_inc(&out_events[i]->ref_count);  // -> 1
+    iree_hal_cuda_event_pool_retain(event_pool);
+  }
+  if (!iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < acquired_count; ++i) {
+      iree_hal_cuda_pooled_event_release(out_events[i]);
+      out_events[i] = NULL;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_pooled_event_retain(iree_hal_cuda_pooled_event_t* event) {
+  iree_atomic_ref_count_inc(&event->ref_count);
+}
+
+void iree_hal_cuda_pooled_event_release(iree_hal_cuda_pooled_event_t* event) {
+  if (iree_atomic_ref_count_dec(&event->ref_count) != 1) return;
+  iree_hal_cuda_event_pool_t* event_pool = event->pool;
+
+  // Return the event to the pool if there is space and otherwise destroy it.
+  // Events are not reset as they are always recorded again before use.
+  iree_slim_mutex_lock(&event_pool->event_mutex);
+  bool pooled = event_pool->available_count < event_pool->available_capacity;
+  if (pooled) {
+    event_pool->available_list[event_pool->available_count++] = event;
+  }
+  iree_slim_mutex_unlock(&event_pool->event_mutex);
+  if (!pooled) iree_hal_cuda_pooled_event_destroy(event);
+
+  // Drop the reference to the pool retained when the event was acquired.
+  iree_hal_cuda_event_pool_release(event_pool);
+}
@@ -0,0 +1,80 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_EVENT_POOL_H_
+#define IREE_HAL_DRIVERS_CUDA_EVENT_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_pooled_event_t
+//===----------------------------------------------------------------------===//
+
+// A reference-counted CUevent acquired from an iree_hal_cuda_event_pool_t.
+// Used to chain queue submissions on the device without host round-trips.
+//
+// The event is returned to its pool when the last reference is released.
+// Thread-safe; multiple threads may retain and release the same event.
+typedef struct iree_hal_cuda_pooled_event_t iree_hal_cuda_pooled_event_t;
+
+// Returns the underlying CUevent handle.
+CUevent iree_hal_cuda_pooled_event_handle(
+    const iree_hal_cuda_pooled_event_t* event);
+
+// Retains the given |event| by increasing its reference count.
+void iree_hal_cuda_pooled_event_retain(iree_hal_cuda_pooled_event_t* event);
+
+// Releases the given |event| by decreasing its reference count.
+// The event is returned to its pool when the reference count reaches zero.
+void iree_hal_cuda_pooled_event_release(iree_hal_cuda_pooled_event_t* event);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_event_pool_t
+//===----------------------------------------------------------------------===//
+
+// A simple pool of CUevents to recycle.
+//
+// Thread-safe; multiple threads may acquire and release events from the pool.
+typedef struct iree_hal_cuda_event_pool_t iree_hal_cuda_event_pool_t;
+
+// Allocates a new event pool with up to |available_capacity| events.
+//
+// Extra events requested beyond the capability are directly created and
+// destroyed without pooling.
+iree_status_t iree_hal_cuda_event_pool_allocate(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_host_size_t available_capacity,
+    iree_hal_cuda_event_pool_t** out_event_pool);
+
+// Retains the given |event_pool| by increasing its reference count.
+void iree_hal_cuda_event_pool_retain(iree_hal_cuda_event_pool_t* event_pool);
+
+// Releases the given |event_pool| by decreasing its reference count.
+//
+// Events acquired from the pool retain it so the pool is only destroyed once
+// all of them have been released.
+void iree_hal_cuda_event_pool_release(iree_hal_cuda_event_pool_t* event_pool);
+
+// Acquires one or more events from the event pool.
+//
+// Each returned event has an initial reference count of 1. The returned
+// CUevent objects may retain captured states of some queue from previous
+// uses; callers should record again to overwrite.
+iree_status_t iree_hal_cuda_event_pool_acquire(
+    iree_hal_cuda_event_pool_t* event_pool, iree_host_size_t event_count,
+    iree_hal_cuda_pooled_event_t** out_events);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_EVENT_POOL_H_
@@ -6,15 +6,66 @@
 
 #include "iree/hal/drivers/cuda/event_semaphore.h"
 
+#include <inttypes.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/wait_handle.h"
 #include "iree/hal/utils/semaphore_base.h"
 
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_timepoint_t
+//===----------------------------------------------------------------------===//
+
+// Represents a point in the timeline that a host thread is waiting to be
+// reached. The event is set when the semaphore reaches the value or fails.
+typedef struct iree_hal_cuda_timepoint_t {
+  iree_hal_semaphore_timepoint_t base;
+  iree_hal_semaphore_t* semaphore;
+  iree_event_t event;
+} iree_hal_cuda_timepoint_t;
+
+static iree_status_t iree_hal_cuda_semaphore_timepoint_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_cuda_timepoint_t* timepoint = (iree_hal_cuda_timepoint_t*)user_data;
+  iree_event_set(&timepoint->event);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_semaphore_t
+//===----------------------------------------------------------------------===//
+
+// An event recorded on a stream that signals the semaphore to |value|.
+typedef struct iree_hal_cuda_device_signal_t {
+  uint64_t value;
+  iree_hal_cuda_pooled_event_t* event;
+} iree_hal_cuda_device_signal_t;
+
 typedef struct iree_hal_cuda_semaphore_t {
   iree_hal_semaphore_t base;
-  iree_hal_cuda_context_wrapper_t* context;
-  iree_atomic_int64_t value;
+  iree_allocator_t host_allocator;
+  iree_event_pool_t* host_event_pool;
+
+  // Guards all mutable fields.
+  iree_slim_mutex_t mutex;
+
+  // Current signaled value. May be IREE_HAL_SEMAPHORE_FAILURE_VALUE to
+  // indicate that the semaphore has been signaled for failure and
+  // |failure_status| contains the error.
+  uint64_t current_value IREE_GUARDED_BY(mutex);
+
+  // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
+  iree_status_t failure_status IREE_GUARDED_BY(mutex);
+
+  // Device signals for values not yet observed on the host in increasing
+  // value order.
+  iree_host_size_t device_signal_count IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_device_signal_t device_signals
+      [IREE_HAL_CUDA_SEMAPHORE_MAX_DEVICE_SIGNAL_COUNT] IREE_GUARDED_BY(mutex);
 } iree_hal_cuda_semaphore_t;
 
 static const iree_hal_semaphore_vtable_t iree_hal_cuda_semaphore_vtable;
@@ -26,9 +77,11 @@ static iree_hal_cuda_semaphore_t* iree_hal_cuda_semaphore_cast(
 }
 
 iree_status_t iree_hal_cuda_semaphore_create(
-    iree_hal_cuda_context_wrapper_t* context, uint64_t initial_value,
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_event_pool_t* host_event_pool, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(host_event_pool);
   IREE_ASSERT_ARGUMENT(out_semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -38,9 +91,12 @@ iree_status_t iree_hal_cuda_semaphore_create(
   if (iree_status_is_ok(status)) {
     iree_hal_semaphore_initialize(&iree_hal_cuda_semaphore_vtable,
                                   &semaphore->base);
-    semaphore->context = context;
-    iree_atomic_store_int64(&semaphore->value, initial_value,
-                            iree_memory_order_release);
+    semaphore->host_allocator = context->host_allocator;
+    semaphore->host_event_pool = host_event_pool;
+    iree_slim_mutex_initialize(&semaphore->mutex);
+    semaphore->current_value = initial_value;
+    semaphore->failure_status = iree_ok_status();
+    semaphore->device_signal_count = 0;
     *out_semaphore = &semaphore->base;
   }
 
@@ -48,38 +104,103 @@ iree_status_t iree_hal_cuda_semaphore_create(
   return status;
 }
 
+// Removes device signals from |semaphore| that are at or below |value| and
+// moves them to |out_events| for release outside of the lock.
+static iree_host_size_t iree_hal_cuda_semaphore_retire_device_signals(
+    iree_hal_cuda_semaphore_t* semaphore, uint64_t value,
+    iree_hal_cuda_pooled_event_t** out_events) {
+  iree_host_size_t retired_count = 0;
+  while (retired_count < semaphore->device_signal_count &&
+         semaphore->device_signals[retired_count].value <= value) {
+    out_events[retired_count] = semaphore->device_signals[retired_count].event;
+    ++retired_count;
+  }
+  semaphore->device_signal_count -= retired_count;
+  memmove(
+      &semaphore->device_signals[0], &semaphore->device_signals[retired_count],
+      semaphore->device_signal_count * sizeof(semaphore->device_signals[0]));
+  return retired_count;
+}
+
 static void iree_hal_cuda_semaphore_destroy(
     iree_hal_semaphore_t* base_semaphore) {
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
-  iree_allocator_t host_allocator = semaphore->context->host_allocator;
+  iree_allocator_t host_allocator = semaphore->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  for (iree_host_size_t i = 0; i < semaphore->device_signal_count; ++i) {
+    iree_hal_cuda_pooled_event_release(semaphore->device_signals[i].event);
+  }
+  iree_status_ignore(semaphore->failure_status);
+  iree_slim_mutex_deinitialize(&semaphore->mutex);
+
   iree_hal_semaphore_deinitialize(&semaphore->base);
   iree_allocator_free(host_allocator, semaphore);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+bool iree_hal_cuda_semaphore_isa(iree_hal_semaphore_t* semaphore) {
+  return iree_hal_resource_is(&semaphore->resource,
+                              &iree_hal_cuda_semaphore_vtable);
+}
+
 static iree_status_t iree_hal_cuda_semaphore_query(
     iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely.
-  *out_value =
-      iree_atomic_load_int64(&semaphore->value, iree_memory_order_acquire);
-  return iree_ok_status();
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  *out_value = semaphore->current_value;
+
+  iree_status_t status = iree_ok_status();
+  if (*out_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
+    status = iree_status_clone(semaphore->failure_status);
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_semaphore_signal(
     iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely. Return OK currently as everything is
-  // synchronized for each submit to allow things to run.
-  iree_atomic_store_int64(&semaphore->value, new_value,
-                          iree_memory_order_release);
-  iree_hal_semaphore_poll(&semaphore->base);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  if (new_value <= semaphore->current_value) {
+    uint64_t current_value IREE_ATTRIBUTE_UNUSED = semaphore->current_value;
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "semaphore values must be monotonically "
+                            "increasing; current_value=%" PRIu64
+                            ", new_value=%" PRIu64,
+                            current_value, new_value);
+  }
+
+  semaphore->current_value = new_value;
+
+  // Device signals at or below the new value are no longer needed as waiters
+  // will observe the value directly.
+  iree_hal_cuda_pooled_event_t*
+      retired_events[IREE_HAL_CUDA_SEMAPHORE_MAX_DEVICE_SIGNAL_COUNT];
+  iree_host_size_t retired_count =
+      iree_hal_cuda_semaphore_retire_device_signals(semaphore, new_value,
+                                                    retired_events);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  for (iree_host_size_t i = 0; i < retired_count; ++i) {
+    iree_hal_cuda_pooled_event_release(retired_events[i]);
+  }
+
+  // Notify timepoints - note that this must happen outside the lock.
+  iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
+
   return iree_ok_status();
 }
 
@@ -87,9 +208,114 @@ static void iree_hal_cuda_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
                                          iree_status_t status) {
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
-  // TODO: save status and mark timepoint as failed.
-  iree_status_ignore(status);
-  iree_hal_semaphore_poll(&semaphore->base);
+  const iree_status_code_t status_code = iree_status_code(status);
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Try to set our local status - we only preserve the first failure so only
+  // do this if we are going from a valid semaphore to a failed one.
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Previous status was not OK; drop our new status.
+    IREE_IGNORE_ERROR(status);
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return;
+  }
+
+  // Signal to our failure sentinel value.
+  semaphore->current_value = IREE_HAL_SEMAPHORE_FAILURE_VALUE;
+  semaphore->failure_status = status;
+
+  // Device waiters must not chain on to work that will never signal.
+  iree_hal_cuda_pooled_event_t*
+      retired_events[IREE_HAL_CUDA_SEMAPHORE_MAX_DEVICE_SIGNAL_COUNT];
+  iree_host_size_t retired_count =
+      iree_hal_cuda_semaphore_retire_device_signals(semaphore, UINT64_MAX,
+                                                    retired_events);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  for (iree_host_size_t i = 0; i < retired_count; ++i) {
+    iree_hal_cuda_pooled_event_release(retired_events[i]);
+  }
+
+  // Notify timepoints - note that this must happen outside the lock.
+  iree_hal_semaphore_notify(&semaphore->base, IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+                            status_code);
+}
+
+void iree_hal_cuda_semaphore_notify_device_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_hal_cuda_pooled_event_t* event) {
+  iree_hal_cuda_semaphore_t* semaphore =
+      iree_hal_cuda_semaphore_cast(base_semaphore);
+  iree_hal_cuda_pooled_event_t* dropped_event = NULL;
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Signals are issued in queue order so values are expected to be increasing
+  // but signals from multiple queues may race; only track signals that advance
+  // the timeline beyond what is already tracked.
+  iree_host_size_t count = semaphore->device_signal_count;
+  if (value > semaphore->current_value &&
+      (count == 0 || value > semaphore->device_signals[count - 1].value)) {
+    if (count == IREE_HAL_CUDA_SEMAPHORE_MAX_DEVICE_SIGNAL_COUNT) {
+      // Drop the oldest signal; waiters on it will use a later one.
+      dropped_event = semaphore->device_signals[0].event;
+      memmove(&semaphore->device_signals[0], &semaphore->device_signals[1],
+              (count - 1) * sizeof(semaphore->device_signals[0]));
+      --count;
+    }
+    iree_hal_cuda_pooled_event_retain(event);
+    semaphore->device_signals[count].value = value;
+    semaphore->device_signals[count].event = event;
+    semaphore->device_signal_count = count + 1;
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  if (dropped_event) iree_hal_cuda_pooled_event_release(dropped_event);
+}
+
+iree_hal_cuda_pooled_event_t* iree_hal_cuda_semaphore_acquire_device_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t minimum_value) {
+  iree_hal_cuda_semaphore_t* semaphore =
+      iree_hal_cuda_semaphore_cast(base_semaphore);
+  iree_hal_cuda_pooled_event_t* event = NULL;
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  // Any signal at or beyond the value satisfies the wait; prefer the earliest
+  // as it completes first.
+  for (iree_host_size_t i = 0; i < semaphore->device_signal_count; ++i) {
+    if (semaphore->device_signals[i].value >= minimum_value) {
+      event = semaphore->device_signals[i].event;
+      iree_hal_cuda_pooled_event_retain(event);
+      break;
+    }
+  }
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  return event;
+}
+
+// Acquires a timepoint waiting for the given value.
+// |out_timepoint| is owned by the caller and must be kept live until the
+// timepoint has been reached (or it is cancelled by the caller).
+static iree_status_t iree_hal_cuda_semaphore_acquire_timepoint(
+    iree_hal_cuda_semaphore_t* semaphore, uint64_t minimum_value,
+    iree_timeout_t timeout, iree_hal_cuda_timepoint_t* out_timepoint) {
+  IREE_RETURN_IF_ERROR(iree_event_pool_acquire(semaphore->host_event_pool, 1,
+                                               &out_timepoint->event));
+  out_timepoint->semaphore = &semaphore->base;
+  iree_hal_semaphore_acquire_timepoint(
+      &semaphore->base, minimum_value, timeout,
+      (iree_hal_semaphore_callback_t){
+          .fn = iree_hal_cuda_semaphore_timepoint_callback,
+          .user_data = out_timepoint,
+      },
+      &out_timepoint->base);
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_semaphore_wait(
@@ -97,10 +323,147 @@ static iree_status_t iree_hal_cuda_semaphore_wait(
     iree_timeout_t timeout) {
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
-  // TODO: Support semaphores completely. Return OK currently as everything is
-  // synchronized for each submit to allow things to run.
-  iree_hal_semaphore_poll(&semaphore->base);
-  return iree_ok_status();
+
+  iree_slim_mutex_lock(&semaphore->mutex);
+
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    // Fastest path: failed; return an error to tell callers to query for it.
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_status_from_code(IREE_STATUS_ABORTED);
+  } else if (semaphore->current_value >= value) {
+    // Fast path: already satisfied.
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_ok_status();
+  } else if (iree_timeout_is_immediate(timeout)) {
+    // Not satisfied but a poll, so can avoid the expensive wait handle work.
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+
+  // Slow path: acquire a timepoint while we hold the lock.
+  iree_hal_cuda_timepoint_t timepoint;
+  iree_status_t status = iree_hal_cuda_semaphore_acquire_timepoint(
+      semaphore, value, timeout, &timepoint);
+
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
+
+  // Wait until the timepoint resolves.
+  // If satisfied the timepoint is automatically cleaned up and we are done. If
+  // the deadline is reached before satisfied then we have to clean it up.
+  status = iree_wait_one(&timepoint.event, deadline_ns);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  }
+  iree_event_pool_release(semaphore->host_event_pool, 1, &timepoint.event);
+
+  // The timepoint is also resolved on failure; report it to the caller.
+  if (iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&semaphore->mutex);
+    if (!iree_status_is_ok(semaphore->failure_status)) {
+      status = iree_status_from_code(IREE_STATUS_ABORTED);
+    }
+    iree_slim_mutex_unlock(&semaphore->mutex);
+  }
+  return status;
+}
+
+iree_status_t iree_hal_cuda_semaphore_multi_wait(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_event_pool_t* host_event_pool, iree_arena_block_pool_t* block_pool) {
+  if (semaphore_list.count == 0) {
+    return iree_ok_status();
+  } else if (semaphore_list.count == 1) {
+    // Fast-path for a single semaphore.
+    return iree_hal_semaphore_wait(semaphore_list.semaphores[0],
+                                   semaphore_list.payload_values[0], timeout);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+
+  // Avoid heap allocations by using the device block pool for the wait set.
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(block_pool, &arena);
+  iree_wait_set_t* wait_set = NULL;
+  iree_status_t status = iree_wait_set_allocate(
+      semaphore_list.count, iree_arena_allocator(&arena), &wait_set);
+
+  // Acquire a wait handle for each semaphore timepoint we are to wait on.
+  iree_host_size_t timepoint_count = 0;
+  iree_hal_cuda_timepoint_t* timepoints = NULL;
+  iree_host_size_t total_timepoint_size =
+      semaphore_list.count * sizeof(timepoints[0]);
+  bool any_satisfied = false;
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
+  }
+  if (iree_status_is_ok(status)) {
+    memset(timepoints, 0, total_timepoint_size);
+    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+      iree_hal_cuda_semaphore_t* semaphore =
+          iree_hal_cuda_semaphore_cast(semaphore_list.semaphores[i]);
+      iree_slim_mutex_lock(&semaphore->mutex);
+      if (!iree_status_is_ok(semaphore->failure_status)) {
+        status = iree_status_from_code(IREE_STATUS_ABORTED);
+      } else if (semaphore->current_value >=
+                 semaphore_list.payload_values[i]) {
+        // Fast path: already satisfied.
+        any_satisfied = true;
+      } else {
+        // Slow path: get a native wait handle for the timepoint.
+        iree_hal_cuda_timepoint_t* timepoint = &timepoints[timepoint_count++];
+        status = iree_hal_cuda_semaphore_acquire_timepoint(
+            semaphore, semaphore_list.payload_values[i], timeout, timepoint);
+        if (iree_status_is_ok(status)) {
+          status = iree_wait_set_insert(wait_set, timepoint->event);
+        }
+      }
+      iree_slim_mutex_unlock(&semaphore->mutex);
+      if (!iree_status_is_ok(status)) break;
+    }
+  }
+
+  // Perform the wait.
+  if (iree_status_is_ok(status) && timepoint_count > 0 &&
+      !(wait_mode == IREE_HAL_WAIT_MODE_ANY && any_satisfied)) {
+    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
+      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
+    } else {
+      status = iree_wait_all(wait_set, deadline_ns);
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
+    iree_hal_semaphore_t* semaphore = timepoints[i].semaphore;
+    if (semaphore) {
+      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i].base);
+      iree_event_pool_release(host_event_pool, 1, &timepoints[i].event);
+    }
+  }
+  iree_wait_set_free(wait_set);
+  iree_arena_deinitialize(&arena);
+
+  // Timepoints also resolve when semaphores fail; report failures to the
+  // caller so they can query for the status.
+  for (iree_host_size_t i = 0;
+       i < semaphore_list.count && iree_status_is_ok(status); ++i) {
+    iree_hal_cuda_semaphore_t* semaphore =
+        iree_hal_cuda_semaphore_cast(semaphore_list.semaphores[i]);
+    iree_slim_mutex_lock(&semaphore->mutex);
+    if (!iree_status_is_ok(semaphore->failure_status)) {
+      status = iree_status_from_code(IREE_STATUS_ABORTED);
+    }
+    iree_slim_mutex_unlock(&semaphore->mutex);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 static const iree_hal_semaphore_vtable_t iree_hal_cuda_semaphore_vtable = {
@@ -10,19 +10,58 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/base/internal/event_pool.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
-// Create a cuda allocator.
+// Maximum number of in-flight device signals tracked per semaphore. Older
+// signals are dropped when exceeded and device waits on them fall back to
+// waiting for the host to observe the signal.
+#define IREE_HAL_CUDA_SEMAPHORE_MAX_DEVICE_SIGNAL_COUNT 8
+
+// Creates a timeline semaphore signaled from the host or by queue submissions.
+//
+// Submissions that signal the semaphore record a CUevent on their stream and
+// publish it with iree_hal_cuda_semaphore_notify_device_signal. Later
+// submissions waiting on the semaphore can then wait on that event on the
+// device instead of waiting on the host for the signal.
+//
+// |host_event_pool| is used to acquire wait handles for host waits.
 iree_status_t iree_hal_cuda_semaphore_create(
-    iree_hal_cuda_context_wrapper_t* context, uint64_t initial_value,
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_event_pool_t* host_event_pool, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore);
 
+// Returns true if |semaphore| is a CUDA semaphore.
+bool iree_hal_cuda_semaphore_isa(iree_hal_semaphore_t* semaphore);
+
+// Publishes that |event| has been recorded on a stream and that |semaphore|
+// will be signaled to |value| once it completes. The semaphore retains the
+// event until it observes the signal on the host.
+void iree_hal_cuda_semaphore_notify_device_signal(
+    iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_hal_cuda_pooled_event_t* event);
+
+// Returns a retained event that completes once |semaphore| reaches at least
+// |minimum_value| or NULL if no such event has been recorded yet.
+iree_hal_cuda_pooled_event_t* iree_hal_cuda_semaphore_acquire_device_wait(
+    iree_hal_semaphore_t* semaphore, uint64_t minimum_value);
+
+// Performs a multi-wait on one or more semaphores.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait does not complete before
+// |timeout| elapses.
+iree_status_t iree_hal_cuda_semaphore_multi_wait(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_event_pool_t* host_event_pool, iree_arena_block_pool_t* block_pool);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
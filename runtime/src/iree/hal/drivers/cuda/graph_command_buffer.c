@@ -18,6 +18,7 @@
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 #include "iree/hal/utils/collective_batch.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 #define IREE_HAL_CUDA_MAX_BINDING_COUNT 64
@@ -31,6 +32,9 @@ typedef struct iree_hal_cuda_graph_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_hal_cuda_context_wrapper_t* context;
 
+  // Cache the exec is acquired from on end and returned to on destroy.
+  iree_hal_cuda_graph_exec_cache_t* exec_cache;
+
   // Maintains a reference to all resources used within the command buffer.
   // Reset on each begin.
   iree_hal_resource_set_t* resource_set;
@@ -43,9 +47,20 @@ typedef struct iree_hal_cuda_graph_command_buffer_t {
   CUgraph graph;
   CUgraphExec exec;
 
-  // Keep track of the last node added to the command buffer as we are currently
-  // serializing all the nodes (each node depends on the previous one).
-  CUgraphNode last_node;
+  // Hash of the graph topology and the node properties that cannot be changed
+  // with cuGraphExecUpdate. Graphs with equal hashes can reuse the same exec.
+  uint64_t structure_hash;
+
+  // Node that all nodes added since the last barrier depend on. NULL if no
+  // barrier has been recorded with prior nodes.
+  CUgraphNode barrier_node;
+
+  // Nodes added since the last barrier. These have no dependencies between one
+  // another and may execute concurrently. Storage is allocated from the arena
+  // and grows as needed.
+  CUgraphNode* region_nodes;
+  iree_host_size_t region_node_count;
+  iree_host_size_t region_node_capacity;
 
   // Iteratively constructed batch of collective operations.
   iree_hal_collective_batch_t collective_batch;
@@ -67,22 +82,18 @@ iree_hal_cuda_graph_command_buffer_cast(iree_hal_command_buffer_t* base_value) {
 
 iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(exec_cache);
   IREE_ASSERT_ARGUMENT(block_pool);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_cuda_graph_command_buffer_t* command_buffer = NULL;
@@ -96,10 +107,15 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
         device, mode, command_categories, queue_affinity, binding_capacity,
         &iree_hal_cuda_graph_command_buffer_vtable, &command_buffer->base);
     command_buffer->context = context;
+    command_buffer->exec_cache = exec_cache;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     command_buffer->graph = NULL;
     command_buffer->exec = NULL;
-    command_buffer->last_node = NULL;
+    command_buffer->structure_hash = 0;
+    command_buffer->barrier_node = NULL;
+    command_buffer->region_nodes = NULL;
+    command_buffer->region_node_count = 0;
+    command_buffer->region_node_capacity = 0;
 
     CUdeviceptr* device_ptrs =
         (CUdeviceptr*)(command_buffer->current_descriptor +
@@ -141,11 +157,13 @@ static void iree_hal_cuda_graph_command_buffer_destroy(
     command_buffer->graph = NULL;
   }
   if (command_buffer->exec != NULL) {
-    CUDA_IGNORE_ERROR(command_buffer->context->syms,
-                      cuGraphExecDestroy(command_buffer->exec));
+    iree_hal_cuda_graph_exec_cache_release(command_buffer->exec_cache,
+                                           command_buffer->structure_hash,
+                                           command_buffer->exec);
     command_buffer->exec = NULL;
   }
-  command_buffer->last_node = NULL;
+  command_buffer->barrier_node = NULL;
+  command_buffer->region_node_count = 0;
 
   iree_hal_collective_batch_deinitialize(&command_buffer->collective_batch);
   iree_hal_resource_set_free(command_buffer->resource_set);
@@ -169,6 +187,65 @@ bool iree_hal_cuda_graph_command_buffer_isa(
                               &iree_hal_cuda_graph_command_buffer_vtable);
 }
 
+// Mixes |value| into the structure hash of the graph being recorded.
+static void iree_hal_cuda_graph_command_buffer_hash(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer, uint64_t value) {
+  // 64-bit FNV-1a over the bytes of |value|.
+  uint64_t hash = command_buffer->structure_hash;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (i * 8)) & 0xFF;
+    hash *= 0x100000001B3ull;
+  }
+  command_buffer->structure_hash = hash;
+}
+
+// Adds |node| to the current concurrent region.
+static iree_status_t iree_hal_cuda_graph_command_buffer_append_node(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer, CUgraphNode node) {
+  if (command_buffer->region_node_count ==
+      command_buffer->region_node_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(16, command_buffer->region_node_capacity * 2);
+    CUgraphNode* new_nodes = NULL;
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                             new_capacity * sizeof(CUgraphNode),
+                                             (void**)&new_nodes));
+    if (command_buffer->region_node_count > 0) {
+      memcpy(new_nodes, command_buffer->region_nodes,
+             command_buffer->region_node_count * sizeof(CUgraphNode));
+    }
+    command_buffer->region_nodes = new_nodes;
+    command_buffer->region_node_capacity = new_capacity;
+  }
+  command_buffer->region_nodes[command_buffer->region_node_count++] = node;
+  return iree_ok_status();
+}
+
+// Ends the current concurrent region such that all nodes added afterward
+// depend on all nodes added before. Regions with multiple nodes are joined
+// through an empty node to avoid quadratic edge counts.
+static iree_status_t iree_hal_cuda_graph_command_buffer_insert_barrier(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer) {
+  if (command_buffer->region_node_count == 0) {
+    return iree_ok_status();
+  }
+  // The graph topology is fully determined by the sequence of node types and
+  // the positions of barriers between them.
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer, UINT64_MAX);
+  if (command_buffer->region_node_count == 1) {
+    command_buffer->barrier_node = command_buffer->region_nodes[0];
+  } else {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuGraphAddEmptyNode(&command_buffer->barrier_node,
+                            command_buffer->graph, command_buffer->region_nodes,
+                            command_buffer->region_node_count),
+        "cuGraphAddEmptyNode");
+  }
+  command_buffer->region_node_count = 0;
+  return iree_ok_status();
+}
+
 // Flushes any pending batched collective operations.
 // Must be called before any other non-collective nodes are added to the graph
 // or a barrier is encountered.
@@ -216,12 +293,13 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_begin(
       iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
 
   // Fail if re-recording.
-  if (command_buffer->graph != NULL) {
+  if (command_buffer->graph != NULL || command_buffer->exec != NULL) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                             "command buffer cannot be re-recorded");
   }
 
   // Create a new empty graph to record into.
+  command_buffer->structure_hash = 0xCBF29CE484222325ull;
   CUDA_RETURN_IF_ERROR(command_buffer->context->syms,
                        cuGraphCreate(&command_buffer->graph, /*flags=*/0),
                        "cuGraphCreate");
@@ -239,16 +317,14 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
       iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
 
   // Reset state used during recording.
-  command_buffer->last_node = NULL;
-
-  // Compile the graph.
-  CUgraphNode error_node = NULL;
-  iree_status_t status =
-      CU_RESULT_TO_STATUS(command_buffer->context->syms,
-                          cuGraphInstantiate(&command_buffer->exec,
-                                             command_buffer->graph, &error_node,
-                                             /*logBuffer=*/NULL,
-                                             /*bufferSize=*/0));
+  command_buffer->barrier_node = NULL;
+  command_buffer->region_node_count = 0;
+
+  // Compile the graph, reusing a cached exec with the same structure if one is
+  // available.
+  iree_status_t status = iree_hal_cuda_graph_exec_cache_acquire(
+      command_buffer->exec_cache, command_buffer->structure_hash,
+      command_buffer->graph, &command_buffer->exec);
   if (iree_status_is_ok(status)) {
     // No longer need the source graph used for construction.
     CUDA_IGNORE_ERROR(command_buffer->context->syms,
@@ -258,7 +334,7 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
 
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_cuda_graph_command_buffer_begin_debug_group(
@@ -287,10 +363,7 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_execution_barrier(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
 
-  // TODO: Implement barrier with Graph edges. Right now all the nodes are
-  // serialized so this is a no-op.
-
-  return iree_ok_status();
+  return iree_hal_cuda_graph_command_buffer_insert_barrier(command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_signal_event(
@@ -301,10 +374,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_signal_event(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
 
-  // TODO: Implement barrier with Graph edges. Right now all the nodes are
-  // serialized so this is a no-op.
-
-  return iree_ok_status();
+  // TODO: Implement events with graph edges. Until then events act as full
+  // barriers to preserve ordering with concurrently executing nodes.
+  return iree_hal_cuda_graph_command_buffer_insert_barrier(command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_reset_event(
@@ -315,10 +387,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_reset_event(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
 
-  // TODO: Implement barrier with Graph edges. Right now all the nodes are
-  // serialized so this is a no-op.
-
-  return iree_ok_status();
+  // TODO: Implement events with graph edges. Until then events act as full
+  // barriers to preserve ordering with concurrently executing nodes.
+  return iree_hal_cuda_graph_command_buffer_insert_barrier(command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_wait_events(
@@ -335,10 +406,9 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_wait_events(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_graph_command_buffer_flush_collectives(command_buffer));
 
-  // TODO: Implement barrier with Graph edges. Right now all the nodes are
-  // serialized so this is a no-op.
-
-  return iree_ok_status();
+  // TODO: Implement events with graph edges. Until then events act as full
+  // barriers to preserve ordering with concurrently executing nodes.
+  return iree_hal_cuda_graph_command_buffer_insert_barrier(command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_discard_buffer(
@@ -396,17 +466,21 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_fill_buffer(
       .height = 1,
       .value = dword_pattern,
   };
-  // Serialize all the nodes for now.
-  CUgraphNode dep[] = {command_buffer->last_node};
-  size_t numNode = command_buffer->last_node ? 1 : 0;
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer,
+                                          CU_GRAPH_NODE_TYPE_MEMSET);
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer, pattern_length);
+  // Nodes depend only on the last barrier so that nodes within a concurrent
+  // region may execute in parallel.
+  CUgraphNode dep[] = {command_buffer->barrier_node};
+  size_t numNode = command_buffer->barrier_node ? 1 : 0;
+  CUgraphNode node = NULL;
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      cuGraphAddMemsetNode(&command_buffer->last_node, command_buffer->graph,
-                           dep, numNode, &params,
+      cuGraphAddMemsetNode(&node, command_buffer->graph, dep, numNode, &params,
                            command_buffer->context->cu_context),
       "cuGraphAddMemsetNode");
 
-  return iree_ok_status();
+  return iree_hal_cuda_graph_command_buffer_append_node(command_buffer, node);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_update_buffer(
@@ -444,19 +518,23 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_update_buffer(
       .Height = 1,
       .Depth = 1,
   };
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer,
+                                          CU_GRAPH_NODE_TYPE_MEMCPY);
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer, params.srcMemoryType);
 
-  // Serialize all the nodes for now.
-  CUgraphNode dep[] = {command_buffer->last_node};
-  size_t numNode = command_buffer->last_node ? 1 : 0;
+  // Nodes depend only on the last barrier so that nodes within a concurrent
+  // region may execute in parallel.
+  CUgraphNode dep[] = {command_buffer->barrier_node};
+  size_t numNode = command_buffer->barrier_node ? 1 : 0;
+  CUgraphNode node = NULL;
 
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      cuGraphAddMemcpyNode(&command_buffer->last_node, command_buffer->graph,
-                           dep, numNode, &params,
+      cuGraphAddMemcpyNode(&node, command_buffer->graph, dep, numNode, &params,
                            command_buffer->context->cu_context),
       "cuGraphAddMemcpyNode");
 
-  return iree_ok_status();
+  return iree_hal_cuda_graph_command_buffer_append_node(command_buffer, node);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_copy_buffer(
@@ -491,19 +569,23 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_copy_buffer(
       .Height = 1,
       .Depth = 1,
   };
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer,
+                                          CU_GRAPH_NODE_TYPE_MEMCPY);
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer, params.srcMemoryType);
 
-  // Serialize all the nodes for now.
-  CUgraphNode dep[] = {command_buffer->last_node};
-  size_t numNode = command_buffer->last_node ? 1 : 0;
+  // Nodes depend only on the last barrier so that nodes within a concurrent
+  // region may execute in parallel.
+  CUgraphNode dep[] = {command_buffer->barrier_node};
+  size_t numNode = command_buffer->barrier_node ? 1 : 0;
+  CUgraphNode node = NULL;
 
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      cuGraphAddMemcpyNode(&command_buffer->last_node, command_buffer->graph,
-                           dep, numNode, &params,
+      cuGraphAddMemcpyNode(&node, command_buffer->graph, dep, numNode, &params,
                            command_buffer->context->cu_context),
       "cuGraphAddMemcpyNode");
 
-  return iree_ok_status();
+  return iree_hal_cuda_graph_command_buffer_append_node(command_buffer, node);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_collective(
@@ -635,18 +717,24 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
       .kernelParams = command_buffer->current_descriptor,
       .sharedMemBytes = kernel_params.shared_memory_size,
   };
+  iree_hal_cuda_graph_command_buffer_hash(command_buffer,
+                                          CU_GRAPH_NODE_TYPE_KERNEL);
+  iree_hal_cuda_graph_command_buffer_hash(
+      command_buffer, (uint64_t)(uintptr_t)kernel_params.function);
 
-  // Serialize all the nodes for now.
-  CUgraphNode dep[] = {command_buffer->last_node};
-  size_t numNodes = command_buffer->last_node ? 1 : 0;
+  // Nodes depend only on the last barrier so that nodes within a concurrent
+  // region may execute in parallel.
+  CUgraphNode dep[] = {command_buffer->barrier_node};
+  size_t numNodes = command_buffer->barrier_node ? 1 : 0;
+  CUgraphNode node = NULL;
 
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      cuGraphAddKernelNode(&command_buffer->last_node, command_buffer->graph,
-                           dep, numNodes, &params),
+      cuGraphAddKernelNode(&node, command_buffer->graph, dep, numNodes,
+                           &params),
       "cuGraphAddKernelNode");
 
-  return iree_ok_status();
+  return iree_hal_cuda_graph_command_buffer_append_node(command_buffer, node);
 }
 
 static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch_indirect(
@@ -662,13 +750,18 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers by adding subgraph nodes and
-  // tracking the binding table for future cuGraphExecKernelNodeSetParams usage.
-  // Need to look into how to update the params of the subgraph nodes - is the
-  // graph exec the outer one and if so will it allow node handles from the
-  // subgraphs?
+  // Nested command buffers are recorded as deferred command buffers and
+  // replayed into this graph with the binding table resolved.
+  // TODO(#10144): record nested command buffers as subgraphs and retarget
+  // their kernel parameters with cuGraphExecKernelNodeSetParams so that a
+  // graph exec can be reused across binding tables without re-recording.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 static const iree_hal_command_buffer_vtable_t
@@ -12,6 +12,7 @@
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,10 +22,16 @@ typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
 
 // Creates a command buffer that records into a CUDA graph.
 //
-// NOTE: the |block_pool| must remain live for the lifetime of the command
-// buffers that use it.
+// Instantiated graphs are acquired from |exec_cache| so that command buffers
+// with the same structure as one previously recorded update an existing
+// CUgraphExec instead of instantiating a new one. The exec is returned to the
+// cache when the command buffer is destroyed.
+//
+// NOTE: the |block_pool| and |exec_cache| must remain live for the lifetime of
+// the command buffers that use them.
 iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
@@ -0,0 +1,76 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+#define IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// An instantiated graph retained by the cache for reuse.
+typedef struct iree_hal_cuda_graph_exec_cache_entry_t {
+  // Hash of the topology and node types of the graph |exec| was last
+  // instantiated or updated from.
+  uint64_t structure_hash;
+  CUgraphExec exec;
+} iree_hal_cuda_graph_exec_cache_entry_t;
+
+// LRU cache of instantiated graphs keyed by a hash of their structure.
+//
+// cuGraphInstantiate is expensive and dominates when command buffers are
+// recorded per invocation (such as with dynamic shapes). Graphs with the same
+// structure as a previously instantiated one only differ in node parameters
+// and can instead update an existing CUgraphExec with cuGraphExecUpdate.
+//
+// Execs are exclusively owned by a command buffer between acquire and release;
+// the cache only holds idle execs. Thread-safe.
+typedef struct iree_hal_cuda_graph_exec_cache_t {
+  iree_hal_cuda_context_wrapper_t* context;
+  // Maximum number of idle execs retained. 0 disables caching.
+  iree_host_size_t capacity;
+
+  iree_slim_mutex_t mutex;
+  // Ordered from least to most recently used.
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_graph_exec_cache_entry_t* entries;
+} iree_hal_cuda_graph_exec_cache_t;
+
+// Initializes |out_cache| to retain up to |capacity| idle instantiated graphs.
+iree_status_t iree_hal_cuda_graph_exec_cache_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_host_size_t capacity,
+    iree_hal_cuda_graph_exec_cache_t* out_cache);
+
+// Deinitializes |cache| and destroys all idle execs. All acquired execs must
+// have been released.
+void iree_hal_cuda_graph_exec_cache_deinitialize(
+    iree_hal_cuda_graph_exec_cache_t* cache);
+
+// Returns an exec for |graph| with the given |structure_hash|. A cached exec
+// with the same hash is updated in-place when possible and otherwise a new exec
+// is instantiated. The caller owns the returned exec and must return it with
+// iree_hal_cuda_graph_exec_cache_release.
+iree_status_t iree_hal_cuda_graph_exec_cache_acquire(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t structure_hash,
+    CUgraph graph, CUgraphExec* out_exec);
+
+// Returns |exec| with |structure_hash| to the cache for reuse, evicting the
+// least recently used exec if the cache is full. The exec may still have work
+// in flight as updates only affect subsequent launches.
+void iree_hal_cuda_graph_exec_cache_release(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t structure_hash,
+    CUgraphExec exec);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
@@ -21,7 +21,7 @@ static const char* IREE_HAL_CUDA_OTHER_POOL_RESERVED_ID =
 
 static iree_status_t iree_hal_cuda_create_memory_pool(
     iree_hal_cuda_context_wrapper_t* context,
-    iree_hal_cuda_memory_pool_params_t params,
+    iree_hal_cuda_memory_pool_params_t params, CUstream stream,
     CUmemoryPool* IREE_RESTRICT out_pool) {
   *out_pool = NULL;
 
@@ -42,12 +42,32 @@ static iree_status_t iree_hal_cuda_create_memory_pool(
   CUDA_RETURN_IF_ERROR(context->syms, cuMemPoolCreate(&pool, &pool_props),
                        "cuMemPoolCreate");
 
+  // The pool must retain at least its minimum capacity across synchronizations
+  // or the reservation below would be returned to the driver immediately.
+  cuuint64_t release_threshold =
+      iree_max(params.release_threshold, params.minimum_capacity);
   iree_status_t status = CU_RESULT_TO_STATUS(
       context->syms,
       cuMemPoolSetAttribute(pool, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD,
-                            &params.release_threshold),
+                            &release_threshold),
       "cuMemPoolSetAttribute");
 
+  // Grow the pool to its minimum capacity by allocating and immediately freeing
+  // a block so that the first allocations do not pay for pool growth.
+  if (iree_status_is_ok(status) && params.minimum_capacity > 0) {
+    CUdeviceptr device_ptr = 0;
+    status = CU_RESULT_TO_STATUS(
+        context->syms,
+        cuMemAllocFromPoolAsync(&device_ptr, (size_t)params.minimum_capacity,
+                                pool, stream),
+        "cuMemAllocFromPoolAsync");
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(context->syms,
+                                   cuMemFreeAsync(device_ptr, stream),
+                                   "cuMemFreeAsync");
+    }
+  }
+
   if (iree_status_is_ok(status)) {
     *out_pool = pool;
   } else {
@@ -59,6 +79,7 @@ static iree_status_t iree_hal_cuda_create_memory_pool(
 iree_status_t iree_hal_cuda_memory_pools_initialize(
     iree_hal_cuda_context_wrapper_t* context,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params,
+    iree_host_size_t queue_count, CUstream stream,
     iree_hal_cuda_memory_pools_t* IREE_RESTRICT out_pools) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(pooling_params);
@@ -68,16 +89,33 @@ iree_status_t iree_hal_cuda_memory_pools_initialize(
   memset(out_pools, 0, sizeof(*out_pools));
   out_pools->context = context;
 
-  iree_status_t status = iree_ok_status();
-
+  iree_host_size_t pool_queue_count =
+      pooling_params->per_queue ? iree_max(1, queue_count) : 1;
+  iree_status_t status = iree_allocator_malloc(
+      context->host_allocator, pool_queue_count * sizeof(out_pools->queues[0]),
+      (void**)&out_pools->queues);
   if (iree_status_is_ok(status)) {
+    memset(out_pools->queues, 0,
+           pool_queue_count * sizeof(out_pools->queues[0]));
+    out_pools->queue_count = pool_queue_count;
+  }
+
+  for (iree_host_size_t i = 0;
+       i < out_pools->queue_count && iree_status_is_ok(status); ++i) {
+    iree_hal_cuda_queue_memory_pools_t* queue_pools = &out_pools->queues[i];
     status = iree_hal_cuda_create_memory_pool(
-        context, pooling_params->device_local, &out_pools->device_local);
+        context, pooling_params->device_local, stream,
+        &queue_pools->device_local);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_create_memory_pool(
+          context, pooling_params->other, stream, &queue_pools->other);
+    }
   }
 
+  // Wait for the reservations to complete so they are usable from any stream.
   if (iree_status_is_ok(status)) {
-    status = iree_hal_cuda_create_memory_pool(context, pooling_params->other,
-                                              &out_pools->other);
+    status = CU_RESULT_TO_STATUS(context->syms, cuStreamSynchronize(stream),
+                                 "cuStreamSynchronize");
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -86,18 +124,25 @@ iree_status_t iree_hal_cuda_memory_pools_initialize(
 
 void iree_hal_cuda_memory_pools_deinitialize(
     iree_hal_cuda_memory_pools_t* pools) {
+  if (!pools->queues) return;
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  if (pools->device_local) {
-    CUDA_IGNORE_ERROR(pools->context->syms,
-                      cuMemPoolDestroy(pools->device_local));
-    pools->device_local = NULL;
-  }
-
-  if (pools->other) {
-    CUDA_IGNORE_ERROR(pools->context->syms, cuMemPoolDestroy(pools->other));
-    pools->other = NULL;
+  for (iree_host_size_t i = 0; i < pools->queue_count; ++i) {
+    iree_hal_cuda_queue_memory_pools_t* queue_pools = &pools->queues[i];
+    if (queue_pools->device_local) {
+      CUDA_IGNORE_ERROR(pools->context->syms,
+                        cuMemPoolDestroy(queue_pools->device_local));
+      queue_pools->device_local = NULL;
+    }
+    if (queue_pools->other) {
+      CUDA_IGNORE_ERROR(pools->context->syms,
+                        cuMemPoolDestroy(queue_pools->other));
+      queue_pools->other = NULL;
+    }
   }
+  iree_allocator_free(pools->context->host_allocator, pools->queues);
+  pools->queues = NULL;
+  pools->queue_count = 0;
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -142,6 +187,21 @@ static void iree_hal_cuda_memory_pool_track_free(
   });
 }
 
+#if IREE_STATISTICS_ENABLE
+// Queries the high-water marks of memory used from and reserved by |pool|.
+static void iree_hal_cuda_memory_pool_query_peaks(
+    iree_hal_cuda_context_wrapper_t* context, CUmemoryPool pool,
+    cuuint64_t* out_used_peak, cuuint64_t* out_reserved_peak) {
+  CUDA_IGNORE_ERROR(context->syms,
+                    cuMemPoolGetAttribute(pool, CU_MEMPOOL_ATTR_USED_MEM_HIGH,
+                                          out_used_peak));
+  CUDA_IGNORE_ERROR(
+      context->syms,
+      cuMemPoolGetAttribute(pool, CU_MEMPOOL_ATTR_RESERVED_MEM_HIGH,
+                            out_reserved_peak));
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 void iree_hal_cuda_memory_pools_merge_statistics(
     iree_hal_cuda_memory_pools_t* pools,
     iree_hal_allocator_statistics_t* statistics) {
@@ -154,21 +214,29 @@ void iree_hal_cuda_memory_pools_merge_statistics(
         &pools->statistics.device_bytes_freed, iree_memory_order_relaxed);
     statistics->host_bytes_freed = iree_atomic_load_int64(
         &pools->statistics.host_bytes_freed, iree_memory_order_relaxed);
-    if (pools->device_local) {
-      cuuint64_t pool_peak = 0;
-      CUDA_IGNORE_ERROR(
-          pools->context->syms,
-          cuMemPoolGetAttribute(pools->device_local,
-                                CU_MEMPOOL_ATTR_USED_MEM_HIGH, &pool_peak));
-      statistics->device_bytes_peak += (iree_device_size_t)pool_peak;
-    }
-    if (pools->other) {
-      cuuint64_t pool_peak = 0;
-      CUDA_IGNORE_ERROR(
-          pools->context->syms,
-          cuMemPoolGetAttribute(pools->other, CU_MEMPOOL_ATTR_USED_MEM_HIGH,
-                                &pool_peak));
-      statistics->host_bytes_peak += (iree_device_size_t)pool_peak;
+    for (iree_host_size_t i = 0; i < pools->queue_count; ++i) {
+      iree_hal_cuda_queue_memory_pools_t* queue_pools = &pools->queues[i];
+      if (queue_pools->device_local) {
+        cuuint64_t used_peak = 0;
+        cuuint64_t reserved_peak = 0;
+        iree_hal_cuda_memory_pool_query_peaks(
+            pools->context, queue_pools->device_local, &used_peak,
+            &reserved_peak);
+        statistics->device_bytes_peak += (iree_device_size_t)used_peak;
+        statistics->pool_bytes_used_peak += (iree_device_size_t)used_peak;
+        statistics->pool_bytes_reserved_peak +=
+            (iree_device_size_t)reserved_peak;
+      }
+      if (queue_pools->other) {
+        cuuint64_t used_peak = 0;
+        cuuint64_t reserved_peak = 0;
+        iree_hal_cuda_memory_pool_query_peaks(
+            pools->context, queue_pools->other, &used_peak, &reserved_peak);
+        statistics->host_bytes_peak += (iree_device_size_t)used_peak;
+        statistics->pool_bytes_used_peak += (iree_device_size_t)used_peak;
+        statistics->pool_bytes_reserved_peak +=
+            (iree_device_size_t)reserved_peak;
+      }
     }
   });
 }
@@ -176,15 +244,19 @@ void iree_hal_cuda_memory_pools_merge_statistics(
 iree_status_t iree_hal_cuda_memory_pools_trim(
     iree_hal_cuda_memory_pools_t* pools,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params) {
-  CUDA_RETURN_IF_ERROR(
-      pools->context->syms,
-      cuMemPoolTrimTo(pools->device_local,
-                      pooling_params->device_local.minimum_capacity),
-      "cuMemPoolTrimTo");
-  CUDA_RETURN_IF_ERROR(
-      pools->context->syms,
-      cuMemPoolTrimTo(pools->other, pooling_params->other.minimum_capacity),
-      "cuMemPoolTrimTo");
+  for (iree_host_size_t i = 0; i < pools->queue_count; ++i) {
+    iree_hal_cuda_queue_memory_pools_t* queue_pools = &pools->queues[i];
+    CUDA_RETURN_IF_ERROR(
+        pools->context->syms,
+        cuMemPoolTrimTo(queue_pools->device_local,
+                        pooling_params->device_local.minimum_capacity),
+        "cuMemPoolTrimTo");
+    CUDA_RETURN_IF_ERROR(
+        pools->context->syms,
+        cuMemPoolTrimTo(queue_pools->other,
+                        pooling_params->other.minimum_capacity),
+        "cuMemPoolTrimTo");
+  }
   return iree_ok_status();
 }
 
@@ -205,8 +277,9 @@ static void iree_hal_cuda_async_buffer_release_callback(
 }
 
 iree_status_t iree_hal_cuda_memory_pools_alloca(
-    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
-    iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    CUstream stream, iree_hal_allocator_pool_t pool,
+    iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -219,10 +292,12 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
   // external) but could use more buffer properties (including usage/export
   // flags) to better isolate the different usage patterns and keep the pools
   // operating with reasonable limits. We should be using the |pool| arg.
+  iree_hal_cuda_queue_memory_pools_t* queue_pools =
+      &pools->queues[queue_index % pools->queue_count];
   CUmemoryPool memory_pool =
       iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
-          ? pools->device_local
-          : pools->other;
+          ? queue_pools->device_local
+          : queue_pools->other;
 
   CUdeviceptr device_ptr = 0;
   iree_status_t status = CU_RESULT_TO_STATUS(
@@ -18,14 +18,22 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Retained CUDA memory pools for various allocation types.
-typedef struct iree_hal_cuda_memory_pools_t {
-  // CUDA context the pools are attached to.
-  iree_hal_cuda_context_wrapper_t* context;
+// CUDA memory pools used for allocations on one or more queues.
+typedef struct iree_hal_cuda_queue_memory_pools_t {
   // Used exclusively for DEVICE_LOCAL allocations.
   CUmemoryPool device_local;
   // Used for any host-visible/host-local memory types.
   CUmemoryPool other;
+} iree_hal_cuda_queue_memory_pools_t;
+
+// Retained CUDA memory pools for various allocation types.
+typedef struct iree_hal_cuda_memory_pools_t {
+  // CUDA context the pools are attached to.
+  iree_hal_cuda_context_wrapper_t* context;
+  // Number of entries in |queues|. 1 when all queues share the same pools.
+  iree_host_size_t queue_count;
+  // Pools used by each queue. Queues beyond |queue_count| wrap around.
+  iree_hal_cuda_queue_memory_pools_t* queues;
 
   IREE_STATISTICS(struct {
     iree_atomic_int64_t device_bytes_allocated;
@@ -35,10 +43,17 @@ typedef struct iree_hal_cuda_memory_pools_t {
   } statistics;)
 } iree_hal_cuda_memory_pools_t;
 
-// Initializes |out_pools| by configuring new CUDA memory pools.
+// Initializes |out_pools| by configuring new CUDA memory pools for each of
+// |queue_count| queues (or one set shared by all queues if per-queue pools are
+// not requested). Each pool is grown to its minimum capacity by an allocation
+// on |stream| that is synchronized before returning.
+//
+// |out_pools| must be deinitialized even on failure to release any pools that
+// were created.
 iree_status_t iree_hal_cuda_memory_pools_initialize(
     iree_hal_cuda_context_wrapper_t* context,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params,
+    iree_host_size_t queue_count, CUstream stream,
     iree_hal_cuda_memory_pools_t* IREE_RESTRICT out_pools);
 
 // Deinitializes the |pools| and releases the underlying CUDA resources.
@@ -55,10 +70,11 @@ iree_status_t iree_hal_cuda_memory_pools_trim(
     iree_hal_cuda_memory_pools_t* pools,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params);
 
-// Asynchronously allocates a buffer from an appropriate pool.
-// The allocation will be stream-ordered on |stream|.
+// Asynchronously allocates a buffer from an appropriate pool of the queue with
+// |queue_index|. The allocation will be stream-ordered on |stream|.
 iree_status_t iree_hal_cuda_memory_pools_alloca(
-    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    CUstream stream,
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer);
@@ -0,0 +1,234 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/module_cache.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+
+// 'IRCB' as a little-endian uint32_t.
+#define IREE_HAL_CUDA_MODULE_CACHE_MAGIC 0x42435249u
+#define IREE_HAL_CUDA_MODULE_CACHE_VERSION 0u
+
+// Header prefixing the cubin in each cache entry file.
+typedef struct iree_hal_cuda_module_cache_header_t {
+  // IREE_HAL_CUDA_MODULE_CACHE_MAGIC.
+  uint32_t magic;
+  // IREE_HAL_CUDA_MODULE_CACHE_VERSION.
+  uint32_t version;
+  // Hash and length of the PTX the cubin was produced from. The hash is also
+  // part of the file name but is repeated to detect collisions.
+  uint64_t ptx_hash;
+  uint64_t ptx_length;
+  // Length of the cubin following the header.
+  uint64_t cubin_length;
+} iree_hal_cuda_module_cache_header_t;
+
+// Returns the 64-bit FNV-1a hash of |length| bytes of |data|.
+static uint64_t iree_hal_cuda_module_cache_hash(const void* data,
+                                                iree_host_size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+iree_status_t iree_hal_cuda_module_cache_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_string_view_t path,
+    iree_hal_cuda_module_cache_t* out_cache) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_cache);
+  memset(out_cache, 0, sizeof(*out_cache));
+  out_cache->path = path;
+
+  int major = 0;
+  int minor = 0;
+  CUDA_RETURN_IF_ERROR(
+      context->syms,
+      cuDeviceGetAttribute(&major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR,
+                           context->cu_device),
+      "cuDeviceGetAttribute");
+  CUDA_RETURN_IF_ERROR(
+      context->syms,
+      cuDeviceGetAttribute(&minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR,
+                           context->cu_device),
+      "cuDeviceGetAttribute");
+  out_cache->sm_version = major * 10 + minor;
+  CUDA_RETURN_IF_ERROR(context->syms,
+                       cuDriverGetVersion(&out_cache->driver_version),
+                       "cuDriverGetVersion");
+  return iree_ok_status();
+}
+
+// Returns the path of the cache entry for PTX with |ptx_hash|.
+// The caller must free the returned path with |host_allocator|.
+static iree_status_t iree_hal_cuda_module_cache_entry_path(
+    const iree_hal_cuda_module_cache_t* cache, uint64_t ptx_hash,
+    iree_allocator_t host_allocator, char** out_path) {
+  char file_name[64];
+  snprintf(file_name, sizeof(file_name), "sm%d-drv%d-%016" PRIx64 ".cubin",
+           cache->sm_version, cache->driver_version, ptx_hash);
+  return iree_file_path_join(cache->path, iree_make_cstring_view(file_name),
+                             host_allocator, out_path);
+}
+
+// Tries to load the cubin cached at |path|. Returns false if there is no valid
+// entry or the driver rejects it.
+static bool iree_hal_cuda_module_cache_try_load(
+    iree_hal_cuda_context_wrapper_t* context, const char* path,
+    uint64_t ptx_hash, iree_host_size_t ptx_length, CUmodule* out_module) {
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status = iree_file_read_contents(
+      path, IREE_FILE_READ_FLAG_DEFAULT, context->host_allocator, &contents);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+
+  iree_hal_cuda_module_cache_header_t header;
+  iree_const_byte_span_t data = contents->const_buffer;
+  bool is_valid = data.data_length >= sizeof(header);
+  if (is_valid) {
+    memcpy(&header, data.data, sizeof(header));
+    is_valid = header.magic == IREE_HAL_CUDA_MODULE_CACHE_MAGIC &&
+               header.version == IREE_HAL_CUDA_MODULE_CACHE_VERSION &&
+               header.ptx_hash == ptx_hash &&
+               header.ptx_length == ptx_length &&
+               header.cubin_length == data.data_length - sizeof(header);
+  }
+  if (is_valid) {
+    // A failure here indicates a corrupt entry that will be rebuilt.
+    status = CU_RESULT_TO_STATUS(
+        context->syms,
+        cuModuleLoadData(out_module, data.data + sizeof(header)),
+        "cuModuleLoadData");
+    is_valid = iree_status_is_ok(status);
+    iree_status_ignore(status);
+  }
+
+  iree_file_contents_free(contents);
+  return is_valid;
+}
+
+// Writes |cubin| to the cache entry at |path|.
+static iree_status_t iree_hal_cuda_module_cache_store(
+    iree_allocator_t host_allocator, const char* path, uint64_t ptx_hash,
+    iree_host_size_t ptx_length, iree_const_byte_span_t cubin) {
+  iree_hal_cuda_module_cache_header_t header = {
+      .magic = IREE_HAL_CUDA_MODULE_CACHE_MAGIC,
+      .version = IREE_HAL_CUDA_MODULE_CACHE_VERSION,
+      .ptx_hash = ptx_hash,
+      .ptx_length = ptx_length,
+      .cubin_length = cubin.data_length,
+  };
+  iree_host_size_t path_length = strlen(path);
+  iree_host_size_t data_length = sizeof(header) + cubin.data_length;
+  uint8_t* storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, data_length + path_length + sizeof(".tmp"),
+      (void**)&storage));
+  memcpy(storage, &header, sizeof(header));
+  memcpy(storage + sizeof(header), cubin.data, cubin.data_length);
+  char* temp_path = (char*)storage + data_length;
+  memcpy(temp_path, path, path_length);
+  memcpy(temp_path + path_length, ".tmp", sizeof(".tmp"));
+
+  iree_status_t status = iree_file_write_contents(
+      temp_path, iree_make_const_byte_span(storage, data_length));
+  if (iree_status_is_ok(status) && rename(temp_path, path) != 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to rename '%s' to '%s'", temp_path,
+                              path);
+    remove(temp_path);
+  }
+
+  iree_allocator_free(host_allocator, storage);
+  return status;
+}
+
+// JIT compiles |ptx_image| to a cubin, loads it, and stores it at |path|.
+static iree_status_t iree_hal_cuda_module_cache_compile(
+    iree_hal_cuda_context_wrapper_t* context, const char* path,
+    uint64_t ptx_hash, const char* ptx_image, iree_host_size_t ptx_length,
+    CUmodule* out_module) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  CUlinkState link_state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, CU_RESULT_TO_STATUS(context->syms,
+                              cuLinkCreate(0, NULL, NULL, &link_state),
+                              "cuLinkCreate"));
+
+  // The PTX length includes the NUL terminator as required by the linker.
+  iree_status_t status = CU_RESULT_TO_STATUS(
+      context->syms,
+      cuLinkAddData(link_state, CU_JIT_INPUT_PTX, (void*)ptx_image,
+                    ptx_length + 1, "module", 0, NULL, NULL),
+      "cuLinkAddData");
+  void* cubin = NULL;
+  size_t cubin_size = 0;
+  if (iree_status_is_ok(status)) {
+    status = CU_RESULT_TO_STATUS(
+        context->syms, cuLinkComplete(link_state, &cubin, &cubin_size),
+        "cuLinkComplete");
+  }
+  if (iree_status_is_ok(status)) {
+    status = CU_RESULT_TO_STATUS(context->syms,
+                                 cuModuleLoadData(out_module, cubin),
+                                 "cuModuleLoadData");
+  }
+  if (iree_status_is_ok(status)) {
+    // The module is already loaded so failing to persist it is not an error.
+    iree_status_ignore(iree_hal_cuda_module_cache_store(
+        context->host_allocator, path, ptx_hash, ptx_length,
+        iree_make_const_byte_span(cubin, cubin_size)));
+  }
+
+  // Destroying the link state frees the cubin.
+  CUDA_IGNORE_ERROR(context->syms, cuLinkDestroy(link_state));
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_module_cache_load_module(
+    const iree_hal_cuda_module_cache_t* cache,
+    iree_hal_cuda_context_wrapper_t* context, const char* ptx_image,
+    iree_host_size_t ptx_length, CUmodule* out_module) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(ptx_image);
+  IREE_ASSERT_ARGUMENT(out_module);
+  *out_module = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  uint64_t ptx_hash = iree_hal_cuda_module_cache_hash(ptx_image, ptx_length);
+  char* path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_module_cache_entry_path(
+              cache, ptx_hash, context->host_allocator, &path));
+
+  iree_status_t status = iree_ok_status();
+  if (!iree_hal_cuda_module_cache_try_load(context, path, ptx_hash, ptx_length,
+                                           out_module)) {
+    status = iree_hal_cuda_module_cache_compile(context, path, ptx_hash,
+                                                ptx_image, ptx_length,
+                                                out_module);
+  }
+
+  iree_allocator_free(context->host_allocator, path);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
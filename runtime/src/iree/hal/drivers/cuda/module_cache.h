@@ -0,0 +1,55 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_MODULE_CACHE_H_
+#define IREE_HAL_DRIVERS_CUDA_MODULE_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Persistent on-disk cache of cubins produced by JIT compiling PTX.
+//
+// Entries are stored as individual files in a user-specified directory and
+// keyed by the hash of the PTX source, the compute capability of the device,
+// and the driver version so that driver upgrades invalidate stale code. Files
+// are written to a temporary path and renamed so that multiple processes may
+// share the directory.
+//
+// Thread-safe; the cache holds no mutable state.
+typedef struct iree_hal_cuda_module_cache_t {
+  // Directory containing cache entries.
+  iree_string_view_t path;
+  // Compute capability of the device, e.g. 80 for sm_80.
+  int sm_version;
+  // Version returned by cuDriverGetVersion.
+  int driver_version;
+} iree_hal_cuda_module_cache_t;
+
+// Initializes |out_cache| for the device in |context| storing entries in
+// |path|. |path| must remain valid for the lifetime of the cache.
+iree_status_t iree_hal_cuda_module_cache_initialize(
+    iree_hal_cuda_context_wrapper_t* context, iree_string_view_t path,
+    iree_hal_cuda_module_cache_t* out_cache);
+
+// Loads the module for the NUL-terminated |ptx_image| of |ptx_length|
+// characters. The cubin is loaded from the cache when present and otherwise
+// JIT compiled and stored in the cache. Failures reading or writing the cache
+// are ignored and only failures compiling or loading the module are returned.
+iree_status_t iree_hal_cuda_module_cache_load_module(
+    const iree_hal_cuda_module_cache_t* cache,
+    iree_hal_cuda_context_wrapper_t* context, const char* ptx_image,
+    iree_host_size_t ptx_length, CUmodule* out_module);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_MODULE_CACHE_H_
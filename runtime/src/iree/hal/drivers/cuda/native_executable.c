@@ -38,6 +38,7 @@ static iree_hal_cuda_native_executable_t* iree_hal_cuda_native_executable_cast(
 
 iree_status_t iree_hal_cuda_native_executable_create(
     iree_hal_cuda_context_wrapper_t* context,
+    const iree_hal_cuda_module_cache_t* module_cache,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(context);
@@ -66,17 +67,15 @@ iree_status_t iree_hal_cuda_native_executable_create(
   iree_host_size_t entry_point_count =
       flatbuffers_string_vec_len(entry_points_vec);
 
-  // Calculate the total number of characters across all entry point names. This
-  // is only required when tracing so that we can store copies of the names as
-  // the flatbuffer storing the strings may be released while the executable is
+  // Calculate the total number of characters across all entry point names so
+  // that we can store copies of the names for tracing and profiling as the
+  // flatbuffer storing the strings may be released while the executable is
   // still live.
   iree_host_size_t total_entry_point_name_chars = 0;
-  IREE_TRACE({
-    for (iree_host_size_t i = 0; i < entry_point_count; i++) {
-      const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
-      total_entry_point_name_chars += flatbuffers_string_len(entry_name);
-    }
-  });
+  for (iree_host_size_t i = 0; i < entry_point_count; i++) {
+    const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
+    total_entry_point_name_chars += flatbuffers_string_len(entry_name);
+  }
 
   // Create the kernel module.
   iree_host_size_t total_size =
@@ -85,10 +84,9 @@ iree_status_t iree_hal_cuda_native_executable_create(
       total_entry_point_name_chars;
   iree_status_t status = iree_allocator_malloc(context->host_allocator,
                                                total_size, (void**)&executable);
-  IREE_TRACE(
-      char* string_table_buffer =
-          (char*)((char*)executable + sizeof(*executable) +
-                  entry_point_count * sizeof(executable->entry_points[0])));
+  char* string_table_buffer =
+      (char*)((char*)executable + sizeof(*executable) +
+              entry_point_count * sizeof(executable->entry_points[0]));
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(&iree_hal_cuda_native_executable_vtable,
                                  &executable->resource);
@@ -96,10 +94,16 @@ iree_status_t iree_hal_cuda_native_executable_create(
 
     // Load the PTX image - this will fail if the device cannot handle the
     // contents. We could check this prior to creating
-    status = CU_RESULT_TO_STATUS(
-        context->syms,
-        cuModuleLoadDataEx(&executable->module, ptx_image, 0, NULL, NULL),
-        "cuModuleLoadDataEx");
+    if (module_cache) {
+      status = iree_hal_cuda_module_cache_load_module(
+          module_cache, context, ptx_image, flatbuffers_string_len(ptx_image),
+          &executable->module);
+    } else {
+      status = CU_RESULT_TO_STATUS(
+          context->syms,
+          cuModuleLoadDataEx(&executable->module, ptx_image, 0, NULL, NULL),
+          "cuModuleLoadDataEx");
+    }
   }
 
   if (iree_status_is_ok(status)) {
@@ -155,14 +159,13 @@ iree_status_t iree_hal_cuda_native_executable_create(
       params->block_size[2] = block_sizes_vec[i].z;
       params->shared_memory_size = shared_memory_sizes[i];
 
-      // Stash the entry point name in the string table for use when tracing.
-      IREE_TRACE({
-        iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
-        memcpy(string_table_buffer, entry_name, entry_name_length);
-        params->function_name =
-            iree_make_string_view(string_table_buffer, entry_name_length);
-        string_table_buffer += entry_name_length;
-      });
+      // Stash the entry point name in the string table for use when tracing
+      // and profiling.
+      iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
+      memcpy(string_table_buffer, entry_name, entry_name_length);
+      params->function_name =
+          iree_make_string_view(string_table_buffer, entry_name_length);
+      string_table_buffer += entry_name_length;
 
       IREE_TRACE({
         if (iree_hal_cuda_ExecutableDef_source_locations_is_present(
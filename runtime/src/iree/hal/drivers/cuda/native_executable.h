@@ -13,6 +13,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/module_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,15 +24,19 @@ typedef struct iree_hal_cuda_kernel_params_t {
   CUfunction function;
   uint32_t block_size[3];
   uint32_t shared_memory_size;
-  IREE_TRACE(iree_string_view_t function_name;)
+  // Name of the entry point used when tracing and profiling dispatches.
+  iree_string_view_t function_name;
   IREE_TRACE(iree_string_view_t source_filename;)
   IREE_TRACE(uint32_t source_line;)
 } iree_hal_cuda_kernel_params_t;
 
 // Creates an executable from a PTX module. The module may contain several
 // kernels that can be extracted along with the associated block size.
+// If |module_cache| is provided the JIT compiled module is loaded from and
+// stored to it.
 iree_status_t iree_hal_cuda_native_executable_create(
     iree_hal_cuda_context_wrapper_t* context,
+    const iree_hal_cuda_module_cache_t* module_cache,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable);
 
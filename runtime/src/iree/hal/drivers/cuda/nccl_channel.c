@@ -509,9 +509,109 @@ static iree_status_t iree_hal_cuda_nccl_submit_batch_entry(
   return iree_ok_status();
 }
 
+// Alignment of each bucket within the scratch allocation of a batch.
+#define IREE_HAL_CUDA_NCCL_BUCKET_ALIGNMENT 256
+
+// Returns the device pointer referenced by |binding|.
+static CUdeviceptr iree_hal_cuda_nccl_binding_device_pointer(
+    iree_hal_buffer_binding_t binding) {
+  return iree_hal_cuda_buffer_device_pointer(
+             iree_hal_buffer_allocated_buffer(binding.buffer)) +
+         iree_hal_buffer_byte_offset(binding.buffer) + binding.offset;
+}
+
+// Returns the size in bytes of the elements operated on by |entry|.
+static iree_device_size_t iree_hal_cuda_nccl_entry_byte_length(
+    const iree_hal_collective_batch_entry_t* entry) {
+  return entry->element_count *
+         iree_hal_collective_element_byte_count(entry->op.element_type);
+}
+
+// Returns the exclusive end index of the bucket starting at |start_index|.
+// Entries not fused with any others return |start_index| + 1.
+static iree_host_size_t iree_hal_cuda_nccl_bucket_end(
+    const iree_hal_cuda_nccl_bucketing_t* bucketing,
+    const iree_hal_collective_batch_t* batch, iree_host_size_t start_index) {
+  if (!bucketing || !bucketing->pool || !bucketing->bucket_size) {
+    return start_index + 1;
+  }
+  return iree_hal_collective_batch_bucket_end(batch, start_index,
+                                              bucketing->bucket_size);
+}
+
+// Copies the send buffers of all bucketed entries into |scratch| (|gather|) or
+// the bucketed results in |scratch| back out to the recv buffers (!|gather|).
+static iree_status_t iree_hal_cuda_nccl_copy_buckets(
+    iree_hal_cuda_context_wrapper_t* context,
+    const iree_hal_cuda_nccl_bucketing_t* bucketing,
+    const iree_hal_collective_batch_t* batch, CUdeviceptr scratch, bool gather,
+    CUstream stream) {
+  iree_device_size_t bucket_offset = 0;
+  for (iree_host_size_t i = 0; i < batch->count;) {
+    iree_host_size_t end = iree_hal_cuda_nccl_bucket_end(bucketing, batch, i);
+    if (end - i > 1) {
+      iree_device_size_t entry_offset = bucket_offset;
+      for (iree_host_size_t j = i; j < end; ++j) {
+        const iree_hal_collective_batch_entry_t* entry = &batch->entries[j];
+        iree_device_size_t byte_length =
+            iree_hal_cuda_nccl_entry_byte_length(entry);
+        CUdeviceptr bucket_ptr = scratch + entry_offset;
+        if (gather) {
+          CUDA_RETURN_IF_ERROR(
+              context->syms,
+              cuMemcpyAsync(bucket_ptr,
+                            iree_hal_cuda_nccl_binding_device_pointer(
+                                entry->send_binding),
+                            byte_length, stream),
+              "cuMemcpyAsync");
+        } else {
+          CUDA_RETURN_IF_ERROR(
+              context->syms,
+              cuMemcpyAsync(iree_hal_cuda_nccl_binding_device_pointer(
+                                entry->recv_binding),
+                            bucket_ptr, byte_length, stream),
+              "cuMemcpyAsync");
+        }
+        entry_offset += byte_length;
+      }
+      bucket_offset += iree_device_align(entry_offset - bucket_offset,
+                                         IREE_HAL_CUDA_NCCL_BUCKET_ALIGNMENT);
+    }
+    i = end;
+  }
+  return iree_ok_status();
+}
+
+// Issues a single in-place all-reduce over the |byte_length| bytes of a bucket
+// at |bucket_ptr| holding the fused entries starting with |first_entry|.
+static iree_status_t iree_hal_cuda_nccl_submit_bucket(
+    const iree_hal_collective_batch_entry_t* first_entry,
+    CUdeviceptr bucket_ptr, iree_device_size_t byte_length, CUstream stream) {
+  iree_hal_cuda_nccl_channel_t* channel =
+      iree_hal_cuda_nccl_channel_cast(first_entry->channel);
+  iree_hal_cuda_dynamic_symbols_t* syms = channel->context_wrapper->syms;
+  ncclComm_t comm = iree_hal_cuda_nccl_channel_comm(first_entry->channel);
+  ncclDataType_t datatype;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_get_nccl_data_type(
+      first_entry->op.element_type, &datatype));
+  ncclRedOp_t redop;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_get_nccl_red_type(first_entry->op.reduction, &redop));
+  iree_device_size_t element_count =
+      byte_length /
+      iree_hal_collective_element_byte_count(first_entry->op.element_type);
+  NCCL_RETURN_IF_ERROR(
+      syms,
+      ncclAllReduce((const void*)bucket_ptr, (void*)bucket_ptr, element_count,
+                    datatype, redop, comm, stream),
+      "ncclAllReduce");
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_cuda_nccl_submit_batch(
     iree_hal_cuda_context_wrapper_t* context,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    const iree_hal_cuda_nccl_bucketing_t* bucketing,
     const iree_hal_collective_batch_t* batch, CUstream stream) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(batch);
@@ -534,15 +634,69 @@ iree_status_t iree_hal_cuda_nccl_submit_batch(
   }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
 
+  // Size a single scratch allocation covering all buckets in the batch. Runs
+  // of small all-reduces are gathered into contiguous buckets so that each run
+  // is reduced with a single collective instead of one per entry.
+  iree_device_size_t scratch_size = 0;
+  for (iree_host_size_t i = 0; i < batch->count;) {
+    iree_host_size_t end = iree_hal_cuda_nccl_bucket_end(bucketing, batch, i);
+    if (end - i > 1) {
+      iree_device_size_t bucket_length = 0;
+      for (iree_host_size_t j = i; j < end; ++j) {
+        bucket_length +=
+            iree_hal_cuda_nccl_entry_byte_length(&batch->entries[j]);
+      }
+      scratch_size += iree_device_align(bucket_length,
+                                        IREE_HAL_CUDA_NCCL_BUCKET_ALIGNMENT);
+    }
+    i = end;
+  }
+
+  // Gather the inputs of all buckets. This must happen outside of the group as
+  // NCCL defers launching the grouped operations until ncclGroupEnd.
+  CUdeviceptr scratch = 0;
+  if (scratch_size > 0) {
+    CUDA_RETURN_IF_ERROR(context->syms,
+                         cuMemAllocFromPoolAsync(&scratch, scratch_size,
+                                                 bucketing->pool, stream),
+                         "cuMemAllocFromPoolAsync");
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_nccl_copy_buckets(
+        context, bucketing, batch, scratch, /*gather=*/true, stream));
+  }
+
   // Issue all collective operations in the batch as part of a group.
   // NCCL may be able to fuse or reduce overheads by issuing like this.
   NCCL_RETURN_IF_ERROR(context->syms, ncclGroupStart(), "ncclGroupStart");
-  for (iree_host_size_t i = 0; i < batch->count; ++i) {
-    IREE_RETURN_IF_ERROR(
-        iree_hal_cuda_nccl_submit_batch_entry(&batch->entries[i], stream));
+  iree_device_size_t bucket_offset = 0;
+  for (iree_host_size_t i = 0; i < batch->count;) {
+    iree_host_size_t end = iree_hal_cuda_nccl_bucket_end(bucketing, batch, i);
+    if (end - i > 1) {
+      iree_device_size_t bucket_length = 0;
+      for (iree_host_size_t j = i; j < end; ++j) {
+        bucket_length +=
+            iree_hal_cuda_nccl_entry_byte_length(&batch->entries[j]);
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_cuda_nccl_submit_bucket(
+          &batch->entries[i], scratch + bucket_offset, bucket_length, stream));
+      bucket_offset += iree_device_align(bucket_length,
+                                         IREE_HAL_CUDA_NCCL_BUCKET_ALIGNMENT);
+    } else {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_cuda_nccl_submit_batch_entry(&batch->entries[i], stream));
+    }
+    i = end;
   }
   NCCL_RETURN_IF_ERROR(context->syms, ncclGroupEnd(), "ncclGroupEnd");
 
+  // Scatter the reduced buckets back to their recv buffers and release the
+  // scratch allocation once the stream has consumed it.
+  if (scratch_size > 0) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_nccl_copy_buckets(
+        context, bucketing, batch, scratch, /*gather=*/false, stream));
+    CUDA_RETURN_IF_ERROR(context->syms, cuMemFreeAsync(scratch, stream),
+                         "cuMemFreeAsync");
+  }
+
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
   // End all zones we began above - note that these are just simply nested so
   // order doesn't matter so long as we end the right number of zones.
@@ -39,13 +39,26 @@ iree_status_t iree_hal_cuda_nccl_channel_create(
     const iree_hal_cuda_nccl_id_t* id, int rank, int count,
     iree_hal_channel_t** out_channel);
 
+// Controls fusion of small all-reduce operations in a batch into buckets.
+// Runs of fusible all-reduces are gathered into a contiguous bucket allocated
+// from |pool|, reduced in place with a single collective, and scattered back.
+typedef struct iree_hal_cuda_nccl_bucketing_t {
+  // Memory pool used for stream-ordered bucket allocations.
+  // Bucketing is disabled if NULL.
+  CUmemoryPool pool;
+  // Maximum size in bytes of a single bucket. Bucketing is disabled if 0.
+  iree_device_size_t bucket_size;
+} iree_hal_cuda_nccl_bucketing_t;
+
 // Performs a non-blocking submission of |batch| to |stream|.
 // The backing storage of |batch| is dropped immediately but all resources
 // referenced will be retained by the parent command buffer for its lifetime.
 // Note that operations in the batch may apply to different channels.
+// If |bucketing| is provided small all-reduce operations may be fused.
 iree_status_t iree_hal_cuda_nccl_submit_batch(
     iree_hal_cuda_context_wrapper_t* context,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    const iree_hal_cuda_nccl_bucketing_t* bucketing,
     const iree_hal_collective_batch_t* batch, CUstream stream);
 
 #ifdef __cplusplus
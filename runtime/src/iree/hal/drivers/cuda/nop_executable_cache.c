@@ -8,13 +8,19 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/module_cache.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
 
 typedef struct iree_hal_cuda_nop_executable_cache_t {
   iree_hal_resource_t resource;
   iree_hal_cuda_context_wrapper_t* context;
+  // Persistent cache of JIT compiled modules; only valid if
+  // |has_module_cache| is true. The path is stored in the trailing allocation.
+  bool has_module_cache;
+  iree_hal_cuda_module_cache_t module_cache;
 } iree_hal_cuda_nop_executable_cache_t;
 
 static const iree_hal_executable_cache_vtable_t
@@ -29,21 +35,39 @@ iree_hal_cuda_nop_executable_cache_cast(
 
 iree_status_t iree_hal_cuda_nop_executable_cache_create(
     iree_hal_cuda_context_wrapper_t* context, iree_string_view_t identifier,
+    iree_string_view_t module_cache_path,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   *out_executable_cache = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_cuda_nop_executable_cache_t* executable_cache = NULL;
-  iree_status_t status =
-      iree_allocator_malloc(context->host_allocator, sizeof(*executable_cache),
-                            (void**)&executable_cache);
+  iree_host_size_t total_size =
+      sizeof(*executable_cache) + module_cache_path.size;
+  iree_status_t status = iree_allocator_malloc(
+      context->host_allocator, total_size, (void**)&executable_cache);
   if (iree_status_is_ok(status)) {
+    memset(executable_cache, 0, total_size);
     iree_hal_resource_initialize(&iree_hal_cuda_nop_executable_cache_vtable,
                                  &executable_cache->resource);
     executable_cache->context = context;
+  }
+
+  if (iree_status_is_ok(status) &&
+      !iree_string_view_is_empty(module_cache_path)) {
+    iree_string_view_t path = iree_string_view_empty();
+    iree_string_view_append_to_buffer(
+        module_cache_path, &path,
+        (char*)executable_cache + sizeof(*executable_cache));
+    status = iree_hal_cuda_module_cache_initialize(
+        context, path, &executable_cache->module_cache);
+    executable_cache->has_module_cache = iree_status_is_ok(status);
+  }
 
+  if (iree_status_is_ok(status)) {
     *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
+  } else {
+    iree_allocator_free(context->host_allocator, executable_cache);
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -76,7 +100,10 @@ static iree_status_t iree_hal_cuda_nop_executable_cache_prepare_executable(
   iree_hal_cuda_nop_executable_cache_t* executable_cache =
       iree_hal_cuda_nop_executable_cache_cast(base_executable_cache);
   return iree_hal_cuda_native_executable_create(
-      executable_cache->context, executable_params, out_executable);
+      executable_cache->context,
+      executable_cache->has_module_cache ? &executable_cache->module_cache
+                                         : NULL,
+      executable_params, out_executable);
 }
 
 static const iree_hal_executable_cache_vtable_t
@@ -15,11 +15,16 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
+// Creates an executable cache that does not cache executables in memory.
 // This is useful to isolate pipeline caching behavior and verify compilation
 // behavior.
+//
+// If |module_cache_path| is non-empty it names a directory used to persist the
+// cubins produced by JIT compiling PTX so that subsequent processes can skip
+// compilation. See iree_hal_cuda_module_cache_t.
 iree_status_t iree_hal_cuda_nop_executable_cache_create(
     iree_hal_cuda_context_wrapper_t* context, iree_string_view_t identifier,
+    iree_string_view_t module_cache_path,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
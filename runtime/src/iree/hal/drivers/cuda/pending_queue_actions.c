@@ -0,0 +1,710 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/pending_queue_actions.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/hal/drivers/cuda/event_semaphore.h"
+#include "iree/hal/drivers/cuda/graph_command_buffer.h"
+#include "iree/hal/drivers/cuda/status_util.h"
+#include "iree/hal/drivers/cuda/stream_command_buffer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/semaphore_base.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_queue_action_t
+//===----------------------------------------------------------------------===//
+
+// State tracked for each semaphore an action waits on.
+typedef struct iree_hal_cuda_queue_action_wait_t {
+  // Host timepoint that requests a new issue scan when the wait is reached.
+  // Only valid when |timepoint_armed| is set. Once armed the timepoint is
+  // either issued by the semaphore or cancelled when the action is retired.
+  iree_hal_semaphore_timepoint_t timepoint;
+  bool timepoint_armed;
+  // Device event the stream must wait on before executing the action or NULL
+  // if the wait has been reached on the host. Only valid while issuing.
+  iree_hal_cuda_pooled_event_t* event;
+} iree_hal_cuda_queue_action_wait_t;
+
+typedef struct iree_hal_cuda_queue_action_t {
+  // Intrusive singly-linked list next entry pointer. Owned by whichever list
+  // the action is in.
+  struct iree_hal_cuda_queue_action_t* next;
+
+  // The pending actions queue that owns this action.
+  iree_hal_cuda_pending_queue_actions_t* owner;
+
+  // Arena the action and all of its lists are allocated from.
+  iree_arena_allocator_t arena;
+
+  CUstream stream;
+  iree_hal_command_buffer_t* stream_command_buffer;
+
+  // Retained command buffers to execute.
+  iree_host_size_t command_buffer_count;
+  iree_hal_command_buffer_t** command_buffers;
+
+  // Retained semaphores to wait on and signal.
+  iree_hal_semaphore_list_t wait_semaphore_list;
+  iree_hal_semaphore_list_t signal_semaphore_list;
+  iree_hal_cuda_queue_action_wait_t* waits;
+} iree_hal_cuda_queue_action_t;
+
+// A FIFO list of actions.
+typedef struct iree_hal_cuda_queue_action_list_t {
+  iree_hal_cuda_queue_action_t* head;
+  iree_hal_cuda_queue_action_t* tail;
+} iree_hal_cuda_queue_action_list_t;
+
+static void iree_hal_cuda_queue_action_list_push_back(
+    iree_hal_cuda_queue_action_list_t* list,
+    iree_hal_cuda_queue_action_t* action) {
+  action->next = NULL;
+  if (list->tail) {
+    list->tail->next = action;
+  } else {
+    list->head = action;
+  }
+  list->tail = action;
+}
+
+// Copies |in_list| into |arena| and retains all semaphores in it.
+static iree_status_t iree_hal_cuda_copy_semaphore_list(
+    iree_hal_semaphore_list_t in_list, iree_arena_allocator_t* arena,
+    iree_hal_semaphore_list_t* out_list) {
+  memset(out_list, 0, sizeof(*out_list));
+  if (!in_list.count) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      arena, in_list.count * sizeof(in_list.semaphores[0]),
+      (void**)&out_list->semaphores));
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      arena, in_list.count * sizeof(in_list.payload_values[0]),
+      (void**)&out_list->payload_values));
+  memcpy(out_list->semaphores, in_list.semaphores,
+         in_list.count * sizeof(in_list.semaphores[0]));
+  memcpy(out_list->payload_values, in_list.payload_values,
+         in_list.count * sizeof(in_list.payload_values[0]));
+  out_list->count = in_list.count;
+  for (iree_host_size_t i = 0; i < in_list.count; ++i) {
+    iree_hal_semaphore_retain(in_list.semaphores[i]);
+  }
+  return iree_ok_status();
+}
+
+// Releases all semaphores in |list| retained by
+// iree_hal_cuda_copy_semaphore_list.
+static void iree_hal_cuda_release_semaphore_list(
+    iree_hal_semaphore_list_t* list) {
+  for (iree_host_size_t i = 0; i < list->count; ++i) {
+    iree_hal_semaphore_release(list->semaphores[i]);
+  }
+  list->count = 0;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_pending_queue_actions_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_cuda_pending_queue_actions_t {
+  iree_hal_cuda_context_wrapper_t* context;
+  iree_hal_cuda_event_pool_t* event_pool;
+  iree_hal_cuda_tracing_context_t* tracing_context;
+  iree_arena_block_pool_t* block_pool;
+
+  // Guards the pending list and serializes issuing actions so that replays
+  // into shared stream command buffers and tracing never overlap.
+  iree_slim_mutex_t action_mutex;
+  // Actions waiting to be issued in submission order.
+  iree_hal_cuda_queue_action_list_t pending_list IREE_GUARDED_BY(action_mutex);
+
+  // Guards the completed list. Only held briefly as it is acquired from CUDA
+  // host function callbacks.
+  iree_slim_mutex_t completion_mutex;
+  // Issued actions whose work has completed on their stream.
+  iree_hal_cuda_queue_action_list_t completed_list
+      IREE_GUARDED_BY(completion_mutex);
+
+  // Number of actions issued but not yet retired.
+  iree_atomic_int32_t in_flight_count;
+
+  // Set when the worker has completions to retire or pending actions may
+  // have become ready.
+  iree_atomic_int32_t worker_requested;
+  // Set when the worker should exit once all in-flight actions have retired.
+  iree_atomic_int32_t exit_requested;
+  // Notified whenever one of the request flags is set.
+  iree_notification_t worker_notification;
+
+  // Worker thread retiring completed actions and issuing unblocked ones.
+  iree_thread_t* worker_thread;
+};
+
+// Wakes the worker to retire completions and scan for ready actions.
+static void iree_hal_cuda_pending_queue_actions_request_worker(
+    iree_hal_cuda_pending_queue_actions_t* actions) {
+  iree_atomic_store_int32(&actions->worker_requested, 1,
+                          iree_memory_order_release);
+  iree_notification_post(&actions->worker_notification, IREE_ALL_WAITERS);
+}
+
+// Handles a wait timepoint being reached (or failing) by requesting a scan.
+// Called from whichever thread signals the semaphore under its timepoint lock
+// and must not manage timepoints or touch the action.
+static iree_status_t iree_hal_cuda_queue_action_wait_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_cuda_pending_queue_actions_request_worker(
+      (iree_hal_cuda_pending_queue_actions_t*)user_data);
+  return iree_ok_status();
+}
+
+// Handles the work of an issued action completing on its stream.
+// Called from a CUDA driver thread that must not make any CUDA API calls so
+// this only hands the action to the worker.
+static void CUDA_CB iree_hal_cuda_queue_action_host_callback(void* user_data) {
+  iree_hal_cuda_queue_action_t* action =
+      (iree_hal_cuda_queue_action_t*)user_data;
+  iree_hal_cuda_pending_queue_actions_t* actions = action->owner;
+  // The worker is requested under the lock so that it cannot retire the action
+  // (and possibly destroy |actions|) before this callback is done with it.
+  iree_slim_mutex_lock(&actions->completion_mutex);
+  iree_hal_cuda_queue_action_list_push_back(&actions->completed_list, action);
+  iree_hal_cuda_pending_queue_actions_request_worker(actions);
+  iree_slim_mutex_unlock(&actions->completion_mutex);
+}
+
+// Releases all resources held by |action| and frees it.
+// Must not be called with the action mutex held as releasing resources may
+// re-entrantly signal semaphores.
+static void iree_hal_cuda_queue_action_free(
+    iree_hal_cuda_queue_action_t* action) {
+  for (iree_host_size_t i = 0; i < action->wait_semaphore_list.count; ++i) {
+    if (action->waits[i].timepoint_armed) {
+      iree_hal_semaphore_cancel_timepoint(
+          action->wait_semaphore_list.semaphores[i],
+          &action->waits[i].timepoint);
+    }
+  }
+  iree_hal_cuda_release_semaphore_list(&action->wait_semaphore_list);
+  iree_hal_cuda_release_semaphore_list(&action->signal_semaphore_list);
+  for (iree_host_size_t i = 0; i < action->command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(action->command_buffers[i]);
+  }
+  iree_arena_allocator_t arena = action->arena;
+  iree_arena_deinitialize(&arena);
+}
+
+// Fails the signal semaphores of |action| with |status| and frees it.
+static void iree_hal_cuda_queue_action_fail(
+    iree_hal_cuda_queue_action_t* action, iree_status_t status) {
+  iree_hal_semaphore_list_fail(action->signal_semaphore_list, status);
+  iree_hal_cuda_queue_action_free(action);
+}
+
+// Results of checking whether an action can be issued.
+typedef enum iree_hal_cuda_queue_action_readiness_e {
+  // At least one wait can be resolved neither on the host nor on the device.
+  IREE_HAL_CUDA_QUEUE_ACTION_BLOCKED = 0,
+  // All waits are resolved and |waits[].event| holds the events to wait on.
+  IREE_HAL_CUDA_QUEUE_ACTION_READY,
+  // A wait semaphore failed and the action must be failed.
+  IREE_HAL_CUDA_QUEUE_ACTION_FAILED,
+} iree_hal_cuda_queue_action_readiness_t;
+
+static void iree_hal_cuda_queue_action_release_wait_events(
+    iree_hal_cuda_queue_action_t* action) {
+  for (iree_host_size_t i = 0; i < action->wait_semaphore_list.count; ++i) {
+    if (action->waits[i].event) {
+      iree_hal_cuda_pooled_event_release(action->waits[i].event);
+      action->waits[i].event = NULL;
+    }
+  }
+}
+
+// Checks whether all waits of |action| can be resolved. Waits not yet reached
+// on the host use an event recorded by an already issued action; waits with
+// neither arm a host timepoint (once) so the action is scanned again when the
+// semaphore is signaled.
+static iree_hal_cuda_queue_action_readiness_t
+iree_hal_cuda_queue_action_check_readiness(
+    iree_hal_cuda_queue_action_t* action, iree_status_t* out_status) {
+  *out_status = iree_ok_status();
+  iree_hal_cuda_queue_action_readiness_t readiness =
+      IREE_HAL_CUDA_QUEUE_ACTION_READY;
+  for (iree_host_size_t i = 0; i < action->wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = action->wait_semaphore_list.semaphores[i];
+    uint64_t minimum_value = action->wait_semaphore_list.payload_values[i];
+    iree_hal_cuda_queue_action_wait_t* wait = &action->waits[i];
+
+    uint64_t current_value = 0;
+    iree_status_t status = iree_hal_semaphore_query(semaphore, &current_value);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_cuda_queue_action_release_wait_events(action);
+      *out_status = status;
+      return IREE_HAL_CUDA_QUEUE_ACTION_FAILED;
+    }
+    if (current_value >= minimum_value) continue;
+
+    if (!wait->event && iree_hal_cuda_semaphore_isa(semaphore)) {
+      wait->event =
+          iree_hal_cuda_semaphore_acquire_device_wait(semaphore, minimum_value);
+    }
+    if (wait->event) continue;
+
+    readiness = IREE_HAL_CUDA_QUEUE_ACTION_BLOCKED;
+    if (!wait->timepoint_armed) {
+      wait->timepoint_armed = true;
+      iree_hal_semaphore_acquire_timepoint(
+          semaphore, minimum_value, iree_infinite_timeout(),
+          (iree_hal_semaphore_callback_t){
+              .fn = iree_hal_cuda_queue_action_wait_callback,
+              .user_data = action->owner,
+          },
+          &wait->timepoint);
+      // The semaphore may have been signaled after it was queried above and
+      // before the timepoint was acquired; semaphores from other devices only
+      // notify timepoints when signaled so poll to resolve it in that case.
+      iree_hal_semaphore_poll(semaphore);
+    }
+  }
+  return readiness;
+}
+
+// Issues |action| to its stream. On failure nothing is enqueued after the
+// failing operation and the caller must fail the action.
+static iree_status_t iree_hal_cuda_queue_action_issue(
+    iree_hal_cuda_queue_action_t* action) {
+  iree_hal_cuda_pending_queue_actions_t* actions = action->owner;
+  iree_hal_cuda_dynamic_symbols_t* syms = actions->context->syms;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Chain on to the work of previously issued actions on the device.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < action->wait_semaphore_list.count && iree_status_is_ok(status);
+       ++i) {
+    if (!action->waits[i].event) continue;
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuStreamWaitEvent(action->stream,
+                          iree_hal_cuda_pooled_event_handle(
+                              action->waits[i].event),
+                          CU_EVENT_WAIT_DEFAULT),
+        "cuStreamWaitEvent");
+  }
+  iree_hal_cuda_queue_action_release_wait_events(action);
+
+  for (iree_host_size_t i = 0;
+       i < action->command_buffer_count && iree_status_is_ok(status); ++i) {
+    iree_hal_command_buffer_t* command_buffer = action->command_buffers[i];
+    if (iree_hal_cuda_stream_command_buffer_isa(command_buffer)) {
+      // Nothing to do for an inline command buffer; all the work has already
+      // been submitted. If there were waits we wouldn't have been able to
+      // execute inline!
+    } else if (iree_hal_cuda_graph_command_buffer_isa(command_buffer)) {
+      CUgraphExec exec =
+          iree_hal_cuda_graph_command_buffer_handle(command_buffer);
+      status = CU_RESULT_TO_STATUS(syms, cuGraphLaunch(exec, action->stream),
+                                   "cuGraphLaunch");
+    } else {
+      // The stream command buffer stages update data such that it may be
+      // reset as soon as the replay returns and the deferred command buffer
+      // retains all resources used by the commands.
+      status = iree_hal_deferred_command_buffer_apply(
+          command_buffer, action->stream_command_buffer,
+          iree_hal_buffer_binding_table_empty());
+    }
+  }
+
+  // Record an event for each signal so that subsequent actions can wait on
+  // the device. Events are only published after being recorded as waits
+  // issued before the record would not wait at all.
+  for (iree_host_size_t i = 0;
+       i < action->signal_semaphore_list.count && iree_status_is_ok(status);
+       ++i) {
+    iree_hal_semaphore_t* semaphore =
+        action->signal_semaphore_list.semaphores[i];
+    if (!iree_hal_cuda_semaphore_isa(semaphore)) continue;
+    iree_hal_cuda_pooled_event_t* event = NULL;
+    status = iree_hal_cuda_event_pool_acquire(actions->event_pool, 1, &event);
+    if (!iree_status_is_ok(status)) break;
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuEventRecord(iree_hal_cuda_pooled_event_handle(event), action->stream),
+        "cuEventRecord");
+    if (iree_status_is_ok(status)) {
+      iree_hal_cuda_semaphore_notify_device_signal(
+          semaphore, action->signal_semaphore_list.payload_values[i], event);
+    }
+    iree_hal_cuda_pooled_event_release(event);
+  }
+
+  // Observe completion on the host to signal the semaphores. Host functions
+  // execute in stream order after all prior work on the stream.
+  if (iree_status_is_ok(status)) {
+    iree_atomic_fetch_add_int32(&actions->in_flight_count, 1,
+                                iree_memory_order_acq_rel);
+    status = CU_RESULT_TO_STATUS(
+        syms,
+        cuLaunchHostFunc(action->stream,
+                         iree_hal_cuda_queue_action_host_callback, action),
+        "cuLaunchHostFunc");
+    if (!iree_status_is_ok(status)) {
+      iree_atomic_fetch_sub_int32(&actions->in_flight_count, 1,
+                                  iree_memory_order_acq_rel);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Issues all pending actions that are ready in submission order. Issuing an
+// action publishes device signals that may make later actions ready so the
+// list is scanned until no more progress is made.
+static void iree_hal_cuda_pending_queue_actions_issue_ready(
+    iree_hal_cuda_pending_queue_actions_t* actions) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Actions failed while scanning are released outside of the lock as failing
+  // semaphores may re-entrantly request issues.
+  iree_hal_cuda_queue_action_t* failed_head = NULL;
+
+  iree_slim_mutex_lock(&actions->action_mutex);
+  bool made_progress = true;
+  while (made_progress) {
+    made_progress = false;
+    iree_hal_cuda_queue_action_list_t remaining_list = {NULL, NULL};
+    iree_hal_cuda_queue_action_t* action = actions->pending_list.head;
+    while (action) {
+      iree_hal_cuda_queue_action_t* next_action = action->next;
+      iree_status_t status = iree_ok_status();
+      iree_hal_cuda_queue_action_readiness_t readiness =
+          iree_hal_cuda_queue_action_check_readiness(action, &status);
+      if (readiness == IREE_HAL_CUDA_QUEUE_ACTION_READY) {
+        status = iree_hal_cuda_queue_action_issue(action);
+        readiness = iree_status_is_ok(status)
+                        ? IREE_HAL_CUDA_QUEUE_ACTION_READY
+                        : IREE_HAL_CUDA_QUEUE_ACTION_FAILED;
+        made_progress = true;
+      }
+      if (readiness == IREE_HAL_CUDA_QUEUE_ACTION_BLOCKED) {
+        iree_hal_cuda_queue_action_list_push_back(&remaining_list, action);
+      } else if (readiness == IREE_HAL_CUDA_QUEUE_ACTION_FAILED) {
+        action->next = failed_head;
+        failed_head = action;
+        iree_hal_semaphore_list_fail(action->signal_semaphore_list, status);
+        made_progress = true;
+      }
+      action = next_action;
+    }
+    actions->pending_list = remaining_list;
+  }
+  iree_slim_mutex_unlock(&actions->action_mutex);
+
+  while (failed_head) {
+    iree_hal_cuda_queue_action_t* next_action = failed_head->next;
+    iree_hal_cuda_queue_action_free(failed_head);
+    failed_head = next_action;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Signals the semaphores of issued actions that completed and frees them.
+// Returns true if any action was retired.
+static bool iree_hal_cuda_pending_queue_actions_retire_completed(
+    iree_hal_cuda_pending_queue_actions_t* actions) {
+  iree_slim_mutex_lock(&actions->completion_mutex);
+  iree_hal_cuda_queue_action_t* action = actions->completed_list.head;
+  actions->completed_list.head = NULL;
+  actions->completed_list.tail = NULL;
+  iree_slim_mutex_unlock(&actions->completion_mutex);
+  if (!action) return false;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  while (action) {
+    iree_hal_cuda_queue_action_t* next_action = action->next;
+    iree_status_t status =
+        iree_hal_semaphore_list_signal(action->signal_semaphore_list);
+    if (iree_status_is_ok(status)) {
+      iree_hal_cuda_queue_action_free(action);
+    } else {
+      iree_hal_cuda_queue_action_fail(action, status);
+    }
+    iree_atomic_fetch_sub_int32(&actions->in_flight_count, 1,
+                                iree_memory_order_acq_rel);
+    action = next_action;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return true;
+}
+
+// Returns true if exit was requested and all issued actions have retired.
+static bool iree_hal_cuda_pending_queue_actions_worker_can_exit(
+    iree_hal_cuda_pending_queue_actions_t* actions) {
+  return iree_atomic_load_int32(&actions->exit_requested,
+                                iree_memory_order_acquire) != 0 &&
+         iree_atomic_load_int32(&actions->in_flight_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+// Returns true if the worker has been requested or can exit.
+static bool iree_hal_cuda_pending_queue_actions_worker_has_work(void* arg) {
+  iree_hal_cuda_pending_queue_actions_t* actions =
+      (iree_hal_cuda_pending_queue_actions_t*)arg;
+  return iree_atomic_load_int32(&actions->worker_requested,
+                                iree_memory_order_acquire) != 0 ||
+         iree_hal_cuda_pending_queue_actions_worker_can_exit(actions);
+}
+
+static int iree_hal_cuda_pending_queue_actions_worker_main(void* entry_arg) {
+  iree_hal_cuda_pending_queue_actions_t* actions =
+      (iree_hal_cuda_pending_queue_actions_t*)entry_arg;
+
+  // Issuing and releasing command buffers may make CUDA calls.
+  IREE_IGNORE_ERROR(CU_RESULT_TO_STATUS(
+      actions->context->syms, cuCtxSetCurrent(actions->context->cu_context),
+      "cuCtxSetCurrent"));
+
+  while (true) {
+    iree_notification_await(&actions->worker_notification,
+                            iree_hal_cuda_pending_queue_actions_worker_has_work,
+                            actions, iree_infinite_timeout());
+    iree_atomic_store_int32(&actions->worker_requested, 0,
+                            iree_memory_order_release);
+
+    // Signaling semaphores of completed actions is what unblocks most pending
+    // actions so retire first and then scan.
+    if (iree_hal_cuda_pending_queue_actions_retire_completed(actions)) {
+      iree_slim_mutex_lock(&actions->action_mutex);
+      iree_hal_cuda_tracing_context_collect(actions->tracing_context);
+      iree_slim_mutex_unlock(&actions->action_mutex);
+    }
+    iree_hal_cuda_pending_queue_actions_issue_ready(actions);
+
+    if (iree_hal_cuda_pending_queue_actions_worker_can_exit(actions)) break;
+  }
+  return 0;
+}
+
+iree_status_t iree_hal_cuda_pending_queue_actions_create(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_event_pool_t* event_pool,
+    iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_arena_block_pool_t* block_pool,
+    iree_hal_cuda_pending_queue_actions_t** out_actions) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(event_pool);
+  IREE_ASSERT_ARGUMENT(block_pool);
+  IREE_ASSERT_ARGUMENT(out_actions);
+  *out_actions = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_pending_queue_actions_t* actions = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(context->host_allocator, sizeof(*actions),
+                                (void**)&actions));
+  memset(actions, 0, sizeof(*actions));
+  actions->context = context;
+  actions->event_pool = event_pool;
+  iree_hal_cuda_event_pool_retain(event_pool);
+  actions->tracing_context = tracing_context;
+  actions->block_pool = block_pool;
+  iree_slim_mutex_initialize(&actions->action_mutex);
+  iree_slim_mutex_initialize(&actions->completion_mutex);
+  iree_notification_initialize(&actions->worker_notification);
+
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = iree_make_cstring_view("iree-cuda-queue-worker");
+  iree_status_t status = iree_thread_create(
+      iree_hal_cuda_pending_queue_actions_worker_main, actions, thread_params,
+      context->host_allocator, &actions->worker_thread);
+
+  if (iree_status_is_ok(status)) {
+    *out_actions = actions;
+  } else {
+    iree_hal_cuda_pending_queue_actions_destroy(actions);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_pending_queue_actions_destroy(
+    iree_hal_cuda_pending_queue_actions_t* actions) {
+  if (!actions) return;
+  iree_allocator_t host_allocator = actions->context->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Let the worker retire all remaining completions and join it.
+  if (actions->worker_thread) {
+    iree_atomic_store_int32(&actions->exit_requested, 1,
+                            iree_memory_order_release);
+    iree_notification_post(&actions->worker_notification, IREE_ALL_WAITERS);
+    iree_thread_release(actions->worker_thread);
+  }
+
+  // Anything still pending can never be issued.
+  iree_hal_cuda_queue_action_t* action = actions->pending_list.head;
+  actions->pending_list.head = NULL;
+  actions->pending_list.tail = NULL;
+  while (action) {
+    iree_hal_cuda_queue_action_t* next_action = action->next;
+    iree_hal_cuda_queue_action_release_wait_events(action);
+    iree_hal_cuda_queue_action_fail(
+        action, iree_make_status(IREE_STATUS_CANCELLED,
+                                 "device destroyed with pending submissions"));
+    action = next_action;
+  }
+
+  iree_notification_deinitialize(&actions->worker_notification);
+  iree_slim_mutex_deinitialize(&actions->completion_mutex);
+  iree_slim_mutex_deinitialize(&actions->action_mutex);
+  iree_hal_cuda_event_pool_release(actions->event_pool);
+  iree_allocator_free(host_allocator, actions);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_pending_queue_actions_enqueue_execution(
+    iree_hal_cuda_pending_queue_actions_t* actions, CUstream stream,
+    iree_hal_command_buffer_t* stream_command_buffer,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers) {
+  IREE_ASSERT_ARGUMENT(actions);
+  IREE_ASSERT_ARGUMENT(!command_buffer_count || command_buffers);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(actions->block_pool, &arena);
+
+  // The action is allocated from its own arena; copy the arena into it once
+  // all other allocations are made so the copy includes them.
+  iree_hal_cuda_queue_action_t* action = NULL;
+  iree_status_t status =
+      iree_arena_allocate(&arena, sizeof(*action), (void**)&action);
+  iree_host_size_t waits_size =
+      wait_semaphore_list.count * sizeof(action->waits[0]);
+  void* waits = NULL;
+  if (iree_status_is_ok(status) && waits_size > 0) {
+    status = iree_arena_allocate(&arena, waits_size, &waits);
+  }
+  iree_hal_command_buffer_t** command_buffers_copy = NULL;
+  if (iree_status_is_ok(status) && command_buffer_count > 0) {
+    status = iree_arena_allocate(
+        &arena, command_buffer_count * sizeof(command_buffers_copy[0]),
+        (void**)&command_buffers_copy);
+  }
+  iree_hal_semaphore_list_t wait_list = {0};
+  iree_hal_semaphore_list_t signal_list = {0};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_copy_semaphore_list(wait_semaphore_list, &arena,
+                                               &wait_list);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_copy_semaphore_list(signal_semaphore_list, &arena,
+                                               &signal_list);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_cuda_release_semaphore_list(&wait_list);
+    }
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_arena_deinitialize(&arena);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  memset(action, 0, sizeof(*action));
+  action->owner = actions;
+  action->stream = stream;
+  action->stream_command_buffer = stream_command_buffer;
+  action->command_buffer_count = command_buffer_count;
+  action->command_buffers = command_buffers_copy;
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    command_buffers_copy[i] = command_buffers[i];
+    iree_hal_command_buffer_retain(command_buffers[i]);
+  }
+  action->wait_semaphore_list = wait_list;
+  action->signal_semaphore_list = signal_list;
+  action->waits = (iree_hal_cuda_queue_action_wait_t*)waits;
+  if (waits) memset(waits, 0, waits_size);
+  action->arena = arena;
+
+  iree_slim_mutex_lock(&actions->action_mutex);
+  iree_hal_cuda_queue_action_list_push_back(&actions->pending_list, action);
+  iree_slim_mutex_unlock(&actions->action_mutex);
+
+  // Issue immediately from the submitting thread when possible to avoid the
+  // latency of handing off to the worker.
+  iree_hal_cuda_pending_queue_actions_issue_ready(actions);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_pending_queue_actions_try_wait_on_stream(
+    iree_hal_cuda_pending_queue_actions_t* actions, CUstream stream,
+    const iree_hal_semaphore_list_t wait_semaphore_list, bool* out_waited) {
+  IREE_ASSERT_ARGUMENT(actions);
+  IREE_ASSERT_ARGUMENT(out_waited);
+  *out_waited = false;
+  if (!wait_semaphore_list.count) {
+    *out_waited = true;
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_pooled_event_t** events =
+      (iree_hal_cuda_pooled_event_t**)iree_alloca(
+          wait_semaphore_list.count * sizeof(events[0]));
+  memset(events, 0, wait_semaphore_list.count * sizeof(events[0]));
+
+  // Resolve all waits before enqueuing any so that nothing is enqueued if the
+  // caller has to fall back to a host wait.
+  iree_status_t status = iree_ok_status();
+  bool resolved = true;
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count && resolved;
+       ++i) {
+    iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+    uint64_t minimum_value = wait_semaphore_list.payload_values[i];
+    uint64_t current_value = 0;
+    status = iree_hal_semaphore_query(semaphore, &current_value);
+    if (!iree_status_is_ok(status)) break;
+    if (current_value >= minimum_value) continue;
+    if (iree_hal_cuda_semaphore_isa(semaphore)) {
+      events[i] =
+          iree_hal_cuda_semaphore_acquire_device_wait(semaphore, minimum_value);
+    }
+    resolved = events[i] != NULL;
+  }
+
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    if (!events[i]) continue;
+    if (iree_status_is_ok(status) && resolved) {
+      status = CU_RESULT_TO_STATUS(
+          actions->context->syms,
+          cuStreamWaitEvent(stream,
+                            iree_hal_cuda_pooled_event_handle(events[i]),
+                            CU_EVENT_WAIT_DEFAULT),
+          "cuStreamWaitEvent");
+    }
+    iree_hal_cuda_pooled_event_release(events[i]);
+  }
+  *out_waited = iree_status_is_ok(status) && resolved;
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,85 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_PENDING_QUEUE_ACTIONS_H_
+#define IREE_HAL_DRIVERS_CUDA_PENDING_QUEUE_ACTIONS_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/context_wrapper.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/event_pool.h"
+#include "iree/hal/drivers/cuda/tracing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A scheduler of queue actions that defers them until their waits resolve
+// without blocking the submitting thread.
+//
+// Actions are issued to their stream as soon as every wait is either already
+// satisfied on the host or can be waited on by the device with an event
+// recorded by a previously issued action. Issued actions record events for
+// their signals so that subsequent actions can chain on them entirely on the
+// device. Completion is observed with a host function enqueued after the
+// action that hands the action to a worker thread; the worker signals the
+// semaphores on the host, releases resources, and issues actions unblocked by
+// the signals.
+//
+// Thread-safe; multiple threads may enqueue actions concurrently.
+typedef struct iree_hal_cuda_pending_queue_actions_t
+    iree_hal_cuda_pending_queue_actions_t;
+
+// Creates a pending actions queue and its worker thread.
+//
+// |event_pool| provides the events used to chain actions on the device and is
+// retained for the lifetime of the queue. The optional |tracing_context| is
+// collected as actions complete.
+iree_status_t iree_hal_cuda_pending_queue_actions_create(
+    iree_hal_cuda_context_wrapper_t* context,
+    iree_hal_cuda_event_pool_t* event_pool,
+    iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_arena_block_pool_t* block_pool,
+    iree_hal_cuda_pending_queue_actions_t** out_actions);
+
+// Destroys the pending |actions| queue.
+//
+// All issued actions must have been completed on their streams. Actions still
+// waiting to be issued are discarded and their signal semaphores are failed
+// with IREE_STATUS_CANCELLED.
+void iree_hal_cuda_pending_queue_actions_destroy(
+    iree_hal_cuda_pending_queue_actions_t* actions);
+
+// Enqueues an action executing |command_buffers| on |stream| after
+// |wait_semaphore_list| is reached and signaling |signal_semaphore_list| once
+// complete.
+//
+// Deferred command buffers are replayed into |stream_command_buffer| which
+// must issue work on |stream| and is only used by this queue. The action may
+// be issued before this returns.
+iree_status_t iree_hal_cuda_pending_queue_actions_enqueue_execution(
+    iree_hal_cuda_pending_queue_actions_t* actions, CUstream stream,
+    iree_hal_command_buffer_t* stream_command_buffer,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers);
+
+// Makes |stream| wait on |wait_semaphore_list| on the device without blocking
+// the host. Sets |out_waited| to false without enqueuing any work if some
+// semaphore has neither been reached nor had a device signal issued for it, in
+// which case the caller must wait on the host instead.
+iree_status_t iree_hal_cuda_pending_queue_actions_try_wait_on_stream(
+    iree_hal_cuda_pending_queue_actions_t* actions, CUstream stream,
+    const iree_hal_semaphore_list_t wait_semaphore_list, bool* out_waited);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_PENDING_QUEUE_ACTIONS_H_
@@ -34,6 +34,44 @@ IREE_FLAG(
     bool, cuda_async_allocations, true,
     "Enables CUDA asynchronous stream-ordered allocations when supported.");
 
+IREE_FLAG(
+    int64_t, cuda_device_local_pool_minimum_capacity, 0,
+    "Bytes reserved in the device-local CUDA memory pool at device creation\n"
+    "and retained when the device is trimmed.");
+
+IREE_FLAG(
+    int64_t, cuda_device_local_pool_release_threshold, -1,
+    "Bytes the device-local CUDA memory pool retains across synchronizations.\n"
+    "-1 retains all memory until the device is trimmed.");
+
+IREE_FLAG(
+    int32_t, cuda_host_registration_cache_capacity, 0,
+    "Number of idle cuMemHostRegister registrations of imported host memory\n"
+    "retained for reuse. Imported host memory must then remain allocated\n"
+    "until the device is trimmed or destroyed.");
+
+IREE_FLAG(bool, cuda_per_queue_memory_pools, false,
+          "Uses separate CUDA memory pools for each queue.");
+
+IREE_FLAG(
+    int64_t, cuda_collective_bucket_size, 0,
+    "Maximum bytes of small all-reduces fused into a single NCCL all-reduce\n"
+    "when using stream command buffers. 0 disables fusion.");
+
+IREE_FLAG(
+    int32_t, cuda_concurrent_stream_count, 4,
+    "Number of CUDA streams used to execute independent commands between\n"
+    "barriers concurrently. 1 executes all commands in order.");
+
+IREE_FLAG(
+    int32_t, cuda_graph_exec_cache_capacity, 16,
+    "Maximum number of instantiated CUDA graphs retained for reuse by\n"
+    "command buffers with the same structure. 0 disables caching.");
+
+IREE_FLAG(
+    string, cuda_executable_cache_path, "",
+    "Directory used to persist JIT compiled CUDA modules across runs.");
+
 IREE_FLAG(int32_t, cuda_default_index, 0, "Index of the default CUDA device.");
 
 IREE_FLAG(bool, cuda_default_index_from_mpi, true,
@@ -96,6 +134,23 @@ static iree_status_t iree_hal_cuda_driver_factory_try_create(
   default_params.allow_inline_execution = FLAG_cuda_allow_inline_execution;
   default_params.stream_tracing = FLAG_cuda_tracing;
   default_params.async_allocations = FLAG_cuda_async_allocations;
+  default_params.memory_pools.device_local.minimum_capacity =
+      (uint64_t)iree_max(0, FLAG_cuda_device_local_pool_minimum_capacity);
+  default_params.memory_pools.device_local.release_threshold =
+      FLAG_cuda_device_local_pool_release_threshold < 0
+          ? UINT64_MAX
+          : (uint64_t)FLAG_cuda_device_local_pool_release_threshold;
+  default_params.memory_pools.per_queue = FLAG_cuda_per_queue_memory_pools;
+  default_params.collective_bucket_size =
+      (iree_device_size_t)iree_max(0, FLAG_cuda_collective_bucket_size);
+  default_params.host_registration_cache_capacity = (iree_host_size_t)iree_max(
+      0, FLAG_cuda_host_registration_cache_capacity);
+  default_params.concurrent_stream_count =
+      (iree_host_size_t)iree_max(1, FLAG_cuda_concurrent_stream_count);
+  default_params.graph_exec_cache_capacity =
+      (iree_host_size_t)iree_max(0, FLAG_cuda_graph_exec_cache_capacity);
+  default_params.executable_cache_path =
+      iree_make_cstring_view(FLAG_cuda_executable_cache_path);
 
   iree_hal_cuda_driver_options_t driver_options;
   iree_hal_cuda_driver_options_initialize(&driver_options);
@@ -6,6 +6,7 @@
 
 #include "iree/hal/drivers/cuda/stream_command_buffer.h"
 
+#include "iree/base/internal/math.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_event.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
@@ -13,6 +14,7 @@
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/status_util.h"
 #include "iree/hal/utils/collective_batch.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 #define IREE_HAL_CUDA_MAX_BINDING_COUNT 64
@@ -23,8 +25,28 @@ typedef struct {
   iree_hal_command_buffer_t base;
   iree_hal_cuda_context_wrapper_t* context;
   iree_hal_cuda_tracing_context_t* tracing_context;
+  iree_hal_cuda_dispatch_profiler_t* dispatch_profiler;
+
+  // Primary stream all work is joined back to on barriers.
   CUstream stream;
 
+  // Streams commands between barriers are distributed across. streams[0] is
+  // the primary stream.
+  iree_host_size_t stream_count;
+  CUstream streams[IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT];
+  // Index of the stream the next command will be issued on.
+  iree_host_size_t next_stream_index;
+  // Event recorded on the primary stream at the start of the current
+  // concurrent region that secondary streams wait on before their first
+  // command in the region.
+  CUevent fork_event;
+  bool is_forked;
+  // Events recorded on each secondary stream that the primary stream waits on
+  // to join the region.
+  CUevent join_events[IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT];
+  // Bitmask of secondary streams that have commands in the current region.
+  uint32_t active_stream_mask;
+
   // Maintains a reference to all resources used within the command buffer.
   // Reset on each begin.
   iree_hal_resource_set_t* resource_set;
@@ -36,6 +58,8 @@ typedef struct {
 
   // Iteratively constructed batch of collective operations.
   iree_hal_collective_batch_t collective_batch;
+  // Controls fusion of small all-reduces in the batch when flushed.
+  iree_hal_cuda_nccl_bucketing_t collective_bucketing;
 
   int32_t push_constant[IREE_HAL_CUDA_MAX_PUSH_CONSTANT_COUNT];
 
@@ -57,20 +81,26 @@ iree_hal_cuda_stream_command_buffer_cast(
 iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_profiler_t* dispatch_profiler,
+    const iree_hal_cuda_nccl_bucketing_t* collective_bucketing,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity, CUstream stream,
-    iree_arena_block_pool_t* block_pool,
+    iree_host_size_t binding_capacity, iree_host_size_t stream_count,
+    const CUstream* streams, iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(streams);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
+  if (stream_count == 0 ||
+      stream_count > IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "stream count %" PRIhsz
+                            " out of range (expected 1 to %d)",
+                            stream_count,
+                            IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT);
   }
 
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -86,7 +116,18 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
         &command_buffer->base);
     command_buffer->context = context;
     command_buffer->tracing_context = tracing_context;
-    command_buffer->stream = stream;
+    command_buffer->dispatch_profiler = dispatch_profiler;
+    if (collective_bucketing) {
+      command_buffer->collective_bucketing = *collective_bucketing;
+    } else {
+      memset(&command_buffer->collective_bucketing, 0,
+             sizeof(command_buffer->collective_bucketing));
+    }
+    command_buffer->stream = streams[0];
+    // Trace zones must be recorded in order on a single stream.
+    command_buffer->stream_count = tracing_context ? 1 : stream_count;
+    memcpy(command_buffer->streams, streams,
+           command_buffer->stream_count * sizeof(CUstream));
     iree_arena_initialize(block_pool, &command_buffer->arena);
     for (size_t i = 0; i < IREE_HAL_CUDA_MAX_KERNEL_ARG; i++) {
       command_buffer->current_descriptor[i] = &command_buffer->device_ptrs[i];
@@ -100,6 +141,22 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
                                          command_buffer->resource_set,
                                          &command_buffer->collective_batch);
   }
+  for (iree_host_size_t i = 1;
+       i < command_buffer->stream_count && iree_status_is_ok(status); ++i) {
+    if (!command_buffer->fork_event) {
+      status = CU_RESULT_TO_STATUS(
+          context->syms,
+          cuEventCreate(&command_buffer->fork_event, CU_EVENT_DISABLE_TIMING),
+          "cuEventCreate");
+    }
+    if (iree_status_is_ok(status)) {
+      status = CU_RESULT_TO_STATUS(
+          context->syms,
+          cuEventCreate(&command_buffer->join_events[i],
+                        CU_EVENT_DISABLE_TIMING),
+          "cuEventCreate");
+    }
+  }
 
   *out_command_buffer = &command_buffer->base;
   IREE_TRACE_ZONE_END(z0);
@@ -112,6 +169,19 @@ static void iree_hal_cuda_stream_command_buffer_destroy(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Events may still be pending on the streams; CUDA defers releasing them
+  // until they complete.
+  if (command_buffer->fork_event) {
+    CUDA_IGNORE_ERROR(command_buffer->context->syms,
+                      cuEventDestroy(command_buffer->fork_event));
+  }
+  for (iree_host_size_t i = 1; i < command_buffer->stream_count; ++i) {
+    if (command_buffer->join_events[i]) {
+      CUDA_IGNORE_ERROR(command_buffer->context->syms,
+                        cuEventDestroy(command_buffer->join_events[i]));
+    }
+  }
+
   iree_hal_collective_batch_deinitialize(&command_buffer->collective_batch);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_arena_deinitialize(&command_buffer->arena);
@@ -126,6 +196,69 @@ bool iree_hal_cuda_stream_command_buffer_isa(
                               &iree_hal_cuda_stream_command_buffer_vtable);
 }
 
+// Selects the stream the next command will be issued on. Commands between
+// barriers are distributed round-robin across all streams. Secondary streams
+// are ordered after all work issued on the primary stream prior to the start
+// of the current concurrent region.
+static iree_status_t iree_hal_cuda_stream_command_buffer_select_stream(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer,
+    CUstream* out_stream) {
+  if (command_buffer->stream_count == 1) {
+    *out_stream = command_buffer->stream;
+    return iree_ok_status();
+  }
+
+  if (!command_buffer->is_forked) {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuEventRecord(command_buffer->fork_event, command_buffer->stream),
+        "cuEventRecord");
+    command_buffer->is_forked = true;
+  }
+
+  iree_host_size_t stream_index = command_buffer->next_stream_index;
+  command_buffer->next_stream_index =
+      (stream_index + 1) % command_buffer->stream_count;
+  const uint32_t stream_bit = 1u << stream_index;
+  if (stream_index != 0 &&
+      !(command_buffer->active_stream_mask & stream_bit)) {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuStreamWaitEvent(command_buffer->streams[stream_index],
+                          command_buffer->fork_event, 0),
+        "cuStreamWaitEvent");
+    command_buffer->active_stream_mask |= stream_bit;
+  }
+
+  *out_stream = command_buffer->streams[stream_index];
+  return iree_ok_status();
+}
+
+// Joins all secondary streams used in the current concurrent region back to
+// the primary stream such that subsequent work observes their results.
+static iree_status_t iree_hal_cuda_stream_command_buffer_join_streams(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer) {
+  uint32_t stream_mask = command_buffer->active_stream_mask;
+  command_buffer->active_stream_mask = 0;
+  command_buffer->is_forked = false;
+  command_buffer->next_stream_index = 0;
+  while (stream_mask) {
+    int stream_index = iree_math_count_trailing_zeros_u32(stream_mask);
+    stream_mask &= stream_mask - 1;
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuEventRecord(command_buffer->join_events[stream_index],
+                      command_buffer->streams[stream_index]),
+        "cuEventRecord");
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuStreamWaitEvent(command_buffer->stream,
+                          command_buffer->join_events[stream_index], 0),
+        "cuStreamWaitEvent");
+  }
+  return iree_ok_status();
+}
+
 // Flushes any pending batched collective operations.
 // Must be called before any other non-collective nodes are added to the graph
 // or a barrier is encountered.
@@ -141,7 +274,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_flush_collectives(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_status_t status = iree_hal_cuda_nccl_submit_batch(
       command_buffer->context, command_buffer->tracing_context,
-      &command_buffer->collective_batch, command_buffer->stream);
+      &command_buffer->collective_bucketing, &command_buffer->collective_batch,
+      command_buffer->stream);
   iree_hal_collective_batch_clear(&command_buffer->collective_batch);
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -151,7 +285,10 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_cuda_stream_command_buffer_t* command_buffer =
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
-  (void)command_buffer;
+
+  // Ensure no streams are left forked from a prior recording that failed.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_streams(command_buffer));
 
   IREE_CUDA_TRACE_ZONE_BEGIN_EXTERNAL(
       command_buffer->tracing_context, command_buffer->stream,
@@ -169,6 +306,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_end(
 
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_streams(command_buffer));
 
   // Reset the arena as there should be nothing using it now that we've
   // dispatched all our operations inline.
@@ -235,8 +374,9 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_execution_barrier(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
-  // TODO(jinchen62): implement CUDA barrier
-  return iree_ok_status();
+  // Commands after the barrier will be issued on the primary stream or on
+  // secondary streams that wait on it.
+  return iree_hal_cuda_stream_command_buffer_join_streams(command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_stream_command_buffer_signal_event(
@@ -246,7 +386,15 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_signal_event(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
-  // TODO(jinchen62): implement CUDA barrier
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_streams(command_buffer));
+
+  // All prior work has been joined back to the primary stream so recording
+  // there signals once all of it has completed.
+  CUDA_RETURN_IF_ERROR(
+      command_buffer->context->syms,
+      cuEventRecord(iree_hal_cuda_event_handle(event), command_buffer->stream),
+      "cuEventRecord");
   return iree_ok_status();
 }
 
@@ -257,7 +405,7 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_reset_event(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
-  // TODO(jinchen62): implement CUDA barrier
+  // CUDA events are reset implicitly each time they are recorded.
   return iree_ok_status();
 }
 
@@ -274,7 +422,17 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_wait_events(
       iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
-  // TODO(jinchen62): implement CUDA barrier
+  // Join first so that the next concurrent region is forked after the waits
+  // and commands on secondary streams are ordered after the events as well.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_stream_command_buffer_join_streams(command_buffer));
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    CUDA_RETURN_IF_ERROR(
+        command_buffer->context->syms,
+        cuStreamWaitEvent(command_buffer->stream,
+                          iree_hal_cuda_event_handle(events[i]), 0),
+        "cuStreamWaitEvent");
+  }
   return iree_ok_status();
 }
 
@@ -295,6 +453,10 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_fill_buffer(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
 
+  CUstream stream = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_select_stream(
+      command_buffer, &stream));
+
   CUdeviceptr target_device_buffer = iree_hal_cuda_buffer_device_pointer(
       iree_hal_buffer_allocated_buffer(target_buffer));
   target_offset += iree_hal_buffer_byte_offset(target_buffer);
@@ -305,7 +467,7 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_fill_buffer(
       CUDA_RETURN_IF_ERROR(
           command_buffer->context->syms,
           cuMemsetD32Async(dst, *(const uint32_t*)(pattern), num_elements,
-                           command_buffer->stream),
+                           stream),
           "cuMemsetD32Async");
       break;
     }
@@ -313,7 +475,7 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_fill_buffer(
       CUDA_RETURN_IF_ERROR(
           command_buffer->context->syms,
           cuMemsetD16Async(dst, *(const uint16_t*)(pattern), num_elements,
-                           command_buffer->stream),
+                           stream),
           "cuMemsetD16Async");
       break;
     }
@@ -321,7 +483,7 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_fill_buffer(
       CUDA_RETURN_IF_ERROR(
           command_buffer->context->syms,
           cuMemsetD8Async(dst, *(const uint8_t*)(pattern), num_elements,
-                          command_buffer->stream),
+                          stream),
           "cuMemsetD8Async");
       break;
     }
@@ -358,13 +520,16 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_update_buffer(
   }
 
   // Issue the copy using the scratch memory as the source.
+  CUstream stream = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_select_stream(
+      command_buffer, &stream));
   CUdeviceptr target_device_buffer = iree_hal_cuda_buffer_device_pointer(
       iree_hal_buffer_allocated_buffer(target_buffer));
   CUdeviceptr dst = target_device_buffer +
                     iree_hal_buffer_byte_offset(target_buffer) + target_offset;
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
-      cuMemcpyHtoDAsync(dst, src, length, command_buffer->stream),
+      cuMemcpyHtoDAsync(dst, src, length, stream),
       "cuMemcpyHtoDAsync");
 
   return iree_ok_status();
@@ -380,6 +545,10 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_copy_buffer(
   IREE_RETURN_IF_ERROR(
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
 
+  CUstream stream = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_select_stream(
+      command_buffer, &stream));
+
   CUdeviceptr target_device_buffer = iree_hal_cuda_buffer_device_pointer(
       iree_hal_buffer_allocated_buffer(target_buffer));
   target_offset += iree_hal_buffer_byte_offset(target_buffer);
@@ -389,7 +558,7 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_copy_buffer(
   CUdeviceptr dst = target_device_buffer + target_offset;
   CUdeviceptr src = source_device_buffer + source_offset;
   CUDA_RETURN_IF_ERROR(command_buffer->context->syms,
-                       cuMemcpyAsync(dst, src, length, command_buffer->stream),
+                       cuMemcpyAsync(dst, src, length, stream),
                        "cuMemcpyAsync");
 
   return iree_ok_status();
@@ -497,8 +666,12 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
       iree_hal_cuda_native_executable_entry_point_kernel_params(
           executable, entry_point, &kernel_params));
 
+  CUstream stream = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_select_stream(
+      command_buffer, &stream));
+
   IREE_CUDA_TRACE_ZONE_BEGIN_EXTERNAL(
-      command_buffer->tracing_context, command_buffer->stream,
+      command_buffer->tracing_context, stream,
       kernel_params.source_filename.data, kernel_params.source_filename.size,
       kernel_params.source_line, /*func_name=*/NULL, 0,
       kernel_params.function_name.data, kernel_params.function_name.size);
@@ -513,17 +686,29 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
         command_buffer->push_constant[i];
   }
 
+  CUevent profile_start_event = NULL;
+  if (iree_hal_cuda_dispatch_profiler_is_active(
+          command_buffer->dispatch_profiler)) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_dispatch_profiler_record_begin(
+        command_buffer->dispatch_profiler, stream, &profile_start_event));
+  }
+
   CUDA_RETURN_IF_ERROR(
       command_buffer->context->syms,
       cuLaunchKernel(kernel_params.function, workgroup_x, workgroup_y,
                      workgroup_z, kernel_params.block_size[0],
                      kernel_params.block_size[1], kernel_params.block_size[2],
-                     kernel_params.shared_memory_size, command_buffer->stream,
+                     kernel_params.shared_memory_size, stream,
                      command_buffer->current_descriptor, NULL),
       "cuLaunchKernel");
 
-  IREE_CUDA_TRACE_ZONE_END(command_buffer->tracing_context,
-                           command_buffer->stream);
+  if (profile_start_event) {
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_dispatch_profiler_record_end(
+        command_buffer->dispatch_profiler, stream, kernel_params.function_name,
+        profile_start_event));
+  }
+
+  IREE_CUDA_TRACE_ZONE_END(command_buffer->tracing_context, stream);
 
   return iree_ok_status();
 }
@@ -541,10 +726,15 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers with deferred command
-  // buffers or graphs. We likely just want to switch to graphs.
+  // Nested command buffers are recorded as deferred command buffers and
+  // replayed onto the stream with the binding table resolved.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 static const iree_hal_command_buffer_vtable_t
@@ -11,15 +11,27 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/context_wrapper.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
 #include "iree/hal/drivers/cuda/dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+// Maximum number of streams a stream command buffer can distribute commands
+// across.
+#define IREE_HAL_CUDA_MAX_CONCURRENT_STREAM_COUNT 16
+
 // Creates a cuda stream command buffer that immediately issues commands against
-// the given |stream|. Access to |stream| must be synchronized by the user.
+// the given |streams|. Access to the streams must be synchronized by the user.
+//
+// |streams[0]| is the primary stream that all work is ordered against at
+// command buffer boundaries. When |stream_count| > 1 the commands recorded
+// between barriers are distributed across all streams so that they may execute
+// concurrently and are joined back to the primary stream with events on each
+// barrier and at the end of the command buffer.
 //
 // If |block_pool| is non-NULL then the stream command buffer will retain copies
 // of input data until reset. If NULL then the caller must ensure the lifetime
@@ -29,13 +41,21 @@ extern "C" {
 // perform inline execution. When replaying the scratch data required for things
 // like buffer updates is retained by the source deferred command buffer and as
 // such the |block_pool| and can be NULL to avoid a double copy.
+//
+// |collective_bucketing| optionally enables fusing small all-reduce operations
+// between barriers into buckets; see iree_hal_cuda_nccl_bucketing_t.
+//
+// |dispatch_profiler| is optional and when active each dispatch is bracketed
+// with events measuring its execution time.
 iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_device_t* device, iree_hal_cuda_context_wrapper_t* context,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_profiler_t* dispatch_profiler,
+    const iree_hal_cuda_nccl_bucketing_t* collective_bucketing,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity, CUstream stream,
-    iree_arena_block_pool_t* block_pool,
+    iree_host_size_t binding_capacity, iree_host_size_t stream_count,
+    const CUstream* streams, iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns true if |command_buffer| is a CUDA stream-based command buffer.
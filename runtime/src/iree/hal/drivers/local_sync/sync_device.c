@@ -20,8 +20,10 @@
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
+#include "iree/hal/utils/shm_channel.h"
 
 typedef struct iree_hal_sync_device_t {
   iree_hal_resource_t resource;
@@ -42,6 +44,8 @@ typedef struct iree_hal_sync_device_t {
   // synchronization ourselves.
   iree_hal_sync_semaphore_state_t semaphore_state;
 
+  iree_hal_local_executable_cache_flags_t executable_cache_flags;
+
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_sync_device_t;
@@ -101,6 +105,7 @@ iree_status_t iree_hal_sync_device_create(
     iree_hal_allocator_retain(device_allocator);
     iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                      &device->large_block_pool);
+    device->executable_cache_flags = params->executable_cache_flags;
 
     device->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
@@ -216,8 +221,9 @@ static iree_status_t iree_hal_sync_device_query_i64(
 static iree_status_t iree_hal_sync_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_shm_channel_create_with_provider(
+      device->channel_provider, params, device->host_allocator, out_channel);
 }
 
 static iree_status_t iree_hal_sync_device_create_command_buffer(
@@ -260,7 +266,8 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_local_executable_cache_create(
-      identifier, /*worker_capacity=*/1, device->loader_count, device->loaders,
+      identifier, /*worker_capacity=*/1, device->executable_cache_flags,
+      device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -268,15 +275,21 @@ static iree_status_t iree_hal_sync_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_sync_device_create_pipeline_layout(
@@ -433,7 +446,7 @@ static iree_status_t iree_hal_sync_device_queue_execute(
   // Wait for semaphores to be signaled before performing any work.
   IREE_RETURN_IF_ERROR(iree_hal_sync_semaphore_multi_wait(
       &device->semaphore_state, IREE_HAL_WAIT_MODE_ALL, wait_semaphore_list,
-      iree_infinite_timeout()));
+      iree_infinite_timeout(), &device->large_block_pool));
 
   // Run all deferred command buffers - any we could have run inline we already
   // did during recording.
@@ -458,7 +471,8 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_sync_semaphore_multi_wait(&device->semaphore_state, wait_mode,
-                                            semaphore_list, timeout);
+                                            semaphore_list, timeout,
+                                            &device->large_block_pool);
 }
 
 static iree_status_t iree_hal_sync_device_profiling_begin(
@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +23,11 @@ typedef struct iree_hal_sync_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Flags controlling executable caches created by the device such as whether
+  // executables are loaded lazily on first dispatch and prefetched in the
+  // background.
+  iree_hal_local_executable_cache_flags_t executable_cache_flags;
 } iree_hal_sync_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -312,90 +312,11 @@ static iree_status_t iree_hal_sync_semaphore_wait(
   return status;
 }
 
-// Returns true if any semaphore in the list has signaled (or failed).
-// Used with with iree_condition_fn_t and must match that signature.
-static bool iree_hal_sync_semaphore_any_signaled(
-    const iree_hal_semaphore_list_t* semaphore_list) {
-  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
-    iree_hal_sync_semaphore_t* semaphore =
-        iree_hal_sync_semaphore_cast(semaphore_list->semaphores[i]);
-    iree_slim_mutex_lock(&semaphore->mutex);
-    bool is_signaled =
-        semaphore->current_value >= semaphore_list->payload_values[i] ||
-        !iree_status_is_ok(semaphore->failure_status);
-    iree_slim_mutex_unlock(&semaphore->mutex);
-    if (is_signaled) return true;
-  }
-  return false;
-}
-
-// Returns true if all semaphores in the list has signaled (or any failed).
-// Used with with iree_condition_fn_t and must match that signature.
-static bool iree_hal_sync_semaphore_all_signaled(
-    const iree_hal_semaphore_list_t* semaphore_list) {
-  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
-    iree_hal_sync_semaphore_t* semaphore =
-        iree_hal_sync_semaphore_cast(semaphore_list->semaphores[i]);
-    iree_slim_mutex_lock(&semaphore->mutex);
-    bool is_signaled =
-        semaphore->current_value >= semaphore_list->payload_values[i] ||
-        !iree_status_is_ok(semaphore->failure_status);
-    iree_slim_mutex_unlock(&semaphore->mutex);
-    if (!is_signaled) return false;
-  }
-  return true;
-}
-
-// Returns a status derived from the |semaphore_list| at the current time:
-// - IREE_STATUS_OK: any or all semaphores signaled (based on |wait_mode|).
-// - IREE_STATUS_ABORTED: one or more semaphores failed.
-// - IREE_STATUS_DEADLINE_EXCEEDED: any or all semaphores unsignaled.
-static iree_status_t iree_hal_sync_semaphore_result_from_state(
-    iree_hal_wait_mode_t wait_mode,
-    const iree_hal_semaphore_list_t semaphore_list) {
-  bool any_signaled = false;
-  bool all_signaled = true;
-  bool any_failed = false;
-  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
-    iree_hal_sync_semaphore_t* semaphore =
-        iree_hal_sync_semaphore_cast(semaphore_list.semaphores[i]);
-    iree_slim_mutex_lock(&semaphore->mutex);
-    const uint64_t current_value = semaphore->current_value;
-    const iree_status_code_t current_status_code =
-        iree_status_code(semaphore->failure_status);
-    if (current_status_code != IREE_STATUS_OK) {
-      // Semaphore has failed.
-      any_failed = true;
-    } else if (current_value < semaphore_list.payload_values[i]) {
-      // Deadline expired before the semaphore was signaled.
-      all_signaled = false;
-    } else {
-      // Signaled!
-      any_signaled = true;
-    }
-    iree_slim_mutex_unlock(&semaphore->mutex);
-  }
-  if (any_failed) {
-    // Always prioritize failure state.
-    return iree_status_from_code(IREE_STATUS_ABORTED);
-  }
-  switch (wait_mode) {
-    default:
-    case IREE_HAL_WAIT_MODE_ALL:
-      return all_signaled
-                 ? iree_ok_status()
-                 : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
-    case IREE_HAL_WAIT_MODE_ANY:
-      return any_signaled
-                 ? iree_ok_status()
-                 : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
-  }
-}
-
 iree_status_t iree_hal_sync_semaphore_multi_wait(
     iree_hal_sync_semaphore_state_t* shared_state,
     iree_hal_wait_mode_t wait_mode,
-    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_arena_block_pool_t* block_pool) {
   if (semaphore_list.count == 0) {
     return iree_ok_status();
   } else if (semaphore_list.count == 1) {
@@ -406,25 +327,15 @@ iree_status_t iree_hal_sync_semaphore_multi_wait(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Fast-path for polling; we'll never wait and can just do a quick query.
-  if (iree_timeout_is_immediate(timeout)) {
-    iree_status_t status =
-        iree_hal_sync_semaphore_result_from_state(wait_mode, semaphore_list);
-    IREE_TRACE_ZONE_END(z0);
-    return status;
-  }
-
-  // Perform wait on the global notification.
-  iree_notification_await(
-      &shared_state->notification,
-      wait_mode == IREE_HAL_WAIT_MODE_ALL
-          ? (iree_condition_fn_t)iree_hal_sync_semaphore_all_signaled
-          : (iree_condition_fn_t)iree_hal_sync_semaphore_any_signaled,
-      (void*)&semaphore_list, iree_infinite_timeout());
-
-  // We may have been successful - or may have a partial failure.
-  iree_status_t status =
-      iree_hal_sync_semaphore_result_from_state(wait_mode, semaphore_list);
+  // Wait on timepoints that wake only this thread instead of the shared
+  // notification which would re-evaluate the entire list on every signal of
+  // any semaphore in the device. Avoid heap allocations for large lists by
+  // using the device block pool for the timepoint storage.
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(block_pool, &arena);
+  iree_status_t status = iree_hal_semaphore_multi_wait_timepoints(
+      wait_mode, semaphore_list, timeout, iree_arena_allocator(&arena));
+  iree_arena_deinitialize(&arena);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -12,11 +12,14 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/local/dispatch_counters.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
+#include "iree/hal/utils/shm_channel.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/list.h"
 #include "iree/task/submission.h"
@@ -26,6 +29,34 @@
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+typedef struct iree_hal_task_command_buffer_t iree_hal_task_command_buffer_t;
+
+// Recorded state of a task in a reusable command buffer.
+// Executing a task mutates its header (dependency counts, completion task,
+// flags) and, for indirect dispatches, the workgroup count. We capture the
+// state when recording ends and restore it prior to each replay.
+typedef struct iree_hal_task_replay_entry_t {
+  struct iree_hal_task_replay_entry_t* next;
+  iree_task_t* task;
+  iree_task_t* completion_task;
+  int32_t pending_dependency_count;
+  iree_task_flags_t flags;
+  // Workgroup count of IREE_TASK_TYPE_DISPATCH tasks. Indirect dispatches
+  // store the pointer they sample from and all others the direct value.
+  union {
+    uint32_t value[3];
+    const uint32_t* ptr;
+  } workgroup_count;
+} iree_hal_task_replay_entry_t;
+
+// Task joining all leaf tasks of a reusable command buffer.
+// Its cleanup marks the command buffer as no longer in-flight so that it may
+// be replayed again.
+typedef struct iree_hal_task_replay_exit_t {
+  iree_task_nop_t task;
+  iree_hal_task_command_buffer_t* command_buffer;
+} iree_hal_task_replay_exit_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
@@ -34,12 +65,22 @@
 // additional allocations required during recording or execution. That means our
 // command buffer here is essentially just a builder for the task system types
 // and manager of the lifetime of the tasks.
-typedef struct iree_hal_task_command_buffer_t {
+//
+// Reusable (non-ONE_SHOT) command buffers are recorded the same way but instead
+// of handing their tasks off to the first submission we retain the DAG and
+// restore it to its recorded state each time it is issued. This "replay" mode
+// avoids rebuilding the DAG as would be required with a deferred command
+// buffer at the cost of only allowing a single execution to be in-flight at a
+// time.
+struct iree_hal_task_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
 
   iree_task_scope_t* scope;
 
+  // Optional profiler sampled by dispatches while active.
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -94,7 +135,25 @@ typedef struct iree_hal_task_command_buffer_t {
     // during recording to allow for partial push_constants updates.
     uint32_t push_constants[IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT];
   } state;
-} iree_hal_task_command_buffer_t;
+
+  // State used to replay reusable command buffers. Unused if ONE_SHOT.
+  struct {
+    // All tasks recorded in the command buffer in reverse recording order.
+    // The recorded task state is captured when recording ends.
+    iree_hal_task_replay_entry_t* entries;
+
+    // Root tasks of the DAG. We retain these as the |root_tasks| list is
+    // linked through the tasks themselves and consumed by the submission.
+    iree_host_size_t root_task_count;
+    iree_task_t** root_tasks;
+
+    // Joins all leaf tasks and is chained to the retire task on issue.
+    iree_hal_task_replay_exit_t* exit_task;
+
+    // 1 while an issued execution has not yet completed.
+    iree_atomic_int32_t in_flight;
+  } replay;
+};
 
 static const iree_hal_command_buffer_vtable_t
     iree_hal_task_command_buffer_vtable;
@@ -105,8 +164,17 @@ static iree_hal_task_command_buffer_t* iree_hal_task_command_buffer_cast(
   return (iree_hal_task_command_buffer_t*)base_value;
 }
 
+// Returns true if |command_buffer| may be issued multiple times and replays
+// its recorded DAG on each issue.
+static bool iree_hal_task_command_buffer_is_replayable(
+    const iree_hal_task_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(iree_hal_command_buffer_mode(&command_buffer->base),
+                            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+}
+
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
+    iree_hal_local_dispatch_counters_t* dispatch_counters,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
@@ -115,25 +183,6 @@ iree_status_t iree_hal_task_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_task_command_buffer_t* command_buffer = NULL;
@@ -145,10 +194,12 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->dispatch_counters = dispatch_counters;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+    memset(&command_buffer->replay, 0, sizeof(command_buffer->replay));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
   }
@@ -170,8 +221,16 @@ static void iree_hal_task_command_buffer_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
-  iree_task_list_discard(&command_buffer->root_tasks);
-  iree_task_list_discard(&command_buffer->leaf_tasks);
+  if (!iree_hal_task_command_buffer_is_replayable(command_buffer)) {
+    iree_task_list_discard(&command_buffer->root_tasks);
+    iree_task_list_discard(&command_buffer->leaf_tasks);
+  } else {
+    // Replayed tasks have no cleanup (besides the exit task) and are owned by
+    // the arena. Discarding would make them (re)notify their dependents which
+    // is not possible after they have executed.
+    IREE_ASSERT_EQ(0, iree_atomic_load_int32(&command_buffer->replay.in_flight,
+                                             iree_memory_order_acquire));
+  }
   iree_arena_deinitialize(&command_buffer->arena);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_allocator_free(host_allocator, command_buffer);
@@ -192,6 +251,9 @@ bool iree_hal_task_command_buffer_isa(
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
 
+static iree_status_t iree_hal_task_command_buffer_finalize_replay(
+    iree_hal_task_command_buffer_t* command_buffer);
+
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_task_command_buffer_t* command_buffer =
@@ -220,11 +282,112 @@ static iree_status_t iree_hal_task_command_buffer_end(
                         &command_buffer->root_tasks);
   }
 
+  // Capture the recorded DAG so that it can be restored on each issue.
+  if (iree_hal_task_command_buffer_is_replayable(command_buffer)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_finalize_replay(command_buffer));
+  }
+
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
   return iree_ok_status();
 }
 
+// Tracks |task| so that its recorded state can be restored prior to replaying
+// a reusable command buffer. No-op for one-shot command buffers.
+static iree_status_t iree_hal_task_command_buffer_track_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  if (!iree_hal_task_command_buffer_is_replayable(command_buffer)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_replay_entry_t* entry = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*entry), (void**)&entry));
+  memset(entry, 0, sizeof(*entry));
+  entry->task = task;
+  entry->next = command_buffer->replay.entries;
+  command_buffer->replay.entries = entry;
+  return iree_ok_status();
+}
+
+static void iree_hal_task_replay_exit_cleanup(iree_task_t* task,
+                                              iree_status_code_t status_code) {
+  iree_hal_task_replay_exit_t* exit_task = (iree_hal_task_replay_exit_t*)task;
+  iree_atomic_store_int32(&exit_task->command_buffer->replay.in_flight, 0,
+                          iree_memory_order_release);
+}
+
+// Joins the recorded DAG to an exit task and captures the state of all tasks
+// so that the DAG can be replayed once per issue.
+static iree_status_t iree_hal_task_command_buffer_finalize_replay(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  // Empty command buffers are no-ops when issued and need no replay state.
+  if (iree_task_list_is_empty(&command_buffer->root_tasks)) {
+    return iree_ok_status();
+  }
+
+  // Join all leaf tasks (or the root tasks if the DAG is a single layer) to
+  // the exit task.
+  iree_hal_task_replay_exit_t* exit_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*exit_task), (void**)&exit_task));
+  iree_task_nop_initialize(command_buffer->scope, &exit_task->task);
+  iree_task_set_cleanup_fn(&exit_task->task.header,
+                           iree_hal_task_replay_exit_cleanup);
+  exit_task->command_buffer = command_buffer;
+  iree_task_list_t* exit_task_list =
+      iree_task_list_is_empty(&command_buffer->leaf_tasks)
+          ? &command_buffer->root_tasks
+          : &command_buffer->leaf_tasks;
+  for (iree_task_t* task = iree_task_list_front(exit_task_list); task != NULL;
+       task = task->next_task) {
+    iree_task_set_completion_task(task, &exit_task->task.header);
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &exit_task->task.header));
+  command_buffer->replay.exit_task = exit_task;
+
+  // Retain the root tasks as the list will be consumed on each issue.
+  iree_host_size_t root_task_count = 0;
+  for (iree_task_t* task = iree_task_list_front(&command_buffer->root_tasks);
+       task != NULL; task = task->next_task) {
+    ++root_task_count;
+  }
+  iree_task_t** root_tasks = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, root_task_count * sizeof(*root_tasks),
+      (void**)&root_tasks));
+  iree_host_size_t root_task_index = 0;
+  for (iree_task_t* task = iree_task_list_front(&command_buffer->root_tasks);
+       task != NULL; task = task->next_task) {
+    root_tasks[root_task_index++] = task;
+  }
+  command_buffer->replay.root_task_count = root_task_count;
+  command_buffer->replay.root_tasks = root_tasks;
+
+  // Capture the state of all tasks now that the DAG is complete.
+  for (iree_hal_task_replay_entry_t* entry = command_buffer->replay.entries;
+       entry != NULL; entry = entry->next) {
+    iree_task_t* task = entry->task;
+    entry->completion_task = task->completion_task;
+    entry->pending_dependency_count = iree_atomic_load_int32(
+        &task->pending_dependency_count, iree_memory_order_relaxed);
+    entry->flags = task->flags;
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+      if (task->flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
+        entry->workgroup_count.ptr = dispatch_task->workgroup_count.ptr;
+      } else {
+        memcpy(entry->workgroup_count.value,
+               dispatch_task->workgroup_count.value,
+               sizeof(entry->workgroup_count.value));
+      }
+    }
+  }
+
+  return iree_ok_status();
+}
+
 // Flushes all open tasks to the previous barrier and prepares for more
 // recording. The root tasks are also populated here when required as this is
 // the one place where we can see both halves of the most recent synchronization
@@ -296,6 +459,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
                                            sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_task(command_buffer, &barrier->header));
 
   // If there were previous tasks then join them to the barrier.
   for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
@@ -332,6 +497,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
 // scope (after state.open_barrier and before the next barrier).
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
     iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_task(command_buffer, task));
   if (command_buffer->state.open_barrier == NULL) {
     // If there is no open barrier then we are at the head and going right into
     // the task DAG.
@@ -348,6 +515,65 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+// Restores the recorded DAG of a reusable command buffer and enqueues its root
+// tasks. Fails if a prior issue of the command buffer is still in-flight as
+// each task can only be executing once at a time.
+static iree_status_t iree_hal_task_command_buffer_issue_replay(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (command_buffer->replay.root_task_count == 0) {
+    return iree_ok_status();
+  }
+
+  if (iree_atomic_exchange_int32(&command_buffer->replay.in_flight, 1,
+                                 iree_memory_order_acq_rel) != 0) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "reusable command buffers cannot be issued while a prior execution is "
+        "still in-flight; order submissions with semaphores");
+  }
+
+  // Reset all tasks to their recorded state. Any execution may have retired
+  // the tasks (clearing their completion tasks), consumed their dependency
+  // counts, and converted indirect dispatches to direct ones.
+  for (iree_hal_task_replay_entry_t* entry = command_buffer->replay.entries;
+       entry != NULL; entry = entry->next) {
+    iree_task_t* task = entry->task;
+    task->completion_task = entry->completion_task;
+    iree_atomic_store_int32(&task->pending_dependency_count,
+                            entry->pending_dependency_count,
+                            iree_memory_order_relaxed);
+    task->flags = entry->flags;
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+      if (task->flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
+        dispatch_task->workgroup_count.ptr = entry->workgroup_count.ptr;
+      } else {
+        memcpy(dispatch_task->workgroup_count.value,
+               entry->workgroup_count.value,
+               sizeof(dispatch_task->workgroup_count.value));
+      }
+    }
+  }
+
+  // Chain the retire task onto the exit task joining all leaves.
+  iree_task_set_completion_task(&command_buffer->replay.exit_task->task.header,
+                                retire_task);
+
+  // Enqueue all root tasks that are ready to run immediately. The submission
+  // takes ownership until the exit task retires.
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_host_size_t i = 0; i < command_buffer->replay.root_task_count;
+       ++i) {
+    iree_task_list_push_back(&root_tasks, command_buffer->replay.root_tasks[i]);
+  }
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -356,6 +582,11 @@ iree_status_t iree_hal_task_command_buffer_issue(
       iree_hal_task_command_buffer_cast(base_command_buffer);
   IREE_ASSERT_TRUE(command_buffer);
 
+  if (iree_hal_task_command_buffer_is_replayable(command_buffer)) {
+    return iree_hal_task_command_buffer_issue_replay(
+        command_buffer, retire_task, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
@@ -703,31 +934,73 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
 // iree_hal_command_buffer_collective
 //===----------------------------------------------------------------------===//
 
+// NOTE: collectives execute as a call task that blocks its worker until all
+// participants have issued the same operation. Issuing multiple collectives
+// between barriers serializes them on the worker as they must be performed in
+// the same order on all ranks.
+
+typedef struct iree_hal_cmd_collective_t {
+  iree_task_call_t task;
+  iree_hal_channel_t* channel;
+  iree_hal_collective_op_t op;
+  uint32_t param;
+  iree_hal_buffer_binding_t send_binding;
+  iree_hal_buffer_binding_t recv_binding;
+  iree_device_size_t element_count;
+} iree_hal_cmd_collective_t;
+
+static iree_status_t iree_hal_cmd_collective(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_collective_t* cmd =
+      (const iree_hal_cmd_collective_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)cmd->element_count);
+  iree_status_t status = iree_hal_shm_channel_execute_bindings(
+      cmd->channel, cmd->op, cmd->param, cmd->send_binding, cmd->recv_binding,
+      cmd->element_count);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_task_command_buffer_collective(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  // The channel can be used as a vtable if we want to inject collective APIs -
-  // the device creation function would set up the channel once and we'll
-  // receive it here each time. When interacting with the task system we want to
-  // get wait handles we can model with iree_task_wait_t.
-  //
-  // An example basic flow:
-  //   insert iree_task_call_t:
-  //     chains with prior commands and makes the collective API call
-  //   insert iree_task_wait_t with API wait handle or our event:
-  //     chains with call
-  //
-  // What we probably want to do, though, is group the commands based on
-  // execution barriers. When a new collective command comes in we should
-  // reserve an event from the event pool, create the call to issue the
-  // collective operation, and then track the event in the command buffer state.
-  // When another collective call comes in we'll do the same and append the
-  // event. At the next execution barrier (or non-collective command) we'd
-  // flush to a multi-wait on all of the pending events.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on the task system");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (!iree_hal_shm_channel_isa(channel)) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "only shared memory channels are supported on the task system");
+  }
+
+  iree_host_size_t resource_count = 0;
+  const void* resources[3] = {NULL};
+  resources[resource_count++] = channel;
+  if (send_binding.buffer) resources[resource_count++] = send_binding.buffer;
+  if (recv_binding.buffer) resources[resource_count++] = recv_binding.buffer;
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, resource_count, resources));
+
+  iree_hal_cmd_collective_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+
+  iree_task_call_initialize(
+      command_buffer->scope,
+      iree_task_make_call_closure(iree_hal_cmd_collective, (void*)cmd),
+      &cmd->task);
+  cmd->channel = channel;
+  cmd->op = op;
+  cmd->param = param;
+  cmd->send_binding = send_binding;
+  cmd->recv_binding = recv_binding;
+  cmd->element_count = element_count;
+
+  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
+                                                          &cmd->task.header);
 }
 
 //===----------------------------------------------------------------------===//
@@ -818,6 +1091,9 @@ typedef struct iree_hal_cmd_dispatch_t {
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Optional profiler sampled around each workgroup while active.
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -826,6 +1102,13 @@ typedef struct iree_hal_cmd_dispatch_t {
   // used (known at compile-time).
   uint16_t binding_count;
 
+  // Workgroup count passed to entry points handling the whole dispatch in a
+  // single call (IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH). The task
+  // then has a single workgroup. Points either at |whole_workgroup_storage| or
+  // the indirect workgroup count buffer. NULL for all other dispatches.
+  const uint32_t* whole_workgroup_count;
+  uint32_t whole_workgroup_storage[3];
+
   // Following this structure in memory there are 3 tables:
   // - const uint32_t push_constants[push_constant_count];
   // - void* binding_ptrs[binding_count];
@@ -864,20 +1147,53 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   dispatch_state.binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += cmd->binding_count * sizeof(*dispatch_state.binding_lengths);
 
+  // Entry points handling the whole dispatch see the full workgroup count from
+  // their single task workgroup.
+  if (cmd->whole_workgroup_count) {
+    dispatch_state.workgroup_count_x = cmd->whole_workgroup_count[0];
+    dispatch_state.workgroup_count_y = cmd->whole_workgroup_count[1];
+    dispatch_state.workgroup_count_z = cmd->whole_workgroup_count[2];
+    if (!dispatch_state.workgroup_count_x ||
+        !dispatch_state.workgroup_count_y ||
+        !dispatch_state.workgroup_count_z) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_ok_status();
+    }
+  }
+
   const iree_alignas(64)
       iree_hal_executable_workgroup_state_v0_t workgroup_state = {
           .workgroup_id_x = tile_context->workgroup_xyz[0],
           .workgroup_id_y = tile_context->workgroup_xyz[1],
           .workgroup_id_z = tile_context->workgroup_xyz[2],
-          .reserved = 0,
+          .workgroup_range_count = (uint16_t)tile_context->tile_count,
           .processor_id = tile_context->processor_id,
           .local_memory = tile_context->local_memory.data,
           .local_memory_size = (size_t)tile_context->local_memory.data_length,
       };
+
+  // Hardware counters are only sampled while dispatch profiling is active.
+  iree_hal_local_dispatch_counter_sample_t counter_sample;
+  const bool sample_counters =
+      iree_hal_local_dispatch_counters_is_active(cmd->dispatch_counters);
+  if (IREE_UNLIKELY(sample_counters)) {
+    iree_hal_local_dispatch_counters_sample_begin(cmd->dispatch_counters,
+                                                  &counter_sample);
+  }
+
   iree_status_t status = iree_hal_local_executable_issue_call(
       cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
       tile_context->worker_id);
 
+  if (IREE_UNLIKELY(sample_counters)) {
+    const bool is_first_workgroup = tile_context->workgroup_xyz[0] == 0 &&
+                                    tile_context->workgroup_xyz[1] == 0 &&
+                                    tile_context->workgroup_xyz[2] == 0;
+    iree_hal_local_dispatch_counters_sample_end(
+        cmd->dispatch_counters, &counter_sample, cmd->executable, cmd->ordinal,
+        is_first_workgroup);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -898,6 +1214,10 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
         "layouts not provided during executable creation; cannot dispatch");
   }
 
+  // Lazily loaded executables are loaded on first use so that their dispatch
+  // attributes are available below.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_resolve(local_executable));
+
   iree_hal_local_pipeline_layout_t* local_layout =
       (iree_hal_local_pipeline_layout_t*)
           local_executable->pipeline_layouts[entry_point];
@@ -923,10 +1243,23 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
+  cmd->dispatch_counters = command_buffer->dispatch_counters;
   cmd->push_constant_count = push_constant_count;
   cmd->binding_count = used_binding_count;
-
-  const uint32_t workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
+  cmd->whole_workgroup_count = NULL;
+
+  const iree_hal_executable_dispatch_flags_v0_t dispatch_flags =
+      iree_hal_local_executable_dispatch_flags(local_executable, entry_point);
+
+  // Entry points handling the whole dispatch get a single task workgroup and
+  // are passed the requested count when called.
+  uint32_t workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
+  if (dispatch_flags & IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH) {
+    memcpy(cmd->whole_workgroup_storage, workgroup_count,
+           sizeof(cmd->whole_workgroup_storage));
+    cmd->whole_workgroup_count = cmd->whole_workgroup_storage;
+    workgroup_count[0] = workgroup_count[1] = workgroup_count[2] = 1;
+  }
   // TODO(benvanik): expose on API or keep fixed on executable.
   const uint32_t workgroup_size[3] = {1, 1, 1};
   iree_task_dispatch_initialize(
@@ -943,6 +1276,28 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Entry points that handle workgroup ranges are called once per tile
+  // reservation instead of once per workgroup.
+  if (iree_hal_local_executable_supports_workgroup_ranges(local_executable,
+                                                          entry_point)) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_TILE_RANGES;
+  }
+
+  // Workers flush denormals to zero unless the entry point requires otherwise.
+  if (dispatch_flags & IREE_HAL_EXECUTABLE_DISPATCH_FLAG_FPU_AGNOSTIC) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_FPU_AGNOSTIC;
+  } else if (dispatch_flags &
+             IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PRESERVE_DENORMALS) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_PRESERVE_DENORMALS;
+  }
+
+  // Share the running workgroup duration estimate of the entry point across
+  // all dispatches so that the task system can size tile reservations.
+  cmd->task.tile_duration_ns =
+      local_executable->workgroup_durations_ns
+          ? &local_executable->workgroup_durations_ns[entry_point]
+          : NULL;
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -1017,8 +1372,15 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
   iree_hal_cmd_dispatch_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_build_dispatch(
       base_command_buffer, executable, entry_point, 0, 0, 0, &cmd));
-  cmd->task.workgroup_count.ptr = (const uint32_t*)buffer_mapping.contents.data;
-  cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
+  const uint32_t* workgroup_count =
+      (const uint32_t*)buffer_mapping.contents.data;
+  if (cmd->whole_workgroup_count) {
+    // The single task workgroup reads the count when it is called.
+    cmd->whole_workgroup_count = workgroup_count;
+  } else {
+    cmd->task.workgroup_count.ptr = workgroup_count;
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
+  }
   return iree_ok_status();
 }
 
@@ -1030,16 +1392,18 @@ static iree_status_t iree_hal_task_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers by using deferred command
-  // buffers or caching the task topology (probably not worth the tracking).
-  // If we could separate the topology that referenced the binding table we'd
-  // be able to reissue but not concurrently (as each task can only be in flight
-  // as a singleton) - which may be enough in many cases but adds complexity to
-  // tracking as we'd need to either enforce serialization of subsequent
-  // submissions or copy-on-write-style clone the topology for each additional
-  // concurrent submission.
+  // Command buffers with indirect bindings are recorded as deferred command
+  // buffers (see iree_hal_task_device_create_command_buffer) and replayed into
+  // this task graph with the binding table resolved. Caching the task topology
+  // instead would avoid the replay but tasks can only be in flight as a
+  // singleton and concurrent submissions would need copy-on-write clones.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 //===----------------------------------------------------------------------===//
@@ -11,6 +11,7 @@
 #include "iree/base/internal/arena.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/local_task/task_queue_state.h"
+#include "iree/hal/local/dispatch_counters.h"
 #include "iree/task/scope.h"
 #include "iree/task/task.h"
 
@@ -18,8 +19,13 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Creates a command buffer recording a task DAG issued to |scope|.
+//
+// |dispatch_counters| is optional and when active each dispatch workgroup
+// executed samples the hardware counters of the worker it runs on.
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
+    iree_hal_local_dispatch_counters_t* dispatch_counters,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
@@ -46,6 +52,11 @@ bool iree_hal_task_command_buffer_isa(
 //
 // |pending_submission| will receive the ready list of commands and must be
 // submitted to the executor (or discarded on failure) by the caller.
+//
+// Reusable (non-ONE_SHOT) command buffers replay the task DAG recorded once at
+// the end of recording. Only one execution may be in-flight at a time and
+// issuing while a prior execution is still pending fails with
+// IREE_STATUS_FAILED_PRECONDITION.
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
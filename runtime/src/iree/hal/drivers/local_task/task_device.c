@@ -16,12 +16,16 @@
 #include "iree/hal/drivers/local_task/task_event.h"
 #include "iree/hal/drivers/local_task/task_queue.h"
 #include "iree/hal/drivers/local_task/task_semaphore.h"
+#include "iree/hal/local/dispatch_counters.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
+#include "iree/hal/utils/shm_channel.h"
 
 typedef struct iree_hal_task_device_t {
   iree_hal_resource_t resource;
@@ -36,6 +40,7 @@ typedef struct iree_hal_task_device_t {
 
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t** loaders;
+  iree_hal_local_executable_cache_flags_t executable_cache_flags;
 
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
@@ -43,6 +48,9 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Samples per-dispatch hardware counters while dispatch profiling is active.
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -58,8 +66,18 @@ static iree_hal_task_device_t* iree_hal_task_device_cast(
 void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
+  out_params->arena_reserved_block_count = 0;
+  out_params->arena_slab_flags = IREE_ARENA_BLOCK_POOL_SLAB_FLAG_NONE;
+  out_params->arena_numa_node = 0;
+  out_params->high_priority_queue_affinity = 0;
+  out_params->executable_cache_flags =
+      IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_NONE;
 }
 
+// Total number of queues that can be selected by an iree_hal_queue_affinity_t.
+#define IREE_HAL_MAX_QUEUE_AFFINITY_BITS \
+  (sizeof(iree_hal_queue_affinity_t) * 8)
+
 static iree_status_t iree_hal_task_device_check_params(
     const iree_hal_task_device_params_t* params, iree_host_size_t queue_count) {
   if (params->arena_block_size < 4096) {
@@ -73,14 +91,6 @@ static iree_status_t iree_hal_task_device_check_params(
   return iree_ok_status();
 }
 
-// Returns an event pool used for device-wide system event handles.
-// Each queue executor will have its own (potentially shared) pool and prefer
-// that but generic resource requests (creating semaphores, etc) will use this.
-iree_event_pool_t* iree_hal_task_device_shared_event_pool(
-    iree_hal_task_device_t* device) {
-  return iree_task_executor_event_pool(device->queues[0].executor);
-}
-
 iree_status_t iree_hal_task_device_create(
     iree_string_view_t identifier, const iree_hal_task_device_params_t* params,
     iree_host_size_t queue_count, iree_task_executor_t* const* queue_executors,
@@ -114,6 +124,7 @@ iree_status_t iree_hal_task_device_create(
     device->host_allocator = host_allocator;
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
+    device->executable_cache_flags = params->executable_cache_flags;
 
     iree_arena_block_pool_initialize(4096, host_allocator,
                                      &device->small_block_pool);
@@ -132,12 +143,32 @@ iree_status_t iree_hal_task_device_create(
     device->queue_count = queue_count;
     for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
       // TODO(benvanik): add a number to each queue ID.
-      iree_hal_task_queue_initialize(device->identifier, queue_executors[i],
+      iree_hal_task_queue_initialize(device->identifier, i, queue_executors[i],
                                      &device->small_block_pool,
                                      &device->queues[i]);
+      if (i < IREE_HAL_MAX_QUEUE_AFFINITY_BITS &&
+          (params->high_priority_queue_affinity & (1ull << i))) {
+        iree_task_scope_set_priority(&device->queues[i].scope,
+                                     IREE_TASK_PRIORITY_HIGH);
+      }
     }
   }
 
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_local_dispatch_counters_allocate(
+        host_allocator, &device->dispatch_counters);
+  }
+
+  if (iree_status_is_ok(status) && params->arena_reserved_block_count > 0) {
+    iree_arena_block_pool_slab_params_t slab_params = {
+        .flags = params->arena_slab_flags,
+        .block_count = params->arena_reserved_block_count,
+        .numa_node = params->arena_numa_node,
+    };
+    status = iree_arena_block_pool_reserve_slab(&device->large_block_pool,
+                                                &slab_params);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -163,6 +194,8 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
 
+  iree_hal_local_dispatch_counters_free(device->dispatch_counters);
+
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
   iree_arena_block_pool_deinitialize(&device->small_block_pool);
 
@@ -274,8 +307,9 @@ static iree_host_size_t iree_hal_task_device_select_queue(
 static iree_status_t iree_hal_task_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_shm_channel_create_with_provider(
+      device->channel_provider, params, device->host_allocator, out_channel);
 }
 
 static iree_status_t iree_hal_task_device_create_command_buffer(
@@ -284,12 +318,21 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) ||
+      binding_capacity > 0) {
+    // Indirect command buffers are recorded once and replayed into the task
+    // graph of each command buffer executing them with its binding table.
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->large_block_pool, device->host_allocator, out_command_buffer);
+  }
   iree_host_size_t queue_index = iree_hal_task_device_select_queue(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
-      base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, binding_capacity, &device->large_block_pool,
-      device->host_allocator, out_command_buffer);
+      base_device, &device->queues[queue_index].scope,
+      device->dispatch_counters, mode, command_categories, queue_affinity,
+      binding_capacity, &device->large_block_pool, device->host_allocator,
+      out_command_buffer);
 }
 
 static iree_status_t iree_hal_task_device_create_descriptor_set_layout(
@@ -323,7 +366,8 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
   }
 
   return iree_hal_local_executable_cache_create(
-      identifier, total_worker_count, device->loader_count, device->loaders,
+      identifier, total_worker_count, device->executable_cache_flags,
+      device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -331,15 +375,21 @@ static iree_status_t iree_hal_task_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_task_device_create_pipeline_layout(
@@ -356,9 +406,8 @@ static iree_status_t iree_hal_task_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  return iree_hal_task_semaphore_create(
-      iree_hal_task_device_shared_event_pool(device), initial_value,
-      device->host_allocator, out_semaphore);
+  return iree_hal_task_semaphore_create(initial_value, device->host_allocator,
+                                        out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
@@ -371,8 +420,9 @@ iree_hal_task_device_query_semaphore_compatibility(
     // confusion).
     return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
   }
-  // For now we support all semaphore types as we only need wait sources and
-  // all semaphores can be wrapped in those.
+  // Semaphores from other devices are waited on with timepoints that ready the
+  // waiting tasks from the signaling thread and are signaled from the host
+  // when submissions retire.
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
 }
 
@@ -475,36 +525,43 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  return iree_hal_task_semaphore_multi_wait(
-      wait_mode, semaphore_list, timeout,
-      iree_hal_task_device_shared_event_pool(device),
-      &device->large_block_pool);
+  return iree_hal_task_semaphore_multi_wait(wait_mode, semaphore_list,
+                                           timeout, &device->large_block_pool);
 }
 
 static iree_status_t iree_hal_task_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  // Only per-dispatch hardware counters are implemented. Other modes could
+  // hook in to vendor APIs (Intel/ARM/etc) for sampling.
+  if (!iree_all_bits_set(options->mode,
+                         IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_ok_status();
+  }
+  return iree_hal_local_dispatch_counters_begin(
+      device->dispatch_counters,
+      iree_make_cstring_view(options->file_path ? options->file_path : ""));
 }
 
 static iree_status_t iree_hal_task_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
+  // Counters are accumulated as dispatches execute and reported on end.
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_task_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (!iree_hal_local_dispatch_counters_is_active(device->dispatch_counters)) {
+    return iree_ok_status();
+  }
+  // Workers must not be executing dispatches when their counters are released.
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_queue_wait_idle(
+        &device->queues[i], iree_infinite_timeout()));
+  }
+  return iree_hal_local_dispatch_counters_end(device->dispatch_counters);
 }
 
 static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
@@ -8,8 +8,10 @@
 #define IREE_HAL_DRIVERS_LOCAL_TASK_TASK_DEVICE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable_cache.h"
 #include "iree/task/executor.h"
 
 #ifdef __cplusplus
@@ -23,6 +25,32 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Number of blocks of |arena_block_size| to reserve in the device shared
+  // block pool at creation. Reserved blocks are allocated as a single slab
+  // that is retained for the lifetime of the device (even across trims) so
+  // that steady-state execution does not touch the system allocator.
+  iree_host_size_t arena_reserved_block_count;
+  // Flags controlling how the reserved slab is allocated such as whether it is
+  // backed by huge pages, bound to |arena_numa_node|, or prefaulted.
+  iree_arena_block_pool_slab_flags_t arena_slab_flags;
+  // NUMA node the reserved slab is bound to when
+  // IREE_ARENA_BLOCK_POOL_SLAB_FLAG_BIND_NUMA_NODE is set in
+  // |arena_slab_flags|. Usually the node of the executor workers.
+  uint32_t arena_numa_node;
+
+  // Bitmask of device queues whose submissions are scheduled with high
+  // priority. Work submitted to these queues (by selecting them with the queue
+  // affinity passed to iree_hal_device_queue_execute and related calls) is
+  // drained by workers ahead of work from other queues and normal priority
+  // dispatches yield to it at tile reservation boundaries. Useful when
+  // latency-sensitive and throughput-oriented workloads share executors.
+  iree_hal_queue_affinity_t high_priority_queue_affinity;
+
+  // Flags controlling executable caches created by the device such as whether
+  // executables are loaded lazily on first dispatch and prefetched in the
+  // background.
+  iree_hal_local_executable_cache_flags_t executable_cache_flags;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/local_task/task_queue.h"
 
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
@@ -98,7 +99,8 @@ static void iree_hal_semaphore_list_release(iree_hal_semaphore_list_t* list) {
 // used to stitch together subsequent submissions never have to go to the system
 // to wait as the implicit queue ordering ensures that the signals would have
 // happened prior to the sequence command being executed. Cross-queue semaphores
-// will still cause waits if they have not yet been signaled.
+// that have not yet been signaled ready the issue task directly from the
+// signaling thread.
 typedef struct iree_hal_task_queue_wait_cmd_t {
   // Call to iree_hal_task_queue_wait_cmd.
   iree_task_call_t task;
@@ -107,6 +109,10 @@ typedef struct iree_hal_task_queue_wait_cmd_t {
   // this.
   iree_arena_allocator_t* arena;
 
+  // Executor the submission is scheduled on; timepoints submit directly to it
+  // when their semaphores are signaled.
+  iree_task_executor_t* executor;
+
   // A list of semaphores to wait on prior to issuing the rest of the
   // submission.
   iree_hal_semaphore_list_t wait_semaphores;
@@ -124,7 +130,7 @@ static iree_status_t iree_hal_task_queue_wait_cmd(
     status = iree_hal_task_semaphore_enqueue_timepoint(
         cmd->wait_semaphores.semaphores[i],
         cmd->wait_semaphores.payload_values[i],
-        cmd->task.header.completion_task, cmd->arena, pending_submission);
+        cmd->task.header.completion_task, cmd->executor, cmd->arena);
     if (IREE_UNLIKELY(!iree_status_is_ok(status))) break;
   }
 
@@ -146,7 +152,8 @@ static void iree_hal_task_queue_wait_cmd_cleanup(
 
 // Allocates and initializes a iree_hal_task_queue_wait_cmd_t task.
 static iree_status_t iree_hal_task_queue_wait_cmd_allocate(
-    iree_task_scope_t* scope, const iree_hal_semaphore_list_t* wait_semaphores,
+    iree_task_scope_t* scope, iree_task_executor_t* executor,
+    const iree_hal_semaphore_list_t* wait_semaphores,
     iree_arena_allocator_t* arena, iree_hal_task_queue_wait_cmd_t** out_cmd) {
   iree_hal_task_queue_wait_cmd_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd));
@@ -156,6 +163,7 @@ static iree_status_t iree_hal_task_queue_wait_cmd_allocate(
   iree_task_set_cleanup_fn(&cmd->task.header,
                            iree_hal_task_queue_wait_cmd_cleanup);
   cmd->arena = arena;
+  cmd->executor = executor;
 
   // Clone the wait semaphores from the batch - we retain them and their
   // payloads.
@@ -196,6 +204,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
     iree_task_submission_t* pending_submission) {
   iree_hal_task_queue_issue_cmd_t* cmd = (iree_hal_task_queue_issue_cmd_t*)task;
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_FLOW_STEP((uintptr_t)cmd->task.header.completion_task);
 
   iree_status_t status = iree_ok_status();
 
@@ -290,6 +299,9 @@ typedef struct iree_hal_task_queue_retire_cmd_t {
   // A list of semaphores to signal upon retiring.
   iree_hal_semaphore_list_t signal_semaphores;
 
+  // Queue depth metric decremented when the submission retires.
+  iree_metric_t* depth_metric;
+
   // Resources retained until all have retired.
   // We could release them earlier but that would require tracking individual
   // resource-level completion.
@@ -305,6 +317,7 @@ static iree_status_t iree_hal_task_queue_retire_cmd(
   iree_hal_task_queue_retire_cmd_t* cmd =
       (iree_hal_task_queue_retire_cmd_t*)task;
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_FLOW_END((uintptr_t)&cmd->task.header);
 
   // Release command buffers now that all are known to have retired.
   // We do this before signaling so that waiting threads can immediately reuse
@@ -358,6 +371,8 @@ static void iree_hal_task_queue_retire_cmd_cleanup(
   // Release all semaphores.
   iree_hal_semaphore_list_release(&cmd->signal_semaphores);
 
+  if (cmd->depth_metric) iree_metric_add(cmd->depth_metric, -1);
+
   // Drop all memory used by the submission (**including cmd**).
   iree_arena_allocator_t arena = cmd->arena;
   cmd = NULL;
@@ -391,6 +406,7 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
         &cmd->task);
     iree_task_set_cleanup_fn(&cmd->task.header,
                              iree_hal_task_queue_retire_cmd_cleanup);
+    cmd->depth_metric = NULL;
   }
 
   // Clone the signal semaphores from the batch - we retain them and their
@@ -422,7 +438,13 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
 // iree_hal_task_queue_t
 //===----------------------------------------------------------------------===//
 
+IREE_METRIC_STATIC(iree_hal_task_queue_submissions_metric,
+                   IREE_METRIC_KIND_COUNTER,
+                   "iree_hal_task_queue_submissions_total",
+                   "Submission batches accepted by local-task device queues.");
+
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
+                                    iree_host_size_t queue_index,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* block_pool,
                                     iree_hal_task_queue_t* out_queue) {
@@ -439,6 +461,15 @@ void iree_hal_task_queue_initialize(iree_string_view_t identifier,
 
   iree_hal_task_queue_state_initialize(&out_queue->state);
 
+  char labels[IREE_METRIC_MAX_LABELS_LENGTH];
+  snprintf(labels, sizeof(labels), "device=\"%.*s\",queue=\"%" PRIhsz "\"",
+           (int)identifier.size, identifier.data, queue_index);
+  iree_metric_initialize(IREE_METRIC_KIND_GAUGE, "iree_hal_task_queue_depth",
+                         "Submissions accepted by a local-task device queue "
+                         "that have not yet retired.",
+                         iree_make_cstring_view(labels),
+                         &out_queue->depth_metric);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -447,6 +478,7 @@ void iree_hal_task_queue_deinitialize(iree_hal_task_queue_t* queue) {
 
   iree_status_ignore(
       iree_task_scope_wait_idle(&queue->scope, IREE_TIME_INFINITE_FUTURE));
+  iree_metric_deinitialize(&queue->depth_metric);
 
   iree_hal_task_queue_state_deinitialize(&queue->state);
   iree_task_scope_deinitialize(&queue->scope);
@@ -487,7 +519,8 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   iree_hal_task_queue_wait_cmd_t* wait_cmd = NULL;
   if (iree_status_is_ok(status) && batch->wait_semaphores.count > 0) {
     status = iree_hal_task_queue_wait_cmd_allocate(
-        &queue->scope, &batch->wait_semaphores, &retire_cmd->arena, &wait_cmd);
+        &queue->scope, queue->executor, &batch->wait_semaphores,
+        &retire_cmd->arena, &wait_cmd);
   }
 
   // Task to issue all the command buffers in the batch.
@@ -507,6 +540,15 @@ static iree_status_t iree_hal_task_queue_submit_batch(
     return status;
   }
 
+  retire_cmd->depth_metric = &queue->depth_metric;
+  iree_metric_add(&queue->depth_metric, 1);
+  iree_metric_add(&iree_hal_task_queue_submissions_metric, 1);
+
+  // Follow the submission from here through issue to retirement on whichever
+  // workers execute them. The retire command is unique to the submission and
+  // alive until the flow ends.
+  IREE_TRACE_FLOW_BEGIN((uintptr_t)&retire_cmd->task.header);
+
   iree_task_submission_t submission;
   iree_task_submission_initialize(&submission);
 
@@ -12,36 +12,8 @@
 #include <string.h>
 
 #include "iree/base/internal/synchronization.h"
-#include "iree/base/internal/wait_handle.h"
 #include "iree/hal/utils/semaphore_base.h"
 
-//===----------------------------------------------------------------------===//
-// iree_hal_task_timepoint_t
-//===----------------------------------------------------------------------===//
-
-// Represents a point in the timeline that someone is waiting to be reached.
-// When the semaphore is signaled to at least the specified value then the
-// given event will be signaled and the timepoint discarded.
-//
-// Instances are owned and retained by the caller that requested them - usually
-// in the arena associated with the submission, but could be on the stack of a
-// synchronously waiting thread.
-typedef struct iree_hal_task_timepoint_t {
-  iree_hal_semaphore_timepoint_t base;
-  iree_hal_semaphore_t* semaphore;
-  iree_event_t event;
-} iree_hal_task_timepoint_t;
-
-// Handles timepoint callbacks when either the timepoint is reached or it fails.
-// We set the event in either case and let the waiters deal with the fallout.
-static iree_status_t iree_hal_task_semaphore_timepoint_callback(
-    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
-    iree_status_code_t status_code) {
-  iree_hal_task_timepoint_t* timepoint = (iree_hal_task_timepoint_t*)user_data;
-  iree_event_set(&timepoint->event);
-  return iree_ok_status();
-}
-
 //===----------------------------------------------------------------------===//
 // iree_hal_task_semaphore_t
 //===----------------------------------------------------------------------===//
@@ -49,7 +21,6 @@ static iree_status_t iree_hal_task_semaphore_timepoint_callback(
 typedef struct iree_hal_task_semaphore_t {
   iree_hal_semaphore_t base;
   iree_allocator_t host_allocator;
-  iree_event_pool_t* event_pool;
 
   // Guards all mutable fields. We expect low contention on semaphores and since
   // iree_slim_mutex_t is (effectively) just a CAS this keeps things simpler
@@ -74,9 +45,8 @@ static iree_hal_task_semaphore_t* iree_hal_task_semaphore_cast(
 }
 
 iree_status_t iree_hal_task_semaphore_create(
-    iree_event_pool_t* event_pool, uint64_t initial_value,
-    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
-  IREE_ASSERT_ARGUMENT(event_pool);
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore) {
   IREE_ASSERT_ARGUMENT(out_semaphore);
   *out_semaphore = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -88,7 +58,6 @@ iree_status_t iree_hal_task_semaphore_create(
     iree_hal_semaphore_initialize(&iree_hal_task_semaphore_vtable,
                                   &semaphore->base);
     semaphore->host_allocator = host_allocator;
-    semaphore->event_pool = event_pool;
 
     iree_slim_mutex_initialize(&semaphore->mutex);
     semaphore->current_value = initial_value;
@@ -196,51 +165,100 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
                             status_code);
 }
 
-// Acquires a timepoint waiting for the given value.
-// |out_timepoint| is owned by the caller and must be kept live until the
-// timepoint has been reached (or it is cancelled by the caller).
-static iree_status_t iree_hal_task_semaphore_acquire_timepoint(
-    iree_hal_task_semaphore_t* semaphore, uint64_t minimum_value,
-    iree_timeout_t timeout, iree_hal_task_timepoint_t* out_timepoint) {
-  IREE_RETURN_IF_ERROR(
-      iree_event_pool_acquire(semaphore->event_pool, 1, &out_timepoint->event));
-  out_timepoint->semaphore = &semaphore->base;
-  iree_hal_semaphore_acquire_timepoint(
-      &semaphore->base, minimum_value, timeout,
-      (iree_hal_semaphore_callback_t){
-          .fn = iree_hal_task_semaphore_timepoint_callback,
-          .user_data = out_timepoint,
-      },
-      &out_timepoint->base);
+// A dependency of an issue task that is resolved directly by a semaphore
+// timepoint. When the semaphore is signaled the signaling thread submits the
+// nop to the executor which then retires it and readies the issue task. This
+// avoids the executor poller and the system wait handles it would need.
+//
+// Allocated from the submission arena and kept live by the pending issue task.
+typedef struct iree_hal_task_semaphore_chain_cmd_t {
+  iree_task_nop_t task;
+  iree_hal_semaphore_t* semaphore;
+  iree_hal_semaphore_timepoint_t timepoint;
+  iree_task_executor_t* executor;
+} iree_hal_task_semaphore_chain_cmd_t;
+
+// Handles timepoint callbacks when either the timepoint is reached or it fails.
+// We ready the issue task in either case and let it deal with the fallout.
+static iree_status_t iree_hal_task_semaphore_chain_cmd_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_task_semaphore_chain_cmd_t* cmd =
+      (iree_hal_task_semaphore_chain_cmd_t*)user_data;
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &cmd->task.header);
+  iree_task_executor_submit(cmd->executor, &submission);
+  iree_task_executor_flush(cmd->executor);
   return iree_ok_status();
 }
 
-typedef struct iree_hal_task_semaphore_wait_cmd_t {
-  iree_task_wait_t task;
-  iree_hal_task_semaphore_t* semaphore;
-  iree_hal_task_timepoint_t timepoint;
-} iree_hal_task_semaphore_wait_cmd_t;
-
-// Cleans up a wait task by returning the event used to the pool and - if the
-// task failed - ensuring we scrub it from the timepoint list.
-static void iree_hal_task_semaphore_wait_cmd_cleanup(
+// Cleans up a chain task by releasing the semaphore and - if the task failed -
+// ensuring we scrub it from the timepoint list so that it cannot be issued
+// after the arena holding it has been freed.
+static void iree_hal_task_semaphore_chain_cmd_cleanup(
     iree_task_t* task, iree_status_code_t status_code) {
-  iree_hal_task_semaphore_wait_cmd_t* cmd =
-      (iree_hal_task_semaphore_wait_cmd_t*)task;
+  iree_hal_task_semaphore_chain_cmd_t* cmd =
+      (iree_hal_task_semaphore_chain_cmd_t*)task;
   if (IREE_UNLIKELY(status_code != IREE_STATUS_OK)) {
     // Abort the timepoint. Note that this is not designed to be fast as
     // semaphore failure is an exceptional case.
-    iree_hal_semaphore_cancel_timepoint(&cmd->semaphore->base,
-                                        &cmd->timepoint.base);
+    iree_hal_semaphore_cancel_timepoint(cmd->semaphore, &cmd->timepoint);
   }
-  iree_event_pool_release(cmd->semaphore->event_pool, 1, &cmd->timepoint.event);
-  iree_hal_semaphore_release((iree_hal_semaphore_t*)cmd->semaphore);
+  iree_hal_semaphore_release(cmd->semaphore);
+}
+
+// Allocates a chain command from |arena| that readies |issue_task| and
+// acquires it as a timepoint on |semaphore| for |minimum_value|.
+static iree_status_t iree_hal_task_semaphore_chain(
+    iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
+    iree_task_t* issue_task, iree_task_executor_t* executor,
+    iree_arena_allocator_t* arena) {
+  iree_hal_task_semaphore_chain_cmd_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd));
+  iree_task_nop_initialize(issue_task->scope, &cmd->task);
+  iree_task_set_cleanup_fn(&cmd->task.header,
+                           iree_hal_task_semaphore_chain_cmd_cleanup);
+  iree_task_set_completion_task(&cmd->task.header, issue_task);
+  cmd->semaphore = semaphore;
+  iree_hal_semaphore_retain(semaphore);
+  cmd->executor = executor;
+  iree_hal_semaphore_acquire_timepoint(
+      semaphore, minimum_value, iree_infinite_timeout(),
+      (iree_hal_semaphore_callback_t){
+          .fn = iree_hal_task_semaphore_chain_cmd_callback,
+          .user_data = cmd,
+      },
+      &cmd->timepoint);
+  return iree_ok_status();
+}
+
+// Chains |issue_task| to a semaphore from another device (such as a CUDA or
+// Vulkan semaphore). Timepoints are notified by the signaling implementation
+// so the other device readies the issue task without any host waits.
+static iree_status_t iree_hal_task_semaphore_enqueue_foreign_timepoint(
+    iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
+    iree_task_t* issue_task, iree_task_executor_t* executor,
+    iree_arena_allocator_t* arena) {
+  uint64_t current_value = 0;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_query(semaphore, &current_value));
+  if (current_value >= minimum_value) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_hal_task_semaphore_chain(
+      semaphore, minimum_value, issue_task, executor, arena));
+  // We don't hold the lock of the other implementation and the value may have
+  // been reached after it was queried; polling resolves the timepoint then.
+  iree_hal_semaphore_poll(semaphore);
+  return iree_ok_status();
 }
 
 iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
     iree_hal_semaphore_t* base_semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission) {
+    iree_task_t* issue_task, iree_task_executor_t* executor,
+    iree_arena_allocator_t* arena) {
+  if (!iree_hal_task_semaphore_isa(base_semaphore)) {
+    return iree_hal_task_semaphore_enqueue_foreign_timepoint(
+        base_semaphore, minimum_value, issue_task, executor, arena);
+  }
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
@@ -253,24 +271,11 @@ iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
     // Semaphore failed; can't enqueue timepoints (they'll reject immediately).
     status = iree_status_clone(semaphore->failure_status);
   } else {
-    // Slow path: acquire a system wait handle and perform a full wait.
-    iree_hal_task_semaphore_wait_cmd_t* cmd = NULL;
-    status = iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd);
-    if (iree_status_is_ok(status)) {
-      status = iree_hal_task_semaphore_acquire_timepoint(
-          semaphore, minimum_value, iree_infinite_timeout(), &cmd->timepoint);
-    }
-    if (iree_status_is_ok(status)) {
-      iree_task_wait_initialize(issue_task->scope,
-                                iree_event_await(&cmd->timepoint.event),
-                                IREE_TIME_INFINITE_FUTURE, &cmd->task);
-      iree_task_set_cleanup_fn(&cmd->task.header,
-                               iree_hal_task_semaphore_wait_cmd_cleanup);
-      iree_task_set_completion_task(&cmd->task.header, issue_task);
-      cmd->semaphore = semaphore;
-      iree_hal_semaphore_retain(base_semaphore);
-      iree_task_submission_enqueue(submission, &cmd->task.header);
-    }
+    // Slow path: chain the issue task to a timepoint. Because we hold the
+    // semaphore lock any signal updating the value after we've checked it
+    // will notify the timepoint once we unlock.
+    status = iree_hal_task_semaphore_chain(base_semaphore, minimum_value,
+                                           issue_task, executor, arena);
   }
 
   iree_slim_mutex_unlock(&semaphore->mutex);
@@ -294,37 +299,28 @@ static iree_status_t iree_hal_task_semaphore_wait(
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_ok_status();
   } else if (iree_timeout_is_immediate(timeout)) {
-    // Not satisfied but a poll, so can avoid the expensive wait handle work.
+    // Not satisfied but a poll, so can avoid the timepoint work.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
-  // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status = iree_hal_task_semaphore_acquire_timepoint(
-      semaphore, value, timeout, &timepoint);
-
   iree_slim_mutex_unlock(&semaphore->mutex);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
-
-  // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
-  }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
 
-  return status;
+  // Slow path: wait on a timepoint that wakes only this thread.
+  iree_hal_semaphore_list_t semaphore_list = {
+      .count = 1,
+      .semaphores = &base_semaphore,
+      .payload_values = &value,
+  };
+  return iree_hal_semaphore_multi_wait_timepoints(
+      IREE_HAL_WAIT_MODE_ALL, semaphore_list, timeout,
+      semaphore->host_allocator);
 }
 
 iree_status_t iree_hal_task_semaphore_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
-    iree_event_pool_t* event_pool, iree_arena_block_pool_t* block_pool) {
+    iree_arena_block_pool_t* block_pool) {
   if (semaphore_list.count == 0) {
     return iree_ok_status();
   } else if (semaphore_list.count == 1) {
@@ -335,66 +331,13 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
-  // Avoid heap allocations by using the device block pool for the wait set.
+  // Each semaphore gets a timepoint that posts a notification owned by this
+  // thread; no system wait handles are needed. Avoid heap allocations for
+  // large lists by using the device block pool for the timepoint storage.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
-  iree_wait_set_t* wait_set = NULL;
-  iree_status_t status = iree_wait_set_allocate(
-      semaphore_list.count, iree_arena_allocator(&arena), &wait_set);
-
-  // Acquire a wait handle for each semaphore timepoint we are to wait on.
-  // TODO(benvanik): flip this API around so we can batch request events from
-  // the event pool. We should be acquiring all required time points in one
-  // call.
-  iree_host_size_t timepoint_count = 0;
-  iree_hal_task_timepoint_t* timepoints = NULL;
-  iree_host_size_t total_timepoint_size =
-      semaphore_list.count * sizeof(timepoints[0]);
-  status =
-      iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
-  if (iree_status_is_ok(status)) {
-    memset(timepoints, 0, total_timepoint_size);
-    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
-      iree_hal_task_semaphore_t* semaphore =
-          iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
-      iree_slim_mutex_lock(&semaphore->mutex);
-      if (semaphore->current_value >= semaphore_list.payload_values[i]) {
-        // Fast path: already satisfied.
-      } else {
-        // Slow path: get a native wait handle for the timepoint.
-        iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
-        status = iree_hal_task_semaphore_acquire_timepoint(
-            semaphore, semaphore_list.payload_values[i], timeout, timepoint);
-        if (iree_status_is_ok(status)) {
-          status = iree_wait_set_insert(wait_set, timepoint->event);
-        }
-      }
-      iree_slim_mutex_unlock(&semaphore->mutex);
-      if (!iree_status_is_ok(status)) break;
-    }
-  }
-
-  // Perform the wait.
-  if (iree_status_is_ok(status)) {
-    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
-    } else {
-      status = iree_wait_all(wait_set, deadline_ns);
-    }
-  }
-
-  // TODO(benvanik): if we flip the API to multi-acquire events from the pool
-  // above then we can multi-release here too.
-  for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
-    iree_hal_semaphore_t* semaphore = timepoints[i].semaphore;
-    if (semaphore) {
-      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i].base);
-      iree_event_pool_release(event_pool, 1, &timepoints[i].event);
-    }
-  }
-  iree_wait_set_free(wait_set);
+  iree_status_t status = iree_hal_semaphore_multi_wait_timepoints(
+      wait_mode, semaphore_list, timeout, iree_arena_allocator(&arena));
   iree_arena_deinitialize(&arena);
 
   IREE_TRACE_ZONE_END(z0);
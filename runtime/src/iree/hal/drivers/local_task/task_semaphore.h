@@ -11,8 +11,8 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/arena.h"
-#include "iree/base/internal/event_pool.h"
 #include "iree/hal/api.h"
+#include "iree/task/executor.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
@@ -23,29 +23,37 @@ extern "C" {
 // Creates a semaphore that integrates with the task system to allow for
 // pipelined wait and signal operations.
 iree_status_t iree_hal_task_semaphore_create(
-    iree_event_pool_t* event_pool, uint64_t initial_value,
-    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore);
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore);
 
 // Returns true if |semaphore| is a task system semaphore.
 bool iree_hal_task_semaphore_isa(iree_hal_semaphore_t* semaphore);
 
 // Reserves a new timepoint in the timeline for the given minimum payload value.
 // |issue_task| will wait until the timeline semaphore is signaled to at least
-// |minimum_value| before proceeding, with a possible wait task generated and
-// appended to the |submission|. Allocations for any intermediates will be made
-// from |arena| whose lifetime must be tied to the submission.
+// |minimum_value| before proceeding. The signaling thread readies
+// |issue_task| directly by submitting a dependency to |executor| without any
+// system wait handles or executor poller involvement. Allocations for any
+// intermediates will be made from |arena| whose lifetime must be tied to the
+// submission.
+//
+// |semaphore| may be from another device (such as CUDA or Vulkan) in which
+// case the timepoint is resolved when that implementation notifies it of the
+// new value; implementations that only observe device-side signals when
+// queried resolve it at that time.
 iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
     iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission);
+    iree_task_t* issue_task, iree_task_executor_t* executor,
+    iree_arena_allocator_t* arena);
 
 // Performs a multi-wait on one or more semaphores.
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait does not complete before
-// |deadline_ns| elapses.
+// |timeout| elapses. Storage for waits on many semaphores is allocated from
+// |block_pool|.
 iree_status_t iree_hal_task_semaphore_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
-    iree_event_pool_t* event_pool, iree_arena_block_pool_t* block_pool);
+    iree_arena_block_pool_t* block_pool);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -56,6 +56,12 @@ typedef struct iree_hal_metal_device_params_t {
   // Larger sizes better support more concurrent/complex command buffers.
   iree_host_size_t queue_uniform_buffer_size;
 
+  // Total size in bytes of the MTLHeap used to sub-allocate device-local
+  // buffers requested with queue-ordered allocations. The heap is created on
+  // first use and allocations that do not fit fall back to dedicated buffers.
+  // 0 disables the heap.
+  iree_device_size_t transient_heap_size;
+
   // Command dispatch type in command buffers.
   // Normally we want to dispatch commands in command buffers in parallel, given
   // that IREE performs explicit dependency tracking and synchronization by
@@ -23,6 +23,9 @@ extern "C" {
 // On macOS, we additionally need the command queue to encode commands to make
 // buffer contents visible to the CPU for managed storage type.
 //
+// |transient_heap_size| bytes are reserved in a MTLHeap on first use of
+// iree_hal_metal_allocator_allocate_transient_buffer; 0 disables the heap.
+//
 // |out_allocator| must be released by the caller (see
 // iree_hal_allocator_release).
 iree_status_t iree_hal_metal_allocator_create(
@@ -31,7 +34,22 @@ iree_status_t iree_hal_metal_allocator_create(
     id<MTLCommandQueue> queue,
 #endif  // IREE_PLATFORM_MACOS
     iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+    iree_device_size_t transient_heap_size, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+// Returns true if |allocator| is a Metal allocator.
+bool iree_hal_metal_allocator_isa(iree_hal_allocator_t* allocator);
+
+// Allocates a buffer as with iree_hal_allocator_allocate_buffer, preferring to
+// sub-allocate device-local buffers from the transient heap.
+//
+// Heap sub-allocation avoids the overhead of creating a dedicated MTLBuffer
+// and is intended for short-lived buffers such as queue-ordered allocations.
+// Falls back to a dedicated buffer when the heap is disabled, the buffer must
+// be host visible, or the heap has no space available.
+iree_status_t iree_hal_metal_allocator_allocate_transient_buffer(
+    iree_hal_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer);
 
 #if defined(IREE_PLATFORM_MACOS)
 // Returns the underyling MetalCommandQueue associated with the given
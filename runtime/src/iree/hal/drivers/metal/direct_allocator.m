@@ -9,6 +9,7 @@
 #import <Metal/Metal.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
@@ -32,6 +33,13 @@ typedef struct iree_hal_metal_allocator_t {
   bool is_unified_memory;
   iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode;
 
+  // Guards lazy creation of |transient_heap|.
+  iree_slim_mutex_t transient_heap_mutex;
+  // Size of the transient heap in bytes; 0 if disabled.
+  iree_device_size_t transient_heap_size IREE_GUARDED_BY(transient_heap_mutex);
+  // Device-local heap transient buffers are sub-allocated from. Created on first use.
+  id<MTLHeap> transient_heap IREE_GUARDED_BY(transient_heap_mutex);
+
   iree_allocator_t host_allocator;
 
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
@@ -56,7 +64,8 @@ iree_status_t iree_hal_metal_allocator_create(
     id<MTLCommandQueue> queue,
 #endif  // IREE_PLATFORM_MACOS
     iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    iree_device_size_t transient_heap_size, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -69,6 +78,9 @@ iree_status_t iree_hal_metal_allocator_create(
     allocator->device = [device retain];  // +1
     allocator->is_unified_memory = [device hasUnifiedMemory];
     allocator->resource_tracking_mode = resource_tracking_mode;
+    allocator->transient_heap_size = transient_heap_size;
+    iree_slim_mutex_initialize(&allocator->transient_heap_mutex);
+    allocator->transient_heap = nil;
     allocator->host_allocator = host_allocator;
 
     *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -83,12 +95,19 @@ static void iree_hal_metal_allocator_destroy(iree_hal_allocator_t* IREE_RESTRICT
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Buffers sub-allocated from the heap retain it and may outlive the allocator.
+  [allocator->transient_heap release];  // -1
+  iree_slim_mutex_deinitialize(&allocator->transient_heap_mutex);
   [allocator->device release];  // -1
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+bool iree_hal_metal_allocator_isa(iree_hal_allocator_t* allocator) {
+  return iree_hal_resource_is(allocator, &iree_hal_metal_allocator_vtable);
+}
+
 static iree_allocator_t iree_hal_metal_allocator_host_allocator(
     const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_metal_allocator_t* allocator = (iree_hal_metal_allocator_t*)base_allocator;
@@ -230,6 +249,32 @@ static MTLResourceOptions iree_hal_metal_select_resource_options(
   return options;
 }
 
+// Wraps a newly created |metal_buffer| allocated with |compat_params| in a HAL buffer.
+static iree_status_t iree_hal_metal_allocator_wrap_new_buffer(
+    iree_hal_metal_allocator_t* allocator, const iree_hal_buffer_params_t* compat_params,
+    iree_device_size_t allocation_size, id<MTLBuffer> metal_buffer,
+    iree_hal_buffer_t** out_buffer) {
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_metal_buffer_wrap(
+#if defined(IREE_PLATFORM_MACOS)
+      allocator->queue,
+#endif  // IREE_PLATFORM_MACOS
+      metal_buffer, (iree_hal_allocator_t*)allocator, compat_params->type, compat_params->access,
+      compat_params->usage, allocation_size, /*byte_offset=*/0, /*byte_length=*/allocation_size,
+      iree_hal_buffer_release_callback_null(), &buffer);  // +1
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED(IREE_HAL_METAL_ALLOCATOR_ID, (void*)iree_hal_metal_buffer_handle(buffer),
+                           allocation_size);
+    IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
+        &allocator->statistics, compat_params->type, allocation_size));
+    *out_buffer = buffer;
+  } else {
+    if (buffer) iree_hal_buffer_release(buffer);
+  }
+  return status;
+}
+
 static iree_status_t iree_hal_metal_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params, iree_device_size_t allocation_size,
@@ -273,25 +318,79 @@ static iree_status_t iree_hal_metal_allocator_allocate_buffer(
     IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED, "unable to allocate buffer");
   }
-  iree_hal_buffer_t* buffer = NULL;
-  iree_status_t status = iree_hal_metal_buffer_wrap(
-#if defined(IREE_PLATFORM_MACOS)
-      allocator->queue,
-#endif  // IREE_PLATFORM_MACOS
-      metal_buffer, base_allocator, compat_params.type, compat_params.access, compat_params.usage,
-      allocation_size, /*byte_offset=*/0, /*byte_length=*/allocation_size,
-      iree_hal_buffer_release_callback_null(), &buffer);  // +1
+  iree_status_t status = iree_hal_metal_allocator_wrap_new_buffer(
+      allocator, &compat_params, allocation_size, metal_buffer, out_buffer);
+  [metal_buffer release];  // -1
 
-  if (iree_status_is_ok(status)) {
-    IREE_TRACE_ALLOC_NAMED(IREE_HAL_METAL_ALLOCATOR_ID, (void*)iree_hal_metal_buffer_handle(buffer),
-                           allocation_size);
-    IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, compat_params.type, allocation_size));
-    *out_buffer = buffer;
-  } else {
-    if (buffer) iree_hal_buffer_release(buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns the transient heap, creating it if needed, or nil if it is disabled or creation failed.
+static id<MTLHeap> iree_hal_metal_allocator_get_transient_heap(
+    iree_hal_metal_allocator_t* allocator) {
+  iree_slim_mutex_lock(&allocator->transient_heap_mutex);
+  if (!allocator->transient_heap && allocator->transient_heap_size != 0) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    MTLHeapDescriptor* descriptor = [MTLHeapDescriptor new];  // +1
+    descriptor.type = MTLHeapTypeAutomatic;
+    descriptor.storageMode = MTLStorageModePrivate;
+    descriptor.hazardTrackingMode =
+        allocator->resource_tracking_mode == IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_TRACKED
+            ? MTLHazardTrackingModeTracked
+            : MTLHazardTrackingModeUntracked;
+    descriptor.size = allocator->transient_heap_size;
+    allocator->transient_heap = [allocator->device newHeapWithDescriptor:descriptor];  // +1
+    [descriptor release];                                                               // -1
+    if (!allocator->transient_heap) {
+      // Don't retry on every allocation if the device cannot reserve the heap.
+      allocator->transient_heap_size = 0;
+    }
+    IREE_TRACE_ZONE_END(z0);
+  }
+  id<MTLHeap> heap = allocator->transient_heap;
+  iree_slim_mutex_unlock(&allocator->transient_heap_mutex);
+  return heap;
+}
+
+iree_status_t iree_hal_metal_allocator_allocate_transient_buffer(
+    iree_hal_allocator_t* base_allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
+
+  // Only device-local buffers the host never maps are placed in the private heap; everything else
+  // (including buffers the allocator cannot allocate) takes the regular path.
+  iree_hal_buffer_params_t compat_params = *params;
+  iree_device_size_t compat_allocation_size = allocation_size;
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_metal_allocator_query_buffer_compatibility(base_allocator, &compat_params,
+                                                          &compat_allocation_size);
+  MTLResourceOptions options = iree_hal_metal_select_resource_options(
+      compat_params.type, allocator->is_unified_memory, allocator->resource_tracking_mode);
+  id<MTLHeap> heap = nil;
+  if (iree_all_bits_set(compatibility, IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE) &&
+      (options & MTLResourceStorageModeMask) == MTLResourceStorageModePrivate) {
+    heap = iree_hal_metal_allocator_get_transient_heap(allocator);
+  }
+  if (!heap) {
+    return iree_hal_metal_allocator_allocate_buffer(base_allocator, params, allocation_size,
+                                                    out_buffer);
   }
 
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, compat_allocation_size);
+
+  // Sub-allocate from the heap; the memory returns to the heap when the buffer is released.
+  id<MTLBuffer> metal_buffer = [heap newBufferWithLength:compat_allocation_size
+                                                 options:heap.resourceOptions];  // +1
+  if (!metal_buffer) {
+    // The heap is full or too fragmented.
+    IREE_TRACE_ZONE_END(z0);
+    return iree_hal_metal_allocator_allocate_buffer(base_allocator, params, allocation_size,
+                                                    out_buffer);
+  }
+  iree_status_t status = iree_hal_metal_allocator_wrap_new_buffer(
+      allocator, &compat_params, compat_allocation_size, metal_buffer, out_buffer);
   [metal_buffer release];  // -1
 
   IREE_TRACE_ZONE_END(z0);
@@ -20,7 +20,10 @@ extern "C" {
 #endif  // __cplusplus
 
 // Creates a Metal command buffer that directly records into a MTLCommandBuffer.
-// Such command buffers are one shot--they can only be submitted once.
+// One-shot command buffers are recorded into a single MTLCommandBuffer when
+// ended and can only be submitted once. Reusable command buffers retain their
+// recorded commands and replay them into a new MTLCommandBuffer for each
+// submission (see iree_hal_metal_direct_command_buffer_prepare_submission).
 //
 // The command buffer would have the given |mode| and be recorded and submitted
 // to the given |queue|.
@@ -57,6 +60,15 @@ bool iree_hal_metal_direct_command_buffer_isa(
 id<MTLCommandBuffer> iree_hal_metal_direct_command_buffer_handle(
     const iree_hal_command_buffer_t* command_buffer);
 
+// Returns in |out_handle| the Metal command buffer to commit for a submission
+// of |command_buffer|. For one-shot command buffers this is the underlying
+// handle; reusable command buffers replay their recorded commands into a new
+// autoreleased handle that must be committed within the caller's autorelease
+// pool. Thread-safe.
+iree_status_t iree_hal_metal_direct_command_buffer_prepare_submission(
+    iree_hal_command_buffer_t* command_buffer,
+    id<MTLCommandBuffer>* out_handle);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
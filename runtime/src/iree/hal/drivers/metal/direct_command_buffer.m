@@ -9,6 +9,7 @@
 #import <Metal/Metal.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
@@ -18,6 +19,7 @@
 #include "iree/hal/drivers/metal/metal_device.h"
 #include "iree/hal/drivers/metal/pipeline_layout.h"
 #include "iree/hal/drivers/metal/staging_buffer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 //===------------------------------------------------------------------------------------------===//
@@ -90,6 +92,12 @@ typedef struct iree_hal_metal_dispatch_segment_t {
   iree_host_size_t push_constant_count;
   // The list of push constants, pointing to the end of the segment allocation.
   int32_t* push_constants;
+
+  // Whether argument buffers for all bound descriptor sets have been encoded into the staging
+  // buffer at |argument_buffer_offsets|. Argument buffers are encoded when the segment is first
+  // recorded and reused when reusable command buffers replay the segment.
+  bool argument_buffers_encoded;
+  uint32_t argument_buffer_offsets[IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
 } iree_hal_metal_dispatch_segment_t;
 // + Additional inline allocation for holding all bound descriptors.
 // + Additional inline allocation for holding all push constants.
@@ -157,6 +165,16 @@ static void iree_hal_metal_command_segment_list_push_back(
 // iree_hal_metal_command_buffer_t
 //===------------------------------------------------------------------------------------------===//
 
+// Maximum number of argument encoders cached per command buffer.
+#define IREE_HAL_METAL_ARGUMENT_ENCODER_CACHE_CAPACITY 8
+
+// An argument encoder reused across dispatches of the same kernel function and descriptor set.
+typedef struct iree_hal_metal_argument_encoder_entry_t {
+  id<MTLFunction> function;
+  uint32_t set;
+  id<MTLArgumentEncoder> encoder;
+} iree_hal_metal_argument_encoder_entry_t;
+
 typedef struct iree_hal_metal_command_buffer_t {
   iree_hal_command_buffer_t base;
 
@@ -185,8 +203,15 @@ typedef struct iree_hal_metal_command_buffer_t {
   // Linked list of command segments to be recorded into a command buffer.
   iree_hal_metal_command_segment_list_t segments;
 
+  // The Metal command buffer being recorded into. One-shot command buffers own it for their whole
+  // lifetime; reusable command buffers only set it while replaying segments for a submission.
   id<MTLCommandBuffer> command_buffer;
 
+  iree_hal_metal_command_buffer_resource_reference_mode_t resource_reference_mode;
+
+  // Serializes segment replay for reusable command buffers submitted from multiple threads.
+  iree_slim_mutex_t replay_mutex;
+
   MTLDispatchType dispatch_type;
 
   struct {
@@ -217,6 +242,13 @@ typedef struct iree_hal_metal_command_buffer_t {
     // push_constants updates.
     int32_t push_constants[IREE_HAL_METAL_MAX_PUSH_CONSTANT_COUNT];
   } state;
+
+  // Argument encoders created for dispatches recorded into the command buffer. Creating an argument
+  // encoder from a kernel function is comparatively expensive and command buffers typically
+  // dispatch a handful of distinct kernels many times. Entries are evicted round-robin.
+  iree_hal_metal_argument_encoder_entry_t
+      argument_encoders[IREE_HAL_METAL_ARGUMENT_ENCODER_CACHE_CAPACITY];
+  iree_host_size_t next_argument_encoder_slot;
 } iree_hal_metal_command_buffer_t;
 
 //===------------------------------------------------------------------------------------------===//
@@ -244,6 +276,21 @@ id<MTLCommandBuffer> iree_hal_metal_direct_command_buffer_handle(
   return command_buffer->command_buffer;
 }
 
+// Returns a new autoreleased Metal command buffer created from |queue|.
+static id<MTLCommandBuffer> iree_hal_metal_command_buffer_new_handle(
+    id<MTLCommandQueue> queue,
+    iree_hal_metal_command_buffer_resource_reference_mode_t resource_reference_mode) {
+  // We track resource lifetime by ourselves in IREE; so just do unretained references to
+  // resources in Metal command buffer, which avoids overhead and gives better performance.
+  MTLCommandBufferDescriptor* descriptor = [MTLCommandBufferDescriptor new];  // +1
+  descriptor.retainedReferences =
+      resource_reference_mode == IREE_HAL_METAL_COMMAND_BUFFER_RESOURCE_REFERENCE_MODE_RETAINED;
+  descriptor.errorOptions = MTLCommandBufferErrorOptionNone;
+  id<MTLCommandBuffer> handle = [queue commandBufferWithDescriptor:descriptor];  // autoreleased
+  [descriptor release];                                                         // -1
+  return handle;
+}
+
 static void iree_hal_metal_end_compute_encoder(iree_hal_metal_command_buffer_t* command_buffer) {
   if (command_buffer->state.compute_encoder) {
     [command_buffer->state.compute_encoder endEncoding];
@@ -341,15 +388,9 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
-  IREE_ASSERT_TRUE(iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT));
   IREE_ASSERT_TRUE(!iree_any_bit_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED));
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "indirect command buffer not yet supported");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_metal_command_buffer_t* command_buffer = NULL;
@@ -365,19 +406,19 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
   iree_arena_initialize(block_pool, &command_buffer->arena);
   command_buffer->staging_buffer = staging_buffer;
   command_buffer->host_allocator = host_allocator;
+  command_buffer->resource_reference_mode = resource_reference_mode;
+  iree_slim_mutex_initialize(&command_buffer->replay_mutex);
   iree_status_t status = iree_hal_resource_set_allocate(block_pool, &command_buffer->resource_set);
   if (iree_status_is_ok(status)) {
     iree_hal_metal_command_segment_list_reset(&command_buffer->segments);
-    @autoreleasepool {  // Use @autoreleasepool to trigger the autorelease within encoder creation.
-      // We track resource lifetime by ourselves in IREE; so just do unretained references to
-      // resources in Metal command buffer, which avoids overhead and gives better performance.
-      MTLCommandBufferDescriptor* descriptor = [MTLCommandBufferDescriptor new];  // +1
-      descriptor.retainedReferences =
-          resource_reference_mode == IREE_HAL_METAL_COMMAND_BUFFER_RESOURCE_REFERENCE_MODE_RETAINED;
-      descriptor.errorOptions = MTLCommandBufferErrorOptionNone;
-      command_buffer->command_buffer =
-          [[queue commandBufferWithDescriptor:descriptor] retain];  // +1
-      [descriptor release];                                         // -1
+    // Reusable command buffers get a new Metal command buffer for each submission instead.
+    if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+      // Use @autoreleasepool to trigger the autorelease within encoder creation.
+      @autoreleasepool {
+        command_buffer->command_buffer =
+            [iree_hal_metal_command_buffer_new_handle(queue, resource_reference_mode)
+                retain];  // +1
+      }
     }
     const iree_hal_metal_device_params_t* params = iree_hal_metal_device_params(device);
     command_buffer->dispatch_type =
@@ -413,11 +454,15 @@ static void iree_hal_metal_command_buffer_destroy_internal(
       iree_hal_metal_command_buffer_cast(base_command_buffer);
 
   iree_hal_metal_command_buffer_reset(command_buffer);
+  for (iree_host_size_t i = 0; i < IREE_HAL_METAL_ARGUMENT_ENCODER_CACHE_CAPACITY; ++i) {
+    [command_buffer->argument_encoders[i].encoder release];  // -1
+  }
   [command_buffer->state.encoder_event release];  // -1
   IREE_ASSERT_EQ(command_buffer->state.compute_encoder, nil);
   IREE_ASSERT_EQ(command_buffer->state.blit_encoder, nil);
   [command_buffer->command_buffer release];  // -1
   [command_buffer->queue release];           // -1
+  iree_slim_mutex_deinitialize(&command_buffer->replay_mutex);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_allocator_free(command_buffer->host_allocator, command_buffer);
@@ -987,6 +1032,28 @@ static iree_status_t iree_hal_metal_command_segment_create_dispatch(
   return iree_ok_status();
 }
 
+// Returns an argument encoder for descriptor |set| of |function|, reusing a cached one if possible.
+// The returned encoder is owned by the command buffer.
+static id<MTLArgumentEncoder> iree_hal_metal_command_buffer_get_argument_encoder(
+    iree_hal_metal_command_buffer_t* command_buffer, id<MTLFunction> function, uint32_t set) {
+  for (iree_host_size_t i = 0; i < IREE_HAL_METAL_ARGUMENT_ENCODER_CACHE_CAPACITY; ++i) {
+    iree_hal_metal_argument_encoder_entry_t* entry = &command_buffer->argument_encoders[i];
+    if (entry->function == function && entry->set == set && entry->encoder != nil) {
+      return entry->encoder;
+    }
+  }
+  iree_hal_metal_argument_encoder_entry_t* entry =
+      &command_buffer->argument_encoders[command_buffer->next_argument_encoder_slot];
+  command_buffer->next_argument_encoder_slot =
+      (command_buffer->next_argument_encoder_slot + 1) %
+      IREE_HAL_METAL_ARGUMENT_ENCODER_CACHE_CAPACITY;
+  [entry->encoder release];  // -1
+  entry->function = function;
+  entry->set = set;
+  entry->encoder = [function newArgumentEncoderWithBufferIndex:set];  // +1
+  return entry->encoder;
+}
+
 static iree_status_t iree_hal_metal_command_segment_record_dispatch(
     iree_hal_metal_command_buffer_t* command_buffer, iree_hal_metal_dispatch_segment_t* segment) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -1008,41 +1075,70 @@ static iree_status_t iree_hal_metal_command_segment_record_dispatch(
   for (iree_host_size_t i = 0; i < segment->descriptor_count;) {
     uint32_t current_set = descriptors[i].set;
 
-    // Build argument encoder and argument buffer for the current descriptor set.
+    // Build argument encoder and argument buffer for the current descriptor set. Replays of
+    // reusable command buffers reuse the argument buffer encoded by the first recording; the
+    // staging buffer keeps it alive as long as the command buffer exists.
     // TODO(antiagainst): Use a cache layer to cache and reuse argument buffers with the same
     // content, to avoid duplicating overhead.
     id<MTLBuffer> argument_buffer = command_buffer->staging_buffer->metal_buffer;
-    id<MTLArgumentEncoder> argument_encoder =
-        [segment->kernel_params.function newArgumentEncoderWithBufferIndex:current_set];  // +1
-    IREE_ASSERT(argument_encoder != nil);
-
-    // Reserve space for the argument buffer from shared staging buffer.
-    iree_byte_span_t reservation;
-    uint32_t argument_buffer_offset;
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_hal_metal_staging_buffer_reserve(
-                command_buffer->staging_buffer, argument_encoder.encodedLength,
-                argument_encoder.alignment, &reservation, &argument_buffer_offset));
-    [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
+    id<MTLArgumentEncoder> argument_encoder = nil;
+    uint32_t argument_buffer_offset = segment->argument_buffer_offsets[current_set];
+    if (!segment->argument_buffers_encoded) {
+      argument_encoder = iree_hal_metal_command_buffer_get_argument_encoder(
+          command_buffer, segment->kernel_params.function, current_set);
+      IREE_ASSERT(argument_encoder != nil);
+
+      // Reserve space for the argument buffer from shared staging buffer.
+      iree_byte_span_t reservation;
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_hal_metal_staging_buffer_reserve(
+                  command_buffer->staging_buffer, argument_encoder.encodedLength,
+                  argument_encoder.alignment, &reservation, &argument_buffer_offset));
+      [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
+      segment->argument_buffer_offsets[current_set] = argument_buffer_offset;
+    }
 
     // Now record all bound buffers belonging to the current set into the argument buffer.
+    // Buffer usages are gathered by usage kind so they can be declared with one call each.
+    id<MTLResource> read_resources[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+    id<MTLResource> write_resources[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+    NSUInteger read_resource_count = 0;
+    NSUInteger write_resource_count = 0;
     for (; i < segment->descriptor_count && descriptors[i].set == current_set; ++i) {
       uint32_t current_binding = descriptors[i].binding;
       id<MTLBuffer> current_buffer =
           iree_hal_metal_buffer_handle(iree_hal_buffer_allocated_buffer(descriptors[i].buffer));
       iree_host_size_t offset =
           iree_hal_buffer_byte_offset(descriptors[i].buffer) + descriptors[i].offset;
-      [argument_encoder setBuffer:current_buffer offset:offset atIndex:current_binding];
+      if (argument_encoder) {
+        [argument_encoder setBuffer:current_buffer offset:offset atIndex:current_binding];
+      }
+
+      if (descriptors[i].usage & MTLResourceUsageWrite) {
+        write_resources[write_resource_count++] = current_buffer;
+      } else {
+        read_resources[read_resource_count++] = current_buffer;
+      }
+    }
 
-      // Also record buffer usages.
-      [compute_encoder useResource:current_buffer usage:descriptors[i].usage];
+    // Also record buffer usages.
+    if (read_resource_count > 0) {
+      [compute_encoder useResources:read_resources
+                              count:read_resource_count
+                              usage:MTLResourceUsageRead];
     }
+    if (write_resource_count > 0) {
+      [compute_encoder useResources:write_resources
+                              count:write_resource_count
+                              usage:MTLResourceUsageRead | MTLResourceUsageWrite];
+    }
+
     // Record the argument buffer.
     [compute_encoder setBuffer:argument_buffer offset:argument_buffer_offset atIndex:current_set];
-
-    [argument_encoder release];  // -1
   }
 
+  segment->argument_buffers_encoded = true;
+
   // Record the dispatch, either direct or indirect.
   uint32_t* workgroup_size = segment->kernel_params.threadgroup_size;
   if (segment->workgroups_buffer == nil) {
@@ -1104,7 +1200,14 @@ static iree_status_t iree_hal_metal_command_buffer_prepare_dispatch_indirect(
 static iree_status_t iree_hal_metal_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "secondary command buffer not yet supported");
+  // Nested command buffers are recorded as deferred command buffers and replayed into this command
+  // buffer with the binding table resolved.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(base_commands, base_command_buffer,
+                                                  binding_table);
+  }
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "only deferred command buffers can be executed indirectly");
 }
 
 static iree_status_t iree_hal_metal_command_segment_record(
@@ -1155,12 +1258,45 @@ static iree_status_t iree_hal_metal_command_buffer_end(
       iree_hal_metal_command_buffer_cast(base_command_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_hal_metal_command_segment_record(command_buffer));
+  // Reusable command buffers keep their segments and record them at each submission.
+  if (iree_all_bits_set(iree_hal_command_buffer_mode(base_command_buffer),
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_hal_metal_command_segment_record(command_buffer));
+    iree_hal_metal_end_blit_encoder(command_buffer);
+    iree_hal_metal_end_compute_encoder(command_buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_metal_direct_command_buffer_prepare_submission(
+    iree_hal_command_buffer_t* base_command_buffer, id<MTLCommandBuffer>* out_handle) {
+  iree_hal_metal_command_buffer_t* command_buffer =
+      iree_hal_metal_command_buffer_cast(base_command_buffer);
+  *out_handle = nil;
+
+  if (iree_all_bits_set(iree_hal_command_buffer_mode(base_command_buffer),
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    *out_handle = command_buffer->command_buffer;
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&command_buffer->replay_mutex);
+
+  id<MTLCommandBuffer> handle = iree_hal_metal_command_buffer_new_handle(
+      command_buffer->queue, command_buffer->resource_reference_mode);  // autoreleased
+  command_buffer->command_buffer = handle;
+  iree_status_t status = iree_hal_metal_command_segment_record(command_buffer);
   iree_hal_metal_end_blit_encoder(command_buffer);
   iree_hal_metal_end_compute_encoder(command_buffer);
+  command_buffer->command_buffer = nil;
 
+  iree_slim_mutex_unlock(&command_buffer->replay_mutex);
+  if (iree_status_is_ok(status)) *out_handle = handle;
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static const iree_hal_command_buffer_vtable_t iree_hal_metal_command_buffer_vtable = {
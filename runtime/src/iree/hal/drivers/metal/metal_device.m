@@ -18,6 +18,8 @@
 #include "iree/hal/drivers/metal/shared_event.h"
 #include "iree/hal/drivers/metal/staging_buffer.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 #include "iree/hal/utils/resource_set.h"
@@ -77,6 +79,7 @@ void iree_hal_metal_device_params_initialize(iree_hal_metal_device_params_t* out
   memset(out_params, 0, sizeof(*out_params));
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_uniform_buffer_size = IREE_HAL_METAL_STAGING_BUFFER_DEFAULT_CAPACITY;
+  out_params->transient_heap_size = 64 * 1024 * 1024;
   out_params->command_dispatch_type = IREE_HAL_METAL_COMMAND_DISPATCH_TYPE_CONCURRENT;
   out_params->command_buffer_resource_reference_mode =
       IREE_HAL_METAL_COMMAND_BUFFER_RESOURCE_REFERENCE_MODE_UNRETAINED;
@@ -128,6 +131,7 @@ static iree_status_t iree_hal_metal_device_create_internal(
                                                          metal_queue,
 #endif  // IREE_PLATFORM_MACOS
                                                          params->resource_hazard_tracking_mode,
+                                                         params->transient_heap_size,
                                                          host_allocator, &device->device_allocator);
 
   if (iree_status_is_ok(status)) {
@@ -242,11 +246,13 @@ static iree_status_t iree_hal_metal_device_create_command_buffer(
     iree_host_size_t binding_capacity, iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_metal_device_t* device = iree_hal_metal_device_cast(base_device);
 
-  if (iree_any_bit_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED))
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "nested command buffer not yet supported");
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT))
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "multi-shot command buffer not yet supported");
+  // Indirect command buffers are recorded once and replayed into each command buffer executing them
+  // with its binding table.
+  if (iree_any_bit_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED) || binding_capacity > 0) {
+    return iree_hal_deferred_command_buffer_create(base_device, mode, command_categories,
+                                                   binding_capacity, &device->block_pool,
+                                                   device->host_allocator, out_command_buffer);
+  }
 
   return iree_hal_metal_direct_command_buffer_create(
       base_device, mode, command_categories, binding_capacity,
@@ -283,13 +289,18 @@ static iree_status_t iree_hal_metal_device_import_file(iree_hal_device_t* base_d
                                                        iree_io_file_handle_t* handle,
                                                        iree_hal_external_file_flags_t flags,
                                                        iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                            "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(queue_affinity, access, handle,
+                                       iree_hal_device_allocator(base_device),
+                                       iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(access, handle,
+                                          iree_hal_device_host_allocator(base_device), out_file);
+    default:
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(queue_affinity, access, handle,
-                                   iree_hal_device_allocator(base_device),
-                                   iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_metal_device_create_pipeline_layout(
@@ -330,8 +341,16 @@ static iree_status_t iree_hal_metal_device_queue_alloca(
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   // TODO(benvanik): queue-ordered allocations.
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list, iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
-                                                          params, allocation_size, out_buffer));
+  iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(base_device);
+  if (iree_hal_metal_allocator_isa(device_allocator)) {
+    // Queue-ordered allocations are usually short-lived transients; sub-allocate them from the
+    // transient heap when possible to avoid creating dedicated buffers.
+    IREE_RETURN_IF_ERROR(iree_hal_metal_allocator_allocate_transient_buffer(
+        device_allocator, &params, allocation_size, out_buffer));
+  } else {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_allocator_allocate_buffer(device_allocator, params, allocation_size, out_buffer));
+  }
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
   return iree_ok_status();
 }
@@ -383,6 +402,34 @@ static iree_status_t iree_hal_metal_device_queue_write(
   return loop_status;
 }
 
+// Replays the deferred |command_buffer| into a one-shot direct command buffer retained by
+// |resource_set| until the submission completes.
+static iree_status_t iree_hal_metal_device_replay_deferred_command_buffer(
+    iree_hal_metal_device_t* device, iree_hal_command_buffer_t* command_buffer,
+    iree_hal_resource_set_t* resource_set, iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_command_buffer_t* direct_command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_metal_direct_command_buffer_create(
+      (iree_hal_device_t*)device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_ANY, /*binding_capacity=*/0,
+      device->command_buffer_resource_reference_mode, device->queue, &device->block_pool,
+      &device->staging_buffer, device->builtin_executable, device->host_allocator,
+      &direct_command_buffer));
+  iree_status_t status = iree_hal_resource_set_insert(resource_set, 1, &direct_command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_begin(direct_command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_deferred_command_buffer_apply(command_buffer, direct_command_buffer,
+                                                    iree_hal_buffer_binding_table_empty());
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(direct_command_buffer);
+  }
+  if (iree_status_is_ok(status)) *out_command_buffer = direct_command_buffer;
+  iree_hal_command_buffer_release(direct_command_buffer);
+  return status;
+}
+
 static iree_status_t iree_hal_metal_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -411,55 +458,73 @@ static iree_status_t iree_hal_metal_device_queue_execute(
 
   if (iree_status_is_ok(status)) {
     @autoreleasepool {
-      // First create a new command buffer and encode wait commands for all wait semaphores.
-      if (wait_semaphore_list.count > 0) {
-        id<MTLCommandBuffer> wait_command_buffer = [device->queue
-            commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
-        for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
-          id<MTLSharedEvent> handle =
-              iree_hal_metal_shared_event_handle(wait_semaphore_list.semaphores[i]);
-          [wait_command_buffer encodeWaitForEvent:handle
-                                            value:wait_semaphore_list.payload_values[i]];
+      // Prepare all Metal command buffers before committing anything so that failures to replay
+      // reusable command buffers leave the queue untouched.
+      id<MTLCommandBuffer>* handles =
+          (id<MTLCommandBuffer>*)iree_alloca(command_buffer_count * sizeof(id<MTLCommandBuffer>));
+      for (iree_host_size_t i = 0; i < command_buffer_count && iree_status_is_ok(status); ++i) {
+        iree_hal_command_buffer_t* command_buffer = command_buffers[i];
+        if (iree_hal_deferred_command_buffer_isa(command_buffer)) {
+          status = iree_hal_metal_device_replay_deferred_command_buffer(device, command_buffer,
+                                                                        resource_set,
+                                                                        &command_buffer);
+        }
+        if (iree_status_is_ok(status)) {
+          status = iree_hal_metal_direct_command_buffer_prepare_submission(command_buffer,
+                                                                           &handles[i]);
         }
-        [wait_command_buffer commit];
       }
+      if (iree_status_is_ok(status)) {
+        // First create a new command buffer and encode wait commands for all wait semaphores.
+        if (wait_semaphore_list.count > 0) {
+          id<MTLCommandBuffer> wait_command_buffer = [device->queue
+              commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
+          for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+            id<MTLSharedEvent> handle =
+                iree_hal_metal_shared_event_handle(wait_semaphore_list.semaphores[i]);
+            [wait_command_buffer encodeWaitForEvent:handle
+                                              value:wait_semaphore_list.payload_values[i]];
+          }
+          [wait_command_buffer commit];
+        }
 
-      // Then commit all recorded compute command buffers, except the last one, which we will patch
-      // up with semaphore signaling.
-      id<MTLCommandBuffer> signal_command_buffer = nil;
-      for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
-        iree_hal_command_buffer_t* command_buffer = command_buffers[i];
-        id<MTLCommandBuffer> handle = iree_hal_metal_direct_command_buffer_handle(command_buffer);
-        if (i + 1 != command_buffer_count) [handle commit];
-        signal_command_buffer = handle;
-      }
-      if (signal_command_buffer == nil) {
-        signal_command_buffer = [device->queue
-            commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
-      }
+        // Then commit all recorded compute command buffers, except the last one, which we will
+        // patch up with semaphore signaling.
+        id<MTLCommandBuffer> signal_command_buffer = nil;
+        for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+          id<MTLCommandBuffer> handle = handles[i];
+          if (i + 1 != command_buffer_count) [handle commit];
+          signal_command_buffer = handle;
+        }
+        if (signal_command_buffer == nil) {
+          signal_command_buffer = [device->queue
+              commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
+        }
 
-      // Finally encode signal commands for all signal semaphores.
-      for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
-        id<MTLSharedEvent> handle =
-            iree_hal_metal_shared_event_handle(signal_semaphore_list.semaphores[i]);
-        [signal_command_buffer encodeSignalEvent:handle
-                                           value:signal_semaphore_list.payload_values[i]];
-      }
+        // Finally encode signal commands for all signal semaphores.
+        for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+          id<MTLSharedEvent> handle =
+              iree_hal_metal_shared_event_handle(signal_semaphore_list.semaphores[i]);
+          [signal_command_buffer encodeSignalEvent:handle
+                                             value:signal_semaphore_list.payload_values[i]];
+        }
 
-      // We use a resource set to keep track of resources in the above. So here we need to retain
-      // the device to make sure the block pool behind outlives the resource set.
-      iree_hal_device_retain(base_device);
-      [signal_command_buffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
-        // Now we can release all retained resources.
-        iree_hal_resource_set_free(resource_set);
-        // And then release the device handle. Note that this must happen separately--if we put the
-        // device itself in the resource set, we can destroy the block pool data structure inside
-        // the device prematurely, before the resource set free procedure done scanning it.
-        iree_hal_device_release(base_device);
-      }];
-      [signal_command_buffer commit];
+        // We use a resource set to keep track of resources in the above. So here we need to retain
+        // the device to make sure the block pool behind outlives the resource set.
+        iree_hal_device_retain(base_device);
+        [signal_command_buffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+          // Now we can release all retained resources.
+          iree_hal_resource_set_free(resource_set);
+          // And then release the device handle. Note that this must happen separately--if we put
+          // the device itself in the resource set, we can destroy the block pool data structure
+          // inside the device prematurely, before the resource set free procedure done scanning it.
+          iree_hal_device_release(base_device);
+        }];
+        [signal_command_buffer commit];
+      }
     }
-  } else {
+  }
+  if (!iree_status_is_ok(status)) {
     iree_hal_resource_set_free(resource_set);
   }
 
@@ -24,6 +24,9 @@ IREE_FLAG(bool, metal_command_buffer_retain_resources, false,
 IREE_FLAG(bool, metal_resource_hazard_tracking, false,
           "Enables automatic Metal hazard tracking for diagnosing concurrency "
           "issues");
+IREE_FLAG(int64_t, metal_transient_heap_size, 64 * 1024 * 1024,
+          "Size in bytes of the Metal heap used to sub-allocate queue-ordered "
+          "allocations; 0 disables the heap");
 
 static iree_status_t iree_hal_metal_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
@@ -70,6 +73,8 @@ static iree_status_t iree_hal_metal_driver_factory_try_create(
       FLAG_metal_resource_hazard_tracking
           ? IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_TRACKED
           : IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_UNTRACKED;
+  device_params.transient_heap_size =
+      (iree_device_size_t)iree_max(0, FLAG_metal_transient_heap_size);
 
   iree_status_t status = iree_hal_metal_driver_create(
       driver_name, &device_params, host_allocator, out_driver);
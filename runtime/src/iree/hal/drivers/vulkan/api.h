@@ -94,6 +94,15 @@ enum iree_hal_vulkan_feature_bits_t {
   // Enables buffer device addresses when supported and uses them when
   // appropriately compiled SPIR-V executables require them.
   IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES = 1u << 6,
+
+  // Enables VK_EXT_descriptor_buffer when supported and writes dispatch
+  // bindings directly into descriptor buffers instead of allocating and
+  // updating descriptor sets. Requires buffer device addresses.
+  //
+  // NOTE: all buffers bound to dispatches must have been created with
+  // VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT. Buffers allocated by the HAL
+  // always are but buffers wrapped from external VkBuffers must be as well.
+  IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS = 1u << 7,
 };
 typedef uint32_t iree_hal_vulkan_features_t;
 
@@ -213,6 +222,29 @@ typedef uint32_t iree_hal_vulkan_device_flags_t;
 typedef struct iree_hal_vulkan_device_options_t {
   // Flags controlling device behavior.
   iree_hal_vulkan_device_flags_t flags;
+
+  // Optional directory used to persist VkPipelineCache contents across
+  // processes. When set each executable's pipeline cache is loaded from
+  // `<pipelineCacheUUID>-<executable hash>.vkpipelinecache` in the directory
+  // prior to pipeline creation and saved there afterward if it was missing or
+  // invalid. The directory must exist and be writable. Empty disables
+  // persistent caching. The string is copied by the driver and device.
+  iree_string_view_t pipeline_cache_path;
+
+  // Maximum number of queue submissions held by each queue and issued together
+  // in a single vkQueueSubmit. Values of 0 or 1 issue each submission
+  // immediately. Held submissions are issued when the count is reached, when
+  // a submission arrives after |submission_batch_window_ns| has elapsed since
+  // the oldest held one, when the queue is flushed, or when the host waits on
+  // or queries a semaphore created by the device.
+  //
+  // NOTE: submissions signaling semaphores exported via
+  // iree_hal_vulkan_semaphore_handle and waited on outside of the HAL must be
+  // flushed with iree_hal_device_queue_flush.
+  iree_host_size_t submission_batch_max_count;
+
+  // Time a held submission may wait for more submissions to batch with.
+  iree_duration_t submission_batch_window_ns;
 } iree_hal_vulkan_device_options_t;
 
 IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
@@ -323,6 +355,39 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_allocated_buffer_handle(
     iree_hal_buffer_t* allocated_buffer, VkDeviceMemory* out_memory,
     VkBuffer* out_handle);
 
+// Allocates a buffer that reserves |reserved_size| bytes of sparse address
+// space but only binds physical memory to the first |committed_size| bytes.
+// The buffer reports |reserved_size| as its allocation size and its VkBuffer
+// never changes: growing with iree_hal_vulkan_buffer_commit binds more memory
+// after the committed range instead of reallocating and copying. This suits
+// storage such as KV caches and dynamically sized outputs whose final size is
+// only bounded.
+//
+// Only the committed range may be accessed. Growable buffers cannot be mapped.
+// |allocator| must be the allocator of a Vulkan device created with
+// IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_RESIDENCY_ALIASED.
+IREE_API_EXPORT iree_status_t
+iree_hal_vulkan_allocator_allocate_growable_buffer(
+    iree_hal_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t reserved_size, iree_device_size_t committed_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Binds physical memory so that at least the first |minimum_committed_size|
+// bytes of the growable |buffer| (or a subspan of one) are accessible. Commits
+// are rounded up to the sparse page size and are a no-op if the range is
+// already committed. Binding happens synchronously on the calling thread and
+// existing contents and in-flight work using the committed range are
+// unaffected.
+//
+// Not thread-safe with respect to other commits of the same buffer.
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_buffer_commit(
+    iree_hal_buffer_t* buffer, iree_device_size_t minimum_committed_size);
+
+// Returns the number of bytes from the start of |buffer| that are accessible.
+// Buffers that are not growable are always fully committed.
+IREE_API_EXPORT iree_device_size_t
+iree_hal_vulkan_buffer_committed_size(const iree_hal_buffer_t* buffer);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_vulkan_*_semaphore_t
 //===----------------------------------------------------------------------===//
@@ -104,6 +104,11 @@ iree_status_t BuiltinExecutables::InitializeExecutables() {
     pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipeline_create_info.pNext = NULL;
     pipeline_create_info.flags = VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+    if (iree_all_bits_set(logical_device_->enabled_features(),
+                          IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+      pipeline_create_info.flags |=
+          VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
     pipeline_create_info.layout =
         iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout_);
     pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
@@ -52,6 +52,13 @@ class CommandQueue {
 
   virtual iree_status_t WaitIdle(iree_timeout_t timeout) = 0;
 
+  // Issues any submissions held by the queue to the device.
+  virtual iree_status_t Flush() { return iree_ok_status(); }
+
+  // Returns true if the queue may hold submissions until they are flushed.
+  // Such queues retain the resources used by submissions until they complete.
+  virtual bool is_batching() const { return false; }
+
  protected:
   CommandQueue(VkDeviceHandle* logical_device,
                iree_hal_command_category_t supported_categories, VkQueue queue)
@@ -8,6 +8,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <ostream>
 
 #include "iree/hal/drivers/vulkan/status_util.h"
@@ -22,11 +23,16 @@ namespace {
 // chaining in the command buffer when pools run out.
 static constexpr int kMaxDescriptorSets = 4096;
 
+// Size of each descriptor buffer block. Command buffers bump-allocate
+// descriptor sets from the block and acquire another when it is exhausted.
+static constexpr VkDeviceSize kDescriptorBufferBlockSize = 64 * 1024;
+
 }  // namespace
 
 DescriptorSetGroup::~DescriptorSetGroup() {
-  IREE_ASSERT_TRUE(descriptor_pools_.empty(),
-                   "DescriptorSetGroup must be reset explicitly");
+  IREE_ASSERT_TRUE(
+      descriptor_pools_.empty() && descriptor_buffer_blocks_.empty(),
+      "DescriptorSetGroup must be reset explicitly");
 }
 
 iree_status_t DescriptorSetGroup::Reset() {
@@ -35,14 +41,47 @@ iree_status_t DescriptorSetGroup::Reset() {
   if (descriptor_pool_cache_ != nullptr) {
     IREE_RETURN_IF_ERROR(
         descriptor_pool_cache_->ReleaseDescriptorPools(descriptor_pools_));
+    descriptor_pool_cache_->ReleaseDescriptorBufferBlocks(
+        descriptor_buffer_blocks_);
   }
   descriptor_pools_.clear();
+  descriptor_buffer_blocks_.clear();
 
   return iree_ok_status();
 }
 
 DescriptorPoolCache::DescriptorPoolCache(VkDeviceHandle* logical_device)
-    : logical_device_(logical_device) {}
+    : logical_device_(logical_device) {
+  iree_slim_mutex_initialize(&descriptor_buffer_mutex_);
+  memset(&memory_props_, 0, sizeof(memory_props_));
+  if (iree_all_bits_set(logical_device_->enabled_features(),
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_props;
+    memset(&descriptor_buffer_props, 0, sizeof(descriptor_buffer_props));
+    descriptor_buffer_props.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 device_props_2;
+    memset(&device_props_2, 0, sizeof(device_props_2));
+    device_props_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    device_props_2.pNext = &descriptor_buffer_props;
+    syms().vkGetPhysicalDeviceProperties2(logical_device_->physical_device(),
+                                          &device_props_2);
+    descriptor_buffer_offset_alignment_ =
+        iree_max(1, descriptor_buffer_props.descriptorBufferOffsetAlignment);
+    storage_buffer_descriptor_size_ =
+        descriptor_buffer_props.storageBufferDescriptorSize;
+    syms().vkGetPhysicalDeviceMemoryProperties(
+        logical_device_->physical_device(), &memory_props_);
+  }
+}
+
+DescriptorPoolCache::~DescriptorPoolCache() {
+  for (const auto& block : free_descriptor_buffer_blocks_) {
+    DestroyDescriptorBufferBlock(block);
+  }
+  free_descriptor_buffer_blocks_.clear();
+  iree_slim_mutex_deinitialize(&descriptor_buffer_mutex_);
+}
 
 iree_status_t DescriptorPoolCache::AcquireDescriptorPool(
     VkDescriptorType descriptor_type, int max_descriptor_count,
@@ -95,6 +134,136 @@ iree_status_t DescriptorPoolCache::ReleaseDescriptorPools(
   return iree_ok_status();
 }
 
+iree_status_t DescriptorPoolCache::AcquireDescriptorBufferBlock(
+    DescriptorBufferBlock* out_descriptor_buffer_block) {
+  iree_slim_mutex_lock(&descriptor_buffer_mutex_);
+  if (!free_descriptor_buffer_blocks_.empty()) {
+    *out_descriptor_buffer_block = free_descriptor_buffer_blocks_.back();
+    free_descriptor_buffer_blocks_.pop_back();
+    iree_slim_mutex_unlock(&descriptor_buffer_mutex_);
+    return iree_ok_status();
+  }
+  iree_slim_mutex_unlock(&descriptor_buffer_mutex_);
+  return CreateDescriptorBufferBlock(out_descriptor_buffer_block);
+}
+
+void DescriptorPoolCache::ReleaseDescriptorBufferBlocks(
+    const std::vector<DescriptorBufferBlock>& descriptor_buffer_blocks) {
+  if (descriptor_buffer_blocks.empty()) return;
+  iree_slim_mutex_lock(&descriptor_buffer_mutex_);
+  free_descriptor_buffer_blocks_.insert(free_descriptor_buffer_blocks_.end(),
+                                        descriptor_buffer_blocks.begin(),
+                                        descriptor_buffer_blocks.end());
+  iree_slim_mutex_unlock(&descriptor_buffer_mutex_);
+}
+
+iree_status_t DescriptorPoolCache::CreateDescriptorBufferBlock(
+    DescriptorBufferBlock* out_descriptor_buffer_block) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::CreateDescriptorBufferBlock");
+
+  DescriptorBufferBlock block;
+  block.size = kDescriptorBufferBlockSize;
+
+  VkBufferCreateInfo buffer_create_info;
+  buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_create_info.pNext = nullptr;
+  buffer_create_info.flags = 0;
+  buffer_create_info.size = block.size;
+  buffer_create_info.usage =
+      VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+      VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  buffer_create_info.queueFamilyIndexCount = 0;
+  buffer_create_info.pQueueFamilyIndices = nullptr;
+  VK_RETURN_IF_ERROR(
+      syms().vkCreateBuffer(*logical_device_, &buffer_create_info,
+                            logical_device_->allocator(), &block.buffer),
+      "vkCreateBuffer");
+
+  VkMemoryRequirements requirements;
+  syms().vkGetBufferMemoryRequirements(*logical_device_, block.buffer,
+                                       &requirements);
+
+  // Descriptors are written from the host while recording so the memory must
+  // be host visible; prefer memory that is also device local.
+  const VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  uint32_t memory_type_index = UINT32_MAX;
+  for (uint32_t i = 0; i < memory_props_.memoryTypeCount; ++i) {
+    if (!(requirements.memoryTypeBits & (1u << i))) continue;
+    VkMemoryPropertyFlags flags = memory_props_.memoryTypes[i].propertyFlags;
+    if (!iree_all_bits_set(flags, required_flags)) continue;
+    if (memory_type_index == UINT32_MAX ||
+        iree_all_bits_set(flags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      memory_type_index = i;
+      if (iree_all_bits_set(flags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) break;
+    }
+  }
+  if (memory_type_index == UINT32_MAX) {
+    syms().vkDestroyBuffer(*logical_device_, block.buffer,
+                           logical_device_->allocator());
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no host visible memory type usable for descriptor buffers");
+  }
+
+  VkMemoryAllocateFlagsInfo allocate_flags_info;
+  allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  allocate_flags_info.pNext = nullptr;
+  allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+  allocate_flags_info.deviceMask = 0;
+  VkMemoryAllocateInfo allocate_info;
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = &allocate_flags_info;
+  allocate_info.allocationSize = requirements.size;
+  allocate_info.memoryTypeIndex = memory_type_index;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      syms().vkAllocateMemory(*logical_device_, &allocate_info,
+                              logical_device_->allocator(), &block.memory),
+      "vkAllocateMemory");
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkBindBufferMemory(*logical_device_, block.buffer, block.memory,
+                                  /*memoryOffset=*/0),
+        "vkBindBufferMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkMapMemory(*logical_device_, block.memory, /*offset=*/0,
+                           VK_WHOLE_SIZE, /*flags=*/0,
+                           reinterpret_cast<void**>(&block.host_ptr)),
+        "vkMapMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    VkBufferDeviceAddressInfo address_info;
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.pNext = nullptr;
+    address_info.buffer = block.buffer;
+    block.address =
+        syms().vkGetBufferDeviceAddress
+            ? syms().vkGetBufferDeviceAddress(*logical_device_, &address_info)
+            : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                                 &address_info);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_descriptor_buffer_block = block;
+  } else {
+    DestroyDescriptorBufferBlock(block);
+  }
+  return status;
+}
+
+void DescriptorPoolCache::DestroyDescriptorBufferBlock(
+    const DescriptorBufferBlock& descriptor_buffer_block) {
+  // Freeing the memory implicitly unmaps it.
+  syms().vkDestroyBuffer(*logical_device_, descriptor_buffer_block.buffer,
+                         logical_device_->allocator());
+  syms().vkFreeMemory(*logical_device_, descriptor_buffer_block.memory,
+                      logical_device_->allocator());
+}
+
 }  // namespace vulkan
 }  // namespace hal
 }  // namespace iree
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
@@ -32,23 +33,42 @@ struct DescriptorPool {
   VkDescriptorPool handle = VK_NULL_HANDLE;
 };
 
+// A host-visible buffer that descriptors are written into directly when
+// VK_EXT_descriptor_buffer is enabled. The buffer is persistently mapped and
+// its memory is host coherent.
+struct DescriptorBufferBlock {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  // Device address of the buffer as bound with vkCmdBindDescriptorBuffersEXT.
+  VkDeviceAddress address = 0;
+  // Host pointer to the mapped buffer contents.
+  uint8_t* host_ptr = nullptr;
+  // Total capacity of the buffer in bytes.
+  VkDeviceSize size = 0;
+};
+
 // A group of descriptor sets allocated and released together.
 // The group must be explicitly reset with Reset() prior to disposing.
 class DescriptorSetGroup final {
  public:
   DescriptorSetGroup() = default;
-  DescriptorSetGroup(DescriptorPoolCache* descriptor_pool_cache,
-                     std::vector<DescriptorPool> descriptor_pools)
+  DescriptorSetGroup(
+      DescriptorPoolCache* descriptor_pool_cache,
+      std::vector<DescriptorPool> descriptor_pools,
+      std::vector<DescriptorBufferBlock> descriptor_buffer_blocks)
       : descriptor_pool_cache_(descriptor_pool_cache),
-        descriptor_pools_(std::move(descriptor_pools)) {}
+        descriptor_pools_(std::move(descriptor_pools)),
+        descriptor_buffer_blocks_(std::move(descriptor_buffer_blocks)) {}
   DescriptorSetGroup(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup& operator=(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup(DescriptorSetGroup&& other) noexcept
       : descriptor_pool_cache_(std::move(other.descriptor_pool_cache_)),
-        descriptor_pools_(std::move(other.descriptor_pools_)) {}
+        descriptor_pools_(std::move(other.descriptor_pools_)),
+        descriptor_buffer_blocks_(std::move(other.descriptor_buffer_blocks_)) {}
   DescriptorSetGroup& operator=(DescriptorSetGroup&& other) {
     std::swap(descriptor_pool_cache_, other.descriptor_pool_cache_);
     std::swap(descriptor_pools_, other.descriptor_pools_);
+    std::swap(descriptor_buffer_blocks_, other.descriptor_buffer_blocks_);
     return *this;
   }
   ~DescriptorSetGroup();
@@ -58,6 +78,7 @@ class DescriptorSetGroup final {
  private:
   DescriptorPoolCache* descriptor_pool_cache_;
   std::vector<DescriptorPool> descriptor_pools_;
+  std::vector<DescriptorBufferBlock> descriptor_buffer_blocks_;
 };
 
 // A "cache" (or really, pool) of descriptor pools. These pools are allocated
@@ -66,9 +87,15 @@ class DescriptorSetGroup final {
 // resources. After the descriptors in the pool are no longer used (all
 // command buffers using descriptor sets allocated from the pool have retired)
 // the pool is returned here to be reused in the future.
+//
+// When VK_EXT_descriptor_buffer is enabled the cache also pools the
+// descriptor buffer blocks command buffers write descriptors into. Blocks are
+// returned to a free list when the command buffers using them have retired
+// and are reused without any further Vulkan calls.
 class DescriptorPoolCache final {
  public:
   explicit DescriptorPoolCache(VkDeviceHandle* logical_device);
+  ~DescriptorPoolCache();
 
   VkDeviceHandle* logical_device() const { return logical_device_; }
   const DynamicSymbols& syms() const { return *logical_device_->syms(); }
@@ -86,8 +113,45 @@ class DescriptorPoolCache final {
   iree_status_t ReleaseDescriptorPools(
       const std::vector<DescriptorPool>& descriptor_pools);
 
+  // Required alignment of descriptor set offsets within descriptor buffers.
+  VkDeviceSize descriptor_buffer_offset_alignment() const {
+    return descriptor_buffer_offset_alignment_;
+  }
+
+  // Size in bytes of a storage buffer descriptor in a descriptor buffer.
+  size_t storage_buffer_descriptor_size() const {
+    return storage_buffer_descriptor_size_;
+  }
+
+  // Acquires a descriptor buffer block for use by the caller.
+  // When all descriptors written to the block are no longer in use it must be
+  // returned to the cache with ReleaseDescriptorBufferBlocks.
+  iree_status_t AcquireDescriptorBufferBlock(
+      DescriptorBufferBlock* out_descriptor_buffer_block);
+
+  // Releases descriptor buffer blocks back to the cache. The blocks must no
+  // longer be in use by any in-flight command.
+  void ReleaseDescriptorBufferBlocks(
+      const std::vector<DescriptorBufferBlock>& descriptor_buffer_blocks);
+
  private:
+  iree_status_t CreateDescriptorBufferBlock(
+      DescriptorBufferBlock* out_descriptor_buffer_block);
+  void DestroyDescriptorBufferBlock(
+      const DescriptorBufferBlock& descriptor_buffer_block);
+
   VkDeviceHandle* logical_device_;
+
+  // Descriptor buffer properties queried from the physical device. Only valid
+  // when IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS is enabled.
+  VkDeviceSize descriptor_buffer_offset_alignment_ = 1;
+  size_t storage_buffer_descriptor_size_ = 0;
+  VkPhysicalDeviceMemoryProperties memory_props_;
+
+  // Blocks available for reuse.
+  iree_slim_mutex_t descriptor_buffer_mutex_;
+  std::vector<DescriptorBufferBlock> free_descriptor_buffer_blocks_
+      IREE_GUARDED_BY(descriptor_buffer_mutex_);
 };
 
 }  // namespace vulkan
@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/vulkan/descriptor_set_arena.h"
 
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 
@@ -85,6 +86,18 @@ static void PopulateDescriptorSetWriteInfos(
   *out_infos = write_infos.data();
 }
 
+// Returns the range of |binding| as seen by shaders; see
+// PopulateDescriptorSetWriteInfos for why it is rounded up.
+static VkDeviceSize CalculateDescriptorBufferRange(
+    const iree_hal_descriptor_set_binding_t& binding) {
+  iree_device_size_t available_length =
+      iree_hal_buffer_byte_length(binding.buffer) - binding.offset;
+  if (binding.length == IREE_WHOLE_BUFFER) {
+    return available_length;
+  }
+  return iree_device_align(std::min(binding.length, available_length), 4);
+}
+
 static VkDescriptorSetAllocateInfo PopulateDescriptorSetsAllocateInfo(
     const DescriptorPool& descriptor_pool,
     iree_hal_descriptor_set_layout_t* set_layout) {
@@ -114,12 +127,23 @@ DescriptorSetArena::~DescriptorSetArena() {
         descriptor_pool_cache_->ReleaseDescriptorPools(used_descriptor_pools_));
     used_descriptor_pools_.clear();
   }
+  descriptor_pool_cache_->ReleaseDescriptorBufferBlocks(
+      used_descriptor_buffer_blocks_);
+  used_descriptor_buffer_blocks_.clear();
 }
 
 iree_status_t DescriptorSetArena::BindDescriptorSet(
     VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
     uint32_t set, iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings) {
+  // Descriptor buffers take precedence over push descriptors as set layouts
+  // are created for one or the other.
+  if (iree_all_bits_set(logical_device_->enabled_features(),
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+    return BindDescriptorBufferSet(command_buffer, pipeline_layout, set,
+                                   binding_count, bindings);
+  }
+
   // Always prefer using push descriptors when available as we can avoid the
   // additional API overhead of updating/resetting pools.
   if (logical_device_->enabled_extensions().push_descriptors) {
@@ -236,10 +260,162 @@ void DescriptorSetArena::PushDescriptorSet(
       set, static_cast<uint32_t>(write_info_count), write_infos);
 }
 
+iree_status_t DescriptorSetArena::BindDescriptorBufferSet(
+    VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
+    uint32_t set, iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::BindDescriptorBufferSet");
+  if (set >= kMaxDescriptorBufferSets) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set %u out of range (max=%u)", set,
+                            kMaxDescriptorBufferSets);
+  }
+
+  auto* set_layout =
+      iree_hal_vulkan_native_pipeline_layout_set(pipeline_layout, set);
+  VkDeviceSize set_size =
+      iree_hal_vulkan_native_descriptor_set_layout_buffer_size(set_layout);
+  VkDeviceSize alignment =
+      descriptor_pool_cache_->descriptor_buffer_offset_alignment();
+
+  // Bump-allocate the set from the current block and move to a new block when
+  // needed. The first set recorded into a command buffer always acquires a
+  // block so that the buffer is bound to the command buffer.
+  VkDeviceSize set_offset =
+      iree_device_align(descriptor_buffer_offset_, alignment);
+  if (command_buffer != descriptor_buffer_command_buffer_ ||
+      descriptor_buffer_block_.buffer == VK_NULL_HANDLE ||
+      set_offset + set_size > descriptor_buffer_block_.size) {
+    if (command_buffer != descriptor_buffer_command_buffer_) {
+      bound_descriptor_buffer_sets_ = {};
+      descriptor_buffer_command_buffer_ = command_buffer;
+    }
+    IREE_RETURN_IF_ERROR(AcquireDescriptorBufferBlock(command_buffer));
+    set_offset = iree_device_align(descriptor_buffer_offset_, alignment);
+    if (set_offset + set_size > descriptor_buffer_block_.size) {
+      return iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "descriptor set size %" PRIdsz " exceeds descriptor buffer blocks",
+          (iree_device_size_t)set_size);
+    }
+  }
+  descriptor_buffer_offset_ = set_offset + set_size;
+
+  // Write each binding directly into the mapped block.
+  uint8_t* set_ptr = descriptor_buffer_block_.host_ptr + set_offset;
+  size_t descriptor_size =
+      descriptor_pool_cache_->storage_buffer_descriptor_size();
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    const auto& binding = bindings[i];
+    VkDescriptorAddressInfoEXT address_info;
+    address_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    address_info.pNext = nullptr;
+    address_info.format = VK_FORMAT_UNDEFINED;
+    VkDescriptorGetInfoEXT get_info;
+    get_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    get_info.pNext = nullptr;
+    get_info.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    if (binding.buffer) {
+      address_info.address =
+          LookupBufferDeviceAddress(
+              iree_hal_vulkan_buffer_handle(binding.buffer)) +
+          iree_hal_buffer_byte_offset(binding.buffer) + binding.offset;
+      address_info.range = CalculateDescriptorBufferRange(binding);
+      get_info.data.pStorageBuffer = &address_info;
+    } else {
+      // Requires the nullDescriptor feature as with descriptor sets.
+      get_info.data.pStorageBuffer = nullptr;
+    }
+    syms().vkGetDescriptorEXT(
+        *logical_device_, &get_info, descriptor_size,
+        set_ptr + iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+                      set_layout, binding.binding));
+  }
+
+  VkPipelineLayout device_pipeline_layout =
+      iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout);
+  uint32_t buffer_index = 0;
+  syms().vkCmdSetDescriptorBufferOffsetsEXT(
+      command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, device_pipeline_layout,
+      set, 1, &buffer_index, &set_offset);
+
+  auto& bound_set = bound_descriptor_buffer_sets_[set];
+  bound_set.pipeline_layout = device_pipeline_layout;
+  bound_set.offset = set_offset;
+  bound_set.size = set_size;
+
+  return iree_ok_status();
+}
+
+iree_status_t DescriptorSetArena::AcquireDescriptorBufferBlock(
+    VkCommandBuffer command_buffer) {
+  DescriptorBufferBlock previous_block = descriptor_buffer_block_;
+  IREE_RETURN_IF_ERROR(descriptor_pool_cache_->AcquireDescriptorBufferBlock(
+      &descriptor_buffer_block_));
+  used_descriptor_buffer_blocks_.push_back(descriptor_buffer_block_);
+  descriptor_buffer_offset_ = 0;
+
+  VkDescriptorBufferBindingInfoEXT binding_info;
+  binding_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+  binding_info.pNext = nullptr;
+  binding_info.address = descriptor_buffer_block_.address;
+  binding_info.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+  syms().vkCmdBindDescriptorBuffersEXT(command_buffer, 1, &binding_info);
+
+  // Binding a new buffer invalidates the offsets of sets bound from the old
+  // one; copy their contents over so that they remain bound for subsequent
+  // dispatches that don't rebind them.
+  VkDeviceSize alignment =
+      descriptor_pool_cache_->descriptor_buffer_offset_alignment();
+  for (uint32_t set = 0; set < kMaxDescriptorBufferSets; ++set) {
+    auto& bound_set = bound_descriptor_buffer_sets_[set];
+    if (bound_set.pipeline_layout == VK_NULL_HANDLE) continue;
+    VkDeviceSize new_offset =
+        iree_device_align(descriptor_buffer_offset_, alignment);
+    memcpy(descriptor_buffer_block_.host_ptr + new_offset,
+           previous_block.host_ptr + bound_set.offset, bound_set.size);
+    descriptor_buffer_offset_ = new_offset + bound_set.size;
+    uint32_t buffer_index = 0;
+    syms().vkCmdSetDescriptorBufferOffsetsEXT(
+        command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        bound_set.pipeline_layout, set, 1, &buffer_index, &new_offset);
+    bound_set.offset = new_offset;
+  }
+
+  return iree_ok_status();
+}
+
+VkDeviceAddress DescriptorSetArena::LookupBufferDeviceAddress(
+    VkBuffer buffer) {
+  auto& entry =
+      buffer_address_cache_[((uint64_t)buffer >> 4) %
+                            buffer_address_cache_.size()];
+  if (entry.buffer == buffer) return entry.address;
+  VkBufferDeviceAddressInfo address_info;
+  address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+  address_info.pNext = nullptr;
+  address_info.buffer = buffer;
+  entry.buffer = buffer;
+  entry.address =
+      syms().vkGetBufferDeviceAddress
+          ? syms().vkGetBufferDeviceAddress(*logical_device_, &address_info)
+          : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                               &address_info);
+  return entry.address;
+}
+
 DescriptorSetGroup DescriptorSetArena::Flush() {
   IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::Flush");
 
-  if (used_descriptor_pools_.empty()) {
+  // Descriptor buffer state is per command buffer.
+  descriptor_buffer_command_buffer_ = VK_NULL_HANDLE;
+  descriptor_buffer_block_ = {};
+  descriptor_buffer_offset_ = 0;
+  bound_descriptor_buffer_sets_ = {};
+  buffer_address_cache_ = {};
+
+  if (used_descriptor_pools_.empty() &&
+      used_descriptor_buffer_blocks_.empty()) {
     // No resources to free.
     return DescriptorSetGroup{};
   }
@@ -248,7 +424,8 @@ DescriptorSetGroup DescriptorSetArena::Flush() {
     bucket = {};
   }
   return DescriptorSetGroup(descriptor_pool_cache_,
-                            std::move(used_descriptor_pools_));
+                            std::move(used_descriptor_pools_),
+                            std::move(used_descriptor_buffer_blocks_));
 }
 
 }  // namespace vulkan
@@ -26,6 +26,10 @@ namespace hal {
 namespace vulkan {
 
 // A reusable arena for allocating descriptor sets and batching updates.
+//
+// When IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS is enabled descriptor
+// sets are bump-allocated from descriptor buffer blocks and written directly
+// with vkGetDescriptorEXT instead of being allocated from descriptor pools.
 class DescriptorSetArena final {
  public:
   explicit DescriptorSetArena(DescriptorPoolCache* descriptor_pool_cache);
@@ -54,6 +58,36 @@ class DescriptorSetArena final {
                          uint32_t set, iree_host_size_t binding_count,
                          const iree_hal_descriptor_set_binding_t* bindings);
 
+  // Writes the descriptor set into a descriptor buffer and binds it.
+  iree_status_t BindDescriptorBufferSet(
+      VkCommandBuffer command_buffer,
+      iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+      iree_host_size_t binding_count,
+      const iree_hal_descriptor_set_binding_t* bindings);
+
+  // Switches to a new descriptor buffer block and rebinds the sets bound from
+  // the previous block, if any.
+  iree_status_t AcquireDescriptorBufferBlock(VkCommandBuffer command_buffer);
+
+  // Returns the device address of |buffer|, caching it across calls.
+  VkDeviceAddress LookupBufferDeviceAddress(VkBuffer buffer);
+
+  // Maximum number of sets tracked while binding descriptor buffers.
+  static constexpr uint32_t kMaxDescriptorBufferSets = 4;
+
+  // A descriptor set bound from the current descriptor buffer block.
+  struct BoundDescriptorBufferSet {
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+  };
+
+  // A direct-mapped cache of buffer device addresses.
+  struct BufferAddressCacheEntry {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceAddress address = 0;
+  };
+
   VkDeviceHandle* logical_device_;
   DescriptorPoolCache* descriptor_pool_cache_;
 
@@ -66,6 +100,19 @@ class DescriptorSetArena final {
 
   // All pools that have been used during allocation.
   std::vector<DescriptorPool> used_descriptor_pools_;
+
+  // Command buffer the current descriptor buffer block is bound to.
+  VkCommandBuffer descriptor_buffer_command_buffer_ = VK_NULL_HANDLE;
+  // Block descriptor sets are currently allocated from, if any.
+  DescriptorBufferBlock descriptor_buffer_block_;
+  // Offset of the next free byte in |descriptor_buffer_block_|.
+  VkDeviceSize descriptor_buffer_offset_ = 0;
+  // Sets bound from |descriptor_buffer_block_| indexed by set ordinal.
+  std::array<BoundDescriptorBufferSet, kMaxDescriptorBufferSets>
+      bound_descriptor_buffer_sets_;
+  // All blocks that have been used during allocation.
+  std::vector<DescriptorBufferBlock> used_descriptor_buffer_blocks_;
+  std::array<BufferAddressCacheEntry, 16> buffer_address_cache_;
 };
 
 }  // namespace vulkan
@@ -20,6 +20,7 @@
 #include "iree/hal/drivers/vulkan/native_pipeline_layout.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 using namespace iree::hal::vulkan;
@@ -92,12 +93,6 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   VkCommandBufferAllocateInfo allocate_info;
@@ -105,7 +100,12 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
   allocate_info.pNext = NULL;
   allocate_info.commandPool = *command_pool;
   allocate_info.commandBufferCount = 1;
-  allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  // Nested command buffers are executed from primary command buffers with
+  // vkCmdExecuteCommands and must be secondary.
+  allocate_info.level =
+      iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)
+          ? VK_COMMAND_BUFFER_LEVEL_SECONDARY
+          : VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 
   VkCommandBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -189,11 +189,21 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_begin(
   VkCommandBufferBeginInfo begin_info;
   begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
   begin_info.pNext = NULL;
+  // Reusable command buffers may be resubmitted while prior submissions of
+  // them are still pending.
   begin_info.flags = iree_all_bits_set(command_buffer->base.mode,
                                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)
                          ? VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-                         : 0;
+                         : VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
   begin_info.pInheritanceInfo = NULL;
+  // Secondary command buffers must declare what they inherit; compute and
+  // transfer commands are recorded outside of render passes so nothing is.
+  VkCommandBufferInheritanceInfo inheritance_info = {};
+  inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+    begin_info.pInheritanceInfo = &inheritance_info;
+  }
   VK_RETURN_IF_ERROR(command_buffer->syms->vkBeginCommandBuffer(
                          command_buffer->handle, &begin_info),
                      "vkBeginCommandBuffer");
@@ -334,6 +344,44 @@ static VkAccessFlags iree_hal_vulkan_convert_access_mask(
   return flags;
 }
 
+// Returns true if the command buffer was allocated from a transfer-only queue
+// family pool and cannot use compute pipeline stages or shader accesses.
+static bool iree_hal_vulkan_direct_command_buffer_is_transfer_only(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(
+      iree_hal_command_buffer_allowed_categories(&command_buffer->base),
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH);
+}
+
+// Converts |stage_mask| to the pipeline stages supported by the queue family
+// the command buffer will be submitted to. Barriers recorded by generic HAL
+// code may conservatively include dispatch stages that transfer queues reject.
+static VkPipelineStageFlags iree_hal_vulkan_direct_command_buffer_stage_mask(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_execution_stage_t stage_mask) {
+  if (!iree_hal_vulkan_direct_command_buffer_is_transfer_only(command_buffer)) {
+    return iree_hal_vulkan_convert_pipeline_stage_flags(stage_mask);
+  }
+  VkPipelineStageFlags flags = iree_hal_vulkan_convert_pipeline_stage_flags(
+      stage_mask & ~(IREE_HAL_EXECUTION_STAGE_COMMAND_PROCESS |
+                     IREE_HAL_EXECUTION_STAGE_DISPATCH));
+  return flags ? flags : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+}
+
+// Converts |access_mask| to the access flags supported by the queue family the
+// command buffer will be submitted to.
+static VkAccessFlags iree_hal_vulkan_direct_command_buffer_access_mask(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_access_scope_t access_mask) {
+  if (iree_hal_vulkan_direct_command_buffer_is_transfer_only(command_buffer)) {
+    access_mask &= ~(IREE_HAL_ACCESS_SCOPE_INDIRECT_COMMAND_READ |
+                     IREE_HAL_ACCESS_SCOPE_CONSTANT_READ |
+                     IREE_HAL_ACCESS_SCOPE_DISPATCH_READ |
+                     IREE_HAL_ACCESS_SCOPE_DISPATCH_WRITE);
+  }
+  return iree_hal_vulkan_convert_access_mask(access_mask);
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_execution_stage_t source_stage_mask,
@@ -355,10 +403,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     VkMemoryBarrier* info = iree_inline_array_at(memory_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, memory_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -368,10 +416,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     VkBufferMemoryBarrier* info = iree_inline_array_at(buffer_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, buffer_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -381,8 +429,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
 
   command_buffer->syms->vkCmdPipelineBarrier(
       command_buffer->handle,
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       target_stage_mask),
       /*dependencyFlags=*/0, (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -405,7 +455,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_signal_event(
 
   command_buffer->syms->vkCmdSetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       source_stage_mask));
 
   return iree_ok_status();
 }
@@ -421,7 +472,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_reset_event(
 
   command_buffer->syms->vkCmdResetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       source_stage_mask));
 
   return iree_ok_status();
 }
@@ -456,10 +508,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     VkMemoryBarrier* info = iree_inline_array_at(memory_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, memory_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -469,10 +521,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     VkBufferMemoryBarrier* info = iree_inline_array_at(buffer_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, buffer_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access_mask(
+        command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -483,8 +535,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
   command_buffer->syms->vkCmdWaitEvents(
       command_buffer->handle, (uint32_t)event_count,
       iree_inline_array_data(event_handles),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_mask(command_buffer,
+                                                       target_stage_mask),
       (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -534,6 +588,17 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
   VkBuffer target_device_buffer = iree_hal_vulkan_buffer_handle(target_buffer);
 
+  // Unaligned fills are emulated with a builtin dispatch that transfer queues
+  // cannot execute.
+  if ((target_offset % 4 != 0 || length % 4 != 0) &&
+      iree_hal_vulkan_direct_command_buffer_is_transfer_only(command_buffer)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "unaligned fill (offset %" PRIdsz ", length %" PRIdsz
+        ") cannot be recorded into a command buffer targeting a transfer queue",
+        target_offset, length);
+  }
+
   IREE_VULKAN_TRACE_ZONE_BEGIN(command_buffer->tracing_context,
                                command_buffer->handle);
 
@@ -800,17 +865,19 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execute_commands(
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
 
-  if (binding_table.count > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    // Since Vulkan doesn't natively support this we'd need to emulate things
-    // with an iree_hal_vulkan_indirect_command_buffer_t type that captured the
-    // command buffer using deferred command buffer and allowed replay with a
-    // binding table. If we wanted to actually reuse the command buffers we'd
-    // need to use update-after-bind (where supported), device pointers (where
-    // supported), or descriptor indexing and a big ringbuffer (make a 1024
-    // element descriptor array and cycle through it with each submission).
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
+  // Command buffers with indirect bindings are recorded as deferred command
+  // buffers and replayed into this command buffer with the binding table
+  // resolved to push descriptors.
+  // TODO(#10144): reuse the recorded Vulkan commands with update-after-bind,
+  // device pointers, or descriptor indexing into a ringbuffer of descriptor
+  // arrays cycled with each submission where supported.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  } else if (binding_table.count > 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding tables are only supported with command "
+                            "buffers created with a binding capacity");
   }
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/vulkan/direct_command_queue.h"
 
 #include <cstdint>
+#include <utility>
 
 #include "iree/hal/drivers/vulkan/direct_command_buffer.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
@@ -21,10 +22,37 @@ namespace vulkan {
 
 DirectCommandQueue::DirectCommandQueue(
     VkDeviceHandle* logical_device,
-    iree_hal_command_category_t supported_categories, VkQueue queue)
-    : CommandQueue(logical_device, supported_categories, queue) {}
+    iree_hal_command_category_t supported_categories, VkQueue queue,
+    iree_host_size_t batch_max_count, iree_duration_t batch_window_ns)
+    : CommandQueue(logical_device, supported_categories, queue),
+      batch_max_count_(batch_max_count),
+      batch_window_ns_(batch_window_ns) {
+  iree_slim_mutex_initialize(&batch_mutex_);
+}
 
-DirectCommandQueue::~DirectCommandQueue() = default;
+DirectCommandQueue::~DirectCommandQueue() {
+  IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::dtor");
+  iree_slim_mutex_lock(&batch_mutex_);
+  iree_status_ignore(FlushLocked());
+
+  // All issued submissions must complete before their resources are released.
+  iree_slim_mutex_lock(&queue_mutex_);
+  syms()->vkQueueWaitIdle(queue_);
+  iree_slim_mutex_unlock(&queue_mutex_);
+  for (auto& submit : in_flight_submits_) {
+    for (auto* resource : submit.resources) iree_hal_resource_release(resource);
+    syms()->vkDestroyFence(*logical_device_, submit.fence,
+                           logical_device_->allocator());
+  }
+  in_flight_submits_.clear();
+  for (VkFence fence : free_fences_) {
+    syms()->vkDestroyFence(*logical_device_, fence,
+                           logical_device_->allocator());
+  }
+  free_fences_.clear();
+  iree_slim_mutex_unlock(&batch_mutex_);
+  iree_slim_mutex_deinitialize(&batch_mutex_);
+}
 
 iree_status_t DirectCommandQueue::TranslateBatchInfo(
     const iree_hal_submission_batch_t* batch, VkSubmitInfo* submit_info,
@@ -93,6 +121,254 @@ iree_status_t DirectCommandQueue::TranslateBatchInfo(
 
 iree_status_t DirectCommandQueue::Submit(
     iree_host_size_t batch_count, const iree_hal_submission_batch_t* batches) {
+  if (!is_batching()) return SubmitImmediate(batch_count, batches);
+  IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::Submit#Batched");
+
+  iree_slim_mutex_lock(&batch_mutex_);
+  RetireCompletedLocked();
+  iree_time_t now_ns = iree_time_now();
+  if (pending_batch_count_ == 0) {
+    pending_deadline_ns_ = iree_timeout_as_deadline_ns(
+        iree_make_timeout_ns(batch_window_ns_));
+  }
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    AppendBatchLocked(&batches[i]);
+  }
+  pending_batch_count_ += batch_count;
+  iree_status_t status = iree_ok_status();
+  if (pending_batch_count_ >= batch_max_count_ ||
+      now_ns >= pending_deadline_ns_) {
+    status = FlushLocked();
+  }
+  iree_slim_mutex_unlock(&batch_mutex_);
+  return status;
+}
+
+// Returns the index of |semaphore| in |semaphores| or -1 if not present.
+static int FindSemaphore(const std::vector<VkSemaphore>& semaphores,
+                         VkSemaphore semaphore) {
+  for (size_t i = 0; i < semaphores.size(); ++i) {
+    if (semaphores[i] == semaphore) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void DirectCommandQueue::AppendBatchLocked(
+    const iree_hal_submission_batch_t* batch) {
+  // Merging delays the signals of the last submit info until the new command
+  // buffers complete and the new command buffers until the waits of the last
+  // submit info are satisfied. This is only safe if the new batch does not wait
+  // on anything the last submit info does not already wait on; otherwise the
+  // merged signals could depend on work that itself depends on them.
+  PendingSubmitInfo* target = nullptr;
+  if (pending_submit_info_count_ > 0) {
+    PendingSubmitInfo* last =
+        &pending_submit_infos_[pending_submit_info_count_ - 1];
+    bool mergeable = true;
+    for (iree_host_size_t i = 0; i < batch->wait_semaphores.count; ++i) {
+      int index = FindSemaphore(last->wait_semaphores,
+                                iree_hal_vulkan_native_semaphore_handle(
+                                    batch->wait_semaphores.semaphores[i]));
+      if (index < 0 || last->wait_values[index] <
+                           batch->wait_semaphores.payload_values[i]) {
+        mergeable = false;
+        break;
+      }
+    }
+    for (iree_host_size_t i = 0;
+         mergeable && i < batch->signal_semaphores.count; ++i) {
+      // Timeline signals must increase; a repeated semaphore is combined by
+      // signaling only the later value.
+      int index = FindSemaphore(last->signal_semaphores,
+                                iree_hal_vulkan_native_semaphore_handle(
+                                    batch->signal_semaphores.semaphores[i]));
+      if (index >= 0 && last->signal_values[index] >=
+                            batch->signal_semaphores.payload_values[i]) {
+        mergeable = false;
+      }
+    }
+    if (mergeable) target = last;
+  }
+  if (!target) {
+    if (pending_submit_info_count_ == pending_submit_infos_.size()) {
+      pending_submit_infos_.emplace_back();
+    }
+    target = &pending_submit_infos_[pending_submit_info_count_++];
+    for (iree_host_size_t i = 0; i < batch->wait_semaphores.count; ++i) {
+      target->wait_semaphores.push_back(iree_hal_vulkan_native_semaphore_handle(
+          batch->wait_semaphores.semaphores[i]));
+      target->wait_values.push_back(batch->wait_semaphores.payload_values[i]);
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < batch->command_buffer_count; ++i) {
+    VkCommandBuffer handle =
+        iree_hal_vulkan_direct_command_buffer_handle(batch->command_buffers[i]);
+    target->command_buffers.push_back(handle);
+  }
+  for (iree_host_size_t i = 0; i < batch->signal_semaphores.count; ++i) {
+    VkSemaphore handle = iree_hal_vulkan_native_semaphore_handle(
+        batch->signal_semaphores.semaphores[i]);
+    uint64_t value = batch->signal_semaphores.payload_values[i];
+    int index = FindSemaphore(target->signal_semaphores, handle);
+    if (index >= 0) {
+      target->signal_values[index] = value;
+    } else {
+      target->signal_semaphores.push_back(handle);
+      target->signal_values.push_back(value);
+    }
+  }
+
+  // Retain everything referenced until the submission completes.
+  for (iree_host_size_t i = 0; i < batch->wait_semaphores.count; ++i) {
+    iree_hal_resource_retain(batch->wait_semaphores.semaphores[i]);
+    pending_resources_.push_back(
+        (iree_hal_resource_t*)batch->wait_semaphores.semaphores[i]);
+  }
+  for (iree_host_size_t i = 0; i < batch->command_buffer_count; ++i) {
+    iree_hal_resource_retain(batch->command_buffers[i]);
+    pending_resources_.push_back(
+        (iree_hal_resource_t*)batch->command_buffers[i]);
+  }
+  for (iree_host_size_t i = 0; i < batch->signal_semaphores.count; ++i) {
+    iree_hal_resource_retain(batch->signal_semaphores.semaphores[i]);
+    pending_resources_.push_back(
+        (iree_hal_resource_t*)batch->signal_semaphores.semaphores[i]);
+  }
+}
+
+iree_status_t DirectCommandQueue::Flush() {
+  if (!is_batching()) return iree_ok_status();
+  iree_slim_mutex_lock(&batch_mutex_);
+  iree_status_t status = FlushLocked();
+  iree_slim_mutex_unlock(&batch_mutex_);
+  return status;
+}
+
+iree_status_t DirectCommandQueue::FlushLocked() {
+  if (pending_submit_info_count_ == 0) return iree_ok_status();
+  IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::Flush");
+
+  // See TranslateBatchInfo for the choice of stages.
+  VkPipelineStageFlags dst_stage_mask =
+      VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+  Arena arena(4 * 1024);
+  auto submit_infos =
+      arena.AllocateSpan<VkSubmitInfo>(pending_submit_info_count_);
+  auto timeline_submit_infos =
+      arena.AllocateSpan<VkTimelineSemaphoreSubmitInfo>(
+          pending_submit_info_count_);
+  for (iree_host_size_t i = 0; i < pending_submit_info_count_; ++i) {
+    PendingSubmitInfo& pending = pending_submit_infos_[i];
+    auto wait_dst_stage_masks = arena.AllocateSpan<VkPipelineStageFlags>(
+        pending.wait_semaphores.size());
+    for (size_t j = 0; j < wait_dst_stage_masks.size(); ++j) {
+      wait_dst_stage_masks[j] = dst_stage_mask;
+    }
+
+    VkSubmitInfo* submit_info = &submit_infos[i];
+    submit_info->sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info->pNext = &timeline_submit_infos[i];
+    submit_info->waitSemaphoreCount =
+        static_cast<uint32_t>(pending.wait_semaphores.size());
+    submit_info->pWaitSemaphores = pending.wait_semaphores.data();
+    submit_info->pWaitDstStageMask = wait_dst_stage_masks.data();
+    submit_info->commandBufferCount =
+        static_cast<uint32_t>(pending.command_buffers.size());
+    submit_info->pCommandBuffers = pending.command_buffers.data();
+    submit_info->signalSemaphoreCount =
+        static_cast<uint32_t>(pending.signal_semaphores.size());
+    submit_info->pSignalSemaphores = pending.signal_semaphores.data();
+
+    VkTimelineSemaphoreSubmitInfo* timeline_submit_info =
+        &timeline_submit_infos[i];
+    timeline_submit_info->sType =
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_submit_info->pNext = nullptr;
+    timeline_submit_info->waitSemaphoreValueCount =
+        static_cast<uint32_t>(pending.wait_values.size());
+    timeline_submit_info->pWaitSemaphoreValues = pending.wait_values.data();
+    timeline_submit_info->signalSemaphoreValueCount =
+        static_cast<uint32_t>(pending.signal_values.size());
+    timeline_submit_info->pSignalSemaphoreValues = pending.signal_values.data();
+  }
+
+  VkFence fence = VK_NULL_HANDLE;
+  iree_status_t status = AcquireFenceLocked(&fence);
+  if (iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&queue_mutex_);
+    status = VK_RESULT_TO_STATUS(
+        syms()->vkQueueSubmit(queue_,
+                              static_cast<uint32_t>(submit_infos.size()),
+                              submit_infos.data(), fence),
+        "vkQueueSubmit");
+    iree_slim_mutex_unlock(&queue_mutex_);
+  }
+
+  if (iree_status_is_ok(status)) {
+    InFlightSubmit submit;
+    submit.fence = fence;
+    submit.resources.swap(pending_resources_);
+    in_flight_submits_.push_back(std::move(submit));
+  } else {
+    // Nothing was issued so the held resources can be dropped immediately.
+    if (fence != VK_NULL_HANDLE) free_fences_.push_back(fence);
+    for (auto* resource : pending_resources_) {
+      iree_hal_resource_release(resource);
+    }
+  }
+  pending_resources_.clear();
+
+  for (iree_host_size_t i = 0; i < pending_submit_info_count_; ++i) {
+    PendingSubmitInfo& pending = pending_submit_infos_[i];
+    pending.wait_semaphores.clear();
+    pending.wait_values.clear();
+    pending.command_buffers.clear();
+    pending.signal_semaphores.clear();
+    pending.signal_values.clear();
+  }
+  pending_submit_info_count_ = 0;
+  pending_batch_count_ = 0;
+  pending_deadline_ns_ = IREE_TIME_INFINITE_FUTURE;
+  return status;
+}
+
+void DirectCommandQueue::RetireCompletedLocked() {
+  // Fences signal in submission order so we can stop at the first pending one.
+  size_t retired_count = 0;
+  for (auto& submit : in_flight_submits_) {
+    if (syms()->vkGetFenceStatus(*logical_device_, submit.fence) !=
+        VK_SUCCESS) {
+      break;
+    }
+    for (auto* resource : submit.resources) iree_hal_resource_release(resource);
+    syms()->vkResetFences(*logical_device_, 1, &submit.fence);
+    free_fences_.push_back(submit.fence);
+    ++retired_count;
+  }
+  in_flight_submits_.erase(in_flight_submits_.begin(),
+                           in_flight_submits_.begin() + retired_count);
+}
+
+iree_status_t DirectCommandQueue::AcquireFenceLocked(VkFence* out_fence) {
+  if (!free_fences_.empty()) {
+    *out_fence = free_fences_.back();
+    free_fences_.pop_back();
+    return iree_ok_status();
+  }
+  VkFenceCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  create_info.pNext = nullptr;
+  create_info.flags = 0;
+  return VK_RESULT_TO_STATUS(
+      syms()->vkCreateFence(*logical_device_, &create_info,
+                            logical_device_->allocator(), out_fence),
+      "vkCreateFence");
+}
+
+iree_status_t DirectCommandQueue::SubmitImmediate(
+    iree_host_size_t batch_count, const iree_hal_submission_batch_t* batches) {
   IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::Submit");
 
   // Map the submission batches to VkSubmitInfos.
@@ -119,6 +395,17 @@ iree_status_t DirectCommandQueue::Submit(
 }
 
 iree_status_t DirectCommandQueue::WaitIdle(iree_timeout_t timeout) {
+  IREE_RETURN_IF_ERROR(Flush());
+  iree_status_t status = WaitIdleImpl(timeout);
+  if (is_batching()) {
+    iree_slim_mutex_lock(&batch_mutex_);
+    RetireCompletedLocked();
+    iree_slim_mutex_unlock(&batch_mutex_);
+  }
+  return status;
+}
+
+iree_status_t DirectCommandQueue::WaitIdleImpl(iree_timeout_t timeout) {
   iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
   if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
     // Fast path for using vkQueueWaitIdle, which is usually cheaper (as it
@@ -7,6 +7,8 @@
 #ifndef IREE_HAL_DRIVERS_VULKAN_DIRECT_COMMAND_QUEUE_H_
 #define IREE_HAL_DRIVERS_VULKAN_DIRECT_COMMAND_QUEUE_H_
 
+#include <vector>
+
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/vulkan/command_queue.h"
@@ -18,11 +20,20 @@ namespace hal {
 namespace vulkan {
 
 // Command queue implementation directly maps to VkQueue.
+//
+// When |batch_max_count| is greater than 1 submissions are held and issued
+// together in a single vkQueueSubmit once |batch_max_count| are pending, once a
+// submission arrives after the oldest held one has waited |batch_window_ns|,
+// or when explicitly flushed. Adjacent submissions that cannot introduce new
+// dependencies are merged into a single VkSubmitInfo. Held submissions retain
+// their semaphores and command buffers until a fence signaled by the
+// vkQueueSubmit they were issued with is reached.
 class DirectCommandQueue final : public CommandQueue {
  public:
   DirectCommandQueue(VkDeviceHandle* logical_device,
                      iree_hal_command_category_t supported_categories,
-                     VkQueue queue);
+                     VkQueue queue, iree_host_size_t batch_max_count = 1,
+                     iree_duration_t batch_window_ns = IREE_DURATION_ZERO);
   ~DirectCommandQueue() override;
 
   iree_status_t Submit(iree_host_size_t batch_count,
@@ -30,10 +41,73 @@ class DirectCommandQueue final : public CommandQueue {
 
   iree_status_t WaitIdle(iree_timeout_t timeout) override;
 
+  iree_status_t Flush() override;
+
+  bool is_batching() const override { return batch_max_count_ > 1; }
+
  private:
+  // A VkSubmitInfo being accumulated from one or more held submissions.
+  struct PendingSubmitInfo {
+    std::vector<VkSemaphore> wait_semaphores;
+    std::vector<uint64_t> wait_values;
+    std::vector<VkCommandBuffer> command_buffers;
+    std::vector<VkSemaphore> signal_semaphores;
+    std::vector<uint64_t> signal_values;
+  };
+
+  // Resources retained by an issued vkQueueSubmit until |fence| is signaled.
+  struct InFlightSubmit {
+    VkFence fence = VK_NULL_HANDLE;
+    std::vector<iree_hal_resource_t*> resources;
+  };
+
   iree_status_t TranslateBatchInfo(
       const iree_hal_submission_batch_t* batch, VkSubmitInfo* submit_info,
       VkTimelineSemaphoreSubmitInfo* timeline_submit_info, Arena* arena);
+
+  iree_status_t SubmitImmediate(iree_host_size_t batch_count,
+                                const iree_hal_submission_batch_t* batches);
+
+  iree_status_t WaitIdleImpl(iree_timeout_t timeout);
+
+  // Appends |batch| to the held submissions, merging it into the last pending
+  // VkSubmitInfo when doing so cannot delay it on new dependencies.
+  void AppendBatchLocked(const iree_hal_submission_batch_t* batch);
+
+  // Issues all held submissions in a single vkQueueSubmit.
+  iree_status_t FlushLocked();
+
+  // Releases the resources of issued submissions that have completed.
+  void RetireCompletedLocked();
+
+  // Returns a reset fence from the pool or creates a new one.
+  iree_status_t AcquireFenceLocked(VkFence* out_fence);
+
+  const iree_host_size_t batch_max_count_;
+  const iree_duration_t batch_window_ns_;
+
+  // Guards the batching state below. Acquired before |queue_mutex_|.
+  iree_slim_mutex_t batch_mutex_;
+
+  // Held submit infos; only the first |pending_submit_info_count_| are used so
+  // that their storage is reused across flushes.
+  std::vector<PendingSubmitInfo> pending_submit_infos_
+      IREE_GUARDED_BY(batch_mutex_);
+  iree_host_size_t pending_submit_info_count_ IREE_GUARDED_BY(batch_mutex_) =
+      0;
+  // Total number of submission batches held.
+  iree_host_size_t pending_batch_count_ IREE_GUARDED_BY(batch_mutex_) = 0;
+  // Time after which the next submission flushes the held submissions.
+  iree_time_t pending_deadline_ns_ IREE_GUARDED_BY(batch_mutex_) =
+      IREE_TIME_INFINITE_FUTURE;
+  // Resources retained by the held submissions.
+  std::vector<iree_hal_resource_t*> pending_resources_
+      IREE_GUARDED_BY(batch_mutex_);
+
+  // Issued submissions in submission order.
+  std::vector<InFlightSubmit> in_flight_submits_ IREE_GUARDED_BY(batch_mutex_);
+  // Fences available for reuse; all are unsignaled.
+  std::vector<VkFence> free_fences_ IREE_GUARDED_BY(batch_mutex_);
 };
 
 }  // namespace vulkan
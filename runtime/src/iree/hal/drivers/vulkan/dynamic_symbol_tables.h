@@ -50,6 +50,7 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkCmdBeginRenderPass)                               \
   DEV_PFN(EXCLUDED, vkCmdBeginRenderPass2KHR)                           \
   DEV_PFN(EXCLUDED, vkCmdBeginTransformFeedbackEXT)                     \
+  DEV_PFN(OPTIONAL, vkCmdBindDescriptorBuffersEXT)                      \
   DEV_PFN(REQUIRED, vkCmdBindDescriptorSets)                            \
   DEV_PFN(EXCLUDED, vkCmdBindIndexBuffer)                               \
   DEV_PFN(REQUIRED, vkCmdBindPipeline)                                  \
@@ -112,6 +113,7 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkCmdSetCoarseSampleOrderNV)                        \
   DEV_PFN(EXCLUDED, vkCmdSetDepthBias)                                  \
   DEV_PFN(EXCLUDED, vkCmdSetDepthBounds)                                \
+  DEV_PFN(OPTIONAL, vkCmdSetDescriptorBufferOffsetsEXT)                 \
   DEV_PFN(EXCLUDED, vkCmdSetDeviceMask)                                 \
   DEV_PFN(EXCLUDED, vkCmdSetDeviceMaskKHR)                              \
   DEV_PFN(EXCLUDED, vkCmdSetDiscardRectangleEXT)                        \
@@ -221,6 +223,9 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkGetBufferMemoryRequirements2)                     \
   DEV_PFN(EXCLUDED, vkGetBufferMemoryRequirements2KHR)                  \
   DEV_PFN(OPTIONAL, vkGetCalibratedTimestampsEXT)                       \
+  DEV_PFN(OPTIONAL, vkGetDescriptorEXT)                                 \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutBindingOffsetEXT)           \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutSizeEXT)                    \
   DEV_PFN(EXCLUDED, vkGetDescriptorSetLayoutSupport)                    \
   DEV_PFN(EXCLUDED, vkGetDescriptorSetLayoutSupportKHR)                 \
   DEV_PFN(EXCLUDED, vkGetDeviceGroupPeerMemoryFeatures)                 \
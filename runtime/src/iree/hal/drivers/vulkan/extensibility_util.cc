@@ -225,6 +225,9 @@ iree_hal_vulkan_populate_enabled_device_extensions(
     } else if (strcmp(extension_name,
                       VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME) == 0) {
       extensions.cooperative_matrix = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0) {
+      extensions.descriptor_buffer = true;
     }
   }
   return extensions;
@@ -254,5 +257,8 @@ iree_hal_vulkan_infer_enabled_device_extensions(
       device_syms->vkGetBufferDeviceAddressKHR) {
     extensions.buffer_device_address = true;
   }
+  if (device_syms->vkCmdBindDescriptorBuffersEXT) {
+    extensions.descriptor_buffer = true;
+  }
   return extensions;
 }
@@ -8,6 +8,7 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/vulkan/api.h"
 #include "iree/hal/drivers/vulkan/base_buffer.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/native_buffer.h"
@@ -38,6 +39,11 @@ typedef struct iree_hal_vulkan_native_allocator_t {
   // Used to quickly look up the memory type index used for a particular usage.
   iree_hal_vulkan_memory_types_t memory_types;
 
+  // Queue families buffers are shared between. Buffers use concurrent sharing
+  // when there is more than one family (dispatch and dedicated transfer).
+  uint32_t queue_family_count;
+  uint32_t queue_family_indices[2];
+
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_vulkan_native_allocator_t;
 
@@ -58,11 +64,19 @@ static void iree_hal_vulkan_native_allocator_destroy(
 extern "C" iree_status_t iree_hal_vulkan_native_allocator_create(
     const iree_hal_vulkan_device_options_t* options, VkInstance instance,
     VkPhysicalDevice physical_device, VkDeviceHandle* logical_device,
+    iree_host_size_t queue_family_count, const uint32_t* queue_family_indices,
     iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(physical_device);
   IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(!queue_family_count || queue_family_indices);
   IREE_ASSERT_ARGUMENT(out_allocator);
+  if (queue_family_count > 2) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "at most 2 queue families may share buffers; "
+                            "got %" PRIhsz,
+                            queue_family_count);
+  }
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_allocator_t host_allocator = logical_device->host_allocator();
@@ -74,6 +88,10 @@ extern "C" iree_status_t iree_hal_vulkan_native_allocator_create(
                                &allocator->resource);
   allocator->logical_device = logical_device;
   allocator->host_allocator = host_allocator;
+  allocator->queue_family_count = (uint32_t)queue_family_count;
+  for (iree_host_size_t i = 0; i < queue_family_count; ++i) {
+    allocator->queue_family_indices[i] = queue_family_indices[i];
+  }
 
   const auto& syms = logical_device->syms();
 
@@ -345,13 +363,14 @@ static iree_status_t iree_hal_vulkan_native_allocator_commit_and_wrap(
 }
 
 static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
-    VkDeviceHandle* logical_device,
+    iree_hal_vulkan_native_allocator_t* IREE_RESTRICT allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
     iree_device_size_t allocation_size, bool use_sparse_allocation,
     bool bind_host_memory, VkBuffer* out_handle) {
-  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(allocator);
   IREE_ASSERT_ARGUMENT(params);
   *out_handle = VK_NULL_HANDLE;
+  VkDeviceHandle* logical_device = allocator->logical_device;
 
   // Create an initially unbound buffer handle. The buffer is the logical view
   // into the physical allocation(s) that are bound to it below.
@@ -371,14 +390,26 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     buffer_create_info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     buffer_create_info.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     buffer_create_info.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    // Descriptor buffers reference bindings by device address.
+    if (iree_all_bits_set(logical_device->enabled_features(),
+                          IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+      buffer_create_info.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
   }
   if (use_sparse_allocation) {
     buffer_create_info.flags |= VK_BUFFER_CREATE_SPARSE_BINDING_BIT |
                                 VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
   }
-  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  buffer_create_info.queueFamilyIndexCount = 0;
-  buffer_create_info.pQueueFamilyIndices = NULL;
+  if (allocator->queue_family_count > 1) {
+    // Buffers are accessed from both dispatch and dedicated transfer queues.
+    buffer_create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    buffer_create_info.queueFamilyIndexCount = allocator->queue_family_count;
+    buffer_create_info.pQueueFamilyIndices = allocator->queue_family_indices;
+  } else {
+    buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    buffer_create_info.queueFamilyIndexCount = 0;
+    buffer_create_info.pQueueFamilyIndices = NULL;
+  }
 
   // If trying to bind to external memory we need to verify we can create a
   // buffer that can be bound.
@@ -478,7 +509,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_allocate_internal(
   // into the physical allocation(s) that are bound to it below.
   VkBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
-      logical_device, params, allocation_size, use_sparse_allocation,
+      allocator, params, allocation_size, use_sparse_allocation,
       /*bind_host_memory=*/false, &handle));
 
   // Commit the backing memory for the buffer and wrap it in a HAL buffer type.
@@ -660,7 +691,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_host_buffer(
   // imported buffer must satisfy.
   VkBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
-      logical_device, params, external_buffer->size,
+      allocator, params, external_buffer->size,
       /*use_sparse_allocation=*/false,
       /*bind_host_memory=*/true, &handle));
 
@@ -791,7 +822,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_device_buffer(
   // Create the logical buffer we can attach the memory to.
   VkBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
-      logical_device, params, external_buffer->size,
+      allocator, params, external_buffer->size,
       /*use_sparse_allocation=*/false,
       /*bind_host_memory=*/false, &handle));
 
@@ -853,6 +884,105 @@ static iree_status_t iree_hal_vulkan_native_allocator_export_buffer(
                           "exporting to external buffers not supported");
 }
 
+IREE_API_EXPORT iree_status_t
+iree_hal_vulkan_allocator_allocate_growable_buffer(
+    iree_hal_allocator_t* base_allocator,
+    const iree_hal_buffer_params_t* params, iree_device_size_t reserved_size,
+    iree_device_size_t committed_size, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (!iree_hal_resource_is(base_allocator,
+                            &iree_hal_vulkan_native_allocator_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocator is not a Vulkan native allocator");
+  }
+  iree_hal_vulkan_native_allocator_t* allocator =
+      iree_hal_vulkan_native_allocator_cast(base_allocator);
+  VkDeviceHandle* logical_device = allocator->logical_device;
+  if (!iree_all_bits_set(
+          logical_device->enabled_features(),
+          IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_RESIDENCY_ALIASED)) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "growable buffers require sparse residency support to be present "
+        "and enabled on the device");
+  } else if (committed_size > reserved_size) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "committed size %" PRIu64
+                            " exceeds reserved size %" PRIu64,
+                            (uint64_t)committed_size, (uint64_t)reserved_size);
+  }
+
+  // Coerce options into those required by the current device. Sparse buffers
+  // cannot be mapped and the compatibility query strips optional mapping.
+  iree_hal_buffer_params_t compat_params = *params;
+  compat_params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL;
+  iree_device_size_t allocation_size = reserved_size;
+  if (!iree_all_bits_set(
+          iree_hal_vulkan_native_allocator_query_buffer_compatibility(
+              base_allocator, &compat_params, &allocation_size),
+          IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE) ||
+      iree_any_bit_set(compat_params.usage,
+                       IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                           IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "allocator cannot allocate a growable buffer with the given "
+        "parameters");
+  }
+  compat_params.usage &= ~IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  // Create the buffer for the full reserved size; only the committed range is
+  // bound to physical memory.
+  VkBuffer handle = VK_NULL_HANDLE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_native_allocator_create_buffer(
+              allocator, &compat_params, allocation_size,
+              /*use_sparse_allocation=*/true,
+              /*bind_host_memory=*/false, &handle));
+
+  // TODO(benvanik): map queue affinity.
+  VkQueue queue = VK_NULL_HANDLE;
+  logical_device->syms()->vkGetDeviceQueue(*logical_device, 0, 0, &queue);
+
+  VkMemoryRequirements requirements = {0};
+  logical_device->syms()->vkGetBufferMemoryRequirements(*logical_device, handle,
+                                                        &requirements);
+  uint32_t memory_type_index = 0;
+  iree_status_t status = iree_hal_vulkan_find_memory_type(
+      &allocator->device_props, &allocator->memory_props, &compat_params,
+      /*allowed_type_indices=*/requirements.memoryTypeBits,
+      &memory_type_index);
+
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_sparse_buffer_create_growable_sync(
+        base_allocator, compat_params.type, compat_params.access,
+        compat_params.usage, allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, logical_device, queue, handle,
+        requirements, memory_type_index,
+        allocator->device_props_11.maxMemoryAllocationSize, committed_size,
+        &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED(IREE_HAL_VULKAN_NATIVE_ALLOCATOR_ID, (void*)handle,
+                           allocation_size);
+    iree_hal_allocator_statistics_record_alloc(
+        &allocator->statistics, compat_params.type, buffer->allocation_size);
+    *out_buffer = buffer;
+  } else {
+    logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
+                                            logical_device->allocator());
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 namespace {
 const iree_hal_allocator_vtable_t iree_hal_vulkan_native_allocator_vtable = {
     /*.destroy=*/iree_hal_vulkan_native_allocator_destroy,
@@ -17,10 +17,16 @@ extern "C" {
 
 // Creates a native Vulkan API-based allocator that directly allocates memory
 // from the underlying implementation with no pooling or suballocation.
+//
+// Buffers are shared between the |queue_family_count| queue families in
+// |queue_family_indices|. When more than one family is provided buffers use
+// concurrent sharing so that queues of any of the families can access them
+// without explicit ownership transfers.
 iree_status_t iree_hal_vulkan_native_allocator_create(
     const iree_hal_vulkan_device_options_t* options, VkInstance instance,
     VkPhysicalDevice physical_device,
     iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_host_size_t queue_family_count, const uint32_t* queue_family_indices,
     iree_hal_allocator_t** out_allocator);
 
 #ifdef __cplusplus
@@ -67,6 +67,27 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
     VkShaderModule shader_module, iree_host_size_t pipeline_count,
     iree_hal_vulkan_entry_point_t* out_entry_points) {
   IREE_TRACE_SCOPE();
+
+  // Entry points requiring a subgroup size were generated for that size
+  // (e.g. subgroup reductions on devices running both wave32 and wave64) and
+  // would produce wrong results if the driver picked another one.
+  flatbuffers_uint32_vec_t subgroup_sizes_vec =
+      iree_hal_spirv_ExecutableDef_subgroup_sizes_get(executable_def);
+  if (subgroup_sizes_vec &&
+      !logical_device->enabled_extensions().subgroup_size_control) {
+    for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+      if (uint32_t subgroup_size =
+              flatbuffers_uint32_vec_at(subgroup_sizes_vec, i)) {
+        return iree_make_status(
+            IREE_STATUS_UNAVAILABLE,
+            "executable entry point %" PRIhsz
+            " requires a subgroup size of %u but "
+            "VK_EXT_subgroup_size_control is not enabled on the device",
+            i, subgroup_size);
+      }
+    }
+  }
+
   uint8_t* scratch_memory = NULL;
   size_t create_info_size =
       pipeline_count * sizeof(VkComputePipelineCreateInfo);
@@ -102,8 +123,6 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
 
   flatbuffers_string_vec_t entry_points_vec =
       iree_hal_spirv_ExecutableDef_entry_points_get(executable_def);
-  flatbuffers_uint32_vec_t subgroup_sizes_vec =
-      iree_hal_spirv_ExecutableDef_subgroup_sizes_get(executable_def);
   for (iree_host_size_t entry_ordinal = 0; entry_ordinal < pipeline_count;
        ++entry_ordinal) {
     VkComputePipelineCreateInfo* create_info = &create_infos[entry_ordinal];
@@ -120,6 +139,10 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
     } else {
       create_info->flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
     }
+    if (iree_all_bits_set(logical_device->enabled_features(),
+                          IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+      create_info->flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
     create_info->layout = iree_hal_vulkan_native_pipeline_layout_handle(
         executable_params->pipeline_layouts[entry_ordinal]);
     create_info->basePipelineHandle = VK_NULL_HANDLE;
@@ -8,6 +8,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
@@ -26,6 +27,13 @@ typedef struct iree_hal_vulkan_native_descriptor_set_layout_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
   VkDescriptorSetLayout handle;
+  // Total size of the set in a descriptor buffer when descriptor buffers are
+  // enabled and otherwise 0.
+  VkDeviceSize descriptor_buffer_size;
+  // Offsets of each binding within the set in a descriptor buffer indexed by
+  // binding ordinal. Only populated when descriptor buffers are enabled.
+  iree_host_size_t binding_offset_count;
+  VkDeviceSize binding_offsets[];
 } iree_hal_vulkan_native_descriptor_set_layout_t;
 
 namespace {
@@ -52,9 +60,21 @@ static iree_status_t iree_hal_vulkan_create_descriptor_set_layout(
   create_info.pNext = NULL;
   create_info.flags = 0;
 
+  // Descriptor buffers require all set layouts used by a pipeline to be
+  // descriptor buffer compatible, including empty ones. They cannot be
+  // combined with push descriptor layouts.
+  bool use_descriptor_buffers =
+      iree_all_bits_set(logical_device->enabled_features(),
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS);
+  if (use_descriptor_buffers) {
+    create_info.flags |=
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+
   VkDescriptorSetLayoutBinding* native_bindings = NULL;
   if (binding_count > 0) {
-    if (logical_device->enabled_extensions().push_descriptors) {
+    if (!use_descriptor_buffers &&
+        logical_device->enabled_extensions().push_descriptors) {
       // Note that we can *only* use push descriptor sets if we set this create
       // flag. If push descriptors aren't supported we emulate them with normal
       // descriptors so it's fine to have kPushOnly without support.
@@ -117,16 +137,48 @@ iree_status_t iree_hal_vulkan_native_descriptor_set_layout_create(
       z0, iree_hal_vulkan_create_descriptor_set_layout(
               logical_device, flags, binding_count, bindings, &handle));
 
+  // Binding offsets are indexed by binding ordinal so that they can be looked
+  // up directly while writing descriptors.
+  bool use_descriptor_buffers =
+      iree_all_bits_set(logical_device->enabled_features(),
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS);
+  iree_host_size_t binding_offset_count = 0;
+  if (use_descriptor_buffers) {
+    for (iree_host_size_t i = 0; i < binding_count; ++i) {
+      binding_offset_count =
+          iree_max(binding_offset_count, bindings[i].binding + 1);
+    }
+  }
+
   iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout = NULL;
-  iree_status_t status = iree_allocator_malloc(logical_device->host_allocator(),
-                                               sizeof(*descriptor_set_layout),
-                                               (void**)&descriptor_set_layout);
+  iree_status_t status = iree_allocator_malloc(
+      logical_device->host_allocator(),
+      sizeof(*descriptor_set_layout) +
+          binding_offset_count *
+              sizeof(descriptor_set_layout->binding_offsets[0]),
+      (void**)&descriptor_set_layout);
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(
         &iree_hal_vulkan_native_descriptor_set_layout_vtable,
         &descriptor_set_layout->resource);
     descriptor_set_layout->logical_device = logical_device;
     descriptor_set_layout->handle = handle;
+    descriptor_set_layout->descriptor_buffer_size = 0;
+    descriptor_set_layout->binding_offset_count = binding_offset_count;
+    memset(descriptor_set_layout->binding_offsets, 0,
+           binding_offset_count *
+               sizeof(descriptor_set_layout->binding_offsets[0]));
+    if (use_descriptor_buffers) {
+      const auto& syms = logical_device->syms();
+      syms->vkGetDescriptorSetLayoutSizeEXT(
+          *logical_device, handle,
+          &descriptor_set_layout->descriptor_buffer_size);
+      for (iree_host_size_t i = 0; i < binding_count; ++i) {
+        syms->vkGetDescriptorSetLayoutBindingOffsetEXT(
+            *logical_device, handle, bindings[i].binding,
+            &descriptor_set_layout->binding_offsets[bindings[i].binding]);
+      }
+    }
     *out_descriptor_set_layout =
         (iree_hal_descriptor_set_layout_t*)descriptor_set_layout;
   } else {
@@ -161,6 +213,24 @@ VkDescriptorSetLayout iree_hal_vulkan_native_descriptor_set_layout_handle(
   return descriptor_set_layout->handle;
 }
 
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_buffer_size(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  return descriptor_set_layout->descriptor_buffer_size;
+}
+
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout,
+    uint32_t binding) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  IREE_ASSERT_LT(binding, descriptor_set_layout->binding_offset_count);
+  return descriptor_set_layout->binding_offsets[binding];
+}
+
 namespace {
 const iree_hal_descriptor_set_layout_vtable_t
     iree_hal_vulkan_native_descriptor_set_layout_vtable = {
@@ -35,6 +35,18 @@ iree_status_t iree_hal_vulkan_native_descriptor_set_layout_create(
 VkDescriptorSetLayout iree_hal_vulkan_native_descriptor_set_layout_handle(
     iree_hal_descriptor_set_layout_t* base_descriptor_set_layout);
 
+// Returns the size in bytes of the descriptor set in a descriptor buffer.
+// Only valid when IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS is enabled.
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_buffer_size(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout);
+
+// Returns the byte offset of |binding| within the descriptor set in a
+// descriptor buffer.
+// Only valid when IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS is enabled.
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout,
+    uint32_t binding);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_vulkan_native_pipeline_layout_t
 //===----------------------------------------------------------------------===//
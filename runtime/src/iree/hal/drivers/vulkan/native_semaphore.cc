@@ -20,6 +20,7 @@ using namespace iree::hal::vulkan;
 typedef struct iree_hal_vulkan_native_semaphore_t {
   iree_hal_semaphore_t base;
   VkDeviceHandle* logical_device;
+  iree_hal_vulkan_submission_flush_t submission_flush;
   VkSemaphore handle;
   iree_atomic_intptr_t failure_status;
 } iree_hal_vulkan_native_semaphore_t;
@@ -36,7 +37,8 @@ iree_hal_vulkan_native_semaphore_cast(iree_hal_semaphore_t* base_value) {
 }
 
 iree_status_t iree_hal_vulkan_native_semaphore_create(
-    iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_vulkan_submission_flush_t submission_flush, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   IREE_ASSERT_ARGUMENT(logical_device);
   IREE_ASSERT_ARGUMENT(out_semaphore);
@@ -67,6 +69,7 @@ iree_status_t iree_hal_vulkan_native_semaphore_create(
     iree_hal_semaphore_initialize(&iree_hal_vulkan_native_semaphore_vtable,
                                   &semaphore->base);
     semaphore->logical_device = logical_device;
+    semaphore->submission_flush = submission_flush;
     semaphore->handle = handle;
     iree_atomic_store_intptr(&semaphore->failure_status, 0,
                              iree_memory_order_release);
@@ -112,11 +115,21 @@ VkSemaphore iree_hal_vulkan_native_semaphore_handle(
   return semaphore->handle;
 }
 
+// Issues any submissions held by queues so that the host can observe signals
+// they may make.
+static iree_status_t iree_hal_vulkan_native_semaphore_flush_submissions(
+    iree_hal_vulkan_native_semaphore_t* semaphore) {
+  if (!semaphore->submission_flush.fn) return iree_ok_status();
+  return semaphore->submission_flush.fn(semaphore->submission_flush.user_data);
+}
+
 static iree_status_t iree_hal_vulkan_native_semaphore_query(
     iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
   iree_hal_vulkan_native_semaphore_t* semaphore =
       iree_hal_vulkan_native_semaphore_cast(base_semaphore);
   *out_value = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_native_semaphore_flush_submissions(semaphore));
 
   // Query from Vulkan source-of-truth.
   uint64_t value = 0;
@@ -285,10 +298,93 @@ static iree_status_t iree_hal_vulkan_native_semaphore_wait(
       /*.semaphores=*/&base_semaphore,
       /*.payload_values=*/&value,
   };
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_native_semaphore_flush_submissions(semaphore));
   return iree_hal_vulkan_native_semaphore_multi_wait(
       semaphore->logical_device, &semaphore_list, timeout, 0);
 }
 
+// Forwards a timepoint on a non-Vulkan semaphore to a native semaphore.
+// Owned by the timepoint and freed when its callback is issued.
+typedef struct iree_hal_vulkan_semaphore_import_t {
+  iree_hal_semaphore_timepoint_t timepoint;
+  iree_allocator_t host_allocator;
+  iree_hal_semaphore_t* target;
+} iree_hal_vulkan_semaphore_import_t;
+
+// Signals or fails the native semaphore of an import from the thread that
+// signaled the imported semaphore.
+static iree_status_t iree_hal_vulkan_semaphore_import_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_vulkan_semaphore_import_t* import =
+      (iree_hal_vulkan_semaphore_import_t*)user_data;
+  iree_status_t status = iree_status_from_code(status_code);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_signal(import->target, 1ull);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_semaphore_fail(import->target, status);
+  }
+  iree_hal_semaphore_release(import->target);
+  iree_allocator_free(import->host_allocator, import);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_vulkan_native_semaphore_import_timepoint(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(semaphore);
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Fail early if the semaphore has already failed so that submissions are not
+  // issued with waits that will never be satisfied successfully.
+  uint64_t current_value = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_semaphore_query(semaphore, &current_value));
+
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  iree_hal_vulkan_semaphore_import_t* import = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*import),
+                                (void**)&import));
+  import->host_allocator = host_allocator;
+
+  iree_hal_vulkan_submission_flush_t submission_flush = {NULL, NULL};
+  iree_status_t status = iree_hal_vulkan_native_semaphore_create(
+      logical_device, submission_flush, 0ull, &import->target);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, import);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // The import holds its own reference that is dropped by the callback.
+  iree_hal_semaphore_t* target = import->target;
+  iree_hal_semaphore_retain(target);
+  iree_hal_semaphore_acquire_timepoint(
+      semaphore, value, iree_infinite_timeout(),
+      {
+          /*.fn=*/iree_hal_vulkan_semaphore_import_callback,
+          /*.user_data=*/import,
+      },
+      &import->timepoint);
+
+  // Timepoints only resolve on the next notification of the semaphore and if
+  // the value was reached before the timepoint was acquired there may not be
+  // one; polling resolves it immediately in that case. |import| may be freed
+  // once the timepoint has been acquired.
+  iree_hal_semaphore_poll(semaphore);
+
+  *out_semaphore = target;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_vulkan_semaphore_handle(
     iree_hal_semaphore_t* base_semaphore, VkSemaphore* out_handle) {
   IREE_ASSERT_ARGUMENT(base_semaphore);
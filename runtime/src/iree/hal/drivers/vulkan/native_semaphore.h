@@ -17,9 +17,31 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Flushes submissions held by queues that may signal semaphores.
+// Called before the host waits on or queries a semaphore so that batched
+// submissions it depends on are issued to the device.
+typedef struct iree_hal_vulkan_submission_flush_t {
+  iree_status_t (*fn)(void* user_data);
+  void* user_data;
+} iree_hal_vulkan_submission_flush_t;
+
 // Creates a timeline semaphore implemented using the native VkSemaphore type.
+// |submission_flush| is optional and must remain valid for the lifetime of the
+// semaphore.
 iree_status_t iree_hal_vulkan_native_semaphore_create(
-    iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_vulkan_submission_flush_t submission_flush, uint64_t initial_value,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Imports the timepoint |value| of a non-Vulkan |semaphore| as a new native
+// semaphore |out_semaphore| that devices can wait on for value 1.
+// The native semaphore is signaled from the host by whichever thread signals
+// |semaphore| to |value| or failed if |semaphore| fails, allowing queues to be
+// submitted ahead of work on other devices without blocking the host.
+// The import keeps |out_semaphore| live until it is signaled.
+iree_status_t iree_hal_vulkan_native_semaphore_import_timepoint(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_hal_semaphore_t* semaphore, uint64_t value,
     iree_hal_semaphore_t** out_semaphore);
 
 // Returns true if |semaphore| is a Vulkan native semaphore.
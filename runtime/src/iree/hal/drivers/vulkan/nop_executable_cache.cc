@@ -6,17 +6,31 @@
 
 #include "iree/hal/drivers/vulkan/nop_executable_cache.h"
 
+#include <cerrno>
+#include <cinttypes>
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
 #include "iree/hal/drivers/vulkan/native_executable.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
 
 using namespace iree::hal::vulkan;
 
 typedef struct iree_hal_vulkan_nop_executable_cache_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
+  // Optional directory used to persist pipeline caches. Stored in the trailing
+  // allocation.
+  iree_string_view_t pipeline_cache_path;
+  // Properties of the physical device used to validate persisted caches.
+  uint32_t vendor_id;
+  uint32_t device_id;
+  uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
 } iree_hal_vulkan_nop_executable_cache_t;
 
 namespace {
@@ -34,20 +48,36 @@ iree_hal_vulkan_nop_executable_cache_cast(
 
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    iree_string_view_t identifier,
+    VkPhysicalDevice physical_device, iree_string_view_t identifier,
+    iree_string_view_t pipeline_cache_path,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   *out_executable_cache = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_vulkan_nop_executable_cache_t* executable_cache = NULL;
-  iree_status_t status = iree_allocator_malloc(logical_device->host_allocator(),
-                                               sizeof(*executable_cache),
-                                               (void**)&executable_cache);
+  iree_host_size_t total_size =
+      sizeof(*executable_cache) + pipeline_cache_path.size;
+  iree_status_t status = iree_allocator_malloc(
+      logical_device->host_allocator(), total_size, (void**)&executable_cache);
   if (iree_status_is_ok(status)) {
+    memset(executable_cache, 0, total_size);
     iree_hal_resource_initialize(&iree_hal_vulkan_nop_executable_cache_vtable,
                                  &executable_cache->resource);
     executable_cache->logical_device = logical_device;
+    iree_string_view_append_to_buffer(
+        pipeline_cache_path, &executable_cache->pipeline_cache_path,
+        (char*)executable_cache + sizeof(*executable_cache));
+    if (!iree_string_view_is_empty(pipeline_cache_path)) {
+      VkPhysicalDeviceProperties properties;
+      logical_device->syms()->vkGetPhysicalDeviceProperties(physical_device,
+                                                            &properties);
+      executable_cache->vendor_id = properties.vendorID;
+      executable_cache->device_id = properties.deviceID;
+      memcpy(executable_cache->pipeline_cache_uuid,
+             properties.pipelineCacheUUID,
+             sizeof(executable_cache->pipeline_cache_uuid));
+    }
 
     *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
   }
@@ -88,6 +118,187 @@ static bool iree_hal_vulkan_nop_executable_cache_can_prepare_format(
   return false;
 }
 
+//===----------------------------------------------------------------------===//
+// Persistent pipeline caches
+//===----------------------------------------------------------------------===//
+
+// Returns a 64-bit FNV-1a hash of |data| continuing from |hash|.
+static uint64_t iree_hal_vulkan_pipeline_cache_hash(uint64_t hash,
+                                                    const void* data,
+                                                    iree_host_size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns the path of the persisted pipeline cache for |executable_params|.
+// The caller must free the returned path with the host allocator.
+static iree_status_t iree_hal_vulkan_pipeline_cache_file_path(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params, char** out_path) {
+  // Specialization constants are part of the pipeline state and are hashed
+  // along with the code so that variants don't overwrite each other.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  hash = iree_hal_vulkan_pipeline_cache_hash(
+      hash, executable_params->executable_format.data,
+      executable_params->executable_format.size);
+  hash = iree_hal_vulkan_pipeline_cache_hash(
+      hash, executable_params->executable_data.data,
+      executable_params->executable_data.data_length);
+  hash = iree_hal_vulkan_pipeline_cache_hash(
+      hash, executable_params->constants,
+      executable_params->constant_count *
+          sizeof(executable_params->constants[0]));
+
+  char file_name[2 * VK_UUID_SIZE + 1 + 16 + sizeof(".vkpipelinecache")];
+  char* p = file_name;
+  for (int i = 0; i < VK_UUID_SIZE; ++i) {
+    p += snprintf(p, 3, "%02x", executable_cache->pipeline_cache_uuid[i]);
+  }
+  snprintf(p, sizeof(file_name) - (p - file_name),
+           "-%016" PRIx64 ".vkpipelinecache", hash);
+  return iree_file_path_join(executable_cache->pipeline_cache_path,
+                             iree_make_cstring_view(file_name),
+                             executable_cache->logical_device->host_allocator(),
+                             out_path);
+}
+
+// Returns true if |data| is a pipeline cache produced by the device the
+// |executable_cache| was created for. Drivers are required to validate the
+// header themselves but some mobile drivers have been known to crash on
+// mismatched data so we reject it up-front.
+static bool iree_hal_vulkan_pipeline_cache_is_compatible(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    iree_const_byte_span_t data) {
+  VkPipelineCacheHeaderVersionOne header;
+  if (data.data_length < sizeof(header)) return false;
+  memcpy(&header, data.data, sizeof(header));
+  return header.headerSize >= sizeof(header) &&
+         header.headerSize <= data.data_length &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == executable_cache->vendor_id &&
+         header.deviceID == executable_cache->device_id &&
+         memcmp(header.pipelineCacheUUID,
+                executable_cache->pipeline_cache_uuid, VK_UUID_SIZE) == 0;
+}
+
+// Writes the contents of |pipeline_cache| to |path| if they differ in size
+// from the |loaded_length| bytes originally loaded. The file is written to a
+// temporary path and renamed so that concurrent processes never observe
+// partial contents.
+static iree_status_t iree_hal_vulkan_pipeline_cache_save(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    VkPipelineCache pipeline_cache, iree_host_size_t loaded_length,
+    const char* path) {
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  size_t data_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, VK_RESULT_TO_STATUS(
+              logical_device->syms()->vkGetPipelineCacheData(
+                  *logical_device, pipeline_cache, &data_size, NULL),
+              "vkGetPipelineCacheData"));
+  if (data_size == loaded_length) {
+    // Nothing was added to the cache.
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  iree_host_size_t path_length = strlen(path);
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                data_size + path_length + sizeof(".tmp"),
+                                (void**)&storage));
+  char* temp_path = (char*)storage + data_size;
+  memcpy(temp_path, path, path_length);
+  memcpy(temp_path + path_length, ".tmp", sizeof(".tmp"));
+
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkGetPipelineCacheData(
+          *logical_device, pipeline_cache, &data_size, storage),
+      "vkGetPipelineCacheData");
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        temp_path, iree_make_const_byte_span(storage, data_size));
+  }
+  if (iree_status_is_ok(status) && rename(temp_path, path) != 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to rename '%s' to '%s'", temp_path,
+                              path);
+    remove(temp_path);
+  }
+
+  iree_allocator_free(host_allocator, storage);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Creates an executable using a pipeline cache persisted in the cache
+// directory. Errors loading or saving the pipeline cache are ignored.
+static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_persistent(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable) {
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char* path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_pipeline_cache_file_path(executable_cache,
+                                                   executable_params, &path));
+
+  // Load the existing cache contents, if any. Missing or stale files are
+  // treated as empty and the cache is rebuilt from scratch.
+  iree_file_contents_t* contents = NULL;
+  iree_status_t load_status = iree_file_read_contents(
+      path, IREE_FILE_READ_FLAG_DEFAULT, host_allocator, &contents);
+  iree_const_byte_span_t initial_data = iree_const_byte_span_empty();
+  if (iree_status_is_ok(load_status) &&
+      iree_hal_vulkan_pipeline_cache_is_compatible(executable_cache,
+                                                   contents->const_buffer)) {
+    initial_data = contents->const_buffer;
+  }
+  iree_status_ignore(load_status);
+
+  VkPipelineCacheCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.pNext = NULL;
+  create_info.flags = 0;
+  create_info.initialDataSize = initial_data.data_length;
+  create_info.pInitialData = initial_data.data;
+  VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+  iree_status_t cache_status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkCreatePipelineCache(
+          *logical_device, &create_info, logical_device->allocator(),
+          &pipeline_cache),
+      "vkCreatePipelineCache");
+  iree_file_contents_free(contents);
+  iree_status_ignore(cache_status);
+
+  iree_status_t status = iree_hal_vulkan_native_executable_create(
+      logical_device, pipeline_cache, executable_params, out_executable);
+
+  if (pipeline_cache != VK_NULL_HANDLE) {
+    if (iree_status_is_ok(status)) {
+      iree_status_ignore(iree_hal_vulkan_pipeline_cache_save(
+          executable_cache, pipeline_cache, initial_data.data_length, path));
+    }
+    logical_device->syms()->vkDestroyPipelineCache(
+        *logical_device, pipeline_cache, logical_device->allocator());
+  }
+  iree_allocator_free(host_allocator, path);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_executable(
     iree_hal_executable_cache_t* base_executable_cache,
     const iree_hal_executable_params_t* executable_params,
@@ -103,6 +314,10 @@ static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_executable(
   }
   iree_hal_vulkan_nop_executable_cache_t* executable_cache =
       iree_hal_vulkan_nop_executable_cache_cast(base_executable_cache);
+  if (!iree_string_view_is_empty(executable_cache->pipeline_cache_path)) {
+    return iree_hal_vulkan_nop_executable_cache_prepare_persistent(
+        executable_cache, executable_params, out_executable);
+  }
   return iree_hal_vulkan_native_executable_create(
       executable_cache->logical_device,
       /*pipeline_cache=*/VK_NULL_HANDLE, executable_params, out_executable);
@@ -15,12 +15,20 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
+// Creates an executable cache that does not cache executables in memory.
 // This is useful to isolate pipeline caching behavior and verify compilation
 // behavior.
+//
+// If |pipeline_cache_path| is non-empty it names a directory used to persist
+// VkPipelineCache contents across processes. Each executable's pipeline cache
+// is loaded from the directory before its pipelines are created and saved
+// back when it changed, keyed by the executable contents and the
+// pipelineCacheUUID of |physical_device|. Failures to load or save are ignored
+// as the cache only affects performance.
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    iree_string_view_t identifier,
+    VkPhysicalDevice physical_device, iree_string_view_t identifier,
+    iree_string_view_t pipeline_cache_path,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
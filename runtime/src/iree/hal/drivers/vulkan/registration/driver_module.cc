@@ -42,9 +42,21 @@ IREE_FLAG(bool, vulkan_buffer_device_addresses, true,
           "Enables the Vulkan 'bufferDeviceAddress` feature and support for "
           "SPIR-V executables compiled to use it.");
 
+IREE_FLAG(bool, vulkan_descriptor_buffers, false,
+          "Enables the Vulkan `VK_EXT_descriptor_buffer` extension when "
+          "available and uses it for dispatch bindings.");
+
 IREE_FLAG(
     bool, vulkan_dedicated_compute_queue, false,
     "Use a dedicated queue with VK_QUEUE_COMPUTE_BIT for dispatch workloads.");
+IREE_FLAG(string, vulkan_pipeline_cache_path, "",
+          "Directory used to persist Vulkan pipeline caches across runs.");
+IREE_FLAG(int32_t, vulkan_submission_batch_max_count, 1,
+          "Maximum number of queue submissions batched into a single "
+          "vkQueueSubmit. Values <= 1 submit immediately.");
+IREE_FLAG(int32_t, vulkan_submission_batch_window_us, 1000,
+          "Time in microseconds a batched queue submission may be held "
+          "waiting for more submissions.");
 
 static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
@@ -94,11 +106,23 @@ static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     driver_options.requested_features |=
         IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
+  if (FLAG_vulkan_descriptor_buffers) {
+    driver_options.requested_features |=
+        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  }
 
   if (FLAG_vulkan_dedicated_compute_queue) {
     driver_options.device_options.flags |=
         IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE;
   }
+  driver_options.device_options.pipeline_cache_path =
+      iree_make_cstring_view(FLAG_vulkan_pipeline_cache_path);
+  driver_options.device_options.submission_batch_max_count =
+      FLAG_vulkan_submission_batch_max_count > 0
+          ? (iree_host_size_t)FLAG_vulkan_submission_batch_max_count
+          : 1;
+  driver_options.device_options.submission_batch_window_ns =
+      (iree_duration_t)FLAG_vulkan_submission_batch_window_us * 1000;
 
   // Load the Vulkan library. This will fail if the library cannot be found or
   // does not have the expected functions.
@@ -11,14 +11,27 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/vulkan/api.h"
 #include "iree/hal/drivers/vulkan/base_buffer.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 
 typedef struct iree_hal_vulkan_sparse_buffer_t {
   iree_hal_vulkan_base_buffer_t base;
   iree::hal::vulkan::VkDeviceHandle* logical_device;
+  // Queue used for binding physical blocks as the buffer grows.
+  VkQueue queue;
+  uint32_t memory_type_index;
+  // Total size of the sparse resource including implementation padding.
+  VkDeviceSize reserved_size;
+  // Required alignment of each sparse memory bind (the sparse page size).
+  VkDeviceSize alignment;
+  // Maximum size of each physical block; aligned to |alignment|.
+  VkDeviceSize physical_block_size;
+  // Bytes from the start of the resource that are bound to physical memory.
+  VkDeviceSize committed_size;
   iree_host_size_t physical_block_count;
-  VkDeviceMemory physical_blocks[];
+  iree_host_size_t physical_block_capacity;
+  VkDeviceMemory* physical_blocks;
 } iree_hal_vulkan_sparse_buffer_t;
 
 namespace {
@@ -31,17 +44,39 @@ static iree_hal_vulkan_sparse_buffer_t* iree_hal_vulkan_sparse_buffer_cast(
   return (iree_hal_vulkan_sparse_buffer_t*)base_value;
 }
 
-static iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
-    iree::hal::vulkan::VkDeviceHandle* logical_device, VkQueue queue,
-    VkBuffer handle, VkMemoryRequirements requirements,
-    uint32_t memory_type_index, VkDeviceSize physical_block_size,
-    iree_host_size_t physical_block_count,
-    VkDeviceMemory out_physical_blocks[]) {
+// Allocates physical blocks covering [committed_size, new_committed_size) and
+// binds them to the buffer. Existing bindings are untouched so that in-flight
+// work using the committed range is unaffected.
+static iree_status_t iree_hal_vulkan_sparse_buffer_bind_sync(
+    iree_hal_vulkan_sparse_buffer_t* buffer, VkDeviceSize new_committed_size) {
+  iree::hal::vulkan::VkDeviceHandle* logical_device = buffer->logical_device;
+  const VkDeviceSize bind_offset = buffer->committed_size;
+  const VkDeviceSize bind_size = new_committed_size - bind_offset;
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)requirements.size);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)requirements.alignment);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)physical_block_size);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)physical_block_count);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)bind_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)bind_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer->physical_block_size);
+
+  // ceil-div for the number of blocks as the last block may be partial.
+  const iree_host_size_t block_count =
+      (iree_host_size_t)iree_device_size_ceil_div(bind_size,
+                                                  buffer->physical_block_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_count);
+  if (buffer->physical_block_count + block_count >
+      buffer->physical_block_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(buffer->physical_block_capacity * 2,
+                 buffer->physical_block_count + block_count);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_realloc(
+                buffer->base.base.host_allocator,
+                new_capacity * sizeof(buffer->physical_blocks[0]),
+                (void**)&buffer->physical_blocks));
+    buffer->physical_block_capacity = new_capacity;
+  }
+  VkDeviceMemory* new_blocks =
+      &buffer->physical_blocks[buffer->physical_block_count];
+  memset(new_blocks, 0, sizeof(new_blocks[0]) * block_count);
 
   // Allocate all physical blocks; note that the last block may be of partial
   // size and we'll just allocate whatever remains from the total requested
@@ -49,80 +84,99 @@ static iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
   VkMemoryAllocateInfo allocate_info;
   allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
   allocate_info.pNext = NULL;
-  allocate_info.memoryTypeIndex = memory_type_index;
+  allocate_info.memoryTypeIndex = buffer->memory_type_index;
   VkSparseMemoryBind* binds = (VkSparseMemoryBind*)iree_alloca(
-      sizeof(VkSparseMemoryBind) * physical_block_count);
-  for (iree_host_size_t i = 0; i < physical_block_count; ++i) {
-    if (i < physical_block_count - 1) {
-      allocate_info.allocationSize = physical_block_size;
+      sizeof(VkSparseMemoryBind) * block_count);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < block_count; ++i) {
+    if (i < block_count - 1) {
+      allocate_info.allocationSize = buffer->physical_block_size;
     } else {
       allocate_info.allocationSize =
-          requirements.size - physical_block_size * (physical_block_count - 1);
+          bind_size - buffer->physical_block_size * (block_count - 1);
     }
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "vkAllocateMemory");
     IREE_TRACE_ZONE_APPEND_VALUE_I64(z1, (int64_t)allocate_info.allocationSize);
-    iree_status_t allocate_status = VK_RESULT_TO_STATUS(
+    status = VK_RESULT_TO_STATUS(
         logical_device->syms()->vkAllocateMemory(
             *logical_device, &allocate_info, logical_device->allocator(),
-            &out_physical_blocks[i]),
+            &new_blocks[i]),
         "vkAllocateMemory");
     IREE_TRACE_ZONE_END(z1);
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, allocate_status);
+    if (!iree_status_is_ok(status)) break;
 
-    binds[i].resourceOffset = i * physical_block_size;
+    binds[i].resourceOffset = bind_offset + i * buffer->physical_block_size;
     binds[i].size = allocate_info.allocationSize;
-    binds[i].memory = out_physical_blocks[i];
+    binds[i].memory = new_blocks[i];
     binds[i].memoryOffset = 0;
     binds[i].flags = 0;
   }
 
   // Temporary fence for enforcing host-synchronous execution.
-  VkFenceCreateInfo fence_info;
-  fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  fence_info.pNext = NULL;
-  fence_info.flags = 0;
   VkFence fence = VK_NULL_HANDLE;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, VK_RESULT_TO_STATUS(logical_device->syms()->vkCreateFence(
-                                  *logical_device, &fence_info,
-                                  logical_device->allocator(), &fence),
-                              "vkCreateFence"));
-
-  IREE_TRACE_ZONE_BEGIN_NAMED(z1, "vkQueueBindSparse");
-
-  // Enqueue sparse binding operation. This will complete asynchronously.
-  VkSparseBufferMemoryBindInfo memory_bind_info;
-  memory_bind_info.buffer = handle;
-  memory_bind_info.bindCount = (uint32_t)physical_block_count;
-  memory_bind_info.pBinds = binds;
-  VkBindSparseInfo bind_info;
-  memset(&bind_info, 0, sizeof(bind_info));
-  bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
-  bind_info.pNext = NULL;
-  bind_info.bufferBindCount = 1;
-  bind_info.pBufferBinds = &memory_bind_info;
-  iree_status_t status = VK_RESULT_TO_STATUS(
-      logical_device->syms()->vkQueueBindSparse(queue, 1, &bind_info, fence),
-      "vkQueueBindSparse");
-
-  // If enqueuing succeeded then wait for the binding to finish.
   if (iree_status_is_ok(status)) {
+    VkFenceCreateInfo fence_info;
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_info.pNext = NULL;
+    fence_info.flags = 0;
     status = VK_RESULT_TO_STATUS(
-        logical_device->syms()->vkWaitForFences(
-            *logical_device, 1, &fence, /*waitAll=*/VK_TRUE, UINT64_MAX),
-        "vkWaitForFences");
+        logical_device->syms()->vkCreateFence(
+            *logical_device, &fence_info, logical_device->allocator(), &fence),
+        "vkCreateFence");
   }
 
-  IREE_TRACE_ZONE_END(z1);
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "vkQueueBindSparse");
+
+    // Enqueue sparse binding operation. This will complete asynchronously.
+    VkSparseBufferMemoryBindInfo memory_bind_info;
+    memory_bind_info.buffer = buffer->base.handle;
+    memory_bind_info.bindCount = (uint32_t)block_count;
+    memory_bind_info.pBinds = binds;
+    VkBindSparseInfo bind_info;
+    memset(&bind_info, 0, sizeof(bind_info));
+    bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+    bind_info.pNext = NULL;
+    bind_info.bufferBindCount = 1;
+    bind_info.pBufferBinds = &memory_bind_info;
+    status = VK_RESULT_TO_STATUS(logical_device->syms()->vkQueueBindSparse(
+                                     buffer->queue, 1, &bind_info, fence),
+                                 "vkQueueBindSparse");
+
+    // If enqueuing succeeded then wait for the binding to finish.
+    if (iree_status_is_ok(status)) {
+      status = VK_RESULT_TO_STATUS(
+          logical_device->syms()->vkWaitForFences(
+              *logical_device, 1, &fence, /*waitAll=*/VK_TRUE, UINT64_MAX),
+          "vkWaitForFences");
+    }
+
+    IREE_TRACE_ZONE_END(z1);
+  }
 
-  logical_device->syms()->vkDestroyFence(*logical_device, fence,
-                                         logical_device->allocator());
+  if (fence != VK_NULL_HANDLE) {
+    logical_device->syms()->vkDestroyFence(*logical_device, fence,
+                                           logical_device->allocator());
+  }
+
+  if (iree_status_is_ok(status)) {
+    buffer->physical_block_count += block_count;
+    buffer->committed_size = new_committed_size;
+  } else {
+    // The blocks were never bound (or the bind failed) and can be freed.
+    for (iree_host_size_t i = 0; i < block_count; ++i) {
+      if (new_blocks[i] != VK_NULL_HANDLE) {
+        logical_device->syms()->vkFreeMemory(*logical_device, new_blocks[i],
+                                             logical_device->allocator());
+      }
+    }
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
-iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
+iree_status_t iree_hal_vulkan_sparse_buffer_create_growable_sync(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
@@ -130,51 +184,55 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
     iree::hal::vulkan::VkDeviceHandle* logical_device, VkQueue queue,
     VkBuffer handle, VkMemoryRequirements requirements,
     uint32_t memory_type_index, VkDeviceSize max_allocation_size,
-    iree_hal_buffer_t** out_buffer) {
+    iree_device_size_t committed_size, iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(allocator);
   IREE_ASSERT_ARGUMENT(logical_device);
   IREE_ASSERT_ARGUMENT(handle);
   IREE_ASSERT_ARGUMENT(out_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
-
-  // The maximum allocation size reported by Vulkan does not need to be a power
-  // of two or aligned to anything in particular - sparse buffers do require
-  // alignment though and must also be under the limit so here we adjust down to
-  // the maximum aligned value.
-  iree_device_size_t physical_block_size =
-      iree_device_size_floor_div(max_allocation_size, requirements.alignment) *
-      requirements.alignment;
-
-  // ceil-div for the number of blocks as the last block may be partial.
-  iree_host_size_t physical_block_count =
-      (iree_host_size_t)iree_device_size_ceil_div(requirements.size,
-                                                  physical_block_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)committed_size);
 
   iree_allocator_t host_allocator =
       iree_hal_allocator_host_allocator(allocator);
   iree_hal_vulkan_sparse_buffer_t* buffer = NULL;
-  iree_host_size_t total_size =
-      iree_host_align(sizeof(*buffer), iree_max_align_t) +
-      sizeof(buffer->physical_blocks[0]) * physical_block_count;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&buffer));
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer));
   iree_hal_buffer_initialize(
       host_allocator, allocator, &buffer->base.base, allocation_size,
       byte_offset, byte_length, memory_type, allowed_access, allowed_usage,
       &iree_hal_vulkan_sparse_buffer_vtable, &buffer->base.base);
   buffer->base.handle = handle;
   buffer->logical_device = logical_device;
-  buffer->physical_block_count = physical_block_count;
+  buffer->queue = queue;
+  buffer->memory_type_index = memory_type_index;
+  buffer->reserved_size = requirements.size;
+  buffer->alignment = requirements.alignment;
+
+  // The maximum allocation size reported by Vulkan does not need to be a power
+  // of two or aligned to anything in particular - sparse buffers do require
+  // alignment though and must also be under the limit so here we adjust down to
+  // the maximum aligned value.
+  buffer->physical_block_size =
+      iree_device_size_floor_div(max_allocation_size, requirements.alignment) *
+      requirements.alignment;
 
-  // Synchronously commit all physical blocks and bind them to the buffer.
-  iree_status_t status = iree_hal_vulkan_sparse_buffer_commit_sync(
-      logical_device, queue, handle, requirements, memory_type_index,
-      physical_block_size, physical_block_count, buffer->physical_blocks);
+  buffer->committed_size = 0;
+  buffer->physical_block_count = 0;
+  buffer->physical_block_capacity = 0;
+  buffer->physical_blocks = NULL;
+
+  // Synchronously commit the initial physical blocks and bind them.
+  iree_status_t status =
+      iree_hal_vulkan_sparse_buffer_commit_sync(&buffer->base.base,
+                                                committed_size);
 
   if (iree_status_is_ok(status)) {
     *out_buffer = &buffer->base.base;
   } else {
+    // The caller retains ownership of |handle| on failure.
+    buffer->base.handle = VK_NULL_HANDLE;
     iree_hal_buffer_destroy((iree_hal_buffer_t*)buffer);
   }
 
@@ -182,6 +240,88 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
   return status;
 }
 
+iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkQueue queue,
+    VkBuffer handle, VkMemoryRequirements requirements,
+    uint32_t memory_type_index, VkDeviceSize max_allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  return iree_hal_vulkan_sparse_buffer_create_growable_sync(
+      allocator, memory_type, allowed_access, allowed_usage, allocation_size,
+      byte_offset, byte_length, logical_device, queue, handle, requirements,
+      memory_type_index, max_allocation_size,
+      /*committed_size=*/requirements.size, out_buffer);
+}
+
+bool iree_hal_vulkan_sparse_buffer_isa(const iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_hal_vulkan_sparse_buffer_vtable);
+}
+
+iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t minimum_committed_size) {
+  iree_hal_vulkan_sparse_buffer_t* buffer =
+      iree_hal_vulkan_sparse_buffer_cast(base_buffer);
+  if (minimum_committed_size <= buffer->committed_size) {
+    return iree_ok_status();
+  } else if (minimum_committed_size > buffer->reserved_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "commit of %" PRIu64
+                            " bytes exceeds the %" PRIu64
+                            " byte sparse buffer reservation",
+                            (uint64_t)minimum_committed_size,
+                            (uint64_t)buffer->reserved_size);
+  }
+
+  // Binds must be aligned to the sparse page size except for the one that
+  // reaches the end of the resource.
+  VkDeviceSize new_committed_size = iree_min(
+      iree_device_align(minimum_committed_size, buffer->alignment),
+      buffer->reserved_size);
+  return iree_hal_vulkan_sparse_buffer_bind_sync(buffer, new_committed_size);
+}
+
+iree_device_size_t iree_hal_vulkan_sparse_buffer_committed_size(
+    const iree_hal_buffer_t* base_buffer) {
+  const iree_hal_vulkan_sparse_buffer_t* buffer =
+      (const iree_hal_vulkan_sparse_buffer_t*)base_buffer;
+  IREE_HAL_ASSERT_TYPE(base_buffer, &iree_hal_vulkan_sparse_buffer_vtable);
+  return buffer->committed_size;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_buffer_commit(
+    iree_hal_buffer_t* buffer, iree_device_size_t minimum_committed_size) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (!iree_hal_vulkan_sparse_buffer_isa(allocated_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "buffer is not a Vulkan growable buffer");
+  }
+  // Subspans commit relative to their own offset within the reservation.
+  return iree_hal_vulkan_sparse_buffer_commit_sync(
+      allocated_buffer,
+      iree_hal_buffer_byte_offset(buffer) + minimum_committed_size);
+}
+
+IREE_API_EXPORT iree_device_size_t
+iree_hal_vulkan_buffer_committed_size(const iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (!iree_hal_vulkan_sparse_buffer_isa(allocated_buffer)) {
+    return iree_hal_buffer_byte_length(buffer);
+  }
+  iree_device_size_t committed_size =
+      iree_hal_vulkan_sparse_buffer_committed_size(allocated_buffer);
+  iree_device_size_t byte_offset = iree_hal_buffer_byte_offset(buffer);
+  if (committed_size <= byte_offset) return 0;
+  return iree_min(committed_size - byte_offset,
+                  iree_hal_buffer_byte_length(buffer));
+}
+
 static void iree_hal_vulkan_sparse_buffer_destroy(
     iree_hal_buffer_t* base_buffer) {
   iree_hal_vulkan_sparse_buffer_t* buffer =
@@ -204,6 +344,7 @@ static void iree_hal_vulkan_sparse_buffer_destroy(
                                            logical_device->allocator());
     }
   }
+  iree_allocator_free(host_allocator, buffer->physical_blocks);
 
   iree_allocator_free(host_allocator, buffer);
 
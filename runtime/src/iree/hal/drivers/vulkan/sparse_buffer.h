@@ -35,6 +35,34 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
     uint32_t memory_type_index, VkDeviceSize max_allocation_size,
     iree_hal_buffer_t** out_buffer);
 
+// EXPERIMENTAL: allocate a growable buffer reserving the full
+// |requirements.size| of the sparse |handle| but only binding physical memory
+// to the first |committed_size| bytes. The buffer is grown in place with
+// iree_hal_vulkan_sparse_buffer_commit_sync. Requires that |handle| was
+// created with sparse residency so that it may be partially bound.
+iree_status_t iree_hal_vulkan_sparse_buffer_create_growable_sync(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkQueue queue,
+    VkBuffer handle, VkMemoryRequirements requirements,
+    uint32_t memory_type_index, VkDeviceSize max_allocation_size,
+    iree_device_size_t committed_size, iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a Vulkan sparse buffer.
+bool iree_hal_vulkan_sparse_buffer_isa(const iree_hal_buffer_t* buffer);
+
+// Binds physical memory so that at least the first |minimum_committed_size|
+// bytes of the sparse |buffer| are resident. Allocation and binding happen
+// synchronously on the calling thread. Previously bound ranges are untouched.
+iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
+    iree_hal_buffer_t* buffer, iree_device_size_t minimum_committed_size);
+
+// Returns the number of bytes from the start of |buffer| that are resident.
+iree_device_size_t iree_hal_vulkan_sparse_buffer_committed_size(
+    const iree_hal_buffer_t* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
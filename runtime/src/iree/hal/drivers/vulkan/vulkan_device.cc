@@ -32,6 +32,8 @@
 #include "iree/hal/drivers/vulkan/util/arena.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
 #include "iree/hal/utils/buffer_transfer.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -219,6 +221,21 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
 
+  // VK_EXT_descriptor_buffer:
+  // Allows writing descriptors directly into buffer memory and avoids
+  // descriptor set pool allocation and updates on the dispatch path. It
+  // depends on VK_KHR_synchronization2 and VK_EXT_descriptor_indexing which
+  // are core in Vulkan 1.3 and 1.2 respectively.
+  if (iree_all_bits_set(requested_features,
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+    ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+            VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+            VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+  }
+
   //===--------------------------------------------------------------------===//
   // Vulkan forward-compatibility shims
   //===--------------------------------------------------------------------===//
@@ -497,6 +514,11 @@ typedef struct iree_hal_vulkan_device_t {
 
   // Flags overriding default device behavior.
   iree_hal_vulkan_device_flags_t flags;
+  // Optional directory used to persist pipeline caches.
+  iree_string_view_t pipeline_cache_path;
+  // Submission batching parameters used by all queues.
+  iree_host_size_t submission_batch_max_count;
+  iree_duration_t submission_batch_window_ns;
   // Which optional extensions are active and available on the device.
   iree_hal_vulkan_device_extensions_t device_extensions;
 
@@ -534,6 +556,10 @@ typedef struct iree_hal_vulkan_device_t {
   // buffers can contain inlined data uploads).
   iree_arena_block_pool_t block_pool;
 
+  // Host-visible staging buffers reused by synchronous transfers to and from
+  // host memory.
+  iree_hal_transfer_staging_pool_t staging_pool;
+
   BuiltinExecutables* builtin_executables;
 
 #if defined(IREE_HAL_VULKAN_HAVE_RENDERDOC)
@@ -555,6 +581,8 @@ IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
     iree_hal_vulkan_device_options_t* out_options) {
   memset(out_options, 0, sizeof(*out_options));
   out_options->flags = 0;
+  out_options->submission_batch_max_count = 1;
+  out_options->submission_batch_window_ns = 1000000ull;  // 1ms
 }
 
 // Creates a transient command pool for the given queue family.
@@ -585,14 +613,17 @@ static iree_status_t iree_hal_vulkan_create_transient_command_pool(
 
 // Creates a command queue of the given queue family.
 static CommandQueue* iree_hal_vulkan_device_create_queue(
-    VkDeviceHandle* logical_device,
+    iree_hal_vulkan_device_t* device,
     iree_hal_command_category_t command_category, uint32_t queue_family_index,
     uint32_t queue_index) {
+  VkDeviceHandle* logical_device = device->logical_device;
   VkQueue queue = VK_NULL_HANDLE;
   logical_device->syms()->vkGetDeviceQueue(*logical_device, queue_family_index,
                                            queue_index, &queue);
 
-  return new DirectCommandQueue(logical_device, command_category, queue);
+  return new DirectCommandQueue(logical_device, command_category, queue,
+                                device->submission_batch_max_count,
+                                device->submission_batch_window_ns);
 }
 
 // Creates command queues for the given sets of queues and populates the
@@ -626,7 +657,7 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
         iree_make_string_view(queue_name_buffer, queue_name_length);
 
     CommandQueue* queue = iree_hal_vulkan_device_create_queue(
-        device->logical_device, IREE_HAL_COMMAND_CATEGORY_ANY,
+        device, IREE_HAL_COMMAND_CATEGORY_ANY,
         compute_queue_set->queue_family_index, i);
 
     iree_host_size_t queue_index = device->queue_count++;
@@ -664,7 +695,7 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
         iree_make_string_view(queue_name_buffer, queue_name_length);
 
     CommandQueue* queue = iree_hal_vulkan_device_create_queue(
-        device->logical_device, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+        device, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
         transfer_queue_set->queue_family_index, i);
 
     iree_host_size_t queue_index = device->queue_count++;
@@ -703,7 +734,7 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
 
   iree_hal_vulkan_device_t* device = NULL;
   iree_host_size_t total_size =
-      sizeof(*device) + identifier.size +
+      sizeof(*device) + identifier.size + options->pipeline_cache_path.size +
       total_queue_count * sizeof(device->queues[0]) +
       total_queue_count * sizeof(device->dispatch_queues[0]) +
       total_queue_count * sizeof(device->transfer_queues[0]) +
@@ -720,6 +751,11 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   buffer_ptr += iree_string_view_append_to_buffer(
       identifier, &device->identifier, (char*)buffer_ptr);
   device->flags = options->flags;
+  device->submission_batch_max_count = options->submission_batch_max_count;
+  device->submission_batch_window_ns = options->submission_batch_window_ns;
+  buffer_ptr += iree_string_view_append_to_buffer(
+      options->pipeline_cache_path, &device->pipeline_cache_path,
+      (char*)buffer_ptr);
 
   device->device_extensions = *device_extensions;
   device->instance = instance;
@@ -733,6 +769,7 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
 
   iree_arena_block_pool_initialize(32 * 1024, host_allocator,
                                    &device->block_pool);
+  iree_hal_transfer_staging_pool_initialize(&device->staging_pool);
 
   // Point the queue storage into the new device allocation. The queues
   // themselves are populated
@@ -750,10 +787,22 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
       new DescriptorPoolCache(device->logical_device);
 
   // Create the device memory allocator that will service all buffer
-  // allocation requests.
+  // allocation requests. Buffers are shared with the dedicated transfer queue
+  // family, if any, so that transfers can run there without ownership
+  // transfers between the queue families.
+  uint32_t queue_family_indices[2] = {
+      compute_queue_set->queue_family_index,
+      transfer_queue_set->queue_family_index,
+  };
+  iree_host_size_t queue_family_count =
+      transfer_queue_set->queue_indices != 0 &&
+              transfer_queue_set->queue_family_index !=
+                  compute_queue_set->queue_family_index
+          ? 2
+          : 1;
   iree_status_t status = iree_hal_vulkan_native_allocator_create(
-      options, instance, physical_device, logical_device,
-      &device->device_allocator);
+      options, instance, physical_device, logical_device, queue_family_count,
+      queue_family_indices, &device->device_allocator);
 
   // Create command pools for each queue family. If we don't have a transfer
   // queue then we'll ignore that one and just use the dispatch pool.
@@ -816,6 +865,7 @@ static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
   delete device->descriptor_pool_cache;
 
   // There should be no more buffers live that use the allocator.
+  iree_hal_transfer_staging_pool_deinitialize(&device->staging_pool);
   iree_hal_allocator_release(device->device_allocator);
 
   // Buffers may have been retaining collective resources.
@@ -976,6 +1026,18 @@ iree_status_t iree_hal_vulkan_device_create(
   available_coop_matrix_features.pNext = available_features2.pNext;
   available_features2.pNext = &available_coop_matrix_features;
 
+  // + Descriptor buffer features.
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT
+      available_descriptor_buffer_features;
+  memset(&available_descriptor_buffer_features, 0,
+         sizeof(available_descriptor_buffer_features));
+  available_descriptor_buffer_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+  if (enabled_device_extensions.descriptor_buffer) {
+    available_descriptor_buffer_features.pNext = available_features2.pNext;
+    available_features2.pNext = &available_descriptor_buffer_features;
+  }
+
   instance_syms->vkGetPhysicalDeviceFeatures2(physical_device,
                                               &available_features2);
   const VkPhysicalDeviceFeatures* available_features =
@@ -1055,6 +1117,24 @@ iree_status_t iree_hal_vulkan_device_create(
     enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
 
+  // Descriptor buffers reference bound buffers by device address.
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features;
+  if (iree_all_bits_set(
+          requested_features,
+          IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS) &&
+      iree_all_bits_set(
+          enabled_features,
+          IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES) &&
+      available_descriptor_buffer_features.descriptorBuffer) {
+    memset(&descriptor_buffer_features, 0, sizeof(descriptor_buffer_features));
+    descriptor_buffer_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    descriptor_buffer_features.pNext = enabled_features2.pNext;
+    enabled_features2.pNext = &descriptor_buffer_features;
+    descriptor_buffer_features.descriptorBuffer = VK_TRUE;
+    enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  }
+
   VkPhysicalDeviceTimelineSemaphoreFeatures semaphore_features;
   memset(&semaphore_features, 0, sizeof(semaphore_features));
   semaphore_features.sType =
@@ -1213,6 +1293,8 @@ static iree_hal_allocator_t* iree_hal_vulkan_device_allocator(
 static void iree_hal_vulkan_replace_device_allocator(
     iree_hal_device_t* base_device, iree_hal_allocator_t* new_allocator) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  // Staging buffers must come from the current allocator.
+  iree_hal_transfer_staging_pool_trim(&device->staging_pool);
   iree_hal_allocator_retain(new_allocator);
   iree_hal_allocator_release(device->device_allocator);
   device->device_allocator = new_allocator;
@@ -1230,9 +1312,68 @@ static iree_status_t iree_hal_vulkan_device_trim(
     iree_hal_device_t* base_device) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
+  iree_hal_transfer_staging_pool_trim(&device->staging_pool);
   return iree_hal_allocator_trim(device->device_allocator);
 }
 
+// Queue affinity bits first map to the dispatch queues and then to any
+// dedicated transfer queues. With 2 dispatch queues and 1 transfer queue bits 0
+// and 1 select the dispatch queues and bit 2 selects the transfer queue.
+// Cross-queue dependencies are expressed with timeline semaphores.
+
+// Returns the affinity mask selecting the dedicated transfer queues, if any.
+static iree_hal_queue_affinity_t iree_hal_vulkan_device_transfer_queue_mask(
+    iree_hal_vulkan_device_t* device) {
+  // Without dedicated transfer queues the transfer queue list aliases the
+  // dispatch queues and there is no transfer command pool.
+  if (!device->transfer_command_pool) return 0;
+  return ((1ull << device->transfer_queue_count) - 1)
+         << device->dispatch_queue_count;
+}
+
+// Returns true if |queue_affinity| only selects dedicated transfer queues.
+static bool iree_hal_vulkan_device_is_transfer_affinity(
+    iree_hal_vulkan_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity) {
+  iree_hal_queue_affinity_t dispatch_mask =
+      (1ull << device->dispatch_queue_count) - 1;
+  return !(queue_affinity & dispatch_mask) &&
+         (queue_affinity & iree_hal_vulkan_device_transfer_queue_mask(device));
+}
+
+// Returns the dedicated transfer queue selected by |queue_affinity| or the
+// first one if the affinity does not select any.
+static CommandQueue* iree_hal_vulkan_device_select_transfer_queue(
+    iree_hal_vulkan_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity) {
+  iree_hal_queue_affinity_t transfer_bits =
+      (queue_affinity & iree_hal_vulkan_device_transfer_queue_mask(device)) >>
+      device->dispatch_queue_count;
+  int queue_index =
+      transfer_bits ? iree_math_count_trailing_zeros_u64(transfer_bits) : 0;
+  return device->transfer_queues[queue_index];
+}
+
+// Returns the queue to submit work to based on the |queue_affinity|.
+// Work only goes to dedicated transfer queues if it contains no dispatches and
+// the affinity exclusively selects transfer queues.
+static CommandQueue* iree_hal_vulkan_device_select_queue(
+    iree_hal_vulkan_device_t* device,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity) {
+  if (!iree_any_bit_set(command_categories,
+                        IREE_HAL_COMMAND_CATEGORY_DISPATCH) &&
+      iree_hal_vulkan_device_is_transfer_affinity(device, queue_affinity)) {
+    return iree_hal_vulkan_device_select_transfer_queue(device,
+                                                        queue_affinity);
+  }
+  iree_hal_queue_affinity_t dispatch_bits =
+      queue_affinity & ((1ull << device->dispatch_queue_count) - 1);
+  int queue_index =
+      dispatch_bits ? iree_math_count_trailing_zeros_u64(dispatch_bits) : 0;
+  return device->dispatch_queues[queue_index];
+}
+
 static iree_status_t iree_hal_vulkan_device_query_i64(
     iree_hal_device_t* base_device, iree_string_view_t category,
     iree_string_view_t key, int64_t* out_value) {
@@ -1256,6 +1397,15 @@ static iree_status_t iree_hal_vulkan_device_query_i64(
                        : 0;
     }
     return iree_ok_status();
+  } else if (iree_string_view_equal(category, IREE_SV("hal.device"))) {
+    if (iree_string_view_equal(key, IREE_SV("concurrency"))) {
+      *out_value = (int64_t)device->dispatch_queue_count;
+      return iree_ok_status();
+    } else if (iree_string_view_equal(key, IREE_SV("transfer_affinity"))) {
+      // Affinity mask selecting the dedicated transfer queues or 0 if none.
+      *out_value = (int64_t)iree_hal_vulkan_device_transfer_queue_mask(device);
+      return iree_ok_status();
+    }
   }
 
   return iree_make_status(
@@ -1264,29 +1414,6 @@ static iree_status_t iree_hal_vulkan_device_query_i64(
       (int)category.size, category.data, (int)key.size, key.data);
 }
 
-// Returns the queue to submit work to based on the |queue_affinity|.
-static CommandQueue* iree_hal_vulkan_device_select_queue(
-    iree_hal_vulkan_device_t* device,
-    iree_hal_command_category_t command_categories,
-    iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // TODO(benvanik): meaningful heuristics for affinity. We don't generate
-  // anything from the compiler that uses multiple queues and until we do it's
-  // best not to do anything too clever here.
-  if (command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER) {
-    return device
-        ->transfer_queues[queue_affinity % device->transfer_queue_count];
-  }
-  return device->dispatch_queues[queue_affinity % device->dispatch_queue_count];
-}
-
 static iree_status_t iree_hal_vulkan_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
@@ -1301,24 +1428,25 @@ static iree_status_t iree_hal_vulkan_device_create_command_buffer(
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
 
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // Select the command pool to used based on the types of commands used.
-  // Note that we may not have a dedicated transfer command pool if there are
-  // no dedicated transfer queues.
-  VkCommandPoolHandle* command_pool = NULL;
-  if (device->transfer_command_pool &&
-      !iree_all_bits_set(command_categories,
-                         IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
+  // Command buffers with indirect bindings are recorded once and replayed into
+  // each command buffer executing them with its binding table.
+  if (binding_capacity > 0) {
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, device->host_allocator, out_command_buffer);
+  }
+
+  // Transfer-only command buffers are recorded for dedicated transfer queues
+  // when the affinity requests them. All others are recorded for dispatch
+  // queues as the unaligned buffer fill polyfill may insert dispatches into
+  // command buffers that at compile time are expected to only contain transfer
+  // commands. Command buffers recorded for transfer queues reject such fills.
+  VkCommandPoolHandle* command_pool = device->dispatch_command_pool;
+  if (command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER &&
+      iree_hal_vulkan_device_is_transfer_affinity(device, queue_affinity)) {
     command_pool = device->transfer_command_pool;
   } else {
-    command_pool = device->dispatch_command_pool;
+    command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
   }
 
   // The tracing context is tied to a particular queue so we must select here
@@ -1359,22 +1487,29 @@ static iree_status_t iree_hal_vulkan_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   return iree_hal_vulkan_nop_executable_cache_create(
-      device->logical_device, identifier, out_executable_cache);
+      device->logical_device, device->physical_device, identifier,
+      device->pipeline_cache_path, out_executable_cache);
 }
 
 static iree_status_t iree_hal_vulkan_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_vulkan_device_create_pipeline_layout(
@@ -1388,12 +1523,27 @@ static iree_status_t iree_hal_vulkan_device_create_pipeline_layout(
       out_pipeline_layout);
 }
 
+// Issues all submissions held by batching queues.
+static iree_status_t iree_hal_vulkan_device_flush_queues(void* user_data) {
+  iree_hal_vulkan_device_t* device = (iree_hal_vulkan_device_t*)user_data;
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    IREE_RETURN_IF_ERROR(device->queues[i]->Flush());
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_vulkan_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  return iree_hal_vulkan_native_semaphore_create(device->logical_device,
-                                                 initial_value, out_semaphore);
+  // Semaphores only need to flush queues when they may hold submissions.
+  iree_hal_vulkan_submission_flush_t submission_flush = {NULL, NULL};
+  if (device->submission_batch_max_count > 1) {
+    submission_flush.fn = iree_hal_vulkan_device_flush_queues;
+    submission_flush.user_data = device;
+  }
+  return iree_hal_vulkan_native_semaphore_create(
+      device->logical_device, submission_flush, initial_value, out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
@@ -1405,9 +1555,24 @@ iree_hal_vulkan_device_query_semaphore_compatibility(
     // multiple devices are used.
     return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
   }
+  // Other semaphores are imported as native semaphores signaled from the host
+  // when reached so the device can wait on them without blocking submission.
+  // Signals are forwarded from the host once submissions complete.
   // TODO(benvanik): semaphore APIs for querying allowed export formats. We
   // can check device caps to see what external semaphore types are supported.
-  return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
+  return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY |
+         IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_WAIT;
+}
+
+static iree_status_t iree_hal_vulkan_device_transfer_range(
+    iree_hal_device_t* base_device, iree_hal_transfer_buffer_t source,
+    iree_device_size_t source_offset, iree_hal_transfer_buffer_t target,
+    iree_device_size_t target_offset, iree_device_size_t data_length,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  return iree_hal_device_submit_transfer_range_and_wait_with_staging_pool(
+      base_device, &device->staging_pool, source, source_offset, target,
+      target_offset, data_length, flags, timeout);
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_alloca(
@@ -1438,6 +1603,20 @@ static iree_status_t iree_hal_vulkan_device_queue_dealloca(
   return iree_ok_status();
 }
 
+// Returns the affinity file transfers are issued with. File transfers only
+// record copies and when the caller has no preference they run on dedicated
+// transfer queues, if any, so that they overlap with work on dispatch queues.
+static iree_hal_queue_affinity_t iree_hal_vulkan_device_file_transfer_affinity(
+    iree_hal_vulkan_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity) {
+  iree_hal_queue_affinity_t transfer_mask =
+      iree_hal_vulkan_device_transfer_queue_mask(device);
+  if (queue_affinity == IREE_HAL_QUEUE_AFFINITY_ANY && transfer_mask) {
+    return transfer_mask;
+  }
+  return queue_affinity;
+}
+
 static iree_status_t iree_hal_vulkan_device_queue_read(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -1445,6 +1624,9 @@ static iree_status_t iree_hal_vulkan_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  queue_affinity =
+      iree_hal_vulkan_device_file_transfer_affinity(device, queue_affinity);
   // TODO: expose streaming chunk count/size options.
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
@@ -1466,6 +1648,9 @@ static iree_status_t iree_hal_vulkan_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  queue_affinity =
+      iree_hal_vulkan_device_file_transfer_affinity(device, queue_affinity);
   // TODO: expose streaming chunk count/size options.
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
@@ -1480,6 +1665,28 @@ static iree_status_t iree_hal_vulkan_device_queue_write(
   return loop_status;
 }
 
+// Releases the native semaphores in |native_list| that were created in place
+// of the non-Vulkan semaphores at the same indices in |list|.
+static void iree_hal_vulkan_device_release_bridged_semaphores(
+    const iree_hal_semaphore_list_t list,
+    const iree_hal_semaphore_list_t native_list) {
+  if (native_list.semaphores == list.semaphores) return;
+  for (iree_host_size_t i = 0; i < list.count; ++i) {
+    if (native_list.semaphores[i] != list.semaphores[i]) {
+      iree_hal_semaphore_release(native_list.semaphores[i]);
+    }
+  }
+}
+
+// Returns true if all semaphores in |list| are Vulkan native semaphores.
+static bool iree_hal_vulkan_device_is_native_semaphore_list(
+    const iree_hal_semaphore_list_t list) {
+  for (iree_host_size_t i = 0; i < list.count; ++i) {
+    if (!iree_hal_vulkan_native_semaphore_isa(list.semaphores[i])) return false;
+  }
+  return true;
+}
+
 static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -1487,31 +1694,153 @@ static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  // NOTE: today we are not discriminating queues based on command type.
-  CommandQueue* queue = iree_hal_vulkan_device_select_queue(
-      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
-  iree_hal_submission_batch_t batch = {
-      /*.wait_semaphores=*/wait_semaphore_list,
-      /*.command_buffer_count=*/command_buffer_count,
-      /*.command_buffers=*/command_buffers,
-      /*.signal_semaphores=*/signal_semaphore_list,
-  };
-  IREE_RETURN_IF_ERROR(queue->Submit(1, &batch));
-  // HACK: we don't track async resource lifetimes so we have to block.
-  return iree_hal_semaphore_list_wait(signal_semaphore_list,
-                                      iree_infinite_timeout());
+
+  // Command buffers recorded from the transfer command pool can only be
+  // submitted to queues of the transfer queue family.
+  iree_host_size_t transfer_only_count = 0;
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    if (iree_hal_vulkan_direct_command_buffer_isa(command_buffers[i]) &&
+        !iree_all_bits_set(
+            iree_hal_command_buffer_allowed_categories(command_buffers[i]),
+            IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
+      ++transfer_only_count;
+    }
+  }
+  CommandQueue* queue = NULL;
+  if (transfer_only_count == 0) {
+    // Barrier-only submissions may go to transfer queues if requested.
+    queue = iree_hal_vulkan_device_select_queue(
+        device,
+        command_buffer_count ? IREE_HAL_COMMAND_CATEGORY_DISPATCH
+                             : IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+        queue_affinity);
+  } else if (transfer_only_count == command_buffer_count) {
+    queue =
+        iree_hal_vulkan_device_select_transfer_queue(device, queue_affinity);
+  } else {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "command buffers recorded for transfer queues cannot be submitted "
+        "together with command buffers recorded for dispatch queues");
+  }
+
+  // Semaphores from other devices (such as local_task CPU queues) are bridged
+  // through native semaphores signaled from the host. Waits are imported as
+  // timepoints so the submission is issued immediately and the device waits
+  // until the other device signals. Signals are made to native semaphores and
+  // forwarded once the submission completes.
+  iree_hal_semaphore_list_t native_wait_list = wait_semaphore_list;
+  iree_hal_semaphore_list_t native_signal_list = signal_semaphore_list;
+  iree_status_t status = iree_ok_status();
+  if (!iree_hal_vulkan_device_is_native_semaphore_list(wait_semaphore_list)) {
+    native_wait_list.semaphores = (iree_hal_semaphore_t**)iree_alloca(
+        wait_semaphore_list.count * sizeof(native_wait_list.semaphores[0]));
+    native_wait_list.payload_values = (uint64_t*)iree_alloca(
+        wait_semaphore_list.count * sizeof(native_wait_list.payload_values[0]));
+    for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+      iree_hal_semaphore_t* semaphore = wait_semaphore_list.semaphores[i];
+      native_wait_list.semaphores[i] = semaphore;
+      native_wait_list.payload_values[i] =
+          wait_semaphore_list.payload_values[i];
+      if (!iree_status_is_ok(status) ||
+          iree_hal_vulkan_native_semaphore_isa(semaphore)) {
+        continue;
+      }
+      status = iree_hal_vulkan_native_semaphore_import_timepoint(
+          device->logical_device, semaphore,
+          wait_semaphore_list.payload_values[i],
+          &native_wait_list.semaphores[i]);
+      if (iree_status_is_ok(status)) {
+        native_wait_list.payload_values[i] = 1ull;
+      } else {
+        native_wait_list.semaphores[i] = semaphore;
+      }
+    }
+  }
+  bool has_bridged_signals = false;
+  if (iree_status_is_ok(status) &&
+      !iree_hal_vulkan_device_is_native_semaphore_list(signal_semaphore_list)) {
+    has_bridged_signals = true;
+    native_signal_list.semaphores = (iree_hal_semaphore_t**)iree_alloca(
+        signal_semaphore_list.count * sizeof(native_signal_list.semaphores[0]));
+    native_signal_list.payload_values =
+        (uint64_t*)iree_alloca(signal_semaphore_list.count *
+                               sizeof(native_signal_list.payload_values[0]));
+    for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+      iree_hal_semaphore_t* semaphore = signal_semaphore_list.semaphores[i];
+      native_signal_list.semaphores[i] = semaphore;
+      native_signal_list.payload_values[i] =
+          signal_semaphore_list.payload_values[i];
+      if (!iree_status_is_ok(status) ||
+          iree_hal_vulkan_native_semaphore_isa(semaphore)) {
+        continue;
+      }
+      iree_hal_vulkan_submission_flush_t submission_flush = {NULL, NULL};
+      status = iree_hal_vulkan_native_semaphore_create(
+          device->logical_device, submission_flush, 0ull,
+          &native_signal_list.semaphores[i]);
+      if (iree_status_is_ok(status)) {
+        native_signal_list.payload_values[i] = 1ull;
+      } else {
+        native_signal_list.semaphores[i] = semaphore;
+      }
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_submission_batch_t batch = {
+        /*.wait_semaphores=*/native_wait_list,
+        /*.command_buffer_count=*/command_buffer_count,
+        /*.command_buffers=*/command_buffers,
+        /*.signal_semaphores=*/native_signal_list,
+    };
+    status = queue->Submit(1, &batch);
+  }
+  if (iree_status_is_ok(status) &&
+      (has_bridged_signals || !queue->is_batching())) {
+    // Batching queues retain the resources used by submissions until they
+    // complete but signals to other devices have to be forwarded from the
+    // host once the submission has been issued and completed.
+    if (queue->is_batching()) status = queue->Flush();
+    // HACK: we don't track async resource lifetimes so we have to block.
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_list_wait(native_signal_list,
+                                            iree_infinite_timeout());
+    }
+  }
+
+  if (has_bridged_signals) {
+    for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+      iree_hal_semaphore_t* semaphore = signal_semaphore_list.semaphores[i];
+      if (native_signal_list.semaphores[i] == semaphore) continue;
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_semaphore_signal(
+            semaphore, signal_semaphore_list.payload_values[i]);
+      } else {
+        iree_hal_semaphore_fail(semaphore, iree_status_clone(status));
+      }
+    }
+  }
+  iree_hal_vulkan_device_release_bridged_semaphores(wait_semaphore_list,
+                                                    native_wait_list);
+  iree_hal_vulkan_device_release_bridged_semaphores(signal_semaphore_list,
+                                                    native_signal_list);
+  return status;
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_flush(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity) {
-  // Currently unused; we flush as submissions are made.
-  return iree_ok_status();
+  // Queues only hold submissions when batching; otherwise we flush as
+  // submissions are made. Affinities may map to any queue so flush them all.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  return iree_hal_vulkan_device_flush_queues(device);
 }
 
 static iree_status_t iree_hal_vulkan_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  IREE_RETURN_IF_ERROR(iree_hal_vulkan_device_flush_queues(device));
   VkSemaphoreWaitFlags wait_flags = 0;
   if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
     wait_flags |= VK_SEMAPHORE_WAIT_ANY_BIT;
@@ -1627,7 +1956,7 @@ const iree_hal_device_vtable_t iree_hal_vulkan_device_vtable = {
     /*.create_semaphore=*/iree_hal_vulkan_device_create_semaphore,
     /*.query_semaphore_compatibility=*/
     iree_hal_vulkan_device_query_semaphore_compatibility,
-    /*.transfer_range=*/iree_hal_device_submit_transfer_range_and_wait,
+    /*.transfer_range=*/iree_hal_vulkan_device_transfer_range,
     /*.queue_alloca=*/iree_hal_vulkan_device_queue_alloca,
     /*.queue_dealloca=*/iree_hal_vulkan_device_queue_dealloca,
     /*.queue_read=*/iree_hal_vulkan_device_queue_read,
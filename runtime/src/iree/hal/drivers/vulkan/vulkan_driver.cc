@@ -110,7 +110,10 @@ static iree_status_t iree_hal_vulkan_driver_create_internal(
   }
 
   iree_hal_vulkan_driver_t* driver = NULL;
-  iree_host_size_t total_size = sizeof(*driver) + identifier.size;
+  iree_string_view_t pipeline_cache_path =
+      options->device_options.pipeline_cache_path;
+  iree_host_size_t total_size =
+      sizeof(*driver) + identifier.size + pipeline_cache_path.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&driver);
   if (!iree_status_is_ok(status)) {
@@ -121,11 +124,14 @@ static iree_status_t iree_hal_vulkan_driver_create_internal(
   iree_hal_resource_initialize(&iree_hal_vulkan_driver_vtable,
                                &driver->resource);
   driver->host_allocator = host_allocator;
-  iree_string_view_append_to_buffer(
-      identifier, &driver->identifier,
-      (char*)driver + total_size - identifier.size);
+  uint8_t* buffer_ptr = (uint8_t*)driver + sizeof(*driver);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      identifier, &driver->identifier, (char*)buffer_ptr);
   memcpy(&driver->device_options, &options->device_options,
          sizeof(driver->device_options));
+  buffer_ptr += iree_string_view_append_to_buffer(
+      pipeline_cache_path, &driver->device_options.pipeline_cache_path,
+      (char*)buffer_ptr);
   driver->enabled_features = options->requested_features;
   driver->syms = iree::add_ref(instance_syms);
   driver->instance = instance;
@@ -0,0 +1,511 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_counters.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT 1
+#else
+#define IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT 0
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+static const char* iree_hal_local_dispatch_counter_names
+    [IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT] = {
+        "cycles", "instructions", "cache_references",
+        "cache_misses", "branch_misses",
+};
+
+// Accumulated counters of a single export.
+typedef struct iree_hal_local_dispatch_counters_entry_t {
+  // Executable and ordinal used for lookups on the recording thread. The
+  // executable may be released before the profile ends and must not be
+  // dereferenced after the entry is created.
+  const void* executable;
+  iree_host_size_t ordinal;
+  // Owned copy of the export name used to merge entries across threads.
+  char* name;
+  uint64_t dispatch_count;
+  uint64_t workgroup_count;
+  uint64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+} iree_hal_local_dispatch_counters_entry_t;
+
+// Counter state of a single thread. Only accessed by the owning thread while
+// profiling is active and by the profiler once it has ended.
+typedef struct iree_hal_local_dispatch_counters_thread_t {
+  struct iree_hal_local_dispatch_counters_thread_t* next;
+  // Group leader fd that all counters are read through or -1 if the counters
+  // could not be opened on this thread.
+  int group_fd;
+  int fds[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+  iree_host_size_t entry_count;
+  iree_host_size_t entry_capacity;
+  iree_hal_local_dispatch_counters_entry_t* entries;
+} iree_hal_local_dispatch_counters_thread_t;
+
+struct iree_hal_local_dispatch_counters_t {
+  iree_allocator_t host_allocator;
+
+  // Unique nonzero ID of the active session or 0 if inactive. Threads compare
+  // this against the session of their cached state to detect when they need to
+  // open new counters.
+  iree_atomic_int64_t session_id;
+
+  // Path the report is written to or NULL to write to stderr.
+  char* file_path;
+
+  // Guards the thread list.
+  iree_slim_mutex_t mutex;
+  iree_hal_local_dispatch_counters_thread_t* thread_list;
+  // Total number of threads that failed to open counters.
+  iree_host_size_t failed_thread_count;
+};
+
+// Source of unique session IDs across all profilers in the process.
+static iree_atomic_int64_t iree_hal_local_dispatch_counters_next_session_id =
+    IREE_ATOMIC_VAR_INIT(1);
+
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+
+// Counter state of the calling thread for the session it was opened in.
+static _Thread_local int64_t iree_hal_local_dispatch_counters_tls_session_id;
+static _Thread_local iree_hal_local_dispatch_counters_thread_t*
+    iree_hal_local_dispatch_counters_tls_thread;
+
+static const uint64_t iree_hal_local_dispatch_counter_configs
+    [IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,       PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static int iree_hal_local_dispatch_counters_perf_event_open(uint64_t config,
+                                                            int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int)syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                      group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void iree_hal_local_dispatch_counters_close_thread_fds(
+    iree_hal_local_dispatch_counters_thread_t* thread) {
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    if (thread->fds[i] != -1) close(thread->fds[i]);
+    thread->fds[i] = -1;
+  }
+  thread->group_fd = -1;
+}
+
+// Opens the counter group of the calling thread. Returns the errno of the
+// first failure or 0 on success.
+static int iree_hal_local_dispatch_counters_open_thread_fds(
+    iree_hal_local_dispatch_counters_thread_t* thread) {
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    thread->fds[i] = -1;
+  }
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    int group_fd = i == 0 ? -1 : thread->fds[0];
+    thread->fds[i] = iree_hal_local_dispatch_counters_perf_event_open(
+        iree_hal_local_dispatch_counter_configs[i], group_fd);
+    if (thread->fds[i] == -1) {
+      int error_number = errno;
+      iree_hal_local_dispatch_counters_close_thread_fds(thread);
+      return error_number;
+    }
+  }
+  thread->group_fd = thread->fds[0];
+  ioctl(thread->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(thread->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return 0;
+}
+
+// Returns the counter state of the calling thread for the active session,
+// opening the counters if this is the first sample taken on the thread.
+static iree_hal_local_dispatch_counters_thread_t*
+iree_hal_local_dispatch_counters_acquire_thread(
+    iree_hal_local_dispatch_counters_t* counters) {
+  int64_t session_id =
+      iree_atomic_load_int64(&counters->session_id, iree_memory_order_acquire);
+  if (IREE_LIKELY(iree_hal_local_dispatch_counters_tls_session_id ==
+                  session_id)) {
+    return iree_hal_local_dispatch_counters_tls_thread;
+  }
+
+  iree_hal_local_dispatch_counters_thread_t* thread = NULL;
+  if (!iree_status_is_ok(iree_allocator_malloc(
+          counters->host_allocator, sizeof(*thread), (void**)&thread))) {
+    return NULL;
+  }
+  memset(thread, 0, sizeof(*thread));
+  int error_number = iree_hal_local_dispatch_counters_open_thread_fds(thread);
+
+  // Threads that fail to open counters still register so that they don't
+  // retry on every workgroup.
+  iree_slim_mutex_lock(&counters->mutex);
+  thread->next = counters->thread_list;
+  counters->thread_list = thread;
+  if (error_number != 0) ++counters->failed_thread_count;
+  iree_slim_mutex_unlock(&counters->mutex);
+
+  iree_hal_local_dispatch_counters_tls_session_id = session_id;
+  iree_hal_local_dispatch_counters_tls_thread = thread;
+  return thread;
+}
+
+static bool iree_hal_local_dispatch_counters_read(
+    iree_hal_local_dispatch_counters_thread_t* thread,
+    uint64_t out_values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT]) {
+  // PERF_FORMAT_GROUP: { u64 nr; u64 values[nr]; }
+  uint64_t buffer[1 + IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+  ssize_t read_size = read(thread->group_fd, buffer, sizeof(buffer));
+  if (read_size != (ssize_t)sizeof(buffer)) return false;
+  memcpy(out_values, &buffer[1], sizeof(buffer) - sizeof(buffer[0]));
+  return true;
+}
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+
+iree_status_t iree_hal_local_dispatch_counters_allocate(
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_counters_t** out_counters) {
+  IREE_ASSERT_ARGUMENT(out_counters);
+  *out_counters = NULL;
+  iree_hal_local_dispatch_counters_t* counters = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*counters), (void**)&counters));
+  memset(counters, 0, sizeof(*counters));
+  counters->host_allocator = host_allocator;
+  iree_atomic_store_int64(&counters->session_id, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&counters->mutex);
+  *out_counters = counters;
+  return iree_ok_status();
+}
+
+// Releases all per-thread state and the file path of the session.
+static void iree_hal_local_dispatch_counters_reset(
+    iree_hal_local_dispatch_counters_t* counters) {
+  iree_hal_local_dispatch_counters_thread_t* thread = counters->thread_list;
+  while (thread) {
+    iree_hal_local_dispatch_counters_thread_t* next = thread->next;
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+    iree_hal_local_dispatch_counters_close_thread_fds(thread);
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+    for (iree_host_size_t i = 0; i < thread->entry_count; ++i) {
+      iree_allocator_free(counters->host_allocator, thread->entries[i].name);
+    }
+    iree_allocator_free(counters->host_allocator, thread->entries);
+    iree_allocator_free(counters->host_allocator, thread);
+    thread = next;
+  }
+  counters->thread_list = NULL;
+  counters->failed_thread_count = 0;
+  iree_allocator_free(counters->host_allocator, counters->file_path);
+  counters->file_path = NULL;
+}
+
+void iree_hal_local_dispatch_counters_free(
+    iree_hal_local_dispatch_counters_t* counters) {
+  if (!counters) return;
+  iree_hal_local_dispatch_counters_reset(counters);
+  iree_slim_mutex_deinitialize(&counters->mutex);
+  iree_allocator_free(counters->host_allocator, counters);
+}
+
+bool iree_hal_local_dispatch_counters_is_active(
+    iree_hal_local_dispatch_counters_t* counters) {
+  return counters && iree_atomic_load_int64(&counters->session_id,
+                                            iree_memory_order_relaxed) != 0;
+}
+
+iree_status_t iree_hal_local_dispatch_counters_begin(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_string_view_t file_path) {
+  IREE_ASSERT_ARGUMENT(counters);
+  if (iree_hal_local_dispatch_counters_is_active(counters)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "dispatch counter profiling already active");
+  }
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+  // Probe the counters on the calling thread so that permission issues are
+  // reported up-front instead of silently producing an empty report.
+  iree_hal_local_dispatch_counters_thread_t probe;
+  memset(&probe, 0, sizeof(probe));
+  int error_number = iree_hal_local_dispatch_counters_open_thread_fds(&probe);
+  if (error_number != 0) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "perf_event_open failed to open hardware counters (%s); counters may "
+        "be unsupported on this machine or restricted by "
+        "/proc/sys/kernel/perf_event_paranoid",
+        strerror(error_number));
+  }
+  iree_hal_local_dispatch_counters_close_thread_fds(&probe);
+
+  if (!iree_string_view_is_empty(file_path)) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(counters->host_allocator,
+                                               file_path.size + 1,
+                                               (void**)&counters->file_path));
+    memcpy(counters->file_path, file_path.data, file_path.size);
+    counters->file_path[file_path.size] = 0;
+  }
+  int64_t session_id = iree_atomic_fetch_add_int64(
+      &iree_hal_local_dispatch_counters_next_session_id, 1,
+      iree_memory_order_relaxed);
+  iree_atomic_store_int64(&counters->session_id, session_id,
+                          iree_memory_order_release);
+  return iree_ok_status();
+#else
+  return iree_make_status(
+      IREE_STATUS_UNAVAILABLE,
+      "dispatch hardware counters require perf_event (Linux/Android)");
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+}
+
+void iree_hal_local_dispatch_counters_sample_begin(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counter_sample_t* out_sample) {
+  out_sample->thread = NULL;
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+  iree_hal_local_dispatch_counters_thread_t* thread =
+      iree_hal_local_dispatch_counters_acquire_thread(counters);
+  if (!thread || thread->group_fd == -1) return;
+  if (iree_hal_local_dispatch_counters_read(thread, out_sample->values)) {
+    out_sample->thread = thread;
+  }
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+}
+
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+
+// Returns the entry for |ordinal| of |executable| on |thread|, creating it if
+// needed. Returns NULL if out of memory.
+static iree_hal_local_dispatch_counters_entry_t*
+iree_hal_local_dispatch_counters_lookup_entry(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counters_thread_t* thread,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  for (iree_host_size_t i = 0; i < thread->entry_count; ++i) {
+    iree_hal_local_dispatch_counters_entry_t* entry = &thread->entries[i];
+    if (entry->executable == executable && entry->ordinal == ordinal) {
+      return entry;
+    }
+  }
+
+  if (thread->entry_count == thread->entry_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, thread->entry_capacity * 2);
+    if (!iree_status_is_ok(iree_allocator_realloc(
+            counters->host_allocator, new_capacity * sizeof(*thread->entries),
+            (void**)&thread->entries))) {
+      return NULL;
+    }
+    thread->entry_capacity = new_capacity;
+  }
+
+  // Exports without names are distinguished by ordinal only.
+  char fallback_name[32];
+  const char* name = executable->export_names
+                         ? executable->export_names[ordinal]
+                         : NULL;
+  if (!name) {
+    snprintf(fallback_name, sizeof(fallback_name), "export_%" PRIhsz, ordinal);
+    name = fallback_name;
+  }
+  iree_host_size_t name_length = strlen(name);
+  char* name_copy = NULL;
+  if (!iree_status_is_ok(iree_allocator_malloc(counters->host_allocator,
+                                               name_length + 1,
+                                               (void**)&name_copy))) {
+    return NULL;
+  }
+  memcpy(name_copy, name, name_length + 1);
+
+  iree_hal_local_dispatch_counters_entry_t* entry =
+      &thread->entries[thread->entry_count++];
+  memset(entry, 0, sizeof(*entry));
+  entry->executable = executable;
+  entry->ordinal = ordinal;
+  entry->name = name_copy;
+  return entry;
+}
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+
+void iree_hal_local_dispatch_counters_sample_end(
+    iree_hal_local_dispatch_counters_t* counters,
+    const iree_hal_local_dispatch_counter_sample_t* sample,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    bool is_first_workgroup) {
+#if IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+  iree_hal_local_dispatch_counters_thread_t* thread =
+      (iree_hal_local_dispatch_counters_thread_t*)sample->thread;
+  if (!thread) return;
+  uint64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+  if (!iree_hal_local_dispatch_counters_read(thread, values)) return;
+  iree_hal_local_dispatch_counters_entry_t* entry =
+      iree_hal_local_dispatch_counters_lookup_entry(counters, thread,
+                                                    executable, ordinal);
+  if (!entry) return;
+  if (is_first_workgroup) ++entry->dispatch_count;
+  ++entry->workgroup_count;
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    entry->values[i] += values[i] - sample->values[i];
+  }
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_PERF_EVENT
+}
+
+static int iree_hal_local_dispatch_counters_compare_entries(const void* a,
+                                                            const void* b) {
+  uint64_t cycles_a = ((const iree_hal_local_dispatch_counters_entry_t*)a)
+                          ->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES];
+  uint64_t cycles_b = ((const iree_hal_local_dispatch_counters_entry_t*)b)
+                          ->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES];
+  return cycles_a < cycles_b ? 1 : (cycles_a > cycles_b ? -1 : 0);
+}
+
+static double iree_hal_local_dispatch_counters_ratio(uint64_t numerator,
+                                                     uint64_t denominator) {
+  return denominator ? (double)numerator / (double)denominator : 0.0;
+}
+
+// Merges the entries of all threads by export name and writes the report.
+static iree_status_t iree_hal_local_dispatch_counters_write_report(
+    iree_hal_local_dispatch_counters_t* counters) {
+  iree_host_size_t max_entry_count = 0;
+  for (iree_hal_local_dispatch_counters_thread_t* thread =
+           counters->thread_list;
+       thread; thread = thread->next) {
+    max_entry_count += thread->entry_count;
+  }
+  iree_hal_local_dispatch_counters_entry_t* merged = NULL;
+  if (max_entry_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        counters->host_allocator, max_entry_count * sizeof(*merged),
+        (void**)&merged));
+  }
+  iree_host_size_t merged_count = 0;
+  for (iree_hal_local_dispatch_counters_thread_t* thread =
+           counters->thread_list;
+       thread; thread = thread->next) {
+    for (iree_host_size_t i = 0; i < thread->entry_count; ++i) {
+      const iree_hal_local_dispatch_counters_entry_t* entry =
+          &thread->entries[i];
+      iree_hal_local_dispatch_counters_entry_t* target = NULL;
+      for (iree_host_size_t j = 0; j < merged_count; ++j) {
+        if (strcmp(merged[j].name, entry->name) == 0) {
+          target = &merged[j];
+          break;
+        }
+      }
+      if (!target) {
+        target = &merged[merged_count++];
+        memset(target, 0, sizeof(*target));
+        target->name = entry->name;  // borrowed from the thread entry
+      }
+      target->dispatch_count += entry->dispatch_count;
+      target->workgroup_count += entry->workgroup_count;
+      for (iree_host_size_t k = 0; k < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT;
+           ++k) {
+        target->values[k] += entry->values[k];
+      }
+    }
+  }
+  if (merged_count > 0) {
+    qsort(merged, merged_count, sizeof(*merged),
+          iree_hal_local_dispatch_counters_compare_entries);
+  }
+
+  FILE* file = stderr;
+  if (counters->file_path) {
+    file = fopen(counters->file_path, "wb");
+    if (!file) {
+      iree_allocator_free(counters->host_allocator, merged);
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to open dispatch counter report '%s'",
+                              counters->file_path);
+    }
+  }
+  if (counters->failed_thread_count > 0) {
+    fprintf(file,
+            "# counters unavailable on %" PRIhsz
+            " thread(s); their workgroups are not included\n",
+            counters->failed_thread_count);
+  }
+  fprintf(file, "export,dispatches,workgroups");
+  for (iree_host_size_t i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    fprintf(file, ",%s", iree_hal_local_dispatch_counter_names[i]);
+  }
+  fprintf(file, ",ipc,cache_miss_rate,branch_mpki\n");
+  for (iree_host_size_t i = 0; i < merged_count; ++i) {
+    const iree_hal_local_dispatch_counters_entry_t* entry = &merged[i];
+    const uint64_t* values = entry->values;
+    fprintf(file, "%s,%" PRIu64 ",%" PRIu64, entry->name,
+            entry->dispatch_count, entry->workgroup_count);
+    for (iree_host_size_t j = 0; j < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT;
+         ++j) {
+      fprintf(file, ",%" PRIu64, values[j]);
+    }
+    fprintf(
+        file, ",%.3f,%.4f,%.3f\n",
+        iree_hal_local_dispatch_counters_ratio(
+            values[IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS],
+            values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES]),
+        iree_hal_local_dispatch_counters_ratio(
+            values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CACHE_MISSES],
+            values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CACHE_REFERENCES]),
+        1000.0 * iree_hal_local_dispatch_counters_ratio(
+                     values[IREE_HAL_LOCAL_DISPATCH_COUNTER_BRANCH_MISSES],
+                     values[IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS]));
+  }
+  iree_allocator_free(counters->host_allocator, merged);
+
+  iree_status_t status = iree_ok_status();
+  if (file != stderr) {
+    bool write_failed = ferror(file) != 0;
+    if (fclose(file) != 0) write_failed = true;
+    if (write_failed) {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "failed to write dispatch counter report '%s'",
+                                counters->file_path);
+    }
+  } else {
+    fflush(file);
+  }
+  return status;
+}
+
+iree_status_t iree_hal_local_dispatch_counters_end(
+    iree_hal_local_dispatch_counters_t* counters) {
+  if (!iree_hal_local_dispatch_counters_is_active(counters)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_atomic_store_int64(&counters->session_id, 0, iree_memory_order_release);
+  iree_slim_mutex_lock(&counters->mutex);
+  iree_status_t status =
+      iree_hal_local_dispatch_counters_write_report(counters);
+  iree_hal_local_dispatch_counters_reset(counters);
+  iree_slim_mutex_unlock(&counters->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,101 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
+#define IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/local_executable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Hardware counters sampled around each workgroup.
+typedef enum iree_hal_local_dispatch_counter_e {
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES = 0,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_CACHE_REFERENCES,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_CACHE_MISSES,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_BRANCH_MISSES,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT,
+} iree_hal_local_dispatch_counter_t;
+
+// Per-dispatch CPU hardware counter profiler.
+//
+// Used for IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS by local devices.
+// While active each workgroup executed is bracketed by reads of a group of
+// per-thread hardware counters (via perf_event_open on Linux/Android) and the
+// deltas are accumulated per executable export on the executing thread. When
+// the profile ends the per-thread totals are merged and a CSV report of the
+// counters along with the derived IPC, cache miss rate, and branch misses per
+// thousand instructions of each export is written out. This makes it possible
+// to tell compute-bound and memory-bound dispatches apart without attaching
+// an external profiler.
+//
+// Counters measure only user-space execution of the calling thread and are
+// read with a syscall per workgroup; expect dispatches with very small
+// workgroups to slow down noticeably while profiling.
+//
+// Unsupported platforms fail to begin profiling with IREE_STATUS_UNAVAILABLE.
+typedef struct iree_hal_local_dispatch_counters_t
+    iree_hal_local_dispatch_counters_t;
+
+// Allocates an inactive profiler. No counters are opened until it is started.
+iree_status_t iree_hal_local_dispatch_counters_allocate(
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_counters_t** out_counters);
+
+// Frees |counters|. Profiling must not be active.
+void iree_hal_local_dispatch_counters_free(
+    iree_hal_local_dispatch_counters_t* counters);
+
+// Returns true if |counters| is non-NULL and capturing.
+bool iree_hal_local_dispatch_counters_is_active(
+    iree_hal_local_dispatch_counters_t* counters);
+
+// Starts capturing counters. The report is written to |file_path| when the
+// profile ends or to stderr if no path is provided.
+iree_status_t iree_hal_local_dispatch_counters_begin(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_string_view_t file_path);
+
+// Stops capturing and writes the report. Must only be called when no
+// dispatches are executing (such as after all queues have idled) as the
+// per-thread state of the workers is released.
+iree_status_t iree_hal_local_dispatch_counters_end(
+    iree_hal_local_dispatch_counters_t* counters);
+
+// Counter values captured by iree_hal_local_dispatch_counters_sample_begin.
+typedef struct iree_hal_local_dispatch_counter_sample_t {
+  // Per-thread counter state or NULL if counters are unavailable.
+  void* thread;
+  uint64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+} iree_hal_local_dispatch_counter_sample_t;
+
+// Reads the counters of the calling thread prior to executing a workgroup.
+// Counters are lazily opened on the first sample taken by each thread.
+void iree_hal_local_dispatch_counters_sample_begin(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counter_sample_t* out_sample);
+
+// Reads the counters of the calling thread after executing a workgroup of
+// export |ordinal| of |executable| and accumulates the deltas from |sample|.
+// |is_first_workgroup| counts the workgroup as the start of a new dispatch.
+void iree_hal_local_dispatch_counters_sample_end(
+    iree_hal_local_dispatch_counters_t* counters,
+    const iree_hal_local_dispatch_counter_sample_t* sample,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    bool is_first_workgroup);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
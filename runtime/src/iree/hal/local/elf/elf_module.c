@@ -242,9 +242,13 @@ static iree_status_t iree_elf_module_load_segments(
   // uncommitted by default as the ELF may only sparsely use the address space.
   module->vaddr_size = iree_page_align_end(
       vaddr_range.length, load_state->memory_info.normal_page_size);
+  iree_memory_view_flags_t view_flags = IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE;
+#if IREE_ELF_MODULE_LARGE_PAGE_TEXT
+  view_flags |= IREE_MEMORY_VIEW_FLAG_LARGE_PAGES;
+#endif  // IREE_ELF_MODULE_LARGE_PAGE_TEXT
   IREE_RETURN_IF_ERROR(iree_memory_view_reserve(
-      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, module->vaddr_size,
-      module->host_allocator, (void**)&module->vaddr_base));
+      view_flags, module->vaddr_size, module->host_allocator,
+      (void**)&module->vaddr_base));
   module->vaddr_bias = module->vaddr_base - vaddr_range.offset;
 
   // Commit and load all of the segments.
@@ -262,6 +266,14 @@ static iree_status_t iree_elf_module_load_segments(
         module->vaddr_bias, 1, &byte_range,
         IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
 
+#if IREE_ELF_MODULE_LARGE_PAGE_TEXT
+    // Request large pages before the copy below first touches the pages so
+    // that they are allocated as large pages instead of collapsed later.
+    if (phdr->p_flags & IREE_ELF_PF_X) {
+      iree_memory_view_advise_large_pages(module->vaddr_bias, 1, &byte_range);
+    }
+#endif  // IREE_ELF_MODULE_LARGE_PAGE_TEXT
+
     // Copy data present in the file.
     // TODO(benvanik): infra for being able to detect if the source model is in
     // a mapped file - if it is, we can remap the page and directly reference it
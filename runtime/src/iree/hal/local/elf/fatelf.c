@@ -6,7 +6,66 @@
 
 #include "iree/hal/local/elf/fatelf.h"
 
+#include "iree/base/internal/cpu.h"
 #include "iree/hal/local/elf/arch.h"
+#include "iree/schemas/cpu_data.h"
+
+#if defined(IREE_ARCH_X86_64)
+
+// Features of each x86-64 microarchitecture level that we have CPU data for.
+// Levels also require features (POPCNT, BMI, MOVBE, etc) that are implied by
+// the ones listed on all processors we support.
+#define IREE_FATELF_X86_64_V2_FEATURES                        \
+  (IREE_CPU_DATA0_X86_64_SSE3 | IREE_CPU_DATA0_X86_64_SSSE3 | \
+   IREE_CPU_DATA0_X86_64_SSE41 | IREE_CPU_DATA0_X86_64_SSE42)
+#define IREE_FATELF_X86_64_V3_FEATURES                          \
+  (IREE_FATELF_X86_64_V2_FEATURES | IREE_CPU_DATA0_X86_64_AVX | \
+   IREE_CPU_DATA0_X86_64_AVX2 | IREE_CPU_DATA0_X86_64_FMA |     \
+   IREE_CPU_DATA0_X86_64_F16C)
+#define IREE_FATELF_X86_64_V4_FEATURES                               \
+  (IREE_FATELF_X86_64_V3_FEATURES | IREE_CPU_DATA0_X86_64_AVX512F |  \
+   IREE_CPU_DATA0_X86_64_AVX512CD | IREE_CPU_DATA0_X86_64_AVX512VL | \
+   IREE_CPU_DATA0_X86_64_AVX512DQ | IREE_CPU_DATA0_X86_64_AVX512BW)
+#define IREE_FATELF_X86_64_ZNVER4_FEATURES                                 \
+  (IREE_FATELF_X86_64_V4_FEATURES | IREE_CPU_DATA0_X86_64_AVX512IFMA |     \
+   IREE_CPU_DATA0_X86_64_AVX512VBMI | IREE_CPU_DATA0_X86_64_AVX512VBMI2 |  \
+   IREE_CPU_DATA0_X86_64_AVX512VPOPCNTDQ |                                 \
+   IREE_CPU_DATA0_X86_64_AVX512VNNI | IREE_CPU_DATA0_X86_64_AVX512BITALG | \
+   IREE_CPU_DATA0_X86_64_AVX512BF16)
+
+bool iree_fatelf_feature_level_is_supported(iree_elf64_byte_t feature_level) {
+  uint64_t required_features = 0;
+  switch (feature_level) {
+    case IREE_FATELF_FEATURE_LEVEL_BASELINE:
+      return true;
+    case IREE_FATELF_FEATURE_LEVEL_X86_64_V2:
+      required_features = IREE_FATELF_X86_64_V2_FEATURES;
+      break;
+    case IREE_FATELF_FEATURE_LEVEL_X86_64_V3:
+      required_features = IREE_FATELF_X86_64_V3_FEATURES;
+      break;
+    case IREE_FATELF_FEATURE_LEVEL_X86_64_V4:
+      required_features = IREE_FATELF_X86_64_V4_FEATURES;
+      break;
+    case IREE_FATELF_FEATURE_LEVEL_X86_64_ZNVER4:
+      required_features = IREE_FATELF_X86_64_ZNVER4_FEATURES;
+      break;
+    default:
+      return false;
+  }
+  // NOTE: CPU data is zeroed if it has not been initialized in which case only
+  // the baseline is selected.
+  return iree_all_bits_set(iree_cpu_data_field(0), required_features);
+}
+
+#else
+
+bool iree_fatelf_feature_level_is_supported(iree_elf64_byte_t feature_level) {
+  // No levels beyond the baseline are defined for other architectures.
+  return feature_level == IREE_FATELF_FEATURE_LEVEL_BASELINE;
+}
+
+#endif  // IREE_ARCH_X86_64
 
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                  iree_const_byte_span_t* out_elf_data) {
@@ -58,9 +117,10 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                             required_bytes, file_data.data_length);
   }
 
-  // Scan record table to find one that matches.
+  // Scan record table to find the best one that matches.
   iree_elf64_off_t selected_offset = 0;
   iree_elf64_xword_t selected_size = 0;
+  int selected_feature_level = -1;
   for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
     const iree_fatelf_record_t* raw_record = &raw_header->records[i];
     const iree_fatelf_record_t host_record = {
@@ -69,7 +129,7 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
+        .feature_level = iree_unaligned_load_le_u8(&raw_record->feature_level),
         .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
@@ -91,14 +151,19 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
 #else
     if (host_record.byte_order != IREE_FATELF_BYTE_ORDER_MSB) continue;
 #endif  // IREE_ENDIANNESS_LITTLE
+    if (host_record.feature_level <= selected_feature_level) continue;
+    if (!iree_fatelf_feature_level_is_supported(host_record.feature_level)) {
+      continue;
+    }
     selected_offset = host_record.offset;
     selected_size = host_record.size;
-    break;
+    selected_feature_level = host_record.feature_level;
   }
   if (!selected_offset || !selected_size) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "no ELFs matching the runtime architecture or "
-                            "Linux ABI found in the FatELF");
+                            "no ELFs matching the runtime architecture, "
+                            "processor features, or Linux ABI found in the "
+                            "FatELF");
   }
 
   // Bounds check the file range - the caller expects valid pointers.
@@ -39,9 +39,8 @@
 #define IREE_FATELF_MAGIC 0x1F0E70FA  // FA700E1F 'fat' 'elf' lol
 
 // Only version 1 is defined. We may end up with our own versions if we diverge.
-// FatELF doesn't have any architectural feature requirement bits which makes it
-// difficult to support specialized ELFs based on things like instruction set
-// support and we may want to add that.
+// FatELF doesn't have any architectural feature requirement bits so we use the
+// first reserved byte of each record to declare a feature level (see below).
 #define IREE_FATELF_FORMAT_VERSION 1
 
 enum {
@@ -54,6 +53,24 @@ enum {
   IREE_FATELF_BYTE_ORDER_LSB = 1,  // IREE_ELF_ELFDATA2LSB - little-endian
 };
 
+// IREE extension: the instruction set features required by an ELF.
+// Levels are architecture-specific and each requires a superset of the
+// features of the levels below it. Level 0 is the architecture baseline and
+// what other FatELF tools write into the reserved byte. When multiple ELFs
+// match the runtime architecture the one with the highest level supported by
+// the host processor is selected. Levels not known to the runtime are never
+// selected.
+enum {
+  IREE_FATELF_FEATURE_LEVEL_BASELINE = 0,
+
+  // x86-64 psABI microarchitecture levels.
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V2 = 1,
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V3 = 2,
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V4 = 3,
+  // x86-64-v4 plus the AVX-512 extensions available on AMD Zen 4.
+  IREE_FATELF_FEATURE_LEVEL_X86_64_ZNVER4 = 4,
+};
+
 // An individual record in the FatELF record table.
 // This has some of the fields from the iree_elf_ehdr_t and references a header-
 // relative file range of where the corresponding ELF file can be found.
@@ -63,7 +80,7 @@ typedef struct {
   iree_elf64_byte_t osabi_version;  // e_ident[EI_ABIVERSION]
   iree_elf64_byte_t word_size;      // e_ident[EI_CLASS]
   iree_elf64_byte_t byte_order;     // e_ident[EI_DATA]
-  iree_elf64_byte_t reserved0;
+  iree_elf64_byte_t feature_level;  // IREE_FATELF_FEATURE_LEVEL_* (reserved)
   iree_elf64_byte_t reserved1;
   iree_elf64_off_t offset;
   iree_elf64_xword_t size;
@@ -80,8 +97,12 @@ typedef struct {
 } iree_fatelf_header_t;
 static_assert(sizeof(iree_fatelf_header_t) == 8, "must be packed");
 
+// Returns true if the host processor supports all features required by
+// |feature_level| on the runtime architecture.
+bool iree_fatelf_feature_level_is_supported(iree_elf64_byte_t feature_level);
+
 // Scans |file_data| for a FatELF header and if present selects the matching ELF
-// for the current system if available.
+// with the highest supported feature level for the current system if available.
 // Upon return |out_elf_data| will either be the entire file if no FatELF header
 // was found or just the bytes of the selected ELF.
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
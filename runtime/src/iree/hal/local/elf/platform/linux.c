@@ -9,6 +9,8 @@
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -16,6 +18,25 @@
 // Memory subsystem information and control
 //==============================================================================
 
+// Returns the transparent huge page size or 0 if unavailable.
+// We use transparent huge pages instead of hugetlbfs as they don't require
+// the system to have reserved a huge page pool and fall back to normal pages
+// gracefully.
+static iree_host_size_t iree_memory_query_transparent_huge_page_size(void) {
+#if defined(MADV_HUGEPAGE)
+  int fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return 0;
+  char buffer[32] = {0};
+  ssize_t read_length = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (read_length <= 0) return 0;
+  return (iree_host_size_t)strtoull(buffer, NULL, 10);
+#else
+  return 0;
+#endif  // MADV_HUGEPAGE
+}
+
 void iree_memory_query_info(iree_memory_info_t* out_info) {
   memset(out_info, 0, sizeof(*out_info));
 
@@ -23,14 +44,11 @@ void iree_memory_query_info(iree_memory_info_t* out_info) {
   out_info->normal_page_size = page_size;
   out_info->normal_page_granularity = page_size;
 
-  // Large pages arent't currently used so we aren't introducing the build goo
-  // to detect and use them yet.
-  // https://linux.die.net/man/3/gethugepagesizes
-  // http://manpages.ubuntu.com/manpages/bionic/man3/gethugepagesize.3.html
-  // Would be:
-  //   #include <hugetlbfs.h>
-  //   out_info->large_page_granularity = gethugepagesize();
-  out_info->large_page_granularity = page_size;
+  iree_host_size_t huge_page_size =
+      iree_memory_query_transparent_huge_page_size();
+  out_info->large_page_granularity =
+      huge_page_size > (iree_host_size_t)page_size ? huge_page_size
+                                                   : page_size;
 
   out_info->can_allocate_executable_pages = true;
 }
@@ -61,14 +79,33 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   int mmap_prot = PROT_NONE;
   int mmap_flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
 
+  // Over-reserve so that the base address can be aligned to the large page
+  // granularity and then return the unaligned head and tail.
+  iree_host_size_t alignment = 0;
+  if (flags & IREE_MEMORY_VIEW_FLAG_LARGE_PAGES) {
+    iree_host_size_t page_size = getpagesize();
+    alignment = iree_memory_query_transparent_huge_page_size();
+    if (alignment <= page_size) alignment = 0;
+  }
+  iree_host_size_t reserve_length = total_length + alignment;
+
   iree_status_t status = iree_ok_status();
-  void* base_address = mmap(NULL, total_length, mmap_prot, mmap_flags, -1, 0);
+  uint8_t* base_address =
+      mmap(NULL, reserve_length, mmap_prot, mmap_flags, -1, 0);
   if (base_address == MAP_FAILED) {
     status = iree_make_status(iree_status_code_from_errno(errno),
                               "mmap reservation failed");
+  } else if (alignment) {
+    uint8_t* aligned_address =
+        (uint8_t*)iree_page_align_end((uintptr_t)base_address, alignment);
+    iree_host_size_t head_length = aligned_address - base_address;
+    if (head_length) munmap(base_address, head_length);
+    iree_host_size_t tail_length = alignment - head_length;
+    if (tail_length) munmap(aligned_address + total_length, tail_length);
+    base_address = aligned_address;
   }
 
-  *out_base_address = base_address;
+  *out_base_address = iree_status_is_ok(status) ? base_address : NULL;
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -136,6 +173,29 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t range_count,
+                                         const iree_byte_range_t* ranges) {
+#if defined(MADV_HUGEPAGE)
+  iree_host_size_t alignment = iree_memory_query_transparent_huge_page_size();
+  if (alignment <= (iree_host_size_t)getpagesize()) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    // Only whole large pages within the range can be used; the partial pages
+    // at either end share protection/backing with neighboring ranges.
+    uintptr_t range_start = iree_page_align_end(
+        (uintptr_t)base_address + ranges[i].offset, alignment);
+    uintptr_t range_end = iree_page_align_start(
+        (uintptr_t)base_address + ranges[i].offset + ranges[i].length,
+        alignment);
+    if (range_end <= range_start) continue;
+    // NOTE: return value ignored as this is only a hint.
+    madvise((void*)range_start, range_end - range_start, MADV_HUGEPAGE);
+  }
+  IREE_TRACE_ZONE_END(z0);
+#endif  // MADV_HUGEPAGE
+}
+
 // IREE_ELF_CLEAR_CACHE can be defined externally to override this default
 // behavior.
 #if !defined(IREE_ELF_CLEAR_CACHE)
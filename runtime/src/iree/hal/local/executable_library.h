@@ -326,8 +326,12 @@ typedef struct iree_hal_executable_workgroup_state_v0_t {
   uint32_t workgroup_id_y;
   uint16_t workgroup_id_z;
 
-  // Reserved for future use.
-  uint16_t reserved;
+  // Total number of workgroups to execute starting at |workgroup_id_*| and
+  // advancing in x-major order (x, then y, then z) within the workgroup count
+  // of the dispatch. A value of 0 is treated as 1. Values greater than 1 are
+  // only passed to exports declaring
+  // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE.
+  uint16_t workgroup_range_count;
 
   // Logical processor identifier used to index into processor info fields.
   // Depending on the implementation this may be an ordinal, a bitfield, or an
@@ -374,6 +378,31 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+// Bitfield specifying how an exported dispatch function is to be executed.
+enum iree_hal_executable_dispatch_flag_bits_v0_t {
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE = 0u,
+  // Export handles |workgroup_range_count| workgroups per call. Hosts may then
+  // issue one call per contiguous run of workgroups instead of one per
+  // workgroup to amortize the call and state setup overhead. Hosts that do
+  // not support ranges will continue to issue one workgroup per call.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE = 1u << 0,
+  // Export requires IEEE denormal handling. By default exports are executed
+  // with denormals flushed to zero (FTZ/DAZ) and hosts must switch the FPU
+  // state of the executing thread prior to calling exports with this flag.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PRESERVE_DENORMALS = 1u << 1,
+  // Export produces the same results regardless of the FPU state (such as
+  // when it performs no floating-point arithmetic). Hosts may execute it in
+  // whatever state the thread is in and avoid switching.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_FPU_AGNOSTIC = 1u << 2,
+  // Export handles the entire dispatch in a single call. Hosts issue exactly
+  // one call with a zero |workgroup_id_*| and the full workgroup count in the
+  // dispatch state; the export is responsible for all workgroups. Intended for
+  // hand-written kernels that defer to libraries with their own scheduling
+  // and that would otherwise be re-entered once per workgroup.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH = 1u << 3,
+};
+typedef uint16_t iree_hal_executable_dispatch_flags_v0_t;
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -382,9 +411,8 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
-  // Must be 0. May be used in the future for flags controlling the dispatch
-  // behavior/synchronization requirements.
-  uint16_t reserved;
+  // Flags controlling the dispatch behavior. Unknown bits must be ignored.
+  iree_hal_executable_dispatch_flags_v0_t flags;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
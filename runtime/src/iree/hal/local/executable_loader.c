@@ -6,6 +6,8 @@
 
 #include "iree/hal/local/executable_loader.h"
 
+#include <string.h>
+
 iree_status_t iree_hal_executable_import_provider_try_resolve(
     const iree_hal_executable_import_provider_t import_provider,
     iree_host_size_t count, const char* const* symbol_names, void** out_fn_ptrs,
@@ -47,6 +49,67 @@ iree_status_t iree_hal_executable_import_provider_try_resolve(
   return status;
 }
 
+// Returns the entry in |table| with the given |symbol_name| or NULL.
+static const iree_hal_executable_import_entry_t*
+iree_hal_executable_import_table_lookup(
+    const iree_hal_executable_import_table_t* table, const char* symbol_name) {
+  iree_host_size_t low = 0;
+  iree_host_size_t high = table->count;
+  while (low < high) {
+    const iree_host_size_t mid = low + (high - low) / 2;
+    const int cmp = strcmp(table->entries[mid].symbol_name, symbol_name);
+    if (cmp == 0) {
+      return &table->entries[mid];
+    } else if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return NULL;
+}
+
+static iree_status_t iree_hal_executable_import_table_resolve(
+    void* self, iree_host_size_t count, const char* const* symbol_names,
+    void** out_fn_ptrs, void** out_fn_contexts,
+    iree_hal_executable_import_resolution_t* out_resolution) {
+  const iree_hal_executable_import_table_t* table =
+      (const iree_hal_executable_import_table_t*)self;
+  iree_hal_executable_import_resolution_t resolution = 0;
+  bool any_required_not_found = false;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    if (out_fn_ptrs[i]) continue;
+    const char* symbol_name = symbol_names[i];
+    const bool is_optional =
+        iree_hal_executable_import_is_optional(symbol_name);
+    if (is_optional) ++symbol_name;
+    const iree_hal_executable_import_entry_t* entry =
+        iree_hal_executable_import_table_lookup(table, symbol_name);
+    if (entry) {
+      out_fn_ptrs[i] = entry->fn_ptr;
+      out_fn_contexts[i] = entry->fn_context;
+    } else if (is_optional) {
+      resolution |= IREE_HAL_EXECUTABLE_IMPORT_RESOLUTION_MISSING_OPTIONAL;
+    } else {
+      any_required_not_found = true;
+    }
+  }
+  if (out_resolution) *out_resolution = resolution;
+  return any_required_not_found
+             ? iree_status_from_code(IREE_STATUS_NOT_FOUND)
+             : iree_ok_status();
+}
+
+iree_hal_executable_import_provider_t
+iree_hal_executable_import_provider_from_table(
+    const iree_hal_executable_import_table_t* table) {
+  iree_hal_executable_import_provider_t provider = {
+      .self = (void*)table,
+      .resolve = table ? iree_hal_executable_import_table_resolve : NULL,
+  };
+  return provider;
+}
+
 void iree_hal_executable_loader_initialize(
     const void* vtable, iree_hal_executable_import_provider_t import_provider,
     iree_hal_executable_loader_t* out_base_loader) {
@@ -80,6 +80,32 @@ iree_status_t iree_hal_executable_import_provider_try_resolve(
     void** out_fn_contexts,
     iree_hal_executable_import_resolution_t* out_resolution);
 
+// A host function made available to executables as an import.
+typedef struct iree_hal_executable_import_entry_t {
+  // Symbol name without the optional `?` prefix.
+  const char* symbol_name;
+  // Function pointer matching the import signature expected by executables
+  // (iree_hal_executable_import_v0_t).
+  void* fn_ptr;
+  // Optional context passed to each call of |fn_ptr|.
+  void* fn_context;
+} iree_hal_executable_import_entry_t;
+
+// A table of host functions sorted ascending by symbol name (by strcmp).
+// Tables are usually static and avoid the need to implement a resolver (or a
+// plugin) when the host application links the functions directly.
+typedef struct iree_hal_executable_import_table_t {
+  iree_host_size_t count;
+  const iree_hal_executable_import_entry_t* entries;
+} iree_hal_executable_import_table_t;
+
+// Returns a provider resolving imports from the host functions in |table|.
+// Each symbol is resolved with a binary search over the sorted table. The
+// table must remain valid for the lifetime of the provider.
+iree_hal_executable_import_provider_t
+iree_hal_executable_import_provider_from_table(
+    const iree_hal_executable_import_table_t* table);
+
 // Returns true if the import |symbol_name| is optional.
 static inline bool iree_hal_executable_import_is_optional(
     const char* symbol_name) {
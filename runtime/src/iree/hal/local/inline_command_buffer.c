@@ -17,6 +17,8 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/shm_channel.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_inline_command_buffer_t
@@ -357,8 +359,12 @@ static iree_status_t iree_hal_inline_command_buffer_collective(
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on CPU");
+  if (!iree_hal_shm_channel_isa(channel)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "only shared memory channels are supported on CPU");
+  }
+  return iree_hal_shm_channel_execute_bindings(
+      channel, op, param, send_binding, recv_binding, element_count);
 }
 
 //===----------------------------------------------------------------------===//
@@ -451,6 +457,10 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
         "layouts not provided during executable creation; cannot dispatch");
   }
 
+  // Lazily loaded executables are loaded on first use so that their dispatch
+  // attributes are available below.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_resolve(local_executable));
+
   iree_hal_local_pipeline_layout_t* local_layout =
       (iree_hal_local_pipeline_layout_t*)
           local_executable->pipeline_layouts[entry_point];
@@ -530,13 +540,23 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   }
 
   // Since we are running on a borrowed thread, we know nothing about the
-  // floating point state. Reset it.
-  iree_fpu_state_t fpu_state =
-      iree_fpu_state_push(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO);
+  // floating point state. Set it to what the entry point requires and restore
+  // it afterward unless the entry point does not depend on it.
+  const iree_hal_executable_dispatch_flags_v0_t dispatch_flags =
+      iree_hal_local_executable_dispatch_flags(local_executable, entry_point);
+  const bool fpu_agnostic =
+      (dispatch_flags & IREE_HAL_EXECUTABLE_DISPATCH_FLAG_FPU_AGNOSTIC) != 0;
+  iree_fpu_state_t fpu_state = {0};
+  if (!fpu_agnostic) {
+    fpu_state = iree_fpu_state_push(
+        (dispatch_flags & IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PRESERVE_DENORMALS)
+            ? IREE_FPU_STATE_DEFAULT
+            : IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO);
+  }
   iree_status_t status = iree_hal_local_executable_issue_dispatch_inline(
       local_executable, entry_point, dispatch_state,
       command_buffer->state.processor_id, local_memory);
-  iree_fpu_state_pop(fpu_state);
+  if (!fpu_agnostic) iree_fpu_state_pop(fpu_state);
 
   if (local_memory.data) {
     iree_allocator_free(command_buffer->host_allocator, local_memory.data);
@@ -579,12 +599,15 @@ static iree_status_t iree_hal_inline_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): decide how to execute the inline command buffer; it is
-  // definitely a deferred command buffer but we don't want to force that
-  // dependency here. We could allow injection of a function to call to execute
-  // command buffers so that the device can decide how it wants to handle them.
+  // Nested command buffers are deferred command buffers that execute inline as
+  // they are replayed with the binding table resolved.
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    return iree_hal_deferred_command_buffer_apply(
+        base_commands, base_command_buffer, binding_table);
+  }
   return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+                          "only deferred command buffers can be executed "
+                          "indirectly");
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,293 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/lazy_executable.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_lazy_executable_t
+//===----------------------------------------------------------------------===//
+
+// Resolution state of a lazy executable.
+typedef enum iree_hal_lazy_executable_state_e {
+  // Not yet loaded.
+  IREE_HAL_LAZY_EXECUTABLE_STATE_PENDING = 0,
+  // Loaded successfully and |loaded_executable| is valid.
+  IREE_HAL_LAZY_EXECUTABLE_STATE_LOADED = 1,
+  // Loading failed and |load_status| holds the error.
+  IREE_HAL_LAZY_EXECUTABLE_STATE_FAILED = 2,
+} iree_hal_lazy_executable_state_t;
+
+typedef struct iree_hal_lazy_executable_t {
+  iree_hal_local_executable_t base;
+
+  // Worker capacity passed to the loaders.
+  iree_host_size_t worker_capacity;
+  // Executable parameters referencing storage owned by the executable.
+  iree_hal_executable_params_t params;
+
+  // iree_hal_lazy_executable_state_t; stored with release semantics after the
+  // base fields have been updated from the loaded executable.
+  iree_atomic_int32_t state;
+  // Guards loading so that only one thread performs it.
+  iree_slim_mutex_t mutex;
+  // Loaded executable when state is IREE_HAL_LAZY_EXECUTABLE_STATE_LOADED.
+  iree_hal_local_executable_t* loaded_executable;
+  // Sticky error when state is IREE_HAL_LAZY_EXECUTABLE_STATE_FAILED.
+  iree_status_t load_status;
+
+  // Retained loaders that may be able to load the executable.
+  iree_host_size_t loader_count;
+  iree_hal_executable_loader_t** loaders;
+
+  // Trailing storage for loaders, pipeline layouts, constants, the executable
+  // format, and (unless aliased) the executable data.
+  iree_hal_pipeline_layout_t* layouts[];
+} iree_hal_lazy_executable_t;
+
+static const iree_hal_local_executable_vtable_t iree_hal_lazy_executable_vtable;
+
+static iree_hal_lazy_executable_t* iree_hal_lazy_executable_cast(
+    iree_hal_executable_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_lazy_executable_vtable);
+  return (iree_hal_lazy_executable_t*)base_value;
+}
+
+iree_status_t iree_hal_lazy_executable_create(
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(!executable_params->pipeline_layout_count ||
+                       executable_params->pipeline_layouts);
+  IREE_ASSERT_ARGUMENT(!executable_params->constant_count ||
+                       executable_params->constants);
+  IREE_ASSERT_ARGUMENT(!loader_count || loaders);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  *out_executable = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Only retain the loaders that may support the executable so that resolution
+  // doesn't need to query them again.
+  iree_host_size_t supported_loader_count = 0;
+  for (iree_host_size_t i = 0; i < loader_count; ++i) {
+    if (iree_hal_executable_loader_query_support(
+            loaders[i], executable_params->caching_mode,
+            executable_params->executable_format)) {
+      ++supported_loader_count;
+    }
+  }
+  if (supported_loader_count == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_NOT_FOUND,
+        "no executable loader registered for the given executable format "
+        "'%.*s'",
+        (int)executable_params->executable_format.size,
+        executable_params->executable_format.data);
+  }
+
+  const bool alias_data =
+      iree_all_bits_set(executable_params->caching_mode,
+                        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA);
+  iree_hal_lazy_executable_t* executable = NULL;
+  iree_host_size_t layouts_size = executable_params->pipeline_layout_count *
+                                  sizeof(*executable->layouts);
+  iree_host_size_t loaders_size =
+      supported_loader_count * sizeof(*executable->loaders);
+  iree_host_size_t constants_size = executable_params->constant_count *
+                                    sizeof(*executable_params->constants);
+  iree_host_size_t format_size = executable_params->executable_format.size;
+  iree_host_size_t data_size =
+      alias_data ? 0 : executable_params->executable_data.data_length;
+  iree_host_size_t total_size = sizeof(*executable) + layouts_size +
+                                loaders_size + constants_size + format_size +
+                                data_size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&executable));
+  iree_hal_local_executable_initialize(
+      &iree_hal_lazy_executable_vtable,
+      executable_params->pipeline_layout_count,
+      executable_params->pipeline_layouts, &executable->layouts[0],
+      host_allocator, &executable->base);
+  executable->worker_capacity = worker_capacity;
+  iree_atomic_store_int32(&executable->state,
+                          IREE_HAL_LAZY_EXECUTABLE_STATE_PENDING,
+                          iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&executable->mutex);
+  executable->loaded_executable = NULL;
+  executable->load_status = iree_ok_status();
+
+  uint8_t* storage_ptr = (uint8_t*)executable + sizeof(*executable) +
+                         layouts_size;
+  executable->loader_count = 0;
+  executable->loaders = (iree_hal_executable_loader_t**)storage_ptr;
+  for (iree_host_size_t i = 0; i < loader_count; ++i) {
+    if (iree_hal_executable_loader_query_support(
+            loaders[i], executable_params->caching_mode,
+            executable_params->executable_format)) {
+      executable->loaders[executable->loader_count++] = loaders[i];
+      iree_hal_executable_loader_retain(loaders[i]);
+    }
+  }
+  storage_ptr += loaders_size;
+
+  // Clone the parameters so that they remain valid until load. Pipeline
+  // layouts are shared with the base executable.
+  executable->params = *executable_params;
+  executable->params.pipeline_layouts = executable->base.pipeline_layouts;
+  if (constants_size > 0) {
+    memcpy(storage_ptr, executable_params->constants, constants_size);
+    executable->params.constants = (const uint32_t*)storage_ptr;
+    storage_ptr += constants_size;
+  }
+  memcpy(storage_ptr, executable_params->executable_format.data, format_size);
+  executable->params.executable_format =
+      iree_make_string_view((const char*)storage_ptr, format_size);
+  storage_ptr += format_size;
+  if (!alias_data) {
+    memcpy(storage_ptr, executable_params->executable_data.data, data_size);
+    executable->params.executable_data =
+        iree_make_const_byte_span(storage_ptr, data_size);
+  }
+
+  *out_executable = (iree_hal_executable_t*)executable;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_lazy_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_lazy_executable_t* executable =
+      iree_hal_lazy_executable_cast(base_executable);
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_executable_release(
+      (iree_hal_executable_t*)executable->loaded_executable);
+  iree_status_ignore(executable->load_status);
+  for (iree_host_size_t i = 0; i < executable->loader_count; ++i) {
+    iree_hal_executable_loader_release(executable->loaders[i]);
+  }
+  iree_slim_mutex_deinitialize(&executable->mutex);
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_lazy_executable_isa(iree_hal_executable_t* executable) {
+  return iree_hal_resource_is(executable, &iree_hal_lazy_executable_vtable);
+}
+
+bool iree_hal_lazy_executable_is_resolved(iree_hal_executable_t* executable) {
+  iree_hal_lazy_executable_t* lazy_executable =
+      iree_hal_lazy_executable_cast(executable);
+  return iree_atomic_load_int32(&lazy_executable->state,
+                                iree_memory_order_acquire) !=
+         IREE_HAL_LAZY_EXECUTABLE_STATE_PENDING;
+}
+
+// Loads the executable with the first loader that accepts it.
+static iree_status_t iree_hal_lazy_executable_load(
+    iree_hal_lazy_executable_t* executable,
+    iree_hal_executable_t** out_executable) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, executable->params.executable_format.data,
+                              executable->params.executable_format.size);
+  for (iree_host_size_t i = 0; i < executable->loader_count; ++i) {
+    // The try will fail with IREE_STATUS_CANCELLED if the specific executable
+    // is not supported and we should continue trying other loaders.
+    iree_status_t status = iree_hal_executable_loader_try_load(
+        executable->loaders[i], &executable->params,
+        executable->worker_capacity, out_executable);
+    if (!iree_status_is_cancelled(status)) {
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_make_status(
+      IREE_STATUS_NOT_FOUND,
+      "no executable loader was able to load the executable format '%.*s'",
+      (int)executable->params.executable_format.size,
+      executable->params.executable_format.data);
+}
+
+static iree_status_t iree_hal_lazy_executable_resolve(
+    iree_hal_local_executable_t* base_executable) {
+  iree_hal_lazy_executable_t* executable =
+      (iree_hal_lazy_executable_t*)base_executable;
+
+  // Fast path for already resolved executables.
+  int32_t state =
+      iree_atomic_load_int32(&executable->state, iree_memory_order_acquire);
+  if (IREE_LIKELY(state == IREE_HAL_LAZY_EXECUTABLE_STATE_LOADED)) {
+    return iree_ok_status();
+  }
+
+  iree_slim_mutex_lock(&executable->mutex);
+  state =
+      iree_atomic_load_int32(&executable->state, iree_memory_order_relaxed);
+  if (state == IREE_HAL_LAZY_EXECUTABLE_STATE_PENDING) {
+    iree_hal_executable_t* loaded_executable = NULL;
+    iree_status_t status =
+        iree_hal_lazy_executable_load(executable, &loaded_executable);
+    if (iree_status_is_ok(status)) {
+      // Adopt the attributes of the loaded executable so that dispatch
+      // recording can use them directly.
+      executable->loaded_executable =
+          iree_hal_local_executable_cast(loaded_executable);
+      executable->base.dispatch_attrs =
+          executable->loaded_executable->dispatch_attrs;
+      executable->base.workgroup_durations_ns =
+          executable->loaded_executable->workgroup_durations_ns;
+      executable->base.export_names =
+          executable->loaded_executable->export_names;
+      state = IREE_HAL_LAZY_EXECUTABLE_STATE_LOADED;
+    } else {
+      executable->load_status = status;
+      state = IREE_HAL_LAZY_EXECUTABLE_STATE_FAILED;
+    }
+    iree_atomic_store_int32(&executable->state, state,
+                            iree_memory_order_release);
+  }
+  iree_status_t status = state == IREE_HAL_LAZY_EXECUTABLE_STATE_LOADED
+                             ? iree_ok_status()
+                             : iree_status_clone(executable->load_status);
+  iree_slim_mutex_unlock(&executable->mutex);
+  return status;
+}
+
+static iree_status_t iree_hal_lazy_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  iree_hal_lazy_executable_t* executable =
+      (iree_hal_lazy_executable_t*)base_executable;
+  IREE_RETURN_IF_ERROR(iree_hal_lazy_executable_resolve(base_executable));
+  return iree_hal_local_executable_issue_call(executable->loaded_executable,
+                                              ordinal, dispatch_state,
+                                              workgroup_state, worker_id);
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_lazy_executable_vtable = {
+        .base =
+            {
+                .destroy = iree_hal_lazy_executable_destroy,
+            },
+        .issue_call = iree_hal_lazy_executable_issue_call,
+        .resolve = iree_hal_lazy_executable_resolve,
+};
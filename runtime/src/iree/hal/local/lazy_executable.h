@@ -0,0 +1,46 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
+#define IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a local executable that defers loading |executable_params| with one
+// of |loaders| until it is first resolved. Resolution happens when a dispatch
+// of the executable is first recorded or issued or when explicitly requested
+// with iree_hal_local_executable_resolve (such as from a prefetch thread).
+//
+// Only loaders that report support for the executable format are retained.
+// The executable data is cloned unless the caching mode includes
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA.
+//
+// Errors loading the executable are reported by the first resolution and all
+// later resolutions return the same error.
+iree_status_t iree_hal_lazy_executable_create(
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable);
+
+// Returns true if |executable| is a lazy executable.
+bool iree_hal_lazy_executable_isa(iree_hal_executable_t* executable);
+
+// Returns true if the lazy |executable| has been loaded (or failed to load).
+bool iree_hal_lazy_executable_is_resolved(iree_hal_executable_t* executable);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
@@ -10,6 +10,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/elf/elf_module.h"
 #include "iree/hal/local/executable_library.h"
@@ -17,6 +19,144 @@
 #include "iree/hal/local/executable_plugin_manager.h"
 #include "iree/hal/local/local_executable.h"
 
+// Set to 0 to load a private copy of each ELF per executable.
+// When enabled executables created from identical binaries (such as when the
+// same module is loaded into multiple contexts or devices) share a single
+// loaded image and thus a single copy of the code and read-only data pages.
+#if !defined(IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES)
+#define IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES 1
+#endif  // !IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+
+//===----------------------------------------------------------------------===//
+// Process-wide loaded module cache
+//===----------------------------------------------------------------------===//
+
+// A loaded ELF module shared by all executables created from the same bytes.
+// Executables are stateless (imports and constants live in the per-executable
+// environment) so the entire loaded image can be shared.
+typedef struct iree_hal_elf_shared_module_t {
+  struct iree_hal_elf_shared_module_t* next;
+  // Number of executables referencing the module. Guarded by the cache lock.
+  int32_t ref_count;
+  // FNV-1a hash and length of the ELF bytes used as the cache key.
+  uint64_t hash;
+  iree_host_size_t length;
+  iree_elf_module_t module;
+} iree_hal_elf_shared_module_t;
+
+#if IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+
+typedef struct iree_hal_elf_module_cache_t {
+  iree_slim_mutex_t mutex;
+  iree_hal_elf_shared_module_t* head IREE_GUARDED_BY(mutex);
+} iree_hal_elf_module_cache_t;
+
+static iree_hal_elf_module_cache_t iree_hal_elf_module_cache_;
+static iree_once_flag iree_hal_elf_module_cache_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_hal_elf_module_cache_initialize(void) {
+  iree_slim_mutex_initialize(&iree_hal_elf_module_cache_.mutex);
+}
+
+static iree_hal_elf_module_cache_t* iree_hal_elf_module_cache(void) {
+  iree_call_once(&iree_hal_elf_module_cache_flag_,
+                 iree_hal_elf_module_cache_initialize);
+  return &iree_hal_elf_module_cache_;
+}
+
+static uint64_t iree_hal_elf_module_hash(iree_const_byte_span_t data) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < data.data_length; ++i) {
+    hash = (hash ^ data.data[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+#endif  // IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+
+// Returns a loaded module for |executable_data|, loading it if no executable
+// in the process has already done so. Callers must release the module with
+// iree_hal_elf_shared_module_release.
+static iree_status_t iree_hal_elf_shared_module_acquire(
+    iree_const_byte_span_t executable_data,
+    iree_hal_elf_shared_module_t** out_shared_module) {
+  *out_shared_module = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Shared modules may outlive the device that created them and are always
+  // allocated from the system allocator.
+  iree_allocator_t host_allocator = iree_allocator_system();
+
+#if IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+  uint64_t hash = iree_hal_elf_module_hash(executable_data);
+  iree_hal_elf_module_cache_t* cache = iree_hal_elf_module_cache();
+  iree_slim_mutex_lock(&cache->mutex);
+  for (iree_hal_elf_shared_module_t* it = cache->head; it; it = it->next) {
+    if (it->hash == hash && it->length == executable_data.data_length) {
+      ++it->ref_count;
+      iree_slim_mutex_unlock(&cache->mutex);
+      *out_shared_module = it;
+      IREE_TRACE_ZONE_END(z0);
+      return iree_ok_status();
+    }
+  }
+#endif  // IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+
+  // Loading happens with the lock held so that concurrent loads of the same
+  // binary don't both map it.
+  iree_hal_elf_shared_module_t* shared_module = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*shared_module), (void**)&shared_module);
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_initialize_from_memory(
+        executable_data, /*import_table=*/NULL, host_allocator,
+        &shared_module->module);
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(host_allocator, shared_module);
+      shared_module = NULL;
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    shared_module->ref_count = 1;
+    shared_module->length = executable_data.data_length;
+#if IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+    shared_module->hash = hash;
+    shared_module->next = cache->head;
+    cache->head = shared_module;
+#endif  // IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+    *out_shared_module = shared_module;
+  }
+
+#if IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+  iree_slim_mutex_unlock(&cache->mutex);
+#endif  // IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Releases a reference to |shared_module| and unloads it if it was the last.
+static void iree_hal_elf_shared_module_release(
+    iree_hal_elf_shared_module_t* shared_module) {
+  if (!shared_module) return;
+#if IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+  iree_hal_elf_module_cache_t* cache = iree_hal_elf_module_cache();
+  iree_slim_mutex_lock(&cache->mutex);
+  bool is_last = --shared_module->ref_count == 0;
+  if (is_last) {
+    for (iree_hal_elf_shared_module_t** it = &cache->head; *it;
+         it = &(*it)->next) {
+      if (*it == shared_module) {
+        *it = shared_module->next;
+        break;
+      }
+    }
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  if (!is_last) return;
+#endif  // IREE_HAL_EMBEDDED_ELF_LOADER_SHARE_MODULES
+  iree_elf_module_deinitialize(&shared_module->module);
+  iree_allocator_free(iree_allocator_system(), shared_module);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_elf_executable_t
 //===----------------------------------------------------------------------===//
@@ -24,8 +164,8 @@
 typedef struct iree_hal_elf_executable_t {
   iree_hal_local_executable_t base;
 
-  // Loaded ELF module.
-  iree_elf_module_t module;
+  // Loaded ELF module, possibly shared with other executables.
+  iree_hal_elf_shared_module_t* shared_module;
 
   // Name used for the file field in tracy and debuggers.
   iree_string_view_t identifier;
@@ -46,7 +186,8 @@ static iree_status_t iree_hal_elf_executable_query_library(
   // Get the exported symbol used to get the library metadata.
   iree_hal_executable_library_query_fn_t query_fn = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &executable->module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
+      &executable->shared_module->module,
+      IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
       (void**)&query_fn));
 
   // Query for a compatible version of the library.
@@ -81,6 +222,7 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
   return iree_ok_status();
 }
 
@@ -106,7 +248,9 @@ static iree_status_t iree_hal_elf_executable_create(
   iree_host_size_t total_size =
       sizeof(*executable) +
       executable_params->pipeline_layout_count * sizeof(*executable->layouts) +
-      executable_params->constant_count * sizeof(*executable_params->constants);
+      executable_params->constant_count * sizeof(*executable_params->constants) +
+      executable_params->pipeline_layout_count *
+          sizeof(*executable->base.workgroup_durations_ns);
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&executable);
   if (iree_status_is_ok(status)) {
@@ -115,6 +259,12 @@ static iree_status_t iree_hal_elf_executable_create(
         executable_params->pipeline_layout_count,
         executable_params->pipeline_layouts, &executable->layouts[0],
         host_allocator, &executable->base);
+    executable->base.workgroup_durations_ns =
+        (iree_atomic_int32_t*)((uint8_t*)executable + sizeof(*executable) +
+                               executable_params->pipeline_layout_count *
+                                   sizeof(*executable->layouts) +
+                               executable_params->constant_count *
+                                   sizeof(*executable_params->constants));
   }
 
   // Copy executable constants so we own them.
@@ -131,9 +281,8 @@ static iree_status_t iree_hal_elf_executable_create(
 
   // Attempt to load the ELF module.
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
+    status = iree_hal_elf_shared_module_acquire(
+        executable_params->executable_data, &executable->shared_module);
   }
 
   // Query metadata and get the entry point function pointers.
@@ -172,7 +321,7 @@ static void iree_hal_elf_executable_destroy(
   iree_allocator_t host_allocator = executable->base.host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_elf_module_deinitialize(&executable->module);
+  iree_hal_elf_shared_module_release(executable->shared_module);
 
   iree_hal_executable_library_deinitialize_imports(
       &executable->base.environment, host_allocator);
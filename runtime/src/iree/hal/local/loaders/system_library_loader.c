@@ -201,6 +201,7 @@ static iree_status_t iree_hal_system_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
   return iree_ok_status();
 }
 
@@ -229,7 +230,9 @@ static iree_status_t iree_hal_system_executable_create(
   iree_host_size_t total_size =
       sizeof(*executable) +
       executable_params->pipeline_layout_count * sizeof(*executable->layouts) +
-      executable_params->constant_count * sizeof(*executable_params->constants);
+      executable_params->constant_count * sizeof(*executable_params->constants) +
+      executable_params->pipeline_layout_count *
+          sizeof(*executable->base.workgroup_durations_ns);
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&executable);
   if (iree_status_is_ok(status)) {
@@ -238,6 +241,12 @@ static iree_status_t iree_hal_system_executable_create(
         executable_params->pipeline_layout_count,
         executable_params->pipeline_layouts, &executable->layouts[0],
         host_allocator, &executable->base);
+    executable->base.workgroup_durations_ns =
+        (iree_atomic_int32_t*)((uint8_t*)executable + sizeof(*executable) +
+                               executable_params->pipeline_layout_count *
+                                   sizeof(*executable->layouts) +
+                               executable_params->constant_count *
+                                   sizeof(*executable_params->constants));
   }
 
   // Copy executable constants so we own them.
@@ -251,9 +251,13 @@ static iree_status_t iree_hal_vmvx_executable_create(
                       8);
   const iree_host_size_t worker_states_size =
       iree_host_align(worker_capacity * sizeof(*executable->worker_states), 8);
+  const iree_host_size_t workgroup_durations_size =
+      iree_host_align(executable_params->pipeline_layout_count *
+                          sizeof(*executable->base.workgroup_durations_ns),
+                      8);
   const iree_host_size_t total_size =
       sizeof(*executable) + entry_fn_ordinals_size + dispatch_attrs_size +
-      pipeline_layouts_size + worker_states_size;
+      pipeline_layouts_size + worker_states_size + workgroup_durations_size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&executable);
   iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs = NULL;
@@ -275,6 +279,8 @@ static iree_status_t iree_hal_vmvx_executable_create(
     executable->worker_capacity = worker_capacity;
     executable->worker_states = (iree_hal_vmvx_worker_state_t*)ptr;
     ptr += worker_states_size;
+    executable->base.workgroup_durations_ns = (iree_atomic_int32_t*)ptr;
+    ptr += workgroup_durations_size;
 
     executable->bytecode_module = bytecode_module;
     executable->entry_fn_count = entry_count;
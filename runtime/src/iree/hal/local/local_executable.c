@@ -27,6 +27,8 @@ void iree_hal_local_executable_initialize(
 
   // Function attributes are optional and populated by the parent type.
   out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->workgroup_durations_ns = NULL;
+  out_base_executable->export_names = NULL;
 
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
@@ -46,6 +48,14 @@ iree_hal_local_executable_t* iree_hal_local_executable_cast(
   return (iree_hal_local_executable_t*)base_value;
 }
 
+iree_status_t iree_hal_local_executable_resolve(
+    iree_hal_local_executable_t* executable) {
+  IREE_ASSERT_ARGUMENT(executable);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  return vtable->resolve ? vtable->resolve(executable) : iree_ok_status();
+}
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -60,6 +70,20 @@ iree_status_t iree_hal_local_executable_issue_call(
                    worker_id);
 }
 
+iree_hal_executable_dispatch_flags_v0_t
+iree_hal_local_executable_dispatch_flags(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  return executable->dispatch_attrs ? executable->dispatch_attrs[ordinal].flags
+                                    : IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE;
+}
+
+bool iree_hal_local_executable_supports_workgroup_ranges(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  return executable->dispatch_attrs &&
+         (executable->dispatch_attrs[ordinal].flags &
+          IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE) != 0;
+}
+
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -84,10 +108,37 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
 
   iree_status_t status = iree_ok_status();
 
+  // Entry points handling the whole dispatch are called once.
+  if (iree_hal_local_executable_dispatch_flags(executable, ordinal) &
+      IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH) {
+    if (workgroup_count_x && workgroup_count_y && workgroup_count_z) {
+      iree_alignas(64)
+          iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+              .workgroup_range_count = 1,
+              .processor_id = processor_id,
+              .local_memory = local_memory.data,
+              .local_memory_size = (size_t)local_memory.data_length,
+          };
+      status = iree_hal_local_executable_issue_call(
+          executable, ordinal, dispatch_state, &workgroup_state,
+          /*worker_id=*/0);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Entry points handling workgroup ranges are issued once per row (or chunk
+  // of a row if it exceeds the range count limit).
+  const uint32_t workgroup_step =
+      iree_hal_local_executable_supports_workgroup_ranges(executable, ordinal)
+          ? UINT16_MAX
+          : 1;
+
   iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
       .workgroup_id_x = 0,
       .workgroup_id_y = 0,
       .workgroup_id_z = 0,
+      .workgroup_range_count = 1,
       .processor_id = processor_id,
       .local_memory = local_memory.data,
       .local_memory_size = (size_t)local_memory.data_length,
@@ -96,8 +147,10 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     workgroup_state.workgroup_id_z = z;
     for (uint32_t y = 0; y < workgroup_count_y; ++y) {
       workgroup_state.workgroup_id_y = y;
-      for (uint32_t x = 0; x < workgroup_count_x; ++x) {
+      for (uint32_t x = 0; x < workgroup_count_x; x += workgroup_step) {
         workgroup_state.workgroup_id_x = x;
+        workgroup_state.workgroup_range_count =
+            (uint16_t)iree_min(workgroup_step, workgroup_count_x - x);
         status = iree_hal_local_executable_issue_call(
             executable, ordinal, dispatch_state, &workgroup_state,
             /*worker_id=*/0);
@@ -109,3 +162,105 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+// Tasks per worker used to balance workgroups of uneven cost.
+#define IREE_HAL_LOCAL_EXECUTABLE_PARALLEL_TASKS_PER_WORKER 4
+
+typedef struct iree_hal_local_executable_parallel_dispatch_t {
+  iree_hal_local_executable_t* executable;
+  iree_host_size_t ordinal;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state;
+  uint32_t processor_id;
+  // Maximum number of workgroups along X issued per call.
+  uint32_t workgroup_step;
+  // Total number of workgroups in the dispatch.
+  uint64_t workgroup_total;
+  // Number of consecutive workgroups (in linear XYZ order) per task.
+  uint64_t workgroups_per_task;
+} iree_hal_local_executable_parallel_dispatch_t;
+
+static iree_status_t IREE_API_PTR iree_hal_local_executable_issue_task(
+    void* task_context, uint32_t task_index, uint32_t worker_id) {
+  const iree_hal_local_executable_parallel_dispatch_t* dispatch =
+      (const iree_hal_local_executable_parallel_dispatch_t*)task_context;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+      dispatch->dispatch_state;
+  const uint32_t workgroup_count_x = dispatch_state->workgroup_count_x;
+  const uint32_t workgroup_count_y = dispatch_state->workgroup_count_y;
+  const uint64_t begin = task_index * dispatch->workgroups_per_task;
+  const uint64_t end = iree_min(begin + dispatch->workgroups_per_task,
+                                dispatch->workgroup_total);
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_range_count = 1,
+      .processor_id = dispatch->processor_id,
+      .local_memory = NULL,
+      .local_memory_size = 0,
+  };
+  iree_status_t status = iree_ok_status();
+  for (uint64_t i = begin; i < end && iree_status_is_ok(status);) {
+    const uint32_t x = (uint32_t)(i % workgroup_count_x);
+    const uint64_t yz = i / workgroup_count_x;
+    workgroup_state.workgroup_id_x = x;
+    workgroup_state.workgroup_id_y = (uint32_t)(yz % workgroup_count_y);
+    workgroup_state.workgroup_id_z = (uint32_t)(yz / workgroup_count_y);
+    // Ranges never cross rows or the end of the task.
+    const uint64_t range = iree_min(
+        iree_min(dispatch->workgroup_step, workgroup_count_x - x), end - i);
+    workgroup_state.workgroup_range_count = (uint16_t)range;
+    status = iree_hal_local_executable_issue_call(
+        dispatch->executable, dispatch->ordinal, dispatch_state,
+        &workgroup_state, worker_id);
+    i += range;
+  }
+  return status;
+}
+
+iree_status_t iree_hal_local_executable_issue_dispatch_parallel(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    uint32_t processor_id, const iree_hal_parallel_for_t* parallel_for) {
+  IREE_ASSERT_ARGUMENT(executable);
+  IREE_ASSERT_ARGUMENT(dispatch_state);
+  IREE_ASSERT_ARGUMENT(parallel_for);
+
+  const uint64_t workgroup_total = (uint64_t)dispatch_state->workgroup_count_x *
+                                   dispatch_state->workgroup_count_y *
+                                   dispatch_state->workgroup_count_z;
+  const bool requires_local_memory =
+      executable->dispatch_attrs &&
+      executable->dispatch_attrs[ordinal].local_memory_pages > 0;
+  if (parallel_for->worker_count <= 1 || workgroup_total <= 1 ||
+      requires_local_memory ||
+      (iree_hal_local_executable_dispatch_flags(executable, ordinal) &
+       IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WHOLE_DISPATCH)) {
+    return iree_hal_local_executable_issue_dispatch_inline(
+        executable, ordinal, dispatch_state, processor_id,
+        iree_byte_span_empty());
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const uint64_t max_task_count =
+      (uint64_t)parallel_for->worker_count *
+      IREE_HAL_LOCAL_EXECUTABLE_PARALLEL_TASKS_PER_WORKER;
+  const uint32_t task_count =
+      (uint32_t)iree_min(workgroup_total, max_task_count);
+  iree_hal_local_executable_parallel_dispatch_t dispatch = {
+      .executable = executable,
+      .ordinal = ordinal,
+      .dispatch_state = dispatch_state,
+      .processor_id = processor_id,
+      .workgroup_step =
+          iree_hal_local_executable_supports_workgroup_ranges(executable,
+                                                              ordinal)
+              ? UINT16_MAX
+              : 1,
+      .workgroup_total = workgroup_total,
+      .workgroups_per_task = (workgroup_total + task_count - 1) / task_count,
+  };
+  iree_status_t status = parallel_for->fn(
+      parallel_for->self, task_count, iree_hal_local_executable_issue_task,
+      &dispatch);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
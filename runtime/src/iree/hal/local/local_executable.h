@@ -8,6 +8,7 @@
 #define IREE_HAL_LOCAL_LOCAL_EXECUTABLE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
 
@@ -32,9 +33,19 @@ typedef struct iree_hal_local_executable_t {
   // Defines per-entry point how much workgroup local memory is required.
   // Contains entries with 0 to indicate no local memory is required or >0 in
   // units of IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE for the minimum amount
-  // of memory required by the function.
+  // of memory required by the function. Also carries the dispatch flags.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional per-entry point running estimate of the duration of a single
+  // workgroup in nanoseconds used by schedulers to size work reservations.
+  // Contains 0 for entry points that have not yet been measured. Populated by
+  // the parent type with pipeline_layout_count entries.
+  iree_atomic_int32_t* workgroup_durations_ns;
+
+  // Optional per-entry point export names used when profiling dispatches.
+  // NULL if the executable does not carry names for its exports.
+  const char* const* export_names;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
 } iree_hal_local_executable_t;
@@ -47,6 +58,11 @@ typedef struct iree_hal_local_executable_vtable_t {
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
       uint32_t worker_id);
+
+  // Optional; ensures the executable is loaded and that the base fields such
+  // as dispatch_attrs are populated. Executables that are fully loaded upon
+  // creation can leave this NULL.
+  iree_status_t(IREE_API_PTR* resolve)(iree_hal_local_executable_t* executable);
 } iree_hal_local_executable_vtable_t;
 
 // Initializes the local executable base type.
@@ -67,6 +83,21 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+// Ensures |executable| is loaded and ready for dispatch. Must be called prior
+// to accessing the executable dispatch_attrs or workgroup_durations_ns.
+iree_status_t iree_hal_local_executable_resolve(
+    iree_hal_local_executable_t* executable);
+
+// Returns true if the entry point at |ordinal| can execute a range of
+// workgroups per call (IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE).
+// Returns the IREE_HAL_EXECUTABLE_DISPATCH_FLAG_* bits of the export |ordinal|.
+iree_hal_executable_dispatch_flags_v0_t
+iree_hal_local_executable_dispatch_flags(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
+bool iree_hal_local_executable_supports_workgroup_ranges(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -78,6 +109,34 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     uint32_t processor_id, iree_byte_span_t local_memory);
 
+// Executes a single task of a parallel-for on the worker |worker_id|.
+typedef iree_status_t(IREE_API_PTR* iree_hal_parallel_for_task_fn_t)(
+    void* task_context, uint32_t task_index, uint32_t worker_id);
+
+// A hosting application-provided parallel-for used to distribute the
+// workgroups of inline dispatches across threads without a task system.
+typedef struct iree_hal_parallel_for_t {
+  // Calls |task_fn| once for each task index in [0, task_count), possibly
+  // concurrently from up to worker_count threads each with a unique worker ID
+  // in [0, worker_count). Must only return after all calls have completed and
+  // returns the first failure, if any. The calling thread may execute tasks.
+  iree_status_t(IREE_API_PTR* fn)(void* self, uint32_t task_count,
+                                  iree_hal_parallel_for_task_fn_t task_fn,
+                                  void* task_context);
+  void* self;
+  // Maximum number of threads that may execute tasks concurrently.
+  uint32_t worker_count;
+} iree_hal_parallel_for_t;
+
+// Issues the dispatch with its workgroups distributed across the workers of
+// |parallel_for|. Exports that handle the whole dispatch themselves or that
+// require workgroup local memory are issued inline on the calling thread.
+// |dispatch_state| max_concurrency should match the parallel_for worker_count.
+iree_status_t iree_hal_local_executable_issue_dispatch_parallel(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    uint32_t processor_id, const iree_hal_parallel_for_t* parallel_for);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
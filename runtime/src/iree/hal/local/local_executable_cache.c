@@ -8,12 +8,179 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/hal/local/lazy_executable.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_prefetcher_t
+//===----------------------------------------------------------------------===//
+
+// Background thread resolving lazy executables in the order they were
+// prepared. Executables are retained while queued so that they may be
+// released by the application at any time.
+typedef struct iree_hal_local_executable_prefetcher_t {
+  iree_allocator_t host_allocator;
+  iree_thread_t* thread;
+  // Posted when executables are queued or the prefetcher is shutting down.
+  iree_notification_t notification;
+  iree_slim_mutex_t mutex;
+  // Set when the thread should exit without resolving remaining executables.
+  bool exit_requested IREE_GUARDED_BY(mutex);
+  // FIFO ring of pending executables.
+  iree_host_size_t head IREE_GUARDED_BY(mutex);
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+  iree_host_size_t capacity IREE_GUARDED_BY(mutex);
+  iree_hal_executable_t** queue IREE_GUARDED_BY(mutex);
+} iree_hal_local_executable_prefetcher_t;
+
+static bool iree_hal_local_executable_prefetcher_has_work(void* arg) {
+  iree_hal_local_executable_prefetcher_t* prefetcher =
+      (iree_hal_local_executable_prefetcher_t*)arg;
+  iree_slim_mutex_lock(&prefetcher->mutex);
+  bool has_work = prefetcher->exit_requested || prefetcher->count > 0;
+  iree_slim_mutex_unlock(&prefetcher->mutex);
+  return has_work;
+}
+
+static int iree_hal_local_executable_prefetcher_main(void* arg) {
+  iree_hal_local_executable_prefetcher_t* prefetcher =
+      (iree_hal_local_executable_prefetcher_t*)arg;
+  for (;;) {
+    iree_notification_await(&prefetcher->notification,
+                            iree_hal_local_executable_prefetcher_has_work,
+                            prefetcher, iree_infinite_timeout());
+    iree_slim_mutex_lock(&prefetcher->mutex);
+    if (prefetcher->exit_requested) {
+      iree_slim_mutex_unlock(&prefetcher->mutex);
+      break;
+    }
+    iree_hal_executable_t* executable = prefetcher->queue[prefetcher->head];
+    prefetcher->head = (prefetcher->head + 1) % prefetcher->capacity;
+    --prefetcher->count;
+    iree_slim_mutex_unlock(&prefetcher->mutex);
+
+    // Errors are sticky on the executable and reported at first dispatch.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_hal_local_executable_prefetch");
+    iree_status_ignore(iree_hal_local_executable_resolve(
+        iree_hal_local_executable_cast(executable)));
+    iree_hal_executable_release(executable);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  return 0;
+}
+
+static iree_status_t iree_hal_local_executable_prefetcher_create(
+    iree_allocator_t host_allocator,
+    iree_hal_local_executable_prefetcher_t** out_prefetcher) {
+  *out_prefetcher = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_executable_prefetcher_t* prefetcher = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*prefetcher),
+                                (void**)&prefetcher));
+  memset(prefetcher, 0, sizeof(*prefetcher));
+  prefetcher->host_allocator = host_allocator;
+  iree_notification_initialize(&prefetcher->notification);
+  iree_slim_mutex_initialize(&prefetcher->mutex);
+
+  iree_thread_create_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.name = IREE_SV("iree-hal-prefetch");
+  params.priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+  iree_status_t status = iree_thread_create(
+      iree_hal_local_executable_prefetcher_main, prefetcher, params,
+      host_allocator, &prefetcher->thread);
+
+  if (iree_status_is_ok(status)) {
+    *out_prefetcher = prefetcher;
+  } else {
+    iree_slim_mutex_deinitialize(&prefetcher->mutex);
+    iree_notification_deinitialize(&prefetcher->notification);
+    iree_allocator_free(host_allocator, prefetcher);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_local_executable_prefetcher_destroy(
+    iree_hal_local_executable_prefetcher_t* prefetcher) {
+  if (!prefetcher) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Request exit and join the thread. Any in-flight resolution completes.
+  iree_slim_mutex_lock(&prefetcher->mutex);
+  prefetcher->exit_requested = true;
+  iree_slim_mutex_unlock(&prefetcher->mutex);
+  iree_notification_post(&prefetcher->notification, IREE_ALL_WAITERS);
+  iree_thread_release(prefetcher->thread);
+
+  // Drop executables that were never prefetched; they will load on demand.
+  for (iree_host_size_t i = 0; i < prefetcher->count; ++i) {
+    iree_hal_executable_release(
+        prefetcher->queue[(prefetcher->head + i) % prefetcher->capacity]);
+  }
+  iree_allocator_free(prefetcher->host_allocator, prefetcher->queue);
+
+  iree_slim_mutex_deinitialize(&prefetcher->mutex);
+  iree_notification_deinitialize(&prefetcher->notification);
+  iree_allocator_free(prefetcher->host_allocator, prefetcher);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Queues |executable| for background resolution and retains it until resolved.
+static iree_status_t iree_hal_local_executable_prefetcher_enqueue(
+    iree_hal_local_executable_prefetcher_t* prefetcher,
+    iree_hal_executable_t* executable) {
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&prefetcher->mutex);
+  if (prefetcher->count == prefetcher->capacity) {
+    // Grow the ring and linearize the existing entries.
+    iree_host_size_t new_capacity = iree_max(16, prefetcher->capacity * 2);
+    iree_hal_executable_t** new_queue = NULL;
+    status = iree_allocator_malloc(prefetcher->host_allocator,
+                                   new_capacity * sizeof(*new_queue),
+                                   (void**)&new_queue);
+    if (iree_status_is_ok(status)) {
+      for (iree_host_size_t i = 0; i < prefetcher->count; ++i) {
+        new_queue[i] =
+            prefetcher->queue[(prefetcher->head + i) % prefetcher->capacity];
+      }
+      iree_allocator_free(prefetcher->host_allocator, prefetcher->queue);
+      prefetcher->queue = new_queue;
+      prefetcher->capacity = new_capacity;
+      prefetcher->head = 0;
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_executable_retain(executable);
+    prefetcher->queue[(prefetcher->head + prefetcher->count) %
+                      prefetcher->capacity] = executable;
+    ++prefetcher->count;
+  }
+  iree_slim_mutex_unlock(&prefetcher->mutex);
+  if (iree_status_is_ok(status)) {
+    iree_notification_post(&prefetcher->notification, IREE_ALL_WAITERS);
+  }
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_t
+//===----------------------------------------------------------------------===//
 
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
   iree_host_size_t worker_capacity;
+  iree_hal_local_executable_cache_flags_t flags;
+  // Optional background prefetcher when IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_
+  // PREFETCH is set.
+  iree_hal_local_executable_prefetcher_t* prefetcher;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_local_executable_cache_t;
@@ -29,6 +196,7 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_hal_local_executable_cache_flags_t flags,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
@@ -38,6 +206,10 @@ iree_status_t iree_hal_local_executable_cache_create(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (iree_all_bits_set(flags, IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_PREFETCH)) {
+    flags |= IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_LAZY_LOAD;
+  }
+
   iree_hal_local_executable_cache_t* executable_cache = NULL;
   iree_host_size_t total_size =
       sizeof(*executable_cache) +
@@ -52,14 +224,27 @@ iree_status_t iree_hal_local_executable_cache_create(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
     executable_cache->worker_capacity = worker_capacity;
+    executable_cache->flags = flags;
+    executable_cache->prefetcher = NULL;
 
     executable_cache->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
       executable_cache->loaders[i] = loaders[i];
       iree_hal_executable_loader_retain(executable_cache->loaders[i]);
     }
+  }
+
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(flags, IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_PREFETCH)) {
+    status = iree_hal_local_executable_prefetcher_create(
+        host_allocator, &executable_cache->prefetcher);
+  }
 
+  if (iree_status_is_ok(status)) {
     *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
+  } else {
+    iree_hal_executable_cache_release(
+        (iree_hal_executable_cache_t*)executable_cache);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -73,6 +258,7 @@ static void iree_hal_local_executable_cache_destroy(
   iree_allocator_t host_allocator = executable_cache->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_local_executable_prefetcher_destroy(executable_cache->prefetcher);
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     iree_hal_executable_loader_release(executable_cache->loaders[i]);
   }
@@ -102,6 +288,25 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
     iree_hal_executable_t** out_executable) {
   iree_hal_local_executable_cache_t* executable_cache =
       iree_hal_local_executable_cache_cast(base_executable_cache);
+
+  if (iree_all_bits_set(executable_cache->flags,
+                        IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_LAZY_LOAD)) {
+    IREE_RETURN_IF_ERROR(iree_hal_lazy_executable_create(
+        executable_params, executable_cache->worker_capacity,
+        executable_cache->loader_count, executable_cache->loaders,
+        executable_cache->host_allocator, out_executable));
+    if (executable_cache->prefetcher) {
+      iree_status_t status = iree_hal_local_executable_prefetcher_enqueue(
+          executable_cache->prefetcher, *out_executable);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_executable_release(*out_executable);
+        *out_executable = NULL;
+      }
+      return status;
+    }
+    return iree_ok_status();
+  }
+
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     if (!iree_hal_executable_loader_query_support(
             executable_cache->loaders[i], executable_params->caching_mode,
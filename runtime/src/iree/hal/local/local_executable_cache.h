@@ -23,8 +23,26 @@ extern "C" {
 // one device is the same JIT'ed executable in another, and in multi-tenant
 // situations we're likely to want that isolation _and_ sharing.
 
+// Controls executable cache behavior.
+enum iree_hal_local_executable_cache_flag_bits_t {
+  IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_NONE = 0u,
+  // Defers loading executables until they are first used in a dispatch.
+  // Preparing an executable only validates that a loader may support it and
+  // load errors are reported when recording the first dispatch instead.
+  IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_LAZY_LOAD = 1u << 0,
+  // Loads lazily prepared executables on a low-priority background thread so
+  // that most are resolved by the time they are first dispatched.
+  // Implies IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_LAZY_LOAD.
+  IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_PREFETCH = 1u << 1,
+};
+typedef uint32_t iree_hal_local_executable_cache_flags_t;
+
+// Creates an executable cache that loads executables with the first of
+// |loaders| that supports them. |worker_capacity| is passed to loaders to size
+// per-worker executable state.
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_hal_local_executable_cache_flags_t flags,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
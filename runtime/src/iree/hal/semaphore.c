@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 
+#include "iree/base/internal/metrics.h"
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
 
@@ -68,13 +69,28 @@ IREE_API_EXPORT void iree_hal_semaphore_fail(iree_hal_semaphore_t* semaphore,
   IREE_TRACE_ZONE_END(z0);
 }
 
+IREE_METRIC_STATIC(iree_hal_semaphore_wait_duration_metric,
+                   IREE_METRIC_KIND_HISTOGRAM,
+                   "iree_hal_semaphore_wait_duration_ns",
+                   "Time host threads spent blocked waiting on semaphores.");
+
+IREE_API_EXPORT void iree_hal_semaphore_record_wait_duration(
+    iree_time_t start_time_ns) {
+  iree_metric_record(&iree_hal_semaphore_wait_duration_metric,
+                     iree_time_now() - start_time_ns);
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_semaphore_wait(
     iree_hal_semaphore_t* semaphore, uint64_t value, iree_timeout_t timeout) {
   IREE_ASSERT_ARGUMENT(semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, value);
+  // Polls are not waits and are excluded from the wait duration metric.
+  const bool is_blocking = !iree_timeout_is_immediate(timeout);
+  const iree_time_t start_time_ns = is_blocking ? iree_time_now() : 0;
   iree_status_t status =
       _VTABLE_DISPATCH(semaphore, wait)(semaphore, value, timeout);
+  if (is_blocking) iree_hal_semaphore_record_wait_duration(start_time_ns);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
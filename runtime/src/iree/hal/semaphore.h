@@ -210,6 +210,11 @@ IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_semaphore_vtable_t);
 IREE_API_EXPORT void iree_hal_semaphore_destroy(
     iree_hal_semaphore_t* semaphore);
 
+// Records a host wait that began at |start_time_ns| and just completed to the
+// process-wide semaphore wait duration metric.
+IREE_API_EXPORT void iree_hal_semaphore_record_wait_duration(
+    iree_time_t start_time_ns);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
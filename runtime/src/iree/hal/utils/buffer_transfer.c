@@ -6,6 +6,8 @@
 
 #include "iree/hal/utils/buffer_transfer.h"
 
+#include "iree/base/internal/math.h"
+
 //===----------------------------------------------------------------------===//
 // Transfer utilities
 //===----------------------------------------------------------------------===//
@@ -95,11 +97,173 @@ static iree_status_t iree_hal_device_transfer_and_wait(
 // iree_hal_device_transfer_range implementations
 //===----------------------------------------------------------------------===//
 
+//===----------------------------------------------------------------------===//
+// iree_hal_transfer_staging_pool_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_initialize(
+    iree_hal_transfer_staging_pool_t* out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  memset(out_pool, 0, sizeof(*out_pool));
+  iree_slim_mutex_initialize(&out_pool->mutex);
+}
+
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_deinitialize(
+    iree_hal_transfer_staging_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(pool->slots); ++i) {
+    IREE_ASSERT(!pool->slots[i].in_use, "staging buffer still in use");
+    iree_hal_buffer_release(pool->slots[i].buffer);
+  }
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  memset(pool, 0, sizeof(*pool));
+}
+
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_trim(
+    iree_hal_transfer_staging_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_hal_buffer_t* trimmed_buffers[IREE_HAL_TRANSFER_STAGING_POOL_CAPACITY];
+  iree_host_size_t trimmed_count = 0;
+  iree_slim_mutex_lock(&pool->mutex);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(pool->slots); ++i) {
+    if (pool->slots[i].in_use || !pool->slots[i].buffer) continue;
+    trimmed_buffers[trimmed_count++] = pool->slots[i].buffer;
+    pool->slots[i].buffer = NULL;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  for (iree_host_size_t i = 0; i < trimmed_count; ++i) {
+    iree_hal_buffer_release(trimmed_buffers[i]);
+  }
+}
+
+static iree_status_t iree_hal_allocate_staging_buffer(
+    iree_hal_device_t* device, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  // TODO(benvanik): make this device-local + host-visible? can be better for
+  // uploads as we know we are never going to read it back.
+  const iree_hal_buffer_params_t params = {
+      .type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  return iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(device),
+                                            params, allocation_size,
+                                            out_buffer);
+}
+
+// Acquires a staging buffer of at least |length| bytes from |pool|, if any.
+// |out_slot| receives the pool slot that must be passed to
+// iree_hal_transfer_staging_pool_release or -1 if the buffer is transient.
+static iree_status_t iree_hal_transfer_staging_pool_acquire(
+    iree_hal_transfer_staging_pool_t* pool, iree_hal_device_t* device,
+    iree_device_size_t length, iree_hal_buffer_t** out_buffer, int* out_slot) {
+  *out_buffer = NULL;
+  *out_slot = -1;
+  if (!pool || length > IREE_HAL_TRANSFER_STAGING_POOL_MAX_BUFFER_SIZE) {
+    return iree_hal_allocate_staging_buffer(device, length, out_buffer);
+  }
+
+  // Prefer the smallest idle buffer that fits and otherwise claim an idle slot
+  // (preferring empty ones) to hold a newly allocated buffer.
+  int fit_slot = -1;
+  int free_slot = -1;
+  iree_slim_mutex_lock(&pool->mutex);
+  for (int i = 0; i < (int)IREE_ARRAYSIZE(pool->slots); ++i) {
+    if (pool->slots[i].in_use) continue;
+    iree_hal_buffer_t* buffer = pool->slots[i].buffer;
+    if (!buffer) {
+      free_slot = i;
+    } else if (iree_hal_buffer_byte_length(buffer) >= length) {
+      if (fit_slot == -1 ||
+          iree_hal_buffer_byte_length(buffer) <
+              iree_hal_buffer_byte_length(pool->slots[fit_slot].buffer)) {
+        fit_slot = i;
+      }
+    } else if (free_slot == -1 || pool->slots[free_slot].buffer) {
+      free_slot = i;
+    }
+  }
+  int slot = fit_slot != -1 ? fit_slot : free_slot;
+  iree_hal_buffer_t* evicted_buffer = NULL;
+  if (slot != -1) {
+    pool->slots[slot].in_use = true;
+    if (slot == fit_slot) {
+      *out_buffer = pool->slots[slot].buffer;
+    } else {
+      evicted_buffer = pool->slots[slot].buffer;
+      pool->slots[slot].buffer = NULL;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_hal_buffer_release(evicted_buffer);
+
+  if (slot == -1) {
+    // All slots are in use by other transfers.
+    return iree_hal_allocate_staging_buffer(device, length, out_buffer);
+  } else if (*out_buffer) {
+    *out_slot = slot;
+    return iree_ok_status();
+  }
+
+  // Allocate a new pooled buffer outside of the lock. The slot remains claimed
+  // so no other transfer will touch it.
+  iree_device_size_t allocation_size = iree_max(
+      IREE_HAL_TRANSFER_STAGING_POOL_MIN_BUFFER_SIZE,
+      iree_math_round_up_to_pow2_u64((uint64_t)length));
+  allocation_size =
+      iree_min(allocation_size, IREE_HAL_TRANSFER_STAGING_POOL_MAX_BUFFER_SIZE);
+  iree_status_t status =
+      iree_hal_allocate_staging_buffer(device, allocation_size, out_buffer);
+  iree_slim_mutex_lock(&pool->mutex);
+  if (iree_status_is_ok(status)) {
+    pool->slots[slot].buffer = *out_buffer;
+    *out_slot = slot;
+  } else {
+    pool->slots[slot].in_use = false;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  return status;
+}
+
+// Returns |buffer| acquired from |slot| of |pool|. Buffers are only reused if
+// |is_idle| indicates the transfer using them completed; otherwise (such as
+// when the wait timed out) the device may still be accessing the buffer and it
+// is evicted from the pool with the in-flight work retaining it.
+static void iree_hal_transfer_staging_pool_release(
+    iree_hal_transfer_staging_pool_t* pool, iree_hal_buffer_t* buffer,
+    int slot, bool is_idle) {
+  if (slot == -1) {
+    iree_hal_buffer_release(buffer);
+    return;
+  }
+  iree_slim_mutex_lock(&pool->mutex);
+  if (!is_idle) pool->slots[slot].buffer = NULL;
+  pool->slots[slot].in_use = false;
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (!is_idle) iree_hal_buffer_release(buffer);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_device_transfer_range implementations
+//===----------------------------------------------------------------------===//
+
 IREE_API_EXPORT iree_status_t iree_hal_device_submit_transfer_range_and_wait(
     iree_hal_device_t* device, iree_hal_transfer_buffer_t source,
     iree_device_size_t source_offset, iree_hal_transfer_buffer_t target,
     iree_device_size_t target_offset, iree_device_size_t data_length,
     iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  return iree_hal_device_submit_transfer_range_and_wait_with_staging_pool(
+      device, /*staging_pool=*/NULL, source, source_offset, target,
+      target_offset, data_length, flags, timeout);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_hal_device_submit_transfer_range_and_wait_with_staging_pool(
+    iree_hal_device_t* device, iree_hal_transfer_staging_pool_t* staging_pool,
+    iree_hal_transfer_buffer_t source, iree_device_size_t source_offset,
+    iree_hal_transfer_buffer_t target, iree_device_size_t target_offset,
+    iree_device_size_t data_length, iree_hal_transfer_buffer_flags_t flags,
+    iree_timeout_t timeout) {
   // If the source and target are both mappable into host memory (or are host
   // memory) then we can use the fast zero-alloc path. This may actually be
   // slower than doing a device queue transfer depending on the size of the data
@@ -148,45 +312,33 @@ IREE_API_EXPORT iree_status_t iree_hal_device_submit_transfer_range_and_wait(
 
   iree_status_t status = iree_ok_status();
 
-  // Allocate the staging buffer for upload to the device.
+  // Acquire the staging buffer for upload to the device.
   iree_hal_buffer_t* source_buffer = source.device_buffer;
+  int source_slot = -1;
   if (!source_buffer) {
-    // Allocate staging memory with a copy of the host data. We only initialize
-    // the portion being transferred.
+    // Stage a copy of the host data. We only initialize the portion being
+    // transferred.
     // TODO(benvanik): use import if supported to avoid the allocation/copy.
-    // TODO(benvanik): make this device-local + host-visible? can be better for
-    // uploads as we know we are never going to read it back.
-    const iree_hal_buffer_params_t source_params = {
-        .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-                IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
-        .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
-    };
-    status = iree_hal_allocator_allocate_buffer(
-        iree_hal_device_allocator(device), source_params, data_length,
-        &source_buffer);
-    source_offset = 0;
+    status = iree_hal_transfer_staging_pool_acquire(
+        staging_pool, device, data_length, &source_buffer, &source_slot);
     if (iree_status_is_ok(status)) {
       status = iree_hal_device_transfer_h2d(
-          device, source.host_buffer.data + source_offset, source_buffer, 0,
-          data_length, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+          device, (const uint8_t*)source.host_buffer.data + source_offset,
+          source_buffer, 0, data_length, IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
           iree_infinite_timeout());
     }
+    source_offset = 0;
   }
 
-  // Allocate the staging buffer for download from the device.
+  // Acquire the staging buffer for download from the device.
   iree_hal_buffer_t* target_buffer = target.device_buffer;
+  int target_slot = -1;
   if (iree_status_is_ok(status) && !target_buffer) {
-    // Allocate uninitialized staging memory for the transfer target.
-    // We only allocate enough for the portion we are transfering.
+    // Staging memory is uninitialized and only the portion we are transferring
+    // is read back.
     // TODO(benvanik): use import if supported to avoid the allocation/copy.
-    const iree_hal_buffer_params_t target_params = {
-        .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-                IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
-        .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
-    };
-    status = iree_hal_allocator_allocate_buffer(
-        iree_hal_device_allocator(device), target_params, data_length,
-        &target_buffer);
+    status = iree_hal_transfer_staging_pool_acquire(
+        staging_pool, device, data_length, &target_buffer, &target_slot);
     target_offset = 0;
   }
 
@@ -214,9 +366,16 @@ IREE_API_EXPORT iree_status_t iree_hal_device_submit_transfer_range_and_wait(
                                       data_length);
   }
 
-  // Discard staging buffers, if they were required.
-  if (!source.device_buffer) iree_hal_buffer_release(source_buffer);
-  if (!target.device_buffer) iree_hal_buffer_release(target_buffer);
+  // Return staging buffers, if they were required.
+  bool is_idle = iree_status_is_ok(status);
+  if (!source.device_buffer && source_buffer) {
+    iree_hal_transfer_staging_pool_release(staging_pool, source_buffer,
+                                           source_slot, is_idle);
+  }
+  if (!target.device_buffer && target_buffer) {
+    iree_hal_transfer_staging_pool_release(staging_pool, target_buffer,
+                                           target_slot, is_idle);
+  }
 
   return status;
 }
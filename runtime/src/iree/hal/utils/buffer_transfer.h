@@ -8,12 +8,63 @@
 #define IREE_HAL_UTILS_BUFFER_TRANSFER_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// iree_hal_transfer_staging_pool_t
+//===----------------------------------------------------------------------===//
+
+// Maximum number of staging buffers retained by a pool. Each concurrent
+// transfer requiring staging holds one buffer for its duration and transfers
+// beyond this count fall back to transient allocations.
+#define IREE_HAL_TRANSFER_STAGING_POOL_CAPACITY 4
+
+// Smallest staging buffer allocated by a pool. Requests are rounded up to a
+// power of two no smaller than this so that buffers can be reused across
+// transfers of varying sizes.
+#define IREE_HAL_TRANSFER_STAGING_POOL_MIN_BUFFER_SIZE (64 * 1024)
+
+// Largest staging buffer retained by a pool. Larger transfers use transient
+// staging buffers to avoid pinning large amounts of host memory indefinitely.
+#define IREE_HAL_TRANSFER_STAGING_POOL_MAX_BUFFER_SIZE (64 * 1024 * 1024)
+
+// A small cache of host-local device-visible staging buffers reused across
+// transfers to and from host memory. Allocating staging memory is expensive on
+// most devices (pinning host pages, registering them with the driver, etc) and
+// the synchronous transfer path would otherwise do it for every transfer.
+//
+// Staging buffers are only returned to the pool once the transfer using them
+// has completed and thus are never shared with in-flight device work.
+//
+// Thread-safe.
+typedef struct iree_hal_transfer_staging_pool_t {
+  iree_slim_mutex_t mutex;
+  struct {
+    // Retained staging buffer or NULL if the slot has not been populated.
+    iree_hal_buffer_t* buffer;
+    // True while a transfer is using the buffer.
+    bool in_use;
+  } slots[IREE_HAL_TRANSFER_STAGING_POOL_CAPACITY];
+} iree_hal_transfer_staging_pool_t;
+
+// Initializes an empty staging pool. Buffers are allocated on demand.
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_initialize(
+    iree_hal_transfer_staging_pool_t* out_pool);
+
+// Deinitializes |pool| and releases all staging buffers.
+// No transfers may be using the pool.
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_deinitialize(
+    iree_hal_transfer_staging_pool_t* pool);
+
+// Releases all staging buffers not currently in use by a transfer.
+IREE_API_EXPORT void iree_hal_transfer_staging_pool_trim(
+    iree_hal_transfer_staging_pool_t* pool);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_device_transfer_range implementations
 //===----------------------------------------------------------------------===//
@@ -30,6 +81,21 @@ IREE_API_EXPORT iree_status_t iree_hal_device_submit_transfer_range_and_wait(
     iree_device_size_t target_offset, iree_device_size_t data_length,
     iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout);
 
+// Performs a full transfer operation as with
+// iree_hal_device_submit_transfer_range_and_wait using staging buffers from
+// |staging_pool| when the source or target is host memory. The pool must be
+// owned by |device| and is used as the staging buffers are allocated from the
+// device allocator. A NULL |staging_pool| allocates transient staging buffers.
+//
+// Precondition: source and target do not overlap.
+IREE_API_EXPORT iree_status_t
+iree_hal_device_submit_transfer_range_and_wait_with_staging_pool(
+    iree_hal_device_t* device, iree_hal_transfer_staging_pool_t* staging_pool,
+    iree_hal_transfer_buffer_t source, iree_device_size_t source_offset,
+    iree_hal_transfer_buffer_t target, iree_device_size_t target_offset,
+    iree_device_size_t data_length, iree_hal_transfer_buffer_flags_t flags,
+    iree_timeout_t timeout);
+
 // Generic implementation of iree_hal_device_transfer_range for when the buffers
 // are mappable. In certain implementations even if buffers are mappable it's
 // often cheaper to still use the full queue transfers: instead of wasting CPU
@@ -11,6 +11,10 @@
 // Default capacity of a pool free list when not specified by the user.
 #define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY 64
 
+// Default percentage of a request that may go unused when reusing a larger
+// cached buffer.
+#define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_MAX_WASTE_PERCENT 25
+
 //===----------------------------------------------------------------------===//
 // iree_hal_caching_allocator_pool_t
 //===----------------------------------------------------------------------===//
@@ -28,12 +32,20 @@ void iree_hal_caching_allocator_pool_params_initialize(
   out_params->max_allocation_capacity = IREE_DEVICE_SIZE_MAX;
   out_params->max_free_allocation_count =
       IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY;
+  out_params->reuse_mode = IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT;
+  out_params->max_waste_percent =
+      IREE_HAL_CACHING_ALLOCATOR_DEFAULT_MAX_WASTE_PERCENT;
 }
 
 // Pool of arbitrarily-sized device allocations for a particular heap.
 // This maintains a free list of blocks available for use but does not track
 // outstanding allocations.
 //
+// When splitting is enabled the free list may contain subspans of a larger
+// allocated buffer (split blocks). Split blocks each retain the allocated
+// buffer and once all of them have been coalesced and released the allocated
+// buffer is recycled back into the pool as a whole block.
+//
 // Thread-safe. Pools can service requests from multiple threads concurrently by
 // way of a pool-specific mutex. The mutex will not be held during underlying
 // allocator operations such as when acquiring a new allocation as these can be
@@ -47,6 +59,9 @@ typedef iree_alignas(
   // Unretained as the parent allocator retains it for us.
   iree_hal_allocator_t* device_allocator;
 
+  // Allocator used for split block subspan buffers.
+  iree_allocator_t host_allocator;
+
   // Guards access to the pool data structures as buffers can be
   // acquired/released from multiple threads if shared across user-visible
   // devices.
@@ -63,6 +78,15 @@ typedef iree_alignas(
   // Total size, in bytes, of all free buffers currently in this pool.
   iree_device_size_t free_allocated_size;
 
+  IREE_STATISTICS(struct {
+    // High-water mark of total_allocated_size.
+    iree_device_size_t peak_allocated_size;
+    // Number of requests served from the free list.
+    uint64_t hit_count;
+    // Number of requests that required a new allocation.
+    uint64_t miss_count;
+  } statistics;)
+
   // Flat MRU list of available buffers with max_free_allocation_count slots.
   // Sorted by ascending recency (the higher the index the more recent).
   // If we really cared about optimizing the interior removal then we'd want
@@ -79,16 +103,19 @@ static void iree_hal_caching_allocator_pool_trim(
 // Buffer device storage will be allocated from |device_allocator|.
 static void iree_hal_caching_allocator_pool_initialize(
     iree_hal_caching_allocator_pool_params_t params,
-    iree_hal_allocator_t* device_allocator,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_caching_allocator_pool_t* out_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_pool->params = params;
   out_pool->device_allocator = device_allocator;
+  out_pool->host_allocator = host_allocator;
   iree_slim_mutex_initialize(&out_pool->mutex);
   out_pool->total_allocated_size = 0;
   out_pool->free_allocated_size = 0;
   out_pool->free_count = 0;
+  IREE_STATISTICS(memset(&out_pool->statistics, 0,
+                         sizeof(out_pool->statistics)));
 
   IREE_TRACE_SET_PLOT_TYPE(IREE_HAL_CACHING_ALLOCATOR_ID,
                            IREE_TRACING_PLOT_TYPE_MEMORY, /*step=*/true,
@@ -119,6 +146,21 @@ static void iree_hal_caching_allocator_pool_deinitialize(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns true if |buffer| is a split block referencing a range of a larger
+// allocated buffer.
+static bool iree_hal_caching_allocator_is_split_block(
+    iree_hal_buffer_t* buffer) {
+  return iree_hal_buffer_allocated_buffer(buffer) != buffer;
+}
+
+// Returns the size, in bytes, of the range |buffer| occupies.
+static iree_device_size_t iree_hal_caching_allocator_block_size(
+    iree_hal_buffer_t* buffer) {
+  return iree_hal_caching_allocator_is_split_block(buffer)
+             ? iree_hal_buffer_byte_length(buffer)
+             : iree_hal_buffer_allocation_size(buffer);
+}
+
 // Pushes |buffer| on to the pool free list as the most recently used.
 // The buffer will be retained in the list.
 //
@@ -136,7 +178,7 @@ static void iree_hal_caching_allocator_pool_push_buffer(
   pool->free_buffers[i] = buffer;
 
   // Track that we're now retaining unused memory.
-  pool->free_allocated_size += buffer->allocation_size;
+  pool->free_allocated_size += iree_hal_caching_allocator_block_size(buffer);
   IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
                             pool->free_allocated_size);
 }
@@ -155,34 +197,96 @@ static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_buffer_at(
             (pool->free_count - i - 1) * sizeof(pool->free_buffers[0]));
   }
   --pool->free_count;
-  pool->free_allocated_size -= buffer->allocation_size;
+  pool->free_allocated_size -= iree_hal_caching_allocator_block_size(buffer);
   IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
                             pool->free_allocated_size);
   return buffer;
 }
 
+// Returns true if a block of |block_size| serving a request of
+// |allocation_size| wastes no more than the pool allows.
+static bool iree_hal_caching_allocator_pool_is_within_waste(
+    const iree_hal_caching_allocator_pool_t* pool,
+    iree_device_size_t block_size, iree_device_size_t allocation_size) {
+  // Split to avoid overflowing allocation_size * percent on large sizes.
+  const iree_device_size_t percent = pool->params.max_waste_percent;
+  const iree_device_size_t max_waste =
+      allocation_size / 100 * percent + allocation_size % 100 * percent / 100;
+  return block_size - allocation_size <= max_waste;
+}
+
 // Scans the |pool| free list for a buffer matching the given requirements and
-// returns ownership.
+// returns ownership. The returned block may be larger than |allocation_size|
+// if the pool reuse mode allows.
 //
 // Must be called with the pool mutex held.
 static iree_hal_buffer_t* iree_hal_caching_allocator_pool_find_and_take_buffer(
     iree_hal_caching_allocator_pool_t* pool,
     const iree_hal_buffer_params_t* params,
     iree_device_size_t allocation_size) {
+  const iree_hal_caching_allocator_pool_reuse_mode_t reuse_mode =
+      pool->params.reuse_mode;
+  int best_index = -1;
+  iree_device_size_t best_size = IREE_DEVICE_SIZE_MAX;
   // Walk backwards so that we check the most recently released buffers first.
   for (int i = (int)pool->free_count - 1; i >= 0; --i) {
     // NOTE: we are not currently checking alignment as we don't really have it.
     // We assume programs will use consistent alignments for a particular heap
     // (as the heap has a min alignment).
     iree_hal_buffer_t* buffer = pool->free_buffers[i];
-    if (iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
-        iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
-                          params->usage) &&
-        iree_hal_buffer_allocation_size(buffer) == allocation_size) {
+    if (!iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) ||
+        !iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage)) {
+      continue;
+    }
+    const iree_device_size_t block_size =
+        iree_hal_caching_allocator_block_size(buffer);
+    if (block_size == allocation_size) {
+      // Exact matches are always preferred.
       return iree_hal_caching_allocator_pool_take_buffer_at(pool, i);
+    } else if (reuse_mode == IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT ||
+               block_size < allocation_size || block_size >= best_size) {
+      continue;
+    } else if (reuse_mode ==
+                   IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_BEST_FIT &&
+               !iree_hal_caching_allocator_pool_is_within_waste(
+                   pool, block_size, allocation_size)) {
+      continue;
     }
+    best_index = i;
+    best_size = block_size;
   }
-  return NULL;  // nothing found
+  if (best_index < 0) return NULL;  // nothing found
+  return iree_hal_caching_allocator_pool_take_buffer_at(
+      pool, (iree_host_size_t)best_index);
+}
+
+// Finds a free split block adjacent to |buffer| in the same allocated buffer.
+// |before| selects the block immediately preceding |buffer| and otherwise the
+// one immediately following it. Returns the index in the free list or -1.
+//
+// Must be called with the pool mutex held.
+static int iree_hal_caching_allocator_pool_find_adjacent_block(
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer,
+    bool before) {
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  const iree_device_size_t offset = iree_hal_buffer_byte_offset(buffer);
+  const iree_device_size_t end = offset + iree_hal_buffer_byte_length(buffer);
+  for (int i = (int)pool->free_count - 1; i >= 0; --i) {
+    iree_hal_buffer_t* block = pool->free_buffers[i];
+    if (block == buffer ||
+        iree_hal_buffer_allocated_buffer(block) != allocated_buffer) {
+      continue;
+    }
+    const iree_device_size_t block_offset = iree_hal_buffer_byte_offset(block);
+    if (before && block_offset + iree_hal_buffer_byte_length(block) == offset) {
+      return i;
+    } else if (!before && block_offset == end) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 // Trims |pool| down to at most |target_size| of available allocations.
@@ -202,6 +306,16 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
         iree_hal_caching_allocator_pool_take_buffer_at(pool,
                                                        pool->free_count - 1);
 
+    // Split blocks are dropped without changing the accounting; once the last
+    // block referencing the allocated buffer is destroyed the allocated buffer
+    // is recycled back into the pool where we'll trim it.
+    if (iree_hal_caching_allocator_is_split_block(dead_buffer)) {
+      iree_slim_mutex_unlock(&pool->mutex);
+      iree_hal_buffer_destroy(dead_buffer);
+      iree_slim_mutex_lock(&pool->mutex);
+      continue;
+    }
+
     // NOTE: we've removed the buffer but have not subtracted the size from
     // the total yet - we want to do that only after releasing the buffer.
     // If we didn't it's possible for another thread to start an allocation
@@ -232,6 +346,165 @@ static void iree_hal_caching_allocator_pool_trim(
   iree_hal_caching_allocator_pool_trim_to_size(pool, 0);
 }
 
+// Pushes a free |block| on to the |pool| free list if there is capacity and
+// otherwise destroys it. The caller's reference is consumed.
+//
+// The pool mutex must not be held by the caller.
+static void iree_hal_caching_allocator_pool_push_or_destroy_block(
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* block) {
+  iree_slim_mutex_lock(&pool->mutex);
+  const bool under_count =
+      pool->free_count + 1 <= pool->params.max_free_allocation_count;
+  if (under_count) {
+    iree_hal_caching_allocator_pool_push_buffer(pool, block);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (under_count) {
+    iree_hal_buffer_release(block);
+  } else {
+    iree_hal_buffer_destroy(block);
+  }
+}
+
+// Splits |block| such that the front |allocation_size| (rounded up to the heap
+// alignment) is returned in |out_buffer| and the remainder is returned to the
+// |pool| free list. Takes ownership of |block|.
+//
+// The pool mutex must not be held by the caller.
+static iree_status_t iree_hal_caching_allocator_pool_split_block(
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* block,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_t* allocated_buffer = iree_hal_buffer_allocated_buffer(block);
+  const iree_device_size_t block_offset = iree_hal_buffer_byte_offset(block);
+  const iree_device_size_t block_length =
+      iree_hal_caching_allocator_block_size(block);
+  const iree_device_size_t head_length = iree_device_align(
+      allocation_size, iree_max(pool->params.heap.min_alignment, 1));
+  if (head_length >= block_length) {
+    // Nothing left over after alignment; use the whole block.
+    *out_buffer = block;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  iree_hal_buffer_t* head = NULL;
+  iree_hal_buffer_t* tail = NULL;
+  iree_status_t status = iree_hal_subspan_buffer_create(
+      allocated_buffer, block_offset, head_length, /*device_allocator=*/NULL,
+      pool->host_allocator, &head);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_subspan_buffer_create(
+        allocated_buffer, block_offset + head_length,
+        block_length - head_length, /*device_allocator=*/NULL,
+        pool->host_allocator, &tail);
+  }
+  if (!iree_status_is_ok(status)) {
+    // Failed to split (out of host memory); use the whole block instead.
+    iree_status_ignore(status);
+    if (head) iree_hal_buffer_destroy(head);
+    *out_buffer = block;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // The split blocks retain the allocated buffer so we can drop the original.
+  // Split blocks are destroyed directly as releasing them would route them back
+  // through the pool.
+  if (iree_hal_caching_allocator_is_split_block(block)) {
+    iree_hal_buffer_destroy(block);
+  } else {
+    iree_hal_buffer_release(block);
+  }
+
+  iree_hal_caching_allocator_pool_push_or_destroy_block(pool, tail);
+  *out_buffer = head;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Releases a split |buffer| to the |pool| coalescing it with any adjacent free
+// split blocks. If the coalesced block spans the entire allocated buffer the
+// blocks are dropped such that the allocated buffer is recycled into the pool.
+//
+// The pool mutex must not be held by the caller.
+static void iree_hal_caching_allocator_pool_release_split_block(
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+
+  // Take the adjacent free blocks, if any.
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_buffer_t* prev_block = NULL;
+  iree_hal_buffer_t* next_block = NULL;
+  int prev_index =
+      iree_hal_caching_allocator_pool_find_adjacent_block(pool, buffer, true);
+  if (prev_index >= 0) {
+    prev_block = iree_hal_caching_allocator_pool_take_buffer_at(
+        pool, (iree_host_size_t)prev_index);
+  }
+  int next_index =
+      iree_hal_caching_allocator_pool_find_adjacent_block(pool, buffer, false);
+  if (next_index >= 0) {
+    next_block = iree_hal_caching_allocator_pool_take_buffer_at(
+        pool, (iree_host_size_t)next_index);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (!prev_block && !next_block) {
+    // Nothing to coalesce with. The buffer is being recycled and has no
+    // references so we need to retain it to own it before pushing.
+    iree_hal_buffer_retain(buffer);
+    iree_hal_caching_allocator_pool_push_or_destroy_block(pool, buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+
+  const iree_device_size_t merged_offset =
+      iree_hal_buffer_byte_offset(prev_block ? prev_block : buffer);
+  iree_hal_buffer_t* last_block = next_block ? next_block : buffer;
+  const iree_device_size_t merged_end =
+      iree_hal_buffer_byte_offset(last_block) +
+      iree_hal_buffer_byte_length(last_block);
+  const bool covers_allocation =
+      merged_offset == iree_hal_buffer_byte_offset(allocated_buffer) &&
+      merged_end >= iree_hal_buffer_byte_offset(allocated_buffer) +
+                        iree_hal_buffer_byte_length(allocated_buffer);
+
+  iree_hal_buffer_t* merged_block = NULL;
+  if (!covers_allocation) {
+    iree_status_t status = iree_hal_subspan_buffer_create(
+        allocated_buffer, merged_offset, merged_end - merged_offset,
+        /*device_allocator=*/NULL, pool->host_allocator, &merged_block);
+    if (!iree_status_is_ok(status)) {
+      // Failed to coalesce (out of host memory); put the neighbors back and
+      // drop the released range until the next trim.
+      iree_status_ignore(status);
+      iree_hal_buffer_destroy(buffer);
+      if (prev_block) {
+        iree_hal_caching_allocator_pool_push_or_destroy_block(pool, prev_block);
+      }
+      if (next_block) {
+        iree_hal_caching_allocator_pool_push_or_destroy_block(pool, next_block);
+      }
+      IREE_TRACE_ZONE_END(z0);
+      return;
+    }
+  }
+
+  // Drop the individual blocks. If the merged range covers the entire
+  // allocation then the last one dropped will recycle the allocated buffer.
+  iree_hal_buffer_destroy(buffer);
+  if (prev_block) iree_hal_buffer_destroy(prev_block);
+  if (next_block) iree_hal_buffer_destroy(next_block);
+  if (merged_block) {
+    iree_hal_caching_allocator_pool_push_or_destroy_block(pool, merged_block);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 // Acquires a buffer of |allocation_size| from the |pool|.
 // The buffer will have a memory type and usage compatible with the given types.
 // Fails if the pool is empty and the underlying device fails the allocation.
@@ -250,17 +523,36 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   iree_hal_buffer_t* existing_buffer =
       iree_hal_caching_allocator_pool_find_and_take_buffer(pool, params,
                                                            allocation_size);
-  if (!existing_buffer) {
+  if (existing_buffer) {
+    IREE_STATISTICS(++pool->statistics.hit_count);
+  } else {
     // We'll need to allocate so we add the size such that it'll be accounted
     // for by other threads allocating at the same time.
     pool->total_allocated_size += allocation_size;
+    IREE_STATISTICS({
+      ++pool->statistics.miss_count;
+      pool->statistics.peak_allocated_size =
+          iree_max(pool->statistics.peak_allocated_size,
+                   pool->total_allocated_size);
+    });
   }
   iree_slim_mutex_unlock(&pool->mutex);
   if (existing_buffer) {
-    // Found a buffer! Return it uninitialized.
-    *out_buffer = existing_buffer;
+    // Found a buffer! Return it uninitialized, splitting off the unused
+    // remainder if it's too large.
+    iree_status_t status = iree_ok_status();
+    if (pool->params.reuse_mode ==
+            IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_SPLIT &&
+        !iree_hal_caching_allocator_pool_is_within_waste(
+            pool, iree_hal_caching_allocator_block_size(existing_buffer),
+            allocation_size)) {
+      status = iree_hal_caching_allocator_pool_split_block(
+          pool, existing_buffer, allocation_size, out_buffer);
+    } else {
+      *out_buffer = existing_buffer;
+    }
     IREE_TRACE_ZONE_END(z0);
-    return iree_ok_status();
+    return status;
   }
 
   // Trim first before allocating so that we don't go over peak.
@@ -296,7 +588,15 @@ static void iree_hal_caching_allocator_pool_release(
     iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(
-      z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
+      z0, (int64_t)iree_hal_caching_allocator_block_size(buffer));
+
+  // Split blocks don't count against the pool capacity as the allocated buffer
+  // they reference already does.
+  if (iree_hal_caching_allocator_is_split_block(buffer)) {
+    iree_hal_caching_allocator_pool_release_split_block(pool, buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
 
   // Try to add the buffer to the pool. If the pool is at capacity we'll just
   // release it back to the allocator.
@@ -433,7 +733,7 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
         iree_max_align_t);
     allocator->pools[i] = pool;
     iree_hal_caching_allocator_pool_initialize(pool_params[i], device_allocator,
-                                               pool);
+                                               host_allocator, pool);
   }
 
   *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -547,12 +847,17 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t max_allocation_size_str = iree_string_view_empty();
     iree_string_view_t max_allocation_capacity_str = iree_string_view_empty();
     iree_string_view_t max_free_allocation_count_str = iree_string_view_empty();
+    iree_string_view_t reuse_mode_str = iree_string_view_empty();
+    iree_string_view_t max_waste_percent_str = iree_string_view_empty();
     iree_string_view_split(pool_config, ';', &max_allocation_size_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_allocation_capacity_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_free_allocation_count_str,
                            &pool_config);
+    iree_string_view_split(pool_config, ';', &reuse_mode_str, &pool_config);
+    iree_string_view_split(pool_config, ';', &max_waste_percent_str,
+                           &pool_config);
     max_allocation_size_str = iree_string_view_trim(max_allocation_size_str);
     if (!iree_string_view_is_empty(max_allocation_size_str) &&
         !iree_string_view_equal(max_allocation_size_str, IREE_SV("*"))) {
@@ -584,6 +889,35 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
       }
       pool_params->max_free_allocation_count = max_free_allocation_count;
     }
+    reuse_mode_str = iree_string_view_trim(reuse_mode_str);
+    if (iree_string_view_is_empty(reuse_mode_str) ||
+        iree_string_view_equal(reuse_mode_str, IREE_SV("*")) ||
+        iree_string_view_equal(reuse_mode_str, IREE_SV("exact"))) {
+      pool_params->reuse_mode =
+          IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT;
+    } else if (iree_string_view_equal(reuse_mode_str, IREE_SV("best_fit"))) {
+      pool_params->reuse_mode =
+          IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_BEST_FIT;
+    } else if (iree_string_view_equal(reuse_mode_str, IREE_SV("split"))) {
+      pool_params->reuse_mode =
+          IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_SPLIT;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid reuse mode '%.*s'; expected one of "
+                              "`exact`, `best_fit`, or `split`",
+                              (int)reuse_mode_str.size, reuse_mode_str.data);
+    }
+    max_waste_percent_str = iree_string_view_trim(max_waste_percent_str);
+    if (!iree_string_view_is_empty(max_waste_percent_str) &&
+        !iree_string_view_equal(max_waste_percent_str, IREE_SV("*"))) {
+      if (!iree_string_view_atoi_uint32(max_waste_percent_str,
+                                        &pool_params->max_waste_percent)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid waste percentage '%.*s'",
+                                (int)max_waste_percent_str.size,
+                                max_waste_percent_str.data);
+      }
+    }
   } while (!iree_string_view_is_empty(config_pairs));
   return iree_hal_caching_allocator_create_with_pools(
       pool_count, pool_params_storage, device_allocator, host_allocator,
@@ -633,6 +967,16 @@ static void iree_hal_caching_allocator_query_statistics(
       iree_hal_caching_allocator_cast(base_allocator);
   iree_hal_allocator_query_statistics(allocator->device_allocator,
                                       out_statistics);
+  IREE_STATISTICS({
+    for (iree_host_size_t i = 0; i < allocator->pool_count; ++i) {
+      iree_hal_caching_allocator_pool_t* pool = allocator->pools[i];
+      iree_slim_mutex_lock(&pool->mutex);
+      out_statistics->cache_bytes_peak += pool->statistics.peak_allocated_size;
+      out_statistics->cache_hit_count += pool->statistics.hit_count;
+      out_statistics->cache_miss_count += pool->statistics.miss_count;
+      iree_slim_mutex_unlock(&pool->mutex);
+    }
+  });
 }
 
 static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
@@ -26,6 +26,23 @@ extern "C" {
 // manipulated from multiple threads.
 typedef struct iree_hal_caching_allocator_t iree_hal_caching_allocator_t;
 
+// Controls how cached buffers are matched against allocation requests.
+typedef enum iree_hal_caching_allocator_pool_reuse_mode_e {
+  // Only cached buffers of exactly the requested allocation size are reused.
+  // This works well when programs repeatedly allocate the same sizes (static
+  // shapes) but misses in most cases when sizes are dynamic.
+  IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT = 0,
+  // The smallest cached buffer at least as large as the request is reused so
+  // long as the unused bytes are within |max_waste_percent| of the request.
+  IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_BEST_FIT,
+  // As with BEST_FIT but cached buffers that would waste more than
+  // |max_waste_percent| are split: the request is served from the front of the
+  // buffer and the remainder is returned to the pool. Split ranges are
+  // coalesced with adjacent free ranges when released and the original buffer
+  // is returned to the pool intact once all of its ranges are free.
+  IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_SPLIT,
+} iree_hal_caching_allocator_pool_reuse_mode_t;
+
 // Parameters used to configure an iree_hal_caching_allocator_t pool.
 // These cannot be changed once the allocator has been created.
 typedef struct iree_hal_caching_allocator_pool_params_t {
@@ -49,6 +66,14 @@ typedef struct iree_hal_caching_allocator_pool_params_t {
   // This is used to allocate storage for the free list and should be reasonably
   // bounded (~64-1024).
   iree_host_size_t max_free_allocation_count;
+
+  // Controls how cached buffers are matched against requests.
+  iree_hal_caching_allocator_pool_reuse_mode_t reuse_mode;
+
+  // Maximum number of bytes, as a percentage of the requested allocation size,
+  // that may go unused when reusing a larger cached buffer. Ignored with
+  // IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT.
+  uint32_t max_waste_percent;
 } iree_hal_caching_allocator_pool_params_t;
 
 // Initializes |out_params| to the default values using |heap| for storage.
@@ -100,11 +125,16 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
 // than 100MB can be retained. Wildcards can be used to indicate max values or
 // defaults.
 //
+// The optional reuse mode is one of `exact`, `best_fit`, or `split` and may be
+// followed by the maximum waste percentage (see
+// iree_hal_caching_allocator_pool_params_t).
+//
 // Expected form:
-//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count
+//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count[;reuse_mode[;max_waste_percent]]
 // Example:
 //   device_local=1gib;1gib;8
 //   host_local=*;*;32
+//   device_local=*;4gib;64;split;25
 iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
@@ -0,0 +1,167 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/caching_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(allocator_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  void CreateAllocator(iree_hal_caching_allocator_pool_reuse_mode_t reuse_mode,
+                       uint32_t max_waste_percent) {
+    iree_hal_allocator_memory_heap_t heap;
+    iree_host_size_t heap_count = 0;
+    IREE_ASSERT_OK(iree_hal_allocator_query_memory_heaps(device_allocator_, 1,
+                                                         &heap, &heap_count));
+    iree_hal_caching_allocator_pool_params_t pool_params;
+    iree_hal_caching_allocator_pool_params_initialize(heap, &pool_params);
+    pool_params.reuse_mode = reuse_mode;
+    pool_params.max_waste_percent = max_waste_percent;
+    IREE_ASSERT_OK(iree_hal_caching_allocator_create_with_pools(
+        1, &pool_params, device_allocator_, iree_allocator_system(),
+        &allocator_));
+  }
+
+  iree_hal_buffer_t* Allocate(iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(
+        iree_hal_allocator_allocate_buffer(allocator_, params, size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(CachingAllocatorTest, ExactReusesSameSize) {
+  CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_EXACT, 0);
+  iree_hal_buffer_t* buffer0 = Allocate(1024);
+  iree_hal_buffer_t* storage0 = buffer0;
+  iree_hal_buffer_release(buffer0);
+
+  // Different size misses.
+  iree_hal_buffer_t* buffer1 = Allocate(1000);
+  EXPECT_NE(buffer1, storage0);
+  // Same size hits.
+  iree_hal_buffer_t* buffer2 = Allocate(1024);
+  EXPECT_EQ(buffer2, storage0);
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer2);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+  EXPECT_EQ(statistics.cache_hit_count, 1);
+  EXPECT_EQ(statistics.cache_miss_count, 2);
+  EXPECT_EQ(statistics.cache_bytes_peak, 1024 + 1000);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+TEST_F(CachingAllocatorTest, BestFitReusesLargerWithinWaste) {
+  CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_BEST_FIT, 25);
+  iree_hal_buffer_t* large = Allocate(4096);
+  iree_hal_buffer_t* small = Allocate(1024);
+  iree_hal_buffer_t* large_storage = large;
+  iree_hal_buffer_t* small_storage = small;
+  iree_hal_buffer_release(large);
+  iree_hal_buffer_release(small);
+
+  // Picks the smallest buffer that fits.
+  iree_hal_buffer_t* buffer0 = Allocate(900);
+  EXPECT_EQ(buffer0, small_storage);
+  // Too much waste to use the large buffer.
+  iree_hal_buffer_t* buffer1 = Allocate(1024);
+  EXPECT_NE(buffer1, large_storage);
+  // Within the waste limits of the large buffer.
+  iree_hal_buffer_t* buffer2 = Allocate(3600);
+  EXPECT_EQ(buffer2, large_storage);
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer2);
+}
+
+TEST_F(CachingAllocatorTest, SplitAndCoalesce) {
+  CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_SPLIT, 25);
+  iree_hal_buffer_t* root = Allocate(4096);
+  iree_hal_buffer_t* root_storage = root;
+  iree_hal_buffer_release(root);
+
+  // Both requests are served from ranges of the cached buffer.
+  iree_hal_buffer_t* buffer0 = Allocate(1024);
+  iree_hal_buffer_t* buffer1 = Allocate(1024);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer0), root_storage);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer1), root_storage);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(buffer0), 0);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(buffer1), 1024);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer1), 1024);
+
+  // Releasing both coalesces with the remainder and returns the whole buffer.
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_t* buffer2 = Allocate(4096);
+  EXPECT_EQ(buffer2, root_storage);
+  iree_hal_buffer_release(buffer2);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+  EXPECT_EQ(statistics.cache_hit_count, 3);
+  EXPECT_EQ(statistics.cache_miss_count, 1);
+  EXPECT_EQ(statistics.cache_bytes_peak, 4096);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+TEST_F(CachingAllocatorTest, TrimReleasesSplitBlocks) {
+  CreateAllocator(IREE_HAL_CACHING_ALLOCATOR_POOL_REUSE_MODE_SPLIT, 0);
+  iree_hal_buffer_t* root = Allocate(4096);
+  iree_hal_buffer_release(root);
+  iree_hal_buffer_t* buffer0 = Allocate(1024);
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+  iree_hal_buffer_release(buffer0);
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+}
+
+TEST_F(CachingAllocatorTest, SpecReuseMode) {
+  IREE_ASSERT_OK(iree_hal_caching_allocator_create_from_spec(
+      iree_make_cstring_view("*=*;*;16;split;10"), device_allocator_,
+      iree_allocator_system(), &allocator_));
+  iree_hal_allocator_release(allocator_);
+  allocator_ = NULL;
+  EXPECT_THAT(Status(iree_hal_caching_allocator_create_from_spec(
+                  iree_make_cstring_view("*=*;*;16;bogus"), device_allocator_,
+                  iree_allocator_system(), &allocator_)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -110,3 +110,39 @@ IREE_API_EXPORT iree_status_t iree_hal_collective_batch_append(
 
   return iree_ok_status();
 }
+
+// Returns the size in bytes of the data reduced by an all-reduce |entry|.
+static iree_device_size_t iree_hal_collective_batch_entry_byte_length(
+    const iree_hal_collective_batch_entry_t* entry) {
+  return entry->element_count *
+         iree_hal_collective_element_byte_count(entry->op.element_type);
+}
+
+IREE_API_EXPORT iree_host_size_t iree_hal_collective_batch_bucket_end(
+    const iree_hal_collective_batch_t* batch, iree_host_size_t start_index,
+    iree_device_size_t max_bucket_size) {
+  IREE_ASSERT_ARGUMENT(batch);
+  IREE_ASSERT_LT(start_index, batch->count);
+  const iree_hal_collective_batch_entry_t* first_entry =
+      &batch->entries[start_index];
+  if (first_entry->op.kind != IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE) {
+    return start_index + 1;
+  }
+  iree_device_size_t bucket_size =
+      iree_hal_collective_batch_entry_byte_length(first_entry);
+  if (bucket_size > max_bucket_size) return start_index + 1;
+  iree_host_size_t end_index = start_index + 1;
+  for (; end_index < batch->count; ++end_index) {
+    const iree_hal_collective_batch_entry_t* entry =
+        &batch->entries[end_index];
+    if (entry->channel != first_entry->channel ||
+        entry->op.packed != first_entry->op.packed) {
+      break;
+    }
+    iree_device_size_t byte_length =
+        iree_hal_collective_batch_entry_byte_length(entry);
+    if (bucket_size + byte_length > max_bucket_size) break;
+    bucket_size += byte_length;
+  }
+  return end_index;
+}
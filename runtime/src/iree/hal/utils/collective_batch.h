@@ -92,6 +92,16 @@ IREE_API_EXPORT iree_status_t iree_hal_collective_batch_append(
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count);
 
+// Returns the exclusive end index of the run of entries starting at
+// |start_index| that can be fused into a single all-reduce over one contiguous
+// bucket of at most |max_bucket_size| bytes. Entries are fusible if they are
+// all-reduce operations on the same channel with the same element type and
+// reduction. Returns |start_index| + 1 if the entry cannot be fused with any of
+// the entries following it.
+IREE_API_EXPORT iree_host_size_t iree_hal_collective_batch_bucket_end(
+    const iree_hal_collective_batch_t* batch, iree_host_size_t start_index,
+    iree_device_size_t max_bucket_size);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
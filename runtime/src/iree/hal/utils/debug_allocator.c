@@ -6,6 +6,8 @@
 
 #include "iree/hal/utils/debug_allocator.h"
 
+#include "iree/base/internal/atomics.h"
+
 //===----------------------------------------------------------------------===//
 // iree_hal_debug_allocator_t
 //===----------------------------------------------------------------------===//
@@ -28,6 +30,8 @@ struct iree_hal_debug_allocator_t {
   iree_allocator_t host_allocator;
   iree_hal_device_t* device;
   iree_hal_allocator_t* device_allocator;
+  // Non-zero while steady-state checking is enabled and allocations must fail.
+  iree_atomic_int32_t steady_state;
 };
 
 static const iree_hal_allocator_vtable_t iree_hal_debug_allocator_vtable;
@@ -41,7 +45,6 @@ iree_hal_debug_allocator_t* iree_hal_debug_allocator_cast(
 iree_status_t iree_hal_debug_allocator_create(
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
-  IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(device_allocator);
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -58,6 +61,8 @@ iree_status_t iree_hal_debug_allocator_create(
   iree_hal_device_retain(allocator->device);
   allocator->device_allocator = device_allocator;
   iree_hal_allocator_retain(allocator->device_allocator);
+  iree_atomic_store_int32(&allocator->steady_state, 0,
+                          iree_memory_order_relaxed);
 
   *out_allocator = (iree_hal_allocator_t*)allocator;
   IREE_TRACE_ZONE_END(z0);
@@ -77,6 +82,53 @@ static void iree_hal_debug_allocator_destroy(
   IREE_TRACE_ZONE_END(z0);
 }
 
+iree_status_t iree_hal_debug_allocator_set_steady_state(
+    iree_hal_allocator_t* base_allocator, bool enabled) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  if (!iree_hal_resource_is(base_allocator,
+                            &iree_hal_debug_allocator_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocator is not a debug allocator");
+  }
+  iree_hal_debug_allocator_t* allocator =
+      iree_hal_debug_allocator_cast(base_allocator);
+  iree_atomic_store_int32(&allocator->steady_state, enabled ? 1 : 0,
+                          iree_memory_order_release);
+  return iree_ok_status();
+}
+
+static bool iree_hal_debug_allocator_is_steady_state(
+    iree_hal_debug_allocator_t* allocator) {
+  return iree_atomic_load_int32(&allocator->steady_state,
+                                iree_memory_order_acquire) != 0;
+}
+
+static iree_status_t iree_hal_debug_allocator_guarded_host_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr) {
+  iree_hal_debug_allocator_t* allocator = (iree_hal_debug_allocator_t*)self;
+  if (command != IREE_ALLOCATOR_COMMAND_FREE &&
+      iree_hal_debug_allocator_is_steady_state(allocator)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "host allocation made during steady-state "
+                            "execution; all per-invocation resources must be "
+                            "pooled during warmup");
+  }
+  return allocator->host_allocator.ctl(allocator->host_allocator.self, command,
+                                       params, inout_ptr);
+}
+
+iree_allocator_t iree_hal_debug_allocator_guarded_host_allocator(
+    iree_hal_allocator_t* base_allocator) {
+  iree_hal_debug_allocator_t* allocator =
+      iree_hal_debug_allocator_cast(base_allocator);
+  iree_allocator_t host_allocator = {
+      .self = allocator,
+      .ctl = iree_hal_debug_allocator_guarded_host_ctl,
+  };
+  return host_allocator;
+}
+
 static iree_allocator_t iree_hal_debug_allocator_host_allocator(
     const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_debug_allocator_t* allocator =
@@ -192,6 +244,15 @@ static iree_status_t iree_hal_debug_allocator_allocate_buffer(
   iree_hal_debug_allocator_t* allocator =
       iree_hal_debug_allocator_cast(base_allocator);
 
+  if (iree_hal_debug_allocator_is_steady_state(allocator)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "buffer allocation of %" PRIdsz
+        " bytes made during steady-state execution; buffers must be pooled "
+        "during warmup (such as with a caching allocator)",
+        allocation_size);
+  }
+
   // Allocate the buffer from the underlying allocator. It may come back with
   // undefined contents (including those from prior allocations which may appear
   // correct).
@@ -204,21 +265,35 @@ static iree_status_t iree_hal_debug_allocator_allocate_buffer(
   // allocation, per trim, etc).
   uint8_t fill_pattern = IREE_HAL_DEBUG_ALLOCATOR_FILL_PATTERN;
 
+  iree_status_t status = iree_ok_status();
   if (iree_all_bits_set(iree_hal_buffer_allowed_usage(base_buffer),
                         IREE_HAL_BUFFER_USAGE_MAPPING) &&
       iree_all_bits_set(iree_hal_buffer_memory_type(base_buffer),
                         IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
-    return iree_hal_debug_allocator_fill_on_host(base_buffer, fill_pattern);
+    status = iree_hal_debug_allocator_fill_on_host(base_buffer, fill_pattern);
+  } else if (allocator->device) {
+    status = iree_hal_debug_allocator_fill_on_device(allocator->device,
+                                                     base_buffer, fill_pattern);
   } else {
-    return iree_hal_debug_allocator_fill_on_device(allocator->device,
-                                                   base_buffer, fill_pattern);
+    status = iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "debug allocator has no device to fill non-mappable buffers with");
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(base_buffer);
+    *out_buffer = NULL;
   }
+  return status;
 }
 
 static void iree_hal_debug_allocator_deallocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     iree_hal_buffer_t* IREE_RESTRICT buffer) {
-  // No-op; we never point a buffer back at us for deallocation.
+  // Buffers are allocated from the underlying allocator and only routed here
+  // by wrapping allocators (such as the caching allocator) when trimming.
+  iree_hal_debug_allocator_t* allocator =
+      iree_hal_debug_allocator_cast(base_allocator);
+  iree_hal_allocator_deallocate_buffer(allocator->device_allocator, buffer);
 }
 
 static iree_status_t iree_hal_debug_allocator_import_buffer(
@@ -21,11 +21,35 @@ extern "C" {
 typedef struct iree_hal_debug_allocator_t iree_hal_debug_allocator_t;
 
 // Creates a debug allocator intercepting all |device_allocator| allocations.
-// If needed |device| will be used for scheduling work.
+// If needed |device| will be used for scheduling work. |device| may be NULL if
+// all buffers allocated are host-visible and mappable.
 iree_status_t iree_hal_debug_allocator_create(
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Enables or disables steady-state checking on the debug |allocator|.
+//
+// Applications with hard latency requirements can use this to verify that
+// invocations after warmup perform no allocations. While enabled any buffer
+// allocation reaching the debug allocator fails with
+// IREE_STATUS_FAILED_PRECONDITION, as do host allocations made through the
+// allocator returned by iree_hal_debug_allocator_guarded_host_allocator.
+// Wrap the debug allocator in a caching allocator so that steady-state buffer
+// requests are serviced from the buffers pooled during warmup.
+//
+// Returns IREE_STATUS_INVALID_ARGUMENT if |allocator| is not a debug allocator.
+iree_status_t iree_hal_debug_allocator_set_steady_state(
+    iree_hal_allocator_t* allocator, bool enabled);
+
+// Returns a host allocator that forwards to the host allocator of the debug
+// |allocator| and fails allocations while steady-state checking is enabled.
+// Frees are always forwarded. Use it for the session and calls created after
+// the device so that per-invocation host allocations (VM lists, buffer views,
+// command buffers, etc) are checked. The debug allocator must remain live for
+// as long as the returned allocator is used.
+iree_allocator_t iree_hal_debug_allocator_guarded_host_allocator(
+    iree_hal_allocator_t* allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,133 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/debug_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/caching_allocator.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class DebugAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    // Heap buffers are host-visible so no device is needed for filling.
+    IREE_ASSERT_OK(iree_hal_debug_allocator_create(
+        /*device=*/NULL, device_allocator_, iree_allocator_system(),
+        &allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(allocator_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_status_t Allocate(iree_hal_allocator_t* allocator,
+                         iree_device_size_t size,
+                         iree_hal_buffer_t** out_buffer) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    return iree_hal_allocator_allocate_buffer(allocator, params, size,
+                                              out_buffer);
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(DebugAllocatorTest, FillsNewBuffers) {
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(Allocate(allocator_, 16, &buffer));
+  uint8_t contents[16] = {0};
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_read(buffer, 0, contents, sizeof(contents)));
+  for (uint8_t value : contents) EXPECT_EQ(value, 0xCD);
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(DebugAllocatorTest, SteadyStateRejectsBufferAllocations) {
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, true));
+  EXPECT_THAT(Status(Allocate(allocator_, 16, &buffer)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_EQ(buffer, nullptr);
+
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, false));
+  IREE_ASSERT_OK(Allocate(allocator_, 16, &buffer));
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(DebugAllocatorTest, SteadyStateRequiresDebugAllocator) {
+  EXPECT_THAT(Status(iree_hal_debug_allocator_set_steady_state(
+                  device_allocator_, true)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(DebugAllocatorTest, SteadyStateRejectsHostAllocations) {
+  iree_allocator_t host_allocator =
+      iree_hal_debug_allocator_guarded_host_allocator(allocator_);
+
+  // Memory allocated during warmup can be freed in steady state.
+  void* warmup_ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(host_allocator, 64, &warmup_ptr));
+
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, true));
+  void* ptr = NULL;
+  EXPECT_THAT(Status(iree_allocator_malloc(host_allocator, 64, &ptr)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_THAT(Status(iree_allocator_realloc(host_allocator, 128, &warmup_ptr)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  iree_allocator_free(host_allocator, warmup_ptr);
+
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, false));
+  IREE_ASSERT_OK(iree_allocator_malloc(host_allocator, 64, &ptr));
+  iree_allocator_free(host_allocator, ptr);
+}
+
+// Buffers released back to a caching allocator during warmup service the
+// steady-state requests without reaching the debug allocator.
+TEST_F(DebugAllocatorTest, CachingAllocatorServicesSteadyState) {
+  iree_hal_allocator_t* caching_allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_caching_allocator_create_unbounded(
+      allocator_, iree_allocator_system(), &caching_allocator));
+
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(Allocate(caching_allocator, 1024, &buffer));
+  iree_hal_buffer_release(buffer);
+
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, true));
+  buffer = NULL;
+  IREE_ASSERT_OK(Allocate(caching_allocator, 1024, &buffer));
+  iree_hal_buffer_release(buffer);
+
+  // Requests that were not seen during warmup are reported.
+  buffer = NULL;
+  EXPECT_THAT(Status(Allocate(caching_allocator, 4096, &buffer)),
+              StatusIs(StatusCode::kFailedPrecondition));
+
+  IREE_ASSERT_OK(iree_hal_debug_allocator_set_steady_state(allocator_, false));
+  iree_hal_allocator_release(caching_allocator);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
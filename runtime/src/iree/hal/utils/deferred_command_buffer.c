@@ -35,11 +35,12 @@ typedef enum iree_hal_command_type_e {
 // Each command is allocated from the arena and does *not* retain any resources;
 // the command buffer has a resource set that does lifetime tracking.
 //
-// We could elide some of these commands by keeping local state however that
-// requires knowing more about the target device (pipeline layouts, etc) and
-// prevents using this as a way to debug or benchmark command buffers. The
-// intent is that each command captures the exact information passed during the
-// call such that the target command buffer cannot tell they were deferred.
+// Each command captures the exact information passed during the call. When
+// recording ends the list is run through a peephole pass that only removes or
+// merges commands in ways that cannot change the results observed by the
+// target command buffer (see iree_hal_cmd_list_optimize). More aggressive
+// elision requires knowing more about the target device (pipeline layouts, etc)
+// and is left to the compiler.
 //
 // As each command is variable sized we store pointers to the following command
 // to allow us to walk the list during replay. Storing just a size would be
@@ -227,10 +228,13 @@ static iree_status_t iree_hal_deferred_command_buffer_begin(
   return iree_ok_status();
 }
 
+static void iree_hal_cmd_list_optimize(iree_hal_cmd_list_t* cmd_list);
+
 static iree_status_t iree_hal_deferred_command_buffer_end(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_deferred_command_buffer_t* command_buffer =
       iree_hal_deferred_command_buffer_cast(base_command_buffer);
+  iree_hal_cmd_list_optimize(&command_buffer->cmd_list);
   iree_hal_resource_set_freeze(command_buffer->resource_set);
   return iree_ok_status();
 }
@@ -731,9 +735,61 @@ static iree_status_t iree_hal_deferred_command_buffer_apply_push_descriptor_set(
     iree_hal_command_buffer_t* target_command_buffer,
     iree_hal_buffer_binding_table_t binding_table,
     const iree_hal_cmd_push_descriptor_set_t* cmd) {
+  // NULL buffers are only binding table references when replaying with a
+  // binding table; without one they are null bindings and pass through as-is.
+  bool any_indirect = false;
+  for (iree_host_size_t i = 0;
+       i < cmd->binding_count && binding_table.count > 0 && !any_indirect;
+       ++i) {
+    any_indirect = cmd->bindings[i].buffer == NULL;
+  }
+  if (!any_indirect) {
+    return iree_hal_command_buffer_push_descriptor_set(
+        target_command_buffer, cmd->pipeline_layout, cmd->set,
+        cmd->binding_count, cmd->bindings);
+  }
+
+  // Resolve indirect bindings against the binding table provided at replay.
+  // The recorded offset is relative to the table entry and a whole-buffer
+  // length covers the remainder of the table entry.
+  iree_hal_descriptor_set_binding_t* bindings =
+      (iree_hal_descriptor_set_binding_t*)iree_alloca(
+          cmd->binding_count * sizeof(iree_hal_descriptor_set_binding_t));
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    iree_hal_descriptor_set_binding_t binding = cmd->bindings[i];
+    if (!binding.buffer) {
+      if (binding.buffer_slot >= binding_table.count) {
+        return iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "indirect binding %" PRIhsz " references slot %u but the binding "
+            "table only has %" PRIhsz " entries",
+            i, (uint32_t)binding.buffer_slot, binding_table.count);
+      }
+      const iree_hal_buffer_binding_t* table_binding =
+          &binding_table.bindings[binding.buffer_slot];
+      if (!table_binding->buffer) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "binding table slot %u has no buffer",
+                                (uint32_t)binding.buffer_slot);
+      }
+      binding.buffer = table_binding->buffer;
+      if (binding.length == IREE_WHOLE_BUFFER &&
+          table_binding->length != IREE_WHOLE_BUFFER) {
+        if (binding.offset > table_binding->length) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "indirect binding %" PRIhsz " offset is outside of slot %u", i,
+              (uint32_t)binding.buffer_slot);
+        }
+        binding.length = table_binding->length - binding.offset;
+      }
+      binding.offset += table_binding->offset;
+    }
+    bindings[i] = binding;
+  }
   return iree_hal_command_buffer_push_descriptor_set(
       target_command_buffer, cmd->pipeline_layout, cmd->set, cmd->binding_count,
-      cmd->bindings);
+      bindings);
 }
 
 //===----------------------------------------------------------------------===//
@@ -870,6 +926,221 @@ static iree_status_t iree_hal_deferred_command_buffer_apply_execute_commands(
       target_command_buffer, cmd->commands, child_binding_table);
 }
 
+//===----------------------------------------------------------------------===//
+// Command list optimization
+//===----------------------------------------------------------------------===//
+
+// Descriptor sets with an ordinal at or above this are never elided.
+#define IREE_HAL_CMD_MAX_TRACKED_DESCRIPTOR_SETS 4
+
+// Returns true if |cmd| is an execution barrier with only stage masks.
+// Memory and buffer barriers are left alone as merging them would require
+// allocating new storage.
+static bool iree_hal_cmd_is_simple_execution_barrier(
+    const iree_hal_cmd_header_t* cmd_header) {
+  if (cmd_header->type != IREE_HAL_CMD_EXECUTION_BARRIER) return false;
+  const iree_hal_cmd_execution_barrier_t* cmd =
+      (const iree_hal_cmd_execution_barrier_t*)cmd_header;
+  return cmd->memory_barrier_count == 0 && cmd->buffer_barrier_count == 0;
+}
+
+// Merges |next| into |cmd| if both are simple execution barriers with the same
+// flags. The merged barrier waits on the union of the source stages before
+// any of the union of the target stages and is at least as strong as the
+// pair.
+static bool iree_hal_cmd_try_merge_execution_barrier(
+    iree_hal_cmd_header_t* cmd_header, const iree_hal_cmd_header_t* next) {
+  if (!iree_hal_cmd_is_simple_execution_barrier(cmd_header) ||
+      !iree_hal_cmd_is_simple_execution_barrier(next)) {
+    return false;
+  }
+  iree_hal_cmd_execution_barrier_t* cmd =
+      (iree_hal_cmd_execution_barrier_t*)cmd_header;
+  const iree_hal_cmd_execution_barrier_t* next_cmd =
+      (const iree_hal_cmd_execution_barrier_t*)next;
+  if (cmd->flags != next_cmd->flags) return false;
+  cmd->source_stage_mask |= next_cmd->source_stage_mask;
+  cmd->target_stage_mask |= next_cmd->target_stage_mask;
+  return true;
+}
+
+// Merges |next| into |cmd| if both fill the same pattern into contiguous
+// ranges of the same buffer. Lengths are multiples of the pattern length so the
+// pattern remains in phase across the merged range.
+static bool iree_hal_cmd_try_merge_fill_buffer(
+    iree_hal_cmd_header_t* cmd_header, const iree_hal_cmd_header_t* next) {
+  if (cmd_header->type != IREE_HAL_CMD_FILL_BUFFER ||
+      next->type != IREE_HAL_CMD_FILL_BUFFER) {
+    return false;
+  }
+  iree_hal_cmd_fill_buffer_t* cmd = (iree_hal_cmd_fill_buffer_t*)cmd_header;
+  const iree_hal_cmd_fill_buffer_t* next_cmd =
+      (const iree_hal_cmd_fill_buffer_t*)next;
+  if (cmd->target_buffer != next_cmd->target_buffer ||
+      cmd->pattern_length != next_cmd->pattern_length ||
+      memcmp(&cmd->pattern, &next_cmd->pattern, cmd->pattern_length) != 0 ||
+      cmd->length == IREE_WHOLE_BUFFER ||
+      next_cmd->length == IREE_WHOLE_BUFFER ||
+      cmd->target_offset + cmd->length != next_cmd->target_offset) {
+    return false;
+  }
+  cmd->length += next_cmd->length;
+  return true;
+}
+
+// Merges |next| into |cmd| if both copy contiguous ranges between the same
+// pair of buffers. Copies within a single buffer are skipped as the second may
+// read what the first wrote.
+static bool iree_hal_cmd_try_merge_copy_buffer(
+    iree_hal_cmd_header_t* cmd_header, const iree_hal_cmd_header_t* next) {
+  if (cmd_header->type != IREE_HAL_CMD_COPY_BUFFER ||
+      next->type != IREE_HAL_CMD_COPY_BUFFER) {
+    return false;
+  }
+  iree_hal_cmd_copy_buffer_t* cmd = (iree_hal_cmd_copy_buffer_t*)cmd_header;
+  const iree_hal_cmd_copy_buffer_t* next_cmd =
+      (const iree_hal_cmd_copy_buffer_t*)next;
+  if (cmd->source_buffer == cmd->target_buffer ||
+      cmd->source_buffer != next_cmd->source_buffer ||
+      cmd->target_buffer != next_cmd->target_buffer ||
+      cmd->length == IREE_WHOLE_BUFFER ||
+      next_cmd->length == IREE_WHOLE_BUFFER ||
+      cmd->source_offset + cmd->length != next_cmd->source_offset ||
+      cmd->target_offset + cmd->length != next_cmd->target_offset) {
+    return false;
+  }
+  cmd->length += next_cmd->length;
+  return true;
+}
+
+static bool iree_hal_cmd_push_constants_equal(
+    const iree_hal_cmd_push_constants_t* lhs,
+    const iree_hal_cmd_push_constants_t* rhs) {
+  return lhs->pipeline_layout == rhs->pipeline_layout &&
+         lhs->offset == rhs->offset &&
+         lhs->values_length == rhs->values_length &&
+         memcmp(lhs->values, rhs->values, lhs->values_length) == 0;
+}
+
+// Indirect bindings compare equal when they reference the same binding table
+// slot as the table is fixed for the duration of a replay.
+static bool iree_hal_cmd_push_descriptor_set_equal(
+    const iree_hal_cmd_push_descriptor_set_t* lhs,
+    const iree_hal_cmd_push_descriptor_set_t* rhs) {
+  if (lhs->pipeline_layout != rhs->pipeline_layout || lhs->set != rhs->set ||
+      lhs->binding_count != rhs->binding_count) {
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < lhs->binding_count; ++i) {
+    const iree_hal_descriptor_set_binding_t* a = &lhs->bindings[i];
+    const iree_hal_descriptor_set_binding_t* b = &rhs->bindings[i];
+    if (a->binding != b->binding || a->buffer != b->buffer ||
+        (!a->buffer && a->buffer_slot != b->buffer_slot) ||
+        a->offset != b->offset || a->length != b->length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Pipeline state established by prior commands in the list.
+typedef struct iree_hal_cmd_state_t {
+  // Pipeline layout used by the most recent push. Pushing with a different
+  // layout may disturb all other state and resets tracking.
+  iree_hal_pipeline_layout_t* pipeline_layout;
+  // Most recent push constants command, if any.
+  const iree_hal_cmd_push_constants_t* push_constants;
+  // Most recent push descriptor set command for each tracked set ordinal.
+  const iree_hal_cmd_push_descriptor_set_t*
+      push_descriptor_sets[IREE_HAL_CMD_MAX_TRACKED_DESCRIPTOR_SETS];
+} iree_hal_cmd_state_t;
+
+static void iree_hal_cmd_state_reset(iree_hal_cmd_state_t* state,
+                                     iree_hal_pipeline_layout_t* layout) {
+  memset(state, 0, sizeof(*state));
+  state->pipeline_layout = layout;
+}
+
+// Returns true if |cmd| only re-establishes state already set by a prior
+// command and can be dropped. Otherwise updates |state| with its effects.
+static bool iree_hal_cmd_state_update(iree_hal_cmd_state_t* state,
+                                      const iree_hal_cmd_header_t* cmd_header) {
+  switch (cmd_header->type) {
+    case IREE_HAL_CMD_PUSH_CONSTANTS: {
+      const iree_hal_cmd_push_constants_t* cmd =
+          (const iree_hal_cmd_push_constants_t*)cmd_header;
+      if (cmd->pipeline_layout != state->pipeline_layout) {
+        iree_hal_cmd_state_reset(state, cmd->pipeline_layout);
+      } else if (state->push_constants &&
+                 iree_hal_cmd_push_constants_equal(state->push_constants,
+                                                   cmd)) {
+        return true;
+      }
+      state->push_constants = cmd;
+      return false;
+    }
+    case IREE_HAL_CMD_PUSH_DESCRIPTOR_SET: {
+      const iree_hal_cmd_push_descriptor_set_t* cmd =
+          (const iree_hal_cmd_push_descriptor_set_t*)cmd_header;
+      if (cmd->pipeline_layout != state->pipeline_layout) {
+        iree_hal_cmd_state_reset(state, cmd->pipeline_layout);
+      }
+      if (cmd->set >= IREE_HAL_CMD_MAX_TRACKED_DESCRIPTOR_SETS) return false;
+      const iree_hal_cmd_push_descriptor_set_t* prior =
+          state->push_descriptor_sets[cmd->set];
+      if (prior && iree_hal_cmd_push_descriptor_set_equal(prior, cmd)) {
+        return true;
+      }
+      state->push_descriptor_sets[cmd->set] = cmd;
+      return false;
+    }
+    case IREE_HAL_CMD_EXECUTE_COMMANDS:
+      // Nested command buffers may change any state.
+      iree_hal_cmd_state_reset(state, NULL);
+      return false;
+    default:
+      return false;
+  }
+}
+
+// Removes or merges commands that have no observable effect on the target
+// command buffer. Only adjacent transfers and barriers are merged; commands
+// are never reordered. Removed commands remain in the arena until reset.
+static void iree_hal_cmd_list_optimize(iree_hal_cmd_list_t* cmd_list) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cmd_state_t state;
+  iree_hal_cmd_state_reset(&state, NULL);
+  iree_hal_cmd_header_t* prev = NULL;
+  iree_hal_cmd_header_t* cmd = cmd_list->head;
+  while (cmd) {
+    iree_hal_cmd_header_t* next = cmd->next;
+    if (iree_hal_cmd_state_update(&state, cmd)) {
+      // Redundant state change: unlink and revisit with the same |prev|.
+      if (prev) {
+        prev->next = next;
+      } else {
+        cmd_list->head = next;
+      }
+      if (cmd_list->tail == cmd) cmd_list->tail = prev;
+      cmd = next;
+      continue;
+    }
+    // Fold as many following commands into |cmd| as possible.
+    while (next && (iree_hal_cmd_try_merge_execution_barrier(cmd, next) ||
+                    iree_hal_cmd_try_merge_fill_buffer(cmd, next) ||
+                    iree_hal_cmd_try_merge_copy_buffer(cmd, next))) {
+      next = next->next;
+      cmd->next = next;
+    }
+    if (!next) cmd_list->tail = cmd;
+    prev = cmd;
+    cmd = next;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 //===----------------------------------------------------------------------===//
 // Dynamic replay dispatch
 //===----------------------------------------------------------------------===//
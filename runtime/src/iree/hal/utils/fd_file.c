@@ -0,0 +1,237 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Needed for pread/pwrite with 64-bit offsets.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+
+#include "iree/hal/utils/fd_file.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_IOS) || \
+    defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+#define IREE_HAL_FD_FILE_AVAILABLE 1
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define IREE_HAL_FD_FILE_AVAILABLE 0
+#endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// iree_hal_fd_file_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_fd_file_t {
+  iree_hal_resource_t resource;
+  // Used to allocate this structure.
+  iree_allocator_t host_allocator;
+  // Allowed access bits.
+  iree_hal_memory_access_t access;
+  // Base file handle, retained.
+  iree_io_file_handle_t* handle;
+  // File descriptor from |handle|.
+  int fd;
+  // Length of the file when opened.
+  uint64_t length;
+} iree_hal_fd_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_fd_file_vtable;
+
+static iree_hal_fd_file_t* iree_hal_fd_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_fd_file_vtable);
+  return (iree_hal_fd_file_t*)base_value;
+}
+
+IREE_API_EXPORT bool iree_hal_fd_file_isa(iree_hal_file_t* file) {
+  return iree_hal_resource_is(file, &iree_hal_fd_file_vtable);
+}
+
+IREE_API_EXPORT int iree_hal_fd_file_descriptor(iree_hal_file_t* file) {
+  if (!iree_hal_fd_file_isa(file)) return -1;
+  return iree_hal_fd_file_cast(file)->fd;
+}
+
+#if IREE_HAL_FD_FILE_AVAILABLE
+
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file handle is not a file descriptor");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int fd = iree_io_file_handle_value(handle).fd;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to query file size");
+  }
+
+  iree_hal_fd_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  iree_hal_resource_initialize(&iree_hal_fd_file_vtable, &file->resource);
+  file->host_allocator = host_allocator;
+  file->access = access;
+  file->handle = handle;
+  iree_io_file_handle_retain(handle);
+  file->fd = fd;
+  file->length = (uint64_t)file_stat.st_size;
+
+  *out_file = (iree_hal_file_t*)file;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptor files not available on this "
+                          "platform");
+}
+
+#endif  // IREE_HAL_FD_FILE_AVAILABLE
+
+static void iree_hal_fd_file_destroy(iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_file_handle_release(file->handle);
+
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_memory_access_t iree_hal_fd_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  return file->access;
+}
+
+static uint64_t iree_hal_fd_file_length(iree_hal_file_t* base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  return file->length;
+}
+
+static iree_hal_buffer_t* iree_hal_fd_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  // File contents are not addressable by devices.
+  return NULL;
+}
+
+static iree_status_t iree_hal_fd_file_read(iree_hal_file_t* base_file,
+                                           uint64_t file_offset,
+                                           iree_hal_buffer_t* buffer,
+                                           iree_device_size_t buffer_offset,
+                                           iree_device_size_t length) {
+#if IREE_HAL_FD_FILE_AVAILABLE
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+
+  // Read directly into the mapped buffer memory.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+      buffer_offset, length, &mapping));
+  iree_status_t status = iree_ok_status();
+  uint8_t* target = mapping.contents.data;
+  iree_host_size_t remaining = mapping.contents.data_length;
+  while (remaining > 0) {
+    ssize_t read_length =
+        pread(file->fd, target, remaining, (off_t)file_offset);
+    if (read_length < 0) {
+      if (errno == EINTR) continue;
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to read file at offset %" PRIu64,
+                                file_offset);
+      break;
+    } else if (read_length == 0) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "unexpected end of file at offset %" PRIu64,
+                                file_offset);
+      break;
+    }
+    target += read_length;
+    remaining -= (iree_host_size_t)read_length;
+    file_offset += (uint64_t)read_length;
+  }
+  if (iree_status_is_ok(status) &&
+      !iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_flush_range(&mapping, 0, IREE_WHOLE_BUFFER);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+#else
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+#endif  // IREE_HAL_FD_FILE_AVAILABLE
+}
+
+static iree_status_t iree_hal_fd_file_write(iree_hal_file_t* base_file,
+                                            uint64_t file_offset,
+                                            iree_hal_buffer_t* buffer,
+                                            iree_device_size_t buffer_offset,
+                                            iree_device_size_t length) {
+#if IREE_HAL_FD_FILE_AVAILABLE
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+
+  // Write directly from the mapped buffer memory.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ,
+      buffer_offset, length, &mapping));
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_invalidate_range(&mapping, 0,
+                                                      IREE_WHOLE_BUFFER);
+  }
+  const uint8_t* source = mapping.contents.data;
+  iree_host_size_t remaining = mapping.contents.data_length;
+  while (iree_status_is_ok(status) && remaining > 0) {
+    ssize_t write_length =
+        pwrite(file->fd, source, remaining, (off_t)file_offset);
+    if (write_length < 0) {
+      if (errno == EINTR) continue;
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to write file at offset %" PRIu64,
+                                file_offset);
+      break;
+    }
+    source += write_length;
+    remaining -= (iree_host_size_t)write_length;
+    file_offset += (uint64_t)write_length;
+  }
+  if (iree_status_is_ok(status)) {
+    file->length = iree_max(file->length, file_offset);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+#else
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+#endif  // IREE_HAL_FD_FILE_AVAILABLE
+}
+
+static const iree_hal_file_vtable_t iree_hal_fd_file_vtable = {
+    .destroy = iree_hal_fd_file_destroy,
+    .allowed_access = iree_hal_fd_file_allowed_access,
+    .length = iree_hal_fd_file_length,
+    .storage_buffer = iree_hal_fd_file_storage_buffer,
+    .read = iree_hal_fd_file_read,
+    .write = iree_hal_fd_file_write,
+};
@@ -0,0 +1,43 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_FD_FILE_H_
+#define IREE_HAL_UTILS_FD_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_fd_file_t
+//===----------------------------------------------------------------------===//
+
+// Creates a file backed by the IREE_IO_FILE_HANDLE_TYPE_FD |handle|.
+// Reads and writes are performed with positional IO (pread/pwrite) directly
+// into/out of mapped buffers and never move the descriptor file position.
+// The handle is retained for the lifetime of the file.
+//
+// Returns IREE_STATUS_UNAVAILABLE on platforms without file descriptors.
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file);
+
+// Returns true if |file| is a file descriptor file.
+IREE_API_EXPORT bool iree_hal_fd_file_isa(iree_hal_file_t* file);
+
+// Returns the file descriptor backing |file| or -1 if |file| is not a file
+// descriptor file. The descriptor remains owned by the file.
+IREE_API_EXPORT int iree_hal_fd_file_descriptor(iree_hal_file_t* file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_FD_FILE_H_
@@ -10,6 +10,8 @@
 #include "iree/base/internal/synchronization.h"
 
 typedef struct iree_hal_file_cache_entry_t {
+  // Next entry in the same hash bucket.
+  struct iree_hal_file_cache_entry_t* next;
   iree_io_file_handle_t* handle;
   iree_hal_device_t* device;
   iree_hal_queue_affinity_t queue_affinity;
@@ -17,21 +19,27 @@ typedef struct iree_hal_file_cache_entry_t {
   iree_hal_file_t* file;
 } iree_hal_file_cache_entry_t;
 
+// Initial number of hash buckets allocated on first insertion.
+#define IREE_HAL_FILE_CACHE_INITIAL_BUCKET_COUNT 16
+
 struct iree_hal_file_cache_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
 
-  // Guards mutation of the entries list.
+  // Guards the hash table. Lookups scan a bucket with the lock held shared and
+  // only take it exclusively to insert new entries or trim. Imports happen
+  // without the lock held so that multiple files can be imported concurrently.
   // NOTE: this does not guard the entries themselves as we assume they are
   // immutable (today).
-  iree_slim_mutex_t mutex;
+  iree_slim_rwlock_t lock;
 
-  // Total capacity of the entries list in elements.
-  iree_host_size_t entry_capacity;
-  // Currently used entry count in elements.
+  // Total number of entries across all buckets.
   iree_host_size_t entry_count;
-  // Dense list of entries in the cache. Grows as needed.
-  iree_hal_file_cache_entry_t** entries;
+  // Number of hash buckets; always a power of two or 0 before first use.
+  iree_host_size_t bucket_count;
+  // Bucket chains of entries indexed by the hash of the file handle and
+  // device. Grows as needed to keep chains short.
+  iree_hal_file_cache_entry_t** buckets;
 };
 
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
@@ -47,13 +55,13 @@ IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
   iree_atomic_ref_count_init(&file_cache->ref_count);
   file_cache->host_allocator = host_allocator;
 
-  iree_slim_mutex_initialize(&file_cache->mutex);
+  iree_slim_rwlock_initialize(&file_cache->lock);
 
   // Grown on first use. We could allocate a bit of inline storage or take an
   // optional initial capacity for callers that know.
-  file_cache->entry_capacity = 0;
   file_cache->entry_count = 0;
-  file_cache->entries = NULL;
+  file_cache->bucket_count = 0;
+  file_cache->buckets = NULL;
 
   *out_file_cache = file_cache;
   IREE_TRACE_ZONE_END(z0);
@@ -67,7 +75,7 @@ static void iree_hal_file_cache_destroy(iree_hal_file_cache_t* file_cache) {
 
   iree_hal_file_cache_trim(file_cache);
 
-  iree_slim_mutex_deinitialize(&file_cache->mutex);
+  iree_slim_rwlock_deinitialize(&file_cache->lock);
 
   iree_allocator_free(host_allocator, file_cache);
 
@@ -95,55 +103,91 @@ IREE_API_EXPORT void iree_hal_file_cache_trim(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_allocator_t host_allocator = file_cache->host_allocator;
 
-  iree_slim_mutex_lock(&file_cache->mutex);
-
-  for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
-    iree_hal_file_cache_entry_t* entry = file_cache->entries[i];
-    iree_hal_file_release(entry->file);
-    iree_hal_device_release(entry->device);
-    iree_io_file_handle_release(entry->handle);
-    iree_allocator_free(host_allocator, entry);
-  }
+  // Detach the table under the lock and release the entries outside of it as
+  // releasing files may call back into drivers.
+  iree_slim_rwlock_lock(&file_cache->lock);
+  iree_hal_file_cache_entry_t** buckets = file_cache->buckets;
+  iree_host_size_t bucket_count = file_cache->bucket_count;
+  file_cache->buckets = NULL;
+  file_cache->bucket_count = 0;
   file_cache->entry_count = 0;
-  if (file_cache->entries) {
-    iree_allocator_free(host_allocator, file_cache->entries);
-    file_cache->entries = NULL;
-    file_cache->entry_capacity = 0;
+  iree_slim_rwlock_unlock(&file_cache->lock);
+
+  for (iree_host_size_t i = 0; i < bucket_count; ++i) {
+    iree_hal_file_cache_entry_t* entry = buckets[i];
+    while (entry) {
+      iree_hal_file_cache_entry_t* next = entry->next;
+      iree_hal_file_release(entry->file);
+      iree_hal_device_release(entry->device);
+      iree_io_file_handle_release(entry->handle);
+      iree_allocator_free(host_allocator, entry);
+      entry = next;
+    }
   }
-
-  iree_slim_mutex_unlock(&file_cache->mutex);
+  iree_allocator_free(host_allocator, buckets);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
-static iree_status_t iree_hal_file_cache_reserve_unsafe(
-    iree_hal_file_cache_t* file_cache, iree_host_size_t new_capacity) {
-  IREE_ASSERT_ARGUMENT(file_cache);
-  if (new_capacity < file_cache->entry_capacity) return iree_ok_status();
+// Returns the hash of the |handle| and |device| pair used to select buckets.
+// Both are pointers whose low bits carry no information so we use a
+// multiplicative hash to spread the high bits.
+static inline uint64_t iree_hal_file_cache_hash(iree_io_file_handle_t* handle,
+                                                iree_hal_device_t* device) {
+  uint64_t value = (uint64_t)(uintptr_t)handle ^
+                   ((uint64_t)(uintptr_t)device * 0x9E3779B97F4A7C15ull);
+  return (value * 0x9E3779B97F4A7C15ull) >> 32;
+}
+
+// Returns the head of the bucket chain for |handle| and |device|.
+// Must be called with the lock held and at least one bucket allocated.
+static inline iree_hal_file_cache_entry_t** iree_hal_file_cache_bucket_unsafe(
+    iree_hal_file_cache_t* file_cache, iree_io_file_handle_t* handle,
+    iree_hal_device_t* device) {
+  return &file_cache->buckets[iree_hal_file_cache_hash(handle, device) &
+                              (file_cache->bucket_count - 1)];
+}
+
+// Grows the hash table to |new_bucket_count| buckets and rehashes all entries.
+static iree_status_t iree_hal_file_cache_rehash_unsafe(
+    iree_hal_file_cache_t* file_cache, iree_host_size_t new_bucket_count) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_bucket_count);
 
-  iree_hal_file_cache_entry_t** new_entries = file_cache->entries;
-  iree_status_t status = iree_allocator_realloc(
-      file_cache->host_allocator, new_capacity * sizeof(file_cache->entries[0]),
-      (void**)&new_entries);
-  if (iree_status_is_ok(status)) {
-    file_cache->entry_capacity = new_capacity;
-    file_cache->entries = new_entries;
+  iree_hal_file_cache_entry_t** new_buckets = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(file_cache->host_allocator,
+                                new_bucket_count * sizeof(new_buckets[0]),
+                                (void**)&new_buckets));
+  for (iree_host_size_t i = 0; i < file_cache->bucket_count; ++i) {
+    iree_hal_file_cache_entry_t* entry = file_cache->buckets[i];
+    while (entry) {
+      iree_hal_file_cache_entry_t* next = entry->next;
+      iree_host_size_t bucket_index =
+          iree_hal_file_cache_hash(entry->handle, entry->device) &
+          (new_bucket_count - 1);
+      entry->next = new_buckets[bucket_index];
+      new_buckets[bucket_index] = entry;
+      entry = next;
+    }
   }
+  iree_allocator_free(file_cache->host_allocator, file_cache->buckets);
+  file_cache->buckets = new_buckets;
+  file_cache->bucket_count = new_bucket_count;
 
   IREE_TRACE_ZONE_END(z0);
-  return status;
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_file_cache_insert_unsafe(
     iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
     iree_io_file_handle_t* handle, iree_hal_file_t* file) {
-  // Ensure there's space to grow the cache table.
-  if (file_cache->entry_count == file_cache->entry_capacity) {
-    IREE_RETURN_IF_ERROR(iree_hal_file_cache_reserve_unsafe(
-        file_cache, iree_max(16u, file_cache->entry_capacity * 2)));
+  // Keep the load factor at or below 1 so that chains stay short.
+  if (file_cache->entry_count >= file_cache->bucket_count) {
+    IREE_RETURN_IF_ERROR(iree_hal_file_cache_rehash_unsafe(
+        file_cache, iree_max(IREE_HAL_FILE_CACHE_INITIAL_BUCKET_COUNT,
+                             file_cache->bucket_count * 2)));
   }
 
   // Allocate the cache entry and retain all resources.
@@ -159,57 +203,115 @@ static iree_status_t iree_hal_file_cache_insert_unsafe(
   entry->file = file;
   iree_hal_file_retain(entry->file);
 
+  iree_hal_file_cache_entry_t** bucket =
+      iree_hal_file_cache_bucket_unsafe(file_cache, handle, device);
+  entry->next = *bucket;
+  *bucket = entry;
+  ++file_cache->entry_count;
   return iree_ok_status();
 }
 
+// Scans the cache for an already imported file compatible with the request.
+// Returns a retained file or NULL if none is found. Must be called with the
+// lock held (shared or exclusive).
+static iree_hal_file_t* iree_hal_file_cache_find_unsafe(
+    iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle) {
+  if (!file_cache->bucket_count) return NULL;
+  for (iree_hal_file_cache_entry_t* entry =
+           *iree_hal_file_cache_bucket_unsafe(file_cache, handle, device);
+       entry; entry = entry->next) {
+    if (entry->device == device && entry->handle == handle &&
+        iree_all_bits_set(entry->queue_affinity, queue_affinity) &&
+        iree_all_bits_set(entry->access, access)) {
+      iree_hal_file_retain(entry->file);
+      return entry->file;
+    }
+  }
+  return NULL;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup(
     iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
     iree_io_file_handle_t* handle, iree_hal_external_file_flags_t flags,
     iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(handle);
+  return iree_hal_file_cache_lookup_batch(file_cache, device, queue_affinity,
+                                          access, 1, &handle, flags, out_file);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup_batch(
+    iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_host_size_t count, iree_io_file_handle_t* const* handles,
+    iree_hal_external_file_flags_t flags, iree_hal_file_t** out_files) {
   IREE_ASSERT_ARGUMENT(file_cache);
   IREE_ASSERT_ARGUMENT(device);
-  IREE_ASSERT_ARGUMENT(handle);
-  IREE_ASSERT_ARGUMENT(out_file);
-  *out_file = NULL;
+  IREE_ASSERT_ARGUMENT(!count || handles);
+  IREE_ASSERT_ARGUMENT(!count || out_files);
+  if (count) memset(out_files, 0, count * sizeof(*out_files));
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_slim_mutex_lock(&file_cache->mutex);
-
-  // Scan the cache to see if we have an already imported file we can use.
-  for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
-    iree_hal_file_cache_entry_t* entry = file_cache->entries[i];
-    if (entry->device == device &&
-        iree_all_bits_set(entry->queue_affinity, queue_affinity) &&
-        iree_all_bits_set(entry->access, access) && entry->handle == handle) {
-      iree_hal_file_t* file = entry->file;
-      iree_hal_file_retain(file);
-      iree_slim_mutex_unlock(&file_cache->mutex);
-      *out_file = file;
-      IREE_TRACE_ZONE_END(z0);
-      return iree_ok_status();
-    }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  // Scan the cache to see if we have already imported files we can use.
+  // Hits are the common case and only need the lock shared.
+  iree_host_size_t miss_count = 0;
+  iree_slim_rwlock_lock_shared(&file_cache->lock);
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    out_files[i] = iree_hal_file_cache_find_unsafe(
+        file_cache, device, queue_affinity, access, handles[i]);
+    if (!out_files[i]) ++miss_count;
+  }
+  iree_slim_rwlock_unlock_shared(&file_cache->lock);
+  if (!miss_count) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, miss_count);
+
+  // Import the missing files without holding the lock. Imports can be slow
+  // (registering memory with devices, opening platform file handles, etc) and
+  // this allows lookups of other files and imports on other threads to
+  // proceed in parallel.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    if (out_files[i]) continue;
+    status = iree_hal_file_import(device, queue_affinity, access, handles[i],
+                                  flags, &out_files[i]);
   }
 
-  // Import the file. This could be slow and ideally we'd not hold the mutex
-  // such that other files can still be accessed through the cache but (today)
-  // it's unexpected that file I/O initialization is a hot path.
-  iree_hal_file_t* file = NULL;
-  iree_status_t status = iree_hal_file_import(device, queue_affinity, access,
-                                              handle, flags, &file);
-
-  // Insert into cache as an append.
-  // If we support removal we'll compact the entries list at the time an entry
-  // is removed to keep this simple.
+  // Insert all imported files with a single exclusive lock acquisition.
+  // Another thread may have imported the same file while we were not holding
+  // the lock in which case we drop ours and use the cached one so that only a
+  // single file per handle is retained.
   if (iree_status_is_ok(status)) {
-    status = iree_hal_file_cache_insert_unsafe(
-        file_cache, device, queue_affinity, access, handle, file);
+    iree_slim_rwlock_lock(&file_cache->lock);
+    for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status);
+         ++i) {
+      iree_hal_file_t* cached_file = iree_hal_file_cache_find_unsafe(
+          file_cache, device, queue_affinity, access, handles[i]);
+      if (cached_file == out_files[i]) {
+        // Hit in the initial scan (or a duplicate handle in the batch).
+        iree_hal_file_release(cached_file);
+      } else if (cached_file) {
+        iree_hal_file_release(out_files[i]);
+        out_files[i] = cached_file;
+      } else {
+        status = iree_hal_file_cache_insert_unsafe(
+            file_cache, device, queue_affinity, access, handles[i],
+            out_files[i]);
+      }
+    }
+    iree_slim_rwlock_unlock(&file_cache->lock);
   }
 
-  iree_slim_mutex_unlock(&file_cache->mutex);
-  if (iree_status_is_ok(status)) {
-    *out_file = file;
-  } else {
-    iree_hal_file_release(file);
+  if (!iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_hal_file_release(out_files[i]);
+      out_files[i] = NULL;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -19,6 +19,18 @@ extern "C" {
 // HAL file reference. A single file cache may be shared across multiple devices
 // and/or multiple queues within individual devices.
 //
+// Cached files retain whatever device resources their import produced (such
+// as registered host memory or GPU direct storage handles) until the cache is
+// trimmed. Sharing a cache across sessions using the same devices avoids
+// paying for those registrations again in each session.
+//
+// Entries are indexed by a hash of the file handle and device and lookups
+// only take a shared lock. Files are imported without the lock held so that
+// independent imports can proceed concurrently. Use
+// iree_hal_file_cache_lookup_batch to resolve many files (such as all
+// parameters from an archive) with a single lock acquisition for hits and one
+// for inserting misses.
+//
 // Thread-safe: multiple threads can access the cache concurrently.
 typedef struct iree_hal_file_cache_t iree_hal_file_cache_t;
 
@@ -51,6 +63,18 @@ IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup(
     iree_io_file_handle_t* handle, iree_hal_external_file_flags_t flags,
     iree_hal_file_t** out_file);
 
+// Looks up |count| file |handles| for use on |device| with any of the queues
+// specified with |queue_affinity| and returns them retained in the
+// corresponding elements of |out_files|. Equivalent to calling
+// iree_hal_file_cache_lookup for each handle but with cache hits resolved
+// under a single lock acquisition and misses imported without holding the lock
+// and then inserted together. On failure no files are returned.
+IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup_batch(
+    iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_host_size_t count, iree_io_file_handle_t* const* handles,
+    iree_hal_external_file_flags_t flags, iree_hal_file_t** out_files);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
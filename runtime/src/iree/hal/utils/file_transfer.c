@@ -7,6 +7,8 @@
 #include "iree/hal/utils/file_transfer.h"
 
 #include "iree/base/internal/math.h"
+#include "iree/hal/utils/fd_file.h"
+#include "iree/hal/utils/io_uring.h"
 #include "iree/hal/utils/memory_file.h"
 
 //===----------------------------------------------------------------------===//
@@ -36,6 +38,17 @@
 #define IREE_HAL_TRANSFER_CHUNKS_PER_WORKER 8
 #endif  // IREE_HAL_TRANSFER_CHUNKS_PER_WORKER
 
+#if !defined(IREE_HAL_TRANSFER_IO_URING_DEPTH)
+// Maximum number of io_uring reads in flight per transfer operation.
+#define IREE_HAL_TRANSFER_IO_URING_DEPTH 32
+#endif  // !IREE_HAL_TRANSFER_IO_URING_DEPTH
+
+#if !defined(IREE_HAL_TRANSFER_IO_URING_CHUNK_SIZE)
+// Bytes per io_uring read request. Smaller requests allow the kernel to
+// parallelize a transfer across more of the storage device queues.
+#define IREE_HAL_TRANSFER_IO_URING_CHUNK_SIZE (1 * 1024 * 1024)
+#endif  // !IREE_HAL_TRANSFER_IO_URING_CHUNK_SIZE
+
 //===----------------------------------------------------------------------===//
 // iree_hal_transfer_operation_t
 //===----------------------------------------------------------------------===//
@@ -825,6 +838,453 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
   return iree_ok_status();  // return ok as loop is fine but operation is not
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_uring_read_operation_t
+//===----------------------------------------------------------------------===//
+
+// Reads from file descriptor-backed files into host-visible buffers are issued
+// directly into the mapped buffer memory with many reads in flight at a time.
+// There's no staging buffer or device copy and the loop is only woken as
+// reads complete so that the first parameters loaded can be used by work
+// waiting on the signal semaphores of earlier reads.
+
+// A single outstanding read request.
+typedef struct iree_hal_uring_read_request_t {
+  // Offset into the transfer of the remaining request range.
+  iree_device_size_t offset;
+  // Remaining length of the request or 0 if the slot is unused.
+  uint32_t length;
+} iree_hal_uring_read_request_t;
+
+// Manages an asynchronous io_uring read from a file into a mapped buffer.
+typedef struct iree_hal_uring_read_operation_t {
+  // Device the transfer was issued on.
+  iree_hal_device_t* device;
+  // Used to associate tracing events with this operation.
+  IREE_TRACE(int32_t trace_id;)
+
+  // Retained file resource and its descriptor.
+  iree_hal_file_t* file;
+  int fd;
+  // Offset into the file where the operation begins.
+  uint64_t file_offset;
+  // Retained buffer resource.
+  iree_hal_buffer_t* buffer;
+  // Offset into the buffer where the operation begins.
+  iree_device_size_t buffer_offset;
+  // Total length of the operation.
+  iree_device_size_t length;
+  // Scoped mapping of the target buffer range valid while reads are issued.
+  iree_hal_buffer_mapping_t mapping;
+  bool is_mapped;
+
+  // Ring all reads are issued on.
+  iree_hal_io_uring_t ring;
+  // Maximum bytes per read request.
+  uint32_t chunk_size;
+  // Offset to where the transfer head is in the operation.
+  // Ranges from 0 at the start and length at the end.
+  iree_device_size_t transfer_head;
+  // Total number of requests in flight in the kernel.
+  iree_host_size_t inflight_count;
+  // Request slots with the index passed as the completion user data.
+  iree_host_size_t request_count;
+  iree_hal_uring_read_request_t requests[IREE_HAL_TRANSFER_IO_URING_DEPTH];
+
+  // Sticky error status; when set no new reads are issued and the signal
+  // semaphores will be failed once all in-flight reads have completed.
+  iree_status_t error_status;
+  // Original user semaphores to wait on before starting the operation.
+  // Contents are stored at the end of the struct.
+  iree_hal_semaphore_list_t wait_semaphore_list;
+  // Original user semaphores to signal at the end of the transfer operation.
+  // Contents are stored at the end of the struct.
+  iree_hal_semaphore_list_t signal_semaphore_list;
+} iree_hal_uring_read_operation_t;
+
+static void iree_hal_uring_read_operation_destroy(
+    iree_hal_uring_read_operation_t* operation);
+
+// Clones |source_list| into |storage| and retains each semaphore.
+static iree_hal_semaphore_list_t iree_hal_uring_clone_semaphore_list(
+    iree_hal_semaphore_list_t source_list, uint8_t* storage) {
+  iree_hal_semaphore_list_t list = {
+      .count = source_list.count,
+      .semaphores = (iree_hal_semaphore_t**)storage,
+      .payload_values =
+          (uint64_t*)(storage +
+                      source_list.count * sizeof(source_list.semaphores[0])),
+  };
+  for (iree_host_size_t i = 0; i < source_list.count; ++i) {
+    list.semaphores[i] = source_list.semaphores[i];
+    iree_hal_semaphore_retain(list.semaphores[i]);
+    list.payload_values[i] = source_list.payload_values[i];
+  }
+  return list;
+}
+
+static void iree_hal_uring_release_semaphore_list(
+    iree_hal_semaphore_list_t list) {
+  for (iree_host_size_t i = 0; i < list.count; ++i) {
+    iree_hal_semaphore_release(list.semaphores[i]);
+  }
+}
+
+// Creates an io_uring read operation. Returns IREE_STATUS_UNAVAILABLE if
+// io_uring cannot be used and the caller should fall back to staging.
+static iree_status_t iree_hal_uring_read_operation_create(
+    iree_hal_device_t* device,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* file, int fd, uint64_t file_offset,
+    iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length,
+    iree_hal_file_transfer_options_t options,
+    iree_hal_uring_read_operation_t** out_operation) {
+  IREE_ASSERT_ARGUMENT(out_operation);
+  *out_operation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(device);
+
+  // Semaphore lists are stored at the end of the struct.
+  const iree_host_size_t semaphore_entry_size =
+      sizeof(iree_hal_semaphore_t*) + sizeof(uint64_t);
+  iree_hal_uring_read_operation_t* operation = NULL;
+  iree_host_size_t wait_list_offset =
+      iree_host_align(sizeof(*operation), iree_max_align_t);
+  iree_host_size_t signal_list_offset =
+      wait_list_offset + wait_semaphore_list.count * semaphore_entry_size;
+  iree_host_size_t total_size =
+      signal_list_offset + signal_semaphore_list.count * semaphore_entry_size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&operation));
+  memset(operation, 0, sizeof(*operation));
+
+  // Initialize the ring first as it's the most likely to fail and we can
+  // avoid retaining anything.
+  iree_status_t status = iree_hal_io_uring_initialize(
+      IREE_HAL_TRANSFER_IO_URING_DEPTH, &operation->ring);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, operation);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  operation->device = device;
+  iree_hal_device_retain(device);
+  operation->file = file;
+  iree_hal_file_retain(file);
+  operation->fd = fd;
+  operation->file_offset = file_offset;
+  operation->buffer = buffer;
+  iree_hal_buffer_retain(buffer);
+  operation->buffer_offset = buffer_offset;
+  operation->length = length;
+  operation->chunk_size = IREE_HAL_TRANSFER_IO_URING_CHUNK_SIZE;
+  if (options.chunk_size != IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT) {
+    operation->chunk_size =
+        (uint32_t)iree_min(options.chunk_size, (iree_device_size_t)UINT32_MAX);
+  }
+  operation->request_count =
+      iree_min(operation->ring.sq_entries, IREE_HAL_TRANSFER_IO_URING_DEPTH);
+  operation->wait_semaphore_list = iree_hal_uring_clone_semaphore_list(
+      wait_semaphore_list, (uint8_t*)operation + wait_list_offset);
+  operation->signal_semaphore_list = iree_hal_uring_clone_semaphore_list(
+      signal_semaphore_list, (uint8_t*)operation + signal_list_offset);
+
+  IREE_TRACE({
+    static iree_atomic_int32_t next_trace_id = IREE_ATOMIC_VAR_INIT(0);
+    operation->trace_id = iree_atomic_fetch_add_int32(
+        &next_trace_id, 1, iree_memory_order_seq_cst);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  });
+
+  *out_operation = operation;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_uring_read_operation_destroy(
+    iree_hal_uring_read_operation_t* operation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  iree_allocator_t host_allocator =
+      iree_hal_device_host_allocator(operation->device);
+
+  IREE_ASSERT(operation->inflight_count == 0, "all reads must have completed");
+  iree_hal_io_uring_deinitialize(&operation->ring);
+  iree_hal_uring_release_semaphore_list(operation->wait_semaphore_list);
+  iree_hal_uring_release_semaphore_list(operation->signal_semaphore_list);
+  iree_hal_buffer_release(operation->buffer);
+  iree_hal_file_release(operation->file);
+  iree_hal_device_t* device = operation->device;
+  iree_status_ignore(operation->error_status);
+  iree_allocator_free(host_allocator, operation);
+  iree_hal_device_release(device);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Sets the sticky error on |operation| if it is the first failure.
+static void iree_hal_uring_read_operation_fail(
+    iree_hal_uring_read_operation_t* operation, iree_status_t status) {
+  if (iree_status_is_ok(operation->error_status)) {
+    operation->error_status = status;
+  } else {
+    iree_status_ignore(status);
+  }
+}
+
+// Completes the operation by unmapping the buffer and signaling or failing the
+// user semaphores. Blocks if any reads are still in flight as they target the
+// mapped memory.
+//
+// Post-condition: the operation is freed.
+static void iree_hal_uring_read_operation_complete(
+    iree_hal_uring_read_operation_t* operation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+
+  // Drain any reads still in flight; this only happens on failure paths where
+  // we could not wait asynchronously.
+  while (operation->inflight_count > 0) {
+    iree_status_t status = iree_hal_io_uring_wait(
+        &operation->ring, (uint32_t)operation->inflight_count);
+    uint64_t user_data = 0;
+    int32_t result = 0;
+    while (iree_hal_io_uring_reap(&operation->ring, &user_data, &result)) {
+      --operation->inflight_count;
+    }
+    if (!iree_status_is_ok(status)) {
+      // Can't safely unmap memory the kernel may still be writing to so we
+      // intentionally leak the operation.
+      iree_hal_semaphore_list_fail(operation->signal_semaphore_list, status);
+      IREE_TRACE_ZONE_END(z0);
+      return;
+    }
+  }
+
+  if (operation->is_mapped) {
+    if (iree_status_is_ok(operation->error_status) &&
+        !iree_all_bits_set(iree_hal_buffer_memory_type(operation->buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+      iree_hal_uring_read_operation_fail(
+          operation, iree_hal_buffer_mapping_flush_range(
+                         &operation->mapping, 0, operation->length));
+    }
+    iree_hal_uring_read_operation_fail(
+        operation, iree_hal_buffer_unmap_range(&operation->mapping));
+    operation->is_mapped = false;
+  }
+
+  if (iree_status_is_ok(operation->error_status)) {
+    iree_hal_uring_read_operation_fail(
+        operation,
+        iree_hal_semaphore_list_signal(operation->signal_semaphore_list));
+  }
+  if (!iree_status_is_ok(operation->error_status)) {
+    iree_hal_semaphore_list_fail(operation->signal_semaphore_list,
+                                 operation->error_status);
+    operation->error_status = iree_ok_status();
+  }
+
+  iree_hal_uring_read_operation_destroy(operation);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Enqueues reads into free request slots until the transfer is fully issued or
+// the ring is full and then submits them to the kernel.
+static iree_status_t iree_hal_uring_read_operation_issue(
+    iree_hal_uring_read_operation_t* operation) {
+  uint8_t* target_ptr = operation->mapping.contents.data;
+  for (iree_host_size_t i = 0; i < operation->request_count &&
+                               operation->transfer_head < operation->length;
+       ++i) {
+    iree_hal_uring_read_request_t* request = &operation->requests[i];
+    if (request->length > 0) continue;
+    request->offset = operation->transfer_head;
+    request->length = (uint32_t)iree_min(
+        (iree_device_size_t)operation->chunk_size,
+        operation->length - operation->transfer_head);
+    if (!iree_hal_io_uring_enqueue_read(
+            &operation->ring, operation->fd, target_ptr + request->offset,
+            request->length, operation->file_offset + request->offset, i)) {
+      request->length = 0;
+      break;
+    }
+    operation->transfer_head += request->length;
+    ++operation->inflight_count;
+  }
+  return iree_hal_io_uring_submit(&operation->ring);
+}
+
+// Processes all available completions, re-issuing short reads and filling
+// freed slots with new reads.
+static void iree_hal_uring_read_operation_process(
+    iree_hal_uring_read_operation_t* operation) {
+  uint8_t* target_ptr = operation->mapping.contents.data;
+  uint64_t user_data = 0;
+  int32_t result = 0;
+  while (iree_hal_io_uring_reap(&operation->ring, &user_data, &result)) {
+    --operation->inflight_count;
+    iree_hal_uring_read_request_t* request = &operation->requests[user_data];
+    if (result < 0) {
+      iree_hal_uring_read_operation_fail(
+          operation,
+          iree_make_status(iree_status_code_from_errno(-result),
+                           "file read of %u bytes at offset %" PRIu64
+                           " failed",
+                           request->length,
+                           operation->file_offset + request->offset));
+      request->length = 0;
+    } else if (result == 0) {
+      iree_hal_uring_read_operation_fail(
+          operation,
+          iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                           "file read at offset %" PRIu64
+                           " reached end of file with %u bytes remaining",
+                           operation->file_offset + request->offset,
+                           request->length));
+      request->length = 0;
+    } else if ((uint32_t)result < request->length &&
+               iree_status_is_ok(operation->error_status)) {
+      // Short read; reissue for the remainder in the same slot.
+      request->offset += (uint32_t)result;
+      request->length -= (uint32_t)result;
+      if (iree_hal_io_uring_enqueue_read(
+              &operation->ring, operation->fd, target_ptr + request->offset,
+              request->length, operation->file_offset + request->offset,
+              user_data)) {
+        ++operation->inflight_count;
+      } else {
+        iree_hal_uring_read_operation_fail(
+            operation, iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                        "io_uring submission queue full"));
+        request->length = 0;
+      }
+    } else {
+      request->length = 0;
+    }
+  }
+  if (iree_status_is_ok(operation->error_status)) {
+    iree_hal_uring_read_operation_fail(
+        operation, iree_hal_uring_read_operation_issue(operation));
+  } else {
+    // Submit any reissued short reads so that they still complete.
+    iree_status_ignore(iree_hal_io_uring_submit(&operation->ring));
+  }
+}
+
+static iree_status_t iree_hal_uring_read_operation_tick(void* user_data,
+                                                        iree_loop_t loop,
+                                                        iree_status_t status);
+
+// Waits for more completions or completes the operation if none are pending.
+static iree_status_t iree_hal_uring_read_operation_continue(
+    iree_hal_uring_read_operation_t* operation, iree_loop_t loop) {
+  if (operation->inflight_count > 0) {
+    iree_status_t status = iree_loop_wait_one(
+        loop, iree_hal_io_uring_await(&operation->ring),
+        iree_infinite_timeout(), iree_hal_uring_read_operation_tick, operation);
+    if (iree_status_is_ok(status)) return status;
+    iree_hal_uring_read_operation_fail(operation, status);
+  }
+  iree_hal_uring_read_operation_complete(operation);
+  return iree_ok_status();  // return ok as loop is fine but operation is not
+}
+
+// Handles completion notifications from the ring.
+static iree_status_t iree_hal_uring_read_operation_tick(void* user_data,
+                                                        iree_loop_t loop,
+                                                        iree_status_t status) {
+  iree_hal_uring_read_operation_t* operation =
+      (iree_hal_uring_read_operation_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_uring_read_operation_fail(operation, status);
+  }
+  iree_hal_io_uring_reset_wait_source(&operation->ring);
+  iree_hal_uring_read_operation_process(operation);
+  status = iree_hal_uring_read_operation_continue(operation, loop);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Maps the target buffer and issues the initial reads once the user wait
+// semaphores have been satisfied.
+static iree_status_t iree_hal_uring_read_operation_start(void* user_data,
+                                                         iree_loop_t loop,
+                                                         iree_status_t status) {
+  iree_hal_uring_read_operation_t* operation =
+      (iree_hal_uring_read_operation_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_range(
+        operation->buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, operation->buffer_offset,
+        operation->length, &operation->mapping);
+    operation->is_mapped = iree_status_is_ok(status);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_uring_read_operation_issue(operation);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_uring_read_operation_fail(operation, status);
+  }
+  status = iree_hal_uring_read_operation_continue(operation, loop);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Begins the transfer operation after the operation wait semaphores are
+// satisfied. If this fails then the transfer never started and the operation
+// has been freed without signaling.
+static iree_status_t iree_hal_uring_read_operation_launch(
+    iree_hal_uring_read_operation_t* operation, iree_loop_t loop) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)operation->trace_id);
+
+  iree_status_t status = iree_ok_status();
+  const iree_hal_semaphore_list_t wait_list = operation->wait_semaphore_list;
+  if (wait_list.count == 0) {
+    status = iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT,
+                            iree_hal_uring_read_operation_start, operation);
+  } else {
+    iree_wait_source_t* wait_sources = (iree_wait_source_t*)iree_alloca(
+        wait_list.count * sizeof(iree_wait_source_t));
+    for (iree_host_size_t i = 0; i < wait_list.count; ++i) {
+      wait_sources[i] = iree_hal_semaphore_await(wait_list.semaphores[i],
+                                                 wait_list.payload_values[i]);
+    }
+    status = iree_loop_wait_all(loop, wait_list.count, wait_sources,
+                                iree_infinite_timeout(),
+                                iree_hal_uring_read_operation_start, operation);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_uring_read_operation_destroy(operation);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns true if the read can be serviced by io_uring directly into the
+// mapped |target_buffer|.
+static bool iree_hal_uring_read_is_supported(iree_hal_file_t* source_file,
+                                             iree_hal_buffer_t* target_buffer,
+                                             iree_device_size_t length) {
+  if (!IREE_HAL_IO_URING_ENABLE || length == 0) return false;
+  if (iree_hal_fd_file_descriptor(source_file) < 0) return false;
+  return iree_all_bits_set(iree_hal_buffer_memory_type(target_buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(target_buffer),
+                           IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED);
+}
+
 //===----------------------------------------------------------------------===//
 // Memory file IO API
 //===----------------------------------------------------------------------===//
@@ -874,6 +1334,24 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
         target_offset, length);
   }
 
+  // If the file is backed by a file descriptor and the target is host-visible
+  // we can read directly into the buffer with many reads in flight. If io_uring
+  // is unavailable at runtime we fall back to the staging path.
+  if (iree_hal_uring_read_is_supported(source_file, target_buffer, length)) {
+    iree_hal_uring_read_operation_t* uring_operation = NULL;
+    iree_status_t status = iree_hal_uring_read_operation_create(
+        device, wait_semaphore_list, signal_semaphore_list, source_file,
+        iree_hal_fd_file_descriptor(source_file), source_offset, target_buffer,
+        target_offset, length, options, &uring_operation);
+    if (iree_status_is_ok(status)) {
+      return iree_hal_uring_read_operation_launch(uring_operation,
+                                                  options.loop);
+    } else if (!iree_status_is_unavailable(status)) {
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+
   // Allocate full transfer operation.
   iree_hal_transfer_operation_t* operation = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_transfer_operation_create(
@@ -0,0 +1,304 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+
+#include "iree/hal/utils/io_uring.h"
+
+#include <string.h>
+
+#if IREE_HAL_IO_URING_ENABLE
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// The kernel and user space communicate through shared ring indices; the
+// producer of each index publishes it with release semantics and the consumer
+// observes it with acquire semantics.
+#define iree_hal_io_uring_load_acquire(ptr) \
+  __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define iree_hal_io_uring_store_release(ptr, value) \
+  __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+static int iree_hal_io_uring_setup(uint32_t entries,
+                                   struct io_uring_params* params) {
+  return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int iree_hal_io_uring_enter(int ring_fd, uint32_t to_submit,
+                                   uint32_t min_complete, uint32_t flags) {
+  return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                      flags, NULL, 0);
+}
+
+static int iree_hal_io_uring_register(int ring_fd, uint32_t opcode,
+                                      const void* arg, uint32_t arg_count) {
+  return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, arg_count);
+}
+
+// Returns true if the kernel supports IORING_OP_READ on |ring_fd|.
+static bool iree_hal_io_uring_supports_read(int ring_fd) {
+  // Probing was added in the same kernel release as IORING_OP_READ (5.6) so
+  // failure to probe also indicates lack of support.
+  uint8_t storage[sizeof(struct io_uring_probe) +
+                  IORING_OP_LAST * sizeof(struct io_uring_probe_op)];
+  memset(storage, 0, sizeof(storage));
+  struct io_uring_probe* probe = (struct io_uring_probe*)storage;
+  if (iree_hal_io_uring_register(ring_fd, IORING_REGISTER_PROBE, probe,
+                                 IORING_OP_LAST) < 0) {
+    return false;
+  }
+  return probe->last_op >= IORING_OP_READ &&
+         (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+}
+
+iree_status_t iree_hal_io_uring_initialize(uint32_t queue_depth,
+                                           iree_hal_io_uring_t* out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_ring, 0, sizeof(*out_ring));
+  out_ring->ring_fd = -1;
+  out_ring->event_fd = -1;
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = iree_hal_io_uring_setup(queue_depth, &params);
+  if (ring_fd < 0) {
+    // ENOSYS (old kernel) and EPERM (sandboxed) both mean unavailable.
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "io_uring_setup failed (%d)", errno);
+  }
+  out_ring->ring_fd = ring_fd;
+
+  iree_status_t status = iree_ok_status();
+  if (!iree_hal_io_uring_supports_read(ring_fd)) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "io_uring does not support IORING_OP_READ");
+  }
+
+  // Map the submission and completion rings. Newer kernels allow both to be
+  // mapped with a single mapping.
+  if (iree_status_is_ok(status)) {
+    out_ring->sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    out_ring->cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      out_ring->sq_ring_size =
+          iree_max(out_ring->sq_ring_size, out_ring->cq_ring_size);
+    }
+    void* sq_ring_ptr =
+        mmap(NULL, out_ring->sq_ring_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    void* cq_ring_ptr = sq_ring_ptr;
+    if (sq_ring_ptr != MAP_FAILED && !single_mmap) {
+      cq_ring_ptr =
+          mmap(NULL, out_ring->cq_ring_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    }
+    if (sq_ring_ptr == MAP_FAILED || cq_ring_ptr == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to map io_uring rings");
+    }
+    out_ring->sq_ring_ptr = sq_ring_ptr != MAP_FAILED ? sq_ring_ptr : NULL;
+    out_ring->cq_ring_ptr = cq_ring_ptr != MAP_FAILED ? cq_ring_ptr : NULL;
+  }
+  if (iree_status_is_ok(status)) {
+    out_ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, out_ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to map io_uring submission entries");
+    } else {
+      out_ring->sqes = sqes;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    uint8_t* sq_ring = (uint8_t*)out_ring->sq_ring_ptr;
+    out_ring->sq_head = (uint32_t*)(sq_ring + params.sq_off.head);
+    out_ring->sq_tail = (uint32_t*)(sq_ring + params.sq_off.tail);
+    out_ring->sq_array = (uint32_t*)(sq_ring + params.sq_off.array);
+    out_ring->sq_mask = *(uint32_t*)(sq_ring + params.sq_off.ring_mask);
+    out_ring->sq_entries = params.sq_entries;
+    uint8_t* cq_ring = (uint8_t*)out_ring->cq_ring_ptr;
+    out_ring->cq_head = (uint32_t*)(cq_ring + params.cq_off.head);
+    out_ring->cq_tail = (uint32_t*)(cq_ring + params.cq_off.tail);
+    out_ring->cqes = cq_ring + params.cq_off.cqes;
+    out_ring->cq_mask = *(uint32_t*)(cq_ring + params.cq_off.ring_mask);
+  }
+
+  // Route completion notifications to an eventfd we can wait on.
+  if (iree_status_is_ok(status)) {
+    out_ring->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (out_ring->event_fd < 0 ||
+        iree_hal_io_uring_register(ring_fd, IORING_REGISTER_EVENTFD,
+                                   &out_ring->event_fd, 1) < 0) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to register io_uring eventfd");
+    }
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_io_uring_deinitialize(out_ring);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_io_uring_deinitialize(iree_hal_io_uring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring_ptr && ring->cq_ring_ptr != ring->sq_ring_ptr) {
+    munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+  }
+  if (ring->sq_ring_ptr) munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+  if (ring->event_fd >= 0) close(ring->event_fd);
+  if (ring->ring_fd >= 0) close(ring->ring_fd);
+  memset(ring, 0, sizeof(*ring));
+  ring->ring_fd = -1;
+  ring->event_fd = -1;
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_io_uring_enqueue_read(iree_hal_io_uring_t* ring, int fd,
+                                    void* target, uint32_t length,
+                                    uint64_t offset, uint64_t user_data) {
+  // We are the only producer of the tail so it can be read directly.
+  const uint32_t tail = *ring->sq_tail;
+  const uint32_t head = iree_hal_io_uring_load_acquire(ring->sq_head);
+  if (tail - head >= ring->sq_entries) return false;
+
+  const uint32_t index = tail & ring->sq_mask;
+  struct io_uring_sqe* sqe = &((struct io_uring_sqe*)ring->sqes)[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t)(uintptr_t)target;
+  sqe->len = length;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  ring->sq_array[index] = index;
+  iree_hal_io_uring_store_release(ring->sq_tail, tail + 1);
+  ++ring->unsubmitted_count;
+  return true;
+}
+
+iree_status_t iree_hal_io_uring_submit(iree_hal_io_uring_t* ring) {
+  while (ring->unsubmitted_count > 0) {
+    int submitted =
+        iree_hal_io_uring_enter(ring->ring_fd, ring->unsubmitted_count, 0, 0);
+    if (submitted < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "io_uring_enter failed");
+    }
+    ring->unsubmitted_count -= (uint32_t)submitted;
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_io_uring_wait(iree_hal_io_uring_t* ring,
+                                     uint32_t min_complete) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  while (iree_hal_io_uring_load_acquire(ring->cq_tail) - *ring->cq_head <
+         min_complete) {
+    if (iree_hal_io_uring_enter(ring->ring_fd, 0, min_complete,
+                                IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "io_uring_enter failed waiting on completions");
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+bool iree_hal_io_uring_reap(iree_hal_io_uring_t* ring, uint64_t* out_user_data,
+                            int32_t* out_result) {
+  // We are the only consumer of the head so it can be read directly.
+  const uint32_t head = *ring->cq_head;
+  const uint32_t tail = iree_hal_io_uring_load_acquire(ring->cq_tail);
+  if (head == tail) return false;
+  const struct io_uring_cqe* cqe =
+      &((const struct io_uring_cqe*)ring->cqes)[head & ring->cq_mask];
+  *out_user_data = cqe->user_data;
+  *out_result = cqe->res;
+  iree_hal_io_uring_store_release(ring->cq_head, head + 1);
+  return true;
+}
+
+iree_wait_source_t iree_hal_io_uring_await(iree_hal_io_uring_t* ring) {
+  iree_wait_primitive_value_t value;
+  memset(&value, 0, sizeof(value));
+  value.event.fd = ring->event_fd;
+  iree_wait_source_t wait_source = iree_wait_source_immediate();
+  iree_status_ignore(iree_wait_source_import(
+      iree_make_wait_primitive(IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD, value),
+      &wait_source));
+  return wait_source;
+}
+
+void iree_hal_io_uring_reset_wait_source(iree_hal_io_uring_t* ring) {
+  // The eventfd is non-blocking so this fails with EAGAIN if not signaled.
+  uint64_t count = 0;
+  ssize_t result = read(ring->event_fd, &count, sizeof(count));
+  (void)result;
+}
+
+#else
+
+iree_status_t iree_hal_io_uring_initialize(uint32_t queue_depth,
+                                           iree_hal_io_uring_t* out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  memset(out_ring, 0, sizeof(*out_ring));
+  out_ring->ring_fd = -1;
+  out_ring->event_fd = -1;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring not available on this platform");
+}
+
+void iree_hal_io_uring_deinitialize(iree_hal_io_uring_t* ring) {}
+
+bool iree_hal_io_uring_enqueue_read(iree_hal_io_uring_t* ring, int fd,
+                                    void* target, uint32_t length,
+                                    uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+iree_status_t iree_hal_io_uring_submit(iree_hal_io_uring_t* ring) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+}
+
+iree_status_t iree_hal_io_uring_wait(iree_hal_io_uring_t* ring,
+                                     uint32_t min_complete) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE);
+}
+
+bool iree_hal_io_uring_reap(iree_hal_io_uring_t* ring, uint64_t* out_user_data,
+                            int32_t* out_result) {
+  return false;
+}
+
+iree_wait_source_t iree_hal_io_uring_await(iree_hal_io_uring_t* ring) {
+  return iree_wait_source_immediate();
+}
+
+void iree_hal_io_uring_reset_wait_source(iree_hal_io_uring_t* ring) {}
+
+#endif  // IREE_HAL_IO_URING_ENABLE
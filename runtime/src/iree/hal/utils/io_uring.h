@@ -0,0 +1,106 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_IO_URING_H_
+#define IREE_HAL_UTILS_IO_URING_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Set to 1 to enable io_uring support on Linux. It is detected at runtime as
+// kernels may be too old or sandboxes (containers, seccomp) may block it;
+// callers must always handle IREE_STATUS_UNAVAILABLE from initialization.
+#if !defined(IREE_HAL_IO_URING_ENABLE)
+#if defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)
+#define IREE_HAL_IO_URING_ENABLE 1
+#else
+#define IREE_HAL_IO_URING_ENABLE 0
+#endif  // IREE_PLATFORM_LINUX
+#endif  // !IREE_HAL_IO_URING_ENABLE
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_t
+//===----------------------------------------------------------------------===//
+
+// A minimal single-producer/single-consumer Linux io_uring instance used for
+// asynchronous positional file reads. Completions are signaled on an eventfd
+// that can be waited on with iree_loop_wait_one so that IO overlaps with other
+// loop work instead of blocking the caller.
+//
+// Thread-compatible; users must serialize all calls on a ring.
+typedef struct iree_hal_io_uring_t {
+  // io_uring file descriptor or -1 if not initialized.
+  int ring_fd;
+  // eventfd signaled by the kernel when completions are posted.
+  int event_fd;
+  // Submission queue ring mapping.
+  void* sq_ring_ptr;
+  iree_host_size_t sq_ring_size;
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t* sq_array;
+  uint32_t sq_mask;
+  uint32_t sq_entries;
+  // Submission queue entries mapping.
+  void* sqes;
+  iree_host_size_t sqes_size;
+  // Completion queue ring mapping; may alias sq_ring_ptr.
+  void* cq_ring_ptr;
+  iree_host_size_t cq_ring_size;
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  void* cqes;
+  uint32_t cq_mask;
+  // Number of entries enqueued but not yet submitted to the kernel.
+  uint32_t unsubmitted_count;
+} iree_hal_io_uring_t;
+
+// Initializes |out_ring| with room for at least |queue_depth| in-flight
+// operations. Returns IREE_STATUS_UNAVAILABLE if io_uring or the required
+// operations are not supported on the host.
+iree_status_t iree_hal_io_uring_initialize(uint32_t queue_depth,
+                                           iree_hal_io_uring_t* out_ring);
+
+// Deinitializes |ring|. All operations must have completed.
+void iree_hal_io_uring_deinitialize(iree_hal_io_uring_t* ring);
+
+// Enqueues a read of |length| bytes at |offset| in |fd| into |target|.
+// |user_data| is returned with the completion. Returns false if the submission
+// queue is full.
+bool iree_hal_io_uring_enqueue_read(iree_hal_io_uring_t* ring, int fd,
+                                    void* target, uint32_t length,
+                                    uint64_t offset, uint64_t user_data);
+
+// Submits all enqueued operations to the kernel.
+iree_status_t iree_hal_io_uring_submit(iree_hal_io_uring_t* ring);
+
+// Blocks the caller until at least |min_complete| completions are pending.
+// Used to drain in-flight operations when asynchronous waits are unavailable.
+iree_status_t iree_hal_io_uring_wait(iree_hal_io_uring_t* ring,
+                                     uint32_t min_complete);
+
+// Pops one completion from the ring if available and returns its |user_data|
+// and |result| (bytes transferred or a negative errno). Returns false if no
+// completions are pending.
+bool iree_hal_io_uring_reap(iree_hal_io_uring_t* ring, uint64_t* out_user_data,
+                            int32_t* out_result);
+
+// Returns a wait source that resolves when completions may be available.
+// Callers must call iree_hal_io_uring_reset_wait_source before reaping to
+// avoid spurious wakes.
+iree_wait_source_t iree_hal_io_uring_await(iree_hal_io_uring_t* ring);
+
+// Resets the completion wait source prior to reaping completions.
+void iree_hal_io_uring_reset_wait_source(iree_hal_io_uring_t* ring);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_IO_URING_H_
@@ -0,0 +1,144 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/io_uring.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if IREE_HAL_IO_URING_ENABLE
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // IREE_HAL_IO_URING_ENABLE
+
+namespace iree {
+namespace hal {
+namespace {
+
+#if IREE_HAL_IO_URING_ENABLE
+
+class IoUringTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_status_t status = iree_hal_io_uring_initialize(8, &ring_);
+    if (iree_status_is_unavailable(status)) {
+      iree_status_ignore(status);
+      GTEST_SKIP() << "io_uring not available on this host";
+    }
+    IREE_ASSERT_OK(status);
+    initialized_ = true;
+
+    // Fill a temporary file with a known pattern.
+    contents_.resize(64 * 1024 + 3);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = (uint8_t)(i * 7);
+    }
+    FILE* file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fwrite(contents_.data(), 1, contents_.size(), file),
+              contents_.size());
+    fflush(file);
+    fd_ = dup(fileno(file));
+    fclose(file);
+    ASSERT_GE(fd_, 0);
+  }
+
+  void TearDown() override {
+    if (fd_ >= 0) close(fd_);
+    if (initialized_) iree_hal_io_uring_deinitialize(&ring_);
+  }
+
+  iree_hal_io_uring_t ring_;
+  bool initialized_ = false;
+  std::vector<uint8_t> contents_;
+  int fd_ = -1;
+};
+
+TEST_F(IoUringTest, ReapEmpty) {
+  uint64_t user_data = 0;
+  int32_t result = 0;
+  EXPECT_FALSE(iree_hal_io_uring_reap(&ring_, &user_data, &result));
+}
+
+TEST_F(IoUringTest, ReadChunks) {
+  // Read the file in 4 chunks with all of them in flight at once.
+  std::vector<uint8_t> target(contents_.size());
+  const uint32_t chunk_size = (uint32_t)(contents_.size() / 4 + 1);
+  uint32_t issued = 0;
+  for (uint64_t offset = 0; offset < contents_.size(); offset += chunk_size) {
+    uint32_t length = (uint32_t)std::min<uint64_t>(
+        chunk_size, contents_.size() - offset);
+    ASSERT_TRUE(iree_hal_io_uring_enqueue_read(
+        &ring_, fd_, target.data() + offset, length, offset, offset));
+    ++issued;
+  }
+  IREE_ASSERT_OK(iree_hal_io_uring_submit(&ring_));
+  IREE_ASSERT_OK(iree_hal_io_uring_wait(&ring_, issued));
+
+  // The eventfd wait source should be signaled now.
+  IREE_EXPECT_OK(iree_wait_source_wait_one(iree_hal_io_uring_await(&ring_),
+                                           iree_immediate_timeout()));
+  iree_hal_io_uring_reset_wait_source(&ring_);
+
+  uint64_t user_data = 0;
+  int32_t result = 0;
+  uint64_t total_length = 0;
+  for (uint32_t i = 0; i < issued; ++i) {
+    ASSERT_TRUE(iree_hal_io_uring_reap(&ring_, &user_data, &result));
+    EXPECT_EQ(user_data % chunk_size, 0);
+    EXPECT_GT(result, 0);
+    total_length += result;
+  }
+  EXPECT_FALSE(iree_hal_io_uring_reap(&ring_, &user_data, &result));
+  EXPECT_EQ(total_length, contents_.size());
+  EXPECT_EQ(target, contents_);
+}
+
+TEST_F(IoUringTest, ReadPastEnd) {
+  uint8_t target[16];
+  ASSERT_TRUE(iree_hal_io_uring_enqueue_read(
+      &ring_, fd_, target, sizeof(target), contents_.size(), 123));
+  IREE_ASSERT_OK(iree_hal_io_uring_submit(&ring_));
+  IREE_ASSERT_OK(iree_hal_io_uring_wait(&ring_, 1));
+  uint64_t user_data = 0;
+  int32_t result = -1;
+  ASSERT_TRUE(iree_hal_io_uring_reap(&ring_, &user_data, &result));
+  EXPECT_EQ(user_data, 123);
+  EXPECT_EQ(result, 0);
+}
+
+TEST_F(IoUringTest, QueueFull) {
+  uint8_t target[1];
+  uint32_t enqueued = 0;
+  while (iree_hal_io_uring_enqueue_read(&ring_, fd_, target, 1, 0, 0)) {
+    ++enqueued;
+    ASSERT_LE(enqueued, ring_.sq_entries);
+  }
+  EXPECT_EQ(enqueued, ring_.sq_entries);
+  IREE_ASSERT_OK(iree_hal_io_uring_submit(&ring_));
+  IREE_ASSERT_OK(iree_hal_io_uring_wait(&ring_, enqueued));
+}
+
+#else
+
+TEST(IoUringTest, Unavailable) {
+  iree_hal_io_uring_t ring;
+  iree_status_t status = iree_hal_io_uring_initialize(8, &ring);
+  EXPECT_TRUE(iree_status_is_unavailable(status));
+  iree_status_ignore(status);
+}
+
+#endif  // IREE_HAL_IO_URING_ENABLE
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
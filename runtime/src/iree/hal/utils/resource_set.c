@@ -7,6 +7,7 @@
 #include "iree/hal/utils/resource_set.h"
 
 #include "iree/base/internal/debugging.h"
+#include "iree/base/internal/math.h"
 
 // Computes the total capacity in resources of a chunk allocated with a total
 // |storage_size| (including the header).
@@ -86,6 +87,18 @@ static void iree_hal_resource_set_release_blocks(iree_hal_resource_set_t* set) {
     chunk = next_chunk;
   }
 
+  // Tables only hold unretained references and can be released directly.
+  iree_hal_resource_set_table_t* table = set->table_head;
+  while (table) {
+    iree_hal_resource_set_table_t* next_table = table->next_table;
+    iree_arena_block_t* block =
+        iree_arena_block_trailer(set->block_pool, (void*)table);
+    block->next = block_head;
+    block_head = block;
+    if (!block_tail) block_tail = block;
+    table = next_table;
+  }
+
   // Release all blocks back to the block pool in one operation.
   // NOTE: this invalidates the |set| memory.
   iree_arena_block_pool_t* block_pool = set->block_pool;
@@ -110,6 +123,11 @@ IREE_API_EXPORT void iree_hal_resource_set_free(iree_hal_resource_set_t* set) {
     // Once unpoisoned we can read the memory to get the next chunk.
     chunk = chunk->next_chunk;
   }
+  iree_hal_resource_set_table_t* table = set->table_head;
+  while (table) {
+    IREE_ASAN_UNPOISON_MEMORY_REGION(table, set->block_pool->usable_block_size);
+    table = table->next_table;
+  }
 #endif  // IREE_SANITIZER_ADDRESS
 
   // Release all resources and the arena block used by the set.
@@ -134,6 +152,13 @@ IREE_API_EXPORT void iree_hal_resource_set_freeze(
                         : 0));
     chunk = next_chunk;
   }
+  // Poison all tables.
+  iree_hal_resource_set_table_t* table = set->table_head;
+  while (table) {
+    iree_hal_resource_set_table_t* next_table = table->next_table;
+    IREE_ASAN_POISON_MEMORY_REGION(table, set->block_pool->usable_block_size);
+    table = next_table;
+  }
   // Poison the set.
   IREE_ASAN_POISON_MEMORY_REGION(set, sizeof(iree_hal_resource_set_t));
 #endif  // IREE_SANITIZER_ADDRESS
@@ -159,9 +184,94 @@ static iree_status_t iree_hal_resource_set_insert_retain(
   // Retain and insert into the chunk.
   chunk->resources[chunk->count++] = resource;
   iree_hal_resource_retain(resource);
+  ++set->retained_count;
   return iree_ok_status();
 }
 
+// Returns the home slot of |resource| in a table with the given |mask|.
+// Resources are at least pointer aligned and the low bits carry no
+// information so we use a multiplicative hash to spread the high bits.
+static inline uint32_t iree_hal_resource_set_table_hash(
+    const iree_hal_resource_t* resource, uint32_t mask) {
+  uint64_t value = (uint64_t)(uintptr_t)resource;
+  return (uint32_t)((value * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// Returns true if |resource| is present in any table of |set|.
+static bool iree_hal_resource_set_table_lookup(
+    const iree_hal_resource_set_t* set, const iree_hal_resource_t* resource) {
+  for (const iree_hal_resource_set_table_t* table = set->table_head; table;
+       table = table->next_table) {
+    // Tables are at most half full so there is always an empty slot to stop
+    // the probe sequence.
+    uint32_t slot = iree_hal_resource_set_table_hash(resource, table->mask);
+    while (table->slots[slot]) {
+      if (table->slots[slot] == resource) return true;
+      slot = (slot + 1) & table->mask;
+    }
+  }
+  return false;
+}
+
+// Appends a new empty table to the head of the table list.
+static iree_status_t iree_hal_resource_set_table_grow(
+    iree_hal_resource_set_t* set) {
+  iree_hal_resource_set_table_t* table = NULL;
+  iree_arena_block_t* block = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_block_pool_acquire(set->block_pool, &block, (void**)&table));
+  uint32_t capacity = (uint32_t)((set->block_pool->usable_block_size -
+                                  sizeof(iree_hal_resource_set_table_t)) /
+                                 sizeof(iree_hal_resource_t*));
+  capacity = iree_math_round_up_to_pow2_u32(capacity + 1) >> 1;
+  table->next_table = set->table_head;
+  table->mask = capacity - 1;
+  table->count = 0;
+  memset(table->slots, 0, sizeof(table->slots[0]) * capacity);
+  set->table_head = table;
+  ++set->table_count;
+  return iree_ok_status();
+}
+
+// Inserts |resource| into the head table of |set|, chaining a new table if the
+// head table is full. Resources that don't fit once the maximum number of
+// tables has been reached are dropped: the set may retain them again but will
+// otherwise remain correct.
+static void iree_hal_resource_set_table_insert(iree_hal_resource_set_t* set,
+                                               iree_hal_resource_t* resource) {
+  iree_hal_resource_set_table_t* table = set->table_head;
+  if (!table || table->count + 1 > (table->mask + 1) / 2) {
+    if (set->table_count >= IREE_HAL_RESOURCE_SET_MAX_TABLE_COUNT) return;
+    // Lookup tables are an optimization and failing to allocate one only
+    // results in redundant retains.
+    iree_status_t status = iree_hal_resource_set_table_grow(set);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      return;
+    }
+    table = set->table_head;
+  }
+  uint32_t slot = iree_hal_resource_set_table_hash(resource, table->mask);
+  while (table->slots[slot]) slot = (slot + 1) & table->mask;
+  table->slots[slot] = resource;
+  ++table->count;
+}
+
+// Populates the lookup tables with all resources retained so far.
+static void iree_hal_resource_set_table_populate(iree_hal_resource_set_t* set) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  for (iree_hal_resource_set_chunk_t* chunk = set->chunk_head; chunk;
+       chunk = chunk->next_chunk) {
+    for (iree_host_size_t i = 0; i < chunk->count; ++i) {
+      iree_hal_resource_t* resource = chunk->resources[i];
+      if (!iree_hal_resource_set_table_lookup(set, resource)) {
+        iree_hal_resource_set_table_insert(set, resource);
+      }
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
 // Scans the lookaside for the resource pointer and updates the order if found.
 // If the resource was not found then it will be inserted into the main list as
 // well as the MRU.
@@ -259,10 +369,25 @@ static iree_status_t iree_hal_resource_set_insert_1(
     return iree_ok_status();
   }
 
+  // Miss - check the lookup tables for large sets. This costs a cache miss or
+  // two but saves an atomic retain/release pair and the chunk storage.
+  if (set->table_head && iree_hal_resource_set_table_lookup(set, resource)) {
+    memmove(&set->mru[1], &set->mru[0],
+            sizeof(set->mru[0]) * (IREE_ARRAYSIZE(set->mru) - 1));
+    set->mru[0] = resource;
+    return iree_ok_status();
+  }
+
   // Miss - insert into the main list (slow path).
   // Note that we do this before updating the MRU in case allocation fails - we
   // don't want to keep the pointer around unless we've really retained it.
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  if (set->table_head) {
+    iree_hal_resource_set_table_insert(set, resource);
+  } else if (IREE_UNLIKELY(set->retained_count ==
+                           IREE_HAL_RESOURCE_SET_TABLE_THRESHOLD)) {
+    iree_hal_resource_set_table_populate(set);
+  }
 
   // Shift the MRU down and insert the new item at the head.
   memmove(&set->mru[1], &set->mru[0],
@@ -35,6 +35,29 @@ typedef struct iree_hal_resource_set_chunk_t {
   iree_hal_resource_t* resources[];
 } iree_hal_resource_set_chunk_t;
 
+// Open-addressed table of retained resources used to deduplicate insertions
+// that miss the MRU. Each table occupies a single block from the pool and is
+// only filled to half of its capacity to keep probe sequences short; once full
+// a new table is chained in front of it.
+typedef struct iree_hal_resource_set_table_t {
+  // Next (older and full) table in the table linked list.
+  struct iree_hal_resource_set_table_t* next_table;
+  // Total number of slots minus one; capacity is always a power of two.
+  uint32_t mask;
+  // Number of occupied slots.
+  uint32_t count;
+  iree_hal_resource_t* slots[];
+} iree_hal_resource_set_table_t;
+
+// Number of retained resources at which a set starts maintaining lookup
+// tables. Below this the MRU catches the majority of redundant insertions.
+#define IREE_HAL_RESOURCE_SET_TABLE_THRESHOLD 32
+
+// Maximum number of lookup tables chained in a set. Each miss probes all
+// tables so this bounds the cost of a miss; resources inserted after the
+// tables are full are only deduplicated by the MRU.
+#define IREE_HAL_RESOURCE_SET_MAX_TABLE_COUNT 8
+
 // Returns true if the chunk is stored inline in the parent resource set.
 #define iree_hal_resource_set_chunk_is_stored_inline(set, chunk) \
   ((const void*)(chunk) == (const uint8_t*)set + sizeof(*set))
@@ -74,6 +97,12 @@ typedef struct iree_hal_resource_set_chunk_t {
 // whatever user code may need to do to maintain proper lifetime - or as small
 // in terms of code-size.
 //
+// Sets that grow past IREE_HAL_RESOURCE_SET_TABLE_THRESHOLD resources (large
+// command buffers touching hundreds or thousands of buffers) would miss the MRU
+// on most insertions and retain the same resources many times over. These sets
+// additionally maintain hash tables allocated from the block pool that are
+// probed on MRU misses before falling back to the full insertion.
+//
 // **WARNING**: thread-unsafe insertion: it's assumed that sets are constructed
 // by a single thread, sealed, and then released at once at a future time point.
 // Multiple threads needing to insert into a set should have their own sets and
@@ -99,6 +128,14 @@ typedef struct iree_hal_resource_set_t {
 
   // Linked list of storage chunks.
   iree_hal_resource_set_chunk_t* chunk_head;
+
+  // Linked list of lookup tables with the one receiving insertions at the
+  // head. NULL until the set has retained enough resources to need them.
+  iree_hal_resource_set_table_t* table_head;
+  // Total number of lookup tables in the linked list.
+  uint32_t table_count;
+  // Total number of resources retained by the set, including duplicates.
+  uint32_t retained_count;
 } iree_hal_resource_set_t;
 
 // TODO(benvanik): add an allocation method that allows for placement; in many
@@ -277,6 +277,9 @@ int main(int argc, char** argv) {
     benchmark_def.user_data = (void*)256u;
     iree_benchmark_register(iree_make_cstring_view("randomized_256"),
                             &benchmark_def);
+    benchmark_def.user_data = (void*)1024u;
+    iree_benchmark_register(iree_make_cstring_view("randomized_1024"),
+                            &benchmark_def);
     benchmark_def.user_data = (void*)4096u;
     iree_benchmark_register(iree_make_cstring_view("randomized_4096"),
                             &benchmark_def);
@@ -252,6 +252,44 @@ TEST_F(ResourceSetTest, RedundantInsertion) {
   EXPECT_EQ(live_bitmap, 0u);
 }
 
+// Tests that large sets deduplicate insertions that miss the MRU.
+TEST_F(ResourceSetTest, LookupTableInsertion) {
+  auto resource_set = make_resource_set(&block_pool);
+
+  // Allocate enough resources to cross the table threshold.
+  iree_hal_resource_t* resources[32] = {NULL};
+  static_assert(IREE_ARRAYSIZE(resources) >=
+                    IREE_HAL_RESOURCE_SET_TABLE_THRESHOLD,
+                "need to pick a value that lets us create lookup tables");
+  uint32_t live_bitmap = 0u;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        i, &live_bitmap, host_allocator, &resources[i]));
+  }
+
+  // First insertion retains each resource once and creates the tables.
+  IREE_ASSERT_OK(iree_hal_resource_set_insert(
+      resource_set.get(), IREE_ARRAYSIZE(resources), resources));
+  EXPECT_EQ(resource_set->retained_count, IREE_ARRAYSIZE(resources));
+  EXPECT_NE(resource_set->table_head, nullptr);
+
+  // Inserting again in the same order misses the MRU on every resource but
+  // should hit in the tables and not retain anything.
+  IREE_ASSERT_OK(iree_hal_resource_set_insert(
+      resource_set.get(), IREE_ARRAYSIZE(resources), resources));
+  EXPECT_EQ(resource_set->retained_count, IREE_ARRAYSIZE(resources));
+
+  // Release all of the resources - they should still be owned by the set.
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    iree_hal_resource_release(resources[i]);
+  }
+  EXPECT_EQ(live_bitmap, 0xFFFFFFFFu);
+
+  // Ensure the set releases the resources.
+  resource_set.reset();
+  EXPECT_EQ(live_bitmap, 0u);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -303,3 +303,185 @@ IREE_API_EXPORT void iree_hal_semaphore_poll(iree_hal_semaphore_t* semaphore) {
 
   IREE_TRACE_ZONE_END(z0);
 }
+
+//===----------------------------------------------------------------------===//
+// Multi-wait utilities
+//===----------------------------------------------------------------------===//
+
+// Maximum number of timepoints stored on the stack of a waiting thread.
+#define IREE_HAL_SEMAPHORE_INLINE_WAIT_CAPACITY 8
+
+// State shared between a waiting thread and the timepoints it has acquired.
+typedef struct iree_hal_semaphore_waiter_t {
+  // Posted by timepoint callbacks to wake the waiting thread.
+  iree_notification_t notification;
+  // Number of timepoints that must be reached before the wait is satisfied.
+  // Forced to 0 when any timepoint is reached in wait-any mode or when any
+  // timepoint fails or expires.
+  iree_atomic_int32_t pending_count;
+  iree_hal_wait_mode_t wait_mode;
+} iree_hal_semaphore_waiter_t;
+
+// A timepoint acquired by a waiting thread.
+typedef struct iree_hal_semaphore_wait_timepoint_t {
+  iree_hal_semaphore_timepoint_t base;
+  // Semaphore the timepoint was acquired on. The base timepoint is reset when
+  // its callback is issued but cancellation must still synchronize with the
+  // semaphore to ensure the callback has completed.
+  iree_hal_semaphore_t* semaphore;
+} iree_hal_semaphore_wait_timepoint_t;
+
+static iree_status_t iree_hal_semaphore_waiter_timepoint_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_semaphore_waiter_t* waiter = (iree_hal_semaphore_waiter_t*)user_data;
+  if (status_code == IREE_STATUS_OK &&
+      waiter->wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+    iree_atomic_fetch_sub_int32(&waiter->pending_count, 1,
+                                iree_memory_order_acq_rel);
+  } else {
+    iree_atomic_store_int32(&waiter->pending_count, 0,
+                            iree_memory_order_release);
+  }
+  iree_notification_post(&waiter->notification, IREE_ALL_WAITERS);
+  return iree_ok_status();
+}
+
+static bool iree_hal_semaphore_waiter_is_resolved(
+    iree_hal_semaphore_waiter_t* waiter) {
+  return iree_atomic_load_int32(&waiter->pending_count,
+                                iree_memory_order_acquire) <= 0;
+}
+
+// Returns true if |semaphore| has reached |value| or failed.
+static bool iree_hal_semaphore_has_reached(iree_hal_semaphore_t* semaphore,
+                                           uint64_t value, bool* out_failed) {
+  uint64_t current_value = 0;
+  iree_status_t status = iree_hal_semaphore_query(semaphore, &current_value);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    *out_failed = true;
+    return true;
+  }
+  return current_value >= value;
+}
+
+// Returns a status derived from the |semaphore_list| at the current time:
+// - IREE_STATUS_OK: any or all semaphores signaled (based on |wait_mode|).
+// - IREE_STATUS_ABORTED: one or more semaphores failed.
+// - IREE_STATUS_DEADLINE_EXCEEDED: any or all semaphores unsignaled.
+static iree_status_t iree_hal_semaphore_multi_wait_result(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list) {
+  bool any_reached = false;
+  bool all_reached = true;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    bool failed = false;
+    bool reached = iree_hal_semaphore_has_reached(
+        semaphore_list.semaphores[i], semaphore_list.payload_values[i],
+        &failed);
+    if (failed) return iree_status_from_code(IREE_STATUS_ABORTED);
+    any_reached |= reached;
+    all_reached &= reached;
+  }
+  bool is_satisfied =
+      wait_mode == IREE_HAL_WAIT_MODE_ANY ? any_reached : all_reached;
+  return is_satisfied ? iree_ok_status()
+                      : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_multi_wait_timepoints(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_allocator_t host_allocator) {
+  if (semaphore_list.count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)semaphore_list.count);
+
+  // Fast-path for waits that are already satisfied (or failed) and polls.
+  iree_status_t status =
+      iree_hal_semaphore_multi_wait_result(wait_mode, semaphore_list);
+  if (!iree_status_is_deadline_exceeded(status) ||
+      iree_timeout_is_immediate(timeout)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+
+  // Timepoints are owned by this thread and live until cancelled below.
+  iree_hal_semaphore_wait_timepoint_t
+      inline_timepoints[IREE_HAL_SEMAPHORE_INLINE_WAIT_CAPACITY];
+  iree_hal_semaphore_wait_timepoint_t* timepoints = inline_timepoints;
+  if (semaphore_list.count > IREE_ARRAYSIZE(inline_timepoints)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(host_allocator,
+                                  semaphore_list.count * sizeof(*timepoints),
+                                  (void**)&timepoints));
+  }
+
+  // The pending count starts with a guard reference so that timepoints
+  // reached while others are still being acquired can't resolve a wait-all
+  // early.
+  iree_hal_semaphore_waiter_t waiter;
+  iree_notification_initialize(&waiter.notification);
+  iree_atomic_store_int32(&waiter.pending_count, 1, iree_memory_order_relaxed);
+  waiter.wait_mode = wait_mode;
+  iree_hal_semaphore_callback_t callback = {
+      .fn = iree_hal_semaphore_waiter_timepoint_callback,
+      .user_data = &waiter,
+  };
+  iree_host_size_t timepoint_count = 0;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    bool failed = false;
+    if (iree_hal_semaphore_has_reached(semaphore_list.semaphores[i],
+                                       semaphore_list.payload_values[i],
+                                       &failed)) {
+      continue;
+    }
+    if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+      iree_atomic_fetch_add_int32(&waiter.pending_count, 1,
+                                  iree_memory_order_relaxed);
+    }
+    iree_hal_semaphore_wait_timepoint_t* timepoint =
+        &timepoints[timepoint_count++];
+    timepoint->semaphore = semaphore_list.semaphores[i];
+    iree_hal_semaphore_acquire_timepoint(
+        timepoint->semaphore, semaphore_list.payload_values[i], timeout,
+        callback, &timepoint->base);
+  }
+  if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+    iree_atomic_fetch_sub_int32(&waiter.pending_count, 1,
+                                iree_memory_order_acq_rel);
+  }
+
+  // Semaphores may have been signaled between the query and the acquire in
+  // which case the signaling thread may have notified before our timepoint
+  // was registered; polling flushes any that are already resolved.
+  for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
+    if (iree_hal_semaphore_waiter_is_resolved(&waiter)) break;
+    iree_hal_semaphore_poll(timepoints[i].semaphore);
+  }
+
+  iree_notification_await(
+      &waiter.notification,
+      (iree_condition_fn_t)iree_hal_semaphore_waiter_is_resolved, &waiter,
+      iree_make_deadline(deadline_ns));
+
+  // Cancelling synchronizes with any callback in-flight on another thread so
+  // that the waiter can be safely torn down. Timepoints that were already
+  // issued have been reset and cancelling them is a no-op.
+  for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
+    iree_hal_semaphore_cancel_timepoint(timepoints[i].semaphore,
+                                        &timepoints[i].base);
+  }
+  iree_notification_deinitialize(&waiter.notification);
+  if (timepoints != inline_timepoints) {
+    iree_allocator_free(host_allocator, timepoints);
+  }
+
+  // We may have been successful - or may have a partial failure.
+  status = iree_hal_semaphore_multi_wait_result(wait_mode, semaphore_list);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -173,6 +173,23 @@ IREE_API_EXPORT void iree_hal_semaphore_notify(
 // Must not be called from a timepoint callback.
 IREE_API_EXPORT void iree_hal_semaphore_poll(iree_hal_semaphore_t* semaphore);
 
+// Performs a multi-wait on one or more semaphores using timepoints.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait does not complete before
+// |timeout| elapses and IREE_STATUS_ABORTED if any semaphore has failed.
+//
+// The waiting thread registers a timepoint on each unsatisfied semaphore that
+// posts a single futex-backed notification owned by the waiter so that only
+// threads whose waits are affected by a signal are woken. No system wait
+// handles are required and no allocations are made for up to 8 semaphores;
+// larger lists use |host_allocator| for the timepoint storage.
+//
+// All semaphores must derive from iree_hal_semaphore_t and notify their
+// timepoints with iree_hal_semaphore_notify.
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_multi_wait_timepoints(
+    iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,7 @@
 
 #include "iree/hal/utils/semaphore_base.h"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -374,6 +375,97 @@ TEST_F(TrackingSemaphoreTest, CancelResolvedTimepoint) {
   iree_hal_semaphore_release(*semaphore);
 }
 
+// Tests multi-waits on semaphores that have already been signaled.
+TEST_F(TrackingSemaphoreTest, MultiWaitTimepointsResolved) {
+  auto* semaphore0 = TestSemaphore::Create(0ull, host_allocator);
+  auto* semaphore1 = TestSemaphore::Create(0ull, host_allocator);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore0, 1ull));
+
+  iree_hal_semaphore_t* semaphores[2] = {*semaphore0, *semaphore1};
+  uint64_t payload_values[2] = {1ull, 1ull};
+  iree_hal_semaphore_list_t semaphore_list = {2, semaphores, payload_values};
+
+  // Any is satisfied while all is not; neither should block.
+  IREE_EXPECT_OK(iree_hal_semaphore_multi_wait_timepoints(
+      IREE_HAL_WAIT_MODE_ANY, semaphore_list, iree_infinite_timeout(),
+      host_allocator));
+  EXPECT_THAT(Status(iree_hal_semaphore_multi_wait_timepoints(
+                  IREE_HAL_WAIT_MODE_ALL, semaphore_list,
+                  iree_immediate_timeout(), host_allocator)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_THAT(Status(iree_hal_semaphore_multi_wait_timepoints(
+                  IREE_HAL_WAIT_MODE_ALL, semaphore_list,
+                  iree_make_timeout_ms(10), host_allocator)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+
+  iree_hal_semaphore_release(*semaphore0);
+  iree_hal_semaphore_release(*semaphore1);
+}
+
+// Tests multi-waits on semaphores signaled from another thread. Uses more
+// semaphores than are stored inline to exercise the allocated storage.
+TEST_F(TrackingSemaphoreTest, MultiWaitTimepointsAsync) {
+  static constexpr int kSemaphoreCount = 32;
+  iree_hal_semaphore_t* semaphores[kSemaphoreCount];
+  uint64_t payload_values[kSemaphoreCount];
+  for (int i = 0; i < kSemaphoreCount; ++i) {
+    semaphores[i] = *TestSemaphore::Create(0ull, host_allocator);
+    payload_values[i] = 1ull;
+  }
+  iree_hal_semaphore_list_t semaphore_list = {kSemaphoreCount, semaphores,
+                                              payload_values};
+
+  // Wait-any wakes on the first signal.
+  std::thread any_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphores[7], 1ull));
+  });
+  IREE_EXPECT_OK(iree_hal_semaphore_multi_wait_timepoints(
+      IREE_HAL_WAIT_MODE_ANY, semaphore_list, iree_infinite_timeout(),
+      host_allocator));
+  any_thread.join();
+
+  // Wait-all wakes only after the last signal.
+  std::thread all_thread([&]() {
+    for (int i = 0; i < kSemaphoreCount; ++i) {
+      if (i == 7) continue;
+      IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphores[i], 1ull));
+    }
+  });
+  IREE_EXPECT_OK(iree_hal_semaphore_multi_wait_timepoints(
+      IREE_HAL_WAIT_MODE_ALL, semaphore_list, iree_infinite_timeout(),
+      host_allocator));
+  all_thread.join();
+
+  for (int i = 0; i < kSemaphoreCount; ++i) {
+    iree_hal_semaphore_release(semaphores[i]);
+  }
+}
+
+// Tests that failing any semaphore aborts a wait-all.
+TEST_F(TrackingSemaphoreTest, MultiWaitTimepointsFailure) {
+  auto* semaphore0 = TestSemaphore::Create(0ull, host_allocator);
+  auto* semaphore1 = TestSemaphore::Create(0ull, host_allocator);
+
+  iree_hal_semaphore_t* semaphores[2] = {*semaphore0, *semaphore1};
+  uint64_t payload_values[2] = {1ull, 1ull};
+  iree_hal_semaphore_list_t semaphore_list = {2, semaphores, payload_values};
+
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    iree_hal_semaphore_fail(*semaphore1,
+                            iree_make_status(IREE_STATUS_DATA_LOSS, "whoops"));
+  });
+  EXPECT_THAT(Status(iree_hal_semaphore_multi_wait_timepoints(
+                  IREE_HAL_WAIT_MODE_ALL, semaphore_list,
+                  iree_infinite_timeout(), host_allocator)),
+              StatusIs(StatusCode::kAborted));
+  thread.join();
+
+  iree_hal_semaphore_release(*semaphore0);
+  iree_hal_semaphore_release(*semaphore1);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
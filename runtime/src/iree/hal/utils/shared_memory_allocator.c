@@ -0,0 +1,579 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// NOTE: must be first before _any_ system includes.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+
+#include "iree/hal/utils/shared_memory_allocator.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#endif  // IREE_PLATFORM_LINUX
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+// Maximum length of the user-provided segment prefix. Segment names must fit
+// within NAME_MAX including the hash and length suffix.
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_MAX_PREFIX_LENGTH 200
+
+// Default time to wait for another process to populate a segment.
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_DEFAULT_POPULATE_TIMEOUT_NS \
+  (10 * 1000000000ll)
+
+void iree_hal_shared_memory_allocator_params_initialize(
+    iree_string_view_t segment_prefix,
+    iree_hal_shared_memory_allocator_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->segment_prefix = segment_prefix;
+  out_params->min_size = IREE_HAL_SHARED_MEMORY_ALLOCATOR_DEFAULT_MIN_SIZE;
+  out_params->numa_node = IREE_HAL_SHARED_MEMORY_ALLOCATOR_NUMA_NODE_ANY;
+  out_params->populate_timeout_ns =
+      IREE_HAL_SHARED_MEMORY_ALLOCATOR_DEFAULT_POPULATE_TIMEOUT_NS;
+}
+
+//===----------------------------------------------------------------------===//
+// Shared memory segments
+//===----------------------------------------------------------------------===//
+
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+// 'IRSM' as a little-endian uint32_t.
+#define IREE_HAL_SHARED_MEMORY_SEGMENT_MAGIC 0x4D535249u
+
+// Size of the segment header. A full page keeps the contents page aligned.
+#define IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE 4096
+
+// Matches MPOL_BIND from linux/mempolicy.h (not always available).
+#define IREE_HAL_SHARED_MEMORY_MPOL_BIND 2
+
+typedef enum iree_hal_shared_memory_segment_state_e {
+  // Segment has been created but not yet populated.
+  IREE_HAL_SHARED_MEMORY_SEGMENT_STATE_PENDING = 0,
+  // Segment contents are valid and immutable.
+  IREE_HAL_SHARED_MEMORY_SEGMENT_STATE_READY = 1,
+} iree_hal_shared_memory_segment_state_t;
+
+// Header at the start of each shared memory segment.
+typedef struct iree_hal_shared_memory_segment_header_t {
+  // IREE_HAL_SHARED_MEMORY_SEGMENT_MAGIC.
+  uint32_t magic;
+  // iree_hal_shared_memory_segment_state_t set by the creating process once
+  // the contents have been populated.
+  iree_atomic_int32_t state;
+  // Length in bytes of the contents following the header.
+  uint64_t length;
+  // Hash of the contents. Also part of the segment name.
+  uint64_t hash;
+} iree_hal_shared_memory_segment_header_t;
+static_assert(sizeof(iree_hal_shared_memory_segment_header_t) <=
+                  IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE,
+              "header must fit in the reserved space");
+
+// A mapped segment released when the imported buffer is destroyed.
+typedef struct iree_hal_shared_memory_segment_t {
+  iree_allocator_t host_allocator;
+  void* base_ptr;
+  iree_host_size_t mapping_size;
+} iree_hal_shared_memory_segment_t;
+
+// Returns a 64-bit FNV-1a style hash of |data|. Hashes 8 bytes at a time as
+// constant pools can be hundreds of megabytes; the result is only used to
+// find candidate segments and the contents are compared before use.
+static uint64_t iree_hal_shared_memory_hash(iree_const_byte_span_t data) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  iree_host_size_t i = 0;
+  for (; i + sizeof(uint64_t) <= data.data_length; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, data.data + i, sizeof(word));
+    hash = (hash ^ word) * 0x100000001B3ull;
+  }
+  for (; i < data.data_length; ++i) {
+    hash = (hash ^ data.data[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Binds the pages backing |ptr| to |numa_node| before they are touched.
+// Best-effort: failures leave the pages with the default policy.
+static void iree_hal_shared_memory_bind_numa_node(void* ptr,
+                                                  iree_host_size_t size,
+                                                  uint32_t numa_node) {
+  if (numa_node == IREE_HAL_SHARED_MEMORY_ALLOCATOR_NUMA_NODE_ANY) return;
+#if defined(SYS_mbind)
+  unsigned long nodemask[4] = {0};
+  const uint32_t bits_per_word = sizeof(nodemask[0]) * 8;
+  if (numa_node >= IREE_ARRAYSIZE(nodemask) * bits_per_word) return;
+  nodemask[numa_node / bits_per_word] = 1ul << (numa_node % bits_per_word);
+  syscall(SYS_mbind, ptr, (unsigned long)size,
+          IREE_HAL_SHARED_MEMORY_MPOL_BIND, nodemask,
+          (unsigned long)(IREE_ARRAYSIZE(nodemask) * bits_per_word), 0);
+#endif  // SYS_mbind
+}
+
+// Creates and populates a new segment |name| with |contents|.
+// Returns IREE_STATUS_ALREADY_EXISTS if another process created it first.
+static iree_status_t iree_hal_shared_memory_segment_create(
+    const char* name, iree_const_byte_span_t contents, uint64_t hash,
+    uint32_t numa_node, void** out_base_ptr, iree_host_size_t* out_size) {
+  const iree_host_size_t mapping_size =
+      IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE + contents.data_length;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "shm_open of '%s' failed", name);
+  }
+  if (ftruncate(fd, (off_t)mapping_size) != 0) {
+    iree_status_t status = iree_make_status(iree_status_code_from_errno(errno),
+                                            "ftruncate of '%s' failed", name);
+    close(fd);
+    shm_unlink(name);
+    return status;
+  }
+  void* base_ptr =
+      mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base_ptr == MAP_FAILED) {
+    shm_unlink(name);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap of '%s' failed", name);
+  }
+
+  iree_hal_shared_memory_bind_numa_node(base_ptr, mapping_size, numa_node);
+
+  uint8_t* data_ptr =
+      (uint8_t*)base_ptr + IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE;
+  memcpy(data_ptr, contents.data, contents.data_length);
+  iree_hal_shared_memory_segment_header_t* header =
+      (iree_hal_shared_memory_segment_header_t*)base_ptr;
+  header->magic = IREE_HAL_SHARED_MEMORY_SEGMENT_MAGIC;
+  header->length = contents.data_length;
+  header->hash = hash;
+  iree_atomic_store_int32(&header->state,
+                          IREE_HAL_SHARED_MEMORY_SEGMENT_STATE_READY,
+                          iree_memory_order_release);
+
+  // The contents are immutable from here on.
+  mprotect(base_ptr, mapping_size, PROT_READ);
+
+  *out_base_ptr = base_ptr;
+  *out_size = mapping_size;
+  return iree_ok_status();
+}
+
+// Opens an existing segment |name| and verifies it holds |contents|, waiting
+// up to |timeout_ns| for the creating process to finish populating it.
+static iree_status_t iree_hal_shared_memory_segment_open(
+    const char* name, iree_const_byte_span_t contents, uint64_t hash,
+    iree_duration_t timeout_ns, void** out_base_ptr,
+    iree_host_size_t* out_size) {
+  const iree_host_size_t mapping_size =
+      IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE + contents.data_length;
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "shm_open of '%s' failed", name);
+  }
+
+  // The creator may not have sized the segment yet.
+  iree_time_t deadline_ns = iree_relative_timeout_to_deadline_ns(timeout_ns);
+  struct stat fd_stat;
+  while (fstat(fd, &fd_stat) == 0 && (iree_host_size_t)fd_stat.st_size == 0 &&
+         iree_time_now() < deadline_ns) {
+    iree_wait_until(iree_time_now() + 1000000);
+  }
+  if ((iree_host_size_t)fd_stat.st_size != mapping_size) {
+    close(fd);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "segment '%s' has an unexpected size", name);
+  }
+
+  void* base_ptr = mmap(NULL, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base_ptr == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap of '%s' failed", name);
+  }
+
+  iree_hal_shared_memory_segment_header_t* header =
+      (iree_hal_shared_memory_segment_header_t*)base_ptr;
+  while (iree_atomic_load_int32(&header->state, iree_memory_order_acquire) !=
+             IREE_HAL_SHARED_MEMORY_SEGMENT_STATE_READY &&
+         iree_time_now() < deadline_ns) {
+    iree_wait_until(iree_time_now() + 1000000);
+  }
+
+  // Hashes are not collision resistant so the contents are compared in full.
+  const uint8_t* data_ptr =
+      (const uint8_t*)base_ptr + IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE;
+  iree_status_t status = iree_ok_status();
+  if (iree_atomic_load_int32(&header->state, iree_memory_order_acquire) !=
+      IREE_HAL_SHARED_MEMORY_SEGMENT_STATE_READY) {
+    status = iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                              "timed out waiting for segment '%s'", name);
+  } else if (header->magic != IREE_HAL_SHARED_MEMORY_SEGMENT_MAGIC ||
+             header->length != contents.data_length || header->hash != hash ||
+             memcmp(data_ptr, contents.data, contents.data_length) != 0) {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "segment '%s' contents do not match", name);
+  }
+  if (!iree_status_is_ok(status)) {
+    munmap(base_ptr, mapping_size);
+    return status;
+  }
+
+  *out_base_ptr = base_ptr;
+  *out_size = mapping_size;
+  return iree_ok_status();
+}
+
+static void iree_hal_shared_memory_segment_release(void* user_data,
+                                                   iree_hal_buffer_t* buffer) {
+  iree_hal_shared_memory_segment_t* segment =
+      (iree_hal_shared_memory_segment_t*)user_data;
+  munmap(segment->base_ptr, segment->mapping_size);
+  iree_allocator_free(segment->host_allocator, segment);
+}
+
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shared_memory_allocator_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_shared_memory_allocator_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_allocator_t* device_allocator;
+  iree_hal_shared_memory_allocator_params_t params;
+  // Storage for params.segment_prefix.
+  char segment_prefix[IREE_HAL_SHARED_MEMORY_ALLOCATOR_MAX_PREFIX_LENGTH];
+};
+
+static const iree_hal_allocator_vtable_t
+    iree_hal_shared_memory_allocator_vtable;
+
+static iree_hal_shared_memory_allocator_t*
+iree_hal_shared_memory_allocator_cast(
+    iree_hal_allocator_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shared_memory_allocator_vtable);
+  return (iree_hal_shared_memory_allocator_t*)base_value;
+}
+
+iree_status_t iree_hal_shared_memory_allocator_create(
+    const iree_hal_shared_memory_allocator_params_t* params,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  *out_allocator = NULL;
+
+  iree_string_view_t segment_prefix = params->segment_prefix;
+  if (iree_string_view_is_empty(segment_prefix) ||
+      segment_prefix.size >
+          IREE_HAL_SHARED_MEMORY_ALLOCATOR_MAX_PREFIX_LENGTH ||
+      iree_string_view_find_char(segment_prefix, '/', 0) !=
+          IREE_STRING_VIEW_NPOS) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "segment prefix '%.*s' must be non-empty, at most "
+                            "%d characters, and contain no '/'",
+                            (int)segment_prefix.size, segment_prefix.data,
+                            IREE_HAL_SHARED_MEMORY_ALLOCATOR_MAX_PREFIX_LENGTH);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_shared_memory_allocator_t* allocator = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*allocator),
+                                (void**)&allocator));
+
+  iree_hal_resource_initialize(&iree_hal_shared_memory_allocator_vtable,
+                               &allocator->resource);
+  allocator->host_allocator = host_allocator;
+  allocator->device_allocator = device_allocator;
+  iree_hal_allocator_retain(allocator->device_allocator);
+  allocator->params = *params;
+  memcpy(allocator->segment_prefix, segment_prefix.data, segment_prefix.size);
+  allocator->params.segment_prefix =
+      iree_make_string_view(allocator->segment_prefix, segment_prefix.size);
+
+  *out_allocator = (iree_hal_allocator_t*)allocator;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_shared_memory_allocator_create_from_spec(
+    iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  iree_hal_shared_memory_allocator_params_t params;
+  iree_hal_shared_memory_allocator_params_initialize(iree_string_view_empty(),
+                                                     &params);
+  while (!iree_string_view_is_empty(config_pairs)) {
+    // Pop the key=value config pair from the list.
+    iree_string_view_t config_pair = iree_string_view_empty();
+    iree_string_view_split(config_pairs, ',', &config_pair, &config_pairs);
+    iree_string_view_t key = iree_string_view_empty();
+    iree_string_view_t value = iree_string_view_empty();
+    iree_string_view_split(config_pair, '=', &key, &value);
+    key = iree_string_view_trim(key);
+    value = iree_string_view_trim(value);
+    if (iree_string_view_equal(key, IREE_SV("prefix"))) {
+      params.segment_prefix = value;
+    } else if (iree_string_view_equal(key, IREE_SV("min_size"))) {
+      IREE_RETURN_IF_ERROR(
+          iree_string_view_parse_device_size(value, &params.min_size),
+          "parsing min_size");
+    } else if (iree_string_view_equal(key, IREE_SV("numa_node"))) {
+      if (!iree_string_view_atoi_uint32(value, &params.numa_node)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid NUMA node '%.*s'", (int)value.size,
+                                value.data);
+      }
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unrecognized shared memory allocator key "
+                              "'%.*s'; expected one of `prefix`, `min_size`, "
+                              "or `numa_node`",
+                              (int)key.size, key.data);
+    }
+  }
+  return iree_hal_shared_memory_allocator_create(&params, device_allocator,
+                                                 host_allocator, out_allocator);
+}
+
+static void iree_hal_shared_memory_allocator_destroy(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  iree_allocator_t host_allocator = allocator->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_allocator_release(allocator->device_allocator);
+  iree_allocator_free(host_allocator, allocator);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_allocator_t iree_hal_shared_memory_allocator_host_allocator(
+    const iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      (iree_hal_shared_memory_allocator_t*)base_allocator;
+  return allocator->host_allocator;
+}
+
+static iree_status_t iree_hal_shared_memory_allocator_trim(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  return iree_hal_allocator_trim(allocator->device_allocator);
+}
+
+static void iree_hal_shared_memory_allocator_query_statistics(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_allocator_statistics_t* IREE_RESTRICT out_statistics) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  iree_hal_allocator_query_statistics(allocator->device_allocator,
+                                      out_statistics);
+}
+
+static iree_status_t iree_hal_shared_memory_allocator_query_memory_heaps(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_host_size_t capacity,
+    iree_hal_allocator_memory_heap_t* IREE_RESTRICT heaps,
+    iree_host_size_t* IREE_RESTRICT out_count) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_memory_heaps(allocator->device_allocator,
+                                               capacity, heaps, out_count);
+}
+
+static iree_hal_buffer_compatibility_t
+iree_hal_shared_memory_allocator_query_buffer_compatibility(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t* IREE_RESTRICT allocation_size) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  return iree_hal_allocator_query_buffer_compatibility(
+      allocator->device_allocator, *params, *allocation_size, params,
+      allocation_size);
+}
+
+static iree_status_t iree_hal_shared_memory_allocator_allocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  return iree_hal_allocator_allocate_buffer(allocator->device_allocator,
+                                            *params, allocation_size,
+                                            out_buffer);
+}
+
+static void iree_hal_shared_memory_allocator_deallocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer) {
+  // No-op; we never point a buffer back at us for deallocation.
+}
+
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+// Returns true if the import of |external_buffer| is eligible for sharing.
+static bool iree_hal_shared_memory_allocator_should_share(
+    iree_hal_shared_memory_allocator_t* allocator,
+    const iree_hal_buffer_params_t* params,
+    const iree_hal_external_buffer_t* external_buffer) {
+  return external_buffer->type ==
+             IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION &&
+         iree_all_bits_set(params->usage,
+                           IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE) &&
+         !iree_any_bit_set(params->access, IREE_HAL_MEMORY_ACCESS_WRITE) &&
+         external_buffer->size >= allocator->params.min_size &&
+         external_buffer->size <=
+             IREE_HOST_SIZE_MAX - IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE;
+}
+
+// Imports |external_buffer| by way of a shared segment holding a copy of its
+// contents. On success the caller's |release_callback| has been issued as the
+// original memory is no longer referenced.
+static iree_status_t iree_hal_shared_memory_allocator_import_shared(
+    iree_hal_shared_memory_allocator_t* allocator,
+    const iree_hal_buffer_params_t* params,
+    const iree_hal_external_buffer_t* external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)external_buffer->size);
+
+  iree_const_byte_span_t contents = iree_make_const_byte_span(
+      external_buffer->handle.host_allocation.ptr,
+      (iree_host_size_t)external_buffer->size);
+  uint64_t hash = iree_hal_shared_memory_hash(contents);
+  char name[IREE_HAL_SHARED_MEMORY_ALLOCATOR_MAX_PREFIX_LENGTH + 40];
+  snprintf(name, sizeof(name), "/%.*s-%016" PRIx64 "-%016" PRIx64,
+           (int)allocator->params.segment_prefix.size,
+           allocator->params.segment_prefix.data, hash,
+           (uint64_t)contents.data_length);
+
+  // Try to be the creator and otherwise attach to the existing segment.
+  void* base_ptr = NULL;
+  iree_host_size_t mapping_size = 0;
+  iree_status_t status = iree_hal_shared_memory_segment_create(
+      name, contents, hash, allocator->params.numa_node, &base_ptr,
+      &mapping_size);
+  if (iree_status_is_already_exists(status)) {
+    iree_status_ignore(status);
+    status = iree_hal_shared_memory_segment_open(
+        name, contents, hash, allocator->params.populate_timeout_ns, &base_ptr,
+        &mapping_size);
+  }
+
+  iree_hal_shared_memory_segment_t* segment = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(allocator->host_allocator, sizeof(*segment),
+                                   (void**)&segment);
+    if (iree_status_is_ok(status)) {
+      segment->host_allocator = allocator->host_allocator;
+      segment->base_ptr = base_ptr;
+      segment->mapping_size = mapping_size;
+    } else {
+      munmap(base_ptr, mapping_size);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_external_buffer_t shared_buffer = *external_buffer;
+    shared_buffer.handle.host_allocation.ptr =
+        (uint8_t*)base_ptr + IREE_HAL_SHARED_MEMORY_SEGMENT_HEADER_SIZE;
+    iree_hal_buffer_release_callback_t segment_release_callback = {
+        .fn = iree_hal_shared_memory_segment_release,
+        .user_data = segment,
+    };
+    status = iree_hal_allocator_import_buffer(
+        allocator->device_allocator, *params, &shared_buffer,
+        segment_release_callback, out_buffer);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_shared_memory_segment_release(segment, NULL);
+    }
+  }
+
+  if (iree_status_is_ok(status) && release_callback.fn) {
+    release_callback.fn(release_callback.user_data, *out_buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+static iree_status_t iree_hal_shared_memory_allocator_import_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+  if (iree_hal_shared_memory_allocator_should_share(allocator, params,
+                                                    external_buffer)) {
+    // Sharing is an optimization and any failure (no /dev/shm, limits
+    // exceeded, etc) falls back to a private import.
+    iree_status_t status = iree_hal_shared_memory_allocator_import_shared(
+        allocator, params, external_buffer, release_callback, out_buffer);
+    if (iree_status_is_ok(status)) return status;
+    iree_status_ignore(status);
+  }
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+  return iree_hal_allocator_import_buffer(allocator->device_allocator, *params,
+                                          external_buffer, release_callback,
+                                          out_buffer);
+}
+
+static iree_status_t iree_hal_shared_memory_allocator_export_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    iree_hal_buffer_t* IREE_RESTRICT buffer,
+    iree_hal_external_buffer_type_t requested_type,
+    iree_hal_external_buffer_flags_t requested_flags,
+    iree_hal_external_buffer_t* IREE_RESTRICT out_external_buffer) {
+  iree_hal_shared_memory_allocator_t* allocator =
+      iree_hal_shared_memory_allocator_cast(base_allocator);
+  return iree_hal_allocator_export_buffer(allocator->device_allocator, buffer,
+                                          requested_type, requested_flags,
+                                          out_external_buffer);
+}
+
+static const iree_hal_allocator_vtable_t
+    iree_hal_shared_memory_allocator_vtable = {
+        .destroy = iree_hal_shared_memory_allocator_destroy,
+        .host_allocator = iree_hal_shared_memory_allocator_host_allocator,
+        .trim = iree_hal_shared_memory_allocator_trim,
+        .query_statistics = iree_hal_shared_memory_allocator_query_statistics,
+        .query_memory_heaps =
+            iree_hal_shared_memory_allocator_query_memory_heaps,
+        .query_buffer_compatibility =
+            iree_hal_shared_memory_allocator_query_buffer_compatibility,
+        .allocate_buffer = iree_hal_shared_memory_allocator_allocate_buffer,
+        .deallocate_buffer = iree_hal_shared_memory_allocator_deallocate_buffer,
+        .import_buffer = iree_hal_shared_memory_allocator_import_buffer,
+        .export_buffer = iree_hal_shared_memory_allocator_export_buffer,
+};
@@ -0,0 +1,94 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_SHARED_MEMORY_ALLOCATOR_H_
+#define IREE_HAL_UTILS_SHARED_MEMORY_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Set to 1 to enable POSIX shared memory segments. When disabled the allocator
+// passes all requests through to the underlying allocator.
+#if !defined(IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE)
+#if (defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)) || \
+    defined(IREE_PLATFORM_APPLE)
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE 1
+#else
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE 0
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+#endif  // !IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+// Default minimum size of an import to place in a shared segment. Smaller
+// constants are not worth the file descriptor and page rounding overhead.
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_DEFAULT_MIN_SIZE (64 * 1024)
+
+// Sentinel indicating that segments are not bound to a NUMA node.
+#define IREE_HAL_SHARED_MEMORY_ALLOCATOR_NUMA_NODE_ANY UINT32_MAX
+
+// Parameters controlling an iree_hal_shared_memory_allocator_t.
+typedef struct iree_hal_shared_memory_allocator_params_t {
+  // Prefix of the shared memory segment names, such as the model name.
+  // Processes using the same prefix share segments with identical contents.
+  iree_string_view_t segment_prefix;
+  // Minimum size in bytes of an import to place in a shared segment.
+  iree_device_size_t min_size;
+  // NUMA node new segments are bound to or
+  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_NUMA_NODE_ANY.
+  uint32_t numa_node;
+  // Maximum time to wait for another process to finish populating a segment
+  // before falling back to a private copy.
+  iree_duration_t populate_timeout_ns;
+} iree_hal_shared_memory_allocator_params_t;
+
+// Initializes |out_params| to default values for the given |segment_prefix|.
+void iree_hal_shared_memory_allocator_params_initialize(
+    iree_string_view_t segment_prefix,
+    iree_hal_shared_memory_allocator_params_t* out_params);
+
+// A HAL allocator that places immutable host imports (such as the constant
+// pools produced by the compiler) in named shared memory segments so that
+// multiple processes loading the same program share one physical copy.
+//
+// Imports of IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION buffers with
+// IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE usage and read-only access are keyed
+// by a hash of their contents and length. The first process to import a given
+// constant creates the segment, populates it, and marks it ready. All others
+// map the existing segment read-only without retaining their own source
+// memory. All other requests and any failure to use shared memory fall back
+// to the underlying allocator.
+//
+// Segments are named `/<segment_prefix>-<hash>-<length>` and intentionally
+// outlive the processes using them so that restarts are fast. They must be
+// removed by the deployment (for example by deleting the files from /dev/shm
+// on Linux) when the program changes.
+typedef struct iree_hal_shared_memory_allocator_t
+    iree_hal_shared_memory_allocator_t;
+
+// Creates a shared memory allocator wrapping |device_allocator|.
+// |device_allocator| must be able to import host allocations.
+iree_status_t iree_hal_shared_memory_allocator_create(
+    const iree_hal_shared_memory_allocator_params_t* params,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
+// Creates a shared memory allocator from a |config_pairs| string.
+//
+// Examples:
+//   prefix=my_model
+//   prefix=my_model,min_size=1MiB,numa_node=1
+iree_status_t iree_hal_shared_memory_allocator_create_from_spec(
+    iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_SHARED_MEMORY_ALLOCATOR_H_
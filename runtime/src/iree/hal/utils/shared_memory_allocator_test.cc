@@ -0,0 +1,190 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/shared_memory_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+#include <sys/mman.h>
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+#if defined(IREE_PLATFORM_LINUX)
+#include <dirent.h>
+#endif  // IREE_PLATFORM_LINUX
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+struct ReleaseState {
+  int count = 0;
+};
+
+static void CountRelease(void* user_data, iree_hal_buffer_t* buffer) {
+  ++reinterpret_cast<ReleaseState*>(user_data)->count;
+}
+
+class SharedMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    // Unique per run so concurrent test runs do not interfere.
+    prefix_ = "iree-shm-test-" + std::to_string(iree_time_now());
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(allocator_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  void CreateAllocator(iree_device_size_t min_size) {
+    iree_hal_shared_memory_allocator_params_t params;
+    iree_hal_shared_memory_allocator_params_initialize(
+        iree_make_string_view(prefix_.data(), prefix_.size()), &params);
+    params.min_size = min_size;
+    IREE_ASSERT_OK(iree_hal_shared_memory_allocator_create(
+        &params, device_allocator_, iree_allocator_system(), &allocator_));
+  }
+
+  iree_status_t Import(std::vector<uint8_t>& data,
+                       iree_hal_buffer_usage_t usage, ReleaseState* state,
+                       iree_hal_buffer_t** out_buffer) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    params.usage = usage;
+    iree_hal_external_buffer_t external_buffer = {};
+    external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+    external_buffer.size = data.size();
+    external_buffer.handle.host_allocation.ptr = data.data();
+    iree_hal_buffer_release_callback_t release_callback = {CountRelease,
+                                                           state};
+    return iree_hal_allocator_import_buffer(allocator_, params,
+                                            &external_buffer, release_callback,
+                                            out_buffer);
+  }
+
+  const uint8_t* MappedPtr(iree_hal_buffer_t* buffer) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+        IREE_WHOLE_BUFFER, &mapping));
+    const uint8_t* ptr = mapping.contents.data;
+    IREE_CHECK_OK(iree_hal_buffer_unmap_range(&mapping));
+    return ptr;
+  }
+
+  // Removes all segments created by the test so they do not leak into
+  // /dev/shm. Segments otherwise intentionally outlive the process.
+  void UnlinkSegments() {
+#if defined(IREE_PLATFORM_LINUX)
+    DIR* dir = opendir("/dev/shm");
+    if (!dir) return;
+    while (struct dirent* entry = readdir(dir)) {
+      if (strncmp(entry->d_name, prefix_.c_str(), prefix_.size()) == 0) {
+        shm_unlink(("/" + std::string(entry->d_name)).c_str());
+      }
+    }
+    closedir(dir);
+#endif  // IREE_PLATFORM_LINUX
+  }
+
+  std::string prefix_;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(SharedMemoryAllocatorTest, RejectsInvalidPrefix) {
+  iree_hal_shared_memory_allocator_params_t params;
+  iree_hal_shared_memory_allocator_params_initialize(IREE_SV("a/b"), &params);
+  EXPECT_THAT(Status(iree_hal_shared_memory_allocator_create(
+                  &params, device_allocator_, iree_allocator_system(),
+                  &allocator_)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_hal_shared_memory_allocator_create_from_spec(
+                  IREE_SV("prefix=x,bogus=1"), device_allocator_,
+                  iree_allocator_system(), &allocator_)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(SharedMemoryAllocatorTest, MutableImportsPassThrough) {
+  CreateAllocator(0);
+  std::vector<uint8_t> data(4096, 0x5A);
+  ReleaseState state;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(Import(data, IREE_HAL_BUFFER_USAGE_DEFAULT, &state, &buffer));
+  EXPECT_EQ(MappedPtr(buffer), data.data());
+  EXPECT_EQ(state.count, 0);
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(state.count, 1);
+}
+
+TEST_F(SharedMemoryAllocatorTest, SmallImportsPassThrough) {
+  CreateAllocator(1024 * 1024);
+  std::vector<uint8_t> data(4096, 0x5A);
+  ReleaseState state;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(Import(
+      data,
+      IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE,
+      &state, &buffer));
+  EXPECT_EQ(MappedPtr(buffer), data.data());
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(state.count, 1);
+}
+
+#if IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+TEST_F(SharedMemoryAllocatorTest, ImmutableImportsShareSegments) {
+  CreateAllocator(0);
+  std::vector<uint8_t> data0(64 * 1024 + 3);
+  for (size_t i = 0; i < data0.size(); ++i) data0[i] = (uint8_t)(i * 7);
+  std::vector<uint8_t> data1 = data0;
+  const iree_hal_buffer_usage_t usage =
+      IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE;
+
+  // The first import creates the segment and releases the source memory.
+  ReleaseState state0;
+  iree_hal_buffer_t* buffer0 = NULL;
+  IREE_ASSERT_OK(Import(data0, usage, &state0, &buffer0));
+  EXPECT_EQ(state0.count, 1);
+  const uint8_t* ptr0 = MappedPtr(buffer0);
+  EXPECT_NE(ptr0, data0.data());
+  EXPECT_EQ(0, memcmp(ptr0, data0.data(), data0.size()));
+
+  // The second import of identical contents attaches to the same segment and
+  // observes the same physical pages through its own mapping.
+  ReleaseState state1;
+  iree_hal_buffer_t* buffer1 = NULL;
+  IREE_ASSERT_OK(Import(data1, usage, &state1, &buffer1));
+  EXPECT_EQ(state1.count, 1);
+  const uint8_t* ptr1 = MappedPtr(buffer1);
+  EXPECT_NE(ptr1, data1.data());
+  EXPECT_EQ(0, memcmp(ptr1, data1.data(), data1.size()));
+
+  UnlinkSegments();
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_release(buffer1);
+}
+
+#endif  // IREE_HAL_SHARED_MEMORY_ALLOCATOR_ENABLE
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
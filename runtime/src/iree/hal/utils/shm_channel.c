@@ -0,0 +1,931 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// NOTE: must be first before _any_ system includes.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+
+#include "iree/hal/utils/shm_channel.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/threading.h"
+
+#if IREE_HAL_SHM_CHANNEL_ENABLE
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // IREE_HAL_SHM_CHANNEL_ENABLE
+
+// Number of times a participant polls a barrier before yielding its thread.
+// Collectives are usually issued by all ranks at nearly the same time and
+// spinning briefly avoids the scheduler round trip.
+#define IREE_HAL_SHM_CHANNEL_SPIN_COUNT 4096
+
+// Size of the segment header. Keeps the rank slots cache line aligned and the
+// header counters from sharing a line with slot data.
+#define IREE_HAL_SHM_CHANNEL_HEADER_SIZE 256
+
+static iree_atomic_int32_t iree_hal_shm_channel_next_id =
+    IREE_ATOMIC_VAR_INIT(0);
+
+IREE_API_EXPORT void iree_hal_shm_channel_id_generate(
+    iree_hal_shm_channel_id_t* out_id) {
+  IREE_ASSERT_ARGUMENT(out_id);
+#if IREE_HAL_SHM_CHANNEL_ENABLE
+  int pid = (int)getpid();
+#else
+  int pid = 0;
+#endif  // IREE_HAL_SHM_CHANNEL_ENABLE
+  int32_t ordinal = iree_atomic_fetch_add_int32(&iree_hal_shm_channel_next_id,
+                                                1, iree_memory_order_relaxed);
+  memset(out_id, 0, sizeof(*out_id));
+  snprintf(out_id->data, sizeof(out_id->data), "/iree-shm-%d-%d", pid,
+           ordinal);
+}
+
+//===----------------------------------------------------------------------===//
+// Shared memory segments
+//===----------------------------------------------------------------------===//
+
+// Header at the start of the shared segment. All ranks map the same segment
+// and coordinate exclusively through these counters.
+typedef struct iree_hal_shm_channel_header_t {
+  // Total number of ranks that have attached to the segment.
+  iree_atomic_int32_t attached_count;
+  // Number of ranks that have arrived at the current barrier.
+  iree_atomic_int32_t arrived_count;
+  // Incremented by the last rank to arrive at each barrier.
+  iree_atomic_int32_t generation;
+} iree_hal_shm_channel_header_t;
+static_assert(sizeof(iree_hal_shm_channel_header_t) <=
+                  IREE_HAL_SHM_CHANNEL_HEADER_SIZE,
+              "header must fit in its reserved space");
+
+#if IREE_HAL_SHM_CHANNEL_ENABLE
+
+// Maps segment |name| sized for |count| ranks, creating it if needed.
+static iree_status_t iree_hal_shm_channel_segment_map(
+    const char* name, iree_host_size_t mapping_size, void** out_base_ptr) {
+  int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "shm_open of '%s' failed", name);
+  }
+  // All ranks size the segment identically so this is idempotent. New
+  // segments are zero-filled which initializes the header.
+  if (ftruncate(fd, (off_t)mapping_size) != 0) {
+    iree_status_t status = iree_make_status(iree_status_code_from_errno(errno),
+                                            "ftruncate of '%s' failed", name);
+    close(fd);
+    return status;
+  }
+  void* base_ptr =
+      mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base_ptr == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap of '%s' failed", name);
+  }
+  *out_base_ptr = base_ptr;
+  return iree_ok_status();
+}
+
+static void iree_hal_shm_channel_segment_unmap(void* base_ptr,
+                                               iree_host_size_t mapping_size) {
+  munmap(base_ptr, mapping_size);
+}
+
+static void iree_hal_shm_channel_segment_unlink(const char* name) {
+  shm_unlink(name);
+}
+
+#else
+
+static iree_status_t iree_hal_shm_channel_segment_map(
+    const char* name, iree_host_size_t mapping_size, void** out_base_ptr) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "shared memory channels not available on this "
+                          "platform");
+}
+
+static void iree_hal_shm_channel_segment_unmap(void* base_ptr,
+                                               iree_host_size_t mapping_size) {}
+
+static void iree_hal_shm_channel_segment_unlink(const char* name) {}
+
+#endif  // IREE_HAL_SHM_CHANNEL_ENABLE
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_shm_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // This participant's rank in the channel.
+  int32_t rank;
+  // Total number of participants in the channel.
+  int32_t count;
+
+  // Mapped shared memory segment.
+  void* base_ptr;
+  iree_host_size_t mapping_size;
+  iree_hal_shm_channel_header_t* header;
+  // Staging slots of IREE_HAL_SHM_CHANNEL_SLOT_SIZE bytes for each rank.
+  uint8_t* slots;
+} iree_hal_shm_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_shm_channel_vtable;
+
+static iree_hal_shm_channel_t* iree_hal_shm_channel_cast(
+    iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shm_channel_vtable);
+  return (iree_hal_shm_channel_t*)base_value;
+}
+
+static uint8_t* iree_hal_shm_channel_slot(iree_hal_shm_channel_t* channel,
+                                          int32_t rank) {
+  return channel->slots +
+         (iree_host_size_t)rank * IREE_HAL_SHM_CHANNEL_SLOT_SIZE;
+}
+
+// Blocks until all ranks in |channel| have arrived at the barrier.
+// Writes to slots before the barrier are visible to all ranks after it.
+static void iree_hal_shm_channel_barrier(iree_hal_shm_channel_t* channel) {
+  iree_hal_shm_channel_header_t* header = channel->header;
+  int32_t generation =
+      iree_atomic_load_int32(&header->generation, iree_memory_order_acquire);
+  if (iree_atomic_fetch_add_int32(&header->arrived_count, 1,
+                                  iree_memory_order_acq_rel) ==
+      channel->count - 1) {
+    // Last to arrive: reset for the next barrier and release all others.
+    iree_atomic_store_int32(&header->arrived_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int32(&header->generation, 1,
+                                iree_memory_order_release);
+    return;
+  }
+  uint32_t spin = 0;
+  while (iree_atomic_load_int32(&header->generation,
+                                iree_memory_order_acquire) == generation) {
+    if (++spin >= IREE_HAL_SHM_CHANNEL_SPIN_COUNT) iree_thread_yield();
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create(
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+
+  if (params.count <= 0 || params.count > IREE_HAL_SHM_CHANNEL_MAX_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "participant count %d out of range (expected 1 to "
+                            "%d)",
+                            params.count, IREE_HAL_SHM_CHANNEL_MAX_COUNT);
+  }
+  if (params.rank < 0 || params.rank >= params.count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "rank %d out of range of participant count %d",
+                            params.rank, params.count);
+  }
+  iree_hal_shm_channel_id_t id;
+  if (params.id.data_length == 0 || params.id.data_length > sizeof(id.data) ||
+      !memchr(params.id.data, 0, params.id.data_length)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "shared memory channel ID must be a "
+                            "NUL-terminated segment name of at most %" PRIhsz
+                            " bytes",
+                            sizeof(id.data));
+  }
+  memset(&id, 0, sizeof(id));
+  memcpy(id.data, params.id.data, params.id.data_length);
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, id.data);
+
+  iree_hal_shm_channel_t* channel = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel),
+                                (void**)&channel));
+  iree_hal_resource_initialize(&iree_hal_shm_channel_vtable,
+                               &channel->resource);
+  channel->host_allocator = host_allocator;
+  channel->rank = params.rank;
+  channel->count = params.count;
+  channel->mapping_size =
+      IREE_HAL_SHM_CHANNEL_HEADER_SIZE +
+      (iree_host_size_t)params.count * IREE_HAL_SHM_CHANNEL_SLOT_SIZE;
+
+  iree_status_t status = iree_hal_shm_channel_segment_map(
+      id.data, channel->mapping_size, &channel->base_ptr);
+  if (iree_status_is_ok(status)) {
+    channel->header = (iree_hal_shm_channel_header_t*)channel->base_ptr;
+    channel->slots =
+        (uint8_t*)channel->base_ptr + IREE_HAL_SHM_CHANNEL_HEADER_SIZE;
+
+    // Wait for all participants to attach. Once they have the name is
+    // unlinked so that the segment is released when the last rank unmaps it
+    // even if processes exit abnormally.
+    int32_t attached_count =
+        iree_atomic_fetch_add_int32(&channel->header->attached_count, 1,
+                                    iree_memory_order_acq_rel) +
+        1;
+    if (attached_count > channel->count) {
+      status = iree_make_status(
+          IREE_STATUS_FAILED_PRECONDITION,
+          "shared memory segment '%s' has more participants than the channel "
+          "count %d; a stale segment may need to be removed",
+          id.data, channel->count);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    for (uint32_t spin = 0;
+         iree_atomic_load_int32(&channel->header->attached_count,
+                                iree_memory_order_acquire) < channel->count;
+         ++spin) {
+      if (spin >= IREE_HAL_SHM_CHANNEL_SPIN_COUNT) iree_thread_yield();
+    }
+    if (channel->rank == 0) iree_hal_shm_channel_segment_unlink(id.data);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_channel = (iree_hal_channel_t*)channel;
+  } else {
+    iree_hal_channel_release((iree_hal_channel_t*)channel);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create_with_provider(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+
+  // Ask the channel provider (if configured) for the default rank and count
+  // if the user did not set them.
+  if (channel_provider && (params.rank == IREE_HAL_CHANNEL_RANK_DEFAULT ||
+                           params.count == IREE_HAL_CHANNEL_COUNT_DEFAULT)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_channel_provider_query_default_rank_and_count(
+            channel_provider, &params.rank, &params.count),
+        "querying default collective group rank and count");
+  }
+
+  iree_hal_shm_channel_id_t id;
+  memset(&id, 0, sizeof(id));
+  if (iree_const_byte_span_is_empty(params.id)) {
+    // User wants the default ID.
+    if (!channel_provider) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "default collective channel ID requested but no channel provider has "
+          "been set on the device to provide it");
+    }
+    if (params.rank == 0) iree_hal_shm_channel_id_generate(&id);
+    IREE_RETURN_IF_ERROR(iree_hal_channel_provider_exchange_default_id(
+                             channel_provider,
+                             iree_make_byte_span((void*)&id, sizeof(id))),
+                         "exchanging shared memory channel ID with other "
+                         "participants");
+    id.data[sizeof(id.data) - 1] = 0;
+    params.id = iree_make_const_byte_span(id.data, sizeof(id.data));
+  }
+
+  return iree_hal_shm_channel_create(params, host_allocator, out_channel);
+}
+
+static void iree_hal_shm_channel_destroy(iree_hal_channel_t* base_channel) {
+  iree_hal_shm_channel_t* channel = iree_hal_shm_channel_cast(base_channel);
+  iree_allocator_t host_allocator = channel->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (channel->base_ptr) {
+    iree_hal_shm_channel_segment_unmap(channel->base_ptr,
+                                       channel->mapping_size);
+  }
+  iree_allocator_free(host_allocator, channel);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_hal_shm_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_shm_channel_vtable);
+}
+
+static iree_status_t iree_hal_shm_channel_split(
+    iree_hal_channel_t* base_channel, int32_t color, int32_t key,
+    iree_hal_channel_flags_t flags, iree_hal_channel_t** out_split_channel) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "shared memory channels cannot be split");
+}
+
+static void iree_hal_shm_channel_query_rank_and_count(
+    const iree_hal_channel_t* base_channel, int32_t* out_rank,
+    int32_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  iree_hal_shm_channel_t* channel =
+      iree_hal_shm_channel_cast((iree_hal_channel_t*)base_channel);
+  *out_rank = channel->rank;
+  *out_count = channel->count;
+}
+
+//===----------------------------------------------------------------------===//
+// Reduction kernels
+//===----------------------------------------------------------------------===//
+// Simple restrict-qualified loops over contiguous elements that compilers
+// vectorize for the target ISA.
+
+#define IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(name, T)                          \
+  static void iree_hal_shm_channel_reduce_##name(                           \
+      iree_hal_collective_reduction_t reduction, T* IREE_RESTRICT target,   \
+      const T* IREE_RESTRICT source, iree_host_size_t count) {              \
+    switch (reduction) {                                                    \
+      case IREE_HAL_COLLECTIVE_REDUCTION_SUM:                               \
+      case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:                           \
+        for (iree_host_size_t i = 0; i < count; ++i) target[i] += source[i]; \
+        break;                                                              \
+      case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:                           \
+        for (iree_host_size_t i = 0; i < count; ++i) target[i] *= source[i]; \
+        break;                                                              \
+      case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:                           \
+        for (iree_host_size_t i = 0; i < count; ++i) {                      \
+          target[i] = source[i] < target[i] ? source[i] : target[i];        \
+        }                                                                   \
+        break;                                                              \
+      case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:                           \
+        for (iree_host_size_t i = 0; i < count; ++i) {                      \
+          target[i] = source[i] > target[i] ? source[i] : target[i];        \
+        }                                                                   \
+        break;                                                              \
+      default:                                                              \
+        break;                                                              \
+    }                                                                       \
+  }                                                                         \
+  static void iree_hal_shm_channel_scale_##name(                            \
+      T* IREE_RESTRICT target, iree_host_size_t count, int32_t divisor) {   \
+    for (iree_host_size_t i = 0; i < count; ++i) target[i] /= (T)divisor;  \
+  }
+
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(i8, int8_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(u8, uint8_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(i16, int16_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(u16, uint16_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(i32, int32_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(u32, uint32_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(i64, int64_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(u64, uint64_t);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(f32, float);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL(f64, double);
+
+// 16-bit floating-point types are reduced in f32 and rounded per step.
+#define IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL_FP16(name, to_f32, from_f32)     \
+  static void iree_hal_shm_channel_reduce_##name(                           \
+      iree_hal_collective_reduction_t reduction,                            \
+      uint16_t* IREE_RESTRICT target, const uint16_t* IREE_RESTRICT source, \
+      iree_host_size_t count) {                                             \
+    for (iree_host_size_t i = 0; i < count; ++i) {                          \
+      float lhs = to_f32(target[i]);                                        \
+      float rhs = to_f32(source[i]);                                        \
+      float result = lhs;                                                   \
+      switch (reduction) {                                                  \
+        case IREE_HAL_COLLECTIVE_REDUCTION_SUM:                             \
+        case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:                         \
+          result = lhs + rhs;                                               \
+          break;                                                            \
+        case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:                         \
+          result = lhs * rhs;                                               \
+          break;                                                            \
+        case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:                         \
+          result = rhs < lhs ? rhs : lhs;                                   \
+          break;                                                            \
+        case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:                         \
+          result = rhs > lhs ? rhs : lhs;                                   \
+          break;                                                            \
+        default:                                                            \
+          break;                                                            \
+      }                                                                     \
+      target[i] = from_f32(result);                                         \
+    }                                                                       \
+  }                                                                         \
+  static void iree_hal_shm_channel_scale_##name(                            \
+      uint16_t* IREE_RESTRICT target, iree_host_size_t count,               \
+      int32_t divisor) {                                                    \
+    for (iree_host_size_t i = 0; i < count; ++i) {                          \
+      target[i] = from_f32(to_f32(target[i]) / (float)divisor);             \
+    }                                                                       \
+  }
+
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL_FP16(f16, iree_math_f16_to_f32,
+                                        iree_math_f32_to_f16);
+IREE_HAL_SHM_CHANNEL_REDUCE_KERNEL_FP16(bf16, iree_math_bf16_to_f32,
+                                        iree_math_f32_to_bf16);
+
+// Combines |count| elements of |source| into |target| using the reduction of
+// |op|.
+static void iree_hal_shm_channel_reduce(iree_hal_collective_op_t op,
+                                        void* target, const void* source,
+                                        iree_host_size_t count) {
+  switch (op.element_type) {
+#define IREE_HAL_SHM_CHANNEL_REDUCE_CASE(type, name, T)              \
+  case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_##type:                      \
+    iree_hal_shm_channel_reduce_##name(op.reduction, (T*)target,     \
+                                       (const T*)source, count);     \
+    break;
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(SINT_8, i8, int8_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(UINT_8, u8, uint8_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(SINT_16, i16, int16_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(UINT_16, u16, uint16_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(SINT_32, i32, int32_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(UINT_32, u32, uint32_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(SINT_64, i64, int64_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(UINT_64, u64, uint64_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(FLOAT_16, f16, uint16_t)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(FLOAT_32, f32, float)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(FLOAT_64, f64, double)
+    IREE_HAL_SHM_CHANNEL_REDUCE_CASE(BFLOAT_16, bf16, uint16_t)
+#undef IREE_HAL_SHM_CHANNEL_REDUCE_CASE
+    default:
+      break;
+  }
+}
+
+// Divides |count| elements of |target| by |divisor| to compute averages.
+static void iree_hal_shm_channel_scale(iree_hal_collective_op_t op,
+                                       void* target, iree_host_size_t count,
+                                       int32_t divisor) {
+  switch (op.element_type) {
+#define IREE_HAL_SHM_CHANNEL_SCALE_CASE(type, name, T)                \
+  case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_##type:                       \
+    iree_hal_shm_channel_scale_##name((T*)target, count, divisor);    \
+    break;
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(SINT_8, i8, int8_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(UINT_8, u8, uint8_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(SINT_16, i16, int16_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(UINT_16, u16, uint16_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(SINT_32, i32, int32_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(UINT_32, u32, uint32_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(SINT_64, i64, int64_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(UINT_64, u64, uint64_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(FLOAT_16, f16, uint16_t)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(FLOAT_32, f32, float)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(FLOAT_64, f64, double)
+    IREE_HAL_SHM_CHANNEL_SCALE_CASE(BFLOAT_16, bf16, uint16_t)
+#undef IREE_HAL_SHM_CHANNEL_SCALE_CASE
+    default:
+      break;
+  }
+}
+
+// Reduces |length| bytes at |slot_offset| in the slots of all ranks into
+// |target| in rank order so that all ranks compute bitwise identical results.
+static void iree_hal_shm_channel_reduce_slots(iree_hal_shm_channel_t* channel,
+                                              iree_hal_collective_op_t op,
+                                              iree_host_size_t slot_offset,
+                                              uint8_t* target,
+                                              iree_host_size_t length) {
+  iree_host_size_t count =
+      length / iree_hal_collective_element_byte_count(op.element_type);
+  memcpy(target, iree_hal_shm_channel_slot(channel, 0) + slot_offset, length);
+  for (int32_t r = 1; r < channel->count; ++r) {
+    iree_hal_shm_channel_reduce(
+        op, target, iree_hal_shm_channel_slot(channel, r) + slot_offset, count);
+  }
+  if (op.reduction == IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE) {
+    iree_hal_shm_channel_scale(op, target, count, channel->count);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Collective operations
+//===----------------------------------------------------------------------===//
+// Each operation stages up to one slot of data per rank, synchronizes, and
+// consumes the slots of the other ranks before a second barrier allows the
+// slots to be reused for the next chunk.
+
+static void iree_hal_shm_channel_all_gather(iree_hal_shm_channel_t* channel,
+                                            const uint8_t* send, uint8_t* recv,
+                                            iree_host_size_t length) {
+  for (iree_host_size_t offset = 0; offset < length;
+       offset += IREE_HAL_SHM_CHANNEL_SLOT_SIZE) {
+    iree_host_size_t chunk_length =
+        iree_min(IREE_HAL_SHM_CHANNEL_SLOT_SIZE, length - offset);
+    memcpy(iree_hal_shm_channel_slot(channel, channel->rank), send + offset,
+           chunk_length);
+    iree_hal_shm_channel_barrier(channel);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(recv + r * length + offset, iree_hal_shm_channel_slot(channel, r),
+             chunk_length);
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Reduces |length| bytes of |send| from all ranks into |recv| on |root| or all
+// ranks if |root| is negative.
+static void iree_hal_shm_channel_reduce_to(iree_hal_shm_channel_t* channel,
+                                           iree_hal_collective_op_t op,
+                                           int32_t root, const uint8_t* send,
+                                           uint8_t* recv,
+                                           iree_host_size_t length,
+                                           iree_host_size_t element_size) {
+  const iree_host_size_t max_chunk_length =
+      IREE_HAL_SHM_CHANNEL_SLOT_SIZE / element_size * element_size;
+  for (iree_host_size_t offset = 0; offset < length;
+       offset += max_chunk_length) {
+    iree_host_size_t chunk_length =
+        iree_min(max_chunk_length, length - offset);
+    memcpy(iree_hal_shm_channel_slot(channel, channel->rank), send + offset,
+           chunk_length);
+    iree_hal_shm_channel_barrier(channel);
+    if (root < 0 || root == channel->rank) {
+      iree_hal_shm_channel_reduce_slots(channel, op, 0, recv + offset,
+                                        chunk_length);
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Exchanges |block_length| byte blocks such that block r of |send| on each
+// rank s lands in block s of |recv| on rank r. When |op| reduces the blocks
+// received from all ranks are instead reduced into |recv| (reduce-scatter).
+static void iree_hal_shm_channel_exchange_blocks(
+    iree_hal_shm_channel_t* channel, iree_hal_collective_op_t op, bool reduce,
+    const uint8_t* send, uint8_t* recv, iree_host_size_t block_length,
+    iree_host_size_t element_size) {
+  const iree_host_size_t max_chunk_length =
+      IREE_HAL_SHM_CHANNEL_SLOT_SIZE / channel->count / element_size *
+      element_size;
+  for (iree_host_size_t offset = 0; offset < block_length;
+       offset += max_chunk_length) {
+    iree_host_size_t chunk_length =
+        iree_min(max_chunk_length, block_length - offset);
+    uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(slot + r * max_chunk_length, send + r * block_length + offset,
+             chunk_length);
+    }
+    iree_hal_shm_channel_barrier(channel);
+    const iree_host_size_t slot_offset = channel->rank * max_chunk_length;
+    if (reduce) {
+      iree_hal_shm_channel_reduce_slots(channel, op, slot_offset,
+                                        recv + offset, chunk_length);
+    } else {
+      for (int32_t s = 0; s < channel->count; ++s) {
+        memcpy(recv + s * block_length + offset,
+               iree_hal_shm_channel_slot(channel, s) + slot_offset,
+               chunk_length);
+      }
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Copies |length| bytes of |send| on the |source| rank to |recv| on each rank
+// that has |source| as its source. Used for both broadcast (all ranks read
+// from the root) and send-recv pairs (each rank reads from its own source).
+// Ranks with a negative |source| receive zeros.
+static void iree_hal_shm_channel_copy_from(iree_hal_shm_channel_t* channel,
+                                           bool has_send, int32_t source,
+                                           const uint8_t* send, uint8_t* recv,
+                                           iree_host_size_t length) {
+  for (iree_host_size_t offset = 0; offset < length;
+       offset += IREE_HAL_SHM_CHANNEL_SLOT_SIZE) {
+    iree_host_size_t chunk_length =
+        iree_min(IREE_HAL_SHM_CHANNEL_SLOT_SIZE, length - offset);
+    if (has_send) {
+      memcpy(iree_hal_shm_channel_slot(channel, channel->rank), send + offset,
+             chunk_length);
+    }
+    iree_hal_shm_channel_barrier(channel);
+    if (recv) {
+      if (source >= 0) {
+        memcpy(recv + offset, iree_hal_shm_channel_slot(channel, source),
+               chunk_length);
+      } else {
+        memset(recv + offset, 0, chunk_length);
+      }
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_execute(
+    iree_hal_channel_t* base_channel, iree_hal_collective_op_t op,
+    uint32_t param, iree_const_byte_span_t send, iree_byte_span_t recv,
+    iree_device_size_t element_count) {
+  iree_hal_shm_channel_t* channel = iree_hal_shm_channel_cast(base_channel);
+  const int32_t rank = channel->rank;
+  const int32_t count = channel->count;
+  const iree_host_size_t element_size =
+      (iree_host_size_t)iree_hal_collective_element_byte_count(
+          op.element_type);
+  const iree_host_size_t length =
+      (iree_host_size_t)element_count * element_size;
+
+  // Determine the storage required on this rank and validate parameters.
+  bool is_reduction = false;
+  iree_host_size_t send_length = 0;
+  iree_host_size_t recv_length = 0;
+  int32_t root = (int32_t)param;
+  int16_t send_target = -1;
+  int16_t recv_source = -1;
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+      send_length = length;
+      recv_length = length * count;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+      is_reduction = true;
+      send_length = length;
+      recv_length = length;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL:
+      if (element_count % count != 0) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "all-to-all element count %" PRIu64
+                                " not divisible by participant count %d",
+                                (uint64_t)element_count, count);
+      }
+      send_length = length;
+      recv_length = length;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+      send_length = rank == root ? length : 0;
+      recv_length = rank == root ? 0 : length;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+      is_reduction = true;
+      send_length = length;
+      recv_length = rank == root ? length : 0;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      is_reduction = true;
+      send_length = length * count;
+      recv_length = length;
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV:
+      memcpy(&send_target, &param, 2);
+      memcpy(&recv_source, (char*)&param + 2, 2);
+      if (send_target >= count || recv_source >= count) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "send-recv ranks %d/%d out of range of "
+                                "participant count %d",
+                                send_target, recv_source, count);
+      }
+      send_length = send_target >= 0 ? length : 0;
+      recv_length = length;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported shared memory collective kind %u",
+                              (uint32_t)op.kind);
+  }
+  if ((op.kind == IREE_HAL_COLLECTIVE_KIND_BROADCAST ||
+       op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE) &&
+      root >= count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "root rank %d out of range of participant count %d",
+                            root, count);
+  }
+  if (is_reduction &&
+      (op.reduction < IREE_HAL_COLLECTIVE_REDUCTION_SUM ||
+       op.reduction > IREE_HAL_COLLECTIVE_REDUCTION_MAX_VALUE)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported collective reduction %u",
+                            (uint32_t)op.reduction);
+  }
+  if (send.data_length < send_length || recv.data_length < recv_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "collective buffers too small (send %" PRIhsz
+                            " < %" PRIhsz " or recv %" PRIhsz " < %" PRIhsz
+                            ")",
+                            send.data_length, send_length, recv.data_length,
+                            recv_length);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+      iree_hal_shm_channel_all_gather(channel, send.data, recv.data, length);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+      iree_hal_shm_channel_reduce_to(channel, op, /*root=*/-1, send.data,
+                                     recv.data, length, element_size);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL:
+      iree_hal_shm_channel_exchange_blocks(channel, op, /*reduce=*/false,
+                                           send.data, recv.data,
+                                           length / count, element_size);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+      iree_hal_shm_channel_copy_from(channel, /*has_send=*/rank == root, root,
+                                     send.data,
+                                     rank == root ? NULL : recv.data, length);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+      iree_hal_shm_channel_reduce_to(channel, op, root, send.data, recv.data,
+                                     length, element_size);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      iree_hal_shm_channel_exchange_blocks(channel, op, /*reduce=*/true,
+                                           send.data, recv.data, length,
+                                           element_size);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV:
+      iree_hal_shm_channel_copy_from(channel, /*has_send=*/send_target >= 0,
+                                     recv_source, send.data, recv.data,
+                                     length);
+      break;
+    default:
+      break;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_execute_bindings(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
+  iree_hal_buffer_mapping_t send_mapping;
+  memset(&send_mapping, 0, sizeof(send_mapping));
+  iree_hal_buffer_mapping_t recv_mapping;
+  memset(&recv_mapping, 0, sizeof(recv_mapping));
+
+  iree_status_t status = iree_ok_status();
+  if (send_binding.buffer) {
+    status = iree_hal_buffer_map_range(
+        send_binding.buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_READ, send_binding.offset, send_binding.length,
+        &send_mapping);
+  }
+  if (iree_status_is_ok(status) && recv_binding.buffer) {
+    status = iree_hal_buffer_map_range(
+        recv_binding.buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_WRITE, recv_binding.offset, recv_binding.length,
+        &recv_mapping);
+    if (!iree_status_is_ok(status) && send_binding.buffer) {
+      status = iree_status_join(status,
+                                iree_hal_buffer_unmap_range(&send_mapping));
+      return status;
+    }
+  }
+  if (!iree_status_is_ok(status)) return status;
+
+  status = iree_hal_shm_channel_execute(
+      channel, op, param,
+      iree_make_const_byte_span(send_mapping.contents.data,
+                                send_mapping.contents.data_length),
+      recv_mapping.contents, element_count);
+
+  if (recv_binding.buffer) {
+    status =
+        iree_status_join(status, iree_hal_buffer_unmap_range(&recv_mapping));
+  }
+  if (send_binding.buffer) {
+    status =
+        iree_status_join(status, iree_hal_buffer_unmap_range(&send_mapping));
+  }
+  return status;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_shm_channel_vtable = {
+    .destroy = iree_hal_shm_channel_destroy,
+    .split = iree_hal_shm_channel_split,
+    .query_rank_and_count = iree_hal_shm_channel_query_rank_and_count,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_provider_t
+//===----------------------------------------------------------------------===//
+
+// Parses the integer environment variable |var_name| into |out_value|.
+static bool iree_hal_shm_channel_env_int32(const char* var_name,
+                                           int32_t* out_value) {
+  const char* var_value = getenv(var_name);
+  if (!var_value || strlen(var_value) == 0) return false;
+  char* end = NULL;
+  long value = strtol(var_value, &end, 10);
+  if (*end != 0 || value < 0 || value > INT32_MAX) return false;
+  *out_value = (int32_t)value;
+  return true;
+}
+
+IREE_API_EXPORT bool iree_hal_shm_channel_is_configured(void) {
+  if (!IREE_HAL_SHM_CHANNEL_ENABLE) return false;
+  int32_t value = 0;
+  return iree_hal_shm_channel_env_int32("IREE_SHM_CHANNEL_RANK", &value) &&
+         iree_hal_shm_channel_env_int32("IREE_SHM_CHANNEL_COUNT", &value);
+}
+
+typedef struct iree_hal_shm_channel_provider_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  // Number of default IDs handed out so far. All participants create channels
+  // in the same order and derive identical names for each.
+  int32_t next_ordinal;
+} iree_hal_shm_channel_provider_t;
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_shm_channel_provider_vtable;
+
+static iree_hal_shm_channel_provider_t* iree_hal_shm_channel_provider_cast(
+    iree_hal_channel_provider_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shm_channel_provider_vtable);
+  return (iree_hal_shm_channel_provider_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_provider_create(
+    iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_provider) {
+  IREE_ASSERT_ARGUMENT(out_channel_provider);
+  *out_channel_provider = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_shm_channel_provider_t* channel_provider = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel_provider),
+                                (void**)&channel_provider));
+  iree_hal_resource_initialize(&iree_hal_shm_channel_provider_vtable,
+                               &channel_provider->resource);
+  channel_provider->host_allocator = host_allocator;
+  channel_provider->next_ordinal = 0;
+
+  *out_channel_provider = (iree_hal_channel_provider_t*)channel_provider;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_shm_channel_provider_destroy(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_shm_channel_provider_t* channel_provider =
+      iree_hal_shm_channel_provider_cast(base_channel_provider);
+  iree_allocator_t host_allocator = channel_provider->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_free(host_allocator, channel_provider);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_shm_channel_provider_query_default_rank_and_count(
+    iree_hal_channel_provider_t* base_channel_provider, int32_t* out_rank,
+    int32_t* out_count) {
+  if (!iree_hal_shm_channel_env_int32("IREE_SHM_CHANNEL_RANK", out_rank) ||
+      !iree_hal_shm_channel_env_int32("IREE_SHM_CHANNEL_COUNT", out_count)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "IREE_SHM_CHANNEL_RANK and IREE_SHM_CHANNEL_COUNT "
+                            "must be set to non-negative integers");
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_shm_channel_provider_exchange_default_id(
+    iree_hal_channel_provider_t* base_channel_provider, iree_byte_span_t id) {
+  iree_hal_shm_channel_provider_t* channel_provider =
+      iree_hal_shm_channel_provider_cast(base_channel_provider);
+
+  // All participants derive the same name from the environment so there is
+  // nothing to exchange. Processes launched together share a parent process.
+  char base_name[32] = {0};
+  const char* name = getenv("IREE_SHM_CHANNEL_NAME");
+  if (!name || strlen(name) == 0) {
+#if IREE_HAL_SHM_CHANNEL_ENABLE
+    snprintf(base_name, sizeof(base_name), "/iree-shm-%d", (int)getppid());
+#endif  // IREE_HAL_SHM_CHANNEL_ENABLE
+    name = base_name;
+  }
+  int32_t ordinal = channel_provider->next_ordinal++;
+  int length = snprintf((char*)id.data, id.data_length, "%s%s-%d",
+                        name[0] == '/' ? "" : "/", name, ordinal);
+  if (length < 0 || (iree_host_size_t)length >= id.data_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "shared memory channel name '%s' too long", name);
+  }
+  return iree_ok_status();
+}
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_shm_channel_provider_vtable = {
+        .destroy = iree_hal_shm_channel_provider_destroy,
+        .query_default_rank_and_count =
+            iree_hal_shm_channel_provider_query_default_rank_and_count,
+        .exchange_default_id =
+            iree_hal_shm_channel_provider_exchange_default_id,
+};
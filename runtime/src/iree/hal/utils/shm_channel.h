@@ -0,0 +1,123 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_SHM_CHANNEL_H_
+#define IREE_HAL_UTILS_SHM_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Set to 1 to enable POSIX shared memory channels. When disabled channel
+// creation fails with IREE_STATUS_UNAVAILABLE.
+#if !defined(IREE_HAL_SHM_CHANNEL_ENABLE)
+#if (defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)) || \
+    defined(IREE_PLATFORM_APPLE)
+#define IREE_HAL_SHM_CHANNEL_ENABLE 1
+#else
+#define IREE_HAL_SHM_CHANNEL_ENABLE 0
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_APPLE
+#endif  // !IREE_HAL_SHM_CHANNEL_ENABLE
+
+// Maximum number of participants in a shared memory channel.
+#define IREE_HAL_SHM_CHANNEL_MAX_COUNT 64
+
+// Size in bytes of the staging slot each rank owns in the shared segment.
+// Collectives larger than a slot are performed in multiple chunks.
+#define IREE_HAL_SHM_CHANNEL_SLOT_SIZE (1 * 1024 * 1024)
+
+// Identifies the shared memory segment all participants of a channel attach
+// to. The ID is the NUL-terminated segment name (such as `/iree-shm-1234-0`).
+typedef struct iree_hal_shm_channel_id_t {
+  char data[64];
+} iree_hal_shm_channel_id_t;
+
+// Generates a process-unique channel ID. Only the root participant should
+// generate an ID and then share it with all other participants.
+IREE_API_EXPORT void iree_hal_shm_channel_id_generate(
+    iree_hal_shm_channel_id_t* out_id);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_t
+//===----------------------------------------------------------------------===//
+
+// Creates a collective channel between processes on the same host using a
+// shared memory segment named by |params.id| (the bytes of an
+// iree_hal_shm_channel_id_t). |params.rank| and |params.count| must be
+// resolved by the caller.
+//
+// Each rank owns a staging slot in the segment. Collectives copy local data
+// into the slot of the rank, synchronize all ranks with a barrier in shared
+// memory, and then read (and reduce) directly out of the slots of the other
+// ranks. Creation blocks until all |params.count| participants have attached.
+//
+// Collective operations block the calling thread until all participants have
+// issued the same operation; callers must ensure all ranks issue collectives
+// in the same order.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create(
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
+
+// Creates a shared memory channel as with iree_hal_shm_channel_create after
+// resolving any default fields of |params| using the optional
+// |channel_provider|. If no ID is specified the root participant generates
+// one and the provider exchanges it with all other participants. Intended for
+// implementing iree_hal_device_create_channel on CPU devices.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create_with_provider(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| is a shared memory channel.
+IREE_API_EXPORT bool iree_hal_shm_channel_isa(iree_hal_channel_t* channel);
+
+// Performs the collective |op| on |channel| using host memory. |send| and
+// |recv| must be sized as required by the operation and |element_count| (see
+// iree_hal_collective_kind_t). Blocks until the operation has completed on
+// this rank.
+//
+// IREE_HAL_COLLECTIVE_KIND_SEND and IREE_HAL_COLLECTIVE_KIND_RECV are not
+// supported as they do not involve all participants.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_execute(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    iree_const_byte_span_t send, iree_byte_span_t recv,
+    iree_device_size_t element_count);
+
+// Performs the collective |op| as with iree_hal_shm_channel_execute on the
+// host-mappable buffers referenced by |send_binding| and |recv_binding|.
+// Bindings unused by the operation on this rank may have a NULL buffer.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_execute_bindings(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_provider_t
+//===----------------------------------------------------------------------===//
+
+// Returns true if shared memory collectives have been configured by the user
+// and should be used. This checks for the IREE_SHM_CHANNEL_RANK and
+// IREE_SHM_CHANNEL_COUNT environment variables that a launcher sets for each
+// process.
+IREE_API_EXPORT bool iree_hal_shm_channel_is_configured(void);
+
+// Creates a channel provider that sources the default rank and count from the
+// IREE_SHM_CHANNEL_RANK and IREE_SHM_CHANNEL_COUNT environment variables and
+// the default channel ID from IREE_SHM_CHANNEL_NAME. Processes launched
+// together must share the same name; when unset the name is derived from the
+// parent process ID.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_provider_create(
+    iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_provider);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_SHM_CHANNEL_H_
@@ -0,0 +1,243 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/shm_channel.h"
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Each rank is simulated by a thread that maps the segment independently as a
+// separate process would.
+class ShmChannelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+#if !IREE_HAL_SHM_CHANNEL_ENABLE
+    GTEST_SKIP() << "shared memory channels not available";
+#endif  // !IREE_HAL_SHM_CHANNEL_ENABLE
+    iree_hal_shm_channel_id_generate(&id_);
+  }
+
+  iree_status_t CreateChannel(int32_t rank, int32_t count,
+                              iree_hal_channel_t** out_channel) {
+    iree_hal_channel_params_t params = {};
+    params.id = iree_make_const_byte_span(id_.data, sizeof(id_.data));
+    params.rank = rank;
+    params.count = count;
+    return iree_hal_shm_channel_create(params, iree_allocator_system(),
+                                       out_channel);
+  }
+
+  // Runs |fn| on |count| ranks concurrently each with its own channel.
+  void RunRanks(int32_t count,
+                std::function<void(iree_hal_channel_t*, int32_t)> fn) {
+    std::vector<std::thread> threads;
+    for (int32_t rank = 0; rank < count; ++rank) {
+      threads.emplace_back([this, count, rank, &fn]() {
+        iree_hal_channel_t* channel = NULL;
+        IREE_ASSERT_OK(CreateChannel(rank, count, &channel));
+        fn(channel, rank);
+        iree_hal_channel_release(channel);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  static iree_hal_collective_op_t MakeOp(
+      iree_hal_collective_kind_t kind,
+      iree_hal_collective_reduction_t reduction,
+      iree_hal_collective_element_type_t element_type) {
+    iree_hal_collective_op_t op = {};
+    op.kind = kind;
+    op.reduction = reduction;
+    op.element_type = element_type;
+    return op;
+  }
+
+  template <typename T>
+  static iree_const_byte_span_t ConstSpan(const std::vector<T>& values) {
+    return iree_make_const_byte_span(values.data(), values.size() * sizeof(T));
+  }
+
+  template <typename T>
+  static iree_byte_span_t Span(std::vector<T>& values) {
+    return iree_make_byte_span(values.data(), values.size() * sizeof(T));
+  }
+
+  iree_hal_shm_channel_id_t id_;
+};
+
+TEST_F(ShmChannelTest, QueryRankAndCount) {
+  RunRanks(2, [](iree_hal_channel_t* channel, int32_t rank) {
+    EXPECT_TRUE(iree_hal_shm_channel_isa(channel));
+    int32_t queried_rank = -1, queried_count = -1;
+    iree_hal_channel_query_rank_and_count(channel, &queried_rank,
+                                          &queried_count);
+    EXPECT_EQ(queried_rank, rank);
+    EXPECT_EQ(queried_count, 2);
+  });
+}
+
+TEST_F(ShmChannelTest, InvalidRank) {
+  iree_hal_channel_t* channel = NULL;
+  EXPECT_THAT(Status(CreateChannel(/*rank=*/2, /*count=*/2, &channel)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(channel, nullptr);
+}
+
+// Spans multiple slots to exercise chunking.
+TEST_F(ShmChannelTest, AllReduceSumF32) {
+  constexpr int32_t kCount = 3;
+  const iree_host_size_t element_count =
+      IREE_HAL_SHM_CHANNEL_SLOT_SIZE / sizeof(float) * 2 + 7;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<float> send(element_count);
+    for (iree_host_size_t i = 0; i < element_count; ++i) {
+      send[i] = (float)(rank + i % 16);
+    }
+    std::vector<float> recv(element_count);
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+               IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32),
+        /*param=*/0, ConstSpan(send), Span(recv), element_count));
+    for (iree_host_size_t i = 0; i < element_count; ++i) {
+      ASSERT_EQ(recv[i], (float)(0 + 1 + 2 + 3 * (i % 16)));
+    }
+  });
+}
+
+TEST_F(ShmChannelTest, AllReduceInPlaceAverageI32) {
+  constexpr int32_t kCount = 4;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<int32_t> values = {rank * 4, 8, -rank * 4};
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+               IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        /*param=*/0, ConstSpan(values), Span(values), values.size()));
+    EXPECT_EQ(values, (std::vector<int32_t>{6, 8, -6}));
+  });
+}
+
+TEST_F(ShmChannelTest, AllGather) {
+  constexpr int32_t kCount = 3;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<uint8_t> send = {(uint8_t)rank, (uint8_t)(rank + 10)};
+    std::vector<uint8_t> recv(send.size() * kCount);
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_GATHER,
+               IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8),
+        /*param=*/0, ConstSpan(send), Span(recv), send.size()));
+    EXPECT_EQ(recv, (std::vector<uint8_t>{0, 10, 1, 11, 2, 12}));
+  });
+}
+
+TEST_F(ShmChannelTest, Broadcast) {
+  constexpr int32_t kCount = 3;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<int64_t> send = {1, 2, 3};
+    std::vector<int64_t> recv(send.size());
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_BROADCAST,
+               IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_64),
+        /*param=*/1, rank == 1 ? ConstSpan(send) : iree_const_byte_span_empty(),
+        rank == 1 ? iree_byte_span_empty() : Span(recv), send.size()));
+    if (rank != 1) {
+      EXPECT_EQ(recv, send);
+    }
+  });
+}
+
+TEST_F(ShmChannelTest, ReduceScatterMax) {
+  constexpr int32_t kCount = 2;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<float> send = rank == 0 ? std::vector<float>{1, 5, 3, 8}
+                                        : std::vector<float>{4, 2, 6, 7};
+    std::vector<float> recv(2);
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER,
+               IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32),
+        /*param=*/0, ConstSpan(send), Span(recv), recv.size()));
+    EXPECT_EQ(recv, rank == 0 ? (std::vector<float>{4, 5})
+                              : (std::vector<float>{6, 8}));
+  });
+}
+
+TEST_F(ShmChannelTest, AllToAll) {
+  constexpr int32_t kCount = 2;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<int32_t> send = {rank * 10 + 0, rank * 10 + 1, rank * 10 + 2,
+                                 rank * 10 + 3};
+    std::vector<int32_t> recv(send.size());
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL,
+               IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        /*param=*/0, ConstSpan(send), Span(recv), send.size()));
+    EXPECT_EQ(recv, rank == 0 ? (std::vector<int32_t>{0, 1, 10, 11})
+                              : (std::vector<int32_t>{2, 3, 12, 13}));
+  });
+}
+
+// Each rank sends to the next and receives from the previous, except that
+// rank 0 receives nothing and gets zeros.
+TEST_F(ShmChannelTest, SendRecvShift) {
+  constexpr int32_t kCount = 3;
+  RunRanks(kCount, [&](iree_hal_channel_t* channel, int32_t rank) {
+    int16_t target = (int16_t)(rank + 1 < kCount ? rank + 1 : -1);
+    int16_t source = (int16_t)(rank > 0 ? rank - 1 : -1);
+    uint32_t param = (uint16_t)target | ((uint32_t)(uint16_t)source << 16);
+    std::vector<int32_t> send = {rank + 100};
+    std::vector<int32_t> recv = {-1};
+    IREE_ASSERT_OK(iree_hal_shm_channel_execute(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_SEND_RECV,
+               IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        param, ConstSpan(send), Span(recv), send.size()));
+    EXPECT_EQ(recv[0], rank > 0 ? rank - 1 + 100 : 0);
+  });
+}
+
+TEST_F(ShmChannelTest, SendUnimplemented) {
+  RunRanks(1, [&](iree_hal_channel_t* channel, int32_t rank) {
+    std::vector<int32_t> send = {1};
+    EXPECT_THAT(Status(iree_hal_shm_channel_execute(
+                    channel,
+                    MakeOp(IREE_HAL_COLLECTIVE_KIND_SEND,
+                           IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+                           IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+                    /*param=*/0, ConstSpan(send), iree_byte_span_empty(),
+                    send.size())),
+                StatusIs(StatusCode::kUnimplemented));
+  });
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -4,8 +4,15 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// Needed for madvise and MAP_POPULATE.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+
 #include "iree/io/file_handle.h"
 
+#include <string.h>
+
 #include "iree/base/internal/atomics.h"
 
 //===----------------------------------------------------------------------===//
@@ -99,3 +106,403 @@ iree_io_file_handle_primitive(const iree_io_file_handle_t* handle) {
   IREE_ASSERT_ARGUMENT(handle);
   return handle->primitive;
 }
+
+//===----------------------------------------------------------------------===//
+// Memory-mapped file handles
+//===----------------------------------------------------------------------===//
+
+// Mapping state owned by the release callback of a mapped file handle.
+typedef struct iree_io_file_mapping_t {
+  iree_allocator_t host_allocator;
+  // Mapped contents of the entire file; empty if the file is empty.
+  iree_byte_span_t contents;
+#if defined(IREE_PLATFORM_WINDOWS)
+  // File mapping object retaining the file.
+  HANDLE mapping;
+#endif  // IREE_PLATFORM_WINDOWS
+} iree_io_file_mapping_t;
+
+static iree_status_t iree_io_file_mapping_open_platform(
+    const char* path, iree_io_file_access_t access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_mapping_t* mapping);
+static void iree_io_file_mapping_close_platform(
+    iree_io_file_mapping_t* mapping);
+static iree_status_t iree_io_file_mapping_advise_platform(
+    iree_io_file_mapping_t* mapping, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice);
+
+static void iree_io_file_mapping_release(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_io_file_mapping_t* mapping = (iree_io_file_mapping_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_io_file_mapping_close_platform(mapping);
+  iree_allocator_free(mapping->host_allocator, mapping);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open_mapped(
+    iree_string_view_t path, iree_io_file_access_t allowed_access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_advice_t advice,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  IREE_ASSERT_ARGUMENT(out_handle);
+  *out_handle = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
+
+  // Platform APIs require a NUL-terminated path.
+  char* path_str = (char*)iree_alloca(path.size + 1);
+  memcpy(path_str, path.data, path.size);
+  path_str[path.size] = 0;
+
+  iree_io_file_mapping_t* mapping = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*mapping),
+                                (void**)&mapping));
+  mapping->host_allocator = host_allocator;
+
+  iree_status_t status = iree_io_file_mapping_open_platform(
+      path_str, allowed_access, flags, mapping);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, mapping);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  if (advice != IREE_IO_FILE_ADVICE_NORMAL) {
+    status = iree_io_file_mapping_advise_platform(
+        mapping, 0, mapping->contents.data_length, advice);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_io_file_handle_release_callback_t release_callback = {
+        .fn = iree_io_file_mapping_release,
+        .user_data = mapping,
+    };
+    status = iree_io_file_handle_wrap_host_allocation(
+        allowed_access, mapping->contents, release_callback, host_allocator,
+        out_handle);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_io_file_mapping_close_platform(mapping);
+    iree_allocator_free(host_allocator, mapping);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_advise(
+    iree_io_file_handle_t* handle, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice) {
+  IREE_ASSERT_ARGUMENT(handle);
+  // Only mapped handles are safe to advise: hints such as DONT_NEED would
+  // discard the contents of anonymous host allocations.
+  if (handle->release_callback.fn != iree_io_file_mapping_release) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "only memory-mapped file handles can be advised");
+  }
+  iree_io_file_mapping_t* mapping =
+      (iree_io_file_mapping_t*)handle->release_callback.user_data;
+  const iree_host_size_t file_length = mapping->contents.data_length;
+  if (offset > file_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "advice offset %" PRIhsz
+                            " out of range of file length %" PRIhsz,
+                            offset, file_length);
+  }
+  length = iree_min(length, file_length - offset);
+  if (length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  iree_status_t status =
+      iree_io_file_mapping_advise_platform(mapping, offset, length, advice);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_IOS) || \
+    defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static iree_status_t iree_io_file_mapping_open_platform(
+    const char* path, iree_io_file_access_t access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_mapping_t* mapping) {
+  const bool writable = iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE);
+  int fd = open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+  if (fd < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path);
+  }
+
+  // Query the file size and ensure the file will fit in the address space.
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    int error = errno;
+    close(fd);
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "failed to query file '%s' size", path);
+  }
+  if ((uint64_t)file_stat.st_size > (uint64_t)IREE_HOST_SIZE_MAX) {
+    close(fd);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "file size exceeds host pointer size capacity "
+                            "(64-bit file loaded into a 32-bit program)");
+  }
+  const size_t length = (size_t)file_stat.st_size;
+
+  // Empty files can't be mapped but are still valid (empty) handles.
+  void* ptr = NULL;
+  if (length > 0) {
+    int map_flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PREFAULT)) {
+      map_flags |= MAP_POPULATE;
+    }
+#endif  // MAP_POPULATE
+    ptr = mmap(NULL, length, PROT_READ | (writable ? PROT_WRITE : 0),
+               map_flags, fd, 0);
+  }
+  int error = errno;
+
+  // The mapping retains the file so we can close our descriptor.
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "failed to map file '%s'", path);
+  }
+  mapping->contents = iree_make_byte_span(ptr, length);
+
+#if !defined(MAP_POPULATE)
+  if (length > 0 &&
+      iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PREFAULT)) {
+    madvise(ptr, length, MADV_WILLNEED);
+  }
+#endif  // !MAP_POPULATE
+
+  return iree_ok_status();
+}
+
+static void iree_io_file_mapping_close_platform(
+    iree_io_file_mapping_t* mapping) {
+  if (mapping->contents.data) {
+    munmap(mapping->contents.data, mapping->contents.data_length);
+    mapping->contents = iree_make_byte_span(NULL, 0);
+  }
+}
+
+static iree_status_t iree_io_file_mapping_advise_platform(
+    iree_io_file_mapping_t* mapping, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice) {
+  if (!mapping->contents.data || length == 0) return iree_ok_status();
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    default:
+    case IREE_IO_FILE_ADVICE_NORMAL:
+      posix_advice = MADV_NORMAL;
+      break;
+    case IREE_IO_FILE_ADVICE_SEQUENTIAL:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case IREE_IO_FILE_ADVICE_RANDOM:
+      posix_advice = MADV_RANDOM;
+      break;
+    case IREE_IO_FILE_ADVICE_WILL_NEED:
+      posix_advice = MADV_WILLNEED;
+      break;
+    case IREE_IO_FILE_ADVICE_DONT_NEED:
+      posix_advice = MADV_DONTNEED;
+      break;
+  }
+
+  // madvise requires page-aligned addresses so expand the range to cover all
+  // pages it touches. The mapping itself is page-aligned.
+  const iree_host_size_t page_size = (iree_host_size_t)sysconf(_SC_PAGESIZE);
+  const iree_host_size_t aligned_offset = offset & ~(page_size - 1);
+  const iree_host_size_t aligned_length = length + (offset - aligned_offset);
+  if (madvise(mapping->contents.data + aligned_offset, aligned_length,
+              posix_advice) != 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "madvise failed");
+  }
+  return iree_ok_status();
+}
+
+#elif defined(IREE_PLATFORM_WINDOWS)
+
+static iree_status_t iree_io_file_mapping_open_platform(
+    const char* path, iree_io_file_access_t access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_mapping_t* mapping) {
+  const bool writable = iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE);
+  HANDLE file = CreateFileA(
+      path, GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ,
+      NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                            "failed to open file '%s'", path);
+  }
+
+  // Query file size and ensure it will fit in the host address space.
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) ||
+      (ULONGLONG)file_size.QuadPart > (ULONGLONG)IREE_HOST_SIZE_MAX) {
+    CloseHandle(file);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "file size exceeds host pointer size capacity "
+                            "(64-bit file loaded into a 32-bit program)");
+  }
+  if (file_size.QuadPart == 0) {
+    // Empty files can't be mapped but are still valid (empty) handles.
+    CloseHandle(file);
+    return iree_ok_status();
+  }
+
+  // Create a mapping object associated with the file. It retains the file so
+  // we can close our handle.
+  HANDLE file_mapping = CreateFileMappingA(
+      file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+      /*dwMaximumSizeHigh=*/0, /*dwMaximumSizeLow=*/0, /*lpName=*/NULL);
+  CloseHandle(file);
+  if (!file_mapping) {
+    return iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                            "failed to create file mapping for '%s'", path);
+  }
+
+  void* ptr = MapViewOfFileEx(
+      file_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ,
+      /*dwFileOffsetHigh=*/0, /*dwFileOffsetLow=*/0,
+      /*dwNumberOfBytesToMap=*/0, /*lpBaseAddress=*/NULL);
+  if (!ptr) {
+    iree_status_t status =
+        iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                         "failed to map file '%s' into host memory", path);
+    CloseHandle(file_mapping);
+    return status;
+  }
+  mapping->mapping = file_mapping;
+  mapping->contents =
+      iree_make_byte_span(ptr, (iree_host_size_t)file_size.QuadPart);
+
+  // There's no populate flag for views so touch each page to fault it in.
+  if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PREFAULT)) {
+    volatile uint8_t* bytes = (volatile uint8_t*)ptr;
+    for (iree_host_size_t i = 0; i < mapping->contents.data_length;
+         i += 4096) {
+      (void)bytes[i];
+    }
+  }
+
+  return iree_ok_status();
+}
+
+static void iree_io_file_mapping_close_platform(
+    iree_io_file_mapping_t* mapping) {
+  if (mapping->contents.data) {
+    UnmapViewOfFile(mapping->contents.data);
+    mapping->contents = iree_make_byte_span(NULL, 0);
+  }
+  if (mapping->mapping) {
+    CloseHandle(mapping->mapping);
+    mapping->mapping = NULL;
+  }
+}
+
+static iree_status_t iree_io_file_mapping_advise_platform(
+    iree_io_file_mapping_t* mapping, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice) {
+  // TODO(benvanik): use PrefetchVirtualMemory for WILL_NEED and
+  // OfferVirtualMemory for DONT_NEED when available (Windows 8+).
+  return iree_ok_status();
+}
+
+#else
+
+static iree_status_t iree_io_file_mapping_open_platform(
+    const char* path, iree_io_file_access_t access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_mapping_t* mapping) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file mapping not supported on this platform");
+}
+
+static void iree_io_file_mapping_close_platform(
+    iree_io_file_mapping_t* mapping) {}
+
+static iree_status_t iree_io_file_mapping_advise_platform(
+    iree_io_file_mapping_t* mapping, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice) {
+  return iree_ok_status();
+}
+
+#endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// File descriptor handles
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_IOS) || \
+    defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+
+static void iree_io_file_handle_close_fd(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open(
+    iree_string_view_t path, iree_io_file_access_t allowed_access,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  IREE_ASSERT_ARGUMENT(out_handle);
+  *out_handle = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
+
+  // Platform APIs require a NUL-terminated path.
+  char* path_str = (char*)iree_alloca(path.size + 1);
+  memcpy(path_str, path.data, path.size);
+  path_str[path.size] = 0;
+
+  const bool writable =
+      iree_all_bits_set(allowed_access, IREE_IO_FILE_ACCESS_WRITE);
+  int fd = open(path_str, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+  if (fd < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path_str);
+  }
+
+  iree_io_file_handle_primitive_t handle_primitive = {
+      .type = IREE_IO_FILE_HANDLE_TYPE_FD,
+      .value =
+          {
+              .fd = fd,
+          },
+  };
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_file_handle_close_fd,
+      .user_data = NULL,
+  };
+  iree_status_t status =
+      iree_io_file_handle_wrap(allowed_access, handle_primitive,
+                               release_callback, host_allocator, out_handle);
+  if (!iree_status_is_ok(status)) close(fd);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open(
+    iree_string_view_t path, iree_io_file_access_t allowed_access,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  IREE_ASSERT_ARGUMENT(out_handle);
+  *out_handle = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptor handles not available on this "
+                          "platform");
+}
+
+#endif  // IREE_PLATFORM_*
@@ -44,8 +44,12 @@ typedef enum iree_io_file_handle_type_e {
   // The handle creator is responsible for ensuring the memory remains live for
   // as long as the file handle referencing it.
   IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION = 0u,
+  // A POSIX file descriptor supporting positional reads and writes
+  // (pread/pwrite). Implementations may use the descriptor for asynchronous IO
+  // and must not change the file position.
+  IREE_IO_FILE_HANDLE_TYPE_FD = 1u,
 
-  // TODO(benvanik): file descriptor, FILE*, HANDLE, etc.
+  // TODO(benvanik): FILE*, HANDLE, etc.
 } iree_io_file_handle_type_t;
 
 // A platform handle to a file primitive.
@@ -54,6 +58,8 @@ typedef enum iree_io_file_handle_type_e {
 typedef union iree_io_file_handle_primitive_value_t {
   // IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION
   iree_byte_span_t host_allocation;
+  // IREE_IO_FILE_HANDLE_TYPE_FD
+  int fd;
 } iree_io_file_handle_primitive_value_t;
 
 // A (type, value) pair describing a system file primitive handle.
@@ -146,6 +152,84 @@ static inline iree_io_file_handle_primitive_value_t iree_io_file_handle_value(
   return iree_io_file_handle_primitive(handle).value;
 }
 
+//===----------------------------------------------------------------------===//
+// File descriptor handles
+//===----------------------------------------------------------------------===//
+
+// Opens the file at |path| and returns a handle of type
+// IREE_IO_FILE_HANDLE_TYPE_FD referencing it. The file is opened read-only
+// unless |allowed_access| includes IREE_IO_FILE_ACCESS_WRITE and the
+// descriptor is closed when the last reference to the handle is released.
+//
+// Unlike iree_io_file_handle_open_mapped no file contents are read until
+// requested and users can issue reads directly into their own buffers.
+// Returns IREE_STATUS_UNAVAILABLE on platforms without file descriptors.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open(
+    iree_string_view_t path, iree_io_file_access_t allowed_access,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
+
+//===----------------------------------------------------------------------===//
+// Memory-mapped file handles
+//===----------------------------------------------------------------------===//
+
+// Bits controlling how files are mapped into host memory.
+enum iree_io_file_mapping_flag_bits_t {
+  IREE_IO_FILE_MAPPING_FLAG_NONE = 0u,
+  // Populates all pages of the mapping before returning instead of faulting
+  // them in lazily on first access. Trades startup latency for predictable
+  // access latency.
+  IREE_IO_FILE_MAPPING_FLAG_PREFAULT = 1u << 0,
+};
+typedef uint32_t iree_io_file_mapping_flags_t;
+
+// Hints describing how ranges of a mapped file will be accessed.
+// Hints are advisory and may be ignored by the platform.
+typedef enum iree_io_file_advice_e {
+  // No particular access pattern; the platform default.
+  IREE_IO_FILE_ADVICE_NORMAL = 0u,
+  // Pages will be accessed in order and can be read ahead aggressively and
+  // discarded soon after being accessed.
+  IREE_IO_FILE_ADVICE_SEQUENTIAL,
+  // Pages will be accessed in random order and read-ahead should be avoided.
+  IREE_IO_FILE_ADVICE_RANDOM,
+  // Pages will be accessed soon and should be read in asynchronously.
+  IREE_IO_FILE_ADVICE_WILL_NEED,
+  // Pages will not be accessed again soon and can be discarded. Read-only
+  // mappings will fault the pages back in from the file if accessed again.
+  IREE_IO_FILE_ADVICE_DONT_NEED,
+} iree_io_file_advice_t;
+
+// Opens the file at |path| and maps its entire contents into host memory.
+// The returned handle is of type IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION
+// referencing the mapped pages and can be used anywhere a host allocation can,
+// such as being imported as a HAL buffer without copying; pages are only read
+// from the file when first accessed unless IREE_IO_FILE_MAPPING_FLAG_PREFAULT
+// is specified. The file is unmapped when the last reference to the handle is
+// released.
+//
+// |allowed_access| selects whether the mapping is read-only or read-write;
+// writes to read-write mappings are written back to the file. |advice| is
+// applied to the entire mapping and can be refined per-range with
+// iree_io_file_handle_advise.
+//
+// The file must not be truncated while mapped. Returns
+// IREE_STATUS_UNAVAILABLE on platforms that do not support file mapping.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open_mapped(
+    iree_string_view_t path, iree_io_file_access_t allowed_access,
+    iree_io_file_mapping_flags_t flags, iree_io_file_advice_t advice,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
+
+// Provides an access pattern |advice| hint for the byte range
+// [|offset|, |offset| + |length|) of a memory-mapped file |handle|.
+// The range is expanded to include all pages it touches and |length| may be
+// IREE_HOST_SIZE_MAX to indicate the remainder of the file.
+// Fails with IREE_STATUS_INVALID_ARGUMENT if the handle was not created with
+// iree_io_file_handle_open_mapped and is a no-op on platforms that do not
+// support hints.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_advise(
+    iree_io_file_handle_t* handle, iree_host_size_t offset,
+    iree_host_size_t length, iree_io_file_advice_t advice);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
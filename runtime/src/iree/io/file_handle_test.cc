@@ -0,0 +1,177 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/file_handle.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+std::string GetUniquePath(const char* unique_name) {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TEMP");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  std::random_device d;
+  uint64_t random = (static_cast<uint64_t>(d()) << 32) | d();
+  char unique_path[256];
+  snprintf(unique_path, sizeof unique_path, "%s/iree_test_%" PRIx64 "_%s",
+           test_tmpdir, random, unique_name);
+  return unique_path;
+}
+
+class OnDiskFileHandleTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = GetUniquePath("OnDiskFileHandleTest");
+    contents_.resize(3 * 4096 + 123);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<uint8_t>(i * 31);
+    }
+    IREE_ASSERT_OK(iree_file_write_contents(
+        path_.c_str(),
+        iree_make_const_byte_span(contents_.data(), contents_.size())));
+  }
+
+  void TearDown() override { remove(path_.c_str()); }
+
+  std::string path_;
+  std::vector<uint8_t> contents_;
+};
+
+TEST_F(OnDiskFileHandleTest, MapReadOnly) {
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_open_mapped(
+      iree_make_string_view(path_.data(), path_.size()),
+      IREE_IO_FILE_ACCESS_READ, IREE_IO_FILE_MAPPING_FLAG_NONE,
+      IREE_IO_FILE_ADVICE_SEQUENTIAL, iree_allocator_system(), &handle));
+  EXPECT_EQ(iree_io_file_handle_type(handle),
+            IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION);
+  EXPECT_EQ(iree_io_file_handle_access(handle), IREE_IO_FILE_ACCESS_READ);
+  iree_byte_span_t mapped = iree_io_file_handle_value(handle).host_allocation;
+  ASSERT_EQ(mapped.data_length, contents_.size());
+  EXPECT_EQ(0, memcmp(mapped.data, contents_.data(), contents_.size()));
+  iree_io_file_handle_release(handle);
+}
+
+TEST_F(OnDiskFileHandleTest, Prefault) {
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_open_mapped(
+      iree_make_string_view(path_.data(), path_.size()),
+      IREE_IO_FILE_ACCESS_READ, IREE_IO_FILE_MAPPING_FLAG_PREFAULT,
+      IREE_IO_FILE_ADVICE_NORMAL, iree_allocator_system(), &handle));
+  iree_byte_span_t mapped = iree_io_file_handle_value(handle).host_allocation;
+  ASSERT_EQ(mapped.data_length, contents_.size());
+  EXPECT_EQ(mapped.data[contents_.size() - 1], contents_.back());
+  iree_io_file_handle_release(handle);
+}
+
+TEST_F(OnDiskFileHandleTest, AdviseRanges) {
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_open_mapped(
+      iree_make_string_view(path_.data(), path_.size()),
+      IREE_IO_FILE_ACCESS_READ, IREE_IO_FILE_MAPPING_FLAG_NONE,
+      IREE_IO_FILE_ADVICE_NORMAL, iree_allocator_system(), &handle));
+
+  // Unaligned ranges are expanded to cover their pages.
+  IREE_EXPECT_OK(iree_io_file_handle_advise(handle, 4097, 100,
+                                            IREE_IO_FILE_ADVICE_WILL_NEED));
+  IREE_EXPECT_OK(iree_io_file_handle_advise(handle, 0, IREE_HOST_SIZE_MAX,
+                                            IREE_IO_FILE_ADVICE_RANDOM));
+  EXPECT_THAT(Status(iree_io_file_handle_advise(handle, contents_.size() + 1, 1,
+                                                IREE_IO_FILE_ADVICE_NORMAL)),
+              StatusIs(StatusCode::kOutOfRange));
+
+  // Discarded read-only pages are reloaded from the file.
+  IREE_EXPECT_OK(iree_io_file_handle_advise(handle, 0, IREE_HOST_SIZE_MAX,
+                                            IREE_IO_FILE_ADVICE_DONT_NEED));
+  iree_byte_span_t mapped = iree_io_file_handle_value(handle).host_allocation;
+  EXPECT_EQ(0, memcmp(mapped.data, contents_.data(), contents_.size()));
+
+  iree_io_file_handle_release(handle);
+}
+
+TEST_F(OnDiskFileHandleTest, MapReadWrite) {
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_open_mapped(
+      iree_make_string_view(path_.data(), path_.size()),
+      IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+      IREE_IO_FILE_MAPPING_FLAG_NONE, IREE_IO_FILE_ADVICE_NORMAL,
+      iree_allocator_system(), &handle));
+  iree_byte_span_t mapped = iree_io_file_handle_value(handle).host_allocation;
+  mapped.data[0] = 0xAB;
+  iree_io_file_handle_release(handle);
+
+  iree_file_contents_t* file_contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(path_.c_str(),
+                                         IREE_FILE_READ_FLAG_DEFAULT,
+                                         iree_allocator_system(),
+                                         &file_contents));
+  EXPECT_EQ(file_contents->const_buffer.data[0], 0xAB);
+  iree_file_contents_free(file_contents);
+}
+
+TEST_F(OnDiskFileHandleTest, OpenDescriptor) {
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_open(
+      iree_make_string_view(path_.data(), path_.size()),
+      IREE_IO_FILE_ACCESS_READ, iree_allocator_system(), &handle));
+  EXPECT_EQ(iree_io_file_handle_type(handle), IREE_IO_FILE_HANDLE_TYPE_FD);
+  EXPECT_EQ(iree_io_file_handle_access(handle), IREE_IO_FILE_ACCESS_READ);
+  EXPECT_GE(iree_io_file_handle_value(handle).fd, 0);
+  iree_io_file_handle_release(handle);
+}
+
+TEST(FileHandleTest, OpenMissingFile) {
+  iree_io_file_handle_t* handle = NULL;
+  EXPECT_THAT(Status(iree_io_file_handle_open(
+                  IREE_SV("/this/file/does/not/exist"),
+                  IREE_IO_FILE_ACCESS_READ, iree_allocator_system(), &handle)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(handle, nullptr);
+}
+
+TEST(FileHandleTest, MapMissingFile) {
+  iree_io_file_handle_t* handle = NULL;
+  EXPECT_THAT(Status(iree_io_file_handle_open_mapped(
+                  IREE_SV("/this/file/does/not/exist"),
+                  IREE_IO_FILE_ACCESS_READ, IREE_IO_FILE_MAPPING_FLAG_NONE,
+                  IREE_IO_FILE_ADVICE_NORMAL, iree_allocator_system(),
+                  &handle)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(handle, nullptr);
+}
+
+TEST(FileHandleTest, AdviseHostAllocationFails) {
+  uint8_t storage[16] = {0};
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ, iree_make_byte_span(storage, sizeof(storage)),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &handle));
+  EXPECT_THAT(Status(iree_io_file_handle_advise(handle, 0, sizeof(storage),
+                                                IREE_IO_FILE_ADVICE_NORMAL)),
+              StatusIs(StatusCode::kInvalidArgument));
+  iree_io_file_handle_release(handle);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
@@ -0,0 +1,620 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_archive.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+
+#if !defined(IREE_ENDIANNESS_LITTLE) || !IREE_ENDIANNESS_LITTLE
+#error "parameter archives are only supported on little-endian hosts"
+#endif  // IREE_ENDIANNESS_LITTLE
+
+IREE_API_EXPORT uint64_t
+iree_io_parameter_archive_hash_name(iree_string_view_t name) {
+  // 64-bit FNV-1a.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < name.size; ++i) {
+    hash ^= (uint8_t)name.data[i];
+    hash *= 0x00000100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns true if [offset, offset + length) is within [0, limit).
+static bool iree_io_parameter_archive_range_is_valid(uint64_t offset,
+                                                     uint64_t length,
+                                                     uint64_t limit) {
+  return offset <= limit && length <= limit - offset;
+}
+
+static bool iree_io_parameter_archive_is_power_of_two(uint64_t value) {
+  return value != 0 && (value & (value - 1)) == 0;
+}
+
+static uint64_t iree_io_parameter_archive_align(uint64_t value,
+                                                uint64_t alignment) {
+  return (value + (alignment - 1)) & ~(alignment - 1);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_t
+//===----------------------------------------------------------------------===//
+
+struct iree_io_parameter_archive_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_io_file_handle_t* file_handle;
+  const iree_io_parameter_archive_header_t* header;
+  const iree_io_parameter_archive_entry_t* entries;
+  const uint32_t* slots;
+  const char* names;
+  const uint8_t* data;
+};
+
+static iree_status_t iree_io_parameter_archive_verify_entry(
+    const iree_io_parameter_archive_t* archive, iree_host_size_t i) {
+  const iree_io_parameter_archive_header_t* header = archive->header;
+  const iree_io_parameter_archive_entry_t* entry = &archive->entries[i];
+  if (!iree_io_parameter_archive_range_is_valid(
+          entry->name_offset, entry->name_length, header->name_table_length)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "entry %" PRIhsz " name out of bounds", i);
+  }
+  iree_string_view_t name = iree_make_string_view(
+      archive->names + entry->name_offset, entry->name_length);
+  if (entry->name_hash != iree_io_parameter_archive_hash_name(name)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "entry %" PRIhsz " name hash mismatch", i);
+  }
+  if (!iree_io_parameter_archive_is_power_of_two(entry->data_alignment)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "entry %" PRIhsz " alignment %" PRIu64
+                            " is not a power of two",
+                            i, entry->data_alignment);
+  }
+  switch (entry->encoding) {
+    case IREE_IO_PARAMETER_ENCODING_RAW: {
+      if (!iree_io_parameter_archive_range_is_valid(entry->data_offset,
+                                                    entry->data_length,
+                                                    header->data_length)) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "entry %" PRIhsz " data out of bounds", i);
+      }
+      uint64_t file_offset = header->data_offset + entry->data_offset;
+      if ((file_offset & (entry->data_alignment - 1)) != 0) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "entry %" PRIhsz " data offset %" PRIu64
+                                " is not aligned to %" PRIu64,
+                                i, file_offset, entry->data_alignment);
+      }
+      return iree_ok_status();
+    }
+    case IREE_IO_PARAMETER_ENCODING_SPLAT: {
+      if (entry->splat_pattern_length == 0 ||
+          entry->splat_pattern_length >
+              IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH ||
+          (entry->data_length % entry->splat_pattern_length) != 0) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "entry %" PRIhsz " has invalid splat pattern",
+                                i);
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "entry %" PRIhsz " has unknown encoding %u", i,
+                              (uint32_t)entry->encoding);
+  }
+}
+
+// Verifies the archive index in |archive| against the |file_length| of the
+// backing storage. After this succeeds all entries and hash table slots are
+// known to be in bounds.
+static iree_status_t iree_io_parameter_archive_verify(
+    iree_io_parameter_archive_t* archive, iree_host_size_t file_length) {
+  const iree_io_parameter_archive_header_t* header = archive->header;
+  if (header->magic != IREE_IO_PARAMETER_ARCHIVE_MAGIC) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file is not a parameter archive");
+  }
+  if (header->version_major != IREE_IO_PARAMETER_ARCHIVE_VERSION_MAJOR) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "parameter archive version %u.%u is not supported (expected %u.x)",
+        header->version_major, header->version_minor,
+        IREE_IO_PARAMETER_ARCHIVE_VERSION_MAJOR);
+  }
+  if (header->file_size > file_length) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "parameter archive truncated; header declares %" PRIu64
+        " bytes but only %" PRIhsz " are available",
+        header->file_size, file_length);
+  }
+  const uint64_t file_size = header->file_size;
+  if (header->header_size < sizeof(*header) ||
+      header->header_size > file_size) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid header size %" PRIu64,
+                            header->header_size);
+  }
+
+  // Tables are referenced in-place and must be naturally aligned.
+  if ((header->entry_table_offset % iree_alignof(uint64_t)) != 0 ||
+      (header->hash_table_offset % sizeof(uint32_t)) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter archive tables are misaligned");
+  }
+  if (header->entry_count > file_size / sizeof(*archive->entries) ||
+      !iree_io_parameter_archive_range_is_valid(
+          header->entry_table_offset,
+          header->entry_count * sizeof(*archive->entries), file_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "entry table out of bounds");
+  }
+  if (!iree_io_parameter_archive_is_power_of_two(
+          header->hash_table_capacity) ||
+      header->hash_table_capacity <= header->entry_count ||
+      header->hash_table_capacity > file_size / sizeof(uint32_t) ||
+      !iree_io_parameter_archive_range_is_valid(
+          header->hash_table_offset,
+          header->hash_table_capacity * sizeof(uint32_t), file_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "hash table invalid or out of bounds");
+  }
+  if (!iree_io_parameter_archive_range_is_valid(
+          header->name_table_offset, header->name_table_length, file_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "name table out of bounds");
+  }
+  if (!iree_io_parameter_archive_range_is_valid(
+          header->data_offset, header->data_length, file_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "data segment out of bounds");
+  }
+
+  const uint8_t* base = (const uint8_t*)archive->header;
+  archive->entries = (const iree_io_parameter_archive_entry_t*)(
+      base + header->entry_table_offset);
+  archive->slots = (const uint32_t*)(base + header->hash_table_offset);
+  archive->names = (const char*)(base + header->name_table_offset);
+  archive->data = base + header->data_offset;
+
+  for (iree_host_size_t i = 0; i < header->entry_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_io_parameter_archive_verify_entry(archive, i));
+  }
+  for (uint64_t i = 0; i < header->hash_table_capacity; ++i) {
+    if (archive->slots[i] > header->entry_count) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "hash table slot %" PRIu64 " out of bounds", i);
+    }
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_open(
+    iree_io_file_handle_t* file_handle, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_t** out_archive) {
+  IREE_ASSERT_ARGUMENT(file_handle);
+  IREE_ASSERT_ARGUMENT(out_archive);
+  *out_archive = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (iree_io_file_handle_type(file_handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "parameter archives require host allocation file "
+                            "handles");
+  }
+  if (!(iree_io_file_handle_access(file_handle) & IREE_IO_FILE_ACCESS_READ)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file handle does not allow reads");
+  }
+  iree_byte_span_t contents =
+      iree_io_file_handle_value(file_handle).host_allocation;
+  if (contents.data_length < sizeof(iree_io_parameter_archive_header_t)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file too small to be a parameter archive");
+  }
+  if (!iree_host_size_has_alignment((iree_host_size_t)contents.data,
+                                    iree_alignof(uint64_t))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter archive storage must be 8-byte aligned");
+  }
+
+  iree_io_parameter_archive_t* archive = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*archive),
+                                (void**)&archive));
+  iree_atomic_ref_count_init(&archive->ref_count);
+  archive->host_allocator = host_allocator;
+  archive->file_handle = file_handle;
+  iree_io_file_handle_retain(file_handle);
+  archive->header = (const iree_io_parameter_archive_header_t*)contents.data;
+
+  iree_status_t status =
+      iree_io_parameter_archive_verify(archive, contents.data_length);
+
+  if (iree_status_is_ok(status)) {
+    *out_archive = archive;
+  } else {
+    iree_io_parameter_archive_release(archive);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_io_parameter_archive_destroy(
+    iree_io_parameter_archive_t* archive) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = archive->host_allocator;
+  iree_io_file_handle_release(archive->file_handle);
+  iree_allocator_free(host_allocator, archive);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_retain(
+    iree_io_parameter_archive_t* archive) {
+  if (IREE_LIKELY(archive)) {
+    iree_atomic_ref_count_inc(&archive->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_release(
+    iree_io_parameter_archive_t* archive) {
+  if (IREE_LIKELY(archive) &&
+      iree_atomic_ref_count_dec(&archive->ref_count) == 1) {
+    iree_io_parameter_archive_destroy(archive);
+  }
+}
+
+IREE_API_EXPORT iree_io_file_handle_t* iree_io_parameter_archive_file_handle(
+    const iree_io_parameter_archive_t* archive) {
+  IREE_ASSERT_ARGUMENT(archive);
+  return archive->file_handle;
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_io_parameter_archive_count(const iree_io_parameter_archive_t* archive) {
+  IREE_ASSERT_ARGUMENT(archive);
+  return (iree_host_size_t)archive->header->entry_count;
+}
+
+static void iree_io_parameter_archive_make_info(
+    const iree_io_parameter_archive_t* archive,
+    const iree_io_parameter_archive_entry_t* entry,
+    iree_io_parameter_info_t* out_info) {
+  memset(out_info, 0, sizeof(*out_info));
+  out_info->name = iree_make_string_view(archive->names + entry->name_offset,
+                                         entry->name_length);
+  out_info->encoding = (iree_io_parameter_encoding_t)entry->encoding;
+  out_info->length = entry->data_length;
+  out_info->alignment = entry->data_alignment;
+  if (entry->encoding == IREE_IO_PARAMETER_ENCODING_RAW) {
+    out_info->file_offset = archive->header->data_offset + entry->data_offset;
+    out_info->contents = iree_make_const_byte_span(
+        archive->data + entry->data_offset, entry->data_length);
+  } else {
+    out_info->splat_pattern = iree_make_const_byte_span(
+        entry->splat_pattern, entry->splat_pattern_length);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_get(
+    const iree_io_parameter_archive_t* archive, iree_host_size_t i,
+    iree_io_parameter_info_t* out_info) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_ARGUMENT(out_info);
+  if (i >= archive->header->entry_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "entry %" PRIhsz " out of range (count=%" PRIu64
+                            ")",
+                            i, archive->header->entry_count);
+  }
+  iree_io_parameter_archive_make_info(archive, &archive->entries[i], out_info);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_lookup(
+    const iree_io_parameter_archive_t* archive, iree_string_view_t name,
+    iree_io_parameter_info_t* out_info) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_ARGUMENT(out_info);
+  const uint64_t hash = iree_io_parameter_archive_hash_name(name);
+  const uint64_t capacity = archive->header->hash_table_capacity;
+  const uint64_t mask = capacity - 1;
+  for (uint64_t probe = 0; probe < capacity; ++probe) {
+    const uint32_t slot = archive->slots[(hash + probe) & mask];
+    if (slot == 0) break;  // empty slot terminates the probe sequence
+    const iree_io_parameter_archive_entry_t* entry =
+        &archive->entries[slot - 1];
+    if (entry->name_hash == hash &&
+        iree_string_view_equal(
+            name, iree_make_string_view(archive->names + entry->name_offset,
+                                        entry->name_length))) {
+      iree_io_parameter_archive_make_info(archive, entry, out_info);
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "parameter '%.*s' not found in archive",
+                          (int)name.size, name.data);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_builder_t
+//===----------------------------------------------------------------------===//
+
+struct iree_io_parameter_archive_builder_entry_t {
+  // Owned copy of the entry name.
+  char* name;
+  iree_host_size_t name_length;
+  iree_io_parameter_encoding_t encoding;
+  uint64_t length;
+  uint64_t alignment;
+  // Offset of the data relative to the data segment for RAW entries.
+  uint64_t data_offset;
+  // Unowned contents for RAW entries.
+  iree_const_byte_span_t contents;
+  uint8_t splat_pattern[IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH];
+  iree_host_size_t splat_pattern_length;
+};
+
+// Computed offsets of the archive tables.
+typedef struct iree_io_parameter_archive_layout_t {
+  uint64_t entry_table_offset;
+  uint64_t hash_table_offset;
+  uint64_t hash_table_capacity;
+  uint64_t name_table_offset;
+  uint64_t data_offset;
+  uint64_t file_size;
+} iree_io_parameter_archive_layout_t;
+
+static iree_io_parameter_archive_layout_t
+iree_io_parameter_archive_calculate_layout(
+    const iree_io_parameter_archive_builder_t* builder) {
+  iree_io_parameter_archive_layout_t layout;
+  layout.entry_table_offset = iree_io_parameter_archive_align(
+      sizeof(iree_io_parameter_archive_header_t), iree_alignof(uint64_t));
+  layout.hash_table_offset =
+      layout.entry_table_offset +
+      builder->entry_count * sizeof(iree_io_parameter_archive_entry_t);
+  // Keep the load factor at or below 50% so probe sequences stay short.
+  layout.hash_table_capacity =
+      iree_math_round_up_to_pow2_u64((uint64_t)builder->entry_count * 2 + 1);
+  layout.name_table_offset =
+      layout.hash_table_offset + layout.hash_table_capacity * sizeof(uint32_t);
+  layout.data_offset = iree_io_parameter_archive_align(
+      layout.name_table_offset + builder->name_table_length,
+      builder->data_alignment);
+  layout.file_size = layout.data_offset + builder->data_length;
+  return layout;
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_builder_initialize(
+    iree_allocator_t host_allocator,
+    iree_io_parameter_archive_builder_t* out_builder) {
+  IREE_ASSERT_ARGUMENT(out_builder);
+  memset(out_builder, 0, sizeof(*out_builder));
+  out_builder->host_allocator = host_allocator;
+  out_builder->data_alignment =
+      IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT;
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_builder_deinitialize(
+    iree_io_parameter_archive_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(builder);
+  for (iree_host_size_t i = 0; i < builder->entry_count; ++i) {
+    iree_allocator_free(builder->host_allocator, builder->entries[i].name);
+  }
+  iree_allocator_free(builder->host_allocator, builder->entries);
+  memset(builder, 0, sizeof(*builder));
+}
+
+// Appends a new entry with a copy of |name| and returns it in |out_entry|.
+static iree_status_t iree_io_parameter_archive_builder_append(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_io_parameter_archive_builder_entry_t** out_entry) {
+  if (name.size > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter name too long");
+  }
+  if (builder->entry_count >= UINT32_MAX - 1) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many parameters in archive");
+  }
+  if (builder->entry_count == builder->entry_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, builder->entry_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        builder->host_allocator, new_capacity * sizeof(*builder->entries),
+        (void**)&builder->entries));
+    builder->entry_capacity = new_capacity;
+  }
+  iree_io_parameter_archive_builder_entry_t* entry =
+      &builder->entries[builder->entry_count];
+  memset(entry, 0, sizeof(*entry));
+  if (name.size > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_clone(
+        builder->host_allocator,
+        iree_make_const_byte_span(name.data, name.size),
+        (void**)&entry->name));
+  }
+  entry->name_length = name.size;
+  ++builder->entry_count;
+  builder->name_table_length += name.size;
+  *out_entry = entry;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_raw(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    uint64_t alignment, iree_const_byte_span_t contents) {
+  IREE_ASSERT_ARGUMENT(builder);
+  if (alignment == 0) {
+    alignment = IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT;
+  } else if (!iree_io_parameter_archive_is_power_of_two(alignment)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "alignment %" PRIu64 " is not a power of two",
+                            alignment);
+  }
+  iree_io_parameter_archive_builder_entry_t* entry = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_archive_builder_append(builder, name, &entry));
+  entry->encoding = IREE_IO_PARAMETER_ENCODING_RAW;
+  entry->length = contents.data_length;
+  entry->alignment = alignment;
+  entry->contents = contents;
+  entry->data_offset =
+      iree_io_parameter_archive_align(builder->data_length, alignment);
+  builder->data_length = entry->data_offset + contents.data_length;
+  builder->data_alignment = iree_max(builder->data_alignment, alignment);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_splat(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    uint64_t length, iree_const_byte_span_t pattern) {
+  IREE_ASSERT_ARGUMENT(builder);
+  if (pattern.data_length == 0 ||
+      pattern.data_length >
+          IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "splat pattern length %" PRIhsz
+                            " must be between 1 and %d bytes",
+                            pattern.data_length,
+                            IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH);
+  }
+  if ((length % pattern.data_length) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "splat length %" PRIu64
+                            " is not a multiple of the pattern length %" PRIhsz,
+                            length, pattern.data_length);
+  }
+  iree_io_parameter_archive_builder_entry_t* entry = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_archive_builder_append(builder, name, &entry));
+  entry->encoding = IREE_IO_PARAMETER_ENCODING_SPLAT;
+  entry->length = length;
+  entry->alignment = 1;
+  memcpy(entry->splat_pattern, pattern.data, pattern.data_length);
+  entry->splat_pattern_length = pattern.data_length;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT uint64_t iree_io_parameter_archive_builder_total_size(
+    const iree_io_parameter_archive_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(builder);
+  return iree_io_parameter_archive_calculate_layout(builder).file_size;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
+    const iree_io_parameter_archive_builder_t* builder,
+    iree_byte_span_t target) {
+  IREE_ASSERT_ARGUMENT(builder);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_io_parameter_archive_layout_t layout =
+      iree_io_parameter_archive_calculate_layout(builder);
+  if (target.data_length < layout.file_size) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "target size %" PRIhsz
+                            " is smaller than the archive size %" PRIu64,
+                            target.data_length, layout.file_size);
+  }
+  if (!iree_host_size_has_alignment((iree_host_size_t)target.data,
+                                    iree_alignof(uint64_t))) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "target must be 8-byte aligned");
+  }
+
+  uint8_t* base = target.data;
+  iree_io_parameter_archive_header_t* header =
+      (iree_io_parameter_archive_header_t*)base;
+  iree_io_parameter_archive_entry_t* entries =
+      (iree_io_parameter_archive_entry_t*)(base + layout.entry_table_offset);
+  uint32_t* slots = (uint32_t*)(base + layout.hash_table_offset);
+  char* names = (char*)(base + layout.name_table_offset);
+  uint8_t* data = base + layout.data_offset;
+
+  // Zero everything but the data segment which is fully written below
+  // (including padding between entries).
+  memset(base, 0, layout.data_offset);
+  header->magic = IREE_IO_PARAMETER_ARCHIVE_MAGIC;
+  header->version_major = IREE_IO_PARAMETER_ARCHIVE_VERSION_MAJOR;
+  header->version_minor = IREE_IO_PARAMETER_ARCHIVE_VERSION_MINOR;
+  header->header_size = sizeof(*header);
+  header->file_size = layout.file_size;
+  header->entry_count = builder->entry_count;
+  header->entry_table_offset = layout.entry_table_offset;
+  header->hash_table_offset = layout.hash_table_offset;
+  header->hash_table_capacity = layout.hash_table_capacity;
+  header->name_table_offset = layout.name_table_offset;
+  header->name_table_length = builder->name_table_length;
+  header->data_offset = layout.data_offset;
+  header->data_length = builder->data_length;
+
+  const uint64_t mask = layout.hash_table_capacity - 1;
+  uint64_t name_offset = 0;
+  uint64_t data_end = 0;
+  for (iree_host_size_t i = 0; i < builder->entry_count; ++i) {
+    const iree_io_parameter_archive_builder_entry_t* source =
+        &builder->entries[i];
+    iree_string_view_t name =
+        iree_make_string_view(source->name, source->name_length);
+    iree_io_parameter_archive_entry_t* entry = &entries[i];
+    entry->name_hash = iree_io_parameter_archive_hash_name(name);
+    entry->name_offset = name_offset;
+    entry->name_length = (uint32_t)name.size;
+    entry->encoding = (uint16_t)source->encoding;
+    entry->data_length = source->length;
+    entry->data_alignment = source->alignment;
+    if (name.size > 0) memcpy(names + name_offset, name.data, name.size);
+    name_offset += name.size;
+
+    if (source->encoding == IREE_IO_PARAMETER_ENCODING_RAW) {
+      entry->data_offset = source->data_offset;
+      memset(data + data_end, 0, source->data_offset - data_end);
+      if (source->length > 0) {
+        memcpy(data + source->data_offset, source->contents.data,
+               source->length);
+      }
+      data_end = source->data_offset + source->length;
+    } else {
+      entry->splat_pattern_length = (uint16_t)source->splat_pattern_length;
+      memcpy(entry->splat_pattern, source->splat_pattern,
+             source->splat_pattern_length);
+    }
+
+    // Insert into the hash table; the load factor guarantees an empty slot.
+    uint64_t slot_index = entry->name_hash & mask;
+    while (slots[slot_index] != 0) {
+      const iree_io_parameter_archive_entry_t* existing =
+          &entries[slots[slot_index] - 1];
+      if (existing->name_hash == entry->name_hash &&
+          iree_string_view_equal(
+              name, iree_make_string_view(names + existing->name_offset,
+                                          existing->name_length))) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_ALREADY_EXISTS,
+                                "duplicate parameter name '%.*s'",
+                                (int)name.size, name.data);
+      }
+      slot_index = (slot_index + 1) & mask;
+    }
+    slots[slot_index] = (uint32_t)(i + 1);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
@@ -0,0 +1,264 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_ARCHIVE_H_
+#define IREE_IO_PARAMETER_ARCHIVE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// On-disk format
+//===----------------------------------------------------------------------===//
+//
+// A parameter archive stores named parameters (usually tensor constants) that
+// programs reference by name instead of embedding them. One archive can back
+// any number of compiled program variants and parameters can be updated
+// without recompiling as long as their names and sizes are unchanged.
+//
+// Layout (all fields little-endian, all offsets in bytes):
+//   +---------------------------+ 0
+//   | header                    |
+//   +---------------------------+ header.entry_table_offset
+//   | entry[entry_count]        |
+//   +---------------------------+ header.hash_table_offset
+//   | uint32_t slots[capacity]  |
+//   +---------------------------+ header.name_table_offset
+//   | packed entry names        |
+//   +---------------------------+ header.data_offset
+//   | aligned parameter data    |
+//   +---------------------------+ header.file_size
+//
+// The hash table is an open-addressed (linear probing) table keyed by the
+// 64-bit FNV-1a hash of the entry name. Each slot holds the entry index plus
+// one with 0 indicating an empty slot. Lookups touch only the header, the slots
+// probed, and the matching entry so the index can be used directly from a
+// memory-mapped file without parsing.
+
+// 'IRPA' as a little-endian uint32_t.
+#define IREE_IO_PARAMETER_ARCHIVE_MAGIC 0x41505249u
+
+// Major version of the format; readers reject archives with a different major
+// version.
+#define IREE_IO_PARAMETER_ARCHIVE_VERSION_MAJOR 0
+// Minor version of the format; new minor versions may only append fields.
+#define IREE_IO_PARAMETER_ARCHIVE_VERSION_MINOR 0
+
+// Alignment of the data segment in archives written by the builder. Entries
+// requesting more alignment raise the data segment alignment to match.
+#define IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT 64
+
+// Maximum length of a splat pattern in bytes.
+#define IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH 16
+
+// Defines how parameter data is stored in the archive.
+typedef enum iree_io_parameter_encoding_e {
+  // Parameter data is stored verbatim in the data segment.
+  IREE_IO_PARAMETER_ENCODING_RAW = 0u,
+  // Parameter data is a repeating pattern stored in the entry itself and
+  // occupies no space in the data segment.
+  IREE_IO_PARAMETER_ENCODING_SPLAT = 1u,
+} iree_io_parameter_encoding_t;
+
+typedef struct iree_io_parameter_archive_header_t {
+  // IREE_IO_PARAMETER_ARCHIVE_MAGIC.
+  uint32_t magic;
+  // IREE_IO_PARAMETER_ARCHIVE_VERSION_MAJOR.
+  uint16_t version_major;
+  // IREE_IO_PARAMETER_ARCHIVE_VERSION_MINOR.
+  uint16_t version_minor;
+  // Size of the header in bytes; may be larger than this struct in newer minor
+  // versions.
+  uint64_t header_size;
+  // Total size of the archive file in bytes.
+  uint64_t file_size;
+  // Number of entries in the entry table.
+  uint64_t entry_count;
+  // Offset of the iree_io_parameter_archive_entry_t table from the file start.
+  uint64_t entry_table_offset;
+  // Offset of the uint32_t hash table slots from the file start.
+  uint64_t hash_table_offset;
+  // Number of hash table slots; a power of two larger than entry_count.
+  uint64_t hash_table_capacity;
+  // Offset and length of the packed name table from the file start.
+  uint64_t name_table_offset;
+  uint64_t name_table_length;
+  // Offset and length of the data segment from the file start.
+  uint64_t data_offset;
+  uint64_t data_length;
+} iree_io_parameter_archive_header_t;
+static_assert(sizeof(iree_io_parameter_archive_header_t) == 88,
+              "header is part of the file format");
+
+typedef struct iree_io_parameter_archive_entry_t {
+  // FNV-1a hash of the entry name.
+  uint64_t name_hash;
+  // Offset of the name within the name table; names are not NUL-terminated.
+  uint64_t name_offset;
+  uint32_t name_length;
+  // iree_io_parameter_encoding_t.
+  uint16_t encoding;
+  // Length of the splat_pattern in bytes for IREE_IO_PARAMETER_ENCODING_SPLAT.
+  uint16_t splat_pattern_length;
+  // Offset of the entry data relative to the data segment.
+  uint64_t data_offset;
+  // Logical length of the parameter in bytes.
+  uint64_t data_length;
+  // Required alignment of the data in the file; a power of two.
+  uint64_t data_alignment;
+  // Repeating pattern for IREE_IO_PARAMETER_ENCODING_SPLAT.
+  uint8_t splat_pattern[IREE_IO_PARAMETER_ARCHIVE_MAX_SPLAT_PATTERN_LENGTH];
+} iree_io_parameter_archive_entry_t;
+static_assert(sizeof(iree_io_parameter_archive_entry_t) == 64,
+              "entry is part of the file format");
+
+// Returns the hash of |name| as stored in archive entries.
+IREE_API_EXPORT uint64_t
+iree_io_parameter_archive_hash_name(iree_string_view_t name);
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_t
+//===----------------------------------------------------------------------===//
+
+// Describes a parameter in an archive.
+typedef struct iree_io_parameter_info_t {
+  // Name of the parameter; references the archive storage.
+  iree_string_view_t name;
+  // Encoding of the parameter data.
+  iree_io_parameter_encoding_t encoding;
+  // Logical length of the parameter in bytes.
+  uint64_t length;
+  // Alignment of the parameter data within the file.
+  uint64_t alignment;
+  // Absolute offset of the parameter data within the file for
+  // IREE_IO_PARAMETER_ENCODING_RAW.
+  uint64_t file_offset;
+  // Parameter data for IREE_IO_PARAMETER_ENCODING_RAW; references the archive
+  // storage and is only valid while the archive is retained.
+  iree_const_byte_span_t contents;
+  // Repeating pattern for IREE_IO_PARAMETER_ENCODING_SPLAT; references the
+  // archive storage.
+  iree_const_byte_span_t splat_pattern;
+} iree_io_parameter_info_t;
+
+// A read-only parameter archive backed by a file handle.
+// Parameter contents are referenced in-place and never copied; when the file
+// handle is memory-mapped pages are loaded on first access.
+//
+// Thread-safe; archives are immutable once opened.
+typedef struct iree_io_parameter_archive_t iree_io_parameter_archive_t;
+
+// Opens a parameter archive stored in |file_handle| and retains the handle.
+// The archive index is validated up-front so that lookups are bounds-safe.
+// Only IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION handles are supported, such as
+// those returned by iree_io_file_handle_open_mapped.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_open(
+    iree_io_file_handle_t* file_handle, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_t** out_archive);
+
+// Retains the given |archive| for the caller.
+IREE_API_EXPORT void iree_io_parameter_archive_retain(
+    iree_io_parameter_archive_t* archive);
+
+// Releases the given |archive| from the caller.
+IREE_API_EXPORT void iree_io_parameter_archive_release(
+    iree_io_parameter_archive_t* archive);
+
+// Returns the file handle backing the |archive|.
+IREE_API_EXPORT iree_io_file_handle_t* iree_io_parameter_archive_file_handle(
+    const iree_io_parameter_archive_t* archive);
+
+// Returns the total number of parameters in the |archive|.
+IREE_API_EXPORT iree_host_size_t
+iree_io_parameter_archive_count(const iree_io_parameter_archive_t* archive);
+
+// Returns information about the parameter at |i| in the |archive|.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_get(
+    const iree_io_parameter_archive_t* archive, iree_host_size_t i,
+    iree_io_parameter_info_t* out_info);
+
+// Looks up the parameter with the given |name| in O(1) expected time.
+// Returns IREE_STATUS_NOT_FOUND if no parameter with the name exists.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_lookup(
+    const iree_io_parameter_archive_t* archive, iree_string_view_t name,
+    iree_io_parameter_info_t* out_info);
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_archive_builder_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_parameter_archive_builder_entry_t
+    iree_io_parameter_archive_builder_entry_t;
+
+// Builds parameter archives in memory.
+// Usage:
+//   iree_io_parameter_archive_builder_initialize(host_allocator, &builder);
+//   iree_io_parameter_archive_builder_add_raw(&builder, name, 64, contents);
+//   ...
+//   uint64_t size = iree_io_parameter_archive_builder_total_size(&builder);
+//   ... allocate or map |size| bytes ...
+//   iree_io_parameter_archive_builder_write(&builder, target);
+//   iree_io_parameter_archive_builder_deinitialize(&builder);
+//
+// Thread-compatible.
+typedef struct iree_io_parameter_archive_builder_t {
+  iree_allocator_t host_allocator;
+  iree_host_size_t entry_count;
+  iree_host_size_t entry_capacity;
+  iree_io_parameter_archive_builder_entry_t* entries;
+  // Total length of all entry names.
+  uint64_t name_table_length;
+  // Total length of the data segment including entry padding.
+  uint64_t data_length;
+  // Alignment of the data segment.
+  uint64_t data_alignment;
+} iree_io_parameter_archive_builder_t;
+
+// Initializes an empty archive |out_builder|.
+IREE_API_EXPORT void iree_io_parameter_archive_builder_initialize(
+    iree_allocator_t host_allocator,
+    iree_io_parameter_archive_builder_t* out_builder);
+
+// Deinitializes |builder| and releases all entries.
+IREE_API_EXPORT void iree_io_parameter_archive_builder_deinitialize(
+    iree_io_parameter_archive_builder_t* builder);
+
+// Adds a raw parameter with the given |name| and |contents| aligned to
+// |alignment| bytes (a power of two, or 0 for the default) in the file.
+// The name is copied while |contents| must remain valid until the archive is
+// written.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_raw(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    uint64_t alignment, iree_const_byte_span_t contents);
+
+// Adds a splat parameter with the given |name| of |length| bytes filled with
+// |pattern|. |length| must be a multiple of the pattern length.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_splat(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    uint64_t length, iree_const_byte_span_t pattern);
+
+// Returns the total size in bytes of the archive file that will be written.
+IREE_API_EXPORT uint64_t iree_io_parameter_archive_builder_total_size(
+    const iree_io_parameter_archive_builder_t* builder);
+
+// Writes the archive to |target| which must be at least
+// iree_io_parameter_archive_builder_total_size bytes.
+// Returns IREE_STATUS_ALREADY_EXISTS if two entries share a name.
+IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
+    const iree_io_parameter_archive_builder_t* builder,
+    iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_ARCHIVE_H_
@@ -0,0 +1,213 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_archive.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class ParameterArchiveTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_io_parameter_archive_builder_initialize(iree_allocator_system(),
+                                                 &builder_);
+  }
+
+  void TearDown() override {
+    iree_io_parameter_archive_release(archive_);
+    iree_io_parameter_archive_builder_deinitialize(&builder_);
+  }
+
+  // Writes the builder contents to storage and opens it as |archive_|.
+  iree_status_t WriteAndOpen() {
+    // Storage is allocated as uint64_t to ensure the required alignment.
+    uint64_t total_size =
+        iree_io_parameter_archive_builder_total_size(&builder_);
+    storage_.resize(total_size / sizeof(uint64_t) + 1);
+    iree_byte_span_t target =
+        iree_make_byte_span(storage_.data(), (iree_host_size_t)total_size);
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_archive_builder_write(&builder_, target));
+    return Open(target);
+  }
+
+  iree_status_t Open(iree_byte_span_t contents) {
+    iree_io_file_handle_t* file_handle = NULL;
+    IREE_RETURN_IF_ERROR(iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ, contents,
+        iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+        &file_handle));
+    iree_status_t status = iree_io_parameter_archive_open(
+        file_handle, iree_allocator_system(), &archive_);
+    iree_io_file_handle_release(file_handle);
+    return status;
+  }
+
+  iree_io_parameter_archive_header_t* header() {
+    return reinterpret_cast<iree_io_parameter_archive_header_t*>(
+        storage_.data());
+  }
+
+  iree_io_parameter_archive_builder_t builder_;
+  std::vector<uint64_t> storage_;
+  iree_io_parameter_archive_t* archive_ = NULL;
+};
+
+TEST_F(ParameterArchiveTest, Empty) {
+  IREE_ASSERT_OK(WriteAndOpen());
+  EXPECT_EQ(iree_io_parameter_archive_count(archive_), 0);
+  iree_io_parameter_info_t info;
+  EXPECT_THAT(Status(iree_io_parameter_archive_lookup(archive_, IREE_SV("a"),
+                                                      &info)),
+              StatusIs(StatusCode::kNotFound));
+}
+
+TEST_F(ParameterArchiveTest, LookupRaw) {
+  std::vector<std::vector<uint8_t>> contents;
+  for (int i = 0; i < 100; ++i) {
+    contents.push_back(std::vector<uint8_t>(i * 3 + 1, (uint8_t)i));
+  }
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "weight." + std::to_string(i);
+    IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+        &builder_, iree_make_string_view(name.data(), name.size()),
+        i % 2 ? 256 : 0,
+        iree_make_const_byte_span(contents[i].data(), contents[i].size())));
+  }
+  IREE_ASSERT_OK(WriteAndOpen());
+  ASSERT_EQ(iree_io_parameter_archive_count(archive_), 100);
+
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "weight." + std::to_string(i);
+    iree_io_parameter_info_t info;
+    IREE_ASSERT_OK(iree_io_parameter_archive_lookup(
+        archive_, iree_make_string_view(name.data(), name.size()), &info));
+    EXPECT_TRUE(iree_string_view_equal(
+        info.name, iree_make_string_view(name.data(), name.size())));
+    EXPECT_EQ(info.encoding, IREE_IO_PARAMETER_ENCODING_RAW);
+    EXPECT_EQ(info.length, contents[i].size());
+    EXPECT_EQ(info.alignment, i % 2 ? 256 : 64);
+    EXPECT_EQ(info.file_offset % info.alignment, 0);
+    ASSERT_EQ(info.contents.data_length, contents[i].size());
+    EXPECT_EQ(0, memcmp(info.contents.data, contents[i].data(),
+                        contents[i].size()));
+    EXPECT_EQ(info.contents.data,
+              reinterpret_cast<const uint8_t*>(storage_.data()) +
+                  info.file_offset);
+  }
+
+  iree_io_parameter_info_t info;
+  EXPECT_THAT(Status(iree_io_parameter_archive_lookup(
+                  archive_, IREE_SV("weight.100"), &info)),
+              StatusIs(StatusCode::kNotFound));
+}
+
+TEST_F(ParameterArchiveTest, Splat) {
+  const uint32_t pattern = 0x3F800000u;
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_splat(
+      &builder_, IREE_SV("ones"), 1024 * sizeof(pattern),
+      iree_make_const_byte_span(&pattern, sizeof(pattern))));
+  uint64_t size_with_splat =
+      iree_io_parameter_archive_builder_total_size(&builder_);
+  IREE_ASSERT_OK(WriteAndOpen());
+
+  // Splats take no space in the data segment.
+  EXPECT_LT(size_with_splat, 1024 * sizeof(pattern));
+
+  iree_io_parameter_info_t info;
+  IREE_ASSERT_OK(
+      iree_io_parameter_archive_lookup(archive_, IREE_SV("ones"), &info));
+  EXPECT_EQ(info.encoding, IREE_IO_PARAMETER_ENCODING_SPLAT);
+  EXPECT_EQ(info.length, 1024 * sizeof(pattern));
+  ASSERT_EQ(info.splat_pattern.data_length, sizeof(pattern));
+  EXPECT_EQ(0, memcmp(info.splat_pattern.data, &pattern, sizeof(pattern)));
+}
+
+TEST_F(ParameterArchiveTest, SplatLengthMismatch) {
+  const uint32_t pattern = 0;
+  EXPECT_THAT(Status(iree_io_parameter_archive_builder_add_splat(
+                  &builder_, IREE_SV("bad"), 7,
+                  iree_make_const_byte_span(&pattern, sizeof(pattern)))),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(ParameterArchiveTest, DuplicateNames) {
+  uint8_t data[4] = {0};
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("a"), 0, iree_make_const_byte_span(data, 4)));
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("a"), 0, iree_make_const_byte_span(data, 4)));
+  EXPECT_THAT(Status(WriteAndOpen()), StatusIs(StatusCode::kAlreadyExists));
+}
+
+TEST_F(ParameterArchiveTest, GetByIndex) {
+  uint8_t data[4] = {1, 2, 3, 4};
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("a"), 0, iree_make_const_byte_span(data, 4)));
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("b"), 0, iree_make_const_byte_span(data, 2)));
+  IREE_ASSERT_OK(WriteAndOpen());
+  iree_io_parameter_info_t info;
+  IREE_ASSERT_OK(iree_io_parameter_archive_get(archive_, 1, &info));
+  EXPECT_TRUE(iree_string_view_equal(info.name, IREE_SV("b")));
+  EXPECT_EQ(info.length, 2);
+  EXPECT_THAT(Status(iree_io_parameter_archive_get(archive_, 2, &info)),
+              StatusIs(StatusCode::kOutOfRange));
+}
+
+TEST_F(ParameterArchiveTest, RejectsBadMagic) {
+  IREE_ASSERT_OK(WriteAndOpen());
+  iree_io_parameter_archive_release(archive_);
+  archive_ = NULL;
+  header()->magic = 0;
+  EXPECT_THAT(Status(Open(iree_make_byte_span(storage_.data(),
+                                              header()->file_size))),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(ParameterArchiveTest, RejectsTruncated) {
+  uint8_t data[128] = {0};
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("a"), 0, iree_make_const_byte_span(data, 128)));
+  IREE_ASSERT_OK(WriteAndOpen());
+  iree_io_parameter_archive_release(archive_);
+  archive_ = NULL;
+  EXPECT_THAT(Status(Open(iree_make_byte_span(storage_.data(),
+                                              header()->file_size - 1))),
+              StatusIs(StatusCode::kOutOfRange));
+}
+
+TEST_F(ParameterArchiveTest, RejectsOutOfBoundsEntry) {
+  uint8_t data[16] = {0};
+  IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_raw(
+      &builder_, IREE_SV("a"), 0, iree_make_const_byte_span(data, 16)));
+  IREE_ASSERT_OK(WriteAndOpen());
+  iree_io_parameter_archive_release(archive_);
+  archive_ = NULL;
+  auto* entries = reinterpret_cast<iree_io_parameter_archive_entry_t*>(
+      reinterpret_cast<uint8_t*>(storage_.data()) +
+      header()->entry_table_offset);
+  entries[0].data_length = header()->data_length + 1;
+  EXPECT_THAT(Status(Open(iree_make_byte_span(storage_.data(),
+                                              header()->file_size))),
+              StatusIs(StatusCode::kOutOfRange));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
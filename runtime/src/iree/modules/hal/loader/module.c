@@ -21,6 +21,8 @@
 typedef struct iree_hal_loader_module_t {
   iree_allocator_t host_allocator;
   iree_hal_loader_module_flags_t flags;
+  // Optional; when worker_count > 1 dispatches are issued in parallel.
+  iree_hal_parallel_for_t parallel_for;
   // TODO(benvanik): types.
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
@@ -33,6 +35,7 @@ typedef struct iree_hal_loader_module_t {
 typedef struct iree_hal_loader_module_state_t {
   iree_allocator_t host_allocator;
   iree_hal_loader_module_flags_t flags;
+  iree_hal_parallel_for_t parallel_for;
 } iree_hal_loader_module_state_t;
 
 static void IREE_API_PTR iree_hal_loader_module_destroy(void* base_module) {
@@ -55,6 +58,7 @@ iree_hal_loader_module_alloc_state(void* self, iree_allocator_t host_allocator,
   memset(state, 0, sizeof(*state));
   state->host_allocator = host_allocator;
   state->flags = module->flags;
+  state->parallel_for = module->parallel_for;
 
   *out_module_state = (iree_vm_module_state_t*)state;
   IREE_TRACE_ZONE_END(z0);
@@ -277,7 +281,7 @@ static iree_status_t iree_hal_loader_module_executable_dispatch(
       .workgroup_count_x = args->workgroup_x,
       .workgroup_count_y = args->workgroup_y,
       .workgroup_count_z = args->workgroup_z,
-      .max_concurrency = 1,
+      .max_concurrency = iree_max(1, state->parallel_for.worker_count),
       .binding_count = args->binding_count,
       .push_constants = args->push_constants,
       .binding_ptrs = binding_ptrs,
@@ -288,6 +292,11 @@ static iree_status_t iree_hal_loader_module_executable_dispatch(
   uint32_t processor_id = 0;
   iree_byte_span_t local_memory = iree_byte_span_empty();
 
+  if (state->parallel_for.worker_count > 1) {
+    return iree_hal_local_executable_issue_dispatch_parallel(
+        (iree_hal_local_executable_t*)executable, args->entry_point,
+        &dispatch_state, processor_id, &state->parallel_for);
+  }
   return iree_hal_local_executable_issue_dispatch_inline(
       (iree_hal_local_executable_t*)executable, args->entry_point,
       &dispatch_state, processor_id, local_memory);
@@ -392,6 +401,16 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  return iree_hal_loader_module_create_with_parallel_for(
+      instance, flags, /*parallel_for=*/NULL, loader_count, loaders,
+      host_allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_parallel_for(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    const iree_hal_parallel_for_t* parallel_for, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -424,6 +443,7 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
   iree_hal_loader_module_t* module = IREE_HAL_LOADER_MODULE_CAST(base_module);
   module->host_allocator = host_allocator;
   module->flags = flags;
+  if (parallel_for) module->parallel_for = *parallel_for;
   module->loader_count = loader_count;
   for (iree_host_size_t i = 0; i < loader_count; ++i) {
     module->loaders[i] = loaders[i];
@@ -12,6 +12,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable.h"
 #include "iree/modules/hal/types.h"
 #include "iree/vm/api.h"
 
@@ -30,6 +31,16 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module);
 
+// Creates the dynamic HAL executable loader module for local execution with
+// dispatch workgroups distributed across the workers of |parallel_for|.
+// The parallel-for must remain valid for the lifetime of the module and may be
+// invoked from any thread calling into the module.
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_parallel_for(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    const iree_hal_parallel_for_t* parallel_for, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
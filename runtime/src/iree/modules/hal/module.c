@@ -67,8 +67,136 @@ typedef struct iree_hal_module_state_t {
   // executables like ones for training vs inference in the same model, or just
   // always use this.
   iree_hal_executable_cache_t* executable_cache;
+
+  // Collected with IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS.
+  iree_host_size_t executable_load_capacity;
+  iree_hal_module_load_statistics_t load_statistics;
+
+  // Constant buffers imported by any module in the context that identical
+  // constant ranges imported later can share. Only populated with
+  // IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS.
+  iree_host_size_t constant_count;
+  iree_host_size_t constant_capacity;
+  struct iree_hal_module_constant_t* constants;
 } iree_hal_module_state_t;
 
+// A constant range imported into a device buffer.
+typedef struct iree_hal_module_constant_t {
+  // Allocator and parameters the buffer was imported with. A buffer is only
+  // shared with requests for the same allocator and parameters.
+  iree_hal_allocator_t* allocator;
+  iree_hal_buffer_params_t params;
+  // Host contents of the constant. Kept live by |buffer| retaining the source.
+  iree_const_byte_span_t contents;
+  // FNV-1a hash of |contents|. Only computed once another constant of the same
+  // length is looked up so that constants of unique sizes are never hashed.
+  uint64_t hash;
+  bool has_hash;
+  iree_hal_buffer_t* buffer;
+} iree_hal_module_constant_t;
+
+static void iree_hal_module_constant_hash(
+    iree_hal_module_constant_t* constant) {
+  if (constant->has_hash) return;
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < constant->contents.data_length; ++i) {
+    hash ^= constant->contents.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  constant->hash = hash;
+  constant->has_hash = true;
+}
+
+static bool iree_hal_module_constant_params_equal(
+    const iree_hal_buffer_params_t* lhs, const iree_hal_buffer_params_t* rhs) {
+  return lhs->type == rhs->type && lhs->usage == rhs->usage &&
+         lhs->access == rhs->access &&
+         lhs->queue_affinity == rhs->queue_affinity &&
+         lhs->min_alignment == rhs->min_alignment;
+}
+
+// Returns a buffer previously imported by |state| with the same allocator,
+// parameters, and contents as |key| or NULL if there is none. The hash of |key|
+// is computed as needed and kept for iree_hal_module_state_insert_constant.
+static iree_hal_buffer_t* iree_hal_module_state_lookup_constant(
+    iree_hal_module_state_t* state, iree_hal_module_constant_t* key) {
+  for (iree_host_size_t i = 0; i < state->constant_count; ++i) {
+    iree_hal_module_constant_t* constant = &state->constants[i];
+    if (constant->allocator != key->allocator ||
+        constant->contents.data_length != key->contents.data_length ||
+        !iree_hal_module_constant_params_equal(&constant->params,
+                                               &key->params)) {
+      continue;
+    }
+    if (constant->contents.data == key->contents.data) return constant->buffer;
+    iree_hal_module_constant_hash(constant);
+    iree_hal_module_constant_hash(key);
+    if (constant->hash == key->hash &&
+        memcmp(constant->contents.data, key->contents.data,
+               key->contents.data_length) == 0) {
+      return constant->buffer;
+    }
+  }
+  return NULL;
+}
+
+// Records |buffer| holding the constant described by |key| in |state|.
+// Both the allocator and the buffer are retained.
+static iree_status_t iree_hal_module_state_insert_constant(
+    iree_hal_module_state_t* state, const iree_hal_module_constant_t* key,
+    iree_hal_buffer_t* buffer) {
+  if (state->constant_count + 1 > state->constant_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, state->constant_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        state->host_allocator, new_capacity * sizeof(*state->constants),
+        (void**)&state->constants));
+    state->constant_capacity = new_capacity;
+  }
+  iree_hal_module_constant_t* constant =
+      &state->constants[state->constant_count++];
+  *constant = *key;
+  constant->buffer = buffer;
+  iree_hal_allocator_retain(constant->allocator);
+  iree_hal_buffer_retain(constant->buffer);
+  return iree_ok_status();
+}
+
+static void iree_hal_module_state_release_constants(
+    iree_hal_module_state_t* state) {
+  for (iree_host_size_t i = 0; i < state->constant_count; ++i) {
+    iree_hal_buffer_release(state->constants[i].buffer);
+    iree_hal_allocator_release(state->constants[i].allocator);
+  }
+  iree_allocator_free(state->host_allocator, state->constants);
+  state->constants = NULL;
+  state->constant_count = 0;
+  state->constant_capacity = 0;
+}
+
+// Appends a record of an executable prepared by |state|.
+static iree_status_t iree_hal_module_state_record_executable_load(
+    iree_hal_module_state_t* state, iree_string_view_t format,
+    iree_host_size_t data_length, iree_duration_t duration_ns) {
+  iree_hal_module_load_statistics_t* statistics = &state->load_statistics;
+  if (statistics->executable_count + 1 > state->executable_load_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(16, state->executable_load_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        state->host_allocator,
+        new_capacity * sizeof(iree_hal_module_executable_load_t),
+        (void**)&statistics->executables));
+    state->executable_load_capacity = new_capacity;
+  }
+  iree_hal_module_executable_load_t* load =
+      (iree_hal_module_executable_load_t*)&statistics
+          ->executables[statistics->executable_count++];
+  memset(load, 0, sizeof(*load));
+  iree_string_view_to_cstring(format, load->format, sizeof(load->format));
+  load->data_length = data_length;
+  load->duration_ns = duration_ns;
+  return iree_ok_status();
+}
+
 static void IREE_API_PTR iree_hal_module_destroy(void* base_module) {
   iree_hal_module_t* module = IREE_HAL_MODULE_CAST(base_module);
   iree_hal_device_release(module->shared_device);
@@ -106,14 +234,57 @@ iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
+  iree_hal_module_state_release_constants(state);
   iree_hal_executable_cache_release(state->executable_cache);
   iree_status_ignore(state->loop_status);
   iree_hal_device_release(state->shared_device);
+  iree_allocator_free(state->host_allocator,
+                      (void*)state->load_statistics.executables);
   iree_allocator_free(state->host_allocator, state);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+static iree_status_t IREE_API_PTR
+iree_hal_module_fork_state(void* self, iree_vm_module_state_t* parent_state,
+                           iree_allocator_t host_allocator,
+                           iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_module_state_t* parent = (iree_hal_module_state_t*)parent_state;
+  iree_hal_module_state_t* state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->host_allocator = host_allocator;
+  state->flags = parent->flags;
+  state->shared_device = parent->shared_device;
+  iree_hal_device_retain(state->shared_device);
+  state->loop_status = iree_ok_status();
+
+  // Executables prepared by the parent are immutable and can be shared.
+  state->executable_cache = parent->executable_cache;
+  iree_hal_executable_cache_retain(state->executable_cache);
+
+  // So are the constants it imported.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < parent->constant_count; ++i) {
+    status = iree_hal_module_state_insert_constant(
+        state, &parent->constants[i], parent->constants[i].buffer);
+    if (!iree_status_is_ok(status)) break;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_module_free_state(self, (iree_vm_module_state_t*)state);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static iree_status_t IREE_API_PTR iree_hal_module_notify(
     void* self, iree_vm_module_state_t* module_state, iree_vm_signal_t signal) {
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
@@ -315,6 +486,32 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_import,  //
       .access = allowed_access,
       .queue_affinity = queue_affinity,
   };
+
+  // Share the buffer of an identical constant imported earlier by any module
+  // in the context. Mutable sources may change and are never shared.
+  iree_hal_module_constant_t constant = {
+      .allocator = allocator,
+      .params = params,
+      .contents = iree_make_const_byte_span(source->data.data + offset,
+                                            (iree_host_size_t)length),
+  };
+  bool deduplicate =
+      iree_all_bits_set(state->flags,
+                        IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS) &&
+      !iree_all_bits_set(source->access, IREE_VM_BUFFER_ACCESS_MUTABLE);
+  if (deduplicate) {
+    iree_hal_buffer_t* shared_buffer =
+        iree_hal_module_state_lookup_constant(state, &constant);
+    if (shared_buffer) {
+      if (state->flags & IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS) {
+        state->load_statistics.constant_bytes += (uint64_t)length;
+        state->load_statistics.deduplicated_constant_bytes += (uint64_t)length;
+      }
+      rets->r0 = iree_hal_buffer_retain_ref(shared_buffer);
+      return iree_ok_status();
+    }
+  }
+
   iree_hal_external_buffer_t external_buffer = {
       .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
       .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
@@ -332,6 +529,16 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_import,  //
     // Import succeeded - retain the source buffer that'll be released by
     // iree_hal_module_map_data_ctl when the mapping is no longer used.
     iree_vm_buffer_retain(source);
+    if (deduplicate) {
+      status = iree_hal_module_state_insert_constant(state, &constant, buffer);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_buffer_release(buffer);
+        return status;
+      }
+    }
+    if (state->flags & IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS) {
+      state->load_statistics.constant_bytes += (uint64_t)length;
+    }
     rets->r0 = iree_hal_buffer_move_ref(buffer);
     return iree_ok_status();
   }
@@ -1046,6 +1253,11 @@ IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_read,  //
   iree_device_size_t target_offset = iree_hal_cast_device_size(args->i7);
   iree_device_size_t length = iree_hal_cast_device_size(args->i8);
   uint32_t flags = (uint32_t)args->i9;
+  // NOTE: reads target buffers allocated by the program and cannot share them
+  // with IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS; only imports are shared.
+  if (state->flags & IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS) {
+    state->load_statistics.constant_bytes += (uint64_t)length;
+  }
   return iree_hal_device_queue_read(
       device, queue_affinity, iree_hal_fence_semaphore_list(wait_fence),
       iree_hal_fence_semaphore_list(signal_fence), source_file, source_offset,
@@ -1163,8 +1375,15 @@ IREE_VM_ABI_EXPORT(iree_hal_module_executable_create,  //
     executable_params.pipeline_layouts = pipeline_layouts;
     executable_params.constant_count = constant_count;
     executable_params.constants = constants;
+    iree_time_t start_time_ns = iree_time_now();
     status = iree_hal_executable_cache_prepare_executable(
         state->executable_cache, &executable_params, &executable);
+    if (iree_status_is_ok(status) &&
+        (state->flags & IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS)) {
+      status = iree_hal_module_state_record_executable_load(
+          state, executable_format_str, executable_data->data.data_length,
+          iree_time_now() - start_time_ns);
+    }
   }
 
   iree_allocator_free(state->host_allocator, pipeline_layouts);
@@ -1543,6 +1762,7 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
       .alloc_state = iree_hal_module_alloc_state,
       .free_state = iree_hal_module_free_state,
       .notify = iree_hal_module_notify,
+      .fork_state = iree_hal_module_fork_state,
   };
 
   // Allocate shared module state.
@@ -1576,3 +1796,9 @@ IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device(
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
   return state->shared_device;
 }
+
+IREE_API_EXPORT iree_hal_module_load_statistics_t
+iree_hal_module_state_load_statistics(iree_vm_module_state_t* module_state) {
+  iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
+  return state->load_statistics;
+}
@@ -23,6 +23,18 @@ enum iree_hal_module_flag_bits_t {
 
   // Forces HAL methods to block instead of yielding as a coroutine.
   IREE_HAL_MODULE_FLAG_SYNCHRONOUS = 1u << 0,
+
+  // Records the executables and constant data loaded by each module state so
+  // that they can be queried with iree_hal_module_state_load_statistics.
+  // Intended for startup profiling as it retains a record per executable.
+  IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS = 1u << 1,
+
+  // Shares device buffers between identical constant ranges imported by the
+  // modules of a context (for example an encoder and decoder compiled with the
+  // same weights). Imported constants are hashed by content and a range that
+  // matches one imported earlier with the same buffer parameters reuses its
+  // buffer. The buffers are retained by the module state until it is freed.
+  IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS = 1u << 2,
 };
 typedef uint32_t iree_hal_module_flags_t;
 
@@ -39,6 +51,38 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
 IREE_API_EXPORT iree_hal_device_t* iree_hal_module_state_device(
     iree_vm_module_state_t* module_state);
 
+// Records an executable prepared by a HAL module state.
+typedef struct iree_hal_module_executable_load_t {
+  // Executable format identifier truncated to fit.
+  char format[32];
+  // Size of the executable data in bytes.
+  iree_host_size_t data_length;
+  // Time spent preparing the executable with the device executable cache.
+  iree_duration_t duration_ns;
+} iree_hal_module_executable_load_t;
+
+// Resources loaded by a HAL module state, usually while the module
+// initializers of the context run. Empty unless the module was created with
+// IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS.
+typedef struct iree_hal_module_load_statistics_t {
+  // Executables in the order they were created.
+  iree_host_size_t executable_count;
+  const iree_hal_module_executable_load_t* executables;
+  // Total bytes of constant data imported from module memory or read from
+  // files into device buffers. Reads are asynchronous and may complete after
+  // the call that issued them returns.
+  uint64_t constant_bytes;
+  // Bytes of constant data that reused a buffer imported earlier instead of
+  // being imported again. Only counted with
+  // IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS and included in constant_bytes.
+  uint64_t deduplicated_constant_bytes;
+} iree_hal_module_load_statistics_t;
+
+// Returns the load statistics of the HAL module state. The executable list is
+// valid until the next executable is created or the state is freed.
+IREE_API_EXPORT iree_hal_module_load_statistics_t
+iree_hal_module_state_load_statistics(iree_vm_module_state_t* module_state);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
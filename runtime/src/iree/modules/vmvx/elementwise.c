@@ -42,6 +42,12 @@ typedef enum {
   IREE_UK_X32B_SUBF = 12,
   IREE_UK_X32B_SUBI = 13,
   IREE_UKENREL_X32B_XORI = 14,
+  IREE_UK_X32B_MAXF = 15,
+  IREE_UK_X32B_MAXSI = 16,
+  IREE_UK_X32B_MAXUI = 17,
+  IREE_UK_X32B_MINF = 18,
+  IREE_UK_X32B_MINSI = 19,
+  IREE_UK_X32B_MINUI = 20,
 } iree_uk_x32b_opcode_t;
 
 typedef enum {
@@ -55,11 +61,6 @@ typedef enum {
   IREE_UK_X32U_RSQRTF,
 } iree_uk_x32u_opcode_t;
 
-// Macros to access various typed, dereferenced pointers.
-#define ASF32(ptr) *((float*)ptr)
-#define ASUI32(ptr) *((iree_uk_uint32_t*)ptr)
-#define ASSI32(ptr) *((iree_uk_int32_t*)ptr)
-
 //===----------------------------------------------------------------------===//
 // Implementation macros.
 //===----------------------------------------------------------------------===//
@@ -101,105 +102,82 @@ typedef enum {
 // Internal helpers.
 //===----------------------------------------------------------------------===//
 
-// Computes a single element of an x32b opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32b_op(iree_uk_x32b_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* lhs,
-                                    const iree_uk_uint32_t* rhs,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32B_ADDF:
-      ASF32(out) = ASF32(lhs) + ASF32(rhs);
-      return;
-    case IREE_UK_X32B_ADDI:
-      ASUI32(out) = ASUI32(lhs) + ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ANDI:
-      ASUI32(out) = ASUI32(lhs) & ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVF:
-      ASF32(out) = ASF32(lhs) / ASF32(rhs);
-      return;
-    case IREE_UK_X32B_DIVSI:
-      ASSI32(out) = ASSI32(lhs) / ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVUI:
-      ASUI32(out) = ASUI32(lhs) / ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_MULF:
-      ASF32(out) = ASF32(lhs) * ASF32(rhs);
-      return;
-    case IREE_UK_X32B_MULI:
-      ASUI32(out) = ASUI32(lhs) * ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ORI:
-      ASUI32(out) = ASUI32(lhs) | ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHLI:
-      ASUI32(out) = ASUI32(lhs) << ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRSI:
-      ASSI32(out) = ASSI32(lhs) >> ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRUI:
-      ASUI32(out) = ASUI32(lhs) >> ASUI32(rhs);
-      return;
-    case IREE_UKENREL_X32B_XORI:
-      ASUI32(out) = ASUI32(lhs) ^ ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SUBF:
-      ASF32(out) = ASF32(lhs) - ASF32(rhs);
-      return;
-    case IREE_UK_X32B_SUBI:
-      ASSI32(out) = ASUI32(lhs) - ASUI32(rhs);
-      return;
-    default:
-      *result_code = 1;
-  }
+// Matches arith.maximumf: NaN if either operand is NaN and +0 > -0.
+static inline float iree_uk_maximumf(float a, float b) {
+  if (a != a || b != b) return a != a ? a : b;
+  if (a == b) return signbit(a) ? b : a;
+  return a > b ? a : b;
 }
 
-// Computes a single element of an x32u opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32u_op(iree_uk_x32u_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* in,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32U_ABSF:
-      ASF32(out) = fabsf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CEILF:
-      ASF32(out) = ceilf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CTLZ:
-      ASUI32(out) = iree_uk_count_leading_zeros_u32(ASUI32(in));
-      return;
-    case IREE_UK_X32U_EXPF:
-      ASF32(out) = expf(ASF32(in));
-      return;
-    case IREE_UK_X32U_FLOORF:
-      ASF32(out) = floorf(ASF32(in));
-      return;
-    case IREE_UK_X32U_LOGF:
-      ASF32(out) = logf(ASF32(in));
-      return;
-    case IREE_UK_X32U_NEGF:
-      ASF32(out) = -ASF32(in);
-      return;
-    case IREE_UK_X32U_RSQRTF:
-      ASF32(out) = 1.0f / sqrtf(ASF32(in));
-      return;
-    default:
-      *result_code = 1;
-  }
+// Matches arith.minimumf: NaN if either operand is NaN and -0 < +0.
+static inline float iree_uk_minimumf(float a, float b) {
+  if (a != a || b != b) return a != a ? a : b;
+  if (a == b) return signbit(a) ? a : b;
+  return a < b ? a : b;
 }
 
+// Evaluates |expr| of operands `a` and `b` of type |ctype| over the 2D ranges.
+// The opcode is resolved once per call (instead of once per element) and the
+// inner loop is specialized for contiguous rows and row-broadcast operands so
+// that it is a countable unit-stride loop the compiler can vectorize for the
+// SIMD extensions available to the target.
+#define IREE_UK_X32B_LOOP_2D(ctype, expr)                                    \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {                              \
+    const ctype* lhs_row = (const ctype*)lhs + i * lhs_stride0;              \
+    const ctype* rhs_row = (const ctype*)rhs + i * rhs_stride0;              \
+    ctype* out_row = (ctype*)out + i * out_stride0;                          \
+    if (lhs_stride1 == 1 && rhs_stride1 == 1 && out_stride1 == 1) {          \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                          \
+        ctype a = lhs_row[j];                                                \
+        ctype b = rhs_row[j];                                                \
+        out_row[j] = (expr);                                                 \
+      }                                                                      \
+    } else if (lhs_stride1 == 1 && rhs_stride1 == 0 && out_stride1 == 1) {   \
+      const ctype b = rhs_row[0];                                            \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                          \
+        ctype a = lhs_row[j];                                                \
+        out_row[j] = (expr);                                                 \
+      }                                                                      \
+    } else if (lhs_stride1 == 0 && rhs_stride1 == 1 && out_stride1 == 1) {   \
+      const ctype a = lhs_row[0];                                            \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                          \
+        ctype b = rhs_row[j];                                                \
+        out_row[j] = (expr);                                                 \
+      }                                                                      \
+    } else {                                                                 \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                          \
+        ctype a = lhs_row[j * lhs_stride1];                                  \
+        ctype b = rhs_row[j * rhs_stride1];                                  \
+        out_row[j * out_stride1] = (expr);                                   \
+      }                                                                      \
+    }                                                                        \
+  }
+
+// Evaluates |expr| of operand `a` of type |ctype| over the 2D ranges.
+// See IREE_UK_X32B_LOOP_2D.
+#define IREE_UK_X32U_LOOP_2D(ctype, expr)                   \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {             \
+    const ctype* in_row = (const ctype*)in + i * in_stride0; \
+    ctype* out_row = (ctype*)out + i * out_stride0;         \
+    if (in_stride1 == 1 && out_stride1 == 1) {              \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {         \
+        ctype a = in_row[j];                                \
+        out_row[j] = (expr);                                \
+      }                                                     \
+    } else {                                                \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {         \
+        ctype a = in_row[j * in_stride1];                   \
+        out_row[j * out_stride1] = (expr);                  \
+      }                                                     \
+    }                                                       \
+  }
+
 //===----------------------------------------------------------------------===//
 // Opcode dispatch entry points.
 //===----------------------------------------------------------------------===//
 
 // Generic 32bit binary kernels.
+// Returns non-zero if the opcode is not recognized.
 IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32b_2d(
     iree_uk_x32b_opcode_t opcode,
     // LHS.
@@ -213,20 +191,77 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32b_2d(
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32b_op(opcode, &result_code,
-                              &lhs[i * lhs_stride0 + j * lhs_stride1],
-                              &rhs[i * rhs_stride0 + j * rhs_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  switch (opcode) {
+    case IREE_UK_X32B_ADDF:
+      IREE_UK_X32B_LOOP_2D(float, a + b);
+      return 0;
+    case IREE_UK_X32B_ADDI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a + b);
+      return 0;
+    case IREE_UK_X32B_ANDI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a & b);
+      return 0;
+    case IREE_UK_X32B_DIVF:
+      IREE_UK_X32B_LOOP_2D(float, a / b);
+      return 0;
+    case IREE_UK_X32B_DIVSI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_int32_t, a / b);
+      return 0;
+    case IREE_UK_X32B_DIVUI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a / b);
+      return 0;
+    case IREE_UK_X32B_MAXF:
+      IREE_UK_X32B_LOOP_2D(float, iree_uk_maximumf(a, b));
+      return 0;
+    case IREE_UK_X32B_MAXSI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_int32_t, a > b ? a : b);
+      return 0;
+    case IREE_UK_X32B_MAXUI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a > b ? a : b);
+      return 0;
+    case IREE_UK_X32B_MINF:
+      IREE_UK_X32B_LOOP_2D(float, iree_uk_minimumf(a, b));
+      return 0;
+    case IREE_UK_X32B_MINSI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_int32_t, a < b ? a : b);
+      return 0;
+    case IREE_UK_X32B_MINUI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a < b ? a : b);
+      return 0;
+    case IREE_UK_X32B_MULF:
+      IREE_UK_X32B_LOOP_2D(float, a * b);
+      return 0;
+    case IREE_UK_X32B_MULI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a * b);
+      return 0;
+    case IREE_UK_X32B_ORI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a | b);
+      return 0;
+    case IREE_UK_X32B_SHLI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a << b);
+      return 0;
+    case IREE_UK_X32B_SHRSI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_int32_t, a >> b);
+      return 0;
+    case IREE_UK_X32B_SHRUI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a >> b);
+      return 0;
+    case IREE_UKENREL_X32B_XORI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a ^ b);
+      return 0;
+    case IREE_UK_X32B_SUBF:
+      IREE_UK_X32B_LOOP_2D(float, a - b);
+      return 0;
+    case IREE_UK_X32B_SUBI:
+      IREE_UK_X32B_LOOP_2D(iree_uk_uint32_t, a - b);
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 // Generic 32bit unary kernels.
+// Returns non-zero if the opcode is not recognized.
 IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32u_2d(
     iree_uk_x32u_opcode_t opcode,
     // IN.
@@ -237,16 +272,35 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32u_2d(
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32u_op(opcode, &result_code,
-                              &in[i * in_stride0 + j * in_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  switch (opcode) {
+    case IREE_UK_X32U_ABSF:
+      IREE_UK_X32U_LOOP_2D(float, fabsf(a));
+      return 0;
+    case IREE_UK_X32U_CEILF:
+      IREE_UK_X32U_LOOP_2D(float, ceilf(a));
+      return 0;
+    case IREE_UK_X32U_CTLZ:
+      IREE_UK_X32U_LOOP_2D(iree_uk_uint32_t,
+                           iree_uk_count_leading_zeros_u32(a));
+      return 0;
+    case IREE_UK_X32U_EXPF:
+      IREE_UK_X32U_LOOP_2D(float, expf(a));
+      return 0;
+    case IREE_UK_X32U_FLOORF:
+      IREE_UK_X32U_LOOP_2D(float, floorf(a));
+      return 0;
+    case IREE_UK_X32U_LOGF:
+      IREE_UK_X32U_LOOP_2D(float, logf(a));
+      return 0;
+    case IREE_UK_X32U_NEGF:
+      IREE_UK_X32U_LOOP_2D(float, -a);
+      return 0;
+    case IREE_UK_X32U_RSQRTF:
+      IREE_UK_X32U_LOOP_2D(float, 1.0f / sqrtf(a));
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 DISPATCH_UKERNEL_BINARY_2D(addf, IREE_UK_X32B_ADDF, iree_uk_uint32_t, x32b);
@@ -255,6 +309,12 @@ DISPATCH_UKERNEL_BINARY_2D(andi, IREE_UK_X32B_ANDI, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(divf, IREE_UK_X32B_DIVF, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(divsi, IREE_UK_X32B_DIVSI, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(divui, IREE_UK_X32B_DIVUI, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(maxf, IREE_UK_X32B_MAXF, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(maxsi, IREE_UK_X32B_MAXSI, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(maxui, IREE_UK_X32B_MAXUI, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(minf, IREE_UK_X32B_MINF, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(minsi, IREE_UK_X32B_MINSI, iree_uk_uint32_t, x32b);
+DISPATCH_UKERNEL_BINARY_2D(minui, IREE_UK_X32B_MINUI, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(mulf, IREE_UK_X32B_MULF, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(muli, IREE_UK_X32B_MULI, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(ori, IREE_UK_X32B_ORI, iree_uk_uint32_t, x32b);
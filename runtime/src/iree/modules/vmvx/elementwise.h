@@ -48,6 +48,12 @@ DECLARE_UKERNEL_BINARY_2D(andi, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(divf, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(divsi, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(divui, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(maxf, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(maxsi, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(maxui, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(minf, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(minsi, iree_uk_uint32_t, x32b);
+DECLARE_UKERNEL_BINARY_2D(minui, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(mulf, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(muli, iree_uk_uint32_t, x32b);
 DECLARE_UKERNEL_BINARY_2D(ori, iree_uk_uint32_t, x32b);
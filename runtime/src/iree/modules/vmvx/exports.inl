@@ -40,6 +40,12 @@ EXPORT_FN("exp.2d.f32", iree_uk_x32u_expf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("fill.2d.x32", iree_vmvx_fill2d_x32, fill2d_x32, irIIII, v)
 EXPORT_FN("floor.2d.f32", iree_uk_x32u_floorf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("log.2d.f32", iree_uk_x32u_logf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
+EXPORT_FN("max.2d.f32", iree_uk_x32b_maxf_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
+EXPORT_FN("maxs.2d.i32", iree_uk_x32b_maxsi_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
+EXPORT_FN("maxu.2d.i32", iree_uk_x32b_maxui_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
+EXPORT_FN("min.2d.f32", iree_uk_x32b_minf_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
+EXPORT_FN("mins.2d.i32", iree_uk_x32b_minsi_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
+EXPORT_FN("minu.2d.i32", iree_uk_x32b_minui_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
 EXPORT_FN("mmt4d", iree_vmvx_mmt4d, mmt4d, rIIrIIrIIIIIiiii, v)
 EXPORT_FN("mul.2d.f32", iree_uk_x32b_mulf_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
 EXPORT_FN("mul.2d.i32", iree_uk_x32b_muli_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
@@ -0,0 +1,554 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/batcher.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/modules/hal/types.h"
+#include "iree/runtime/session.h"
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_options_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->max_batch_size = 8;
+  out_options->max_delay_ns = 2000000;  // 2ms
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+// A single request waiting for or participating in a batch.
+typedef struct iree_runtime_batcher_request_t {
+  iree_vm_list_t* inputs;
+  iree_vm_list_t* outputs;
+  iree_hal_fence_t* signal_fence;
+  iree_time_t submit_time_ns;
+} iree_runtime_batcher_request_t;
+
+// Storage for a batched argument reused across batches.
+typedef struct iree_runtime_batcher_arg_t {
+  // Buffer with room for max_batch_size rows of |row_size| bytes.
+  iree_hal_buffer_t* buffer;
+  iree_device_size_t row_size;
+} iree_runtime_batcher_arg_t;
+
+struct iree_runtime_batcher_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_runtime_session_t* session;
+  iree_vm_function_t function;
+  iree_runtime_batcher_options_t options;
+  iree_host_size_t arg_count;
+  iree_host_size_t result_count;
+
+  // Guards the pending requests.
+  iree_slim_mutex_t queue_mutex;
+  iree_host_size_t pending_count;
+  iree_runtime_batcher_request_t* pending;  // [max_batch_size]
+
+  // Held while executing a batch and guards all fields below.
+  iree_slim_mutex_t execute_mutex;
+  iree_runtime_batcher_request_t* executing;  // [max_batch_size]
+  iree_runtime_batcher_arg_t* args;           // [arg_count]
+  iree_vm_list_t* batch_inputs;
+  iree_vm_list_t* batch_outputs;
+};
+
+static void iree_runtime_batcher_destroy(iree_runtime_batcher_t* batcher);
+
+// Returns true if every value in the cconv |fragment| is a ref.
+static bool iree_runtime_batcher_is_all_refs(iree_string_view_t fragment) {
+  for (iree_host_size_t i = 0; i < fragment.size; ++i) {
+    if (fragment.data[i] != 'r') return false;
+  }
+  return true;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_batcher);
+  *out_batcher = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (options->max_batch_size == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "max_batch_size must be at least 1");
+  }
+
+  // Batching is only possible when all arguments and results are buffer views
+  // that can be concatenated/split along their outermost dimension.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t arguments;
+  iree_string_view_t results;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(&signature, &arguments,
+                                                    &results));
+  if (!iree_runtime_batcher_is_all_refs(arguments) ||
+      !iree_runtime_batcher_is_all_refs(results)) {
+    iree_string_view_t name = iree_vm_function_name(&function);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "function '%.*s' is not batchable; all arguments "
+                            "and results must be buffer views",
+                            (int)name.size, name.data);
+  }
+
+  iree_runtime_batcher_t* batcher = NULL;
+  iree_host_size_t total_size =
+      sizeof(*batcher) +
+      2 * options->max_batch_size * sizeof(iree_runtime_batcher_request_t) +
+      arguments.size * sizeof(iree_runtime_batcher_arg_t);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&batcher));
+  iree_atomic_ref_count_init(&batcher->ref_count);
+  batcher->host_allocator = host_allocator;
+  batcher->session = session;
+  iree_runtime_session_retain(session);
+  batcher->function = function;
+  batcher->options = *options;
+  batcher->arg_count = arguments.size;
+  batcher->result_count = results.size;
+  iree_slim_mutex_initialize(&batcher->queue_mutex);
+  iree_slim_mutex_initialize(&batcher->execute_mutex);
+  batcher->pending = (iree_runtime_batcher_request_t*)(batcher + 1);
+  batcher->executing = batcher->pending + options->max_batch_size;
+  batcher->args =
+      (iree_runtime_batcher_arg_t*)(batcher->executing +
+                                    options->max_batch_size);
+
+  iree_status_t status =
+      iree_vm_list_create(iree_vm_make_undefined_type_def(), arguments.size,
+                          host_allocator, &batcher->batch_inputs);
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_vm_list_create(iree_vm_make_undefined_type_def(), results.size,
+                            host_allocator, &batcher->batch_outputs);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_batcher = batcher;
+  } else {
+    iree_runtime_batcher_release(batcher);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher) {
+    iree_atomic_ref_count_inc(&batcher->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher && iree_atomic_ref_count_dec(&batcher->ref_count) == 1) {
+    iree_runtime_batcher_destroy(batcher);
+  }
+}
+
+// Ensures the batch buffer for argument |arg| can hold rows of |row_size|.
+static iree_status_t iree_runtime_batcher_ensure_arg_storage(
+    iree_runtime_batcher_t* batcher, iree_runtime_batcher_arg_t* arg,
+    iree_device_size_t row_size) {
+  if (arg->buffer && arg->row_size == row_size) return iree_ok_status();
+  iree_hal_buffer_release(arg->buffer);
+  arg->buffer = NULL;
+  arg->row_size = 0;
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+  };
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      iree_runtime_session_device_allocator(batcher->session), params,
+      row_size * batcher->options.max_batch_size, &arg->buffer));
+  arg->row_size = row_size;
+  return iree_ok_status();
+}
+
+// Verifies that request |view| can occupy a row in a batch shaped like
+// |first_view|.
+static iree_status_t iree_runtime_batcher_verify_row(
+    iree_host_size_t arg_index, iree_hal_buffer_view_t* first_view,
+    iree_hal_buffer_view_t* view) {
+  iree_host_size_t rank = iree_hal_buffer_view_shape_rank(view);
+  if (rank == 0 || iree_hal_buffer_view_shape_dim(view, 0) != 1) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument %" PRIhsz
+                            " must have an outermost batch dimension of 1",
+                            arg_index);
+  }
+  if (view == first_view) return iree_ok_status();
+  bool is_compatible =
+      rank == iree_hal_buffer_view_shape_rank(first_view) &&
+      iree_hal_buffer_view_element_type(view) ==
+          iree_hal_buffer_view_element_type(first_view) &&
+      iree_hal_buffer_view_encoding_type(view) ==
+          iree_hal_buffer_view_encoding_type(first_view);
+  for (iree_host_size_t i = 1; is_compatible && i < rank; ++i) {
+    is_compatible = iree_hal_buffer_view_shape_dim(view, i) ==
+                    iree_hal_buffer_view_shape_dim(first_view, i);
+  }
+  if (!is_compatible) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument %" PRIhsz
+                            " shape or type differs from other requests in "
+                            "the batch",
+                            arg_index);
+  }
+  return iree_ok_status();
+}
+
+// Copies all inputs of the first |count| executing requests into the batch
+// buffers and populates the batch input list with views of |count| rows.
+static iree_status_t iree_runtime_batcher_gather(
+    iree_runtime_batcher_t* batcher, iree_host_size_t count) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_device_t* device = iree_runtime_session_device(batcher->session);
+
+  // Verify all requests and allocate storage before recording any copies.
+  for (iree_host_size_t i = 0; i < batcher->arg_count; ++i) {
+    iree_hal_buffer_view_t* first_view = NULL;
+    for (iree_host_size_t j = 0; j < count; ++j) {
+      iree_hal_buffer_view_t* view = iree_vm_list_get_buffer_view_assign(
+          batcher->executing[j].inputs, i);
+      if (!view) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "argument %" PRIhsz " is not a buffer view",
+                                i);
+      }
+      if (!first_view) first_view = view;
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_runtime_batcher_verify_row(i, first_view, view));
+    }
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_runtime_batcher_ensure_arg_storage(
+                batcher, &batcher->args[i],
+                iree_hal_buffer_view_byte_length(first_view)));
+  }
+
+  // Record all row copies into a single command buffer so that the batch is
+  // gathered with one submission.
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_command_buffer_create(
+              device,
+              IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+                  IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
+              IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+              /*binding_capacity=*/0, &command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+  for (iree_host_size_t i = 0; i < batcher->arg_count; ++i) {
+    iree_runtime_batcher_arg_t* arg = &batcher->args[i];
+    for (iree_host_size_t j = 0; j < count && iree_status_is_ok(status); ++j) {
+      iree_hal_buffer_view_t* view = iree_vm_list_get_buffer_view_assign(
+          batcher->executing[j].inputs, i);
+      status = iree_hal_command_buffer_copy_buffer(
+          command_buffer, iree_hal_buffer_view_buffer(view), 0, arg->buffer,
+          j * arg->row_size, arg->row_size);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+
+  // Submit and wait for the copies to complete.
+  iree_hal_semaphore_t* semaphore = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(device, 0ull, &semaphore);
+  }
+  if (iree_status_is_ok(status)) {
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        .count = 1,
+        .semaphores = &semaphore,
+        .payload_values = &signal_value,
+    };
+    status = iree_hal_device_queue_execute(
+        device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, 1, &command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout());
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+
+  // Wrap the first |count| rows of each batch buffer in views with the batch
+  // dimension set to the number of requests.
+  for (iree_host_size_t i = 0;
+       i < batcher->arg_count && iree_status_is_ok(status); ++i) {
+    iree_runtime_batcher_arg_t* arg = &batcher->args[i];
+    iree_hal_buffer_view_t* first_view =
+        iree_vm_list_get_buffer_view_assign(batcher->executing[0].inputs, i);
+    iree_host_size_t rank = iree_hal_buffer_view_shape_rank(first_view);
+    iree_hal_dim_t* shape =
+        (iree_hal_dim_t*)iree_alloca(rank * sizeof(iree_hal_dim_t));
+    memcpy(shape, iree_hal_buffer_view_shape_dims(first_view),
+           rank * sizeof(iree_hal_dim_t));
+    shape[0] = (iree_hal_dim_t)count;
+    iree_hal_buffer_t* rows = NULL;
+    status = iree_hal_buffer_subspan(arg->buffer, 0, count * arg->row_size,
+                                     &rows);
+    iree_hal_buffer_view_t* batch_view = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_view_create(
+          rows, rank, shape, iree_hal_buffer_view_element_type(first_view),
+          iree_hal_buffer_view_encoding_type(first_view),
+          batcher->host_allocator, &batch_view);
+    }
+    iree_hal_buffer_release(rows);
+    if (iree_status_is_ok(status)) {
+      iree_vm_ref_t batch_view_ref = iree_hal_buffer_view_move_ref(batch_view);
+      status = iree_vm_list_push_ref_move(batcher->batch_inputs,
+                                          &batch_view_ref);
+      iree_vm_ref_release(&batch_view_ref);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Splits each batched result into per-request views of the corresponding row
+// and appends them to the request outputs.
+static iree_status_t iree_runtime_batcher_scatter(
+    iree_runtime_batcher_t* batcher, iree_host_size_t count) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < batcher->result_count && iree_status_is_ok(status); ++i) {
+    iree_hal_buffer_view_t* batch_view =
+        iree_vm_list_get_buffer_view_assign(batcher->batch_outputs, i);
+    iree_host_size_t rank =
+        batch_view ? iree_hal_buffer_view_shape_rank(batch_view) : 0;
+    if (rank == 0 || iree_hal_buffer_view_shape_dim(batch_view, 0) != count) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "result %" PRIhsz
+                                " is not a buffer view with an outermost "
+                                "batch dimension of %" PRIhsz,
+                                i, count);
+      break;
+    }
+    iree_device_size_t row_size =
+        iree_hal_buffer_view_byte_length(batch_view) / count;
+    iree_hal_dim_t* shape =
+        (iree_hal_dim_t*)iree_alloca(rank * sizeof(iree_hal_dim_t));
+    memcpy(shape, iree_hal_buffer_view_shape_dims(batch_view),
+           rank * sizeof(iree_hal_dim_t));
+    shape[0] = 1;
+    for (iree_host_size_t j = 0; j < count && iree_status_is_ok(status); ++j) {
+      // The row retains the batch result buffer until the request releases it.
+      iree_hal_buffer_t* row = NULL;
+      status = iree_hal_buffer_subspan(iree_hal_buffer_view_buffer(batch_view),
+                                       j * row_size, row_size, &row);
+      iree_hal_buffer_view_t* row_view = NULL;
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_buffer_view_create(
+            row, rank, shape, iree_hal_buffer_view_element_type(batch_view),
+            iree_hal_buffer_view_encoding_type(batch_view),
+            batcher->host_allocator, &row_view);
+      }
+      iree_hal_buffer_release(row);
+      if (iree_status_is_ok(status)) {
+        iree_vm_ref_t row_view_ref = iree_hal_buffer_view_move_ref(row_view);
+        status = iree_vm_list_push_ref_move(batcher->executing[j].outputs,
+                                            &row_view_ref);
+        iree_vm_ref_release(&row_view_ref);
+      }
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Executes the first |count| executing requests as a single batch and
+// completes their fences. Requires the execute mutex to be held.
+static iree_status_t iree_runtime_batcher_execute(
+    iree_runtime_batcher_t* batcher, iree_host_size_t count) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)count);
+
+  iree_status_t batch_status = iree_runtime_batcher_gather(batcher, count);
+  if (iree_status_is_ok(batch_status)) {
+    batch_status = iree_runtime_session_call(
+        batcher->session, &batcher->function, batcher->batch_inputs,
+        batcher->batch_outputs);
+  }
+  if (iree_status_is_ok(batch_status)) {
+    batch_status = iree_runtime_batcher_scatter(batcher, count);
+  }
+
+  // Drop our references to the batch results; request outputs retain the
+  // rows they reference.
+  iree_vm_list_clear(batcher->batch_inputs);
+  iree_vm_list_clear(batcher->batch_outputs);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_runtime_batcher_request_t* request = &batcher->executing[i];
+    if (iree_status_is_ok(batch_status)) {
+      status = iree_status_join(status,
+                                iree_hal_fence_signal(request->signal_fence));
+    } else {
+      iree_vm_list_clear(request->outputs);
+      iree_hal_fence_fail(request->signal_fence,
+                          iree_status_clone(batch_status));
+    }
+    iree_hal_fence_release(request->signal_fence);
+    iree_vm_list_release(request->inputs);
+    iree_vm_list_release(request->outputs);
+  }
+  memset(batcher->executing, 0, count * sizeof(batcher->executing[0]));
+  iree_status_ignore(batch_status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Executes the pending requests if |force| is set or the oldest pending
+// request has waited for the maximum delay.
+static iree_status_t iree_runtime_batcher_execute_pending(
+    iree_runtime_batcher_t* batcher, bool force) {
+  iree_slim_mutex_lock(&batcher->execute_mutex);
+
+  iree_slim_mutex_lock(&batcher->queue_mutex);
+  iree_host_size_t count = batcher->pending_count;
+  if (count > 0 && !force &&
+      iree_time_now() <
+          batcher->pending[0].submit_time_ns + batcher->options.max_delay_ns) {
+    count = 0;
+  }
+  if (count > 0) {
+    memcpy(batcher->executing, batcher->pending,
+           count * sizeof(batcher->pending[0]));
+    batcher->pending_count = 0;
+  }
+  iree_slim_mutex_unlock(&batcher->queue_mutex);
+
+  iree_status_t status = iree_ok_status();
+  if (count > 0) {
+    status = iree_runtime_batcher_execute(batcher, count);
+  }
+
+  iree_slim_mutex_unlock(&batcher->execute_mutex);
+  return status;
+}
+
+static void iree_runtime_batcher_destroy(iree_runtime_batcher_t* batcher) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = batcher->host_allocator;
+
+  // Complete any requests still waiting so that their fences are reached.
+  if (batcher->batch_inputs && batcher->batch_outputs) {
+    IREE_IGNORE_ERROR(
+        iree_runtime_batcher_execute_pending(batcher, /*force=*/true));
+  }
+
+  for (iree_host_size_t i = 0; i < batcher->arg_count; ++i) {
+    iree_hal_buffer_release(batcher->args[i].buffer);
+  }
+  iree_vm_list_release(batcher->batch_inputs);
+  iree_vm_list_release(batcher->batch_outputs);
+  iree_slim_mutex_deinitialize(&batcher->execute_mutex);
+  iree_slim_mutex_deinitialize(&batcher->queue_mutex);
+  iree_runtime_session_release(batcher->session);
+  iree_allocator_free(host_allocator, batcher);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_submit(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_vm_list_t* outputs, iree_hal_fence_t* signal_fence) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  IREE_ASSERT_ARGUMENT(inputs);
+  IREE_ASSERT_ARGUMENT(outputs);
+  IREE_ASSERT_ARGUMENT(signal_fence);
+  if (iree_vm_list_size(inputs) != batcher->arg_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "request has %" PRIhsz
+                            " inputs but the batched function takes %" PRIhsz,
+                            iree_vm_list_size(inputs), batcher->arg_count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (;;) {
+    iree_slim_mutex_lock(&batcher->queue_mutex);
+    if (batcher->pending_count < batcher->options.max_batch_size) {
+      iree_runtime_batcher_request_t* request =
+          &batcher->pending[batcher->pending_count++];
+      request->inputs = inputs;
+      iree_vm_list_retain(inputs);
+      request->outputs = outputs;
+      iree_vm_list_retain(outputs);
+      request->signal_fence = signal_fence;
+      iree_hal_fence_retain(signal_fence);
+      request->submit_time_ns = iree_time_now();
+      bool is_full =
+          batcher->pending_count == batcher->options.max_batch_size;
+      iree_slim_mutex_unlock(&batcher->queue_mutex);
+      iree_status_t status = iree_ok_status();
+      if (is_full) {
+        status = iree_runtime_batcher_execute_pending(batcher, /*force=*/true);
+      }
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_slim_mutex_unlock(&batcher->queue_mutex);
+
+    // Another thread filled the batch and has not yet taken it for execution;
+    // help drain it before trying again.
+    iree_status_t status =
+        iree_runtime_batcher_execute_pending(batcher, /*force=*/true);
+    if (!iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+  }
+}
+
+IREE_API_EXPORT iree_time_t
+iree_runtime_batcher_deadline(iree_runtime_batcher_t* batcher) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  iree_slim_mutex_lock(&batcher->queue_mutex);
+  iree_time_t deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  if (batcher->pending_count > 0) {
+    deadline_ns =
+        batcher->pending[0].submit_time_ns + batcher->options.max_delay_ns;
+  }
+  iree_slim_mutex_unlock(&batcher->queue_mutex);
+  return deadline_ns;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_runtime_batcher_poll(iree_runtime_batcher_t* batcher) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  return iree_runtime_batcher_execute_pending(batcher, /*force=*/false);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_runtime_batcher_flush(iree_runtime_batcher_t* batcher) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  return iree_runtime_batcher_execute_pending(batcher, /*force=*/true);
+}
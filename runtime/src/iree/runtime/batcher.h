@@ -0,0 +1,117 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_RUNTIME_BATCHER_H_
+#define IREE_RUNTIME_BATCHER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_runtime_session_t iree_runtime_session_t;
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_options_t
+//===----------------------------------------------------------------------===//
+
+// Options used to configure batcher creation.
+typedef struct iree_runtime_batcher_options_t {
+  // Maximum number of requests gathered into a single batch. A batch is
+  // executed as soon as it is full.
+  iree_host_size_t max_batch_size;
+  // Maximum duration the oldest pending request waits for others to arrive
+  // before its batch is executed by iree_runtime_batcher_poll.
+  iree_duration_t max_delay_ns;
+} iree_runtime_batcher_options_t;
+
+// Initializes |out_options| to its default values.
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options);
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+// Gathers single requests into batches executed with one invocation.
+//
+// The batched function must be batch-polymorphic: every argument and result
+// is a buffer view whose outermost dimension is the batch dimension and that
+// dimension is dynamic. Each request provides arguments with an outermost
+// dimension of 1 and all other dimensions and element types matching the
+// other requests in the batch. Inputs are copied into batch buffers allocated
+// once for |max_batch_size| requests and reused across batches. Each request
+// receives results that are views into row N of the batched results so that
+// no copies are required on the way out.
+//
+// The batched function must complete synchronously (that is, not use the
+// coarse-fences ABI) as the batch input buffers are reused once it returns.
+//
+// A batch is executed when it fills up during iree_runtime_batcher_submit or
+// when the oldest request has waited |max_delay_ns| as observed by
+// iree_runtime_batcher_poll. The batcher owns no threads: serving loops are
+// expected to poll no later than iree_runtime_batcher_deadline. Batches are
+// executed on the thread that triggers them.
+//
+// Thread-safe; requests may be submitted and batches flushed from any thread.
+// Batches are executed one at a time and the batcher must be the only user of
+// |session| while it is live.
+typedef struct iree_runtime_batcher_t iree_runtime_batcher_t;
+
+// Creates a batcher invoking |function| within |session| for each batch.
+// |out_batcher| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher);
+
+// Retains the given |batcher| for the caller.
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher);
+
+// Releases the given |batcher| from the caller.
+// Any pending requests are executed prior to destruction.
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher);
+
+// Submits a request with the buffer views in |inputs|. Once the batch
+// containing the request completes |outputs| is populated with the request
+// results and |signal_fence| is signaled. If the batch fails the fence is
+// failed with the batch status.
+//
+// |inputs| and |outputs| are retained until the request completes and callers
+// must not access |outputs| until |signal_fence| has been reached. Returns an
+// error only if the request could not be queued; batch execution failures are
+// routed to the fences of the requests in the batch.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_submit(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_vm_list_t* outputs, iree_hal_fence_t* signal_fence);
+
+// Returns the time by which iree_runtime_batcher_poll must be called for
+// pending requests to meet the configured delay or IREE_TIME_INFINITE_FUTURE
+// if no requests are pending.
+IREE_API_EXPORT iree_time_t
+iree_runtime_batcher_deadline(iree_runtime_batcher_t* batcher);
+
+// Executes the pending batch if the oldest request in it has waited for the
+// maximum delay. Returns an error only if the batch could not be executed.
+IREE_API_EXPORT iree_status_t
+iree_runtime_batcher_poll(iree_runtime_batcher_t* batcher);
+
+// Executes all pending requests regardless of how long they have waited.
+IREE_API_EXPORT iree_status_t
+iree_runtime_batcher_flush(iree_runtime_batcher_t* batcher);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_RUNTIME_BATCHER_H_
@@ -71,6 +71,7 @@ IREE_API_EXPORT void iree_runtime_call_deinitialize(iree_runtime_call_t* call) {
   IREE_ASSERT_ARGUMENT(call);
   iree_vm_list_release(call->inputs);
   iree_vm_list_release(call->outputs);
+  iree_vm_context_release(call->state);
   iree_runtime_session_release(call->session);
 }
 
@@ -80,6 +81,14 @@ IREE_API_EXPORT void iree_runtime_call_reset(iree_runtime_call_t* call) {
   iree_status_ignore(iree_vm_list_resize(call->outputs, 0));
 }
 
+IREE_API_EXPORT void iree_runtime_call_set_state(iree_runtime_call_t* call,
+                                                 iree_vm_context_t* state) {
+  IREE_ASSERT_ARGUMENT(call);
+  iree_vm_context_retain(state);
+  iree_vm_context_release(call->state);
+  call->state = state;
+}
+
 IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_inputs(
     const iree_runtime_call_t* call) {
   IREE_ASSERT_ARGUMENT(call);
@@ -94,8 +103,83 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
 
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags) {
-  return iree_runtime_session_call(call->session, &call->function, call->inputs,
-                                   call->outputs);
+  return iree_runtime_session_call_with_state(call->session, call->state,
+                                              &call->function, call->inputs,
+                                              call->outputs);
+}
+
+static iree_status_t iree_runtime_call_async_complete(void* user_data,
+                                                      iree_loop_t loop,
+                                                      iree_status_t status,
+                                                      iree_vm_list_t* outputs) {
+  iree_runtime_call_t* call = (iree_runtime_call_t*)user_data;
+
+  // The async invocation retains the outputs for us but the call still holds
+  // its own reference.
+  iree_vm_list_release(outputs);
+
+  iree_hal_fence_t* signal_fence = call->async.signal_fence;
+  iree_runtime_call_callback_fn_t callback = call->async.callback;
+  void* callback_user_data = call->async.user_data;
+  call->async.signal_fence = NULL;
+  call->async.callback = NULL;
+  call->async.user_data = NULL;
+
+  iree_status_t signal_status = iree_ok_status();
+  if (signal_fence) {
+    if (iree_status_is_ok(status)) {
+      signal_status = iree_hal_fence_signal(signal_fence);
+    } else {
+      iree_hal_fence_fail(signal_fence, iree_status_clone(status));
+    }
+    iree_hal_fence_release(signal_fence);
+  }
+
+  // NOTE: the call may be deinitialized by the callback.
+  if (callback) {
+    status = callback(callback_user_data, loop, status, call);
+  } else {
+    // The failure has been routed to the fence, if any, and the loop scope
+    // should not be failed for it.
+    iree_status_ignore(status);
+    status = iree_ok_status();
+  }
+  if (!iree_status_is_ok(signal_status)) {
+    iree_status_ignore(status);
+    status = signal_status;
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_hal_fence_t* signal_fence,
+    iree_runtime_call_callback_fn_t callback, void* user_data) {
+  IREE_ASSERT_ARGUMENT(call);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  call->async.signal_fence = signal_fence;
+  iree_hal_fence_retain(signal_fence);
+  call->async.callback = callback;
+  call->async.user_data = user_data;
+
+  // NOTE: this may complete the call before returning.
+  iree_status_t status = iree_vm_async_invoke(
+      loop, &call->async.state,
+      call->state ? call->state : iree_runtime_session_context(call->session),
+      call->function, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL,
+      call->inputs, call->outputs,
+      iree_runtime_session_host_allocator(call->session),
+      iree_runtime_call_async_complete, call);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_fence_release(call->async.signal_fence);
+    call->async.signal_fence = NULL;
+    call->async.callback = NULL;
+    call->async.user_data = NULL;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 //===----------------------------------------------------------------------===//
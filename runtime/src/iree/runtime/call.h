@@ -18,6 +18,7 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_runtime_session_t iree_runtime_session_t;
+typedef struct iree_runtime_call_t iree_runtime_call_t;
 
 //===----------------------------------------------------------------------===//
 // iree_runtime_call_t
@@ -32,6 +33,16 @@ enum iree_runtime_call_flag_bits_t {
 };
 typedef uint32_t iree_runtime_call_flags_t;
 
+// Callback notifying the caller of iree_runtime_call_invoke_async that the
+// |call| has completed. If |status| is OK the call outputs contain the results.
+//
+// This is executed from within a |loop| context and must not block. The
+// callback takes ownership of |status| and the returned status is propagated
+// to the loop scope.
+typedef iree_status_t(IREE_API_PTR* iree_runtime_call_callback_fn_t)(
+    void* user_data, iree_loop_t loop, iree_status_t status,
+    iree_runtime_call_t* call);
+
 // A stateful VM function call builder.
 //
 // Applications that will be calling the same function repeatedly can reuse the
@@ -46,8 +57,18 @@ typedef uint32_t iree_runtime_call_flags_t;
 typedef struct iree_runtime_call_t {
   iree_runtime_session_t* session;
   iree_vm_function_t function;
+  // Optional session state selected with iree_runtime_call_set_state.
+  iree_vm_context_t* state;
   iree_vm_list_t* inputs;
   iree_vm_list_t* outputs;
+
+  // State of an in-flight iree_runtime_call_invoke_async, if any.
+  struct {
+    iree_vm_async_invoke_state_t state;
+    iree_hal_fence_t* signal_fence;
+    iree_runtime_call_callback_fn_t callback;
+    void* user_data;
+  } async;
 } iree_runtime_call_t;
 
 // Initializes call state for a call to |function| within |session|.
@@ -75,6 +96,13 @@ IREE_API_EXPORT void iree_runtime_call_deinitialize(iree_runtime_call_t* call);
 // construction of another call.
 IREE_API_EXPORT void iree_runtime_call_reset(iree_runtime_call_t* call);
 
+// Selects the session |state| the call is invoked against, such as one created
+// with iree_runtime_session_fork_state. NULL selects the session state.
+// The state is retained by the call until replaced or the call is
+// deinitialized. Must not be changed while an async invocation is in-flight.
+IREE_API_EXPORT void iree_runtime_call_set_state(iree_runtime_call_t* call,
+                                                 iree_vm_context_t* state);
+
 // Returns an initially-empty variant list for passing in function inputs.
 // The list must be fully populated based on the required arguments of the
 // function.
@@ -92,6 +120,27 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags);
 
+// Asynchronously invokes the call on |loop| and returns immediately.
+//
+// The invocation runs on the loop and is suspended whenever it waits, such as
+// on HAL fences, and then resumed by the loop once the wait is satisfied.
+// This lets a single thread driving |loop| multiplex many in-flight calls.
+// Concurrent calls into the same session require the session context to be
+// created with IREE_VM_CONTEXT_FLAG_CONCURRENT.
+//
+// When the call completes the optional |signal_fence| is signaled, or failed
+// with the call status, and then the optional |callback| is issued. Callers
+// can wait on the fence to join the result with other device work or use it
+// as a future. Either may be issued before this function returns, such as
+// when using an inline loop.
+//
+// The call must remain live and must not be modified until completion. The
+// inputs list remains unchanged and the outputs list receives the results.
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_hal_fence_t* signal_fence,
+    iree_runtime_call_callback_fn_t callback, void* user_data);
+
 //===----------------------------------------------------------------------===//
 // Helpers for defining call I/O
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,521 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/kv_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_kv_cache_options_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_runtime_kv_cache_options_initialize(
+    iree_runtime_kv_cache_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->block_tokens = 16;
+  out_options->queue_affinity = IREE_HAL_QUEUE_AFFINITY_ANY;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_kv_cache_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_runtime_kv_cache_sequence_t {
+  bool is_live;
+  // Number of tokens stored in the sequence.
+  iree_host_size_t token_count;
+  // Number of valid entries in the sequence block table.
+  iree_host_size_t block_count;
+} iree_runtime_kv_cache_sequence_t;
+
+struct iree_runtime_kv_cache_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_hal_device_t* device;
+  iree_runtime_kv_cache_options_t options;
+  iree_device_size_t block_byte_length;
+
+  // Block pool allocated with queue_alloca and a view of it for programs.
+  iree_hal_buffer_t* pool_buffer;
+  iree_hal_buffer_view_t* pool_view;
+
+  // Device storage for uploaded block tables followed by sequence lengths.
+  iree_hal_buffer_t* table_buffer;
+
+  iree_runtime_kv_cache_sequence_t* sequences;  // [max_sequence_count]
+  // Block tables of all sequences with max_blocks_per_sequence entries each.
+  int32_t* block_tables;  // [max_sequence_count * max_blocks_per_sequence]
+  // Number of sequences referencing each block.
+  uint32_t* block_ref_counts;  // [block_count]
+  // Stack of unreferenced block indices.
+  iree_host_size_t free_block_count;
+  uint32_t* free_blocks;  // [block_count]
+  // Host staging for block table uploads in the same layout as the device
+  // table storage.
+  int32_t* upload_staging;  // [max_sequence_count * (max_blocks + 1)]
+};
+
+static void iree_runtime_kv_cache_destroy(iree_runtime_kv_cache_t* cache);
+
+// Allocates |allocation_size| bytes of pool storage in queue order and waits
+// for it to become available.
+static iree_status_t iree_runtime_kv_cache_alloca_pool(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphores = {
+      .count = 1,
+      .semaphores = &semaphore,
+      .payload_values = &signal_value,
+  };
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+      .queue_affinity = queue_affinity,
+  };
+  iree_status_t status = iree_hal_device_queue_alloca(
+      device, queue_affinity, iree_hal_semaphore_list_empty(),
+      signal_semaphores, IREE_HAL_ALLOCATOR_POOL_DEFAULT, params,
+      allocation_size, out_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                     iree_infinite_timeout());
+  }
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_create(
+    iree_hal_device_t* device, const iree_runtime_kv_cache_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_kv_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!options->elements_per_token || !options->block_tokens ||
+      !options->block_count || !options->max_sequence_count ||
+      !options->max_blocks_per_sequence) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "KV-cache sizes must all be non-zero");
+  }
+  if (options->block_count > INT32_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "block count %" PRIhsz
+                            " exceeds the range of the i32 block table",
+                            options->block_count);
+  }
+
+  iree_host_size_t sequence_count = options->max_sequence_count;
+  iree_host_size_t table_entry_count =
+      sequence_count * options->max_blocks_per_sequence;
+  iree_host_size_t total_size =
+      sizeof(iree_runtime_kv_cache_t) +
+      sequence_count * sizeof(iree_runtime_kv_cache_sequence_t) +
+      table_entry_count * sizeof(int32_t) +
+      2 * options->block_count * sizeof(uint32_t) +
+      (table_entry_count + sequence_count) * sizeof(int32_t);
+  iree_runtime_kv_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&cache));
+  iree_atomic_ref_count_init(&cache->ref_count);
+  cache->host_allocator = host_allocator;
+  cache->device = device;
+  iree_hal_device_retain(device);
+  cache->options = *options;
+  cache->block_byte_length =
+      (iree_device_size_t)options->block_tokens * options->elements_per_token *
+      iree_hal_element_dense_byte_count(options->element_type);
+
+  uint8_t* storage = (uint8_t*)(cache + 1);
+  cache->sequences = (iree_runtime_kv_cache_sequence_t*)storage;
+  storage += sequence_count * sizeof(cache->sequences[0]);
+  cache->block_tables = (int32_t*)storage;
+  storage += table_entry_count * sizeof(cache->block_tables[0]);
+  cache->block_ref_counts = (uint32_t*)storage;
+  storage += options->block_count * sizeof(cache->block_ref_counts[0]);
+  cache->free_blocks = (uint32_t*)storage;
+  storage += options->block_count * sizeof(cache->free_blocks[0]);
+  cache->upload_staging = (int32_t*)storage;
+
+  // Push blocks in reverse so that they are handed out in ascending order.
+  cache->free_block_count = options->block_count;
+  for (iree_host_size_t i = 0; i < options->block_count; ++i) {
+    cache->free_blocks[i] = (uint32_t)(options->block_count - 1 - i);
+  }
+
+  iree_status_t status = iree_runtime_kv_cache_alloca_pool(
+      device, options->queue_affinity,
+      cache->block_byte_length * options->block_count, &cache->pool_buffer);
+  if (iree_status_is_ok(status)) {
+    const iree_hal_dim_t shape[3] = {
+        (iree_hal_dim_t)options->block_count,
+        (iree_hal_dim_t)options->block_tokens,
+        (iree_hal_dim_t)options->elements_per_token,
+    };
+    status = iree_hal_buffer_view_create(
+        cache->pool_buffer, IREE_ARRAYSIZE(shape), shape, options->element_type,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, host_allocator,
+        &cache->pool_view);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_params_t params = {
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+        .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+        .queue_affinity = options->queue_affinity,
+    };
+    status = iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device), params,
+        (table_entry_count + sequence_count) * sizeof(int32_t),
+        &cache->table_buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_cache = cache;
+  } else {
+    iree_runtime_kv_cache_release(cache);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_runtime_kv_cache_destroy(iree_runtime_kv_cache_t* cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = cache->host_allocator;
+
+  iree_hal_buffer_release(cache->table_buffer);
+  iree_hal_buffer_view_release(cache->pool_view);
+  if (cache->pool_buffer) {
+    // Programs using the pool must have completed before the cache is
+    // released and the deallocation need not wait on anything.
+    IREE_IGNORE_ERROR(iree_hal_device_queue_dealloca(
+        cache->device, cache->options.queue_affinity,
+        iree_hal_semaphore_list_empty(), iree_hal_semaphore_list_empty(),
+        cache->pool_buffer));
+    iree_hal_buffer_release(cache->pool_buffer);
+  }
+  iree_hal_device_release(cache->device);
+  iree_allocator_free(host_allocator, cache);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_runtime_kv_cache_retain(
+    iree_runtime_kv_cache_t* cache) {
+  if (cache) {
+    iree_atomic_ref_count_inc(&cache->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_runtime_kv_cache_release(
+    iree_runtime_kv_cache_t* cache) {
+  if (cache && iree_atomic_ref_count_dec(&cache->ref_count) == 1) {
+    iree_runtime_kv_cache_destroy(cache);
+  }
+}
+
+IREE_API_EXPORT iree_hal_buffer_view_t* iree_runtime_kv_cache_pool(
+    iree_runtime_kv_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  return cache->pool_view;
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_runtime_kv_cache_free_block_count(iree_runtime_kv_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  return cache->free_block_count;
+}
+
+// Returns the block table of |sequence_id|.
+static int32_t* iree_runtime_kv_cache_sequence_blocks(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id) {
+  return &cache->block_tables[sequence_id *
+                              cache->options.max_blocks_per_sequence];
+}
+
+// Returns the sequence with |sequence_id| or NULL if it is not live.
+static iree_runtime_kv_cache_sequence_t* iree_runtime_kv_cache_lookup(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id) {
+  if (sequence_id >= cache->options.max_sequence_count) return NULL;
+  iree_runtime_kv_cache_sequence_t* sequence = &cache->sequences[sequence_id];
+  return sequence->is_live ? sequence : NULL;
+}
+
+static iree_status_t iree_runtime_kv_cache_lookup_or_fail(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id,
+    iree_runtime_kv_cache_sequence_t** out_sequence) {
+  *out_sequence = iree_runtime_kv_cache_lookup(cache, sequence_id);
+  if (!*out_sequence) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "sequence %u is not live in the KV-cache",
+                            sequence_id);
+  }
+  return iree_ok_status();
+}
+
+// Claims an unused sequence slot.
+static iree_status_t iree_runtime_kv_cache_claim_sequence(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t* out_sequence_id) {
+  for (iree_host_size_t i = 0; i < cache->options.max_sequence_count; ++i) {
+    iree_runtime_kv_cache_sequence_t* sequence = &cache->sequences[i];
+    if (sequence->is_live) continue;
+    memset(sequence, 0, sizeof(*sequence));
+    sequence->is_live = true;
+    *out_sequence_id = (iree_runtime_kv_cache_sequence_id_t)i;
+    return iree_ok_status();
+  }
+  return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                          "all %" PRIhsz " KV-cache sequences are live",
+                          cache->options.max_sequence_count);
+}
+
+static uint32_t iree_runtime_kv_cache_acquire_block(
+    iree_runtime_kv_cache_t* cache) {
+  uint32_t block = cache->free_blocks[--cache->free_block_count];
+  cache->block_ref_counts[block] = 1;
+  return block;
+}
+
+static void iree_runtime_kv_cache_release_block(iree_runtime_kv_cache_t* cache,
+                                                uint32_t block) {
+  if (--cache->block_ref_counts[block] == 0) {
+    cache->free_blocks[cache->free_block_count++] = block;
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_create(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t* out_sequence_id) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_sequence_id);
+  return iree_runtime_kv_cache_claim_sequence(cache, out_sequence_id);
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_fork(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t parent_id,
+    iree_runtime_kv_cache_sequence_id_t* out_sequence_id) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_sequence_id);
+  iree_runtime_kv_cache_sequence_t* parent = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_runtime_kv_cache_lookup_or_fail(cache, parent_id, &parent));
+  iree_runtime_kv_cache_sequence_id_t child_id = 0;
+  IREE_RETURN_IF_ERROR(iree_runtime_kv_cache_claim_sequence(cache, &child_id));
+  iree_runtime_kv_cache_sequence_t* child = &cache->sequences[child_id];
+  child->token_count = parent->token_count;
+  child->block_count = parent->block_count;
+  const int32_t* parent_blocks =
+      iree_runtime_kv_cache_sequence_blocks(cache, parent_id);
+  int32_t* child_blocks =
+      iree_runtime_kv_cache_sequence_blocks(cache, child_id);
+  for (iree_host_size_t i = 0; i < parent->block_count; ++i) {
+    child_blocks[i] = parent_blocks[i];
+    ++cache->block_ref_counts[parent_blocks[i]];
+  }
+  *out_sequence_id = child_id;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void iree_runtime_kv_cache_sequence_release(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id) {
+  IREE_ASSERT_ARGUMENT(cache);
+  iree_runtime_kv_cache_sequence_t* sequence =
+      iree_runtime_kv_cache_lookup(cache, sequence_id);
+  if (!sequence) return;
+  const int32_t* blocks =
+      iree_runtime_kv_cache_sequence_blocks(cache, sequence_id);
+  for (iree_host_size_t i = 0; i < sequence->block_count; ++i) {
+    iree_runtime_kv_cache_release_block(cache, (uint32_t)blocks[i]);
+  }
+  memset(sequence, 0, sizeof(*sequence));
+}
+
+IREE_API_EXPORT iree_host_size_t iree_runtime_kv_cache_sequence_length(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id) {
+  IREE_ASSERT_ARGUMENT(cache);
+  iree_runtime_kv_cache_sequence_t* sequence =
+      iree_runtime_kv_cache_lookup(cache, sequence_id);
+  return sequence ? sequence->token_count : 0;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_append(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id,
+    iree_host_size_t token_count) {
+  IREE_ASSERT_ARGUMENT(cache);
+  iree_runtime_kv_cache_sequence_t* sequence = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_runtime_kv_cache_lookup_or_fail(cache, sequence_id, &sequence));
+  if (!token_count) return iree_ok_status();
+
+  const iree_host_size_t block_tokens = cache->options.block_tokens;
+  iree_host_size_t new_token_count = sequence->token_count + token_count;
+  iree_host_size_t new_block_count =
+      iree_host_size_ceil_div(new_token_count, block_tokens);
+  if (new_block_count > cache->options.max_blocks_per_sequence) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "sequence %u length %" PRIhsz
+                            " exceeds the maximum of %" PRIhsz " tokens",
+                            sequence_id, new_token_count,
+                            cache->options.max_blocks_per_sequence *
+                                block_tokens);
+  }
+
+  // A partially filled last block shared with a fork must be copied before
+  // new tokens are written to it.
+  int32_t* blocks = iree_runtime_kv_cache_sequence_blocks(cache, sequence_id);
+  bool needs_copy =
+      sequence->token_count % block_tokens != 0 &&
+      cache->block_ref_counts[blocks[sequence->block_count - 1]] > 1;
+  iree_host_size_t required_blocks =
+      new_block_count - sequence->block_count + (needs_copy ? 1 : 0);
+  if (required_blocks > cache->free_block_count) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "KV-cache requires %" PRIhsz
+                            " blocks but only %" PRIhsz " are free",
+                            required_blocks, cache->free_block_count);
+  }
+
+  if (needs_copy) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_runtime_kv_cache_copy_on_write");
+    uint32_t shared_block = (uint32_t)blocks[sequence->block_count - 1];
+    uint32_t new_block = iree_runtime_kv_cache_acquire_block(cache);
+    iree_status_t status = iree_hal_device_transfer_d2d(
+        cache->device, cache->pool_buffer,
+        shared_block * cache->block_byte_length, cache->pool_buffer,
+        new_block * cache->block_byte_length, cache->block_byte_length,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout());
+    if (!iree_status_is_ok(status)) {
+      iree_runtime_kv_cache_release_block(cache, new_block);
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_runtime_kv_cache_release_block(cache, shared_block);
+    blocks[sequence->block_count - 1] = (int32_t)new_block;
+    IREE_TRACE_ZONE_END(z0);
+  }
+
+  while (sequence->block_count < new_block_count) {
+    blocks[sequence->block_count++] =
+        (int32_t)iree_runtime_kv_cache_acquire_block(cache);
+  }
+  sequence->token_count = new_token_count;
+  return iree_ok_status();
+}
+
+// Creates a view of |shape| i32 elements at |byte_offset| of the table buffer.
+static iree_status_t iree_runtime_kv_cache_table_view(
+    iree_runtime_kv_cache_t* cache, iree_device_size_t byte_offset,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_buffer_view_t** out_view) {
+  iree_device_size_t element_count = 1;
+  for (iree_host_size_t i = 0; i < shape_rank; ++i) element_count *= shape[i];
+  iree_hal_buffer_t* subspan = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_subspan(cache->table_buffer, byte_offset,
+                              element_count * sizeof(int32_t), &subspan));
+  iree_status_t status = iree_hal_buffer_view_create(
+      subspan, shape_rank, shape, IREE_HAL_ELEMENT_TYPE_INT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, cache->host_allocator, out_view);
+  iree_hal_buffer_release(subspan);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_upload_block_tables(
+    iree_runtime_kv_cache_t* cache, iree_host_size_t sequence_count,
+    const iree_runtime_kv_cache_sequence_id_t* sequence_ids,
+    iree_hal_buffer_view_t** out_block_table,
+    iree_hal_buffer_view_t** out_lengths) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(!sequence_count || sequence_ids);
+  IREE_ASSERT_ARGUMENT(out_block_table);
+  IREE_ASSERT_ARGUMENT(out_lengths);
+  *out_block_table = NULL;
+  *out_lengths = NULL;
+  if (sequence_count > cache->options.max_sequence_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "%" PRIhsz
+                            " sequences exceed the maximum of %" PRIhsz,
+                            sequence_count, cache->options.max_sequence_count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Pack the tables followed by the lengths so they upload in one transfer.
+  const iree_host_size_t max_blocks = cache->options.max_blocks_per_sequence;
+  int32_t* tables = cache->upload_staging;
+  int32_t* lengths = tables + sequence_count * max_blocks;
+  memset(tables, 0, sequence_count * max_blocks * sizeof(int32_t));
+  for (iree_host_size_t i = 0; i < sequence_count; ++i) {
+    iree_runtime_kv_cache_sequence_t* sequence = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_runtime_kv_cache_lookup_or_fail(cache, sequence_ids[i],
+                                                 &sequence));
+    memcpy(&tables[i * max_blocks],
+           iree_runtime_kv_cache_sequence_blocks(cache, sequence_ids[i]),
+           sequence->block_count * sizeof(int32_t));
+    lengths[i] = (int32_t)sequence->token_count;
+  }
+  iree_device_size_t tables_length =
+      sequence_count * max_blocks * sizeof(int32_t);
+  iree_device_size_t lengths_length = sequence_count * sizeof(int32_t);
+  if (tables_length + lengths_length > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_device_transfer_h2d(
+                cache->device, cache->upload_staging, cache->table_buffer, 0,
+                tables_length + lengths_length,
+                IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+                iree_infinite_timeout()));
+  }
+
+  const iree_hal_dim_t table_shape[2] = {(iree_hal_dim_t)sequence_count,
+                                         (iree_hal_dim_t)max_blocks};
+  const iree_hal_dim_t lengths_shape[1] = {(iree_hal_dim_t)sequence_count};
+  iree_status_t status = iree_runtime_kv_cache_table_view(
+      cache, 0, IREE_ARRAYSIZE(table_shape), table_shape, out_block_table);
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_kv_cache_table_view(
+        cache, tables_length, IREE_ARRAYSIZE(lengths_shape), lengths_shape,
+        out_lengths);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_view_release(*out_block_table);
+    *out_block_table = NULL;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_block_subspan(
+    iree_runtime_kv_cache_t* cache, iree_host_size_t block_index,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (block_index >= cache->options.block_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "block %" PRIhsz " out of range (%" PRIhsz
+                            " blocks)",
+                            block_index, cache->options.block_count);
+  }
+  return iree_hal_buffer_subspan(cache->pool_buffer,
+                                 block_index * cache->block_byte_length,
+                                 cache->block_byte_length, out_buffer);
+}
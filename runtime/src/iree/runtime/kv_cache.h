@@ -0,0 +1,156 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_RUNTIME_KV_CACHE_H_
+#define IREE_RUNTIME_KV_CACHE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_kv_cache_options_t
+//===----------------------------------------------------------------------===//
+
+// Options used to configure KV-cache creation.
+typedef struct iree_runtime_kv_cache_options_t {
+  // Element type of the cached keys and values.
+  iree_hal_element_type_t element_type;
+  // Number of elements stored for each token, such as
+  // `layers * 2 * kv_heads * head_dim` for a cache holding all layers.
+  iree_host_size_t elements_per_token;
+  // Number of tokens stored in each block.
+  iree_host_size_t block_tokens;
+  // Total number of blocks in the pool shared by all sequences.
+  iree_host_size_t block_count;
+  // Maximum number of sequences live at the same time.
+  iree_host_size_t max_sequence_count;
+  // Maximum number of blocks referenced by a single sequence; bounds the
+  // sequence length to `max_blocks_per_sequence * block_tokens` tokens.
+  iree_host_size_t max_blocks_per_sequence;
+  // Queue used to allocate the pool and upload block tables.
+  iree_hal_queue_affinity_t queue_affinity;
+} iree_runtime_kv_cache_options_t;
+
+// Initializes |out_options| to its default values.
+// The element type and sizes must be set by the caller.
+IREE_API_EXPORT void iree_runtime_kv_cache_options_initialize(
+    iree_runtime_kv_cache_options_t* out_options);
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_kv_cache_t
+//===----------------------------------------------------------------------===//
+
+// Identifies a sequence within a KV-cache.
+typedef uint32_t iree_runtime_kv_cache_sequence_id_t;
+
+// A paged key/value cache for autoregressive decoding.
+//
+// Storage is a single device pool of fixed-size blocks allocated once with
+// iree_hal_device_queue_alloca. Sequences own an ordered list of blocks (their
+// block table) and grow one block at a time so that many concurrent sequences
+// of varying length share the pool without fragmentation or reallocation.
+// Forked sequences share the blocks of their parent, such as a common prompt
+// prefix, and a shared partially-filled block is copied before it is appended
+// to.
+//
+// Programs receive the pool as a `[block_count, block_tokens,
+// elements_per_token]` buffer view along with a `[sequence_count,
+// max_blocks_per_sequence]` i32 block table and a `[sequence_count]` i32
+// length list and gather/scatter tokens through the table. Table entries past
+// the end of a sequence are 0 and must be masked using the length.
+//
+// Thread-compatible; callers scheduling sequences from multiple threads must
+// synchronize their use of the cache.
+typedef struct iree_runtime_kv_cache_t iree_runtime_kv_cache_t;
+
+// Creates a KV-cache with storage allocated from |device|.
+// |out_cache| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_create(
+    iree_hal_device_t* device, const iree_runtime_kv_cache_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_kv_cache_t** out_cache);
+
+// Retains the given |cache| for the caller.
+IREE_API_EXPORT void iree_runtime_kv_cache_retain(
+    iree_runtime_kv_cache_t* cache);
+
+// Releases the given |cache| from the caller.
+IREE_API_EXPORT void iree_runtime_kv_cache_release(
+    iree_runtime_kv_cache_t* cache);
+
+// Returns a `[block_count, block_tokens, elements_per_token]` view of the
+// block pool. The view is owned by the cache and must be retained by callers
+// that need it to outlive the cache.
+IREE_API_EXPORT iree_hal_buffer_view_t* iree_runtime_kv_cache_pool(
+    iree_runtime_kv_cache_t* cache);
+
+// Returns the number of blocks not referenced by any sequence.
+IREE_API_EXPORT iree_host_size_t
+iree_runtime_kv_cache_free_block_count(iree_runtime_kv_cache_t* cache);
+
+// Creates a new empty sequence.
+// Fails with IREE_STATUS_RESOURCE_EXHAUSTED if max_sequence_count sequences
+// are live.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_create(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t* out_sequence_id);
+
+// Creates a new sequence sharing all tokens of |parent_id|.
+// No storage is copied until either sequence appends to a shared block.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_fork(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t parent_id,
+    iree_runtime_kv_cache_sequence_id_t* out_sequence_id);
+
+// Releases |sequence_id| and returns its unshared blocks to the pool.
+IREE_API_EXPORT void iree_runtime_kv_cache_sequence_release(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id);
+
+// Returns the number of tokens in |sequence_id|.
+IREE_API_EXPORT iree_host_size_t iree_runtime_kv_cache_sequence_length(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id);
+
+// Extends |sequence_id| by |token_count| tokens, acquiring blocks as needed
+// so that the program can write the new tokens through the block table.
+// Fails with IREE_STATUS_RESOURCE_EXHAUSTED and leaves the sequence unchanged
+// if the pool does not have enough free blocks; schedulers can then preempt
+// other sequences and retry.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_sequence_append(
+    iree_runtime_kv_cache_t* cache,
+    iree_runtime_kv_cache_sequence_id_t sequence_id,
+    iree_host_size_t token_count);
+
+// Uploads the block tables and lengths of |sequence_ids| and returns a
+// `[sequence_count, max_blocks_per_sequence]` i32 block table view and
+// `[sequence_count]` i32 length view for passing to a program.
+//
+// The views reference storage reused by every call and the program consuming
+// them must complete before the next call. Both views must be released by the
+// caller.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_upload_block_tables(
+    iree_runtime_kv_cache_t* cache, iree_host_size_t sequence_count,
+    const iree_runtime_kv_cache_sequence_id_t* sequence_ids,
+    iree_hal_buffer_view_t** out_block_table,
+    iree_hal_buffer_view_t** out_lengths);
+
+// Returns a subspan of the pool covering |block_index|.
+// |out_buffer| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_runtime_kv_cache_block_subspan(
+    iree_runtime_kv_cache_t* cache, iree_host_size_t block_index,
+    iree_hal_buffer_t** out_buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_RUNTIME_KV_CACHE_H_
@@ -183,6 +183,19 @@ iree_runtime_session_trim(iree_runtime_session_t* session) {
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_session_fork_state(
+    iree_runtime_session_t* session, iree_vm_context_t** out_state) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(out_state);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      iree_vm_context_fork(iree_runtime_session_context(session),
+                           iree_runtime_session_host_allocator(session),
+                           out_state);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_runtime_session_append_module(
     iree_runtime_session_t* session, iree_vm_module_t* module) {
   IREE_ASSERT_ARGUMENT(session);
@@ -291,15 +304,24 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_lookup_function(
 IREE_API_EXPORT iree_status_t iree_runtime_session_call(
     iree_runtime_session_t* session, const iree_vm_function_t* function,
     iree_vm_list_t* input_list, iree_vm_list_t* output_list) {
+  return iree_runtime_session_call_with_state(session, /*state=*/NULL,
+                                              function, input_list,
+                                              output_list);
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_with_state(
+    iree_runtime_session_t* session, iree_vm_context_t* state,
+    const iree_vm_function_t* function, iree_vm_list_t* input_list,
+    iree_vm_list_t* output_list) {
   IREE_ASSERT_ARGUMENT(session);
   IREE_ASSERT_ARGUMENT(function);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_status_t status =
-      iree_vm_invoke(iree_runtime_session_context(session), *function,
-                     IREE_VM_INVOCATION_FLAG_NONE,
-                     /*policy=*/NULL, input_list, output_list,
-                     iree_runtime_session_host_allocator(session));
+  iree_status_t status = iree_vm_invoke(
+      state ? state : iree_runtime_session_context(session), *function,
+      IREE_VM_INVOCATION_FLAG_NONE,
+      /*policy=*/NULL, input_list, output_list,
+      iree_runtime_session_host_allocator(session));
 
   IREE_TRACE_ZONE_END(z0);
   return status;
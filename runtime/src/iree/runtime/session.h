@@ -135,6 +135,21 @@ IREE_API_EXPORT iree_hal_allocator_t* iree_runtime_session_device_allocator(
 IREE_API_EXPORT iree_status_t
 iree_runtime_session_trim(iree_runtime_session_t* session);
 
+// Creates a new session state holding an independent copy of the mutable
+// module state (globals) of |session| as it is now. Immutable resources
+// created by module initializers such as executables and constants are shared
+// with the session and all other states so that many concurrent sequences or
+// tenants can be hosted without duplicating them.
+//
+// The returned state is a context forked from the session context (see
+// iree_vm_context_fork) and is selected per-invocation with
+// iree_runtime_session_call_with_state or iree_runtime_call_set_state.
+// Modules appended to the session after the state is created are not visible
+// to it. The session must not be executing while the state is created.
+// |out_state| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_runtime_session_fork_state(
+    iree_runtime_session_t* session, iree_vm_context_t** out_state);
+
 // Appends the given |module| to the context.
 // The module will be retained by the context.
 //
@@ -208,6 +223,16 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call(
     iree_runtime_session_t* session, const iree_vm_function_t* function,
     iree_vm_list_t* input_list, iree_vm_list_t* output_list);
 
+// Synchronously issues a generic function call against |state| as with
+// iree_runtime_session_call. |state| must have been created from |session|
+// with iree_runtime_session_fork_state or be NULL to use the session state.
+// Switching between states is only a pointer swap and lets callers
+// interleave calls for many sequences in any order.
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_with_state(
+    iree_runtime_session_t* session, iree_vm_context_t* state,
+    const iree_vm_function_t* function, iree_vm_list_t* input_list,
+    iree_vm_list_t* output_list);
+
 // Synchronously issues a generic function call by fully-qualified name.
 // This is equivalent to performing a iree_runtime_session_lookup_function
 // followed by a iree_runtime_session_call. When calling the same function
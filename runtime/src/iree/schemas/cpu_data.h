@@ -74,4 +74,31 @@
 
 #undef IREE_CPU_FEATURE_BIT_NAME
 
+//===----------------------------------------------------------------------===//
+// CPU processor identification
+//===----------------------------------------------------------------------===//
+// Data field 7, the last one so that feature bits can keep growing from field
+// 0 up, identifies the processor microarchitecture. This lets code make tuning
+// decisions that ISA feature bits can't express, e.g. two CPUs with the same
+// features preferring different loop nests. Zero means unknown. A nonzero value
+// is only meaningful on the architecture that produced it. On heterogeneous
+// (big.LITTLE) systems this is the processor that ran iree_cpu_initialize.
+// Each value is (field7 >> X_SHIFT) & X_MASK.
+
+// x86_64: the vendor, and the display family and model from CPUID leaf 1.
+#define IREE_CPU_DATA7_X86_64_VENDOR_SHIFT 0
+#define IREE_CPU_DATA7_X86_64_VENDOR_MASK 0xFFull
+#define IREE_CPU_DATA7_X86_64_FAMILY_SHIFT 8
+#define IREE_CPU_DATA7_X86_64_FAMILY_MASK 0xFFFull
+#define IREE_CPU_DATA7_X86_64_MODEL_SHIFT 20
+#define IREE_CPU_DATA7_X86_64_MODEL_MASK 0xFFull
+#define IREE_CPU_DATA7_X86_64_VENDOR_INTEL 1
+#define IREE_CPU_DATA7_X86_64_VENDOR_AMD 2
+
+// arm_64: the implementer and part number fields of MIDR_EL1.
+#define IREE_CPU_DATA7_ARM_64_IMPLEMENTER_SHIFT 0
+#define IREE_CPU_DATA7_ARM_64_IMPLEMENTER_MASK 0xFFull
+#define IREE_CPU_DATA7_ARM_64_PARTNUM_SHIFT 8
+#define IREE_CPU_DATA7_ARM_64_PARTNUM_MASK 0xFFFull
+
 #endif  // IREE_SCHEMAS_CPU_DATA_H_
@@ -114,3 +114,11 @@ IREE_CPU_FEATURE_BIT(X86_64, 0, 32, AVX512FP16, "avx512fp16")
 IREE_CPU_FEATURE_BIT(X86_64, 0, 50, AMXTILE, "amx-tile")
 IREE_CPU_FEATURE_BIT(X86_64, 0, 51, AMXINT8, "amx-int8")
 IREE_CPU_FEATURE_BIT(X86_64, 0, 52, AMXBF16, "amx-bf16")
+
+//===----------------------------------------------------------------------===//
+// IREE_ARCH_WASM_32 / wasm32
+//===----------------------------------------------------------------------===//
+
+// WebAssembly has no runtime feature detection: modules using SIMD instructions
+// fail validation on engines lacking them.
+IREE_CPU_FEATURE_BIT(WASM_32, 0, 0, SIMD128, "simd128")
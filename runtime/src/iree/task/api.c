@@ -24,6 +24,48 @@ IREE_FLAG(
     "when latency is the #1 priority (vs. thermals, system-wide scheduling,\n"
     "etc).");
 
+IREE_FLAG(
+    bool, task_worker_adaptive_spin, false,
+    "Adapts the spin duration of each worker between 0 and\n"
+    "--task_worker_spin_us based on how long the worker has recently been\n"
+    "idle before new work arrived. Workers only spin when work tends to\n"
+    "arrive within the spin window and otherwise park immediately.");
+
+IREE_FLAG(
+    int32_t, task_worker_node_theft_threshold, 0,
+    "Minimum number of additional busy workers a remote NUMA node must have\n"
+    "over the local node before a worker will steal tasks across nodes. 0\n"
+    "allows stealing across nodes whenever local stealing fails. Only used\n"
+    "with executors spanning multiple NUMA nodes such as those created with\n"
+    "--task_topology_mode=physical_cores_numa.");
+
+IREE_FLAG(
+    bool, task_node_local_dispatch, false,
+    "Confines the shards of each dispatch to the workers of a single NUMA\n"
+    "node. Only used with executors spanning multiple NUMA nodes such as\n"
+    "those created with --task_topology_mode=physical_cores_numa.");
+
+IREE_FLAG(
+    bool, task_dispatch_tile_affinity, false,
+    "Assigns dispatch tiles to the same workers across dispatches with\n"
+    "matching workgroup counts so that consumers reuse data their producers\n"
+    "left in worker caches. Trades some load balancing for locality.");
+
+IREE_FLAG(
+    bool, task_dispatch_sized_shards, false,
+    "Shards small dispatches across only as many workers as their workgroup\n"
+    "count warrants so that concurrent submissions run side by side on\n"
+    "their own workers. Improves throughput with many independent requests\n"
+    "in flight at the cost of single-request latency.");
+
+IREE_FLAG(
+    string, task_worker_priority, "normal",
+    "Priority class of worker threads: 'lowest', 'low', 'normal', 'high',\n"
+    "'highest', or 'realtime'. Raising the priority above normal may require\n"
+    "additional privileges and is best-effort. 'realtime' uses SCHED_FIFO on\n"
+    "Linux/Android when permitted and can starve the rest of the system if\n"
+    "workers spin (see --task_worker_spin_us=).");
+
 IREE_FLAG(
     int32_t, task_worker_stack_size, 128 * 1024,
     "Minimum size in bytes of each worker thread stack.\n"
@@ -44,12 +86,58 @@ IREE_FLAG(
     "only use a specific maximum amount of local memory and the runtime must\n"
     "be configured to make at least that amount of local memory available.");
 
+// Parses a thread priority class from its |value| flag name.
+static iree_status_t iree_task_parse_priority_class(
+    iree_string_view_t value,
+    iree_thread_priority_class_t* out_priority_class) {
+  if (iree_string_view_equal(value, IREE_SV("lowest"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_LOWEST;
+  } else if (iree_string_view_equal(value, IREE_SV("low"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_LOW;
+  } else if (iree_string_view_is_empty(value) ||
+             iree_string_view_equal(value, IREE_SV("normal"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  } else if (iree_string_view_equal(value, IREE_SV("high"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_HIGH;
+  } else if (iree_string_view_equal(value, IREE_SV("highest"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_HIGHEST;
+  } else if (iree_string_view_equal(value, IREE_SV("realtime"))) {
+    *out_priority_class = IREE_THREAD_PRIORITY_CLASS_REALTIME;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown worker priority '%.*s'; expected one of "
+                            "lowest, low, normal, high, highest, or realtime",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
   IREE_ASSERT_ARGUMENT(out_options);
   iree_task_executor_options_initialize(out_options);
+  IREE_RETURN_IF_ERROR(iree_task_parse_priority_class(
+      iree_make_cstring_view(FLAG_task_worker_priority),
+      &out_options->worker_priority_class));
   out_options->worker_spin_ns =
       (iree_duration_t)FLAG_task_worker_spin_us * 1000;
+  out_options->worker_idle_policy = FLAG_task_worker_adaptive_spin
+                                        ? IREE_TASK_WORKER_IDLE_POLICY_ADAPTIVE
+                                        : IREE_TASK_WORKER_IDLE_POLICY_FIXED;
+  out_options->worker_node_theft_threshold =
+      (uint32_t)iree_max(0, FLAG_task_worker_node_theft_threshold);
+  if (FLAG_task_node_local_dispatch) {
+    out_options->scheduling_mode |=
+        IREE_TASK_SCHEDULING_MODE_NODE_LOCAL_DISPATCH;
+  }
+  if (FLAG_task_dispatch_tile_affinity) {
+    out_options->scheduling_mode |=
+        IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY;
+  }
+  if (FLAG_task_dispatch_sized_shards) {
+    out_options->scheduling_mode |=
+        IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS;
+  }
   out_options->worker_stack_size =
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
@@ -72,7 +160,17 @@ IREE_FLAG(
     " 'physical_cores':\n"
     "   Creates one executor per NUMA node in --task_topology_nodes= and one\n"
     "   group per physical core in each NUMA node up to the value specified\n"
-    "   by --task_topology_max_group_count=.");
+    "   by --task_topology_max_group_count=.\n"
+    " 'performance_cores':\n"
+    "   As with 'physical_cores' but only using performance (big/P-)cores on\n"
+    "   heterogeneous systems. Useful for latency-sensitive workloads that\n"
+    "   would otherwise wait on efficiency cores at every dispatch barrier.\n"
+    " 'physical_cores_numa':\n"
+    "   Creates a single executor spanning all NUMA nodes in\n"
+    "   --task_topology_nodes= with one group per physical core in each NUMA\n"
+    "   node up to the value specified by --task_topology_max_group_count=\n"
+    "   per node. Workers prefer work from their own node; see\n"
+    "   --task_worker_node_theft_threshold= and --task_node_local_dispatch.");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -97,6 +195,13 @@ IREE_FLAG(
     "flags. 'all' can be used to indicate all available NUMA nodes and\n"
     "'current' will inherit the node of the calling thread.");
 
+IREE_FLAG(
+    string, task_topology_core_type, "any",
+    "Type of cores used by 'physical_cores' topologies on heterogeneous\n"
+    "systems: 'any', 'performance' (big/P-cores), or 'efficiency'\n"
+    "(LITTLE/E-cores). Systems without multiple core types (or platforms\n"
+    "where they cannot be detected) use all cores.");
+
 IREE_FLAG(
     int32_t, task_topology_max_group_count, 8,
     "Sets a maximum value on the worker count that can be automatically\n"
@@ -156,6 +261,40 @@ static iree_status_t iree_task_topologies_select_nodes_from_flags(
   return iree_ok_status();
 }
 
+// Returns true if a single executor should span all selected NUMA nodes.
+static bool iree_task_topology_flags_span_nodes(void) {
+  return FLAG_task_topology_group_count == 0 &&
+         strcmp(FLAG_task_topology_mode, "physical_cores_numa") == 0;
+}
+
+// Initializes |out_topology| with groups from all NUMA nodes in |node_mask|.
+static iree_status_t iree_task_topology_initialize_spanning_nodes_from_flags(
+    uint64_t node_mask, iree_task_topology_t* out_topology) {
+  return iree_task_topology_initialize_from_physical_cores_on_nodes(
+      node_mask, FLAG_task_topology_max_group_count, out_topology);
+}
+
+// Parses --task_topology_core_type=.
+static iree_status_t iree_task_topology_core_type_from_flags(
+    iree_task_topology_core_type_t* out_core_type) {
+  iree_string_view_t value =
+      iree_make_cstring_view(FLAG_task_topology_core_type);
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("any"))) {
+    *out_core_type = IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+  } else if (iree_string_view_equal(value, IREE_SV("performance"))) {
+    *out_core_type = IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE;
+  } else if (iree_string_view_equal(value, IREE_SV("efficiency"))) {
+    *out_core_type = IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown core type '%.*s'; expected one of any, "
+                            "performance, or efficiency",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_task_topology_initialize_from_flags(
     iree_task_topology_node_id_t node_id, iree_task_topology_t* out_topology) {
   IREE_ASSERT_ARGUMENT(out_topology);
@@ -167,9 +306,20 @@ iree_status_t iree_task_topology_initialize_from_flags(
         FLAG_task_topology_group_count, out_topology);
     return iree_ok_status();
   } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
-    // Physical cores sourced from a specific NUMA node.
-    return iree_task_topology_initialize_from_physical_cores(
-        node_id, FLAG_task_topology_max_group_count, out_topology);
+    // Physical cores of the requested type sourced from a specific NUMA node.
+    iree_task_topology_core_type_t core_type = IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+    IREE_RETURN_IF_ERROR(iree_task_topology_core_type_from_flags(&core_type));
+    return iree_task_topology_initialize_from_physical_cores_of_type(
+        node_id, core_type, FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "performance_cores") == 0) {
+    // Only performance cores from a specific NUMA node.
+    return iree_task_topology_initialize_from_physical_cores_of_type(
+        node_id, IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE,
+        FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "physical_cores_numa") == 0) {
+    // Physical cores from the specific NUMA node as part of a larger topology.
+    return iree_task_topology_initialize_spanning_nodes_from_flags(
+        1ull << node_id, out_topology);
   } else {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -205,6 +355,13 @@ static void iree_task_flags_dump_task_topology(
     const iree_task_topology_group_t* group = &topology->groups[j];
     fprintf(stdout, "# group[%d]: '%s'\n", group->group_index, group->name);
     fprintf(stdout, "#      processor: %u\n", group->processor_index);
+    fprintf(stdout, "#      numa node: %u\n", group->node_id);
+    fprintf(stdout, "#      core type: %s\n",
+            group->core_type == IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE
+                ? "performance"
+            : group->core_type == IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY
+                ? "efficiency"
+                : "(any/unknown)");
     fprintf(stdout, "#       affinity: ");
     if (group->ideal_thread_affinity.specified) {
       fprintf(
@@ -233,6 +390,13 @@ static void iree_task_flags_dump_task_topology(
       }
       fprintf(stdout, "\n");
     }
+    fprintf(stdout, "#    llc sharing: ");
+    if (group->llc_sharing_mask == IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) {
+      fprintf(stdout, "(all/undefined)\n");
+    } else {
+      fprintf(stdout, "%d group(s)\n",
+              iree_math_count_ones_u64(group->llc_sharing_mask));
+    }
     fprintf(stdout, "#\n");
   }
 }
@@ -247,6 +411,17 @@ static iree_status_t iree_task_flags_dump_task_topologies(
     IREE_RETURN_IF_ERROR(
         iree_task_topologies_select_nodes_from_flags(&node_mask));
 
+    if (iree_task_topology_flags_span_nodes()) {
+      iree_task_topology_t topology;
+      IREE_RETURN_IF_ERROR(
+          iree_task_topology_initialize_spanning_nodes_from_flags(node_mask,
+                                                                  &topology));
+      iree_task_flags_dump_task_topology(0, &topology);
+      iree_task_topology_deinitialize(&topology);
+      exit(0);
+      return iree_ok_status();
+    }
+
     // TODO(benvanik): macros to make this iteration easier (ala cpu_set
     // iterators).
     iree_host_size_t topology_count = iree_math_count_ones_u64(node_mask);
@@ -312,7 +487,9 @@ iree_status_t iree_task_executors_create_from_flags(
   if (cpu_ids_list.count == 0) {
     IREE_RETURN_IF_ERROR(
         iree_task_topologies_select_nodes_from_flags(&node_mask));
-    topology_count = iree_math_count_ones_u64(node_mask);
+    topology_count = iree_task_topology_flags_span_nodes()
+                         ? 1
+                         : iree_math_count_ones_u64(node_mask);
   } else {
     topology_count = cpu_ids_list.count;
   }
@@ -346,7 +523,17 @@ iree_status_t iree_task_executors_create_from_flags(
 
   // Create one executor per topology.
   iree_status_t status = iree_ok_status();
-  if (cpu_ids_list.count == 0) {
+  if (cpu_ids_list.count == 0 && iree_task_topology_flags_span_nodes()) {
+    // Single executor spanning all selected nodes.
+    iree_task_topology_t topology;
+    status = iree_task_topology_initialize_spanning_nodes_from_flags(
+        node_mask, &topology);
+    if (iree_status_is_ok(status)) {
+      status = iree_task_executor_create(options, &topology, host_allocator,
+                                         &executors[0]);
+    }
+    iree_task_topology_deinitialize(&topology);
+  } else if (cpu_ids_list.count == 0) {
     // TODO(benvanik): macros to make this iteration easier (ala cpu_set
     // iterators).
     uint64_t node_mask_bits = node_mask;
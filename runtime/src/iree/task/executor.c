@@ -29,6 +29,41 @@ void iree_task_executor_options_initialize(
   memset(out_options, 0, sizeof(*out_options));
 }
 
+// Returns a bitmask of all workers in |topology| on the NUMA node |node_id|.
+static iree_task_affinity_set_t iree_task_executor_calculate_node_worker_mask(
+    const iree_task_topology_t* topology,
+    iree_task_topology_node_id_t node_id) {
+  iree_task_affinity_set_t node_worker_mask = 0;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    if (topology->groups[i].node_id == node_id) {
+      node_worker_mask |= iree_task_affinity_for_worker(i);
+    }
+  }
+  return node_worker_mask;
+}
+
+// Returns a bitmask of all workers in |topology| placed on performance cores
+// or 0 if the topology does not mix performance and efficiency cores.
+static iree_task_affinity_set_t
+iree_task_executor_calculate_performance_worker_mask(
+    const iree_task_topology_t* topology) {
+  iree_task_affinity_set_t performance_worker_mask = 0;
+  bool has_efficiency_cores = false;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    switch (topology->groups[i].core_type) {
+      case IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE:
+        performance_worker_mask |= iree_task_affinity_for_worker(i);
+        break;
+      case IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY:
+        has_efficiency_cores = true;
+        break;
+      default:
+        break;
+    }
+  }
+  return has_efficiency_cores ? performance_worker_mask : 0;
+}
+
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
                                         const iree_task_topology_t* topology,
                                         iree_allocator_t allocator,
@@ -79,8 +114,16 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   executor->allocator = allocator;
   executor->scheduling_mode = options.scheduling_mode;
   executor->worker_spin_ns = options.worker_spin_ns;
+  executor->worker_idle_policy = options.worker_idle_policy;
+  executor->worker_priority_class = options.worker_priority_class;
+  executor->performance_worker_mask =
+      iree_task_executor_calculate_performance_worker_mask(topology);
+  executor->node_count = iree_task_topology_query_group_node_count(topology);
+  executor->worker_node_theft_threshold = options.worker_node_theft_threshold;
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
+  iree_atomic_store_int32(&executor->coordination_requested, 0,
+                          iree_memory_order_relaxed);
 
   IREE_TRACE({
     static iree_atomic_int32_t executor_id = IREE_ATOMIC_VAR_INIT(0);
@@ -158,8 +201,12 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
 
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
       iree_task_worker_t* worker = &executor->workers[i];
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(topology, i);
       status = iree_task_worker_initialize(
-          executor, i, iree_task_topology_get_group(topology, i),
+          executor, i, group,
+          iree_task_executor_calculate_node_worker_mask(topology,
+                                                        group->node_id),
           options.worker_stack_size,
           iree_make_byte_span(worker_local_memory,
                               options.worker_local_memory_size),
@@ -255,6 +302,20 @@ iree_host_size_t iree_task_executor_worker_count(
   return executor->worker_count;
 }
 
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    out_statistics->worker_spin_hit_count += (uint64_t)iree_atomic_load_int64(
+        &worker->spin_hit_count, iree_memory_order_relaxed);
+    out_statistics->worker_park_count += (uint64_t)iree_atomic_load_int64(
+        &worker->park_count, iree_memory_order_relaxed);
+  }
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
@@ -420,20 +481,37 @@ void iree_task_executor_flush(iree_task_executor_t* executor) {
 // If a coordination run ends up with no ready tasks and |current_worker| is
 // provided the calling thread will enter a wait until the worker has more tasks
 // posted to it.
+//
+// Callers never block on another coordinator: if one is already active the
+// request is handed off to it and it will run another pass after it finishes
+// its current one. This keeps concurrent submitters (and idle workers) from
+// forming long serialized lock chains on the coordinator mutex.
 void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Request coordination before trying to become the coordinator. If another
+  // thread holds the lock it is guaranteed to observe the request after it
+  // unlocks and will pick up anything we've submitted.
+  iree_atomic_exchange_int32(&executor->coordination_requested, 1,
+                             iree_memory_order_seq_cst);
+
   // We may be adding tasks/waiting/etc on each pass through coordination - to
   // ensure we completely drain the incoming queues and satisfied waits we loop
   // until there's nothing left to coordinate.
   bool schedule_dirty = true;
   do {
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_task_executor_coordinate_try");
-    // TODO(#10212): remove this lock or do something more clever to avoid
-    // contention when many workers try to coordinate at the same time. This can
-    // create very long serialized lock chains that slow down worker wakes.
-    iree_slim_mutex_lock(&executor->coordinator_mutex);
+    if (!iree_slim_mutex_try_lock(&executor->coordinator_mutex)) {
+      // Another thread is coordinating and has been handed our request.
+      IREE_TRACE_ZONE_END(z1);
+      break;
+    }
+
+    // Clear the request prior to draining so that any submission that lands
+    // after this point will cause another pass.
+    iree_atomic_store_int32(&executor->coordination_requested, 0,
+                            iree_memory_order_seq_cst);
 
     // Check for incoming submissions and move their posted tasks into our
     // local lists. Any of the tasks here are ready to execute immediately and
@@ -457,6 +535,15 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     if (iree_task_list_is_empty(&pending_submission.ready_list)) {
       iree_slim_mutex_unlock(&executor->coordinator_mutex);
       IREE_TRACE_ZONE_END(z1);
+      // Run another pass if a request was handed off to us while we held the
+      // lock. The fence orders our unlock before the load and pairs with the
+      // exchange performed by requesters before they try to lock.
+      iree_atomic_thread_fence(iree_memory_order_seq_cst);
+      if (iree_atomic_load_int32(&executor->coordination_requested,
+                                 iree_memory_order_seq_cst)) {
+        schedule_dirty = true;
+        continue;
+      }
       break;
     }
 
@@ -466,8 +553,7 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // coordinator is random it's better to ensure that these bytes never incur
     // a cache miss by making them live here in the stack of the chosen thread.
     iree_task_post_batch_t* post_batch =
-        iree_alloca(sizeof(iree_task_post_batch_t) +
-                    executor->worker_count * sizeof(iree_task_list_t));
+        iree_alloca(iree_task_post_batch_size(executor));
     iree_task_post_batch_initialize(executor, current_worker, post_batch);
 
     // Schedule all ready tasks in this batch. Some may complete inline (such
@@ -486,6 +572,12 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // Post all new work to workers; they may wake and begin executing
     // immediately. Returns whether this worker has new tasks for it to work on.
     schedule_dirty = iree_task_post_batch_submit(post_batch);
+
+    // Run another pass if a request was handed off to us while we held the
+    // lock (see above).
+    iree_atomic_thread_fence(iree_memory_order_seq_cst);
+    schedule_dirty |= iree_atomic_load_int32(&executor->coordination_requested,
+                                             iree_memory_order_seq_cst) != 0;
   } while (schedule_dirty);
 
   IREE_TRACE_ZONE_END(z0);
@@ -556,10 +648,24 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // group we steal. We (probably) don't need anything super complex here so
 // instead of bouncing around at random we just select the starting point in
 // our search and then go in-order.
+//
+// Victims that share the last level cache (|llc_sharing_mask|) are tried next:
+// on parts with many cache domains (CCDs/clusters) taking work from another
+// domain means refetching everything it touches from memory or over the
+// interconnect and it's better to drain the local domain first.
+//
+// On multi-node topologies the remaining victims on the same NUMA node as the
+// thief (|node_worker_mask|) are tried next and only if those fail and the
+// remote nodes are sufficiently more loaded than the local one do we reach
+// across the interconnect. Pulling a task across nodes means all of the memory
+// it touches will be remote and it's often better to leave it for the workers
+// on its own node to finish.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_affinity_set_t llc_sharing_mask,
+    iree_task_affinity_set_t node_worker_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
     iree_task_queue_t* local_task_queue) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -586,20 +692,52 @@ iree_task_t* iree_task_executor_try_steal_task(
   // helps to prevent cache invalidations/availability updates as it's likely
   // that we won't need to go back to main memory (or higher cache tiers) in the
   // event that the thief and victim are running close to each other in time.
+  iree_task_affinity_set_t local_victim_mask = victim_mask & node_worker_mask;
   iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
+      executor, local_victim_mask & constructive_sharing_mask,
+      max_theft_attempts, rotation_offset, local_task_queue);
   if (task) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
   } else {
     task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+        executor,
+        local_victim_mask & ~constructive_sharing_mask & llc_sharing_mask,
+        max_theft_attempts, rotation_offset, local_task_queue);
+    if (task) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "llc");
+    }
+  }
+  if (!task) {
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor,
+        local_victim_mask & ~constructive_sharing_mask & ~llc_sharing_mask,
+        max_theft_attempts, rotation_offset, local_task_queue);
     if (task) {
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
     }
   }
 
+  // Fall back to remote nodes only if they are imbalanced enough to be worth
+  // the cross-node traffic. The busy worker counts are derived from the same
+  // relaxed masks as above and are just as approximate.
+  iree_task_affinity_set_t remote_victim_mask = victim_mask & ~node_worker_mask;
+  if (!task && remote_victim_mask) {
+    const int local_busy_count =
+        iree_task_affinity_set_count_ones(local_victim_mask);
+    const int remote_busy_count =
+        iree_task_affinity_set_count_ones(remote_victim_mask);
+    if (executor->worker_node_theft_threshold == 0 ||
+        remote_busy_count - local_busy_count >=
+            (int)executor->worker_node_theft_threshold) {
+      task = iree_task_executor_try_steal_task_from_affinity_set(
+          executor, remote_victim_mask, max_theft_attempts, rotation_offset,
+          local_task_queue);
+      if (task) {
+        IREE_TRACE_ZONE_APPEND_TEXT(z0, "remote");
+      }
+    }
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return task;
 }
@@ -128,7 +128,10 @@ extern "C" {
 //
 //   c. iree_task_post_batch_submit: per-worker tasks are pushed to their
 //      respective iree_task_worker_t mailbox_slist and the workers with new
-//      tasks are notified to wake up (if not already awake).
+//      tasks are notified to wake up (if not already awake). Tasks from scopes
+//      with IREE_TASK_PRIORITY_HIGH are instead pushed to the
+//      priority_mailbox_slist and flagged so that the worker picks them up
+//      before anything else it has pending.
 //
 // 4. iree_task_worker_main_pump_once (LIFO mailbox -> FIFO thread-local list)
 //    When either woken or after completing all available thread-local work
@@ -136,7 +139,9 @@ extern "C" {
 //    posted.
 //
 //    a. Tasks are flushed from the LIFO mailbox into the local_task_queue FIFO
-//       for the particular worker.
+//       for the particular worker. High-priority tasks are flushed into the
+//       front of the queue and normal priority dispatch shards yield to them at
+//       their next tile reservation boundary.
 //
 //    b. If the mailbox is empty the worker *may* attempt to steal work from
 //       another nearby worker in the topology.
@@ -265,9 +270,50 @@ enum iree_task_scheduling_mode_bits_t {
   // reach peak utilization or artificially limiting which tasks we allow
   // through to keep certain CPU cores asleep unless absolutely required.
   IREE_TASK_SCHEDULING_MODE_RESERVED = 0u,
+
+  // Confines the shards of each dispatch to the workers on a single NUMA node:
+  // the node of the worker the dispatch is first issued to. All tiles of the
+  // dispatch will be reserved and executed by workers sharing the same memory
+  // controller unless work stealing moves shards across nodes (see
+  // iree_task_executor_options_t::worker_node_theft_threshold). Has no effect
+  // on topologies with a single node.
+  IREE_TASK_SCHEDULING_MODE_NODE_LOCAL_DISPATCH = 1u << 0,
+
+  // Assigns dispatch tiles to workers deterministically so that consecutive
+  // dispatches with matching workgroup counts execute the same tiles on the
+  // same workers and can reuse the data a producer left in the worker caches.
+  // Shards are always issued starting from the first worker in the dispatch
+  // affinity set and each shard owns a contiguous block of the leading
+  // IREE_TASK_DISPATCH_AFFINITY_TILE_PERCENT of the grid. The remaining tiles
+  // are reserved dynamically by whichever shards finish their blocks first to
+  // balance the load.
+  IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY = 1u << 1,
+
+  // Shards each dispatch across only as many workers as its tile count
+  // warrants (one per IREE_TASK_DISPATCH_MIN_TILES_PER_SHARD tiles) instead of
+  // all workers in its affinity set. Small dispatches from concurrent
+  // submissions then run side by side on disjoint sets of idle workers rather
+  // than each fanning out to every worker, reducing cache thrashing and
+  // synchronization overhead at the cost of latency when a single small
+  // dispatch is all that is running.
+  IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS = 1u << 2,
 };
 typedef uint32_t iree_task_scheduling_mode_t;
 
+// Defines how workers behave when they run out of work.
+typedef enum iree_task_worker_idle_policy_e {
+  // Workers spin for up to iree_task_executor_options_t::worker_spin_ns before
+  // parking themselves in the kernel until more work arrives.
+  IREE_TASK_WORKER_IDLE_POLICY_FIXED = 0,
+  // Workers adapt their spin window between 0 and
+  // iree_task_executor_options_t::worker_spin_ns based on how long they have
+  // recently been idle before new work arrived. When work arrives faster than
+  // the maximum spin window workers spin just long enough to catch it without
+  // a kernel round-trip and otherwise they park immediately to avoid burning
+  // cycles they won't get anything back for.
+  IREE_TASK_WORKER_IDLE_POLICY_ADAPTIVE = 1,
+} iree_task_worker_idle_policy_t;
+
 // Options controlling task executor behavior.
 typedef struct iree_task_executor_options_t {
   // Specifies the schedule mode used for worker and workload balancing.
@@ -288,6 +334,25 @@ typedef struct iree_task_executor_options_t {
   // scheduling, and the environment).
   iree_duration_t worker_spin_ns;
 
+  // Controls how the spin window is selected when |worker_spin_ns| is not zero.
+  iree_task_worker_idle_policy_t worker_idle_policy;
+
+  // Minimum imbalance in busy workers between remote NUMA nodes and the local
+  // node of a thief before it will steal tasks across nodes. Workers always
+  // try to steal from their own node first and only look at remote nodes when
+  // the remote nodes have at least this many more busy workers than the local
+  // node. 0 disables the threshold and allows stealing across nodes whenever
+  // local theft fails. Has no effect on topologies with a single node.
+  uint32_t worker_node_theft_threshold;
+
+  // Priority class of each worker thread. Latency-critical executors can raise
+  // their workers above other threads in the system (and on big.LITTLE systems
+  // make the OS scheduler more likely to keep them on the big cores) while
+  // background executors can lower theirs. Each executor (such as the one per
+  // NUMA node or CPU set created from flags) can use its own priority. See
+  // iree_thread_priority_class_t for how each class maps to each platform.
+  iree_thread_priority_class_t worker_priority_class;
+
   // Minimum size in bytes of each worker thread stack.
   // The underlying platform may allocate more stack space but _should_
   // guarantee that the available stack space is near this amount. Note that the
@@ -347,6 +412,22 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence);
 
+// Statistics aggregated across all workers of an executor.
+// Counters are updated with relaxed atomics and may tear across fields when
+// queried while the executor is active.
+typedef struct iree_task_executor_statistics_t {
+  // Total number of times workers that ran out of work found more while
+  // spinning and avoided parking in the kernel.
+  uint64_t worker_spin_hit_count;
+  // Total number of times workers parked in the kernel waiting for work.
+  uint64_t worker_park_count;
+} iree_task_executor_statistics_t;
+
+// Queries the current aggregate statistics of |executor|.
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics);
+
 // TODO(benvanik): scheduling mode mutation, compute quota control, etc.
 
 // Submits a batch of tasks for execution.
@@ -357,8 +438,11 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
 // submission unless tasks have a custom pool specified that they can be
 // returned to.
 //
-// Safe to call from any thread. Wait-free but may block for a small duration
-// during initial scheduling of the submitted tasks.
+// Safe to call from any thread. Never blocks on other threads flushing
+// concurrently: if another thread is already scheduling tasks the flush is
+// handed off to it and this returns immediately. Otherwise the calling thread
+// may block for a small duration during initial scheduling of the submitted
+// tasks.
 //
 // NOTE: it's possible for all work in the submission to complete prior to this
 // function returning.
@@ -367,8 +451,11 @@ void iree_task_executor_submit(iree_task_executor_t* executor,
 
 // Flushes any pending task batches for execution.
 //
-// Safe to call from any thread. Wait-free but may block for a small duration
-// during initial scheduling of the submitted tasks.
+// Safe to call from any thread. Never blocks on other threads flushing
+// concurrently: if another thread is already scheduling tasks the flush is
+// handed off to it and this returns immediately. Otherwise the calling thread
+// may block for a small duration during initial scheduling of the submitted
+// tasks.
 //
 // NOTE: due to races it's possible for new work to arrive from other threads
 // after the flush has occurred but prior to this call returning.
@@ -0,0 +1,354 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Micro-benchmarks of the task system scheduling overheads.
+//
+// Each benchmark is run across worker counts and topology presets so that
+// scheduler changes can be evaluated both with the OS placing threads and with
+// threads pinned to physical cores. The work performed by tasks is trivial so
+// that the measured time is dominated by submission, issue, stealing, and
+// wake-up costs of the executor itself.
+//
+// Executor statistics are reported as counters normalized per iteration:
+//   parks: times a worker went to sleep in the kernel waiting for work.
+//   spin_hits: times a worker found work while spinning before parking.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+
+namespace {
+
+//==============================================================================
+// Executor setup
+//==============================================================================
+
+// Topology presets built from the topology.c initializers.
+enum class TopologyPreset {
+  // One unpinned group per worker with placement left to the OS.
+  kGroupCount,
+  // One group per physical core of the current NUMA node with affinity set.
+  kPhysicalCores,
+};
+
+class Executor {
+ public:
+  Executor(TopologyPreset preset, iree_host_size_t worker_count) {
+    iree_task_topology_t topology;
+    switch (preset) {
+      case TopologyPreset::kGroupCount:
+        iree_task_topology_initialize_from_group_count(worker_count,
+                                                       &topology);
+        break;
+      case TopologyPreset::kPhysicalCores:
+        IREE_CHECK_OK(iree_task_topology_initialize_from_physical_cores(
+            IREE_TASK_TOPOLOGY_NODE_ID_ANY, worker_count, &topology));
+        break;
+    }
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    IREE_CHECK_OK(iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executor_));
+    iree_task_topology_deinitialize(&topology);
+    iree_task_scope_initialize(iree_make_cstring_view("benchmark"), &scope_);
+    iree_task_executor_query_statistics(executor_, &base_statistics_);
+  }
+
+  ~Executor() {
+    iree_task_scope_deinitialize(&scope_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_task_executor_t* executor() { return executor_; }
+  iree_task_scope_t* scope() { return &scope_; }
+
+  // Submits the DAG from |head_task| to |tail_task| and waits for it to
+  // complete. Submission and waiting happen on the calling thread.
+  void SubmitAndWait(iree_task_t* head_task, iree_task_t* tail_task) {
+    SubmitAndWait(executor_, &scope_, head_task, tail_task);
+  }
+
+  static void SubmitAndWait(iree_task_executor_t* executor,
+                            iree_task_scope_t* scope, iree_task_t* head_task,
+                            iree_task_t* tail_task) {
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, scope, &fence));
+    iree_task_set_completion_task(tail_task, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, head_task);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(scope, IREE_TIME_INFINITE_FUTURE));
+  }
+
+  // Reports the executor statistics accumulated since creation and the actual
+  // worker count (which may be lower than requested if the topology preset
+  // ran out of cores).
+  void ReportCounters(benchmark::State& state) {
+    iree_task_executor_statistics_t statistics;
+    iree_task_executor_query_statistics(executor_, &statistics);
+    state.counters["workers"] =
+        (double)iree_task_executor_worker_count(executor_);
+    state.counters["parks"] = benchmark::Counter(
+        (double)(statistics.worker_park_count -
+                 base_statistics_.worker_park_count),
+        benchmark::Counter::kAvgIterations);
+    state.counters["spin_hits"] = benchmark::Counter(
+        (double)(statistics.worker_spin_hit_count -
+                 base_statistics_.worker_spin_hit_count),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  iree_task_executor_t* executor_ = NULL;
+  iree_task_scope_t scope_;
+  iree_task_executor_statistics_t base_statistics_;
+};
+
+static iree_status_t NopCall(void* user_context, iree_task_t* task,
+                             iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+static iree_status_t NopTile(void* user_context,
+                             const iree_task_tile_context_t* tile_context,
+                             iree_task_submission_t* pending_submission) {
+  benchmark::DoNotOptimize(tile_context->workgroup_xyz[0]);
+  return iree_ok_status();
+}
+
+//==============================================================================
+// Empty dispatch round trip
+//==============================================================================
+
+// A single workgroup dispatch doing no work submitted and waited on from the
+// calling thread. Measures the minimum submit-to-retire latency.
+void BM_EmptyDispatchRoundTrip(benchmark::State& state,
+                               TopologyPreset preset) {
+  Executor executor(preset, (iree_host_size_t)state.range(0));
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {1, 1, 1};
+  for (auto _ : state) {
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(executor.scope(),
+                                  iree_task_make_dispatch_closure(NopTile, 0),
+                                  workgroup_size, workgroup_count, &dispatch);
+    executor.SubmitAndWait(&dispatch.header, &dispatch.header);
+  }
+  executor.ReportCounters(state);
+}
+
+//==============================================================================
+// Wake-up latency
+//==============================================================================
+
+// Time from submission until a worker begins executing a task when all
+// workers have parked. Timing is manual such that the wait for workers to go
+// idle between iterations is excluded.
+void BM_WakeLatency(benchmark::State& state, TopologyPreset preset) {
+  Executor executor(preset, (iree_host_size_t)state.range(0));
+  std::atomic<iree_time_t> start_time_ns{0};
+  for (auto _ : state) {
+    // Give workers time to exhaust their spin and park in the kernel.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    iree_task_call_t call;
+    iree_task_call_initialize(
+        executor.scope(),
+        iree_task_make_call_closure(
+            [](void* user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              ((std::atomic<iree_time_t>*)user_context)
+                  ->store(iree_time_now(), std::memory_order_relaxed);
+              return iree_ok_status();
+            },
+            &start_time_ns),
+        &call);
+    iree_time_t submit_time_ns = iree_time_now();
+    executor.SubmitAndWait(&call.header, &call.header);
+    state.SetIterationTime(
+        (start_time_ns.load(std::memory_order_relaxed) - submit_time_ns) /
+        1e9);
+  }
+  executor.ReportCounters(state);
+}
+
+//==============================================================================
+// Fan-out/fan-in DAG
+//==============================================================================
+
+// A root call fanning out to |width| independent calls through a barrier and
+// joining on a single call. Measures DAG readiness tracking and the cost of
+// distributing many small ready tasks across workers.
+void BM_FanOutFanIn(benchmark::State& state, TopologyPreset preset) {
+  Executor executor(preset, (iree_host_size_t)state.range(0));
+  const iree_host_size_t width = (iree_host_size_t)state.range(1);
+  std::vector<iree_task_call_t> calls(width);
+  std::vector<iree_task_t*> call_tasks(width);
+  for (auto _ : state) {
+    iree_task_call_t join;
+    iree_task_call_initialize(executor.scope(),
+                              iree_task_make_call_closure(NopCall, 0), &join);
+    for (iree_host_size_t i = 0; i < width; ++i) {
+      iree_task_call_initialize(executor.scope(),
+                                iree_task_make_call_closure(NopCall, 0),
+                                &calls[i]);
+      iree_task_set_completion_task(&calls[i].header, &join.header);
+      call_tasks[i] = &calls[i].header;
+    }
+    iree_task_barrier_t fan_out;
+    iree_task_barrier_initialize(executor.scope(), width, call_tasks.data(),
+                                 &fan_out);
+    iree_task_call_t root;
+    iree_task_call_initialize(executor.scope(),
+                              iree_task_make_call_closure(NopCall, 0), &root);
+    iree_task_set_completion_task(&root.header, &fan_out.header);
+    executor.SubmitAndWait(&root.header, &join.header);
+  }
+  state.SetItemsProcessed(state.iterations() * width);
+  executor.ReportCounters(state);
+}
+
+//==============================================================================
+// Many tiny tiles
+//==============================================================================
+
+// A dispatch of |tile_count| workgroups doing no work. Measures the per-tile
+// issue overhead and how well work is distributed and stolen across workers.
+void BM_TinyTiles(benchmark::State& state, TopologyPreset preset) {
+  Executor executor(preset, (iree_host_size_t)state.range(0));
+  const uint32_t tile_count = (uint32_t)state.range(1);
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+  for (auto _ : state) {
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(executor.scope(),
+                                  iree_task_make_dispatch_closure(NopTile, 0),
+                                  workgroup_size, workgroup_count, &dispatch);
+    executor.SubmitAndWait(&dispatch.header, &dispatch.header);
+  }
+  state.SetItemsProcessed(state.iterations() * tile_count);
+  executor.ReportCounters(state);
+}
+
+//==============================================================================
+// Contended multi-submitter
+//==============================================================================
+
+// Multiple benchmark threads each submitting small dispatches to one shared
+// executor from their own scope. Measures contention on the executor
+// submission and coordination paths.
+void BM_ContendedSubmit(benchmark::State& state, TopologyPreset preset) {
+  // Shared by all benchmark threads; created once per preset and worker count
+  // and intentionally leaked as threads may exit the benchmark in any order.
+  static std::atomic<iree_task_executor_t*> executors[2][64];
+  const iree_host_size_t worker_count = (iree_host_size_t)state.range(0);
+  auto& shared_executor = executors[(int)preset][worker_count];
+  iree_task_executor_t* executor =
+      shared_executor.load(std::memory_order_acquire);
+  if (!executor) {
+    Executor* new_executor = new Executor(preset, worker_count);
+    iree_task_executor_t* expected = NULL;
+    if (shared_executor.compare_exchange_strong(expected,
+                                                new_executor->executor())) {
+      executor = new_executor->executor();
+    } else {
+      delete new_executor;
+      executor = expected;
+    }
+  }
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("submitter"), &scope);
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {4, 1, 1};
+  for (auto _ : state) {
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(&scope,
+                                  iree_task_make_dispatch_closure(NopTile, 0),
+                                  workgroup_size, workgroup_count, &dispatch);
+    Executor::SubmitAndWait(executor, &scope, &dispatch.header,
+                            &dispatch.header);
+  }
+  iree_task_scope_deinitialize(&scope);
+}
+
+//==============================================================================
+// Registration
+//==============================================================================
+
+static void WorkerCounts(benchmark::internal::Benchmark* b) {
+  b->ArgName("workers")->RangeMultiplier(2)->Range(1, 16);
+}
+
+static void WorkerCountsAndWidths(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"workers", "width"})->ArgsProduct({{1, 4, 16}, {4, 64, 1024}});
+}
+
+static void WorkerCountsAndTiles(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"workers", "tiles"})
+      ->ArgsProduct({{1, 4, 16}, {64, 4096, 65536}});
+}
+
+BENCHMARK_CAPTURE(BM_EmptyDispatchRoundTrip, group_count,
+                  TopologyPreset::kGroupCount)
+    ->Apply(WorkerCounts)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_EmptyDispatchRoundTrip, physical_cores,
+                  TopologyPreset::kPhysicalCores)
+    ->Apply(WorkerCounts)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_FanOutFanIn, group_count, TopologyPreset::kGroupCount)
+    ->Apply(WorkerCountsAndWidths)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_FanOutFanIn, physical_cores,
+                  TopologyPreset::kPhysicalCores)
+    ->Apply(WorkerCountsAndWidths)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_TinyTiles, group_count, TopologyPreset::kGroupCount)
+    ->Apply(WorkerCountsAndTiles)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_TinyTiles, physical_cores, TopologyPreset::kPhysicalCores)
+    ->Apply(WorkerCountsAndTiles)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_WakeLatency, group_count, TopologyPreset::kGroupCount)
+    ->Apply(WorkerCounts)
+    ->UseManualTime();
+BENCHMARK_CAPTURE(BM_WakeLatency, physical_cores,
+                  TopologyPreset::kPhysicalCores)
+    ->Apply(WorkerCounts)
+    ->UseManualTime();
+
+BENCHMARK_CAPTURE(BM_ContendedSubmit, group_count, TopologyPreset::kGroupCount)
+    ->ArgName("workers")
+    ->Arg(4)
+    ->Arg(16)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ContendedSubmit, physical_cores,
+                  TopologyPreset::kPhysicalCores)
+    ->ArgName("workers")
+    ->Arg(4)
+    ->Arg(16)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace
@@ -42,6 +42,23 @@ struct iree_task_executor_t {
   // IREE_DURATION_ZERO is used to disable spinning.
   iree_duration_t worker_spin_ns;
 
+  // Whether workers adapt their spin window within [0, worker_spin_ns].
+  iree_task_worker_idle_policy_t worker_idle_policy;
+
+  // Priority class each worker thread is created with.
+  iree_thread_priority_class_t worker_priority_class;
+
+  // Workers placed on performance cores when the topology mixes performance
+  // and efficiency cores. 0 if all workers are assumed to be equally capable.
+  iree_task_affinity_set_t performance_worker_mask;
+
+  // Number of unique NUMA nodes the workers are distributed across.
+  iree_host_size_t node_count;
+
+  // Minimum busy worker imbalance between remote nodes and the local node
+  // required before workers steal across nodes. 0 if unrestricted.
+  uint32_t worker_node_theft_threshold;
+
   // State used by the work-stealing operations performed by donated threads.
   // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
   // much care about the precise selection of workers enough to mind any tears
@@ -87,6 +104,12 @@ struct iree_task_executor_t {
   // coordinator.
   iree_slim_mutex_t coordinator_mutex;
 
+  // Set by any thread requesting coordination and cleared by the coordinator
+  // before it drains the incoming lists. Threads that fail to acquire the
+  // coordinator_mutex hand off their request to the active coordinator via this
+  // flag instead of blocking.
+  iree_atomic_int32_t coordination_requested;
+
   // Wait task polling and wait thread manager.
   // This handles all system waits so that we can keep the syscalls off the
   // worker threads and lower wake latencies (the wait thread can enqueue
@@ -157,10 +180,15 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
 // May steal multiple tasks and add them to the |local_task_queue|.
+// Victims sharing caches as indicated by |constructive_sharing_mask| and then
+// |llc_sharing_mask| are preferred over others and victims on the same NUMA
+// node as indicated by |node_worker_mask| are preferred over remote ones.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_affinity_set_t llc_sharing_mask,
+    iree_task_affinity_set_t node_worker_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
     iree_task_queue_t* local_task_queue);
 
 #ifdef __cplusplus
@@ -6,7 +6,11 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <thread>
+#include <vector>
 
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -133,4 +137,461 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Tests many threads submitting and flushing concurrently. Flushes that race
+// with an active coordinator hand off their work instead of blocking and all of
+// the work must still be scheduled.
+TEST(ExecutorTest, ConcurrentSubmissionStress) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+
+  static constexpr int kThreadCount = 8;
+  static constexpr int kSubmissionCount = 200;
+  std::atomic<int> call_count = {0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&]() {
+      iree_task_scope_t scope;
+      iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+      for (int j = 0; j < kSubmissionCount; ++j) {
+        iree_task_call_t call;
+        iree_task_call_initialize(
+            &scope,
+            iree_task_make_call_closure(
+                [](void* user_context, iree_task_t* task,
+                   iree_task_submission_t* pending_submission) {
+                  ++*(std::atomic<int>*)user_context;
+                  return iree_ok_status();
+                },
+                (void*)&call_count),
+            &call);
+        iree_task_fence_t* fence = NULL;
+        IREE_ASSERT_OK(
+            iree_task_executor_acquire_fence(executor, &scope, &fence));
+        iree_task_set_completion_task(&call.header, &fence->header);
+        iree_task_submission_t submission;
+        iree_task_submission_initialize(&submission);
+        iree_task_submission_enqueue(&submission, &call.header);
+        iree_task_executor_submit(executor, &submission);
+        iree_task_executor_flush(executor);
+        IREE_ASSERT_OK(
+            iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+      }
+      iree_task_scope_deinitialize(&scope);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(call_count, kThreadCount * kSubmissionCount);
+
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that workers using the adaptive idle policy keep running serialized
+// submissions and that their idle behavior is reflected in statistics. Without
+// spinning no wait can be satisfied by a spin.
+TEST(ExecutorTest, AdaptiveSpinStatistics) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+
+  for (iree_duration_t spin_ns : {iree_duration_t{IREE_DURATION_ZERO},
+                                  iree_duration_t{1000000}}) {
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    options.worker_spin_ns = spin_ns;
+    options.worker_idle_policy = IREE_TASK_WORKER_IDLE_POLICY_ADAPTIVE;
+    iree_task_executor_t* executor = NULL;
+    IREE_ASSERT_OK(iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executor));
+    iree_task_scope_t scope;
+    iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+    for (int i = 0; i < 100; ++i) {
+      iree_task_call_t call;
+      iree_task_call_initialize(
+          &scope,
+          iree_task_make_call_closure(
+              [](void* user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                return iree_ok_status();
+              },
+              NULL),
+          &call);
+
+      iree_task_fence_t* fence = NULL;
+      IREE_ASSERT_OK(
+          iree_task_executor_acquire_fence(executor, &scope, &fence));
+      iree_task_set_completion_task(&call.header, &fence->header);
+
+      iree_task_submission_t submission;
+      iree_task_submission_initialize(&submission);
+      iree_task_submission_enqueue(&submission, &call.header);
+      iree_task_executor_submit(executor, &submission);
+      iree_task_executor_flush(executor);
+      IREE_ASSERT_OK(
+          iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+    }
+
+    iree_task_executor_statistics_t statistics;
+    iree_task_executor_query_statistics(executor, &statistics);
+    EXPECT_GT(statistics.worker_spin_hit_count + statistics.worker_park_count,
+              0u);
+    if (spin_ns == IREE_DURATION_ZERO) {
+      EXPECT_EQ(statistics.worker_spin_hit_count, 0u);
+    }
+
+    iree_task_scope_deinitialize(&scope);
+    iree_task_executor_release(executor);
+  }
+
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatches on a multi-node topology stay on the node they were
+// issued to when node-local dispatch is enabled and cross-node theft is
+// effectively disabled.
+TEST(ExecutorTest, NodeLocalDispatch) {
+  // 2 nodes with 2 workers each: workers [0, 1] on node 0, [2, 3] on node 1.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    group.node_id = i / 2;
+    IREE_ASSERT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.scheduling_mode |= IREE_TASK_SCHEDULING_MODE_NODE_LOCAL_DISPATCH;
+  options.worker_node_theft_threshold = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  for (int i = 0; i < 100; ++i) {
+    struct dispatch_state_t {
+      std::atomic<uint32_t> tile_count = {0};
+      std::atomic<uint64_t> worker_mask = {0};
+    } state;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {64, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              auto* state = (dispatch_state_t*)user_context;
+              state->tile_count.fetch_add(1);
+              state->worker_mask.fetch_or(1ull << tile_context->worker_id);
+              return iree_ok_status();
+            },
+            (void*)&state),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(state.tile_count, 64);
+    uint64_t worker_mask = state.worker_mask;
+    EXPECT_TRUE((worker_mask & ~0b0011ull) == 0 ||
+                (worker_mask & ~0b1100ull) == 0)
+        << "dispatch crossed NUMA nodes";
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatches with tile affinity enabled execute every tile exactly
+// once across both the statically assigned blocks and the dynamically reserved
+// remainder.
+TEST(ExecutorTest, DispatchTileAffinity) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.scheduling_mode |= IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  for (uint32_t tile_count : {1u, 3u, 67u, 1000u}) {
+    std::vector<std::atomic<uint32_t>> tile_hits(tile_count);
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              auto* tile_hits = (std::atomic<uint32_t>*)user_context;
+              tile_hits[tile_context->workgroup_xyz[0]].fetch_add(1);
+              return iree_ok_status();
+            },
+            (void*)tile_hits.data()),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      EXPECT_EQ(tile_hits[i], 1u) << "tile " << i;
+    }
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatches with sized shards only fan out to as many workers as
+// their tile count warrants while still executing every tile exactly once.
+TEST(ExecutorTest, DispatchSizedShards) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.scheduling_mode |= IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  const uint32_t min_tiles = IREE_TASK_DISPATCH_MIN_TILES_PER_SHARD;
+  for (uint32_t tile_count : {1u, 3u, min_tiles, 5u, 67u, 1000u}) {
+    struct dispatch_state_t {
+      std::vector<std::atomic<uint32_t>> tile_hits;
+      std::atomic<uint64_t> worker_mask = {0};
+    } state;
+    state.tile_hits = std::vector<std::atomic<uint32_t>>(tile_count);
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              auto* state = (dispatch_state_t*)user_context;
+              state->tile_hits[tile_context->workgroup_xyz[0]].fetch_add(1);
+              state->worker_mask.fetch_or(1ull << tile_context->worker_id);
+              return iree_ok_status();
+            },
+            (void*)&state),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      EXPECT_EQ(state.tile_hits[i], 1u) << "tile " << i;
+    }
+    // Dispatches with no more than the minimum tiles per shard have a single
+    // shard and run entirely on one worker.
+    if (tile_count <= min_tiles) {
+      uint64_t worker_mask = state.worker_mask;
+      EXPECT_TRUE(worker_mask != 0 && (worker_mask & (worker_mask - 1)) == 0)
+          << "tile count " << tile_count;
+    }
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatches on heterogeneous topologies execute every tile exactly
+// once when shards on efficiency cores reserve fewer tiles and small
+// dispatches are restricted to performance cores.
+TEST(ExecutorTest, HeterogeneousDispatch) {
+  // Workers [0, 1] on performance cores and [2, 3] on efficiency cores.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    group.core_type = i < 2 ? IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE
+                            : IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY;
+    IREE_ASSERT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.scheduling_mode |= IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  for (uint32_t tile_count : {1u, 2u, 3u, 67u, 1000u}) {
+    std::vector<std::atomic<uint32_t>> tile_hits(tile_count);
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              auto* tile_hits = (std::atomic<uint32_t>*)user_context;
+              tile_hits[tile_context->workgroup_xyz[0]].fetch_add(1);
+              return iree_ok_status();
+            },
+            (void*)tile_hits.data()),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      EXPECT_EQ(tile_hits[i], 1u) << "tile " << i;
+    }
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that high-priority work posted to a worker busy with a normal priority
+// dispatch runs before the dispatch completes. With a single worker the only
+// way for this to happen is for the dispatch shard to yield at a tile
+// reservation boundary.
+TEST(ExecutorTest, PriorityPreemptsDispatch) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t normal_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("normal"), &normal_scope);
+  iree_task_scope_t high_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("high"), &high_scope);
+  iree_task_scope_set_priority(&high_scope, IREE_TASK_PRIORITY_HIGH);
+
+  struct priority_state_t {
+    std::atomic<uint32_t> tile_count = {0};
+    std::atomic<uint32_t> tile_count_at_call = {0};
+  } state;
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &normal_scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (priority_state_t*)user_context;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            state->tile_count.fetch_add(1);
+            return iree_ok_status();
+          },
+          (void*)&state),
+      workgroup_size, workgroup_count, &dispatch);
+  iree_task_fence_t* normal_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &normal_scope, &normal_fence));
+  iree_task_set_completion_task(&dispatch.header, &normal_fence->header);
+  iree_task_submission_t normal_submission;
+  iree_task_submission_initialize(&normal_submission);
+  iree_task_submission_enqueue(&normal_submission, &dispatch.header);
+  iree_task_executor_submit(executor, &normal_submission);
+  iree_task_executor_flush(executor);
+
+  // Wait for the dispatch to start executing tiles before posting the call.
+  while (state.tile_count.load() == 0) {
+    std::this_thread::yield();
+  }
+
+  iree_task_call_t call;
+  iree_task_call_initialize(
+      &high_scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (priority_state_t*)user_context;
+            state->tile_count_at_call = state->tile_count.load();
+            return iree_ok_status();
+          },
+          (void*)&state),
+      &call);
+  iree_task_fence_t* high_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &high_scope, &high_fence));
+  iree_task_set_completion_task(&call.header, &high_fence->header);
+  iree_task_submission_t high_submission;
+  iree_task_submission_initialize(&high_submission);
+  iree_task_submission_enqueue(&high_submission, &call.header);
+  iree_task_executor_submit(executor, &high_submission);
+  iree_task_executor_flush(executor);
+
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&high_scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&normal_scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(state.tile_count, 64);
+  EXPECT_LT(state.tile_count_at_call, 64);
+
+  iree_task_scope_deinitialize(&high_scope);
+  iree_task_scope_deinitialize(&normal_scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
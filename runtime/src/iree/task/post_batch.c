@@ -14,16 +14,25 @@
 #include "iree/base/internal/threading.h"
 #include "iree/task/executor_impl.h"
 #include "iree/task/queue.h"
+#include "iree/task/scope.h"
 #include "iree/task/worker.h"
 
+iree_host_size_t iree_task_post_batch_size(iree_task_executor_t* executor) {
+  return sizeof(iree_task_post_batch_t) +
+         IREE_TASK_PRIORITY_COUNT * executor->worker_count *
+             sizeof(iree_task_list_t);
+}
+
 void iree_task_post_batch_initialize(iree_task_executor_t* executor,
                                      iree_task_worker_t* current_worker,
                                      iree_task_post_batch_t* out_post_batch) {
   out_post_batch->executor = executor;
   out_post_batch->current_worker = current_worker;
   out_post_batch->worker_pending_mask = 0;
+  out_post_batch->worker_priority_pending_mask = 0;
   memset(&out_post_batch->worker_pending_lifos, 0,
-         executor->worker_count * sizeof(iree_task_list_t));
+         IREE_TASK_PRIORITY_COUNT * executor->worker_count *
+             sizeof(iree_task_list_t));
 }
 
 iree_host_size_t iree_task_post_batch_worker_count(
@@ -31,6 +40,43 @@ iree_host_size_t iree_task_post_batch_worker_count(
   return post_batch->executor->worker_count;
 }
 
+iree_task_affinity_set_t iree_task_post_batch_dispatch_worker_mask(
+    const iree_task_post_batch_t* post_batch, iree_host_size_t worker_index) {
+  iree_task_executor_t* executor = post_batch->executor;
+  if (executor->node_count > 1 &&
+      iree_all_bits_set(executor->scheduling_mode,
+                        IREE_TASK_SCHEDULING_MODE_NODE_LOCAL_DISPATCH)) {
+    return executor->workers[worker_index].node_worker_mask;
+  }
+  return iree_task_affinity_set_ones(executor->worker_count);
+}
+
+iree_task_affinity_set_t iree_task_post_batch_performance_worker_mask(
+    const iree_task_post_batch_t* post_batch) {
+  return post_batch->executor->performance_worker_mask;
+}
+
+bool iree_task_post_batch_dispatch_tile_affinity(
+    const iree_task_post_batch_t* post_batch) {
+  return iree_all_bits_set(post_batch->executor->scheduling_mode,
+                           IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY);
+}
+
+bool iree_task_post_batch_dispatch_sized_shards(
+    const iree_task_post_batch_t* post_batch) {
+  return iree_all_bits_set(post_batch->executor->scheduling_mode,
+                           IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS);
+}
+
+iree_task_affinity_set_t iree_task_post_batch_idle_worker_mask(
+    const iree_task_post_batch_t* post_batch) {
+  // Accessed with 'relaxed' order because the mask is just a hint.
+  iree_task_affinity_set_t worker_idle_mask =
+      iree_atomic_task_affinity_set_load(
+          &post_batch->executor->worker_idle_mask, iree_memory_order_relaxed);
+  return worker_idle_mask & ~post_batch->worker_pending_mask;
+}
+
 static iree_host_size_t iree_task_post_batch_select_random_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set) {
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -87,10 +133,19 @@ iree_host_size_t iree_task_post_batch_select_worker(
 void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
                                   iree_host_size_t worker_index,
                                   iree_task_t* task) {
-  iree_task_list_push_front(&post_batch->worker_pending_lifos[worker_index],
-                            task);
-  post_batch->worker_pending_mask |=
+  iree_task_affinity_set_t worker_bit =
       iree_task_affinity_for_worker(worker_index);
+  if (task->scope &&
+      iree_task_scope_priority(task->scope) > IREE_TASK_PRIORITY_NORMAL) {
+    iree_host_size_t worker_count = post_batch->executor->worker_count;
+    iree_task_list_push_front(
+        &post_batch->worker_pending_lifos[worker_count + worker_index], task);
+    post_batch->worker_priority_pending_mask |= worker_bit;
+  } else {
+    iree_task_list_push_front(&post_batch->worker_pending_lifos[worker_index],
+                              task);
+  }
+  post_batch->worker_pending_mask |= worker_bit;
 }
 
 // Wakes each worker indicated in the |wake_mask|, if needed.
@@ -135,7 +190,11 @@ bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
   // Run through each worker that has a bit set in the pending mask and post
   // the pending tasks.
   iree_task_affinity_set_t worker_mask = post_batch->worker_pending_mask;
+  iree_task_affinity_set_t worker_priority_mask =
+      post_batch->worker_priority_pending_mask;
   post_batch->worker_pending_mask = 0;
+  post_batch->worker_priority_pending_mask = 0;
+  const iree_host_size_t worker_count = post_batch->executor->worker_count;
   int worker_index = 0;
   int post_count = iree_task_affinity_set_count_ones(worker_mask);
   iree_task_affinity_set_t worker_wake_mask = 0;
@@ -148,15 +207,31 @@ bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
     iree_task_worker_t* worker = &post_batch->executor->workers[target_index];
     iree_task_list_t* target_pending_lifo =
         &post_batch->worker_pending_lifos[target_index];
+    iree_task_list_t* target_priority_pending_lifo =
+        &post_batch->worker_pending_lifos[worker_count + target_index];
+    const bool has_priority_tasks =
+        (worker_priority_mask & iree_task_affinity_for_worker(target_index)) !=
+        0;
     if (worker == post_batch->current_worker) {
       // Fast-path for posting to self; this happens when a worker plays the
       // role of coordinator and we want to ensure we aren't doing a fully
       // block-and-flush loop when we could just be popping the next new task
-      // off the list.
+      // off the list. High-priority tasks jump ahead of anything the worker
+      // already has queued.
       iree_task_queue_append_from_lifo_list_unsafe(&worker->local_task_queue,
                                                    target_pending_lifo);
+      if (has_priority_tasks) {
+        iree_task_queue_prepend_from_lifo_list_unsafe(
+            &worker->local_task_queue, target_priority_pending_lifo);
+      }
     } else {
-      iree_task_worker_post_tasks(worker, target_pending_lifo);
+      if (!iree_task_list_is_empty(target_pending_lifo)) {
+        iree_task_worker_post_tasks(worker, target_pending_lifo);
+      }
+      if (has_priority_tasks) {
+        iree_task_worker_post_priority_tasks(worker,
+                                             target_priority_pending_lifo);
+      }
       worker_wake_mask |= iree_task_affinity_for_worker(target_index);
     }
   }
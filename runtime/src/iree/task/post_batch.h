@@ -39,10 +39,20 @@ typedef struct iree_task_post_batch_t {
   // Used to quickly scan the lists and perform the posts only when required.
   iree_task_affinity_set_t worker_pending_mask;
 
-  // A per-worker LIFO task list waiting to be posted.
+  // A bitmask of workers that have pending high-priority tasks. Always a subset
+  // of |worker_pending_mask|.
+  iree_task_affinity_set_t worker_priority_pending_mask;
+
+  // Per-worker LIFO task lists waiting to be posted. The first worker_count
+  // lists hold normal priority tasks and the following worker_count lists hold
+  // high-priority tasks that will be placed ahead of all other work.
+  // Use iree_task_post_batch_size to calculate the required storage.
   iree_task_list_t worker_pending_lifos[0];
 } iree_task_post_batch_t;
 
+// Returns the size in bytes of a post batch for |executor|.
+iree_host_size_t iree_task_post_batch_size(iree_task_executor_t* executor);
+
 void iree_task_post_batch_initialize(iree_task_executor_t* executor,
                                      iree_task_worker_t* current_worker,
                                      iree_task_post_batch_t* out_post_batch);
@@ -51,6 +61,32 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch);
 
+// Returns the set of workers that dispatch shards issued starting at
+// |worker_index| may be posted to. Depending on the executor scheduling mode
+// this may be all workers or only those on the same NUMA node.
+iree_task_affinity_set_t iree_task_post_batch_dispatch_worker_mask(
+    const iree_task_post_batch_t* post_batch, iree_host_size_t worker_index);
+
+// Returns the workers placed on performance cores of a heterogeneous
+// topology or 0 if all workers are assumed to be equally capable.
+iree_task_affinity_set_t iree_task_post_batch_performance_worker_mask(
+    const iree_task_post_batch_t* post_batch);
+
+// Returns true if dispatch tiles should be assigned to workers
+// deterministically (IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY).
+bool iree_task_post_batch_dispatch_tile_affinity(
+    const iree_task_post_batch_t* post_batch);
+
+// Returns true if dispatches should only be sharded across as many workers as
+// their tile count warrants (IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS).
+bool iree_task_post_batch_dispatch_sized_shards(
+    const iree_task_post_batch_t* post_batch);
+
+// Returns the workers that are idle and have not yet had work posted to them
+// as part of the batch. This is only a hint as workers may change state.
+iree_task_affinity_set_t iree_task_post_batch_idle_worker_mask(
+    const iree_task_post_batch_t* post_batch);
+
 // Selects a random worker from the given affinity set.
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
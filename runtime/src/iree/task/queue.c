@@ -42,6 +42,15 @@ void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
   iree_slim_mutex_unlock(&queue->mutex);
 }
 
+void iree_task_queue_prepend_from_lifo_list_unsafe(iree_task_queue_t* queue,
+                                                   iree_task_list_t* list) {
+  // NOTE: reversing the list outside of the lock.
+  iree_task_list_reverse(list);
+  iree_slim_mutex_lock(&queue->mutex);
+  iree_task_list_prepend(&queue->list, list);
+  iree_slim_mutex_unlock(&queue->mutex);
+}
+
 iree_task_t* iree_task_queue_flush_from_lifo_slist(
     iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist) {
   // Perform the flush and swap outside of the lock; acquiring the list is
@@ -61,6 +70,25 @@ iree_task_t* iree_task_queue_flush_from_lifo_slist(
   return next_task;
 }
 
+iree_task_t* iree_task_queue_prepend_from_lifo_slist(
+    iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist) {
+  // Perform the flush and swap outside of the lock; acquiring the list is
+  // atomic and then we own it exclusively.
+  iree_task_list_t prefix;
+  iree_task_list_initialize(&prefix);
+  const bool did_flush = iree_atomic_task_slist_flush(
+      source_slist, IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_FIFO,
+      &prefix.head, &prefix.tail);
+
+  // Prepend the tasks and pop off the front for return.
+  iree_slim_mutex_lock(&queue->mutex);
+  if (did_flush) iree_task_list_prepend(&queue->list, &prefix);
+  iree_task_t* next_task = iree_task_list_pop_front(&queue->list);
+  iree_slim_mutex_unlock(&queue->mutex);
+
+  return next_task;
+}
+
 iree_task_t* iree_task_queue_pop_front(iree_task_queue_t* queue) {
   iree_slim_mutex_lock(&queue->mutex);
   iree_task_t* next_task = iree_task_list_pop_front(&queue->list);
@@ -135,6 +135,13 @@ void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task);
 void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
                                                   iree_task_list_t* list);
 
+// Prepends a LIFO |list| of tasks to the queue such that they are processed
+// before any tasks already in the queue.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_queue_prepend_from_lifo_list_unsafe(iree_task_queue_t* queue,
+                                                   iree_task_list_t* list);
+
 // Flushes the |source_slist| LIFO mailbox into the task queue in FIFO order.
 // Returns the first task in the queue upon success; the task may be
 // pre-existing or from the newly flushed tasks.
@@ -143,6 +150,15 @@ void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
 iree_task_t* iree_task_queue_flush_from_lifo_slist(
     iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist);
 
+// Flushes the |source_slist| LIFO mailbox into the front of the task queue in
+// FIFO order such that the flushed tasks are processed before any tasks already
+// in the queue. Returns the first task in the queue upon success; the task may
+// be pre-existing or from the newly flushed tasks.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_queue_prepend_from_lifo_slist(
+    iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist);
+
 // Pops a task from the front of the queue if any are available.
 //
 // Must only be called from the owning worker's thread.
@@ -17,6 +17,7 @@ void iree_task_scope_initialize(iree_string_view_t name,
   IREE_TRACE_ZONE_BEGIN(z0);
 
   memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->priority = IREE_TASK_PRIORITY_NORMAL;
   iree_atomic_ref_count_init_value(&out_scope->pending_submissions, 0);
 
   iree_host_size_t name_length =
@@ -63,6 +64,15 @@ iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope) {
   return iree_make_cstring_view(scope->name);
 }
 
+iree_task_priority_t iree_task_scope_priority(const iree_task_scope_t* scope) {
+  return scope->priority;
+}
+
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority) {
+  scope->priority = priority;
+}
+
 iree_task_dispatch_statistics_t iree_task_scope_consume_statistics(
     iree_task_scope_t* scope) {
   iree_task_dispatch_statistics_t result = scope->dispatch_statistics;
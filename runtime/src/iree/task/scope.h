@@ -19,6 +19,22 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Scheduling priority class of tasks within a scope.
+// Workers drain higher-priority tasks before any lower-priority ones and
+// lower-priority dispatches yield to higher-priority work posted to the worker
+// at tile reservation boundaries. Priorities only influence ordering of ready
+// tasks and do not guarantee that lower-priority work will not be executing
+// concurrently with higher-priority work.
+typedef enum iree_task_priority_e {
+  // Default priority for throughput-oriented work.
+  IREE_TASK_PRIORITY_NORMAL = 0,
+  // Latency-sensitive work that should preempt normal priority work.
+  IREE_TASK_PRIORITY_HIGH = 1,
+
+  // Total number of priority classes.
+  IREE_TASK_PRIORITY_COUNT = 2,
+} iree_task_priority_t;
+
 // iree_task_scope_t is an atomic reference-counting helper posting a
 // notification when the reference count is decremended to 0.
 //
@@ -52,6 +68,9 @@ typedef struct iree_task_scope_t {
   // The color will be modulated based on task type.
   IREE_TRACE(uint32_t task_trace_color;)
 
+  // Scheduling priority of all tasks attributed to the scope.
+  iree_task_priority_t priority;
+
   // A permanent status code set when a task within the scope fails. All pending
   // tasks will be aborted, though any in-flight tasks may continue executing
   // to completion.
@@ -88,6 +107,15 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope);
 // string.
 iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope);
 
+// Returns the scheduling priority of tasks within the scope.
+iree_task_priority_t iree_task_scope_priority(const iree_task_scope_t* scope);
+
+// Sets the scheduling priority of tasks within the scope.
+// Only tasks submitted after the change are guaranteed to observe the new
+// priority and callers should only change it while the scope is idle.
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority);
+
 // Returns and resets the statistics for the scope.
 // Statistics may experience tearing (non-atomic update across fields) if this
 // is performed while tasks are in-flight.
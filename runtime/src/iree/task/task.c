@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "iree/base/internal/metrics.h"
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
@@ -532,6 +533,7 @@ static void iree_task_dispatch_initialize_base(
   out_task->local_memory_size = 0;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
+  out_task->tile_duration_ns = NULL;
 
   IREE_TRACE({
     static iree_atomic_int64_t next_dispatch_id = IREE_ATOMIC_VAR_INIT(0);
@@ -559,6 +561,84 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
+// Calculates how many tiles each shard reserves at a time from the grid.
+// A higher number reduces overhead and improves locality while a lower number
+// reduces maximum worst-case latency (coarser work stealing).
+static uint32_t iree_task_dispatch_calculate_tiles_per_reservation(
+    const iree_task_dispatch_t* dispatch_task, iree_host_size_t shard_count) {
+  const uint32_t tile_count = dispatch_task->tile_count;
+  const int32_t tile_duration_ns =
+      dispatch_task->tile_duration_ns
+          ? iree_atomic_load_int32(dispatch_task->tile_duration_ns,
+                                   iree_memory_order_relaxed)
+          : 0;
+  if (tile_duration_ns <= 0) {
+    // No estimate available: use a fixed policy based on the grid size.
+    if (tile_count <
+        shard_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+      // Grid is small - allow it to be eagerly sliced up.
+      return 1;
+    }
+    return IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+  }
+
+  // Reserve enough tiles to cover the target duration...
+  uint32_t tiles_per_reservation = (uint32_t)iree_max(
+      1, IREE_TASK_DISPATCH_TARGET_RESERVATION_DURATION_NS / tile_duration_ns);
+  // ...but leave enough reservations so that shards can balance the load...
+  const uint32_t balanced_tiles_per_reservation = (uint32_t)iree_max(
+      1, tile_count /
+             (shard_count * IREE_TASK_DISPATCH_MIN_RESERVATIONS_PER_SHARD));
+  tiles_per_reservation =
+      iree_min(tiles_per_reservation, balanced_tiles_per_reservation);
+  // ...and don't hold on to too many at a time.
+  return iree_min(tiles_per_reservation,
+                  IREE_TASK_DISPATCH_MAX_ADAPTIVE_TILES_PER_SHARD_RESERVATION);
+}
+
+IREE_METRIC_STATIC(iree_task_dispatch_duration_metric,
+                   IREE_METRIC_KIND_HISTOGRAM, "iree_task_dispatch_duration_ns",
+                   "Time from issuing a dispatch to all of its workgroups "
+                   "completing.");
+
+// Returns the first worker in |affinity_set| or worker 0 if there are none.
+// Used instead of randomized selection when tiles must land on the same
+// workers across dispatches.
+static iree_host_size_t iree_task_dispatch_first_worker(
+    const iree_task_post_batch_t* post_batch,
+    iree_task_affinity_set_t affinity_set) {
+  iree_task_affinity_set_t worker_mask =
+      affinity_set & iree_task_affinity_set_ones(
+                         iree_task_post_batch_worker_count(post_batch));
+  return worker_mask ? iree_task_affinity_set_count_trailing_zeros(worker_mask)
+                     : 0;
+}
+
+// Returns the index of the first worker at or after |worker_index| (modulo
+// |worker_count|) that is in |shard_worker_mask|. The mask must not be empty.
+static iree_host_size_t iree_task_dispatch_next_shard_worker(
+    iree_task_affinity_set_t shard_worker_mask, iree_host_size_t worker_count,
+    iree_host_size_t worker_index) {
+  while (!(shard_worker_mask &
+           iree_task_affinity_for_worker(worker_index % worker_count))) {
+    ++worker_index;
+  }
+  return worker_index;
+}
+
+// Returns the capacity of |worker_index| relative to a worker on a performance
+// core as a percentage. All workers have full capacity unless the topology is
+// heterogeneous as indicated by a non-zero |performance_worker_mask|.
+static uint32_t iree_task_dispatch_worker_capacity(
+    iree_task_affinity_set_t performance_worker_mask,
+    iree_host_size_t worker_index) {
+  if (!performance_worker_mask ||
+      (performance_worker_mask & iree_task_affinity_for_worker(worker_index))) {
+    return 100;
+  }
+  return IREE_TASK_DISPATCH_EFFICIENCY_CORE_CAPACITY_PERCENT;
+}
+
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
                               iree_task_submission_t* pending_submission,
@@ -569,6 +649,9 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   // Mark the dispatch as having been issued; the next time it retires it'll be
   // because all work has completed.
   dispatch_task->header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+#if IREE_METRICS_ENABLE
+  dispatch_task->issue_time_ns = iree_time_now();
+#endif  // IREE_METRICS_ENABLE
 
   // Fetch the workgroup count (directly or indirectly).
   if (dispatch_task->header.flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
@@ -597,38 +680,133 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
 #endif  // IREE_HAL_VERBOSE_TRACING_ENABLE
 
   // Setup the iteration space for shards to pull work from the complete grid.
-  iree_atomic_store_int32(&dispatch_task->tile_index, 0,
-                          iree_memory_order_relaxed);
   dispatch_task->tile_count =
       workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
 
+  // Randomize starting worker unless tiles are assigned to workers
+  // deterministically, in which case shard i always lands on the i-th worker
+  // following the first worker in the affinity set.
+  const bool tile_affinity =
+      iree_task_post_batch_dispatch_tile_affinity(post_batch);
+  iree_host_size_t worker_offset =
+      tile_affinity
+          ? iree_task_dispatch_first_worker(post_batch,
+                                            dispatch_task->header.affinity_set)
+          : iree_task_post_batch_select_worker(
+                post_batch, dispatch_task->header.affinity_set);
+  iree_host_size_t worker_index = worker_offset;
+
+  // Workers the shards may be posted to. This is usually all workers but may
+  // be restricted to those on the same NUMA node as the starting worker.
+  iree_task_affinity_set_t shard_worker_mask =
+      iree_task_post_batch_dispatch_worker_mask(post_batch, worker_offset);
+
+  // On heterogeneous topologies dispatches with no more tiles than there are
+  // performance cores are kept off of the efficiency cores: each shard will
+  // only execute a single tile and the dispatch would otherwise not complete
+  // until the slowest core had finished its tile.
+  const iree_task_affinity_set_t performance_worker_mask =
+      iree_task_post_batch_performance_worker_mask(post_batch);
+  const iree_task_affinity_set_t performance_shard_worker_mask =
+      shard_worker_mask & performance_worker_mask;
+  if (performance_shard_worker_mask &&
+      dispatch_task->tile_count <=
+          iree_task_affinity_set_count_ones(performance_shard_worker_mask)) {
+    shard_worker_mask = performance_shard_worker_mask;
+  }
+
   // Compute shard count - almost always worker_count unless we are a very small
   // dispatch (1x1x1, etc).
   iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
+  iree_host_size_t shard_worker_count =
+      iree_task_affinity_set_count_ones(shard_worker_mask);
+
+  // With sized dispatch shards small dispatches only fan out to as many
+  // workers as they can keep busy so that dispatches from concurrent
+  // submissions run side by side on their own workers instead of interleaving
+  // across all of them. Idle workers are preferred unless tiles are assigned
+  // to workers deterministically.
+  if (iree_task_post_batch_dispatch_sized_shards(post_batch)) {
+    const iree_host_size_t sized_worker_count = iree_max(
+        1, (dispatch_task->tile_count + IREE_TASK_DISPATCH_MIN_TILES_PER_SHARD -
+            1) / IREE_TASK_DISPATCH_MIN_TILES_PER_SHARD);
+    if (sized_worker_count < shard_worker_count) {
+      shard_worker_count = sized_worker_count;
+      const iree_task_affinity_set_t idle_shard_worker_mask =
+          shard_worker_mask & iree_task_post_batch_idle_worker_mask(post_batch);
+      if (!tile_affinity && iree_task_affinity_set_count_ones(
+                                idle_shard_worker_mask) >= shard_worker_count) {
+        shard_worker_mask = idle_shard_worker_mask;
+      }
+    }
+  }
+
   iree_host_size_t shard_count =
-      iree_min(dispatch_task->tile_count, worker_count);
+      iree_min(dispatch_task->tile_count, shard_worker_count);
 
   // Compute how many tiles we want each shard to reserve at a time from the
-  // larger grid. A higher number reduces overhead and improves locality while
-  // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (dispatch_task->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
-    // Grid is small - allow it to be eagerly sliced up.
-    dispatch_task->tiles_per_reservation = 1;
-  } else {
-    dispatch_task->tiles_per_reservation =
-        IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
-  }
+  // larger grid.
+  dispatch_task->tiles_per_reservation =
+      iree_task_dispatch_calculate_tiles_per_reservation(dispatch_task,
+                                                         shard_worker_count);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, dispatch_task->tiles_per_reservation);
+  IREE_TRACE_PLOT_VALUE_I64("iree_task_dispatch_tiles_per_reservation",
+                            dispatch_task->tiles_per_reservation);
+
+  // With tile affinity each shard owns a contiguous block of the leading tiles
+  // so that tile i maps to the same shard (and worker) in every dispatch with
+  // the same tile and shard counts. Shards reserve the remaining tiles from
+  // the shared index after finishing their blocks.
+  const uint32_t static_tile_count =
+      tile_affinity ? (uint32_t)(((uint64_t)dispatch_task->tile_count *
+                                  IREE_TASK_DISPATCH_AFFINITY_TILE_PERCENT) /
+                                 100)
+                    : 0;
+  iree_atomic_store_int32(&dispatch_task->tile_index, static_tile_count,
+                          iree_memory_order_relaxed);
 
-  // Randomize starting worker.
-  iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
-      post_batch, dispatch_task->header.affinity_set);
-  iree_host_size_t worker_index = worker_offset;
+  // Static tile blocks are sized by the relative capacity of the worker each
+  // shard is posted to so that shards on efficiency cores finish their blocks
+  // around the same time as those on performance cores. The workers are
+  // selected in the same order as the shards are posted below.
+  uint32_t total_capacity = 0;
+  if (static_tile_count > 0) {
+    iree_host_size_t capacity_worker_index = worker_index;
+    for (iree_host_size_t i = 0; i < shard_count; ++i) {
+      capacity_worker_index = iree_task_dispatch_next_shard_worker(
+          shard_worker_mask, worker_count, capacity_worker_index);
+      total_capacity += iree_task_dispatch_worker_capacity(
+          performance_worker_mask, capacity_worker_index % worker_count);
+      ++capacity_worker_index;
+    }
+  }
 
+  uint32_t capacity_base = 0;
   for (iree_host_size_t i = 0; i < shard_count; ++i) {
+    // Skip over workers not in the shard worker set. There are at least
+    // shard_count workers in it so this will always terminate.
+    worker_index = iree_task_dispatch_next_shard_worker(
+        shard_worker_mask, worker_count, worker_index);
+    const uint32_t capacity = iree_task_dispatch_worker_capacity(
+        performance_worker_mask, worker_index % worker_count);
+
     // Allocate and initialize the shard.
     iree_task_dispatch_shard_t* shard_task =
         iree_task_dispatch_shard_allocate(dispatch_task, shard_task_pool);
+    shard_task->tiles_per_reservation = iree_max(
+        1, (uint32_t)(((uint64_t)dispatch_task->tiles_per_reservation *
+                       capacity) /
+                      100));
+    if (total_capacity > 0) {
+      shard_task->tile_base =
+          (uint32_t)(((uint64_t)static_tile_count * capacity_base) /
+                     total_capacity);
+      shard_task->tile_end =
+          (uint32_t)(((uint64_t)static_tile_count *
+                      (capacity_base + capacity)) /
+                     total_capacity);
+      capacity_base += capacity;
+    }
 
     // Enqueue on the worker selected for the task.
     iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
@@ -657,6 +835,11 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 
   // TODO(benvanik): attach statistics to the tracy zone.
 
+#if IREE_METRICS_ENABLE
+  iree_metric_record(&iree_task_dispatch_duration_metric,
+                     iree_time_now() - dispatch_task->issue_time_ns);
+#endif  // IREE_METRICS_ENABLE
+
   // Merge the statistics from the dispatch into the scope so we can track all
   // of the work without tracking all the dispatches at a global level.
   iree_task_dispatch_statistics_merge(
@@ -693,6 +876,13 @@ void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
   iree_task_initialize(IREE_TASK_TYPE_DISPATCH_SHARD,
                        dispatch_task->header.scope, &out_task->header);
   iree_task_set_completion_task(&out_task->header, &dispatch_task->header);
+  // Workers select their FPU state from the shard being executed.
+  out_task->header.flags |= dispatch_task->header.flags &
+                            (IREE_TASK_FLAG_DISPATCH_PRESERVE_DENORMALS |
+                             IREE_TASK_FLAG_DISPATCH_FPU_AGNOSTIC);
+  out_task->tile_base = 0;
+  out_task->tile_end = 0;
+  out_task->tiles_per_reservation = dispatch_task->tiles_per_reservation;
 }
 
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
@@ -709,9 +899,54 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
-void iree_task_dispatch_shard_execute(
+// Updates the running |tile_duration_ns| estimate with a new sample.
+// Samples are averaged to smooth out noise (such as a shard being preempted).
+static void iree_task_dispatch_update_tile_duration(
+    iree_atomic_int32_t* tile_duration_ns, iree_duration_t sample_ns) {
+  const int32_t clamped_sample_ns =
+      (int32_t)iree_min(iree_max(sample_ns, 1), INT32_MAX);
+  const int32_t estimate_ns =
+      iree_atomic_load_int32(tile_duration_ns, iree_memory_order_relaxed);
+  const int32_t new_estimate_ns =
+      estimate_ns <= 0 ? clamped_sample_ns
+                       : (int32_t)(estimate_ns +
+                                   ((int64_t)clamped_sample_ns - estimate_ns) /
+                                       4);
+  iree_atomic_store_int32(tile_duration_ns, iree_max(1, new_estimate_ns),
+                          iree_memory_order_relaxed);
+}
+
+// Reserves the next range of tiles [|out_tile_base|, |out_tile_range|) for
+// the shard to execute. Tiles statically assigned to the shard are consumed
+// first and then tiles are reserved from the grid shared with all other shards.
+// Returns false if there are no more tiles to execute.
+static bool iree_task_dispatch_shard_reserve(
+    iree_task_dispatch_shard_t* task, iree_task_dispatch_t* dispatch_task,
+    uint32_t* out_tile_base, uint32_t* out_tile_range) {
+  const uint32_t tiles_per_reservation = task->tiles_per_reservation;
+  if (task->tile_base < task->tile_end) {
+    *out_tile_base = task->tile_base;
+    *out_tile_range =
+        iree_min(task->tile_base + tiles_per_reservation, task->tile_end);
+    task->tile_base = *out_tile_range;
+    return true;
+  }
+  // relaxed order because we only care about atomic increments, not about
+  // ordering of tile_index accesses w.r.t. other memory accesses.
+  const uint32_t tile_count = dispatch_task->tile_count;
+  const uint32_t tile_base = iree_atomic_fetch_add_int32(
+      &dispatch_task->tile_index, tiles_per_reservation,
+      iree_memory_order_relaxed);
+  if (tile_base >= tile_count) return false;
+  *out_tile_base = tile_base;
+  *out_tile_range = iree_min(tile_base + tiles_per_reservation, tile_count);
+  return true;
+}
+
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* preempt_flag,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -734,7 +969,7 @@ void iree_task_dispatch_shard_execute(
                          worker_local_memory.data_length));
     iree_task_retire(&task->header, pending_submission, iree_ok_status());
     IREE_TRACE_ZONE_END(z0);
-    return;
+    return false;
   }
   iree_byte_span_t local_memory = iree_make_byte_span(
       worker_local_memory.data, dispatch_task->local_memory_size);
@@ -760,19 +995,33 @@ void iree_task_dispatch_shard_execute(
   // Hint as to which processor we are running on.
   tile_context.processor_id = processor_id;
 
+  // Measure how long tiles take to update the running estimate, if any.
+  iree_time_t start_time_ns =
+      dispatch_task->tile_duration_ns ? iree_time_now() : 0;
+  uint32_t executed_tile_count = 0;
+
+  // High-priority dispatches never yield.
+  if (dispatch_task->header.scope &&
+      iree_task_scope_priority(dispatch_task->header.scope) >=
+          IREE_TASK_PRIORITY_HIGH) {
+    preempt_flag = NULL;
+  }
+  bool yielded = false;
+
+  // Dispatches that accept tile ranges are issued once per reservation and
+  // all others once per tile.
+  const bool tile_ranges =
+      (dispatch_task->header.flags & IREE_TASK_FLAG_DISPATCH_TILE_RANGES) != 0;
+  tile_context.tile_count = 1;
+
   // Loop over all tiles until they are all processed.
-  const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
-  // relaxed order because we only care about atomic increments, not about
-  // ordering of tile_index accesses w.r.t. other memory accesses.
-  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                                   tiles_per_reservation,
-                                                   iree_memory_order_relaxed);
-  while (tile_base < tile_count) {
-    const uint32_t tile_range =
-        iree_min(tile_base + tiles_per_reservation, tile_count);
+  uint32_t tile_base = 0;
+  uint32_t tile_range = 0;
+  while (iree_task_dispatch_shard_reserve(task, dispatch_task, &tile_base,
+                                          &tile_range)) {
     for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
+         tile_index += tile_context.tile_count) {
+      if (tile_ranges) tile_context.tile_count = tile_range - tile_index;
       // TODO(benvanik): faster math here, especially knowing we pull off N
       // sequential indices per reservation.
       uint32_t tile_i = tile_index;
@@ -813,12 +1062,34 @@ void iree_task_dispatch_shard_execute(
         goto abort_shard;  // out of the while-for nest
       }
     }
+    executed_tile_count += tile_range - tile_base;
+
+    // Yield to higher-priority work before reserving more tiles. The only
+    // state the shard carries is its remaining statically assigned tiles
+    // (stored in the task) and otherwise it resumes from wherever the other
+    // shards are in the shared dispatch counter when it is executed again.
+    // Nothing is gained by yielding if all tiles have already been reserved as
+    // the shard would just retire upon resuming.
+    if (preempt_flag &&
+        iree_atomic_load_int32(preempt_flag, iree_memory_order_relaxed) &&
+        (task->tile_base < task->tile_end ||
+         (uint32_t)iree_atomic_load_int32(&dispatch_task->tile_index,
+                                          iree_memory_order_relaxed) <
+             dispatch_task->tile_count)) {
+      yielded = true;
+      break;
+    }
+  }
 
-    // Try to grab the next slice of tiles.
-    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                            tiles_per_reservation,
-                                            iree_memory_order_relaxed);
+  // Fold the measured tile duration into the running estimate. This is racy
+  // with other shards and dispatches updating the estimate concurrently but
+  // it's only a hint and the last update winning is fine.
+  if (dispatch_task->tile_duration_ns && executed_tile_count > 0) {
+    iree_task_dispatch_update_tile_duration(
+        dispatch_task->tile_duration_ns,
+        (iree_time_now() - start_time_ns) / executed_tile_count);
   }
+
 abort_shard:
 
   // Push aggregate statistics up to the dispatch.
@@ -827,8 +1098,16 @@ abort_shard:
   iree_task_dispatch_statistics_merge(&shard_statistics,
                                       &dispatch_task->statistics);
 
+  // Yielded shards remain live and will be executed again by the caller.
+  if (yielded) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "yielded");
+    IREE_TRACE_ZONE_END(z0);
+    return true;
+  }
+
   // NOTE: even if an error was hit we retire OK - the error has already been
   // propagated to the dispatch and it'll clean up after all shards are joined.
   iree_task_retire(&task->header, pending_submission, iree_ok_status());
   IREE_TRACE_ZONE_END(z0);
+  return false;
 }
@@ -117,6 +117,22 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // The dispatch closure can process a contiguous range of tiles per call.
+  // Each tile reservation made by a shard is issued as a single call with
+  // iree_task_tile_context_t::tile_count set to the number of tiles in the
+  // range instead of one call per tile.
+  IREE_TASK_FLAG_DISPATCH_TILE_RANGES = 1u << 6,
+
+  // The dispatch closure requires IEEE denormal handling. Workers otherwise
+  // execute with denormals flushed to zero and will switch their FPU state
+  // before executing shards of the dispatch.
+  IREE_TASK_FLAG_DISPATCH_PRESERVE_DENORMALS = 1u << 7,
+
+  // The dispatch closure does not depend on the FPU state. Workers execute it
+  // in whatever state they are in so that runs of dispatches with differing
+  // requirements interleaved with agnostic ones need not switch back and forth.
+  IREE_TASK_FLAG_DISPATCH_FPU_AGNOSTIC = 1u << 8,
 };
 typedef uint16_t iree_task_flags_t;
 
@@ -524,6 +540,9 @@ typedef struct iree_task_tile_storage_t {
 typedef iree_alignas(iree_max_align_t) struct {
   // Workgroup ID for the current invocation.
   uint32_t workgroup_xyz[3];
+  // Number of tiles to process starting at workgroup_xyz in x-major order.
+  // Always 1 unless the dispatch has IREE_TASK_FLAG_DISPATCH_TILE_RANGES set.
+  uint32_t tile_count;
   // Workgroup size for each invocation.
   uint32_t workgroup_size[3];
   // Total workgroup count for the task. Can be used in conjunction with the
@@ -646,6 +665,13 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // reasonable number chosen based on the tile and shard counts.
   uint32_t tiles_per_reservation;
 
+  // Optional running estimate of the duration of a single tile in nanoseconds
+  // shared by all dispatches of the same function (such as an executable entry
+  // point). When provided tile reservations are sized from the estimate and
+  // shards update it as they execute. 0 indicates no estimate is available yet.
+  // The storage must remain valid until the dispatch has retired.
+  iree_atomic_int32_t* tile_duration_ns;
+
   // The tail tile index; the next reservation will start from here.
   // This is used by shards to slice off the work to perform in their inner
   // loop. Ideally we'd have no destructive interference with other shared data
@@ -653,6 +679,11 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // per shard instead of once per slice and are less of a concern.
   iree_atomic_int32_t tile_index;
 
+#if IREE_METRICS_ENABLE
+  // Time the dispatch was issued used to record its duration when retired.
+  iree_time_t issue_time_ns;
+#endif  // IREE_METRICS_ENABLE
+
   // Incrementing process-lifetime dispatch identifier.
   IREE_TRACE(int64_t dispatch_id;)
 } iree_task_dispatch_t;
@@ -678,6 +709,17 @@ typedef iree_alignas(iree_max_align_t) struct {
 
   // NOTE: the parent dispatch task this shard is applied to is in the
   // header.completion_task field.
+
+  // Tiles statically assigned to the shard in [tile_base, tile_end) that have
+  // not yet been executed. Executed before reserving tiles from the dispatch
+  // and only populated with IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY.
+  uint32_t tile_base;
+  uint32_t tile_end;
+
+  // Number of tiles the shard reserves at a time. Derived from the dispatch
+  // tiles_per_reservation and scaled down for shards posted to efficiency
+  // cores so that they do not hold up the dispatch with large reservations.
+  uint32_t tiles_per_reservation;
 } iree_task_dispatch_shard_t;
 
 void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
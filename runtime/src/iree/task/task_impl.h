@@ -118,11 +118,18 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
 //
+// |preempt_flag| is an optional flag that is polled at tile reservation
+// boundaries. If the shard is from a scope with less than high priority and the
+// flag is set while tiles remain then the shard yields prior to reserving more
+// tiles and returns true without retiring. The caller must requeue the shard to
+// have it resume processing tiles later.
+//
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
-void iree_task_dispatch_shard_execute(
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* preempt_flag,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
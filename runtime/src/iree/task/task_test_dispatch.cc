@@ -113,6 +113,29 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+// Tests that dispatches sharing a tile duration estimate cover their grids as
+// the estimate is established and reservation sizes change.
+TEST_F(TaskDispatchTest, IssueTileDurationEstimate) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 16, 3};
+  iree_atomic_int32_t tile_duration_ns = IREE_ATOMIC_VAR_INIT(0);
+  for (int i = 0; i < 4; ++i) {
+    GridCoverage coverage(kWorkgroupCount);
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
+        kWorkgroupSize, kWorkgroupCount, &task);
+    task.tile_duration_ns = &tile_duration_ns;
+    IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+    EXPECT_TRUE(coverage.Verify());
+    EXPECT_GT(iree_atomic_load_int32(&tile_duration_ns,
+                                     iree_memory_order_relaxed),
+              0);
+  }
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
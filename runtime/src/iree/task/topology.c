@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/math.h"
 
 void iree_task_topology_group_initialize(
     uint8_t group_index, iree_task_topology_group_t* out_group) {
@@ -19,6 +20,7 @@ void iree_task_topology_group_initialize(
            group_index);
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
   out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+  out_group->llc_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
 }
 
 void iree_task_topology_initialize(iree_task_topology_t* out_topology) {
@@ -76,10 +78,10 @@ iree_status_t iree_task_topology_push_group(
   return iree_ok_status();
 }
 
-// Fixes constructive_sharing_mask values such that they represent other chosen
-// topology groups instead of processor indices. We do this so that code using
-// the topology groups doesn't need to know anything about which physical
-// processor IDs a particular group is mapped to.
+// Fixes constructive_sharing_mask and llc_sharing_mask values such that they
+// represent other chosen topology groups instead of processor indices. We do
+// this so that code using the topology groups doesn't need to know anything
+// about which physical processor IDs a particular group is mapped to.
 //
 // This is implemented by platform-specific logic and may be a no-op if the
 // platform doesn't support querying the required cache information.
@@ -165,3 +167,174 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set_string(
   return iree_task_topology_initialize_from_logical_cpu_set(cpu_count, cpu_ids,
                                                             out_topology);
 }
+
+// Remaps |mask| of groups in a source topology to the indices the groups were
+// assigned in a topology built from a subset of them. |group_map| maps source
+// group indices to the new indices or -1 if the group was not selected.
+static iree_task_topology_group_mask_t iree_task_topology_remap_group_mask(
+    iree_task_topology_group_mask_t mask, iree_host_size_t group_count,
+    const int8_t* group_map) {
+  if (mask == IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) return mask;
+  iree_task_topology_group_mask_t new_mask = 0;
+  while (mask) {
+    int i = iree_math_count_trailing_zeros_u64(mask);
+    mask &= mask - 1;
+    if (i < group_count && group_map[i] >= 0) {
+      new_mask |= 1ull << group_map[i];
+    }
+  }
+  return new_mask;
+}
+
+iree_status_t iree_task_topology_initialize_from_core_type(
+    const iree_task_topology_t* source_topology,
+    iree_task_topology_core_type_t core_type, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology) {
+  IREE_ASSERT_ARGUMENT(source_topology);
+  IREE_ASSERT_ARGUMENT(out_topology);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)core_type);
+
+  // Select the groups of the requested type. The order of the selected groups
+  // is preserved so that the selection still avoids the calling thread's core
+  // where possible.
+  int8_t group_map[IREE_ARRAYSIZE(source_topology->groups)];
+  iree_host_size_t selected_count = 0;
+  for (iree_host_size_t i = 0; i < source_topology->group_count; ++i) {
+    group_map[i] = -1;
+    if ((core_type == IREE_TASK_TOPOLOGY_CORE_TYPE_ANY ||
+         source_topology->groups[i].core_type == core_type) &&
+        selected_count < max_core_count) {
+      group_map[i] = (int8_t)selected_count++;
+    }
+  }
+
+  iree_task_topology_initialize(out_topology);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < source_topology->group_count; ++i) {
+    if (group_map[i] < 0) continue;
+    iree_task_topology_group_t group = source_topology->groups[i];
+    group.constructive_sharing_mask = iree_task_topology_remap_group_mask(
+        group.constructive_sharing_mask, source_topology->group_count,
+        group_map);
+    group.llc_sharing_mask = iree_task_topology_remap_group_mask(
+        group.llc_sharing_mask, source_topology->group_count, group_map);
+    snprintf(group.name, IREE_ARRAYSIZE(group.name), "iree-worker-%d",
+             group_map[i]);
+    status = iree_task_topology_push_group(out_topology, &group);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_type(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_type_t core_type, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology) {
+  if (core_type == IREE_TASK_TOPOLOGY_CORE_TYPE_ANY) {
+    return iree_task_topology_initialize_from_physical_cores(
+        node_id, max_core_count, out_topology);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)core_type);
+
+  // Query all cores on the node and select those of the requested type.
+  iree_task_topology_t all_topology;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_task_topology_initialize_from_physical_cores(
+              node_id, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT, &all_topology));
+  iree_status_t status = iree_task_topology_initialize_from_core_type(
+      &all_topology, core_type, max_core_count, out_topology);
+  iree_task_topology_deinitialize(&all_topology);
+  if (iree_status_is_ok(status) &&
+      iree_task_topology_group_count(out_topology) == 0) {
+    // No cores of the requested type (or the types are unknown).
+    iree_task_topology_deinitialize(out_topology);
+    status = iree_task_topology_initialize_from_physical_cores(
+        node_id, max_core_count, out_topology);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_task_topology_initialize_from_physical_cores_on_nodes(
+    uint64_t node_mask, iree_host_size_t max_core_count_per_node,
+    iree_task_topology_t* out_topology) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)node_mask);
+  iree_task_topology_initialize(out_topology);
+
+  iree_status_t status = iree_ok_status();
+  uint64_t node_mask_bits = node_mask;
+  while (node_mask_bits) {
+    iree_task_topology_node_id_t node_id =
+        (iree_task_topology_node_id_t)iree_math_count_trailing_zeros_u64(
+            node_mask_bits);
+    node_mask_bits &= node_mask_bits - 1;
+
+    // Query the node in isolation; the resulting groups are relative to the
+    // node topology and must be rebased onto the combined topology.
+    iree_task_topology_t node_topology;
+    status = iree_task_topology_initialize_from_physical_cores(
+        node_id, max_core_count_per_node, &node_topology);
+    if (!iree_status_is_ok(status)) break;
+
+    const iree_host_size_t base_index = out_topology->group_count;
+    if (base_index + node_topology.group_count >
+        IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
+      iree_task_topology_deinitialize(&node_topology);
+      status = iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "too many groups across the selected NUMA nodes (%" PRIhsz
+          " exceeds a max capacity of %zu); lower the per-node core count",
+          base_index + node_topology.group_count,
+          IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
+      break;
+    }
+
+    const iree_task_topology_group_mask_t node_group_mask =
+        node_topology.group_count == IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT
+            ? IREE_TASK_TOPOLOGY_GROUP_MASK_ALL
+            : (1ull << node_topology.group_count) - 1;
+    for (iree_host_size_t i = 0; i < node_topology.group_count; ++i) {
+      iree_task_topology_group_t group = node_topology.groups[i];
+      group.node_id = node_id;
+      // Sharing masks are relative to the node topology; clamp them to the
+      // node (undefined/all sharing only applies within the node) and shift
+      // them to where the node groups now live.
+      group.constructive_sharing_mask =
+          (group.constructive_sharing_mask & node_group_mask) << base_index;
+      group.llc_sharing_mask = (group.llc_sharing_mask & node_group_mask)
+                               << base_index;
+      snprintf(group.name, IREE_ARRAYSIZE(group.name), "iree-worker-%" PRIhsz,
+               base_index + i);
+      status = iree_task_topology_push_group(out_topology, &group);
+      if (!iree_status_is_ok(status)) break;
+    }
+    iree_task_topology_deinitialize(&node_topology);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_host_size_t iree_task_topology_query_group_node_count(
+    const iree_task_topology_t* topology) {
+  // O(n^2) but n is always <= 64 and this is only used during setup.
+  iree_host_size_t node_count = 0;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    bool is_unique = true;
+    for (iree_host_size_t j = 0; j < i; ++j) {
+      if (topology->groups[j].node_id == topology->groups[i].node_id) {
+        is_unique = false;
+        break;
+      }
+    }
+    if (is_unique) ++node_count;
+  }
+  return node_count;
+}
@@ -49,6 +49,18 @@ typedef uint64_t iree_task_topology_group_mask_t;
 #define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT \
   (sizeof(iree_task_topology_group_mask_t) * 8)
 
+// Identifies the class of core a group is assigned to on heterogeneous
+// systems (ARM big.LITTLE/DynamIQ, Intel hybrid P/E cores, Apple P/E cores).
+typedef enum iree_task_topology_core_type_e {
+  // Core type is unknown or the system is homogeneous. When used as a
+  // preference this matches all cores.
+  IREE_TASK_TOPOLOGY_CORE_TYPE_ANY = 0,
+  // A high-performance core (big/prime/P-core).
+  IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE = 1,
+  // A power-efficient core (LITTLE/E-core) in the lowest performance tier.
+  IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY = 2,
+} iree_task_topology_core_type_t;
+
 // Information about a particular group within the topology.
 // Groups may be of varying levels of granularity even within the same topology
 // based on how the topology is defined.
@@ -63,6 +75,15 @@ typedef struct iree_task_topology_group_t {
   // Processor index in the cpuinfo set.
   uint32_t processor_index;
 
+  // NUMA node the processor is attached to or 0 if unknown.
+  // Workers in groups on the same node share a memory controller and are
+  // preferred over remote nodes when distributing and stealing work.
+  iree_task_topology_node_id_t node_id;
+
+  // Class of the core the group is assigned to or
+  // IREE_TASK_TOPOLOGY_CORE_TYPE_ANY if unknown or the system is homogeneous.
+  iree_task_topology_core_type_t core_type;
+
   // Ideal thread affinity for threads within this group.
   // All threads within the group share the same affinity and this is what
   // allows us to model Simultaneous Multi-Threading (SMT) (aka hyperthreading).
@@ -74,6 +95,13 @@ typedef struct iree_task_topology_group_t {
   // workers in a group all share an L2 cache then the groups indicated here may
   // all share the same L3 cache.
   iree_task_topology_group_mask_t constructive_sharing_mask;
+
+  // A bitmask of other group indices that share the last level cache (usually
+  // L3) with this group. This is a superset of the groups in
+  // |constructive_sharing_mask| on platforms that report both and defines the
+  // cache domain (CCX/CCD/cluster) outside of which stealing work implies
+  // refetching everything it touches from memory or a remote cache.
+  iree_task_topology_group_mask_t llc_sharing_mask;
 } iree_task_topology_group_t;
 
 // Initializes |out_group| with a |group_index| derived name.
@@ -183,6 +211,47 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
     iree_task_topology_t* out_topology);
 
+// Initializes a topology with up to |max_core_count| of the groups in
+// |source_topology| that are assigned to cores of |core_type| (or all groups
+// if IREE_TASK_TOPOLOGY_CORE_TYPE_ANY). Sharing masks are remapped to the new
+// group indices. The resulting topology is empty if no groups match.
+iree_status_t iree_task_topology_initialize_from_core_type(
+    const iree_task_topology_t* source_topology,
+    iree_task_topology_core_type_t core_type, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology);
+
+// Initializes a topology with one group for each physical core with the given
+// NUMA |node_id| and |core_type| as detected on heterogeneous systems. Up to
+// |max_core_count| physical cores will be selected. If no cores of the
+// requested type are found (homogeneous systems or platforms where core types
+// cannot be queried) this behaves as
+// iree_task_topology_initialize_from_physical_cores.
+//
+// Latency-critical workloads on mobile devices should prefer
+// IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE so that workers are pinned to the
+// big cores instead of wherever the OS happens to place them.
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_type(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_type_t core_type, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology);
+
+// Initializes a topology spanning every NUMA node set in |node_mask| with one
+// group for each physical core on each node. Up to |max_core_count_per_node|
+// physical cores will be selected from each node and groups are ordered by
+// node such that all groups of a node are contiguous. Each group has its
+// |node_id| set and constructive sharing masks never cross nodes.
+//
+// A single executor created from the resulting topology will keep work on the
+// node it was issued on where possible; see
+// iree_task_executor_options_t::worker_node_theft_threshold.
+iree_status_t iree_task_topology_initialize_from_physical_cores_on_nodes(
+    uint64_t node_mask, iree_host_size_t max_core_count_per_node,
+    iree_task_topology_t* out_topology);
+
+// Returns the number of unique NUMA nodes referenced by groups in |topology|.
+iree_host_size_t iree_task_topology_query_group_node_count(
+    const iree_task_topology_t* topology);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
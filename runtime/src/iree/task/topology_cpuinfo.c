@@ -180,6 +180,29 @@ static void iree_task_topology_set_affinity_from_processor(
 #endif  // cpuinfo-like platform field
 }
 
+// Returns the class of |core| on heterogeneous systems.
+// cpuinfo reports the maximum frequency of each core (on Linux/Android) and
+// cores in the lowest frequency tier are treated as efficiency cores while all
+// others (big/prime on 3-tier ARM systems) are treated as performance cores.
+// Systems where all cores have the same maximum frequency or where it is not
+// reported are treated as homogeneous.
+static iree_task_topology_core_type_t iree_task_topology_query_core_type(
+    const struct cpuinfo_core* core) {
+  if (!core->frequency) return IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+  uint64_t min_frequency = UINT64_MAX;
+  uint64_t max_frequency = 0;
+  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); ++i) {
+    uint64_t frequency = cpuinfo_get_core(i)->frequency;
+    if (!frequency) return IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+    min_frequency = iree_min(min_frequency, frequency);
+    max_frequency = iree_max(max_frequency, frequency);
+  }
+  if (min_frequency == max_frequency) return IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+  return core->frequency == min_frequency
+             ? IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY
+             : IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE;
+}
+
 // Populates |out_group| with the information from |processor|.
 static void iree_task_topology_group_initialize_from_processor(
     uint32_t group_index, const struct cpuinfo_processor* processor,
@@ -191,6 +214,8 @@ static void iree_task_topology_group_initialize_from_processor(
   out_group->processor_index =
       processor->core->processor_start + processor->smt_id;
 #endif  // __linux__
+  out_group->node_id = processor->cluster->cluster_id;
+  out_group->core_type = iree_task_topology_query_core_type(processor->core);
   iree_task_topology_set_affinity_from_processor(
       processor, &out_group->ideal_thread_affinity);
 }
@@ -232,12 +257,42 @@ static uint64_t iree_task_topology_calculate_constructive_sharing_mask(
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1i);
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1d);
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l2);
-  // TODO(benvanik): include L3 here too (for systems that have it)? Or use L3
-  // info purely for distribution and focus the group mask on lower-latency
-  // caches?
+  // NOTE: L3 info is kept separate (see below) so that the group mask can
+  // focus on the lower-latency caches.
+  return mask;
+}
+
+// Constructs a sharing mask for all *processors* that share the last level
+// cache with the specified |processor|. Falls back to the constructive sharing
+// mask if the processor has no L3 (or L4) cache reported.
+static uint64_t iree_task_topology_calculate_llc_sharing_mask(
+    const struct cpuinfo_processor* processor) {
+  uint64_t mask = 0;
+  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l4);
+  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l3);
+  if (!mask) {
+    mask = iree_task_topology_calculate_constructive_sharing_mask(processor);
+  }
   return mask;
 }
 
+// Maps a mask of *processors* to a mask of the groups in |topology| that are
+// assigned to those processors.
+static iree_task_topology_group_mask_t
+iree_task_topology_map_processor_mask_to_groups(
+    const iree_task_topology_t* topology, uint64_t processor_mask) {
+  iree_task_topology_group_mask_t group_mask = 0;
+  for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
+    const iree_task_topology_group_t* other_group = &topology->groups[j];
+    uint64_t group_processor_bits =
+        iree_math_rotl_u64(1ull, other_group->processor_index);
+    if (processor_mask & group_processor_bits) {
+      group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
+    }
+  }
+  return group_mask;
+}
+
 iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_t* topology) {
   if (!iree_task_topology_is_cpuinfo_available()) {
@@ -250,21 +305,18 @@ iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_group_t* group = &topology->groups[i];
 
     // Compute the processors that we can constructively share with.
+    const struct cpuinfo_processor* processor =
+        cpuinfo_get_processor(group->processor_index);
     uint64_t constructive_sharing_mask =
-        iree_task_topology_calculate_constructive_sharing_mask(
-            cpuinfo_get_processor(group->processor_index));
-
-    iree_task_topology_group_mask_t group_mask = 0;
-    for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
-      const iree_task_topology_group_t* other_group = &topology->groups[j];
-      uint64_t group_processor_bits =
-          iree_math_rotl_u64(1ull, other_group->processor_index);
-      if (constructive_sharing_mask & group_processor_bits) {
-        group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
-      }
-    }
-
-    group->constructive_sharing_mask = group_mask;
+        iree_task_topology_calculate_constructive_sharing_mask(processor);
+    uint64_t llc_sharing_mask =
+        iree_task_topology_calculate_llc_sharing_mask(processor);
+
+    group->constructive_sharing_mask =
+        iree_task_topology_map_processor_mask_to_groups(
+            topology, constructive_sharing_mask);
+    group->llc_sharing_mask = iree_task_topology_map_processor_mask_to_groups(
+        topology, llc_sharing_mask);
   }
 
   return iree_ok_status();
@@ -60,6 +60,9 @@ TEST(TopologyTest, Construction) {
     const iree_task_topology_group_t* group =
         iree_task_topology_get_group(&topology, i);
     EXPECT_EQ(i, group->group_index);
+    EXPECT_EQ(IREE_TASK_TOPOLOGY_GROUP_MASK_ALL,
+              group->constructive_sharing_mask);
+    EXPECT_EQ(IREE_TASK_TOPOLOGY_GROUP_MASK_ALL, group->llc_sharing_mask);
   }
 
   iree_task_topology_deinitialize(&topology);
@@ -144,4 +147,124 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Returns a mask with a bit set for each of the first |group_count| groups.
+static iree_task_topology_group_mask_t ValidGroupMask(
+    iree_host_size_t group_count) {
+  if (group_count >= IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
+    return IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+  }
+  return (1ull << group_count) - 1;
+}
+
+// Tests that selecting a core type on the host yields a valid topology
+// regardless of whether the system is heterogeneous.
+TEST(TopologyTest, FromPhysicalCoresOfType) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  for (auto core_type : {IREE_TASK_TOPOLOGY_CORE_TYPE_ANY,
+                         IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE,
+                         IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY}) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize(&topology);
+    IREE_ASSERT_OK(iree_task_topology_initialize_from_physical_cores_of_type(
+        IREE_TASK_TOPOLOGY_NODE_ID_ANY, core_type, kMaxGroupCount, &topology));
+    EnsureTopologyValid(kMaxGroupCount, &topology);
+    const iree_task_topology_group_mask_t valid_group_mask =
+        ValidGroupMask(iree_task_topology_group_count(&topology));
+    for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+         ++i) {
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(&topology, i);
+      // Sharing must not reference groups outside of the topology.
+      if (group->constructive_sharing_mask !=
+          IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) {
+        EXPECT_EQ(0, group->constructive_sharing_mask & ~valid_group_mask);
+      }
+    }
+    iree_task_topology_deinitialize(&topology);
+  }
+}
+
+// Tests that selecting a core type from a heterogeneous topology yields only
+// cores of that type with sharing masks remapped to the selected groups.
+TEST(TopologyTest, FromCoreType) {
+  // Groups alternate performance/efficiency cores with each pair sharing a
+  // cache: 0P 1E | 2P 3E | 4P 5E.
+  iree_task_topology_t source_topology;
+  iree_task_topology_initialize(&source_topology);
+  for (iree_host_size_t i = 0; i < 6; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    group.core_type = (i % 2) == 0 ? IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE
+                                   : IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY;
+    group.constructive_sharing_mask = 0b11ull << (i & ~1);
+    group.llc_sharing_mask = 0b111111ull;
+    IREE_ASSERT_OK(iree_task_topology_push_group(&source_topology, &group));
+  }
+
+  for (auto core_type : {IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE,
+                         IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY}) {
+    iree_task_topology_t topology;
+    IREE_ASSERT_OK(iree_task_topology_initialize_from_core_type(
+        &source_topology, core_type, /*max_core_count=*/2, &topology));
+    ASSERT_EQ(2, iree_task_topology_group_count(&topology));
+    for (iree_host_size_t i = 0; i < 2; ++i) {
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(&topology, i);
+      EXPECT_EQ(i, group->group_index);
+      EXPECT_EQ(core_type, group->core_type);
+      // The selected groups no longer share a cache with each other but do
+      // share the last level cache.
+      EXPECT_EQ(1ull << i, group->constructive_sharing_mask);
+      EXPECT_EQ(0b11ull, group->llc_sharing_mask);
+    }
+    iree_task_topology_deinitialize(&topology);
+  }
+
+  // Selecting any core type keeps every group up to the limit.
+  iree_task_topology_t topology;
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_core_type(
+      &source_topology, IREE_TASK_TOPOLOGY_CORE_TYPE_ANY,
+      /*max_core_count=*/64, &topology));
+  EXPECT_EQ(6, iree_task_topology_group_count(&topology));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_topology_deinitialize(&source_topology);
+}
+
+TEST(TopologyTest, FromPhysicalCoresOnNodes) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_physical_cores_on_nodes(
+      /*node_mask=*/1ull << 0, kMaxGroupCount, &topology));
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+       ++i) {
+    const iree_task_topology_group_t* group =
+        iree_task_topology_get_group(&topology, i);
+    EXPECT_EQ(0, group->node_id);
+    // Sharing must not reference groups outside of the topology.
+    const iree_task_topology_group_mask_t valid_group_mask =
+        ValidGroupMask(iree_task_topology_group_count(&topology));
+    EXPECT_EQ(0, group->constructive_sharing_mask & ~valid_group_mask);
+    EXPECT_EQ(0, group->llc_sharing_mask & ~valid_group_mask);
+  }
+  EXPECT_EQ(1, iree_task_topology_query_group_node_count(&topology));
+  iree_task_topology_deinitialize(&topology);
+}
+
+TEST(TopologyTest, GroupNodeCount) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  EXPECT_EQ(0, iree_task_topology_query_group_node_count(&topology));
+  for (iree_host_size_t i = 0; i < 6; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    group.node_id = i % 3;
+    IREE_ASSERT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+  EXPECT_EQ(3, iree_task_topology_query_group_node_count(&topology));
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
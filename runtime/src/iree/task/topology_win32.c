@@ -31,6 +31,20 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
   return (iree_task_topology_node_id_t)node_number;
 }
 
+// Returns the NUMA node of the processor specified by |affinity| or 0 if
+// unknown.
+static iree_task_topology_node_id_t iree_task_topology_query_affinity_node(
+    const iree_thread_affinity_t* affinity) {
+  if (!affinity->specified) return 0;
+  PROCESSOR_NUMBER processor_number;
+  memset(&processor_number, 0, sizeof(processor_number));
+  processor_number.Group = (WORD)affinity->group;
+  processor_number.Number = (BYTE)affinity->id;
+  USHORT node_number = 0;
+  if (!GetNumaProcessorNodeEx(&processor_number, &node_number)) return 0;
+  return (iree_task_topology_node_id_t)node_number;
+}
+
 //===----------------------------------------------------------------------===//
 // Topology initialization helpers
 //===----------------------------------------------------------------------===//
@@ -67,6 +81,37 @@ static void iree_task_topology_set_affinity_from_processor(
       iree_task_count_trailing_zeros_kaffinity(processor->GroupMask[0].Mask);
 }
 
+// Returns the range of efficiency classes reported across all cores in the
+// relationship list. Higher efficiency classes indicate higher performance
+// cores (P-cores) and homogeneous systems report the same class for all cores.
+static void iree_task_topology_query_efficiency_class_range(
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* relationships,
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* relationships_end,
+    BYTE* out_min_class, BYTE* out_max_class) {
+  BYTE min_class = 0xFF;
+  BYTE max_class = 0;
+  for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* p = relationships;
+       p < relationships_end;
+       p = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)p + p->Size)) {
+    if (p->Relationship != RelationProcessorCore) continue;
+    min_class = iree_min(min_class, p->Processor.EfficiencyClass);
+    max_class = iree_max(max_class, p->Processor.EfficiencyClass);
+  }
+  *out_min_class = min_class;
+  *out_max_class = max_class;
+}
+
+// Returns the core type of |processor| given the range of efficiency classes
+// in the system. Cores in the lowest class are efficiency cores.
+static iree_task_topology_core_type_t
+iree_task_topology_core_type_for_processor(
+    const PROCESSOR_RELATIONSHIP* processor, BYTE min_class, BYTE max_class) {
+  if (min_class >= max_class) return IREE_TASK_TOPOLOGY_CORE_TYPE_ANY;
+  return processor->EfficiencyClass == min_class
+             ? IREE_TASK_TOPOLOGY_CORE_TYPE_EFFICIENCY
+             : IREE_TASK_TOPOLOGY_CORE_TYPE_PERFORMANCE;
+}
+
 // Uses |group_mask| to assign constructive sharing masks to all topology groups
 // that constructively share some level of the cache hierarchy.
 static void iree_task_topology_assign_constructive_sharing(
@@ -83,6 +128,7 @@ static void iree_task_topology_assign_constructive_sharing(
         if (other->ideal_thread_affinity.group == group_mask.Group &&
             (group_mask.Mask & (1ull << other->ideal_thread_affinity.id))) {
           group->constructive_sharing_mask |= 1ull << group_j;
+          group->llc_sharing_mask |= 1ull << group_j;
         }
       }
     }
@@ -212,6 +258,12 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
     }
   }
 
+  BYTE min_efficiency_class = 0;
+  BYTE max_efficiency_class = 0;
+  iree_task_topology_query_efficiency_class_range(
+      all_relationships, all_relationships_end, &min_efficiency_class,
+      &max_efficiency_class);
+
   // Validate the CPU IDs provided and build a lookup table of processors we
   // have selected. This could be a bitmap but it's not worth the code today.
   uint8_t* included_processors =
@@ -252,6 +304,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         iree_task_topology_group_initialize(group_index, group);
         group->processor_index = (uint32_t)global_processor_index;
         group->constructive_sharing_mask = 0;  // set below
+        group->llc_sharing_mask = 0;           // set below
 
         // Pin group to the processor.
         iree_thread_affinity_t* affinity = &group->ideal_thread_affinity;
@@ -260,6 +313,9 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         affinity->smt = (p->Processor.Flags & LTP_PC_SMT) == LTP_PC_SMT;
         affinity->group = p->Processor.GroupMask[0].Group;
         affinity->id = group_offset + bit_offset;
+        group->node_id = iree_task_topology_query_affinity_node(affinity);
+        group->core_type = iree_task_topology_core_type_for_processor(
+            &p->Processor, min_efficiency_class, max_efficiency_class);
       }
       group_offset += bit_offset + 1;
       if (out_topology->group_count >= cpu_count) break;
@@ -395,6 +451,12 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     }
   }
 
+  BYTE min_efficiency_class = 0;
+  BYTE max_efficiency_class = 0;
+  iree_task_topology_query_efficiency_class_range(
+      all_relationships, all_relationships_end, &min_efficiency_class,
+      &max_efficiency_class);
+
   // Clamp the total number of cores available to the max provided.
   // This is the number of topology groups we'll create.
   iree_host_size_t used_core_count =
@@ -440,8 +502,17 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_group_initialize(group_index, group);
     group->processor_index = (uint32_t)adjusted_core_index;
     group->constructive_sharing_mask = 0;  // set below
+    group->llc_sharing_mask = 0;           // set below
     iree_task_topology_set_affinity_from_processor(
         all_cores[adjusted_core_index], &group->ideal_thread_affinity);
+    group->node_id =
+        node_id == IREE_TASK_TOPOLOGY_NODE_ID_ANY
+            ? iree_task_topology_query_affinity_node(
+                  &group->ideal_thread_affinity)
+            : node_id;
+    group->core_type = iree_task_topology_core_type_for_processor(
+        all_cores[adjusted_core_index], min_efficiency_class,
+        max_efficiency_class);
   }
 
   // Assign constructive sharing masks to each topology group.
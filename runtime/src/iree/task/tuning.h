@@ -94,6 +94,44 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Target duration in nanoseconds of the tiles in each shard reservation when
+// a dispatch provides a running tile duration estimate (see
+// iree_task_dispatch_t::tile_duration_ns). Cheap tiles are batched into larger
+// reservations to amortize the atomic reservation overhead while expensive
+// tiles are reserved one at a time to balance load.
+#define IREE_TASK_DISPATCH_TARGET_RESERVATION_DURATION_NS (20 /*us*/ * 1000)
+
+// Maximum number of tiles a shard may reserve at a time when the reservation
+// size is derived from a tile duration estimate.
+#define IREE_TASK_DISPATCH_MAX_ADAPTIVE_TILES_PER_SHARD_RESERVATION (256)
+
+// Minimum number of reservations each shard of a dispatch should be able to
+// make when the reservation size is derived from a tile duration estimate.
+// This bounds reservation sizes for small grids so that shards can still steal
+// work from each other.
+#define IREE_TASK_DISPATCH_MIN_RESERVATIONS_PER_SHARD (4)
+
+// Percentage of the tiles in a dispatch statically assigned to shards when
+// IREE_TASK_SCHEDULING_MODE_DISPATCH_TILE_AFFINITY is set. Each shard owns a
+// contiguous block of the statically assigned tiles and the remainder is
+// reserved dynamically by shards as they finish their blocks. Higher values
+// improve cache reuse across dispatches while lower values leave more tiles to
+// balance uneven workers.
+#define IREE_TASK_DISPATCH_AFFINITY_TILE_PERCENT (75)
+
+// Minimum number of tiles per shard when dispatches are sharded across only as
+// many workers as their tile count warrants with
+// IREE_TASK_SCHEDULING_MODE_DISPATCH_SIZED_SHARDS. Dispatches with fewer than
+// this many tiles per worker run on a subset of the workers.
+#define IREE_TASK_DISPATCH_MIN_TILES_PER_SHARD (4)
+
+// Relative capacity of a worker on an efficiency core compared to one on a
+// performance core as a percentage. Used on heterogeneous topologies
+// (big.LITTLE/DynamIQ, P/E cores) to scale the number of tiles shards on
+// efficiency cores reserve at a time and their share of statically assigned
+// tiles. Has no effect on topologies with a single core type.
+#define IREE_TASK_DISPATCH_EFFICIENCY_CORE_CAPACITY_PERCENT (50)
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
@@ -11,12 +11,24 @@
 
 #include "iree/base/internal/fpu_state.h"
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/task/executor_impl.h"
 #include "iree/task/post_batch.h"
 #include "iree/task/submission.h"
 #include "iree/task/task_impl.h"
 #include "iree/task/tuning.h"
 
+IREE_METRIC_STATIC(iree_task_worker_steals_metric, IREE_METRIC_KIND_COUNTER,
+                   "iree_task_worker_steals_total",
+                   "Times idle workers stole tasks from other workers.");
+IREE_METRIC_STATIC(iree_task_worker_spin_hits_metric,
+                   IREE_METRIC_KIND_COUNTER,
+                   "iree_task_worker_spin_hits_total",
+                   "Times idle workers found work while spinning.");
+IREE_METRIC_STATIC(iree_task_worker_parks_metric, IREE_METRIC_KIND_COUNTER,
+                   "iree_task_worker_parks_total",
+                   "Times idle workers parked in the kernel waiting for work.");
+
 #define IREE_TASK_WORKER_MIN_STACK_SIZE (32 * 1024)
 
 static int iree_task_worker_main(iree_task_worker_t* worker);
@@ -24,8 +36,9 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
+    iree_task_affinity_set_t node_worker_mask, iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
@@ -34,10 +47,20 @@ iree_status_t iree_task_worker_initialize(
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
+  out_worker->llc_sharing_mask = topology_group->llc_sharing_mask;
+  out_worker->node_id = topology_group->node_id;
+  out_worker->node_worker_mask = node_worker_mask;
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
+  out_worker->spin_ns = executor->worker_spin_ns;
+  out_worker->idle_duration_ns = IREE_DURATION_ZERO;
+  out_worker->idle_start_ns = IREE_TIME_INFINITE_PAST;
+  iree_atomic_store_int64(&out_worker->spin_hit_count, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_worker->park_count, 0,
+                          iree_memory_order_relaxed);
   out_worker->local_memory = local_memory;
   out_worker->processor_id = 0;
   out_worker->processor_tag = 0;
@@ -45,6 +68,9 @@ iree_status_t iree_task_worker_initialize(
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
+  iree_atomic_task_slist_initialize(&out_worker->priority_mailbox_slist);
+  iree_atomic_store_int32(&out_worker->priority_pending, 0,
+                          iree_memory_order_relaxed);
   iree_task_queue_initialize(&out_worker->local_task_queue);
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
@@ -55,7 +81,7 @@ iree_status_t iree_task_worker_initialize(
   memset(&thread_params, 0, sizeof(thread_params));
   thread_params.name = iree_make_cstring_view(topology_group->name);
   thread_params.create_suspended = false;
-  thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  thread_params.priority_class = executor->worker_priority_class;
   thread_params.initial_affinity = out_worker->ideal_thread_affinity;
   thread_params.stack_size =
       iree_max(IREE_TASK_WORKER_MIN_STACK_SIZE, stack_size);
@@ -130,11 +156,13 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
+  iree_atomic_task_slist_discard(&worker->priority_mailbox_slist);
   iree_task_list_discard(&worker->local_task_queue.list);
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
+  iree_atomic_task_slist_deinitialize(&worker->priority_mailbox_slist);
   iree_task_queue_deinitialize(&worker->local_task_queue);
 
   IREE_TRACE_ZONE_END(z0);
@@ -148,6 +176,19 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
   memset(list, 0, sizeof(*list));
 }
 
+void iree_task_worker_post_priority_tasks(iree_task_worker_t* worker,
+                                          iree_task_list_t* list) {
+  iree_atomic_task_slist_concat(&worker->priority_mailbox_slist, list->head,
+                                list->tail);
+  memset(list, 0, sizeof(*list));
+
+  // Set after the tasks are visible in the mailbox so that a worker observing
+  // the flag is guaranteed to find them. A worker may find them before the flag
+  // is set and then see a spurious flag which is harmless.
+  iree_atomic_store_int32(&worker->priority_pending, 1,
+                          iree_memory_order_release);
+}
+
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
                                              iree_task_queue_t* target_queue,
                                              iree_host_size_t max_tasks) {
@@ -157,13 +198,29 @@ iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
                                                 target_queue, max_tasks);
   if (task) return task;
 
-  // If we still didn't steal any tasks then let's try the slist instead.
+  // If we still didn't steal any tasks then let's try the slists instead,
+  // preferring any high-priority tasks that are waiting.
+  task = iree_atomic_task_slist_pop(&worker->priority_mailbox_slist);
+  if (task) return task;
   task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
   if (task) return task;
 
   return NULL;
 }
 
+// Switches the FPU state of the worker thread to what |task| requires.
+// Dispatches flush denormals to zero unless they request IEEE behavior and
+// those declaring no FPU dependence run in whatever state the worker is in.
+static void iree_task_worker_switch_fpu_state(iree_task_worker_t* worker,
+                                              const iree_task_t* task) {
+  if (task->flags & IREE_TASK_FLAG_DISPATCH_FPU_AGNOSTIC) return;
+  const iree_fpu_state_flags_t fpu_flags =
+      (task->flags & IREE_TASK_FLAG_DISPATCH_PRESERVE_DENORMALS)
+          ? IREE_FPU_STATE_DEFAULT
+          : IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO;
+  iree_fpu_state_switch(fpu_flags, &worker->fpu_flags);
+}
+
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
 // handled by the coordinator during scheduling.
@@ -178,15 +235,23 @@ static void iree_task_worker_execute(
   // BFS behavior at the cost of the additional merge overhead - it's probably
   // worth it?
   // TODO(benvanik): handle partial tasks and re-queuing.
+  iree_task_worker_switch_fpu_state(worker, task);
   switch (task->type) {
     case IREE_TASK_TYPE_CALL: {
       iree_task_call_execute((iree_task_call_t*)task, pending_submission);
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
+      const bool yielded = iree_task_dispatch_shard_execute(
           (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+          worker->worker_index, worker->local_memory,
+          &worker->priority_pending, pending_submission);
+      if (yielded) {
+        // The shard yielded to high-priority work posted to us; requeue it so
+        // that it resumes after the high-priority tasks (which will be flushed
+        // ahead of it on the next pump).
+        iree_task_queue_push_front(&worker->local_task_queue, task);
+      }
       break;
     }
     default:
@@ -205,10 +270,22 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // High-priority tasks posted to us jump ahead of everything else we have
+  // pending. The flag is cleared before flushing so that any tasks posted after
+  // the flush will set it again and be picked up on the next pump.
+  iree_task_t* task = NULL;
+  if (iree_atomic_load_int32(&worker->priority_pending,
+                             iree_memory_order_relaxed)) {
+    iree_atomic_store_int32(&worker->priority_pending, 0,
+                            iree_memory_order_relaxed);
+    task = iree_task_queue_prepend_from_lifo_slist(
+        &worker->local_task_queue, &worker->priority_mailbox_slist);
+  }
+
   // Check the local work queue for any work we know we should start
   // processing immediately. Other workers may try to steal some of this work
   // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
+  if (!task) task = iree_task_queue_pop_front(&worker->local_task_queue);
 
   // Check the mailbox to see if we have incoming work that has been posted.
   // We try to greedily move it to our local work list so that we can work
@@ -232,8 +309,10 @@ static bool iree_task_worker_pump_once(
   if (!task) {
     task = iree_task_executor_try_steal_task(
         worker->executor, worker->constructive_sharing_mask,
+        worker->llc_sharing_mask, worker->node_worker_mask,
         worker->max_theft_attempts, &worker->theft_prng,
         &worker->local_task_queue);
+    if (task) iree_metric_add(&iree_task_worker_steals_metric, 1);
   }
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
@@ -256,6 +335,35 @@ static void iree_task_worker_update_processor_id(iree_task_worker_t* worker) {
   iree_cpu_requery_processor_id(&worker->processor_tag, &worker->processor_id);
 }
 
+// Marks the worker as having run out of work if it is not already idle.
+static void iree_task_worker_begin_idle(iree_task_worker_t* worker) {
+  if (worker->executor->worker_idle_policy !=
+      IREE_TASK_WORKER_IDLE_POLICY_ADAPTIVE) {
+    return;
+  }
+  if (worker->idle_start_ns == IREE_TIME_INFINITE_PAST) {
+    worker->idle_start_ns = iree_time_now();
+  }
+}
+
+// Marks the worker as having found more work and adapts the spin window based
+// on how long it was idle. We keep a moving average of the idle durations and
+// spin for twice that (so that most arrivals around the average are caught)
+// unless the average exceeds the maximum spin window - in which case spinning
+// is unlikely to pay off and we park immediately. Parking still measures the
+// idle duration so that the window reopens when work starts arriving faster.
+static void iree_task_worker_end_idle(iree_task_worker_t* worker) {
+  if (worker->idle_start_ns == IREE_TIME_INFINITE_PAST) return;
+  const iree_duration_t max_spin_ns = worker->executor->worker_spin_ns;
+  const iree_duration_t idle_ns = iree_time_now() - worker->idle_start_ns;
+  worker->idle_start_ns = IREE_TIME_INFINITE_PAST;
+  worker->idle_duration_ns =
+      worker->idle_duration_ns - worker->idle_duration_ns / 8 + idle_ns / 8;
+  worker->spin_ns = worker->idle_duration_ns <= max_spin_ns
+                        ? iree_min(max_spin_ns, 2 * worker->idle_duration_ns)
+                        : IREE_DURATION_ZERO;
+}
+
 // Alternates between pumping ready tasks in the worker queue and waiting
 // for more tasks to arrive. Only returns when the worker has been asked by
 // the executor to exit.
@@ -265,6 +373,13 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
   // be able to process it with the proper processor ID immediately.
   iree_task_worker_update_processor_id(worker);
 
+  // Set when the prior wait spun without being notified so that the next wait
+  // parks in the kernel. Spinning and parking are split into two waits (with a
+  // pump in between) so that we can tell which one succeeded; a notification
+  // posted after the spin gave up is caught by the pump as the wait token has
+  // already been consumed.
+  bool park_next = false;
+
   // Pump the thread loop to process more tasks.
   while (true) {
     // If we fail to find any work to do we'll wait at the end of this loop.
@@ -327,9 +442,8 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
 
     // When we encounter a complete lack of work we can self-nominate to check
     // the global work queue and distribute work to other threads. Only one
-    // coordinator can be running at a time so we also ensure that if another
-    // is doing its work we gracefully wait for it. It's fine to block in here
-    // as the next thing we'd have done is go idle anyway.
+    // coordinator can be running at a time and if another is doing its work
+    // our request is handed off to it and we'll be woken if it posts us work.
 
     // First self-nominate; this *may* do something or just be ignored (if
     // another worker is already coordinating).
@@ -342,16 +456,42 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
         !iree_task_queue_is_empty(&worker->local_task_queue)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
+      iree_task_worker_end_idle(worker);
+      park_next = false;
+    } else if (worker->spin_ns != IREE_DURATION_ZERO && !park_next) {
+      // Spin without entering the kernel. If we are notified while spinning we
+      // go right back to pumping and otherwise we'll park on the next wait.
+      iree_task_worker_begin_idle(worker);
+      IREE_TRACE_ZONE_BEGIN_NAMED(z_spin,
+                                  "iree_task_worker_main_pump_wake_spin");
+      const bool notified = iree_notification_commit_wait(
+          &worker->wake_notification, wait_token,
+          /*spin_ns=*/worker->spin_ns,
+          /*deadline_ns=*/IREE_TIME_INFINITE_PAST);
+      IREE_TRACE_ZONE_END(z_spin);
+      if (notified) {
+        iree_atomic_fetch_add_int64(&worker->spin_hit_count, 1,
+                                    iree_memory_order_relaxed);
+        iree_metric_add(&iree_task_worker_spin_hits_metric, 1);
+        iree_task_worker_end_idle(worker);
+      } else {
+        park_next = true;
+      }
     } else {
-      // Spin/wait in the kernel. We don't care if the condition fails as we're
+      // Wait in the kernel. We don't care if the condition fails as we're
       // just using it as a pulse.
+      iree_task_worker_begin_idle(worker);
+      iree_atomic_fetch_add_int64(&worker->park_count, 1,
+                                  iree_memory_order_relaxed);
+      iree_metric_add(&iree_task_worker_parks_metric, 1);
       IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
                                   "iree_task_worker_main_pump_wake_wait");
-      iree_notification_commit_wait(
-          &worker->wake_notification, wait_token,
-          /*spin_ns=*/worker->executor->worker_spin_ns,
-          /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+      iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                    /*spin_ns=*/IREE_DURATION_ZERO,
+                                    /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
       IREE_TRACE_ZONE_END(z_wait);
+      iree_task_worker_end_idle(worker);
+      park_next = false;
 
       // Woke from a wait - query the processor ID in case we migrated during
       // the sleep.
@@ -369,8 +509,10 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
   IREE_TRACE_ZONE_BEGIN(thread_zone);
 
   // We cannot rely on the global process settings for FPU state.
-  // Be explicit here on what we need.
+  // Be explicit here on what we need. Tasks may switch the state as they
+  // execute but only when their requirements differ from the current state.
   iree_fpu_state_push(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO);
+  worker->fpu_flags = IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO;
 
   // Reset affinity (as it can change over time).
   // TODO(benvanik): call this after waking in case CPU hotplugging happens.
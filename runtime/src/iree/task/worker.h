@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/fpu_state.h"
 #include "iree/base/internal/prng.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/threading.h"
@@ -63,6 +64,16 @@ typedef struct iree_task_worker_t {
   // LAYOUT: must be 64b away from local_task_queue.
   iree_atomic_task_slist_t mailbox_slist;
 
+  // A LIFO mailbox used by coordinators to post high-priority tasks to this
+  // worker. Flushed into the front of the local queue ahead of any other work.
+  // LAYOUT: next to mailbox_slist as posting touches both.
+  iree_atomic_task_slist_t priority_mailbox_slist;
+
+  // Nonzero when tasks may have been posted to |priority_mailbox_slist| since
+  // the worker last flushed it. Lower-priority dispatch shards running on the
+  // worker poll this at tile reservation boundaries and yield when it is set.
+  iree_atomic_int32_t priority_pending;
+
   // Current state of the worker (iree_task_worker_state_t).
   // LAYOUT: frequent access; next to wake_notification as they are always
   //         accessed together.
@@ -98,9 +109,23 @@ typedef struct iree_task_worker_t {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
+  // A bitmask of other group indices that share the last level cache with
+  // this worker. Victims in this cache domain are tried after those in the
+  // |constructive_sharing_mask| and before any other worker.
+  iree_task_affinity_set_t llc_sharing_mask;
+
+  // NUMA node the worker is pinned to.
+  iree_task_topology_node_id_t node_id;
+
+  // A bitmask of all workers (including this one) on the same NUMA node.
+  // All workers in single-node topologies will have all bits set.
+  iree_task_affinity_set_t node_worker_mask;
+
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
-  // (try stealing from these 3 other cores that share your L3 cache).
+  // (try stealing from these 3 other cores that share your L3 cache). Applies
+  // to each tier of victims (shared L1/L2, shared LLC, node, remote) and not
+  // the total.
   uint32_t max_theft_attempts;
 
   // Rotation counter for work stealing (ensures we don't favor one victim).
@@ -120,6 +145,12 @@ typedef struct iree_task_worker_t {
   // An opaque tag used to reduce the cost of processor ID queries.
   iree_cpu_processor_tag_t processor_tag;
 
+  // FPU state flags the worker thread last switched to. Tasks requiring a
+  // different state switch the thread on demand and the state is retained
+  // across runs of tasks with the same requirements. Only touched by the worker
+  // thread.
+  iree_fpu_state_flags_t fpu_flags;
+
   // Destructive interference padding between the mailbox and local task queue
   // to ensure that the worker - who is pounding on local_task_queue - doesn't
   // contend with submissions or coordinators dropping new tasks in the mailbox.
@@ -132,6 +163,22 @@ typedef struct iree_task_worker_t {
   // interference) this is the only place padding should be added.
   // uint8_t _padding[8];
 
+  // Current spin window used when the worker runs out of work. Either fixed at
+  // the executor worker_spin_ns or adapted over time within [0, worker_spin_ns]
+  // based on |idle_duration_ns|. Only touched by the worker thread.
+  iree_duration_t spin_ns;
+  // Moving average of how long the worker was idle before work arrived.
+  // Only touched by the worker thread.
+  iree_duration_t idle_duration_ns;
+  // Time the worker last ran out of work or IREE_TIME_INFINITE_PAST if it is
+  // not currently idle. Only touched by the worker thread.
+  iree_time_t idle_start_ns;
+
+  // Statistics counters incremented by the worker and read by any thread
+  // querying executor statistics.
+  iree_atomic_int64_t spin_hit_count;
+  iree_atomic_int64_t park_count;
+
   // Pointer to local memory available for use exclusively by the worker.
   // The base address should be aligned to avoid false sharing with other
   // workers.
@@ -156,11 +203,15 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 // tasks. Where supported the worker will be created in a suspended state so
 // that we aren't creating a thundering herd on startup:
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
+//
+// |node_worker_mask| indicates which workers share the NUMA node of the
+// |topology_group|, including the worker being initialized.
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
+    iree_task_affinity_set_t node_worker_mask, iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker);
 
 // Requests that the worker begin exiting (if it hasn't already).
 // If the worker is actively processing tasks it will wait until it has
@@ -190,6 +241,16 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list);
 
+// Posts a FIFO list of high-priority tasks to the worker priority mailbox. The
+// tasks will be processed before any other work the worker has pending and
+// lower-priority dispatch shards the worker is executing will yield to them at
+// their next tile reservation boundary. The target worker takes ownership of
+// the tasks and must be woken by the caller if it is currently idle.
+//
+// May be called from any thread (including the worker thread).
+void iree_task_worker_post_priority_tasks(iree_task_worker_t* worker,
+                                          iree_task_list_t* list);
+
 // Tries to steal up to |max_tasks| from the back of the queue.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
 // that were at the tail of the worker FIFO will be moved to the |target_queue|
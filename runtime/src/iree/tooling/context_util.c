@@ -20,6 +20,7 @@
 #include "iree/modules/hal/module.h"
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/modules/resolver.h"
+#include "iree/tooling/startup_profile.h"
 #include "iree/vm/bytecode/module.h"
 #include "iree/vm/dynamic/module.h"
 
@@ -53,6 +54,7 @@ static iree_status_t iree_tooling_load_bytecode_module(
   // We could map the memory here if we wanted to and were coming from a file
   // on disk.
   iree_file_contents_t* file_contents = NULL;
+  iree_time_t read_start_ns = iree_time_now();
   if (iree_string_view_equal(path, IREE_SV("-"))) {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_stdin_read_contents(host_allocator, &file_contents));
@@ -74,6 +76,11 @@ static iree_status_t iree_tooling_load_bytecode_module(
         z0, iree_file_read_contents(path_str, read_flags, host_allocator,
                                     &file_contents));
   }
+  iree_host_size_t file_length = file_contents->const_buffer.data_length;
+  iree_time_t create_start_ns = iree_time_now();
+  iree_tooling_startup_profile_record(IREE_TOOLING_STARTUP_PHASE_MODULE_READ,
+                                      path, create_start_ns - read_start_ns,
+                                      file_length);
 
   // Try to load the module as bytecode (all we have today that we can use).
   // We could sniff the file ID and switch off to other module types.
@@ -82,6 +89,9 @@ static iree_status_t iree_tooling_load_bytecode_module(
   iree_status_t status = iree_vm_bytecode_module_create(
       instance, file_contents->const_buffer,
       iree_file_contents_deallocator(file_contents), host_allocator, &module);
+  iree_tooling_startup_profile_record(IREE_TOOLING_STARTUP_PHASE_MODULE_CREATE,
+                                      path, iree_time_now() - create_start_ns,
+                                      file_length);
 
   if (iree_status_is_ok(status)) {
     *out_module = module;
@@ -111,9 +121,12 @@ static iree_status_t iree_tooling_load_dynamic_module(
     iree_uri_split_params(params, param_count, &param_count, param_list);
   }
 
+  iree_time_t start_ns = iree_time_now();
   iree_status_t status = iree_vm_dynamic_module_load_from_file(
       instance, path, export_name, param_count, param_list, host_allocator,
       out_module);
+  iree_tooling_startup_profile_record(IREE_TOOLING_STARTUP_PHASE_MODULE_CREATE,
+                                      path, iree_time_now() - start_ns, 0);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -172,6 +185,11 @@ iree_status_t iree_tooling_load_modules_from_flags(
 // HAL execution model management
 //===----------------------------------------------------------------------===//
 
+IREE_FLAG(
+    bool, hal_deduplicate_constants, false,
+    "Shares one device buffer between identical constant data imported by\n"
+    "the modules loaded into the context instead of importing it per module.");
+
 static iree_status_t iree_tooling_load_hal_async_module(
     iree_vm_instance_t* instance, iree_string_view_t default_device_uri,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module,
@@ -201,10 +219,15 @@ static iree_status_t iree_tooling_load_hal_async_module(
     default_device_uri = iree_hal_default_device_uri();
   }
   iree_hal_device_t* device = NULL;
+  iree_time_t device_start_ns = iree_time_now();
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_create_device_from_flags(
               iree_hal_available_driver_registry(), default_device_uri,
               host_allocator, &device));
+  iree_time_t module_start_ns = iree_time_now();
+  iree_tooling_startup_profile_record(IREE_TOOLING_STARTUP_PHASE_DEVICE_CREATE,
+                                      iree_hal_device_id(device),
+                                      module_start_ns - device_start_ns, 0);
 
   // Fetch the allocator from the device to pass back to the caller.
   iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(device);
@@ -212,9 +235,18 @@ static iree_status_t iree_tooling_load_hal_async_module(
 
   // Create HAL module wrapping the device created above.
   iree_hal_module_flags_t flags = IREE_HAL_MODULE_FLAG_NONE;
+  if (iree_tooling_startup_profile_is_enabled()) {
+    flags |= IREE_HAL_MODULE_FLAG_COLLECT_LOAD_STATISTICS;
+  }
+  if (FLAG_hal_deduplicate_constants) {
+    flags |= IREE_HAL_MODULE_FLAG_DEDUPLICATE_CONSTANTS;
+  }
   iree_vm_module_t* module = NULL;
   iree_status_t status =
       iree_hal_module_create(instance, device, flags, host_allocator, &module);
+  iree_tooling_startup_profile_record(
+      IREE_TOOLING_STARTUP_PHASE_HAL_MODULE_CREATE, iree_string_view_empty(),
+      iree_time_now() - module_start_ns, 0);
 
   if (iree_status_is_ok(status)) {
     *out_module = module;
@@ -459,6 +491,20 @@ iree_status_t iree_tooling_resolve_modules(
   if (out_device_allocator) *out_device_allocator = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Modules compiled for multiple devices list the targets they support; pick
+  // the first one with an available driver so that only its executables (and
+  // their constants) are loaded. Explicit --device= flags still take priority.
+  for (iree_host_size_t i = 0;
+       i < user_module_count && iree_string_view_is_empty(default_device_uri);
+       ++i) {
+    iree_string_view_t device_targets = iree_vm_module_lookup_attr_by_name(
+        user_modules[i], IREE_SV("hal.device.targets"));
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_select_device_uri_for_targets(
+                iree_hal_available_driver_registry(), device_targets,
+                host_allocator, &default_device_uri));
+  }
+
   iree_tooling_resolve_state_t resolve_state = {
       .instance = instance,
       .host_allocator = host_allocator,
@@ -555,6 +601,7 @@ iree_status_t iree_tooling_create_instance(iree_allocator_t host_allocator,
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_vm_instance_t* instance = NULL;
+  iree_time_t start_ns = iree_time_now();
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT, host_allocator,
                                   &instance));
@@ -565,6 +612,9 @@ iree_status_t iree_tooling_create_instance(iree_allocator_t host_allocator,
   if (iree_status_is_ok(status)) {
     status = iree_tooling_register_all_module_types(instance);
   }
+  iree_tooling_startup_profile_record(
+      IREE_TOOLING_STARTUP_PHASE_INSTANCE_CREATE, iree_string_view_empty(),
+      iree_time_now() - start_ns, 0);
 
   if (iree_status_is_ok(status)) {
     *out_instance = instance;
@@ -610,9 +660,13 @@ iree_status_t iree_tooling_create_context_from_flags(
   // Create the context with the full list of resolved modules.
   // The context retains the modules and we can release them afterward.
   iree_vm_context_t* context = NULL;
+  iree_time_t start_ns = iree_time_now();
   iree_status_t status = iree_vm_context_create_with_modules(
       instance, flags, resolved_list.count, resolved_list.values,
       host_allocator, &context);
+  iree_tooling_startup_profile_record(
+      IREE_TOOLING_STARTUP_PHASE_CONTEXT_CREATE, iree_string_view_empty(),
+      iree_time_now() - start_ns, 0);
   iree_tooling_module_list_reset(&resolved_list);
 
   // If no device allocator was created we'll create a default one just so that
@@ -11,6 +11,7 @@
 #include "iree/hal/drivers/init.h"
 #include "iree/hal/utils/allocators.h"
 #include "iree/hal/utils/mpi_channel_provider.h"
+#include "iree/hal/utils/shm_channel.h"
 
 //===----------------------------------------------------------------------===//
 // Shared driver registry
@@ -35,6 +36,61 @@ iree_string_view_t iree_hal_default_device_uri(void) {
   return IREE_SV("local-task");
 }
 
+// Returns the name of the driver that can execute programs compiled for the
+// compiler device target |device_id|. Returns an empty string if the target
+// does not use a HAL device.
+static iree_string_view_t iree_hal_driver_name_for_device_target(
+    iree_string_view_t device_id) {
+  if (iree_string_view_equal(device_id, IREE_SV("vmvx-inline"))) {
+    // Inline execution does not use a HAL device.
+    return iree_string_view_empty();
+  } else if (iree_string_view_equal(device_id, IREE_SV("llvm-cpu")) ||
+             iree_string_view_equal(device_id, IREE_SV("vmvx"))) {
+    // Locally-executable targets default to the multithreaded task system.
+    return IREE_SV("local-task");
+  }
+  // Other targets share their name with their driver (`vulkan`, `cuda`, ...).
+  return device_id;
+}
+
+iree_status_t iree_hal_select_device_uri_for_targets(
+    iree_hal_driver_registry_t* driver_registry,
+    iree_string_view_t device_targets, iree_allocator_t host_allocator,
+    iree_string_view_t* out_device_uri) {
+  IREE_ASSERT_ARGUMENT(driver_registry);
+  IREE_ASSERT_ARGUMENT(out_device_uri);
+  *out_device_uri = iree_string_view_empty();
+  if (iree_string_view_is_empty(device_targets)) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t driver_info_count = 0;
+  iree_hal_driver_info_t* driver_infos = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_driver_registry_enumerate(driver_registry, host_allocator,
+                                             &driver_info_count,
+                                             &driver_infos));
+
+  iree_string_view_t remaining = device_targets;
+  while (!iree_string_view_is_empty(remaining) &&
+         iree_string_view_is_empty(*out_device_uri)) {
+    iree_string_view_t device_id = iree_string_view_empty();
+    iree_string_view_split(remaining, ',', &device_id, &remaining);
+    iree_string_view_t driver_name = iree_hal_driver_name_for_device_target(
+        iree_string_view_trim(device_id));
+    if (iree_string_view_is_empty(driver_name)) continue;
+    for (iree_host_size_t i = 0; i < driver_info_count; ++i) {
+      if (iree_string_view_equal(driver_infos[i].driver_name, driver_name)) {
+        *out_device_uri = driver_name;
+        break;
+      }
+    }
+  }
+
+  iree_allocator_free(host_allocator, driver_infos);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Driver and device listing commands
 //===----------------------------------------------------------------------===//
@@ -309,8 +365,18 @@ static iree_status_t iree_hal_configure_allocator_from_flags(
 
 iree_status_t iree_hal_device_set_default_channel_provider(
     iree_hal_device_t* device) {
-  if (!iree_hal_mpi_is_configured()) return iree_ok_status();
   iree_hal_channel_provider_t* channel_provider = NULL;
+  if (iree_hal_shm_channel_is_configured()) {
+    // Single-host launches configure ranks directly without MPI.
+    IREE_RETURN_IF_ERROR(
+        iree_hal_shm_channel_provider_create(
+            iree_hal_device_host_allocator(device), &channel_provider),
+        "creating shared memory channel provider as detected in environment");
+    iree_hal_device_replace_channel_provider(device, channel_provider);
+    iree_hal_channel_provider_release(channel_provider);
+    return iree_ok_status();
+  }
+  if (!iree_hal_mpi_is_configured()) return iree_ok_status();
   IREE_RETURN_IF_ERROR(
       iree_hal_mpi_channel_provider_create(
           iree_hal_device_host_allocator(device), &channel_provider),
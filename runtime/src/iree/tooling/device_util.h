@@ -22,6 +22,17 @@ iree_hal_driver_registry_t* iree_hal_available_driver_registry(void);
 // flags and tools should encourage that.
 iree_string_view_t iree_hal_default_device_uri(void);
 
+// Selects a device URI for the first of the comma-separated compiler device
+// target IDs in |device_targets| (as recorded by the compiler in the
+// `hal.device.targets` module reflection attribute) that has a driver
+// registered in |driver_registry|. Targets are listed in order of preference.
+// Returns an empty string in |out_device_uri| if no target is available.
+// The returned URI may reference storage in |device_targets|.
+iree_status_t iree_hal_select_device_uri_for_targets(
+    iree_hal_driver_registry_t* driver_registry,
+    iree_string_view_t device_targets, iree_allocator_t host_allocator,
+    iree_string_view_t* out_device_uri);
+
 // TODO(#5724): remove this and replace with an iree_hal_device_set_t.
 void iree_hal_get_devices_flag_list(iree_host_size_t* out_count,
                                     const iree_string_view_t** out_list);
@@ -35,8 +46,9 @@ iree_status_t iree_hal_create_device_from_flags(
     iree_hal_device_t** out_device);
 
 // Configures the |device| channel provider based on the current environment.
-// Today this simply checks to see if the process is running under MPI and
-// initializes that unconditionally.
+// Shared memory collectives are used if IREE_SHM_CHANNEL_RANK and
+// IREE_SHM_CHANNEL_COUNT are set and otherwise MPI is used if the process is
+// running under it.
 //
 // WARNING: not thread-safe and must only be called immediately after device
 // creation.
@@ -24,6 +24,26 @@
 //   padded with spaces (\x20) such that
 //   `len(magic string) + 2 + len(length) + HEADER_LEN` % 64 = 0
 
+// Verifies the |magic| bytes and version of an npy header prefix.
+static iree_status_t iree_numpy_npy_verify_header_prefix(
+    const uint8_t magic[6], uint8_t version_major, uint8_t version_minor) {
+  // Verify magic bytes to confirm this is an npy file.
+  static const uint8_t kMagicBytes[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+  if (memcmp(magic, kMagicBytes, sizeof(kMagicBytes)) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npy header magic mismatch");
+  }
+
+  // Ensure we support the version; newer versions aren't expected to parse.
+  // There's been no minor versions yet so we only need to check major.
+  if (version_major <= 0 || version_major > 3) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "npy version %d.%d not supported", version_major,
+                            version_minor);
+  }
+  return iree_ok_status();
+}
+
 // Reads the numpy file header string into an allocated |out_header_buffer|.
 // Upon successful return the |stream| will be positioned immediately at the
 // start of the file payload.
@@ -50,20 +70,8 @@ static iree_status_t iree_numpy_npy_read_header(
                             "unable to read entire header prefix");
   }
 
-  // Verify magic bytes to confirm this is an npy file.
-  static const uint8_t kMagicBytes[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
-  if (memcmp(header.magic, kMagicBytes, sizeof(kMagicBytes)) != 0) {
-    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "npy header magic mismatch");
-  }
-
-  // Ensure we support the version; newer versions aren't expected to parse.
-  // There's been no minor versions yet so we only need to check major.
-  if (header.version_major <= 0 || header.version_major > 3) {
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "npy version %d.%d not supported",
-                            header.version_major, header.version_minor);
-  }
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_verify_header_prefix(
+      header.magic, header.version_major, header.version_minor));
 
   // Read 2- or 4-byte header length.
   // Have never seen a header actually needing 4-bytes (any reason to have one
@@ -292,39 +300,24 @@ static iree_status_t iree_numpy_parse_shape_dims(iree_string_view_t shape,
   return iree_ok_status();
 }
 
-IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
-    FILE* stream, iree_numpy_npy_load_options_t options,
-    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
-    iree_hal_allocator_t* device_allocator,
-    iree_hal_buffer_view_t** out_buffer_view) {
-  IREE_ASSERT_ARGUMENT(stream);
-  IREE_ASSERT_ARGUMENT(device_allocator);
-  IREE_ASSERT_ARGUMENT(out_buffer_view);
-  *out_buffer_view = NULL;
-  IREE_TRACE_ZONE_BEGIN(z0);
-  iree_allocator_t host_allocator =
-      iree_hal_allocator_host_allocator(device_allocator);
+// Maximum shape rank of ndarrays that can be loaded.
+#define IREE_NUMPY_NPY_MAX_SHAPE_RANK 128
 
-  // Quick check for EOF; if already there we can give a better error than
-  // if we failed trying to parse the header. Since npy files are often
-  // concatenated callers are likely to be using this in a loop and checking for
-  // this condition, even if it'd be better if they did it themselves.
-  if (feof(stream)) {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "end-of-file");
-  }
+// ndarray properties parsed from an npy header.
+typedef struct iree_numpy_npy_header_t {
+  iree_host_size_t shape_rank;
+  iree_hal_dim_t shape[IREE_NUMPY_NPY_MAX_SHAPE_RANK];
+  iree_hal_element_type_t element_type;
+  iree_hal_encoding_type_t encoding_type;
+} iree_numpy_npy_header_t;
 
-  // Read header string.
-  // The resulting header must be freed with host_allocator.
-  char* header_buffer = NULL;
-  iree_host_size_t header_length = 0;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_numpy_npy_read_header(stream, host_allocator, &header_length,
-                                     &header_buffer));
-  iree_string_view_t header = iree_string_view_trim(
-      iree_make_string_view(header_buffer, header_length));
+// Parses the npy |header| dictionary string into |out_header|.
+static iree_status_t iree_numpy_npy_parse_header(
+    iree_string_view_t header, iree_numpy_npy_header_t* out_header) {
+  out_header->shape_rank = 0;
+  out_header->element_type = IREE_HAL_ELEMENT_TYPE_NONE;
+  out_header->encoding_type = IREE_HAL_ENCODING_TYPE_OPAQUE;
 
-  // Parse the header.
   // It look something like this:
   //   {'descr': '|i1', 'fortran_order': False, 'shape': (2, 2, 1), }
   // The spec says that although the keys should be sorted alphabetically that's
@@ -332,10 +325,6 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
   // also be keys we don't understand such as when what's saved is a pickled
   // object. We implement a basic scanning parser here and try to deal with it.
   iree_status_t status = iree_ok_status();
-  iree_host_size_t shape_rank = 0;
-  iree_hal_dim_t* shape = NULL;
-  iree_hal_element_type_t element_type = IREE_HAL_ELEMENT_TYPE_NONE;
-  iree_hal_encoding_type_t encoding_type = IREE_HAL_ENCODING_TYPE_OPAQUE;
   iree_string_view_consume_prefix(&header, IREE_SV("{"));
   iree_string_view_consume_suffix(&header, IREE_SV("}"));
   while (!iree_string_view_is_empty(header)) {
@@ -345,27 +334,68 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     if (!iree_status_is_ok(status)) break;
 
     if (iree_string_view_equal(key, IREE_SV("descr"))) {
-      status = iree_numpy_descr_to_element_type(value, &element_type);
+      status =
+          iree_numpy_descr_to_element_type(value, &out_header->element_type);
     } else if (iree_string_view_equal(key, IREE_SV("fortran_order"))) {
       if (iree_string_view_equal(value, IREE_SV("False"))) {
-        encoding_type = IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
+        out_header->encoding_type = IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
       } else {
         status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                   "fortran order arrays not supported");
       }
     } else if (iree_string_view_equal(key, IREE_SV("shape"))) {
-      shape_rank = iree_numpy_parse_shape_rank(value);
-      if (shape_rank > 128) {
+      iree_host_size_t shape_rank = iree_numpy_parse_shape_rank(value);
+      if (shape_rank > IREE_NUMPY_NPY_MAX_SHAPE_RANK) {
         status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                                   "shape rank %" PRIhsz
-                                  " too large; be reasonable please");
+                                  " too large; be reasonable please",
+                                  shape_rank);
       } else {
-        shape = iree_alloca(shape_rank * sizeof(*shape));
-        status = iree_numpy_parse_shape_dims(value, shape_rank, shape);
+        out_header->shape_rank = shape_rank;
+        status =
+            iree_numpy_parse_shape_dims(value, shape_rank, out_header->shape);
       }
     }
     if (!iree_status_is_ok(status)) break;
   }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
+    FILE* stream, iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(stream);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  *out_buffer_view = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(device_allocator);
+
+  // Quick check for EOF; if already there we can give a better error than
+  // if we failed trying to parse the header. Since npy files are often
+  // concatenated callers are likely to be using this in a loop and checking for
+  // this condition, even if it'd be better if they did it themselves.
+  if (feof(stream)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "end-of-file");
+  }
+
+  // Read header string.
+  // The resulting header must be freed with host_allocator.
+  char* header_buffer = NULL;
+  iree_host_size_t header_length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_npy_read_header(stream, host_allocator, &header_length,
+                                     &header_buffer));
+  iree_string_view_t header = iree_string_view_trim(
+      iree_make_string_view(header_buffer, header_length));
+
+  // Parse the header to get the ndarray shape and type.
+  iree_numpy_npy_header_t npy_header;
+  iree_status_t status = iree_numpy_npy_parse_header(header, &npy_header);
 
   // Allocate the buffer view and directly read into the allocated memory.
   // On targets where we can perform host mapping this will be zero-copy; on
@@ -376,9 +406,9 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     };
     buffer_params.access |= IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE;
     status = iree_hal_buffer_view_generate_buffer(
-        device, device_allocator, shape_rank, shape, element_type,
-        encoding_type, buffer_params, iree_numpy_npy_read_into_mapping,
-        &read_params, out_buffer_view);
+        device, device_allocator, npy_header.shape_rank, npy_header.shape,
+        npy_header.element_type, npy_header.encoding_type, buffer_params,
+        iree_numpy_npy_read_into_mapping, &read_params, out_buffer_view);
   }
 
   iree_allocator_free(host_allocator, header_buffer);
@@ -386,6 +416,266 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
   return status;
 }
 
+// Parses the npy header at the start of |contents| into |out_header| and
+// returns the offset of the ndarray contents following it in
+// |out_payload_offset|.
+static iree_status_t iree_numpy_npy_parse_header_from_memory(
+    iree_const_byte_span_t contents, iree_numpy_npy_header_t* out_header,
+    iree_host_size_t* out_payload_offset) {
+  // 6b magic, 1b major version, 1b minor version, 2b or 4b header length.
+  if (contents.data_length < 10) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "unable to read entire header prefix");
+  }
+  const uint8_t* data = contents.data;
+  const uint8_t version_major = data[6];
+  const uint8_t version_minor = data[7];
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_verify_header_prefix(
+      data, version_major, version_minor));
+  iree_host_size_t header_offset = 0;
+  iree_host_size_t header_length = 0;
+  if (version_major == 1) {
+    header_offset = 10;
+    header_length =
+        (iree_host_size_t)data[8] | ((iree_host_size_t)data[9] << 8);
+  } else {
+    if (contents.data_length < 12) {
+      return iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "failed to read version %d.%d 4-byte header length", version_major,
+          version_minor);
+    }
+    header_offset = 12;
+    header_length = (iree_host_size_t)data[8] |
+                    ((iree_host_size_t)data[9] << 8) |
+                    ((iree_host_size_t)data[10] << 16) |
+                    ((iree_host_size_t)data[11] << 24);
+  }
+  if (header_length > contents.data_length - header_offset) {
+    return iree_make_status(
+        IREE_STATUS_RESOURCE_EXHAUSTED,
+        "failed to read header string of %" PRIhsz " bytes", header_length);
+  }
+  IREE_RETURN_IF_ERROR(iree_numpy_npy_parse_header(
+      iree_string_view_trim(iree_make_string_view(
+          (const char*)data + header_offset, header_length)),
+      out_header));
+  *out_payload_offset = header_offset + header_length;
+  return iree_ok_status();
+}
+
+// Releases the file handle retained by a buffer imported from its contents.
+static void iree_numpy_npy_file_handle_buffer_release(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_io_file_handle_release((iree_io_file_handle_t*)user_data);
+}
+
+// Tries to import |contents| of |file_handle| as a device-accessible buffer
+// without copying. Returns false if the allocator cannot import the memory.
+static bool iree_numpy_npy_try_import_ndarray(
+    iree_io_file_handle_t* file_handle, iree_byte_span_t contents,
+    const iree_numpy_npy_header_t* header,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  // The mapping is read-only and cannot back writable buffers.
+  if (iree_any_bit_set(buffer_params.access, IREE_HAL_MEMORY_ACCESS_WRITE)) {
+    return false;
+  }
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = 0,
+      .size = (iree_device_size_t)contents.data_length,
+      .handle =
+          {
+              .host_allocation =
+                  {
+                      .ptr = contents.data,
+                  },
+          },
+  };
+
+  // NOTE: the buffer retains the file handle so that the mapping outlives it.
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_numpy_npy_file_handle_buffer_release,
+      .user_data = file_handle,
+  };
+  iree_io_file_handle_retain(file_handle);
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_allocator_import_buffer(
+      device_allocator, buffer_params, &external_buffer, release_callback,
+      &buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_io_file_handle_release(file_handle);
+    iree_status_ignore(status);
+    return false;
+  }
+  status = iree_hal_buffer_view_create(
+      buffer, header->shape_rank, header->shape, header->element_type,
+      header->encoding_type,
+      iree_hal_allocator_host_allocator(device_allocator), out_buffer_view);
+  iree_hal_buffer_release(buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  return true;
+}
+
+// Streams |length| bytes of the ndarray contents at |offset| in |file_handle|
+// into a new device buffer with iree_hal_device_queue_read. Returns
+// IREE_STATUS_UNAVAILABLE if the |device| cannot import the file.
+static iree_status_t iree_numpy_npy_stream_ndarray(
+    iree_io_file_handle_t* file_handle, uint64_t offset,
+    iree_device_size_t length, const iree_numpy_npy_header_t* header,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  const iree_hal_queue_affinity_t queue_affinity =
+      buffer_params.queue_affinity ? buffer_params.queue_affinity
+                                   : IREE_HAL_QUEUE_AFFINITY_ANY;
+  iree_hal_file_t* file = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_file_import(
+      device, queue_affinity, IREE_HAL_MEMORY_ACCESS_READ, file_handle,
+      IREE_HAL_EXTERNAL_FILE_FLAG_NONE, &file));
+
+  buffer_params.access |= IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE;
+  buffer_params.usage |= IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET;
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, buffer_params, length, &buffer);
+
+  // Read the contents and wait for them to land in the buffer.
+  iree_hal_semaphore_t* semaphore = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(device, 0ull, &semaphore);
+  }
+  if (iree_status_is_ok(status)) {
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphore_list = {
+        .count = 1,
+        .semaphores = &semaphore,
+        .payload_values = &signal_value,
+    };
+    status = iree_hal_device_queue_read(
+        device, queue_affinity, iree_hal_semaphore_list_empty(),
+        signal_semaphore_list, file, offset, buffer, 0, length, 0);
+  }
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout());
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_file_release(file);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_view_create(
+        buffer, header->shape_rank, header->shape, header->element_type,
+        header->encoding_type,
+        iree_hal_allocator_host_allocator(device_allocator), out_buffer_view);
+  }
+  iree_hal_buffer_release(buffer);
+  return status;
+}
+
+typedef struct {
+  iree_const_byte_span_t contents;
+} iree_numpy_npy_copy_params_t;
+static iree_status_t iree_numpy_npy_copy_into_mapping(
+    iree_hal_buffer_mapping_t* mapping, void* user_data) {
+  iree_numpy_npy_copy_params_t* params =
+      (iree_numpy_npy_copy_params_t*)user_data;
+  memcpy(mapping->contents.data, params->contents.data,
+         iree_min(mapping->contents.data_length,
+                  params->contents.data_length));
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray_from_file_handle(
+    iree_io_file_handle_t* file_handle, uint64_t* inout_offset,
+    iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(file_handle);
+  IREE_ASSERT_ARGUMENT(inout_offset);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  *out_buffer_view = NULL;
+  if (iree_io_file_handle_type(file_handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "npy loading requires a file handle referencing "
+                            "host memory such as a mapped file");
+  }
+  iree_byte_span_t file_contents =
+      iree_io_file_handle_value(file_handle).host_allocation;
+  if (*inout_offset >= file_contents.data_length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "end-of-file");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Parse the header directly from the file contents.
+  iree_const_byte_span_t contents = iree_make_const_byte_span(
+      file_contents.data + *inout_offset,
+      file_contents.data_length - (iree_host_size_t)*inout_offset);
+  iree_numpy_npy_header_t header;
+  iree_host_size_t payload_offset = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_npy_parse_header_from_memory(contents, &header,
+                                                  &payload_offset));
+  iree_device_size_t payload_length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_buffer_compute_view_size(
+              header.shape_rank, header.shape, header.element_type,
+              header.encoding_type, &payload_length));
+  if (payload_length > contents.data_length - payload_offset) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to read npy contents of %" PRIdsz " bytes",
+                            payload_length);
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)payload_length);
+  iree_byte_span_t payload = iree_make_byte_span(
+      file_contents.data + *inout_offset + payload_offset,
+      (iree_host_size_t)payload_length);
+
+  // Prefer using the mapped contents directly, then streaming them into
+  // device memory, and only as a last resort copying them through a host
+  // mapping of the device buffer. None of these materialize another copy of
+  // the contents in host memory.
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE) ||
+      !iree_numpy_npy_try_import_ndarray(file_handle, payload, &header,
+                                         buffer_params, device_allocator,
+                                         out_buffer_view)) {
+    status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+    if (device) {
+      status = iree_numpy_npy_stream_ndarray(
+          file_handle, *inout_offset + payload_offset, payload_length,
+          &header, buffer_params, device, device_allocator, out_buffer_view);
+    }
+    if (iree_status_is_unavailable(status)) {
+      iree_status_ignore(status);
+      iree_numpy_npy_copy_params_t copy_params = {
+          .contents = iree_make_const_byte_span(payload.data,
+                                                payload.data_length),
+      };
+      buffer_params.access |= IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE;
+      status = iree_hal_buffer_view_generate_buffer(
+          device, device_allocator, header.shape_rank, header.shape,
+          header.element_type, header.encoding_type, buffer_params,
+          iree_numpy_npy_copy_into_mapping, &copy_params, out_buffer_view);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *inout_offset += payload_offset + payload_length;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Builds a dtype string from |buffer_view|.
 static iree_status_t iree_numpy_npy_build_dtype(
     iree_hal_buffer_view_t* buffer_view, iree_string_builder_t* builder) {
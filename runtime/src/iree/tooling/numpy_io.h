@@ -18,8 +18,8 @@
 //
 // .npy and uncompressed .npz files can be mapped into host memory with
 // IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE if the HAL device allocator
-// supports using such memory. On devices with discrete memory the contents will
-// be loaded into host memory and copied to the device.
+// supports using such memory. On devices with discrete memory the contents
+// of mapped files are streamed to the device with iree_hal_device_queue_read.
 //
 // This current implementation is very basic; in the future it'd be nice to
 // support an iree_io_stream_t to allow for externalizing the file access.
@@ -40,6 +40,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -89,6 +90,26 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     iree_hal_allocator_t* device_allocator,
     iree_hal_buffer_view_t** out_buffer_view);
 
+// Loads a single value from the .npy contents of |file_handle| starting at
+// |inout_offset| into a buffer view. Behaves like iree_numpy_npy_load_ndarray
+// but without reading the contents through an intermediate host allocation.
+// Upon return |inout_offset| will be positioned immediately following the
+// ndarray contents, which may be the end of the file.
+//
+// |file_handle| must reference host memory such as the handles returned by
+// iree_io_file_handle_open_mapped. If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is
+// set and the |device_allocator| can import the memory then the buffer view
+// references the file contents directly and retains |file_handle|. Otherwise
+// the contents are streamed into a new device buffer with
+// iree_hal_device_queue_read or, if |device| cannot import the file, copied
+// into a host mapping of the device buffer.
+IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray_from_file_handle(
+    iree_io_file_handle_t* file_handle, uint64_t* inout_offset,
+    iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view);
+
 // Saves |buffer_view| to a .npy |stream|.
 // The ndarray will be appended to the stream to produce a concatenated file.
 //
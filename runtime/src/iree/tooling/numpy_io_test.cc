@@ -71,6 +71,24 @@ class NumpyIOTest : public ::testing::Test {
     return NULL;
   }
 
+  iree_io_file_handle_t* MapInputFile(const char* name) {
+    const struct iree_file_toc_t* file_toc = iree_numpy_npy_files_create();
+    for (size_t i = 0; i < iree_numpy_npy_files_size(); ++i) {
+      if (strcmp(file_toc[i].name, name) != 0) continue;
+      auto file_path = GetTempFilename(name);
+      IREE_CHECK_OK(iree_file_write_contents(
+          file_path.c_str(),
+          iree_make_const_byte_span(file_toc[i].data, file_toc[i].size)));
+      iree_io_file_handle_t* file_handle = NULL;
+      IREE_CHECK_OK(iree_io_file_handle_open_mapped(
+          iree_make_cstring_view(file_path.c_str()), IREE_IO_FILE_ACCESS_READ,
+          IREE_IO_FILE_MAPPING_FLAG_NONE, IREE_IO_FILE_ADVICE_SEQUENTIAL,
+          iree_allocator_system(), &file_handle));
+      return file_handle;
+    }
+    return NULL;
+  }
+
   FILE* OpenOutputFile(const char* name) {
     auto file_path = GetTempFilename(name);
     return fopen(file_path.c_str(), "w+b");
@@ -194,6 +212,71 @@ TEST_F(NumpyIOTest, LoadMultipleArrays) {
   fclose(stream);
 }
 
+template <typename T>
+static void LoadArrayFromFileHandleAndAssertContents(
+    iree_io_file_handle_t* file_handle, uint64_t* offset,
+    iree_numpy_npy_load_options_t options, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator, std::vector<iree_hal_dim_t> shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type, std::vector<T> contents) {
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_numpy_npy_load_ndarray_from_file_handle(
+      file_handle, offset, options, buffer_params, device, device_allocator,
+      &buffer_view));
+  AssertBufferViewContents<T>(buffer_view, shape, element_type, encoding_type,
+                              contents);
+  iree_hal_buffer_view_release(buffer_view);
+}
+
+// Tests loading multiple arrays from a mapped file both by importing the
+// mapped contents and by streaming them into device buffers.
+TEST_F(NumpyIOTest, LoadMultipleArraysFromFileHandle) {
+  iree_io_file_handle_t* file_handle = MapInputFile("multiple.npy");
+  ASSERT_NE(file_handle, nullptr);
+  const uint64_t file_length =
+      iree_io_file_handle_value(file_handle).host_allocation.data_length;
+
+  for (iree_numpy_npy_load_options_t options :
+       {IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT,
+        IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE}) {
+    uint64_t offset = 0;
+
+    // np.array([1.1, 2.2, 3.3], dtype=np.float32)
+    LoadArrayFromFileHandleAndAssertContents<float>(
+        file_handle, &offset, options, device_, device_allocator_, {3},
+        IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        {1.1f, 2.2f, 3.3f});
+
+    // np.array([[0, 1], [2, 3]], dtype=np.int32)
+    LoadArrayFromFileHandleAndAssertContents<int32_t>(
+        file_handle, &offset, options, device_, device_allocator_, {2, 2},
+        IREE_HAL_ELEMENT_TYPE_SINT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        {0, 1, 2, 3});
+
+    // np.array(42, dtype=np.int32)
+    LoadArrayFromFileHandleAndAssertContents<int32_t>(
+        file_handle, &offset, options, device_, device_allocator_, {},
+        IREE_HAL_ELEMENT_TYPE_SINT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        {42});
+
+    // Should have hit EOF.
+    EXPECT_EQ(offset, file_length);
+    iree_hal_buffer_params_t buffer_params = {};
+    buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    EXPECT_THAT(Status(iree_numpy_npy_load_ndarray_from_file_handle(
+                    file_handle, &offset, options, buffer_params, device_,
+                    device_allocator_, &buffer_view)),
+                StatusIs(StatusCode::kOutOfRange));
+  }
+
+  iree_io_file_handle_release(file_handle);
+}
+
 // Tests loading arrays with various shapes.
 TEST_F(NumpyIOTest, ArrayShapes) {
   FILE* stream = OpenInputFile("array_shapes.npy");
@@ -14,6 +14,7 @@
 #include "iree/tooling/context_util.h"
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/instrument_util.h"
+#include "iree/tooling/startup_profile.h"
 #include "iree/tooling/vm_util.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
@@ -217,6 +218,7 @@ static iree_status_t iree_tooling_run_function(
   }
 
   // Invoke the function with the provided inputs.
+  iree_time_t invoke_start_ns = iree_time_now();
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(
         iree_vm_invoke(context, function, IREE_VM_INVOCATION_FLAG_NONE,
@@ -232,6 +234,9 @@ static iree_status_t iree_tooling_run_function(
         iree_hal_fence_wait(finish_fence, iree_infinite_timeout()),
         "waiting on finish fence");
   }
+  iree_tooling_startup_profile_record(
+      IREE_TOOLING_STARTUP_PHASE_FIRST_INVOCATION, function_name,
+      iree_time_now() - invoke_start_ns, 0);
 
   // End profiling after waiting for the invocation to finish.
   if (iree_status_is_ok(status)) {
@@ -366,6 +371,9 @@ iree_status_t iree_tooling_run_module_with_data(
       iree_tooling_run_function(context, function, device, device_allocator,
                                 host_allocator, out_exit_code);
 
+  // Report startup timing while the context (and its HAL module state) lives.
+  iree_tooling_startup_profile_fprint(stderr, context);
+
   // Release the context and all retained resources (variables, constants, etc).
   iree_vm_context_release(context);
 
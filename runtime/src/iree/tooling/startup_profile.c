@@ -0,0 +1,176 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/startup_profile.h"
+
+#include <string.h>
+
+#include "iree/base/internal/flags.h"
+#include "iree/modules/hal/module.h"
+
+IREE_FLAG(bool, profile_startup, false,
+          "Prints a breakdown of the time spent in each phase of startup\n"
+          "(module loading, device creation, context creation, and the first\n"
+          "invocation) along with the per-executable load cost and constant\n"
+          "upload volume to stderr.");
+
+// Maximum number of phase records retained; additional records are dropped.
+#define IREE_TOOLING_STARTUP_PROFILE_MAX_RECORDS 64
+
+typedef struct iree_tooling_startup_record_t {
+  iree_tooling_startup_phase_t phase;
+  char label[128];
+  iree_duration_t duration_ns;
+  uint64_t byte_count;
+} iree_tooling_startup_record_t;
+
+// Process-global as startup spans tooling utilities that don't share state.
+// Tools are single-threaded during startup and no synchronization is needed.
+static struct {
+  iree_host_size_t record_count;
+  iree_tooling_startup_record_t
+      records[IREE_TOOLING_STARTUP_PROFILE_MAX_RECORDS];
+} iree_tooling_startup_profile;
+
+static const char* iree_tooling_startup_phase_name(
+    iree_tooling_startup_phase_t phase) {
+  switch (phase) {
+    case IREE_TOOLING_STARTUP_PHASE_INSTANCE_CREATE:
+      return "instance.create";
+    case IREE_TOOLING_STARTUP_PHASE_MODULE_READ:
+      return "module.read";
+    case IREE_TOOLING_STARTUP_PHASE_MODULE_CREATE:
+      return "module.create";
+    case IREE_TOOLING_STARTUP_PHASE_DEVICE_CREATE:
+      return "device.create";
+    case IREE_TOOLING_STARTUP_PHASE_HAL_MODULE_CREATE:
+      return "hal.module.create";
+    case IREE_TOOLING_STARTUP_PHASE_CONTEXT_CREATE:
+      return "context.create";
+    case IREE_TOOLING_STARTUP_PHASE_FIRST_INVOCATION:
+      return "invoke.first";
+    default:
+      return "unknown";
+  }
+}
+
+bool iree_tooling_startup_profile_is_enabled(void) {
+  return FLAG_profile_startup;
+}
+
+void iree_tooling_startup_profile_record(iree_tooling_startup_phase_t phase,
+                                         iree_string_view_t label,
+                                         iree_duration_t duration_ns,
+                                         uint64_t byte_count) {
+  if (!FLAG_profile_startup) return;
+  if (iree_tooling_startup_profile.record_count >=
+      IREE_TOOLING_STARTUP_PROFILE_MAX_RECORDS) {
+    return;
+  }
+  iree_tooling_startup_record_t* record =
+      &iree_tooling_startup_profile
+           .records[iree_tooling_startup_profile.record_count++];
+  memset(record, 0, sizeof(*record));
+  record->phase = phase;
+  iree_string_view_to_cstring(label, record->label, sizeof(record->label));
+  record->duration_ns = duration_ns;
+  record->byte_count = byte_count;
+}
+
+static double iree_tooling_ns_to_ms(iree_duration_t duration_ns) {
+  return (double)duration_ns / 1000000.0;
+}
+
+// Returns the load statistics of the async HAL module in |context| or empty
+// statistics if the HAL module is not used.
+static iree_hal_module_load_statistics_t
+iree_tooling_query_hal_load_statistics(iree_vm_context_t* context) {
+  iree_hal_module_load_statistics_t statistics;
+  memset(&statistics, 0, sizeof(statistics));
+  if (!context) return statistics;
+  for (iree_host_size_t i = 0; i < iree_vm_context_module_count(context);
+       ++i) {
+    iree_vm_module_t* module = iree_vm_context_module_at(context, i);
+    if (!iree_string_view_equal(iree_vm_module_name(module), IREE_SV("hal"))) {
+      continue;
+    }
+    iree_vm_module_state_t* module_state = NULL;
+    iree_status_t status =
+        iree_vm_context_resolve_module_state(context, module, &module_state);
+    if (iree_status_is_ok(status)) {
+      statistics = iree_hal_module_state_load_statistics(module_state);
+    }
+    iree_status_ignore(status);
+    break;
+  }
+  return statistics;
+}
+
+void iree_tooling_startup_profile_fprint(FILE* file,
+                                         iree_vm_context_t* context) {
+  if (!FLAG_profile_startup) return;
+
+  fprintf(file, "[[ startup profile ]]\n");
+  fprintf(file, "%-18s %12s %14s  %s\n", "phase", "time (ms)", "bytes",
+          "label");
+  iree_duration_t total_ns = 0;
+  iree_duration_t context_create_ns = 0;
+  for (iree_host_size_t i = 0; i < iree_tooling_startup_profile.record_count;
+       ++i) {
+    const iree_tooling_startup_record_t* record =
+        &iree_tooling_startup_profile.records[i];
+    fprintf(file, "%-18s %12.3f %14" PRIu64 "  %s\n",
+            iree_tooling_startup_phase_name(record->phase),
+            iree_tooling_ns_to_ms(record->duration_ns), record->byte_count,
+            record->label);
+    total_ns += record->duration_ns;
+    if (record->phase == IREE_TOOLING_STARTUP_PHASE_CONTEXT_CREATE) {
+      context_create_ns += record->duration_ns;
+    }
+  }
+  fprintf(file, "%-18s %12.3f\n", "total", iree_tooling_ns_to_ms(total_ns));
+
+  iree_hal_module_load_statistics_t statistics =
+      iree_tooling_query_hal_load_statistics(context);
+  if (statistics.executable_count > 0) {
+    iree_duration_t executable_total_ns = 0;
+    iree_host_size_t executable_total_bytes = 0;
+    fprintf(file, "\n%-10s %-32s %14s %12s\n", "executable", "format", "bytes",
+            "time (ms)");
+    for (iree_host_size_t i = 0; i < statistics.executable_count; ++i) {
+      const iree_hal_module_executable_load_t* load =
+          &statistics.executables[i];
+      fprintf(file, "%-10" PRIhsz " %-32s %14" PRIhsz " %12.3f\n", i,
+              load->format, load->data_length,
+              iree_tooling_ns_to_ms(load->duration_ns));
+      executable_total_ns += load->duration_ns;
+      executable_total_bytes += load->data_length;
+    }
+    fprintf(file, "%-10s %-32s %14" PRIhsz " %12.3f\n", "total", "",
+            executable_total_bytes, iree_tooling_ns_to_ms(executable_total_ns));
+    // Attribute whatever context creation time was not spent loading
+    // executables to constant upload; initializers do little else.
+    context_create_ns -= iree_min(context_create_ns, executable_total_ns);
+  }
+
+  if (statistics.constant_bytes > 0) {
+    fprintf(file, "\nconstants: %" PRIu64 " bytes", statistics.constant_bytes);
+    if (context_create_ns > 0) {
+      double seconds = (double)context_create_ns / 1e9;
+      fprintf(file, " in ~%.3f ms (~%.1f MB/s)",
+              iree_tooling_ns_to_ms(context_create_ns),
+              (double)statistics.constant_bytes / seconds / (1024.0 * 1024.0));
+    }
+    fprintf(file,
+            "\n  (excludes asynchronous reads completing during the first "
+            "invocation)\n");
+  }
+  if (statistics.deduplicated_constant_bytes > 0) {
+    fprintf(file, "constants shared between modules: %" PRIu64 " bytes\n",
+            statistics.deduplicated_constant_bytes);
+  }
+  fflush(file);
+}
@@ -0,0 +1,64 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TOOLING_STARTUP_PROFILE_H_
+#define IREE_TOOLING_STARTUP_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Phases of cold-start timed by the startup profile.
+typedef enum iree_tooling_startup_phase_e {
+  // VM instance creation and type registration.
+  IREE_TOOLING_STARTUP_PHASE_INSTANCE_CREATE = 0,
+  // Reading or mapping a module file into memory.
+  IREE_TOOLING_STARTUP_PHASE_MODULE_READ,
+  // Creating a module from its contents including bytecode verification.
+  IREE_TOOLING_STARTUP_PHASE_MODULE_CREATE,
+  // HAL driver and device creation.
+  IREE_TOOLING_STARTUP_PHASE_DEVICE_CREATE,
+  // HAL module creation around the device.
+  IREE_TOOLING_STARTUP_PHASE_HAL_MODULE_CREATE,
+  // iree_vm_context_create_with_modules: module state allocation and module
+  // initializers loading executables and uploading constants.
+  IREE_TOOLING_STARTUP_PHASE_CONTEXT_CREATE,
+  // The first invocation of a function including any work deferred by module
+  // initialization such as asynchronous constant reads.
+  IREE_TOOLING_STARTUP_PHASE_FIRST_INVOCATION,
+  IREE_TOOLING_STARTUP_PHASE_COUNT,
+} iree_tooling_startup_phase_t;
+
+// Returns true if startup profiling was requested with --profile_startup.
+// When enabled HAL modules created by the tooling collect load statistics.
+bool iree_tooling_startup_profile_is_enabled(void);
+
+// Records a |phase| that took |duration_ns| and processed |byte_count| bytes
+// (or 0 if not applicable). |label| identifies the resource the phase operated
+// on, such as a module path, and is copied. No-op if profiling is disabled.
+void iree_tooling_startup_profile_record(iree_tooling_startup_phase_t phase,
+                                         iree_string_view_t label,
+                                         iree_duration_t duration_ns,
+                                         uint64_t byte_count);
+
+// Prints the recorded phases to |file| along with the executables and
+// constants loaded by the HAL module of |context| (if any).
+// No-op if profiling is disabled.
+void iree_tooling_startup_profile_fprint(FILE* file,
+                                         iree_vm_context_t* context);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TOOLING_STARTUP_PROFILE_H_
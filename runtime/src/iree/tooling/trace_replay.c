@@ -1310,6 +1310,21 @@ iree_status_t iree_trace_replay_event_call(
       z0, iree_trace_replay_event_call_prepare(replay, document, event_node,
                                                &function, &input_list));
 
+  iree_status_t status = iree_trace_replay_event_call_with_inputs(
+      replay, document, event_node, function, input_list, hooks);
+
+  iree_vm_list_release(input_list);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_trace_replay_event_call_with_inputs(
+    iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* event_node, iree_vm_function_t function,
+    iree_vm_list_t* input_list, const iree_trace_replay_call_hooks_t* hooks) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
   iree_vm_list_t* output_list = NULL;
   iree_status_t status = iree_vm_list_create(
       iree_vm_make_undefined_type_def(), /*initial_capacity=*/8,
@@ -1340,12 +1355,6 @@ iree_status_t iree_trace_replay_event_call(
                           function, output_list);
   }
 
-  // NOTE: we could release this prior to the hooks but if the hooks are timing
-  // or capturing performance data we want them to be able to scope themselves
-  // to just the call. The downside is that if the hook allocates memory it
-  // won't be able to reuse what we're holding on to here.
-  iree_vm_list_release(input_list);
-
   if (iree_status_is_ok(status)) {
     status = iree_trace_replay_event_call_finish(replay, document, event_node,
                                                  function, output_list);
@@ -1609,3 +1618,158 @@ iree_status_t iree_trace_replay_event(iree_trace_replay_t* replay,
       event_node->start_mark.line, (int)type_node->data.scalar.length,
       type_node->data.scalar.value);
 }
+
+//===----------------------------------------------------------------------===//
+// iree_trace_replay_plan_t
+//===----------------------------------------------------------------------===//
+
+// Returns true if |node| or any node nested within it references replay state
+// via an I/O or blackboard macro.
+static bool iree_trace_replay_node_references_state(yaml_document_t* document,
+                                                    yaml_node_t* node) {
+  if (!node) return false;
+  iree_string_view_t tag = iree_make_cstring_view((const char*)node->tag);
+  if (iree_string_view_starts_with(tag, IREE_SV("!input.")) ||
+      iree_string_view_starts_with(tag, IREE_SV("!output.")) ||
+      iree_string_view_starts_with(tag, IREE_SV("!blackboard."))) {
+    return true;
+  }
+  switch (node->type) {
+    case YAML_SEQUENCE_NODE:
+      for (yaml_node_item_t* item = node->data.sequence.items.start;
+           item != node->data.sequence.items.top; ++item) {
+        if (iree_trace_replay_node_references_state(
+                document, yaml_document_get_node(document, *item))) {
+          return true;
+        }
+      }
+      return false;
+    case YAML_MAPPING_NODE:
+      for (yaml_node_pair_t* pair = node->data.mapping.pairs.start;
+           pair != node->data.mapping.pairs.top; ++pair) {
+        if (iree_trace_replay_node_references_state(
+                document, yaml_document_get_node(document, pair->value))) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// Classifies the event in |step| so that replays need not inspect the YAML.
+static iree_status_t iree_trace_replay_step_classify(
+    iree_trace_replay_step_t* step) {
+  yaml_document_t* document = &step->document;
+  yaml_node_t* event_node = step->event_node;
+  if (event_node->type != YAML_MAPPING_NODE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "(%zu): expected mapping node",
+                            event_node->start_mark.line);
+  }
+  yaml_node_t* type_node = NULL;
+  IREE_RETURN_IF_ERROR(iree_yaml_mapping_find(document, event_node,
+                                              IREE_SV("type"), &type_node));
+  step->is_call = iree_yaml_string_equal(type_node, IREE_SV("call"));
+  if (step->is_call) {
+    yaml_node_t* args_node = NULL;
+    IREE_RETURN_IF_ERROR(iree_yaml_mapping_try_find(
+        document, event_node, IREE_SV("args"), &args_node));
+    step->has_static_args =
+        !iree_trace_replay_node_references_state(document, args_node);
+  }
+  return iree_ok_status();
+}
+
+// Appends a step for |document| to |plan|, taking ownership of the document.
+static iree_status_t iree_trace_replay_plan_append(
+    iree_trace_replay_plan_t* plan, yaml_document_t* document) {
+  if (plan->step_count + 1 > plan->step_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, plan->step_capacity * 2);
+    iree_status_t status = iree_allocator_realloc(
+        plan->host_allocator, new_capacity * sizeof(plan->steps[0]),
+        (void**)&plan->steps);
+    if (!iree_status_is_ok(status)) {
+      yaml_document_delete(document);
+      return status;
+    }
+    plan->step_capacity = new_capacity;
+  }
+  // The document nodes are heap allocated and the root node remains valid
+  // when the document struct is moved into the step.
+  iree_trace_replay_step_t* step = &plan->steps[plan->step_count++];
+  memset(step, 0, sizeof(*step));
+  step->document = *document;
+  step->event_node = yaml_document_get_root_node(&step->document);
+  IREE_RETURN_IF_ERROR(iree_trace_replay_step_classify(step));
+  if (step->is_call && plan->first_call_step == IREE_HOST_SIZE_MAX) {
+    plan->first_call_step = plan->step_count - 1;
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_trace_replay_plan_initialize_from_file(
+    FILE* file, iree_allocator_t host_allocator,
+    iree_trace_replay_plan_t* out_plan) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_plan, 0, sizeof(*out_plan));
+  out_plan->host_allocator = host_allocator;
+  out_plan->first_call_step = IREE_HOST_SIZE_MAX;
+
+  yaml_parser_t parser;
+  if (!yaml_parser_initialize(&parser)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "yaml_parser_initialize failed");
+  }
+  yaml_parser_set_input_file(&parser, file);
+
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status)) {
+    yaml_document_t document;
+    if (!yaml_parser_load(&parser, &document)) {
+      status = iree_status_from_yaml_parser_error(&parser);
+      break;
+    }
+    if (!yaml_document_get_root_node(&document)) {
+      // An empty document indicates EOF.
+      yaml_document_delete(&document);
+      break;
+    }
+    status = iree_trace_replay_plan_append(out_plan, &document);
+  }
+
+  yaml_parser_delete(&parser);
+
+  if (out_plan->first_call_step == IREE_HOST_SIZE_MAX) {
+    out_plan->first_call_step = out_plan->step_count;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_trace_replay_plan_deinitialize(out_plan);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_trace_replay_plan_deinitialize(iree_trace_replay_plan_t* plan) {
+  for (iree_host_size_t i = 0; i < plan->step_count; ++i) {
+    yaml_document_delete(&plan->steps[i].document);
+  }
+  iree_allocator_free(plan->host_allocator, plan->steps);
+  memset(plan, 0, sizeof(*plan));
+}
+
+iree_string_view_t iree_trace_replay_step_function_name(
+    iree_trace_replay_step_t* step) {
+  if (!step->is_call) return iree_string_view_empty();
+  yaml_node_t* function_node = NULL;
+  iree_status_t status =
+      iree_yaml_mapping_find(&step->document, step->event_node,
+                             IREE_SV("function"), &function_node);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return iree_string_view_empty();
+  }
+  return iree_yaml_node_as_string(function_node);
+}
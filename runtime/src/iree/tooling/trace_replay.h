@@ -7,6 +7,8 @@
 #ifndef IREE_TOOLING_TRACE_REPLAY_H_
 #define IREE_TOOLING_TRACE_REPLAY_H_
 
+#include <stdio.h>
+
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/tooling/yaml_util.h"
@@ -154,6 +156,60 @@ iree_status_t iree_trace_replay_event_call(
     iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node, const iree_trace_replay_call_hooks_t* hooks);
 
+// Replays a `call` event against the replay context using |function| and
+// |input_list| as produced by iree_trace_replay_event_call_prepare.
+// |input_list| is not consumed and may be reused for subsequent calls so long
+// as the callee does not mutate the values within it.
+iree_status_t iree_trace_replay_event_call_with_inputs(
+    iree_trace_replay_t* replay, yaml_document_t* document,
+    yaml_node_t* event_node, iree_vm_function_t function,
+    iree_vm_list_t* input_list, const iree_trace_replay_call_hooks_t* hooks);
+
+//===----------------------------------------------------------------------===//
+// iree_trace_replay_plan_t
+//===----------------------------------------------------------------------===//
+
+// A single event of a trace file retained in its parsed form.
+typedef struct iree_trace_replay_step_t {
+  // YAML document containing the event as its root node.
+  yaml_document_t document;
+  // Root event node of |document|.
+  yaml_node_t* event_node;
+  // True if the event is a `call`.
+  bool is_call;
+  // True if the event is a `call` whose arguments do not reference replay
+  // state (`!input.*`, `!output.*`, or `!blackboard.*`) and that can be
+  // prepared once per device and reused across replays.
+  bool has_static_args;
+} iree_trace_replay_step_t;
+
+// A trace file parsed into memory so that it can be replayed repeatedly
+// without reading or parsing the YAML on each replay.
+typedef struct iree_trace_replay_plan_t {
+  iree_allocator_t host_allocator;
+  // Total number of steps in the trace in execution order.
+  iree_host_size_t step_count;
+  iree_host_size_t step_capacity;
+  iree_trace_replay_step_t* steps;
+  // Index of the first `call` step or |step_count| if there are none.
+  // Steps prior to this set up the context and modules.
+  iree_host_size_t first_call_step;
+} iree_trace_replay_plan_t;
+
+// Parses all events from the YAML trace |file| into |out_plan|.
+// The file is read until EOF and may be closed after the call returns.
+iree_status_t iree_trace_replay_plan_initialize_from_file(
+    FILE* file, iree_allocator_t host_allocator,
+    iree_trace_replay_plan_t* out_plan);
+
+// Deinitializes |plan| and releases all parsed documents.
+void iree_trace_replay_plan_deinitialize(iree_trace_replay_plan_t* plan);
+
+// Returns the `module.function` name called by |step| or empty if the step is
+// not a call.
+iree_string_view_t iree_trace_replay_step_function_name(
+    iree_trace_replay_step_t* step);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
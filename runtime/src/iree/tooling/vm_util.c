@@ -13,6 +13,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tooling/numpy_io.h"
 
@@ -25,9 +26,56 @@ static iree_status_t iree_allocate_and_copy_cstring_from_view(
   return iree_ok_status();
 }
 
+// Loads all ndarrays from the npy file mapped by |file_handle| into |list|.
+// The contents are imported or streamed into device buffers directly from the
+// mapping instead of being read into host memory first.
+static iree_status_t iree_tooling_load_ndarrays_from_file_handle(
+    iree_io_file_handle_t* file_handle, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator, iree_vm_list_t* list) {
+  const uint64_t file_length =
+      iree_io_file_handle_value(file_handle).host_allocation.data_length;
+
+  iree_hal_buffer_params_t buffer_params = {0};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+
+  iree_status_t status = iree_ok_status();
+  uint64_t offset = 0;
+  while (iree_status_is_ok(status) && offset < file_length) {
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    status = iree_numpy_npy_load_ndarray_from_file_handle(
+        file_handle, &offset, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE,
+        buffer_params, device, device_allocator, &buffer_view);
+    if (iree_status_is_ok(status)) {
+      iree_vm_ref_t buffer_view_ref =
+          iree_hal_buffer_view_retain_ref(buffer_view);
+      status = iree_vm_list_push_ref_move(list, &buffer_view_ref);
+    }
+    iree_hal_buffer_view_release(buffer_view);
+  }
+  return status;
+}
+
 static iree_status_t iree_tooling_load_ndarrays_from_file(
     iree_string_view_t file_path, iree_hal_device_t* device,
     iree_hal_allocator_t* device_allocator, iree_vm_list_t* list) {
+  // Map the file if possible so that large inputs are not read into host
+  // memory just to be copied again into device memory.
+  iree_io_file_handle_t* file_handle = NULL;
+  iree_status_t map_status = iree_io_file_handle_open_mapped(
+      file_path, IREE_IO_FILE_ACCESS_READ, IREE_IO_FILE_MAPPING_FLAG_NONE,
+      IREE_IO_FILE_ADVICE_SEQUENTIAL, iree_allocator_system(), &file_handle);
+  if (iree_status_is_ok(map_status)) {
+    iree_status_t status = iree_tooling_load_ndarrays_from_file_handle(
+        file_handle, device, device_allocator, list);
+    iree_io_file_handle_release(file_handle);
+    return status;
+  } else if (!iree_status_is_unavailable(map_status)) {
+    return map_status;
+  }
+  iree_status_ignore(map_status);
+
   char* file_path_cstring = NULL;
   IREE_RETURN_IF_ERROR(iree_allocate_and_copy_cstring_from_view(
       iree_allocator_system(), file_path, &file_path_cstring));
@@ -288,12 +336,29 @@ iree_status_t iree_tooling_append_async_fence_inputs(
 
   iree_string_view_t model =
       iree_vm_function_lookup_attr_by_name(function, IREE_SV("iree.abi.model"));
-  if (!iree_string_view_equal(model, IREE_SV("coarse-fences"))) {
+  const bool is_fine = iree_string_view_equal(model, IREE_SV("fine-fences"));
+  if (!is_fine && !iree_string_view_equal(model, IREE_SV("coarse-fences"))) {
     // Ignore unknown models - the user may have provided their own fences.
     IREE_TRACE_ZONE_END(z0);
     return iree_ok_status();
   }
 
+  // The fine-fences model takes one wait fence per tensor input. All of our
+  // inputs are ready at the same time so each one waits on |wait_fence|.
+  iree_host_size_t wait_fence_count = 1;
+  if (is_fine) {
+    wait_fence_count = 0;
+    for (iree_host_size_t i = 0; i < iree_vm_list_size(list); ++i) {
+      iree_vm_variant_t variant = iree_vm_variant_empty();
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_vm_list_get_variant_assign(list, i, &variant));
+      if (iree_vm_variant_is_ref(variant) &&
+          iree_hal_buffer_view_isa(variant.ref)) {
+        ++wait_fence_count;
+      }
+    }
+  }
+
   // Create the signal fence as a 0->1 transition. The caller will wait on that.
   iree_hal_semaphore_t* semaphore = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -303,8 +368,9 @@ iree_status_t iree_tooling_append_async_fence_inputs(
       semaphore, 1ull, iree_hal_device_host_allocator(device), &signal_fence);
   iree_hal_semaphore_release(semaphore);
 
-  // Append (wait, signal) fences.
-  if (iree_status_is_ok(status)) {
+  // Append (wait..., signal) fences.
+  for (iree_host_size_t i = 0; i < wait_fence_count; ++i) {
+    if (!iree_status_is_ok(status)) break;
     iree_vm_ref_t wait_fence_ref = iree_hal_fence_retain_ref(wait_fence);
     status = iree_vm_list_push_ref_move(list, &wait_fence_ref);
     iree_vm_ref_release(&wait_fence_ref);
@@ -293,6 +293,33 @@ static iree_status_t iree_vm_bytecode_disassembler_emit_remap_list(
     break;                                                             \
   }
 
+#define DISASM_OP_CORE_CMP_BRANCH_I32(op_name, op_mnemonic)                 \
+  DISASM_OP(CORE, op_name) {                                                \
+    uint16_t lhs_reg = VM_ParseOperandRegI32("lhs");                        \
+    uint16_t rhs_reg = VM_ParseOperandRegI32("rhs");                        \
+    int32_t true_block_pc = VM_ParseBranchTarget("true_dest");              \
+    const iree_vm_register_remap_list_t* true_remap_list =                  \
+        VM_ParseBranchOperands("true_operands");                            \
+    int32_t false_block_pc = VM_ParseBranchTarget("false_dest");            \
+    const iree_vm_register_remap_list_t* false_remap_list =                 \
+        VM_ParseBranchOperands("false_operands");                           \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, "%s ", op_mnemonic));          \
+    EMIT_I32_REG_NAME(lhs_reg);                                             \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[lhs_reg]);                            \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", "));      \
+    EMIT_I32_REG_NAME(rhs_reg);                                             \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[rhs_reg]);                            \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, ", ^%08X(", true_block_pc));   \
+    EMIT_REMAP_LIST(true_remap_list);                                       \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, "), ^%08X(", false_block_pc)); \
+    EMIT_REMAP_LIST(false_remap_list);                                      \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));       \
+    break;                                                                  \
+  }
+
 #define DISASM_OP_CORE_TERNARY_I32(op_name, op_mnemonic)               \
   DISASM_OP(CORE, op_name) {                                           \
     uint16_t a_reg = VM_ParseOperandRegI32("a");                       \
@@ -1323,6 +1350,18 @@ iree_status_t iree_vm_bytecode_disassemble_op(
     //===------------------------------------------------------------------===//
 
     DISASM_OP_CORE_BINARY_I32(AddI32, "vm.add.i32");
+    DISASM_OP(CORE, AddImmI32) {
+      uint16_t lhs_reg = VM_ParseOperandRegI32("lhs");
+      int32_t imm = VM_ParseIntAttr32("imm");
+      uint16_t result_reg = VM_ParseResultRegI32("result");
+      EMIT_I32_REG_NAME(result_reg);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_cstring(b, " = vm.add.imm.i32 "));
+      EMIT_I32_REG_NAME(lhs_reg);
+      EMIT_OPTIONAL_VALUE_I32(regs->i32[lhs_reg]);
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(b, ", %d", imm));
+      break;
+    }
     DISASM_OP_CORE_BINARY_I32(SubI32, "vm.sub.i32");
     DISASM_OP_CORE_BINARY_I32(MulI32, "vm.mul.i32");
     DISASM_OP_CORE_BINARY_I32(DivI32S, "vm.div.i32.s");
@@ -1591,6 +1630,11 @@ iree_status_t iree_vm_bytecode_disassemble_op(
       break;
     }
 
+    DISASM_OP_CORE_CMP_BRANCH_I32(CmpBranchEQI32, "vm.cmp_br.eq.i32");
+    DISASM_OP_CORE_CMP_BRANCH_I32(CmpBranchNEI32, "vm.cmp_br.ne.i32");
+    DISASM_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32S, "vm.cmp_br.lt.i32.s");
+    DISASM_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32U, "vm.cmp_br.lt.i32.u");
+
     DISASM_OP(CORE, BranchTable) {
       uint16_t index_reg = VM_ParseOperandRegI32("index");
       IREE_RETURN_IF_ERROR(
@@ -104,6 +104,8 @@ static iree_status_t iree_vm_bytecode_function_enter(
   }
   const iree_vm_FunctionDescriptor_t* target_descriptor =
       &module->function_descriptor_table[function.ordinal];
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_ensure_function_verified(
+      module, (uint16_t)function.ordinal));
 
   // We first compute the frame size of the callee and the masks we'll use to
   // bounds check register access. This lets us allocate the entire frame
@@ -115,21 +117,28 @@ static iree_status_t iree_vm_bytecode_function_enter(
   IREE_ASSERT_LE(i32_register_count, IREE_I32_REGISTER_MASK);
   IREE_ASSERT_LE(ref_register_count, IREE_REF_REGISTER_MASK);
 
-  // We need to align the ref register start to the natural machine
-  // alignment in case the compiler is expecting that (it makes it easier to
-  // debug too).
+  // We need to align the register banks to the natural machine alignment in
+  // case the compiler is expecting that (it makes it easier to debug too).
+  //
+  // Ref registers are placed before i32 registers so that only the header and
+  // ref registers need to be zeroed on entry: refs must start out null so that
+  // assignment and frame cleanup can release them while i32 registers are
+  // always written before they are read by compiler-produced bytecode. Any
+  // stale i32 register value read by malformed bytecode is still subject to
+  // the same bounds checks as any other value.
   iree_host_size_t header_size =
       iree_host_align(sizeof(iree_vm_bytecode_frame_storage_t), 16);
-  iree_host_size_t i32_register_size =
-      iree_host_align(i32_register_count * sizeof(int32_t), 16);
   iree_host_size_t ref_register_size =
       iree_host_align(ref_register_count * sizeof(iree_vm_ref_t), 16);
+  iree_host_size_t i32_register_size =
+      iree_host_align(i32_register_count * sizeof(int32_t), 16);
   iree_host_size_t frame_size =
-      header_size + i32_register_size + ref_register_size;
+      header_size + ref_register_size + i32_register_size;
 
   // Enter function and allocate stack frame storage.
-  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter_uninitialized(
       stack, &function, IREE_VM_STACK_FRAME_BYTECODE, frame_size,
+      /*zeroed_frame_size=*/header_size + ref_register_size,
       iree_vm_bytecode_stack_frame_cleanup, out_callee_frame));
 
   // Stash metadata and compute register pointers.
@@ -137,10 +146,11 @@ static iree_status_t iree_vm_bytecode_function_enter(
       (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
           *out_callee_frame);
   stack_storage->cconv_results = cconv_results;
+  stack_storage->flags = 0;
   stack_storage->i32_register_count = i32_register_count;
-  stack_storage->i32_register_offset = header_size;
+  stack_storage->i32_register_offset = header_size + ref_register_size;
   stack_storage->ref_register_count = ref_register_count;
-  stack_storage->ref_register_offset = header_size + i32_register_size;
+  stack_storage->ref_register_offset = header_size;
   *out_callee_registers =
       iree_vm_bytecode_get_register_storage(*out_callee_frame);
 
@@ -534,6 +544,46 @@ static iree_status_t iree_vm_bytecode_verify_import(
   return iree_ok_status();
 }
 
+static_assert(IREE_VM_ABI_REF_REGISTER_MASK == IREE_REF_REGISTER_MASK,
+              "shim ref register mask must match the bytecode ISA");
+
+// Calls a native import with a fixed signature through its register shim.
+// Arguments are read directly from |src_reg_list| and results written directly
+// to |dst_reg_list| without ABI buffers or a trip through begin_call.
+static iree_status_t iree_vm_bytecode_issue_import_register_call(
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    iree_vm_stack_frame_t* IREE_RESTRICT* out_caller_frame,
+    iree_vm_registers_t* out_caller_registers) {
+  // Registers are passed as offsets as the stack may grow during the call.
+  const iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          iree_vm_stack_current_frame(stack));
+  iree_vm_abi_register_file_t register_file = {
+      .i32_offset = stack_storage->i32_register_offset,
+      .ref_offset = stack_storage->ref_register_offset,
+  };
+  iree_status_t call_status = import->register_shim(
+      stack, &import->function, register_file, src_reg_list, dst_reg_list,
+      import->target, import->target_module);
+  if (iree_status_is_deferred(call_status)) {
+    if (import->result_buffer_size > 0) {
+      iree_status_ignore(call_status);
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "yield in imports with results not supported");
+    }
+    return call_status;  // deferred for future resume
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+    return iree_status_annotate(call_status,
+                                iree_make_cstring_view("while calling import"));
+  }
+  *out_caller_frame = iree_vm_stack_current_frame(stack);
+  *out_caller_registers =
+      iree_vm_bytecode_get_register_storage(*out_caller_frame);
+  return iree_ok_status();
+}
+
 // Calls an imported function from another module.
 // Marshals the |src_reg_list| registers into ABI storage and results into
 // |dst_reg_list|.
@@ -548,6 +598,11 @@ static iree_status_t iree_vm_bytecode_call_import(
   const iree_vm_bytecode_import_t* import = NULL;
   IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_import(stack, module_state,
                                                       import_ordinal, &import));
+  if (import->register_shim) {
+    return iree_vm_bytecode_issue_import_register_call(
+        stack, import, src_reg_list, dst_reg_list, out_caller_frame,
+        out_caller_registers);
+  }
 
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
@@ -611,6 +666,39 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
                                             out_caller_registers);
 }
 
+// Returns the import table entry for |import_ordinal| if it can be called
+// directly from the dispatch loop. Unresolved imports are never direct.
+static inline const iree_vm_bytecode_import_t*
+iree_vm_bytecode_lookup_direct_import(
+    const iree_vm_bytecode_module_state_t* module_state,
+    uint32_t import_ordinal) {
+  // Ordinal has been checked as in-bounds during verification.
+  import_ordinal &= 0x7FFFFFFFu;
+  IREE_ASSERT(import_ordinal < module_state->import_count);
+  const iree_vm_bytecode_import_t* import =
+      &module_state->import_table[import_ordinal];
+  return import->direct_module ? import : NULL;
+}
+
+// Enters the bytecode function of a direct |import| from the current frame.
+// The callee frame is marked so that its return pops back into the caller
+// module instead of leaving the dispatch loop.
+static iree_status_t iree_vm_bytecode_direct_enter(
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    iree_vm_stack_frame_t* IREE_RESTRICT* out_callee_frame,
+    iree_vm_registers_t* out_callee_registers) {
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_enter(
+      stack, import->direct_module, import->direct_ordinal, src_reg_list,
+      dst_reg_list, out_callee_frame, out_callee_registers));
+  iree_vm_bytecode_frame_storage_t* callee_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          *out_callee_frame);
+  callee_storage->flags |= IREE_VM_BYTECODE_FRAME_FLAG_DIRECT_CALL;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Main interpreter dispatch routine
 //===----------------------------------------------------------------------===//
@@ -1427,6 +1515,12 @@ static iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP_CORE_BINARY_I32(AddI32, vm_add_i32);
+    DISPATCH_OP(CORE, AddImmI32, {
+      int32_t lhs = VM_DecOperandRegI32("lhs");
+      int32_t imm = VM_DecIntAttr32("imm");
+      int32_t* result = VM_DecResultRegI32("result");
+      *result = vm_add_i32(lhs, imm);
+    });
     DISPATCH_OP_CORE_BINARY_I32(SubI32, vm_sub_i32);
     DISPATCH_OP_CORE_BINARY_I32(MulI32, vm_mul_i32);
     DISPATCH_OP_CORE_BINARY_I32(DivI32S, vm_div_i32s);
@@ -1628,6 +1722,11 @@ static iree_status_t iree_vm_bytecode_dispatch(
       }
     });
 
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CmpBranchEQI32, vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CmpBranchNEI32, vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32S, vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32U, vm_cmp_lt_i32u);
+
     DISPATCH_OP(CORE, BranchTable, {
       int32_t index = VM_DecOperandRegI32("index");
       int32_t default_block_pc = VM_DecBranchTarget("default_dest");
@@ -1670,7 +1769,24 @@ static iree_status_t iree_vm_bytecode_dispatch(
       // NOTE: we assume validation has ensured these functions exist.
       // TODO(benvanik): something more clever than just a high bit?
       int is_import = (function_ordinal & 0x80000000u) != 0;
-      if (is_import) {
+      const iree_vm_bytecode_import_t* direct_import =
+          is_import ? iree_vm_bytecode_lookup_direct_import(module_state,
+                                                            function_ordinal)
+                    : NULL;
+      if (direct_import) {
+        // Switch execution to the function in the imported bytecode module and
+        // continue running in this dispatcher as with internal calls.
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_direct_enter(
+            stack, direct_import, src_reg_list, dst_reg_list, &current_frame,
+            &regs));
+        module = (iree_vm_bytecode_module_t*)direct_import->direct_module->self;
+        module_state =
+            (iree_vm_bytecode_module_state_t*)current_frame->module_state;
+        bytecode_data =
+            module->bytecode_data.data +
+            module->function_descriptor_table[direct_import->direct_ordinal]
+                .bytecode_offset;
+      } else if (is_import) {
         // Call import (and possible yield).
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
             stack, module_state, function_ordinal, regs, src_reg_list,
@@ -1736,10 +1852,19 @@ static iree_status_t iree_vm_bytecode_dispatch(
           VM_DecVariadicOperands("operands");
       current_frame->pc = pc;
 
+      // Frames entered by a direct call return to the caller module within
+      // this dispatch loop.
+      const bool is_direct_call =
+          (((iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+                current_frame))
+               ->flags &
+           IREE_VM_BYTECODE_FRAME_FLAG_DIRECT_CALL) != 0;
+
       // TODO(benvanik): faster check for escaping; this is slow (cache misses).
       iree_vm_stack_frame_t* parent_frame = iree_vm_stack_parent_frame(stack);
-      if (!parent_frame ||
-          parent_frame->module_state != current_frame->module_state) {
+      if (!is_direct_call &&
+          (!parent_frame ||
+           parent_frame->module_state != current_frame->module_state)) {
         // Return from the top-level entry frame - return back to call().
         return iree_vm_bytecode_external_leave(stack, current_frame, &regs,
                                                src_reg_list, call_results);
@@ -1748,6 +1873,12 @@ static iree_status_t iree_vm_bytecode_dispatch(
       // Store results into the caller frame and pop back to the parent.
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_leave(
           stack, current_frame, regs, src_reg_list, &current_frame, &regs));
+      if (is_direct_call) {
+        module =
+            (iree_vm_bytecode_module_t*)current_frame->function.module->self;
+        module_state =
+            (iree_vm_bytecode_module_state_t*)current_frame->module_state;
+      }
 
       // Reset dispatch state so we can continue executing in the caller.
       bytecode_data =
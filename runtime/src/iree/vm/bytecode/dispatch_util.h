@@ -67,6 +67,13 @@ typedef struct iree_vm_registers_t {
   iree_vm_ref_t* ref;
 } iree_vm_registers_t;
 
+enum iree_vm_bytecode_frame_flag_bits_t {
+  // Frame was entered by a direct call from a frame in another bytecode module
+  // and returns to it within the same dispatch loop like an internal call.
+  IREE_VM_BYTECODE_FRAME_FLAG_DIRECT_CALL = 1u << 0,
+};
+typedef uint32_t iree_vm_bytecode_frame_flags_t;
+
 // Storage associated with each stack frame of a bytecode function.
 // NOTE: we cannot store pointers to the stack in here as the stack may be
 // reallocated.
@@ -78,6 +85,9 @@ typedef struct iree_vm_bytecode_frame_storage_t {
   // will be stored by callees upon return.
   const iree_vm_register_list_t* return_registers;
 
+  // Flags describing how the frame was entered.
+  iree_vm_bytecode_frame_flags_t flags;
+
   // Counts of each register type and their relative byte offsets from the head
   // of this struct.
   uint32_t i32_register_count;
@@ -398,6 +408,33 @@ static inline const iree_vm_register_list_t* VM_DecVariadicOperandsImpl(
     *result = op_func(a, b, c);                        \
   });
 
+// Fused compare-and-branch: equivalent to a vm.cmp.* feeding a vm.cond_br
+// without the round-trip through a condition register.
+#define DISPATCH_OP_CORE_CMP_BRANCH_I32(op_name, op_func)                      \
+  DISPATCH_OP(CORE, op_name, {                                                 \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                                  \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                                  \
+    int32_t true_block_pc = VM_DecBranchTarget("true_dest");                   \
+    const iree_vm_register_remap_list_t* true_remap_list =                     \
+        VM_DecBranchOperands("true_operands");                                 \
+    int32_t false_block_pc = VM_DecBranchTarget("false_dest");                 \
+    const iree_vm_register_remap_list_t* false_remap_list =                    \
+        VM_DecBranchOperands("false_operands");                                \
+    if (op_func(lhs, rhs)) {                                                   \
+      pc = true_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip block marker */  \
+      if (IREE_UNLIKELY(true_remap_list->size > 0)) {                          \
+        iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,   \
+                                                         true_remap_list);     \
+      }                                                                        \
+    } else {                                                                   \
+      pc = false_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip block marker */ \
+      if (IREE_UNLIKELY(false_remap_list->size > 0)) {                         \
+        iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,   \
+                                                         false_remap_list);    \
+      }                                                                        \
+    }                                                                          \
+  });
+
 #define DISPATCH_OP_EXT_F32_UNARY_F32(op_name, op_func) \
   DISPATCH_OP(EXT_F32, op_name, {                       \
     float operand = VM_DecOperandRegF32("operand");     \
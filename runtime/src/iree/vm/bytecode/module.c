@@ -685,6 +685,62 @@ static void iree_vm_bytecode_module_free_state(
   IREE_TRACE_ZONE_END(z0);
 }
 
+static iree_status_t iree_vm_bytecode_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t allocator, iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(parent_state);
+  IREE_ASSERT_ARGUMENT(out_module_state);
+  *out_module_state = NULL;
+
+  iree_vm_module_state_t* module_state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_alloc_state(self, allocator, &module_state));
+  iree_vm_bytecode_module_state_t* state =
+      (iree_vm_bytecode_module_state_t*)module_state;
+  iree_vm_bytecode_module_state_t* parent =
+      (iree_vm_bytecode_module_state_t*)parent_state;
+
+  // Primitive globals are copied so the fork can mutate them independently.
+  memcpy(state->rwdata_storage.data, parent->rwdata_storage.data,
+         state->rwdata_storage.data_length);
+
+  // Ref globals are shared with the parent. Initializers usually only store
+  // immutable resources (buffers, executables, etc) in globals; programs that
+  // mutate ref objects in place will observe the mutations across forks.
+  for (iree_host_size_t i = 0; i < state->global_ref_count; ++i) {
+    iree_vm_ref_retain(&parent->global_ref_table[i],
+                       &state->global_ref_table[i]);
+  }
+
+  // Imports are resolved by the context against the forked states.
+
+  *out_module_state = module_state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_bytecode_module_begin_call(
+    void* self, iree_vm_stack_t* stack, iree_vm_function_call_t call);
+
+// Returns true if all values in |cconv_fragment| are passed in single
+// registers as with internal calls.
+static bool iree_vm_bytecode_cconv_fragment_is_direct_callable(
+    iree_string_view_t cconv_fragment) {
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_VOID:
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+      case IREE_VM_CCONV_TYPE_REF:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
 static iree_status_t iree_vm_bytecode_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -727,6 +783,40 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Native imports with fixed signatures can be called directly from the
+  // caller registers using a shim specialized on the calling convention.
+  import->register_shim = NULL;
+  import->target = NULL;
+  import->target_module = NULL;
+  const iree_vm_native_function_ptr_t* function_ptr = NULL;
+  void* target_module = NULL;
+  if (!iree_vm_function_call_is_variadic_cconv(import->arguments) &&
+      iree_vm_native_module_try_resolve_function_ptr(function, &function_ptr,
+                                                     &target_module)) {
+    import->register_shim = iree_vm_shim_lookup_register_shim(
+        function_ptr->shim, import->arguments, import->results);
+    if (import->register_shim) {
+      import->target = (iree_vm_native_function_target2_t)function_ptr->target;
+      import->target_module = target_module;
+    }
+  }
+
+  // Imports from other bytecode modules can be entered directly from the
+  // caller dispatch loop without marshaling through the ABI buffers.
+  import->direct_module = NULL;
+  import->direct_ordinal = 0;
+  if (function->module->begin_call == iree_vm_bytecode_module_begin_call &&
+      function->linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT &&
+      iree_vm_bytecode_cconv_fragment_is_direct_callable(import->arguments) &&
+      iree_vm_bytecode_cconv_fragment_is_direct_callable(import->results)) {
+    uint16_t internal_ordinal = 0;
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_map_internal_ordinal(
+        (iree_vm_bytecode_module_t*)function->module->self, *function,
+        &internal_ordinal, NULL));
+    import->direct_module = function->module;
+    import->direct_ordinal = internal_ordinal;
+  }
+
   return iree_ok_status();
 }
 
@@ -788,10 +878,98 @@ static iree_status_t iree_vm_bytecode_module_resume_call(
   return iree_vm_bytecode_dispatch_resume(stack, module, call_results);  // tail
 }
 
+iree_status_t iree_vm_bytecode_module_verify_function_lazily(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal) {
+  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_vm_bytecode_function_verify");
+  // Multiple threads may race to verify the same function; verification has no
+  // side effects and the first to finish publishes the result.
+  iree_status_t status = iree_vm_bytecode_function_verify(
+      module, function_ordinal, module->allocator);
+  if (iree_status_is_ok(status)) {
+    iree_atomic_fetch_or_int32(
+        &module->verified_function_bits[function_ordinal / 32],
+        (int32_t)(1u << (function_ordinal % 32)), iree_memory_order_release);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Decodes run-length encoded rodata |source| (see RunLengthDataDef) into a
+// new allocation from |allocator| returned in |out_data|.
+static iree_status_t iree_vm_bytecode_module_decompress_run_length(
+    iree_vm_RunLengthDataDef_table_t rle_def, iree_const_byte_span_t source,
+    iree_allocator_t allocator, iree_byte_span_t* out_data) {
+  *out_data = iree_byte_span_empty();
+  const iree_host_size_t element_size =
+      iree_vm_RunLengthDataDef_element_size(rle_def);
+  const uint64_t decompressed_length =
+      iree_vm_RunLengthDataDef_decompressed_length(rle_def);
+  if (element_size != 1 && element_size != 2 && element_size != 4 &&
+      element_size != 8) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported run-length element size %" PRIhsz,
+                            element_size);
+  }
+  if (decompressed_length > IREE_HOST_SIZE_MAX ||
+      decompressed_length % element_size != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid run-length decompressed length %" PRIu64,
+                            decompressed_length);
+  }
+
+  uint8_t* data = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, (iree_host_size_t)decompressed_length, (void**)&data));
+  iree_host_size_t source_offset = 0;
+  iree_host_size_t target_offset = 0;
+  const iree_host_size_t target_length = (iree_host_size_t)decompressed_length;
+  while (source_offset < source.data_length) {
+    if (source.data_length - source_offset < sizeof(uint32_t)) break;
+    const uint32_t header = iree_unaligned_load_le_u32(
+        (const uint32_t*)(source.data + source_offset));
+    source_offset += sizeof(uint32_t);
+    const bool is_run = (header & 0x80000000u) != 0;
+    const iree_host_size_t count = header & 0x7FFFFFFFu;
+    const iree_host_size_t source_size = is_run ? element_size
+                                                : count * element_size;
+    if (count > (target_length - target_offset) / element_size ||
+        source_size > source.data_length - source_offset) {
+      break;
+    }
+    if (is_run) {
+      const uint8_t* element = source.data + source_offset;
+      for (iree_host_size_t i = 0; i < count; ++i) {
+        memcpy(data + target_offset + i * element_size, element, element_size);
+      }
+    } else {
+      memcpy(data + target_offset, source.data + source_offset, source_size);
+    }
+    source_offset += source_size;
+    target_offset += count * element_size;
+  }
+  if (source_offset != source.data_length || target_offset != target_length) {
+    iree_allocator_free(allocator, data);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed run-length encoded data");
+  }
+
+  *out_data = iree_make_byte_span(data, target_length);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_vm_instance_t* instance, iree_const_byte_span_t archive_contents,
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      instance, IREE_VM_BYTECODE_MODULE_FLAG_NONE, archive_contents,
+      archive_allocator, allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -832,13 +1010,36 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   size_t rodata_ref_table_size =
       iree_host_align(rodata_ref_count * sizeof(iree_vm_buffer_t), 16);
 
+  // Lazily verified modules track which functions have been verified.
+  bool verify_lazily = false;
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  verify_lazily =
+      iree_all_bits_set(flags,
+                        IREE_VM_BYTECODE_MODULE_FLAG_LAZY_VERIFICATION) &&
+      !iree_all_bits_set(flags, IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED);
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  iree_host_size_t function_count = iree_vm_FunctionDescriptor_vec_len(
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def));
+  size_t verified_function_bits_size =
+      verify_lazily ? iree_host_align(iree_host_align(function_count, 32) / 8,
+                                      16)
+                    : 0;
+
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(
-          allocator, sizeof(*module) + type_table_size + rodata_ref_table_size,
-          (void**)&module));
+      z0, iree_allocator_malloc(allocator,
+                                sizeof(*module) + type_table_size +
+                                    rodata_ref_table_size +
+                                    verified_function_bits_size,
+                                (void**)&module));
   module->allocator = allocator;
+  module->verified_function_bits = NULL;
+  if (verify_lazily) {
+    module->verified_function_bits =
+        (iree_atomic_int32_t*)((uint8_t*)module + sizeof(*module) +
+                               type_table_size + rodata_ref_table_size);
+    memset(module->verified_function_bits, 0, verified_function_bits_size);
+  }
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
       iree_vm_BytecodeModuleDef_function_descriptors(module_def);
@@ -885,13 +1086,17 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   module->interface.notify = iree_vm_bytecode_module_notify;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
   module->interface.resume_call = iree_vm_bytecode_module_resume_call;
+  module->interface.fork_state = iree_vm_bytecode_module_fork_state;
 
   // Setup rodata segments to point directly at the FlatBuffer memory.
+  // Compressed segments are decompressed into module-owned memory.
   module->rodata_ref_count = rodata_ref_count;
   module->rodata_ref_table =
       (iree_vm_buffer_t*)((uint8_t*)module + sizeof(*module) + type_table_size);
   iree_vm_RodataSegmentDef_vec_t rodata_segments =
       iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  iree_status_t rodata_status = iree_ok_status();
+  int initialized_rodata_count = 0;
   for (int i = 0; i < module->rodata_ref_count; ++i) {
     iree_vm_RodataSegmentDef_table_t segment =
         iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
@@ -911,15 +1116,48 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
           iree_vm_RodataSegmentDef_external_data_length(segment));
     }
     iree_vm_buffer_t* ref = &module->rodata_ref_table[i];
-    iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE, byte_span,
-                              iree_allocator_null(), ref);
+    if (iree_vm_RodataSegmentDef_compression_type_type(segment) ==
+        iree_vm_CompressionTypeDef_RunLengthDataDef) {
+      // Compressed segments are expanded once into memory owned by the
+      // buffer and released when the module is destroyed.
+      iree_byte_span_t decompressed_span = iree_byte_span_empty();
+      rodata_status = iree_vm_bytecode_module_decompress_run_length(
+          (iree_vm_RunLengthDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment),
+          iree_make_const_byte_span(byte_span.data, byte_span.data_length),
+          allocator, &decompressed_span);
+      if (!iree_status_is_ok(rodata_status)) {
+        rodata_status = iree_status_annotate_f(
+            rodata_status, "decompressing rodata[%d]", i);
+        break;
+      }
+      iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                                decompressed_span, allocator, ref);
+    } else {
+      iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                                byte_span, iree_allocator_null(), ref);
+    }
+    ++initialized_rodata_count;
+  }
+  if (!iree_status_is_ok(rodata_status)) {
+    for (int i = 0; i < initialized_rodata_count; ++i) {
+      iree_vm_buffer_deinitialize(&module->rodata_ref_table[i]);
+    }
+    iree_allocator_free(allocator, module);
+    IREE_TRACE_ZONE_END(z0);
+    return rodata_status;
   }
 
   // Verify functions in the module now that we've verified the metadata that we
   // need to do so.
+  // Modules that are trusted or verified lazily skip this.
   iree_status_t verify_status = iree_ok_status();
 #if IREE_VM_BYTECODE_VERIFICATION_ENABLE
-  for (uint16_t i = 0; i < module->function_descriptor_count; ++i) {
+  const bool verify_eagerly =
+      !verify_lazily &&
+      !iree_all_bits_set(flags, IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED);
+  for (uint16_t i = 0; verify_eagerly && i < module->function_descriptor_count;
+       ++i) {
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_function_verify");
     verify_status = iree_vm_bytecode_function_verify(module, i, allocator);
     IREE_TRACE_ZONE_END(z1);
@@ -929,6 +1167,9 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   if (iree_status_is_ok(verify_status)) {
     *out_module = &module->interface;
   } else {
+    for (int i = 0; i < module->rodata_ref_count; ++i) {
+      iree_vm_buffer_deinitialize(&module->rodata_ref_table[i]);
+    }
     iree_allocator_free(allocator, module);
   }
 
@@ -14,6 +14,24 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Controls bytecode module loading behavior.
+enum iree_vm_bytecode_module_flag_bits_t {
+  IREE_VM_BYTECODE_MODULE_FLAG_NONE = 0u,
+  // Defers verification of each function until it is first entered instead of
+  // verifying all functions when the module is created. Reduces load time for
+  // large modules that only execute a subset of their functions at the cost of
+  // reporting malformed functions when they are called.
+  IREE_VM_BYTECODE_MODULE_FLAG_LAZY_VERIFICATION = 1u << 0,
+  // Skips function verification entirely. Only the module metadata required
+  // to safely load the module is verified.
+  //
+  // WARNING: must only be used with known-good modules such as those that have
+  // been signed or otherwise authenticated. Malformed bytecode can perform
+  // arbitrary out-of-bounds memory accesses.
+  IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED = 1u << 1,
+};
+typedef uint32_t iree_vm_bytecode_module_flags_t;
+
 // Creates a VM module from an in-memory ModuleDef FlatBuffer archive.
 // If a |archive_allocator| is provided then it will be used to free the
 // |archive_contents| when the module is destroyed and otherwise the ownership
@@ -23,6 +41,14 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Creates a VM module from an in-memory ModuleDef FlatBuffer archive with
+// loading behavior controlled by |flags|.
+// See iree_vm_bytecode_module_create for more information.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
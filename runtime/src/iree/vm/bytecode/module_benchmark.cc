@@ -12,6 +12,7 @@
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
 #include "iree/vm/bytecode/module_benchmark_module_c.h"
+#include "iree/vm/bytecode/module_benchmark_unfused_module_c.h"
 
 namespace {
 
@@ -71,10 +72,13 @@ static iree_status_t native_import_module_create(
 }
 
 // Benchmarks the given exported function, optionally passing in arguments.
-static iree_status_t RunFunction(benchmark::State& state,
-                                 iree_string_view_t function_name,
-                                 std::vector<int32_t> i32_args,
-                                 int result_count, int64_t batch_size = 1) {
+// |module_file_toc| selects the module build; unless overridden the module is
+// compiled with superinstruction fusion enabled.
+static iree_status_t RunFunction(
+    benchmark::State& state, iree_string_view_t function_name,
+    std::vector<int32_t> i32_args, int result_count, int64_t batch_size = 1,
+    const iree_file_toc_t* module_file_toc =
+        iree_vm_bytecode_module_benchmark_module_create()) {
   iree_vm_instance_t* instance = NULL;
   IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
                                         iree_allocator_system(), &instance));
@@ -83,8 +87,6 @@ static iree_status_t RunFunction(benchmark::State& state,
   IREE_CHECK_OK(native_import_module_create(instance, iree_allocator_system(),
                                             &import_module));
 
-  const auto* module_file_toc =
-      iree_vm_bytecode_module_benchmark_module_create();
   iree_vm_module_t* bytecode_module = nullptr;
   IREE_CHECK_OK(iree_vm_bytecode_module_create(
       instance,
@@ -323,6 +325,18 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+// Same as BM_LoopSumBytecode but without superinstruction fusion; the delta
+// between the two is the speedup from compare-and-branch/add-immediate fusion.
+static void BM_LoopSumBytecodeUnfused(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.loop_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0),
+      iree_vm_bytecode_module_benchmark_unfused_module_create()));
+}
+BENCHMARK(BM_LoopSumBytecodeUnfused)->Arg(100000);
+
 static void BM_BufferReduceReference(benchmark::State& state) {
   static auto work = +[](int32_t* buffer, int i, int sum) {
     int new_sum = buffer[i] + sum;
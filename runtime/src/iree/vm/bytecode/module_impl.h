@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/utils/isa.h"
 
@@ -48,11 +49,37 @@ typedef struct iree_vm_bytecode_module_t {
   iree_host_size_t rodata_ref_count;
   iree_vm_buffer_t* rodata_ref_table;
 
+  // Bitmap with one bit per function set once the function has been verified.
+  // Only present when the module was created with
+  // IREE_VM_BYTECODE_MODULE_FLAG_LAZY_VERIFICATION.
+  iree_atomic_int32_t* verified_function_bits;
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t type_table[];
 } iree_vm_bytecode_module_t;
 
+// Verifies the function with the given |function_ordinal| if it has not yet
+// been verified. Safe to call concurrently from multiple threads.
+iree_status_t iree_vm_bytecode_module_verify_function_lazily(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal);
+
+// Ensures the function with the given |function_ordinal| has been verified
+// before it is executed. A no-op unless lazy verification is enabled.
+static inline iree_status_t iree_vm_bytecode_module_ensure_function_verified(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal) {
+  if (IREE_LIKELY(!module->verified_function_bits)) return iree_ok_status();
+  int32_t mask = (int32_t)(1u << (function_ordinal % 32));
+  if (IREE_LIKELY(iree_atomic_load_int32(
+                      &module->verified_function_bits[function_ordinal / 32],
+                      iree_memory_order_acquire) &
+                  mask)) {
+    return iree_ok_status();
+  }
+  return iree_vm_bytecode_module_verify_function_lazily(module,
+                                                        function_ordinal);
+}
+
 // A resolved and split import in the module state table.
 //
 // NOTE: a table of these are stored per module per context so ideally we'd
@@ -73,6 +100,22 @@ typedef struct iree_vm_bytecode_import_t {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Optional register shim used to call native imports with fixed signatures
+  // directly from the caller registers, bypassing begin_call and the argument
+  // and result buffers. When set |target| and |target_module| are the native
+  // function target and the module pointer it expects.
+  iree_vm_native_function_register_shim_t register_shim;
+  iree_vm_native_function_target2_t target;
+  void* target_module;
+
+  // Optional bytecode module and internal function ordinal used to call
+  // imports exported by other bytecode modules directly from the dispatch
+  // loop as if they were internal functions, bypassing begin_call. Only set
+  // when the signature contains no 64-bit values as those are passed through
+  // register pairs that internal calls do not marshal.
+  iree_vm_module_t* direct_module;
+  uint16_t direct_ordinal;
 } iree_vm_bytecode_import_t;
 
 // Per-instance module state.
@@ -107,15 +107,17 @@ using iree::testing::status::StatusIs;
 using iree::vm::ref;
 using testing::Eq;
 
-class VMBytecodeModuleTest : public ::testing::Test {
+// Parameterized on the module flags so that each loading mode is covered.
+class VMBytecodeModuleTest
+    : public ::testing::TestWithParam<iree_vm_bytecode_module_flags_t> {
  protected:
   virtual void SetUp() {
     IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
                                           iree_allocator_system(), &instance_));
 
     const auto* module_file_toc = iree_vm_bytecode_module_test_module_create();
-    IREE_CHECK_OK(iree_vm_bytecode_module_create(
-        instance_,
+    IREE_CHECK_OK(iree_vm_bytecode_module_create_with_flags(
+        instance_, GetParam(),
         iree_const_byte_span_t{
             reinterpret_cast<const uint8_t*>(module_file_toc->data),
             static_cast<iree_host_size_t>(module_file_toc->size)},
@@ -208,24 +210,30 @@ class VMBytecodeModuleTest : public ::testing::Test {
   iree_vm_module_t* bytecode_module_ = nullptr;
 };
 
-TEST_F(VMBytecodeModuleTest, FuncIOEmpty) {
+TEST_P(VMBytecodeModuleTest, FuncIOEmpty) {
   EXPECT_THAT(RunFunction("FuncIOEmpty", std::vector<iree_vm_value_t>()),
               IsOkAndHolds(Eq(std::vector<iree_vm_value_t>())));
 }
 
-TEST_F(VMBytecodeModuleTest, FuncIO1) {
+TEST_P(VMBytecodeModuleTest, FuncIO1) {
   EXPECT_THAT(RunFunction("FuncIO1", MakeValuesList({1})),
               IsOkAndHolds(Eq(MakeValuesList({1}))));
 }
 
-TEST_F(VMBytecodeModuleTest, FuncIO8) {
+TEST_P(VMBytecodeModuleTest, FuncIO8) {
   EXPECT_THAT(RunFunction("FuncIO8", MakeValueRangeList(0, 7)),
               IsOkAndHolds(Eq(MakeValueRangeList(7, 0))));
 }
 
-TEST_F(VMBytecodeModuleTest, FuncIO600) {
+TEST_P(VMBytecodeModuleTest, FuncIO600) {
   EXPECT_THAT(RunFunction("FuncIO600", MakeNullRefList(600)),
               IsOkAndHolds(Eq(MakeNullRefList(600))));
 }
 
+INSTANTIATE_TEST_SUITE_P(
+    ModuleFlags, VMBytecodeModuleTest,
+    ::testing::Values(IREE_VM_BYTECODE_MODULE_FLAG_NONE,
+                      IREE_VM_BYTECODE_MODULE_FLAG_LAZY_VERIFICATION,
+                      IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED));
+
 }  // namespace
@@ -139,11 +139,11 @@ typedef enum {
   IREE_VM_OP_CORE_MaxI64U = 0x81,
   IREE_VM_OP_CORE_CastAnyRef = 0x82,
   IREE_VM_OP_CORE_BranchTable = 0x83,
-  IREE_VM_OP_CORE_RSV_0x84,
-  IREE_VM_OP_CORE_RSV_0x85,
-  IREE_VM_OP_CORE_RSV_0x86,
-  IREE_VM_OP_CORE_RSV_0x87,
-  IREE_VM_OP_CORE_RSV_0x88,
+  IREE_VM_OP_CORE_AddImmI32 = 0x84,
+  IREE_VM_OP_CORE_CmpBranchEQI32 = 0x85,
+  IREE_VM_OP_CORE_CmpBranchNEI32 = 0x86,
+  IREE_VM_OP_CORE_CmpBranchLTI32S = 0x87,
+  IREE_VM_OP_CORE_CmpBranchLTI32U = 0x88,
   IREE_VM_OP_CORE_RSV_0x89,
   IREE_VM_OP_CORE_RSV_0x8A,
   IREE_VM_OP_CORE_RSV_0x8B,
@@ -398,11 +398,11 @@ typedef enum {
     OPC(0x81, MaxI64U) \
     OPC(0x82, CastAnyRef) \
     OPC(0x83, BranchTable) \
-    RSV(0x84) \
-    RSV(0x85) \
-    RSV(0x86) \
-    RSV(0x87) \
-    RSV(0x88) \
+    OPC(0x84, AddImmI32) \
+    OPC(0x85, CmpBranchEQI32) \
+    OPC(0x86, CmpBranchNEI32) \
+    OPC(0x87, CmpBranchLTI32S) \
+    OPC(0x88, CmpBranchLTI32U) \
     RSV(0x89) \
     RSV(0x8A) \
     RSV(0x8B) \
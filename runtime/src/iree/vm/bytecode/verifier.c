@@ -65,6 +65,17 @@ iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
        ++i) {
     iree_vm_RodataSegmentDef_table_t segment =
         iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    switch (iree_vm_RodataSegmentDef_compression_type_type(segment)) {
+      case iree_vm_CompressionTypeDef_NONE:
+      case iree_vm_CompressionTypeDef_UncompressedDataDef:
+      case iree_vm_CompressionTypeDef_RunLengthDataDef:
+        break;
+      default:
+        return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "rodata[%zu] uses an unsupported compression "
+                                "type",
+                                i);
+    }
     if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
       continue;  // embedded data is verified by FlatBuffers
     }
@@ -729,6 +740,17 @@ iree_status_t iree_vm_bytecode_function_verify(
     VM_VerifyResultRegI32(result);         \
   });
 
+#define VERIFY_OP_CORE_CMP_BRANCH_I32(op_name)   \
+  VERIFY_OP(CORE, op_name, {                     \
+    VM_VerifyOperandRegI32(lhs);                 \
+    VM_VerifyOperandRegI32(rhs);                 \
+    VM_VerifyBranchTarget(true_dest_pc);         \
+    VM_VerifyBranchOperands(true_operands);      \
+    VM_VerifyBranchTarget(false_dest_pc);        \
+    VM_VerifyBranchOperands(false_operands);     \
+    verify_state->in_block = 0; /* terminator */ \
+  });
+
 #define VERIFY_OP_CORE_BINARY_I64(op_name) \
   VERIFY_OP(CORE, op_name, {               \
     VM_VerifyOperandRegI64(lhs);           \
@@ -1388,6 +1410,11 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
     //===------------------------------------------------------------------===//
 
     VERIFY_OP_CORE_BINARY_I32(AddI32);
+    VERIFY_OP(CORE, AddImmI32, {
+      VM_VerifyOperandRegI32(lhs);
+      VM_VerifyIntAttr32(imm);
+      VM_VerifyResultRegI32(result);
+    });
     VERIFY_OP_CORE_BINARY_I32(SubI32);
     VERIFY_OP_CORE_BINARY_I32(MulI32);
     VERIFY_OP_CORE_BINARY_I32(DivI32S);
@@ -1553,6 +1580,11 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
       verify_state->in_block = 0;  // terminator
     });
 
+    VERIFY_OP_CORE_CMP_BRANCH_I32(CmpBranchEQI32);
+    VERIFY_OP_CORE_CMP_BRANCH_I32(CmpBranchNEI32);
+    VERIFY_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32S);
+    VERIFY_OP_CORE_CMP_BRANCH_I32(CmpBranchLTI32U);
+
     VERIFY_OP(CORE, BranchTable, {
       VM_VerifyOperandRegI32(index);
       VM_VerifyBranchTarget(default_dest_pc);
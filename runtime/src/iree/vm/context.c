@@ -348,6 +348,96 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    const iree_vm_context_t* parent_context, iree_allocator_t allocator,
+    iree_vm_context_t** out_context) {
+  IREE_ASSERT_ARGUMENT(parent_context);
+  IREE_ASSERT_ARGUMENT(out_context);
+  *out_context = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Reject the fork before allocating anything if any module can't be forked.
+  const iree_host_size_t module_count = parent_context->list.count;
+  for (iree_host_size_t i = 0; i < module_count; ++i) {
+    iree_vm_module_t* module = parent_context->list.modules[i];
+    if (!module->fork_state) {
+      iree_string_view_t module_name = iree_vm_module_name(module);
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "module '%.*s' does not support forking state",
+                              (int)module_name.size, module_name.data);
+    }
+  }
+
+  // Forked contexts have a static module list like those created with
+  // iree_vm_context_create_with_modules.
+  iree_host_size_t context_size =
+      sizeof(iree_vm_context_t) + sizeof(iree_vm_module_t*) * module_count +
+      sizeof(iree_vm_module_state_t*) * module_count;
+  iree_vm_context_t* context = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, context_size, (void**)&context));
+  iree_atomic_ref_count_init(&context->ref_count);
+  context->instance = parent_context->instance;
+  iree_vm_instance_retain(context->instance);
+  context->allocator = allocator;
+  context->context_id = iree_vm_context_allocate_id();
+  context->is_frozen = module_count > 0;
+  context->is_static = module_count > 0;
+  context->flags = parent_context->flags;
+
+  uint8_t* p = (uint8_t*)context + sizeof(iree_vm_context_t);
+  context->list.modules = (iree_vm_module_t**)p;
+  p += sizeof(iree_vm_module_t*) * module_count;
+  context->list.module_states = (iree_vm_module_state_t**)p;
+  p += sizeof(iree_vm_module_state_t*) * module_count;
+  context->list.count = 0;
+  context->list.capacity = module_count;
+
+  // Fork module state in registration order so that imports resolve against
+  // the forked states of the modules registered before them. Initializers are
+  // not run as the parent state is already initialized.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < module_count; ++i) {
+    iree_vm_module_t* module = parent_context->list.modules[i];
+    context->list.modules[i] = module;
+    context->list.module_states[i] = NULL;
+    iree_vm_module_retain(module);
+
+    iree_vm_module_state_t* module_state = NULL;
+    status = module->fork_state(module->self,
+                                parent_context->list.module_states[i],
+                                allocator, &module_state);
+    if (!iree_status_is_ok(status)) {
+      // Include the partially forked module in the cleanup below.
+      context->list.count = i + 1;
+      break;
+    }
+    context->list.module_states[i] = module_state;
+
+    status =
+        iree_vm_context_resolve_module_imports(context, module, module_state);
+    if (!iree_status_is_ok(status)) {
+      iree_string_view_t module_name = iree_vm_module_name(module);
+      (void)module_name;
+      status = iree_status_annotate_f(status, "resolving module '%.*s' imports",
+                                      (int)module_name.size, module_name.data);
+      context->list.count = i + 1;
+      break;
+    }
+
+    ++context->list.count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_context = context;
+  } else {
+    iree_vm_context_destroy(context);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_vm_context_destroy(iree_vm_context_t* context) {
   if (!context) return;
 
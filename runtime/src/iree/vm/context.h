@@ -69,6 +69,21 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
     iree_host_size_t module_count, iree_vm_module_t** modules,
     iree_allocator_t allocator, iree_vm_context_t** out_context);
 
+// Creates a new context with the same modules and flags as |parent_context|
+// whose module state is forked from the fully initialized parent state.
+// Module initializers are not run again and immutable resources created by
+// them (such as constants and executables) are shared with the parent. This
+// allows a context to be initialized once and then cheaply stamped out for
+// each tenant/session that needs isolated mutable state.
+//
+// The parent context must not be executing while it is being forked. All
+// modules registered in the parent must implement `fork_state` or
+// IREE_STATUS_UNIMPLEMENTED is returned.
+// |out_context| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    const iree_vm_context_t* parent_context, iree_allocator_t allocator,
+    iree_vm_context_t** out_context);
+
 // Retains the given |context| for the caller.
 IREE_API_EXPORT void iree_vm_context_retain(iree_vm_context_t* context);
 
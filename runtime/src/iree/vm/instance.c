@@ -45,7 +45,9 @@ struct iree_vm_instance_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
 
-  iree_slim_mutex_t type_mutex;
+  // Held shared by type lookups (common during module loading) and exclusively
+  // when registering or unregistering types.
+  iree_slim_rwlock_t type_lock;
   uint16_t type_capacity;
   uint16_t type_count;
   iree_vm_registered_type_t types[];
@@ -65,7 +67,7 @@ IREE_API_EXPORT iree_status_t iree_vm_instance_create(
       z0, iree_allocator_malloc(allocator, total_size, (void**)&instance));
   instance->allocator = allocator;
   iree_atomic_ref_count_init(&instance->ref_count);
-  iree_slim_mutex_initialize(&instance->type_mutex);
+  iree_slim_rwlock_initialize(&instance->type_lock);
   instance->type_capacity = type_capacity;
 
   iree_status_t status = iree_vm_register_builtin_types(instance);
@@ -82,7 +84,7 @@ IREE_API_EXPORT iree_status_t iree_vm_instance_create(
 static void iree_vm_instance_destroy(iree_vm_instance_t* instance) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(instance);
-  iree_slim_mutex_deinitialize(&instance->type_mutex);
+  iree_slim_rwlock_deinitialize(&instance->type_lock);
   iree_allocator_free(instance->allocator, instance);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -126,7 +128,7 @@ iree_vm_instance_register_type(iree_vm_instance_t* instance,
                             "words of their structures");
   }
 
-  iree_slim_mutex_lock(&instance->type_mutex);
+  iree_slim_rwlock_lock(&instance->type_lock);
 
   // Scan to see if there are any existing types registered with this
   // descriptor.
@@ -136,7 +138,7 @@ iree_vm_instance_register_type(iree_vm_instance_t* instance,
       // Already registered - increment count so that we have a balanced
       // register/unregister set.
       ++type->registration_count;
-      iree_slim_mutex_unlock(&instance->type_mutex);
+      iree_slim_rwlock_unlock(&instance->type_lock);
       *out_registration = (iree_vm_ref_type_t)descriptor |
                           (iree_vm_ref_type_t)descriptor->offsetof_counter;
       return iree_ok_status();
@@ -145,7 +147,7 @@ iree_vm_instance_register_type(iree_vm_instance_t* instance,
 
   // Ensure there's capacity.
   if (instance->type_count + 1 > instance->type_capacity) {
-    iree_slim_mutex_unlock(&instance->type_mutex);
+    iree_slim_rwlock_unlock(&instance->type_lock);
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
                             "too many user-defined types registered; new type "
                             "%.*s would exceed capacity of %d",
@@ -160,7 +162,7 @@ iree_vm_instance_register_type(iree_vm_instance_t* instance,
       .registration_count = 1,
   };
 
-  iree_slim_mutex_unlock(&instance->type_mutex);
+  iree_slim_rwlock_unlock(&instance->type_lock);
 
   *out_registration = (iree_vm_ref_type_t)descriptor |
                       (iree_vm_ref_type_t)descriptor->offsetof_counter;
@@ -170,7 +172,7 @@ iree_vm_instance_register_type(iree_vm_instance_t* instance,
 IREE_API_EXPORT void iree_vm_instance_unregister_type(
     iree_vm_instance_t* instance,
     const iree_vm_ref_type_descriptor_t* descriptor) {
-  iree_slim_mutex_lock(&instance->type_mutex);
+  iree_slim_rwlock_lock(&instance->type_lock);
   for (iree_host_size_t i = 0; i < instance->type_count; ++i) {
     // NOTE: descriptor pointers must be stable so we can just compare that
     // instead of each field.
@@ -179,7 +181,7 @@ IREE_API_EXPORT void iree_vm_instance_unregister_type(
       if (--type->registration_count == 0) {
         // Last registration reference, remove from the list.
         memmove(&instance->types[i], &instance->types[i + 1],
-                instance->type_count - i - 1);
+                (instance->type_count - i - 1) * sizeof(instance->types[0]));
         instance->types[--instance->type_count] = (iree_vm_registered_type_t){
             .descriptor = NULL,
             .registration_count = 0,
@@ -188,7 +190,7 @@ IREE_API_EXPORT void iree_vm_instance_unregister_type(
       break;
     }
   }
-  iree_slim_mutex_unlock(&instance->type_mutex);
+  iree_slim_rwlock_unlock(&instance->type_lock);
 }
 
 // NOTE: this does a linear scan over the type descriptors even though they are
@@ -197,7 +199,7 @@ IREE_API_EXPORT void iree_vm_instance_unregister_type(
 IREE_API_EXPORT iree_vm_ref_type_t iree_vm_instance_lookup_type(
     iree_vm_instance_t* instance, iree_string_view_t full_name) {
   const iree_vm_ref_type_descriptor_t* descriptor = NULL;
-  iree_slim_mutex_lock(&instance->type_mutex);
+  iree_slim_rwlock_lock_shared(&instance->type_lock);
   for (iree_host_size_t i = 0; i < instance->type_count; ++i) {
     const iree_vm_registered_type_t* type = &instance->types[i];
     if (iree_string_view_equal(type->descriptor->type_name, full_name)) {
@@ -205,7 +207,7 @@ IREE_API_EXPORT iree_vm_ref_type_t iree_vm_instance_lookup_type(
       break;
     }
   }
-  iree_slim_mutex_unlock(&instance->type_mutex);
+  iree_slim_rwlock_unlock_shared(&instance->type_lock);
   if (!descriptor) return 0;
   return (iree_vm_ref_type_t)descriptor |
          (iree_vm_ref_type_t)descriptor->offsetof_counter;
@@ -60,6 +60,9 @@ struct iree_vm_list_t {
   // For certain storage modes, such as IREE_VM_STORAGE_MODE_REF, special
   // lifetime management and cleanup logic is required.
   void* storage;
+  // Storage embedded in the memory the list was initialized in, if any.
+  // |storage| is only owned by |allocator| when it differs from this.
+  void* inline_storage;
 };
 
 IREE_VM_DEFINE_TYPE_ADAPTERS(iree_vm_list, iree_vm_list_t);
@@ -141,6 +144,15 @@ IREE_API_EXPORT iree_host_size_t iree_vm_list_storage_size(
 IREE_API_EXPORT iree_status_t iree_vm_list_initialize(
     iree_byte_span_t storage, const iree_vm_type_def_t* element_type,
     iree_host_size_t capacity, iree_vm_list_t** out_list) {
+  return iree_vm_list_initialize_growable(storage, element_type, capacity,
+                                          iree_allocator_null(), out_list);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_initialize_growable(
+    iree_byte_span_t storage, const iree_vm_type_def_t* element_type,
+    iree_host_size_t inline_capacity, iree_allocator_t allocator,
+    iree_vm_list_t** out_list) {
+  IREE_ASSERT_ARGUMENT(out_list);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_vm_list_storage_mode_t storage_mode = IREE_VM_LIST_STORAGE_MODE_VARIANT;
@@ -160,8 +172,9 @@ IREE_API_EXPORT iree_status_t iree_vm_list_initialize(
 
   iree_host_size_t storage_offset = iree_host_align(sizeof(iree_vm_list_t), 8);
   iree_host_size_t required_storage_size =
-      storage_offset + iree_host_align(capacity * element_size, 8);
+      storage_offset + iree_host_align(inline_capacity * element_size, 8);
   if (storage.data_length < required_storage_size) {
+    IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
                             "storage buffer underflow: provided=%" PRIhsz
                             " < required=%" PRIhsz,
@@ -171,13 +184,15 @@ IREE_API_EXPORT iree_status_t iree_vm_list_initialize(
 
   iree_vm_list_t* list = (iree_vm_list_t*)storage.data;
   iree_atomic_ref_count_init(&list->ref_object.counter);
+  list->allocator = allocator;
   if (element_type) {
     list->element_type = *element_type;
   }
   list->element_size = element_size;
   list->storage_mode = storage_mode;
-  list->capacity = capacity;
+  list->capacity = inline_capacity;
   list->storage = storage.data + storage_offset;
+  list->inline_storage = list->storage;
 
   *out_list = list;
   IREE_TRACE_ZONE_END(z0);
@@ -191,6 +206,11 @@ IREE_API_EXPORT void iree_vm_list_deinitialize(iree_vm_list_t* list) {
   iree_atomic_ref_count_abort_if_uses(&list->ref_object.counter);
   iree_vm_list_reset_range(list, 0, list->count);
   list->count = 0;
+  if (list->storage != list->inline_storage) {
+    iree_allocator_free(list->allocator, list->storage);
+    list->storage = list->inline_storage;
+    list->capacity = 0;
+  }
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -236,7 +256,9 @@ static void iree_vm_list_destroy(void* ptr) {
 
   iree_vm_list_t* list = (iree_vm_list_t*)ptr;
   iree_vm_list_reset_range(list, 0, list->count);
-  iree_allocator_free(list->allocator, list->storage);
+  if (list->storage != list->inline_storage) {
+    iree_allocator_free(list->allocator, list->storage);
+  }
   iree_allocator_free(list->allocator, list);
 
   IREE_TRACE_ZONE_END(z0);
@@ -293,8 +315,20 @@ iree_vm_list_reserve(iree_vm_list_t* list, iree_host_size_t minimum_capacity) {
   }
   iree_host_size_t old_capacity = list->capacity;
   iree_host_size_t new_capacity = iree_host_align(minimum_capacity, 64);
-  IREE_RETURN_IF_ERROR(iree_allocator_realloc(
-      list->allocator, new_capacity * list->element_size, &list->storage));
+  if (list->storage != list->inline_storage) {
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        list->allocator, new_capacity * list->element_size, &list->storage));
+  } else {
+    // Spill the inline storage to the heap. Elements are moved as-is so that
+    // their references transfer to the new storage.
+    void* new_storage = NULL;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        list->allocator, new_capacity * list->element_size, &new_storage));
+    if (old_capacity > 0) {
+      memcpy(new_storage, list->storage, old_capacity * list->element_size);
+    }
+    list->storage = new_storage;
+  }
   memset((void*)((uintptr_t)list->storage + old_capacity * list->element_size),
          0, (new_capacity - old_capacity) * list->element_size);
   list->capacity = new_capacity;
@@ -358,6 +392,8 @@ IREE_API_EXPORT void iree_vm_list_swap_storage(iree_vm_list_t* list_a,
   iree_memswap(&list_a->storage_mode, &list_b->storage_mode,
                sizeof(list_a->storage_mode));
   iree_memswap(&list_a->storage, &list_b->storage, sizeof(list_a->storage));
+  iree_memswap(&list_a->inline_storage, &list_b->inline_storage,
+               sizeof(list_a->inline_storage));
 }
 
 // Copies from a |src_list| of any type (value, ref, variant) into a |dst_list|
@@ -51,8 +51,33 @@ IREE_API_EXPORT iree_status_t iree_vm_list_initialize(
     iree_byte_span_t storage, const iree_vm_type_def_t* element_type,
     iree_host_size_t capacity, iree_vm_list_t** out_list);
 
+// Initializes a statically-allocated list in the |storage| memory with room
+// for |inline_capacity| elements that can grow beyond it. The list starts out
+// using the inline storage and only when it grows past |inline_capacity| are
+// its contents moved to storage allocated from |allocator|. Use
+// iree_vm_list_storage_size to query the required |storage| capacity.
+//
+// This allows call argument and result lists with a small number of elements
+// to be built without any heap allocations:
+//  iree_host_size_t storage_size = iree_vm_list_storage_size(NULL, 8);
+//  iree_vm_list_t* inputs = NULL;
+//  IREE_RETURN_IF_ERROR(iree_vm_list_initialize_growable(
+//      iree_make_byte_span(iree_alloca(storage_size), storage_size),
+//      /*element_type=*/NULL, /*inline_capacity=*/8, host_allocator,
+//      &inputs));
+//  ...
+//  iree_vm_list_deinitialize(inputs);
+//
+// The same lifetime rules as iree_vm_list_initialize apply.
+IREE_API_EXPORT iree_status_t iree_vm_list_initialize_growable(
+    iree_byte_span_t storage, const iree_vm_type_def_t* element_type,
+    iree_host_size_t inline_capacity, iree_allocator_t allocator,
+    iree_vm_list_t** out_list);
+
 // Deinitializes a statically-allocated |list| previously initialized with
 // iree_vm_list_initialize. Aborts if there are still references remaining.
+// Any storage allocated when the list grew beyond its inline capacity is
+// freed.
 IREE_API_EXPORT void iree_vm_list_deinitialize(iree_vm_list_t* list);
 
 // Creates a growable list containing the given |element_type|, which may either
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/testing/gtest.h"
@@ -497,6 +498,63 @@ TEST_F(VMListTest, Reserve) {
   iree_vm_list_release(list);
 }
 
+// Tests that statically-allocated lists without an allocator cannot grow.
+TEST_F(VMListTest, InitializeFixedCapacity) {
+  iree_vm_type_def_t element_type = iree_vm_make_ref_type_def(test_a_type());
+  iree_host_size_t capacity = 2;
+  iree_host_size_t storage_size =
+      iree_vm_list_storage_size(&element_type, capacity);
+  std::vector<uint8_t> storage(storage_size);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_initialize(
+      iree_make_byte_span(storage.data(), storage.size()), &element_type,
+      capacity, &list));
+  EXPECT_EQ(capacity, iree_vm_list_capacity(list));
+
+  for (iree_host_size_t i = 0; i < capacity; ++i) {
+    iree_vm_ref_t ref_a = MakeRef<A>((float)i);
+    IREE_ASSERT_OK(iree_vm_list_push_ref_move(list, &ref_a));
+  }
+  EXPECT_THAT(Status(iree_vm_list_reserve(list, capacity + 1)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(capacity, iree_vm_list_size(list));
+
+  iree_vm_list_deinitialize(list);
+}
+
+// Tests that growable statically-allocated lists spill their inline storage to
+// the heap when they grow and keep their contents.
+TEST_F(VMListTest, InitializeGrowable) {
+  iree_vm_type_def_t element_type = iree_vm_make_ref_type_def(test_a_type());
+  iree_host_size_t inline_capacity = 2;
+  iree_host_size_t storage_size =
+      iree_vm_list_storage_size(&element_type, inline_capacity);
+  std::vector<uint8_t> storage(storage_size);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_initialize_growable(
+      iree_make_byte_span(storage.data(), storage.size()), &element_type,
+      inline_capacity, iree_allocator_system(), &list));
+  EXPECT_EQ(inline_capacity, iree_vm_list_capacity(list));
+
+  for (iree_host_size_t i = 0; i < 5; ++i) {
+    iree_vm_ref_t ref_a = MakeRef<A>((float)i);
+    IREE_ASSERT_OK(iree_vm_list_push_ref_move(list, &ref_a));
+  }
+  EXPECT_LE(5, iree_vm_list_capacity(list));
+  EXPECT_EQ(5, iree_vm_list_size(list));
+
+  for (iree_host_size_t i = 0; i < 5; ++i) {
+    iree_vm_ref_t ref_a{0};
+    IREE_ASSERT_OK(iree_vm_list_get_ref_retain(list, i, &ref_a));
+    EXPECT_TRUE(test_a_isa(ref_a));
+    auto* a = test_a_deref(ref_a);
+    EXPECT_EQ(i, a->data());
+    iree_vm_ref_release(&ref_a);
+  }
+
+  iree_vm_list_deinitialize(list);
+}
+
 // Tests the behavior of resize for truncation and extension on primitives.
 TEST_F(VMListTest, ResizeI32) {
   iree_vm_type_def_t element_type =
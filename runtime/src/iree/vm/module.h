@@ -451,6 +451,16 @@ typedef struct iree_vm_module_t {
   // without first completing prior ones.
   iree_status_t(IREE_API_PTR* resume_call)(void* self, iree_vm_stack_t* stack,
                                            iree_byte_span_t call_results);
+
+  // Allocates module state data initialized from the fully initialized
+  // |parent_state| of another context. Immutable resources (constants,
+  // executables, caches) should be shared with the parent by reference instead
+  // of being recreated. Imports are resolved on the new state after forking and
+  // module initializers are not run again.
+  // Optional: modules that do not implement this cannot be forked.
+  iree_status_t(IREE_API_PTR* fork_state)(
+      void* self, iree_vm_module_state_t* parent_state,
+      iree_allocator_t allocator, iree_vm_module_state_t** out_module_state);
 } iree_vm_module_t;
 
 // Initializes the interface of a module handle.
@@ -304,6 +304,26 @@ static void IREE_API_PTR iree_vm_native_module_free_state(
   IREE_ASSERT_EQ(module_state, NULL);
 }
 
+static iree_status_t IREE_API_PTR iree_vm_native_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t allocator, iree_vm_module_state_t** out_module_state) {
+  iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
+  *out_module_state = NULL;
+  if (module->user_interface.fork_state) {
+    return module->user_interface.fork_state(module->self, parent_state,
+                                             allocator, out_module_state);
+  } else if (module->user_interface.alloc_state) {
+    // Modules with state must opt in to forking as we can't know what in their
+    // state is safe to share.
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "module '%.*s' does not support forking state",
+                            (int)module->descriptor->name.size,
+                            module->descriptor->name.data);
+  }
+  // Default to no state.
+  return iree_ok_status();
+}
+
 static iree_status_t IREE_API_PTR iree_vm_native_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -415,6 +435,26 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_resume_call(
       iree_byte_span_empty(), call_results);  // tail
 }
 
+IREE_API_EXPORT bool iree_vm_native_module_try_resolve_function_ptr(
+    const iree_vm_function_t* function,
+    const iree_vm_native_function_ptr_t** out_function_ptr, void** out_self) {
+  *out_function_ptr = NULL;
+  *out_self = NULL;
+  if (!function->module ||
+      function->module->begin_call != iree_vm_native_module_begin_call) {
+    return false;
+  }
+  iree_vm_native_module_t* module = (iree_vm_native_module_t*)function->module;
+  if (module->user_interface.begin_call ||
+      function->linkage != IREE_VM_FUNCTION_LINKAGE_EXPORT ||
+      function->ordinal >= module->descriptor->export_count) {
+    return false;
+  }
+  *out_function_ptr = &module->descriptor->functions[function->ordinal];
+  *out_self = module->self;
+  return true;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_native_module_create(
     const iree_vm_module_t* module_interface,
     const iree_vm_native_module_descriptor_t* module_descriptor,
@@ -523,6 +563,7 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
   module->base_interface.notify = iree_vm_native_module_notify;
   module->base_interface.begin_call = iree_vm_native_module_begin_call;
   module->base_interface.resume_call = iree_vm_native_module_resume_call;
+  module->base_interface.fork_state = iree_vm_native_module_fork_state;
 
   return iree_ok_status();
 }
@@ -146,6 +146,18 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
     iree_vm_instance_t* instance, iree_allocator_t allocator,
     iree_vm_module_t* module);
 
+// Resolves |function| to its entry in the function pointer table of the native
+// module that owns it. Returns false if the module is not a native module or
+// overrides begin_call, as then the table entry need not be what is called.
+// |out_self| receives the module pointer passed to the target function.
+//
+// This allows callers to bypass begin_call and invoke the target directly
+// with a compatible shim. The call must still enter a native stack frame for
+// |function| so that the target receives its module state.
+IREE_API_EXPORT bool iree_vm_native_module_try_resolve_function_ptr(
+    const iree_vm_function_t* function,
+    const iree_vm_native_function_ptr_t** out_function_ptr, void** out_self);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -59,12 +59,17 @@ class VMNativeModuleTest : public ::testing::Test {
 
   StatusOr<int32_t> RunFunction(iree_string_view_t function_name,
                                 int32_t arg0) {
+    return RunFunction(context_, function_name, arg0);
+  }
+
+  StatusOr<int32_t> RunFunction(iree_vm_context_t* context,
+                                iree_string_view_t function_name,
+                                int32_t arg0) {
     // Lookup the entry function. This can be cached in an application if
     // multiple calls will be made.
     iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(
-        iree_vm_context_resolve_function(
-            context_, iree_make_cstring_view("module_b.entry"), &function),
+        iree_vm_context_resolve_function(context, function_name, &function),
         "unable to resolve entry point");
 
     // Setup I/O lists and pass in the argument. The result list will be
@@ -83,7 +88,7 @@ class VMNativeModuleTest : public ::testing::Test {
 
     // Invoke the entry function to do our work. Runs synchronously.
     IREE_RETURN_IF_ERROR(
-        iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+        iree_vm_invoke(context, function, IREE_VM_INVOCATION_FLAG_NONE,
                        /*policy=*/nullptr, input_list.get(), output_list.get(),
                        iree_allocator_system()));
 
@@ -94,7 +99,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -111,5 +116,36 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Forked contexts start from the parent state and then diverge.
+TEST_F(VMNativeModuleTest, ForkContext) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 1));
+  ASSERT_EQ(v0, 1);
+
+  iree_vm_context_t* fork = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_context_fork(context_, iree_allocator_system(), &fork));
+  EXPECT_EQ(iree_vm_context_module_count(fork),
+            iree_vm_context_module_count(context_));
+  EXPECT_NE(iree_vm_context_id(fork), iree_vm_context_id(context_));
+
+  // The fork sees the parent counter (2) and its own import resolutions.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v1,
+      RunFunction(fork, iree_make_cstring_view("module_b.entry"), 2));
+  EXPECT_EQ(v1, 4);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v2,
+      RunFunction(fork, iree_make_cstring_view("module_b.entry"), 3));
+  EXPECT_EQ(v2, 8);
+
+  // The parent state is unchanged by calls into the fork.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v3, RunFunction(iree_make_cstring_view("module_b.entry"), 2));
+  EXPECT_EQ(v3, 4);
+
+  iree_vm_context_release(fork);
+}
+
 }  // namespace
 }  // namespace iree
@@ -196,6 +196,18 @@ module_b_free_state(void* self, iree_vm_module_state_t* module_state) {
   iree_allocator_free(state->allocator, state);
 }
 
+// Allocates per-context state initialized from the state of another context.
+// Imports are resolved again by the new context so only user state is copied.
+static iree_status_t IREE_API_PTR
+module_b_fork_state(void* self, iree_vm_module_state_t* parent_state,
+                    iree_allocator_t allocator,
+                    iree_vm_module_state_t** out_module_state) {
+  IREE_RETURN_IF_ERROR(module_b_alloc_state(self, allocator, out_module_state));
+  module_b_state_t* state = (module_b_state_t*)*out_module_state;
+  state->counter = ((module_b_state_t*)parent_state)->counter;
+  return iree_ok_status();
+}
+
 // Called once per import function so the module can store the function ref.
 static iree_status_t IREE_API_PTR module_b_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
@@ -310,6 +322,7 @@ static iree_status_t module_b_create(iree_vm_instance_t* instance,
   interface.destroy = module_b_destroy;
   interface.alloc_state = module_b_alloc_state;
   interface.free_state = module_b_free_state;
+  interface.fork_state = module_b_fork_state;
   interface.resolve_import = module_b_resolve_import;
   return iree_vm_native_module_create(&interface, &module_b_descriptor_,
                                       instance, allocator, out_module);
@@ -233,6 +233,26 @@ static inline int32_t vm_select_i32(int32_t condition, int32_t true_value,
   return condition ? true_value : false_value;
 }
 
+// Retains or moves the selected value into |result| and releases the other
+// value if it was moved. Matches vm.select.ref in the bytecode interpreter.
+static inline iree_status_t vm_select_ref(
+    int32_t condition, iree_vm_ref_t* true_value, bool true_value_is_move,
+    iree_vm_ref_t* false_value, bool false_value_is_move,
+    iree_vm_ref_type_t type, iree_vm_ref_t* result) {
+  iree_vm_ref_t* selected_value = condition ? true_value : false_value;
+  bool selected_value_is_move =
+      condition ? true_value_is_move : false_value_is_move;
+  iree_vm_ref_t* other_value = condition ? false_value : true_value;
+  bool other_value_is_move =
+      condition ? false_value_is_move : true_value_is_move;
+  IREE_RETURN_IF_ERROR(iree_vm_ref_retain_or_move_checked(
+      selected_value_is_move, selected_value, type, result));
+  if (other_value_is_move && other_value != result) {
+    iree_vm_ref_release(other_value);
+  }
+  return iree_ok_status();
+}
+
 //===------------------------------------------------------------------===//
 // Native integer arithmetic
 //===------------------------------------------------------------------===//
@@ -76,3 +76,117 @@ IREE_VM_ABI_DEFINE_SHIM(irII, rr);
 IREE_VM_ABI_DEFINE_SHIM(v, i);
 IREE_VM_ABI_DEFINE_SHIM(v, r);
 IREE_VM_ABI_DEFINE_SHIM(v, v);
+
+//===----------------------------------------------------------------------===//
+// Register shims
+//===----------------------------------------------------------------------===//
+
+// Shims with fixed calling conventions that have register shims. Variadic
+// signatures require segment size handling and always use the buffer shims.
+#define IREE_VM_ABI_FOREACH_REGISTER_SHIM(V)                                  \
+  V(irIi, v)                                                                  \
+  V(r, i)                                                                     \
+  V(r, I)                                                                     \
+  V(r, ii)                                                                    \
+  V(r, iI)                                                                    \
+  V(r, iii)                                                                   \
+  V(r, iiii)                                                                  \
+  V(r, r)                                                                     \
+  V(r, rI)                                                                    \
+  V(r, v)                                                                     \
+  V(ri, i)                                                                    \
+  V(ri, ii)                                                                   \
+  V(ri, I)                                                                    \
+  V(ri, f)                                                                    \
+  V(ri, r)                                                                    \
+  V(ri, v)                                                                    \
+  V(rI, i)                                                                    \
+  V(rI, r)                                                                    \
+  V(rI, v)                                                                    \
+  V(rIi, i)                                                                   \
+  V(rIirrii, r)                                                               \
+  V(rIirIIi, r)                                                               \
+  V(rii, r)                                                                   \
+  V(rII, r)                                                                   \
+  V(rii, v)                                                                   \
+  V(rif, v)                                                                   \
+  V(riii, r)                                                                  \
+  V(riiI, r)                                                                  \
+  V(riii, v)                                                                  \
+  V(rIiiI, r)                                                                 \
+  V(riIiirII, r)                                                              \
+  V(rriirIIrIII, v)                                                           \
+  V(ririi, v)                                                                 \
+  V(rr, i)                                                                    \
+  V(rr, r)                                                                    \
+  V(rr, v)                                                                    \
+  V(rr, ii)                                                                   \
+  V(rr, iI)                                                                   \
+  V(rrr, iI)                                                                  \
+  V(rrr, r)                                                                   \
+  V(rriiii, v)                                                                \
+  V(rrIIii, v)                                                                \
+  V(rrirI, v)                                                                 \
+  V(rrIrII, v)                                                                \
+  V(rrIii, v)                                                                 \
+  V(rrrIii, v)                                                                \
+  V(rIrriiiI, r)                                                              \
+  V(rIrrrIrIIi, v)                                                            \
+  V(rIrrr, v)                                                                 \
+  V(iI, rr)                                                                   \
+  V(irII, rr)                                                                 \
+  V(v, i)                                                                     \
+  V(v, r)                                                                     \
+  V(v, v)
+
+IREE_VM_ABI_FOREACH_REGISTER_SHIM(IREE_VM_ABI_DEFINE_REGISTER_SHIM)
+
+typedef struct iree_vm_abi_register_shim_entry_t {
+  iree_vm_native_function_shim_t shim;
+  iree_vm_native_function_register_shim_t register_shim;
+  const char* arguments;
+  const char* results;
+} iree_vm_abi_register_shim_entry_t;
+
+#define IREE_VM_ABI_REGISTER_SHIM_TABLE_ENTRY(arg_types, ret_types)            \
+  {                                                                          \
+      (iree_vm_native_function_shim_t)iree_vm_shim_##arg_types##_##ret_types, \
+      iree_vm_register_shim_##arg_types##_##ret_types,                       \
+      #arg_types,                                                            \
+      #ret_types,                                                            \
+  },
+static const iree_vm_abi_register_shim_entry_t
+    iree_vm_abi_register_shim_table[] = {
+        IREE_VM_ABI_FOREACH_REGISTER_SHIM(
+            IREE_VM_ABI_REGISTER_SHIM_TABLE_ENTRY)};
+#undef IREE_VM_ABI_REGISTER_SHIM_TABLE_ENTRY
+
+// Returns true if the cconv |fragment| matches the shim |types|. Empty
+// fragments are equivalent to `v` as in `0_r` and `0v_r`.
+static bool iree_vm_abi_cconv_fragment_equal(iree_string_view_t fragment,
+                                             const char* types) {
+  iree_string_view_t types_view = iree_make_cstring_view(types);
+  if (!fragment.size) {
+    return iree_string_view_equal(types_view, IREE_SV("v"));
+  }
+  return iree_string_view_equal(fragment, types_view);
+}
+
+iree_vm_native_function_register_shim_t iree_vm_shim_lookup_register_shim(
+    iree_vm_native_function_shim_t shim, iree_string_view_t arguments,
+    iree_string_view_t results) {
+  // Resolved once per import so a linear scan is fine.
+  for (iree_host_size_t i = 0;
+       i < IREE_ARRAYSIZE(iree_vm_abi_register_shim_table); ++i) {
+    const iree_vm_abi_register_shim_entry_t* entry =
+        &iree_vm_abi_register_shim_table[i];
+    if (entry->shim != shim) continue;
+    // The shim must agree with the signature the caller marshals against.
+    if (!iree_vm_abi_cconv_fragment_equal(arguments, entry->arguments) ||
+        !iree_vm_abi_cconv_fragment_equal(results, entry->results)) {
+      return NULL;
+    }
+    return entry->register_shim;
+  }
+  return NULL;
+}
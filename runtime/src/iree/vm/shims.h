@@ -100,6 +100,149 @@ typedef iree_status_t(IREE_API_PTR* iree_vm_native_function_target2_t)(
     return target_fn(stack, module, module_state, args, rets);                 \
   }
 
+//===----------------------------------------------------------------------===//
+// Register shims for direct calls from the bytecode interpreter
+//===----------------------------------------------------------------------===//
+
+// Mask applied to ref register ordinals to strip their type and move bits.
+// Must match IREE_REF_REGISTER_MASK in the bytecode ISA.
+#define IREE_VM_ABI_REF_REGISTER_MASK 0x3FFF
+
+// Location of a caller's register file within its stack frame storage.
+// Offsets are used instead of pointers as entering the callee frame may
+// reallocate the stack and the registers must be requeried to store results.
+typedef struct iree_vm_abi_register_file_t {
+  uint32_t i32_offset;
+  uint32_t ref_offset;
+} iree_vm_abi_register_file_t;
+
+// A shim specialized on a fixed calling convention that reads arguments
+// directly from the registers of the current stack frame, enters a native frame
+// for |function|, calls |target_fn|, and writes results directly back to the
+// caller registers. Equivalent to packing an ABI buffer with
+// iree_vm_function_call_t and routing it through begin_call and the matching
+// iree_vm_shim_* but without the intermediate buffers or cconv parsing.
+typedef iree_status_t(IREE_API_PTR* iree_vm_native_function_register_shim_t)(
+    iree_vm_stack_t* IREE_RESTRICT stack,
+    const iree_vm_function_t* IREE_RESTRICT function,
+    iree_vm_abi_register_file_t register_file,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    iree_vm_native_function_target2_t target_fn, void* IREE_RESTRICT module);
+
+static inline int32_t* iree_vm_abi_register_file_i32(
+    iree_vm_stack_frame_t* frame, iree_vm_abi_register_file_t register_file) {
+  return (int32_t*)((uintptr_t)iree_vm_stack_frame_storage(frame) +
+                    register_file.i32_offset);
+}
+
+static inline iree_vm_ref_t* iree_vm_abi_register_file_ref(
+    iree_vm_stack_frame_t* frame, iree_vm_abi_register_file_t register_file) {
+  return (iree_vm_ref_t*)((uintptr_t)iree_vm_stack_frame_storage(frame) +
+                          register_file.ref_offset);
+}
+
+// Packs the registers in |reg_list| into the ABI struct at |p| per the
+// |cconv| fragment. Refs are borrowed from the registers without retaining.
+// Always inlined with a literal |cconv| so the loop folds into straight-line
+// loads and stores for each signature.
+static IREE_ATTRIBUTE_ALWAYS_INLINE inline void iree_vm_abi_pack_registers(
+    const char* cconv, iree_host_size_t cconv_length,
+    const int32_t* IREE_RESTRICT regs_i32,
+    iree_vm_ref_t* IREE_RESTRICT regs_ref,
+    const iree_vm_register_list_t* IREE_RESTRICT reg_list,
+    uint8_t* IREE_RESTRICT p) {
+  iree_host_size_t reg_i = 0;
+  for (iree_host_size_t i = 0; i < cconv_length; ++i) {
+    switch (cconv[i]) {
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        memcpy(p, &regs_i32[reg_list->registers[reg_i++]], sizeof(int32_t));
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_I64:
+      case IREE_VM_CCONV_TYPE_F64:
+        memcpy(p, &regs_i32[reg_list->registers[reg_i++]], sizeof(int64_t));
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_REF: {
+        uint16_t reg = reg_list->registers[reg_i++];
+        iree_vm_ref_assign(&regs_ref[reg & IREE_VM_ABI_REF_REGISTER_MASK],
+                           (iree_vm_ref_t*)p);
+        p += sizeof(iree_vm_ref_t);
+      } break;
+      default:
+        break;
+    }
+  }
+}
+
+// Unpacks the ABI struct at |p| into the registers in |reg_list| per the
+// |cconv| fragment. Refs are moved out of the struct into the registers.
+static IREE_ATTRIBUTE_ALWAYS_INLINE inline void iree_vm_abi_unpack_registers(
+    const char* cconv, iree_host_size_t cconv_length, uint8_t* IREE_RESTRICT p,
+    const iree_vm_register_list_t* IREE_RESTRICT reg_list,
+    int32_t* IREE_RESTRICT regs_i32, iree_vm_ref_t* IREE_RESTRICT regs_ref) {
+  iree_host_size_t reg_i = 0;
+  for (iree_host_size_t i = 0; i < cconv_length && reg_i < reg_list->size;
+       ++i) {
+    switch (cconv[i]) {
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        memcpy(&regs_i32[reg_list->registers[reg_i++]], p, sizeof(int32_t));
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_I64:
+      case IREE_VM_CCONV_TYPE_F64:
+        memcpy(&regs_i32[reg_list->registers[reg_i++]], p, sizeof(int64_t));
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_REF: {
+        uint16_t reg = reg_list->registers[reg_i++];
+        iree_vm_ref_move((iree_vm_ref_t*)p,
+                         &regs_ref[reg & IREE_VM_ABI_REF_REGISTER_MASK]);
+        p += sizeof(iree_vm_ref_t);
+      } break;
+      default:
+        break;
+    }
+  }
+}
+
+#define IREE_VM_ABI_DEFINE_REGISTER_SHIM(arg_types, ret_types)                 \
+  static iree_status_t iree_vm_register_shim_##arg_types##_##ret_types(        \
+      iree_vm_stack_t* IREE_RESTRICT stack,                                    \
+      const iree_vm_function_t* IREE_RESTRICT function,                        \
+      iree_vm_abi_register_file_t register_file,                               \
+      const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,               \
+      const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,               \
+      iree_vm_native_function_target2_t target_fn,                             \
+      void* IREE_RESTRICT module) {                                            \
+    IREE_VM_ABI_TYPE_NAME(arg_types) args;                                     \
+    iree_vm_abi_##arg_types##_reset(&args);                                    \
+    iree_vm_stack_frame_t* caller_frame = iree_vm_stack_current_frame(stack);  \
+    iree_vm_abi_pack_registers(                                                \
+        #arg_types, sizeof(#arg_types) - 1,                                    \
+        iree_vm_abi_register_file_i32(caller_frame, register_file),            \
+        iree_vm_abi_register_file_ref(caller_frame, register_file),            \
+        src_reg_list, (uint8_t*)&args);                                        \
+    iree_vm_stack_frame_t* callee_frame = NULL;                                \
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(                         \
+        stack, function, IREE_VM_STACK_FRAME_NATIVE, /*frame_size=*/0,         \
+        /*frame_cleanup_fn=*/NULL, &callee_frame));                            \
+    IREE_VM_ABI_TYPE_NAME(ret_types) rets;                                     \
+    iree_vm_abi_##ret_types##_reset(&rets);                                    \
+    IREE_RETURN_IF_ERROR(                                                      \
+        target_fn(stack, module, callee_frame->module_state, &args, &rets));   \
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));                 \
+    caller_frame = iree_vm_stack_current_frame(stack);                         \
+    iree_vm_abi_unpack_registers(                                              \
+        #ret_types, sizeof(#ret_types) - 1, (uint8_t*)&rets, dst_reg_list,     \
+        iree_vm_abi_register_file_i32(caller_frame, register_file),            \
+        iree_vm_abi_register_file_ref(caller_frame, register_file));           \
+    return iree_ok_status();                                                   \
+  }
+
 #define IREE_VM_ABI_EXPORT(function_name, module_state, arg_types, ret_types) \
   static iree_status_t function_name(                                         \
       iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,       \
@@ -667,4 +810,16 @@ IREE_VM_ABI_DECLARE_SHIM(v, i);
 IREE_VM_ABI_DECLARE_SHIM(v, r);
 IREE_VM_ABI_DECLARE_SHIM(v, v);
 
+//===----------------------------------------------------------------------===//
+// Register shim lookup
+//===----------------------------------------------------------------------===//
+
+// Returns the register shim specialized for the same calling convention as
+// |shim| or NULL if |shim| is not one of the iree_vm_shim_* functions above,
+// has a variadic signature, or does not match the |arguments| and |results|
+// cconv fragments of the function. Register shims call the same targets.
+iree_vm_native_function_register_shim_t iree_vm_shim_lookup_register_shim(
+    iree_vm_native_function_shim_t shim, iree_string_view_t arguments,
+    iree_string_view_t results);
+
 #endif  // IREE_VM_SHIMS_H_
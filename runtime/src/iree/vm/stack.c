@@ -541,7 +541,19 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter(
     iree_vm_stack_frame_type_t frame_type, iree_host_size_t frame_size,
     iree_vm_stack_frame_cleanup_fn_t frame_cleanup_fn,
     iree_vm_stack_frame_t* IREE_RESTRICT* out_callee_frame) {
+  return iree_vm_stack_function_enter_uninitialized(
+      stack, function, frame_type, frame_size, frame_size, frame_cleanup_fn,
+      out_callee_frame);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter_uninitialized(
+    iree_vm_stack_t* stack, const iree_vm_function_t* function,
+    iree_vm_stack_frame_type_t frame_type, iree_host_size_t frame_size,
+    iree_host_size_t zeroed_frame_size,
+    iree_vm_stack_frame_cleanup_fn_t frame_cleanup_fn,
+    iree_vm_stack_frame_t* IREE_RESTRICT* out_callee_frame) {
   if (out_callee_frame) *out_callee_frame = NULL;
+  IREE_ASSERT_LE(zeroed_frame_size, frame_size);
 
   // Allocate stack space and grow stack, if required.
   iree_host_size_t header_size = sizeof(iree_vm_stack_frame_header_t);
@@ -568,7 +580,7 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter(
   iree_vm_stack_frame_header_t* frame_header =
       (iree_vm_stack_frame_header_t*)((uintptr_t)stack->frame_storage +
                                       stack->frame_storage_size);
-  memset(frame_header, 0, header_size + frame_size);
+  memset(frame_header, 0, header_size + zeroed_frame_size);
 
   frame_header->frame_size = header_size + frame_size;
   frame_header->parent = stack->top;
@@ -305,6 +305,19 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter(
     iree_vm_stack_frame_cleanup_fn_t frame_cleanup_fn,
     iree_vm_stack_frame_t* IREE_RESTRICT* out_callee_frame);
 
+// Enters into the given |function| like iree_vm_stack_function_enter but only
+// zeroes the first |zeroed_frame_size| bytes of the |frame_size| frame storage.
+// The remainder of the storage is uninitialized and must be written by the
+// callee before being read. Callers should place any data requiring
+// initialization (such as ref storage released by |frame_cleanup_fn|) at the
+// start of the frame storage.
+IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter_uninitialized(
+    iree_vm_stack_t* stack, const iree_vm_function_t* function,
+    iree_vm_stack_frame_type_t frame_type, iree_host_size_t frame_size,
+    iree_host_size_t zeroed_frame_size,
+    iree_vm_stack_frame_cleanup_fn_t frame_cleanup_fn,
+    iree_vm_stack_frame_t* IREE_RESTRICT* out_callee_frame);
+
 // Leaves the current stack frame.
 IREE_API_EXPORT iree_status_t
 iree_vm_stack_function_leave(iree_vm_stack_t* stack);
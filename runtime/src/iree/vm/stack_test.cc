@@ -71,6 +71,37 @@ TEST(VMStackTest, Usage) {
   iree_vm_stack_deinitialize(stack);
 }
 
+// Tests that only the requested prefix of the frame storage is zeroed when
+// entering a frame with uninitialized storage.
+TEST(VMStackTest, EnterUninitialized) {
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  state_resolver, iree_allocator_system());
+
+  // Dirty the storage the next frame will occupy.
+  iree_vm_function_t function = {MODULE_A_SENTINEL,
+                                 IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_stack_frame_t* frame = nullptr;
+  IREE_ASSERT_OK(iree_vm_stack_function_enter(
+      stack, &function, IREE_VM_STACK_FRAME_NATIVE, 64, NULL, &frame));
+  memset(iree_vm_stack_frame_storage(frame), 0xCD, 64);
+  IREE_ASSERT_OK(iree_vm_stack_function_leave(stack));
+
+  IREE_ASSERT_OK(iree_vm_stack_function_enter_uninitialized(
+      stack, &function, IREE_VM_STACK_FRAME_NATIVE, 64,
+      /*zeroed_frame_size=*/16, NULL, &frame));
+  uint8_t* storage = (uint8_t*)iree_vm_stack_frame_storage(frame);
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(0, storage[i]);
+  }
+  for (int i = 16; i < 64; ++i) {
+    EXPECT_EQ(0xCD, storage[i]);
+  }
+  IREE_ASSERT_OK(iree_vm_stack_function_leave(stack));
+
+  iree_vm_stack_deinitialize(stack);
+}
+
 // Tests stack cleanup with unpopped frames (like during failure teardown).
 TEST(VMStackTest, DeinitWithRemainingFrames) {
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
@@ -0,0 +1,234 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks the same module compiled to bytecode and to C so that the
+// ahead-of-time EmitC path can be compared against the interpreter.
+
+// TODO: We should not be including C implementation-only headers in a C++
+// module like this. In order to make this work for the moment across
+// runtime libraries that are strict, do a global using of the std namespace.
+// See #7605
+#include <cmath>
+using namespace std;
+
+#include <array>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode/module.h"
+#include "iree/vm/bytecode/module_benchmark_module_c.h"
+#define EMITC_IMPLEMENTATION
+#include "iree/vm/test/emitc/module_benchmark.h"
+
+namespace {
+
+// vm.import private @native_import_module.add_1(%arg0 : i32) -> i32
+static iree_status_t native_import_module_add_1(
+    iree_vm_stack_t* stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state) {
+  int32_t arg0 = *reinterpret_cast<int32_t*>(args_storage.data);
+  *reinterpret_cast<int32_t*>(rets_storage.data) = arg0 + 1;
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    native_import_module_exports_[] = {
+        {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i_i"), 0,
+         NULL},
+};
+static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(native_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    native_import_module_descriptor_ = {
+        /*.name=*/iree_make_cstring_view("native_import_module"),
+        /*.version=*/0u,
+        /*.attr_count=*/0,
+        /*.attrs=*/NULL,
+        /*.dependency_count=*/0,
+        /*.dependencies=*/NULL,
+        /*.import_count=*/0,
+        /*.imports=*/NULL,
+        /*.export_count=*/IREE_ARRAYSIZE(native_import_module_exports_),
+        /*.exports=*/native_import_module_exports_,
+        /*.import_count=*/IREE_ARRAYSIZE(native_import_module_funcs_),
+        /*.imports=*/native_import_module_funcs_,
+};
+
+static iree_status_t native_import_module_create(
+    iree_vm_instance_t* instance, iree_allocator_t allocator,
+    iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(&interface,
+                                      &native_import_module_descriptor_,
+                                      instance, allocator, out_module);
+}
+
+typedef iree_status_t (*module_create_fn_t)(iree_vm_instance_t* instance,
+                                            iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module);
+
+static iree_status_t bytecode_module_create(iree_vm_instance_t* instance,
+                                            iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module) {
+  const iree_file_toc_t* module_file_toc =
+      iree_vm_bytecode_module_benchmark_module_create();
+  return iree_vm_bytecode_module_create(
+      instance,
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          static_cast<iree_host_size_t>(module_file_toc->size)},
+      iree_allocator_null(), allocator, out_module);
+}
+
+static iree_status_t emitc_module_create(iree_vm_instance_t* instance,
+                                         iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module) {
+  return bytecode_module_benchmark_create(instance, allocator, out_module);
+}
+
+// Benchmarks the exported function |function_name| of the module created by
+// |module_create|, passing in |i32_args|.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 module_create_fn_t module_create,
+                                 iree_string_view_t function_name,
+                                 std::vector<int32_t> i32_args,
+                                 int result_count, int64_t batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                        iree_allocator_system(), &instance));
+
+  iree_vm_module_t* import_module = NULL;
+  IREE_CHECK_OK(native_import_module_create(instance, iree_allocator_system(),
+                                            &import_module));
+
+  iree_vm_module_t* module = NULL;
+  IREE_CHECK_OK(module_create(instance, iree_allocator_system(), &module));
+
+  std::array<iree_vm_module_t*, 2> modules = {import_module, module};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, modules.size(), modules.data(),
+      iree_allocator_system(), &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(
+      iree_vm_context_resolve_function(context, function_name, &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context),
+                                  iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+    IREE_CHECK_OK(function.module->begin_call(function.module->self, stack,
+                                              call));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(import_module);
+  iree_vm_module_release(module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+static void BM_EmptyFunc(benchmark::State& state,
+                         module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view("bytecode_module_benchmark.empty_func"), {},
+      /*result_count=*/0));
+}
+BENCHMARK_CAPTURE(BM_EmptyFunc, Bytecode, bytecode_module_create);
+BENCHMARK_CAPTURE(BM_EmptyFunc, EmitC, emitc_module_create);
+
+static void BM_CallInternalFunc(benchmark::State& state,
+                                module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view("bytecode_module_benchmark.call_internal_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/20));
+}
+BENCHMARK_CAPTURE(BM_CallInternalFunc, Bytecode, bytecode_module_create);
+BENCHMARK_CAPTURE(BM_CallInternalFunc, EmitC, emitc_module_create);
+
+static void BM_CallImportedFunc(benchmark::State& state,
+                                module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view("bytecode_module_benchmark.call_imported_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/20));
+}
+BENCHMARK_CAPTURE(BM_CallImportedFunc, Bytecode, bytecode_module_create);
+BENCHMARK_CAPTURE(BM_CallImportedFunc, EmitC, emitc_module_create);
+
+static void BM_LoopSum(benchmark::State& state,
+                       module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view("bytecode_module_benchmark.loop_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK_CAPTURE(BM_LoopSum, Bytecode, bytecode_module_create)->Arg(100000);
+BENCHMARK_CAPTURE(BM_LoopSum, EmitC, emitc_module_create)->Arg(100000);
+
+static void BM_BufferReduce(benchmark::State& state,
+                            module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view("bytecode_module_benchmark.buffer_reduce"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK_CAPTURE(BM_BufferReduce, Bytecode, bytecode_module_create)
+    ->Arg(100000);
+BENCHMARK_CAPTURE(BM_BufferReduce, EmitC, emitc_module_create)->Arg(100000);
+
+// NOTE: unrolled 8x, requires %count to be % 8 = 0.
+static void BM_BufferReduceUnrolled(benchmark::State& state,
+                                    module_create_fn_t module_create) {
+  IREE_CHECK_OK(RunFunction(
+      state, module_create,
+      iree_make_cstring_view(
+          "bytecode_module_benchmark.buffer_reduce_unrolled"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK_CAPTURE(BM_BufferReduceUnrolled, Bytecode, bytecode_module_create)
+    ->Arg(100000);
+BENCHMARK_CAPTURE(BM_BufferReduceUnrolled, EmitC, emitc_module_create)
+    ->Arg(100000);
+
+}  // namespace
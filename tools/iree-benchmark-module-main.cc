@@ -51,11 +51,30 @@
 // how the full program will run, though, and YMMV. Always verify timings with
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
+//
+// The Google Benchmark runs above measure closed-loop latency: a new batch
+// is only issued once the prior one completed. For capacity planning the
+// --load_qps= flag switches to an open-loop mode where invocations of the
+// --function= arrive at a target rate regardless of whether prior ones have
+// completed. Arrivals are queued to --load_concurrency= workers, each with its
+// own VM context, and the latency of each invocation is measured from its
+// scheduled arrival so that queueing delay is included. Repeating the flag
+// sweeps multiple rates to produce a throughput-vs-latency curve.
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
+#include <deque>
 #include <iterator>
+#include <mutex>
+#include <random>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -105,6 +124,24 @@ IREE_FLAG_LIST(
     "Each occurrence of the flag indicates an input in the order they were\n"
     "specified on the command line.");
 
+IREE_FLAG_LIST(
+    string, load_qps,
+    "Target invocations per second of an open-loop load run of --function=\n"
+    "instead of the closed-loop benchmarks. Each occurrence of the flag\n"
+    "adds a run at that rate, producing a throughput-vs-latency sweep.");
+IREE_FLAG(string, load_arrivals, "poisson",
+          "Arrival process of open-loop load runs: 'poisson' for exponentially "
+          "distributed inter-arrival times or 'fixed' for a constant rate.");
+IREE_FLAG(double, load_duration, 10.0,
+          "Duration in seconds over which arrivals are generated for each "
+          "open-loop load run.");
+IREE_FLAG(int32_t, load_concurrency, 1,
+          "Maximum number of concurrent invocations in open-loop load runs. "
+          "Each concurrent invocation uses its own VM context.");
+IREE_FLAG(bool, load_histogram, false,
+          "Prints a log2-bucketed latency histogram for each open-loop load "
+          "run.");
+
 static iree_status_t parse_time_unit(iree_string_view_t flag_name,
                                      void* storage, iree_string_view_t value) {
   auto* unit = (std::pair<bool, benchmark::TimeUnit>*)storage;
@@ -423,6 +460,255 @@ void RegisterDispatchBenchmark(const std::string& function_name,
                                   : benchmark::kMicrosecond);
 }
 
+//===----------------------------------------------------------------------===//
+// Open-loop load generation
+//===----------------------------------------------------------------------===//
+
+using LoadClock = std::chrono::steady_clock;
+
+// Measurements of a single open-loop load run.
+struct LoadRunResult {
+  double target_qps = 0.0;
+  double achieved_qps = 0.0;
+  // Latency of each completed invocation from its scheduled arrival.
+  std::vector<int64_t> latencies_ns;
+};
+
+// Issues invocations of a function at a target rate across a set of contexts
+// and measures their latencies. Each context is owned by one worker thread
+// that dequeues arrivals in order; arrivals queue up when all workers are
+// busy, as requests would in a server.
+class LoadGenerator {
+ public:
+  LoadGenerator(iree_hal_device_t* device, iree_vm_function_t function,
+                iree_vm_list_t* common_inputs, bool poisson_arrivals,
+                double duration_seconds)
+      : device_(device),
+        function_(function),
+        common_inputs_(common_inputs),
+        poisson_arrivals_(poisson_arrivals),
+        duration_seconds_(duration_seconds) {
+    iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
+        &function, IREE_SV("iree.abi.model"));
+    is_async_ = iree_string_view_equal(invocation_model,
+                                       IREE_SV("coarse-fences"));
+  }
+
+  iree_status_t Run(const std::vector<iree_vm_context_t*>& contexts,
+                    double target_qps, LoadRunResult* out_result) {
+    IREE_TRACE_SCOPE_NAMED("LoadGenerator::Run");
+    std::vector<Worker> workers(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      IREE_RETURN_IF_ERROR(InitializeWorker(contexts[i], &workers[i]));
+    }
+
+    arrivals_.clear();
+    latencies_ns_.clear();
+    done_ = false;
+    status_ = iree_ok_status();
+    auto start_time = LoadClock::now();
+    last_completion_time_ = start_time;
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+      threads.emplace_back([this, &worker]() { WorkerMain(worker); });
+    }
+
+    // Generate arrivals until the duration elapses. Arrival times are
+    // precomputed so that a slow enqueue does not shift the schedule.
+    std::mt19937_64 rng(0);
+    std::exponential_distribution<double> exponential(target_qps);
+    auto end_time =
+        start_time + std::chrono::duration_cast<LoadClock::duration>(
+                         std::chrono::duration<double>(duration_seconds_));
+    double offset_seconds = 0.0;
+    size_t arrival_count = 0;
+    while (true) {
+      offset_seconds +=
+          poisson_arrivals_ ? exponential(rng) : 1.0 / target_qps;
+      auto arrival_time =
+          start_time + std::chrono::duration_cast<LoadClock::duration>(
+                           std::chrono::duration<double>(offset_seconds));
+      if (arrival_time >= end_time) break;
+      std::this_thread::sleep_until(arrival_time);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!iree_status_is_ok(status_)) break;
+        arrivals_.push_back(arrival_time);
+      }
+      cond_.notify_one();
+      ++arrival_count;
+    }
+
+    // Drain all outstanding invocations.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cond_.notify_all();
+    for (auto& thread : threads) thread.join();
+    IREE_RETURN_IF_ERROR(status_);
+
+    double elapsed_seconds =
+        std::chrono::duration<double>(last_completion_time_ - start_time)
+            .count();
+    out_result->target_qps = target_qps;
+    out_result->achieved_qps =
+        elapsed_seconds > 0.0 ? arrival_count / elapsed_seconds : 0.0;
+    out_result->latencies_ns = std::move(latencies_ns_);
+    return iree_ok_status();
+  }
+
+ private:
+  // Invocation state owned by a single worker thread.
+  struct Worker {
+    iree_vm_context_t* context = nullptr;
+    vm::ref<iree_vm_list_t> inputs;
+    vm::ref<iree_vm_list_t> outputs;
+    // Timeline signaled by asynchronous invocations.
+    vm::ref<iree_hal_semaphore_t> semaphore;
+    uint64_t signal_value = 0;
+  };
+
+  iree_status_t InitializeWorker(iree_vm_context_t* context, Worker* worker) {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    worker->context = context;
+    if (common_inputs_) {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_clone(common_inputs_, host_allocator, &worker->inputs));
+    } else {
+      IREE_RETURN_IF_ERROR(iree_vm_list_create(
+          iree_vm_make_undefined_type_def(), 2, host_allocator,
+          &worker->inputs));
+    }
+    if (is_async_) {
+      // Inputs are ready when invoked so the wait fence is null. The signal
+      // fence placeholder is replaced on each invocation.
+      IREE_RETURN_IF_ERROR(
+          iree_hal_semaphore_create(device_, 0ull, &worker->semaphore));
+      vm::ref<iree_hal_fence_t> wait_fence;
+      vm::ref<iree_hal_fence_t> signal_fence;
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_ref_move(worker->inputs.get(), wait_fence));
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_ref_move(worker->inputs.get(), signal_fence));
+    }
+    return iree_vm_list_create(iree_vm_make_undefined_type_def(), 16,
+                               host_allocator, &worker->outputs);
+  }
+
+  iree_status_t Invoke(Worker& worker) {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    vm::ref<iree_hal_fence_t> signal_fence;
+    if (is_async_) {
+      IREE_RETURN_IF_ERROR(iree_hal_fence_create_at(
+          worker.semaphore.get(), ++worker.signal_value, host_allocator,
+          &signal_fence));
+      vm::ref<iree_hal_fence_t> list_fence = vm::retain_ref(signal_fence);
+      IREE_RETURN_IF_ERROR(iree_vm_list_set_ref_move(
+          worker.inputs.get(), iree_vm_list_size(worker.inputs.get()) - 1,
+          list_fence));
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_invoke(
+        worker.context, function_, IREE_VM_INVOCATION_FLAG_NONE,
+        /*policy=*/nullptr, worker.inputs.get(), worker.outputs.get(),
+        host_allocator));
+    if (is_async_) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_fence_wait(signal_fence.get(), iree_infinite_timeout()));
+    }
+    return iree_vm_list_resize(worker.outputs.get(), 0);
+  }
+
+  void WorkerMain(Worker& worker) {
+    while (true) {
+      LoadClock::time_point arrival_time;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return done_ || !arrivals_.empty(); });
+        if (arrivals_.empty() || !iree_status_is_ok(status_)) return;
+        arrival_time = arrivals_.front();
+        arrivals_.pop_front();
+      }
+      iree_status_t status = Invoke(worker);
+      auto completion_time = LoadClock::now();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!iree_status_is_ok(status)) {
+        status_ = iree_status_join(status_, status);
+        done_ = true;
+        cond_.notify_all();
+        return;
+      }
+      latencies_ns_.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              completion_time - arrival_time)
+              .count());
+      last_completion_time_ = std::max(last_completion_time_, completion_time);
+    }
+  }
+
+  iree_hal_device_t* device_;
+  iree_vm_function_t function_;
+  iree_vm_list_t* common_inputs_;
+  bool poisson_arrivals_;
+  double duration_seconds_;
+  bool is_async_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<LoadClock::time_point> arrivals_;
+  bool done_ = false;
+  iree_status_t status_ = iree_ok_status();
+  std::vector<int64_t> latencies_ns_;
+  LoadClock::time_point last_completion_time_;
+};
+
+static void PrintLoadRunHeader(const char* unit_string) {
+  fprintf(stdout, "%12s %12s %10s %10s %10s %10s %10s %10s %10s  (%s)\n",
+          "target_qps", "achieved_qps", "count", "mean", "p50", "p90", "p99",
+          "p99.9", "max", unit_string);
+}
+
+static void PrintLoadRunResult(LoadRunResult& result, double unit_ns) {
+  auto& latencies = result.latencies_ns;
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double q) -> double {
+    if (latencies.empty()) return 0.0;
+    size_t rank = (size_t)std::ceil(q * latencies.size());
+    return latencies[std::min(latencies.size() - 1, rank ? rank - 1 : 0)] /
+           unit_ns;
+  };
+  double mean = 0.0;
+  for (int64_t latency : latencies) mean += latency;
+  if (!latencies.empty()) mean /= latencies.size() * unit_ns;
+  fprintf(stdout,
+          "%12.2f %12.2f %10zu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+          result.target_qps, result.achieved_qps, latencies.size(), mean,
+          percentile(0.50), percentile(0.90), percentile(0.99),
+          percentile(0.999), percentile(1.0));
+}
+
+// Prints |latencies_ns| bucketed by powers of two microseconds.
+static void PrintLoadRunHistogram(const std::vector<int64_t>& latencies_ns) {
+  if (latencies_ns.empty()) return;
+  std::vector<size_t> buckets;
+  for (int64_t latency_ns : latencies_ns) {
+    int64_t latency_us = latency_ns / 1000;
+    size_t bucket = 0;
+    while (latency_us >> bucket) ++bucket;
+    if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+    ++buckets[bucket];
+  }
+  size_t max_count = *std::max_element(buckets.begin(), buckets.end());
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    uint64_t lower_us = i ? (1ull << (i - 1)) : 0;
+    uint64_t upper_us = 1ull << i;
+    int bar_length = max_count ? (int)(40 * buckets[i] / max_count) : 0;
+    fprintf(stdout, "  [%10" PRIu64 ", %10" PRIu64 ") us %10zu %.*s\n",
+            lower_us, upper_us, buckets[i], bar_length,
+            "########################################");
+  }
+}
+
 // The lifetime of IREEBenchmark should be as long as
 // ::benchmark::RunSpecifiedBenchmarks() where the resources are used during
 // benchmarking.
@@ -435,6 +721,7 @@ class IREEBenchmark {
 
     // Order matters. Tear down modules first to release resources.
     inputs_.reset();
+    load_contexts_.clear();
     context_.reset();
     iree_tooling_module_list_reset(&module_list_);
     instance_.reset();
@@ -450,6 +737,125 @@ class IREEBenchmark {
 
   iree_hal_device_t* device() const { return device_.get(); }
 
+  // Returns true if open-loop load runs were requested instead of the
+  // closed-loop benchmarks.
+  static bool IsLoadMode() { return FLAG_load_qps_list().count > 0; }
+
+  // Prepares the contexts and inputs used by RunLoad.
+  iree_status_t PrepareLoad() {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::PrepareLoad");
+    if (!instance_ || !device_allocator_ || !context_ || !module_list_.count) {
+      IREE_RETURN_IF_ERROR(Init());
+    }
+
+    auto function_name = std::string(FLAG_function);
+    if (function_name.empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--load_qps= requires a --function= to run");
+    }
+    if (FLAG_load_concurrency < 1) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--load_concurrency= must be at least 1");
+    }
+    iree_vm_module_t* main_module =
+        iree_tooling_module_list_back(&module_list_);
+    IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
+        main_module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(),
+                           (iree_host_size_t)function_name.size()},
+        &load_function_));
+    IREE_RETURN_IF_ERROR(iree_tooling_parse_to_variant_list(
+        device_.get(), device_allocator_.get(), FLAG_input_list().values,
+        FLAG_input_list().count, iree_vm_instance_allocator(instance_.get()),
+        &inputs_));
+
+    // Additional contexts share the modules (and so the device) of the
+    // primary context but have their own module state.
+    std::vector<iree_vm_module_t*> modules(
+        iree_vm_context_module_count(context_.get()));
+    for (iree_host_size_t i = 0; i < modules.size(); ++i) {
+      modules[i] = iree_vm_context_module_at(context_.get(), i);
+    }
+    load_contexts_.push_back(vm::retain_ref(context_.get()));
+    for (int32_t i = 1; i < FLAG_load_concurrency; ++i) {
+      vm::ref<iree_vm_context_t> context;
+      IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+          instance_.get(), iree_vm_context_flags(context_.get()),
+          modules.size(), modules.data(), iree_allocator_system(), &context));
+      load_contexts_.push_back(std::move(context));
+    }
+    return iree_ok_status();
+  }
+
+  // Runs an open-loop load run at each --load_qps= rate and prints the
+  // resulting latency distributions.
+  iree_status_t RunLoad() {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RunLoad");
+    std::vector<double> target_qps_values;
+    for (iree_host_size_t i = 0; i < FLAG_load_qps_list().count; ++i) {
+      iree_string_view_t value = FLAG_load_qps_list().values[i];
+      std::string value_string(value.data, value.size);
+      char* end = nullptr;
+      double target_qps = std::strtod(value_string.c_str(), &end);
+      if (end == value_string.c_str() || *end != 0 || !(target_qps > 0.0)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid --load_qps= value '%.*s'",
+                                (int)value.size, value.data);
+      }
+      target_qps_values.push_back(target_qps);
+    }
+    iree_string_view_t arrivals = iree_make_cstring_view(FLAG_load_arrivals);
+    bool poisson_arrivals =
+        iree_string_view_equal(arrivals, IREE_SV("poisson"));
+    if (!poisson_arrivals &&
+        !iree_string_view_equal(arrivals, IREE_SV("fixed"))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unsupported --load_arrivals= '%.*s'; expected "
+                              "'poisson' or 'fixed'",
+                              (int)arrivals.size, arrivals.data);
+    }
+
+    const char* unit_string = kMillisecondsUnitString;
+    double unit_ns = 1e6;
+    if (FLAG_time_unit.first) {
+      switch (FLAG_time_unit.second) {
+        case benchmark::kMicrosecond:
+          unit_string = kMicrosecondsUnitString;
+          unit_ns = 1e3;
+          break;
+        case benchmark::kNanosecond:
+          unit_string = kNanosecondsUnitString;
+          unit_ns = 1.0;
+          break;
+        default:
+          break;
+      }
+    }
+
+    std::vector<iree_vm_context_t*> contexts;
+    for (auto& context : load_contexts_) contexts.push_back(context.get());
+    LoadGenerator generator(device_.get(), load_function_, inputs_.get(),
+                            poisson_arrivals, FLAG_load_duration);
+    iree_string_view_t function_name = iree_vm_function_name(&load_function_);
+    fprintf(stdout,
+            "Open-loop load of %.*s: %s arrivals over %.2fs with %d "
+            "concurrent invocations\n",
+            (int)function_name.size, function_name.data, FLAG_load_arrivals,
+            FLAG_load_duration, FLAG_load_concurrency);
+    PrintLoadRunHeader(unit_string);
+    for (double target_qps : target_qps_values) {
+      LoadRunResult result;
+      IREE_RETURN_IF_ERROR(generator.Run(contexts, target_qps, &result));
+      PrintLoadRunResult(result, unit_ns);
+      if (FLAG_load_histogram) PrintLoadRunHistogram(result.latencies_ns);
+      fflush(stdout);
+      if (device_) {
+        IREE_RETURN_IF_ERROR(iree_hal_device_profiling_flush(device_.get()));
+      }
+    }
+    return iree_ok_status();
+  }
+
   iree_status_t Register() {
     IREE_TRACE_SCOPE_NAMED("IREEBenchmark::Register");
 
@@ -595,6 +1001,8 @@ class IREEBenchmark {
   iree::vm::ref<iree_hal_allocator_t> device_allocator_;
   iree_tooling_module_list_t module_list_;
   iree::vm::ref<iree_vm_list_t> inputs_;
+  iree_vm_function_t load_function_ = {0};
+  std::vector<iree::vm::ref<iree_vm_context_t>> load_contexts_;
 };
 }  // namespace
 }  // namespace iree
@@ -610,7 +1018,18 @@ int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
 
   iree::IREEBenchmark iree_benchmark;
-  iree_status_t status = iree_benchmark.Register();
+  bool load_mode = iree::IREEBenchmark::IsLoadMode();
+  iree_status_t status = load_mode ? iree_benchmark.PrepareLoad()
+                                   : iree_benchmark.Register();
+  if (iree_status_is_ok(status)) {
+    IREE_CHECK_OK(iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
+    if (load_mode) {
+      status = iree_benchmark.RunLoad();
+    } else {
+      ::benchmark::RunSpecifiedBenchmarks();
+    }
+    IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  }
   if (!iree_status_is_ok(status)) {
     int exit_code = static_cast<int>(iree_status_code(status));
     printf("%s\n", iree::Status(std::move(status)).ToString().c_str());
@@ -618,9 +1037,6 @@ int main(int argc, char** argv) {
     IREE_TRACE_APP_EXIT(exit_code);
     return exit_code;
   }
-  IREE_CHECK_OK(iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
-  ::benchmark::RunSpecifiedBenchmarks();
-  IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
 
   IREE_TRACE_ZONE_END(z0);
   IREE_TRACE_APP_EXIT(EXIT_SUCCESS);
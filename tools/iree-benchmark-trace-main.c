@@ -15,6 +15,8 @@
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/base/internal/path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 #include "iree/testing/benchmark.h"
 #include "iree/tooling/device_util.h"
@@ -54,6 +56,16 @@ IREE_FLAG_LIST(
     "Each occurrence of the flag indicates an input in the order they were\n"
     "specified on the command line.");
 
+IREE_FLAG(int32_t, replay_streams, 1,
+          "Number of independent replays of each trace run concurrently.\n"
+          "Each stream has its own VM context and state but shares the HAL\n"
+          "device when --reuse_devices is set. An iteration completes when\n"
+          "all streams have replayed the trace.");
+
+IREE_FLAG(bool, print_step_latencies, true,
+          "Prints per-call latency statistics for each trace to stderr after\n"
+          "all benchmarks have run.");
+
 // Global state shared across all benchmarks and iterations.
 // Immutable and thread-safe (so much as anything contained within is).
 typedef struct iree_replay_benchmark_globals_t {
@@ -66,6 +78,33 @@ typedef struct iree_replay_benchmark_globals_t {
   iree_const_byte_span_t stdin_contents;
 } iree_replay_benchmark_globals_t;
 
+// Growable list of call latency samples.
+typedef struct iree_replay_benchmark_samples_t {
+  iree_host_size_t count;
+  iree_host_size_t capacity;
+  iree_duration_t* values;
+} iree_replay_benchmark_samples_t;
+
+static iree_status_t iree_replay_benchmark_samples_append(
+    iree_replay_benchmark_samples_t* samples, iree_duration_t value,
+    iree_allocator_t host_allocator) {
+  if (samples->count + 1 > samples->capacity) {
+    iree_host_size_t new_capacity = iree_max(64, samples->capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        host_allocator, new_capacity * sizeof(samples->values[0]),
+        (void**)&samples->values));
+    samples->capacity = new_capacity;
+  }
+  samples->values[samples->count++] = value;
+  return iree_ok_status();
+}
+
+static void iree_replay_benchmark_samples_reset(
+    iree_replay_benchmark_samples_t* samples, iree_allocator_t host_allocator) {
+  iree_allocator_free(host_allocator, samples->values);
+  memset(samples, 0, sizeof(*samples));
+}
+
 // A benchmark registration for each file to run.
 typedef struct iree_replay_benchmark_registration_t {
   iree_benchmark_def_t benchmark_def;  // Must be first.
@@ -75,17 +114,71 @@ typedef struct iree_replay_benchmark_registration_t {
   iree_string_view_t file_path;
   // Global state shared across all benchmarks and iterations.
   const iree_replay_benchmark_globals_t* globals;
+  // Trace parsed on first use and retained for all runs of the benchmark.
+  bool has_plan;
+  iree_trace_replay_plan_t plan;
+  // Call latencies of each step in |plan| accumulated across all runs and
+  // streams. Only call steps have samples.
+  iree_replay_benchmark_samples_t* step_samples;
 } iree_replay_benchmark_registration_t;
 
+// An independent replay of a trace.
+// Streams are only touched by their own thread while an iteration is running
+// and by the benchmark thread otherwise.
+typedef struct iree_replay_benchmark_stream_t {
+  iree_replay_benchmark_registration_t* registration;
+  iree_trace_replay_t replay;
+  // Benchmark state when the stream is timing its own calls. NULL when
+  // multiple streams are running concurrently and iterations are timed as a
+  // whole.
+  iree_benchmark_state_t* benchmark_state;
+  // --input= values parsed once the device is available; cloned into the
+  // replay inputs at the start of each iteration.
+  iree_vm_list_t* preloaded_inputs;
+  // Inputs of each call step with static arguments prepared on first use.
+  iree_vm_list_t** step_inputs;
+  // Call latencies of each step recorded during the current run.
+  iree_replay_benchmark_samples_t* step_samples;
+  // Index of the step currently being replayed.
+  iree_host_size_t step_index;
+  // Time the current call began.
+  iree_time_t call_start_ns;
+  // Worker thread when running concurrently with other streams.
+  iree_thread_t* thread;
+  // Last iteration epoch the worker has started.
+  int32_t worker_epoch;
+  // Result of the last iteration run by the worker thread.
+  iree_status_t worker_status;
+  struct iree_replay_benchmark_run_t* run;
+} iree_replay_benchmark_stream_t;
+
+// State for a single run of a benchmark across all streams.
+typedef struct iree_replay_benchmark_run_t {
+  iree_host_size_t stream_count;
+  iree_replay_benchmark_stream_t* streams;
+  // Incremented to start a new iteration on all worker threads.
+  iree_atomic_int32_t epoch;
+  // Set to request that worker threads exit.
+  iree_atomic_int32_t exit_requested;
+  // Number of worker threads that have not yet finished the iteration.
+  iree_atomic_int32_t pending_count;
+  iree_notification_t start_notification;
+  iree_notification_t done_notification;
+} iree_replay_benchmark_run_t;
+
 IREE_TRACE(static const char* IREE_REPLAY_ACTIVE_PLOT_ID = "Timing Active");
 
 static iree_status_t iree_replay_benchmark_call_before(
     void* user_data, iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node, iree_vm_function_t function,
     iree_vm_list_t* input_list) {
-  iree_benchmark_state_t* benchmark_state = (iree_benchmark_state_t*)user_data;
-  IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 1);
-  iree_benchmark_resume_timing(benchmark_state);
+  iree_replay_benchmark_stream_t* stream =
+      (iree_replay_benchmark_stream_t*)user_data;
+  if (stream->benchmark_state) {
+    IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 1);
+    iree_benchmark_resume_timing(stream->benchmark_state);
+  }
+  stream->call_start_ns = iree_time_now();
   return iree_ok_status();
 }
 
@@ -93,73 +186,23 @@ static iree_status_t iree_replay_benchmark_call_after(
     void* user_data, iree_trace_replay_t* replay, yaml_document_t* document,
     yaml_node_t* event_node, iree_vm_function_t function,
     iree_vm_list_t* output_list) {
-  iree_benchmark_state_t* benchmark_state = (iree_benchmark_state_t*)user_data;
-  iree_benchmark_pause_timing(benchmark_state);
-  IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 0);
-  return iree_ok_status();
-}
-
-static iree_status_t iree_replay_benchmark_run_documents(
-    iree_trace_replay_t* replay, FILE* file,
-    iree_benchmark_state_t* benchmark_state) {
-  // One-pass parsing through the file.
-  yaml_parser_t parser;
-  if (!yaml_parser_initialize(&parser)) {
-    return iree_make_status(IREE_STATUS_INTERNAL,
-                            "yaml_parser_initialize failed");
-  }
-  yaml_parser_set_input_file(&parser, file);
-
-  bool have_parsed_inputs = false;
-  iree_status_t status = iree_ok_status();
-  for (bool document_eof = false; !document_eof;) {
-    // Parse the subdocument event.
-    IREE_TRACE_ZONE_BEGIN_NAMED(z_load, "yaml_parser_load");
-    yaml_document_t document;
-    bool did_load = yaml_parser_load(&parser, &document);
-    IREE_TRACE_ZONE_END(z_load);
-    if (!did_load) {
-      status = iree_status_from_yaml_parser_error(&parser);
-      break;
-    }
-
-    // Execute the event or handle EOF (empty document).
-    yaml_node_t* event_node = yaml_document_get_root_node(&document);
-    if (event_node) {
-      status = iree_trace_replay_event(replay, &document, event_node);
-    } else {
-      document_eof = true;
-    }
-
-    // Reclaim subdocument resources before moving on to the next.
-    IREE_TRACE_ZONE_BEGIN_NAMED(z_delete, "yaml_document_delete");
-    yaml_document_delete(&document);
-    IREE_TRACE_ZONE_END(z_delete);
-
-    // If the event created a device and we haven't yet performed our input
-    // loading we can do that now before processing subsequent events.
-    if (iree_status_is_ok(status) && !have_parsed_inputs && replay->device) {
-      status = iree_tooling_parse_into_variant_list(
-          replay->device, iree_hal_device_allocator(replay->device),
-          FLAG_input_list().values, FLAG_input_list().count,
-          replay->host_allocator, replay->inputs);
-      have_parsed_inputs = true;
-    }
-
-    if (!iree_status_is_ok(status)) break;
+  iree_replay_benchmark_stream_t* stream =
+      (iree_replay_benchmark_stream_t*)user_data;
+  iree_time_t call_end_ns = iree_time_now();
+  if (stream->benchmark_state) {
+    iree_benchmark_pause_timing(stream->benchmark_state);
+    IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 0);
   }
-
-  yaml_parser_delete(&parser);
-
-  return status;
+  return iree_replay_benchmark_samples_append(
+      &stream->step_samples[stream->step_index],
+      call_end_ns - stream->call_start_ns, replay->host_allocator);
 }
 
-// Benchmark function that runs a trace file.
-static iree_status_t iree_replay_benchmark_run_file(
-    const iree_benchmark_def_t* benchmark_def,
-    iree_benchmark_state_t* benchmark_state) {
-  const iree_replay_benchmark_registration_t* registration =
-      (const iree_replay_benchmark_registration_t*)benchmark_def->user_data;
+static iree_status_t iree_replay_benchmark_stream_initialize(
+    iree_replay_benchmark_registration_t* registration,
+    iree_allocator_t host_allocator, iree_replay_benchmark_stream_t* stream) {
+  memset(stream, 0, sizeof(*stream));
+  stream->registration = registration;
   const iree_replay_benchmark_globals_t* globals = registration->globals;
 
   iree_trace_replay_flags_t replay_flags = IREE_TRACE_REPLAY_FLAG_NONE;
@@ -173,18 +216,17 @@ static iree_status_t iree_replay_benchmark_run_file(
     replay_flags |= IREE_TRACE_REPLAY_FLAG_REUSE_MODULES;
   }
 
-  // Setup replay state used for this benchmark.
-  iree_trace_replay_t replay;
+  // Setup replay state used for this stream.
   IREE_RETURN_IF_ERROR(iree_trace_replay_initialize(
       registration->root_path, globals->instance, replay_flags,
       IREE_VM_CONTEXT_FLAG_NONE, iree_hal_available_driver_registry(),
-      iree_allocator_system(), &replay));
-  replay.stdin_contents = globals->stdin_contents;
+      host_allocator, &stream->replay));
+  stream->replay.stdin_contents = globals->stdin_contents;
 
   // Hook into all calls processed during the trace so we can time them.
-  replay.call_hooks.user_data = benchmark_state;
-  replay.call_hooks.before = iree_replay_benchmark_call_before;
-  replay.call_hooks.after = iree_replay_benchmark_call_after;
+  stream->replay.call_hooks.user_data = stream;
+  stream->replay.call_hooks.before = iree_replay_benchmark_call_before;
+  stream->replay.call_hooks.after = iree_replay_benchmark_call_after;
 
   // Query device overrides, if any. When omitted the devices from the trace
   // file will be used.
@@ -192,52 +234,404 @@ static iree_status_t iree_replay_benchmark_run_file(
   iree_host_size_t device_uri_count = 0;
   const iree_string_view_t* device_uris = NULL;
   iree_hal_get_devices_flag_list(&device_uri_count, &device_uris);
-  iree_trace_replay_set_hal_devices_override(&replay, device_uri_count,
+  iree_trace_replay_set_hal_devices_override(&stream->replay, device_uri_count,
                                              device_uris);
 
-  // Open trace YAML file from the given file_path.
-  FILE* file = fopen(registration->file_path.data, "rb");
-  if (!file) {
-    return iree_make_status(
-        iree_status_code_from_errno(errno), "failed to open trace file '%.*s'",
-        (int)registration->file_path.size, registration->file_path.data);
+  iree_host_size_t step_count = registration->plan.step_count;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, step_count * sizeof(stream->step_inputs[0]),
+      (void**)&stream->step_inputs));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, step_count * sizeof(stream->step_samples[0]),
+      (void**)&stream->step_samples));
+  return iree_ok_status();
+}
+
+static void iree_replay_benchmark_stream_deinitialize(
+    iree_replay_benchmark_stream_t* stream) {
+  iree_allocator_t host_allocator = stream->replay.host_allocator;
+  iree_host_size_t step_count = stream->registration->plan.step_count;
+  if (stream->step_inputs) {
+    for (iree_host_size_t i = 0; i < step_count; ++i) {
+      iree_vm_list_release(stream->step_inputs[i]);
+    }
+    iree_allocator_free(host_allocator, stream->step_inputs);
+  }
+  if (stream->step_samples) {
+    for (iree_host_size_t i = 0; i < step_count; ++i) {
+      iree_replay_benchmark_samples_reset(&stream->step_samples[i],
+                                          host_allocator);
+    }
+    iree_allocator_free(host_allocator, stream->step_samples);
   }
+  iree_vm_list_release(stream->preloaded_inputs);
+  iree_trace_replay_deinitialize(&stream->replay);
+}
 
-  // Call the functions within the trace in order.
-  while (iree_benchmark_keep_running(benchmark_state,
-                                     /*batch_count=*/1)) {
-    // Pause timing that was started automatically. We'll resume/pause around
-    // each call.
-    // TODO(benvanik): see if we can tell benchmark to start paused?
-    iree_benchmark_pause_timing(benchmark_state);
+// Replays the untimed steps prior to the first call to set up the context and
+// restores the preloaded inputs.
+static iree_status_t iree_replay_benchmark_stream_prepare(
+    iree_replay_benchmark_stream_t* stream) {
+  iree_trace_replay_t* replay = &stream->replay;
+  iree_trace_replay_plan_t* plan = &stream->registration->plan;
 
-    // Clear replay state.
-    iree_trace_replay_reset(&replay);
+  // Clear replay state.
+  iree_trace_replay_reset(replay);
 
-    // Run all events in the document from start to end.
+  for (iree_host_size_t i = 0; i < plan->first_call_step; ++i) {
+    iree_trace_replay_step_t* step = &plan->steps[i];
     IREE_RETURN_IF_ERROR(
-        iree_replay_benchmark_run_documents(&replay, file, benchmark_state));
+        iree_trace_replay_event(replay, &step->document, step->event_node));
+  }
+
+  // Parse --input= values once a device is available and keep them around
+  // for all future iterations.
+  if (!stream->preloaded_inputs && replay->device) {
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             FLAG_input_list().count,
+                                             replay->host_allocator,
+                                             &stream->preloaded_inputs));
+    IREE_RETURN_IF_ERROR(iree_tooling_parse_into_variant_list(
+        replay->device, iree_hal_device_allocator(replay->device),
+        FLAG_input_list().values, FLAG_input_list().count,
+        replay->host_allocator, stream->preloaded_inputs));
+  }
+  if (stream->preloaded_inputs) {
+    // Inputs may be taken by the trace and we clone so that each iteration
+    // starts with all of them present.
+    iree_vm_list_release(replay->inputs);
+    replay->inputs = NULL;
+    IREE_RETURN_IF_ERROR(iree_vm_list_clone(
+        stream->preloaded_inputs, replay->host_allocator, &replay->inputs));
+  }
+  return iree_ok_status();
+}
+
+// Replays a call step using inputs prepared on first use when possible.
+static iree_status_t iree_replay_benchmark_stream_call(
+    iree_replay_benchmark_stream_t* stream, iree_trace_replay_step_t* step) {
+  iree_trace_replay_t* replay = &stream->replay;
+
+  // Prepared inputs reference device buffers and are only reusable when the
+  // device lives across iterations.
+  bool can_reuse_inputs =
+      step->has_static_args &&
+      iree_all_bits_set(replay->replay_flags,
+                        IREE_TRACE_REPLAY_FLAG_REUSE_DEVICES);
+
+  iree_vm_function_t function;
+  iree_vm_list_t* input_list = NULL;
+  iree_vm_list_t** cached_input_list =
+      &stream->step_inputs[stream->step_index];
+  if (can_reuse_inputs && *cached_input_list) {
+    yaml_node_t* function_node = NULL;
+    IREE_RETURN_IF_ERROR(iree_yaml_mapping_find(
+        &step->document, step->event_node, IREE_SV("function"),
+        &function_node));
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        replay->context, iree_yaml_node_as_string(function_node), &function));
+    input_list = *cached_input_list;
+    iree_vm_list_retain(input_list);
+  } else {
+    IREE_RETURN_IF_ERROR(iree_trace_replay_event_call_prepare(
+        replay, &step->document, step->event_node, &function, &input_list));
+    if (can_reuse_inputs) {
+      *cached_input_list = input_list;
+      iree_vm_list_retain(input_list);
+    }
+  }
+
+  iree_status_t status = iree_trace_replay_event_call_with_inputs(
+      replay, &step->document, step->event_node, function, input_list,
+      &replay->call_hooks);
+  iree_vm_list_release(input_list);
+  return status;
+}
+
+// Replays all steps from the first call to the end of the trace.
+static iree_status_t iree_replay_benchmark_stream_run(
+    iree_replay_benchmark_stream_t* stream) {
+  iree_trace_replay_plan_t* plan = &stream->registration->plan;
+  for (iree_host_size_t i = plan->first_call_step; i < plan->step_count; ++i) {
+    iree_trace_replay_step_t* step = &plan->steps[i];
+    stream->step_index = i;
+    if (step->is_call) {
+      IREE_RETURN_IF_ERROR(iree_replay_benchmark_stream_call(stream, step));
+    } else {
+      IREE_RETURN_IF_ERROR(iree_trace_replay_event(
+          &stream->replay, &step->document, step->event_node));
+    }
+  }
+  return iree_ok_status();
+}
+
+static bool iree_replay_benchmark_worker_should_wake(void* arg) {
+  iree_replay_benchmark_stream_t* stream =
+      (iree_replay_benchmark_stream_t*)arg;
+  return iree_atomic_load_int32(&stream->run->exit_requested,
+                                iree_memory_order_acquire) ||
+         iree_atomic_load_int32(&stream->run->epoch,
+                                iree_memory_order_acquire) !=
+             stream->worker_epoch;
+}
 
-    // Reset file back to the start.
-    fseek(file, 0, SEEK_SET);
+static bool iree_replay_benchmark_run_is_done(void* arg) {
+  iree_replay_benchmark_run_t* run = (iree_replay_benchmark_run_t*)arg;
+  return iree_atomic_load_int32(&run->pending_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+// Worker thread entry point replaying the stream once per iteration epoch.
+static int iree_replay_benchmark_worker_main(void* entry_arg) {
+  iree_replay_benchmark_stream_t* stream =
+      (iree_replay_benchmark_stream_t*)entry_arg;
+  iree_replay_benchmark_run_t* run = stream->run;
+  for (;;) {
+    iree_notification_await(&run->start_notification,
+                            iree_replay_benchmark_worker_should_wake, stream,
+                            iree_infinite_timeout());
+    if (iree_atomic_load_int32(&run->exit_requested,
+                               iree_memory_order_acquire)) {
+      break;
+    }
+    stream->worker_epoch =
+        iree_atomic_load_int32(&run->epoch, iree_memory_order_acquire);
+    stream->worker_status = iree_replay_benchmark_stream_run(stream);
+    if (iree_atomic_fetch_sub_int32(&run->pending_count, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&run->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+// Runs one iteration of all streams concurrently and returns the first error.
+static iree_status_t iree_replay_benchmark_run_concurrent_iteration(
+    iree_replay_benchmark_run_t* run) {
+  iree_atomic_store_int32(&run->pending_count, (int32_t)run->stream_count,
+                          iree_memory_order_release);
+  iree_atomic_fetch_add_int32(&run->epoch, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&run->start_notification, IREE_ALL_WAITERS);
+  iree_notification_await(&run->done_notification,
+                          iree_replay_benchmark_run_is_done, run,
+                          iree_infinite_timeout());
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < run->stream_count; ++i) {
+    status = iree_status_join(status, run->streams[i].worker_status);
+    run->streams[i].worker_status = iree_ok_status();
+  }
+  return status;
+}
+
+// Benchmark function that runs a trace file.
+static iree_status_t iree_replay_benchmark_run_file(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_replay_benchmark_registration_t* registration =
+      (iree_replay_benchmark_registration_t*)benchmark_def->user_data;
+  iree_allocator_t host_allocator = iree_allocator_system();
+
+  // Parse the trace once; all runs and iterations replay the parsed plan.
+  if (!registration->has_plan) {
+    FILE* file = fopen(registration->file_path.data, "rb");
+    if (!file) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to open trace file '%.*s'",
+                              (int)registration->file_path.size,
+                              registration->file_path.data);
+    }
+    iree_status_t status = iree_trace_replay_plan_initialize_from_file(
+        file, host_allocator, &registration->plan);
+    fclose(file);
+    IREE_RETURN_IF_ERROR(status);
+    registration->has_plan = true;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        host_allocator,
+        registration->plan.step_count * sizeof(registration->step_samples[0]),
+        (void**)&registration->step_samples));
+  }
+
+  iree_replay_benchmark_run_t run;
+  memset(&run, 0, sizeof(run));
+  run.stream_count = (iree_host_size_t)iree_max(1, FLAG_replay_streams);
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, run.stream_count * sizeof(run.streams[0]),
+      (void**)&run.streams));
+  iree_notification_initialize(&run.start_notification);
+  iree_notification_initialize(&run.done_notification);
+  bool is_concurrent = run.stream_count > 1;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < run.stream_count && iree_status_is_ok(status); ++i) {
+    iree_replay_benchmark_stream_t* stream = &run.streams[i];
+    status = iree_replay_benchmark_stream_initialize(registration,
+                                                     host_allocator, stream);
+    stream->run = &run;
+    if (!is_concurrent) stream->benchmark_state = benchmark_state;
+  }
+
+  // Prepare the first stream so that it creates the device and then share it
+  // with all other streams when allowed.
+  if (iree_status_is_ok(status)) {
+    status = iree_replay_benchmark_stream_prepare(&run.streams[0]);
+  }
+  if (iree_status_is_ok(status) && FLAG_reuse_devices) {
+    for (iree_host_size_t i = 1; i < run.stream_count; ++i) {
+      run.streams[i].replay.device = run.streams[0].replay.device;
+      iree_hal_device_retain(run.streams[i].replay.device);
+    }
+  }
+
+  if (is_concurrent) {
+    for (iree_host_size_t i = 0;
+         i < run.stream_count && iree_status_is_ok(status); ++i) {
+      iree_thread_create_params_t params;
+      memset(&params, 0, sizeof(params));
+      params.name = IREE_SV("iree-replay-stream");
+      status = iree_thread_create(iree_replay_benchmark_worker_main,
+                                  &run.streams[i], params, host_allocator,
+                                  &run.streams[i].thread);
+    }
+  }
+
+  // Run all calls within the trace in order.
+  bool is_first_iteration = true;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state,
+                                     /*batch_count=*/1)) {
+    // Pause timing that was started automatically. In single stream mode we
+    // resume/pause around each call and otherwise around the whole iteration.
+    // TODO(benvanik): see if we can tell benchmark to start paused?
+    iree_benchmark_pause_timing(benchmark_state);
+
+    // Reset state and replay the setup steps of each stream.
+    for (iree_host_size_t i = 0;
+         i < run.stream_count && iree_status_is_ok(status); ++i) {
+      if (i == 0 && is_first_iteration) continue;  // prepared above
+      status = iree_replay_benchmark_stream_prepare(&run.streams[i]);
+    }
+    is_first_iteration = false;
+
+    if (iree_status_is_ok(status)) {
+      if (is_concurrent) {
+        IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 1);
+        iree_benchmark_resume_timing(benchmark_state);
+        status = iree_replay_benchmark_run_concurrent_iteration(&run);
+        iree_benchmark_pause_timing(benchmark_state);
+        IREE_TRACE_PLOT_VALUE_I64(IREE_REPLAY_ACTIVE_PLOT_ID, 0);
+      } else {
+        status = iree_replay_benchmark_stream_run(&run.streams[0]);
+      }
+    }
 
     // Resume before looping because keep_running requires it.
     iree_benchmark_resume_timing(benchmark_state);
   }
 
-  iree_trace_replay_deinitialize(&replay);
-  return iree_ok_status();
+  // Stop worker threads; releasing a thread joins it.
+  iree_atomic_store_int32(&run.exit_requested, 1, iree_memory_order_release);
+  iree_notification_post(&run.start_notification, IREE_ALL_WAITERS);
+  for (iree_host_size_t i = 0; i < run.stream_count; ++i) {
+    iree_thread_release(run.streams[i].thread);
+  }
+
+  // Merge the latencies of all streams into the registration totals.
+  for (iree_host_size_t i = 0; i < run.stream_count; ++i) {
+    iree_replay_benchmark_stream_t* stream = &run.streams[i];
+    if (!stream->step_samples) continue;
+    for (iree_host_size_t j = 0;
+         j < registration->plan.step_count && iree_status_is_ok(status); ++j) {
+      const iree_replay_benchmark_samples_t* samples =
+          &stream->step_samples[j];
+      for (iree_host_size_t k = 0; k < samples->count; ++k) {
+        status = iree_replay_benchmark_samples_append(
+            &registration->step_samples[j], samples->values[k],
+            host_allocator);
+        if (!iree_status_is_ok(status)) break;
+      }
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < run.stream_count; ++i) {
+    if (run.streams[i].registration) {
+      iree_replay_benchmark_stream_deinitialize(&run.streams[i]);
+    }
+  }
+  iree_notification_deinitialize(&run.done_notification);
+  iree_notification_deinitialize(&run.start_notification);
+  iree_allocator_free(host_allocator, run.streams);
+  return status;
+}
+
+static int iree_replay_benchmark_compare_durations(const void* lhs,
+                                                   const void* rhs) {
+  iree_duration_t a = *(const iree_duration_t*)lhs;
+  iree_duration_t b = *(const iree_duration_t*)rhs;
+  return (a > b) - (a < b);
+}
+
+// Returns the |percentile| of the sorted |samples|.
+static iree_duration_t iree_replay_benchmark_percentile(
+    const iree_replay_benchmark_samples_t* samples, double percentile) {
+  iree_host_size_t index =
+      (iree_host_size_t)(percentile / 100.0 * (double)(samples->count - 1) +
+                         0.5);
+  return samples->values[index];
+}
+
+// Prints the latency distribution of each call step in |registration|.
+static void iree_replay_benchmark_print_step_latencies(
+    iree_replay_benchmark_registration_t* registration, FILE* file) {
+  if (!registration->has_plan) return;
+  fprintf(file, "[[ %.*s step latencies (ms) ]]\n",
+          (int)registration->file_path.size, registration->file_path.data);
+  fprintf(file, "%6s %10s %10s %10s %10s %10s %10s  %s\n", "step", "count",
+          "mean", "p50", "p90", "p99", "max", "function");
+  for (iree_host_size_t i = 0; i < registration->plan.step_count; ++i) {
+    iree_replay_benchmark_samples_t* samples = &registration->step_samples[i];
+    if (!samples->count) continue;
+    qsort(samples->values, samples->count, sizeof(samples->values[0]),
+          iree_replay_benchmark_compare_durations);
+    double total_ns = 0.0;
+    for (iree_host_size_t j = 0; j < samples->count; ++j) {
+      total_ns += (double)samples->values[j];
+    }
+    iree_string_view_t function_name =
+        iree_trace_replay_step_function_name(&registration->plan.steps[i]);
+    fprintf(
+        file,
+        "%6" PRIhsz " %10" PRIhsz " %10.3f %10.3f %10.3f %10.3f %10.3f  %.*s\n",
+        i, samples->count, total_ns / (double)samples->count / 1e6,
+        iree_replay_benchmark_percentile(samples, 50.0) / 1e6,
+        iree_replay_benchmark_percentile(samples, 90.0) / 1e6,
+        iree_replay_benchmark_percentile(samples, 99.0) / 1e6,
+        samples->values[samples->count - 1] / 1e6, (int)function_name.size,
+        function_name.data);
+  }
+}
+
+static void iree_replay_benchmark_registration_deinitialize(
+    iree_replay_benchmark_registration_t* registration) {
+  if (!registration->has_plan) return;
+  iree_allocator_t host_allocator = registration->plan.host_allocator;
+  for (iree_host_size_t i = 0; i < registration->plan.step_count; ++i) {
+    iree_replay_benchmark_samples_reset(&registration->step_samples[i],
+                                        host_allocator);
+  }
+  iree_allocator_free(host_allocator, registration->step_samples);
+  iree_trace_replay_plan_deinitialize(&registration->plan);
+  registration->has_plan = false;
 }
 
 // Registers benchmarks for each trace file.
-static void iree_replay_benchmark_register_trace_files(
+static iree_replay_benchmark_registration_t*
+iree_replay_benchmark_register_trace_files(
     int file_count, char** file_paths,
     const iree_replay_benchmark_globals_t* globals) {
-  static iree_replay_benchmark_registration_t* registrations = NULL;
-  if (!registrations) free(registrations);
-  registrations = (iree_replay_benchmark_registration_t*)malloc(
-      file_count * sizeof(iree_replay_benchmark_registration_t));
-
+  iree_replay_benchmark_registration_t* registrations =
+      (iree_replay_benchmark_registration_t*)calloc(
+          file_count, sizeof(iree_replay_benchmark_registration_t));
   for (int i = 0; i < file_count; ++i) {
     iree_string_view_t file_path = iree_make_cstring_view(file_paths[i]);
     registrations[i].root_path = iree_file_path_dirname(file_path);
@@ -255,6 +649,7 @@ static void iree_replay_benchmark_register_trace_files(
     iree_benchmark_register(iree_file_path_stem(file_path),
                             &registrations[i].benchmark_def);
   }
+  return registrations;
 }
 
 int main(int argc, char** argv) {
@@ -301,9 +696,20 @@ int main(int argc, char** argv) {
       .stdin_contents = stdin_contents ? stdin_contents->const_buffer
                                        : iree_const_byte_span_empty(),
   };
-  iree_replay_benchmark_register_trace_files(argc - 1, argv + 1, &globals);
+  int file_count = argc - 1;
+  iree_replay_benchmark_registration_t* registrations =
+      iree_replay_benchmark_register_trace_files(file_count, argv + 1,
+                                                 &globals);
   iree_benchmark_run_specified();
 
+  for (int i = 0; i < file_count; ++i) {
+    if (FLAG_print_step_latencies) {
+      iree_replay_benchmark_print_step_latencies(&registrations[i], stderr);
+    }
+    iree_replay_benchmark_registration_deinitialize(&registrations[i]);
+  }
+  free(registrations);
+
   iree_file_contents_free(stdin_contents);
   iree_vm_instance_release(instance);
   IREE_TRACE_APP_EXIT(EXIT_SUCCESS);
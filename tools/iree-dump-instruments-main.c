@@ -52,6 +52,13 @@ static iree_status_t iree_tooling_dump_dispatch_metadata(
     flatbuffers_string_t layout =
         iree_instruments_DispatchFunctionDef_layout(function_def);
     if (layout) fprintf(stream, "//  layout: %s\n", layout);
+    uint64_t flops = iree_instruments_DispatchFunctionDef_flops(function_def);
+    uint64_t bytes = iree_instruments_DispatchFunctionDef_bytes(function_def);
+    if (flops || bytes) {
+      fprintf(stream,
+              "//    cost: %" PRIu64 " FLOP, %" PRIu64 " B, %.2f FLOP/B\n",
+              flops, bytes, bytes ? (double)flops / (double)bytes : 0.0);
+    }
     flatbuffers_string_t source =
         iree_instruments_DispatchFunctionDef_source(function_def);
     if (source) fprintf(stream, "%s\n", source);
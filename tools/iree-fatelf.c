@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/path.h"
 #include "iree/hal/local/elf/fatelf.h"
@@ -34,6 +35,11 @@ static int print_usage() {
   fprintf(stderr, "\n");
   fprintf(stderr, "Join multiple ELFs into a FatELF:\n");
   fprintf(stderr, "  iree-fatelf join elf_a.so elf_b.so > fatelf.sos\n");
+  fprintf(stderr, "ELFs requiring processor features may be prefixed with\n");
+  fprintf(stderr, "their feature level (x86-64-v2, x86-64-v3, x86-64-v4,\n");
+  fprintf(stderr, "znver4) and the best supported one will be selected:\n");
+  fprintf(stderr,
+          "  iree-fatelf join elf.so x86-64-v3=elf_v3.so > fatelf.sos\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Split a FatELF into multiple ELF files (to dir):\n");
   fprintf(stderr, "  iree-fatelf split fatelf.sos\n");
@@ -112,7 +118,7 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
+        .feature_level = iree_unaligned_load_le_u8(&raw_record->feature_level),
         .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
@@ -174,8 +180,57 @@ static iree_status_t fatelf_parse_elf_metadata(
   return iree_ok_status();
 }
 
+static const struct {
+  iree_elf64_byte_t value;
+  const char* name;
+} fatelf_feature_levels[] = {
+    {IREE_FATELF_FEATURE_LEVEL_BASELINE, "baseline"},
+    {IREE_FATELF_FEATURE_LEVEL_X86_64_V2, "x86-64-v2"},
+    {IREE_FATELF_FEATURE_LEVEL_X86_64_V3, "x86-64-v3"},
+    {IREE_FATELF_FEATURE_LEVEL_X86_64_V4, "x86-64-v4"},
+    {IREE_FATELF_FEATURE_LEVEL_X86_64_ZNVER4, "znver4"},
+};
+
+// NOTE: feature level values are architecture-specific but today only x86-64
+// defines any beyond the baseline.
+static const char* fatelf_feature_level_str(iree_elf64_byte_t value) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(fatelf_feature_levels);
+       ++i) {
+    if (fatelf_feature_levels[i].value == value) {
+      return fatelf_feature_levels[i].name;
+    }
+  }
+  return "unknown";
+}
+
+// Splits a `level=path` join argument into its feature level and path.
+// Arguments without a level are treated as the baseline.
+static iree_status_t fatelf_parse_join_arg(const char* arg,
+                                           iree_elf64_byte_t* out_level,
+                                           const char** out_path) {
+  *out_level = IREE_FATELF_FEATURE_LEVEL_BASELINE;
+  *out_path = arg;
+  const char* separator = strchr(arg, '=');
+  if (!separator) return iree_ok_status();
+  iree_string_view_t name =
+      iree_make_string_view(arg, (iree_host_size_t)(separator - arg));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(fatelf_feature_levels);
+       ++i) {
+    if (iree_string_view_equal(
+            name, iree_make_cstring_view(fatelf_feature_levels[i].name))) {
+      *out_level = fatelf_feature_levels[i].value;
+      *out_path = separator + 1;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "unknown feature level '%.*s'", (int)name.size,
+                          name.data);
+}
+
 typedef struct {
   uint64_t offset;
+  iree_elf64_byte_t feature_level;
   iree_file_contents_t* contents;
   iree_const_byte_span_t elf_data;
 } fatelf_entry_t;
@@ -194,8 +249,11 @@ static iree_status_t fatelf_join(int argc, char** argv) {
       (fatelf_entry_t*)iree_alloca(entry_count * sizeof(fatelf_entry_t));
   memset(entries, 0, entry_count * sizeof(*entries));
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
+    const char* path = NULL;
+    IREE_RETURN_IF_ERROR(
+        fatelf_parse_join_arg(argv[i], &entries[i].feature_level, &path));
     IREE_RETURN_IF_ERROR(
-        iree_file_read_contents(argv[i], IREE_FILE_READ_FLAG_DEFAULT,
+        iree_file_read_contents(path, IREE_FILE_READ_FLAG_DEFAULT,
                                 iree_allocator_system(), &entries[i].contents));
     entries[i].elf_data = entries[i].contents->const_buffer;
   }
@@ -239,7 +297,7 @@ static iree_status_t fatelf_join(int argc, char** argv) {
         .byte_order = elf_data == IREE_ELF_ELFDATA2LSB
                           ? IREE_FATELF_BYTE_ORDER_LSB
                           : IREE_FATELF_BYTE_ORDER_MSB,
-        .reserved0 = 0,
+        .feature_level = entries[i].feature_level,
         .reserved1 = 0,
         .offset = (iree_elf64_off_t)entries[i].offset,
         .size = (iree_elf64_xword_t)entries[i].elf_data.data_length,
@@ -347,12 +405,19 @@ static iree_status_t fatelf_split(int argc, char** argv) {
     const char* word_size_str = fatelf_word_size_id_str(record->word_size);
     const char* byte_order_str = fatelf_byte_order_id_str(record->byte_order);
 
+    // Baseline records keep the unsuffixed name.
+    char feature_level_str[32] = {0};
+    if (record->feature_level != IREE_FATELF_FEATURE_LEVEL_BASELINE) {
+      snprintf(feature_level_str, IREE_ARRAYSIZE(feature_level_str), "_%s",
+               fatelf_feature_level_str(record->feature_level));
+    }
+
     char record_path[2048];
-    iree_host_size_t record_path_length =
-        snprintf(record_path, IREE_ARRAYSIZE(record_path),
-                 "%.*s%s%.*s.%s_%s_%s%s.so", (int)dirname.size, dirname.data,
-                 dirname.size ? "/" : "", (int)stem.size, stem.data,
-                 machine_str, osabi_str, word_size_str, byte_order_str);
+    iree_host_size_t record_path_length = snprintf(
+        record_path, IREE_ARRAYSIZE(record_path), "%.*s%s%.*s.%s_%s_%s%s%s.so",
+        (int)dirname.size, dirname.data, dirname.size ? "/" : "",
+        (int)stem.size, stem.data, machine_str, osabi_str, word_size_str,
+        byte_order_str, feature_level_str);
     record_path_length =
         iree_file_path_canonicalize(record_path, record_path_length);
 
@@ -371,10 +436,12 @@ static iree_status_t fatelf_split(int argc, char** argv) {
   return iree_ok_status();
 }
 
-// Selects the ELF matching the current host config from a FatELF and writes
-// it to stdout.
+// Selects the ELF matching the current host config and processor features
+// from a FatELF and writes it to stdout.
 static iree_status_t fatelf_select(int argc, char** argv) {
   IREE_SET_BINARY_MODE(stdout);  // ensure binary output mode
+  // Feature levels are selected based on the host processor.
+  iree_cpu_initialize(iree_allocator_system());
   iree_file_contents_t* fatelf_contents = NULL;
   IREE_RETURN_IF_ERROR(
       iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
@@ -438,8 +505,9 @@ static iree_status_t fatelf_dump(int argc, char** argv) {
             record->word_size, fatelf_word_size_enum_str(record->word_size));
     fprintf(stdout, " byte_order: %d / %02X = %s\n", record->byte_order,
             record->byte_order, fatelf_byte_order_enum_str(record->byte_order));
-    fprintf(stdout, "  reserved0: %d / %02X\n", record->reserved0,
-            record->reserved0);
+    fprintf(stdout, "    feature: %d / %02X = %s\n", record->feature_level,
+            record->feature_level,
+            fatelf_feature_level_str(record->feature_level));
     fprintf(stdout, "  reserved1: %d / %02X\n", record->reserved1,
             record->reserved1);
     fprintf(stdout, "     offset: %" PRIu64 " / %016" PRIX64 "\n",
@@ -194,17 +194,12 @@ Status ConfigureTargetBackends(iree_compiler_session_t* session,
   }
 
   // If target backends are specified then we can infer the runtime devices from
-  // the compiler configuration. This only works if there's a single backend
-  // specified; if the user wants multiple target backends then they must
-  // specify the device(s) to use.
+  // the compiler configuration. When multiple backends are specified the
+  // compiled module records them and the first one with an available driver is
+  // selected when the module is loaded.
   if (device_flag_count == 0) {
     if (target_backends_flag.find(',') != std::string::npos) {
-      return iree_make_status(
-          IREE_STATUS_INVALID_ARGUMENT,
-          "if multiple target backends are specified the device to use must "
-          "also be specified with --device= (have "
-          "`--iree-hal-target-backends=%.*s`)",
-          (int)target_backends_flag.size(), target_backends_flag.data());
+      return OkStatus();
     }
     *out_default_device_uri =
         InferDefaultDeviceFromTargetBackend(target_backends_flag);